@@ -0,0 +1,1513 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_bench.c
+ * @brief  ROHC throughput benchmark
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The program generates synthetic IP flows, compresses them, decompresses
+ * them, and reports the throughput of the library for every kind of flows.
+ * Every kind of flows is run in its own process, so that the memory used by
+ * the library may be reported for every kind of flows.
+ *
+ * The traffic may be spread over many compressor/decompressor pairs, each
+ * with a few flows, as a terminal concentrator would: the packets are given
+ * to the pairs in round-robin. The creation time of the pairs, the memory
+ * used per pair, and the rate of last-level cache misses are then reported
+ * too.
+ */
+
+#include "config.h" /* for PACKAGE_BUGREPORT */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h> /* for PRIu64 */
+#include <time.h> /* for clock_gettime(2) */
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#if HAVE_LINUX_PERF_EVENT_H == 1
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  define BENCH_HAVE_PERF  1
+#endif
+#if defined(__i386__) || defined(__x86_64__)
+#  include <x86intrin.h> /* for __rdtsc() */
+#  define BENCH_HAVE_TSC  1
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The maximum number of flows */
+#define BENCH_FLOWS_MAX  16384U
+
+/** The maximum number of compressor/decompressor pairs */
+#define BENCH_INSTANCES_MAX  100000U
+
+/** The maximum length (in bytes) of the payloads of the generated packets */
+#define BENCH_PAYLOAD_MAX_LEN  1400U
+
+/** The maximum length (in bytes) of the generated packets */
+#define BENCH_PKT_MAX_LEN  (BENCH_PAYLOAD_MAX_LEN + 100U)
+
+/** The maximum length (in bytes) of the ROHC packets */
+#define BENCH_ROHC_MAX_LEN  (BENCH_PKT_MAX_LEN + 100U)
+
+/** The number of packets generated at once, then compressed at once, then
+ *  decompressed at once, so that the clocks are read once per batch */
+#define BENCH_BATCH_LEN  256U
+
+/** The UDP port of the RTP flows */
+#define BENCH_RTP_PORT  5004U
+
+/** The length (in bytes) of the TCP header with the NOP, NOP, TS options */
+#define BENCH_TCP_HDR_LEN  32U
+
+
+/** The kinds of flows the benchmark may generate */
+typedef enum
+{
+	BENCH_PROTO_UDP,   /**< IP/UDP flows */
+	BENCH_PROTO_RTP,   /**< IP/UDP/RTP flows */
+	BENCH_PROTO_TCP,   /**< IP/TCP flows */
+	BENCH_PROTO_ESP,   /**< IP/ESP flows */
+	BENCH_PROTO_MAX    /**< The number of kinds of flows */
+} bench_proto_t;
+
+/** The names of the kinds of flows */
+static const char *const bench_proto_names[BENCH_PROTO_MAX] = {
+	[BENCH_PROTO_UDP] = "udp",
+	[BENCH_PROTO_RTP] = "rtp",
+	[BENCH_PROTO_TCP] = "tcp",
+	[BENCH_PROTO_ESP] = "esp",
+};
+
+/** The parameters of one benchmark run */
+struct bench_params
+{
+	bench_proto_t proto;         /**< The kind of flows */
+	unsigned int ip_version;     /**< The IP version of the flows: 4 or 6 */
+	size_t instances_nr;         /**< The number of compressor/decompressor
+	                                  pairs */
+	size_t flows_nr;             /**< The number of flows per pair */
+	size_t payload_len;          /**< The length of the payloads */
+	unsigned long pkts_nr;       /**< The number of packets to generate */
+	double change_rate;          /**< The percentage of packets that change
+	                                  the fields of their flow */
+	double loss_rate;            /**< The percentage of ROHC packets lost
+	                                  before decompression */
+	bool use_rohcv2;             /**< Whether to use the ROHCv2 profiles */
+};
+
+/** The state of one generated flow */
+struct bench_flow
+{
+	uint16_t id;         /**< The index of the flow */
+	uint8_t tos;         /**< The IPv4 TOS or the IPv6 Traffic Class */
+	uint8_t ttl;         /**< The IPv4 TTL or the IPv6 Hop Limit */
+	uint16_t ip_id;      /**< The IPv4 Identification */
+	uint16_t sport;      /**< The UDP or TCP source port */
+	uint16_t dport;      /**< The UDP or TCP destination port */
+	uint16_t rtp_sn;     /**< The RTP Sequence Number */
+	uint32_t rtp_ts;     /**< The RTP Timestamp */
+	uint32_t ssrc;       /**< The RTP SSRC */
+	uint32_t tcp_seq;    /**< The TCP Sequence Number */
+	uint32_t tcp_ack;    /**< The TCP Acknowledgment Number */
+	uint16_t tcp_win;    /**< The TCP Window */
+	uint32_t tcp_tsval;  /**< The value of the TCP Timestamp option */
+	uint32_t esp_spi;    /**< The ESP SPI */
+	uint32_t esp_sn;     /**< The ESP Sequence Number */
+};
+
+/** The results of one benchmark run */
+struct bench_results
+{
+	uint64_t comp_ns;            /**< The time spent to compress (ns) */
+	uint64_t decomp_ns;          /**< The time spent to decompress (ns) */
+	uint64_t comp_cycles;        /**< The CPU cycles spent to compress */
+	uint64_t decomp_cycles;      /**< The CPU cycles spent to decompress */
+	unsigned long comp_pkts;     /**< The number of compressed packets */
+	unsigned long decomp_pkts;   /**< The number of decompressed packets */
+	unsigned long decomp_errs;   /**< The number of decompression failures */
+	uint64_t uncomp_bytes;       /**< The number of uncompressed bytes */
+	uint64_t comp_bytes;         /**< The number of compressed bytes */
+	uint64_t create_ns;          /**< The time spent to create the pairs of
+	                                  compressor/decompressor (ns) */
+	long rss_delta;              /**< The resident memory used by the pairs
+	                                  of compressor/decompressor (kB) */
+	uint64_t llc_misses;         /**< The last-level cache misses */
+	uint64_t llc_refs;           /**< The last-level cache references */
+	bool has_llc;                /**< Whether the cache counters are known */
+};
+
+/** The hardware counters of the last-level cache */
+struct bench_perf
+{
+	int misses_fd;   /**< The counter of cache misses, -1 if none */
+	int refs_fd;     /**< The counter of cache references, -1 if none */
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+
+static int bench_run(const struct bench_params *const params)
+	__attribute__((warn_unused_result, nonnull(1)));
+static int bench_run_child(const struct bench_params *const params)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_comp * bench_create_comp(const struct bench_params *const params,
+                                            const rohc_cid_type_t cid_type,
+                                            const rohc_cid_t max_cid)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_decomp * bench_create_decomp(const struct bench_params *const params,
+                                                const rohc_cid_type_t cid_type,
+                                                const rohc_cid_t max_cid)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void bench_init_flow(const struct bench_params *const params,
+                            struct bench_flow *const flow,
+                            const size_t id,
+                            uint64_t *const rand_state)
+	__attribute__((nonnull(1, 2, 4)));
+static size_t bench_gen_pkt(const struct bench_params *const params,
+                            struct bench_flow *const flow,
+                            uint64_t *const rand_state,
+                            uint8_t *const pkt)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+static void bench_print_results(const struct bench_params *const params,
+                                const struct bench_results *const results,
+                                const long peak_rss)
+	__attribute__((nonnull(1, 2)));
+static void bench_print_instances(const struct bench_params *const params,
+                                  const struct bench_results *const results)
+	__attribute__((nonnull(1, 2)));
+
+static void bench_perf_open(struct bench_perf *const perf)
+	__attribute__((nonnull(1)));
+static void bench_perf_enable(const struct bench_perf *const perf,
+                              const bool enable)
+	__attribute__((nonnull(1)));
+static bool bench_perf_read(const struct bench_perf *const perf,
+                            uint64_t *const misses,
+                            uint64_t *const refs)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void bench_perf_close(struct bench_perf *const perf)
+	__attribute__((nonnull(1)));
+static long bench_get_rss(void)
+	__attribute__((warn_unused_result));
+
+static uint64_t bench_rand(uint64_t *const state)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool bench_rand_percent(uint64_t *const state, const double percent)
+	__attribute__((warn_unused_result, nonnull(1)));
+static uint64_t bench_get_ns(void)
+	__attribute__((warn_unused_result));
+static uint64_t bench_get_cycles(void)
+	__attribute__((warn_unused_result));
+static uint32_t bench_csum_add(uint32_t sum,
+                               const uint8_t *const data,
+                               const size_t len)
+	__attribute__((warn_unused_result, nonnull(2)));
+static uint16_t bench_csum_fold(uint32_t sum)
+	__attribute__((warn_unused_result, const));
+static void bench_put16(uint8_t *const buf, const uint16_t value)
+	__attribute__((nonnull(1)));
+static void bench_put32(uint8_t *const buf, const uint32_t value)
+	__attribute__((nonnull(1)));
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Main function for the ROHC benchmark program
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct bench_params params = {
+		.instances_nr = 1,
+		.flows_nr = 1,
+		.payload_len = 100,
+		.pkts_nr = 1000000,
+		.change_rate = 0.0,
+		.loss_rate = 0.0,
+		.use_rohcv2 = false,
+	};
+	const char *proto_name = NULL;
+	int ip_version = 0; /* 0 means both IPv4 and IPv6 */
+	unsigned int proto;
+	unsigned int ipv;
+	int status = 1;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_bench version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "--flows") ||
+		        !strcmp(*argv, "--instances") ||
+		        !strcmp(*argv, "--size") ||
+		        !strcmp(*argv, "--packets") ||
+		        !strcmp(*argv, "--ip") ||
+		        !strcmp(*argv, "--change-rate") ||
+		        !strcmp(*argv, "--loss-rate"))
+		{
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory %s parameter\n", argv[0]);
+				usage();
+				goto error;
+			}
+			if(!strcmp(*argv, "--flows"))
+			{
+				/* get the number of flows to generate */
+				params.flows_nr = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--instances"))
+			{
+				/* get the number of compressor/decompressor pairs */
+				params.instances_nr = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--size"))
+			{
+				/* get the length of the payloads of the packets */
+				params.payload_len = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--packets"))
+			{
+				/* get the number of packets to generate */
+				params.pkts_nr = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--ip"))
+			{
+				/* get the IP version of the flows */
+				ip_version = atoi(argv[1]);
+			}
+			else if(!strcmp(*argv, "--change-rate"))
+			{
+				/* get the percentage of packets that change their flow */
+				params.change_rate = strtod(argv[1], NULL);
+			}
+			else
+			{
+				/* get the percentage of ROHC packets to lose */
+				params.loss_rate = strtod(argv[1], NULL);
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--rohcv2"))
+		{
+			/* use the ROHCv2 profiles instead of the ROHCv1 ones */
+			params.use_rohcv2 = true;
+		}
+		else if(proto_name == NULL)
+		{
+			/* get the kind of flows */
+			proto_name = argv[0];
+		}
+		else
+		{
+			/* do not accept more than one kind of flows */
+			usage();
+			goto error;
+		}
+	}
+
+	/* check the parameters */
+	if(params.flows_nr < 1 || params.flows_nr > BENCH_FLOWS_MAX)
+	{
+		fprintf(stderr, "the number of flows should be between 1 and %u\n\n",
+		        BENCH_FLOWS_MAX);
+		usage();
+		goto error;
+	}
+	if(params.instances_nr < 1 || params.instances_nr > BENCH_INSTANCES_MAX)
+	{
+		fprintf(stderr, "the number of instances should be between 1 and %u\n\n",
+		        BENCH_INSTANCES_MAX);
+		usage();
+		goto error;
+	}
+	if(params.payload_len > BENCH_PAYLOAD_MAX_LEN)
+	{
+		fprintf(stderr, "the size of the payloads should be between 0 and %u "
+		        "bytes\n\n", BENCH_PAYLOAD_MAX_LEN);
+		usage();
+		goto error;
+	}
+	if(params.pkts_nr < 1)
+	{
+		fprintf(stderr, "the number of packets should be at least 1\n\n");
+		usage();
+		goto error;
+	}
+	if(ip_version != 0 && ip_version != 4 && ip_version != 6)
+	{
+		fprintf(stderr, "the IP version should be 4 or 6\n\n");
+		usage();
+		goto error;
+	}
+	if(params.change_rate < 0.0 || params.change_rate > 100.0 ||
+	   params.loss_rate < 0.0 || params.loss_rate > 100.0)
+	{
+		fprintf(stderr, "the change and loss rates should be between 0 and "
+		        "100 %%\n\n");
+		usage();
+		goto error;
+	}
+	if(proto_name == NULL)
+	{
+		proto_name = "all";
+	}
+	for(proto = 0; proto < BENCH_PROTO_MAX; proto++)
+	{
+		if(!strcmp(proto_name, bench_proto_names[proto]))
+		{
+			break;
+		}
+	}
+	if(proto == BENCH_PROTO_MAX && strcmp(proto_name, "all") != 0)
+	{
+		fprintf(stderr, "unexpected kind of flows '%s'\n\n", proto_name);
+		usage();
+		goto error;
+	}
+
+	/* output the results columns names */
+	printf("BENCH\t"
+	       "\"flows\"\t"
+	       "\"IP version\"\t"
+	       "\"number of flows\"\t"
+	       "\"payload size (bytes)\"\t"
+	       "\"packets\"\t"
+	       "\"packets/s\"\t"
+	       "\"ns/packet\"\t"
+	       "\"compression ns/packet\"\t"
+	       "\"decompression ns/packet\"\t"
+	       "\"compression cycles/packet\"\t"
+	       "\"decompression cycles/packet\"\t"
+	       "\"compression ratio (%%)\"\t"
+	       "\"decompression failures\"\t"
+	       "\"peak RSS (kB)\"\n");
+	if(params.instances_nr > 1)
+	{
+		printf("INSTANCES\t"
+		       "\"flows\"\t"
+		       "\"IP version\"\t"
+		       "\"instances\"\t"
+		       "\"flows per instance\"\t"
+		       "\"creation ns/instance\"\t"
+		       "\"RSS per instance (kB)\"\t"
+		       "\"LLC miss rate (%%)\"\t"
+		       "\"aggregate packets/s\"\n");
+	}
+	fflush(stdout);
+
+	/* run the benchmark for every kind of flows and every IP version */
+	for(params.proto = 0; params.proto < BENCH_PROTO_MAX; params.proto++)
+	{
+		if(proto != BENCH_PROTO_MAX && params.proto != proto)
+		{
+			continue;
+		}
+		for(ipv = 4; ipv <= 6; ipv += 2)
+		{
+			if(ip_version != 0 && ipv != (unsigned int) ip_version)
+			{
+				continue;
+			}
+			params.ip_version = ipv;
+			if(bench_run(&params) != 0)
+			{
+				goto error;
+			}
+		}
+	}
+
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the benchmark application
+ */
+static void usage(void)
+{
+	printf("The ROHC benchmark tool measures the throughput of the ROHC library\n"
+	       "\n"
+	       "The rohc_bench tool generates synthetic flows, compresses them,\n"
+	       "then decompresses them. It outputs one line of results per kind\n"
+	       "of flows and per IP version, with the following tab-separated\n"
+	       "fields:\n\n"
+	       "  * keyword 'BENCH'\n\n"
+	       "  * kind of flows\n\n"
+	       "  * IP version\n\n"
+	       "  * number of flows\n\n"
+	       "  * payload size (bytes)\n\n"
+	       "  * number of packets\n\n"
+	       "  * packets compressed and decompressed per second\n\n"
+	       "  * nanoseconds per packet (compression + decompression)\n\n"
+	       "  * compression nanoseconds per packet\n\n"
+	       "  * decompression nanoseconds per packet\n\n"
+	       "  * compression CPU cycles per packet (0 if not available)\n\n"
+	       "  * decompression CPU cycles per packet (0 if not available)\n\n"
+	       "  * compression ratio (%%)\n\n"
+	       "  * number of decompression failures\n\n"
+	       "  * peak resident memory (kB)\n\n"
+	       "With more than one instance, it also outputs one line per kind\n"
+	       "of flows and per IP version with the following fields:\n\n"
+	       "  * keyword 'INSTANCES'\n\n"
+	       "  * kind of flows\n\n"
+	       "  * IP version\n\n"
+	       "  * number of compressor/decompressor pairs\n\n"
+	       "  * number of flows per pair\n\n"
+	       "  * nanoseconds to create one pair\n\n"
+	       "  * resident memory per pair (kB)\n\n"
+	       "  * last-level cache miss rate (%%, '-' if not available)\n\n"
+	       "  * aggregate packets compressed and decompressed per second\n\n"
+	       "\n"
+	       "Usage: rohc_bench [OPTIONS] [FLOWS]\n"
+	       "\n"
+	       "Options:\n"
+	       "  -v, --version             Print version information and exit\n"
+	       "  -h, --help                Print this usage and exit\n"
+	       "      --flows NUM           The number of flows per instance,\n"
+	       "                            from 1 to %u (default 1)\n"
+	       "      --instances NUM       The number of compressor/decompressor\n"
+	       "                            pairs that share the packets in\n"
+	       "                            round-robin, from 1 to %u (default 1)\n"
+	       "      --size NUM            The size of the payloads (bytes),\n"
+	       "                            up to %u (default 100)\n"
+	       "      --packets NUM         The number of packets to generate\n"
+	       "                            (default 1000000)\n"
+	       "      --ip VERSION          Generate only IPv4 or IPv6 flows\n"
+	       "      --change-rate PERCENT The percentage of packets that change\n"
+	       "                            the TOS, TTL, IP-ID, or RTP TS of their\n"
+	       "                            flow (default 0)\n"
+	       "      --loss-rate PERCENT   The percentage of ROHC packets lost\n"
+	       "                            before decompression (default 0)\n"
+	       "      --rohcv2              Use the ROHCv2 profiles if possible\n"
+	       "\n"
+	       "With:\n"
+	       "  FLOWS     The kind of flows among 'udp', 'rtp', 'tcp', 'esp',\n"
+	       "            or 'all' (default)\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_bench                          Benchmark all kinds of flows\n"
+	       "  rohc_bench --flows 16384 --ip 6 tcp Benchmark many IPv6/TCP flows\n"
+	       "  rohc_bench --loss-rate 1 rtp        Benchmark RTP flows with losses\n"
+	       "  rohc_bench --instances 10000 --flows 4 udp\n"
+	       "                                      Benchmark many small instances\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       BENCH_FLOWS_MAX, BENCH_INSTANCES_MAX, BENCH_PAYLOAD_MAX_LEN);
+}
+
+
+/**
+ * @brief Run one benchmark in a child process
+ *
+ * The child process reports the memory used by the library alone.
+ *
+ * @param params  The parameters of the benchmark
+ * @return        0 in case of success,
+ *                1 in case of failure
+ */
+static int bench_run(const struct bench_params *const params)
+{
+	int child_status;
+	pid_t pid;
+
+	pid = fork();
+	if(pid < 0)
+	{
+		fprintf(stderr, "failed to create child process: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+	else if(pid == 0)
+	{
+		exit(bench_run_child(params));
+	}
+
+	if(waitpid(pid, &child_status, 0) != pid)
+	{
+		fprintf(stderr, "failed to wait for child process: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+	if(!WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0)
+	{
+		fprintf(stderr, "benchmark of %s/IPv%u flows failed\n",
+		        bench_proto_names[params->proto], params->ip_version);
+		goto error;
+	}
+
+	return 0;
+
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Run one benchmark
+ *
+ * The packets are generated, compressed, then decompressed, by batches of
+ * \ref BENCH_BATCH_LEN packets. Only the compression and decompression are
+ * measured. The packets are given to the compressor/decompressor pairs in
+ * round-robin, every pair handling its own flows.
+ *
+ * @param params  The parameters of the benchmark
+ * @return        0 in case of success,
+ *                1 in case of failure
+ */
+static int bench_run_child(const struct bench_params *const params)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const rohc_cid_type_t cid_type =
+		(params->flows_nr > (ROHC_SMALL_CID_MAX + 1) ? ROHC_LARGE_CID : ROHC_SMALL_CID);
+	struct rohc_comp **comps;
+	struct rohc_decomp **decomps;
+	struct bench_results results;
+	struct bench_perf perf;
+	struct bench_flow *flows;
+	uint8_t *uncomp_bufs;
+	uint8_t *rohc_bufs;
+	struct rohc_buf uncomp_pkts[BENCH_BATCH_LEN];
+	struct rohc_buf rohc_pkts[BENCH_BATCH_LEN];
+	bool is_lost[BENCH_BATCH_LEN];
+	size_t instances[BENCH_BATCH_LEN];
+	uint8_t decomp_buf[BENCH_ROHC_MAX_LEN];
+	uint64_t rand_state = 0x9e3779b97f4a7c15ULL;
+	struct rusage usage;
+	const size_t flows_nr = params->instances_nr * params->flows_nr;
+	unsigned long pkts_nr = 0;
+	size_t next_instance = 0;
+	long rss_before;
+	long rss_after;
+	uint64_t start_ns;
+	size_t i;
+
+	int is_failure = 1;
+
+	memset(&results, 0, sizeof(struct bench_results));
+
+	comps = calloc(params->instances_nr, sizeof(struct rohc_comp *));
+	if(comps == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the compressors\n");
+		goto error;
+	}
+	decomps = calloc(params->instances_nr, sizeof(struct rohc_decomp *));
+	if(decomps == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the decompressors\n");
+		goto free_comps;
+	}
+
+	/* create all the compressor/decompressor pairs */
+	rss_before = bench_get_rss();
+	start_ns = bench_get_ns();
+	for(i = 0; i < params->instances_nr; i++)
+	{
+		comps[i] = bench_create_comp(params, cid_type, params->flows_nr - 1);
+		if(comps[i] == NULL)
+		{
+			goto free_instances;
+		}
+		decomps[i] = bench_create_decomp(params, cid_type, params->flows_nr - 1);
+		if(decomps[i] == NULL)
+		{
+			goto free_instances;
+		}
+	}
+	results.create_ns = bench_get_ns() - start_ns;
+
+	flows = calloc(flows_nr, sizeof(struct bench_flow));
+	if(flows == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the flows\n");
+		goto free_instances;
+	}
+	for(i = 0; i < flows_nr; i++)
+	{
+		bench_init_flow(params, &flows[i], i, &rand_state);
+	}
+
+	uncomp_bufs = malloc(BENCH_BATCH_LEN * BENCH_PKT_MAX_LEN);
+	if(uncomp_bufs == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the packets\n");
+		goto free_flows;
+	}
+	rohc_bufs = malloc(BENCH_BATCH_LEN * BENCH_ROHC_MAX_LEN);
+	if(rohc_bufs == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the ROHC packets\n");
+		goto free_uncomp_bufs;
+	}
+
+	bench_perf_open(&perf);
+
+	while(pkts_nr < params->pkts_nr)
+	{
+		const size_t batch_len =
+			((params->pkts_nr - pkts_nr) < BENCH_BATCH_LEN ?
+			 (params->pkts_nr - pkts_nr) : BENCH_BATCH_LEN);
+		uint64_t start_cycles;
+
+		/* generate one batch of packets on random flows of the pairs of
+		 * compressor/decompressor taken in round-robin */
+		for(i = 0; i < batch_len; i++)
+		{
+			struct bench_flow *const flow =
+				&flows[next_instance * params->flows_nr +
+				       bench_rand(&rand_state) % params->flows_nr];
+			uint8_t *const uncomp_buf = uncomp_bufs + i * BENCH_PKT_MAX_LEN;
+
+			instances[i] = next_instance;
+			next_instance = (next_instance + 1) % params->instances_nr;
+
+			uncomp_pkts[i] = (struct rohc_buf)
+				rohc_buf_init_full(uncomp_buf,
+				                   bench_gen_pkt(params, flow, &rand_state, uncomp_buf),
+				                   arrival_time);
+			rohc_pkts[i] = (struct rohc_buf)
+				rohc_buf_init_empty(rohc_bufs + i * BENCH_ROHC_MAX_LEN,
+				                    BENCH_ROHC_MAX_LEN);
+			is_lost[i] = bench_rand_percent(&rand_state, params->loss_rate);
+		}
+
+		/* compress the batch */
+		bench_perf_enable(&perf, true);
+		start_ns = bench_get_ns();
+		start_cycles = bench_get_cycles();
+		for(i = 0; i < batch_len; i++)
+		{
+			if(rohc_compress4(comps[instances[i]], uncomp_pkts[i],
+			                  &rohc_pkts[i]) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "failed to compress packet #%lu\n", pkts_nr + i + 1);
+				goto close_perf;
+			}
+		}
+		results.comp_cycles += bench_get_cycles() - start_cycles;
+		results.comp_ns += bench_get_ns() - start_ns;
+		bench_perf_enable(&perf, false);
+		results.comp_pkts += batch_len;
+
+		for(i = 0; i < batch_len; i++)
+		{
+			results.uncomp_bytes += uncomp_pkts[i].len;
+			results.comp_bytes += rohc_pkts[i].len;
+		}
+
+		/* decompress the ROHC packets that were not lost */
+		bench_perf_enable(&perf, true);
+		start_ns = bench_get_ns();
+		start_cycles = bench_get_cycles();
+		for(i = 0; i < batch_len; i++)
+		{
+			struct rohc_buf decomp_pkt =
+				rohc_buf_init_empty(decomp_buf, BENCH_ROHC_MAX_LEN);
+
+			if(is_lost[i])
+			{
+				continue;
+			}
+			if(rohc_decompress3(decomps[instances[i]], rohc_pkts[i], &decomp_pkt,
+			                    NULL, NULL) != ROHC_STATUS_OK)
+			{
+				results.decomp_errs++;
+			}
+			results.decomp_pkts++;
+		}
+		results.decomp_cycles += bench_get_cycles() - start_cycles;
+		results.decomp_ns += bench_get_ns() - start_ns;
+		bench_perf_enable(&perf, false);
+
+		pkts_nr += batch_len;
+	}
+
+	/* the memory of the contexts is allocated along the traffic */
+	rss_after = bench_get_rss();
+	results.rss_delta = (rss_after > rss_before ? rss_after - rss_before : 0);
+	results.has_llc = bench_perf_read(&perf, &results.llc_misses,
+	                                  &results.llc_refs);
+
+	/* the peak memory of the process, ie. the memory used by the library */
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		usage.ru_maxrss = 0;
+	}
+	bench_print_results(params, &results, usage.ru_maxrss);
+	if(params->instances_nr > 1)
+	{
+		bench_print_instances(params, &results);
+	}
+
+	is_failure = 0;
+
+close_perf:
+	bench_perf_close(&perf);
+	free(rohc_bufs);
+free_uncomp_bufs:
+	free(uncomp_bufs);
+free_flows:
+	free(flows);
+free_instances:
+	for(i = 0; i < params->instances_nr; i++)
+	{
+		if(decomps[i] != NULL)
+		{
+			rohc_decomp_free(decomps[i]);
+		}
+		if(comps[i] != NULL)
+		{
+			rohc_comp_free(comps[i]);
+		}
+	}
+	free(decomps);
+free_comps:
+	free(comps);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Create the ROHC compressor of one benchmark
+ *
+ * @param params    The parameters of the benchmark
+ * @param cid_type  The type of CIDs the compressor shall use
+ * @param max_cid   The largest CID the compressor shall use
+ * @return          The new compressor, NULL in case of failure
+ */
+static struct rohc_comp * bench_create_comp(const struct bench_params *const params,
+                                            const rohc_cid_type_t cid_type,
+                                            const rohc_cid_t max_cid)
+{
+	struct rohc_comp *comp;
+	bool is_ok;
+
+	comp = rohc_comp_new2(cid_type, max_cid, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+
+	/* enable profiles, there is no ROHCv2 profile for TCP */
+	if(params->use_rohcv2)
+	{
+		is_ok = rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                  ROHCv2_PROFILE_IP_UDP_RTP,
+		                                  ROHCv2_PROFILE_IP_UDP,
+		                                  ROHCv2_PROFILE_IP_ESP, ROHCv2_PROFILE_IP,
+		                                  ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	else
+	{
+		is_ok = rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                  ROHCv1_PROFILE_IP_UDP_RTP,
+		                                  ROHCv1_PROFILE_IP_UDP,
+		                                  ROHCv1_PROFILE_IP_ESP, ROHCv1_PROFILE_IP,
+		                                  ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	if(!is_ok)
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create the ROHC decompressor of one benchmark
+ *
+ * @param params    The parameters of the benchmark
+ * @param cid_type  The type of CIDs the decompressor shall use
+ * @param max_cid   The largest CID the decompressor shall use
+ * @return          The new decompressor, NULL in case of failure
+ */
+static struct rohc_decomp * bench_create_decomp(const struct bench_params *const params,
+                                                const rohc_cid_type_t cid_type,
+                                                const rohc_cid_t max_cid)
+{
+	struct rohc_decomp *decomp;
+	bool is_ok;
+
+	decomp = rohc_decomp_new2(cid_type, max_cid, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto error;
+	}
+
+	/* enable profiles, there is no ROHCv2 profile for TCP */
+	if(params->use_rohcv2)
+	{
+		is_ok = rohc_decomp_enable_profiles(decomp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                    ROHCv2_PROFILE_IP_UDP_RTP,
+		                                    ROHCv2_PROFILE_IP_UDP,
+		                                    ROHCv2_PROFILE_IP_ESP,
+		                                    ROHCv2_PROFILE_IP,
+		                                    ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	else
+	{
+		is_ok = rohc_decomp_enable_profiles(decomp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                    ROHCv1_PROFILE_IP_UDP_RTP,
+		                                    ROHCv1_PROFILE_IP_UDP,
+		                                    ROHCv1_PROFILE_IP_ESP,
+		                                    ROHCv1_PROFILE_IP,
+		                                    ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	if(!is_ok)
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Initialize one generated flow
+ *
+ * @param params               The parameters of the benchmark
+ * @param[out] flow            The flow to initialize
+ * @param id                   The index of the flow
+ * @param[in,out] rand_state   The state of the random generator
+ */
+static void bench_init_flow(const struct bench_params *const params,
+                            struct bench_flow *const flow,
+                            const size_t id,
+                            uint64_t *const rand_state)
+{
+	flow->id = id;
+	flow->tos = 0;
+	flow->ttl = 64;
+	flow->ip_id = bench_rand(rand_state);
+	flow->sport = 10000 + id;
+	flow->dport = (params->proto == BENCH_PROTO_RTP ? BENCH_RTP_PORT : 80);
+	flow->rtp_sn = bench_rand(rand_state);
+	flow->rtp_ts = bench_rand(rand_state);
+	flow->ssrc = bench_rand(rand_state);
+	flow->tcp_seq = bench_rand(rand_state);
+	flow->tcp_ack = bench_rand(rand_state);
+	flow->tcp_win = 0xffff;
+	flow->tcp_tsval = bench_rand(rand_state);
+	flow->esp_spi = 0x1000 + id;
+	flow->esp_sn = 1;
+}
+
+
+/**
+ * @brief Generate the next packet of one flow
+ *
+ * @param params               The parameters of the benchmark
+ * @param flow                 The flow
+ * @param[in,out] rand_state   The state of the random generator
+ * @param[out] pkt             The generated packet,
+ *                             \ref BENCH_PKT_MAX_LEN bytes at most
+ * @return                     The length of the generated packet
+ */
+static size_t bench_gen_pkt(const struct bench_params *const params,
+                            struct bench_flow *const flow,
+                            uint64_t *const rand_state,
+                            uint8_t *const pkt)
+{
+	const size_t ip_hdr_len = (params->ip_version == 4 ? 20 : 40);
+	uint8_t *const l4 = pkt + ip_hdr_len;
+	uint8_t *payload;
+	size_t l4_len;
+	uint8_t protocol;
+	uint32_t csum;
+
+	/* some packets change the fields of their flow */
+	if(bench_rand_percent(rand_state, params->change_rate))
+	{
+		flow->tos ^= 0x04;
+		flow->ttl = 32 + (bench_rand(rand_state) % 64);
+		flow->ip_id += bench_rand(rand_state) % 1000;
+		flow->rtp_ts += 8000;
+		flow->tcp_win ^= 0x0f00;
+	}
+	flow->ip_id++;
+
+	/* the transport headers and the payload */
+	if(params->proto == BENCH_PROTO_UDP || params->proto == BENCH_PROTO_RTP)
+	{
+		const size_t rtp_hdr_len = (params->proto == BENCH_PROTO_RTP ? 12 : 0);
+		protocol = 17;
+		l4_len = 8 + rtp_hdr_len + params->payload_len;
+		bench_put16(l4, flow->sport);
+		bench_put16(l4 + 2, flow->dport);
+		bench_put16(l4 + 4, l4_len);
+		bench_put16(l4 + 6, 0);
+		if(params->proto == BENCH_PROTO_RTP)
+		{
+			flow->rtp_sn++;
+			flow->rtp_ts += 160;
+			l4[8] = 0x80;
+			l4[9] = 96;
+			bench_put16(l4 + 10, flow->rtp_sn);
+			bench_put32(l4 + 12, flow->rtp_ts);
+			bench_put32(l4 + 16, flow->ssrc);
+		}
+		payload = l4 + 8 + rtp_hdr_len;
+	}
+	else if(params->proto == BENCH_PROTO_TCP)
+	{
+		protocol = 6;
+		l4_len = BENCH_TCP_HDR_LEN + params->payload_len;
+		flow->tcp_tsval++;
+		bench_put16(l4, flow->sport);
+		bench_put16(l4 + 2, flow->dport);
+		bench_put32(l4 + 4, flow->tcp_seq);
+		bench_put32(l4 + 8, flow->tcp_ack);
+		l4[12] = (BENCH_TCP_HDR_LEN / 4) << 4;
+		l4[13] = 0x18; /* ACK + PSH */
+		bench_put16(l4 + 14, flow->tcp_win);
+		bench_put16(l4 + 16, 0);
+		bench_put16(l4 + 18, 0);
+		l4[20] = 1; /* NOP */
+		l4[21] = 1; /* NOP */
+		l4[22] = 8; /* TS */
+		l4[23] = 10;
+		bench_put32(l4 + 24, flow->tcp_tsval);
+		bench_put32(l4 + 28, 0);
+		flow->tcp_seq += params->payload_len;
+		payload = l4 + BENCH_TCP_HDR_LEN;
+	}
+	else /* BENCH_PROTO_ESP */
+	{
+		protocol = 50;
+		l4_len = 8 + params->payload_len;
+		bench_put32(l4, flow->esp_spi);
+		bench_put32(l4 + 4, flow->esp_sn);
+		flow->esp_sn++;
+		payload = l4 + 8;
+	}
+	memset(payload, flow->id & 0xff, params->payload_len);
+
+	/* the IP header */
+	if(params->ip_version == 4)
+	{
+		pkt[0] = 0x45;
+		pkt[1] = flow->tos;
+		bench_put16(pkt + 2, ip_hdr_len + l4_len);
+		bench_put16(pkt + 4, flow->ip_id);
+		bench_put16(pkt + 6, 0x4000); /* DF */
+		pkt[8] = flow->ttl;
+		pkt[9] = protocol;
+		bench_put16(pkt + 10, 0);
+		pkt[12] = 10;
+		pkt[13] = (flow->id >> 8) & 0xff;
+		pkt[14] = flow->id & 0xff;
+		pkt[15] = 1;
+		pkt[16] = 192;
+		pkt[17] = 168;
+		pkt[18] = 0;
+		pkt[19] = 1;
+		bench_put16(pkt + 10, bench_csum_fold(bench_csum_add(0, pkt, ip_hdr_len)));
+		csum = bench_csum_add(0, pkt + 12, 8);
+	}
+	else
+	{
+		bench_put32(pkt, 0x60000000U | (((uint32_t) flow->tos) << 20) | flow->id);
+		bench_put16(pkt + 4, l4_len);
+		pkt[6] = protocol;
+		pkt[7] = flow->ttl;
+		memset(pkt + 8, 0, 32);
+		bench_put32(pkt + 8, 0x20010db8U);
+		bench_put16(pkt + 22, flow->id);
+		bench_put32(pkt + 24, 0x20010db8U);
+		bench_put16(pkt + 38, 1);
+		csum = bench_csum_add(0, pkt + 8, 32);
+	}
+
+	/* the UDP and TCP checksums over the pseudo IP header */
+	if(protocol == 17 || protocol == 6)
+	{
+		const size_t csum_offset = (protocol == 17 ? 6 : 16);
+		uint16_t check;
+		csum += protocol + l4_len;
+		check = bench_csum_fold(bench_csum_add(csum, l4, l4_len));
+		bench_put16(l4 + csum_offset, (check == 0 ? 0xffff : check));
+	}
+
+	return ip_hdr_len + l4_len;
+}
+
+
+/**
+ * @brief Print the results of one benchmark
+ *
+ * @param params    The parameters of the benchmark
+ * @param results   The results of the benchmark
+ * @param peak_rss  The peak resident memory of the benchmark (kB)
+ */
+static void bench_print_results(const struct bench_params *const params,
+                                const struct bench_results *const results,
+                                const long peak_rss)
+{
+	const uint64_t total_ns = results->comp_ns + results->decomp_ns;
+	const double pkts_per_sec =
+		(total_ns > 0 ? results->comp_pkts * 1e9 / total_ns : 0.0);
+	const double comp_ns = ((double) results->comp_ns) / results->comp_pkts;
+	const double decomp_ns = (results->decomp_pkts > 0 ?
+	                          ((double) results->decomp_ns) / results->decomp_pkts :
+	                          0.0);
+	const double comp_cycles = ((double) results->comp_cycles) / results->comp_pkts;
+	const double decomp_cycles = (results->decomp_pkts > 0 ?
+	                              ((double) results->decomp_cycles) /
+	                              results->decomp_pkts : 0.0);
+	const double ratio = (results->uncomp_bytes > 0 ?
+	                      results->comp_bytes * 100.0 / results->uncomp_bytes :
+	                      0.0);
+
+	printf("BENCH\t%s\t%u\t%zu\t%zu\t%lu\t%.0f\t%.1f\t%.1f\t%.1f\t%.0f\t%.0f\t"
+	       "%.2f\t%lu\t%ld\n", bench_proto_names[params->proto],
+	       params->ip_version, params->flows_nr, params->payload_len,
+	       results->comp_pkts, pkts_per_sec, comp_ns + decomp_ns, comp_ns,
+	       decomp_ns, comp_cycles, decomp_cycles, ratio, results->decomp_errs,
+	       peak_rss);
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Print the results of one benchmark specific to many instances
+ *
+ * @param params    The parameters of the benchmark
+ * @param results   The results of the benchmark
+ */
+static void bench_print_instances(const struct bench_params *const params,
+                                  const struct bench_results *const results)
+{
+	const uint64_t total_ns = results->comp_ns + results->decomp_ns;
+	const double pkts_per_sec =
+		(total_ns > 0 ? results->comp_pkts * 1e9 / total_ns : 0.0);
+	const double create_ns =
+		((double) results->create_ns) / params->instances_nr;
+	const double rss = ((double) results->rss_delta) / params->instances_nr;
+	char llc_rate[32];
+
+	if(results->has_llc && results->llc_refs > 0)
+	{
+		snprintf(llc_rate, sizeof(llc_rate), "%.2f",
+		         results->llc_misses * 100.0 / results->llc_refs);
+	}
+	else
+	{
+		snprintf(llc_rate, sizeof(llc_rate), "-");
+	}
+
+	printf("INSTANCES\t%s\t%u\t%zu\t%zu\t%.0f\t%.2f\t%s\t%.0f\n",
+	       bench_proto_names[params->proto], params->ip_version,
+	       params->instances_nr, params->flows_nr, create_ns, rss, llc_rate,
+	       pkts_per_sec);
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Open the hardware counters of the last-level cache
+ *
+ * The counters are opened disabled. They are not available if the kernel
+ * or the CPU does not provide them, or if the user is not allowed to use
+ * them.
+ *
+ * @param[out] perf  The counters
+ */
+static void bench_perf_open(struct bench_perf *const perf)
+{
+	perf->misses_fd = -1;
+	perf->refs_fd = -1;
+
+#ifdef BENCH_HAVE_PERF
+	{
+		struct perf_event_attr attr;
+
+		memset(&attr, 0, sizeof(struct perf_event_attr));
+		attr.size = sizeof(struct perf_event_attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		/* the cache misses lead the group of counters */
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		perf->misses_fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		if(perf->misses_fd < 0)
+		{
+			perf->misses_fd = -1;
+			return;
+		}
+		attr.config = PERF_COUNT_HW_CACHE_REFERENCES;
+		attr.disabled = 0;
+		perf->refs_fd = syscall(__NR_perf_event_open, &attr, 0, -1,
+		                        perf->misses_fd, 0);
+		if(perf->refs_fd < 0)
+		{
+			close(perf->misses_fd);
+			perf->misses_fd = -1;
+			perf->refs_fd = -1;
+		}
+	}
+#endif
+}
+
+
+/**
+ * @brief Start or stop the hardware counters of the last-level cache
+ *
+ * @param perf    The counters
+ * @param enable  true to start the counters, false to stop them
+ */
+static void bench_perf_enable(const struct bench_perf *const perf,
+                              const bool enable)
+{
+#ifdef BENCH_HAVE_PERF
+	if(perf->misses_fd >= 0)
+	{
+		const unsigned long request =
+			(enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE);
+		if(ioctl(perf->misses_fd, request, PERF_IOC_FLAG_GROUP) != 0)
+		{
+			fprintf(stderr, "failed to %s the cache counters\n",
+			        enable ? "start" : "stop");
+		}
+	}
+#endif
+}
+
+
+/**
+ * @brief Read the hardware counters of the last-level cache
+ *
+ * @param perf         The counters
+ * @param[out] misses  The number of cache misses
+ * @param[out] refs    The number of cache references
+ * @return             true if the counters are available,
+ *                     false otherwise
+ */
+static bool bench_perf_read(const struct bench_perf *const perf,
+                            uint64_t *const misses,
+                            uint64_t *const refs)
+{
+	*misses = 0;
+	*refs = 0;
+
+	if(perf->misses_fd < 0 || perf->refs_fd < 0)
+	{
+		return false;
+	}
+	if(read(perf->misses_fd, misses, sizeof(uint64_t)) != sizeof(uint64_t) ||
+	   read(perf->refs_fd, refs, sizeof(uint64_t)) != sizeof(uint64_t))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Close the hardware counters of the last-level cache
+ *
+ * @param perf  The counters
+ */
+static void bench_perf_close(struct bench_perf *const perf)
+{
+	if(perf->refs_fd >= 0)
+	{
+		close(perf->refs_fd);
+		perf->refs_fd = -1;
+	}
+	if(perf->misses_fd >= 0)
+	{
+		close(perf->misses_fd);
+		perf->misses_fd = -1;
+	}
+}
+
+
+/**
+ * @brief Get the current resident memory of the process
+ *
+ * @return  The current resident memory (kB), 0 if not available
+ */
+static long bench_get_rss(void)
+{
+	const long page_size = sysconf(_SC_PAGESIZE);
+	unsigned long vm_size;
+	unsigned long rss_pages;
+	FILE *statm;
+	long rss = 0;
+
+	statm = fopen("/proc/self/statm", "r");
+	if(statm == NULL)
+	{
+		goto error;
+	}
+	if(fscanf(statm, "%lu %lu", &vm_size, &rss_pages) == 2 && page_size > 0)
+	{
+		rss = rss_pages * (page_size / 1024);
+	}
+	fclose(statm);
+
+error:
+	return rss;
+}
+
+
+/**
+ * @brief Get the next number of the pseudo-random generator
+ *
+ * The xorshift64* generator is used, so that the benchmark generates the
+ * very same packets every time.
+ *
+ * @param[in,out] state  The state of the generator
+ * @return               The next pseudo-random number
+ */
+static uint64_t bench_rand(uint64_t *const state)
+{
+	(*state) ^= (*state) >> 12;
+	(*state) ^= (*state) << 25;
+	(*state) ^= (*state) >> 27;
+	return (*state) * 0x2545f4914f6cdd1dULL;
+}
+
+
+/**
+ * @brief Draw one event with the given probability
+ *
+ * @param[in,out] state  The state of the pseudo-random generator
+ * @param percent        The probability of the event (%)
+ * @return               Whether the event occurs or not
+ */
+static bool bench_rand_percent(uint64_t *const state, const double percent)
+{
+	if(percent <= 0.0)
+	{
+		return false;
+	}
+	return ((bench_rand(state) % 1000000U) < (percent * 10000.0));
+}
+
+
+/**
+ * @brief Get the current monotonic time
+ *
+ * @return  The current time (ns)
+ */
+static uint64_t bench_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+
+/**
+ * @brief Get the current number of CPU cycles
+ *
+ * @return  The current number of CPU cycles, 0 if not available
+ */
+static uint64_t bench_get_cycles(void)
+{
+#ifdef BENCH_HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Add some bytes to one Internet checksum
+ *
+ * @param sum   The checksum being computed
+ * @param data  The bytes to add
+ * @param len   The number of bytes to add
+ * @return      The checksum being computed, not folded yet
+ */
+static uint32_t bench_csum_add(uint32_t sum,
+                               const uint8_t *const data,
+                               const size_t len)
+{
+	size_t i;
+
+	for(i = 0; (i + 1) < len; i += 2)
+	{
+		sum += (((uint32_t) data[i]) << 8) | data[i + 1];
+	}
+	if(i < len)
+	{
+		sum += ((uint32_t) data[i]) << 8;
+	}
+
+	return sum;
+}
+
+
+/**
+ * @brief Fold one Internet checksum
+ *
+ * @param sum  The checksum being computed
+ * @return     The final checksum
+ */
+static uint16_t bench_csum_fold(uint32_t sum)
+{
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	return (~sum) & 0xffff;
+}
+
+
+/**
+ * @brief Write one 16-bit field in network byte order
+ *
+ * @param buf    The buffer to write the field in
+ * @param value  The value of the field
+ */
+static void bench_put16(uint8_t *const buf, const uint16_t value)
+{
+	buf[0] = (value >> 8) & 0xff;
+	buf[1] = value & 0xff;
+}
+
+
+/**
+ * @brief Write one 32-bit field in network byte order
+ *
+ * @param buf    The buffer to write the field in
+ * @param value  The value of the field
+ */
+static void bench_put32(uint8_t *const buf, const uint32_t value)
+{
+	bench_put16(buf, (value >> 16) & 0xffff);
+	bench_put16(buf + 2, value & 0xffff);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp __attribute__((unused)),
+                          void *const user_context __attribute__((unused)))
+{
+	return rand();
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	if(udp == NULL)
+	{
+		return false;
+	}
+	return (((udp[2] << 8) | udp[3]) == BENCH_RTP_PORT);
+}
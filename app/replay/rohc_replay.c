@@ -0,0 +1,1692 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_replay.c
+ * @brief  ROHC traffic generator for the load testing of decompressors
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The program loads the IP packets of one PCAP file, compresses all of them
+ * with the library, then replays the resulting ROHC packets from memory on
+ * one network device, at a given rate or as fast as possible. The ROHC
+ * packets are sent in batches with sendmmsg(2) on one AF_PACKET socket, or
+ * through one AF_PACKET TX ring. The achieved rate is reported at the end of
+ * the replay.
+ *
+ * The ROHC packets are computed once before the replay, so the compressor
+ * cannot react to the feedback of the decompressor under test. With
+ * --feedback, the IP packets are compressed during the replay instead, and
+ * the ROHC feedback received on the network device is delivered to the
+ * compressor between two batches of packets. The rate is then bound by the
+ * compressor.
+ *
+ * The ROHC packets are sent in Ethernet frames with the ROHC Ethertype on
+ * Ethernet devices, or without link layer header on raw IP devices.
+ */
+
+#include "config.h" /* for PACKAGE_BUGREPORT */
+
+/* system includes */
+#define _GNU_SOURCE /* for sendmmsg(2) */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h> /* for PRIu64 */
+#include <time.h> /* for clock_gettime(2) */
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <linux/if_packet.h>
+#if defined(PACKET_TX_RING) && defined(TPACKET2_HDRLEN)
+#  define REPLAY_HAVE_TX_RING  1
+#endif
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/ipv6.h>
+
+/* include for the PCAP library */
+#if HAVE_PCAP_PCAP_H == 1
+#  include <pcap/pcap.h>
+#elif HAVE_PCAP_H == 1
+#  include <pcap.h>
+#else
+#  error "pcap.h header not found, did you specified --enable-app-replay \
+for ./configure ? If yes, check configure output and config.log"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+
+
+/** The device MTU */
+#define DEV_MTU  0xffffU
+
+/** The maximal size for the ROHC packets */
+#define MAX_ROHC_SIZE  (DEV_MTU + 100U)
+
+/** The maximum number of bytes the ROHC packet adds to the IP packet */
+#define REPLAY_ROHC_OVERHEAD  (MAX_ROHC_SIZE - DEV_MTU)
+
+/** The length of the Linux Cooked Sockets header */
+#define LINUX_COOKED_HDR_LEN  16U
+
+/** The length (in bytes) of the Ethernet address */
+#define ETH_ALEN  6U
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** The minimum Ethernet length (in bytes) */
+#define ETHER_FRAME_MIN_LEN  60U
+
+/** The 10Mb/s ethernet header */
+struct ether_header
+{
+	uint8_t ether_dhost[ETH_ALEN];  /**< destination eth addr */
+	uint8_t ether_shost[ETH_ALEN];  /**< source ether addr */
+	uint16_t ether_type;            /**< packet type ID field */
+} __attribute__((__packed__));
+
+/** The Ethertype for the 802.1q protocol (VLAN) */
+#define ETHERTYPE_8021Q   0x8100U
+/** The Ethertype for the 802.1ad protocol */
+#define ETHERTYPE_8021AD  0x88a8U
+
+/** The Ethertype assigned to ROHC by IEEE */
+#define ETHERTYPE_ROHC  0x22f1U
+
+/** The VLAN header */
+struct vlan_hdr
+{
+	uint16_t vid;  /**< The PCP, DEI and VID fields */
+	uint16_t type; /**< The Ethertype of the next header */
+} __attribute__((packed));
+
+/** The default number of ROHC packets sent per system call */
+#define REPLAY_BATCH_DEFAULT  32U
+/** The maximum number of ROHC packets sent per system call */
+#define REPLAY_BATCH_MAX  1024U
+
+/** The initial size (in bytes) of the memory that stores the packets */
+#define REPLAY_STORE_INIT_LEN  (16U * 1024U * 1024U)
+
+/** The minimum size (in bytes) of the frames of the TX ring */
+#define REPLAY_RING_FRAME_MIN_SIZE  2048U
+/** The size (in bytes) of one block of the TX ring */
+#define REPLAY_RING_BLOCK_SIZE  (1024U * 1024U)
+/** The number of blocks of the TX ring */
+#define REPLAY_RING_BLOCKS_NR  16U
+
+
+/** The parameters of the replay */
+struct replay_params
+{
+	rohc_cid_type_t cid_type;     /**< The type of CIDs */
+	size_t max_contexts;          /**< The maximum number of ROHC contexts */
+	int rohc_version;             /**< The ROHC version: 1 or 2 */
+	uint64_t rate;                /**< The packets sent per second,
+	                                   0 for as fast as possible */
+	unsigned long loops_nr;       /**< The number of replays of the PCAP file,
+	                                   0 for infinite */
+	size_t batch_len;             /**< The packets sent per system call */
+	bool use_tx_ring;             /**< Whether to send through a TX ring */
+	bool do_feedback;             /**< Whether to compress during the replay
+	                                   and handle the received feedback */
+	uint8_t dst_mac[ETH_ALEN];    /**< The destination Ethernet address */
+};
+
+/** One packet stored in memory for the replay */
+struct replay_pkt
+{
+	size_t offset;   /**< The offset of the packet in the store */
+	size_t len;      /**< The length of the packet (bytes) */
+	size_t ip_len;   /**< The length of the original IP packet (bytes) */
+};
+
+/** The packets stored back to back in memory for the replay */
+struct replay_store
+{
+	uint8_t *data;             /**< The data of all the packets */
+	size_t data_len;           /**< The length of the data in use */
+	size_t data_max;           /**< The allocated length of the data */
+	struct replay_pkt *pkts;   /**< The packets */
+	size_t pkts_nr;            /**< The number of packets */
+	size_t pkts_max;           /**< The allocated number of packets */
+	size_t max_len;            /**< The length of the largest packet */
+	bool is_rohc;              /**< Whether ROHC or IP packets are stored */
+};
+
+/** The network device the ROHC packets are sent on */
+struct replay_link
+{
+	int fd;                        /**< The AF_PACKET socket */
+	uint8_t hdr[ETHER_HDR_LEN];    /**< The link layer header of the frames */
+	size_t hdr_len;                /**< The length of the link layer header,
+	                                    0 on raw IP devices */
+#ifdef REPLAY_HAVE_TX_RING
+	uint8_t *ring;                 /**< The TX ring, NULL if none */
+	size_t ring_len;               /**< The length of the TX ring (bytes) */
+	size_t frame_size;             /**< The size of the frames of the ring */
+	size_t frames_nr;              /**< The number of frames of the ring */
+	size_t frame_id;               /**< The next frame to fill */
+#endif
+};
+
+/** The results of the replay */
+struct replay_results
+{
+	unsigned long load_errs;       /**< The PCAP packets that were skipped */
+	unsigned long comp_errs;       /**< The compression failures */
+	unsigned long loops;           /**< The complete replays of the file */
+	unsigned long sent_pkts;       /**< The ROHC packets sent */
+	uint64_t sent_bytes;           /**< The bytes sent, link layer included */
+	uint64_t sent_rohc_bytes;      /**< The ROHC bytes sent */
+	uint64_t sent_ip_bytes;        /**< The IP bytes the ROHC packets carry */
+	unsigned long send_retries;    /**< The times the device was busy */
+	unsigned long send_errs;       /**< The ROHC packets the device refused */
+	unsigned long feedbacks_ok;    /**< The feedbacks delivered */
+	unsigned long feedbacks_ko;    /**< The feedbacks the compressor refused */
+	uint64_t elapsed_ns;           /**< The duration of the replay (ns) */
+};
+
+
+/** Whether the replay shall stop, set by the signal handler */
+static volatile sig_atomic_t stop_replay = 0;
+
+
+/* prototypes of private functions */
+static void usage(void);
+static void replay_interrupt(int signum);
+
+static struct rohc_comp * replay_create_comp(const struct replay_params *const params)
+	__attribute__((warn_unused_result, nonnull(1)));
+static int replay_load(const struct replay_params *const params,
+                       const char *const filename,
+                       struct rohc_comp *const comp,
+                       struct replay_store *const store,
+                       struct replay_results *const results)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
+static bool replay_store_add(struct replay_store *const store,
+                             const struct rohc_buf pkt,
+                             const size_t ip_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void replay_store_free(struct replay_store *const store)
+	__attribute__((nonnull(1)));
+
+static bool replay_link_open(const struct replay_params *const params,
+                             const char *const device_name,
+                             const size_t max_pkt_len,
+                             struct replay_link *const link)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static void replay_link_close(struct replay_link *const link)
+	__attribute__((nonnull(1)));
+static size_t replay_send_mmsg(struct replay_link *const link,
+                               struct iovec pkts[],
+                               const size_t pkts_nr,
+                               struct replay_results *const results)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+#ifdef REPLAY_HAVE_TX_RING
+static bool replay_ring_open(struct replay_link *const link,
+                             const size_t max_pkt_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static size_t replay_send_ring(struct replay_link *const link,
+                               struct iovec pkts[],
+                               const size_t pkts_nr,
+                               struct replay_results *const results)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+#endif
+static void replay_recv_feedback(struct replay_link *const link,
+                                 struct rohc_comp *const comp,
+                                 struct replay_results *const results)
+	__attribute__((nonnull(1, 2, 3)));
+
+static int replay_run(const struct replay_params *const params,
+                      struct rohc_comp *const comp,
+                      const struct replay_store *const store,
+                      struct replay_link *const link,
+                      struct replay_results *const results)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
+static void replay_print_results(const struct replay_results *const results)
+	__attribute__((nonnull(1)));
+
+static bool replay_parse_mac(const char *const str, uint8_t mac[ETH_ALEN])
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint64_t replay_get_ns(void)
+	__attribute__((warn_unused_result));
+static void replay_sleep_until(const uint64_t deadline_ns);
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+static bool detect_vlan_hdrs(const struct rohc_buf *const frame,
+                             size_t *const link_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/**
+ * @brief Main function for the ROHC replay program
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct replay_params params = {
+		.cid_type = ROHC_SMALL_CID,
+		.max_contexts = ROHC_SMALL_CID_MAX + 1,
+		.rohc_version = 1,
+		.rate = 0,
+		.loops_nr = 1,
+		.batch_len = REPLAY_BATCH_DEFAULT,
+		.use_tx_ring = false,
+		.do_feedback = false,
+		.dst_mac = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+	};
+	struct replay_store store;
+	struct replay_link link;
+	struct replay_results results;
+	struct rohc_comp *comp;
+	const char *cid_type_name = NULL;
+	const char *filename = NULL;
+	const char *device_name = NULL;
+	size_t max_possible_contexts;
+	int status = 1;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_replay version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "--max-contexts") ||
+		        !strcmp(*argv, "--rohc-version") ||
+		        !strcmp(*argv, "--rate") ||
+		        !strcmp(*argv, "--loops") ||
+		        !strcmp(*argv, "--batch") ||
+		        !strcmp(*argv, "--dst-mac"))
+		{
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory %s parameter\n", argv[0]);
+				usage();
+				goto error;
+			}
+			if(!strcmp(*argv, "--max-contexts"))
+			{
+				/* get the maximum number of contexts the compressor may use */
+				params.max_contexts = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--rohc-version"))
+			{
+				/* get the ROHC version to use */
+				params.rohc_version = atoi(argv[1]);
+			}
+			else if(!strcmp(*argv, "--rate"))
+			{
+				/* get the number of packets to send per second */
+				params.rate = strtoull(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--loops"))
+			{
+				/* get the number of replays of the PCAP file */
+				params.loops_nr = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--batch"))
+			{
+				/* get the number of packets to send per system call */
+				params.batch_len = strtoul(argv[1], NULL, 10);
+			}
+			else
+			{
+				/* get the destination Ethernet address */
+				if(!replay_parse_mac(argv[1], params.dst_mac))
+				{
+					fprintf(stderr, "malformed Ethernet address '%s'\n\n", argv[1]);
+					usage();
+					goto error;
+				}
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--tx-ring"))
+		{
+			/* send through one AF_PACKET TX ring instead of sendmmsg(2) */
+			params.use_tx_ring = true;
+		}
+		else if(!strcmp(*argv, "--feedback"))
+		{
+			/* compress during the replay and handle the received feedback */
+			params.do_feedback = true;
+		}
+		else if(cid_type_name == NULL)
+		{
+			/* get the type of CID to use within the ROHC library */
+			cid_type_name = argv[0];
+		}
+		else if(filename == NULL)
+		{
+			/* get the name of the PCAP file to replay */
+			filename = argv[0];
+		}
+		else if(device_name == NULL)
+		{
+			/* get the name of the network device to send the packets on */
+			device_name = argv[0];
+		}
+		else
+		{
+			/* do not accept more than one device */
+			usage();
+			goto error;
+		}
+	}
+
+	/* check the parameters */
+	if(cid_type_name == NULL || filename == NULL || device_name == NULL)
+	{
+		fprintf(stderr, "parameters CID_TYPE, FILE and DEVICE are mandatory\n\n");
+		usage();
+		goto error;
+	}
+	if(!strcmp(cid_type_name, "smallcid"))
+	{
+		params.cid_type = ROHC_SMALL_CID;
+		max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
+	}
+	else if(!strcmp(cid_type_name, "largecid"))
+	{
+		params.cid_type = ROHC_LARGE_CID;
+		max_possible_contexts = ROHC_LARGE_CID_MAX + 1;
+	}
+	else
+	{
+		fprintf(stderr, "invalid CID type '%s', only 'smallcid' and "
+		        "'largecid' expected\n\n", cid_type_name);
+		usage();
+		goto error;
+	}
+	if(params.max_contexts < 1 || params.max_contexts > max_possible_contexts)
+	{
+		fprintf(stderr, "the maximum number of ROHC contexts should be "
+		        "between 1 and %zu\n\n", max_possible_contexts);
+		usage();
+		goto error;
+	}
+	if(params.rohc_version != 1 && params.rohc_version != 2)
+	{
+		fprintf(stderr, "invalid ROHC version '%d': specify 1 for ROHCv1 and "
+		        "2 for ROHCv2\n\n", params.rohc_version);
+		usage();
+		goto error;
+	}
+	if(params.batch_len < 1 || params.batch_len > REPLAY_BATCH_MAX)
+	{
+		fprintf(stderr, "the number of packets per batch should be between 1 "
+		        "and %u\n\n", REPLAY_BATCH_MAX);
+		usage();
+		goto error;
+	}
+#ifndef REPLAY_HAVE_TX_RING
+	if(params.use_tx_ring)
+	{
+		fprintf(stderr, "AF_PACKET TX rings are not supported on this "
+		        "platform\n\n");
+		goto error;
+	}
+#endif
+
+	memset(&results, 0, sizeof(struct replay_results));
+	srand(time(NULL));
+
+	/* create the ROHC compressor */
+	comp = replay_create_comp(&params);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* load the PCAP file in memory, compressed unless feedback is handled */
+	if(replay_load(&params, filename, comp, &store, &results) != 0)
+	{
+		goto free_comp;
+	}
+
+	/* open the network device */
+	if(!replay_link_open(&params, device_name, store.max_len, &link))
+	{
+		goto free_store;
+	}
+
+	/* stop the replay gracefully on CTRL+C */
+	signal(SIGINT, replay_interrupt);
+	signal(SIGTERM, replay_interrupt);
+
+	/* replay the packets, then report the achieved rate */
+	if(replay_run(&params, comp, &store, &link, &results) != 0)
+	{
+		goto close_link;
+	}
+	replay_print_results(&results);
+
+	status = 0;
+
+close_link:
+	replay_link_close(&link);
+free_store:
+	replay_store_free(&store);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the replay application
+ */
+static void usage(void)
+{
+	printf("The ROHC replay tool generates ROHC traffic to load ROHC decompressors\n"
+	       "\n"
+	       "The rohc_replay tool compresses the IP packets of one PCAP file,\n"
+	       "then sends the ROHC packets from memory on one network device.\n"
+	       "Every replay of the file sends the very same ROHC packets, so the\n"
+	       "decompressor sees the sequence numbers jump backwards at every\n"
+	       "new loop. It outputs the results of the replay with the following\n"
+	       "tab-separated fields:\n\n"
+	       "  * keyword 'REPLAY'\n\n"
+	       "  * number of ROHC packets sent\n\n"
+	       "  * number of complete replays of the file\n\n"
+	       "  * duration (seconds)\n\n"
+	       "  * ROHC packets sent per second\n\n"
+	       "  * megabits sent per second, link layer included\n\n"
+	       "  * compression ratio (%%)\n\n"
+	       "  * number of times the device was busy\n\n"
+	       "  * number of ROHC packets the device refused\n\n"
+	       "  * number of compression failures\n\n"
+	       "  * number of feedbacks delivered to the compressor\n\n"
+	       "  * number of feedbacks the compressor refused\n\n"
+	       "\n"
+	       "Usage: rohc_replay [OPTIONS] CID_TYPE FILE DEVICE\n"
+	       "\n"
+	       "Options:\n"
+	       "  -v, --version             Print version information and exit\n"
+	       "  -h, --help                Print this usage and exit\n"
+	       "      --max-contexts NUM    The maximum number of ROHC contexts to\n"
+	       "                            use for compression\n"
+	       "      --rohc-version NUM    The ROHC version to use: 1 for ROHCv1\n"
+	       "                            (default) and 2 for ROHCv2\n"
+	       "      --rate NUM            The number of ROHC packets to send per\n"
+	       "                            second, 0 for as fast as possible\n"
+	       "                            (default 0)\n"
+	       "      --loops NUM           The number of replays of the file,\n"
+	       "                            0 for infinite (default 1)\n"
+	       "      --batch NUM           The number of ROHC packets sent per\n"
+	       "                            system call, up to %u (default %u)\n"
+	       "      --tx-ring             Send through one AF_PACKET TX ring\n"
+	       "                            instead of sendmmsg(2)\n"
+	       "      --feedback            Compress the packets during the replay\n"
+	       "                            and deliver the ROHC feedback received\n"
+	       "                            on the device to the compressor\n"
+	       "                            (Ethernet devices only)\n"
+	       "      --dst-mac MAC         The destination Ethernet address of the\n"
+	       "                            frames (default ff:ff:ff:ff:ff:ff)\n"
+	       "\n"
+	       "With:\n"
+	       "  CID_TYPE  The type of CID to use among 'smallcid'\n"
+	       "            and 'largecid'\n"
+	       "  FILE      The name of a file in PCAP format with the IP packets\n"
+	       "            to compress\n"
+	       "  DEVICE    The name of the network device to send the ROHC packets\n"
+	       "            on, the Ethertype of the Ethernet frames is 0x%04x\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_replay smallcid voip.pcap eth0  Send the ROHC packets once\n"
+	       "  rohc_replay --loops 0 --rate 100000 largecid lan.pcap eth0\n"
+	       "                                       Send 100000 packets/s forever\n"
+	       "  rohc_replay --feedback smallcid voip.pcap eth0\n"
+	       "                                       Handle the feedback of the\n"
+	       "                                       decompressor under test\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       REPLAY_BATCH_MAX, REPLAY_BATCH_DEFAULT, ETHERTYPE_ROHC);
+}
+
+
+/**
+ * @brief Handle the signals that stop the replay
+ *
+ * @param signum  The signal that was caught
+ */
+static void replay_interrupt(int signum __attribute__((unused)))
+{
+	stop_replay = 1;
+}
+
+
+/**
+ * @brief Create the ROHC compressor of the replay
+ *
+ * @param params  The parameters of the replay
+ * @return        The new compressor, NULL in case of failure
+ */
+static struct rohc_comp * replay_create_comp(const struct replay_params *const params)
+{
+	struct rohc_comp *comp;
+	bool is_ok;
+
+	comp = rohc_comp_new2(params->cid_type, params->max_contexts - 1,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+
+	/* enable profiles, there is no ROHCv2 profile for TCP */
+	if(params->rohc_version == 2)
+	{
+		is_ok = rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                  ROHCv2_PROFILE_IP_UDP_RTP,
+		                                  ROHCv2_PROFILE_IP_UDP,
+		                                  ROHCv2_PROFILE_IP_ESP, ROHCv2_PROFILE_IP,
+		                                  ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	else
+	{
+		is_ok = rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                  ROHCv1_PROFILE_IP_UDP_RTP,
+		                                  ROHCv1_PROFILE_IP_UDP,
+		                                  ROHCv1_PROFILE_IP_UDPLITE,
+		                                  ROHCv1_PROFILE_IP_ESP, ROHCv1_PROFILE_IP,
+		                                  ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	if(!is_ok)
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Load the packets of one PCAP file in memory
+ *
+ * The IP packets are compressed in the order of the PCAP file and the ROHC
+ * packets are stored, unless the feedback is handled: the IP packets are
+ * stored then, they are compressed during the replay.
+ *
+ * @param params         The parameters of the replay
+ * @param filename       The name of the PCAP file
+ * @param comp           The ROHC compressor
+ * @param[out] store     The packets loaded in memory
+ * @param[out] results   The results of the replay
+ * @return               0 in case of success,
+ *                       1 in case of failure
+ */
+static int replay_load(const struct replay_params *const params,
+                       const char *const filename,
+                       struct rohc_comp *const comp,
+                       struct replay_store *const store,
+                       struct replay_results *const results)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	pcap_t *handle;
+	int link_layer_type;
+	size_t link_len_src;
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	unsigned long num_packet;
+	uint8_t *rohc_buffer;
+	int is_failure = 1;
+
+	memset(store, 0, sizeof(struct replay_store));
+	store->is_rohc = !params->do_feedback;
+
+	rohc_buffer = malloc(MAX_ROHC_SIZE);
+	if(rohc_buffer == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the ROHC packets\n");
+		goto error;
+	}
+
+	/* open the source PCAP file */
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
+		goto free_buffer;
+	}
+
+	/* determine the size of the link layer header */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len_src = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len_src = LINUX_COOKED_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_RAW)
+	{
+		link_len_src = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link layer type %d not supported in source PCAP file "
+		        "(supported = %d, %d, %d)\n", link_layer_type, DLT_EN10MB,
+		        DLT_LINUX_SLL, DLT_RAW);
+		goto close_input;
+	}
+
+	num_packet = 0;
+	while((packet = pcap_next(handle, &header)) != NULL)
+	{
+		const struct rohc_ts arrival_time = {
+			.sec = header.ts.tv_sec,
+			.nsec = header.ts.tv_usec * 1000
+		};
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full((uint8_t *) packet, header.caplen, arrival_time);
+		size_t link_len = link_len_src;
+
+		num_packet++;
+
+		/* skip the truncated packets and the link layer header (including
+		 * VLAN headers) */
+		if(header.len <= link_len || header.len != header.caplen)
+		{
+			fprintf(stderr, "packet #%lu: bad PCAP packet (len = %u, caplen = "
+			        "%u), skip it\n", num_packet, header.len, header.caplen);
+			results->load_errs++;
+			continue;
+		}
+		if(!detect_vlan_hdrs(&ip_packet, &link_len) ||
+		   ip_packet.len <= link_len)
+		{
+			fprintf(stderr, "packet #%lu: malformed VLAN header, skip it\n",
+			        num_packet);
+			results->load_errs++;
+			continue;
+		}
+		rohc_buf_pull(&ip_packet, link_len);
+
+		/* check for padding after the IP packet in the Ethernet payload */
+		if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+		{
+			uint16_t tot_len;
+
+			if(((rohc_buf_byte(ip_packet) >> 4) & 0x0f) == 4)
+			{
+				const struct ipv4_hdr *const ip =
+					(struct ipv4_hdr *) rohc_buf_data(ip_packet);
+				tot_len = ntohs(ip->tot_len);
+			}
+			else
+			{
+				const struct ipv6_hdr *const ip =
+					(struct ipv6_hdr *) rohc_buf_data(ip_packet);
+				tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+			}
+			if(tot_len < ip_packet.len)
+			{
+				ip_packet.len = tot_len;
+			}
+		}
+
+		if(store->is_rohc)
+		{
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+
+			/* compress the IP packet once for all the replays */
+			if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "packet #%lu: compression failed, skip it\n",
+				        num_packet);
+				results->comp_errs++;
+				continue;
+			}
+			if(!replay_store_add(store, rohc_packet, ip_packet.len))
+			{
+				goto close_input;
+			}
+		}
+		else if(!replay_store_add(store, ip_packet, ip_packet.len))
+		{
+			goto close_input;
+		}
+	}
+
+	if(store->pkts_nr == 0)
+	{
+		fprintf(stderr, "no packet to replay in PCAP file '%s'\n", filename);
+		goto close_input;
+	}
+
+	/* the packets compressed during the replay grow a little */
+	if(!store->is_rohc)
+	{
+		store->max_len += REPLAY_ROHC_OVERHEAD;
+	}
+
+	is_failure = 0;
+
+close_input:
+	pcap_close(handle);
+free_buffer:
+	free(rohc_buffer);
+error:
+	if(is_failure)
+	{
+		replay_store_free(store);
+	}
+	return is_failure;
+}
+
+
+/**
+ * @brief Append one packet to the packets stored for the replay
+ *
+ * @param store   The packets stored for the replay
+ * @param pkt     The packet to store
+ * @param ip_len  The length of the original IP packet
+ * @return        true if the packet was stored, false otherwise
+ */
+static bool replay_store_add(struct replay_store *const store,
+                             const struct rohc_buf pkt,
+                             const size_t ip_len)
+{
+	if((store->data_len + pkt.len) > store->data_max)
+	{
+		size_t new_max = (store->data_max == 0 ? REPLAY_STORE_INIT_LEN :
+		                  store->data_max * 2);
+		uint8_t *new_data;
+
+		while(new_max < (store->data_len + pkt.len))
+		{
+			new_max *= 2;
+		}
+		new_data = realloc(store->data, new_max);
+		if(new_data == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for %zu bytes of "
+			        "packets\n", new_max);
+			goto error;
+		}
+		store->data = new_data;
+		store->data_max = new_max;
+	}
+	if(store->pkts_nr == store->pkts_max)
+	{
+		const size_t new_max = (store->pkts_max == 0 ? 1024 : store->pkts_max * 2);
+		struct replay_pkt *new_pkts;
+
+		new_pkts = realloc(store->pkts, new_max * sizeof(struct replay_pkt));
+		if(new_pkts == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for %zu packets\n",
+			        new_max);
+			goto error;
+		}
+		store->pkts = new_pkts;
+		store->pkts_max = new_max;
+	}
+
+	memcpy(store->data + store->data_len, rohc_buf_data(pkt), pkt.len);
+	store->pkts[store->pkts_nr].offset = store->data_len;
+	store->pkts[store->pkts_nr].len = pkt.len;
+	store->pkts[store->pkts_nr].ip_len = ip_len;
+	store->pkts_nr++;
+	store->data_len += pkt.len;
+	if(pkt.len > store->max_len)
+	{
+		store->max_len = pkt.len;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Free the packets stored for the replay
+ *
+ * @param store  The packets stored for the replay
+ */
+static void replay_store_free(struct replay_store *const store)
+{
+	free(store->data);
+	store->data = NULL;
+	free(store->pkts);
+	store->pkts = NULL;
+	store->pkts_nr = 0;
+}
+
+
+/**
+ * @brief Open the network device the ROHC packets are sent on
+ *
+ * @param params       The parameters of the replay
+ * @param device_name  The name of the network device
+ * @param max_pkt_len  The length of the largest ROHC packet to send
+ * @param[out] link    The network device
+ * @return             true if the device was opened, false otherwise
+ */
+static bool replay_link_open(const struct replay_params *const params,
+                             const char *const device_name,
+                             const size_t max_pkt_len,
+                             struct replay_link *const link)
+{
+	struct sockaddr_ll addr;
+	struct ifreq ifr;
+	uint16_t protocol;
+
+	memset(link, 0, sizeof(struct replay_link));
+
+	if(strlen(device_name) >= IFNAMSIZ)
+	{
+		fprintf(stderr, "device name '%s' too long, should be strictly less "
+		        "than %u characters\n", device_name, IFNAMSIZ);
+		goto error;
+	}
+
+	/* nothing is received unless the feedback is handled */
+	protocol = (params->do_feedback ? htons(ETHERTYPE_ROHC) : 0);
+	link->fd = socket(AF_PACKET, SOCK_RAW, protocol);
+	if(link->fd < 0)
+	{
+		fprintf(stderr, "failed to create AF_PACKET socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	/* get the index and the link layer of the device */
+	memset(&ifr, 0, sizeof(struct ifreq));
+	strncpy(ifr.ifr_name, device_name, IFNAMSIZ - 1);
+	if(ioctl(link->fd, SIOCGIFINDEX, &ifr) != 0)
+	{
+		fprintf(stderr, "failed to get the index of network device '%s': "
+		        "%s (%d)\n", device_name, strerror(errno), errno);
+		goto close_socket;
+	}
+	memset(&addr, 0, sizeof(struct sockaddr_ll));
+	addr.sll_family = AF_PACKET;
+	addr.sll_protocol = protocol;
+	addr.sll_ifindex = ifr.ifr_ifindex;
+	if(ioctl(link->fd, SIOCGIFHWADDR, &ifr) != 0)
+	{
+		fprintf(stderr, "failed to get the type of network device '%s': "
+		        "%s (%d)\n", device_name, strerror(errno), errno);
+		goto close_socket;
+	}
+	if(ifr.ifr_hwaddr.sa_family == ARPHRD_ETHER ||
+	   ifr.ifr_hwaddr.sa_family == ARPHRD_LOOPBACK)
+	{
+		struct ether_header *const eth_header = (struct ether_header *) link->hdr;
+
+		/* the ROHC packets are sent in Ethernet frames with the ROHC Ethertype */
+		memcpy(eth_header->ether_dhost, params->dst_mac, ETH_ALEN);
+		memcpy(eth_header->ether_shost, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+		eth_header->ether_type = htons(ETHERTYPE_ROHC);
+		link->hdr_len = ETHER_HDR_LEN;
+	}
+	else if(ifr.ifr_hwaddr.sa_family == ARPHRD_NONE ||
+	        ifr.ifr_hwaddr.sa_family == ARPHRD_PPP)
+	{
+		if(params->do_feedback)
+		{
+			fprintf(stderr, "feedback cannot be received on raw IP network "
+			        "device '%s'\n", device_name);
+			goto close_socket;
+		}
+		link->hdr_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "type %u of network device '%s' not supported\n",
+		        ifr.ifr_hwaddr.sa_family, device_name);
+		goto close_socket;
+	}
+
+	if(bind(link->fd, (struct sockaddr *) &addr,
+	        sizeof(struct sockaddr_ll)) != 0)
+	{
+		fprintf(stderr, "failed to bind AF_PACKET socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto close_socket;
+	}
+
+#ifdef REPLAY_HAVE_TX_RING
+	link->ring = NULL;
+	if(params->use_tx_ring && !replay_ring_open(link, max_pkt_len))
+	{
+		goto close_socket;
+	}
+#else
+	(void) max_pkt_len;
+#endif
+
+	return true;
+
+close_socket:
+	close(link->fd);
+	link->fd = -1;
+error:
+	return false;
+}
+
+
+/**
+ * @brief Close the network device the ROHC packets are sent on
+ *
+ * @param link  The network device
+ */
+static void replay_link_close(struct replay_link *const link)
+{
+#ifdef REPLAY_HAVE_TX_RING
+	if(link->ring != NULL)
+	{
+		munmap(link->ring, link->ring_len);
+		link->ring = NULL;
+	}
+#endif
+	close(link->fd);
+	link->fd = -1;
+}
+
+
+/**
+ * @brief Send one batch of ROHC packets with sendmmsg(2)
+ *
+ * The device being busy is not an error: the packets are sent again until
+ * the device accepts them. The packets the device refuses, eg. because they
+ * exceed its MTU, are skipped.
+ *
+ * @param link     The network device
+ * @param pkts     The ROHC packets to send
+ * @param pkts_nr  The number of ROHC packets to send
+ * @param results  The results of the replay
+ * @return         The number of ROHC packets sent
+ */
+static size_t replay_send_mmsg(struct replay_link *const link,
+                               struct iovec pkts[],
+                               const size_t pkts_nr,
+                               struct replay_results *const results)
+{
+	struct mmsghdr msgs[REPLAY_BATCH_MAX];
+	struct iovec iovs[REPLAY_BATCH_MAX][2];
+	size_t sent_nr = 0;
+	size_t done_nr = 0;
+	size_t i;
+
+	/* the link layer header and the ROHC packet are sent without copy */
+	for(i = 0; i < pkts_nr; i++)
+	{
+		size_t iovs_nr = 0;
+
+		if(link->hdr_len > 0)
+		{
+			iovs[i][iovs_nr].iov_base = link->hdr;
+			iovs[i][iovs_nr].iov_len = link->hdr_len;
+			iovs_nr++;
+		}
+		iovs[i][iovs_nr] = pkts[i];
+		iovs_nr++;
+
+		memset(&msgs[i], 0, sizeof(struct mmsghdr));
+		msgs[i].msg_hdr.msg_iov = iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = iovs_nr;
+	}
+
+	while(done_nr < pkts_nr && !stop_replay)
+	{
+		const int ret = sendmmsg(link->fd, msgs + done_nr, pkts_nr - done_nr, 0);
+		if(ret < 0 && (errno == ENOBUFS || errno == EAGAIN || errno == EINTR))
+		{
+			/* the device is busy, try again */
+			results->send_retries++;
+			continue;
+		}
+		else if(ret < 0)
+		{
+			/* the device refuses the first packet, skip it */
+			results->send_errs++;
+			done_nr++;
+			continue;
+		}
+		sent_nr += ret;
+		done_nr += ret;
+	}
+
+	return sent_nr;
+}
+
+
+#ifdef REPLAY_HAVE_TX_RING
+
+/**
+ * @brief Open the AF_PACKET TX ring of the network device
+ *
+ * @param link         The network device
+ * @param max_pkt_len  The length of the largest ROHC packet to send
+ * @return             true if the ring was opened, false otherwise
+ */
+static bool replay_ring_open(struct replay_link *const link,
+                             const size_t max_pkt_len)
+{
+	const size_t data_off = TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+	const int version = TPACKET_V2;
+	const int discard = 1;
+	struct tpacket_req req;
+	size_t block_size;
+
+	/* every frame holds the largest packet */
+	link->frame_size = REPLAY_RING_FRAME_MIN_SIZE;
+	while(link->frame_size < (data_off + link->hdr_len + max_pkt_len))
+	{
+		link->frame_size *= 2;
+	}
+	block_size = REPLAY_RING_BLOCK_SIZE;
+	if(block_size < link->frame_size)
+	{
+		block_size = link->frame_size;
+	}
+	link->frames_nr = (block_size / link->frame_size) * REPLAY_RING_BLOCKS_NR;
+	link->ring_len = block_size * REPLAY_RING_BLOCKS_NR;
+	link->frame_id = 0;
+
+	if(setsockopt(link->fd, SOL_PACKET, PACKET_VERSION, &version,
+	              sizeof(version)) != 0)
+	{
+		fprintf(stderr, "failed to select TPACKET_V2: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	/* do not stop the ring on the frames the device refuses */
+	if(setsockopt(link->fd, SOL_PACKET, PACKET_LOSS, &discard,
+	              sizeof(discard)) != 0)
+	{
+		fprintf(stderr, "failed to discard malformed frames: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	memset(&req, 0, sizeof(struct tpacket_req));
+	req.tp_block_size = block_size;
+	req.tp_block_nr = REPLAY_RING_BLOCKS_NR;
+	req.tp_frame_size = link->frame_size;
+	req.tp_frame_nr = link->frames_nr;
+	if(setsockopt(link->fd, SOL_PACKET, PACKET_TX_RING, &req,
+	              sizeof(struct tpacket_req)) != 0)
+	{
+		fprintf(stderr, "failed to create TX ring: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+	link->ring = mmap(NULL, link->ring_len, PROT_READ | PROT_WRITE,
+	                  MAP_SHARED, link->fd, 0);
+	if(link->ring == MAP_FAILED)
+	{
+		fprintf(stderr, "failed to map TX ring: %s (%d)\n",
+		        strerror(errno), errno);
+		link->ring = NULL;
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Send one batch of ROHC packets through the TX ring
+ *
+ * The ROHC packets are copied in the free frames of the ring, then the kernel
+ * is asked to send them. If the ring is full, the kernel is asked to send the
+ * pending frames until one frame gets free.
+ *
+ * @param link     The network device
+ * @param pkts     The ROHC packets to send
+ * @param pkts_nr  The number of ROHC packets to send
+ * @param results  The results of the replay
+ * @return         The number of ROHC packets queued for sending
+ */
+static size_t replay_send_ring(struct replay_link *const link,
+                               struct iovec pkts[],
+                               const size_t pkts_nr,
+                               struct replay_results *const results)
+{
+	const size_t data_off = TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+	size_t sent_nr = 0;
+	size_t i;
+
+	for(i = 0; i < pkts_nr && !stop_replay; i++)
+	{
+		struct tpacket2_hdr *const frame = (struct tpacket2_hdr *)
+			(link->ring + link->frame_id * link->frame_size);
+		uint8_t *const data = ((uint8_t *) frame) + data_off;
+
+		/* wait for the frame to be free */
+		while(frame->tp_status != TP_STATUS_AVAILABLE && !stop_replay)
+		{
+			if(send(link->fd, NULL, 0, 0) < 0 && errno != EINTR)
+			{
+				results->send_retries++;
+			}
+		}
+		if(stop_replay)
+		{
+			break;
+		}
+
+		memcpy(data, link->hdr, link->hdr_len);
+		memcpy(data + link->hdr_len, pkts[i].iov_base, pkts[i].iov_len);
+		frame->tp_len = link->hdr_len + pkts[i].iov_len;
+		__sync_synchronize();
+		frame->tp_status = TP_STATUS_SEND_REQUEST;
+		sent_nr++;
+
+		link->frame_id = (link->frame_id + 1) % link->frames_nr;
+	}
+
+	/* ask the kernel to send the new frames without waiting for them */
+	if(send(link->fd, NULL, 0, MSG_DONTWAIT) < 0 &&
+	   errno != EAGAIN && errno != ENOBUFS && errno != EINTR)
+	{
+		results->send_errs++;
+	}
+
+	return sent_nr;
+}
+
+#endif /* REPLAY_HAVE_TX_RING */
+
+
+/**
+ * @brief Deliver the ROHC feedback received on the network device to the
+ *        compressor
+ *
+ * @param link     The network device
+ * @param comp     The ROHC compressor
+ * @param results  The results of the replay
+ */
+static void replay_recv_feedback(struct replay_link *const link,
+                                 struct rohc_comp *const comp,
+                                 struct replay_results *const results)
+{
+	uint8_t frame[ETHER_HDR_LEN + MAX_ROHC_SIZE];
+	struct sockaddr_ll addr;
+	socklen_t addr_len;
+	ssize_t len;
+
+	for(;;)
+	{
+		addr_len = sizeof(struct sockaddr_ll);
+		len = recvfrom(link->fd, frame, sizeof(frame), MSG_DONTWAIT,
+		               (struct sockaddr *) &addr, &addr_len);
+		if(len < 0)
+		{
+			break;
+		}
+
+		/* skip the frames sent by the replay itself, they are seen twice on
+		 * loopback devices */
+		if(addr.sll_pkttype == PACKET_OUTGOING ||
+		   ((size_t) len) <= link->hdr_len ||
+		   !memcmp(frame + ETH_ALEN, link->hdr + ETH_ALEN, ETH_ALEN))
+		{
+			continue;
+		}
+
+		{
+			const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+			const struct rohc_buf feedback =
+				rohc_buf_init_full(frame + link->hdr_len, len - link->hdr_len, ts);
+
+			if(rohc_comp_deliver_feedback2(comp, feedback))
+			{
+				results->feedbacks_ok++;
+			}
+			else
+			{
+				results->feedbacks_ko++;
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief Replay the packets stored in memory on the network device
+ *
+ * With a rate, the packets that are due are sent in batches of at most
+ * --batch packets, and the replay sleeps until the next packet is due.
+ * Without rate, every batch is as large as possible.
+ *
+ * @param params   The parameters of the replay
+ * @param comp     The ROHC compressor, used if the feedback is handled
+ * @param store    The packets stored for the replay
+ * @param link     The network device
+ * @param results  The results of the replay
+ * @return         0 in case of success,
+ *                 1 in case of failure
+ */
+static int replay_run(const struct replay_params *const params,
+                      struct rohc_comp *const comp,
+                      const struct replay_store *const store,
+                      struct replay_link *const link,
+                      struct replay_results *const results)
+{
+	struct iovec pkts[REPLAY_BATCH_MAX];
+	size_t ip_lens[REPLAY_BATCH_MAX];
+	uint8_t *comp_bufs = NULL;
+	uint64_t scheduled_nr = 0;
+	size_t pkt_id = 0;
+	uint64_t start_ns;
+	int is_failure = 1;
+
+	/* the packets compressed during the replay need room */
+	if(!store->is_rohc)
+	{
+		comp_bufs = malloc(params->batch_len * MAX_ROHC_SIZE);
+		if(comp_bufs == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for the ROHC packets\n");
+			goto error;
+		}
+	}
+
+	start_ns = replay_get_ns();
+	while(!stop_replay &&
+	      (params->loops_nr == 0 || results->loops < params->loops_nr))
+	{
+		size_t batch_nr = params->batch_len;
+		size_t pkts_nr = 0;
+		size_t sent_nr;
+		size_t i;
+
+		/* send only the packets that are due */
+		if(params->rate > 0)
+		{
+			const uint64_t elapsed_ns = replay_get_ns() - start_ns;
+			const uint64_t due_nr =
+				(uint64_t) (((double) elapsed_ns) * params->rate / 1e9) + 1;
+
+			if(due_nr <= scheduled_nr)
+			{
+				replay_sleep_until(start_ns + (uint64_t)
+				                   (((double) scheduled_nr) * 1e9 / params->rate));
+				continue;
+			}
+			if((due_nr - scheduled_nr) < batch_nr)
+			{
+				batch_nr = due_nr - scheduled_nr;
+			}
+		}
+
+		/* collect the next packets of the file */
+		for(i = 0; i < batch_nr &&
+		            (params->loops_nr == 0 || results->loops < params->loops_nr);
+		    i++)
+		{
+			const struct replay_pkt *const pkt = &store->pkts[pkt_id];
+
+			if(store->is_rohc)
+			{
+				pkts[pkts_nr].iov_base = store->data + pkt->offset;
+				pkts[pkts_nr].iov_len = pkt->len;
+				ip_lens[pkts_nr] = pkt->ip_len;
+				pkts_nr++;
+			}
+			else
+			{
+				const uint64_t now_ns = replay_get_ns();
+				const struct rohc_ts arrival_time = {
+					.sec = now_ns / 1000000000ULL,
+					.nsec = now_ns % 1000000000ULL
+				};
+				const struct rohc_buf ip_packet =
+					rohc_buf_init_full(store->data + pkt->offset, pkt->len,
+					                   arrival_time);
+				struct rohc_buf rohc_packet =
+					rohc_buf_init_empty(comp_bufs + pkts_nr * MAX_ROHC_SIZE,
+					                    MAX_ROHC_SIZE);
+
+				/* compress the IP packet with the latest feedback */
+				if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+				{
+					results->comp_errs++;
+				}
+				else
+				{
+					pkts[pkts_nr].iov_base = rohc_buf_data(rohc_packet);
+					pkts[pkts_nr].iov_len = rohc_packet.len;
+					ip_lens[pkts_nr] = pkt->ip_len;
+					pkts_nr++;
+				}
+			}
+
+			pkt_id++;
+			if(pkt_id == store->pkts_nr)
+			{
+				pkt_id = 0;
+				results->loops++;
+			}
+		}
+		scheduled_nr += i;
+
+		/* send the batch */
+#ifdef REPLAY_HAVE_TX_RING
+		if(link->ring != NULL)
+		{
+			sent_nr = replay_send_ring(link, pkts, pkts_nr, results);
+		}
+		else
+#endif
+		{
+			sent_nr = replay_send_mmsg(link, pkts, pkts_nr, results);
+		}
+		results->sent_pkts += sent_nr;
+		for(i = 0; i < sent_nr; i++)
+		{
+			results->sent_bytes += link->hdr_len + pkts[i].iov_len;
+			results->sent_rohc_bytes += pkts[i].iov_len;
+			results->sent_ip_bytes += ip_lens[i];
+		}
+
+		/* the compressor reacts to the feedback before the next batch */
+		if(params->do_feedback)
+		{
+			replay_recv_feedback(link, comp, results);
+		}
+	}
+
+#ifdef REPLAY_HAVE_TX_RING
+	/* wait for the last frames of the ring to be sent */
+	if(link->ring != NULL)
+	{
+		(void) send(link->fd, NULL, 0, 0);
+	}
+#endif
+	results->elapsed_ns = replay_get_ns() - start_ns;
+
+	is_failure = 0;
+
+	free(comp_bufs);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print the results of the replay
+ *
+ * @param results  The results of the replay
+ */
+static void replay_print_results(const struct replay_results *const results)
+{
+	const double seconds = ((double) results->elapsed_ns) / 1e9;
+	const double pps = (seconds > 0 ? results->sent_pkts / seconds : 0);
+	const double mbps =
+		(seconds > 0 ? results->sent_bytes * 8.0 / seconds / 1e6 : 0);
+	const double ratio = (results->sent_ip_bytes > 0 ?
+		100.0 * results->sent_rohc_bytes / results->sent_ip_bytes : 0);
+
+	if(results->load_errs > 0)
+	{
+		fprintf(stderr, "%lu packets of the PCAP file were skipped\n",
+		        results->load_errs);
+	}
+
+	printf("REPLAY\t"
+	       "\"packets\"\t"
+	       "\"loops\"\t"
+	       "\"seconds\"\t"
+	       "\"packets/s\"\t"
+	       "\"Mbit/s\"\t"
+	       "\"compression ratio (%%)\"\t"
+	       "\"send retries\"\t"
+	       "\"send errors\"\t"
+	       "\"compression failures\"\t"
+	       "\"feedbacks\"\t"
+	       "\"feedback errors\"\n");
+	printf("REPLAY\t%lu\t%lu\t%.3f\t%.0f\t%.1f\t%.1f\t%lu\t%lu\t%lu\t%lu\t%lu\n",
+	       results->sent_pkts, results->loops, seconds, pps, mbps, ratio,
+	       results->send_retries, results->send_errs, results->comp_errs,
+	       results->feedbacks_ok, results->feedbacks_ko);
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Parse one Ethernet address
+ *
+ * @param str       The Ethernet address, eg. 00:11:22:33:44:55
+ * @param[out] mac  The parsed Ethernet address
+ * @return          true if the address is well-formed, false otherwise
+ */
+static bool replay_parse_mac(const char *const str, uint8_t mac[ETH_ALEN])
+{
+	unsigned int bytes[ETH_ALEN];
+	char trailing;
+	size_t i;
+
+	if(sscanf(str, "%x:%x:%x:%x:%x:%x%c", &bytes[0], &bytes[1], &bytes[2],
+	          &bytes[3], &bytes[4], &bytes[5], &trailing) != ETH_ALEN)
+	{
+		return false;
+	}
+	for(i = 0; i < ETH_ALEN; i++)
+	{
+		if(bytes[i] > 0xff)
+		{
+			return false;
+		}
+		mac[i] = bytes[i];
+	}
+	return true;
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (ns)
+ */
+static uint64_t replay_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+
+/**
+ * @brief Sleep until the given time of the monotonic clock
+ *
+ * @param deadline_ns  The time to wake up at (ns)
+ */
+static void replay_sleep_until(const uint64_t deadline_ns)
+{
+	const struct timespec deadline = {
+		.tv_sec = deadline_ns / 1000000000ULL,
+		.tv_nsec = deadline_ns % 1000000000ULL
+	};
+
+	(void) clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp __attribute__((unused)),
+                          void *const user_context __attribute__((unused)))
+{
+	return rand();
+}
+
+
+/**
+ * @brief The detection callback which do detect RTP stream
+ *
+ * @param ip           The inner ip packet
+ * @param udp          The udp header of the packet
+ * @param payload      The payload of the packet
+ * @param payload_size The size of the payload (in bytes)
+ * @param rtp_private  An optional private context, may be NULL
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	const size_t default_rtp_ports_nr = 5;
+	unsigned int default_rtp_ports[] = { 1234, 36780, 33238, 5020, 5002 };
+	uint16_t udp_dport;
+	bool is_rtp = false;
+	size_t i;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* get the UDP destination port */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	/* is the UDP destination port in the list of ports reserved for RTP
+	 * traffic by default (for compatibility reasons) */
+	for(i = 0; i < default_rtp_ports_nr; i++)
+	{
+		if(ntohs(udp_dport) == default_rtp_ports[i])
+		{
+			is_rtp = true;
+			break;
+		}
+	}
+
+	return is_rtp;
+}
+
+
+/**
+ * @brief Detect the 802.1q and 802.1ad headers after the Ethernet header
+ *
+ * @param frame         The Ethernet frame
+ * @param[in,out] link_len  The length of the link layer header, VLAN headers
+ *                          are added to it
+ * @return              true if the VLAN headers are well-formed,
+ *                      false otherwise
+ */
+static bool detect_vlan_hdrs(const struct rohc_buf *const frame,
+                             size_t *const link_len)
+{
+	if((*link_len) == ETHER_HDR_LEN)
+	{
+		const struct ether_header *const eth_header =
+			(struct ether_header *) rohc_buf_data(*frame);
+		uint16_t proto_type = ntohs(eth_header->ether_type);
+
+		/* skip all 802.1q or 802.1ad headers */
+		while(proto_type == ETHERTYPE_8021Q || proto_type == ETHERTYPE_8021AD)
+		{
+			const struct vlan_hdr *vlan_hdr;
+
+			/* check min length */
+			if(frame->len < (*link_len) + sizeof(struct vlan_hdr))
+			{
+				return false;
+			}
+
+			/* detect next header */
+			vlan_hdr = (struct vlan_hdr *) rohc_buf_data_at(*frame, (*link_len));
+			proto_type = ntohs(vlan_hdr->type);
+
+			/* skip VLAN header */
+			(*link_len) += sizeof(struct vlan_hdr);
+		}
+	}
+
+	return true;
+}
@@ -35,10 +35,10 @@ link_netns()
 	local netns1_itf=$2
 	local netns2=$3
 	local netns2_itf=$4
-	ip link add name ${netns1_itf} type veth peer name ${netns2_itf}
-	ip link set ${netns1_itf} netns ${netns1}
+	# create both ends in their namespaces, they may have the same name
+	ip link add name ${netns1_itf} netns ${netns1} type veth \
+		peer name ${netns2_itf} netns ${netns2}
 	ip netns exec ${netns1} ip link set ${netns1_itf} up
-	ip link set ${netns2_itf} netns ${netns2}
 	ip netns exec ${netns2} ip link set ${netns2_itf} up
 }
 
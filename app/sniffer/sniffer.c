@@ -31,6 +31,16 @@
  *   the ROHC library with them. The packets are compressed, then decompressed,
  *   and finally compared with the original IP packets.
  *
+ * Pipeline:
+ *   One capture thread reads the packets from the network interface with
+ *   pcap_dispatch() and dispatches them to the workers. Every worker owns one
+ *   compressor/decompressor pair and processes the flows that are sharded to
+ *   it. The packets of one flow always go to the same worker, so the contexts
+ *   of one worker are never shared with another worker. One writer thread
+ *   saves the packets in the dump files. The queues between the stages are
+ *   bounded: a packet is dropped if the next stage cannot keep up, the drops
+ *   are counted in the statistics.
+ *
  * Statistics:
  *   Some statistics are gathered during the tests. There are printed on the
  *   console. More stats should be added. A better way to export them remains to
@@ -39,9 +49,18 @@
  * Post-mortem bug analysis:
  *   The program stops (assertion) if compression/decompression/comparison
  *   fails. The last library traces are recorded and printed in case of error.
- *   The last packets are recorded in PCAP files, one per context. This is
- *   also a good idea to run the program with core enabled. Many elements are
+ *   The last packets are recorded in a few segmented PCAP files: the oldest
+ *   segment is removed when a new one is started. Every segment comes with
+ *   one index that gives the worker, the CID and the start of stream of every
+ *   packet of the segment, so the stream of one context may be extracted
+ *   from the segments. This is also a good idea to run the program with core enabled. Many elements are
  *   thus available to reproduce and fix the discovered problems.
+ *
+ * Replay:
+ *   With --replay, the program decompresses the packets of one ROHC capture
+ *   recorded by rohc_stats instead of sniffing. With --seek, the contexts are
+ *   restored from the snapshot nearest to the given packet, so the problem
+ *   seen at one packet far in the capture is reproduced quickly.
  */
 
 #include "config.h" /* for HAVE_*_H and PACKAGE_BUGREPORT */
@@ -67,6 +86,20 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <linux/if.h>
+#include <pthread.h>
+
+/* includes for the AF_PACKET capture rings */
+#if HAVE_LINUX_IF_PACKET_H == 1
+#  include <linux/if_packet.h>
+#  include <net/if_arp.h>
+#  include <sys/socket.h>
+#  include <sys/ioctl.h>
+#  include <sys/mman.h>
+#  include <poll.h>
+#  if defined(TPACKET3_HDRLEN)
+#    define SNIFFER_HAVE_RING  1
+#  endif
+#endif
 
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
@@ -83,6 +116,9 @@ for ./configure ? If yes, check configure output and config.log"
 #include <rohc/rohc_comp.h>
 #include <rohc/rohc_decomp.h>
 
+/* ROHC captures */
+#include "rohc_capture.h"
+
 
 
 /** Return the smaller value from the two */
@@ -96,6 +132,49 @@ for ./configure ? If yes, check configure output and config.log"
 /** The maximal size for the ROHC packets */
 #define MAX_ROHC_SIZE  (DEV_MTU + 100U)
 
+/** The default number of compression/decompression workers */
+#define SNIFFER_WORKERS_DEFAULT  1U
+/** The maximum number of compression/decompression workers */
+#define SNIFFER_WORKERS_MAX  64U
+
+/** The size (in bytes) of the queue in front of every worker and the writer */
+#define SNIFFER_QUEUE_SIZE  (16U * 1024U * 1024U)
+
+/** The size (in bytes) of the capture buffer in the kernel */
+#define SNIFFER_CAPTURE_BUFFER_SIZE  (64 * 1024 * 1024)
+
+/** The timeout (in ms) of the capture, stop and stats requests are handled
+ *  at least that often */
+#define SNIFFER_CAPTURE_TIMEOUT_MS  100
+
+/** The maximum length (in bytes) of one segment of the dump files */
+#define SNIFFER_SEGMENT_MAX_LEN  (256U * 1024U * 1024U)
+/** The maximum number of segments of the dump files kept on disk */
+#define SNIFFER_SEGMENTS_MAX  8U
+/** The length (in bytes) of the buffers of the writer, every write to disk
+ *  is that large except at the end of one segment */
+#define SNIFFER_WRITE_BUF_LEN  (4U * 1024U * 1024U)
+
+/** The size (in bytes) of one block of the AF_PACKET capture rings */
+#define SNIFFER_RING_BLOCK_SIZE  (4U * 1024U * 1024U)
+/** The number of blocks of every AF_PACKET capture ring */
+#define SNIFFER_RING_BLOCKS_NR  16U
+/** The size (in bytes) of the frames of the AF_PACKET capture rings */
+#define SNIFFER_RING_FRAME_SIZE  2048U
+/** The number of capture timeouts between two prints of the statistics
+ *  requested by --stat (ring capture only) */
+#define SNIFFER_RING_STATS_TICKS  100U
+
+/** The protocol of the AF_PACKET sockets: all of them, see ETH_P_ALL in
+ *  linux/if_ether.h that conflicts with the Ethernet definitions below */
+#define SNIFFER_ETH_P_ALL  0x0003U
+
+/** The maximum number of packets compressed at once from one ring block */
+#define SNIFFER_BURST_MAX  64U
+
+/** Round the given length up to the alignment of the entries of the queues */
+#define SNIFFER_ALIGN(len)  (((len) + 7U) & ~((size_t) 7U))
+
 /** The length of the Linux Cooked Sockets header */
 #define LINUX_COOKED_HDR_LEN  16U
 
@@ -105,6 +184,10 @@ for ./configure ? If yes, check configure output and config.log"
 /** The length (in bytes) of the Ethernet header */
 #define ETHER_HDR_LEN  14U
 
+/** The maximal size for the ROHC packets, link layer header included */
+#define SNIFFER_OUTPUT_MAX_LEN \
+	(max(ETHER_HDR_LEN, LINUX_COOKED_HDR_LEN) + MAX_ROHC_SIZE)
+
 /** The minimum Ethernet length (in bytes) */
 #define ETHER_FRAME_MIN_LEN  60U
 
@@ -174,27 +257,337 @@ struct sniffer_stats_t
 };
 
 
+/**
+ * @brief One packet in one of the queues of the pipeline
+ *
+ * The entries are stored one after the other in the queue. One entry never
+ * wraps around the end of the queue: the end of the queue is padded with one
+ * padding entry instead.
+ */
+struct sniffer_pkt
+{
+	/** The length of the entry in the queue, alignment included */
+	uint32_t len;
+	/** Whether the entry only pads the end of the queue */
+	uint32_t is_pad;
+
+	/** The PCAP header of the packet */
+	struct pcap_pkthdr header;
+
+	/** The worker that compressed the packet (writer only) */
+	size_t worker_id;
+	/** The CID of the context the packet was compressed with (writer only) */
+	unsigned int cid;
+	/** Whether the packet starts a new stream for the CID (writer only) */
+	bool is_new_stream;
+	/** Whether the packet failed to be compressed (writer only) */
+	bool is_comp_failure;
+
+	/** The packet, link layer included */
+	unsigned char data[];
+};
+
+
+/**
+ * @brief One bounded queue between two stages of the pipeline
+ *
+ * The producers hold the lock between \ref sniffer_queue_reserve and
+ * \ref sniffer_queue_commit, so several producers may share one queue.
+ * There is only one consumer per queue.
+ */
+struct sniffer_queue
+{
+	/** The lock that protects the queue */
+	pthread_mutex_t lock;
+	/** Signaled when one entry is added to the queue */
+	pthread_cond_t not_empty;
+	/** Signaled when one entry is removed from the queue */
+	pthread_cond_t not_full;
+
+	/** The memory of the queue */
+	uint8_t *buf;
+	/** The size (in bytes) of the queue */
+	size_t size;
+	/** The offset of the oldest entry */
+	size_t head;
+	/** The offset of the next entry */
+	size_t tail;
+	/** The number of bytes used in the queue, padding included */
+	size_t used;
+
+	/** The number of packets in the queue */
+	size_t depth;
+	/** The maximum number of packets ever seen in the queue */
+	size_t max_depth;
+	/** The number of packets dropped because the queue was full */
+	unsigned long drops;
+
+	/** Whether the producers are done with the queue */
+	bool closed;
+};
+
+
+/** One compression/decompression worker */
+struct sniffer_worker
+{
+	/** The index of the worker */
+	size_t id;
+	/** The thread of the worker */
+	pthread_t thread;
+	/** Whether the thread of the worker was started */
+	bool is_started;
+
+	/** The packets captured for the worker (libpcap capture only) */
+	struct sniffer_queue queue;
+
+	/** The AF_PACKET socket of the worker (ring capture only), -1 if none */
+	int ring_fd;
+	/** The capture ring mapped in memory (ring capture only) */
+	uint8_t *ring;
+	/** The next block of the capture ring to read (ring capture only) */
+	size_t ring_block_id;
+	/** The ROHC packets of one burst (ring capture only) */
+	uint8_t *burst_buf;
+	/** The packets seen by the capture ring, updated with the stats */
+	unsigned long ring_packets;
+	/** The packets dropped by the capture ring, updated with the stats */
+	unsigned long ring_drops;
+
+	/** The compressor of the worker */
+	struct rohc_comp *comp;
+	/** The decompressor of the worker */
+	struct rohc_decomp *decomp;
+
+	/** The length of the link layer header before IP data */
+	size_t link_len_src;
+
+	/** The feedback to piggyback on the next ROHC packet */
+	uint8_t feedback_send_buffer[MAX_ROHC_SIZE];
+	/** The feedback to piggyback on the next ROHC packet */
+	struct rohc_buf feedback_send;
+
+	/** The number of packets successfully processed */
+	unsigned int nb_ok;
+	/** The number of bad packets */
+	unsigned int nb_bad;
+	/** The number of internal errors */
+	unsigned int nb_internal_err;
+	/** The number of compression errors */
+	unsigned int err_comp;
+	/** The number of decompression errors */
+	unsigned int err_decomp;
+	/** The number of packets that differ once decompressed */
+	unsigned int nb_ref;
+};
+
+
+/** The header of one PCAP file */
+struct sniffer_pcap_file_hdr
+{
+	uint32_t magic;          /**< 0xa1b2c3d4 in the byte order of the host */
+	uint16_t version_major;  /**< 2 */
+	uint16_t version_minor;  /**< 4 */
+	int32_t thiszone;        /**< Always 0 */
+	uint32_t sigfigs;        /**< Always 0 */
+	uint32_t snaplen;        /**< The maximum length of the packets */
+	uint32_t linktype;       /**< The link layer of the packets */
+} __attribute__((packed));
+
+
+/** The header of one packet in one PCAP file */
+struct sniffer_pcap_rec_hdr
+{
+	uint32_t ts_sec;         /**< The timestamp of the packet (seconds) */
+	uint32_t ts_usec;        /**< The timestamp of the packet (microseconds) */
+	uint32_t incl_len;       /**< The length of the packet in the file */
+	uint32_t orig_len;       /**< The length of the packet on the wire */
+} __attribute__((packed));
+
+
+/** The index of one packet in one segment of the dump files */
+struct sniffer_index_rec
+{
+	uint32_t offset;         /**< The offset of the packet in the segment */
+	uint16_t worker_id;      /**< The worker that compressed the packet */
+	uint16_t cid;            /**< The CID the packet was compressed with */
+	uint8_t is_new_stream;   /**< Whether a new stream starts for the CID */
+	uint8_t unused[3];
+} __attribute__((packed));
+
+
+/** One buffered output file of the writer */
+struct sniffer_out_file
+{
+	/** The file descriptor of the file, -1 if not opened */
+	int fd;
+	/** The data not written to the file yet */
+	uint8_t *buf;
+	/** The length of the data not written to the file yet */
+	size_t buf_len;
+};
+
+
+/** The writer that saves the packets in the dump files */
+struct sniffer_writer
+{
+	/** The thread of the writer */
+	pthread_t thread;
+	/** Whether the thread of the writer was started */
+	bool is_started;
+
+	/** The packets to save */
+	struct sniffer_queue queue;
+
+	/** The PCAP handle the dump file for compression failures is opened with */
+	pcap_t *handle;
+	/** The link layer of the packets */
+	int linktype;
+
+	/** The number of the current segment */
+	unsigned int seg_id;
+	/** The number of the oldest segment kept on disk */
+	unsigned int seg_first_id;
+	/** The length of the current segment, buffered data included */
+	size_t seg_len;
+	/** The PCAP file of the current segment */
+	struct sniffer_out_file seg;
+	/** The index of the current segment */
+	struct sniffer_out_file idx;
+};
+
+
 /* prototypes of private functions */
 
 static void usage(void);
 static void sniffer_interrupt(int signum);
-static void sniffer_print_stats(int signum);
+static void sniffer_request_stats(int signum);
+static void sniffer_print_stats(void);
 
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
                   const int enabled_profiles[],
-                  const char *const device_name)
+                  const char *const device_name,
+                  const size_t workers_nr,
+                  const bool use_ring)
 	__attribute__((warn_unused_result, nonnull(4)));
-static int compress_decompress(struct rohc_comp *comp,
-                               struct rohc_decomp *decomp,
+static bool sniffer_replay(const rohc_cid_type_t cid_type,
+                           const size_t max_contexts,
+                           const int enabled_profiles[],
+                           const char *const replay_name,
+                           const size_t seek_pkt_num)
+	__attribute__((warn_unused_result, nonnull(4)));
+static void sniffer_capture_cb(u_char *user,
+                               const struct pcap_pkthdr *header,
+                               const u_char *packet)
+	__attribute__((nonnull(1, 2, 3)));
+static uint32_t sniffer_flow_hash(const unsigned char *const packet,
+                                  const size_t len,
+                                  const size_t link_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool sniffer_worker_init(struct sniffer_worker *const worker,
+                                const size_t id,
+                                const rohc_cid_type_t cid_type,
+                                const size_t max_contexts,
+                                const int enabled_profiles[],
+                                const size_t link_len_src)
+	__attribute__((warn_unused_result, nonnull(1, 5)));
+static void sniffer_worker_free(struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+static void * sniffer_worker_run(void *const arg)
+	__attribute__((nonnull(1)));
+static void sniffer_worker_account(struct sniffer_worker *const worker,
+                                   const int ret,
+                                   const unsigned int cid)
+	__attribute__((nonnull(1)));
+#ifdef SNIFFER_HAVE_RING
+static bool sniffer_ring_get_device(const char *const device_name,
+                                    int *const ifindex,
+                                    int *const link_layer_type)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool sniffer_ring_open(struct sniffer_worker *const worker,
+                              const int ifindex,
+                              const int fanout_arg)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_ring_close(struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+static void sniffer_ring_update_stats(struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+static void * sniffer_worker_run_ring(void *const arg)
+	__attribute__((nonnull(1)));
+static void sniffer_ring_process_block(struct sniffer_worker *const worker,
+                                       const struct tpacket_block_desc *const block)
+	__attribute__((nonnull(1, 2)));
+static void compress_decompress_burst(struct sniffer_worker *const worker,
+                                      const struct pcap_pkthdr headers[],
+                                      unsigned char *const packets[],
+                                      const size_t pkts_nr)
+	__attribute__((nonnull(1, 2, 3)));
+#endif
+static void * sniffer_writer_run(void *const arg)
+	__attribute__((nonnull(1)));
+static void sniffer_dump_pkt(const struct sniffer_worker *const worker,
+                             const struct pcap_pkthdr *const header,
+                             const unsigned char *const packet,
+                             const unsigned int cid,
+                             const bool is_new_stream,
+                             const bool is_comp_failure)
+	__attribute__((nonnull(1, 2, 3)));
+static bool sniffer_writer_append(struct sniffer_writer *const writer,
+                                  const struct sniffer_pkt *const pkt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool sniffer_writer_open_segment(struct sniffer_writer *const writer)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool sniffer_writer_close_segment(struct sniffer_writer *const writer)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_segment_filename(char *const filename,
+                                     const size_t filename_max_len,
+                                     const unsigned int seg_id,
+                                     const char *const ext)
+	__attribute__((nonnull(1, 4)));
+static bool sniffer_out_file_flush(struct sniffer_out_file *const file)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool sniffer_queue_init(struct sniffer_queue *const queue,
+                               const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_queue_free(struct sniffer_queue *const queue)
+	__attribute__((nonnull(1)));
+static struct sniffer_pkt * sniffer_queue_reserve(struct sniffer_queue *const queue,
+                                                  const size_t data_len,
+                                                  const bool do_wait)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_queue_commit(struct sniffer_queue *const queue,
+                                 const struct sniffer_pkt *const pkt)
+	__attribute__((nonnull(1, 2)));
+static struct sniffer_pkt * sniffer_queue_peek(struct sniffer_queue *const queue)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_queue_release(struct sniffer_queue *const queue,
+                                  const struct sniffer_pkt *const pkt)
+	__attribute__((nonnull(1, 2)));
+static void sniffer_queue_close(struct sniffer_queue *const queue)
+	__attribute__((nonnull(1)));
+static void sniffer_queue_wait_empty(struct sniffer_queue *const queue)
+	__attribute__((nonnull(1)));
+
+static int compress_decompress(struct sniffer_worker *const worker,
                                struct pcap_pkthdr header,
                                unsigned char *packet,
-                               size_t link_len_src,
-                               pcap_t *handle,
-                               pcap_dumper_t *dumpers[],
-                               struct rohc_buf *const feedback_send,
-                               unsigned int *const cid,
-                               struct sniffer_stats_t *stats);
+                               unsigned int *const cid)
+	__attribute__((nonnull(1, 3, 4)));
+static int sniffer_prepare_pkt(const size_t link_len_src,
+                               const struct pcap_pkthdr *const header,
+                               struct rohc_buf *const uncomp_packet)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
+static int sniffer_check_pkt(struct sniffer_worker *const worker,
+                             const struct pcap_pkthdr *const header,
+                             const unsigned char *const packet,
+                             const struct rohc_buf uncomp_packet,
+                             const struct rohc_buf rohc_packet,
+                             const rohc_status_t status,
+                             const struct rohc_comp_pkt_info *const comp_pkt_info,
+                             unsigned int *const cid)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 7, 8)));
 
 static int compare_packets(const struct rohc_buf pkt1,
                            const struct rohc_buf pkt2)
@@ -227,10 +620,15 @@ static bool write_pid_file(const char *const path)
 
 
 /** Whether the application shall stop or not */
-static bool stop_program;
+static volatile bool stop_program;
+
+/** Whether the statistics shall be printed by the capture thread or not */
+static volatile sig_atomic_t stats_requested;
 
 /** Some statistics collected by the sniffer */
 static struct sniffer_stats_t sniffer_stats;
+/** The lock that protects the statistics shared by the threads */
+static pthread_mutex_t sniffer_stats_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /** Whether the application runs in daemon mode or not */
 static bool is_daemon;
@@ -241,8 +639,19 @@ static bool is_verbose;
 /** Whether the application prints stats at regular interval of time or not */
 static bool do_print_stat;
 
-/** The PCAP dumpers */
-static pcap_dumper_t *sniffer_dumpers[ROHC_LARGE_CID_MAX + 1] = { 0 };
+/** The PCAP handle of the capture */
+static pcap_t *sniffer_handle = NULL;
+
+/** Whether the packets are captured with AF_PACKET rings or with libpcap */
+static bool sniffer_use_ring = false;
+
+/** The compression/decompression workers */
+static struct sniffer_worker *sniffer_workers = NULL;
+/** The number of compression/decompression workers */
+static size_t sniffer_workers_nr = 0;
+
+/** The writer of the PCAP files */
+static struct sniffer_writer sniffer_writer;
 
 /** The maximum number of traces to keep */
 #define MAX_LAST_TRACES  5000
@@ -255,6 +664,8 @@ static char last_traces[MAX_LAST_TRACES][MAX_LAST_TRACES + 1];
 static int last_traces_first;
 /** The index of the last trace */
 static int last_traces_last;
+/** The lock that protects the ring buffer for the last traces */
+static pthread_mutex_t last_traces_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /** Whether to print traces on stderr or not */
 static bool do_print_stderr = true;
@@ -291,6 +702,11 @@ int main(int argc, char *argv[])
 	char *cid_type_name = NULL;
 	char *device_name = NULL;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
+	int workers_nr = SNIFFER_WORKERS_DEFAULT;
+	char *capture_name = NULL;
+	bool use_ring = false;
+	char *replay_name = NULL;
+	int seek_pkt_num = 0; /* 0 means no seek */
 	int proto_version = 1; /* ROHC protocol version, v1 by default */
 	rohc_cid_type_t cid_type;
 	int args_used;
@@ -299,6 +715,7 @@ int main(int argc, char *argv[])
 
 	/* by default, we don't stop */
 	stop_program = false;
+	stats_requested = 0;
 
 	/* reset stats */
 	memset(&sniffer_stats, 0, sizeof(struct sniffer_stats_t));
@@ -397,6 +814,54 @@ int main(int argc, char *argv[])
 			max_contexts = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "-j") || !strcmp(*argv, "--workers"))
+		{
+			/* get the number of compression/decompression workers */
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "missing mandatory -j/--workers parameter");
+				usage();
+				goto error;
+			}
+			workers_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "-c") || !strcmp(*argv, "--capture"))
+		{
+			/* get the capture backend */
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "missing mandatory -c/--capture parameter");
+				usage();
+				goto error;
+			}
+			capture_name = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--replay"))
+		{
+			/* get the ROHC capture to decompress instead of sniffing */
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "missing mandatory --replay parameter");
+				usage();
+				goto error;
+			}
+			replay_name = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--seek"))
+		{
+			/* get the packet of the ROHC capture to start the replay at */
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "missing mandatory --seek parameter");
+				usage();
+				goto error;
+			}
+			seek_pkt_num = atoi(argv[1]);
+			args_used++;
+		}
 		else if(!strcmp(*argv, "--rohc-version"))
 		{
 			/* get the ROHC version to use */
@@ -492,6 +957,32 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* check capture backend */
+	if(capture_name == NULL || !strcmp(capture_name, "pcap"))
+	{
+		use_ring = false;
+	}
+	else if(!strcmp(capture_name, "ring"))
+	{
+		use_ring = true;
+	}
+	else
+	{
+		SNIFFER_LOG(LOG_WARNING, "invalid capture backend, only 'pcap' and "
+		            "'ring' expected");
+		usage();
+		goto error;
+	}
+
+	/* the number of workers should be valid */
+	if(workers_nr < 1 || (size_t) workers_nr > SNIFFER_WORKERS_MAX)
+	{
+		SNIFFER_LOG(LOG_WARNING, "the number of workers should be between 1 "
+		            "and %u", SNIFFER_WORKERS_MAX);
+		usage();
+		goto error;
+	}
+
 	if(proto_version != 1 && proto_version != 2)
 	{
 		SNIFFER_LOG(LOG_WARNING, "invalid ROHC version '%d': specify 1 for ROHCv1 and "
@@ -538,6 +1029,32 @@ int main(int argc, char *argv[])
 		enabled_profiles[ROHCv1_PROFILE_IP_UDPLITE] = 0;
 	}
 
+	/* decompress the ROHC capture instead of sniffing if asked */
+	if(seek_pkt_num < 0 || (seek_pkt_num != 0 && replay_name == NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "option --seek requires option --replay and "
+		            "a packet between 1 and %d", INT_MAX);
+		usage();
+		goto error;
+	}
+	if(replay_name != NULL)
+	{
+		if(device_name != NULL || is_daemon)
+		{
+			SNIFFER_LOG(LOG_WARNING, "option --replay cannot be used with "
+			            "DEVICE nor option --daemon");
+			usage();
+			goto error;
+		}
+		if(!sniffer_replay(cid_type, max_contexts, enabled_profiles,
+		                   replay_name, seek_pkt_num))
+		{
+			goto error;
+		}
+		closelog();
+		return 0;
+	}
+
 	/* the source filename is mandatory */
 	if(device_name == NULL)
 	{
@@ -616,7 +1133,7 @@ int main(int argc, char *argv[])
 	signal(SIGTERM, sniffer_interrupt);
 	signal(SIGSEGV, sniffer_interrupt);
 	signal(SIGABRT, sniffer_interrupt);
-	signal(SIGUSR1, sniffer_print_stats);
+	signal(SIGUSR1, sniffer_request_stats);
 	{
 		struct sigaction action;
 		memset(&action, 0, sizeof(struct sigaction));
@@ -625,7 +1142,8 @@ int main(int argc, char *argv[])
 	}
 
 	/* test ROHC compression/decompression with the packets from the file */
-	if(!sniff(cid_type, max_contexts, enabled_profiles, device_name))
+	if(!sniff(cid_type, max_contexts, enabled_profiles, device_name,
+	          workers_nr, use_ring))
 	{
 		goto error;
 	}
@@ -669,6 +1187,7 @@ static void usage(void)
 	       "to run the ROHC sniffer.\n"
 	       "\n"
 	       "Usage: rohc_sniffer [OPTIONS] CID_TYPE DEVICE\n"
+	       "       rohc_sniffer [OPTIONS] --replay FILE [--seek NUM] CID_TYPE\n"
 	       "\n"
 	       "Options:\n"
 	       "  CID_TYPE                The type of CID to use among 'smallcid'\n"
@@ -680,6 +1199,20 @@ static void usage(void)
 	       "  -p, --pidfile FILE      Write daemon PID in the given file\n"
 	       "  -m, --max-contexts NUM  The maximum number of ROHC contexts to\n"
 	       "                          simultaneously use during the test\n"
+	       "                          (per worker)\n"
+	       "  -j, --workers NUM       The number of compression/decompression\n"
+	       "                          workers, the flows are sharded among\n"
+	       "                          them (default: %u, max: %u)\n"
+	       "  -c, --capture BACKEND   The capture backend among 'pcap' (one\n"
+	       "                          capture thread with libpcap, default)\n"
+	       "                          and 'ring' (one AF_PACKET ring per\n"
+	       "                          worker, packets compressed in place\n"
+	       "                          and in bursts, Linux only)\n"
+	       "      --replay FILE       Decompress the ROHC packets of the given\n"
+	       "                          ROHC capture instead of sniffing\n"
+	       "      --seek NUM          Start the replay at packet NUM of the\n"
+	       "                          ROHC capture: the contexts are restored\n"
+	       "                          from the nearest snapshot\n"
 	       "      --rohc-version NUM  The ROHC version to use: 1 for ROHCv1\n"
 	       "                          and 2 for ROHCv2\n"
 	       "      --disable PROFILE   A ROHC profile to disable\n"
@@ -693,8 +1226,16 @@ static void usage(void)
 	       "  rohc_sniffer -m 450 largecid wlan0  compress traffic from\n"
 	       "                                      wlan0 with large CIDs, no\n"
 	       "                                      more than 450 streams\n"
+	       "  rohc_sniffer -j 8 largecid eth1     compress traffic from eth1\n"
+	       "                                      with 8 workers\n"
+	       "  rohc_sniffer -j 8 -c ring largecid eth1\n"
+	       "                                      same with 8 capture rings\n"
+	       "  rohc_sniffer --replay day.rcap --seek 123456 smallcid\n"
+	       "                                      decompress one ROHC capture\n"
+	       "                                      from packet 123456\n"
 	       "\n"
-	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       SNIFFER_WORKERS_DEFAULT, SNIFFER_WORKERS_MAX);
 }
 
 
@@ -714,7 +1255,6 @@ static void sniffer_interrupt(int signum)
 	if(signum == SIGSEGV || signum == SIGABRT)
 	{
 		int i;
-		size_t j;
 
 		if(signum == SIGSEGV)
 		{
@@ -727,13 +1267,16 @@ static void sniffer_interrupt(int signum)
 			            sniffer_stats.total_packets);
 		}
 
-		/* close PCAP dumpers */
-		for(j = 0; j <= ROHC_LARGE_CID_MAX; j++)
+		/* write the buffered packets in the dump files, the writer thread
+		 * might still be running but the program is about to die anyway */
+		if(sniffer_writer.is_started)
 		{
-			if(sniffer_dumpers[j] != NULL)
+			SNIFFER_LOG(LOG_INFO, "flush segment #%u of the dump files",
+			            sniffer_writer.seg_id);
+			if(!sniffer_out_file_flush(&sniffer_writer.seg) ||
+			   !sniffer_out_file_flush(&sniffer_writer.idx))
 			{
-				SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %zu", j);
-				pcap_dump_close(sniffer_dumpers[j]);
+				SNIFFER_LOG(LOG_WARNING, "failed to flush the dump files");
 			}
 		}
 
@@ -781,6 +1324,20 @@ static void sniffer_interrupt(int signum)
 }
 
 
+/**
+ * @brief Handle UNIX signals that request statistics
+ *
+ * The statistics are printed by the capture thread, not in the handler, as
+ * printing them requires the locks of the pipeline.
+ *
+ * @param signum  The received signal
+ */
+static void sniffer_request_stats(int signum __attribute__((unused)))
+{
+	stats_requested = 1;
+}
+
+
 /**
  * @brief Compute a percentage
  *
@@ -809,15 +1366,22 @@ static unsigned long long compute_percent(const unsigned long value,
 
 
 /**
- * @brief Handle UNIX signals that print statistics
+ * @brief Print the statistics of the sniffer
  *
- * @param signum  The received signal
+ * Shall be called by the capture thread only.
  */
-static void sniffer_print_stats(int signum __attribute__((unused)))
+static void sniffer_print_stats(void)
 {
+	struct pcap_stat capture_stats;
 	unsigned long total;
+	size_t depth;
+	size_t max_depth;
+	unsigned long drops;
+	size_t j;
 	int i;
 
+	pthread_mutex_lock(&sniffer_stats_lock);
+
 	SNIFFER_LOG(LOG_INFO, "dump ROHC sniffer statistics...");
 
 	/* general */
@@ -982,65 +1546,150 @@ static void sniffer_print_stats(int signum __attribute__((unused)))
 		}
 	}
 
+	pthread_mutex_unlock(&sniffer_stats_lock);
+
+	/* pipeline: capture, then workers, then writer */
+	SNIFFER_LOG(LOG_INFO, "pipeline:");
+	if(sniffer_handle != NULL && pcap_stats(sniffer_handle, &capture_stats) == 0)
+	{
+		SNIFFER_LOG(LOG_INFO, "  capture: %u packets received, %u dropped by "
+		            "kernel, %u dropped by interface", capture_stats.ps_recv,
+		            capture_stats.ps_drop, capture_stats.ps_ifdrop);
+	}
+	for(j = 0; j < sniffer_workers_nr; j++)
+	{
+		struct sniffer_queue *const queue = &sniffer_workers[j].queue;
+
+#ifdef SNIFFER_HAVE_RING
+		if(sniffer_use_ring)
+		{
+			sniffer_ring_update_stats(&sniffer_workers[j]);
+			SNIFFER_LOG(LOG_INFO, "  worker #%zu: capture ring %lu packets "
+			            "received, %lu dropped by kernel", j,
+			            sniffer_workers[j].ring_packets,
+			            sniffer_workers[j].ring_drops);
+			continue;
+		}
+#endif
+
+		pthread_mutex_lock(&queue->lock);
+		depth = queue->depth;
+		max_depth = queue->max_depth;
+		drops = queue->drops;
+		pthread_mutex_unlock(&queue->lock);
+
+		SNIFFER_LOG(LOG_INFO, "  worker #%zu: queue depth %zu packets (max %zu), "
+		            "%lu packets dropped", j, depth, max_depth, drops);
+	}
+	if(sniffer_writer.is_started)
+	{
+		struct sniffer_queue *const queue = &sniffer_writer.queue;
+
+		pthread_mutex_lock(&queue->lock);
+		depth = queue->depth;
+		max_depth = queue->max_depth;
+		drops = queue->drops;
+		pthread_mutex_unlock(&queue->lock);
+
+		SNIFFER_LOG(LOG_INFO, "  writer: queue depth %zu packets (max %zu), "
+		            "%lu packets dropped", depth, max_depth, drops);
+	}
+
 	SNIFFER_LOG(LOG_INFO, "all ROHC sniffer statistics dumped");
 }
 
 
 /**
  * @brief Test the ROHC library with a sniffed flow of IP packets going
- *        through one compressor/decompressor pair
+ *        through a pipeline of compressor/decompressor pairs
+ *
+ * The calling thread becomes the capture thread of the pipeline.
  *
  * @param cid_type          The type of CIDs that the compressor shall use
  * @param max_contexts      The maximum number of ROHC contexts to use
  * @param enabled_profiles  The ROHC profiles to enable
  * @param device_name       The name of the network device
+ * @param workers_nr        The number of compression/decompression workers
+ * @param use_ring          Whether every worker captures its packets with one
+ *                          AF_PACKET ring, or the calling thread captures all
+ *                          the packets with libpcap
  * @return                  Whether the sniffer setup was OK
  */
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
                   const int enabled_profiles[],
-                  const char *const device_name)
+                  const char *const device_name,
+                  const size_t workers_nr,
+                  const bool use_ring)
 {
 	char errbuf[PCAP_ERRBUF_SIZE];
-	pcap_t *handle;
+	pcap_t *handle = NULL;
 	int link_layer_type_src;
-	int link_len_src;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
-
-	struct rohc_comp *comp;
-	struct rohc_decomp *decomp;
-
-	uint8_t feedback_send_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf feedback_send =
-		rohc_buf_init_empty(feedback_send_buffer, MAX_ROHC_SIZE);
-
-	unsigned int i;
-
-	/* statistics */
-	unsigned int nb_ok = 0;
-	unsigned int nb_bad = 0;
-	unsigned int nb_internal_err = 0;
-	unsigned int err_comp = 0;
-	unsigned int err_decomp = 0;
-	unsigned int nb_ref = 0;
+	size_t link_len_src;
+	size_t workers_init_nr = 0;
+#ifdef SNIFFER_HAVE_RING
+	int ifindex = 0;
+#endif
+	unsigned int ticks_nr = 0;
+	size_t i;
+	int ret;
 
 	/* init status */
 	bool status = false;
 
 	assert(device_name != NULL);
+	assert(workers_nr > 0);
 
-	/* open the network device */
-	handle = pcap_open_live(device_name, DEV_MTU, 0, 0, errbuf);
-	if(handle == NULL)
+	if(use_ring)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
-		            device_name, errbuf);
+#ifdef SNIFFER_HAVE_RING
+		/* the rings are opened along with the workers */
+		if(!sniffer_ring_get_device(device_name, &ifindex, &link_layer_type_src))
+		{
+			goto error;
+		}
+#else
+		SNIFFER_LOG(LOG_WARNING, "AF_PACKET capture rings are not supported on "
+		            "this platform");
 		goto error;
+#endif
+	}
+	else
+	{
+		/* open the network device with a large capture buffer, so that bursts
+		 * of traffic are absorbed while the workers catch up */
+		handle = pcap_create(device_name, errbuf);
+		if(handle == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
+			            device_name, errbuf);
+			goto error;
+		}
+		if(pcap_set_snaplen(handle, DEV_MTU) != 0 ||
+		   pcap_set_promisc(handle, 0) != 0 ||
+		   pcap_set_timeout(handle, SNIFFER_CAPTURE_TIMEOUT_MS) != 0 ||
+		   pcap_set_buffer_size(handle, SNIFFER_CAPTURE_BUFFER_SIZE) != 0)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to configure network device '%s'",
+			            device_name);
+			goto close_input;
+		}
+		ret = pcap_activate(handle);
+		if(ret < 0)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to activate network device '%s': %s",
+			            device_name, pcap_geterr(handle));
+			goto close_input;
+		}
+		else if(ret > 0)
+		{
+			SNIFFER_LOG(LOG_NOTICE, "network device '%s' activated with warning: "
+			            "%s", device_name, pcap_geterr(handle));
+		}
+		link_layer_type_src = pcap_datalink(handle);
 	}
 
 	/* link layer in the source dump must be Ethernet */
-	link_layer_type_src = pcap_datalink(handle);
 	if(link_layer_type_src != DLT_EN10MB &&
 	   link_layer_type_src != DLT_LINUX_SLL &&
 	   link_layer_type_src != DLT_RAW)
@@ -1064,71 +1713,278 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		link_len_src = 0;
 	}
 
-	/* create the ROHC compressor */
-	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
-	if(comp == NULL)
+	/* the writer opens the dump files with the same link layer as the
+	 * capture, but without sharing the capture handle */
+	memset(&sniffer_writer, 0, sizeof(struct sniffer_writer));
+	sniffer_writer.linktype = link_layer_type_src;
+	sniffer_writer.seg.fd = -1;
+	sniffer_writer.idx.fd = -1;
+	sniffer_writer.handle = pcap_open_dead(link_layer_type_src, DEV_MTU);
+	if(sniffer_writer.handle == NULL)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to create the ROHC compressor");
+		SNIFFER_LOG(LOG_WARNING, "failed to create the PCAP handle for the "
+		            "dump files");
 		goto close_input;
 	}
+	if(!sniffer_queue_init(&sniffer_writer.queue, SNIFFER_QUEUE_SIZE))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the queue of the writer");
+		goto close_writer_handle;
+	}
 
-	/* set the callback for traces on compressor */
-	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	/* the packets are saved in a few large segments instead of one PCAP file
+	 * per context, the segments are written with large sequential writes */
+	sniffer_writer.seg.buf = malloc(SNIFFER_WRITE_BUF_LEN);
+	sniffer_writer.idx.buf = malloc(SNIFFER_WRITE_BUF_LEN);
+	if(sniffer_writer.seg.buf == NULL || sniffer_writer.idx.buf == NULL)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set the trace callback for the "
-		            "compressor");
-		goto destroy_comp;
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for the buffers "
+		            "of the writer");
+		goto free_writer_bufs;
+	}
+	if(!sniffer_writer_open_segment(&sniffer_writer))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to open the first segment of the dump "
+		            "files");
+		goto free_writer_bufs;
 	}
 
-	/* enable the compression profiles */
-	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	/* create the workers, one compressor/decompressor pair each */
+	sniffer_workers = calloc(workers_nr, sizeof(struct sniffer_worker));
+	if(sniffer_workers == NULL)
 	{
-		if(enabled_profiles[i] == 1 && !rohc_comp_enable_profile(comp, i))
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to enable compression profile "
-			            "0x%04x", i);
-			goto destroy_comp;
-		}
-		else if(enabled_profiles[i] == 0 && !rohc_comp_disable_profile(comp, i))
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for the workers");
+		goto close_segment;
+	}
+	for(workers_init_nr = 0; workers_init_nr < workers_nr; workers_init_nr++)
+	{
+		if(!sniffer_worker_init(&sniffer_workers[workers_init_nr], workers_init_nr,
+		                        cid_type, max_contexts, enabled_profiles,
+		                        link_len_src))
 		{
-			SNIFFER_LOG(LOG_WARNING, "failed to disable compression profile "
-			            "0x%04x", i);
-			goto destroy_comp;
+			SNIFFER_LOG(LOG_WARNING, "failed to create worker #%zu",
+			            workers_init_nr);
+			goto free_workers;
 		}
 	}
+	sniffer_workers_nr = workers_nr;
+	sniffer_use_ring = use_ring;
+	sniffer_stats.total_packets = 0;
 
-	/* set the callback for RTP stream detection */
-	if(!rohc_comp_set_rtp_detection_cb(comp, rtp_detect_cb, NULL))
+#ifdef SNIFFER_HAVE_RING
+	/* one capture ring per worker, the kernel shards the flows among the
+	 * rings of the fanout group */
+	if(use_ring)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set the RTP stream detection "
-		            "callback for compressor");
-		goto destroy_comp;
+		const int fanout_arg = (getpid() & 0xffff) | (PACKET_FANOUT_HASH << 16);
+
+		for(i = 0; i < workers_nr; i++)
+		{
+			if(!sniffer_ring_open(&sniffer_workers[i], ifindex,
+			                      (workers_nr > 1 ? fanout_arg : 0)))
+			{
+				SNIFFER_LOG(LOG_WARNING, "failed to open the capture ring of "
+				            "worker #%zu", i);
+				goto free_workers;
+			}
+		}
 	}
+#endif
 
-	/* create the decompressor (bi-directional mode) */
-	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
-	if(decomp == NULL)
+	/* start the writer, then the workers */
+	ret = pthread_create(&sniffer_writer.thread, NULL, sniffer_writer_run,
+	                     &sniffer_writer);
+	if(ret != 0)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
-		goto destroy_comp;
+		SNIFFER_LOG(LOG_WARNING, "failed to start the writer: %s (%d)",
+		            strerror(ret), ret);
+		goto free_workers;
 	}
-
-	/* set the callback for traces on decompressor */
-	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	sniffer_writer.is_started = true;
+	for(i = 0; i < workers_nr; i++)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set trace callback for "
-		            "decompressor");
-		goto destroy_decomp;
+#ifdef SNIFFER_HAVE_RING
+		ret = pthread_create(&sniffer_workers[i].thread, NULL,
+		                     (use_ring ? sniffer_worker_run_ring : sniffer_worker_run),
+		                     &sniffer_workers[i]);
+#else
+		ret = pthread_create(&sniffer_workers[i].thread, NULL,
+		                     sniffer_worker_run, &sniffer_workers[i]);
+#endif
+		if(ret != 0)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to start worker #%zu: %s (%d)",
+			            i, strerror(ret), ret);
+			goto stop_pipeline;
+		}
+		sniffer_workers[i].is_started = true;
 	}
+	sniffer_handle = handle;
 
-	/* enable the decompression profiles */
-	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	SNIFFER_LOG(LOG_INFO, "ROHC sniffer successfully started with %zu "
+	            "worker(s)", workers_nr);
+	SNIFFER_LOG(LOG_INFO, "start processing captured packets");
+
+	/* capture the packets and dispatch them to the workers until the program
+	 * is stopped, the capture times out regularly to handle the requests for
+	 * statistics */
+	while(!stop_program)
 	{
-		if(enabled_profiles[i] == 1 && !rohc_decomp_enable_profile(decomp, i))
+		if(use_ring)
 		{
-			SNIFFER_LOG(LOG_WARNING, "failed to enable decompression profile "
-			            "0x%04x", i);
-			goto destroy_decomp;
+			/* the workers capture their packets by themselves */
+			usleep(SNIFFER_CAPTURE_TIMEOUT_MS * 1000);
+			if(!is_daemon)
+			{
+				pthread_mutex_lock(&sniffer_stats_lock);
+				printf("\rpacket #%lu", sniffer_stats.total_packets);
+				pthread_mutex_unlock(&sniffer_stats_lock);
+				fflush(stdout);
+			}
+			ticks_nr++;
+			if(do_print_stat && (ticks_nr % SNIFFER_RING_STATS_TICKS) == 0)
+			{
+				printf("\n\n");
+				stats_requested = 1;
+			}
+		}
+		else
+		{
+			ret = pcap_dispatch(handle, -1, sniffer_capture_cb,
+			                    (u_char *) &link_len_src);
+			if(ret == -1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "failed to capture packets: %s",
+				            pcap_geterr(handle));
+				goto stop_pipeline;
+			}
+		}
+
+		if(stats_requested)
+		{
+			stats_requested = 0;
+			sniffer_print_stats();
+		}
+	}
+
+	if(stop_program)
+	{
+		SNIFFER_LOG(LOG_INFO, "program stopped by signal");
+	}
+
+	status = true;
+
+stop_pipeline:
+	/* let the workers process the packets already captured, then let the
+	 * writer save them: the workers with capture rings stop on the flag, the
+	 * other ones once their queue is empty */
+	stop_program = true;
+	for(i = 0; i < workers_nr; i++)
+	{
+		if(sniffer_workers[i].is_started)
+		{
+			sniffer_queue_close(&sniffer_workers[i].queue);
+			pthread_join(sniffer_workers[i].thread, NULL);
+			sniffer_workers[i].is_started = false;
+		}
+	}
+	sniffer_queue_close(&sniffer_writer.queue);
+	pthread_join(sniffer_writer.thread, NULL);
+	sniffer_writer.is_started = false;
+	sniffer_handle = NULL;
+
+free_workers:
+	for(i = 0; i < workers_init_nr; i++)
+	{
+		sniffer_worker_free(&sniffer_workers[i]);
+	}
+	sniffer_workers_nr = 0;
+	free(sniffer_workers);
+	sniffer_workers = NULL;
+close_segment:
+	/* write the buffered packets in the last segment of the dump files */
+	SNIFFER_LOG(LOG_INFO, "close segment #%u of the dump files",
+	            sniffer_writer.seg_id);
+	if(!sniffer_writer_close_segment(&sniffer_writer))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to close the last segment of the dump "
+		            "files");
+		status = false;
+	}
+free_writer_bufs:
+	free(sniffer_writer.idx.buf);
+	free(sniffer_writer.seg.buf);
+	sniffer_queue_free(&sniffer_writer.queue);
+close_writer_handle:
+	pcap_close(sniffer_writer.handle);
+close_input:
+	if(handle != NULL)
+	{
+		pcap_close(handle);
+	}
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress the packets of one ROHC capture
+ *
+ * The contexts are restored from the last snapshot before the given packet,
+ * then all the packets from the snapshot to the end of the capture are
+ * decompressed. There is no feedback channel, the decompressor thus works
+ * in U-mode.
+ *
+ * @param cid_type          The type of CIDs that the decompressor shall use
+ * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param enabled_profiles  The ROHC profiles to enable
+ * @param replay_name       The ROHC capture
+ * @param seek_pkt_num      The packet (from 1) to start the replay at,
+ *                          0 for the first packet of the capture
+ * @return                  Whether all the packets were decompressed
+ */
+static bool sniffer_replay(const rohc_cid_type_t cid_type,
+                           const size_t max_contexts,
+                           const int enabled_profiles[],
+                           const char *const replay_name,
+                           const size_t seek_pkt_num)
+{
+	struct rohc_capture_map map;
+	struct rohc_capture_rec_hdr rec;
+	struct rohc_decomp *decomp;
+	const uint8_t *packet;
+	uint64_t first_pkt_num;
+	size_t ctxts_nr;
+	unsigned long nb_ok = 0;
+	unsigned long nb_bad = 0;
+	bool is_success = false;
+	int i;
+
+	if(!rohc_capture_map_open(replay_name, &map))
+	{
+		goto error;
+	}
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
+		goto close_capture;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set trace callback for "
+		            "decompressor");
+		goto destroy_decomp;
+	}
+	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(enabled_profiles[i] == 1 && !rohc_decomp_enable_profile(decomp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to enable decompression profile "
+			            "0x%04x", i);
+			goto destroy_decomp;
 		}
 		else if(enabled_profiles[i] == 0 &&
 		        !rohc_decomp_disable_profile(decomp, i))
@@ -1139,136 +1995,1323 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		}
 	}
 
-	/* reset the PCAP dumpers (used to save sniffed packets in several PCAP
-	 * files, one per Context ID) */
-	bzero(sniffer_dumpers, sizeof(pcap_dumper_t *) * max_contexts);
+	/* restore the contexts from the nearest snapshot */
+	if(!rohc_capture_map_seek(&map, decomp,
+	                          seek_pkt_num > 0 ? seek_pkt_num - 1 : 0,
+	                          &first_pkt_num, &ctxts_nr))
+	{
+		goto destroy_decomp;
+	}
+	SNIFFER_LOG(LOG_INFO, "replay ROHC capture '%s' from packet #%llu with "
+	            "%zu restored contexts", replay_name,
+	            (unsigned long long) first_pkt_num + 1, ctxts_nr);
+
+	while(!stop_program && rohc_capture_map_next(&map, &rec, &packet))
+	{
+		const struct rohc_ts arrival_time = {
+			.sec = rec.ts_sec,
+			.nsec = rec.ts_nsec
+		};
+		const struct rohc_buf rohc_packet =
+			rohc_buf_init_full((uint8_t *) packet, rec.len, arrival_time);
+		uint8_t ip_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf ip_packet = rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+
+		if(rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL,
+		                    NULL) != ROHC_STATUS_OK)
+		{
+			SNIFFER_LOG(LOG_WARNING, "packet #%llu: decompression failed",
+			            (unsigned long long) rec.pkt_num + 1);
+			nb_bad++;
+		}
+		else
+		{
+			nb_ok++;
+		}
+	}
+	SNIFFER_LOG(LOG_INFO, "%lu packets decompressed, %lu failures",
+	            nb_ok, nb_bad);
+	is_success = (nb_bad == 0);
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+close_capture:
+	rohc_capture_map_close(&map);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Dispatch one captured packet to the worker of its flow
+ *
+ * The packet is dropped if the queue of the worker is full: the capture
+ * shall never wait for the workers.
+ *
+ * @param user    The length of the link layer header before IP data
+ * @param header  The PCAP header of the packet
+ * @param packet  The captured packet (link layer included)
+ */
+static void sniffer_capture_cb(u_char *user,
+                               const struct pcap_pkthdr *header,
+                               const u_char *packet)
+{
+	const size_t link_len_src = *((const size_t *) user);
+	struct sniffer_worker *worker;
+	struct sniffer_pkt *pkt;
+	unsigned long total_packets;
+
+	pthread_mutex_lock(&sniffer_stats_lock);
+	sniffer_stats.total_packets++;
+	total_packets = sniffer_stats.total_packets;
+	pthread_mutex_unlock(&sniffer_stats_lock);
+
+	if(!is_daemon &&
+	   (total_packets == 1 || (total_packets % 100) == 0))
+	{
+		if(total_packets > 1)
+		{
+			printf("\r");
+		}
+		printf("packet #%lu", total_packets);
+		fflush(stdout);
+
+		if(do_print_stat && (total_packets % 1000) == 0)
+		{
+			printf("\n\n");
+			fprintf(stderr, "================================================\n");
+			sniffer_print_stats();
+			fprintf(stderr, "================================================\n");
+			fprintf(stderr, "\n");
+			fflush(stderr);
+		}
+	}
+
+	/* all the packets of one flow go to the same worker */
+	worker = &sniffer_workers[sniffer_flow_hash(packet, header->caplen,
+	                                            link_len_src) % sniffer_workers_nr];
+
+	pkt = sniffer_queue_reserve(&worker->queue, header->caplen, false);
+	if(pkt == NULL)
+	{
+		/* queue is full, drop is counted by the queue */
+		return;
+	}
+	memcpy(&pkt->header, header, sizeof(struct pcap_pkthdr));
+	memcpy(pkt->data, packet, header->caplen);
+	sniffer_queue_commit(&worker->queue, pkt);
+}
+
+
+/**
+ * @brief Compute the hash of the flow of one captured packet
+ *
+ * The flow is identified by the IP addresses and protocol, and by the ports
+ * of the TCP, UDP and UDP-Lite packets that are not fragmented. Packets that
+ * are not IP all belong to the same flow.
+ *
+ * @param packet    The captured packet (link layer included)
+ * @param len       The length of the captured packet
+ * @param link_len  The length of the link layer header before IP data
+ * @return          The hash of the flow
+ */
+static uint32_t sniffer_flow_hash(const unsigned char *const packet,
+                                  const size_t len,
+                                  const size_t link_len)
+{
+	const uint32_t fnv_prime = 16777619U;
+	const unsigned char *ip;
+	size_t ip_len;
+	uint32_t hash = 2166136261U;
+	uint8_t protocol;
+	size_t l4_offset;
+	size_t i;
+
+	if(len <= link_len)
+	{
+		goto not_ip;
+	}
+	ip = packet + link_len;
+	ip_len = len - link_len;
+
+	if(((ip[0] >> 4) & 0x0f) == 4 && ip_len >= 20)
+	{
+		const uint16_t frag = ((ip[6] & 0x3f) << 8) | ip[7];
+
+		protocol = ip[9];
+		for(i = 12; i < 20; i++)
+		{
+			hash = (hash ^ ip[i]) * fnv_prime;
+		}
+		l4_offset = (frag != 0 ? ip_len : (size_t) ((ip[0] & 0x0f) * 4));
+	}
+	else if(((ip[0] >> 4) & 0x0f) == 6 && ip_len >= 40)
+	{
+		protocol = ip[6];
+		for(i = 8; i < 40; i++)
+		{
+			hash = (hash ^ ip[i]) * fnv_prime;
+		}
+		l4_offset = 40;
+	}
+	else
+	{
+		goto not_ip;
+	}
+	hash = (hash ^ protocol) * fnv_prime;
+
+	if((protocol == IPPROTO_TCP || protocol == IPPROTO_UDP ||
+	    protocol == IPPROTO_UDPLITE) && ip_len >= (l4_offset + 4))
+	{
+		for(i = l4_offset; i < (l4_offset + 4); i++)
+		{
+			hash = (hash ^ ip[i]) * fnv_prime;
+		}
+	}
+
+	/* the low bits of the hash select the worker: mix the high bits in */
+	return hash ^ (hash >> 16);
+
+not_ip:
+	return 0;
+}
+
+
+/**
+ * @brief Create one compression/decompression worker
+ *
+ * @param worker            The worker to create
+ * @param id                The index of the worker
+ * @param cid_type          The type of CIDs that the compressor shall use
+ * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param enabled_profiles  The ROHC profiles to enable
+ * @param link_len_src      The length of the link layer header before IP data
+ * @return                  true if the worker was created, false otherwise
+ */
+static bool sniffer_worker_init(struct sniffer_worker *const worker,
+                                const size_t id,
+                                const rohc_cid_type_t cid_type,
+                                const size_t max_contexts,
+                                const int enabled_profiles[],
+                                const size_t link_len_src)
+{
+	unsigned int i;
+
+	memset(worker, 0, sizeof(struct sniffer_worker));
+	worker->id = id;
+	worker->ring_fd = -1;
+	worker->link_len_src = link_len_src;
+	worker->feedback_send.data = worker->feedback_send_buffer;
+	worker->feedback_send.max_len = MAX_ROHC_SIZE;
+
+	if(!sniffer_queue_init(&worker->queue, SNIFFER_QUEUE_SIZE))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the queue of the worker");
+		goto error;
+	}
+
+	/* create the ROHC compressor */
+	worker->comp = rohc_comp_new2(cid_type, max_contexts - 1,
+	                              gen_false_random_num, NULL);
+	if(worker->comp == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the ROHC compressor");
+		goto free_queue;
+	}
+
+	/* set the callback for traces on compressor */
+	if(!rohc_comp_set_traces_cb2(worker->comp, print_rohc_traces, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set the trace callback for the "
+		            "compressor");
+		goto destroy_comp;
+	}
+
+	/* enable the compression profiles */
+	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(enabled_profiles[i] == 1 && !rohc_comp_enable_profile(worker->comp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to enable compression profile "
+			            "0x%04x", i);
+			goto destroy_comp;
+		}
+		else if(enabled_profiles[i] == 0 &&
+		        !rohc_comp_disable_profile(worker->comp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to disable compression profile "
+			            "0x%04x", i);
+			goto destroy_comp;
+		}
+	}
+
+	/* set the callback for RTP stream detection */
+	if(!rohc_comp_set_rtp_detection_cb(worker->comp, rtp_detect_cb, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set the RTP stream detection "
+		            "callback for compressor");
+		goto destroy_comp;
+	}
+
+	/* create the decompressor (bi-directional mode) */
+	worker->decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
+	if(worker->decomp == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
+		goto destroy_comp;
+	}
+
+	/* set the callback for traces on decompressor */
+	if(!rohc_decomp_set_traces_cb2(worker->decomp, print_rohc_traces, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set trace callback for "
+		            "decompressor");
+		goto destroy_decomp;
+	}
+
+	/* enable the decompression profiles */
+	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(enabled_profiles[i] == 1 &&
+		   !rohc_decomp_enable_profile(worker->decomp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to enable decompression profile "
+			            "0x%04x", i);
+			goto destroy_decomp;
+		}
+		else if(enabled_profiles[i] == 0 &&
+		        !rohc_decomp_disable_profile(worker->decomp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to disable decompression profile "
+			            "0x%04x", i);
+			goto destroy_decomp;
+		}
+	}
+
+	return true;
+
+destroy_decomp:
+	rohc_decomp_free(worker->decomp);
+destroy_comp:
+	rohc_comp_free(worker->comp);
+free_queue:
+	sniffer_queue_free(&worker->queue);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy one compression/decompression worker
+ *
+ * The thread of the worker shall be stopped.
+ *
+ * @param worker  The worker to destroy
+ */
+static void sniffer_worker_free(struct sniffer_worker *const worker)
+{
+#ifdef SNIFFER_HAVE_RING
+	if(worker->ring_fd >= 0)
+	{
+		sniffer_ring_close(worker);
+	}
+#endif
+	rohc_decomp_free(worker->decomp);
+	rohc_comp_free(worker->comp);
+	sniffer_queue_free(&worker->queue);
+}
+
+
+/**
+ * @brief Compress, decompress and compare the packets of one worker
+ *
+ * The worker stops once its queue is closed and empty.
+ *
+ * @param arg  The worker
+ * @return     Always NULL
+ */
+static void * sniffer_worker_run(void *const arg)
+{
+	struct sniffer_worker *const worker = arg;
+	struct sniffer_pkt *pkt;
+
+	while((pkt = sniffer_queue_peek(&worker->queue)) != NULL)
+	{
+		unsigned int cid = 0;
+		int ret;
+
+		/* compress & decompress from compressor to decompressor */
+		ret = compress_decompress(worker, pkt->header, pkt->data, &cid);
+		sniffer_queue_release(&worker->queue, pkt);
+		sniffer_worker_account(worker, ret, cid);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Account for the result of one packet processed by one worker
+ *
+ * The program dies in case of problem, bad packets excepted.
+ *
+ * @param worker  The worker that processed the packet
+ * @param ret     The result of \ref compress_decompress for the packet
+ * @param cid     The CID used for the packet
+ */
+static void sniffer_worker_account(struct sniffer_worker *const worker,
+                                   const int ret,
+                                   const unsigned int cid)
+{
+	if(ret == -1)
+	{
+		worker->err_comp++;
+	}
+	else if(ret == -2)
+	{
+		worker->err_decomp++;
+	}
+	else if(ret == 0)
+	{
+		worker->nb_ref++;
+	}
+	else if(ret == 1)
+	{
+		worker->nb_ok++;
+	}
+	else if(ret == -3)
+	{
+		worker->nb_bad++;
+		pthread_mutex_lock(&sniffer_stats_lock);
+		sniffer_stats.bad_packets++;
+		pthread_mutex_unlock(&sniffer_stats_lock);
+	}
+	else
+	{
+		worker->nb_internal_err++;
+	}
+
+	/* in case of problem (ignore bad packets), just die! */
+	if(ret != 1 && ret != -3)
+	{
+		SNIFFER_LOG(LOG_WARNING, "worker #%zu, CID %u: stats OK, ERR(COMP), "
+		            "ERR(DECOMP), ERR(REF), ERR(BAD), ERR(INTERNAL)  =  "
+		            "%u  %u  %u  %u  %u  %u", worker->id, cid, worker->nb_ok,
+		            worker->err_comp, worker->err_decomp, worker->nb_ref,
+		            worker->nb_bad, worker->nb_internal_err);
+
+		/* let the writer save the faulty packet before dying */
+		stop_program = true;
+		sniffer_queue_wait_empty(&sniffer_writer.queue);
+
+		/* last debug traces are recorded in SIGABRT handler */
+		assert(0);
+	}
+}
+
+#ifdef SNIFFER_HAVE_RING
+
+/**
+ * @brief Get the index and the link layer of the network device to capture
+ *        packets from with AF_PACKET rings
+ *
+ * @param device_name           The name of the network device
+ * @param[out] ifindex          The index of the network device
+ * @param[out] link_layer_type  The link layer of the packets, as a DLT_*
+ *                              value of libpcap
+ * @return                      true if the device is supported, false otherwise
+ */
+static bool sniffer_ring_get_device(const char *const device_name,
+                                    int *const ifindex,
+                                    int *const link_layer_type)
+{
+	struct ifreq ifr;
+	int fd;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if(fd < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create socket: %s (%d)",
+		            strerror(errno), errno);
+		goto error;
+	}
+
+	memset(&ifr, 0, sizeof(struct ifreq));
+	strncpy(ifr.ifr_name, device_name, IFNAMSIZ - 1);
+	if(ioctl(fd, SIOCGIFINDEX, &ifr) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to get the index of network device "
+		            "'%s': %s (%d)", device_name, strerror(errno), errno);
+		goto close_socket;
+	}
+	*ifindex = ifr.ifr_ifindex;
+
+	if(ioctl(fd, SIOCGIFHWADDR, &ifr) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to get the type of network device "
+		            "'%s': %s (%d)", device_name, strerror(errno), errno);
+		goto close_socket;
+	}
+	if(ifr.ifr_hwaddr.sa_family == ARPHRD_ETHER ||
+	   ifr.ifr_hwaddr.sa_family == ARPHRD_LOOPBACK)
+	{
+		*link_layer_type = DLT_EN10MB;
+	}
+	else if(ifr.ifr_hwaddr.sa_family == ARPHRD_NONE ||
+	        ifr.ifr_hwaddr.sa_family == ARPHRD_PPP)
+	{
+		*link_layer_type = DLT_RAW;
+	}
+	else
+	{
+		SNIFFER_LOG(LOG_WARNING, "type %u of network device '%s' not supported "
+		            "by the capture rings", ifr.ifr_hwaddr.sa_family, device_name);
+		goto close_socket;
+	}
+
+	close(fd);
+	return true;
+
+close_socket:
+	close(fd);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Open the AF_PACKET capture ring of one worker
+ *
+ * @param worker      The worker
+ * @param ifindex     The index of the network device to capture packets from
+ * @param fanout_arg  The argument of the PACKET_FANOUT option to join the
+ *                    fanout group of all the workers, 0 for no fanout
+ * @return            true if the ring was opened, false otherwise
+ */
+static bool sniffer_ring_open(struct sniffer_worker *const worker,
+                              const int ifindex,
+                              const int fanout_arg)
+{
+	const int version = TPACKET_V3;
+	struct tpacket_req3 req;
+	struct sockaddr_ll addr;
+
+	worker->ring_block_id = 0;
+	worker->ring_packets = 0;
+	worker->ring_drops = 0;
+
+	/* the ROHC packets of one burst are kept until the burst is checked */
+	worker->burst_buf = malloc(SNIFFER_BURST_MAX * SNIFFER_OUTPUT_MAX_LEN);
+	if(worker->burst_buf == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for the bursts");
+		goto error;
+	}
+
+	worker->ring_fd = socket(AF_PACKET, SOCK_RAW, htons(SNIFFER_ETH_P_ALL));
+	if(worker->ring_fd < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create AF_PACKET socket: %s (%d)",
+		            strerror(errno), errno);
+		goto free_burst;
+	}
+	if(setsockopt(worker->ring_fd, SOL_PACKET, PACKET_VERSION, &version,
+	              sizeof(version)) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to select TPACKET_V3: %s (%d)",
+		            strerror(errno), errno);
+		goto close_socket;
+	}
+
+	/* the kernel fills one block after the other, one block is given to the
+	 * worker once full or once the capture timeout expires */
+	memset(&req, 0, sizeof(struct tpacket_req3));
+	req.tp_block_size = SNIFFER_RING_BLOCK_SIZE;
+	req.tp_block_nr = SNIFFER_RING_BLOCKS_NR;
+	req.tp_frame_size = SNIFFER_RING_FRAME_SIZE;
+	req.tp_frame_nr = (SNIFFER_RING_BLOCK_SIZE / SNIFFER_RING_FRAME_SIZE) *
+	                  SNIFFER_RING_BLOCKS_NR;
+	req.tp_retire_blk_tov = SNIFFER_CAPTURE_TIMEOUT_MS;
+	if(setsockopt(worker->ring_fd, SOL_PACKET, PACKET_RX_RING, &req,
+	              sizeof(struct tpacket_req3)) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create capture ring: %s (%d)",
+		            strerror(errno), errno);
+		goto close_socket;
+	}
+	worker->ring = mmap(NULL, SNIFFER_RING_BLOCK_SIZE * SNIFFER_RING_BLOCKS_NR,
+	                    PROT_READ | PROT_WRITE, MAP_SHARED, worker->ring_fd, 0);
+	if(worker->ring == MAP_FAILED)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to map capture ring: %s (%d)",
+		            strerror(errno), errno);
+		goto close_socket;
+	}
+
+	memset(&addr, 0, sizeof(struct sockaddr_ll));
+	addr.sll_family = AF_PACKET;
+	addr.sll_protocol = htons(SNIFFER_ETH_P_ALL);
+	addr.sll_ifindex = ifindex;
+	if(bind(worker->ring_fd, (struct sockaddr *) &addr,
+	        sizeof(struct sockaddr_ll)) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to bind AF_PACKET socket: %s (%d)",
+		            strerror(errno), errno);
+		goto unmap_ring;
+	}
+
+	/* the kernel keeps the packets of one flow in the same ring */
+	if(fanout_arg != 0 &&
+	   setsockopt(worker->ring_fd, SOL_PACKET, PACKET_FANOUT, &fanout_arg,
+	              sizeof(fanout_arg)) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to join fanout group: %s (%d)",
+		            strerror(errno), errno);
+		goto unmap_ring;
+	}
+
+	return true;
+
+unmap_ring:
+	munmap(worker->ring, SNIFFER_RING_BLOCK_SIZE * SNIFFER_RING_BLOCKS_NR);
+	worker->ring = NULL;
+close_socket:
+	close(worker->ring_fd);
+	worker->ring_fd = -1;
+free_burst:
+	free(worker->burst_buf);
+	worker->burst_buf = NULL;
+error:
+	return false;
+}
+
+
+/**
+ * @brief Close the AF_PACKET capture ring of one worker
+ *
+ * @param worker  The worker
+ */
+static void sniffer_ring_close(struct sniffer_worker *const worker)
+{
+	munmap(worker->ring, SNIFFER_RING_BLOCK_SIZE * SNIFFER_RING_BLOCKS_NR);
+	worker->ring = NULL;
+	close(worker->ring_fd);
+	worker->ring_fd = -1;
+	free(worker->burst_buf);
+	worker->burst_buf = NULL;
+}
+
+
+/**
+ * @brief Add the counters of the AF_PACKET capture ring of one worker to the
+ *        statistics of the worker
+ *
+ * The kernel resets its counters every time they are read, so this shall be
+ * done by the capture thread only.
+ *
+ * @param worker  The worker
+ */
+static void sniffer_ring_update_stats(struct sniffer_worker *const worker)
+{
+	struct tpacket_stats_v3 ring_stats;
+	socklen_t len = sizeof(struct tpacket_stats_v3);
+
+	if(worker->ring_fd >= 0 &&
+	   getsockopt(worker->ring_fd, SOL_PACKET, PACKET_STATISTICS, &ring_stats,
+	              &len) == 0)
+	{
+		worker->ring_packets += ring_stats.tp_packets;
+		worker->ring_drops += ring_stats.tp_drops;
+	}
+}
+
+
+/**
+ * @brief Capture, compress, decompress and compare the packets of one worker
+ *        with its AF_PACKET capture ring
+ *
+ * The worker stops once the program is stopped.
+ *
+ * @param arg  The worker
+ * @return     Always NULL
+ */
+static void * sniffer_worker_run_ring(void *const arg)
+{
+	struct sniffer_worker *const worker = arg;
+
+	while(!stop_program)
+	{
+		struct tpacket_block_desc *const block = (struct tpacket_block_desc *)
+			(worker->ring + worker->ring_block_id * SNIFFER_RING_BLOCK_SIZE);
+
+		/* wait for the kernel to give the next block */
+		if((block->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+		{
+			struct pollfd pfd = {
+				.fd = worker->ring_fd,
+				.events = POLLIN | POLLERR,
+				.revents = 0,
+			};
+			poll(&pfd, 1, SNIFFER_CAPTURE_TIMEOUT_MS);
+			continue;
+		}
+		__sync_synchronize();
+
+		sniffer_ring_process_block(worker, block);
+
+		/* give the block back to the kernel */
+		__sync_synchronize();
+		block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+		worker->ring_block_id = (worker->ring_block_id + 1) % SNIFFER_RING_BLOCKS_NR;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Compress, decompress and compare the packets of one block of the
+ *        AF_PACKET capture ring of one worker
+ *
+ * The packets are compressed in bursts straight from the block.
+ *
+ * @param worker  The worker
+ * @param block   The block given by the kernel
+ */
+static void sniffer_ring_process_block(struct sniffer_worker *const worker,
+                                       const struct tpacket_block_desc *const block)
+{
+	const uint32_t pkts_nr = block->hdr.bh1.num_pkts;
+	const uint8_t *pkt_hdr = ((const uint8_t *) block) +
+	                         block->hdr.bh1.offset_to_first_pkt;
+	struct pcap_pkthdr headers[SNIFFER_BURST_MAX];
+	unsigned char *packets[SNIFFER_BURST_MAX];
+	size_t burst_nr = 0;
+	uint32_t i;
+
+	pthread_mutex_lock(&sniffer_stats_lock);
+	sniffer_stats.total_packets += pkts_nr;
+	pthread_mutex_unlock(&sniffer_stats_lock);
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const struct tpacket3_hdr *const tp_hdr =
+			(const struct tpacket3_hdr *) pkt_hdr;
+
+		headers[burst_nr].ts.tv_sec = tp_hdr->tp_sec;
+		headers[burst_nr].ts.tv_usec = tp_hdr->tp_nsec / 1000;
+		headers[burst_nr].caplen = tp_hdr->tp_snaplen;
+		headers[burst_nr].len = tp_hdr->tp_len;
+		packets[burst_nr] = (unsigned char *) (pkt_hdr + tp_hdr->tp_mac);
+		burst_nr++;
+
+		if(burst_nr == SNIFFER_BURST_MAX || (i + 1) == pkts_nr)
+		{
+			compress_decompress_burst(worker, headers, packets, burst_nr);
+			burst_nr = 0;
+		}
+
+		pkt_hdr += tp_hdr->tp_next_offset;
+	}
+}
+
+#endif /* SNIFFER_HAVE_RING */
+
+
+/**
+ * @brief Save the packets of all the workers in the dump files
+ *
+ * The writer stops once its queue is closed and empty.
+ *
+ * @param arg  The writer
+ * @return     Always NULL
+ */
+static void * sniffer_writer_run(void *const arg)
+{
+	struct sniffer_writer *const writer = arg;
+	struct sniffer_pkt *pkt;
+
+	while((pkt = sniffer_queue_peek(&writer->queue)) != NULL)
+	{
+		if(pkt->is_comp_failure)
+		{
+			pcap_dumper_t *dumper;
+
+			/* the packets of the segment shall be on disk along with the faulty
+			 * packet to reproduce the problem */
+			if(!sniffer_out_file_flush(&writer->seg) ||
+			   !sniffer_out_file_flush(&writer->idx))
+			{
+				SNIFFER_LOG(LOG_WARNING, "failed to flush segment #%u of the dump "
+				            "files", writer->seg_id);
+			}
+
+			/* open the new dumper */
+			dumper = pcap_dump_open(writer->handle, "./dump_stream_default.pcap");
+			if(dumper == NULL)
+			{
+				SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s'",
+				            "./dump_stream_default.pcap");
+				assert(0);
+			}
+			else
+			{
+				/* dump the IP packet */
+				SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'",
+				            "./dump_stream_default.pcap");
+				pcap_dump((u_char *) dumper, &pkt->header, pkt->data);
+
+				SNIFFER_LOG(LOG_INFO, "close dump file");
+				pcap_dump_close(dumper);
+			}
+		}
+		else if(!sniffer_writer_append(writer, pkt))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to write packet in segment #%u of "
+			            "the dump files", writer->seg_id);
+			assert(0);
+		}
+
+		sniffer_queue_release(&writer->queue, pkt);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Append one packet to the current segment of the dump files
+ *
+ * A new segment is started if the packet does not fit in the current one.
+ *
+ * @param writer  The writer
+ * @param pkt     The packet to append
+ * @return        true if the packet was appended, false otherwise
+ */
+static bool sniffer_writer_append(struct sniffer_writer *const writer,
+                                  const struct sniffer_pkt *const pkt)
+{
+	const size_t rec_len = sizeof(struct sniffer_pcap_rec_hdr) + pkt->header.caplen;
+	struct sniffer_pcap_rec_hdr rec_hdr;
+	struct sniffer_index_rec index_rec;
+
+	/* start a new segment if the current one is full */
+	if((writer->seg_len + rec_len) > SNIFFER_SEGMENT_MAX_LEN)
+	{
+		if(!sniffer_writer_close_segment(writer))
+		{
+			goto error;
+		}
+		writer->seg_id++;
+		if(!sniffer_writer_open_segment(writer))
+		{
+			goto error;
+		}
+	}
+
+	/* write the buffers to disk when they are full */
+	if((writer->seg.buf_len + rec_len) > SNIFFER_WRITE_BUF_LEN &&
+	   !sniffer_out_file_flush(&writer->seg))
+	{
+		goto error;
+	}
+	if((writer->idx.buf_len + sizeof(struct sniffer_index_rec)) >
+	   SNIFFER_WRITE_BUF_LEN && !sniffer_out_file_flush(&writer->idx))
+	{
+		goto error;
+	}
+
+	/* the packet */
+	rec_hdr.ts_sec = pkt->header.ts.tv_sec;
+	rec_hdr.ts_usec = pkt->header.ts.tv_usec;
+	rec_hdr.incl_len = pkt->header.caplen;
+	rec_hdr.orig_len = pkt->header.len;
+	memcpy(writer->seg.buf + writer->seg.buf_len, &rec_hdr,
+	       sizeof(struct sniffer_pcap_rec_hdr));
+	memcpy(writer->seg.buf + writer->seg.buf_len +
+	       sizeof(struct sniffer_pcap_rec_hdr), pkt->data, pkt->header.caplen);
+	writer->seg.buf_len += rec_len;
+
+	/* the index of the packet */
+	memset(&index_rec, 0, sizeof(struct sniffer_index_rec));
+	index_rec.offset = writer->seg_len;
+	index_rec.worker_id = pkt->worker_id;
+	index_rec.cid = pkt->cid;
+	index_rec.is_new_stream = !!pkt->is_new_stream;
+	memcpy(writer->idx.buf + writer->idx.buf_len, &index_rec,
+	       sizeof(struct sniffer_index_rec));
+	writer->idx.buf_len += sizeof(struct sniffer_index_rec);
+
+	writer->seg_len += rec_len;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Start the current segment of the dump files
+ *
+ * The oldest segment is removed if too many segments are kept on disk.
+ *
+ * @param writer  The writer
+ * @return        true if the segment was started, false otherwise
+ */
+static bool sniffer_writer_open_segment(struct sniffer_writer *const writer)
+{
+	struct sniffer_pcap_file_hdr file_hdr;
+	char filename[1024];
+
+	/* remove the oldest segment if needed */
+	if((writer->seg_id - writer->seg_first_id) >= SNIFFER_SEGMENTS_MAX)
+	{
+		sniffer_segment_filename(filename, 1024, writer->seg_first_id, "pcap");
+		unlink(filename);
+		sniffer_segment_filename(filename, 1024, writer->seg_first_id, "idx");
+		unlink(filename);
+		/* TODO: check result */
+		writer->seg_first_id++;
+	}
+
+	sniffer_segment_filename(filename, 1024, writer->seg_id, "pcap");
+	writer->seg.fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(writer->seg.fd < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to open dump file '%s': %s (%d)",
+		            filename, strerror(errno), errno);
+		goto error;
+	}
+	sniffer_segment_filename(filename, 1024, writer->seg_id, "idx");
+	writer->idx.fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(writer->idx.fd < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to open dump file '%s': %s (%d)",
+		            filename, strerror(errno), errno);
+		goto close_seg;
+	}
+
+	/* every segment is one complete PCAP file */
+	file_hdr.magic = 0xa1b2c3d4U;
+	file_hdr.version_major = 2;
+	file_hdr.version_minor = 4;
+	file_hdr.thiszone = 0;
+	file_hdr.sigfigs = 0;
+	file_hdr.snaplen = DEV_MTU;
+	file_hdr.linktype = writer->linktype;
+	memcpy(writer->seg.buf, &file_hdr, sizeof(struct sniffer_pcap_file_hdr));
+	writer->seg.buf_len = sizeof(struct sniffer_pcap_file_hdr);
+	writer->seg_len = sizeof(struct sniffer_pcap_file_hdr);
+	writer->idx.buf_len = 0;
+
+	if(is_verbose)
+	{
+		SNIFFER_LOG(LOG_INFO, "start segment #%u of the dump files",
+		            writer->seg_id);
+	}
+
+	return true;
+
+close_seg:
+	close(writer->seg.fd);
+	writer->seg.fd = -1;
+error:
+	return false;
+}
+
+
+/**
+ * @brief Write the buffered data of the current segment, then close it
+ *
+ * @param writer  The writer
+ * @return        true if the segment was written, false otherwise
+ */
+static bool sniffer_writer_close_segment(struct sniffer_writer *const writer)
+{
+	bool is_success = true;
+
+	if(!sniffer_out_file_flush(&writer->seg) ||
+	   !sniffer_out_file_flush(&writer->idx))
+	{
+		is_success = false;
+	}
+	if(writer->seg.fd >= 0)
+	{
+		close(writer->seg.fd);
+		writer->seg.fd = -1;
+	}
+	if(writer->idx.fd >= 0)
+	{
+		close(writer->idx.fd);
+		writer->idx.fd = -1;
+	}
+
+	return is_success;
+}
+
+
+/**
+ * @brief Build the name of one file of one segment of the dump files
+ *
+ * @param filename          OUT: the name of the file
+ * @param filename_max_len  The maximum length of the name
+ * @param seg_id            The number of the segment
+ * @param ext               The extension of the file: "pcap" for the packets
+ *                          or "idx" for their index
+ */
+static void sniffer_segment_filename(char *const filename,
+                                     const size_t filename_max_len,
+                                     const unsigned int seg_id,
+                                     const char *const ext)
+{
+	snprintf(filename, filename_max_len, "./dump_segment_%06u.%s", seg_id, ext);
+	/* TODO: check result */
+}
+
+
+/**
+ * @brief Write the buffered data of one output file of the writer
+ *
+ * Only async-signal-safe functions are used, so that the data may be written
+ * from the handler of SIGSEGV/SIGABRT.
+ *
+ * @param file  The output file
+ * @return      true if the data was written, false otherwise
+ */
+static bool sniffer_out_file_flush(struct sniffer_out_file *const file)
+{
+	size_t written_len = 0;
+
+	if(file->fd < 0)
+	{
+		goto error;
+	}
+
+	while(written_len < file->buf_len)
+	{
+		const ssize_t ret = write(file->fd, file->buf + written_len,
+		                          file->buf_len - written_len);
+		if(ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if(ret <= 0)
+		{
+			goto error;
+		}
+		written_len += ret;
+	}
+	file->buf_len = 0;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Send one packet of one worker to the writer
+ *
+ * The packets that start a new stream and the packets that failed to be
+ * compressed are never dropped, the worker waits for the writer instead:
+ * the dump files would be unusable without them. The other packets are
+ * dropped if the writer cannot keep up.
+ *
+ * @param worker           The worker that compressed the packet
+ * @param header           The PCAP header of the packet
+ * @param packet           The packet (link layer included)
+ * @param cid              The CID the packet was compressed with
+ * @param is_new_stream    Whether the packet starts a new stream for the CID
+ * @param is_comp_failure  Whether the packet failed to be compressed
+ */
+static void sniffer_dump_pkt(const struct sniffer_worker *const worker,
+                             const struct pcap_pkthdr *const header,
+                             const unsigned char *const packet,
+                             const unsigned int cid,
+                             const bool is_new_stream,
+                             const bool is_comp_failure)
+{
+	const bool do_wait = (is_new_stream || is_comp_failure);
+	struct sniffer_pkt *pkt;
+
+	pkt = sniffer_queue_reserve(&sniffer_writer.queue, header->caplen, do_wait);
+	if(pkt == NULL)
+	{
+		/* queue is full, drop is counted by the queue */
+		return;
+	}
+	memcpy(&pkt->header, header, sizeof(struct pcap_pkthdr));
+	pkt->worker_id = worker->id;
+	pkt->cid = cid;
+	pkt->is_new_stream = is_new_stream;
+	pkt->is_comp_failure = is_comp_failure;
+	memcpy(pkt->data, packet, header->caplen);
+	sniffer_queue_commit(&sniffer_writer.queue, pkt);
+}
+
 
-	SNIFFER_LOG(LOG_INFO, "ROHC sniffer successfully started");
-	SNIFFER_LOG(LOG_INFO, "start processing captured packets");
+/**
+ * @brief Create one queue of the pipeline
+ *
+ * @param queue  The queue to create
+ * @param size   The size (in bytes) of the queue
+ * @return       true if the queue was created, false otherwise
+ */
+static bool sniffer_queue_init(struct sniffer_queue *const queue,
+                               const size_t size)
+{
+	memset(queue, 0, sizeof(struct sniffer_queue));
 
-	/* for each sniffed packet */
-	sniffer_stats.total_packets = 0;
-	while(!stop_program)
+	queue->size = SNIFFER_ALIGN(size);
+	queue->buf = malloc(queue->size);
+	if(queue->buf == NULL)
 	{
-		unsigned int cid = 0;
-		int ret;
+		goto error;
+	}
+	if(pthread_mutex_init(&queue->lock, NULL) != 0)
+	{
+		goto free_buf;
+	}
+	if(pthread_cond_init(&queue->not_empty, NULL) != 0)
+	{
+		goto destroy_lock;
+	}
+	if(pthread_cond_init(&queue->not_full, NULL) != 0)
+	{
+		goto destroy_not_empty;
+	}
 
-		/* try to capture a packet */
-		packet = (unsigned char *) pcap_next(handle, &header);
-		if(packet == NULL)
-		{
-			/* no packet captured, re-try */
-			continue;
-		}
+	return true;
 
-		sniffer_stats.total_packets++;
+destroy_not_empty:
+	pthread_cond_destroy(&queue->not_empty);
+destroy_lock:
+	pthread_mutex_destroy(&queue->lock);
+free_buf:
+	free(queue->buf);
+error:
+	return false;
+}
 
-		if(!is_daemon &&
-		   (sniffer_stats.total_packets == 1 || (sniffer_stats.total_packets % 100) == 0))
-		{
-			if(sniffer_stats.total_packets > 1)
-			{
-				printf("\r");
-			}
-			printf("packet #%lu", sniffer_stats.total_packets);
-			fflush(stdout);
 
-			if(do_print_stat && (sniffer_stats.total_packets % 1000) == 0)
-			{
-				printf("\n\n");
-				fprintf(stderr, "================================================\n");
-				sniffer_print_stats(SIGUSR1);
-				fprintf(stderr, "================================================\n");
-				fprintf(stderr, "\n");
-				fflush(stderr);
-			}
-		}
+/**
+ * @brief Destroy one queue of the pipeline
+ *
+ * @param queue  The queue to destroy
+ */
+static void sniffer_queue_free(struct sniffer_queue *const queue)
+{
+	pthread_cond_destroy(&queue->not_full);
+	pthread_cond_destroy(&queue->not_empty);
+	pthread_mutex_destroy(&queue->lock);
+	free(queue->buf);
+}
 
-		/* compress & decompress from compressor to decompressor */
-		ret = compress_decompress(comp, decomp, header, packet,
-		                          link_len_src, handle, sniffer_dumpers,
-		                          &feedback_send, &cid, &sniffer_stats);
-		if(ret == -1)
-		{
-			err_comp++;
-		}
-		else if(ret == -2)
-		{
-			err_decomp++;
-		}
-		else if(ret == 0)
-		{
-			nb_ref++;
-		}
-		else if(ret == 1)
-		{
-			nb_ok++;
-		}
-		else if(ret == -3)
+
+/**
+ * @brief Reserve room for one packet at the end of one queue
+ *
+ * On success, the lock of the queue is held until \ref sniffer_queue_commit
+ * is called.
+ *
+ * @param queue     The queue
+ * @param data_len  The length of the packet
+ * @param do_wait   Whether to wait for room if the queue is full, or to drop
+ *                  the packet
+ * @return          The entry to fill, NULL if the packet was dropped
+ */
+static struct sniffer_pkt * sniffer_queue_reserve(struct sniffer_queue *const queue,
+                                                  const size_t data_len,
+                                                  const bool do_wait)
+{
+	const size_t entry_len = SNIFFER_ALIGN(sizeof(struct sniffer_pkt) + data_len);
+	struct sniffer_pkt *pkt;
+
+	pthread_mutex_lock(&queue->lock);
+
+	if(entry_len > queue->size)
+	{
+		goto drop;
+	}
+
+	/* the entry shall not wrap around the end of the queue: count the room
+	 * lost at the end of the queue if it is too small for the entry */
+	while(true)
+	{
+		const size_t room_to_end = queue->size - queue->tail;
+		const size_t needed_len =
+			(entry_len <= room_to_end ? entry_len : room_to_end + entry_len);
+
+		if(needed_len <= (queue->size - queue->used))
 		{
-			nb_bad++;
-			sniffer_stats.bad_packets++;
+			break;
 		}
-		else
+		else if(!do_wait || queue->closed)
 		{
-			nb_internal_err++;
+			goto drop;
 		}
+		pthread_cond_wait(&queue->not_full, &queue->lock);
+	}
 
-		/* in case of problem (ignore bad packets), just die! */
-		if(ret != 1 && ret != -3)
-		{
-			SNIFFER_LOG(LOG_WARNING, "packet #%lu, CID %u: stats OK, ERR(COMP), "
-			            "ERR(DECOMP), ERR(REF), ERR(BAD), ERR(INTERNAL)  =  "
-			            "%u  %u  %u  %u  %u  %u", sniffer_stats.total_packets,
-			            cid, nb_ok, err_comp, err_decomp, nb_ref, nb_bad,
-			            nb_internal_err);
-
-			/* last debug traces are recorded in SIGABRT handler */
-			assert(0);
-		}
+	/* pad the end of the queue if the entry does not fit before it */
+	if(entry_len > (queue->size - queue->tail))
+	{
+		struct sniffer_pkt *const pad =
+			(struct sniffer_pkt *) (queue->buf + queue->tail);
+		pad->len = queue->size - queue->tail;
+		pad->is_pad = 1;
+		queue->used += pad->len;
+		queue->tail = 0;
 	}
 
-	if(stop_program)
+	pkt = (struct sniffer_pkt *) (queue->buf + queue->tail);
+	pkt->len = entry_len;
+	pkt->is_pad = 0;
+
+	return pkt;
+
+drop:
+	queue->drops++;
+	pthread_mutex_unlock(&queue->lock);
+	return NULL;
+}
+
+
+/**
+ * @brief Add one packet reserved with \ref sniffer_queue_reserve to one queue
+ *
+ * The lock of the queue is released.
+ *
+ * @param queue  The queue
+ * @param pkt    The entry returned by \ref sniffer_queue_reserve
+ */
+static void sniffer_queue_commit(struct sniffer_queue *const queue,
+                                 const struct sniffer_pkt *const pkt)
+{
+	queue->tail += pkt->len;
+	if(queue->tail == queue->size)
 	{
-		SNIFFER_LOG(LOG_INFO, "program stopped by signal");
+		queue->tail = 0;
+	}
+	queue->used += pkt->len;
+	queue->depth++;
+	if(queue->depth > queue->max_depth)
+	{
+		queue->max_depth = queue->depth;
 	}
+	pthread_cond_signal(&queue->not_empty);
+	pthread_mutex_unlock(&queue->lock);
+}
 
-	status = true;
 
-	/* close PCAP dumpers */
-	for(i = 0; i < max_contexts; i++)
+/**
+ * @brief Get the oldest packet of one queue, wait for one if the queue is empty
+ *
+ * The packet stays in the queue until \ref sniffer_queue_release is called.
+ *
+ * @param queue  The queue
+ * @return       The oldest packet, NULL if the queue is closed and empty
+ */
+static struct sniffer_pkt * sniffer_queue_peek(struct sniffer_queue *const queue)
+{
+	struct sniffer_pkt *pkt;
+
+	pthread_mutex_lock(&queue->lock);
+	while(queue->depth == 0 && !queue->closed)
+	{
+		pthread_cond_wait(&queue->not_empty, &queue->lock);
+	}
+	if(queue->depth == 0)
+	{
+		pkt = NULL;
+	}
+	else
 	{
-		if(sniffer_dumpers[i] != NULL)
+		pkt = (struct sniffer_pkt *) (queue->buf + queue->head);
+		if(pkt->is_pad)
 		{
-			SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %u", i);
-			pcap_dump_close(sniffer_dumpers[i]);
+			/* skip the padding at the end of the queue */
+			queue->used -= pkt->len;
+			queue->head = 0;
+			pkt = (struct sniffer_pkt *) queue->buf;
 		}
 	}
+	pthread_mutex_unlock(&queue->lock);
 
-destroy_decomp:
-	rohc_decomp_free(decomp);
-destroy_comp:
-	rohc_comp_free(comp);
-close_input:
-	pcap_close(handle);
-error:
-	return status;
+	return pkt;
+}
+
+
+/**
+ * @brief Remove the oldest packet of one queue
+ *
+ * @param queue  The queue
+ * @param pkt    The packet returned by \ref sniffer_queue_peek
+ */
+static void sniffer_queue_release(struct sniffer_queue *const queue,
+                                  const struct sniffer_pkt *const pkt)
+{
+	pthread_mutex_lock(&queue->lock);
+	queue->head += pkt->len;
+	if(queue->head == queue->size)
+	{
+		queue->head = 0;
+	}
+	queue->used -= pkt->len;
+	queue->depth--;
+	if(queue->used == 0)
+	{
+		/* restart from the beginning to avoid padding */
+		queue->head = 0;
+		queue->tail = 0;
+	}
+	pthread_cond_broadcast(&queue->not_full);
+	pthread_mutex_unlock(&queue->lock);
+}
+
+
+/**
+ * @brief Close one queue: no more packet is added, the consumer stops once
+ *        the queue is empty
+ *
+ * @param queue  The queue
+ */
+static void sniffer_queue_close(struct sniffer_queue *const queue)
+{
+	pthread_mutex_lock(&queue->lock);
+	queue->closed = true;
+	pthread_cond_broadcast(&queue->not_empty);
+	pthread_cond_broadcast(&queue->not_full);
+	pthread_mutex_unlock(&queue->lock);
+}
+
+
+/**
+ * @brief Wait for the consumer of one queue to process all its packets
+ *
+ * @param queue  The queue
+ */
+static void sniffer_queue_wait_empty(struct sniffer_queue *const queue)
+{
+	pthread_mutex_lock(&queue->lock);
+	while(queue->depth > 0)
+	{
+		pthread_cond_wait(&queue->not_full, &queue->lock);
+	}
+	pthread_mutex_unlock(&queue->lock);
 }
 
 
 /**
- * @brief Compress and decompress one uncompressed IP packet with the given
- *        compressor and decompressor
+ * @brief Compress and decompress one uncompressed IP packet with the
+ *        compressor and decompressor of the given worker
  *
- * @param comp           The compressor to use to compress the IP packet
- * @param decomp         The decompressor to use to decompress the IP packet
+ * @param worker         The worker that compresses/decompresses the IP packet
  * @param header         The PCAP header for the packet
  * @param packet         The packet to compress/decompress (link layer included)
- * @param link_len_src   The length of the link layer header before IP data
- * @param handle         The PCAP handler that sniffed the packet
- * @param dumpers        The PCAP dumpers, one per context
  * @param cid            OUT: the CID used for the last packet
- * @param stats          IN/OUT: The sniffer stats
  * @return               1 if the process is successful
  *                       0 if the decompressed packet doesn't match the
  *                         original one
@@ -1277,17 +3320,12 @@ error:
  *                       -3 if the link layer is not Ethernet
  *                       -4 if (de)compression info cannot be retrieved
  */
-static int compress_decompress(struct rohc_comp *comp,
-                               struct rohc_decomp *decomp,
+static int compress_decompress(struct sniffer_worker *const worker,
                                struct pcap_pkthdr header,
                                unsigned char *packet,
-                               size_t link_len_src,
-                               pcap_t *handle,
-                               pcap_dumper_t *dumpers[],
-                               struct rohc_buf *const feedback_send,
-                               unsigned int *const cid,
-                               struct sniffer_stats_t *stats)
+                               unsigned int *const cid)
 {
+	struct rohc_buf *const feedback_send = &worker->feedback_send;
 	const struct rohc_ts arrival_time = {
 		.sec = header.ts.tv_sec,
 		.nsec = header.ts.tv_usec * 1000
@@ -1295,35 +3333,167 @@ static int compress_decompress(struct rohc_comp *comp,
 	struct rohc_buf uncomp_packet =
 		rohc_buf_init_full(packet, header.caplen, arrival_time);
 
-#define output_packet_max_len \
-		(max(ETHER_HDR_LEN, LINUX_COOKED_HDR_LEN) + MAX_ROHC_SIZE)
-	uint8_t output_packet[output_packet_max_len];
+	uint8_t output_packet[SNIFFER_OUTPUT_MAX_LEN];
 	struct rohc_buf rohc_packet =
-		rohc_buf_init_empty(output_packet, output_packet_max_len);
+		rohc_buf_init_empty(output_packet, SNIFFER_OUTPUT_MAX_LEN);
 
-	uint8_t decomp_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf decomp_packet =
-		rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+	struct rohc_comp_pkt_info comp_pkt_info;
+	rohc_status_t status;
+	int ret;
 
-	uint8_t rcvd_feedback_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf rcvd_feedback =
-		rohc_buf_init_empty(rcvd_feedback_buffer, MAX_ROHC_SIZE);
+	ret = sniffer_prepare_pkt(worker->link_len_src, &header, &uncomp_packet);
+	if(ret != 1)
+	{
+		/* ignored packets are successfully processed */
+		return (ret == 0 ? 1 : ret);
+	}
 
-	rohc_comp_last_packet_info2_t comp_last_packet_info;
-	rohc_decomp_last_packet_info_t decomp_last_packet_info;
-	unsigned long possible_unit;
+	/* keep room for the link layer header */
+	rohc_packet.len += worker->link_len_src;
+	rohc_buf_pull(&rohc_packet, worker->link_len_src);
 
-	uint16_t protocol;
+	/* piggyback the feedback */
+	rohc_buf_append_buf(&rohc_packet, *feedback_send);
+	rohc_buf_pull(&rohc_packet, feedback_send->len);
 
-	rohc_status_t status;
-	int ret;
+	/* compress the IP packet */
+	status = rohc_compress5(worker->comp, uncomp_packet, &rohc_packet,
+	                        &comp_pkt_info);
+
+	return sniffer_check_pkt(worker, &header, packet, uncomp_packet,
+	                         rohc_packet, status, &comp_pkt_info, cid);
+}
+
+#ifdef SNIFFER_HAVE_RING
+
+/**
+ * @brief Compress, decompress and compare one burst of packets
+ *
+ * The packets are compressed in place from the capture ring with one single
+ * call to the library. The feedbacks are not piggybacked in bursts, they are
+ * delivered to the compressor once every packet is checked.
+ *
+ * @param worker   The worker that compresses/decompresses the IP packets
+ * @param headers  The PCAP headers for the packets
+ * @param packets  The packets to compress/decompress (link layer included)
+ * @param pkts_nr  The number of packets in the burst
+ */
+static void compress_decompress_burst(struct sniffer_worker *const worker,
+                                      const struct pcap_pkthdr headers[],
+                                      unsigned char *const packets[],
+                                      const size_t pkts_nr)
+{
+	struct rohc_buf *const feedback_send = &worker->feedback_send;
+	struct rohc_buf uncomp_pkts[SNIFFER_BURST_MAX];
+	struct rohc_buf rohc_pkts[SNIFFER_BURST_MAX];
+	rohc_status_t statuses[SNIFFER_BURST_MAX];
+	struct rohc_comp_pkt_info infos[SNIFFER_BURST_MAX];
+	size_t pkt_ids[SNIFFER_BURST_MAX];
+	size_t burst_nr = 0;
+	size_t done_nr;
+	size_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const struct rohc_ts arrival_time = {
+			.sec = headers[i].ts.tv_sec,
+			.nsec = headers[i].ts.tv_usec * 1000
+		};
+		int ret;
+
+		uncomp_pkts[burst_nr] = (struct rohc_buf)
+			rohc_buf_init_full(packets[i], headers[i].caplen, arrival_time);
+		ret = sniffer_prepare_pkt(worker->link_len_src, &headers[i],
+		                          &uncomp_pkts[burst_nr]);
+		if(ret != 1)
+		{
+			/* ignored packets are successfully processed */
+			sniffer_worker_account(worker, (ret == 0 ? 1 : ret), 0);
+			continue;
+		}
+
+		/* keep room for the link layer header */
+		rohc_pkts[burst_nr] = (struct rohc_buf)
+			rohc_buf_init_empty(worker->burst_buf + burst_nr * SNIFFER_OUTPUT_MAX_LEN,
+			                    SNIFFER_OUTPUT_MAX_LEN);
+		rohc_pkts[burst_nr].len += worker->link_len_src;
+		rohc_buf_pull(&rohc_pkts[burst_nr], worker->link_len_src);
+
+		pkt_ids[burst_nr] = i;
+		burst_nr++;
+	}
+
+	/* compress the whole burst, the library stops after segmented packets */
+	done_nr = 0;
+	while(done_nr < burst_nr)
+	{
+		const size_t nr =
+			rohc_compress_burst2(worker->comp, uncomp_pkts + done_nr,
+			                     rohc_pkts + done_nr, statuses + done_nr,
+			                     infos + done_nr, burst_nr - done_nr);
+		if(nr == 0)
+		{
+			for(i = done_nr; i < burst_nr; i++)
+			{
+				statuses[i] = ROHC_STATUS_ERROR;
+			}
+			break;
+		}
+		done_nr += nr;
+	}
+
+	for(i = 0; i < burst_nr; i++)
+	{
+		unsigned int cid = 0;
+		int ret;
+
+		ret = sniffer_check_pkt(worker, &headers[pkt_ids[i]], packets[pkt_ids[i]],
+		                        uncomp_pkts[i], rohc_pkts[i], statuses[i],
+		                        &infos[i], &cid);
+
+		/* deliver the feedback of the decompressor to the compressor */
+		if(ret == 1 && feedback_send->len > 0)
+		{
+			if(!rohc_comp_deliver_feedback2(worker->comp, *feedback_send))
+			{
+				SNIFFER_LOG(LOG_WARNING, "failed to deliver feedback");
+				ret = -4;
+			}
+			feedback_send->data -= feedback_send->offset;
+			feedback_send->len = 0;
+		}
+
+		sniffer_worker_account(worker, ret, cid);
+	}
+}
+
+#endif /* SNIFFER_HAVE_RING */
+
+
+/**
+ * @brief Prepare one captured packet for compression
+ *
+ * The link layer header and the Ethernet padding are skipped, the faulty
+ * IPv4 checksums are fixed in place.
+ *
+ * @param link_len_src        The length of the link layer header before IP data
+ * @param header              The PCAP header for the packet
+ * @param[in,out] uncomp_packet  The whole packet in, the IP packet out
+ * @return                    1 if the packet shall be compressed
+ *                            0 if the packet shall be ignored
+ *                            -3 if the packet is malformed
+ */
+static int sniffer_prepare_pkt(const size_t link_len_src,
+                               const struct pcap_pkthdr *const header,
+                               struct rohc_buf *const uncomp_packet)
+{
+	uint16_t protocol;
 
 	/* check Ethernet frame length */
-	if(header.len <= link_len_src || header.len != header.caplen)
+	if(header->len <= link_len_src || header->len != header->caplen)
 	{
 		SNIFFER_LOG(LOG_WARNING, "bad PCAP packet (full len = %u, capture "
-		            "len = %u)", header.len, header.caplen);
-		ret = -3;
+		            "len = %u)", header->len, header->caplen);
 		goto error;
 	}
 
@@ -1331,7 +3501,7 @@ static int compress_decompress(struct rohc_comp *comp,
 	if(link_len_src == ETHER_HDR_LEN)
 	{
 		const struct ether_header *const ethhdr =
-			(struct ether_header *) rohc_buf_data(uncomp_packet);
+			(struct ether_header *) rohc_buf_data(*uncomp_packet);
 		protocol = ntohs(ethhdr->ether_type);
 	}
 	else
@@ -1342,41 +3512,39 @@ static int compress_decompress(struct rohc_comp *comp,
 	/* drop ARP packets */
 	if(protocol == 0x0806)
 	{
-		return 1;
+		goto ignore;
 	}
 
 	/* skip the link layer header */
-	rohc_buf_pull(&uncomp_packet, link_len_src);
-	rohc_packet.len += link_len_src;
-	rohc_buf_pull(&rohc_packet, link_len_src);
+	rohc_buf_pull(uncomp_packet, link_len_src);
 
 	/* check for padding after the IP packet in the Ethernet payload */
-	if(link_len_src == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+	if(link_len_src == ETHER_HDR_LEN && header->len == ETHER_FRAME_MIN_LEN)
 	{
 		uint16_t tot_len;
 
 		if(protocol == ETHERTYPE_IPV4)
 		{
-			memcpy(&tot_len, rohc_buf_data_at(uncomp_packet, 2), sizeof(uint16_t));
+			memcpy(&tot_len, rohc_buf_data_at(*uncomp_packet, 2), sizeof(uint16_t));
 			tot_len = ntohs(tot_len);
 		}
 		else if(protocol == ETHERTYPE_IPV6)
 		{
 			const size_t ipv6_header_len = 40;
-			memcpy(&tot_len, rohc_buf_data_at(uncomp_packet, 4), sizeof(uint16_t));
+			memcpy(&tot_len, rohc_buf_data_at(*uncomp_packet, 4), sizeof(uint16_t));
 			tot_len = ipv6_header_len + ntohs(tot_len);
 		}
 		else
 		{
-			tot_len = uncomp_packet.len;
+			tot_len = uncomp_packet->len;
 		}
 
-		if(tot_len < uncomp_packet.len)
+		if(tot_len < uncomp_packet->len)
 		{
 			SNIFFER_LOG(LOG_INFO, "the Ethernet frame has %zu bytes of "
 			            "padding after the %u byte IP packet!",
-			            uncomp_packet.len - tot_len, tot_len);
-			uncomp_packet.len = tot_len;
+			            uncomp_packet->len - tot_len, tot_len);
+			uncomp_packet->len = tot_len;
 		}
 	}
 
@@ -1384,63 +3552,85 @@ static int compress_decompress(struct rohc_comp *comp,
 	 * of 0x0000 (Windows Vista seems to be faulty for the latter), to avoid
 	 * false comparison failures after decompression */
 	if(protocol == ETHERTYPE_IPV4 &&
-	   ((rohc_buf_byte_at(uncomp_packet, 0) >> 4) & 0x0f) == 4 &&
-	   uncomp_packet.len >= 20 &&
-	   rohc_buf_byte_at(uncomp_packet, 10) == 0xff &&
-	   rohc_buf_byte_at(uncomp_packet, 11) == 0xff)
+	   ((rohc_buf_byte_at(*uncomp_packet, 0) >> 4) & 0x0f) == 4 &&
+	   uncomp_packet->len >= 20 &&
+	   rohc_buf_byte_at(*uncomp_packet, 10) == 0xff &&
+	   rohc_buf_byte_at(*uncomp_packet, 11) == 0xff)
 	{
-		rohc_buf_byte_at(uncomp_packet, 10) = 0x00;
-		rohc_buf_byte_at(uncomp_packet, 11) = 0x00;
+		rohc_buf_byte_at(*uncomp_packet, 10) = 0x00;
+		rohc_buf_byte_at(*uncomp_packet, 11) = 0x00;
 	}
 
-	/* piggyback the feedback */
-	rohc_buf_append_buf(&rohc_packet, *feedback_send);
-	rohc_buf_pull(&rohc_packet, feedback_send->len);
+	return 1;
 
-	/* compress the IP packet */
-	status = rohc_compress4(comp, uncomp_packet, &rohc_packet);
-	if(status != ROHC_STATUS_OK)
-	{
-		pcap_dumper_t *dumper;
+ignore:
+	return 0;
 
-		SNIFFER_LOG(LOG_WARNING, "compression failed");
-		ret = -1;
-		rohc_buf_push(&uncomp_packet, link_len_src);
+error:
+	return -3;
+}
 
-		/* open the new dumper */
-		dumper = pcap_dump_open(handle, "./dump_stream_default.pcap");
-		if(dumper == NULL)
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s'",
-			            "./dump_stream_default.pcap");
-			assert(0);
-			goto error;
-		}
 
-		/* dump the IP packet */
-		SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'",
-		            "./dump_stream_default.pcap");
-		pcap_dump((u_char *) dumper, &header, packet);
+/**
+ * @brief Check one compressed packet: decompress it and compare the result
+ *        with the original packet
+ *
+ * Update the statistics and send the packet to the writer on the way.
+ *
+ * @param worker         The worker that compressed the IP packet
+ * @param header         The PCAP header for the packet
+ * @param packet         The packet (link layer included)
+ * @param uncomp_packet  The IP packet that was compressed
+ * @param rohc_packet    The ROHC packet
+ * @param status         The status of the compression of the packet
+ * @param comp_pkt_info  The information about the compressed packet
+ * @param cid            OUT: the CID used for the packet
+ * @return               The same values as \ref compress_decompress
+ */
+static int sniffer_check_pkt(struct sniffer_worker *const worker,
+                             const struct pcap_pkthdr *const header,
+                             const unsigned char *const packet,
+                             const struct rohc_buf uncomp_packet,
+                             const struct rohc_buf rohc_packet,
+                             const rohc_status_t status,
+                             const struct rohc_comp_pkt_info *const comp_pkt_info,
+                             unsigned int *const cid)
+{
+	struct rohc_comp *const comp = worker->comp;
+	struct rohc_decomp *const decomp = worker->decomp;
+	struct rohc_buf *const feedback_send = &worker->feedback_send;
+	struct sniffer_stats_t *const stats = &sniffer_stats;
 
-		SNIFFER_LOG(LOG_INFO, "close dump file");
-		pcap_dump_close(dumper);
+	uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf decomp_packet =
+		rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
 
-		goto error;
-	}
+	uint8_t rcvd_feedback_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf rcvd_feedback =
+		rohc_buf_init_empty(rcvd_feedback_buffer, MAX_ROHC_SIZE);
 
-	/* get some statistics about the last compressed packet */
-	comp_last_packet_info.version_major = 0;
-	comp_last_packet_info.version_minor = 0;
-	if(!rohc_comp_get_last_packet_info2(comp, &comp_last_packet_info))
+	struct rohc_decomp_pkt_info decomp_pkt_info;
+	unsigned long possible_unit;
+	rohc_status_t decomp_status;
+	int ret;
+
+	if(status != ROHC_STATUS_OK)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to get compression info");
-		ret = -4;
+		SNIFFER_LOG(LOG_WARNING, "compression failed");
+		ret = -1;
+
+		/* dump the IP packet in the default dump file */
+		sniffer_dump_pkt(worker, header, packet, 0, false, true);
+
 		goto error;
 	}
+
+	/* update statistics with the information about the compressed packet */
+	pthread_mutex_lock(&sniffer_stats_lock);
 	stats->comp_pre_nr_bytes += uncomp_packet.len;
-	stats->comp_pre_nr_hdr_bytes += comp_last_packet_info.header_last_uncomp_size;
+	stats->comp_pre_nr_hdr_bytes += comp_pkt_info->uncomp_hdr_len;
 	stats->comp_post_nr_bytes += rohc_packet.len;
-	stats->comp_post_nr_hdr_bytes += comp_last_packet_info.header_last_comp_size;
+	stats->comp_post_nr_hdr_bytes += comp_pkt_info->hdr_len;
 	possible_unit = stats->comp_unit_size;
 	if(stats->comp_unit_size == 1)
 	{
@@ -1493,102 +3683,62 @@ static int compress_decompress(struct rohc_comp *comp,
 			stats->comp_post_nr_bytes %= stats->comp_unit_size;
 		}
 	}
-	stats->comp_nr_pkts_per_profile[comp_last_packet_info.profile_id]++;
-	stats->comp_nr_pkts_per_mode[comp_last_packet_info.context_mode]++;
-	stats->comp_nr_pkts_per_state[comp_last_packet_info.context_state]++;
-	stats->comp_nr_pkts_per_pkt_type[comp_last_packet_info.packet_type]++;
-	if(comp_last_packet_info.is_context_init)
+	stats->comp_nr_pkts_per_profile[comp_pkt_info->profile_id]++;
+	stats->comp_nr_pkts_per_mode[comp_pkt_info->context_mode]++;
+	stats->comp_nr_pkts_per_state[comp_pkt_info->context_state]++;
+	stats->comp_nr_pkts_per_pkt_type[comp_pkt_info->packet_type]++;
+	if(comp_pkt_info->is_context_init)
 	{
 		stats->comp_nr_reused_cid++;
 	}
+	pthread_mutex_unlock(&sniffer_stats_lock);
 
-	/* open a new dumper if none exists or the stream changed */
-	if(comp_last_packet_info.is_context_init)
-	{
-		char dump_filename[1024];
-
-		snprintf(dump_filename, 1024, "./dump_stream_cid_%u.pcap",
-		         comp_last_packet_info.context_id);
-		/* TODO: check result */
-
-		/* close the previous dumper and remove its file if one was opened */
-		if(dumpers[comp_last_packet_info.context_id] != NULL)
-		{
-			if(is_verbose)
-			{
-				SNIFFER_LOG(LOG_INFO, "replace dump file '%s' for context with "
-				            "ID %u", dump_filename,
-				            comp_last_packet_info.context_id);
-			}
-			pcap_dump_close(dumpers[comp_last_packet_info.context_id]);
-			unlink(dump_filename);
-			/* TODO: check result */
-		}
-
-		/* open the new dumper */
-		dumpers[comp_last_packet_info.context_id] =
-			pcap_dump_open(handle, dump_filename);
-		if(dumpers[comp_last_packet_info.context_id] == NULL)
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s' for "
-			            "context with ID %u", dump_filename,
-			            comp_last_packet_info.context_id);
-			assert(0);
-			goto error;
-		}
-	}
-
-	/* dump the IP packet */
-	rohc_buf_push(&uncomp_packet, link_len_src);
-	pcap_dump((u_char *) dumpers[comp_last_packet_info.context_id],
-	          &header, packet);
-	rohc_buf_pull(&uncomp_packet, link_len_src);
+	/* dump the IP packet, the writer opens a new dump file if none exists or
+	 * the stream changed */
+	sniffer_dump_pkt(worker, header, packet, comp_pkt_info->cid,
+	                 comp_pkt_info->is_context_init, false);
 
 	/* record the CID */
-	*cid = comp_last_packet_info.context_id;
+	*cid = comp_pkt_info->cid;
 
 	/* reset the feedback buffer */
 	feedback_send->data -= feedback_send->offset;
 	feedback_send->len = 0;
 
 	/* decompress the ROHC packet */
-	status = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
-	                          &rcvd_feedback, feedback_send);
-	if(status != ROHC_STATUS_OK)
+	memset(&decomp_pkt_info, 0, sizeof(struct rohc_decomp_pkt_info));
+	decomp_status = rohc_decompress4(decomp, rohc_packet, &decomp_packet,
+	                                 &rcvd_feedback, feedback_send,
+	                                 &decomp_pkt_info);
+	if(decomp_status != ROHC_STATUS_OK)
 	{
 		SNIFFER_LOG(LOG_WARNING, "decompression failed");
 		ret = -2;
 		goto error;
 	}
 
-	/* get some statistics about the last decompressed packet */
-	decomp_last_packet_info.version_major = 0;
-	decomp_last_packet_info.version_minor = 1;
-	if(!rohc_decomp_get_last_packet_info(decomp, &decomp_last_packet_info))
-	{
-		SNIFFER_LOG(LOG_WARNING, "failed to get decompression info");
-		ret = -4;
-		goto error;
-	}
-	stats->nr_lost_packets += decomp_last_packet_info.nr_lost_packets;
-	if(decomp_last_packet_info.nr_lost_packets > 0)
+	/* update statistics with the information about the decompressed packet */
+	pthread_mutex_lock(&sniffer_stats_lock);
+	stats->nr_lost_packets += decomp_pkt_info.lost_packets_nr;
+	if(decomp_pkt_info.lost_packets_nr > 0)
 	{
 		stats->nr_loss_bursts++;
-		if(decomp_last_packet_info.nr_lost_packets > stats->max_loss_burst_len)
+		if(decomp_pkt_info.lost_packets_nr > stats->max_loss_burst_len)
 		{
-			stats->max_loss_burst_len = decomp_last_packet_info.nr_lost_packets;
+			stats->max_loss_burst_len = decomp_pkt_info.lost_packets_nr;
 		}
-		if(decomp_last_packet_info.nr_lost_packets < stats->min_loss_burst_len ||
+		if(decomp_pkt_info.lost_packets_nr < stats->min_loss_burst_len ||
 		   stats->min_loss_burst_len == 0)
 		{
-			stats->min_loss_burst_len = decomp_last_packet_info.nr_lost_packets;
+			stats->min_loss_burst_len = decomp_pkt_info.lost_packets_nr;
 		}
 	}
-	stats->nr_misordered_packets += decomp_last_packet_info.nr_misordered_packets;
-	if(decomp_last_packet_info.is_duplicated)
+	stats->nr_misordered_packets += decomp_pkt_info.misordered_packets_nr;
+	if(decomp_pkt_info.is_duplicated)
 	{
 		stats->nr_duplicated_packets++;
 	}
+	pthread_mutex_unlock(&sniffer_stats_lock);
 
 	/* deliver any received feedback data to the associated compressor */
 	if(!rohc_comp_deliver_feedback2(comp, rcvd_feedback))
@@ -1845,6 +3995,9 @@ static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
                               const int profile __attribute__((unused)),
                               const char *format, ...)
 {
+	/* the workers share the ring buffer for the last traces */
+	pthread_mutex_lock(&last_traces_lock);
+
 	if(level >= ROHC_TRACE_WARNING || is_verbose)
 	{
 		va_list args;
@@ -1900,6 +4053,8 @@ static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
 	{
 		last_traces_first = (last_traces_first + 1) % MAX_LAST_TRACES;
 	}
+
+	pthread_mutex_unlock(&last_traces_lock);
 }
 
 
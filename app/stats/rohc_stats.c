@@ -47,6 +47,10 @@
 #include <unistd.h>
 #include <errno.h>
 #include <limits.h> /* for INT_MAX */
+#include <inttypes.h> /* for PRIu64 */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <pthread.h>
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -68,6 +72,9 @@ for ./configure ? If yes, check configure output and config.log"
 #include <rohc_comp.h>
 #include <rohc_decomp.h>
 
+/* ROHC captures */
+#include "rohc_capture.h"
+
 
 /** The device MTU */
 #define DEV_MTU  0xffffU
@@ -108,6 +115,109 @@ struct vlan_hdr
 } __attribute__((packed));
 
 
+/** The magic number of PCAP files with timestamps in microseconds */
+#define PCAP_MAGIC_USEC  0xa1b2c3d4U
+/** The magic number of PCAP files with timestamps in nanoseconds */
+#define PCAP_MAGIC_NSEC  0xa1b23c4dU
+
+/** The link type of raw IP packets stored in PCAP files, the DLT_RAW value
+ *  of libpcap depends on the platform */
+#define LINKTYPE_RAW  101U
+
+/** The global header of one PCAP file */
+struct pcap_file_hdr
+{
+	uint32_t magic;          /**< \ref PCAP_MAGIC_USEC or \ref PCAP_MAGIC_NSEC */
+	uint16_t version_major;  /**< The major version of the file format */
+	uint16_t version_minor;  /**< The minor version of the file format */
+	int32_t thiszone;        /**< The GMT to local correction */
+	uint32_t sigfigs;        /**< The accuracy of timestamps */
+	uint32_t snaplen;        /**< The max length of captured packets */
+	uint32_t linktype;       /**< The link type of the packets */
+} __attribute__((packed));
+
+/** The header of one packet record in one PCAP file */
+struct pcap_rec_hdr
+{
+	uint32_t ts_sec;   /**< The timestamp of the packet (seconds) */
+	uint32_t ts_frac;  /**< The timestamp of the packet (us or ns) */
+	uint32_t caplen;   /**< The number of bytes stored in the file */
+	uint32_t len;      /**< The length of the packet on the wire */
+} __attribute__((packed));
+
+/** One PCAP file mapped in memory */
+struct pcap_map
+{
+	const uint8_t *data;  /**< The content of the file */
+	size_t len;           /**< The length of the file */
+	size_t offset;        /**< The offset of the next packet record */
+	bool is_swapped;      /**< Whether the file was written in the other byte order */
+	bool is_nsec;         /**< Whether timestamps are in nanoseconds */
+	uint32_t linktype;    /**< The link type of the packets */
+};
+
+
+/** The maximum number of jobs that generate one summary in parallel */
+#define STATS_JOBS_MAX  256U
+
+/** The counters of one bucket of the histograms of one summary */
+struct stats_bucket
+{
+	uint64_t pkts_nr;         /**< The number of packets */
+	uint64_t uncomp_len;      /**< The uncompressed bytes */
+	uint64_t uncomp_hdr_len;  /**< The uncompressed header bytes */
+	uint64_t comp_len;        /**< The compressed bytes */
+	uint64_t comp_hdr_len;    /**< The compressed header bytes */
+};
+
+/** The histograms of one summary of (de)compression statistics */
+struct stats_summary
+{
+	/** All the packets */
+	struct stats_bucket total;
+	/** The packets per profile */
+	struct stats_bucket per_profile[ROHC_PROFILE_MAX];
+	/** The packets per context mode */
+	struct stats_bucket per_mode[ROHC_R_MODE + 1];
+	/** The packets per context state (compression states are the most) */
+	struct stats_bucket per_state[ROHC_COMP_STATE_CR + 1];
+	/** The packets per packet type */
+	struct stats_bucket per_pkt_type[ROHC_PACKET_MAX];
+	/** The packets per context */
+	struct stats_bucket per_cid[ROHC_LARGE_CID_MAX + 1];
+};
+
+/** The actions that rohc_stats may run on packets */
+typedef enum
+{
+	STATS_ACTION_DUMMY,   /**< Do nothing with the packets */
+	STATS_ACTION_COMP,    /**< Compress the packets */
+	STATS_ACTION_DECOMP,  /**< Decompress the packets */
+} stats_action_t;
+
+/** The sources shared by the jobs that generate one summary */
+struct stats_jobs
+{
+	stats_action_t action;              /**< The action to run on packets */
+	rohc_cid_type_t cid_type;           /**< The type of CIDs */
+	unsigned int max_contexts;          /**< The max number of contexts */
+	size_t max_pkts_nr;                 /**< The max number of packets per file */
+	const char *const *sources;         /**< The PCAP files */
+	size_t sources_nr;                  /**< The number of PCAP files */
+	size_t next_source;                 /**< The next PCAP file to process */
+	bool is_failure;                    /**< Whether one job failed */
+	pthread_mutex_t lock;               /**< The lock for next_source and is_failure */
+};
+
+/** One job that generates one summary with some of the sources */
+struct stats_job
+{
+	pthread_t thread;                /**< The thread that runs the job */
+	struct stats_jobs *jobs;         /**< The sources shared by all jobs */
+	struct stats_summary *summary;   /**< The summary of the job */
+};
+
+
 /** Whether the application runs in verbose mode or not */
 static enum
 {
@@ -126,7 +236,8 @@ static int generate_dummy_stats_all(const char *source,
 static int generate_dummy_stats_one(const unsigned long num_packet,
                                     const struct pcap_pkthdr header,
                                     const unsigned char *packet,
-                                    size_t link_len)
+                                    size_t link_len,
+                                    struct stats_summary *const summary)
 	__attribute__((warn_unused_result, nonnull(3)));
 
 static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
@@ -138,20 +249,93 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
                                    const unsigned long num_packet,
                                    const struct pcap_pkthdr header,
                                    const unsigned char *packet,
-                                   size_t link_len)
+                                   size_t link_len,
+                                   struct stats_summary *const summary)
 	__attribute__((warn_unused_result, nonnull(1, 4)));
+static struct rohc_comp * create_comp(const rohc_cid_type_t cid_type,
+                                      const unsigned int max_contexts)
+	__attribute__((warn_unused_result));
 
 static int generate_decomp_stats_all(const rohc_cid_type_t cid_type,
                                      const unsigned int max_contexts,
                                      const char *source,
-                                     const size_t max_pkts_nr)
+                                     const size_t max_pkts_nr,
+                                     const char *const record_path,
+                                     const size_t snapshot_interval)
+	__attribute__((warn_unused_result, nonnull(3)));
+static int generate_decomp_stats_capture(const rohc_cid_type_t cid_type,
+                                         const unsigned int max_contexts,
+                                         const char *source,
+                                         const size_t max_pkts_nr,
+                                         const size_t seek_pkt_num)
 	__attribute__((warn_unused_result, nonnull(3)));
 static int generate_decomp_stats_one(struct rohc_decomp *const decomp,
                                      const unsigned long num_packet,
                                      const struct pcap_pkthdr header,
                                      const unsigned char *packet,
-                                     size_t link_len)
+                                     size_t link_len,
+                                     struct stats_summary *const summary,
+                                     struct rohc_capture_writer *const capture)
 	__attribute__((warn_unused_result, nonnull(1, 4)));
+static struct rohc_decomp * create_decomp(const rohc_cid_type_t cid_type,
+                                          const unsigned int max_contexts)
+	__attribute__((warn_unused_result));
+
+static int generate_summary_all(const stats_action_t action,
+                                const rohc_cid_type_t cid_type,
+                                const unsigned int max_contexts,
+                                const char *const sources[],
+                                const size_t sources_nr,
+                                const size_t jobs_nr,
+                                const size_t max_pkts_nr)
+	__attribute__((warn_unused_result, nonnull(4)));
+static void * stats_job_run(void *const arg)
+	__attribute__((nonnull(1)));
+static int generate_summary_one(const struct stats_jobs *const jobs,
+                                const char *const source,
+                                struct stats_summary *const summary)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void stats_summary_add(struct stats_summary *const summary,
+                              const int profile_id,
+                              const int cid,
+                              const int mode,
+                              const int state,
+                              const int packet_type,
+                              const size_t uncomp_len,
+                              const size_t uncomp_hdr_len,
+                              const size_t comp_len,
+                              const size_t comp_hdr_len)
+	__attribute__((nonnull(1)));
+static void stats_buckets_merge(struct stats_bucket *const buckets,
+                                const struct stats_bucket *const others,
+                                const size_t nr)
+	__attribute__((nonnull(1, 2)));
+static void stats_summary_merge(struct stats_summary *const summary,
+                                const struct stats_summary *const other)
+	__attribute__((nonnull(1, 2)));
+static void print_summary(const struct stats_summary *const summary,
+                          const stats_action_t action)
+	__attribute__((nonnull(1)));
+static void print_summary_bucket(const char *const histogram,
+                                 const unsigned int id,
+                                 const char *const name,
+                                 const struct stats_bucket *const bucket)
+	__attribute__((nonnull(1, 3, 4)));
+static const char * get_profile_descr(const unsigned int profile_id)
+	__attribute__((warn_unused_result, const));
+
+static bool pcap_map_open(const char *const path,
+                          struct pcap_map *const map)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool pcap_map_next(struct pcap_map *const map,
+                          struct pcap_pkthdr *const header,
+                          const unsigned char **const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void pcap_map_close(struct pcap_map *const map)
+	__attribute__((nonnull(1)));
+static uint32_t pcap_map_u32(const struct pcap_map *const map,
+                             const uint32_t value)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
@@ -190,9 +374,16 @@ int main(int argc, char *argv[])
 	char *test_type = NULL; /* the name of the test to perform */
 	char *cid_type_name = NULL;
 	char *source_descr = NULL;
+	const char **sources = NULL;
+	size_t sources_nr = 0;
+	bool do_summary = false;
+	int jobs_nr = 1;
 	int status = 1;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int max_pkts_nr = 0; /* 0 means all PCAP file or infinite for live capture */
+	char *record_path = NULL;
+	int snapshot_interval = ROHC_CAPTURE_SNAPSHOT_INTERVAL;
+	int seek_pkt_num = 0; /* 0 means no seek */
 	size_t max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
 	rohc_cid_type_t cid_type = ROHC_SMALL_CID;
 	int args_used;
@@ -207,6 +398,14 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* the sources are collected for the summary mode */
+	sources = calloc(argc, sizeof(char *));
+	if(sources == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the sources\n");
+		goto error;
+	}
+
 	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
 	{
 		args_used = 1;
@@ -257,6 +456,59 @@ int main(int argc, char *argv[])
 			max_pkts_nr = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--summary"))
+		{
+			/* print histograms instead of per-packet statistics */
+			do_summary = true;
+		}
+		else if(!strcmp(*argv, "--record"))
+		{
+			/* get the name of the ROHC capture to record the packets in */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --record parameter\n");
+				usage();
+				goto error;
+			}
+			record_path = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--snapshot-interval"))
+		{
+			/* get the number of packets between two snapshots of the contexts */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --snapshot-interval parameter\n");
+				usage();
+				goto error;
+			}
+			snapshot_interval = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--seek"))
+		{
+			/* get the first packet of the ROHC capture to generate stats for */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --seek parameter\n");
+				usage();
+				goto error;
+			}
+			seek_pkt_num = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--jobs"))
+		{
+			/* get the number of files to process in parallel */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --jobs parameter\n");
+				usage();
+				goto error;
+			}
+			jobs_nr = atoi(argv[1]);
+			args_used++;
+		}
 		else if(test_type == NULL)
 		{
 			/* get the name of the test */
@@ -285,18 +537,17 @@ int main(int argc, char *argv[])
 				goto error;
 			}
 		}
-		else if(source_descr == NULL)
+		else
 		{
 			/* get the source of packets: either the name of the file that contains
 			 * the packets to compress, or the name of the network device to
-			 * live capture packets from */
-			source_descr = argv[0];
-		}
-		else
-		{
-			/* do not accept more than one filename without option name */
-			usage();
-			goto error;
+			 * live capture packets from; several files may be summarized */
+			if(source_descr == NULL)
+			{
+				source_descr = argv[0];
+			}
+			sources[sources_nr] = argv[0];
+			sources_nr++;
 		}
 	}
 
@@ -344,8 +595,75 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* do not accept more than one source without summary */
+	if(sources_nr > 1 && !do_summary)
+	{
+		fprintf(stderr, "several sources require --summary\n");
+		usage();
+		goto error;
+	}
+
+	/* the number of jobs should be valid */
+	if(jobs_nr < 1 || jobs_nr > STATS_JOBS_MAX)
+	{
+		fprintf(stderr, "the number of jobs should be between 1 and %u\n\n",
+		        STATS_JOBS_MAX);
+		usage();
+		goto error;
+	}
+
+	/* ROHC captures are only for decompression, packet per packet */
+	if((record_path != NULL || seek_pkt_num != 0) &&
+	   (do_summary || strcmp(test_type, "decomp") != 0))
+	{
+		fprintf(stderr, "--record and --seek require the 'decomp' action "
+		        "without --summary\n");
+		usage();
+		goto error;
+	}
+	if(snapshot_interval < 1)
+	{
+		fprintf(stderr, "the number of packets between two snapshots should be "
+		        "between 1 and %d\n\n", INT_MAX);
+		usage();
+		goto error;
+	}
+	if(seek_pkt_num < 0)
+	{
+		fprintf(stderr, "the packet to seek to should be between 1 and %d\n\n",
+		        INT_MAX);
+		usage();
+		goto error;
+	}
+
 	/* generate ROHC (de)compression statistics with the packets from the source */
-	if(strcmp(test_type, "dummy") == 0)
+	if(do_summary)
+	{
+		stats_action_t action;
+
+		if(strcmp(test_type, "dummy") == 0)
+		{
+			action = STATS_ACTION_DUMMY;
+		}
+		else if(strcmp(test_type, "comp") == 0)
+		{
+			action = STATS_ACTION_COMP;
+		}
+		else if(strcmp(test_type, "decomp") == 0)
+		{
+			action = STATS_ACTION_DECOMP;
+		}
+		else
+		{
+			fprintf(stderr, "unexpected test type '%s'\n", test_type);
+			goto error;
+		}
+
+		/* summarize the packets from the PCAP files */
+		status = generate_summary_all(action, cid_type, max_contexts, sources,
+		                              sources_nr, jobs_nr, max_pkts_nr);
+	}
+	else if(strcmp(test_type, "dummy") == 0)
 	{
 		/* do nothing with the packets from the capture to estimate program overhead */
 		status = generate_dummy_stats_all(source_descr, max_pkts_nr);
@@ -356,11 +674,33 @@ int main(int argc, char *argv[])
 		status = generate_comp_stats_all(cid_type, max_contexts, source_descr,
 		                                 max_pkts_nr);
 	}
+	else if(strcmp(test_type, "decomp") == 0 &&
+	        rohc_capture_is_capture(source_descr))
+	{
+		/* test ROHC decompression with the packets from the ROHC capture,
+		 * from the given packet on */
+		if(record_path != NULL)
+		{
+			fprintf(stderr, "--record requires a PCAP source\n");
+			usage();
+			goto error;
+		}
+		status = generate_decomp_stats_capture(cid_type, max_contexts,
+		                                       source_descr, max_pkts_nr,
+		                                       seek_pkt_num);
+	}
 	else if(strcmp(test_type, "decomp") == 0)
 	{
 		/* test ROHC decompression with the packets from the capture */
+		if(seek_pkt_num != 0)
+		{
+			fprintf(stderr, "--seek requires a ROHC capture as source\n");
+			usage();
+			goto error;
+		}
 		status = generate_decomp_stats_all(cid_type, max_contexts, source_descr,
-		                                   max_pkts_nr);
+		                                   max_pkts_nr, record_path,
+		                                   snapshot_interval);
 	}
 	else
 	{
@@ -369,6 +709,7 @@ int main(int argc, char *argv[])
 	}
 
 error:
+	free(sources);
 	return status;
 }
 
@@ -398,7 +739,21 @@ static void usage(void)
 	       "The shell script rohc_stats.sh could be used to generate a HTML\n"
 	       "report.\n"
 	       "\n"
+	       "With --summary, the rohc_stats tool outputs histograms instead,\n"
+	       "one bucket per line with the following tab-separated fields:\n\n"
+	       "  * keyword 'HIST'\n\n"
+	       "  * histogram among 'total', 'profile', 'mode', 'state',\n"
+	       "    'packet_type' and 'context'\n\n"
+	       "  * bucket (numeric ID)\n\n"
+	       "  * bucket (string, no whitespace)\n\n"
+	       "  * number of packets\n\n"
+	       "  * uncompressed packet size (bytes)\n\n"
+	       "  * uncompressed header size (bytes)\n\n"
+	       "  * compressed packet size (bytes)\n\n"
+	       "  * compressed header size (bytes)\n\n"
+	       "\n"
 	       "Usage: rohc_stats [OPTIONS] ACTION CID_TYPE SOURCE\n"
+	       "       rohc_stats [OPTIONS] --summary ACTION CID_TYPE FILE...\n"
 	       "\n"
 	       "Options:\n"
 	       "  -v, --version           Print version information and exit\n"
@@ -410,6 +765,23 @@ static void usage(void)
 	       "      --max-pkts-nr NUM   The maximum number of packets to (de)compress\n"
 	       "                          (0 means all packets from file or infinite for\n"
 	       "                           network device)\n"
+	       "                          (per file with --summary)\n"
+	       "      --summary           Print histograms of all the packets of all\n"
+	       "                          the PCAP files instead of per-packet\n"
+	       "                          statistics\n"
+	       "      --jobs NUM          The number of PCAP files to process in\n"
+	       "                          parallel with --summary (default 1)\n"
+	       "      --record FILE       Record the ROHC packets to decompress in\n"
+	       "                          the given ROHC capture, along with\n"
+	       "                          snapshots of the decompression contexts\n"
+	       "                          ('decomp' from a PCAP source only)\n"
+	       "      --snapshot-interval NUM\n"
+	       "                          The number of packets between two\n"
+	       "                          snapshots with --record (default %u)\n"
+	       "      --seek NUM          Generate statistics from packet NUM of\n"
+	       "                          the ROHC capture: the contexts are\n"
+	       "                          restored from the nearest snapshot\n"
+	       "                          ('decomp' from a ROHC capture only)\n"
 	       "\n"
 	       "With:\n"
 	       "  ACTION    Run a dummy test with 'dummy',\n"
@@ -420,13 +792,23 @@ static void usage(void)
 	       "  SOURCE    The source of of Ethernet frames to compress, ie:\n"
 	       "              - the name of a file in PCAP format\n"
 	       "              - the name of a network device\n"
+	       "              - the name of a ROHC capture ('decomp' only)\n"
+	       "  FILE      The name of a file in PCAP format, every file is\n"
+	       "            (de)compressed with its own ROHC (de)compressor\n"
 	       "\n"
 	       "Examples:\n"
 	       "  rohc_stats comp smallcid /tmp/rtp.pcap  Generate statistics from a file\n"
 	       "  rohc_stats decomp largecid ~/lan.pcap   Generate statistics from a file\n"
 	       "  rohc_stats comp largecid eth0           Generate statistics from Ethernet device 'eth0'\n"
+	       "  rohc_stats --summary --jobs 8 comp smallcid day/*.pcap\n"
+	       "                                          Generate histograms from many files\n"
+	       "  rohc_stats --record day.rcap decomp smallcid day.pcap\n"
+	       "                                          Record one seekable ROHC capture\n"
+	       "  rohc_stats --seek 123456 decomp smallcid day.rcap\n"
+	       "                                          Generate statistics from packet 123456\n"
 	       "\n"
-	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       ROHC_CAPTURE_SNAPSHOT_INTERVAL);
 }
 
 
@@ -538,7 +920,8 @@ static int generate_dummy_stats_all(const char *source,
 		num_packet++;
 
 		/* do nothing with the packet and generate statistics */
-		ret = generate_dummy_stats_one(num_packet, header, packet, link_len);
+		ret = generate_dummy_stats_one(num_packet, header, packet, link_len,
+		                               NULL);
 		if(ret != 0)
 		{
 			fprintf(stderr, "packet %lu: failed to generate stats for packet\n",
@@ -564,13 +947,16 @@ error:
  * @param header      The PCAP header for the packet
  * @param packet      The packet to compress (link layer included)
  * @param link_len    The length of the link layer header before IP data
+ * @param summary     The summary to account the packet in, NULL to print
+ *                    the statistics of the packet instead
  * @return            0 in case of success,
  *                    1 in case of failure
  */
 static int generate_dummy_stats_one(const unsigned long num_packet,
                                     const struct pcap_pkthdr header,
                                     const unsigned char *packet,
-                                    size_t link_len)
+                                    size_t link_len,
+                                    struct stats_summary *const summary)
 {
 	struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
 	struct rohc_buf ip_packet =
@@ -619,7 +1005,13 @@ static int generate_dummy_stats_one(const unsigned long num_packet,
 		}
 	}
 
-	if(verbosity != VERBOSITY_NONE)
+	if(summary != NULL)
+	{
+		/* account the packet in the summary */
+		stats_summary_add(summary, -1, -1, -1, -1, ROHC_PACKET_UNKNOWN,
+		                  ip_packet.len, 0, ip_packet.len, 0);
+	}
+	else if(verbosity != VERBOSITY_NONE)
 	{
 		/* output some statistics about the last compressed packet */
 		printf("STAT\t%lu\t0\tunknown\t0\tunknown\t14\tunknown\t%zu\t0\t%zu\t0\n",
@@ -725,49 +1117,12 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 	srand(time(NULL));
 
 	/* create the ROHC compressor */
-	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_random_num, NULL);
+	comp = create_comp(cid_type, max_contexts);
 	if(comp == NULL)
 	{
-		fprintf(stderr, "cannot create the ROHC compressor\n");
 		goto close_input;
 	}
 
-	/* enable traces in verbose mode */
-	if(verbosity == VERBOSITY_FULL)
-	{
-		/* set the callback for traces on compressor */
-		if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
-		{
-			fprintf(stderr, "failed to set the callback for traces on "
-			        "compressor\n");
-			goto destroy_comp;
-		}
-	}
-
-	/* enable periodic refreshes based on inter-packet delay */
-	if(!rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES))
-	{
-		fprintf(stderr, "failed to enable periodic refreshes of contexts based "
-		        "on inter-packet delay\n");
-		goto destroy_comp;
-	}
-
-	/* enable profiles */
-	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
-	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
-	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
-	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
-	{
-		fprintf(stderr, "failed to enable the compression profiles\n");
-		goto destroy_comp;
-	}
-
-	/* set UDP ports dedicated to RTP traffic */
-	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
-	{
-		goto destroy_comp;
-	}
-
 	/* output the statistics columns names */
 	if(verbosity != VERBOSITY_NONE)
 	{
@@ -795,7 +1150,8 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 		num_packet++;
 
 		/* compress the packet and generate statistics */
-		ret = generate_comp_stats_one(comp, num_packet, header, packet, link_len);
+		ret = generate_comp_stats_one(comp, num_packet, header, packet, link_len,
+		                              NULL);
 		if(ret != 0)
 		{
 			fprintf(stderr, "packet %lu: failed to compress or generate stats "
@@ -824,6 +1180,8 @@ error:
  * @param header      The PCAP header for the packet
  * @param packet      The packet to compress (link layer included)
  * @param link_len    The length of the link layer header before IP data
+ * @param summary     The summary to account the packet in, NULL to print
+ *                    the statistics of the packet instead
  * @return            0 in case of success,
  *                    1 in case of failure
  */
@@ -831,7 +1189,8 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
                                    const unsigned long num_packet,
                                    const struct pcap_pkthdr header,
                                    const unsigned char *packet,
-                                   size_t link_len)
+                                   size_t link_len,
+                                   struct stats_summary *const summary)
 {
 	const struct rohc_ts arrival_time = {
 		.sec = header.ts.tv_sec,
@@ -842,7 +1201,7 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
 	uint8_t rohc_buffer[MAX_ROHC_SIZE];
 	struct rohc_buf rohc_packet =
 		rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
-	rohc_comp_last_packet_info2_t last_packet_info;
+	struct rohc_comp_pkt_info pkt_info;
 	rohc_status_t status;
 
 	/* check frame length */
@@ -889,38 +1248,35 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
 	}
 
 	/* compress the IP packet */
-	status = rohc_compress4(comp, ip_packet, &rohc_packet);
+	status = rohc_compress5(comp, ip_packet, &rohc_packet, &pkt_info);
 	if(status != ROHC_STATUS_OK)
 	{
 		fprintf(stderr, "packet #%lu: compression failed\n", num_packet);
 		goto error;
 	}
 
-	if(verbosity != VERBOSITY_NONE)
+	if(summary != NULL)
 	{
-		/* get some statistics about the last compressed packet */
-		last_packet_info.version_major = 0;
-		last_packet_info.version_minor = 0;
-		if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
-		{
-			fprintf(stderr, "packet #%lu: cannot get stats about the last compressed "
-			        "packet\n", num_packet);
-			goto error;
-		}
-
-		/* output some statistics about the last compressed packet */
-		printf("STAT\t%lu\t%d\t%s\t%d\t%s\t%d\t%s\t%lu\t%lu\t%lu\t%lu\n",
+		/* account the packet in the summary */
+		stats_summary_add(summary, pkt_info.profile_id, pkt_info.cid,
+		                  pkt_info.context_mode, pkt_info.context_state,
+		                  pkt_info.packet_type, ip_packet.len,
+		                  pkt_info.uncomp_hdr_len, rohc_packet.len,
+		                  pkt_info.hdr_len);
+	}
+	else if(verbosity != VERBOSITY_NONE)
+	{
+		/* output some statistics about the compressed packet */
+		printf("STAT\t%lu\t%d\t%s\t%d\t%s\t%d\t%s\t%zu\t%zu\t%zu\t%zu\n",
 		       num_packet,
-		       last_packet_info.context_mode,
-		       rohc_get_mode_descr(last_packet_info.context_mode),
-		       last_packet_info.context_state,
-		       rohc_comp_get_state_descr(last_packet_info.context_state),
-		       last_packet_info.packet_type,
-		       rohc_get_packet_descr(last_packet_info.packet_type),
-		       last_packet_info.total_last_uncomp_size,
-		       last_packet_info.header_last_uncomp_size,
-		       last_packet_info.total_last_comp_size,
-		       last_packet_info.header_last_comp_size);
+		       pkt_info.context_mode,
+		       rohc_get_mode_descr(pkt_info.context_mode),
+		       pkt_info.context_state,
+		       rohc_comp_get_state_descr(pkt_info.context_state),
+		       pkt_info.packet_type,
+		       rohc_get_packet_descr(pkt_info.packet_type),
+		       ip_packet.len, pkt_info.uncomp_hdr_len,
+		       rohc_packet.len, pkt_info.hdr_len);
 		fflush(stdout);
 	}
 
@@ -932,19 +1288,90 @@ error:
 
 
 /**
- * @brief Generate ROHC decompression statistics with a flow of ROHC packets
+ * @brief Create one ROHC compressor for the statistics
  *
  * @param cid_type       The type of CIDs the compressor shall use
  * @param max_contexts   The maximum number of ROHC contexts to use
- * @param source         The source of ROHC packets
- * @param max_pkts_nr    The maximum number of packets to decompress
- * @return               0 in case of success,
- *                       1 in case of failure
+ * @return               The new compressor, NULL in case of failure
+ */
+static struct rohc_comp * create_comp(const rohc_cid_type_t cid_type,
+                                      const unsigned int max_contexts)
+{
+	struct rohc_comp *comp;
+
+	/* create the ROHC compressor */
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+
+	/* enable traces in verbose mode */
+	if(verbosity == VERBOSITY_FULL)
+	{
+		/* set the callback for traces on compressor */
+		if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+		{
+			fprintf(stderr, "failed to set the callback for traces on "
+			        "compressor\n");
+			goto destroy_comp;
+		}
+	}
+
+	/* enable periodic refreshes based on inter-packet delay */
+	if(!rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES))
+	{
+		fprintf(stderr, "failed to enable periodic refreshes of contexts based "
+		        "on inter-packet delay\n");
+		goto destroy_comp;
+	}
+
+	/* enable profiles */
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Generate ROHC decompression statistics with a flow of ROHC packets
+ *
+ * @param cid_type           The type of CIDs the compressor shall use
+ * @param max_contexts       The maximum number of ROHC contexts to use
+ * @param source             The source of ROHC packets
+ * @param max_pkts_nr        The maximum number of packets to decompress
+ * @param record_path        The ROHC capture to record the ROHC packets in,
+ *                           NULL not to record them
+ * @param snapshot_interval  The number of packets between two snapshots of
+ *                           the contexts in the ROHC capture
+ * @return                   0 in case of success,
+ *                           1 in case of failure
  */
 static int generate_decomp_stats_all(const rohc_cid_type_t cid_type,
                                      const unsigned int max_contexts,
                                      const char *source,
-                                     const size_t max_pkts_nr)
+                                     const size_t max_pkts_nr,
+                                     const char *const record_path,
+                                     const size_t snapshot_interval)
 {
 	struct stat source_stat;
 	int ret;
@@ -956,6 +1383,8 @@ static int generate_decomp_stats_all(const rohc_cid_type_t cid_type,
 
 	struct rohc_decomp *decomp;
 
+	struct rohc_capture_writer capture;
+
 	unsigned long num_packet;
 	struct pcap_pkthdr header;
 	unsigned char *packet;
@@ -1019,41 +1448,18 @@ static int generate_decomp_stats_all(const rohc_cid_type_t cid_type,
 	}
 
 	/* create the ROHC decompressor */
-	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
+	decomp = create_decomp(cid_type, max_contexts);
 	if(decomp == NULL)
 	{
-		fprintf(stderr, "cannot create the ROHC decompressor\n");
 		goto close_input;
 	}
 
-	/* enable traces in verbose mode */
-	if(verbosity == VERBOSITY_FULL)
+	/* start the ROHC capture if asked */
+	if(record_path != NULL &&
+	   !rohc_capture_writer_open(&capture, record_path, snapshot_interval))
 	{
-		/* set the callback for traces on decompressor */
-		if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
-		{
-			fprintf(stderr, "failed to set the callback for traces on "
-			        "decompressor\n");
-			goto destroy_decomp;
-		}
-
-		/* enable packet dump only in verbose mode */
-		if(!rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_DUMP_PACKETS))
-		{
-			fprintf(stderr, "failed to enable packet dumps\n");
-			goto destroy_decomp;
-		}
-	}
-
-	/* enable profiles */
-	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
-	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
-	                                ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
-	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
-	{
-		fprintf(stderr, "failed to enable the decompression profiles\n");
-		goto destroy_decomp;
-	}
+		goto destroy_decomp;
+	}
 
 	/* output the statistics columns names */
 	if(verbosity != VERBOSITY_NONE)
@@ -1082,18 +1488,25 @@ static int generate_decomp_stats_all(const rohc_cid_type_t cid_type,
 		num_packet++;
 
 		/* decompress the packet and generate statistics */
-		ret = generate_decomp_stats_one(decomp, num_packet, header, packet, link_len);
+		ret = generate_decomp_stats_one(decomp, num_packet, header, packet,
+		                                link_len, NULL,
+		                                record_path != NULL ? &capture : NULL);
 		if(ret != 0)
 		{
 			fprintf(stderr, "packet %lu: failed to decompress or generate stats "
 			        "for packet\n", num_packet);
-			goto destroy_decomp;
+			goto close_capture;
 		}
 	}
 
 	/* everything went fine */
 	is_failure = 0;
 
+close_capture:
+	if(record_path != NULL && !rohc_capture_writer_close(&capture))
+	{
+		is_failure = 1;
+	}
 destroy_decomp:
 	rohc_decomp_free(decomp);
 close_input:
@@ -1103,6 +1516,146 @@ error:
 }
 
 
+/**
+ * @brief Generate ROHC decompression statistics with the packets of one ROHC
+ *        capture
+ *
+ * The contexts are restored from the last snapshot before the first packet
+ * to generate statistics for, then the packets between the snapshot and the
+ * first packet are decompressed without statistics.
+ *
+ * @param cid_type       The type of CIDs the decompressor shall use
+ * @param max_contexts   The maximum number of ROHC contexts to use
+ * @param source         The ROHC capture
+ * @param max_pkts_nr    The maximum number of packets to generate stats for
+ * @param seek_pkt_num   The first packet (from 1) to generate stats for,
+ *                       0 for the first packet of the capture
+ * @return               0 in case of success,
+ *                       1 in case of failure
+ */
+static int generate_decomp_stats_capture(const rohc_cid_type_t cid_type,
+                                         const unsigned int max_contexts,
+                                         const char *source,
+                                         const size_t max_pkts_nr,
+                                         const size_t seek_pkt_num)
+{
+	const uint64_t first_stats_pkt = (seek_pkt_num > 0 ? seek_pkt_num - 1 : 0);
+	struct rohc_capture_map map;
+	struct rohc_decomp *decomp;
+	struct rohc_capture_rec_hdr rec;
+	const uint8_t *packet;
+	uint64_t pkt_num;
+	size_t stats_pkts_nr = 0;
+	size_t ctxts_nr;
+	int is_failure = 1;
+
+	/* map the ROHC capture */
+	if(!rohc_capture_map_open(source, &map))
+	{
+		goto error;
+	}
+
+	/* create the ROHC decompressor */
+	decomp = create_decomp(cid_type, max_contexts);
+	if(decomp == NULL)
+	{
+		goto close_input;
+	}
+
+	/* restore the contexts from the nearest snapshot */
+	if(!rohc_capture_map_seek(&map, decomp, first_stats_pkt, &pkt_num,
+	                          &ctxts_nr))
+	{
+		goto destroy_decomp;
+	}
+	if(verbosity == VERBOSITY_FULL)
+	{
+		fprintf(stderr, "%zu contexts restored for packet #%llu, %llu packets "
+		        "to decompress before packet #%llu\n", ctxts_nr,
+		        (unsigned long long) pkt_num + 1,
+		        (unsigned long long) (first_stats_pkt - pkt_num),
+		        (unsigned long long) first_stats_pkt + 1);
+	}
+
+	/* output the statistics columns names */
+	if(verbosity != VERBOSITY_NONE)
+	{
+		printf("STAT\t"
+		       "\"packet number\"\t"
+		       "\"context mode\"\t"
+		       "\"context mode (string)\"\t"
+		       "\"context state\"\t"
+		       "\"context state (string)\"\t"
+		       "\"packet type\"\t"
+		       "\"packet type (string)\"\t"
+		       "\"uncompressed packet size (bytes)\"\t"
+		       "\"uncompressed header size (bytes)\"\t"
+		       "\"compressed packet size (bytes)\"\t"
+		       "\"compressed header size (bytes)\"\n");
+		fflush(stdout);
+	}
+
+	/* for each packet of the ROHC capture from the snapshot on,
+	 * up to max_pkts_nr packets with statistics */
+	while((max_pkts_nr == 0 || stats_pkts_nr < max_pkts_nr) &&
+	      rohc_capture_map_next(&map, &rec, &packet))
+	{
+		pkt_num = rec.pkt_num;
+
+		if(pkt_num < first_stats_pkt)
+		{
+			/* only update the contexts up to the first packet */
+			const struct rohc_ts arrival_time = {
+				.sec = rec.ts_sec,
+				.nsec = rec.ts_nsec
+			};
+			const struct rohc_buf rohc_packet =
+				rohc_buf_init_full((uint8_t *) packet, rec.len, arrival_time);
+			uint8_t ip_buffer[MAX_ROHC_SIZE];
+			struct rohc_buf ip_packet =
+				rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+
+			if(rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL,
+			                    NULL) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "packet #%llu: decompression failed\n",
+				        (unsigned long long) pkt_num + 1);
+				goto destroy_decomp;
+			}
+		}
+		else
+		{
+			struct pcap_pkthdr header;
+
+			/* decompress the packet and generate statistics */
+			memset(&header, 0, sizeof(struct pcap_pkthdr));
+			header.ts.tv_sec = rec.ts_sec;
+			header.ts.tv_usec = rec.ts_nsec / 1000;
+			header.caplen = rec.len;
+			header.len = rec.len;
+			if(generate_decomp_stats_one(decomp, pkt_num + 1, header, packet,
+			                             0, NULL, NULL) != 0)
+			{
+				fprintf(stderr, "packet %llu: failed to decompress or generate "
+				        "stats for packet\n", (unsigned long long) pkt_num + 1);
+				goto destroy_decomp;
+			}
+			stats_pkts_nr++;
+		}
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+close_input:
+	rohc_capture_map_close(&map);
+error:
+	return is_failure;
+}
+
+
 /**
  * @brief Generate ROHC decompression statistics for one single IP packet
  *
@@ -1111,6 +1664,10 @@ error:
  * @param header      The PCAP header for the packet
  * @param packet      The packet to compress (link layer included)
  * @param link_len    The length of the link layer header before ROHC data
+ * @param summary     The summary to account the packet in, NULL to print
+ *                    the statistics of the packet instead
+ * @param capture     The ROHC capture to record the ROHC packet in, NULL
+ *                    not to record it
  * @return            0 in case of success,
  *                    1 in case of failure
  */
@@ -1118,7 +1675,9 @@ static int generate_decomp_stats_one(struct rohc_decomp *const decomp,
                                      const unsigned long num_packet,
                                      const struct pcap_pkthdr header,
                                      const unsigned char *packet,
-                                     size_t link_len)
+                                     size_t link_len,
+                                     struct stats_summary *const summary,
+                                     struct rohc_capture_writer *const capture)
 {
 	const struct rohc_ts arrival_time = {
 		.sec = header.ts.tv_sec,
@@ -1129,7 +1688,7 @@ static int generate_decomp_stats_one(struct rohc_decomp *const decomp,
 	uint8_t ip_buffer[MAX_ROHC_SIZE];
 	struct rohc_buf ip_packet =
 		rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
-	rohc_decomp_last_packet_info_t last_packet_info;
+	struct rohc_decomp_pkt_info pkt_info;
 	rohc_status_t status;
 
 	/* check frame length */
@@ -1148,39 +1707,48 @@ static int generate_decomp_stats_one(struct rohc_decomp *const decomp,
 	}
 	rohc_buf_pull(&rohc_packet, link_len);
 
+	/* record the ROHC packet before the decompressor updates its contexts */
+	if(capture != NULL &&
+	   !rohc_capture_writer_add(capture, decomp, arrival_time,
+	                            rohc_buf_data(rohc_packet), rohc_packet.len))
+	{
+		fprintf(stderr, "packet #%lu: failed to record the packet\n",
+		        num_packet);
+		goto error;
+	}
+
 	/* decompress the IP packet */
-	status = rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL, NULL);
+	memset(&pkt_info, 0, sizeof(struct rohc_decomp_pkt_info));
+	status = rohc_decompress4(decomp, rohc_packet, &ip_packet, NULL, NULL,
+	                          &pkt_info);
 	if(status != ROHC_STATUS_OK)
 	{
 		fprintf(stderr, "packet #%lu: compression failed\n", num_packet);
 		goto error;
 	}
 
-	if(verbosity != VERBOSITY_NONE)
+	if(summary != NULL)
 	{
-		/* get some statistics about the last decompressed packet */
-		last_packet_info.version_major = 0;
-		last_packet_info.version_minor = 2;
-		if(!rohc_decomp_get_last_packet_info(decomp, &last_packet_info))
-		{
-			fprintf(stderr, "packet #%lu: cannot get stats about the last "
-			        "decompressed packet\n", num_packet);
-			goto error;
-		}
-
-		/* output some statistics about the last decompressed packet */
-		printf("STAT\t%lu\t%d\t%s\t%d\t%s\t%d\t%s\t%lu\t%lu\t%lu\t%lu\n",
+		/* account the packet in the summary */
+		stats_summary_add(summary, pkt_info.profile_id, pkt_info.cid,
+		                  pkt_info.context_mode, pkt_info.context_state,
+		                  pkt_info.packet_type, ip_packet.len,
+		                  pkt_info.uncomp_hdr_len, rohc_packet.len,
+		                  pkt_info.hdr_len);
+	}
+	else if(verbosity != VERBOSITY_NONE)
+	{
+		/* output some statistics about the decompressed packet */
+		printf("STAT\t%lu\t%d\t%s\t%d\t%s\t%d\t%s\t%zu\t%zu\t%zu\t%zu\n",
 		       num_packet,
-		       last_packet_info.context_mode,
-		       rohc_get_mode_descr(last_packet_info.context_mode),
-		       last_packet_info.context_state,
-		       rohc_decomp_get_state_descr(last_packet_info.context_state),
-		       last_packet_info.packet_type,
-		       rohc_get_packet_descr(last_packet_info.packet_type),
-		       last_packet_info.total_last_uncomp_size,
-		       last_packet_info.header_last_uncomp_size,
-		       last_packet_info.total_last_comp_size,
-		       last_packet_info.header_last_comp_size);
+		       pkt_info.context_mode,
+		       rohc_get_mode_descr(pkt_info.context_mode),
+		       pkt_info.context_state,
+		       rohc_decomp_get_state_descr(pkt_info.context_state),
+		       pkt_info.packet_type,
+		       rohc_get_packet_descr(pkt_info.packet_type),
+		       ip_packet.len, pkt_info.uncomp_hdr_len,
+		       rohc_packet.len, pkt_info.hdr_len);
 		fflush(stdout);
 	}
 
@@ -1191,6 +1759,744 @@ error:
 }
 
 
+/**
+ * @brief Create one ROHC decompressor for the statistics
+ *
+ * @param cid_type       The type of CIDs the decompressor shall use
+ * @param max_contexts   The maximum number of ROHC contexts to use
+ * @return               The new decompressor, NULL in case of failure
+ */
+static struct rohc_decomp * create_decomp(const rohc_cid_type_t cid_type,
+                                          const unsigned int max_contexts)
+{
+	struct rohc_decomp *decomp;
+
+	/* create the ROHC decompressor */
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto error;
+	}
+
+	/* enable traces in verbose mode */
+	if(verbosity == VERBOSITY_FULL)
+	{
+		/* set the callback for traces on decompressor */
+		if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+		{
+			fprintf(stderr, "failed to set the callback for traces on "
+			        "decompressor\n");
+			goto destroy_decomp;
+		}
+
+		/* enable packet dump only in verbose mode */
+		if(!rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_DUMP_PACKETS))
+		{
+			fprintf(stderr, "failed to enable packet dumps\n");
+			goto destroy_decomp;
+		}
+	}
+
+	/* enable profiles */
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+/**
+ * @brief Generate one summary of ROHC (de)compression statistics with several
+ *        PCAP files
+ *
+ * The PCAP files are processed in parallel by several jobs, every file is
+ * (de)compressed with its own ROHC compressor or decompressor. The histograms
+ * of all the files are printed once all the files are processed.
+ *
+ * @param action         The action to run on the packets
+ * @param cid_type       The type of CIDs the (de)compressors shall use
+ * @param max_contexts   The maximum number of ROHC contexts to use
+ * @param sources        The PCAP files
+ * @param sources_nr     The number of PCAP files
+ * @param jobs_nr        The number of jobs to run in parallel
+ * @param max_pkts_nr    The maximum number of packets to (de)compress per file
+ * @return               0 in case of success,
+ *                       1 in case of failure
+ */
+static int generate_summary_all(const stats_action_t action,
+                                const rohc_cid_type_t cid_type,
+                                const unsigned int max_contexts,
+                                const char *const sources[],
+                                const size_t sources_nr,
+                                const size_t jobs_nr,
+                                const size_t max_pkts_nr)
+{
+	struct stats_jobs jobs = {
+		.action = action,
+		.cid_type = cid_type,
+		.max_contexts = max_contexts,
+		.max_pkts_nr = max_pkts_nr,
+		.sources = sources,
+		.sources_nr = sources_nr,
+		.next_source = 0,
+		.is_failure = false,
+	};
+	struct stats_job job_list[STATS_JOBS_MAX];
+	struct stats_summary *summary;
+	size_t started_nr = 0;
+	size_t i;
+
+	int is_failure = 1;
+
+	if(pthread_mutex_init(&jobs.lock, NULL) != 0)
+	{
+		fprintf(stderr, "failed to initialize the lock of the jobs\n");
+		goto error;
+	}
+
+	summary = calloc(1, sizeof(struct stats_summary));
+	if(summary == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the summary\n");
+		goto destroy_lock;
+	}
+
+	/* initialize the random generator */
+	srand(time(NULL));
+
+	/* start the jobs, more jobs than files would be useless */
+	for(i = 0; i < jobs_nr && i < sources_nr; i++)
+	{
+		job_list[i].jobs = &jobs;
+		job_list[i].summary = calloc(1, sizeof(struct stats_summary));
+		if(job_list[i].summary == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for the summary of job "
+			        "#%zu\n", i + 1);
+			pthread_mutex_lock(&jobs.lock);
+			jobs.is_failure = true;
+			pthread_mutex_unlock(&jobs.lock);
+			break;
+		}
+		if(pthread_create(&job_list[i].thread, NULL, stats_job_run,
+		                  &job_list[i]) != 0)
+		{
+			fprintf(stderr, "failed to start job #%zu\n", i + 1);
+			free(job_list[i].summary);
+			pthread_mutex_lock(&jobs.lock);
+			jobs.is_failure = true;
+			pthread_mutex_unlock(&jobs.lock);
+			break;
+		}
+		started_nr++;
+	}
+
+	/* wait for the jobs, then merge their summaries */
+	for(i = 0; i < started_nr; i++)
+	{
+		pthread_join(job_list[i].thread, NULL);
+		stats_summary_merge(summary, job_list[i].summary);
+		free(job_list[i].summary);
+	}
+	if(jobs.is_failure)
+	{
+		goto free_summary;
+	}
+
+	/* output the histograms */
+	if(verbosity != VERBOSITY_NONE)
+	{
+		print_summary(summary, action);
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_summary:
+	free(summary);
+destroy_lock:
+	pthread_mutex_destroy(&jobs.lock);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run one job that generates one summary with the next free sources
+ *
+ * The job stops once all the sources are processed or once one job failed.
+ *
+ * @param arg  The job
+ * @return     Always NULL
+ */
+static void * stats_job_run(void *const arg)
+{
+	struct stats_job *const job = arg;
+	struct stats_jobs *const jobs = job->jobs;
+
+	while(true)
+	{
+		const char *source = NULL;
+
+		/* get the next free source */
+		pthread_mutex_lock(&jobs->lock);
+		if(!jobs->is_failure && jobs->next_source < jobs->sources_nr)
+		{
+			source = jobs->sources[jobs->next_source];
+			jobs->next_source++;
+		}
+		pthread_mutex_unlock(&jobs->lock);
+		if(source == NULL)
+		{
+			break;
+		}
+
+		if(generate_summary_one(jobs, source, job->summary) != 0)
+		{
+			pthread_mutex_lock(&jobs->lock);
+			jobs->is_failure = true;
+			pthread_mutex_unlock(&jobs->lock);
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Account all the packets of one PCAP file in one summary
+ *
+ * @param jobs     The parameters shared by all the jobs
+ * @param source   The PCAP file
+ * @param summary  The summary to account the packets in
+ * @return         0 in case of success,
+ *                 1 in case of failure
+ */
+static int generate_summary_one(const struct stats_jobs *const jobs,
+                                const char *const source,
+                                struct stats_summary *const summary)
+{
+	struct pcap_map map;
+	size_t link_len;
+
+	struct rohc_comp *comp = NULL;
+	struct rohc_decomp *decomp = NULL;
+
+	unsigned long num_packet;
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	int ret;
+
+	int is_failure = 1;
+
+	/* map the source PCAP file in memory */
+	if(!pcap_map_open(source, &map))
+	{
+		goto error;
+	}
+
+	/* determine the size of the link layer header */
+	if(map.linktype == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(map.linktype == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(map.linktype == LINKTYPE_RAW || map.linktype == DLT_RAW)
+	{
+		link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "%s: link layer type %u not supported in source PCAP "
+		        "file (supported = %d, %d, %u)\n", source, map.linktype,
+		        DLT_EN10MB, DLT_LINUX_SLL, LINKTYPE_RAW);
+		goto close_input;
+	}
+
+	/* every file gets its own ROHC compressor or decompressor */
+	if(jobs->action == STATS_ACTION_COMP)
+	{
+		comp = create_comp(jobs->cid_type, jobs->max_contexts);
+		if(comp == NULL)
+		{
+			goto close_input;
+		}
+	}
+	else if(jobs->action == STATS_ACTION_DECOMP)
+	{
+		decomp = create_decomp(jobs->cid_type, jobs->max_contexts);
+		if(decomp == NULL)
+		{
+			goto close_input;
+		}
+	}
+
+	/* for each packet extracted from the PCAP file, up to max_pkts_nr
+	 * packets */
+	num_packet = 0;
+	while((jobs->max_pkts_nr == 0 || num_packet < jobs->max_pkts_nr) &&
+	      pcap_map_next(&map, &header, &packet))
+	{
+		num_packet++;
+
+		/* (de)compress the packet and account it in the summary */
+		if(jobs->action == STATS_ACTION_COMP)
+		{
+			ret = generate_comp_stats_one(comp, num_packet, header, packet,
+			                              link_len, summary);
+		}
+		else if(jobs->action == STATS_ACTION_DECOMP)
+		{
+			ret = generate_decomp_stats_one(decomp, num_packet, header, packet,
+			                                link_len, summary, NULL);
+		}
+		else
+		{
+			ret = generate_dummy_stats_one(num_packet, header, packet, link_len,
+			                               summary);
+		}
+		if(ret != 0)
+		{
+			fprintf(stderr, "%s: packet %lu: failed to generate stats for "
+			        "packet\n", source, num_packet);
+			goto destroy_rohc;
+		}
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_rohc:
+	if(decomp != NULL)
+	{
+		rohc_decomp_free(decomp);
+	}
+	if(comp != NULL)
+	{
+		rohc_comp_free(comp);
+	}
+close_input:
+	pcap_map_close(&map);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Account one packet in one summary
+ *
+ * @param summary         The summary
+ * @param profile_id      The profile used for the packet, -1 if none
+ * @param cid             The CID used for the packet, -1 if none
+ * @param mode            The mode of the context used for the packet,
+ *                        -1 if none
+ * @param state           The state of the context used for the packet,
+ *                        -1 if none
+ * @param packet_type     The type of ROHC packet
+ * @param uncomp_len      The length of the uncompressed packet
+ * @param uncomp_hdr_len  The length of the uncompressed headers
+ * @param comp_len        The length of the compressed packet
+ * @param comp_hdr_len    The length of the compressed headers
+ */
+static void stats_summary_add(struct stats_summary *const summary,
+                              const int profile_id,
+                              const int cid,
+                              const int mode,
+                              const int state,
+                              const int packet_type,
+                              const size_t uncomp_len,
+                              const size_t uncomp_hdr_len,
+                              const size_t comp_len,
+                              const size_t comp_hdr_len)
+{
+	struct stats_bucket *buckets[6];
+	size_t buckets_nr = 0;
+	size_t i;
+
+	buckets[buckets_nr++] = &summary->total;
+	if(profile_id >= 0 && profile_id < ROHC_PROFILE_MAX)
+	{
+		buckets[buckets_nr++] = &summary->per_profile[profile_id];
+	}
+	if(cid >= 0 && cid <= ROHC_LARGE_CID_MAX)
+	{
+		buckets[buckets_nr++] = &summary->per_cid[cid];
+	}
+	if(mode >= 0 && mode <= ROHC_R_MODE)
+	{
+		buckets[buckets_nr++] = &summary->per_mode[mode];
+	}
+	if(state >= 0 && state <= ROHC_COMP_STATE_CR)
+	{
+		buckets[buckets_nr++] = &summary->per_state[state];
+	}
+	if(packet_type >= 0 && packet_type < ROHC_PACKET_MAX)
+	{
+		buckets[buckets_nr++] = &summary->per_pkt_type[packet_type];
+	}
+
+	for(i = 0; i < buckets_nr; i++)
+	{
+		buckets[i]->pkts_nr++;
+		buckets[i]->uncomp_len += uncomp_len;
+		buckets[i]->uncomp_hdr_len += uncomp_hdr_len;
+		buckets[i]->comp_len += comp_len;
+		buckets[i]->comp_hdr_len += comp_hdr_len;
+	}
+}
+
+
+/**
+ * @brief Add the buckets of one summary to the buckets of another one
+ *
+ * @param buckets  The buckets to add to
+ * @param others   The buckets to add
+ * @param nr       The number of buckets
+ */
+static void stats_buckets_merge(struct stats_bucket *const buckets,
+                                const struct stats_bucket *const others,
+                                const size_t nr)
+{
+	size_t i;
+
+	for(i = 0; i < nr; i++)
+	{
+		buckets[i].pkts_nr += others[i].pkts_nr;
+		buckets[i].uncomp_len += others[i].uncomp_len;
+		buckets[i].uncomp_hdr_len += others[i].uncomp_hdr_len;
+		buckets[i].comp_len += others[i].comp_len;
+		buckets[i].comp_hdr_len += others[i].comp_hdr_len;
+	}
+}
+
+
+/**
+ * @brief Add one summary to another one
+ *
+ * @param summary  The summary to add to
+ * @param other    The summary to add
+ */
+static void stats_summary_merge(struct stats_summary *const summary,
+                                const struct stats_summary *const other)
+{
+	stats_buckets_merge(&summary->total, &other->total, 1);
+	stats_buckets_merge(summary->per_profile, other->per_profile,
+	                    ROHC_PROFILE_MAX);
+	stats_buckets_merge(summary->per_mode, other->per_mode, ROHC_R_MODE + 1);
+	stats_buckets_merge(summary->per_state, other->per_state,
+	                    ROHC_COMP_STATE_CR + 1);
+	stats_buckets_merge(summary->per_pkt_type, other->per_pkt_type,
+	                    ROHC_PACKET_MAX);
+	stats_buckets_merge(summary->per_cid, other->per_cid,
+	                    ROHC_LARGE_CID_MAX + 1);
+}
+
+
+/**
+ * @brief Print the histograms of one summary
+ *
+ * Only the non-empty buckets are printed.
+ *
+ * @param summary  The summary
+ * @param action   The action that generated the summary
+ */
+static void print_summary(const struct stats_summary *const summary,
+                          const stats_action_t action)
+{
+	size_t i;
+
+	printf("HIST\t"
+	       "\"histogram\"\t"
+	       "\"ID\"\t"
+	       "\"name\"\t"
+	       "\"packets\"\t"
+	       "\"uncompressed packet size (bytes)\"\t"
+	       "\"uncompressed header size (bytes)\"\t"
+	       "\"compressed packet size (bytes)\"\t"
+	       "\"compressed header size (bytes)\"\n");
+
+	print_summary_bucket("total", 0, "all", &summary->total);
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(summary->per_profile[i].pkts_nr > 0)
+		{
+			print_summary_bucket("profile", i, get_profile_descr(i),
+			                     &summary->per_profile[i]);
+		}
+	}
+	for(i = 0; i <= ROHC_R_MODE; i++)
+	{
+		if(summary->per_mode[i].pkts_nr > 0)
+		{
+			print_summary_bucket("mode", i, rohc_get_mode_descr(i),
+			                     &summary->per_mode[i]);
+		}
+	}
+	for(i = 0; i <= ROHC_COMP_STATE_CR; i++)
+	{
+		if(summary->per_state[i].pkts_nr > 0)
+		{
+			print_summary_bucket("state", i,
+			                     (action == STATS_ACTION_DECOMP ?
+			                      rohc_decomp_get_state_descr(i) :
+			                      rohc_comp_get_state_descr(i)),
+			                     &summary->per_state[i]);
+		}
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(summary->per_pkt_type[i].pkts_nr > 0)
+		{
+			print_summary_bucket("packet_type", i, rohc_get_packet_descr(i),
+			                     &summary->per_pkt_type[i]);
+		}
+	}
+	for(i = 0; i <= ROHC_LARGE_CID_MAX; i++)
+	{
+		if(summary->per_cid[i].pkts_nr > 0)
+		{
+			char cid_name[16];
+			snprintf(cid_name, sizeof(cid_name), "CID_%zu", i);
+			print_summary_bucket("context", i, cid_name, &summary->per_cid[i]);
+		}
+	}
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Print one bucket of one histogram
+ *
+ * @param histogram  The name of the histogram
+ * @param id         The numeric ID of the bucket
+ * @param name       The name of the bucket (no whitespace)
+ * @param bucket     The bucket
+ */
+static void print_summary_bucket(const char *const histogram,
+                                 const unsigned int id,
+                                 const char *const name,
+                                 const struct stats_bucket *const bucket)
+{
+	printf("HIST\t%s\t%u\t%s\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\t%" PRIu64
+	       "\t%" PRIu64 "\n", histogram, id, name, bucket->pkts_nr,
+	       bucket->uncomp_len, bucket->uncomp_hdr_len, bucket->comp_len,
+	       bucket->comp_hdr_len);
+}
+
+
+/**
+ * @brief Get a string that describes the given profile
+ *
+ * @param profile_id  The ID of the profile
+ * @return            The description of the profile (no whitespace)
+ */
+static const char * get_profile_descr(const unsigned int profile_id)
+{
+	switch(profile_id)
+	{
+		case ROHCv1_PROFILE_UNCOMPRESSED:
+			return "ROHCv1/Uncompressed";
+		case ROHCv1_PROFILE_IP_UDP_RTP:
+			return "ROHCv1/IP/UDP/RTP";
+		case ROHCv1_PROFILE_IP_UDP:
+			return "ROHCv1/IP/UDP";
+		case ROHCv1_PROFILE_IP_ESP:
+			return "ROHCv1/IP/ESP";
+		case ROHCv1_PROFILE_IP:
+			return "ROHCv1/IP";
+		case ROHCv1_PROFILE_IP_UDP_RTP_LLA:
+			return "ROHCv1/IP/UDP/RTP/LLA";
+		case ROHCv1_PROFILE_IP_TCP:
+			return "ROHCv1/IP/TCP";
+		case ROHCv1_PROFILE_IP_UDPLITE_RTP:
+			return "ROHCv1/IP/UDP-Lite/RTP";
+		case ROHCv1_PROFILE_IP_UDPLITE:
+			return "ROHCv1/IP/UDP-Lite";
+		case ROHCv2_PROFILE_IP_UDP_RTP:
+			return "ROHCv2/IP/UDP/RTP";
+		case ROHCv2_PROFILE_IP_UDP:
+			return "ROHCv2/IP/UDP";
+		case ROHCv2_PROFILE_IP_ESP:
+			return "ROHCv2/IP/ESP";
+		case ROHCv2_PROFILE_IP:
+			return "ROHCv2/IP";
+		case ROHCv2_PROFILE_IP_UDPLITE_RTP:
+			return "ROHCv2/IP/UDP-Lite/RTP";
+		case ROHCv2_PROFILE_IP_UDPLITE:
+			return "ROHCv2/IP/UDP-Lite";
+		default:
+			return "unknown";
+	}
+}
+
+
+/**
+ * @brief Map one PCAP file in memory
+ *
+ * @param path      The path to the PCAP file
+ * @param[out] map  The PCAP file mapped in memory
+ * @return          true if the file was mapped, false otherwise
+ */
+static bool pcap_map_open(const char *const path,
+                          struct pcap_map *const map)
+{
+	struct pcap_file_hdr hdr;
+	struct stat file_stat;
+	void *data;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to open PCAP file '%s': %s (%d)\n", path,
+		        strerror(errno), errno);
+		goto error;
+	}
+	if(fstat(fd, &file_stat) != 0)
+	{
+		fprintf(stderr, "failed to get information for file '%s': %s (%d)\n",
+		        path, strerror(errno), errno);
+		goto close_file;
+	}
+	if(file_stat.st_size < (off_t) sizeof(struct pcap_file_hdr))
+	{
+		fprintf(stderr, "file '%s' is too short for a PCAP file\n", path);
+		goto close_file;
+	}
+
+	data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(data == MAP_FAILED)
+	{
+		fprintf(stderr, "failed to map PCAP file '%s': %s (%d)\n", path,
+		        strerror(errno), errno);
+		goto close_file;
+	}
+	map->data = data;
+	map->len = file_stat.st_size;
+
+	/* the file is read once from the beginning to the end */
+	(void) madvise(data, map->len, MADV_SEQUENTIAL);
+
+	/* the magic number tells the byte order and the timestamp unit */
+	memcpy(&hdr, map->data, sizeof(struct pcap_file_hdr));
+	if(hdr.magic == PCAP_MAGIC_USEC || hdr.magic == PCAP_MAGIC_NSEC)
+	{
+		map->is_swapped = false;
+	}
+	else if(__builtin_bswap32(hdr.magic) == PCAP_MAGIC_USEC ||
+	        __builtin_bswap32(hdr.magic) == PCAP_MAGIC_NSEC)
+	{
+		map->is_swapped = true;
+	}
+	else
+	{
+		fprintf(stderr, "file '%s' is not a PCAP file\n", path);
+		goto unmap_file;
+	}
+	map->is_nsec = (pcap_map_u32(map, hdr.magic) == PCAP_MAGIC_NSEC);
+	map->linktype = pcap_map_u32(map, hdr.linktype);
+	map->offset = sizeof(struct pcap_file_hdr);
+
+	close(fd);
+	return true;
+
+unmap_file:
+	munmap(data, map->len);
+close_file:
+	close(fd);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the next packet of one PCAP file mapped in memory
+ *
+ * A truncated packet record at the end of the file ends the file, as
+ * pcap_next() does.
+ *
+ * @param map          The PCAP file mapped in memory
+ * @param[out] header  The PCAP header for the packet
+ * @param[out] packet  The packet (link layer included), in the mapped file
+ * @return             true if one packet was found, false at the end of file
+ */
+static bool pcap_map_next(struct pcap_map *const map,
+                          struct pcap_pkthdr *const header,
+                          const unsigned char **const packet)
+{
+	struct pcap_rec_hdr rec;
+	uint32_t caplen;
+
+	if((map->len - map->offset) < sizeof(struct pcap_rec_hdr))
+	{
+		goto end_of_file;
+	}
+	memcpy(&rec, map->data + map->offset, sizeof(struct pcap_rec_hdr));
+	caplen = pcap_map_u32(map, rec.caplen);
+	if(caplen > (map->len - map->offset - sizeof(struct pcap_rec_hdr)))
+	{
+		goto end_of_file;
+	}
+	map->offset += sizeof(struct pcap_rec_hdr);
+
+	header->ts.tv_sec = pcap_map_u32(map, rec.ts_sec);
+	header->ts.tv_usec = pcap_map_u32(map, rec.ts_frac);
+	if(map->is_nsec)
+	{
+		header->ts.tv_usec /= 1000;
+	}
+	header->caplen = caplen;
+	header->len = pcap_map_u32(map, rec.len);
+	*packet = map->data + map->offset;
+	map->offset += caplen;
+
+	return true;
+
+end_of_file:
+	return false;
+}
+
+
+/**
+ * @brief Unmap one PCAP file from memory
+ *
+ * @param map  The PCAP file mapped in memory
+ */
+static void pcap_map_close(struct pcap_map *const map)
+{
+	munmap((void *) map->data, map->len);
+	map->data = NULL;
+	map->len = 0;
+}
+
+
+/**
+ * @brief Get one 32-bit field of one PCAP file in the host byte order
+ *
+ * @param map    The PCAP file mapped in memory
+ * @param value  The 32-bit field in the byte order of the file
+ * @return       The 32-bit field in the host byte order
+ */
+static uint32_t pcap_map_u32(const struct pcap_map *const map,
+                             const uint32_t value)
+{
+	return (map->is_swapped ? __builtin_bswap32(value) : value);
+}
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
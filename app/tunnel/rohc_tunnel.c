@@ -0,0 +1,1168 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_tunnel.c
+ * @brief  ROHC-over-UDP tunnel between two TUN interfaces
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The program creates one multiqueue TUN interface and runs several worker
+ * threads. Every worker thread owns one queue of the TUN interface, one UDP
+ * socket, one shard of a group of ROHC compressors, and one ROHC
+ * decompressor:
+ *  - the IP packets read from the TUN queue are compressed in bursts, then
+ *    sent in bursts to the remote tunnel endpoint with sendmmsg(2),
+ *  - the ROHC packets received in bursts with recvmmsg(2) are decompressed in
+ *    bursts, then written to the TUN queue.
+ *
+ * The worker thread #i sends to the UDP port #i of the remote endpoint, and
+ * receives on its own UDP port #i. Both tunnel endpoints shall thus run with
+ * the same number of threads and the same CID space: the ROHC packets
+ * received by thread #i are the ones of the compressor shard #i of the remote
+ * endpoint, and the feedbacks received by thread #i are the ones for its own
+ * compressor shard. The decompressor and the compressor of every thread share
+ * one ring of feedbacks, so the feedbacks are piggybacked on the return
+ * traffic without any lock. If no IP packet is compressed for a while, the
+ * feedbacks are sent in feedback-only ROHC packets.
+ */
+
+#include "config.h" /* for PACKAGE_BUGREPORT */
+
+/* system includes */
+#define _GNU_SOURCE /* for recvmmsg(2) and sendmmsg(2) */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h> /* for PRIu64 */
+#include <time.h> /* for clock_gettime(2) */
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The maximum number of worker threads */
+#define TUNNEL_THREADS_MAX  64U
+
+/** The maximum number of packets read, compressed or sent at once */
+#define TUNNEL_BURST_MAX  64U
+
+/** The maximum length (in bytes) of the IP packets */
+#define TUNNEL_PKT_MAX_LEN  2048U
+
+/** The maximum length (in bytes) of the ROHC packets, piggybacked feedbacks
+ *  included */
+#define TUNNEL_ROHC_MAX_LEN  (TUNNEL_PKT_MAX_LEN + 512U)
+
+/** The number of slots of the feedback ring of every thread */
+#define TUNNEL_FEEDBACK_SLOTS  256U
+
+/** The delay (in milliseconds) before the waiting feedbacks are sent in a
+ *  feedback-only ROHC packet */
+#define TUNNEL_FEEDBACK_DELAY_MS  5U
+
+
+/** The parameters of the tunnel */
+struct tunnel_params
+{
+	const char *tun_name;          /**< The name of the TUN interface */
+	struct sockaddr_in local;      /**< The first local UDP endpoint */
+	struct sockaddr_in remote;     /**< The first remote UDP endpoint */
+	size_t threads_nr;             /**< The number of worker threads */
+	size_t burst_len;              /**< The number of packets per burst */
+	rohc_cid_t max_cid;            /**< The largest CID of the channel */
+	unsigned int stats_period;     /**< The period of the statistics (s) */
+	bool use_rohcv2;               /**< Whether to use the ROHCv2 profiles */
+};
+
+/** The statistics of one worker thread */
+struct tunnel_stats
+{
+	uint64_t tun_rx;             /**< The IP packets read from TUN */
+	uint64_t tun_rx_bytes;       /**< The bytes read from TUN */
+	uint64_t udp_tx;             /**< The ROHC packets sent */
+	uint64_t udp_tx_bytes;       /**< The bytes of ROHC packets sent */
+	uint64_t udp_rx;             /**< The ROHC packets received */
+	uint64_t tun_tx;             /**< The IP packets written to TUN */
+	uint64_t feedbacks_only;     /**< The feedback-only packets sent */
+	uint64_t comp_failures;      /**< The packets that failed compression */
+	uint64_t decomp_failures;    /**< The packets that failed decompression */
+	uint64_t io_failures;        /**< The packets lost on I/O errors */
+	uint64_t comp_ns;            /**< The time spent in compression bursts */
+	uint64_t decomp_ns;          /**< The time spent in decompression bursts */
+	uint64_t comp_lat_max_ns;    /**< The longest TUN-to-UDP burst latency */
+	uint64_t decomp_lat_max_ns;  /**< The longest UDP-to-TUN burst latency */
+};
+
+/** The context of one worker thread */
+struct tunnel_worker
+{
+	size_t idx;                      /**< The index of the thread */
+	pthread_t thread;                /**< The thread */
+	bool is_started;                 /**< Whether the thread was started */
+	int tun_fd;                      /**< The TUN queue of the thread */
+	int udp_fd;                      /**< The UDP socket of the thread */
+	struct rohc_comp *comp;          /**< The compressor shard */
+	struct rohc_decomp *decomp;      /**< The decompressor */
+	struct rohc_feedback_ring *ring; /**< The feedbacks of the thread */
+	const struct tunnel_params *params; /**< The parameters of the tunnel */
+
+	/** The IP packets and the ROHC packets of one burst */
+	uint8_t ip_data[TUNNEL_BURST_MAX][TUNNEL_PKT_MAX_LEN];
+	uint8_t rohc_data[TUNNEL_BURST_MAX][TUNNEL_ROHC_MAX_LEN];
+	struct rohc_buf ip_pkts[TUNNEL_BURST_MAX];
+	struct rohc_buf rohc_pkts[TUNNEL_BURST_MAX];
+	rohc_status_t statuses[TUNNEL_BURST_MAX];
+	struct mmsghdr msgs[TUNNEL_BURST_MAX];
+	struct iovec iovs[TUNNEL_BURST_MAX];
+
+	/** The time of the last ROHC packet sent */
+	uint64_t last_tx_ns;
+
+	/** The statistics, updated by the worker thread only */
+	struct tunnel_stats stats;
+};
+
+
+/** Whether the program shall stop */
+static volatile sig_atomic_t stop_program = 0;
+
+
+static void usage(void);
+static bool tunnel_parse_endpoint(const char *const str,
+                                  struct sockaddr_in *const addr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static int tunnel_open_tun(const char *const name, const bool multi_queue)
+	__attribute__((warn_unused_result, nonnull(1)));
+static int tunnel_open_udp(const struct tunnel_params *const params,
+                           const size_t idx)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool tunnel_init_worker(struct tunnel_worker *const worker,
+                               const struct tunnel_params *const params,
+                               struct rohc_comp_group *const group,
+                               const size_t idx)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void tunnel_free_worker(struct tunnel_worker *const worker)
+	__attribute__((nonnull(1)));
+static void * tunnel_worker_main(void *arg)
+	__attribute__((nonnull(1)));
+static void tunnel_tun_to_udp(struct tunnel_worker *const worker)
+	__attribute__((nonnull(1)));
+static void tunnel_udp_to_tun(struct tunnel_worker *const worker)
+	__attribute__((nonnull(1)));
+static void tunnel_flush_feedbacks(struct tunnel_worker *const worker)
+	__attribute__((nonnull(1)));
+static void tunnel_send_burst(struct tunnel_worker *const worker,
+                              const size_t pkts_nr)
+	__attribute__((nonnull(1)));
+static void tunnel_print_stats(const struct tunnel_worker *const workers,
+                               const size_t workers_nr,
+                               const double period)
+	__attribute__((nonnull(1)));
+static uint64_t tunnel_get_ns(void)
+	__attribute__((warn_unused_result));
+static struct rohc_ts tunnel_get_ts(void)
+	__attribute__((warn_unused_result));
+static int tunnel_gen_random_num(const struct rohc_comp *const comp,
+                                 void *const user_context)
+	__attribute__((nonnull(1)));
+static void tunnel_stop(int signum);
+
+
+/**
+ * @brief Main function for the ROHC tunnel program
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct tunnel_params params = {
+		.tun_name = "rohc0",
+		.threads_nr = 1,
+		.burst_len = 32,
+		.max_cid = ROHC_SMALL_CID_MAX,
+		.stats_period = 0,
+		.use_rohcv2 = false,
+	};
+	bool local_set = false;
+	bool remote_set = false;
+	struct tunnel_worker *workers;
+	struct rohc_comp_group *group;
+	rohc_cid_type_t cid_type;
+	uint64_t last_stats_ns;
+	size_t i;
+	int status = 1;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_tunnel version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "--tun") ||
+		        !strcmp(*argv, "--local") ||
+		        !strcmp(*argv, "--remote") ||
+		        !strcmp(*argv, "--threads") ||
+		        !strcmp(*argv, "--burst") ||
+		        !strcmp(*argv, "--max-cid") ||
+		        !strcmp(*argv, "--stats"))
+		{
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory %s parameter\n", argv[0]);
+				usage();
+				goto error;
+			}
+			if(!strcmp(*argv, "--tun"))
+			{
+				/* get the name of the TUN interface */
+				params.tun_name = argv[1];
+			}
+			else if(!strcmp(*argv, "--local"))
+			{
+				/* get the first local UDP endpoint */
+				if(!tunnel_parse_endpoint(argv[1], &params.local))
+				{
+					fprintf(stderr, "malformed local endpoint '%s'\n\n", argv[1]);
+					usage();
+					goto error;
+				}
+				local_set = true;
+			}
+			else if(!strcmp(*argv, "--remote"))
+			{
+				/* get the first remote UDP endpoint */
+				if(!tunnel_parse_endpoint(argv[1], &params.remote))
+				{
+					fprintf(stderr, "malformed remote endpoint '%s'\n\n", argv[1]);
+					usage();
+					goto error;
+				}
+				remote_set = true;
+			}
+			else if(!strcmp(*argv, "--threads"))
+			{
+				/* get the number of worker threads */
+				params.threads_nr = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--burst"))
+			{
+				/* get the number of packets per burst */
+				params.burst_len = strtoul(argv[1], NULL, 10);
+			}
+			else if(!strcmp(*argv, "--max-cid"))
+			{
+				/* get the largest CID of the channel */
+				params.max_cid = strtoul(argv[1], NULL, 10);
+			}
+			else
+			{
+				/* get the period of the statistics */
+				params.stats_period = strtoul(argv[1], NULL, 10);
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--rohcv2"))
+		{
+			/* use the ROHCv2 profiles instead of the ROHCv1 ones */
+			params.use_rohcv2 = true;
+		}
+		else
+		{
+			fprintf(stderr, "unexpected argument '%s'\n\n", *argv);
+			usage();
+			goto error;
+		}
+	}
+
+	/* check the parameters */
+	if(!local_set || !remote_set)
+	{
+		fprintf(stderr, "both the local and remote endpoints are required\n\n");
+		usage();
+		goto error;
+	}
+	if(params.threads_nr < 1 || params.threads_nr > TUNNEL_THREADS_MAX)
+	{
+		fprintf(stderr, "the number of threads should be between 1 and %u\n\n",
+		        TUNNEL_THREADS_MAX);
+		usage();
+		goto error;
+	}
+	if(params.burst_len < 1 || params.burst_len > TUNNEL_BURST_MAX)
+	{
+		fprintf(stderr, "the number of packets per burst should be between 1 "
+		        "and %u\n\n", TUNNEL_BURST_MAX);
+		usage();
+		goto error;
+	}
+	if(params.max_cid > ROHC_LARGE_CID_MAX ||
+	   params.max_cid < (params.threads_nr - 1))
+	{
+		fprintf(stderr, "the largest CID should be between the number of "
+		        "threads minus one and %u\n\n", ROHC_LARGE_CID_MAX);
+		usage();
+		goto error;
+	}
+	cid_type = (params.max_cid > ROHC_SMALL_CID_MAX ?
+	            ROHC_LARGE_CID : ROHC_SMALL_CID);
+
+	signal(SIGINT, tunnel_stop);
+	signal(SIGTERM, tunnel_stop);
+
+	/* one compressor shard per thread, every shard has its own CIDs */
+	group = rohc_comp_group_new(cid_type, params.max_cid, params.threads_nr,
+	                            tunnel_gen_random_num, NULL);
+	if(group == NULL)
+	{
+		fprintf(stderr, "failed to create the group of ROHC compressors\n");
+		goto error;
+	}
+
+	workers = calloc(params.threads_nr, sizeof(struct tunnel_worker));
+	if(workers == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the threads\n");
+		goto free_group;
+	}
+	for(i = 0; i < params.threads_nr; i++)
+	{
+		workers[i].tun_fd = -1;
+		workers[i].udp_fd = -1;
+	}
+	for(i = 0; i < params.threads_nr; i++)
+	{
+		if(!tunnel_init_worker(&workers[i], &params, group, i))
+		{
+			goto free_workers;
+		}
+	}
+
+	printf("tunnel %s: %zu threads, CIDs 0-%u, local %s:%u\n", params.tun_name,
+	       params.threads_nr, params.max_cid, inet_ntoa(params.local.sin_addr),
+	       ntohs(params.local.sin_port));
+
+	for(i = 0; i < params.threads_nr; i++)
+	{
+		if(pthread_create(&workers[i].thread, NULL, tunnel_worker_main,
+		                  &workers[i]) != 0)
+		{
+			fprintf(stderr, "failed to start thread #%zu\n", i + 1);
+			stop_program = 1;
+			goto stop_workers;
+		}
+		workers[i].is_started = true;
+	}
+
+	/* print the statistics periodically until the program is stopped */
+	last_stats_ns = tunnel_get_ns();
+	while(!stop_program)
+	{
+		const struct timespec delay = { .tv_sec = 0, .tv_nsec = 100000000 };
+		uint64_t now_ns;
+
+		nanosleep(&delay, NULL);
+		now_ns = tunnel_get_ns();
+		if(params.stats_period > 0 &&
+		   (now_ns - last_stats_ns) >= (params.stats_period * 1000000000ULL))
+		{
+			tunnel_print_stats(workers, params.threads_nr,
+			                   (now_ns - last_stats_ns) / 1e9);
+			last_stats_ns = now_ns;
+		}
+	}
+	status = 0;
+
+stop_workers:
+	for(i = 0; i < params.threads_nr; i++)
+	{
+		if(workers[i].is_started)
+		{
+			pthread_join(workers[i].thread, NULL);
+		}
+	}
+	if(status == 0 && params.stats_period > 0)
+	{
+		tunnel_print_stats(workers, params.threads_nr,
+		                   (tunnel_get_ns() - last_stats_ns) / 1e9);
+	}
+free_workers:
+	for(i = 0; i < params.threads_nr; i++)
+	{
+		tunnel_free_worker(&workers[i]);
+	}
+	free(workers);
+free_group:
+	rohc_comp_group_free(group);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the tunnel program
+ */
+static void usage(void)
+{
+	printf("The ROHC tunnel tool carries the IP packets of one TUN interface\n"
+	       "over ROHC over UDP\n"
+	       "\n"
+	       "The rohc_tunnel tool creates one multiqueue TUN interface, and\n"
+	       "runs one worker thread per queue. Every thread compresses the IP\n"
+	       "packets of its queue and sends them to the remote endpoint, and\n"
+	       "decompresses the ROHC packets it receives. Thread #i uses the\n"
+	       "UDP port of the endpoints plus i, so both endpoints shall run\n"
+	       "with the same number of threads and the same largest CID.\n"
+	       "\n"
+	       "With --stats, the tool periodically outputs one line per thread\n"
+	       "with the packets per second in both directions, the compression\n"
+	       "ratio, the mean time to compress and decompress one packet, and\n"
+	       "the longest latency of one burst from TUN to UDP and from UDP\n"
+	       "to TUN.\n"
+	       "\n"
+	       "Usage: rohc_tunnel [OPTIONS] --local ADDR:PORT --remote ADDR:PORT\n"
+	       "\n"
+	       "Options:\n"
+	       "  -v, --version             Print version information and exit\n"
+	       "  -h, --help                Print this usage and exit\n"
+	       "      --tun NAME            The name of the TUN interface\n"
+	       "                            (default rohc0)\n"
+	       "      --local ADDR:PORT     The first local UDP endpoint\n"
+	       "      --remote ADDR:PORT    The first remote UDP endpoint\n"
+	       "      --threads NUM         The number of worker threads, from 1\n"
+	       "                            to %u (default 1)\n"
+	       "      --burst NUM           The number of packets per burst, from\n"
+	       "                            1 to %u (default 32)\n"
+	       "      --max-cid NUM         The largest CID of the channel\n"
+	       "                            (default 15)\n"
+	       "      --stats SECONDS       Print statistics every SECONDS\n"
+	       "                            (default 0, ie. never)\n"
+	       "      --rohcv2              Use the ROHCv2 profiles if possible\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_tunnel --local 192.168.0.1:5000 --remote 192.168.0.2:5000\n"
+	       "  rohc_tunnel --threads 4 --max-cid 1023 --stats 1 \\\n"
+	       "              --local 192.168.0.1:5000 --remote 192.168.0.2:5000\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       TUNNEL_THREADS_MAX, TUNNEL_BURST_MAX);
+}
+
+
+/**
+ * @brief Parse one IPv4 UDP endpoint
+ *
+ * @param str        The endpoint, formatted as ADDR:PORT
+ * @param[out] addr  The parsed endpoint
+ * @return           true if the endpoint is well-formed, false otherwise
+ */
+static bool tunnel_parse_endpoint(const char *const str,
+                                  struct sockaddr_in *const addr)
+{
+	char host[INET_ADDRSTRLEN];
+	const char *const colon = strrchr(str, ':');
+	unsigned long port;
+	char *end;
+
+	if(colon == NULL || ((size_t) (colon - str)) >= INET_ADDRSTRLEN)
+	{
+		goto error;
+	}
+	memcpy(host, str, colon - str);
+	host[colon - str] = '\0';
+
+	port = strtoul(colon + 1, &end, 10);
+	if((*end) != '\0' || port < 1 || port > 0xffff)
+	{
+		goto error;
+	}
+
+	memset(addr, 0, sizeof(struct sockaddr_in));
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	if(inet_pton(AF_INET, host, &addr->sin_addr) != 1)
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Open one queue of the TUN interface
+ *
+ * @param name         The name of the TUN interface
+ * @param multi_queue  Whether the interface has several queues
+ * @return             The file descriptor of the queue, -1 in case of error
+ */
+static int tunnel_open_tun(const char *const name, const bool multi_queue)
+{
+	struct ifreq ifr;
+	int fd;
+
+	fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to open /dev/net/tun: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	memset(&ifr, 0, sizeof(struct ifreq));
+	ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+	if(multi_queue)
+	{
+		ifr.ifr_flags |= IFF_MULTI_QUEUE;
+	}
+	strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+	if(ioctl(fd, TUNSETIFF, &ifr) != 0)
+	{
+		fprintf(stderr, "failed to create the TUN interface %s: %s (%d)\n",
+		        name, strerror(errno), errno);
+		goto close_fd;
+	}
+
+	return fd;
+
+close_fd:
+	close(fd);
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Open the UDP socket of one worker thread
+ *
+ * The socket is bound to the first local endpoint plus the index of the
+ * thread, and connected to the first remote endpoint plus the index of the
+ * thread.
+ *
+ * @param params  The parameters of the tunnel
+ * @param idx     The index of the thread
+ * @return        The file descriptor of the socket, -1 in case of error
+ */
+static int tunnel_open_udp(const struct tunnel_params *const params,
+                           const size_t idx)
+{
+	struct sockaddr_in local = params->local;
+	struct sockaddr_in remote = params->remote;
+	int fd;
+
+	local.sin_port = htons(ntohs(params->local.sin_port) + idx);
+	remote.sin_port = htons(ntohs(params->remote.sin_port) + idx);
+
+	fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to create the UDP socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+	if(bind(fd, (struct sockaddr *) &local, sizeof(struct sockaddr_in)) != 0)
+	{
+		fprintf(stderr, "failed to bind the UDP socket to port %u: %s (%d)\n",
+		        ntohs(local.sin_port), strerror(errno), errno);
+		goto close_fd;
+	}
+	if(connect(fd, (struct sockaddr *) &remote, sizeof(struct sockaddr_in)) != 0)
+	{
+		fprintf(stderr, "failed to connect the UDP socket to port %u: %s (%d)\n",
+		        ntohs(remote.sin_port), strerror(errno), errno);
+		goto close_fd;
+	}
+
+	return fd;
+
+close_fd:
+	close(fd);
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Create the resources of one worker thread
+ *
+ * @param worker  The worker thread
+ * @param params  The parameters of the tunnel
+ * @param group   The group of ROHC compressors
+ * @param idx     The index of the worker thread
+ * @return        true if the worker thread is ready, false otherwise
+ */
+static bool tunnel_init_worker(struct tunnel_worker *const worker,
+                               const struct tunnel_params *const params,
+                               struct rohc_comp_group *const group,
+                               const size_t idx)
+{
+	const rohc_cid_type_t cid_type =
+		(params->max_cid > ROHC_SMALL_CID_MAX ? ROHC_LARGE_CID : ROHC_SMALL_CID);
+	bool is_ok;
+
+	worker->idx = idx;
+	worker->params = params;
+
+	worker->tun_fd = tunnel_open_tun(params->tun_name, params->threads_nr > 1);
+	if(worker->tun_fd < 0)
+	{
+		goto error;
+	}
+	worker->udp_fd = tunnel_open_udp(params, idx);
+	if(worker->udp_fd < 0)
+	{
+		goto error;
+	}
+
+	/* the compressor shard of the thread, there is no ROHCv2 profile for TCP */
+	worker->comp = rohc_comp_group_get_shard(group, idx);
+	if(params->use_rohcv2)
+	{
+		is_ok = rohc_comp_enable_profiles(worker->comp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                  ROHCv2_PROFILE_IP_UDP_RTP,
+		                                  ROHCv2_PROFILE_IP_UDP,
+		                                  ROHCv2_PROFILE_IP_ESP, ROHCv2_PROFILE_IP,
+		                                  ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	else
+	{
+		is_ok = rohc_comp_enable_profiles(worker->comp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                  ROHCv1_PROFILE_IP_UDP_RTP,
+		                                  ROHCv1_PROFILE_IP_UDP,
+		                                  ROHCv1_PROFILE_IP_ESP, ROHCv1_PROFILE_IP,
+		                                  ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	if(!is_ok)
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto error;
+	}
+
+	/* the decompressor of the thread */
+	worker->decomp = rohc_decomp_new2(cid_type, params->max_cid, ROHC_O_MODE);
+	if(worker->decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto error;
+	}
+	if(params->use_rohcv2)
+	{
+		is_ok = rohc_decomp_enable_profiles(worker->decomp,
+		                                    ROHCv1_PROFILE_UNCOMPRESSED,
+		                                    ROHCv2_PROFILE_IP_UDP_RTP,
+		                                    ROHCv2_PROFILE_IP_UDP,
+		                                    ROHCv2_PROFILE_IP_ESP,
+		                                    ROHCv2_PROFILE_IP,
+		                                    ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	else
+	{
+		is_ok = rohc_decomp_enable_profiles(worker->decomp,
+		                                    ROHCv1_PROFILE_UNCOMPRESSED,
+		                                    ROHCv1_PROFILE_IP_UDP_RTP,
+		                                    ROHCv1_PROFILE_IP_UDP,
+		                                    ROHCv1_PROFILE_IP_ESP,
+		                                    ROHCv1_PROFILE_IP,
+		                                    ROHCv1_PROFILE_IP_TCP, -1);
+	}
+	if(!is_ok)
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto error;
+	}
+
+	/* the feedbacks of the decompressor are piggybacked by the compressor */
+	worker->ring = rohc_feedback_ring_new(TUNNEL_FEEDBACK_SLOTS);
+	if(worker->ring == NULL ||
+	   !rohc_comp_set_feedback_ring(worker->comp, worker->ring) ||
+	   !rohc_decomp_set_feedback_ring(worker->decomp, worker->ring))
+	{
+		fprintf(stderr, "failed to create the ring of feedbacks\n");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the resources of one worker thread
+ *
+ * The compressor shard is released with its group, it does not use the ring
+ * of feedbacks any more once the thread is stopped.
+ *
+ * @param worker  The worker thread
+ */
+static void tunnel_free_worker(struct tunnel_worker *const worker)
+{
+	if(worker->decomp != NULL)
+	{
+		rohc_decomp_free(worker->decomp);
+	}
+	if(worker->ring != NULL)
+	{
+		rohc_feedback_ring_free(worker->ring);
+	}
+	if(worker->udp_fd >= 0)
+	{
+		close(worker->udp_fd);
+	}
+	if(worker->tun_fd >= 0)
+	{
+		close(worker->tun_fd);
+	}
+}
+
+
+/**
+ * @brief The main loop of one worker thread
+ *
+ * @param arg  The worker thread
+ * @return     Always NULL
+ */
+static void * tunnel_worker_main(void *arg)
+{
+	struct tunnel_worker *const worker = arg;
+
+	worker->last_tx_ns = tunnel_get_ns();
+
+	while(!stop_program)
+	{
+		struct pollfd fds[2] = {
+			{ .fd = worker->tun_fd, .events = POLLIN },
+			{ .fd = worker->udp_fd, .events = POLLIN },
+		};
+		int ret;
+
+		ret = poll(fds, 2, TUNNEL_FEEDBACK_DELAY_MS);
+		if(ret < 0 && errno != EINTR)
+		{
+			fprintf(stderr, "thread #%zu: poll() failed: %s (%d)\n",
+			        worker->idx + 1, strerror(errno), errno);
+			break;
+		}
+
+		if(ret > 0 && (fds[1].revents & POLLIN) != 0)
+		{
+			tunnel_udp_to_tun(worker);
+		}
+		if(ret > 0 && (fds[0].revents & POLLIN) != 0)
+		{
+			tunnel_tun_to_udp(worker);
+		}
+
+		/* do not keep the feedbacks for too long without return traffic */
+		if((tunnel_get_ns() - worker->last_tx_ns) >=
+		   (TUNNEL_FEEDBACK_DELAY_MS * 1000000ULL))
+		{
+			tunnel_flush_feedbacks(worker);
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Read a burst of IP packets from TUN, compress them and send them
+ *
+ * The feedbacks of the ring are piggybacked on the ROHC packets by the
+ * compressor.
+ *
+ * @param worker  The worker thread
+ */
+static void tunnel_tun_to_udp(struct tunnel_worker *const worker)
+{
+	const struct rohc_ts arrival_time = tunnel_get_ts();
+	uint64_t start_ns;
+	uint64_t comp_start_ns;
+	uint64_t end_ns;
+	size_t pkts_nr = 0;
+	size_t processed_nr;
+	size_t tx_nr = 0;
+	size_t i;
+
+	/* TUN gives one packet per read(2) */
+	while(pkts_nr < worker->params->burst_len)
+	{
+		const ssize_t len = read(worker->tun_fd, worker->ip_data[pkts_nr],
+		                         TUNNEL_PKT_MAX_LEN);
+		if(len <= 0)
+		{
+			break;
+		}
+		worker->ip_pkts[pkts_nr].time = arrival_time;
+		worker->ip_pkts[pkts_nr].data = worker->ip_data[pkts_nr];
+		worker->ip_pkts[pkts_nr].max_len = TUNNEL_PKT_MAX_LEN;
+		worker->ip_pkts[pkts_nr].offset = 0;
+		worker->ip_pkts[pkts_nr].len = len;
+		worker->rohc_pkts[pkts_nr].time = arrival_time;
+		worker->rohc_pkts[pkts_nr].data = worker->rohc_data[pkts_nr];
+		worker->rohc_pkts[pkts_nr].max_len = TUNNEL_ROHC_MAX_LEN;
+		worker->rohc_pkts[pkts_nr].offset = 0;
+		worker->rohc_pkts[pkts_nr].len = 0;
+		worker->stats.tun_rx_bytes += len;
+		pkts_nr++;
+	}
+	if(pkts_nr == 0)
+	{
+		return;
+	}
+	worker->stats.tun_rx += pkts_nr;
+	start_ns = tunnel_get_ns();
+
+	/* compress the burst, ROHC segmentation stops it, but the ROHC packets
+	 * are never larger than their output buffers */
+	comp_start_ns = tunnel_get_ns();
+	processed_nr = 0;
+	while(processed_nr < pkts_nr)
+	{
+		const size_t nr =
+			rohc_compress_burst(worker->comp, worker->ip_pkts + processed_nr,
+			                    worker->rohc_pkts + processed_nr,
+			                    worker->statuses + processed_nr,
+			                    pkts_nr - processed_nr);
+		if(nr == 0)
+		{
+			break;
+		}
+		processed_nr += nr;
+	}
+	worker->stats.comp_ns += tunnel_get_ns() - comp_start_ns;
+
+	/* keep the ROHC packets only */
+	for(i = 0; i < processed_nr; i++)
+	{
+		if(worker->statuses[i] != ROHC_STATUS_OK)
+		{
+			worker->stats.comp_failures++;
+			continue;
+		}
+		worker->iovs[tx_nr].iov_base = rohc_buf_data(worker->rohc_pkts[i]);
+		worker->iovs[tx_nr].iov_len = worker->rohc_pkts[i].len;
+		tx_nr++;
+	}
+	worker->stats.comp_failures += pkts_nr - processed_nr;
+
+	tunnel_send_burst(worker, tx_nr);
+
+	end_ns = tunnel_get_ns();
+	if((end_ns - start_ns) > worker->stats.comp_lat_max_ns)
+	{
+		worker->stats.comp_lat_max_ns = end_ns - start_ns;
+	}
+}
+
+
+/**
+ * @brief Receive a burst of ROHC packets, decompress them and write them
+ *
+ * The feedbacks received from the remote endpoint and the feedbacks built
+ * by the decompressor are pushed in the ring by the decompressor.
+ *
+ * @param worker  The worker thread
+ */
+static void tunnel_udp_to_tun(struct tunnel_worker *const worker)
+{
+	struct rohc_ts arrival_time;
+	uint64_t start_ns;
+	uint64_t decomp_start_ns;
+	uint64_t end_ns;
+	size_t processed_nr;
+	int rcvd_nr;
+	int i;
+
+	for(i = 0; ((size_t) i) < worker->params->burst_len; i++)
+	{
+		worker->iovs[i].iov_base = worker->rohc_data[i];
+		worker->iovs[i].iov_len = TUNNEL_ROHC_MAX_LEN;
+		memset(&worker->msgs[i], 0, sizeof(struct mmsghdr));
+		worker->msgs[i].msg_hdr.msg_iov = &worker->iovs[i];
+		worker->msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+	rcvd_nr = recvmmsg(worker->udp_fd, worker->msgs, worker->params->burst_len,
+	                   MSG_DONTWAIT, NULL);
+	if(rcvd_nr <= 0)
+	{
+		return;
+	}
+	worker->stats.udp_rx += rcvd_nr;
+	start_ns = tunnel_get_ns();
+	arrival_time = tunnel_get_ts();
+
+	for(i = 0; i < rcvd_nr; i++)
+	{
+		worker->rohc_pkts[i].time = arrival_time;
+		worker->rohc_pkts[i].data = worker->rohc_data[i];
+		worker->rohc_pkts[i].max_len = TUNNEL_ROHC_MAX_LEN;
+		worker->rohc_pkts[i].offset = 0;
+		worker->rohc_pkts[i].len = worker->msgs[i].msg_len;
+		worker->ip_pkts[i].time = arrival_time;
+		worker->ip_pkts[i].data = worker->ip_data[i];
+		worker->ip_pkts[i].max_len = TUNNEL_PKT_MAX_LEN;
+		worker->ip_pkts[i].offset = 0;
+		worker->ip_pkts[i].len = 0;
+	}
+
+	decomp_start_ns = tunnel_get_ns();
+	processed_nr = rohc_decompress_burst(worker->decomp, worker->rohc_pkts,
+	                                     worker->ip_pkts, worker->statuses, NULL,
+	                                     rcvd_nr);
+	worker->stats.decomp_ns += tunnel_get_ns() - decomp_start_ns;
+
+	/* TUN takes one packet per write(2), feedback-only packets are empty */
+	for(i = 0; ((size_t) i) < processed_nr; i++)
+	{
+		if(worker->statuses[i] != ROHC_STATUS_OK)
+		{
+			worker->stats.decomp_failures++;
+			continue;
+		}
+		if(worker->ip_pkts[i].len == 0)
+		{
+			continue;
+		}
+		if(write(worker->tun_fd, rohc_buf_data(worker->ip_pkts[i]),
+		         worker->ip_pkts[i].len) != ((ssize_t) worker->ip_pkts[i].len))
+		{
+			worker->stats.io_failures++;
+			continue;
+		}
+		worker->stats.tun_tx++;
+	}
+
+	end_ns = tunnel_get_ns();
+	if((end_ns - start_ns) > worker->stats.decomp_lat_max_ns)
+	{
+		worker->stats.decomp_lat_max_ns = end_ns - start_ns;
+	}
+}
+
+
+/**
+ * @brief Send the feedbacks of the ring in one feedback-only ROHC packet
+ *
+ * The received feedbacks of the ring are delivered to the compressor at the
+ * same time.
+ *
+ * @param worker  The worker thread
+ */
+static void tunnel_flush_feedbacks(struct tunnel_worker *const worker)
+{
+	struct rohc_buf feedbacks =
+		rohc_buf_init_empty(worker->rohc_data[0], TUNNEL_ROHC_MAX_LEN);
+
+	if(!rohc_comp_drain_feedback_ring(worker->comp, &feedbacks))
+	{
+		/* one received feedback was rejected by the compressor */
+		worker->stats.comp_failures++;
+	}
+	if(feedbacks.len > 0)
+	{
+		worker->iovs[0].iov_base = rohc_buf_data(feedbacks);
+		worker->iovs[0].iov_len = feedbacks.len;
+		tunnel_send_burst(worker, 1);
+		worker->stats.feedbacks_only++;
+	}
+	else
+	{
+		worker->last_tx_ns = tunnel_get_ns();
+	}
+}
+
+
+/**
+ * @brief Send the ROHC packets described by the I/O vectors of the thread
+ *
+ * @param worker   The worker thread
+ * @param pkts_nr  The number of ROHC packets to send
+ */
+static void tunnel_send_burst(struct tunnel_worker *const worker,
+                              const size_t pkts_nr)
+{
+	size_t sent_nr = 0;
+	size_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		memset(&worker->msgs[i], 0, sizeof(struct mmsghdr));
+		worker->msgs[i].msg_hdr.msg_iov = &worker->iovs[i];
+		worker->msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while(sent_nr < pkts_nr)
+	{
+		const int ret = sendmmsg(worker->udp_fd, worker->msgs + sent_nr,
+		                         pkts_nr - sent_nr, 0);
+		if(ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if(ret <= 0)
+		{
+			/* drop the rest of the burst */
+			worker->stats.io_failures += pkts_nr - sent_nr;
+			break;
+		}
+		for(i = sent_nr; i < (sent_nr + ret); i++)
+		{
+			worker->stats.udp_tx_bytes += worker->msgs[i].msg_len;
+		}
+		sent_nr += ret;
+	}
+	worker->stats.udp_tx += sent_nr;
+	worker->last_tx_ns = tunnel_get_ns();
+}
+
+
+/**
+ * @brief Print the statistics of the worker threads
+ *
+ * The statistics are read without synchronization: they are approximate.
+ *
+ * @param workers     The worker threads
+ * @param workers_nr  The number of worker threads
+ * @param period      The time elapsed since the previous statistics (s)
+ */
+static void tunnel_print_stats(const struct tunnel_worker *const workers,
+                               const size_t workers_nr,
+                               const double period)
+{
+	static struct tunnel_stats prev[TUNNEL_THREADS_MAX];
+	size_t i;
+
+	printf("thread\ttx_pps\trx_pps\tratio%%\tcomp_ns\tdecomp_ns\tcomp_lat_max_us"
+	       "\tdecomp_lat_max_us\tcomp_err\tdecomp_err\tio_err\tfb_only\n");
+	for(i = 0; i < workers_nr; i++)
+	{
+		const struct tunnel_stats cur = workers[i].stats;
+		const uint64_t tun_rx = cur.tun_rx - prev[i].tun_rx;
+		const uint64_t udp_rx = cur.udp_rx - prev[i].udp_rx;
+		const uint64_t tun_rx_bytes = cur.tun_rx_bytes - prev[i].tun_rx_bytes;
+		const uint64_t udp_tx_bytes = cur.udp_tx_bytes - prev[i].udp_tx_bytes;
+
+		printf("%zu\t%.0f\t%.0f\t%.2f\t%.1f\t%.1f\t%.1f\t%.1f\t%" PRIu64 "\t%"
+		       PRIu64 "\t%" PRIu64 "\t%" PRIu64 "\n", i + 1, tun_rx / period,
+		       udp_rx / period,
+		       (tun_rx_bytes > 0 ? 100.0 * udp_tx_bytes / tun_rx_bytes : 0.0),
+		       (tun_rx > 0 ? ((double) (cur.comp_ns - prev[i].comp_ns)) / tun_rx : 0.0),
+		       (udp_rx > 0 ? ((double) (cur.decomp_ns - prev[i].decomp_ns)) / udp_rx : 0.0),
+		       cur.comp_lat_max_ns / 1e3, cur.decomp_lat_max_ns / 1e3,
+		       cur.comp_failures, cur.decomp_failures, cur.io_failures,
+		       cur.feedbacks_only);
+		prev[i] = cur;
+	}
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Get the current monotonic time in nanoseconds
+ *
+ * @return  The current time in nanoseconds
+ */
+static uint64_t tunnel_get_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Get the current monotonic time for the ROHC library
+ *
+ * @return  The current time
+ */
+static struct rohc_ts tunnel_get_ts(void)
+{
+	struct timespec now;
+	struct rohc_ts ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ts.sec = now.tv_sec;
+	ts.nsec = now.tv_nsec;
+
+	return ts;
+}
+
+
+/**
+ * @brief Generate a random number for the compressors
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int tunnel_gen_random_num(const struct rohc_comp *const comp __attribute__((unused)),
+                                 void *const user_context __attribute__((unused)))
+{
+	return rand();
+}
+
+
+/**
+ * @brief Stop the program on SIGINT or SIGTERM
+ *
+ * @param signum  The signal number
+ */
+static void tunnel_stop(int signum __attribute__((unused)))
+{
+	stop_program = 1;
+}
+
@@ -0,0 +1,278 @@
+#!/bin/sh
+#
+# Copyright 2018 Viveris Technologies
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+#
+# file:        rohc_tunnel_lab.sh
+# description: Measure the performances of the ROHC tunnel between network
+#              namespaces
+# author:      Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+#
+# The network namespaces are the ones of app/sniffer/setup_perfs_env.sh:
+#
+#   ENDPOINT1 ---- PROXY1 ==== ROHC tunnel ==== PROXY2 ---- ENDPOINT2
+#  192.168.0.1                                            192.168.1.254
+#
+# The traffic of every scenario goes from ENDPOINT1 to ENDPOINT2, so PROXY1
+# compresses it and PROXY2 decompresses it:
+#  - tcp: one TCP bulk transfer,
+#  - udp: one UDP flow of 1400-byte packets at the given rate,
+#  - voip: several UDP flows of 172-byte packets at 50 packets per second,
+#    ie. the sizes of G.711 RTP flows.
+# The TCP and UDP flows are generated by iperf3, and the latency is measured
+# by ping(8) during every scenario.
+#
+# The report contains one line per scenario with:
+#  - the throughput received by ENDPOINT2 and the UDP loss rate,
+#  - the percentiles 50, 90 and 99 of the round-trip time under load,
+#  - the CPU usage of the tunnels of PROXY1 and PROXY2, in percents of one
+#    CPU (the TCP acknowledgements are compressed by PROXY2 and decompressed
+#    by PROXY1),
+#  - the mean time to compress and to decompress one packet, and the share
+#    of the bytes saved on the tunnel link, as reported by the tunnels.
+#
+
+usage()
+{
+	echo "usage: $0 [OPTIONS] [SCENARIO...]" >&2
+	echo >&2
+	echo "Run the given scenarios (default: tcp udp voip) through the ROHC" >&2
+	echo "tunnel between network namespaces, then print one report line per" >&2
+	echo "scenario. Shall be run as root." >&2
+	echo >&2
+	echo "options:" >&2
+	echo "  --tunnel PATH      The rohc_tunnel program (default: the one" >&2
+	echo "                     next to the script)" >&2
+	echo "  --threads NUM      The number of threads of the tunnels (default 1)" >&2
+	echo "  --max-cid NUM      The largest CID of the tunnels (default 15)" >&2
+	echo "  --rohcv2           Use the ROHCv2 profiles" >&2
+	echo "  --duration SEC     The duration of every scenario (default 10)" >&2
+	echo "  --udp-rate RATE    The rate of the udp scenario, in iperf3" >&2
+	echo "                     format (default 100M)" >&2
+	echo "  --voip-streams NUM The number of flows of the voip scenario" >&2
+	echo "                     (default 10)" >&2
+	echo "  --output DIR       The directory of the logs and the report" >&2
+	echo "                     (default: a new temporary directory)" >&2
+}
+
+basedir=$( dirname $0 )
+setup_env="${basedir}/../sniffer/setup_perfs_env.sh"
+
+# parse parameters
+tunnel="${basedir}/rohc_tunnel"
+threads=1
+max_cid=15
+rohcv2=""
+duration=10
+udp_rate="100M"
+voip_streams=10
+output_dir=""
+scenarios=""
+while [ $# -gt 0 ] ; do
+	case "$1" in
+		--tunnel)       tunnel="$2" ; shift ;;
+		--threads)      threads="$2" ; shift ;;
+		--max-cid)      max_cid="$2" ; shift ;;
+		--rohcv2)       rohcv2="--rohcv2" ;;
+		--duration)     duration="$2" ; shift ;;
+		--udp-rate)     udp_rate="$2" ; shift ;;
+		--voip-streams) voip_streams="$2" ; shift ;;
+		--output)       output_dir="$2" ; shift ;;
+		-h|--help)      usage ; exit 0 ;;
+		tcp|udp|voip)   scenarios="${scenarios} $1" ;;
+		*)              echo "unexpected argument '$1'" >&2 ; usage ; exit 1 ;;
+	esac
+	shift
+done
+if [ -z "${scenarios}" ] ; then
+	scenarios="tcp udp voip"
+fi
+
+if [ "$( id -u )" != "0" ] ; then
+	echo "the network namespaces can only be created by root" >&2
+	exit 1
+fi
+if [ ! -x "${tunnel}" ] ; then
+	echo "the rohc_tunnel program '${tunnel}' is not found, see --tunnel" >&2
+	exit 1
+fi
+for tool in ip iperf3 ping gawk ; do
+	if ! which ${tool} >/dev/null 2>&1 ; then
+		echo "the ${tool} program is required" >&2
+		exit 1
+	fi
+done
+if [ -z "${output_dir}" ] ; then
+	output_dir=$( mktemp -d /tmp/rohc_tunnel_lab.XXXXXX ) || exit 1
+else
+	mkdir -p "${output_dir}" || exit 1
+fi
+
+tunnel1_pid=""
+tunnel2_pid=""
+
+cleanup()
+{
+	for pid in ${tunnel1_pid} ${tunnel2_pid} ; do
+		kill ${pid} 2>/dev/null
+		wait ${pid} 2>/dev/null
+	done
+	for netns in ENDPOINT1 PROXY1 PROXY2 ENDPOINT2 ; do
+		ip netns pids ${netns} 2>/dev/null | xargs -r kill 2>/dev/null
+		ip netns del ${netns} 2>/dev/null
+	done
+}
+trap cleanup EXIT
+trap 'exit 1' INT TERM
+
+# print the CPU time (in clock ticks) used by the given process so far
+cpu_ticks()
+{
+	gawk '{ print $14 + $15 }' /proc/$1/stat
+}
+
+# print the CPU usage (in percents of one CPU) between two CPU times
+cpu_percent()
+{
+	gawk -v t1="$1" -v t2="$2" -v hz="$( getconf CLK_TCK )" -v d="${duration}" \
+		'BEGIN { printf("%.1f", 100.0 * (t2 - t1) / hz / d) }'
+}
+
+# print the mean of one column of the statistics of a tunnel, weighted by
+# the packets of another column, from the given line of the log
+tunnel_stat()
+{
+	local log="$1"
+	local from="$2"
+	local col="$3"
+	local weight_col="$4"
+
+	tail -n +$(( ${from} + 1 )) "${log}" | gawk -F'\t' -v col=${col} \
+		-v wcol=${weight_col} \
+		'$1 ~ /^[0-9]+$/ && $wcol > 0 { sum += $col * $wcol ; w += $wcol }
+		 END { if(w > 0) { printf("%.1f", sum / w) } else { printf("-") } }'
+}
+
+# print the percentiles 50, 90 and 99 of the round-trip times of ping(8)
+rtt_percentiles()
+{
+	sed -n -e 's/^.* time=\([0-9.]*\) ms$/\1/p' "$1" | sort -n | gawk \
+		'{ rtt[NR] = $1 }
+		 END {
+			if(NR == 0) { printf("-\t-\t-") ; exit }
+			printf("%s\t%s\t%s", rtt[int((NR - 1) * 0.50) + 1],
+			       rtt[int((NR - 1) * 0.90) + 1], rtt[int((NR - 1) * 0.99) + 1])
+		 }'
+}
+
+# print the throughput (in Mbits/sec) and the loss rate received by the
+# iperf3 server
+iperf_result()
+{
+	gawk '/receiver/ {
+			loss = "-"
+			for(i = 2 ; i <= NF ; i++) {
+				if($i == "Mbits/sec") { tput = $(i - 1) }
+				if($i ~ /^\([0-9.e+-]+%\)$/) { loss = substr($i, 2, length($i) - 3) }
+			}
+		 }
+		 END { printf("%s\t%s", (tput == "" ? "-" : tput), (loss == "" ? "-" : loss)) }' "$1"
+}
+
+# create the network namespaces, then route ENDPOINT1 and ENDPOINT2 through
+# the tunnel between PROXY1 and PROXY2
+sh "${setup_env}" >"${output_dir}/setup.log" 2>&1
+for proxy in PROXY1 PROXY2 ; do
+	ip netns exec ${proxy} sh -c 'echo 1 > /proc/sys/net/ipv4/ip_forward'
+	ip netns exec ${proxy} sh -c 'echo 1 > /proc/sys/net/ipv4/conf/lan/proxy_arp'
+	# room for the ROHC and UDP headers of full-sized IP packets
+	ip netns exec ${proxy} ip link set internet mtu 1600
+done
+ip netns exec PROXY1 ip -4 addr add 10.0.0.1/24 dev internet
+ip netns exec PROXY2 ip -4 addr add 10.0.0.2/24 dev internet
+ip netns exec PROXY1 ip route add 192.168.0.0/24 dev lan
+ip netns exec PROXY2 ip route add 192.168.1.0/24 dev lan
+
+ip netns exec PROXY1 "${tunnel}" --tun rohc0 --threads ${threads} \
+	--max-cid ${max_cid} --stats 1 ${rohcv2} \
+	--local 10.0.0.1:5000 --remote 10.0.0.2:5000 >"${output_dir}/tunnel1.log" 2>&1 &
+tunnel1_pid=$!
+ip netns exec PROXY2 "${tunnel}" --tun rohc0 --threads ${threads} \
+	--max-cid ${max_cid} --stats 1 ${rohcv2} \
+	--local 10.0.0.2:5000 --remote 10.0.0.1:5000 >"${output_dir}/tunnel2.log" 2>&1 &
+tunnel2_pid=$!
+sleep 1
+for pid in ${tunnel1_pid} ${tunnel2_pid} ; do
+	if ! kill -0 ${pid} 2>/dev/null ; then
+		echo "the tunnels failed to start, see ${output_dir}" >&2
+		exit 1
+	fi
+done
+ip netns exec PROXY1 ip link set rohc0 up
+ip netns exec PROXY1 ip route add 192.168.1.0/24 dev rohc0
+ip netns exec PROXY2 ip link set rohc0 up
+ip netns exec PROXY2 ip route add 192.168.0.0/24 dev rohc0
+
+if ! ip netns exec ENDPOINT1 ping -c 3 -W 1 192.168.1.254 >"${output_dir}/check.log" 2>&1 ; then
+	echo "ENDPOINT2 is not reachable through the tunnels, see ${output_dir}" >&2
+	exit 1
+fi
+
+printf "scenario\tMbits/sec\tloss%%\trtt_p50_ms\trtt_p90_ms\trtt_p99_ms"
+printf "\tcomp_cpu%%\tdecomp_cpu%%\tcomp_ns\tdecomp_ns\tsaved%%\n"
+for scenario in ${scenarios} ; do
+	case "${scenario}" in
+		tcp)  iperf_args="" ;;
+		udp)  iperf_args="-u -l 1400 -b ${udp_rate}" ;;
+		voip) iperf_args="-u -l 172 -b 68800 -P ${voip_streams}" ;;
+	esac
+
+	ip netns exec ENDPOINT2 iperf3 -s -1 >/dev/null 2>&1 &
+	server_pid=$!
+	sleep 1
+
+	log1_from=$( wc -l < "${output_dir}/tunnel1.log" )
+	log2_from=$( wc -l < "${output_dir}/tunnel2.log" )
+	cpu1_from=$( cpu_ticks ${tunnel1_pid} )
+	cpu2_from=$( cpu_ticks ${tunnel2_pid} )
+
+	ip netns exec ENDPOINT1 ping -n -i 0.01 -w ${duration} 192.168.1.254 \
+		>"${output_dir}/${scenario}.ping" 2>&1 &
+	ping_pid=$!
+	ip netns exec ENDPOINT1 iperf3 -c 192.168.1.254 -f m -t ${duration} \
+		${iperf_args} >"${output_dir}/${scenario}.iperf" 2>&1
+	wait ${ping_pid}
+	wait ${server_pid} 2>/dev/null
+
+	cpu1_to=$( cpu_ticks ${tunnel1_pid} )
+	cpu2_to=$( cpu_ticks ${tunnel2_pid} )
+	# let the tunnels print the statistics of the last second
+	sleep 1.5
+
+	ratio=$( tunnel_stat "${output_dir}/tunnel1.log" ${log1_from} 4 2 )
+	printf "%s\t%s\t%s" "${scenario}" \
+		"$( iperf_result "${output_dir}/${scenario}.iperf" )" \
+		"$( rtt_percentiles "${output_dir}/${scenario}.ping" )"
+	printf "\t%s\t%s" "$( cpu_percent ${cpu1_from} ${cpu1_to} )" \
+		"$( cpu_percent ${cpu2_from} ${cpu2_to} )"
+	printf "\t%s\t%s\t%s\n" \
+		"$( tunnel_stat "${output_dir}/tunnel1.log" ${log1_from} 5 2 )" \
+		"$( tunnel_stat "${output_dir}/tunnel2.log" ${log2_from} 6 3 )" \
+		"$( echo "${ratio}" | gawk '$1 != "-" { printf("%.1f", 100.0 - $1) ; next } { print }' )"
+done | tee "${output_dir}/report.tsv"
+
+echo "logs and report stored in ${output_dir}" >&2
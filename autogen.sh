@@ -87,6 +87,7 @@ fi
 chmod +x ${NEW_PWD}/configure
 ${NEW_PWD}/configure \
 	--enable-rohc-debug \
+	--enable-rohc-alloc-check \
 	--enable-fail-on-warning \
 	--enable-fortify-sources \
 	--enable-app-sniffer \
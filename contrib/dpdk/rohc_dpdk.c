@@ -0,0 +1,284 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   rohc_dpdk.c
+ * @brief  Compress and decompress DPDK mbufs in place
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_dpdk.h"
+
+#include <rte_prefetch.h>
+
+#include <string.h>
+
+
+static bool rohc_dpdk_make_contiguous(struct rte_mbuf *const m)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/**
+ * @brief Describe the packet of the given mbuf with a network buffer
+ *
+ * The network buffer starts at the beginning of the memory of the mbuf, so
+ * that the headroom of the mbuf is the headroom of the network buffer. The
+ * mbuf shall not be chained.
+ *
+ * @param m         The mbuf
+ * @param time      The arrival time of the packet
+ * @param[out] buf  The network buffer
+ */
+void rohc_dpdk_mbuf_to_buf(const struct rte_mbuf *const m,
+                           const struct rohc_ts time,
+                           struct rohc_buf *const buf)
+{
+	buf->time = time;
+	buf->data = m->buf_addr;
+	buf->offset = m->data_off;
+	buf->len = m->data_len;
+	buf->max_len = buf->offset + buf->len;
+}
+
+
+/**
+ * @brief Move the data of the mbuf to the packet of the network buffer
+ *
+ * The network buffer shall describe the same memory as the one built with
+ * \ref rohc_dpdk_mbuf_to_buf.
+ *
+ * @param m    The mbuf
+ * @param buf  The network buffer
+ */
+void rohc_dpdk_mbuf_from_buf(struct rte_mbuf *const m,
+                             const struct rohc_buf buf)
+{
+	m->data_off = buf.offset;
+	m->data_len = buf.len;
+	m->pkt_len = buf.len;
+}
+
+
+/**
+ * @brief Compress the IP packet of the given mbuf in place
+ *
+ * The IP packet starts at the data of the mbuf. The ROHC header is built in
+ * the headroom of the mbuf, then moved right before the payload that stays
+ * where it is. On success, the data of the mbuf is the ROHC packet.
+ *
+ * @param comp  The ROHC compressor
+ * @param m     The mbuf with the IP packet to compress
+ * @param time  The arrival time of the packet
+ * @return      ROHC_STATUS_OK if the packet was compressed,
+ *              ROHC_STATUS_NO_MEMORY if the chained mbuf could not be
+ *              linearized, the same status values as
+ *              \ref rohc_compress_in_place otherwise
+ *
+ * @see rohc_compress_in_place
+ */
+rohc_status_t rohc_dpdk_compress(struct rohc_comp *const comp,
+                                 struct rte_mbuf *const m,
+                                 const struct rohc_ts time)
+{
+	struct rohc_buf pkt;
+	rohc_status_t status;
+
+	if(comp == NULL || m == NULL || rte_pktmbuf_pkt_len(m) == 0)
+	{
+		goto error;
+	}
+	if(!rohc_dpdk_make_contiguous(m))
+	{
+		status = ROHC_STATUS_NO_MEMORY;
+		goto error_status;
+	}
+
+	rohc_dpdk_mbuf_to_buf(m, time, &pkt);
+	status = rohc_compress_in_place(comp, &pkt);
+	if(status != ROHC_STATUS_OK)
+	{
+		goto error_status;
+	}
+	rohc_dpdk_mbuf_from_buf(m, pkt);
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+error_status:
+	return status;
+}
+
+
+/**
+ * @brief Compress the IP packets of the given mbufs in place
+ *
+ * Compress every mbuf as \ref rohc_dpdk_compress does, the headers of the
+ * next packet being prefetched while the current one is compressed. The
+ * mbufs that failed to be compressed are left unchanged.
+ *
+ * @param comp           The ROHC compressor
+ * @param pkts           The mbufs with the IP packets to compress
+ * @param pkts_nr        The number of mbufs
+ * @param time           The arrival time of the packets
+ * @param[out] statuses  The status of every packet, may be NULL
+ * @return               The number of packets that were compressed
+ */
+uint16_t rohc_dpdk_compress_bulk(struct rohc_comp *const comp,
+                                 struct rte_mbuf **const pkts,
+                                 const uint16_t pkts_nr,
+                                 const struct rohc_ts time,
+                                 rohc_status_t *const statuses)
+{
+	uint16_t compressed_nr = 0;
+	uint16_t i;
+
+	if(comp == NULL || pkts == NULL)
+	{
+		goto error;
+	}
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		rohc_status_t status;
+
+		if((i + 1) < pkts_nr)
+		{
+			rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 1], void *));
+		}
+
+		status = rohc_dpdk_compress(comp, pkts[i], time);
+		if(status == ROHC_STATUS_OK)
+		{
+			compressed_nr++;
+		}
+		if(statuses != NULL)
+		{
+			statuses[i] = status;
+		}
+	}
+
+error:
+	return compressed_nr;
+}
+
+
+/**
+ * @brief Decompress the ROHC packet of the given mbuf in place
+ *
+ * The ROHC packet starts at the data of the mbuf. The uncompressed headers
+ * are built in the headroom of the mbuf, then moved right before the payload
+ * that stays where it is. On success, the data of the mbuf is the IP packet,
+ * or is empty if the ROHC packet contained feedback only.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param m                   The mbuf with the ROHC packet to decompress
+ * @param time                The arrival time of the packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor, may be
+ *                            NULL
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, may be NULL
+ * @return                    ROHC_STATUS_OK if the packet was decompressed,
+ *                            ROHC_STATUS_NO_MEMORY if the chained mbuf could
+ *                            not be linearized, the same status values as
+ *                            \ref rohc_decompress_in_place otherwise
+ *
+ * @see rohc_decompress_in_place
+ */
+rohc_status_t rohc_dpdk_decompress(struct rohc_decomp *const decomp,
+                                   struct rte_mbuf *const m,
+                                   const struct rohc_ts time,
+                                   struct rohc_buf *const rcvd_feedback,
+                                   struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf pkt;
+	rohc_status_t status;
+
+	if(decomp == NULL || m == NULL || rte_pktmbuf_pkt_len(m) == 0)
+	{
+		goto error;
+	}
+	if(!rohc_dpdk_make_contiguous(m))
+	{
+		status = ROHC_STATUS_NO_MEMORY;
+		goto error_status;
+	}
+
+	rohc_dpdk_mbuf_to_buf(m, time, &pkt);
+	status = rohc_decompress_in_place(decomp, &pkt, rcvd_feedback,
+	                                  feedback_send);
+	if(status != ROHC_STATUS_OK)
+	{
+		goto error_status;
+	}
+	rohc_dpdk_mbuf_from_buf(m, pkt);
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+error_status:
+	return status;
+}
+
+
+/**
+ * @brief Prepend the given data to the packet of the given mbuf
+ *
+ * Used to piggyback feedbacks in front of a ROHC packet, or to add the
+ * link-layer header back.
+ *
+ * @param m     The mbuf
+ * @param data  The data to prepend
+ * @return      true if the data was prepended,
+ *              false if the headroom of the mbuf is too small
+ */
+bool rohc_dpdk_prepend(struct rte_mbuf *const m,
+                       const struct rohc_buf data)
+{
+	char *dst;
+
+	if(data.len == 0)
+	{
+		return true;
+	}
+
+	dst = rte_pktmbuf_prepend(m, data.len);
+	if(dst == NULL)
+	{
+		return false;
+	}
+	memcpy(dst, rohc_buf_data(data), data.len);
+
+	return true;
+}
+
+
+/**
+ * @brief Make the packet of the given mbuf contiguous
+ *
+ * @param m  The mbuf
+ * @return   true if the packet is contiguous,
+ *           false if the chained mbuf could not be linearized
+ */
+static bool rohc_dpdk_make_contiguous(struct rte_mbuf *const m)
+{
+	return (rte_pktmbuf_is_contiguous(m) || rte_pktmbuf_linearize(m) == 0);
+}
+
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   rohc_dpdk.h
+ * @brief  Compress and decompress DPDK mbufs in place
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The helpers describe the packet of one rte_mbuf with a rohc_buf whose
+ * headroom is the headroom of the mbuf, then compress or decompress it in
+ * place: the ROHC header replaces the uncompressed headers and the
+ * uncompressed headers replace the ROHC header, the payload is neither copied
+ * nor moved.
+ *
+ * The mbuf shall start with the IP packet or the ROHC packet, ie. the
+ * link-layer header shall be removed first, eg. with rte_pktmbuf_adj().
+ * Chained mbufs are linearized first, since the library needs the whole
+ * packet in contiguous memory.
+ *
+ * The headroom of the mbuf is used as a scratch area by the library, see
+ * \ref rohc_compress_in_place and \ref rohc_decompress_in_place. The default
+ * RTE_PKTMBUF_HEADROOM of 128 bytes is enough for the usual IPv4 and IPv6
+ * headers once the Ethernet header is removed. The packets with longer
+ * headers fail with \ref ROHC_STATUS_ERROR or
+ * \ref ROHC_STATUS_OUTPUT_TOO_SMALL.
+ */
+
+#ifndef ROHC_DPDK_H
+#define ROHC_DPDK_H
+
+#include <rte_mbuf.h>
+
+#include <rohc/rohc.h>
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/** The EtherType of the ROHC packets over Ethernet */
+#define ROHC_DPDK_ETHER_TYPE  0x22f1U
+
+
+void rohc_dpdk_mbuf_to_buf(const struct rte_mbuf *const m,
+                           const struct rohc_ts time,
+                           struct rohc_buf *const buf)
+	__attribute__((nonnull(1, 3)));
+
+void rohc_dpdk_mbuf_from_buf(struct rte_mbuf *const m,
+                             const struct rohc_buf buf)
+	__attribute__((nonnull(1)));
+
+rohc_status_t rohc_dpdk_compress(struct rohc_comp *const comp,
+                                 struct rte_mbuf *const m,
+                                 const struct rohc_ts time)
+	__attribute__((warn_unused_result));
+
+uint16_t rohc_dpdk_compress_bulk(struct rohc_comp *const comp,
+                                 struct rte_mbuf **const pkts,
+                                 const uint16_t pkts_nr,
+                                 const struct rohc_ts time,
+                                 rohc_status_t *const statuses)
+	__attribute__((warn_unused_result));
+
+rohc_status_t rohc_dpdk_decompress(struct rohc_decomp *const decomp,
+                                   struct rte_mbuf *const m,
+                                   const struct rohc_ts time,
+                                   struct rohc_buf *const rcvd_feedback,
+                                   struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+bool rohc_dpdk_prepend(struct rte_mbuf *const m,
+                       const struct rohc_buf data)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+#endif /* ROHC_DPDK_H */
+
@@ -0,0 +1,1277 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   rohc_fwd.c
+ * @brief  Multi-core ROHC gateway between two DPDK ports
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The gateway forwards the IP packets received on the LAN port to the WAN port
+ * once compressed, and the ROHC packets received on the WAN port to the LAN
+ * port once decompressed. The ROHC packets are carried over Ethernet with the
+ * ROHC EtherType.
+ *
+ * Every worker lcore serves one RX queue and one TX queue of both ports. The
+ * NIC distributes the IP flows over the RX queues of the LAN port with RSS, so
+ * that every flow is always compressed by the same lcore. Every lcore owns one
+ * shard of a group of ROHC compressors, ie. a ROHC compressor restricted to
+ * its own range of CIDs, so that no compression context is shared between
+ * lcores.
+ *
+ * The remote gateway shall run with the same number of lcores and the same
+ * CID space: the ROHC packets of the CID range of lcore #i are then
+ * decompressed by lcore #i, whatever the RX queue they were received on,
+ * since the NIC cannot hash the ROHC packets by CID. The ROHC packets are
+ * handed over to their lcore through one rte_ring per lcore.
+ *
+ * The feedbacks are carried between lcores over rte_rings too, without any
+ * lock: the feedbacks received by the decompressor of one lcore are routed to
+ * the compressor that owns their CID, and the feedbacks built by the
+ * decompressor of one lcore are piggybacked on its next ROHC packets, or
+ * sent in a feedback-only packet if no ROHC packet is sent for a while.
+ *
+ * Usage:
+ *   rohc_fwd [EAL options] -- [--lan-port N] [--wan-port N] [--max-cid N]
+ *            [--lan-dst MAC] [--wan-dst MAC] [--stats-period SEC]
+ */
+
+#include "rohc_dpdk.h"
+
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <getopt.h>
+#include <errno.h>
+
+
+/** The maximal number of worker lcores */
+#define ROHC_FWD_LCORES_MAX  64U
+
+/** The number of mbufs received or sent in one burst */
+#define ROHC_FWD_BURST  32U
+
+/** The number of RX and TX descriptors per queue */
+#define ROHC_FWD_RX_DESC  1024U
+#define ROHC_FWD_TX_DESC  1024U
+
+/** The number of mbufs per lcore in the packet pool */
+#define ROHC_FWD_MBUFS_PER_LCORE  8192U
+
+/** The number of entries of the rings between lcores */
+#define ROHC_FWD_RING_SIZE  4096U
+
+/** The maximal length of one feedback item routed between lcores */
+#define ROHC_FWD_FEEDBACK_MAX_LEN  64U
+
+/** The maximal length of the feedbacks waiting to be piggybacked */
+#define ROHC_FWD_FEEDBACKS_MAX_LEN  512U
+
+/** The delay before the waiting feedbacks are sent in a feedback-only
+ *  packet (in microseconds) */
+#define ROHC_FWD_FEEDBACK_DELAY_US  1000U
+
+
+/** One feedback item routed from one lcore to another one */
+struct rohc_fwd_feedback
+{
+	uint16_t len;                              /**< The length of the item */
+	uint8_t data[ROHC_FWD_FEEDBACK_MAX_LEN];   /**< The feedback item */
+};
+
+
+/** The statistics of one worker lcore */
+struct rohc_fwd_stats
+{
+	uint64_t lan_rx;           /**< The packets received on the LAN port */
+	uint64_t lan_rx_bytes;     /**< The bytes received on the LAN port */
+	uint64_t wan_tx;           /**< The ROHC packets sent on the WAN port */
+	uint64_t wan_tx_bytes;     /**< The bytes sent on the WAN port */
+	uint64_t wan_rx;           /**< The packets received on the WAN port */
+	uint64_t lan_tx;           /**< The packets sent on the LAN port */
+	uint64_t handed_over;      /**< The ROHC packets given to other lcores */
+	uint64_t comp_failures;    /**< The packets that failed to be compressed */
+	uint64_t decomp_failures;  /**< The packets that failed to be decompressed */
+	uint64_t feedbacks_routed; /**< The feedbacks given to other lcores */
+	uint64_t feedbacks_only;   /**< The feedback-only packets sent */
+	uint64_t drops;            /**< The packets dropped for lack of room */
+} __rte_cache_aligned;
+
+
+/** The context of one worker lcore */
+struct rohc_fwd_worker
+{
+	unsigned int lcore_id;       /**< The ID of the lcore */
+	uint16_t queue_id;           /**< The RX and TX queues of the lcore */
+	struct rohc_comp *comp;      /**< The compressor shard of the lcore */
+	struct rohc_decomp *decomp;  /**< The decompressor of the lcore */
+	rohc_cid_t cid_min;          /**< The first CID of the shard */
+	rohc_cid_t cid_max;          /**< The last CID of the shard */
+	struct rte_ring *rohc_ring;  /**< The ROHC packets of the CID range */
+	struct rte_ring *fb_ring;    /**< The feedbacks for the shard */
+
+	/** The feedbacks to piggyback on the next ROHC packets */
+	struct rohc_buf feedbacks;
+	uint8_t feedbacks_data[ROHC_FWD_FEEDBACKS_MAX_LEN];
+	/** The TSC when the oldest waiting feedback was built */
+	uint64_t feedbacks_since;
+
+	struct rohc_fwd_stats stats; /**< The statistics of the lcore */
+} __rte_cache_aligned;
+
+
+/** The configuration and the state of the gateway */
+struct rohc_fwd
+{
+	uint16_t lan_port;                /**< The port of the IP packets */
+	uint16_t wan_port;                /**< The port of the ROHC packets */
+	struct rte_ether_addr lan_dst;    /**< The destination MAC on the LAN */
+	struct rte_ether_addr wan_dst;    /**< The destination MAC on the WAN */
+	struct rte_ether_addr lan_src;    /**< The MAC of the LAN port */
+	struct rte_ether_addr wan_src;    /**< The MAC of the WAN port */
+	rohc_cid_t max_cid;               /**< The largest CID of the channel */
+	unsigned int stats_period;        /**< The period of the stats (s) */
+	struct rte_mempool *pkt_pool;     /**< The pool of packet mbufs */
+	struct rte_mempool *fb_pool;      /**< The pool of feedback items */
+	struct rohc_comp_group *group;    /**< The compressor shards */
+	size_t workers_nr;                /**< The number of worker lcores */
+	struct rohc_fwd_worker *workers[ROHC_FWD_LCORES_MAX];
+};
+
+
+static struct rohc_fwd fwd;
+static volatile bool force_quit = false;
+
+
+static int rohc_fwd_parse_args(int argc, char *argv[])
+	__attribute__((warn_unused_result));
+static int rohc_fwd_init_port(const uint16_t port_id, const uint16_t queues_nr)
+	__attribute__((warn_unused_result));
+static int rohc_fwd_init_workers(void)
+	__attribute__((warn_unused_result));
+static void rohc_fwd_free_workers(void);
+static int rohc_fwd_worker_main(void *arg);
+static void rohc_fwd_lan_to_wan(struct rohc_fwd_worker *const worker,
+                                struct rte_mbuf **const pkts,
+                                const uint16_t pkts_nr,
+                                const struct rohc_ts now)
+	__attribute__((nonnull(1, 2)));
+static void rohc_fwd_wan_rx(struct rohc_fwd_worker *const worker,
+                            struct rte_mbuf **const pkts,
+                            const uint16_t pkts_nr,
+                            const struct rohc_ts now)
+	__attribute__((nonnull(1, 2)));
+static void rohc_fwd_wan_to_lan(struct rohc_fwd_worker *const worker,
+                                struct rte_mbuf **const pkts,
+                                const uint16_t pkts_nr,
+                                const struct rohc_ts now)
+	__attribute__((nonnull(1, 2)));
+static void rohc_fwd_route_feedbacks(struct rohc_fwd_worker *const worker,
+                                     struct rohc_buf feedbacks)
+	__attribute__((nonnull(1)));
+static void rohc_fwd_drain_feedbacks(struct rohc_fwd_worker *const worker)
+	__attribute__((nonnull(1)));
+static void rohc_fwd_queue_feedbacks(struct rohc_fwd_worker *const worker,
+                                     const struct rohc_buf feedbacks)
+	__attribute__((nonnull(1)));
+static void rohc_fwd_flush_feedbacks(struct rohc_fwd_worker *const worker)
+	__attribute__((nonnull(1)));
+static size_t rohc_fwd_cid_owner(const rohc_cid_t cid)
+	__attribute__((warn_unused_result));
+static bool rohc_fwd_push_eth(struct rte_mbuf *const m,
+                              const struct rte_ether_addr *const src,
+                              const struct rte_ether_addr *const dst,
+                              const uint16_t ether_type)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void rohc_fwd_tx(const uint16_t port_id,
+                        const uint16_t queue_id,
+                        struct rte_mbuf **const pkts,
+                        const uint16_t pkts_nr,
+                        struct rohc_fwd_stats *const stats)
+	__attribute__((nonnull(3, 5)));
+static struct rohc_ts rohc_fwd_now(void)
+	__attribute__((warn_unused_result));
+static void rohc_fwd_print_stats(void);
+static int rohc_fwd_gen_random_num(const struct rohc_comp *const comp,
+                                   void *const user_context)
+	__attribute__((nonnull(1)));
+static void rohc_fwd_signal_handler(int signum);
+
+
+/**
+ * @brief Main function of the ROHC gateway
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	unsigned int lcore_id;
+	uint64_t last_stats;
+	int ret;
+	int status = 1;
+
+	ret = rte_eal_init(argc, argv);
+	if(ret < 0)
+	{
+		fprintf(stderr, "failed to initialize the EAL\n");
+		goto error;
+	}
+	argc -= ret;
+	argv += ret;
+
+	signal(SIGINT, rohc_fwd_signal_handler);
+	signal(SIGTERM, rohc_fwd_signal_handler);
+
+	if(rohc_fwd_parse_args(argc, argv) != 0)
+	{
+		goto cleanup_eal;
+	}
+
+	fwd.workers_nr = rte_lcore_count() - 1;
+	if(fwd.workers_nr == 0 || fwd.workers_nr > ROHC_FWD_LCORES_MAX)
+	{
+		fprintf(stderr, "between 1 and %u worker lcores are required in addition "
+		        "to the main lcore\n", ROHC_FWD_LCORES_MAX);
+		goto cleanup_eal;
+	}
+	if(fwd.workers_nr > ((size_t) fwd.max_cid) + 1)
+	{
+		fprintf(stderr, "not enough CIDs for %zu worker lcores\n",
+		        fwd.workers_nr);
+		goto cleanup_eal;
+	}
+
+	fwd.pkt_pool =
+		rte_pktmbuf_pool_create("rohc_fwd_pkts",
+		                        ROHC_FWD_MBUFS_PER_LCORE * fwd.workers_nr,
+		                        256, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+		                        rte_socket_id());
+	if(fwd.pkt_pool == NULL)
+	{
+		fprintf(stderr, "failed to create the pool of packets: %s\n",
+		        rte_strerror(rte_errno));
+		goto cleanup_eal;
+	}
+	fwd.fb_pool =
+		rte_mempool_create("rohc_fwd_feedbacks",
+		                   ROHC_FWD_RING_SIZE * fwd.workers_nr,
+		                   sizeof(struct rohc_fwd_feedback), 256, 0,
+		                   NULL, NULL, NULL, NULL, rte_socket_id(), 0);
+	if(fwd.fb_pool == NULL)
+	{
+		fprintf(stderr, "failed to create the pool of feedbacks: %s\n",
+		        rte_strerror(rte_errno));
+		goto free_pkt_pool;
+	}
+
+	if(rohc_fwd_init_port(fwd.lan_port, fwd.workers_nr) != 0 ||
+	   rohc_fwd_init_port(fwd.wan_port, fwd.workers_nr) != 0)
+	{
+		goto free_fb_pool;
+	}
+	if(rte_eth_macaddr_get(fwd.lan_port, &fwd.lan_src) != 0 ||
+	   rte_eth_macaddr_get(fwd.wan_port, &fwd.wan_src) != 0)
+	{
+		fprintf(stderr, "failed to get the MAC addresses of the ports\n");
+		goto stop_ports;
+	}
+
+	if(rohc_fwd_init_workers() != 0)
+	{
+		goto stop_ports;
+	}
+
+	printf("ROHC gateway: LAN port %u, WAN port %u, %zu worker lcores, "
+	       "CIDs 0-%u\n", fwd.lan_port, fwd.wan_port, fwd.workers_nr,
+	       fwd.max_cid);
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+	{
+		size_t i;
+
+		for(i = 0; i < fwd.workers_nr; i++)
+		{
+			if(fwd.workers[i]->lcore_id == lcore_id)
+			{
+				rte_eal_remote_launch(rohc_fwd_worker_main, fwd.workers[i],
+				                      lcore_id);
+			}
+		}
+	}
+
+	/* the main lcore prints the statistics */
+	last_stats = rte_get_tsc_cycles();
+	while(!force_quit)
+	{
+		rte_delay_ms(100);
+		if(fwd.stats_period > 0 &&
+		   (rte_get_tsc_cycles() - last_stats) >=
+		   (rte_get_tsc_hz() * fwd.stats_period))
+		{
+			rohc_fwd_print_stats();
+			last_stats = rte_get_tsc_cycles();
+		}
+	}
+	rte_eal_mp_wait_lcore();
+	rohc_fwd_print_stats();
+
+	status = 0;
+
+	rohc_fwd_free_workers();
+stop_ports:
+	rte_eth_dev_stop(fwd.lan_port);
+	rte_eth_dev_close(fwd.lan_port);
+	rte_eth_dev_stop(fwd.wan_port);
+	rte_eth_dev_close(fwd.wan_port);
+free_fb_pool:
+	rte_mempool_free(fwd.fb_pool);
+free_pkt_pool:
+	rte_mempool_free(fwd.pkt_pool);
+cleanup_eal:
+	rte_eal_cleanup();
+error:
+	return status;
+}
+
+
+/**
+ * @brief Parse the application arguments that follow the EAL ones
+ *
+ * @param argc  The number of application arguments
+ * @param argv  The application arguments
+ * @return      0 in case of success, -1 otherwise
+ */
+static int rohc_fwd_parse_args(int argc, char *argv[])
+{
+	static const struct option options[] =
+	{
+		{ "lan-port",     required_argument, NULL, 'l' },
+		{ "wan-port",     required_argument, NULL, 'w' },
+		{ "max-cid",      required_argument, NULL, 'c' },
+		{ "lan-dst",      required_argument, NULL, 'L' },
+		{ "wan-dst",      required_argument, NULL, 'W' },
+		{ "stats-period", required_argument, NULL, 's' },
+		{ NULL, 0, NULL, 0 }
+	};
+	int opt;
+
+	fwd.lan_port = 0;
+	fwd.wan_port = 1;
+	fwd.max_cid = ROHC_LARGE_CID_MAX;
+	memset(&fwd.lan_dst, 0xff, sizeof(struct rte_ether_addr));
+	memset(&fwd.wan_dst, 0xff, sizeof(struct rte_ether_addr));
+	fwd.stats_period = 1;
+
+	while((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+	{
+		switch(opt)
+		{
+			case 'l':
+				fwd.lan_port = atoi(optarg);
+				break;
+			case 'w':
+				fwd.wan_port = atoi(optarg);
+				break;
+			case 'c':
+				fwd.max_cid = strtoul(optarg, NULL, 10);
+				if(fwd.max_cid > ROHC_LARGE_CID_MAX)
+				{
+					fprintf(stderr, "max CID shall be at most %u\n",
+					        ROHC_LARGE_CID_MAX);
+					goto error;
+				}
+				break;
+			case 'L':
+				if(rte_ether_unformat_addr(optarg, &fwd.lan_dst) != 0)
+				{
+					fprintf(stderr, "malformed LAN MAC address '%s'\n", optarg);
+					goto error;
+				}
+				break;
+			case 'W':
+				if(rte_ether_unformat_addr(optarg, &fwd.wan_dst) != 0)
+				{
+					fprintf(stderr, "malformed WAN MAC address '%s'\n", optarg);
+					goto error;
+				}
+				break;
+			case 's':
+				fwd.stats_period = strtoul(optarg, NULL, 10);
+				break;
+			default:
+				fprintf(stderr,
+				        "usage: rohc_fwd [EAL options] -- [--lan-port N] "
+				        "[--wan-port N] [--max-cid N] [--lan-dst MAC] "
+				        "[--wan-dst MAC] [--stats-period SEC]\n");
+				goto error;
+		}
+	}
+
+	if(fwd.lan_port == fwd.wan_port)
+	{
+		fprintf(stderr, "LAN and WAN ports shall be different\n");
+		goto error;
+	}
+
+	return 0;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Configure one port with one RX and one TX queue per worker lcore
+ *
+ * RSS distributes the IP flows over the RX queues. The ROHC packets are not
+ * IP packets, so they are all received on the first RX queue of the WAN port.
+ *
+ * @param port_id    The port to configure
+ * @param queues_nr  The number of RX and TX queues
+ * @return           0 in case of success, -1 otherwise
+ */
+static int rohc_fwd_init_port(const uint16_t port_id, const uint16_t queues_nr)
+{
+	struct rte_eth_conf port_conf;
+	struct rte_eth_dev_info dev_info;
+	uint16_t rx_desc = ROHC_FWD_RX_DESC;
+	uint16_t tx_desc = ROHC_FWD_TX_DESC;
+	uint16_t q;
+
+	if(!rte_eth_dev_is_valid_port(port_id) ||
+	   rte_eth_dev_info_get(port_id, &dev_info) != 0)
+	{
+		fprintf(stderr, "port %u is not available\n", port_id);
+		goto error;
+	}
+	if(queues_nr > dev_info.max_rx_queues || queues_nr > dev_info.max_tx_queues)
+	{
+		fprintf(stderr, "port %u supports at most %u RX and %u TX queues\n",
+		        port_id, dev_info.max_rx_queues, dev_info.max_tx_queues);
+		goto error;
+	}
+
+	memset(&port_conf, 0, sizeof(struct rte_eth_conf));
+	if(queues_nr > 1)
+	{
+		port_conf.rxmode.mq_mode = RTE_ETH_MQ_RX_RSS;
+		port_conf.rx_adv_conf.rss_conf.rss_key = NULL;
+		port_conf.rx_adv_conf.rss_conf.rss_hf =
+			(RTE_ETH_RSS_IP | RTE_ETH_RSS_UDP | RTE_ETH_RSS_TCP) &
+			dev_info.flow_type_rss_offloads;
+	}
+
+	if(rte_eth_dev_configure(port_id, queues_nr, queues_nr, &port_conf) != 0 ||
+	   rte_eth_dev_adjust_nb_rx_tx_desc(port_id, &rx_desc, &tx_desc) != 0)
+	{
+		fprintf(stderr, "failed to configure port %u\n", port_id);
+		goto error;
+	}
+	for(q = 0; q < queues_nr; q++)
+	{
+		if(rte_eth_rx_queue_setup(port_id, q, rx_desc,
+		                          rte_eth_dev_socket_id(port_id), NULL,
+		                          fwd.pkt_pool) != 0 ||
+		   rte_eth_tx_queue_setup(port_id, q, tx_desc,
+		                          rte_eth_dev_socket_id(port_id), NULL) != 0)
+		{
+			fprintf(stderr, "failed to set up queue %u of port %u\n", q, port_id);
+			goto error;
+		}
+	}
+	if(rte_eth_dev_start(port_id) != 0)
+	{
+		fprintf(stderr, "failed to start port %u\n", port_id);
+		goto error;
+	}
+	rte_eth_promiscuous_enable(port_id);
+
+	return 0;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Create the context of every worker lcore
+ *
+ * The compressors are the shards of one group of ROHC compressors, so every
+ * lcore owns a disjoint range of the CIDs of the channel.
+ *
+ * @return  0 in case of success, -1 otherwise
+ */
+static int rohc_fwd_init_workers(void)
+{
+	const rohc_cid_type_t cid_type =
+		(fwd.max_cid > ROHC_SMALL_CID_MAX ? ROHC_LARGE_CID : ROHC_SMALL_CID);
+	unsigned int lcore_id;
+	size_t i = 0;
+
+	fwd.group = rohc_comp_group_new(cid_type, fwd.max_cid, fwd.workers_nr,
+	                                rohc_fwd_gen_random_num, NULL);
+	if(fwd.group == NULL)
+	{
+		fprintf(stderr, "failed to create the group of ROHC compressors\n");
+		goto error;
+	}
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+	{
+		struct rohc_fwd_worker *worker;
+		char name[RTE_RING_NAMESIZE];
+
+		worker = rte_zmalloc_socket("rohc_fwd_worker",
+		                            sizeof(struct rohc_fwd_worker),
+		                            RTE_CACHE_LINE_SIZE,
+		                            rte_lcore_to_socket_id(lcore_id));
+		if(worker == NULL)
+		{
+			fprintf(stderr, "failed to allocate the context of lcore %u\n",
+			        lcore_id);
+			goto free_workers;
+		}
+		fwd.workers[i] = worker;
+		worker->lcore_id = lcore_id;
+		worker->queue_id = i;
+		worker->feedbacks.time.sec = 0;
+		worker->feedbacks.time.nsec = 0;
+		worker->feedbacks.data = worker->feedbacks_data;
+		worker->feedbacks.max_len = ROHC_FWD_FEEDBACKS_MAX_LEN;
+		worker->feedbacks.offset = 0;
+		worker->feedbacks.len = 0;
+
+		worker->comp = rohc_comp_group_get_shard(fwd.group, i);
+		if(worker->comp == NULL ||
+		   !rohc_comp_get_cid_range(worker->comp, &worker->cid_min,
+		                            &worker->cid_max) ||
+		   !rohc_comp_enable_profiles(worker->comp, ROHCv1_PROFILE_UNCOMPRESSED,
+		                              ROHCv1_PROFILE_IP_UDP_RTP,
+		                              ROHCv1_PROFILE_IP_UDP, ROHCv1_PROFILE_IP_ESP,
+		                              ROHCv1_PROFILE_IP, ROHCv1_PROFILE_IP_TCP,
+		                              -1))
+		{
+			fprintf(stderr, "failed to set up the compressor of lcore %u\n",
+			        lcore_id);
+			goto free_workers;
+		}
+
+		worker->decomp = rohc_decomp_new2(cid_type, fwd.max_cid, ROHC_O_MODE);
+		if(worker->decomp == NULL ||
+		   !rohc_decomp_enable_profiles(worker->decomp,
+		                                ROHCv1_PROFILE_UNCOMPRESSED,
+		                                ROHCv1_PROFILE_IP_UDP_RTP,
+		                                ROHCv1_PROFILE_IP_UDP,
+		                                ROHCv1_PROFILE_IP_ESP, ROHCv1_PROFILE_IP,
+		                                ROHCv1_PROFILE_IP_TCP, -1))
+		{
+			fprintf(stderr, "failed to set up the decompressor of lcore %u\n",
+			        lcore_id);
+			goto free_workers;
+		}
+
+		/* several lcores hand over packets and feedbacks to one lcore */
+		snprintf(name, RTE_RING_NAMESIZE, "rohc_fwd_pkts_%zu", i);
+		worker->rohc_ring =
+			rte_ring_create(name, ROHC_FWD_RING_SIZE,
+			                rte_lcore_to_socket_id(lcore_id), RING_F_SC_DEQ);
+		snprintf(name, RTE_RING_NAMESIZE, "rohc_fwd_fbs_%zu", i);
+		worker->fb_ring =
+			rte_ring_create(name, ROHC_FWD_RING_SIZE,
+			                rte_lcore_to_socket_id(lcore_id), RING_F_SC_DEQ);
+		if(worker->rohc_ring == NULL || worker->fb_ring == NULL)
+		{
+			fprintf(stderr, "failed to create the rings of lcore %u\n", lcore_id);
+			goto free_workers;
+		}
+
+		i++;
+	}
+
+	return 0;
+
+free_workers:
+	rohc_fwd_free_workers();
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Destroy the context of every worker lcore
+ */
+static void rohc_fwd_free_workers(void)
+{
+	size_t i;
+
+	for(i = 0; i < fwd.workers_nr; i++)
+	{
+		struct rohc_fwd_worker *const worker = fwd.workers[i];
+
+		if(worker == NULL)
+		{
+			continue;
+		}
+		if(worker->rohc_ring != NULL)
+		{
+			struct rte_mbuf *m;
+
+			while(rte_ring_dequeue(worker->rohc_ring, (void **) &m) == 0)
+			{
+				rte_pktmbuf_free(m);
+			}
+			rte_ring_free(worker->rohc_ring);
+		}
+		rte_ring_free(worker->fb_ring);
+		if(worker->decomp != NULL)
+		{
+			rohc_decomp_free(worker->decomp);
+		}
+		rte_free(worker);
+		fwd.workers[i] = NULL;
+	}
+
+	/* the compressors are freed with their group */
+	if(fwd.group != NULL)
+	{
+		rohc_comp_group_free(fwd.group);
+		fwd.group = NULL;
+	}
+}
+
+
+/**
+ * @brief The main loop of one worker lcore
+ *
+ * @param arg  The context of the worker lcore
+ * @return     Always 0
+ */
+static int rohc_fwd_worker_main(void *arg)
+{
+	struct rohc_fwd_worker *const worker = arg;
+	const uint64_t fb_delay =
+		(rte_get_tsc_hz() * ROHC_FWD_FEEDBACK_DELAY_US) / 1000000U;
+
+	printf("lcore %u: queue %u, CIDs %u-%u\n", worker->lcore_id,
+	       worker->queue_id, worker->cid_min, worker->cid_max);
+
+	while(!force_quit)
+	{
+		struct rte_mbuf *pkts[ROHC_FWD_BURST];
+		const struct rohc_ts now = rohc_fwd_now();
+		uint16_t nr;
+
+		/* the feedbacks routed to the compressor shard by other lcores */
+		rohc_fwd_drain_feedbacks(worker);
+
+		/* IP packets to compress */
+		nr = rte_eth_rx_burst(fwd.lan_port, worker->queue_id, pkts,
+		                      ROHC_FWD_BURST);
+		if(nr > 0)
+		{
+			rohc_fwd_lan_to_wan(worker, pkts, nr, now);
+		}
+
+		/* ROHC packets received by the lcore, and ROHC packets of the CID
+		 * range of the lcore received by other lcores */
+		nr = rte_eth_rx_burst(fwd.wan_port, worker->queue_id, pkts,
+		                      ROHC_FWD_BURST);
+		if(nr > 0)
+		{
+			rohc_fwd_wan_rx(worker, pkts, nr, now);
+		}
+		nr = rte_ring_dequeue_burst(worker->rohc_ring, (void **) pkts,
+		                            ROHC_FWD_BURST, NULL);
+		if(nr > 0)
+		{
+			rohc_fwd_wan_to_lan(worker, pkts, nr, now);
+		}
+
+		/* do not keep the feedbacks for too long without ROHC packet */
+		if(!rohc_buf_is_empty(worker->feedbacks) &&
+		   (rte_get_tsc_cycles() - worker->feedbacks_since) >= fb_delay)
+		{
+			rohc_fwd_flush_feedbacks(worker);
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief Compress IP packets from the LAN and send them to the WAN
+ *
+ * The feedbacks waiting to be sent are piggybacked on the first ROHC packet
+ * that has room enough in its headroom.
+ *
+ * @param worker   The context of the worker lcore
+ * @param pkts     The received Ethernet frames
+ * @param pkts_nr  The number of received Ethernet frames
+ * @param now      The current time
+ */
+static void rohc_fwd_lan_to_wan(struct rohc_fwd_worker *const worker,
+                                struct rte_mbuf **const pkts,
+                                const uint16_t pkts_nr,
+                                const struct rohc_ts now)
+{
+	struct rte_mbuf *tx_pkts[ROHC_FWD_BURST];
+	rohc_status_t statuses[ROHC_FWD_BURST];
+	uint16_t ip_nr = 0;
+	uint16_t tx_nr = 0;
+	uint16_t i;
+
+	/* strip the Ethernet headers, drop the non-IP frames */
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const struct rte_ether_hdr *const eth =
+			rte_pktmbuf_mtod(pkts[i], const struct rte_ether_hdr *);
+
+		worker->stats.lan_rx++;
+		worker->stats.lan_rx_bytes += rte_pktmbuf_pkt_len(pkts[i]);
+		if(rte_pktmbuf_pkt_len(pkts[i]) <= sizeof(struct rte_ether_hdr) ||
+		   (eth->ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) &&
+		    eth->ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6)))
+		{
+			rte_pktmbuf_free(pkts[i]);
+			worker->stats.drops++;
+			continue;
+		}
+		rte_pktmbuf_adj(pkts[i], sizeof(struct rte_ether_hdr));
+		pkts[ip_nr] = pkts[i];
+		ip_nr++;
+	}
+
+	(void) rohc_dpdk_compress_bulk(worker->comp, pkts, ip_nr, now, statuses);
+
+	for(i = 0; i < ip_nr; i++)
+	{
+		if(statuses[i] != ROHC_STATUS_OK)
+		{
+			rte_pktmbuf_free(pkts[i]);
+			worker->stats.comp_failures++;
+			continue;
+		}
+
+		/* piggyback the feedbacks in front of the ROHC packet */
+		if(!rohc_buf_is_empty(worker->feedbacks) &&
+		   rohc_dpdk_prepend(pkts[i], worker->feedbacks))
+		{
+			worker->feedbacks.len = 0;
+		}
+
+		if(!rohc_fwd_push_eth(pkts[i], &fwd.wan_src, &fwd.wan_dst,
+		                      ROHC_DPDK_ETHER_TYPE))
+		{
+			rte_pktmbuf_free(pkts[i]);
+			worker->stats.drops++;
+			continue;
+		}
+		worker->stats.wan_tx_bytes += rte_pktmbuf_pkt_len(pkts[i]);
+		tx_pkts[tx_nr] = pkts[i];
+		tx_nr++;
+	}
+
+	rohc_fwd_tx(fwd.wan_port, worker->queue_id, tx_pkts, tx_nr, &worker->stats);
+	worker->stats.wan_tx += tx_nr;
+}
+
+
+/**
+ * @brief Dispatch the ROHC packets received from the WAN to their lcore
+ *
+ * The ROHC packets of the CID range of the lcore are decompressed right
+ * away, the other ones are handed over to the lcore that owns their CID.
+ * Feedback-only packets carry no CID, they are handled by the lcore that
+ * received them.
+ *
+ * @param worker   The context of the worker lcore
+ * @param pkts     The received Ethernet frames
+ * @param pkts_nr  The number of received Ethernet frames
+ * @param now      The current time
+ */
+static void rohc_fwd_wan_rx(struct rohc_fwd_worker *const worker,
+                            struct rte_mbuf **const pkts,
+                            const uint16_t pkts_nr,
+                            const struct rohc_ts now)
+{
+	uint16_t local_nr = 0;
+	uint16_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const struct rte_ether_hdr *const eth =
+			rte_pktmbuf_mtod(pkts[i], const struct rte_ether_hdr *);
+		struct rohc_buf rohc_pkt;
+		size_t fb_offset;
+		size_t fb_len;
+		rohc_cid_t cid;
+		size_t owner;
+
+		worker->stats.wan_rx++;
+		if(rte_pktmbuf_pkt_len(pkts[i]) <= sizeof(struct rte_ether_hdr) ||
+		   eth->ether_type != rte_cpu_to_be_16(ROHC_DPDK_ETHER_TYPE) ||
+		   rte_pktmbuf_adj(pkts[i], sizeof(struct rte_ether_hdr)) == NULL)
+		{
+			rte_pktmbuf_free(pkts[i]);
+			worker->stats.drops++;
+			continue;
+		}
+
+		owner = worker->queue_id;
+		if(rte_pktmbuf_is_contiguous(pkts[i]))
+		{
+			rohc_dpdk_mbuf_to_buf(pkts[i], now, &rohc_pkt);
+			if(rohc_decomp_peek_cid(worker->decomp, rohc_pkt, &cid, &fb_offset,
+			                        &fb_len))
+			{
+				owner = rohc_fwd_cid_owner(cid);
+			}
+		}
+
+		if(owner == worker->queue_id)
+		{
+			pkts[local_nr] = pkts[i];
+			local_nr++;
+		}
+		else if(rte_ring_enqueue(fwd.workers[owner]->rohc_ring, pkts[i]) == 0)
+		{
+			worker->stats.handed_over++;
+		}
+		else
+		{
+			rte_pktmbuf_free(pkts[i]);
+			worker->stats.drops++;
+		}
+	}
+
+	if(local_nr > 0)
+	{
+		rohc_fwd_wan_to_lan(worker, pkts, local_nr, now);
+	}
+}
+
+
+/**
+ * @brief Decompress ROHC packets and send them to the LAN
+ *
+ * @param worker   The context of the worker lcore
+ * @param pkts     The ROHC packets, without their Ethernet header
+ * @param pkts_nr  The number of ROHC packets
+ * @param now      The current time
+ */
+static void rohc_fwd_wan_to_lan(struct rohc_fwd_worker *const worker,
+                                struct rte_mbuf **const pkts,
+                                const uint16_t pkts_nr,
+                                const struct rohc_ts now)
+{
+	struct rte_mbuf *tx_pkts[ROHC_FWD_BURST];
+	uint16_t tx_nr = 0;
+	uint16_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		uint8_t rcvd_fb_data[ROHC_FWD_FEEDBACKS_MAX_LEN];
+		struct rohc_buf rcvd_fb =
+			rohc_buf_init_empty(rcvd_fb_data, ROHC_FWD_FEEDBACKS_MAX_LEN);
+		uint8_t send_fb_data[ROHC_FWD_FEEDBACKS_MAX_LEN];
+		struct rohc_buf send_fb =
+			rohc_buf_init_empty(send_fb_data, ROHC_FWD_FEEDBACKS_MAX_LEN);
+		rohc_status_t status;
+		uint16_t ether_type;
+
+		if((i + 1) < pkts_nr)
+		{
+			rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 1], void *));
+		}
+
+		status = rohc_dpdk_decompress(worker->decomp, pkts[i], now,
+		                              &rcvd_fb, &send_fb);
+
+		/* the feedbacks are handled even if the packet is not decompressed */
+		rohc_fwd_route_feedbacks(worker, rcvd_fb);
+		rohc_fwd_queue_feedbacks(worker, send_fb);
+
+		if(status != ROHC_STATUS_OK)
+		{
+			rte_pktmbuf_free(pkts[i]);
+			worker->stats.decomp_failures++;
+			continue;
+		}
+		if(rte_pktmbuf_pkt_len(pkts[i]) == 0)
+		{
+			/* feedback-only packet */
+			rte_pktmbuf_free(pkts[i]);
+			continue;
+		}
+
+		if(((*rte_pktmbuf_mtod(pkts[i], uint8_t *)) >> 4) == 6)
+		{
+			ether_type = RTE_ETHER_TYPE_IPV6;
+		}
+		else
+		{
+			ether_type = RTE_ETHER_TYPE_IPV4;
+		}
+		if(!rohc_fwd_push_eth(pkts[i], &fwd.lan_src, &fwd.lan_dst, ether_type))
+		{
+			rte_pktmbuf_free(pkts[i]);
+			worker->stats.drops++;
+			continue;
+		}
+		tx_pkts[tx_nr] = pkts[i];
+		tx_nr++;
+	}
+
+	rohc_fwd_tx(fwd.lan_port, worker->queue_id, tx_pkts, tx_nr, &worker->stats);
+	worker->stats.lan_tx += tx_nr;
+}
+
+
+/**
+ * @brief Route the received feedbacks to the compressor shards
+ *
+ * The feedbacks for the shard of the lcore are delivered right away, the
+ * other ones are given to the lcore that owns their CID.
+ *
+ * @param worker     The context of the worker lcore
+ * @param feedbacks  The feedbacks received from the remote peer
+ */
+static void rohc_fwd_route_feedbacks(struct rohc_fwd_worker *const worker,
+                                     struct rohc_buf feedbacks)
+{
+	while(!rohc_buf_is_empty(feedbacks))
+	{
+		struct rohc_buf feedback_item;
+		struct rohc_fwd_feedback *msg;
+		size_t shard_idx;
+
+		if(!rohc_comp_group_route_feedback(fwd.group, &feedbacks,
+		                                   &feedback_item, &shard_idx))
+		{
+			/* malformed feedback data, drop the remaining items */
+			worker->stats.drops++;
+			break;
+		}
+
+		if(shard_idx == worker->queue_id)
+		{
+			if(!rohc_comp_deliver_feedback2(worker->comp, feedback_item))
+			{
+				worker->stats.drops++;
+			}
+			continue;
+		}
+
+		if(feedback_item.len > ROHC_FWD_FEEDBACK_MAX_LEN ||
+		   rte_mempool_get(fwd.fb_pool, (void **) &msg) != 0)
+		{
+			worker->stats.drops++;
+			continue;
+		}
+		msg->len = feedback_item.len;
+		memcpy(msg->data, rohc_buf_data(feedback_item), feedback_item.len);
+		if(rte_ring_enqueue(fwd.workers[shard_idx]->fb_ring, msg) != 0)
+		{
+			rte_mempool_put(fwd.fb_pool, msg);
+			worker->stats.drops++;
+			continue;
+		}
+		worker->stats.feedbacks_routed++;
+	}
+}
+
+
+/**
+ * @brief Deliver the feedbacks routed by other lcores to the compressor shard
+ *
+ * @param worker  The context of the worker lcore
+ */
+static void rohc_fwd_drain_feedbacks(struct rohc_fwd_worker *const worker)
+{
+	struct rohc_fwd_feedback *msgs[ROHC_FWD_BURST];
+	unsigned int nr;
+	unsigned int i;
+
+	nr = rte_ring_dequeue_burst(worker->fb_ring, (void **) msgs,
+	                            ROHC_FWD_BURST, NULL);
+	for(i = 0; i < nr; i++)
+	{
+		const struct rohc_buf feedback =
+			rohc_buf_init_full(msgs[i]->data, msgs[i]->len, rohc_fwd_now());
+
+		if(!rohc_comp_deliver_feedback2(worker->comp, feedback))
+		{
+			worker->stats.drops++;
+		}
+	}
+	if(nr > 0)
+	{
+		rte_mempool_put_bulk(fwd.fb_pool, (void **) msgs, nr);
+	}
+}
+
+
+/**
+ * @brief Queue the feedbacks built by the decompressor of the lcore
+ *
+ * The feedbacks are piggybacked on the next ROHC packets of the lcore.
+ *
+ * @param worker     The context of the worker lcore
+ * @param feedbacks  The feedbacks built by the decompressor
+ */
+static void rohc_fwd_queue_feedbacks(struct rohc_fwd_worker *const worker,
+                                     const struct rohc_buf feedbacks)
+{
+	if(rohc_buf_is_empty(feedbacks))
+	{
+		return;
+	}
+	if((worker->feedbacks.len + feedbacks.len) > ROHC_FWD_FEEDBACKS_MAX_LEN)
+	{
+		/* too many feedbacks waiting, send them right now */
+		rohc_fwd_flush_feedbacks(worker);
+	}
+	if((worker->feedbacks.len + feedbacks.len) > ROHC_FWD_FEEDBACKS_MAX_LEN)
+	{
+		worker->stats.drops++;
+		return;
+	}
+
+	if(rohc_buf_is_empty(worker->feedbacks))
+	{
+		worker->feedbacks_since = rte_get_tsc_cycles();
+	}
+	rohc_buf_append_buf(&worker->feedbacks, feedbacks);
+}
+
+
+/**
+ * @brief Send the feedbacks waiting for a ROHC packet in a feedback-only packet
+ *
+ * @param worker  The context of the worker lcore
+ */
+static void rohc_fwd_flush_feedbacks(struct rohc_fwd_worker *const worker)
+{
+	struct rte_mbuf *m;
+
+	m = rte_pktmbuf_alloc(fwd.pkt_pool);
+	if(m == NULL)
+	{
+		worker->stats.drops++;
+		goto end;
+	}
+	if(!rohc_dpdk_prepend(m, worker->feedbacks) ||
+	   !rohc_fwd_push_eth(m, &fwd.wan_src, &fwd.wan_dst, ROHC_DPDK_ETHER_TYPE))
+	{
+		rte_pktmbuf_free(m);
+		worker->stats.drops++;
+		goto end;
+	}
+
+	rohc_fwd_tx(fwd.wan_port, worker->queue_id, &m, 1, &worker->stats);
+	worker->stats.feedbacks_only++;
+
+end:
+	worker->feedbacks.len = 0;
+}
+
+
+/**
+ * @brief Get the worker lcore that owns the given CID
+ *
+ * @param cid  The CID
+ * @return     The index of the worker lcore
+ */
+static size_t rohc_fwd_cid_owner(const rohc_cid_t cid)
+{
+	size_t i;
+
+	for(i = 0; i < fwd.workers_nr; i++)
+	{
+		if(cid >= fwd.workers[i]->cid_min && cid <= fwd.workers[i]->cid_max)
+		{
+			return i;
+		}
+	}
+
+	return fwd.workers_nr - 1;
+}
+
+
+/**
+ * @brief Add an Ethernet header to the given mbuf
+ *
+ * @param m           The mbuf
+ * @param src         The source MAC address
+ * @param dst         The destination MAC address
+ * @param ether_type  The EtherType, in host byte order
+ * @return            true if the header was added,
+ *                    false if the headroom of the mbuf is too small
+ */
+static bool rohc_fwd_push_eth(struct rte_mbuf *const m,
+                              const struct rte_ether_addr *const src,
+                              const struct rte_ether_addr *const dst,
+                              const uint16_t ether_type)
+{
+	struct rte_ether_hdr *const eth =
+		(struct rte_ether_hdr *) rte_pktmbuf_prepend(m, sizeof(struct rte_ether_hdr));
+
+	if(eth == NULL)
+	{
+		return false;
+	}
+	rte_ether_addr_copy(dst, &eth->dst_addr);
+	rte_ether_addr_copy(src, &eth->src_addr);
+	eth->ether_type = rte_cpu_to_be_16(ether_type);
+
+	return true;
+}
+
+
+/**
+ * @brief Send mbufs on one TX queue, drop the ones that were not sent
+ *
+ * @param port_id   The port
+ * @param queue_id  The TX queue
+ * @param pkts      The mbufs to send
+ * @param pkts_nr   The number of mbufs to send
+ * @param stats     The statistics of the worker lcore
+ */
+static void rohc_fwd_tx(const uint16_t port_id,
+                        const uint16_t queue_id,
+                        struct rte_mbuf **const pkts,
+                        const uint16_t pkts_nr,
+                        struct rohc_fwd_stats *const stats)
+{
+	uint16_t sent_nr = 0;
+
+	while(sent_nr < pkts_nr)
+	{
+		const uint16_t nr = rte_eth_tx_burst(port_id, queue_id, pkts + sent_nr,
+		                                     pkts_nr - sent_nr);
+		if(nr == 0)
+		{
+			break;
+		}
+		sent_nr += nr;
+	}
+	if(sent_nr < pkts_nr)
+	{
+		rte_pktmbuf_free_bulk(pkts + sent_nr, pkts_nr - sent_nr);
+		stats->drops += pkts_nr - sent_nr;
+	}
+}
+
+
+/**
+ * @brief Get the current time for the ROHC library
+ *
+ * @return  The current time, computed from the TSC
+ */
+static struct rohc_ts rohc_fwd_now(void)
+{
+	const uint64_t cycles = rte_get_tsc_cycles();
+	const uint64_t hz = rte_get_tsc_hz();
+	struct rohc_ts now;
+
+	now.sec = cycles / hz;
+	now.nsec = ((cycles % hz) * 1000000000ULL) / hz;
+
+	return now;
+}
+
+
+/**
+ * @brief Print the statistics of all the worker lcores
+ */
+static void rohc_fwd_print_stats(void)
+{
+	struct rohc_fwd_stats total;
+	size_t i;
+
+	memset(&total, 0, sizeof(struct rohc_fwd_stats));
+	printf("%-6s %12s %12s %12s %12s %10s %10s %10s %10s\n", "lcore",
+	       "lan_rx", "wan_tx", "wan_rx", "lan_tx", "handover", "comp_err",
+	       "decomp_err", "drops");
+	for(i = 0; i < fwd.workers_nr; i++)
+	{
+		const struct rohc_fwd_stats *const s = &fwd.workers[i]->stats;
+
+		printf("%-6u %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64
+		       " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+		       fwd.workers[i]->lcore_id, s->lan_rx, s->wan_tx, s->wan_rx,
+		       s->lan_tx, s->handed_over, s->comp_failures, s->decomp_failures,
+		       s->drops);
+		total.lan_rx_bytes += s->lan_rx_bytes;
+		total.wan_tx_bytes += s->wan_tx_bytes;
+	}
+	if(total.lan_rx_bytes > 0)
+	{
+		printf("compression ratio: %.2f%%\n",
+		       100.0 * total.wan_tx_bytes / total.lan_rx_bytes);
+	}
+}
+
+
+/**
+ * @brief Generate a random number for the compressors
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int rohc_fwd_gen_random_num(const struct rohc_comp *const comp,
+                                   void *const user_context)
+{
+	return rand();
+}
+
+
+/**
+ * @brief Stop the gateway on SIGINT or SIGTERM
+ *
+ * @param signum  The signal number
+ */
+static void rohc_fwd_signal_handler(int signum)
+{
+	if(signum == SIGINT || signum == SIGTERM)
+	{
+		force_quit = true;
+	}
+}
+
@@ -0,0 +1,906 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_burst.c
+ * @brief  Zero-copy Python binding for the burst API of the ROHC library
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The _rohc_burst module compresses and decompresses bursts of packets
+ * without copying them between Python and the library. The packets are given
+ * as any object that supports the buffer protocol (bytes, bytearray,
+ * memoryview, numpy arrays...):
+ *  \li the input packets are stored back-to-back in one readable buffer,
+ *      their lengths in one buffer of 32-bit unsigned integers,
+ *  \li the output packets are written in one writable buffer divided in
+ *      slots of \e slot_len bytes, one slot per packet, and their lengths in
+ *      one writable buffer of 32-bit unsigned integers,
+ *  \li the status of every packet is optionally written in one writable
+ *      buffer of bytes, see the STATUS_* constants.
+ *
+ * The library works directly on the memory of the Python objects, and the
+ * GIL is released during the burst so that several compressors or
+ * decompressors may work in parallel from several Python threads. One object
+ * shall not be used by several threads at the same time.
+ *
+ * Example:
+ *
+ * \code
+ *   comp = _rohc_burst.Compressor()
+ *   lens = numpy.array([len(p) for p in pkts], dtype=numpy.uint32)
+ *   out = numpy.empty(len(pkts) * 2048, dtype=numpy.uint8)
+ *   out_lens = numpy.empty(len(pkts), dtype=numpy.uint32)
+ *   nr = comp.compress_burst(b''.join(pkts), lens, out, out_lens, 2048)
+ * \endcode
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** The number of packets given to the library in one single call */
+#define ROHC_PY_BURST_CHUNK  64U
+
+
+/** The compressor object */
+typedef struct
+{
+	PyObject_HEAD
+	struct rohc_comp *comp;  /**< The ROHC compressor */
+	bool in_use;             /**< Whether a burst is in progress or not */
+} RohcBurstCompressor;
+
+
+/** The decompressor object */
+typedef struct
+{
+	PyObject_HEAD
+	struct rohc_decomp *decomp;  /**< The ROHC decompressor */
+	bool in_use;                 /**< Whether a burst is in progress or not */
+} RohcBurstDecompressor;
+
+
+/** The buffers of one burst */
+struct rohc_py_burst
+{
+	Py_buffer pkts;      /**< The input packets, back-to-back */
+	Py_buffer lens;      /**< The lengths of the input packets */
+	Py_buffer out;       /**< The slots for the output packets */
+	Py_buffer out_lens;  /**< The lengths of the output packets */
+	Py_buffer statuses;  /**< The statuses of the packets, optional */
+	bool has_statuses;   /**< Whether the statuses buffer was given */
+	size_t pkts_nr;      /**< The number of packets in the burst */
+	size_t slot_len;     /**< The length of one output slot */
+};
+
+
+/** The signature of one burst function of the library */
+typedef size_t (*rohc_py_burst_fn_t)(void *const rohc_obj,
+                                     const struct rohc_buf *const in_pkts,
+                                     struct rohc_buf *const out_pkts,
+                                     rohc_status_t *const statuses,
+                                     const size_t pkts_nr);
+
+
+/** The ROHCv1 profiles enabled if the user does not give any */
+static const int rohc_py_default_profiles[] =
+{
+	ROHCv1_PROFILE_UNCOMPRESSED,
+	ROHCv1_PROFILE_IP_UDP_RTP,
+	ROHCv1_PROFILE_IP_UDP,
+	ROHCv1_PROFILE_IP_ESP,
+	ROHCv1_PROFILE_IP,
+	ROHCv1_PROFILE_IP_TCP,
+	ROHCv1_PROFILE_IP_UDPLITE,
+	ROHCv1_PROFILE_IP_UDPLITE_RTP,
+};
+
+
+static bool rohc_py_get_u32_buf(PyObject *const obj,
+                                Py_buffer *const view,
+                                const int flags,
+                                const char *const name)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+static bool rohc_py_burst_get(struct rohc_py_burst *const burst,
+                              PyObject *const pkts,
+                              PyObject *const lens,
+                              PyObject *const out,
+                              PyObject *const out_lens,
+                              PyObject *const statuses,
+                              const Py_ssize_t slot_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5, 6)));
+
+static void rohc_py_burst_release(struct rohc_py_burst *const burst)
+	__attribute__((nonnull(1)));
+
+static size_t rohc_py_burst_run(struct rohc_py_burst *const burst,
+                                void *const rohc_obj,
+                                const rohc_py_burst_fn_t burst_fn)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static size_t rohc_py_compress_burst(void *const rohc_obj,
+                                     const struct rohc_buf *const in_pkts,
+                                     struct rohc_buf *const out_pkts,
+                                     rohc_status_t *const statuses,
+                                     const size_t pkts_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static size_t rohc_py_decompress_burst(void *const rohc_obj,
+                                       const struct rohc_buf *const in_pkts,
+                                       struct rohc_buf *const out_pkts,
+                                       rohc_status_t *const statuses,
+                                       const size_t pkts_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static int rohc_py_gen_random_num(const struct rohc_comp *const comp,
+                                  void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Get one buffer of 32-bit unsigned integers
+ *
+ * @param obj        The Python object that exports the buffer
+ * @param[out] view  The buffer view to fill
+ * @param flags      The extra flags for the buffer request, eg. PyBUF_WRITABLE
+ * @param name       The name of the argument, for error messages
+ * @return           true if the buffer was retrieved, false if an exception
+ *                   was raised
+ */
+static bool rohc_py_get_u32_buf(PyObject *const obj,
+                                Py_buffer *const view,
+                                const int flags,
+                                const char *const name)
+{
+	const char *format;
+	size_t fmt_len;
+
+	if(PyObject_GetBuffer(obj, view, flags | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0)
+	{
+		goto error;
+	}
+
+	/* accept the native or little-endian formats of unsigned 32-bit integers,
+	 * eg. array('I'), numpy.uint32 or memoryview.cast('I') */
+	format = (view->format != NULL ? view->format : "B");
+	fmt_len = strlen(format);
+	if(view->itemsize != 4 || fmt_len == 0 || fmt_len > 2 ||
+	   (format[fmt_len - 1] != 'I' && format[fmt_len - 1] != 'L') ||
+	   (fmt_len == 2 && format[0] != '@' && format[0] != '=' &&
+	    format[0] != '<'))
+	{
+		PyErr_Format(PyExc_TypeError, "%s shall be a buffer of 32-bit unsigned "
+		             "integers, not of format '%s'", name, format);
+		goto release;
+	}
+
+	return true;
+
+release:
+	PyBuffer_Release(view);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get and check the buffers of one burst
+ *
+ * @param[out] burst  The buffers of the burst
+ * @param pkts        The input packets, back-to-back
+ * @param lens        The lengths of the input packets
+ * @param out         The slots for the output packets
+ * @param out_lens    The lengths of the output packets
+ * @param statuses    The statuses of the packets, may be Py_None
+ * @param slot_len    The length of one output slot
+ * @return            true if the buffers are usable, false if an exception
+ *                    was raised
+ */
+static bool rohc_py_burst_get(struct rohc_py_burst *const burst,
+                              PyObject *const pkts,
+                              PyObject *const lens,
+                              PyObject *const out,
+                              PyObject *const out_lens,
+                              PyObject *const statuses,
+                              const Py_ssize_t slot_len)
+{
+	const uint32_t *in_lens;
+	size_t total_len = 0;
+	size_t i;
+
+	burst->has_statuses = false;
+	burst->statuses.buf = NULL;
+
+	if(slot_len <= 0)
+	{
+		PyErr_SetString(PyExc_ValueError, "slot_len shall be positive");
+		goto error;
+	}
+	burst->slot_len = slot_len;
+
+	if(PyObject_GetBuffer(pkts, &burst->pkts, PyBUF_C_CONTIGUOUS) != 0)
+	{
+		goto error;
+	}
+	if(!rohc_py_get_u32_buf(lens, &burst->lens, 0, "lens"))
+	{
+		goto release_pkts;
+	}
+	if(PyObject_GetBuffer(out, &burst->out, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+	{
+		goto release_lens;
+	}
+	if(!rohc_py_get_u32_buf(out_lens, &burst->out_lens, PyBUF_WRITABLE,
+	                        "out_lens"))
+	{
+		goto release_out;
+	}
+	if(statuses != Py_None)
+	{
+		if(PyObject_GetBuffer(statuses, &burst->statuses,
+		                      PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+		{
+			goto release_out_lens;
+		}
+		burst->has_statuses = true;
+	}
+
+	/* check that all the buffers are large enough for the burst */
+	burst->pkts_nr = burst->lens.len / 4;
+	if(((size_t) burst->out_lens.len) / 4 < burst->pkts_nr)
+	{
+		PyErr_SetString(PyExc_ValueError, "out_lens is shorter than lens");
+		goto release_statuses;
+	}
+	if(burst->has_statuses && ((size_t) burst->statuses.len) < burst->pkts_nr)
+	{
+		PyErr_SetString(PyExc_ValueError, "statuses is shorter than lens");
+		goto release_statuses;
+	}
+	if(((size_t) burst->out.len) / burst->slot_len < burst->pkts_nr)
+	{
+		PyErr_SetString(PyExc_ValueError, "out is too small for one slot of "
+		                "slot_len bytes per packet");
+		goto release_statuses;
+	}
+	in_lens = burst->lens.buf;
+	for(i = 0; i < burst->pkts_nr; i++)
+	{
+		total_len += in_lens[i];
+	}
+	if(total_len > ((size_t) burst->pkts.len))
+	{
+		PyErr_SetString(PyExc_ValueError, "the sum of lens exceeds the length "
+		                "of pkts");
+		goto release_statuses;
+	}
+
+	return true;
+
+release_statuses:
+	if(burst->has_statuses)
+	{
+		PyBuffer_Release(&burst->statuses);
+	}
+release_out_lens:
+	PyBuffer_Release(&burst->out_lens);
+release_out:
+	PyBuffer_Release(&burst->out);
+release_lens:
+	PyBuffer_Release(&burst->lens);
+release_pkts:
+	PyBuffer_Release(&burst->pkts);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the buffers of one burst
+ *
+ * @param burst  The buffers of the burst
+ */
+static void rohc_py_burst_release(struct rohc_py_burst *const burst)
+{
+	if(burst->has_statuses)
+	{
+		PyBuffer_Release(&burst->statuses);
+	}
+	PyBuffer_Release(&burst->out_lens);
+	PyBuffer_Release(&burst->out);
+	PyBuffer_Release(&burst->lens);
+	PyBuffer_Release(&burst->pkts);
+}
+
+
+/**
+ * @brief Run one burst function of the library over all the packets
+ *
+ * The packets are given to the library by chunks of \ref ROHC_PY_BURST_CHUNK
+ * packets, so that the rohc_buf descriptors fit on the stack. The function
+ * is called without the GIL.
+ *
+ * @param burst     The buffers of the burst
+ * @param rohc_obj  The ROHC compressor or decompressor
+ * @param burst_fn  The burst function of the library
+ * @return          The number of packets that were processed
+ */
+static size_t rohc_py_burst_run(struct rohc_py_burst *const burst,
+                                void *const rohc_obj,
+                                const rohc_py_burst_fn_t burst_fn)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const uint8_t *in_data = burst->pkts.buf;
+	const uint32_t *const in_lens = burst->lens.buf;
+	uint8_t *const out_data = burst->out.buf;
+	uint32_t *const out_lens = burst->out_lens.buf;
+	uint8_t *const out_statuses = burst->statuses.buf;
+	size_t done_nr = 0;
+
+	while(done_nr < burst->pkts_nr)
+	{
+		struct rohc_buf in_pkts[ROHC_PY_BURST_CHUNK];
+		struct rohc_buf out_pkts[ROHC_PY_BURST_CHUNK];
+		rohc_status_t statuses[ROHC_PY_BURST_CHUNK];
+		size_t chunk_nr = burst->pkts_nr - done_nr;
+		size_t processed_nr;
+		size_t i;
+
+		if(chunk_nr > ROHC_PY_BURST_CHUNK)
+		{
+			chunk_nr = ROHC_PY_BURST_CHUNK;
+		}
+
+		/* describe the packets in place, nothing is copied */
+		for(i = 0; i < chunk_nr; i++)
+		{
+			const size_t pkt_num = done_nr + i;
+
+			in_pkts[i].time = arrival_time;
+			in_pkts[i].data = (uint8_t *) in_data;
+			in_pkts[i].max_len = in_lens[pkt_num];
+			in_pkts[i].offset = 0;
+			in_pkts[i].len = in_lens[pkt_num];
+			in_data += in_lens[pkt_num];
+
+			out_pkts[i].time = arrival_time;
+			out_pkts[i].data = out_data + pkt_num * burst->slot_len;
+			out_pkts[i].max_len = burst->slot_len;
+			out_pkts[i].offset = 0;
+			out_pkts[i].len = 0;
+		}
+
+		processed_nr = burst_fn(rohc_obj, in_pkts, out_pkts, statuses, chunk_nr);
+
+		for(i = 0; i < processed_nr; i++)
+		{
+			const size_t pkt_num = done_nr + i;
+
+			out_lens[pkt_num] =
+				(statuses[i] == ROHC_STATUS_OK ? out_pkts[i].len : 0);
+			if(burst->has_statuses)
+			{
+				out_statuses[pkt_num] = statuses[i];
+			}
+		}
+		done_nr += processed_nr;
+
+		/* the library stops the burst on ROHC segmentation */
+		if(processed_nr < chunk_nr)
+		{
+			break;
+		}
+	}
+
+	return done_nr;
+}
+
+
+/**
+ * @brief Compress one chunk of packets
+ *
+ * @param rohc_obj       The ROHC compressor
+ * @param in_pkts        The uncompressed packets
+ * @param[out] out_pkts  The ROHC packets
+ * @param[out] statuses  The status of every packet
+ * @param pkts_nr        The number of packets
+ * @return               The number of packets that were processed
+ */
+static size_t rohc_py_compress_burst(void *const rohc_obj,
+                                     const struct rohc_buf *const in_pkts,
+                                     struct rohc_buf *const out_pkts,
+                                     rohc_status_t *const statuses,
+                                     const size_t pkts_nr)
+{
+	return rohc_compress_burst(rohc_obj, in_pkts, out_pkts, statuses, pkts_nr);
+}
+
+
+/**
+ * @brief Decompress one chunk of packets
+ *
+ * @param rohc_obj       The ROHC decompressor
+ * @param in_pkts        The ROHC packets
+ * @param[out] out_pkts  The uncompressed packets
+ * @param[out] statuses  The status of every packet
+ * @param pkts_nr        The number of packets
+ * @return               The number of packets that were processed
+ */
+static size_t rohc_py_decompress_burst(void *const rohc_obj,
+                                       const struct rohc_buf *const in_pkts,
+                                       struct rohc_buf *const out_pkts,
+                                       rohc_status_t *const statuses,
+                                       const size_t pkts_nr)
+{
+	return rohc_decompress_burst(rohc_obj, in_pkts, out_pkts, statuses, NULL,
+	                             pkts_nr);
+}
+
+
+/**
+ * @brief Generate a random number for the compressor
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int rohc_py_gen_random_num(const struct rohc_comp *const comp,
+                                  void *const user_context)
+{
+	return rand();
+}
+
+
+/*
+ * The compressor object
+ */
+
+static int RohcBurstCompressor_init(RohcBurstCompressor *self,
+                                    PyObject *args,
+                                    PyObject *kwds)
+{
+	static char *kwlist[] = { "large_cid", "max_cid", "profiles", NULL };
+	int large_cid = 0;
+	unsigned int max_cid = ROHC_SMALL_CID_MAX;
+	PyObject *profiles = Py_None;
+
+	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|pIO", kwlist,
+	                                &large_cid, &max_cid, &profiles))
+	{
+		goto error;
+	}
+	if(self->comp != NULL)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "compressor already initialized");
+		goto error;
+	}
+
+	self->comp = rohc_comp_new2(large_cid ? ROHC_LARGE_CID : ROHC_SMALL_CID,
+	                            max_cid, rohc_py_gen_random_num, NULL);
+	if(self->comp == NULL)
+	{
+		PyErr_SetString(PyExc_ValueError, "failed to create the ROHC compressor");
+		goto error;
+	}
+
+	if(profiles == Py_None)
+	{
+		size_t enabled_nr = 0;
+		size_t i;
+
+		/* the profiles not built in the library are silently skipped */
+		for(i = 0; i < sizeof(rohc_py_default_profiles) / sizeof(int); i++)
+		{
+			if(rohc_comp_enable_profile(self->comp, rohc_py_default_profiles[i]))
+			{
+				enabled_nr++;
+			}
+		}
+		if(enabled_nr == 0)
+		{
+			PyErr_SetString(PyExc_ValueError, "no profile built in the library");
+			goto free_comp;
+		}
+	}
+	else
+	{
+		PyObject *const seq = PySequence_Fast(profiles, "profiles shall be a "
+		                                      "sequence of profile IDs");
+		Py_ssize_t i;
+
+		if(seq == NULL)
+		{
+			goto free_comp;
+		}
+		for(i = 0; i < PySequence_Fast_GET_SIZE(seq); i++)
+		{
+			const long profile = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+
+			if(profile == -1 && PyErr_Occurred())
+			{
+				Py_DECREF(seq);
+				goto free_comp;
+			}
+			if(!rohc_comp_enable_profile(self->comp, profile))
+			{
+				PyErr_Format(PyExc_ValueError, "failed to enable profile 0x%04lx",
+				             profile);
+				Py_DECREF(seq);
+				goto free_comp;
+			}
+		}
+		Py_DECREF(seq);
+	}
+
+	return 0;
+
+free_comp:
+	rohc_comp_free(self->comp);
+	self->comp = NULL;
+error:
+	return -1;
+}
+
+
+static void RohcBurstCompressor_dealloc(RohcBurstCompressor *self)
+{
+	if(self->comp != NULL)
+	{
+		rohc_comp_free(self->comp);
+	}
+	Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+
+static PyObject * RohcBurstCompressor_compress_burst(RohcBurstCompressor *self,
+                                                     PyObject *args)
+{
+	PyObject *pkts;
+	PyObject *lens;
+	PyObject *out;
+	PyObject *out_lens;
+	PyObject *statuses = Py_None;
+	Py_ssize_t slot_len;
+	struct rohc_py_burst burst;
+	size_t done_nr;
+
+	if(!PyArg_ParseTuple(args, "OOOOn|O:compress_burst", &pkts, &lens, &out,
+	                     &out_lens, &slot_len, &statuses))
+	{
+		goto error;
+	}
+	if(self->comp == NULL || self->in_use)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "compressor not initialized or "
+		                "already in use by another thread");
+		goto error;
+	}
+	if(!rohc_py_burst_get(&burst, pkts, lens, out, out_lens, statuses,
+	                      slot_len))
+	{
+		goto error;
+	}
+
+	self->in_use = true;
+	Py_BEGIN_ALLOW_THREADS
+	done_nr = rohc_py_burst_run(&burst, self->comp, rohc_py_compress_burst);
+	Py_END_ALLOW_THREADS
+	self->in_use = false;
+
+	rohc_py_burst_release(&burst);
+	return PyLong_FromSize_t(done_nr);
+
+error:
+	return NULL;
+}
+
+
+static PyMethodDef RohcBurstCompressor_methods[] =
+{
+	{
+		"compress_burst", (PyCFunction) RohcBurstCompressor_compress_burst,
+		METH_VARARGS,
+		"compress_burst(pkts, lens, out, out_lens, slot_len, statuses=None)\n"
+		"\n"
+		"Compress the packets stored back-to-back in pkts, whose lengths are\n"
+		"given by the uint32 buffer lens. The ROHC packet #i is written at\n"
+		"offset i * slot_len of out, and its length in out_lens[i] (0 if the\n"
+		"compression failed). The status of every packet is written in the\n"
+		"optional bytes buffer statuses. Return the number of packets that\n"
+		"were processed: the burst stops on ROHC segmentation."
+	},
+	{ NULL, NULL, 0, NULL }
+};
+
+
+static PyTypeObject RohcBurstCompressorType =
+{
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "_rohc_burst.Compressor",
+	.tp_doc = "Compressor(large_cid=False, max_cid=15, profiles=None)\n"
+	          "\n"
+	          "A ROHC compressor that works on buffers without copying them.",
+	.tp_basicsize = sizeof(RohcBurstCompressor),
+	.tp_itemsize = 0,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc) RohcBurstCompressor_init,
+	.tp_dealloc = (destructor) RohcBurstCompressor_dealloc,
+	.tp_methods = RohcBurstCompressor_methods,
+};
+
+
+/*
+ * The decompressor object
+ */
+
+static int RohcBurstDecompressor_init(RohcBurstDecompressor *self,
+                                      PyObject *args,
+                                      PyObject *kwds)
+{
+	static char *kwlist[] = { "large_cid", "max_cid", "mode", "profiles", NULL };
+	int large_cid = 0;
+	unsigned int max_cid = ROHC_SMALL_CID_MAX;
+	int mode = ROHC_O_MODE;
+	PyObject *profiles = Py_None;
+
+	if(!PyArg_ParseTupleAndKeywords(args, kwds, "|pIiO", kwlist,
+	                                &large_cid, &max_cid, &mode, &profiles))
+	{
+		goto error;
+	}
+	if(self->decomp != NULL)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "decompressor already initialized");
+		goto error;
+	}
+
+	self->decomp = rohc_decomp_new2(large_cid ? ROHC_LARGE_CID : ROHC_SMALL_CID,
+	                                max_cid, mode);
+	if(self->decomp == NULL)
+	{
+		PyErr_SetString(PyExc_ValueError, "failed to create the ROHC "
+		                "decompressor");
+		goto error;
+	}
+
+	if(profiles == Py_None)
+	{
+		size_t enabled_nr = 0;
+		size_t i;
+
+		/* the profiles not built in the library are silently skipped */
+		for(i = 0; i < sizeof(rohc_py_default_profiles) / sizeof(int); i++)
+		{
+			if(rohc_decomp_enable_profile(self->decomp, rohc_py_default_profiles[i]))
+			{
+				enabled_nr++;
+			}
+		}
+		if(enabled_nr == 0)
+		{
+			PyErr_SetString(PyExc_ValueError, "no profile built in the library");
+			goto free_decomp;
+		}
+	}
+	else
+	{
+		PyObject *const seq = PySequence_Fast(profiles, "profiles shall be a "
+		                                      "sequence of profile IDs");
+		Py_ssize_t i;
+
+		if(seq == NULL)
+		{
+			goto free_decomp;
+		}
+		for(i = 0; i < PySequence_Fast_GET_SIZE(seq); i++)
+		{
+			const long profile = PyLong_AsLong(PySequence_Fast_GET_ITEM(seq, i));
+
+			if(profile == -1 && PyErr_Occurred())
+			{
+				Py_DECREF(seq);
+				goto free_decomp;
+			}
+			if(!rohc_decomp_enable_profile(self->decomp, profile))
+			{
+				PyErr_Format(PyExc_ValueError, "failed to enable profile 0x%04lx",
+				             profile);
+				Py_DECREF(seq);
+				goto free_decomp;
+			}
+		}
+		Py_DECREF(seq);
+	}
+
+	return 0;
+
+free_decomp:
+	rohc_decomp_free(self->decomp);
+	self->decomp = NULL;
+error:
+	return -1;
+}
+
+
+static void RohcBurstDecompressor_dealloc(RohcBurstDecompressor *self)
+{
+	if(self->decomp != NULL)
+	{
+		rohc_decomp_free(self->decomp);
+	}
+	Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+
+static PyObject * RohcBurstDecompressor_decompress_burst(RohcBurstDecompressor *self,
+                                                         PyObject *args)
+{
+	PyObject *pkts;
+	PyObject *lens;
+	PyObject *out;
+	PyObject *out_lens;
+	PyObject *statuses = Py_None;
+	Py_ssize_t slot_len;
+	struct rohc_py_burst burst;
+	size_t done_nr;
+
+	if(!PyArg_ParseTuple(args, "OOOOn|O:decompress_burst", &pkts, &lens, &out,
+	                     &out_lens, &slot_len, &statuses))
+	{
+		goto error;
+	}
+	if(self->decomp == NULL || self->in_use)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "decompressor not initialized or "
+		                "already in use by another thread");
+		goto error;
+	}
+	if(!rohc_py_burst_get(&burst, pkts, lens, out, out_lens, statuses,
+	                      slot_len))
+	{
+		goto error;
+	}
+
+	self->in_use = true;
+	Py_BEGIN_ALLOW_THREADS
+	done_nr = rohc_py_burst_run(&burst, self->decomp, rohc_py_decompress_burst);
+	Py_END_ALLOW_THREADS
+	self->in_use = false;
+
+	rohc_py_burst_release(&burst);
+	return PyLong_FromSize_t(done_nr);
+
+error:
+	return NULL;
+}
+
+
+static PyMethodDef RohcBurstDecompressor_methods[] =
+{
+	{
+		"decompress_burst", (PyCFunction) RohcBurstDecompressor_decompress_burst,
+		METH_VARARGS,
+		"decompress_burst(pkts, lens, out, out_lens, slot_len, statuses=None)\n"
+		"\n"
+		"Decompress the ROHC packets stored back-to-back in pkts, whose\n"
+		"lengths are given by the uint32 buffer lens. The packet #i is written\n"
+		"at offset i * slot_len of out, and its length in out_lens[i] (0 if\n"
+		"the decompression failed or if the ROHC packet contained feedback\n"
+		"only). The status of every packet is written in the optional bytes\n"
+		"buffer statuses. Return the number of packets that were processed.\n"
+		"The feedbacks built by the decompressor are not returned."
+	},
+	{ NULL, NULL, 0, NULL }
+};
+
+
+static PyTypeObject RohcBurstDecompressorType =
+{
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "_rohc_burst.Decompressor",
+	.tp_doc = "Decompressor(large_cid=False, max_cid=15, mode=MODE_O, "
+	          "profiles=None)\n"
+	          "\n"
+	          "A ROHC decompressor that works on buffers without copying them.",
+	.tp_basicsize = sizeof(RohcBurstDecompressor),
+	.tp_itemsize = 0,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc) RohcBurstDecompressor_init,
+	.tp_dealloc = (destructor) RohcBurstDecompressor_dealloc,
+	.tp_methods = RohcBurstDecompressor_methods,
+};
+
+
+/*
+ * The module
+ */
+
+static struct PyModuleDef rohc_burst_module =
+{
+	PyModuleDef_HEAD_INIT,
+	.m_name = "_rohc_burst",
+	.m_doc = "Zero-copy binding for the burst API of the ROHC library",
+	.m_size = -1,
+};
+
+
+PyMODINIT_FUNC PyInit__rohc_burst(void)
+{
+	PyObject *module;
+
+	if(PyType_Ready(&RohcBurstCompressorType) < 0 ||
+	   PyType_Ready(&RohcBurstDecompressorType) < 0)
+	{
+		goto error;
+	}
+
+	module = PyModule_Create(&rohc_burst_module);
+	if(module == NULL)
+	{
+		goto error;
+	}
+
+	Py_INCREF(&RohcBurstCompressorType);
+	if(PyModule_AddObject(module, "Compressor",
+	                      (PyObject *) &RohcBurstCompressorType) < 0)
+	{
+		Py_DECREF(&RohcBurstCompressorType);
+		goto free_module;
+	}
+	Py_INCREF(&RohcBurstDecompressorType);
+	if(PyModule_AddObject(module, "Decompressor",
+	                      (PyObject *) &RohcBurstDecompressorType) < 0)
+	{
+		Py_DECREF(&RohcBurstDecompressorType);
+		goto free_module;
+	}
+
+	if(PyModule_AddIntConstant(module, "STATUS_OK", ROHC_STATUS_OK) < 0 ||
+	   PyModule_AddIntConstant(module, "STATUS_SEGMENT", ROHC_STATUS_SEGMENT) < 0 ||
+	   PyModule_AddIntConstant(module, "STATUS_MALFORMED", ROHC_STATUS_MALFORMED) < 0 ||
+	   PyModule_AddIntConstant(module, "STATUS_NO_CONTEXT", ROHC_STATUS_NO_CONTEXT) < 0 ||
+	   PyModule_AddIntConstant(module, "STATUS_BAD_CRC", ROHC_STATUS_BAD_CRC) < 0 ||
+	   PyModule_AddIntConstant(module, "STATUS_OUTPUT_TOO_SMALL",
+	                           ROHC_STATUS_OUTPUT_TOO_SMALL) < 0 ||
+	   PyModule_AddIntConstant(module, "STATUS_ERROR", ROHC_STATUS_ERROR) < 0 ||
+	   PyModule_AddIntConstant(module, "MODE_U", ROHC_U_MODE) < 0 ||
+	   PyModule_AddIntConstant(module, "MODE_O", ROHC_O_MODE) < 0 ||
+	   PyModule_AddIntConstant(module, "MODE_R", ROHC_R_MODE) < 0)
+	{
+		goto free_module;
+	}
+
+	return module;
+
+free_module:
+	Py_DECREF(module);
+error:
+	return NULL;
+}
@@ -40,6 +40,14 @@ rohc_module = Extension('_rohc',
                         library_dirs=['../../src/.libs'],
                         )
 
+# zero-copy binding for the burst API, see rohc_burst.c
+rohc_burst_module = Extension('_rohc_burst',
+                              sources=['rohc_burst.c'],
+                              include_dirs=rohc_inc_dirs,
+                              libraries=['rohc'],
+                              library_dirs=['../../src/.libs'],
+                              )
+
 setup(name             = 'rohc',
       version          = '0.1',
       author           = 'Didier Barvaux',
@@ -47,7 +55,7 @@ setup(name             = 'rohc',
       description      = """Python binding for the ROHC library""",
       license          = 'LGPL version 2.1 or later',
       url              = 'https://rohc-lib.org/',
-      ext_modules      = [rohc_module],
+      ext_modules      = [rohc_module, rohc_burst_module],
       py_modules       = ['rohc', 'RohcCompressor', 'RohcDecompressor'],
       install_requires = ['future'],
       classifiers      = [
@@ -0,0 +1,465 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   packet-rohclib.c
+ * @brief  Wireshark dissector plugin that decodes ROHC with the ROHC library
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The ROHC packets are decompressed by the decompressor of the ROHC library,
+ * so the detection of the packet types and the parsing of the packets are the
+ * ones of the library. One decompressor is created for every direction of
+ * every conversation, since the contexts of one ROHC channel depend on all
+ * the previous packets of the channel.
+ *
+ * The decompression is stateful, so the packets are decompressed only once,
+ * during the first pass on the capture: the results are attached to the
+ * frames and displayed again when the frames are selected later.
+ */
+
+#include <epan/packet.h>
+#include <epan/conversation.h>
+#include <epan/prefs.h>
+#include <epan/expert.h>
+#include <wsutil/plugins.h>
+#include <ws_version.h>
+
+#include <rohc/rohc.h>
+#include <rohc/rohc_decomp.h>
+
+
+/** The EtherType of ROHC over Ethernet */
+#define ROHCLIB_ETHERTYPE  0x22f1
+
+/** The maximal size for the decompressed packets */
+#define ROHCLIB_MAX_PKT_LEN  0xffff
+
+/** The version of the plugin, given by the Makefile */
+#ifndef ROHCLIB_VERSION
+#  define ROHCLIB_VERSION "0.0.0"
+#endif
+
+
+/** The decompressors of one conversation, one per direction */
+struct rohclib_conv
+{
+	/** The source address of the first packet of the conversation */
+	address first_src;
+	/** The port of the first packet of the conversation */
+	guint32 first_srcport;
+	/** The decompressors for the two directions of the conversation */
+	struct rohc_decomp *decomps[2];
+};
+
+
+/** The result of the decompression of one frame */
+struct rohclib_frame
+{
+	/** The status of the decompression */
+	rohc_status_t status;
+	/** The information about the decompressed packet */
+	struct rohc_decomp_pkt_info info;
+	/** The decompressed packet, NULL if none */
+	guint8 *uncomp;
+	/** The length of the decompressed packet */
+	size_t uncomp_len;
+};
+
+
+void plugin_register(void);
+void proto_register_rohclib(void);
+void proto_reg_handoff_rohclib(void);
+
+
+WS_DLL_PUBLIC_DEF const gchar plugin_version[] = ROHCLIB_VERSION;
+WS_DLL_PUBLIC_DEF const int plugin_want_major = WIRESHARK_VERSION_MAJOR;
+WS_DLL_PUBLIC_DEF const int plugin_want_minor = WIRESHARK_VERSION_MINOR;
+
+static int proto_rohclib = -1;
+
+static int hf_rohclib_status = -1;
+static int hf_rohclib_cid = -1;
+static int hf_rohclib_profile = -1;
+static int hf_rohclib_packet_type = -1;
+static int hf_rohclib_state = -1;
+static int hf_rohclib_mode = -1;
+static int hf_rohclib_hdr_len = -1;
+static int hf_rohclib_uncomp_hdr_len = -1;
+static int hf_rohclib_lost = -1;
+static int hf_rohclib_misordered = -1;
+static int hf_rohclib_duplicated = -1;
+static int hf_rohclib_feedbacks = -1;
+
+static gint ett_rohclib = -1;
+
+static expert_field ei_rohclib_failed = EI_INIT;
+
+static dissector_handle_t rohclib_handle;
+static dissector_handle_t ip_handle;
+
+/** Whether the ROHC channels use large CIDs */
+static gboolean rohclib_large_cid = FALSE;
+/** The MAX_CID of the ROHC channels */
+static guint rohclib_max_cid = 15;
+
+/** The profiles enabled on the decompressors, if built in the library */
+static const rohc_profile_t rohclib_profiles[] = {
+	ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	ROHC_PROFILE_ESP, ROHC_PROFILE_IP, ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE,
+	ROHCv2_PROFILE_IP_UDP_RTP, ROHCv2_PROFILE_IP_UDP, ROHCv2_PROFILE_IP_ESP,
+	ROHCv2_PROFILE_IP
+};
+
+/** The buffer in which the packets are decompressed */
+static guint8 rohclib_uncomp_buf[ROHCLIB_MAX_PKT_LEN];
+
+
+/**
+ * @brief Free the decompressors of one conversation with the capture file
+ *
+ * @param allocator  The file-scope memory allocator
+ * @param event      The event on the allocator
+ * @param user_data  The decompressors of the conversation
+ * @return           FALSE to unregister the callback
+ */
+static gboolean rohclib_conv_free(wmem_allocator_t *allocator _U_,
+                                  wmem_cb_event_t event _U_,
+                                  void *user_data)
+{
+	struct rohclib_conv *const conv = user_data;
+	size_t i;
+
+	for(i = 0; i < 2; i++)
+	{
+		if(conv->decomps[i] != NULL)
+		{
+			rohc_decomp_free(conv->decomps[i]);
+			conv->decomps[i] = NULL;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/**
+ * @brief Get the decompressor for the direction of the given packet
+ *
+ * The decompressors of one conversation are created with the first packet
+ * of each direction of the conversation.
+ *
+ * @param pinfo  The information about the packet
+ * @return       The decompressor, NULL if it cannot be created
+ */
+static struct rohc_decomp * rohclib_get_decomp(packet_info *pinfo)
+{
+	conversation_t *const conversation = find_or_create_conversation(pinfo);
+	struct rohclib_conv *conv;
+	size_t dir;
+
+	conv = conversation_get_proto_data(conversation, proto_rohclib);
+	if(conv == NULL)
+	{
+		conv = wmem_new0(wmem_file_scope(), struct rohclib_conv);
+		copy_address_wmem(wmem_file_scope(), &conv->first_src, &pinfo->src);
+		conv->first_srcport = pinfo->srcport;
+		conversation_add_proto_data(conversation, proto_rohclib, conv);
+		wmem_register_callback(wmem_file_scope(), rohclib_conv_free, conv);
+	}
+
+	if(addresses_equal(&conv->first_src, &pinfo->src) &&
+	   conv->first_srcport == pinfo->srcport)
+	{
+		dir = 0;
+	}
+	else
+	{
+		dir = 1;
+	}
+
+	if(conv->decomps[dir] == NULL)
+	{
+		const rohc_cid_type_t cid_type =
+			(rohclib_large_cid ? ROHC_LARGE_CID : ROHC_SMALL_CID);
+		struct rohc_decomp *decomp;
+		size_t profiles_nr = 0;
+		size_t i;
+
+		decomp = rohc_decomp_new2(cid_type, rohclib_max_cid, ROHC_O_MODE);
+		if(decomp == NULL)
+		{
+			goto error;
+		}
+		for(i = 0; i < array_length(rohclib_profiles); i++)
+		{
+			/* the library may be built with some profiles only */
+			if(rohc_decomp_enable_profile(decomp, rohclib_profiles[i]))
+			{
+				profiles_nr++;
+			}
+		}
+		if(profiles_nr == 0)
+		{
+			rohc_decomp_free(decomp);
+			goto error;
+		}
+		conv->decomps[dir] = decomp;
+	}
+
+	return conv->decomps[dir];
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Decompress the ROHC packet of the given frame
+ *
+ * @param tvb    The ROHC packet
+ * @param pinfo  The information about the packet
+ * @return       The result of the decompression
+ */
+static struct rohclib_frame * rohclib_decompress(tvbuff_t *tvb,
+                                                 packet_info *pinfo)
+{
+	struct rohclib_frame *const frame =
+		wmem_new0(wmem_file_scope(), struct rohclib_frame);
+	struct rohc_decomp *const decomp = rohclib_get_decomp(pinfo);
+	const struct rohc_ts arrival_time = {
+		.sec = pinfo->abs_ts.secs,
+		.nsec = pinfo->abs_ts.nsecs
+	};
+	const guint len = tvb_captured_length(tvb);
+	/* the decompressor does not write in the ROHC packet */
+	const struct rohc_buf rohc_packet =
+		rohc_buf_init_full((guint8 *) tvb_get_ptr(tvb, 0, len), len,
+		                   arrival_time);
+	struct rohc_buf uncomp_packet =
+		rohc_buf_init_empty(rohclib_uncomp_buf, ROHCLIB_MAX_PKT_LEN);
+
+	if(decomp == NULL)
+	{
+		frame->status = ROHC_STATUS_NO_MEMORY;
+		goto error;
+	}
+
+	frame->status = rohc_decompress4(decomp, rohc_packet, &uncomp_packet,
+	                                 NULL, NULL, &frame->info);
+	if(frame->status == ROHC_STATUS_OK && uncomp_packet.len > 0)
+	{
+		frame->uncomp = wmem_memdup(wmem_file_scope(),
+		                            rohc_buf_data(uncomp_packet),
+		                            uncomp_packet.len);
+		frame->uncomp_len = uncomp_packet.len;
+	}
+
+error:
+	p_add_proto_data(wmem_file_scope(), pinfo, proto_rohclib, 0, frame);
+	return frame;
+}
+
+
+/**
+ * @brief Dissect one ROHC packet
+ *
+ * @param tvb    The ROHC packet
+ * @param pinfo  The information about the packet
+ * @param tree   The tree of the packet
+ * @param data   Unused
+ * @return       The number of bytes dissected
+ */
+static int dissect_rohclib(tvbuff_t *tvb, packet_info *pinfo,
+                           proto_tree *tree, void *data _U_)
+{
+	struct rohclib_frame *frame;
+	proto_item *ti;
+	proto_tree *rohc_tree;
+
+	col_set_str(pinfo->cinfo, COL_PROTOCOL, "ROHC");
+	col_clear(pinfo->cinfo, COL_INFO);
+
+	/* decompress the packet only during the first pass */
+	frame = p_get_proto_data(wmem_file_scope(), pinfo, proto_rohclib, 0);
+	if(frame == NULL)
+	{
+		if(PINFO_FD_VISITED(pinfo))
+		{
+			return 0;
+		}
+		frame = rohclib_decompress(tvb, pinfo);
+	}
+
+	ti = proto_tree_add_item(tree, proto_rohclib, tvb, 0, -1, ENC_NA);
+	rohc_tree = proto_item_add_subtree(ti, ett_rohclib);
+	proto_tree_add_string(rohc_tree, hf_rohclib_status, tvb, 0, 0,
+	                      rohc_strerror(frame->status));
+	if(frame->status != ROHC_STATUS_OK)
+	{
+		expert_add_info_format(pinfo, ti, &ei_rohclib_failed,
+		                       "ROHC decompression failed: %s",
+		                       rohc_strerror(frame->status));
+		col_add_fstr(pinfo->cinfo, COL_INFO, "ROHC decompression failed: %s",
+		             rohc_strerror(frame->status));
+		return tvb_captured_length(tvb);
+	}
+
+	col_add_fstr(pinfo->cinfo, COL_INFO, "CID %u, %s, %s",
+	             frame->info.cid, rohc_get_profile_descr(frame->info.profile_id),
+	             rohc_get_packet_descr(frame->info.packet_type));
+	proto_item_append_text(ti, ", CID %u, %s", frame->info.cid,
+	                       rohc_get_packet_descr(frame->info.packet_type));
+
+	proto_tree_add_uint(rohc_tree, hf_rohclib_cid, tvb, 0, 0, frame->info.cid);
+	proto_tree_add_string(rohc_tree, hf_rohclib_profile, tvb, 0, 0,
+	                      rohc_get_profile_descr(frame->info.profile_id));
+	proto_tree_add_string(rohc_tree, hf_rohclib_packet_type, tvb, 0, 0,
+	                      rohc_get_packet_descr(frame->info.packet_type));
+	proto_tree_add_string(rohc_tree, hf_rohclib_state, tvb, 0, 0,
+	                      rohc_decomp_get_state_descr(frame->info.context_state));
+	proto_tree_add_string(rohc_tree, hf_rohclib_mode, tvb, 0, 0,
+	                      rohc_get_mode_descr(frame->info.context_mode));
+	proto_tree_add_uint(rohc_tree, hf_rohclib_feedbacks, tvb,
+	                    frame->info.rcvd_feedbacks_offset,
+	                    frame->info.rcvd_feedbacks_len,
+	                    frame->info.rcvd_feedbacks_nr);
+	proto_tree_add_uint(rohc_tree, hf_rohclib_hdr_len, tvb,
+	                    frame->info.rcvd_feedbacks_offset +
+	                    frame->info.rcvd_feedbacks_len,
+	                    frame->info.hdr_len, frame->info.hdr_len);
+	proto_tree_add_uint(rohc_tree, hf_rohclib_uncomp_hdr_len, tvb, 0, 0,
+	                    frame->info.uncomp_hdr_len);
+	proto_tree_add_uint(rohc_tree, hf_rohclib_lost, tvb, 0, 0,
+	                    frame->info.lost_packets_nr);
+	proto_tree_add_uint(rohc_tree, hf_rohclib_misordered, tvb, 0, 0,
+	                    frame->info.misordered_packets_nr);
+	proto_tree_add_boolean(rohc_tree, hf_rohclib_duplicated, tvb, 0, 0,
+	                       frame->info.is_duplicated);
+
+	/* dissect the decompressed packet */
+	if(frame->uncomp != NULL)
+	{
+		tvbuff_t *const uncomp_tvb =
+			tvb_new_child_real_data(tvb, frame->uncomp, frame->uncomp_len,
+			                        frame->uncomp_len);
+
+		add_new_data_source(pinfo, uncomp_tvb, "Decompressed ROHC packet");
+		call_dissector(ip_handle, uncomp_tvb, pinfo, tree);
+	}
+
+	return tvb_captured_length(tvb);
+}
+
+
+/**
+ * @brief Register the protocol, its fields and its preferences
+ */
+void proto_register_rohclib(void)
+{
+	static hf_register_info hf[] = {
+		{ &hf_rohclib_status,
+		  { "Status", "rohclib.status", FT_STRING, BASE_NONE,
+		    NULL, 0x0, "Status of the decompression", HFILL } },
+		{ &hf_rohclib_cid,
+		  { "CID", "rohclib.cid", FT_UINT16, BASE_DEC,
+		    NULL, 0x0, "Context ID", HFILL } },
+		{ &hf_rohclib_profile,
+		  { "Profile", "rohclib.profile", FT_STRING, BASE_NONE,
+		    NULL, 0x0, "Profile of the context", HFILL } },
+		{ &hf_rohclib_packet_type,
+		  { "Packet type", "rohclib.packet_type", FT_STRING, BASE_NONE,
+		    NULL, 0x0, "Type of the ROHC packet", HFILL } },
+		{ &hf_rohclib_state,
+		  { "Context state", "rohclib.state", FT_STRING, BASE_NONE,
+		    NULL, 0x0, "State of the context after the packet", HFILL } },
+		{ &hf_rohclib_mode,
+		  { "Context mode", "rohclib.mode", FT_STRING, BASE_NONE,
+		    NULL, 0x0, "Mode of the context after the packet", HFILL } },
+		{ &hf_rohclib_hdr_len,
+		  { "ROHC header length", "rohclib.hdr_len", FT_UINT32, BASE_DEC,
+		    NULL, 0x0, NULL, HFILL } },
+		{ &hf_rohclib_uncomp_hdr_len,
+		  { "Uncompressed headers length", "rohclib.uncomp_hdr_len",
+		    FT_UINT32, BASE_DEC, NULL, 0x0, NULL, HFILL } },
+		{ &hf_rohclib_lost,
+		  { "Lost packets", "rohclib.lost", FT_UINT32, BASE_DEC,
+		    NULL, 0x0, "Packets possibly lost before the packet", HFILL } },
+		{ &hf_rohclib_misordered,
+		  { "Misordered packets", "rohclib.misordered", FT_UINT32, BASE_DEC,
+		    NULL, 0x0, "Packets before the late packet", HFILL } },
+		{ &hf_rohclib_duplicated,
+		  { "Duplicated", "rohclib.duplicated", FT_BOOLEAN, BASE_NONE,
+		    NULL, 0x0, "Packet possibly duplicated", HFILL } },
+		{ &hf_rohclib_feedbacks,
+		  { "Feedbacks", "rohclib.feedbacks", FT_UINT32, BASE_DEC,
+		    NULL, 0x0, "Piggybacked feedback items", HFILL } },
+	};
+	static gint *ett[] = {
+		&ett_rohclib,
+	};
+	static ei_register_info ei[] = {
+		{ &ei_rohclib_failed,
+		  { "rohclib.failed", PI_MALFORMED, PI_ERROR,
+		    "ROHC decompression failed", EXPFILL } },
+	};
+	module_t *rohclib_module;
+	expert_module_t *expert_rohclib;
+
+	proto_rohclib = proto_register_protocol("RObust Header Compression "
+	                                        "(ROHC library)", "ROHClib",
+	                                        "rohclib");
+	proto_register_field_array(proto_rohclib, hf, array_length(hf));
+	proto_register_subtree_array(ett, array_length(ett));
+	expert_rohclib = expert_register_protocol(proto_rohclib);
+	expert_register_field_array(expert_rohclib, ei, array_length(ei));
+
+	rohclib_module = prefs_register_protocol(proto_rohclib, NULL);
+	prefs_register_bool_preference(rohclib_module, "large_cid", "Large CIDs",
+	                               "Whether the ROHC channels use large CIDs",
+	                               &rohclib_large_cid);
+	prefs_register_uint_preference(rohclib_module, "max_cid", "MAX_CID",
+	                               "The MAX_CID of the ROHC channels", 10,
+	                               &rohclib_max_cid);
+
+	rohclib_handle = register_dissector("rohclib", dissect_rohclib,
+	                                    proto_rohclib);
+}
+
+
+/**
+ * @brief Attach the dissector to ROHC over Ethernet and to Decode As
+ */
+void proto_reg_handoff_rohclib(void)
+{
+	ip_handle = find_dissector("ip");
+	dissector_add_uint("ethertype", ROHCLIB_ETHERTYPE, rohclib_handle);
+	dissector_add_for_decode_as("udp.port", rohclib_handle);
+}
+
+
+/**
+ * @brief Register the plugin
+ */
+void plugin_register(void)
+{
+	static proto_plugin plug;
+
+	plug.register_protoinfo = proto_register_rohclib;
+	plug.register_handoff = proto_reg_handoff_rohclib;
+	proto_register_plugin(&plug);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_trace_events.h
+ * @brief  The tracepoints of the ROHC library in the Linux kernel
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The tracepoints are used through the ROHC_PROBE macros of rohc_probes.h.
+ * They are created in kmod.c.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM rohc
+
+#if !defined(ROHC_TRACE_EVENTS_H) || defined(TRACE_HEADER_MULTI_READ)
+#define ROHC_TRACE_EVENTS_H
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(rohc_comp_packet,
+	TP_PROTO(unsigned int cid, int profile, int packet_type,
+	         size_t uncomp_hdr_len, size_t comp_hdr_len),
+	TP_ARGS(cid, profile, packet_type, uncomp_hdr_len, comp_hdr_len),
+	TP_STRUCT__entry(
+		__field(unsigned int, cid)
+		__field(int, profile)
+		__field(int, packet_type)
+		__field(size_t, uncomp_hdr_len)
+		__field(size_t, comp_hdr_len)
+	),
+	TP_fast_assign(
+		__entry->cid = cid;
+		__entry->profile = profile;
+		__entry->packet_type = packet_type;
+		__entry->uncomp_hdr_len = uncomp_hdr_len;
+		__entry->comp_hdr_len = comp_hdr_len;
+	),
+	TP_printk("cid=%u profile=0x%04x packet_type=%d hdr_len=%zu/%zu",
+	          __entry->cid, __entry->profile, __entry->packet_type,
+	          __entry->uncomp_hdr_len, __entry->comp_hdr_len)
+);
+
+DECLARE_EVENT_CLASS(rohc_ctxt,
+	TP_PROTO(unsigned int cid, int profile),
+	TP_ARGS(cid, profile),
+	TP_STRUCT__entry(
+		__field(unsigned int, cid)
+		__field(int, profile)
+	),
+	TP_fast_assign(
+		__entry->cid = cid;
+		__entry->profile = profile;
+	),
+	TP_printk("cid=%u profile=0x%04x", __entry->cid, __entry->profile)
+);
+
+DEFINE_EVENT(rohc_ctxt, rohc_comp_ctxt_created,
+	TP_PROTO(unsigned int cid, int profile),
+	TP_ARGS(cid, profile)
+);
+
+DEFINE_EVENT(rohc_ctxt, rohc_comp_ctxt_recycled,
+	TP_PROTO(unsigned int cid, int profile),
+	TP_ARGS(cid, profile)
+);
+
+TRACE_EVENT(rohc_comp_state_change,
+	TP_PROTO(unsigned int cid, int profile, int old_state, int new_state),
+	TP_ARGS(cid, profile, old_state, new_state),
+	TP_STRUCT__entry(
+		__field(unsigned int, cid)
+		__field(int, profile)
+		__field(int, old_state)
+		__field(int, new_state)
+	),
+	TP_fast_assign(
+		__entry->cid = cid;
+		__entry->profile = profile;
+		__entry->old_state = old_state;
+		__entry->new_state = new_state;
+	),
+	TP_printk("cid=%u profile=0x%04x state=%d->%d", __entry->cid,
+	          __entry->profile, __entry->old_state, __entry->new_state)
+);
+
+DECLARE_EVENT_CLASS(rohc_ctxt_value,
+	TP_PROTO(unsigned int cid, int profile, int value),
+	TP_ARGS(cid, profile, value),
+	TP_STRUCT__entry(
+		__field(unsigned int, cid)
+		__field(int, profile)
+		__field(int, value)
+	),
+	TP_fast_assign(
+		__entry->cid = cid;
+		__entry->profile = profile;
+		__entry->value = value;
+	),
+	TP_printk("cid=%u profile=0x%04x value=%d", __entry->cid,
+	          __entry->profile, __entry->value)
+);
+
+DEFINE_EVENT(rohc_ctxt_value, rohc_comp_feedback,
+	TP_PROTO(unsigned int cid, int profile, int feedback_type),
+	TP_ARGS(cid, profile, feedback_type)
+);
+
+DEFINE_EVENT(rohc_ctxt_value, rohc_decomp_crc_failure,
+	TP_PROTO(unsigned int cid, int profile, int packet_type),
+	TP_ARGS(cid, profile, packet_type)
+);
+
+DEFINE_EVENT(rohc_ctxt_value, rohc_decomp_crc_repair,
+	TP_PROTO(unsigned int cid, int profile, int repair_algo),
+	TP_ARGS(cid, profile, repair_algo)
+);
+
+#endif /* ROHC_TRACE_EVENTS_H */
+
+/* the header is not in include/trace/events of the kernel tree, it is found
+ * through the include path of the module */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE rohc_trace_events
+#include <trace/define_trace.h>
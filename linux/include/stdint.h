@@ -31,10 +31,14 @@
 
 #include <linux/types.h>
 
+typedef int64_t intmax_t;
 typedef uint64_t uintmax_t;
 
 #define UINT8_MAX   0xffU
 #define UINT16_MAX  0xffffU
+#ifndef UINT64_MAX
+#  define UINT64_MAX  0xffffffffffffffffULL
+#endif
 #define PRIu64      "llu"
 
 #endif /* STDINT_H_ */
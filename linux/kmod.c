@@ -33,6 +33,11 @@
 #include "rohc.h"
 #include "rohc_comp.h"
 #include "rohc_decomp.h"
+#include "kmod_pcpu.h"
+#include "kmod_skb.h"
+
+#define CREATE_TRACE_POINTS
+#include "rohc_trace_events.h"
 
 
 MODULE_VERSION(PACKAGE_VERSION PACKAGE_REVNO);
@@ -59,6 +64,16 @@ EXPORT_SYMBOL_GPL(rohc_packet_is_ir);
 EXPORT_SYMBOL_GPL(rohc_packet_carry_static_info);
 EXPORT_SYMBOL_GPL(rohc_packet_carry_crc_7_or_8);
 
+EXPORT_SYMBOL_GPL(rohc_feedback_ring_new);
+EXPORT_SYMBOL_GPL(rohc_feedback_ring_free);
+EXPORT_SYMBOL_GPL(rohc_channel_set_new);
+EXPORT_SYMBOL_GPL(rohc_channel_set_free);
+EXPORT_SYMBOL_GPL(rohc_trace_ring_new);
+EXPORT_SYMBOL_GPL(rohc_trace_ring_free);
+EXPORT_SYMBOL_GPL(rohc_trace_ring_cb);
+EXPORT_SYMBOL_GPL(rohc_trace_ring_expand);
+EXPORT_SYMBOL_GPL(rohc_perf_histo_bucket_min);
+
 EXPORT_SYMBOL_GPL(rohc_buf_is_malformed);
 EXPORT_SYMBOL_GPL(rohc_buf_is_empty);
 EXPORT_SYMBOL_GPL(rohc_buf_push);
@@ -78,20 +93,52 @@ EXPORT_SYMBOL_GPL(rohc_buf_reset);
 
 /* general */
 EXPORT_SYMBOL_GPL(rohc_comp_new2);
+EXPORT_SYMBOL_GPL(rohc_comp_new_cid_range);
 EXPORT_SYMBOL_GPL(rohc_comp_free);
 EXPORT_SYMBOL_GPL(rohc_compress4);
+EXPORT_SYMBOL_GPL(rohc_compress5);
+EXPORT_SYMBOL_GPL(rohc_compress_with_feedbacks);
+EXPORT_SYMBOL_GPL(rohc_compress_hdr);
+EXPORT_SYMBOL_GPL(rohc_compress_in_place);
+EXPORT_SYMBOL_GPL(rohc_compress_dryrun);
+EXPORT_SYMBOL_GPL(rohc_compress_constrained);
+EXPORT_SYMBOL_GPL(rohc_compress_iov);
+EXPORT_SYMBOL_GPL(rohc_compress_chain);
+EXPORT_SYMBOL_GPL(rohc_compress_hdrs_info);
+EXPORT_SYMBOL_GPL(rohc_compress_burst);
+EXPORT_SYMBOL_GPL(rohc_compress_burst2);
+EXPORT_SYMBOL_GPL(rohc_comp_prefetch);
+EXPORT_SYMBOL_GPL(rohc_compress_gso);
+EXPORT_SYMBOL_GPL(rohc_compress_broadcast);
 EXPORT_SYMBOL_GPL(rohc_comp_pad);
 EXPORT_SYMBOL_GPL(rohc_comp_force_contexts_reinit);
+EXPORT_SYMBOL_GPL(rohc_comp_invalidate_contexts);
+EXPORT_SYMBOL_GPL(rohc_comp_reset);
+EXPORT_SYMBOL_GPL(rohc_comp_expire);
+EXPORT_SYMBOL_GPL(rohc_comp_flow_hash);
 
 /* segment */
 EXPORT_SYMBOL_GPL(rohc_comp_get_segment2);
+EXPORT_SYMBOL_GPL(rohc_comp_get_segment_iov);
 
 /* feedback */
 EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback2);
+EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback_burst);
+EXPORT_SYMBOL_GPL(rohc_comp_set_feedback_ring);
+EXPORT_SYMBOL_GPL(rohc_comp_drain_feedback_ring);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_comp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_comp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_comp_get_stats);
+EXPORT_SYMBOL_GPL(rohc_comp_get_contexts_info);
+EXPORT_SYMBOL_GPL(rohc_comp_save_contexts);
+EXPORT_SYMBOL_GPL(rohc_comp_restore_contexts);
+EXPORT_SYMBOL_GPL(rohc_comp_export_context);
+EXPORT_SYMBOL_GPL(rohc_comp_import_context);
+EXPORT_SYMBOL_GPL(rohc_comp_prewarm_context);
+EXPORT_SYMBOL_GPL(rohc_comp_get_mem_info);
+EXPORT_SYMBOL_GPL(rohc_comp_get_perf_info);
 EXPORT_SYMBOL_GPL(rohc_comp_get_last_packet_info2);
 
 /* configuration */
@@ -103,16 +150,55 @@ EXPORT_SYMBOL_GPL(rohc_comp_disable_profiles);
 EXPORT_SYMBOL_GPL(rohc_comp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_comp_get_mrru);
 EXPORT_SYMBOL_GPL(rohc_comp_get_max_cid);
+EXPORT_SYMBOL_GPL(rohc_comp_get_cid_range);
 EXPORT_SYMBOL_GPL(rohc_comp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_comp_set_optimistic_approach);
+EXPORT_SYMBOL_GPL(rohc_comp_set_adaptive_oa);
+EXPORT_SYMBOL_GPL(rohc_comp_set_loss_estimate);
 EXPORT_SYMBOL_GPL(rohc_comp_set_reorder_ratio);
+EXPORT_SYMBOL_GPL(rohc_comp_set_adaptive_reorder);
+EXPORT_SYMBOL_GPL(rohc_comp_set_reorder_estimate);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_time);
+EXPORT_SYMBOL_GPL(rohc_comp_set_adaptive_refreshes);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ctxt_idle_timeout);
+EXPORT_SYMBOL_GPL(rohc_comp_set_refresh_scheduler);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ip_id_hysteresis);
 EXPORT_SYMBOL_GPL(rohc_comp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ctxt_event_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_set_hash);
+EXPORT_SYMBOL_GPL(rohc_comp_set_crc_engine);
+EXPORT_SYMBOL_GPL(rohc_comp_set_mem_budget);
+EXPORT_SYMBOL_GPL(rohc_comp_set_trace_level);
 EXPORT_SYMBOL_GPL(rohc_comp_set_features);
 
 /* RTP-specific configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_interval);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_ports);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_ts_stride);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ts_timer_jitter);
+EXPORT_SYMBOL_GPL(rohc_comp_set_uncomp_flows_ttl);
+EXPORT_SYMBOL_GPL(rohc_comp_set_bulk_policy);
+EXPORT_SYMBOL_GPL(rohc_comp_set_overload);
+EXPORT_SYMBOL_GPL(rohc_comp_set_overload_latency);
+EXPORT_SYMBOL_GPL(rohc_comp_set_mem_cbs);
+EXPORT_SYMBOL_GPL(rohc_comp_preallocate);
+EXPORT_SYMBOL_GPL(rohc_comp_set_channel_set);
+
+/* groups of compressors */
+EXPORT_SYMBOL_GPL(rohc_comp_group_new);
+EXPORT_SYMBOL_GPL(rohc_comp_group_free);
+EXPORT_SYMBOL_GPL(rohc_comp_group_get_shards_nr);
+EXPORT_SYMBOL_GPL(rohc_comp_group_get_shard);
+EXPORT_SYMBOL_GPL(rohc_comp_group_steer);
+EXPORT_SYMBOL_GPL(rohc_comp_group_route_feedback);
+EXPORT_SYMBOL_GPL(rohc_comp_queue_new);
+EXPORT_SYMBOL_GPL(rohc_comp_queue_free);
+EXPORT_SYMBOL_GPL(rohc_comp_queue_submit);
+EXPORT_SYMBOL_GPL(rohc_comp_queue_submit_burst);
+EXPORT_SYMBOL_GPL(rohc_comp_queue_run);
+EXPORT_SYMBOL_GPL(rohc_comp_queue_reap);
 
 
 /*
@@ -122,12 +208,27 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
 /* general */
 EXPORT_SYMBOL_GPL(rohc_decomp_new2);
 EXPORT_SYMBOL_GPL(rohc_decomp_free);
+EXPORT_SYMBOL_GPL(rohc_decomp_reset);
 EXPORT_SYMBOL_GPL(rohc_decompress3);
+EXPORT_SYMBOL_GPL(rohc_decompress4);
+EXPORT_SYMBOL_GPL(rohc_decompress_in_place);
+EXPORT_SYMBOL_GPL(rohc_decompress_chain);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst2);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst_gro);
+EXPORT_SYMBOL_GPL(rohc_decomp_peek_cid);
+EXPORT_SYMBOL_GPL(rohc_decomp_prefetch);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_decomp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_stats);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_perf_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_context_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_contexts_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_save_contexts);
+EXPORT_SYMBOL_GPL(rohc_decomp_restore_contexts);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_mem_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_last_packet_info);
 
 /* configuration */
@@ -142,8 +243,43 @@ EXPORT_SYMBOL_GPL(rohc_decomp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_rate_limits);
+EXPORT_SYMBOL_GPL(rohc_decomp_flush_feedback);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_feedback_ring);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_reorder);
+EXPORT_SYMBOL_GPL(rohc_decomp_reorder_release);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_ctxt_event_cb);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_mem_budget);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_trace_level);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_features);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_mem_cbs);
+EXPORT_SYMBOL_GPL(rohc_decomp_preallocate);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_crc_engine);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_channel_set);
+
+
+/*
+ * Socket buffers API
+ */
+
+EXPORT_SYMBOL_GPL(rohc_compress_skb);
+EXPORT_SYMBOL_GPL(rohc_decompress_skb);
+
+
+/*
+ * Per-CPU or per-queue instances API
+ */
+
+EXPORT_SYMBOL_GPL(rohc_pcpu_new);
+EXPORT_SYMBOL_GPL(rohc_pcpu_free);
+EXPORT_SYMBOL_GPL(rohc_pcpu_get_instances_nr);
+EXPORT_SYMBOL_GPL(rohc_pcpu_get_comp);
+EXPORT_SYMBOL_GPL(rohc_pcpu_get_decomp);
+EXPORT_SYMBOL_GPL(rohc_pcpu_steer);
+EXPORT_SYMBOL_GPL(rohc_pcpu_compress);
+EXPORT_SYMBOL_GPL(rohc_pcpu_decompress);
+EXPORT_SYMBOL_GPL(rohc_pcpu_flush_feedbacks);
+EXPORT_SYMBOL_GPL(rohc_pcpu_get_dropped_feedbacks);
 
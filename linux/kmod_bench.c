@@ -0,0 +1,581 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   kmod_bench.c
+ * @brief  In-kernel benchmark of the ROHC library for the test module
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include <linux/module.h>
+#include <linux/uaccess.h>
+#include <linux/proc_fs.h>
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/kthread.h>
+#include <linux/completion.h>
+#include <linux/mutex.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/fs.h>
+
+#include "config.h"
+#include "rohc.h"
+#include "rohc_comp.h"
+#include "rohc_decomp.h"
+
+#include "kmod_bench.h"
+
+
+/** The name of the file to inject the capture and to read the report */
+#define PROC_BENCH_NAME "rohc_bench"
+
+/** The maximal size of the injected capture (length prefixes included) */
+#define ROHC_BENCH_CAPTURE_MAX  (32 * 1024 * 1024)
+
+/** The room reserved for the ROHC overhead of every packet of the capture */
+#define ROHC_BENCH_OVERHEAD  256
+
+/** The maximal size for the decompressed IP packets */
+#define ROHC_BENCH_IP_MAX  0xffff
+
+
+/** Custom pr_info() macro for the module */
+#define rohc_info(format, ...) \
+	pr_info("[%s] " format, THIS_MODULE->name, ##__VA_ARGS__)
+
+/** Custom pr_err() macro for the module */
+#define rohc_err(format, ...) \
+	pr_err("[%s] " format, THIS_MODULE->name, ##__VA_ARGS__)
+
+
+/** The number of times the capture is replayed */
+static unsigned int bench_iters = 100;
+module_param(bench_iters, uint, 0644);
+MODULE_PARM_DESC(bench_iters, "Number of times the capture is replayed");
+
+/** The CPU to run the benchmark on, -1 to let the scheduler choose */
+static int bench_cpu = -1;
+module_param(bench_cpu, int, 0644);
+MODULE_PARM_DESC(bench_cpu, "CPU to run the benchmark on (-1 for any)");
+
+
+/** The state of the in-kernel benchmark */
+struct rohc_bench {
+	/** The injected capture: IP packets prefixed by their lengths */
+	uint8_t *capture;
+	/** The number of bytes of capture injected so far */
+	size_t capture_len;
+
+	/** Whether the kernel thread shall stop as soon as possible */
+	bool stop;
+	/** Signaled by the kernel thread once the benchmark is over */
+	struct completion done;
+	/** The result of the benchmark: 0 in case of success, -errno otherwise */
+	int status;
+
+	/** The number of packets in the capture */
+	u64 pkts_nr;
+	/** The number of times the capture was replayed */
+	u64 iters_nr;
+	/** The time spent in compression (in nanoseconds) */
+	u64 comp_ns;
+	/** The time spent in decompression (in nanoseconds) */
+	u64 decomp_ns;
+	/** The number of packets that failed to be compressed */
+	u64 comp_errs;
+	/** The number of packets that failed to be decompressed */
+	u64 decomp_errs;
+
+	/** The text report of the last benchmark */
+	char report[512];
+	/** The length of the text report */
+	size_t report_len;
+};
+
+
+/** The one benchmark of the module */
+static struct rohc_bench bench;
+
+/** Serialize the accesses to the benchmark from userspace */
+static DEFINE_MUTEX(bench_lock);
+
+
+/**
+ * @brief Generate a false random number for the benchmark
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int rohc_bench_rand(const struct rohc_comp *const comp,
+			   void *const user_context)
+{
+	return 0;
+}
+
+
+/**
+ * @brief Count the packets of the injected capture
+ *
+ * @param b  The benchmark
+ * @return   The number of packets, -EINVAL if the capture is truncated
+ */
+static long rohc_bench_count_pkts(const struct rohc_bench *const b)
+{
+	size_t offset = 0;
+	long pkts_nr = 0;
+
+	while (offset < b->capture_len) {
+		uint16_t pkt_len;
+
+		if ((b->capture_len - offset) < sizeof(uint16_t))
+			return -EINVAL;
+		memcpy(&pkt_len, b->capture + offset, sizeof(uint16_t));
+		offset += sizeof(uint16_t);
+		if (pkt_len == 0 || (b->capture_len - offset) < pkt_len)
+			return -EINVAL;
+		offset += pkt_len;
+		pkts_nr++;
+	}
+
+	return pkts_nr;
+}
+
+
+/**
+ * @brief Create the compressor and the decompressor of the benchmark
+ *
+ * All the profiles enabled by the test module are enabled.
+ *
+ * @param[out] comp    The ROHC compressor
+ * @param[out] decomp  The ROHC decompressor
+ * @return             0 in case of success, -ENOMEM otherwise
+ */
+static int rohc_bench_new_couple(struct rohc_comp **const comp,
+				 struct rohc_decomp **const decomp)
+{
+	*comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+			       rohc_bench_rand, NULL);
+	if (*comp == NULL)
+		goto error;
+	if (!rohc_comp_enable_profiles(*comp,
+			ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_RTP,
+			ROHC_PROFILE_UDP, ROHC_PROFILE_ESP, ROHC_PROFILE_IP,
+			ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE, -1))
+		goto free_comp;
+
+	*decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+				   ROHC_U_MODE);
+	if (*decomp == NULL)
+		goto free_comp;
+	if (!rohc_decomp_enable_profiles(*decomp,
+			ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_RTP,
+			ROHC_PROFILE_UDP, ROHC_PROFILE_ESP, ROHC_PROFILE_IP,
+			ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE, -1))
+		goto free_decomp;
+
+	return 0;
+
+free_decomp:
+	rohc_decomp_free(*decomp);
+free_comp:
+	rohc_comp_free(*comp);
+error:
+	return -ENOMEM;
+}
+
+
+/**
+ * @brief Replay the injected capture through one compressor/decompressor
+ *
+ * Every replay compresses all the packets of the capture, then decompresses
+ * all the ROHC packets, so that the two timings do not include the cost of
+ * reading the clock for every packet.
+ *
+ * @param b  The benchmark
+ * @return   0 in case of success, -errno otherwise
+ */
+static int rohc_bench_run(struct rohc_bench *const b)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint8_t *rohc_pkts;
+	size_t *rohc_lens;
+	uint8_t *ip_pkt;
+	long pkts_nr;
+	int err;
+
+	pkts_nr = rohc_bench_count_pkts(b);
+	if (pkts_nr <= 0) {
+		rohc_err("no capture or truncated capture injected\n");
+		err = -EINVAL;
+		goto error;
+	}
+	b->pkts_nr = pkts_nr;
+
+	err = -ENOMEM;
+	rohc_pkts = vmalloc(b->capture_len + pkts_nr * ROHC_BENCH_OVERHEAD);
+	if (rohc_pkts == NULL)
+		goto error;
+	rohc_lens = vmalloc(pkts_nr * sizeof(size_t));
+	if (rohc_lens == NULL)
+		goto free_rohc_pkts;
+	ip_pkt = kmalloc(ROHC_BENCH_IP_MAX, GFP_KERNEL);
+	if (ip_pkt == NULL)
+		goto free_rohc_lens;
+	err = rohc_bench_new_couple(&comp, &decomp);
+	if (err != 0)
+		goto free_ip_pkt;
+
+	for (b->iters_nr = 0; b->iters_nr < bench_iters; b->iters_nr++) {
+		size_t capture_offset = 0;
+		size_t rohc_offset = 0;
+		u64 start;
+		long i;
+
+		/* compress all the packets of the capture */
+		start = ktime_get_ns();
+		for (i = 0; i < pkts_nr; i++) {
+			uint16_t pkt_len;
+			struct rohc_buf ip_packet;
+			struct rohc_buf rohc_packet;
+
+			memcpy(&pkt_len, b->capture + capture_offset,
+			       sizeof(uint16_t));
+			capture_offset += sizeof(uint16_t);
+			ip_packet = rohc_buf_init_full(b->capture +
+						       capture_offset,
+						       pkt_len, arrival_time);
+			rohc_packet = rohc_buf_init_empty(rohc_pkts +
+							  rohc_offset,
+							  pkt_len +
+							  ROHC_BENCH_OVERHEAD);
+			if (rohc_compress4(comp, ip_packet, &rohc_packet) !=
+			    ROHC_STATUS_OK) {
+				b->comp_errs++;
+				rohc_lens[i] = 0;
+			} else {
+				rohc_lens[i] = rohc_packet.len;
+			}
+			capture_offset += pkt_len;
+			rohc_offset += pkt_len + ROHC_BENCH_OVERHEAD;
+		}
+		b->comp_ns += ktime_get_ns() - start;
+
+		/* decompress all the ROHC packets */
+		rohc_offset = 0;
+		capture_offset = 0;
+		start = ktime_get_ns();
+		for (i = 0; i < pkts_nr; i++) {
+			uint16_t pkt_len;
+
+			memcpy(&pkt_len, b->capture + capture_offset,
+			       sizeof(uint16_t));
+			capture_offset += sizeof(uint16_t) + pkt_len;
+
+			if (rohc_lens[i] > 0) {
+				const struct rohc_buf rohc_packet =
+					rohc_buf_init_full(rohc_pkts +
+							   rohc_offset,
+							   rohc_lens[i],
+							   arrival_time);
+				struct rohc_buf ip_packet =
+					rohc_buf_init_empty(ip_pkt,
+							    ROHC_BENCH_IP_MAX);
+
+				if (rohc_decompress3(decomp, rohc_packet,
+						     &ip_packet, NULL, NULL) !=
+				    ROHC_STATUS_OK)
+					b->decomp_errs++;
+			}
+			rohc_offset += pkt_len + ROHC_BENCH_OVERHEAD;
+		}
+		b->decomp_ns += ktime_get_ns() - start;
+
+		if (READ_ONCE(b->stop))
+			break;
+		cond_resched();
+	}
+	err = 0;
+
+	rohc_decomp_free(decomp);
+	rohc_comp_free(comp);
+free_ip_pkt:
+	kfree(ip_pkt);
+free_rohc_lens:
+	vfree(rohc_lens);
+free_rohc_pkts:
+	vfree(rohc_pkts);
+error:
+	return err;
+}
+
+
+/**
+ * @brief The kernel thread that runs the benchmark
+ *
+ * @param arg  The benchmark
+ * @return     Always 0
+ */
+static int rohc_bench_thread(void *arg)
+{
+	struct rohc_bench *const b = arg;
+
+	b->status = rohc_bench_run(b);
+	complete(&b->done);
+
+	return 0;
+}
+
+
+/**
+ * @brief Build the text report of the last benchmark
+ *
+ * @param b  The benchmark
+ */
+static void rohc_bench_report(struct rohc_bench *const b)
+{
+	const u64 pkts_nr = b->pkts_nr * b->iters_nr;
+	u64 comp_pps = 0;
+	u64 decomp_pps = 0;
+	u64 comp_ns_per_pkt = 0;
+	u64 decomp_ns_per_pkt = 0;
+
+	if (b->status != 0) {
+		b->report_len = scnprintf(b->report, sizeof(b->report),
+					  "error: %d\n", b->status);
+		return;
+	}
+
+	if (pkts_nr > 0) {
+		comp_ns_per_pkt = div64_u64(b->comp_ns, pkts_nr);
+		decomp_ns_per_pkt = div64_u64(b->decomp_ns, pkts_nr);
+	}
+	if (b->comp_ns > 0)
+		comp_pps = div64_u64(pkts_nr * NSEC_PER_SEC, b->comp_ns);
+	if (b->decomp_ns > 0)
+		decomp_pps = div64_u64(pkts_nr * NSEC_PER_SEC, b->decomp_ns);
+
+	b->report_len = scnprintf(b->report, sizeof(b->report),
+				  "packets: %llu\n"
+				  "iterations: %llu\n"
+				  "compression: %llu packets/s, %llu ns/packet, %llu errors\n"
+				  "decompression: %llu packets/s, %llu ns/packet, %llu errors\n",
+				  b->pkts_nr, b->iters_nr,
+				  comp_pps, comp_ns_per_pkt, b->comp_errs,
+				  decomp_pps, decomp_ns_per_pkt,
+				  b->decomp_errs);
+}
+
+
+/**
+ * @brief Run the benchmark in a kernel thread and wait for its end
+ *
+ * @param b  The benchmark
+ * @return   0 if the benchmark ran, -errno if the kernel thread failed
+ */
+static int rohc_bench_start(struct rohc_bench *const b)
+{
+	struct task_struct *thread;
+
+	b->stop = false;
+	b->status = 0;
+	b->iters_nr = 0;
+	b->comp_ns = 0;
+	b->decomp_ns = 0;
+	b->comp_errs = 0;
+	b->decomp_errs = 0;
+	init_completion(&b->done);
+
+	thread = kthread_create(rohc_bench_thread, b, "rohc_bench");
+	if (IS_ERR(thread)) {
+		rohc_err("failed to create the benchmark thread\n");
+		return PTR_ERR(thread);
+	}
+	if (bench_cpu >= 0 && cpu_online(bench_cpu))
+		kthread_bind(thread, bench_cpu);
+	wake_up_process(thread);
+
+	/* stop the benchmark early if userspace is interrupted, but always
+	 * wait for the thread since it uses the capture
+	 */
+	if (wait_for_completion_interruptible(&b->done) != 0) {
+		WRITE_ONCE(b->stop, true);
+		wait_for_completion(&b->done);
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief Called when /proc/rohc_bench is opened by userspace
+ *
+ * Opening the file for writing clears the injected capture.
+ *
+ * @param inode  The inode information on the /proc file
+ * @param file   The file information on the /proc file
+ * @return       0 in case of success, -ENOMEM if memory allocation fails
+ */
+static int rohc_bench_open(struct inode *inode, struct file *file)
+{
+	int err = 0;
+
+	if (!(file->f_mode & FMODE_WRITE))
+		return 0;
+
+	mutex_lock(&bench_lock);
+	if (bench.capture == NULL) {
+		bench.capture = vmalloc(ROHC_BENCH_CAPTURE_MAX);
+		if (bench.capture == NULL) {
+			rohc_err("failed allocate %d bytes of memory\n",
+				 ROHC_BENCH_CAPTURE_MAX);
+			err = -ENOMEM;
+		}
+	}
+	bench.capture_len = 0;
+	mutex_unlock(&bench_lock);
+
+	return err;
+}
+
+
+/**
+ * @brief Handle a write to /proc/rohc_bench file from userspace
+ *
+ * The data is appended to the capture, so that one capture may be injected
+ * in several writes.
+ *
+ * @param file    The /proc file userspace writes to
+ * @param buffer  The data userspace writes
+ * @param count   The number of bytes of data
+ * @param ppos    The position in the file
+ * @return        The number of bytes of data handled by the function,
+ *                -ENOSPC if the capture is too large,
+ *                -EFAULT if another error occurs
+ */
+static ssize_t rohc_bench_write(struct file *file,
+				const char __user *buffer,
+				size_t count,
+				loff_t *ppos)
+{
+	ssize_t err;
+
+	mutex_lock(&bench_lock);
+	if (count > (ROHC_BENCH_CAPTURE_MAX - bench.capture_len)) {
+		rohc_err("capture is larger than %d bytes\n",
+			 ROHC_BENCH_CAPTURE_MAX);
+		err = -ENOSPC;
+		goto unlock;
+	}
+	if (copy_from_user(bench.capture + bench.capture_len, buffer, count)) {
+		rohc_err("failed to copy %zd bytes of capture from userspace to kernel\n",
+			 count);
+		err = -EFAULT;
+		goto unlock;
+	}
+	bench.capture_len += count;
+	*ppos += count;
+	err = count;
+
+unlock:
+	mutex_unlock(&bench_lock);
+	return err;
+}
+
+
+/**
+ * @brief Handle a read from /proc/rohc_bench file from userspace
+ *
+ * The benchmark is run when the file is read from its beginning, the report
+ * is then returned.
+ *
+ * @param file    The /proc file userspace reads from
+ * @param buffer  The data userspace reads
+ * @param count   The number of bytes of data
+ * @param ppos    The position in the file
+ * @return        The number of bytes of data handled by the function,
+ *                -errno if the benchmark failed to run
+ */
+static ssize_t rohc_bench_read(struct file *file,
+			       char __user *buffer,
+			       size_t count,
+			       loff_t *ppos)
+{
+	ssize_t err;
+
+	mutex_lock(&bench_lock);
+	if (*ppos == 0) {
+		err = rohc_bench_start(&bench);
+		if (err != 0)
+			goto unlock;
+		rohc_bench_report(&bench);
+		rohc_info("benchmark of %zu bytes of capture:\n%s",
+			  bench.capture_len, bench.report);
+	}
+	err = simple_read_from_buffer(buffer, count, ppos, bench.report,
+				      bench.report_len);
+
+unlock:
+	mutex_unlock(&bench_lock);
+	return err;
+}
+
+
+/** File operations for /proc/rohc_bench */
+static const struct file_operations rohc_bench_fops = {
+	.owner   = THIS_MODULE,
+	.open    = rohc_bench_open,
+	.write   = rohc_bench_write,
+	.read    = rohc_bench_read,
+};
+
+
+/**
+ * @brief Create the /proc/rohc_bench entry
+ *
+ * @return  0 in case of success, 1 in case of error
+ */
+int rohc_bench_init(void)
+{
+	struct proc_dir_entry *proc_file;
+
+	rohc_info("\tcreate interface /proc/%s...\n", PROC_BENCH_NAME);
+	proc_file = proc_create(PROC_BENCH_NAME, S_IFREG|0600, NULL,
+				&rohc_bench_fops);
+	if (proc_file == NULL) {
+		rohc_err("\tfailed to create /proc/%s\n", PROC_BENCH_NAME);
+		return 1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief Release the /proc/rohc_bench entry and the injected capture
+ */
+void rohc_bench_release(void)
+{
+	remove_proc_entry(PROC_BENCH_NAME, NULL);
+	vfree(bench.capture);
+	bench.capture = NULL;
+	bench.capture_len = 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   kmod_bench.h
+ * @brief  In-kernel benchmark of the ROHC library for the test module
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * A capture of IP packets is injected in the kernel through the
+ * /proc/rohc_bench file: every packet is prefixed by its length on 16 bits
+ * (host byte order), as for the other /proc files of the test module. The
+ * capture is cleared every time the file is opened for writing.
+ *
+ * Reading /proc/rohc_bench replays the capture in a kernel thread: the
+ * packets are compressed, then the ROHC packets are decompressed, as many
+ * times as the bench_iters module parameter says. The report gives the
+ * number of packets per second and the nanoseconds per packet for both the
+ * compression and the decompression, so that they may be compared with the
+ * numbers of the userspace rohc_bench tool. The bench_cpu module parameter
+ * pins the kernel thread on one CPU.
+ */
+
+#ifndef ROHC_KMOD_BENCH_H
+#define ROHC_KMOD_BENCH_H
+
+int rohc_bench_init(void);
+void rohc_bench_release(void);
+
+#endif
+
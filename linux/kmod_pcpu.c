@@ -0,0 +1,728 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   kmod_pcpu.c
+ * @brief  Per-CPU or per-queue ROHC instances for the Linux kernel datapath
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <linux/llist.h>
+#include <linux/atomic.h>
+#include <linux/topology.h>
+#include <linux/cpumask.h>
+#include <linux/string.h>
+
+#include "kmod_pcpu.h"
+
+
+/** The maximal length of one feedback item, header included */
+#define ROHC_PCPU_FEEDBACK_MAX_LEN  (2U + 255U)
+
+/** The maximal length of the feedbacks piggybacked on one ROHC packet */
+#define ROHC_PCPU_FEEDBACKS_MAX_LEN  2048U
+
+
+/** One feedback item exchanged between two instances */
+struct rohc_pcpu_feedback
+{
+	/** The node in the list of feedbacks of the destination instance */
+	struct llist_node node;
+	/** The length of the feedback item */
+	size_t len;
+	/** The feedback item, header included */
+	uint8_t data[];
+};
+
+
+/** One instance of a ROHC channel, ie. one compressor and one decompressor */
+struct rohc_pcpu_instance
+{
+	/** The NUMA node the memory of the instance is allocated on */
+	int node;
+
+	/** The lock that serializes the users of the compressor */
+	spinlock_t comp_lock;
+	/** The compressor of the instance, it belongs to the group */
+	struct rohc_comp *comp;
+	/** The feedbacks to send that are not piggybacked yet */
+	struct rohc_buf feedbacks_send;
+	/** The memory of the feedbacks to send */
+	uint8_t feedbacks_send_data[ROHC_PCPU_FEEDBACKS_MAX_LEN];
+
+	/** The lock that serializes the users of the decompressor */
+	spinlock_t decomp_lock;
+	/** The decompressor of the instance */
+	struct rohc_decomp *decomp;
+	/** The memory of the feedbacks the decompressor received */
+	uint8_t rcvd_feedbacks_data[ROHC_PCPU_FEEDBACKS_MAX_LEN];
+	/** The memory of the feedbacks the decompressor built */
+	uint8_t built_feedbacks_data[ROHC_PCPU_FEEDBACKS_MAX_LEN];
+
+	/** The received feedbacks for the contexts of the compressor, queued by
+	 *  the decompressors of all the instances */
+	struct llist_head rcvd_feedbacks;
+	/** The feedbacks to send, queued by the decompressor of the instance */
+	struct llist_head built_feedbacks;
+} ____cacheline_aligned_in_smp;
+
+
+/** The instances of one ROHC channel */
+struct rohc_pcpu
+{
+	/** The group of compressors, one shard per instance */
+	struct rohc_comp_group *group;
+	/** The number of CIDs on the ROHC channel */
+	size_t cids_nr;
+	/** The number of instances */
+	size_t instances_nr;
+	/** The instances */
+	struct rohc_pcpu_instance **instances;
+	/** The number of feedbacks dropped because of memory shortage */
+	atomic_long_t dropped_feedbacks_nr;
+};
+
+
+static void * rohc_pcpu_mem_alloc(const size_t size, void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+static void rohc_pcpu_mem_free(void *const ptr,
+                               const size_t size,
+                               void *const priv_ctxt);
+
+static size_t rohc_pcpu_cid_owner(const struct rohc_pcpu *const pcpu,
+                                  const rohc_cid_t cid)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void rohc_pcpu_queue_feedback(struct rohc_pcpu *const pcpu,
+                                     struct llist_head *const list,
+                                     const struct rohc_buf feedback)
+	__attribute__((nonnull(1, 2)));
+static void rohc_pcpu_route_feedbacks(struct rohc_pcpu *const pcpu,
+                                      struct rohc_buf feedbacks)
+	__attribute__((nonnull(1)));
+static void rohc_pcpu_drain_feedbacks(struct rohc_pcpu *const pcpu,
+                                      struct rohc_pcpu_instance *const instance)
+	__attribute__((nonnull(1, 2)));
+
+
+/**
+ * @brief Create the instances of a new ROHC channel
+ *
+ * Create one compressor and one decompressor for every instance. The CIDs of
+ * the channel are split in as many disjoint ranges as instances, every
+ * instance owning one range, see \ref rohc_comp_group_new. The memory of the
+ * contexts of every instance is allocated on the NUMA node of the CPU with
+ * the same index, if any, so that one instance per CPU only works on local
+ * memory.
+ *
+ * The compressors and decompressors shall then be configured the same way
+ * with the functions that are available for one compressor or decompressor.
+ * Retrieve them with \ref rohc_pcpu_get_comp and \ref rohc_pcpu_get_decomp.
+ * ROHC segmentation is not supported: the contexts of segmented packets
+ * might not be owned by the right instance.
+ *
+ * The function may sleep.
+ *
+ * @param cid_type      The type of Context IDs (CID) of the ROHC channel
+ * @param max_cid       The maximum value of CIDs on the ROHC channel
+ * @param instances_nr  The number of instances, eg. the number of CPUs or
+ *                      of queues, in range [1, \e max_cid + 1]
+ * @param decomp_mode   The operational mode of the decompressors
+ * @param rand_cb       The random callback of the compressors, it shall be
+ *                      thread-safe
+ * @param rand_priv     Private data that will be given to the callback
+ * @return              The created instances if successful,
+ *                      NULL if creation failed
+ *
+ * @see rohc_pcpu_free
+ */
+struct rohc_pcpu * rohc_pcpu_new(const rohc_cid_type_t cid_type,
+                                 const rohc_cid_t max_cid,
+                                 const size_t instances_nr,
+                                 const rohc_mode_t decomp_mode,
+                                 const rohc_comp_random_cb_t rand_cb,
+                                 void *const rand_priv)
+{
+	struct rohc_pcpu *pcpu;
+	size_t i;
+
+	pcpu = kzalloc(sizeof(struct rohc_pcpu), GFP_KERNEL);
+	if(pcpu == NULL)
+	{
+		goto error;
+	}
+	pcpu->cids_nr = max_cid + 1;
+	atomic_long_set(&pcpu->dropped_feedbacks_nr, 0);
+
+	pcpu->group = rohc_comp_group_new(cid_type, max_cid, instances_nr,
+	                                  rand_cb, rand_priv);
+	if(pcpu->group == NULL)
+	{
+		goto free_pcpu;
+	}
+	pcpu->instances = kcalloc(instances_nr, sizeof(struct rohc_pcpu_instance *),
+	                          GFP_KERNEL);
+	if(pcpu->instances == NULL)
+	{
+		goto free_pcpu;
+	}
+
+	for(i = 0; i < instances_nr; i++)
+	{
+		const int node = (i < nr_cpu_ids ? cpu_to_node(i) : NUMA_NO_NODE);
+		struct rohc_pcpu_instance *instance;
+
+		instance = kzalloc_node(sizeof(struct rohc_pcpu_instance), GFP_KERNEL,
+		                        node);
+		if(instance == NULL)
+		{
+			goto free_pcpu;
+		}
+		pcpu->instances[i] = instance;
+		pcpu->instances_nr++;
+
+		instance->node = node;
+		spin_lock_init(&instance->comp_lock);
+		spin_lock_init(&instance->decomp_lock);
+		init_llist_head(&instance->rcvd_feedbacks);
+		init_llist_head(&instance->built_feedbacks);
+		instance->feedbacks_send.time.sec = 0;
+		instance->feedbacks_send.time.nsec = 0;
+		instance->feedbacks_send.data = instance->feedbacks_send_data;
+		instance->feedbacks_send.max_len = ROHC_PCPU_FEEDBACKS_MAX_LEN;
+		instance->feedbacks_send.offset = 0;
+		instance->feedbacks_send.len = 0;
+
+		instance->comp = rohc_comp_group_get_shard(pcpu->group, i);
+		if(!rohc_comp_set_mem_cbs(instance->comp, rohc_pcpu_mem_alloc,
+		                          rohc_pcpu_mem_free, instance))
+		{
+			goto free_pcpu;
+		}
+
+		instance->decomp = rohc_decomp_new2(cid_type, max_cid, decomp_mode);
+		if(instance->decomp == NULL)
+		{
+			goto free_pcpu;
+		}
+		if(!rohc_decomp_set_mem_cbs(instance->decomp, rohc_pcpu_mem_alloc,
+		                            rohc_pcpu_mem_free, instance))
+		{
+			goto free_pcpu;
+		}
+	}
+
+	return pcpu;
+
+free_pcpu:
+	rohc_pcpu_free(pcpu);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the instances of a ROHC channel
+ *
+ * The instances shall not be in use anymore. The feedbacks that are still
+ * queued are dropped.
+ *
+ * @param pcpu  The instances to destroy
+ *
+ * @see rohc_pcpu_new
+ */
+void rohc_pcpu_free(struct rohc_pcpu *const pcpu)
+{
+	if(pcpu != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < pcpu->instances_nr; i++)
+		{
+			struct rohc_pcpu_instance *const instance = pcpu->instances[i];
+			struct rohc_pcpu_feedback *feedback;
+			struct rohc_pcpu_feedback *next;
+
+			llist_for_each_entry_safe(feedback, next,
+			                          llist_del_all(&instance->rcvd_feedbacks), node)
+			{
+				kfree(feedback);
+			}
+			llist_for_each_entry_safe(feedback, next,
+			                          llist_del_all(&instance->built_feedbacks), node)
+			{
+				kfree(feedback);
+			}
+			rohc_decomp_free(instance->decomp);
+		}
+
+		/* free the compressors before the instances they allocate memory for */
+		rohc_comp_group_free(pcpu->group);
+		for(i = 0; i < pcpu->instances_nr; i++)
+		{
+			kfree(pcpu->instances[i]);
+		}
+		kfree(pcpu->instances);
+		kfree(pcpu);
+	}
+}
+
+
+/**
+ * @brief Get the number of instances of a ROHC channel
+ *
+ * @param pcpu  The instances of the ROHC channel
+ * @return      The number of instances, 0 if \e pcpu is not valid
+ */
+size_t rohc_pcpu_get_instances_nr(const struct rohc_pcpu *const pcpu)
+{
+	if(pcpu == NULL)
+	{
+		return 0;
+	}
+
+	return pcpu->instances_nr;
+}
+
+
+/**
+ * @brief Get the compressor of one instance, eg. to configure it
+ *
+ * The compressor belongs to the instance: it shall not be destroyed with
+ * \ref rohc_comp_free, nor used for compression while the instances are in
+ * use, see \ref rohc_pcpu_compress instead.
+ *
+ * @param pcpu          The instances of the ROHC channel
+ * @param instance_idx  The index of the instance
+ * @return              The compressor, NULL if an argument is not valid
+ */
+struct rohc_comp * rohc_pcpu_get_comp(const struct rohc_pcpu *const pcpu,
+                                      const size_t instance_idx)
+{
+	if(pcpu == NULL || instance_idx >= pcpu->instances_nr)
+	{
+		return NULL;
+	}
+
+	return pcpu->instances[instance_idx]->comp;
+}
+
+
+/**
+ * @brief Get the decompressor of one instance, eg. to configure it
+ *
+ * The decompressor belongs to the instance: it shall not be destroyed with
+ * \ref rohc_decomp_free, nor used for decompression while the instances are
+ * in use, see \ref rohc_pcpu_decompress instead.
+ *
+ * @param pcpu          The instances of the ROHC channel
+ * @param instance_idx  The index of the instance
+ * @return              The decompressor, NULL if an argument is not valid
+ */
+struct rohc_decomp * rohc_pcpu_get_decomp(const struct rohc_pcpu *const pcpu,
+                                          const size_t instance_idx)
+{
+	if(pcpu == NULL || instance_idx >= pcpu->instances_nr)
+	{
+		return NULL;
+	}
+
+	return pcpu->instances[instance_idx]->decomp;
+}
+
+
+/**
+ * @brief Find out which instance shall compress a packet
+ *
+ * All the packets of one flow are steered to the same instance, see
+ * \ref rohc_comp_group_steer. A network device may use the index as TX queue
+ * in its ndo_select_queue() callback, so that the compressor of every queue
+ * is never contended.
+ *
+ * @param pcpu               The instances of the ROHC channel
+ * @param uncomp_packet      The uncompressed packet to steer
+ * @param[out] instance_idx  The index of the instance that shall compress the
+ *                           packet
+ * @return                   true if the packet was steered,
+ *                           false if no enabled profile may compress it
+ */
+bool rohc_pcpu_steer(const struct rohc_pcpu *const pcpu,
+                     const struct rohc_buf uncomp_packet,
+                     size_t *const instance_idx)
+{
+	if(pcpu == NULL)
+	{
+		return false;
+	}
+
+	return rohc_comp_group_steer(pcpu->group, uncomp_packet, instance_idx);
+}
+
+
+/**
+ * @brief Compress a packet with one instance
+ *
+ * Deliver first the feedbacks queued for the compressor of the instance,
+ * then compress the packet as \ref rohc_compress4 does, and piggyback on it
+ * the feedbacks built by the decompressor of the instance. The packet shall
+ * be steered to the instance with \ref rohc_pcpu_steer, otherwise its context
+ * might be created in the CID range of another instance too.
+ *
+ * @param pcpu              The instances of the ROHC channel
+ * @param instance_idx      The index of the instance
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet, feedbacks
+ *                          included
+ * @return                  The same status values as \ref rohc_compress4
+ */
+rohc_status_t rohc_pcpu_compress(struct rohc_pcpu *const pcpu,
+                                 const size_t instance_idx,
+                                 const struct rohc_buf uncomp_packet,
+                                 struct rohc_buf *const rohc_packet)
+{
+	struct rohc_pcpu_instance *instance;
+	rohc_status_t status;
+
+	if(pcpu == NULL || instance_idx >= pcpu->instances_nr)
+	{
+		goto error;
+	}
+	instance = pcpu->instances[instance_idx];
+
+	spin_lock_bh(&instance->comp_lock);
+	rohc_pcpu_drain_feedbacks(pcpu, instance);
+	if(rohc_buf_is_empty(instance->feedbacks_send))
+	{
+		status = rohc_compress4(instance->comp, uncomp_packet, rohc_packet);
+	}
+	else
+	{
+		status = rohc_compress_with_feedbacks(instance->comp, uncomp_packet,
+		                                      rohc_packet,
+		                                      &instance->feedbacks_send);
+	}
+	spin_unlock_bh(&instance->comp_lock);
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress a ROHC packet with the instance that owns its CID
+ *
+ * The ROHC packet is decompressed by the decompressor of the instance that
+ * owns its CID. Feedback-only packets are handled by the given instance, eg.
+ * the instance of the RX queue the packet was received on. The received
+ * feedbacks are queued for the compressors that own their CIDs, and the
+ * feedbacks built by the decompressor are queued for the given instance.
+ *
+ * @param pcpu                The instances of the ROHC channel
+ * @param instance_idx        The index of the instance of the caller
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @return                    The same status values as \ref rohc_decompress3
+ */
+rohc_status_t rohc_pcpu_decompress(struct rohc_pcpu *const pcpu,
+                                   const size_t instance_idx,
+                                   const struct rohc_buf rohc_packet,
+                                   struct rohc_buf *const uncomp_packet)
+{
+	struct rohc_pcpu_instance *instance;
+	size_t owner_idx = instance_idx;
+	rohc_status_t status;
+	size_t feedback_offset;
+	size_t feedback_len;
+	rohc_cid_t cid;
+
+	if(pcpu == NULL || instance_idx >= pcpu->instances_nr)
+	{
+		goto error;
+	}
+
+	/* the packet is decompressed by the instance that owns its CID */
+	if(rohc_decomp_peek_cid(pcpu->instances[instance_idx]->decomp, rohc_packet,
+	                        &cid, &feedback_offset, &feedback_len))
+	{
+		owner_idx = rohc_pcpu_cid_owner(pcpu, cid);
+	}
+	instance = pcpu->instances[owner_idx];
+
+	spin_lock_bh(&instance->decomp_lock);
+	{
+		struct rohc_buf rcvd_feedbacks =
+			rohc_buf_init_empty(instance->rcvd_feedbacks_data,
+			                    ROHC_PCPU_FEEDBACKS_MAX_LEN);
+		struct rohc_buf built_feedbacks =
+			rohc_buf_init_empty(instance->built_feedbacks_data,
+			                    ROHC_PCPU_FEEDBACKS_MAX_LEN);
+
+		status = rohc_decompress3(instance->decomp, rohc_packet, uncomp_packet,
+		                          &rcvd_feedbacks, &built_feedbacks);
+
+		/* deliver the feedbacks to the other instances, the buffers of the
+		 * instance are protected by the lock until then */
+		rohc_pcpu_route_feedbacks(pcpu, rcvd_feedbacks);
+		if(!rohc_buf_is_empty(built_feedbacks))
+		{
+			rohc_pcpu_queue_feedback(pcpu,
+			                         &pcpu->instances[instance_idx]->built_feedbacks,
+			                         built_feedbacks);
+		}
+	}
+	spin_unlock_bh(&instance->decomp_lock);
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Get the feedbacks that one instance did not piggyback yet
+ *
+ * Deliver the feedbacks queued for the compressor of the instance, then move
+ * the feedbacks to send at the end of the given buffer, eg. to send them in a
+ * feedback-only packet when the instance has no packet to compress.
+ *
+ * @param pcpu           The instances of the ROHC channel
+ * @param instance_idx   The index of the instance
+ * @param[out] feedbacks The buffer to store the feedbacks to send in
+ * @return               true if all the feedbacks to send were stored,
+ *                       false if some of them did not fit in the buffer
+ */
+bool rohc_pcpu_flush_feedbacks(struct rohc_pcpu *const pcpu,
+                               const size_t instance_idx,
+                               struct rohc_buf *const feedbacks)
+{
+	struct rohc_pcpu_instance *instance;
+	bool all_stored = false;
+
+	if(pcpu == NULL || instance_idx >= pcpu->instances_nr || feedbacks == NULL)
+	{
+		goto error;
+	}
+	instance = pcpu->instances[instance_idx];
+
+	spin_lock_bh(&instance->comp_lock);
+	rohc_pcpu_drain_feedbacks(pcpu, instance);
+	if((feedbacks->len + instance->feedbacks_send.len) <=
+	   rohc_buf_avail_len(*feedbacks))
+	{
+		rohc_buf_append_buf(feedbacks, instance->feedbacks_send);
+		instance->feedbacks_send.len = 0;
+		all_stored = true;
+	}
+	spin_unlock_bh(&instance->comp_lock);
+
+error:
+	return all_stored;
+}
+
+
+/**
+ * @brief Get the number of feedbacks dropped between instances
+ *
+ * Feedbacks are dropped when no memory is available to queue them, or when
+ * too many feedbacks to send are waiting for a ROHC packet to piggyback them.
+ *
+ * @param pcpu  The instances of the ROHC channel
+ * @return      The number of dropped feedbacks
+ */
+size_t rohc_pcpu_get_dropped_feedbacks(const struct rohc_pcpu *const pcpu)
+{
+	if(pcpu == NULL)
+	{
+		return 0;
+	}
+
+	return atomic_long_read(&pcpu->dropped_feedbacks_nr);
+}
+
+
+/**
+ * @brief Allocate memory for the contexts of one instance
+ *
+ * The memory is allocated on the NUMA node of the instance, from the per-CPU
+ * caches of the kernel allocator. The ROHC library may allocate in softirq
+ * context, so the allocation never sleeps.
+ *
+ * @param size       The number of bytes to allocate
+ * @param priv_ctxt  The instance
+ * @return           The allocated memory, NULL on failure
+ */
+static void * rohc_pcpu_mem_alloc(const size_t size, void *const priv_ctxt)
+{
+	const struct rohc_pcpu_instance *const instance = priv_ctxt;
+
+	return kmalloc_node(size, GFP_ATOMIC, instance->node);
+}
+
+
+/**
+ * @brief Free memory of the contexts of one instance
+ *
+ * @param ptr        The memory to free
+ * @param size       The number of bytes that were allocated
+ * @param priv_ctxt  The instance
+ */
+static void rohc_pcpu_mem_free(void *const ptr,
+                               const size_t size __attribute__((unused)),
+                               void *const priv_ctxt __attribute__((unused)))
+{
+	kfree(ptr);
+}
+
+
+/**
+ * @brief Find out which instance owns the given CID
+ *
+ * The CIDs are split between the instances the same way as between the
+ * compressors of a group: instance i owns the CIDs from i * cids_nr /
+ * instances_nr included.
+ *
+ * @param pcpu  The instances of the ROHC channel
+ * @param cid   The CID
+ * @return      The index of the instance that owns the CID
+ */
+static size_t rohc_pcpu_cid_owner(const struct rohc_pcpu *const pcpu,
+                                  const rohc_cid_t cid)
+{
+	if(cid >= pcpu->cids_nr)
+	{
+		return 0;
+	}
+
+	return ((cid + 1) * pcpu->instances_nr - 1) / pcpu->cids_nr;
+}
+
+
+/**
+ * @brief Queue one or more feedback items in the given list
+ *
+ * The list may be shared by several producers in softirq context, the
+ * feedback items are thus copied in a new node that is added without lock.
+ *
+ * @param pcpu      The instances of the ROHC channel
+ * @param list      The list to add the feedback items to
+ * @param feedback  One or more complete feedback items
+ */
+static void rohc_pcpu_queue_feedback(struct rohc_pcpu *const pcpu,
+                                     struct llist_head *const list,
+                                     const struct rohc_buf feedback)
+{
+	struct rohc_pcpu_feedback *node;
+
+	node = kmalloc(sizeof(struct rohc_pcpu_feedback) + feedback.len, GFP_ATOMIC);
+	if(node == NULL)
+	{
+		atomic_long_inc(&pcpu->dropped_feedbacks_nr);
+		return;
+	}
+	node->len = feedback.len;
+	memcpy(node->data, rohc_buf_data(feedback), feedback.len);
+	llist_add(&node->node, list);
+}
+
+
+/**
+ * @brief Queue the received feedback items for the compressors that own them
+ *
+ * @param pcpu       The instances of the ROHC channel
+ * @param feedbacks  The received feedback items
+ */
+static void rohc_pcpu_route_feedbacks(struct rohc_pcpu *const pcpu,
+                                      struct rohc_buf feedbacks)
+{
+	while(!rohc_buf_is_empty(feedbacks))
+	{
+		struct rohc_buf feedback_item;
+		size_t shard_idx;
+
+		if(!rohc_comp_group_route_feedback(pcpu->group, &feedbacks,
+		                                   &feedback_item, &shard_idx))
+		{
+			/* malformed feedback data, drop the remaining items */
+			atomic_long_inc(&pcpu->dropped_feedbacks_nr);
+			break;
+		}
+		if(feedback_item.len > ROHC_PCPU_FEEDBACK_MAX_LEN)
+		{
+			atomic_long_inc(&pcpu->dropped_feedbacks_nr);
+			continue;
+		}
+		rohc_pcpu_queue_feedback(pcpu, &pcpu->instances[shard_idx]->rcvd_feedbacks,
+		                         feedback_item);
+	}
+}
+
+
+/**
+ * @brief Consume the feedbacks queued for one instance
+ *
+ * The received feedbacks are delivered to the compressor of the instance,
+ * the feedbacks to send are appended to the ones to piggyback. Both are
+ * consumed in the order they were queued. The caller shall hold the lock of
+ * the compressor of the instance.
+ *
+ * @param pcpu      The instances of the ROHC channel
+ * @param instance  The instance
+ */
+static void rohc_pcpu_drain_feedbacks(struct rohc_pcpu *const pcpu,
+                                      struct rohc_pcpu_instance *const instance)
+{
+	struct llist_node *nodes;
+	struct rohc_pcpu_feedback *feedback;
+	struct rohc_pcpu_feedback *next;
+
+	nodes = llist_reverse_order(llist_del_all(&instance->rcvd_feedbacks));
+	llist_for_each_entry_safe(feedback, next, nodes, node)
+	{
+		const struct rohc_ts time = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf feedback_buf =
+			rohc_buf_init_full(feedback->data, feedback->len, time);
+
+		if(!rohc_comp_deliver_feedback2(instance->comp, feedback_buf))
+		{
+			atomic_long_inc(&pcpu->dropped_feedbacks_nr);
+		}
+		kfree(feedback);
+	}
+
+	nodes = llist_reverse_order(llist_del_all(&instance->built_feedbacks));
+	llist_for_each_entry_safe(feedback, next, nodes, node)
+	{
+		if((instance->feedbacks_send.len + feedback->len) <=
+		   rohc_buf_avail_len(instance->feedbacks_send))
+		{
+			rohc_buf_append(&instance->feedbacks_send, feedback->data,
+			                feedback->len);
+		}
+		else
+		{
+			atomic_long_inc(&pcpu->dropped_feedbacks_nr);
+		}
+		kfree(feedback);
+	}
+}
+
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   kmod_pcpu.h
+ * @brief  Per-CPU or per-queue ROHC instances for the Linux kernel datapath
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * One ROHC channel is served by several instances, typically one per CPU or
+ * one per RX/TX queue of a network device. Every instance owns one
+ * compressor and one decompressor that are restricted to a disjoint range of
+ * the CIDs of the channel, so that the instances never share one context.
+ *
+ * The packets of one flow shall always be compressed by the same instance:
+ * use \ref rohc_pcpu_steer, eg. from the ndo_select_queue() callback of the
+ * network device. The ROHC packets are decompressed by the instance that owns
+ * their CID, whatever the instance they are given to.
+ *
+ * Feedbacks are exchanged between the instances without blocking: the
+ * feedbacks received by the decompressor of one instance are queued for the
+ * compressor that owns their CID, and are delivered to it the next time it
+ * compresses a packet. The feedbacks built by the decompressor of one
+ * instance are piggybacked on the next ROHC packets of the same instance, or
+ * retrieved with \ref rohc_pcpu_flush_feedbacks. All the functions may be
+ * called from softirq context.
+ */
+
+#ifndef ROHC_KMOD_PCPU_H
+#define ROHC_KMOD_PCPU_H
+
+#include "rohc.h"
+#include "rohc_comp.h"
+#include "rohc_decomp.h"
+
+
+struct rohc_pcpu;
+
+
+struct rohc_pcpu * rohc_pcpu_new(const rohc_cid_type_t cid_type,
+                                 const rohc_cid_t max_cid,
+                                 const size_t instances_nr,
+                                 const rohc_mode_t decomp_mode,
+                                 const rohc_comp_random_cb_t rand_cb,
+                                 void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+void rohc_pcpu_free(struct rohc_pcpu *const pcpu);
+
+size_t rohc_pcpu_get_instances_nr(const struct rohc_pcpu *const pcpu)
+	__attribute__((warn_unused_result));
+
+struct rohc_comp * rohc_pcpu_get_comp(const struct rohc_pcpu *const pcpu,
+                                      const size_t instance_idx)
+	__attribute__((warn_unused_result));
+
+struct rohc_decomp * rohc_pcpu_get_decomp(const struct rohc_pcpu *const pcpu,
+                                          const size_t instance_idx)
+	__attribute__((warn_unused_result));
+
+bool rohc_pcpu_steer(const struct rohc_pcpu *const pcpu,
+                     const struct rohc_buf uncomp_packet,
+                     size_t *const instance_idx)
+	__attribute__((warn_unused_result));
+
+rohc_status_t rohc_pcpu_compress(struct rohc_pcpu *const pcpu,
+                                 const size_t instance_idx,
+                                 const struct rohc_buf uncomp_packet,
+                                 struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result));
+
+rohc_status_t rohc_pcpu_decompress(struct rohc_pcpu *const pcpu,
+                                   const size_t instance_idx,
+                                   const struct rohc_buf rohc_packet,
+                                   struct rohc_buf *const uncomp_packet)
+	__attribute__((warn_unused_result));
+
+bool rohc_pcpu_flush_feedbacks(struct rohc_pcpu *const pcpu,
+                               const size_t instance_idx,
+                               struct rohc_buf *const feedbacks)
+	__attribute__((warn_unused_result));
+
+size_t rohc_pcpu_get_dropped_feedbacks(const struct rohc_pcpu *const pcpu)
+	__attribute__((warn_unused_result));
+
+#endif /* ROHC_KMOD_PCPU_H */
+
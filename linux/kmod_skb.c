@@ -0,0 +1,441 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   kmod_skb.c
+ * @brief  Compress and decompress socket buffers of the Linux kernel in place
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The ROHC library checks the lengths of the headers against the length of
+ * the whole packet, so the rohc_buf given to the library spans the whole
+ * packet: its first bytes are in the linear area of the sk_buff, the other
+ * ones in the paged fragments. The library never reads nor writes the
+ * payload when it works in place, so the helpers only have to make sure that
+ * all the bytes the library may read are in the linear area before it is
+ * called.
+ */
+
+#include <linux/skbuff.h>
+#include <linux/ip.h>
+#include <linux/ipv6.h>
+#include <linux/udp.h>
+#include <linux/tcp.h>
+
+#include "kmod_skb.h"
+#include "ip.h"
+#include "protocols/ip.h"
+#include "protocols/ip_numbers.h"
+#include "feedback_parse.h"
+
+
+/** The headroom required for the ROHC header in addition to the length of
+ *  the uncompressed headers, the IR headers being a little larger */
+#define ROHC_SKB_COMP_HEADROOM_EXTRA  64U
+
+/** The headroom required for the uncompressed headers */
+#define ROHC_SKB_DECOMP_HEADROOM  512U
+
+/** The maximal length of the RTP header, CSRC list included */
+#define ROHC_SKB_RTP_HDR_MAX_LEN  (12U + 15U * 4U)
+
+/** The maximal length of the ROHC headers of the compressed packets, ie. all
+ *  ROHC packets but IR, IR-DYN, co_common, co_repair and segments */
+#define ROHC_SKB_CO_HDR_MAX_LEN  256U
+
+/** The ROHC packets from this discriminator carry static or dynamic chains, or
+ *  are segments, their length is not bounded */
+#define ROHC_SKB_LONG_PKT_TYPE  0xf8U
+
+
+static unsigned int rohc_skb_uncomp_hdrs_len(const struct sk_buff *const skb)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool rohc_skb_rohc_hdrs_len(const struct sk_buff *const skb,
+                                   unsigned int *const hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_skb_to_buf(const struct sk_buff *const skb,
+                            struct rohc_buf *const buf)
+	__attribute__((nonnull(1, 2)));
+static void rohc_skb_from_buf(struct sk_buff *const skb,
+                              const struct rohc_buf buf)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Compress the IP packet of the given sk_buff in place
+ *
+ * The IP packet starts at skb->data. The uncompressed headers are pulled in
+ * the linear area of the sk_buff if needed, and enough headroom is ensured
+ * for the ROHC header, the header of the sk_buff being unshared if it is
+ * cloned. The ROHC header is then built in the headroom, and moved right
+ * before the payload that stays where it is. On success, skb->data points to
+ * the ROHC packet.
+ *
+ * The function may be called from softirq context.
+ *
+ * @param comp  The ROHC compressor
+ * @param skb   The sk_buff with the IP packet to compress
+ * @return      ROHC_STATUS_OK if the packet was compressed,
+ *              ROHC_STATUS_NO_MEMORY if the sk_buff could not be prepared,
+ *              the same status values as \ref rohc_compress_in_place
+ *              otherwise
+ *
+ * @see rohc_compress_in_place
+ */
+rohc_status_t rohc_compress_skb(struct rohc_comp *const comp,
+                                struct sk_buff *const skb)
+{
+	struct rohc_buf pkt;
+	unsigned int hdrs_len;
+	rohc_status_t status;
+
+	if(comp == NULL || skb == NULL || skb->len == 0)
+	{
+		goto error;
+	}
+
+	/* the headers shall be in the linear area, and the ROHC header shall fit
+	 * in the writable headroom */
+	hdrs_len = rohc_skb_uncomp_hdrs_len(skb);
+	if(!pskb_may_pull(skb, hdrs_len) ||
+	   skb_cow_head(skb, hdrs_len + ROHC_SKB_COMP_HEADROOM_EXTRA) != 0)
+	{
+		status = ROHC_STATUS_NO_MEMORY;
+		goto error_status;
+	}
+
+	rohc_skb_to_buf(skb, &pkt);
+	status = rohc_compress_in_place(comp, &pkt);
+	if(status != ROHC_STATUS_OK)
+	{
+		goto error_status;
+	}
+	rohc_skb_from_buf(skb, pkt);
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+error_status:
+	return status;
+}
+
+
+/**
+ * @brief Decompress the ROHC packet of the given sk_buff in place
+ *
+ * The ROHC packet starts at skb->data. The ROHC header is pulled in the
+ * linear area of the sk_buff if needed, and enough headroom is ensured for
+ * the uncompressed headers, the header of the sk_buff being unshared if it is
+ * cloned. The uncompressed headers are then built in the headroom, and moved
+ * right before the payload that stays where it is. On success, skb->data
+ * points to the IP packet, and the network header of the sk_buff is reset to
+ * it. The sk_buff is empty if the ROHC packet contained feedback only.
+ *
+ * The ROHC packets that carry static or dynamic chains, ie. IR, IR-DYN,
+ * co_common or co_repair packets, and the ROHC segments are fully linearized
+ * before decompression: their ROHC headers are not bounded, but they are
+ * rare once the contexts are established.
+ *
+ * The function may be called from softirq context.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param skb                 The sk_buff with the ROHC packet to decompress
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor, may be
+ *                            NULL
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, may be NULL
+ * @return                    ROHC_STATUS_OK if the packet was decompressed,
+ *                            ROHC_STATUS_NO_MEMORY if the sk_buff could not be
+ *                            prepared, the same status values as
+ *                            \ref rohc_decompress_in_place otherwise
+ *
+ * @see rohc_decompress_in_place
+ */
+rohc_status_t rohc_decompress_skb(struct rohc_decomp *const decomp,
+                                  struct sk_buff *const skb,
+                                  struct rohc_buf *const rcvd_feedback,
+                                  struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf pkt;
+	unsigned int hdrs_len;
+	rohc_status_t status;
+
+	if(decomp == NULL || skb == NULL || skb->len == 0)
+	{
+		goto error;
+	}
+
+	/* the ROHC header shall be in the linear area, and the uncompressed
+	 * headers shall fit in the writable headroom */
+	if(!rohc_skb_rohc_hdrs_len(skb, &hdrs_len))
+	{
+		if(skb_linearize(skb) != 0)
+		{
+			status = ROHC_STATUS_NO_MEMORY;
+			goto error_status;
+		}
+	}
+	else if(!pskb_may_pull(skb, hdrs_len))
+	{
+		status = ROHC_STATUS_NO_MEMORY;
+		goto error_status;
+	}
+	if(skb_cow_head(skb, ROHC_SKB_DECOMP_HEADROOM) != 0)
+	{
+		status = ROHC_STATUS_NO_MEMORY;
+		goto error_status;
+	}
+
+	rohc_skb_to_buf(skb, &pkt);
+	status = rohc_decompress_in_place(decomp, &pkt, rcvd_feedback,
+	                                  feedback_send);
+	if(status != ROHC_STATUS_OK)
+	{
+		goto error_status;
+	}
+	if(pkt.len == 0)
+	{
+		/* feedback-only packet, the whole packet was consumed */
+		if(pskb_trim(skb, 0) != 0)
+		{
+			status = ROHC_STATUS_NO_MEMORY;
+			goto error_status;
+		}
+	}
+	else
+	{
+		rohc_skb_from_buf(skb, pkt);
+	}
+	skb_reset_network_header(skb);
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+error_status:
+	return status;
+}
+
+
+/**
+ * @brief Get the length of the uncompressed headers the compressor may read
+ *
+ * Walk the IP headers, the IPv6 extension headers and the transport header
+ * the same way the compressor does. The RTP header, if any, is accounted for
+ * every UDP packet, since the RTP detection reads the UDP payload. The walk
+ * stops at the first unexpected header: the compressor does not read further
+ * either.
+ *
+ * @param skb  The sk_buff with the IP packet
+ * @return     The length of the uncompressed headers, at most the length of
+ *             the packet
+ */
+static unsigned int rohc_skb_uncomp_hdrs_len(const struct sk_buff *const skb)
+{
+	unsigned int hdrs_len = 0;
+	size_t ip_hdrs_nr = 0;
+	uint8_t next_proto;
+
+	do
+	{
+		uint8_t version_buf;
+		const uint8_t *const version =
+			skb_header_pointer(skb, hdrs_len, 1, &version_buf);
+
+		if(version == NULL)
+		{
+			goto end;
+		}
+		if(((*version) >> 4) == IPV4)
+		{
+			struct iphdr iph_buf;
+			const struct iphdr *const iph =
+				skb_header_pointer(skb, hdrs_len, sizeof(struct iphdr), &iph_buf);
+
+			if(iph == NULL)
+			{
+				goto end;
+			}
+			next_proto = iph->protocol;
+			hdrs_len += iph->ihl * 4;
+		}
+		else if(((*version) >> 4) == IPV6)
+		{
+			struct ipv6hdr ip6h_buf;
+			const struct ipv6hdr *const ip6h =
+				skb_header_pointer(skb, hdrs_len, sizeof(struct ipv6hdr), &ip6h_buf);
+
+			if(ip6h == NULL)
+			{
+				goto end;
+			}
+			next_proto = ip6h->nexthdr;
+			hdrs_len += sizeof(struct ipv6hdr);
+
+			while(rohc_is_ipv6_opt(next_proto))
+			{
+				uint8_t ext_buf[2];
+				const uint8_t *const ext =
+					skb_header_pointer(skb, hdrs_len, 2, ext_buf);
+
+				if(ext == NULL)
+				{
+					goto end;
+				}
+				next_proto = ext[0];
+				hdrs_len += (ext[1] + 1) * 8;
+			}
+		}
+		else
+		{
+			goto end;
+		}
+		ip_hdrs_nr++;
+	}
+	while(rohc_is_tunneling(next_proto) && ip_hdrs_nr < ROHC_MAX_IP_HDRS);
+
+	if(next_proto == ROHC_IPPROTO_UDP || next_proto == ROHC_IPPROTO_UDPLITE)
+	{
+		hdrs_len += sizeof(struct udphdr) + ROHC_SKB_RTP_HDR_MAX_LEN;
+	}
+	else if(next_proto == ROHC_IPPROTO_TCP)
+	{
+		struct tcphdr tcph_buf;
+		const struct tcphdr *const tcph =
+			skb_header_pointer(skb, hdrs_len, sizeof(struct tcphdr), &tcph_buf);
+
+		if(tcph != NULL)
+		{
+			hdrs_len += tcph->doff * 4;
+		}
+	}
+	else if(next_proto == ROHC_IPPROTO_ESP)
+	{
+		/* SPI and sequence number */
+		hdrs_len += 8;
+	}
+
+end:
+	return min(hdrs_len, skb->len);
+}
+
+
+/**
+ * @brief Get the length of the ROHC headers the decompressor may read
+ *
+ * Skip the padding, the piggybacked feedback items and the add-CID octet,
+ * then look at the discriminator of the ROHC packet: the compressed packets
+ * have bounded ROHC headers, the other packets do not.
+ *
+ * @param skb            The sk_buff with the ROHC packet
+ * @param[out] hdrs_len  The length of the ROHC headers, at most the length
+ *                       of the packet
+ * @return               true if the length of the ROHC headers is bounded,
+ *                       false if the whole packet may be read
+ */
+static bool rohc_skb_rohc_hdrs_len(const struct sk_buff *const skb,
+                                   unsigned int *const hdrs_len)
+{
+	unsigned int off = 0;
+	uint8_t type_buf[2];
+	const uint8_t *type;
+
+	/* padding and feedback items */
+	while((type = skb_header_pointer(skb, off, 2, type_buf)) != NULL &&
+	      (type[0] == 0xe0 || rohc_packet_is_feedback(type[0])))
+	{
+		if(type[0] == 0xe0)
+		{
+			off++;
+		}
+		else if((type[0] & 0x07) != 0)
+		{
+			off += 1 + (type[0] & 0x07);
+		}
+		else
+		{
+			off += 2 + type[1];
+		}
+	}
+
+	/* the add-CID octet before the discriminator */
+	type = skb_header_pointer(skb, off, 1, type_buf);
+	if(type != NULL && ((*type) & 0xf0) == 0xe0)
+	{
+		off++;
+		type = skb_header_pointer(skb, off, 1, type_buf);
+	}
+	if(type == NULL || (*type) >= ROHC_SKB_LONG_PKT_TYPE)
+	{
+		return false;
+	}
+
+	*hdrs_len = min(off + ROHC_SKB_CO_HDR_MAX_LEN, skb->len);
+	return true;
+}
+
+
+/**
+ * @brief Describe the packet of the given sk_buff with a network buffer
+ *
+ * The network buffer starts at the head of the sk_buff, so that the headroom
+ * of the sk_buff is the headroom of the network buffer, and spans the whole
+ * packet, paged fragments included. Only the bytes in the linear area may be
+ * accessed through it.
+ *
+ * @param skb       The sk_buff
+ * @param[out] buf  The network buffer
+ */
+static void rohc_skb_to_buf(const struct sk_buff *const skb,
+                            struct rohc_buf *const buf)
+{
+	buf->time.sec = 0;
+	buf->time.nsec = 0;
+	buf->data = skb->head;
+	buf->offset = skb_headroom(skb);
+	buf->len = skb->len;
+	buf->max_len = buf->offset + buf->len;
+}
+
+
+/**
+ * @brief Move the data of the sk_buff to the packet of the network buffer
+ *
+ * The network buffer shall describe the same memory as the one built with
+ * \ref rohc_skb_to_buf, its packet shall end where the sk_buff does.
+ *
+ * @param skb  The sk_buff
+ * @param buf  The network buffer
+ */
+static void rohc_skb_from_buf(struct sk_buff *const skb,
+                              const struct rohc_buf buf)
+{
+	const unsigned int headroom = skb_headroom(skb);
+
+	if(buf.offset >= headroom)
+	{
+		skb_pull(skb, buf.offset - headroom);
+	}
+	else
+	{
+		skb_push(skb, headroom - buf.offset);
+	}
+	WARN_ON(skb->len != buf.len);
+}
+
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file   kmod_skb.h
+ * @brief  Compress and decompress socket buffers of the Linux kernel in place
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The helpers compress and decompress the packet of one sk_buff in place:
+ * the ROHC header replaces the uncompressed headers in the linear area of
+ * the sk_buff, and the uncompressed headers replace the ROHC header. Only
+ * the headers are pulled in the linear area if they are not there yet, the
+ * payload is neither copied nor linearized, so the paged fragments of the
+ * sk_buff are left untouched.
+ */
+
+#ifndef ROHC_KMOD_SKB_H
+#define ROHC_KMOD_SKB_H
+
+#include <linux/skbuff.h>
+
+#include "rohc.h"
+#include "rohc_comp.h"
+#include "rohc_decomp.h"
+
+
+rohc_status_t rohc_compress_skb(struct rohc_comp *const comp,
+                                struct sk_buff *const skb)
+	__attribute__((warn_unused_result));
+
+rohc_status_t rohc_decompress_skb(struct rohc_decomp *const decomp,
+                                  struct sk_buff *const skb,
+                                  struct rohc_buf *const rcvd_feedback,
+                                  struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+#endif /* ROHC_KMOD_SKB_H */
+
@@ -24,17 +24,27 @@
  * @author  Thales Communications
  * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
  * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The /proc/rohc_(de)?comp%d_(in|out) files exchange one packet per write or
+ * read. The /proc/rohc_(de)?comp%d_batch files exchange whole batches of
+ * packets instead: every packet of the batch is prefixed by its length on 16
+ * bits, one write (de)compresses all the packets of the batch, and the next
+ * read returns all the resulting packets. See kmod_bench.h for the in-kernel
+ * benchmark.
  */
 
 #include <linux/module.h>
 #include <linux/uaccess.h>
 #include <linux/proc_fs.h>
+#include <linux/vmalloc.h>
 
 #include "config.h"
 #include "rohc.h"
 #include "rohc_comp.h"
 #include "rohc_decomp.h"
 
+#include "kmod_bench.h"
+
 
 /** The name of the file to write IP packets on to compressor */
 #define PROC_COMP_IN_NAME "rohc_comp%d_in"
@@ -46,9 +56,19 @@
 /** The name of the file to read IP packets from decompressor */
 #define PROC_DECOMP_OUT_NAME "rohc_decomp%d_out"
 
+/** The name of the file to exchange batches of packets with compressor */
+#define PROC_COMP_BATCH_NAME "rohc_comp%d_batch"
+/** The name of the file to exchange batches of packets with decompressor */
+#define PROC_DECOMP_BATCH_NAME "rohc_decomp%d_batch"
+
 /** The maximal size for the ROHC packets */
 #define MAX_ROHC_SIZE   10000
 
+/** The maximal size of one batch of packets written by userspace */
+#define MAX_BATCH_IN_SIZE   (1024 * 1024)
+/** The maximal size of one batch of packets read by userspace */
+#define MAX_BATCH_OUT_SIZE  (4 * 1024 * 1024)
+
 
 /** Custom pr_info() macro for the module */
 #define rohc_info(format, ...) \
@@ -106,6 +126,11 @@ struct rohc_couple {
 	 */
 	struct rohc_buf feedback_to_send;
 
+	/** The buffer in which to store the packets of the last batch */
+	unsigned char *batch_out;
+	/** The size of the packets of the last batch */
+	size_t batch_out_len;
+
 	/** The file to write IP packets on to compressor */
 	struct proc_dir_entry *proc_file_comp_in;
 	/** The file to read ROHC packets from compressor */
@@ -115,6 +140,11 @@ struct rohc_couple {
 	struct proc_dir_entry *proc_file_decomp_in;
 	/** The file to read IP packets from decompressor */
 	struct proc_dir_entry *proc_file_decomp_out;
+
+	/** The file to exchange batches of packets with compressor */
+	struct proc_dir_entry *proc_file_comp_batch;
+	/** The file to exchange batches of packets with decompressor */
+	struct proc_dir_entry *proc_file_decomp_batch;
 };
 
 
@@ -381,11 +411,19 @@ int rohc_couple_init_phase2(struct rohc_couple *couple, int index)
 	couple->feedback_to_send.offset = 0;
 	couple->feedback_to_send.len = 0;
 
+	/* allocate memory for the batches of packets */
+	couple->batch_out = vmalloc(MAX_BATCH_OUT_SIZE);
+	if (couple->batch_out == NULL)
+		goto free_feedback_to_send;
+	couple->batch_out_len = 0;
+
 	rohc_info("\tROHC couple #%d successfully initialized (phase 2)\n",
 		  index + 1);
 
 	return 0;
 
+free_feedback_to_send:
+	kfree(couple->feedback_to_send_buffer);
 free_rcvd_feedback:
 	kfree(couple->rcvd_feedback_buffer);
 free_ip_packet:
@@ -446,6 +484,13 @@ void rohc_couple_release(struct rohc_couple *couple, int index)
 		couple->feedback_to_send_buffer = NULL;
 	}
 
+	/* free/reset resources for batches */
+	if (couple->batch_out != NULL) {
+		vfree(couple->batch_out);
+		couple->batch_out = NULL;
+	}
+	couple->batch_out_len = 0;
+
 	/* free (de)compressor */
 	if (couple->comp != NULL)
 		rohc_comp_free(couple->comp);
@@ -514,7 +559,9 @@ static int rohc_proc_open(struct inode *inode, struct file *file)
 	if (!strcmp(file->f_path.dentry->d_name.name, "rohc_comp1_in") ||
 	    !strcmp(file->f_path.dentry->d_name.name, "rohc_comp1_out") ||
 	    !strcmp(file->f_path.dentry->d_name.name, "rohc_decomp1_in") ||
-	    !strcmp(file->f_path.dentry->d_name.name, "rohc_decomp1_out")) {
+	    !strcmp(file->f_path.dentry->d_name.name, "rohc_decomp1_out") ||
+	    !strcmp(file->f_path.dentry->d_name.name, "rohc_comp1_batch") ||
+	    !strcmp(file->f_path.dentry->d_name.name, "rohc_decomp1_batch")) {
 		file->private_data = &couples[0];
 	} else {
 		file->private_data = &couples[1];
@@ -904,6 +951,268 @@ error:
 }
 
 
+/**
+ * @brief Compress or decompress one packet of a batch
+ *
+ * The resulting packet is appended to the batch of packets for userspace,
+ * prefixed by its length on 16 bits. A packet that fails to be
+ * (de)compressed is appended as an empty packet, so that userspace may
+ * match the packets of the batches.
+ *
+ * @param couple   The couple of ROHC compressor/decompressor
+ * @param pkt      The packet to compress or decompress
+ * @param pkt_len  The length of the packet
+ * @param is_comp  true to compress the packet, false to decompress it
+ * @return         0 in case of success,
+ *                 -ENOSPC if the batch for userspace is full,
+ *                 -EFAULT if another error occurs
+ */
+static int rohc_batch_handle_pkt(struct rohc_couple *couple,
+				 unsigned char *pkt,
+				 uint16_t pkt_len,
+				 bool is_comp)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const struct rohc_buf pkt_in =
+		rohc_buf_init_full(pkt, pkt_len, arrival_time);
+	struct rohc_buf pkt_out;
+	rohc_status_t status;
+	uint16_t pkt_out_len;
+
+	if ((MAX_BATCH_OUT_SIZE - couple->batch_out_len) <=
+	    sizeof(uint16_t)) {
+		rohc_err("batch of packets for userspace is full\n");
+		return -ENOSPC;
+	}
+	pkt_out = rohc_buf_init_empty(couple->batch_out +
+				      couple->batch_out_len +
+				      sizeof(uint16_t),
+				      min_t(size_t, MAX_BATCH_OUT_SIZE -
+					    couple->batch_out_len -
+					    sizeof(uint16_t), 0xffff));
+
+	if (is_comp) {
+		/* piggyback the feedback data on the first ROHC packet */
+		if (couple->feedback_to_send.len > rohc_buf_avail_len(pkt_out))
+			return -ENOSPC;
+		rohc_buf_append_buf(&pkt_out, couple->feedback_to_send);
+		rohc_buf_pull(&pkt_out, couple->feedback_to_send.len);
+
+		status = rohc_compress4(couple->comp, pkt_in, &pkt_out);
+		if (status == ROHC_STATUS_OK) {
+			rohc_buf_push(&pkt_out, couple->feedback_to_send.len);
+			rohc_buf_reset(&couple->feedback_to_send);
+		}
+	} else {
+		const unsigned int other_couple = (couple->index + 1) % 2;
+		struct rohc_buf rcvd_feedback =
+			rohc_buf_init_empty(couple->rcvd_feedback_buffer,
+					    MAX_ROHC_SIZE);
+
+		status = rohc_decompress3(couple->decomp, pkt_in, &pkt_out,
+					  &rcvd_feedback,
+					  &couples[other_couple].feedback_to_send);
+		if (status == ROHC_STATUS_OK &&
+		    !rohc_comp_deliver_feedback2(couples[other_couple].comp,
+						 rcvd_feedback)) {
+			rohc_err("failed to deliver received feedback to comp.\n");
+			return -EFAULT;
+		}
+	}
+
+	if (status == ROHC_STATUS_OUTPUT_TOO_SMALL) {
+		rohc_err("batch of packets for userspace is full\n");
+		return -ENOSPC;
+	} else if (status != ROHC_STATUS_OK) {
+		rohc_err("failed to %scompress one packet of the batch\n",
+			 is_comp ? "" : "de");
+		pkt_out.len = 0;
+	}
+
+	pkt_out_len = pkt_out.len;
+	memcpy(couple->batch_out + couple->batch_out_len, &pkt_out_len,
+	       sizeof(uint16_t));
+	couple->batch_out_len += sizeof(uint16_t) + pkt_out_len;
+
+	return 0;
+}
+
+
+/**
+ * @brief Handle a write to /proc/rohc_(de)?comp%d_batch file from userspace
+ *
+ * One write brings a whole batch of packets, every packet being prefixed by
+ * its length on 16 bits. All the packets are (de)compressed at once, and the
+ * resulting packets are kept for the next read on the same file.
+ *
+ * @param file     The /proc file userspace writes to
+ * @param buffer   The data userspace writes
+ * @param count    The number of bytes of data
+ * @param is_comp  true to compress the packets, false to decompress them
+ * @return         The number of bytes of data handled by the function,
+ *                 -ENOMEM if memory allocation fails,
+ *                 -EINVAL if the batch is malformed,
+ *                 -ENOSPC if the resulting batch is too large,
+ *                 -EFAULT if another error occurs
+ */
+static ssize_t rohc_proc_batch_write(struct file *file,
+				     const char __user *buffer,
+				     size_t count,
+				     bool is_comp)
+{
+	struct rohc_couple *couple = file->private_data;
+	unsigned char *batch_in;
+	size_t offset = 0;
+	ssize_t err;
+
+	WARN_ON(couples_ref_nr == 0);
+
+	couple->batch_out_len = 0;
+
+	if (count > MAX_BATCH_IN_SIZE) {
+		rohc_err("batch of %zd bytes is larger than %d bytes\n",
+			 count, MAX_BATCH_IN_SIZE);
+		return -EINVAL;
+	}
+	batch_in = vmalloc(count);
+	if (batch_in == NULL) {
+		rohc_err("failed allocate %zd bytes of memory\n", count);
+		return -ENOMEM;
+	}
+	if (copy_from_user(batch_in, buffer, count)) {
+		rohc_err("failed to copy %zd-byte batch from userspace to kernel\n",
+			 count);
+		err = -EFAULT;
+		goto error;
+	}
+
+	/* (de)compress all the packets of the batch */
+	while (offset < count) {
+		uint16_t pkt_len;
+		int ret;
+
+		if ((count - offset) < sizeof(uint16_t)) {
+			rohc_err("batch is truncated\n");
+			err = -EINVAL;
+			goto error;
+		}
+		memcpy(&pkt_len, batch_in + offset, sizeof(uint16_t));
+		offset += sizeof(uint16_t);
+		if ((count - offset) < pkt_len) {
+			rohc_err("batch is truncated\n");
+			err = -EINVAL;
+			goto error;
+		}
+
+		ret = rohc_batch_handle_pkt(couple, batch_in + offset, pkt_len,
+					    is_comp);
+		if (ret != 0) {
+			err = ret;
+			goto error;
+		}
+		offset += pkt_len;
+	}
+
+	vfree(batch_in);
+	return count;
+
+error:
+	couple->batch_out_len = 0;
+	vfree(batch_in);
+	return err;
+}
+
+
+/**
+ * @brief Handle a write to /proc/rohc_comp%d_batch file from userspace
+ *
+ * @param file    The /proc file userspace writes to
+ * @param buffer  The data userspace writes
+ * @param count   The number of bytes of data
+ * @param ppos    TODO
+ * @return        The number of bytes of data handled by the function,
+ *                -errno in case of error
+ */
+ssize_t rohc_proc_comp_batch_write(struct file *file,
+				   const char __user *buffer,
+				   size_t count,
+				   loff_t *ppos)
+{
+	return rohc_proc_batch_write(file, buffer, count, true);
+}
+
+
+/**
+ * @brief Handle a write to /proc/rohc_decomp%d_batch file from userspace
+ *
+ * @param file    The /proc file userspace writes to
+ * @param buffer  The data userspace writes
+ * @param count   The number of bytes of data
+ * @param ppos    TODO
+ * @return        The number of bytes of data handled by the function,
+ *                -errno in case of error
+ */
+ssize_t rohc_proc_decomp_batch_write(struct file *file,
+				     const char __user *buffer,
+				     size_t count,
+				     loff_t *ppos)
+{
+	return rohc_proc_batch_write(file, buffer, count, false);
+}
+
+
+/**
+ * @brief Handle a read from /proc/rohc_(de)?comp%d_batch file from userspace
+ *
+ * Return the packets of the last batch, every packet being prefixed by its
+ * length on 16 bits.
+ *
+ * @param file    The /proc file userspace reads from
+ * @param buffer  The data userspace reads
+ * @param count   The number of bytes of data
+ * @param ppos    TODO
+ * @return        The number of bytes of data handled by the function,
+ *                -EFAULT in case of error
+ */
+ssize_t rohc_proc_batch_read(struct file *file,
+			     char __user *buffer,
+			     size_t count,
+			     loff_t *ppos)
+{
+	struct rohc_couple *couple = file->private_data;
+	int err = -EFAULT;
+
+	WARN_ON(couples_ref_nr == 0);
+
+	/* if one reads a batch when none is available, return an error */
+	if (couple->batch_out_len == 0) {
+		rohc_err("cannot send batch to userspace: no batch available\n");
+		goto error;
+	}
+
+	/* userspace should provides a buffer that is large enough
+	 * for the whole batch
+	 */
+	if (count < couple->batch_out_len) {
+		rohc_err("cannot send batch to userspace: too large\n");
+		goto error;
+	}
+
+	/* send data to userspace */
+	if (copy_to_user(buffer, couple->batch_out, couple->batch_out_len)) {
+		rohc_err("cannot send batch to userspace: copy_to_user failed\n");
+		goto error;
+	}
+
+	/* everything went fine */
+	err = couple->batch_out_len;
+
+error:
+	couple->batch_out_len = 0;
+	return err;
+}
+
+
 /**
  * @brief Handle a close() from userspace on a /proc file
  *
@@ -966,8 +1275,28 @@ static const struct file_operations rohc_proc_decomp_out_fops = {
 };
 
 
+/** File operations for /proc/rohc_comp%d_batch */
+static const struct file_operations rohc_proc_comp_batch_fops = {
+	.owner   = THIS_MODULE,
+	.open    = rohc_proc_open,
+	.write   = rohc_proc_comp_batch_write,
+	.read    = rohc_proc_batch_read,
+	.release = rohc_proc_close,
+};
+
+
+/** File operations for /proc/rohc_decomp%d_batch */
+static const struct file_operations rohc_proc_decomp_batch_fops = {
+	.owner   = THIS_MODULE,
+	.open    = rohc_proc_open,
+	.write   = rohc_proc_decomp_batch_write,
+	.read    = rohc_proc_batch_read,
+	.release = rohc_proc_close,
+};
+
+
 /**
- * @brief Create /proc/rohc_(de)?comp[12]_(in|out) entries
+ * @brief Create /proc/rohc_(de)?comp[12]_(in|out|batch) entries
  *
  * @param couple  The ROHC couple for which to create the /proc entries
  * @param index   The index of the couple: 0 or 1
@@ -979,12 +1308,16 @@ int rohc_proc_init(struct rohc_couple *couple, int index)
 	char proc_comp_out_name[100];
 	char proc_decomp_in_name[100];
 	char proc_decomp_out_name[100];
+	char proc_comp_batch_name[100];
+	char proc_decomp_batch_name[100];
 
 	/* create the name of the /proc files according to the couple index */
 	sprintf(proc_comp_in_name, PROC_COMP_IN_NAME, index + 1);
 	sprintf(proc_comp_out_name, PROC_COMP_OUT_NAME, index + 1);
 	sprintf(proc_decomp_in_name, PROC_DECOMP_IN_NAME, index + 1);
 	sprintf(proc_decomp_out_name, PROC_DECOMP_OUT_NAME, index + 1);
+	sprintf(proc_comp_batch_name, PROC_COMP_BATCH_NAME, index + 1);
+	sprintf(proc_decomp_batch_name, PROC_DECOMP_BATCH_NAME, index + 1);
 
 	rohc_info("\tcreate interface /proc/%s...\n", proc_comp_in_name);
 	couple->proc_file_comp_in =
@@ -1022,8 +1355,30 @@ int rohc_proc_init(struct rohc_couple *couple, int index)
 		goto err_free_decomp_in;
 	}
 
+	rohc_info("\tcreate interface /proc/%s...\n", proc_comp_batch_name);
+	couple->proc_file_comp_batch =
+		proc_create(proc_comp_batch_name, S_IFREG|0600,
+			    NULL, &rohc_proc_comp_batch_fops);
+	if (couple->proc_file_comp_batch == NULL) {
+		rohc_err("\tfailed to create /proc/%s\n", proc_comp_batch_name);
+		goto err_free_decomp_out;
+	}
+
+	rohc_info("\tcreate interface /proc/%s...\n", proc_decomp_batch_name);
+	couple->proc_file_decomp_batch =
+		proc_create(proc_decomp_batch_name, S_IFREG|0600,
+			    NULL, &rohc_proc_decomp_batch_fops);
+	if (couple->proc_file_decomp_batch == NULL) {
+		rohc_err("\tfailed to create /proc/%s\n", proc_decomp_batch_name);
+		goto err_free_comp_batch;
+	}
+
 	return 0;
 
+err_free_comp_batch:
+	remove_proc_entry(proc_comp_batch_name, NULL);
+err_free_decomp_out:
+	remove_proc_entry(proc_decomp_out_name, NULL);
 err_free_decomp_in:
 	remove_proc_entry(proc_decomp_in_name, NULL);
 err_free_comp_out:
@@ -1036,7 +1391,7 @@ err:
 
 
 /**
- * @brief Release the /proc/rohc_(de)?comp[12]_(in|out) entries
+ * @brief Release the /proc/rohc_(de)?comp[12]_(in|out|batch) entries
  *
  * @param index   The index of the couple: 0 or 1
  */
@@ -1046,18 +1401,24 @@ void rohc_proc_release(int index)
 	char proc_comp_out_name[100];
 	char proc_decomp_in_name[100];
 	char proc_decomp_out_name[100];
+	char proc_comp_batch_name[100];
+	char proc_decomp_batch_name[100];
 
 	/* create the name of the /proc files according to the couple index */
 	sprintf(proc_comp_in_name, PROC_COMP_IN_NAME, index + 1);
 	sprintf(proc_comp_out_name, PROC_COMP_OUT_NAME, index + 1);
 	sprintf(proc_decomp_in_name, PROC_DECOMP_IN_NAME, index + 1);
 	sprintf(proc_decomp_out_name, PROC_DECOMP_OUT_NAME, index + 1);
+	sprintf(proc_comp_batch_name, PROC_COMP_BATCH_NAME, index + 1);
+	sprintf(proc_decomp_batch_name, PROC_DECOMP_BATCH_NAME, index + 1);
 
 	/* remove the /proc entries of the couple */
 	remove_proc_entry(proc_comp_in_name, NULL);
 	remove_proc_entry(proc_comp_out_name, NULL);
 	remove_proc_entry(proc_decomp_in_name, NULL);
 	remove_proc_entry(proc_decomp_out_name, NULL);
+	remove_proc_entry(proc_comp_batch_name, NULL);
+	remove_proc_entry(proc_decomp_batch_name, NULL);
 }
 
 
@@ -1086,10 +1447,19 @@ int __init rohc_test_init(void)
 		goto release_proc;
 	}
 
+	/* create /proc entry for the in-kernel benchmark */
+	ret = rohc_bench_init();
+	if (ret != 0) {
+		rohc_err("failed to create /proc entries\n");
+		goto release_proc2;
+	}
+
 	rohc_info("ROHC test module successfully loaded\n");
 
 	return 0;
 
+release_proc2:
+	rohc_proc_release(1);
 release_proc:
 	rohc_proc_release(0);
 error:
@@ -1105,6 +1475,7 @@ void __exit rohc_test_exit(void)
 	rohc_info("unloading ROHC test module...\n");
 	rohc_proc_release(0);
 	rohc_proc_release(1);
+	rohc_bench_release();
 	rohc_info("ROHC test module successfully unloaded\n");
 }
 
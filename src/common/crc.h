@@ -52,6 +52,9 @@
 /** The length (in bytes) of the FCS-32 CRC */
 #define CRC_FCS32_LEN  4U
 
+/** The minimal length of data for the slicing-by-4 CRC-7 and CRC-8 */
+#define CRC_SLICE4_MIN_LEN  8U
+
 /** The different types of CRC used to protect ROHC headers */
 typedef enum
 {
@@ -148,47 +151,71 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
                         const uint32_t init_val)
 	__attribute__((nonnull(1), warn_unused_result, pure));
 
-uint8_t ip_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t crc_calc_8_slice4(const uint8_t *const buf,
+                          const size_t size,
+                          const uint8_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+uint8_t crc_calc_7_slice4(const uint8_t *const buf,
+                          const size_t size,
+                          const uint8_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+
+void crc_calc_lanes(const rohc_crc_type_t crc_type,
+                    const uint8_t *const bufs[],
+                    const size_t lens[],
+                    uint8_t crcs[],
+                    const size_t lanes_nr)
+	__attribute__((nonnull(2, 3, 4)));
+
+uint8_t ip_compute_crc_static(const struct rohc_crc_engine *const crc_engine,
+                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                               const rohc_crc_type_t crc_type,
                               const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
-uint8_t ip_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+	__attribute__((nonnull(1, 2), warn_unused_result));
+uint8_t ip_compute_crc_dynamic(const struct rohc_crc_engine *const crc_engine,
+                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
+	__attribute__((nonnull(1, 2), warn_unused_result));
 
 static inline
-uint8_t udp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t udp_compute_crc_static(const struct rohc_crc_engine *const crc_engine,
+                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
+	__attribute__((nonnull(1, 2), warn_unused_result));
 static inline
-uint8_t udp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t udp_compute_crc_dynamic(const struct rohc_crc_engine *const crc_engine,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
+	__attribute__((nonnull(1, 2), warn_unused_result));
 
 static inline
-uint8_t esp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t esp_compute_crc_static(const struct rohc_crc_engine *const crc_engine,
+                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
+	__attribute__((nonnull(1, 2), warn_unused_result));
 static inline
-uint8_t esp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t esp_compute_crc_dynamic(const struct rohc_crc_engine *const crc_engine,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
+	__attribute__((nonnull(1, 2), warn_unused_result));
 
 static inline
-uint8_t rtp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t rtp_compute_crc_static(const struct rohc_crc_engine *const crc_engine,
+                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
+	__attribute__((nonnull(1, 2), warn_unused_result));
 static inline
-uint8_t rtp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t rtp_compute_crc_dynamic(const struct rohc_crc_engine *const crc_engine,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val)
-	__attribute__((nonnull(1), warn_unused_result));
+	__attribute__((nonnull(1, 2), warn_unused_result));
 
 uint8_t compute_crc_ctrl_fields(const rohc_profile_t profile_id,
                                 const uint8_t reorder_ratio,
@@ -203,6 +230,19 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
                       const size_t length,
                       const uint8_t init_val)
 	__attribute__((nonnull(2), warn_unused_result));
+static inline
+uint8_t crc_engine_calc(const struct rohc_crc_engine *const crc_engine,
+                        const rohc_crc_type_t crc_type,
+                        const uint8_t *const data,
+                        const size_t length,
+                        const uint8_t init_val)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+static inline
+uint32_t crc_engine_fcs32(const struct rohc_crc_engine *const crc_engine,
+                          const uint8_t *const data,
+                          const size_t length,
+                          const uint32_t init_val)
+	__attribute__((nonnull(1, 2), warn_unused_result));
 
 static inline uint8_t crc_calc_8(const uint8_t *const buf,
                                  const size_t size,
@@ -257,9 +297,64 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
 }
 
 
+/**
+ * @brief Calculate the checksum for the given data with one CRC engine
+ *
+ * The tables of the library are used if the engine has no CRC callback.
+ *
+ * @param crc_engine  The CRC engine of the compressor or decompressor
+ * @param crc_type    The CRC type
+ * @param data        The data to calculate the checksum on
+ * @param length      The length of the data
+ * @param init_val    The initial CRC value
+ * @return            The checksum
+ */
+static inline
+uint8_t crc_engine_calc(const struct rohc_crc_engine *const crc_engine,
+                        const rohc_crc_type_t crc_type,
+                        const uint8_t *const data,
+                        const size_t length,
+                        const uint8_t init_val)
+{
+	if(crc_engine->crc_calc == NULL || crc_type == ROHC_CRC_TYPE_NONE)
+	{
+		return crc_calculate(crc_type, data, length, init_val);
+	}
+	return crc_engine->crc_calc(crc_type, data, length, init_val,
+	                            crc_engine->priv_ctxt);
+}
+
+
+/**
+ * @brief Calculate the FCS-32 for the given data with one CRC engine
+ *
+ * The tables of the library are used if the engine has no FCS-32 callback.
+ *
+ * @param crc_engine  The CRC engine of the compressor or decompressor
+ * @param data        The data to calculate the FCS-32 on
+ * @param length      The length of the data
+ * @param init_val    The initial value of the FCS-32
+ * @return            The FCS-32
+ */
+static inline
+uint32_t crc_engine_fcs32(const struct rohc_crc_engine *const crc_engine,
+                          const uint8_t *const data,
+                          const size_t length,
+                          const uint32_t init_val)
+{
+	if(crc_engine->fcs32_calc == NULL)
+	{
+		return crc_calc_fcs32(data, length, init_val);
+	}
+	return crc_engine->fcs32_calc(data, length, init_val, crc_engine->priv_ctxt);
+}
+
+
 /**
  * @brief Optimized CRC-8 calculation using a table
  *
+ * The headers of several bytes are computed with the slicing-by-4 tables.
+ *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
  * @param init_val   The initial CRC value
@@ -272,6 +367,11 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
 	uint8_t crc = init_val;
 	size_t i;
 
+	if(size >= CRC_SLICE4_MIN_LEN)
+	{
+		return crc_calc_8_slice4(buf, size, init_val);
+	}
+
 	for(i = 0; i < size; i++)
 	{
 		crc = crc_table_8[buf[i] ^ crc];
@@ -284,6 +384,8 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
 /**
  * @brief Optimized CRC-7 calculation using a table
  *
+ * The headers of several bytes are computed with the slicing-by-4 tables.
+ *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
  * @param init_val   The initial CRC value
@@ -296,6 +398,11 @@ static inline uint8_t crc_calc_7(const uint8_t *const buf,
 	uint8_t crc = init_val;
 	size_t i;
 
+	if(size >= CRC_SLICE4_MIN_LEN)
+	{
+		return crc_calc_7_slice4(buf, size, init_val);
+	}
+
 	for(i = 0; i < size; i++)
 	{
 		crc = crc_table_7[buf[i] ^ (crc & 127)];
@@ -328,23 +435,25 @@ static inline uint8_t crc_calc_3(const uint8_t *const buf,
  *  all fields expect those for CRC-DYNAMIC
  *    - bytes 1-4 in original UDP header
  *
+ * @param crc_engine       The CRC engine of the (de)compressor
  * @param uncomp_pkt_hdrs  The uncompressed headers to compute CRC for
  * @param crc_type         The type of CRC
  * @param init_val         The initial CRC value
  * @return                 The computed CRC
  */
 static inline
-uint8_t udp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t udp_compute_crc_static(const struct rohc_crc_engine *const crc_engine,
+                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 
 	/* compute the CRC-STATIC value for IP and IP2 headers */
-	crc = ip_compute_crc_static(uncomp_pkt_hdrs, crc_type, crc);
+	crc = ip_compute_crc_static(crc_engine, uncomp_pkt_hdrs, crc_type, crc);
 
 	/* bytes 1-4 (Source Port, Destination Port) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&uncomp_pkt_hdrs->udp->source), 4, crc);
+	crc = crc_engine_calc(crc_engine, crc_type, (uint8_t *)(&uncomp_pkt_hdrs->udp->source), 4, crc);
 
 	return crc;
 }
@@ -356,23 +465,25 @@ uint8_t udp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs
  * Concerned fields are:
  *   - bytes 5-6, 7-8 in original UDP header
  *
+ * @param crc_engine       The CRC engine of the (de)compressor
  * @param uncomp_pkt_hdrs  The uncompressed headers to compute CRC for
  * @param crc_type         The type of CRC
  * @param init_val         The initial CRC value
  * @return                 The computed CRC
  */
 static inline
-uint8_t udp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t udp_compute_crc_dynamic(const struct rohc_crc_engine *const crc_engine,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 
 	/* compute the CRC-DYNAMIC value for IP and IP2 headers */
-	crc = ip_compute_crc_dynamic(uncomp_pkt_hdrs, crc_type, crc);
+	crc = ip_compute_crc_dynamic(crc_engine, uncomp_pkt_hdrs, crc_type, crc);
 
 	/* bytes 5-8 (Length, Checksum) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&uncomp_pkt_hdrs->udp->len), 4, crc);
+	crc = crc_engine_calc(crc_engine, crc_type, (uint8_t *)(&uncomp_pkt_hdrs->udp->len), 4, crc);
 
 	return crc;
 }
@@ -385,23 +496,25 @@ uint8_t udp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdr
  *  all fields expect those for CRC-DYNAMIC
  *    - bytes 1-4 in original ESP header
  *
+ * @param crc_engine       The CRC engine of the (de)compressor
  * @param uncomp_pkt_hdrs  The uncompressed headers to compute CRC for
  * @param crc_type         The type of CRC
  * @param init_val         The initial CRC value
  * @return                 The computed CRC
  */
 static inline
-uint8_t esp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t esp_compute_crc_static(const struct rohc_crc_engine *const crc_engine,
+                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 
 	/* compute the CRC-STATIC value for IP and IP2 headers */
-	crc = ip_compute_crc_static(uncomp_pkt_hdrs, crc_type, crc);
+	crc = ip_compute_crc_static(crc_engine, uncomp_pkt_hdrs, crc_type, crc);
 
 	/* bytes 1-4 (Security parameters index) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&uncomp_pkt_hdrs->esp->spi), 4, crc);
+	crc = crc_engine_calc(crc_engine, crc_type, (uint8_t *)(&uncomp_pkt_hdrs->esp->spi), 4, crc);
 
 	return crc;
 }
@@ -413,23 +526,25 @@ uint8_t esp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs
  * Concerned fields are:
  *   - bytes 5-8 in original ESP header
  *
+ * @param crc_engine       The CRC engine of the (de)compressor
  * @param uncomp_pkt_hdrs  The uncompressed headers to compute CRC for
  * @param crc_type         The type of CRC
  * @param init_val         The initial CRC value
  * @return                 The computed CRC
  */
 static inline
-uint8_t esp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t esp_compute_crc_dynamic(const struct rohc_crc_engine *const crc_engine,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 
 	/* compute the CRC-DYNAMIC value for IP and IP2 headers */
-	crc = ip_compute_crc_dynamic(uncomp_pkt_hdrs, crc_type, crc);
+	crc = ip_compute_crc_dynamic(crc_engine, uncomp_pkt_hdrs, crc_type, crc);
 
 	/* bytes 5-8 (Sequence number) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&uncomp_pkt_hdrs->esp->sn), 4, crc);
+	crc = crc_engine_calc(crc_engine, crc_type, (uint8_t *)(&uncomp_pkt_hdrs->esp->sn), 4, crc);
 
 	return crc;
 }
@@ -442,26 +557,28 @@ uint8_t esp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdr
  *  all fields expect those for CRC-DYNAMIC
  *    - bytes 1, 9-12 (and CSRC list) in original RTP header
  *
+ * @param crc_engine       The CRC engine of the (de)compressor
  * @param uncomp_pkt_hdrs  The uncompressed headers to compute CRC for
  * @param crc_type         The type of CRC
  * @param init_val         The initial CRC value
  * @return                 The computed CRC
  */
 static inline
-uint8_t rtp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t rtp_compute_crc_static(const struct rohc_crc_engine *const crc_engine,
+                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 
 	/* compute the CRC-STATIC value for IP, IP2 and UDP headers */
-	crc = udp_compute_crc_static(uncomp_pkt_hdrs, crc_type, crc);
+	crc = udp_compute_crc_static(crc_engine, uncomp_pkt_hdrs, crc_type, crc);
 
 	/* byte 1 (Version, P, X, CC) */
-	crc = crc_calculate(crc_type, (uint8_t *)uncomp_pkt_hdrs->rtp, 1, crc);
+	crc = crc_engine_calc(crc_engine, crc_type, (uint8_t *)uncomp_pkt_hdrs->rtp, 1, crc);
 
 	/* bytes 9-12 (SSRC identifier) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&uncomp_pkt_hdrs->rtp->ssrc), 4, crc);
+	crc = crc_engine_calc(crc_engine, crc_type, (uint8_t *)(&uncomp_pkt_hdrs->rtp->ssrc), 4, crc);
 
 	/* TODO: CSRC identifiers */
 
@@ -475,23 +592,25 @@ uint8_t rtp_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs
  * Concerned fields are:
  *   - bytes 2, 3-4, 5-8 in original RTP header
  *
+ * @param crc_engine       The CRC engine of the (de)compressor
  * @param uncomp_pkt_hdrs  The uncompressed headers to compute CRC for
  * @param crc_type         The type of CRC
  * @param init_val         The initial CRC value
  * @return                 The computed CRC
  */
 static inline
-uint8_t rtp_compute_crc_dynamic(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+uint8_t rtp_compute_crc_dynamic(const struct rohc_crc_engine *const crc_engine,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val)
 {
 	uint8_t crc = init_val;
 
 	/* compute the CRC-DYNAMIC value for IP, IP2 and UDP headers */
-	crc = udp_compute_crc_dynamic(uncomp_pkt_hdrs, crc_type, crc);
+	crc = udp_compute_crc_dynamic(crc_engine, uncomp_pkt_hdrs, crc_type, crc);
 
 	/* bytes 2-8 (Marker, Payload Type, Sequence Number, Timestamp) */
-	crc = crc_calculate(crc_type, ((uint8_t *) uncomp_pkt_hdrs->rtp) + 1, 7, crc);
+	crc = crc_engine_calc(crc_engine, crc_type, ((uint8_t *) uncomp_pkt_hdrs->rtp) + 1, 7, crc);
 
 	return crc;
 }
@@ -68,14 +68,28 @@
 	d = ROTATE(d, t) ^ c;			\
 	a = ROTATE(a, 32);
 
-#define DOUBLE_ROUND(v0,v1,v2,v3)		\
-	HALF_ROUND(v0,v1,v2,v3,13,16);		\
-	HALF_ROUND(v2,v1,v0,v3,17,21);		\
+#define SINGLE_ROUND(v0,v1,v2,v3)		\
 	HALF_ROUND(v0,v1,v2,v3,13,16);		\
 	HALF_ROUND(v2,v1,v0,v3,17,21);
 
+#define ROUNDS(v0,v1,v2,v3,n)			\
+	do {					\
+		int r;				\
+		for (r = 0; r < (n); r++) {	\
+			SINGLE_ROUND(v0,v1,v2,v3);	\
+		}				\
+	} while (0)
 
-uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16]) {
+
+/* SipHash-c-d: c rounds per message block, d finalization rounds */
+static inline uint64_t siphash_cd(const void *src, unsigned long src_sz,
+                                  const char key[16], const int c_rounds,
+                                  const int d_rounds)
+	__attribute__((always_inline));
+
+static inline uint64_t siphash_cd(const void *src, unsigned long src_sz,
+                                  const char key[16], const int c_rounds,
+                                  const int d_rounds) {
 	const uint64_t *_key = (uint64_t *)key;
 	uint64_t k0 = _le64toh(_key[0]);
 	uint64_t k1 = _le64toh(_key[1]);
@@ -91,7 +105,7 @@ uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16]) {
 		uint64_t mi = _le64toh(*in);
 		in += 1; src_sz -= 8;
 		v3 ^= mi;
-		DOUBLE_ROUND(v0,v1,v2,v3);
+		ROUNDS(v0,v1,v2,v3,c_rounds);
 		v0 ^= mi;
 	}
 
@@ -125,9 +139,20 @@ uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16]) {
 	}
 
 	v3 ^= b;
-	DOUBLE_ROUND(v0,v1,v2,v3);
+	ROUNDS(v0,v1,v2,v3,c_rounds);
 	v0 ^= b; v2 ^= 0xff;
-	DOUBLE_ROUND(v0,v1,v2,v3);
-	DOUBLE_ROUND(v0,v1,v2,v3);
+	ROUNDS(v0,v1,v2,v3,d_rounds);
 	return (v0 ^ v1) ^ (v2 ^ v3);
 }
+
+
+uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16]) {
+	return siphash_cd(src, src_sz, key, 2, 4);
+}
+
+
+/* SipHash-1-3, the faster variant used by the hash tables of several
+ * languages, still keyed */
+uint64_t siphash13(const void *src, unsigned long src_sz, const char key[16]) {
+	return siphash_cd(src, src_sz, key, 1, 3);
+}
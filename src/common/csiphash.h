@@ -37,5 +37,8 @@
 uint64_t siphash24(const void *src, unsigned long src_sz, const char key[16])
 	__attribute__((warn_unused_result, nonnull(1)));
 
+uint64_t siphash13(const void *src, unsigned long src_sz, const char key[16])
+	__attribute__((warn_unused_result, nonnull(1)));
+
 #endif /* ROHC_CSIPHASH_H */
 
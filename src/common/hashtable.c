@@ -26,21 +26,55 @@
 
 #include "csiphash.h"
 
+#ifndef __KERNEL__
+#  include "config.h" /* for ROHC_ALLOC_CHECK */
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+/* the AES rounds of the CPU hash the keys in a few cycles, but not in kernel
+ * space where the vector registers are not available without saving them
+ * first */
+#if !defined(__KERNEL__) && defined(__GNUC__) && defined(__x86_64__)
+#  define ROHC_HASHTABLE_AES_NI 1
+#  include <wmmintrin.h>
+#elif !defined(__KERNEL__) && defined(__aarch64__) && \
+      (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#  define ROHC_HASHTABLE_ARM_AES 1
+#  include <arm_neon.h>
+#endif
+
+
+static size_t hashtable_find_slot(const struct hashtable *const hashtable,
+                                  const uint64_t hash,
+                                  const void *const elem)
+	__attribute((warn_unused_result, nonnull(1, 3)));
+
+static bool hashtable_grow(struct hashtable *const hashtable)
+	__attribute((warn_unused_result, nonnull(1)));
+
+#if defined(ROHC_HASHTABLE_AES_NI)
+static uint64_t hashtable_aes_hash_x86(const void *const data,
+                                       const size_t len,
+                                       const char key[16])
+	__attribute((warn_unused_result, nonnull(1), target("aes")));
+#endif
+
 
 bool hashtable_new(struct hashtable *const hashtable,
-                   const size_t key_len,
-                   const size_t size)
+                   const size_t key_offset)
 {
-	hashtable->key_len = key_len;
-	hashtable->full_key_len = key_len;
-	hashtable->mask = size - 1;
+	hashtable->key_offset = key_offset;
+	hashtable->mask = HASHTABLE_MIN_SIZE - 1;
+	hashtable->elems_nr = 0;
+	hashtable->hash_fn = hashtable_siphash24;
+	hashtable->hash_priv = NULL;
+	hashtable->is_fixed = false;
 
-	hashtable->table = calloc(size, sizeof(struct hashlist *));
-	if(hashtable->table == NULL)
+	hashtable->slots = calloc(HASHTABLE_MIN_SIZE, sizeof(struct hashtable_slot));
+	if(hashtable->slots == NULL)
 	{
 		return false;
 	}
@@ -51,84 +85,480 @@ bool hashtable_new(struct hashtable *const hashtable,
 
 void hashtable_free(struct hashtable *const hashtable)
 {
-	free(hashtable->table);
+	free(hashtable->slots);
+}
+
+
+/**
+ * @brief Reserve the slots of the hash table once for all
+ *
+ * The table is grown to keep the given number of elements at most half full,
+ * then it never grows again: the additions beyond that number of elements
+ * fail instead of allocating memory, or abort the program if the library was
+ * built with the check of the allocations.
+ *
+ * @param hashtable  The hash table
+ * @param elems_nr   The maximum number of elements in the table
+ * @return           true if the slots were reserved, false if memory is
+ *                   missing
+ */
+bool hashtable_reserve(struct hashtable *const hashtable,
+                       const size_t elems_nr)
+{
+	while((elems_nr * 2) > (hashtable->mask + 1))
+	{
+		if(!hashtable_grow(hashtable))
+		{
+			return false;
+		}
+	}
+	hashtable->is_fixed = true;
+
+	return true;
 }
 
 
-void hashtable_add(struct hashtable *const hashtable,
+/**
+ * @brief Change the function that hashes the keys of the hash table
+ *
+ * The hashes of the elements are cached in the slots, so the hash function
+ * shall be changed while the table is empty only.
+ *
+ * @param hashtable  The hash table
+ * @param hash_fn    The hash function for the keys
+ * @param hash_priv  The private context given to the hash function
+ */
+void hashtable_set_hash(struct hashtable *const hashtable,
+                        const hashtable_hash_fn_t hash_fn,
+                        void *const hash_priv)
+{
+	assert(hashtable->elems_nr == 0);
+	hashtable->hash_fn = hash_fn;
+	hashtable->hash_priv = hash_priv;
+}
+
+
+bool hashtable_add(struct hashtable *const hashtable,
                    const void *const key,
+                   const size_t key_len,
                    void *const elem)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	const uint64_t hash = hashtable_hash(hashtable, key, key_len);
+	uint64_t i;
 
-	entry = hashtable->table[hash & hashtable->mask];
-	if(entry == NULL)
+	/* nothing to do if the element is already in the table */
+	if(hashtable_find_slot(hashtable, hash, elem) <= hashtable->mask)
 	{
-		hashtable->table[hash & hashtable->mask] = elem;
-		((struct hashlist *) elem)->prev = NULL;
+		return true;
 	}
-	else
+
+	/* keep the table at most half full, so that probe sequences stay short */
+	if(((hashtable->elems_nr + 1) * 2) > (hashtable->mask + 1) &&
+	   !hashtable_grow(hashtable))
+	{
+		return false;
+	}
+
+	i = hash & hashtable->mask;
+	while(hashtable->slots[i].elem != NULL)
+	{
+		i = (i + 1) & hashtable->mask;
+	}
+	hashtable->slots[i].hash = hash;
+	hashtable->slots[i].elem = elem;
+	hashtable->elems_nr++;
+
+	return true;
+}
+
+
+void * hashtable_get(const struct hashtable *const hashtable,
+                     const void *const key,
+                     const size_t key_len)
+{
+	const uint64_t hash = hashtable_hash(hashtable, key, key_len);
+	uint64_t i;
+
+	for(i = hash & hashtable->mask;
+	    hashtable->slots[i].elem != NULL;
+	    i = (i + 1) & hashtable->mask)
 	{
-		while(entry->next != NULL)
+		const uint8_t *const elem = hashtable->slots[i].elem;
+
+		/* compare the cached hashes first, then the keys */
+		if(hashtable->slots[i].hash == hash &&
+		   memcmp(key, elem + hashtable->key_offset, key_len) == 0)
 		{
-			entry = entry->next;
+			return hashtable->slots[i].elem;
 		}
-		entry->next = elem;
-		((struct hashlist *) elem)->prev = entry;
 	}
-	((struct hashlist *) elem)->next = NULL;
+
+	return NULL;
 }
 
 
-void * hashtable_get(const struct hashtable *const hashtable,
-                     const void *const key)
+void * hashtable_get_next(const struct hashtable *const hashtable,
+                          const void *const key,
+                          const size_t key_len,
+                          const void *const pos)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	const uint64_t hash = hashtable_hash(hashtable, key, key_len);
+	uint64_t i;
 
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next)
+	/* start right after the previous element, it shares the hash */
+	i = hashtable_find_slot(hashtable, hash, pos);
+	if(i > hashtable->mask)
 	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
+		return NULL;
+	}
+
+	for(i = (i + 1) & hashtable->mask;
+	    hashtable->slots[i].elem != NULL;
+	    i = (i + 1) & hashtable->mask)
+	{
+		const uint8_t *const elem = hashtable->slots[i].elem;
+
+		if(hashtable->slots[i].hash == hash &&
+		   memcmp(key, elem + hashtable->key_offset, key_len) == 0)
 		{
-			break;
+			return hashtable->slots[i].elem;
 		}
 	}
 
-	return entry;
+	return NULL;
+}
+
+
+uint64_t hashtable_hash(const struct hashtable *const hashtable,
+                        const void *const key,
+                        const size_t key_len)
+{
+	return hashtable->hash_fn(key, key_len, hashtable->key, hashtable->hash_priv);
+}
+
+
+/**
+ * @brief Hash the given key with SipHash-2-4, the default hash function
+ *
+ * @param data  The key of the element to hash
+ * @param len   The length of the key of the element
+ * @param key   The secret key of the hash table
+ * @param priv  Unused
+ * @return      The 64-bit hash
+ */
+uint64_t hashtable_siphash24(const void *const data,
+                             const size_t len,
+                             const char key[16],
+                             void *const priv __attribute__((unused)))
+{
+	return siphash24(data, len, key);
+}
+
+
+/**
+ * @brief Hash the given key with SipHash-1-3
+ *
+ * Half the rounds of SipHash-2-4, still keyed so that the flows cannot be
+ * chosen to collide in the table.
+ *
+ * @param data  The key of the element to hash
+ * @param len   The length of the key of the element
+ * @param key   The secret key of the hash table
+ * @param priv  Unused
+ * @return      The 64-bit hash
+ */
+uint64_t hashtable_siphash13(const void *const data,
+                             const size_t len,
+                             const char key[16],
+                             void *const priv __attribute__((unused)))
+{
+	return siphash13(data, len, key);
+}
+
+
+/**
+ * @brief Whether the AES rounds of the CPU are available for hashing
+ *
+ * @return  true if \ref hashtable_aes_hash may be used, false otherwise
+ */
+bool hashtable_aes_hash_available(void)
+{
+#if defined(ROHC_HASHTABLE_AES_NI)
+	return !!__builtin_cpu_supports("aes");
+#elif defined(ROHC_HASHTABLE_ARM_AES)
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+/**
+ * @brief Hash the given key with the AES rounds of the CPU
+ *
+ * Every block of 16 bytes of the key of the element, the last one padded
+ * with zeroes, goes through one AES round keyed with the secret of the
+ * table, then 2 more rounds mix the state. The length of the key of the
+ * element is mixed first, so that the padding zeroes do not collide. The
+ * hash is not a MAC, but the secret key of the table is still required to
+ * choose colliding flows.
+ *
+ * Shall be used only if \ref hashtable_aes_hash_available returns true.
+ *
+ * @param data  The key of the element to hash
+ * @param len   The length of the key of the element
+ * @param key   The secret key of the hash table
+ * @param priv  Unused
+ * @return      The 64-bit hash
+ */
+uint64_t hashtable_aes_hash(const void *const data,
+                            const size_t len,
+                            const char key[16],
+                            void *const priv __attribute__((unused)))
+{
+#if defined(ROHC_HASHTABLE_AES_NI)
+	return hashtable_aes_hash_x86(data, len, key);
+#elif defined(ROHC_HASHTABLE_ARM_AES)
+	const uint8x16_t round_key = vld1q_u8((const uint8_t *) key);
+	const uint8x16_t round_key2 =
+		veorq_u8(round_key, vdupq_n_u8(0x5c));
+	const uint8_t *bytes = data;
+	size_t remain = len;
+	uint64_t len_block[2] = { len, 0 };
+	uint8x16_t state;
+
+	state = veorq_u8(round_key2, vld1q_u8((const uint8_t *) len_block));
+	for(; remain >= 16; remain -= 16, bytes += 16)
+	{
+		state = veorq_u8(state, vld1q_u8(bytes));
+		state = vaesmcq_u8(vaeseq_u8(state, round_key));
+	}
+	if(remain > 0)
+	{
+		uint8_t last[16] = { 0 };
+		memcpy(last, bytes, remain);
+		state = veorq_u8(state, vld1q_u8(last));
+		state = vaesmcq_u8(vaeseq_u8(state, round_key));
+	}
+	state = vaesmcq_u8(vaeseq_u8(state, round_key2));
+	state = vaesmcq_u8(vaeseq_u8(state, round_key));
+
+	return (vgetq_lane_u64(vreinterpretq_u64_u8(state), 0) ^
+	        vgetq_lane_u64(vreinterpretq_u64_u8(state), 1));
+#else
+	/* not reached if hashtable_aes_hash_available() was checked */
+	return siphash13(data, len, key);
+#endif
+}
+
+
+/**
+ * @brief Hash the given key without any secret
+ *
+ * Every word of 8 bytes is mixed with one multiplication, then the
+ * finalizer of MurmurHash3 mixes the bits. The hash is the fastest one, but
+ * anybody may choose flows that collide in the table: for trusted traffic
+ * only.
+ *
+ * @param data  The key of the element to hash
+ * @param len   The length of the key of the element
+ * @param key   Unused
+ * @param priv  Unused
+ * @return      The 64-bit hash
+ */
+uint64_t hashtable_unkeyed_hash(const void *const data,
+                                const size_t len,
+                                const char key[16] __attribute__((unused)),
+                                void *const priv __attribute__((unused)))
+{
+	const uint8_t *bytes = data;
+	uint64_t hash = 0x9e3779b97f4a7c15ULL ^ len;
+	uint64_t word;
+	size_t remain;
+
+	for(remain = len; remain >= 8; remain -= 8, bytes += 8)
+	{
+		memcpy(&word, bytes, 8);
+		hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 32;
+	}
+	if(remain > 0)
+	{
+		word = 0;
+		memcpy(&word, bytes, remain);
+		hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+	}
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
 }
 
 
 void hashtable_del(struct hashtable *const hashtable,
-                   const void *const key)
+                   const void *const key,
+                   const size_t key_len,
+                   const void *const elem)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	const uint64_t hash = hashtable_hash(hashtable, key, key_len);
+	uint64_t i;
+	uint64_t j;
+
+	i = hashtable_find_slot(hashtable, hash, elem);
+	if(i > hashtable->mask)
+	{
+		/* element not in table */
+		return;
+	}
 
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next)
+	/* shift back the next elements of the probe sequence that may be moved
+	 * closer to their home slot, so that no tombstone is required */
+	for(j = (i + 1) & hashtable->mask;
+	    hashtable->slots[j].elem != NULL;
+	    j = (j + 1) & hashtable->mask)
 	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
+		const uint64_t home = hashtable->slots[j].hash & hashtable->mask;
+
+		/* the element in slot j may be moved to slot i only if its home slot
+		 * is not cyclically in ]i, j] */
+		if(((j - home) & hashtable->mask) >= ((j - i) & hashtable->mask))
 		{
-			if(entry->prev == NULL)
-			{
-				hashtable->table[hash & hashtable->mask] = entry->next;
-			}
-			else
-			{
-				entry->prev->next = entry->next;
-			}
+			hashtable->slots[i] = hashtable->slots[j];
+			i = j;
+		}
+	}
+	hashtable->slots[i].elem = NULL;
+	assert(hashtable->elems_nr > 0);
+	hashtable->elems_nr--;
+}
+
+
+/**
+ * @brief Find the slot of the given element
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key of the element
+ * @param elem       The element to search for
+ * @return           The index of the slot, or a value greater than the mask
+ *                   of the table if the element is not in the table
+ */
+static size_t hashtable_find_slot(const struct hashtable *const hashtable,
+                                  const uint64_t hash,
+                                  const void *const elem)
+{
+	uint64_t i;
+
+	for(i = hash & hashtable->mask;
+	    hashtable->slots[i].elem != NULL;
+	    i = (i + 1) & hashtable->mask)
+	{
+		if(hashtable->slots[i].elem == elem)
+		{
+			return i;
+		}
+	}
+
+	return hashtable->mask + 1;
+}
+
+
+/**
+ * @brief Double the number of slots of the hash table
+ *
+ * The cached hashes are used to re-insert the elements, no key is hashed
+ * again.
+ *
+ * @param hashtable  The hash table
+ * @return           true if the table was grown, false if memory is missing
+ *                   or if the slots were reserved once for all
+ */
+static bool hashtable_grow(struct hashtable *const hashtable)
+{
+	const uint64_t new_mask = (hashtable->mask << 1) | 1;
+	struct hashtable_slot *new_slots;
+	uint64_t i;
+
+	if(hashtable->is_fixed)
+	{
+#if ROHC_ALLOC_CHECK == 1
+		/* more slots than reserved are required */
+		abort();
+#endif
+		return false;
+	}
 
-			if(entry->next != NULL)
+	new_slots = calloc(new_mask + 1, sizeof(struct hashtable_slot));
+	if(new_slots == NULL)
+	{
+		return false;
+	}
+
+	for(i = 0; i <= hashtable->mask; i++)
+	{
+		if(hashtable->slots[i].elem != NULL)
+		{
+			uint64_t j = hashtable->slots[i].hash & new_mask;
+
+			while(new_slots[j].elem != NULL)
 			{
-				entry->next->prev = entry->prev;
+				j = (j + 1) & new_mask;
 			}
-
-			break;
+			new_slots[j] = hashtable->slots[i];
 		}
 	}
+
+	free(hashtable->slots);
+	hashtable->slots = new_slots;
+	hashtable->mask = new_mask;
+
+	return true;
+}
+
+
+#if defined(ROHC_HASHTABLE_AES_NI)
+
+/**
+ * @brief Hash the given key with the AES-NI instructions of x86 CPUs
+ *
+ * See \ref hashtable_aes_hash.
+ *
+ * @param data  The key of the element to hash
+ * @param len   The length of the key of the element
+ * @param key   The secret key of the hash table
+ * @return      The 64-bit hash
+ */
+static uint64_t hashtable_aes_hash_x86(const void *const data,
+                                       const size_t len,
+                                       const char key[16])
+{
+	const __m128i round_key = _mm_loadu_si128((const __m128i *) key);
+	const __m128i round_key2 = _mm_xor_si128(round_key, _mm_set1_epi8(0x5c));
+	const uint8_t *bytes = data;
+	size_t remain = len;
+	__m128i state;
+
+	state = _mm_xor_si128(round_key2, _mm_set_epi64x(0, (int64_t) len));
+	for(; remain >= 16; remain -= 16, bytes += 16)
+	{
+		state = _mm_xor_si128(state, _mm_loadu_si128((const __m128i *) bytes));
+		state = _mm_aesenc_si128(state, round_key);
+	}
+	if(remain > 0)
+	{
+		uint8_t last[16] = { 0 };
+		memcpy(last, bytes, remain);
+		state = _mm_xor_si128(state, _mm_loadu_si128((const __m128i *) last));
+		state = _mm_aesenc_si128(state, round_key);
+	}
+	state = _mm_aesenc_si128(state, round_key2);
+	state = _mm_aesenc_si128(state, round_key);
+
+	return ((uint64_t) _mm_cvtsi128_si64(state)) ^
+	       ((uint64_t) _mm_cvtsi128_si64(_mm_unpackhi_epi64(state, state)));
 }
 
+#endif /* ROHC_HASHTABLE_AES_NI */
@@ -30,48 +30,131 @@
 #include <stdint.h>
 
 
-/** A linked list */
-struct hashlist
+/** The initial number of slots of one hash table */
+#define HASHTABLE_MIN_SIZE  16U
+
+
+/**
+ * @brief The prototype of the hash functions of the hash tables
+ *
+ * @param data  The key of the element to hash
+ * @param len   The length of the key of the element
+ * @param key   The secret key of the hash table
+ * @param priv  The private context given with the hash function
+ * @return      The 64-bit hash
+ */
+typedef uint64_t (*hashtable_hash_fn_t)(const void *const data,
+                                        const size_t len,
+                                        const char key[16],
+                                        void *const priv);
+
+
+/** One slot of a hash table */
+struct hashtable_slot
 {
-	struct hashlist *prev;
-	struct hashlist *next;
-	struct hashlist *prev_cr;
-	struct hashlist *next_cr;
-	uint8_t key[];
-} __attribute__((packed));
+	uint64_t hash;  /**< The cached hash of the key of the element */
+	void *elem;     /**< The element, NULL if the slot is empty */
+};
 
 
-/** One hash table */
+/**
+ * @brief One hash table
+ *
+ * The hash table uses open addressing with linear probing: elements are
+ * stored directly in an array of slots, and the hash of every element is
+ * cached in its slot, so a lookup compares the hashes of consecutive slots
+ * and compares the keys only on hash match. The array grows when it becomes
+ * half full.
+ *
+ * The keys are stored within the elements at a fixed offset. Several
+ * elements may share the same key, see \ref hashtable_get_next.
+ *
+ * The keys are hashed with SipHash-2-4 keyed with a random secret by
+ * default, see \ref hashtable_set_hash for faster hash functions.
+ */
 struct hashtable
 {
-	size_t key_len;
-	size_t full_key_len;
-	uint64_t mask;
-	struct hashlist **table;
+	size_t key_offset;  /**< The offset of the key within the elements */
+	uint64_t mask;      /**< The number of slots minus one */
+	size_t elems_nr;    /**< The number of elements in the table */
+	struct hashtable_slot *slots;
 	char key[16];
+	hashtable_hash_fn_t hash_fn;  /**< The function that hashes the keys */
+	void *hash_priv;              /**< The private context of the function */
+	bool is_fixed;  /**< Whether the slots were reserved once for all */
 };
 
 
 bool hashtable_new(struct hashtable *const hashtable,
-                   const size_t key_len,
-                   const size_t size)
+                   const size_t key_offset)
 	__attribute((warn_unused_result, nonnull(1)));
 
 void hashtable_free(struct hashtable *const hashtable)
 	__attribute((nonnull(1)));
 
-void hashtable_add(struct hashtable *const hashtable,
+bool hashtable_reserve(struct hashtable *const hashtable,
+                       const size_t elems_nr)
+	__attribute((warn_unused_result, nonnull(1)));
+
+void hashtable_set_hash(struct hashtable *const hashtable,
+                        const hashtable_hash_fn_t hash_fn,
+                        void *const hash_priv)
+	__attribute((nonnull(1, 2)));
+
+bool hashtable_add(struct hashtable *const hashtable,
                    const void *const key,
+                   const size_t key_len,
                    void *const elem)
-	__attribute((nonnull(1, 2, 3)));
+	__attribute((warn_unused_result, nonnull(1, 2, 4)));
 
 void * hashtable_get(const struct hashtable *const hashtable,
-                     const void *const key)
+                     const void *const key,
+                     const size_t key_len)
 	__attribute((warn_unused_result, nonnull(1, 2)));
 
+void * hashtable_get_next(const struct hashtable *const hashtable,
+                          const void *const key,
+                          const size_t key_len,
+                          const void *const pos)
+	__attribute((warn_unused_result, nonnull(1, 2, 4)));
+
+uint64_t hashtable_hash(const struct hashtable *const hashtable,
+                        const void *const key,
+                        const size_t key_len)
+	__attribute((warn_unused_result, nonnull(1, 2), pure));
+
 void hashtable_del(struct hashtable *const hashtable,
-                   const void *const key)
-	__attribute((nonnull(1, 2)));
+                   const void *const key,
+                   const size_t key_len,
+                   const void *const elem)
+	__attribute((nonnull(1, 2, 4)));
+
+uint64_t hashtable_siphash24(const void *const data,
+                             const size_t len,
+                             const char key[16],
+                             void *const priv)
+	__attribute((warn_unused_result, nonnull(1)));
+
+uint64_t hashtable_siphash13(const void *const data,
+                             const size_t len,
+                             const char key[16],
+                             void *const priv)
+	__attribute((warn_unused_result, nonnull(1)));
+
+bool hashtable_aes_hash_available(void)
+	__attribute((warn_unused_result));
+
+uint64_t hashtable_aes_hash(const void *const data,
+                            const size_t len,
+                            const char key[16],
+                            void *const priv)
+	__attribute((warn_unused_result, nonnull(1)));
+
+uint64_t hashtable_unkeyed_hash(const void *const data,
+                                const size_t len,
+                                const char key[16],
+                                void *const priv)
+	__attribute((warn_unused_result, nonnull(1)));
 
 #endif
 
@@ -29,6 +29,74 @@
 #include <assert.h>
 
 
+/** Build a table of 33 shift parameters p, one for every k in [0 ; 32] */
+#define ROHC_INTERVAL_P_TABLE(f) \
+	{ \
+		f(0),  f(1),  f(2),  f(3),  f(4),  f(5),  f(6),  f(7), \
+		f(8),  f(9),  f(10), f(11), f(12), f(13), f(14), f(15), \
+		f(16), f(17), f(18), f(19), f(20), f(21), f(22), f(23), \
+		f(24), f(25), f(26), f(27), f(28), f(29), f(30), f(31), \
+		f(32), \
+	}
+
+/** Compute 2^k on 64 bits, so that k = 32 does not overflow */
+#define ROHC_INTERVAL_POW2(k)  (((int64_t) 1) << (k))
+
+/** The shift parameter p for RTP TS: 2^(k-2) - 1, or 0 if k <= 2 */
+#define ROHC_INTERVAL_P_RTP_TS(k) \
+	((int32_t) ((k) <= 2 ? 0 : ROHC_INTERVAL_POW2((k) - 2) - 1))
+/** The shift parameter p for timer-based RTP TS: 2^(k-1) - 1, or 0 if k = 0 */
+#define ROHC_INTERVAL_P_RTP_TS_TIMER(k) \
+	((int32_t) ((k) == 0 ? 0 : ROHC_INTERVAL_POW2((k) - 1) - 1))
+/** The shift parameter p for RTP and ESP SN: 2^(k-5) - 1, or 1 if k <= 4 */
+#define ROHC_INTERVAL_P_RTP_SN(k) \
+	((int32_t) ((k) <= 4 ? 1 : ROHC_INTERVAL_POW2((k) - 5) - 1))
+/** The shift parameter p for RFC5225 MSN without reordering */
+#define ROHC_INTERVAL_P_MSN_NONE(k)  ((int32_t) 1)
+/** The shift parameter p for RFC5225 MSN with 1/4 of reordering */
+#define ROHC_INTERVAL_P_MSN_QUARTER(k) \
+	((int32_t) (ROHC_INTERVAL_POW2(k) / 4 - 1))
+/** The shift parameter p for RFC5225 MSN with 1/2 of reordering */
+#define ROHC_INTERVAL_P_MSN_HALF(k) \
+	((int32_t) (ROHC_INTERVAL_POW2(k) / 2 - 1))
+/** The shift parameter p for RFC5225 MSN with 3/4 of reordering
+ *  (saturated to INT32_MAX for k = 32) */
+#define ROHC_INTERVAL_P_MSN_THREEQUARTERS(k) \
+	((int32_t) ((k) == 32 ? INT32_MAX : ROHC_INTERVAL_POW2(k) * 3 / 4 - 1))
+
+
+/** The shift parameters p for the RTP TS, RTP SN and ESP SN codes, indexed by
+ *  \ref ROHC_INTERVAL_P_CODE then by k */
+const int32_t rohc_interval_p_coded[ROHC_INTERVAL_P_CODES_NR]
+                                   [ROHC_INTERVAL_P_TABLE_LEN] =
+{
+	[ROHC_INTERVAL_P_CODE(ROHC_LSB_SHIFT_RTP_TS)] =
+		ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_RTP_TS),
+	[ROHC_INTERVAL_P_CODE(ROHC_LSB_SHIFT_RTP_SN)] =
+		ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_RTP_SN),
+	[ROHC_INTERVAL_P_CODE(ROHC_LSB_SHIFT_ESP_SN)] =
+		ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_RTP_SN),
+};
+
+/** The shift parameters p for the timer-based RTP TS, indexed by k */
+const int32_t rohc_interval_p_rtp_ts_timer[ROHC_INTERVAL_P_TABLE_LEN] =
+	ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_RTP_TS_TIMER);
+
+/** The shift parameters p for RFC5225 MSN, indexed by reorder ratio and k */
+static const int32_t rohc_interval_p_rfc5225_msn[ROHC_REORDERING_THREEQUARTERS + 1]
+                                                [ROHC_INTERVAL_P_TABLE_LEN] =
+{
+	[ROHC_REORDERING_NONE] =
+		ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_MSN_NONE),
+	[ROHC_REORDERING_QUARTER] =
+		ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_MSN_QUARTER),
+	[ROHC_REORDERING_HALF] =
+		ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_MSN_HALF),
+	[ROHC_REORDERING_THREEQUARTERS] =
+		ROHC_INTERVAL_P_TABLE(ROHC_INTERVAL_P_MSN_THREEQUARTERS),
+};
+
+
 /**
  * @brief The f function as defined in LSB encoding for 32-bit fields
  *
@@ -49,22 +117,11 @@ struct rohc_interval32 rohc_f_32bits(const uint32_t v_ref,
                                      const size_t k,
                                      const rohc_lsb_shift_t p)
 {
+	/* the interval width = 2^k - 1, computed on 64 bits for k = 32 */
+	const uint32_t interval_width = (uint32_t) ((((uint64_t) 1) << k) - 1);
+	/* the real p value to use */
+	const int32_t computed_p = rohc_interval_compute_p(k, p);
 	struct rohc_interval32 interval32;
-	uint32_t interval_width;
-	int32_t computed_p;
-
-	/* compute the interval width = 2^k - 1 */
-	if(k == 32)
-	{
-		interval_width = 0xffffffff;
-	}
-	else
-	{
-		interval_width = (1U << k) - 1; /* (1 << k) = 2^k */
-	}
-
-	/* determine the real p value to use */
-	computed_p = rohc_interval_compute_p(k, p);
 
 	/* compute the minimal and maximal values of the interval:
 	 *   min = v_ref - p
@@ -90,27 +147,9 @@ struct rohc_interval32 rohc_f_32bits(const uint32_t v_ref,
 int32_t rohc_interval_get_rfc5225_msn_p(const size_t k,
                                         rohc_reordering_offset_t reorder_ratio)
 {
-	rohc_lsb_shift_t p;
-
-	if(reorder_ratio == ROHC_REORDERING_NONE)
-	{
-		p = 1;
-	}
-	else if(reorder_ratio == ROHC_REORDERING_QUARTER)
-	{
-		p = (1 << k) / 4 - 1;
-	}
-	else if(reorder_ratio == ROHC_REORDERING_HALF)
-	{
-		p = (1 << k) / 2 - 1;
-	}
-	else
-	{
-		assert(reorder_ratio == ROHC_REORDERING_THREEQUARTERS);
-		p = (1 << k) * 3 / 4 - 1;
-	}
-
-	return p;
+	assert(reorder_ratio <= ROHC_REORDERING_THREEQUARTERS);
+	assert(k < ROHC_INTERVAL_P_TABLE_LEN);
+	return rohc_interval_p_rfc5225_msn[reorder_ratio][k];
 }
 
 
@@ -123,6 +162,7 @@ int32_t rohc_interval_get_rfc5225_msn_p(const size_t k,
  */
 int32_t rohc_interval_get_rfc5225_id_id_p(const size_t k)
 {
-	return ((1 << k) / 4 - 1);
+	assert(k < ROHC_INTERVAL_P_TABLE_LEN);
+	return rohc_interval_p_rfc5225_msn[ROHC_REORDERING_QUARTER][k];
 }
 
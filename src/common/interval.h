@@ -34,6 +34,9 @@
 /** The maximum width of the W-LSB window (implementation specific) */
 #define ROHC_WLSB_WIDTH_MAX  UINT8_MAX
 
+/** The number of entries in the tables of shift parameters (k in [0 ; 32]) */
+#define ROHC_INTERVAL_P_TABLE_LEN  33U
+
 
 /**
  * @brief the different values of the shift parameter of the LSB algorithm
@@ -62,6 +65,13 @@ typedef enum
 	ROHC_LSB_SHIFT_TCP_TS_4B  = 0x04000000, /**< real value for TCP TS */
 } rohc_lsb_shift_t;
 
+/** The number of shift codes that need a computation (RTP TS, RTP/ESP SN) */
+#define ROHC_INTERVAL_P_CODES_NR \
+	((size_t) (ROHC_LSB_SHIFT_ESP_SN - ROHC_LSB_SHIFT_RTP_TS + 1))
+
+/** The index of one shift code in the table of precomputed shift parameters */
+#define ROHC_INTERVAL_P_CODE(p)  ((p) - ROHC_LSB_SHIFT_RTP_TS)
+
 
 /**
  * @brief An interval of 8-bit values
@@ -126,6 +136,15 @@ struct rohc_interval32
 };
 
 
+/*
+ * Precomputed shift parameters, indexed by the number k of transmitted bits:
+ */
+
+extern const int32_t rohc_interval_p_coded[ROHC_INTERVAL_P_CODES_NR]
+                                          [ROHC_INTERVAL_P_TABLE_LEN];
+extern const int32_t rohc_interval_p_rtp_ts_timer[ROHC_INTERVAL_P_TABLE_LEN];
+
+
 /*
  * Public function prototypes:
  */
@@ -142,6 +161,9 @@ struct rohc_interval32 rohc_f_32bits(const uint32_t v_ref,
 static inline int32_t rohc_interval_compute_p_rtp_ts(const size_t k)
 	__attribute__((warn_unused_result, const));
 
+static inline int32_t rohc_interval_compute_p_rtp_ts_timer(const size_t k)
+	__attribute__((warn_unused_result, const));
+
 static inline int32_t rohc_interval_compute_p_rtp_sn(const size_t k)
 	__attribute__((warn_unused_result, const));
 
@@ -167,26 +189,16 @@ int32_t rohc_interval_get_rfc5225_id_id_p(const size_t k)
 static inline int32_t rohc_interval_compute_p(const size_t k,
                                               const rohc_lsb_shift_t p)
 {
-	int32_t computed_p;
+	/* RTP TS, RTP SN and ESP SN are the only codes that need a computation,
+	 * they are consecutive so that one comparison detects them */
+	const uint32_t code = ((uint32_t) p) - ((uint32_t) ROHC_LSB_SHIFT_RTP_TS);
 
-	/* determine the real p value to use */
-	if(p == ROHC_LSB_SHIFT_RTP_TS)
-	{
-		/* special computation for RTP TS encoding */
-		computed_p = (k <= 2 ? 0 : (1 << (k - 2)) - 1);
-	}
-	else if(p == ROHC_LSB_SHIFT_RTP_SN || p == ROHC_LSB_SHIFT_ESP_SN)
-	{
-		/* special computation for RTP and ESP SN encoding */
-		computed_p = (k <= 4 ? 1 : (1 << (k - 5)) - 1);
-	}
-	else
+	if(code >= ROHC_INTERVAL_P_CODES_NR)
 	{
-		/* otherwise: use the p value given as parameter */
-		computed_p = p;
+		/* use the p value given as parameter */
+		return p;
 	}
-
-	return computed_p;
+	return rohc_interval_p_coded[code][k];
 }
 
 
@@ -199,7 +211,23 @@ static inline int32_t rohc_interval_compute_p(const size_t k,
  */
 static inline int32_t rohc_interval_compute_p_rtp_ts(const size_t k)
 {
-	return (k <= 2 ? 0 : (1 << (k - 2)) - 1);
+	return rohc_interval_p_coded[ROHC_INTERVAL_P_CODE(ROHC_LSB_SHIFT_RTP_TS)][k];
+}
+
+
+/**
+ * @brief Compute the shift parameter p for the timer-based encoding of RTP TS
+ *
+ * The interpretation interval is centered on the approximation of TS_SCALED
+ * computed from the arrival time, see section 4.5.4 of RFC 3095.
+ *
+ * @param k  The number of least significant bits of the value that are
+ *           transmitted
+ * @return   The computed shift parameter p
+ */
+static inline int32_t rohc_interval_compute_p_rtp_ts_timer(const size_t k)
+{
+	return rohc_interval_p_rtp_ts_timer[k];
 }
 
 
@@ -212,7 +240,7 @@ static inline int32_t rohc_interval_compute_p_rtp_ts(const size_t k)
  */
 static inline int32_t rohc_interval_compute_p_rtp_sn(const size_t k)
 {
-	return (k <= 4 ? 1 : (1 << (k - 5)) - 1);
+	return rohc_interval_p_coded[ROHC_INTERVAL_P_CODE(ROHC_LSB_SHIFT_RTP_SN)][k];
 }
 
 
@@ -35,6 +35,42 @@
 #include <string.h>
 #include <assert.h>
 
+/* the 16-bit words of the checksummed data are summed 8 or 16 at a time in
+ * vector registers (SSE2 and AVX2 on x86, NEON on ARMv8), but not in kernel
+ * space where the vector registers are not available without saving them
+ * first */
+#if !defined(__KERNEL__) && defined(__GNUC__) && defined(__x86_64__)
+#  define ROHC_IP_CSUM_SSE2 1
+#  include <immintrin.h>
+#elif !defined(__KERNEL__) && defined(__aarch64__) && defined(__ARM_NEON)
+#  define ROHC_IP_CSUM_NEON 1
+#  include <arm_neon.h>
+#endif
+
+/** The minimal length of data worth summing in vector registers */
+#define IP_CSUM_VEC_MIN_LEN  64U
+
+/**
+ * The maximal number of 16-byte blocks summed in the 32-bit lanes of the
+ * vector registers before the lanes may overflow: every lane grows of 2
+ * 16-bit words per block at most
+ */
+#define IP_CSUM_VEC_MAX_BLOCKS  (1U << 15)
+
+
+#if defined(ROHC_IP_CSUM_SSE2)
+static uint64_t ip_csum_partial_sse2(const uint8_t *const data,
+                                     const size_t blocks_nr)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static uint64_t ip_csum_partial_avx2(const uint8_t *const data,
+                                     const size_t blocks_nr)
+	__attribute__((warn_unused_result, nonnull(1), pure, target("avx2")));
+#elif defined(ROHC_IP_CSUM_NEON)
+static uint64_t ip_csum_partial_neon(const uint8_t *const data,
+                                     const size_t blocks_nr)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+#endif
+
 
 /*
  * Generic IP functions (apply to both IPv4 and IPv6):
@@ -280,3 +316,194 @@ void ip_set_daddr(struct ip_packet *const ip, const uint8_t *value)
 	}
 }
 
+
+/*
+ * Internet checksum functions:
+ */
+
+
+/**
+ * @brief Add the given bytes to an Internet checksum
+ *
+ * The 16-bit words are added in network byte order. Only the last bytes
+ * added to the checksum may be of odd length.
+ *
+ * The data long enough are summed 16 or 32 bytes at a time in vector
+ * registers if available (SSE2 or AVX2 on x86, NEON on ARMv8): the sum of
+ * the 16-bit words in host byte order is the byte-swapped sum of the 16-bit
+ * words in network byte order, once folded.
+ *
+ * @param sum   The checksum being computed, not folded
+ * @param data  The bytes to add to the checksum
+ * @param len   The number of bytes
+ * @return      The updated checksum, not folded
+ */
+uint32_t ip_csum_partial(const uint32_t sum,
+                         const uint8_t *const data,
+                         const size_t len)
+{
+	uint64_t acc = sum;
+	size_t i = 0;
+
+#if defined(ROHC_IP_CSUM_SSE2) || defined(ROHC_IP_CSUM_NEON)
+	if(len >= IP_CSUM_VEC_MIN_LEN)
+	{
+		uint64_t vec_sum = 0;
+
+		while((len - i) >= 16)
+		{
+			const size_t blocks_nr =
+				rohc_min((len - i) / 16, IP_CSUM_VEC_MAX_BLOCKS - 1);
+
+#  if defined(ROHC_IP_CSUM_SSE2)
+			if(__builtin_cpu_supports("avx2"))
+			{
+				vec_sum += ip_csum_partial_avx2(data + i, blocks_nr);
+			}
+			else
+			{
+				vec_sum += ip_csum_partial_sse2(data + i, blocks_nr);
+			}
+#  else
+			vec_sum += ip_csum_partial_neon(data + i, blocks_nr);
+#  endif
+			i += blocks_nr * 16;
+		}
+
+		/* fold the sum in host byte order, then swap it in network byte
+		 * order */
+		while((vec_sum >> 16) != 0)
+		{
+			vec_sum = (vec_sum & 0xffff) + (vec_sum >> 16);
+		}
+		acc += rohc_ntoh16((uint16_t) vec_sum);
+	}
+#endif
+
+	for(; (i + 1) < len; i += 2)
+	{
+		acc += (data[i] << 8) | data[i + 1];
+	}
+	if((len % 2) != 0)
+	{
+		acc += data[len - 1] << 8;
+	}
+
+	while((acc >> 31) != 0)
+	{
+		acc = (acc & 0xffff) + (acc >> 16);
+	}
+
+	return (uint32_t) acc;
+}
+
+
+#if defined(ROHC_IP_CSUM_SSE2)
+
+/**
+ * @brief Sum the 16-bit words of some 16-byte blocks with SSE2
+ *
+ * Every 16-byte block is split in 4 lanes of 32 bits, the 2 16-bit words of
+ * every lane are added in the lane.
+ *
+ * @param data       The blocks
+ * @param blocks_nr  The number of blocks, less than
+ *                   \ref IP_CSUM_VEC_MAX_BLOCKS
+ * @return           The sum of the 16-bit words in host byte order
+ */
+static uint64_t ip_csum_partial_sse2(const uint8_t *const data,
+                                     const size_t blocks_nr)
+{
+	const __m128i mask = _mm_set1_epi32(0xffff);
+	__m128i acc = _mm_setzero_si128();
+	uint32_t lanes[4];
+	size_t i;
+
+	assert(blocks_nr < IP_CSUM_VEC_MAX_BLOCKS);
+
+	for(i = 0; i < blocks_nr; i++)
+	{
+		const __m128i block = _mm_loadu_si128((const __m128i *) (data + i * 16));
+		acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_and_si128(block, mask),
+		                                       _mm_srli_epi32(block, 16)));
+	}
+	_mm_storeu_si128((__m128i *) lanes, acc);
+
+	return ((uint64_t) lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+
+/**
+ * @brief Sum the 16-bit words of some 16-byte blocks with AVX2
+ *
+ * The blocks are summed 2 at a time in the 8 lanes of 32 bits of the vector
+ * register, in the same way as \ref ip_csum_partial_sse2.
+ *
+ * @param data       The blocks
+ * @param blocks_nr  The number of blocks, less than
+ *                   \ref IP_CSUM_VEC_MAX_BLOCKS
+ * @return           The sum of the 16-bit words in host byte order
+ */
+static uint64_t ip_csum_partial_avx2(const uint8_t *const data,
+                                     const size_t blocks_nr)
+{
+	const __m256i mask = _mm256_set1_epi32(0xffff);
+	__m256i acc = _mm256_setzero_si256();
+	uint32_t lanes[8];
+	uint64_t sum = 0;
+	size_t i;
+
+	assert(blocks_nr < IP_CSUM_VEC_MAX_BLOCKS);
+
+	for(i = 0; (i + 1) < blocks_nr; i += 2)
+	{
+		const __m256i blocks =
+			_mm256_loadu_si256((const __m256i *) (data + i * 16));
+		acc = _mm256_add_epi32(acc, _mm256_add_epi32(_mm256_and_si256(blocks, mask),
+		                                             _mm256_srli_epi32(blocks, 16)));
+	}
+	_mm256_storeu_si256((__m256i *) lanes, acc);
+	for(i = 0; i < 8; i++)
+	{
+		sum += lanes[i];
+	}
+
+	/* the last block if the number of blocks is odd */
+	if((blocks_nr % 2) != 0)
+	{
+		sum += ip_csum_partial_sse2(data + (blocks_nr - 1) * 16, 1);
+	}
+
+	return sum;
+}
+
+#elif defined(ROHC_IP_CSUM_NEON)
+
+/**
+ * @brief Sum the 16-bit words of some 16-byte blocks with NEON
+ *
+ * The 8 16-bit words of every 16-byte block are added pairwise into 4 lanes
+ * of 32 bits.
+ *
+ * @param data       The blocks
+ * @param blocks_nr  The number of blocks, less than
+ *                   \ref IP_CSUM_VEC_MAX_BLOCKS
+ * @return           The sum of the 16-bit words in host byte order
+ */
+static uint64_t ip_csum_partial_neon(const uint8_t *const data,
+                                     const size_t blocks_nr)
+{
+	uint32x4_t acc = vdupq_n_u32(0);
+	size_t i;
+
+	assert(blocks_nr < IP_CSUM_VEC_MAX_BLOCKS);
+
+	for(i = 0; i < blocks_nr; i++)
+	{
+		acc = vpadalq_u16(acc, vreinterpretq_u16_u8(vld1q_u8(data + i * 16)));
+	}
+
+	return vaddlvq_u32(acc);
+}
+
+#endif /* ROHC_IP_CSUM_SSE2 / ROHC_IP_CSUM_NEON */
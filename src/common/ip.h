@@ -31,8 +31,10 @@
 #include "protocols/ipv6.h"
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 
 /** The selected IP header */
@@ -279,6 +281,44 @@ out:
 #endif /* __KERNEL__ */
 
 
+/**
+ * @brief Update the checksum of one IPv4 header after some fields changed
+ *
+ * Apply the incremental update of RFC 1624, HC' = ~(~HC + ~m + m'), for every
+ * 16-bit word that differs between the old and the new headers instead of
+ * computing the checksum over the whole new header again.
+ *
+ * @param check    The checksum of the old IPv4 header
+ * @param old_hdr  The old IPv4 header, without options
+ * @param new_hdr  The new IPv4 header, without options
+ * @return         The checksum of the new IPv4 header
+ */
+static inline uint16_t ipv4_csum_update(const uint16_t check,
+                                        const uint8_t *const old_hdr,
+                                        const uint8_t *const new_hdr)
+{
+	uint32_t sum = (uint16_t) ~check;
+	size_t i;
+
+	for(i = 0; i < sizeof(struct ipv4_hdr); i += sizeof(uint16_t))
+	{
+		uint16_t old_word;
+		uint16_t new_word;
+
+		memcpy(&old_word, old_hdr + i, sizeof(uint16_t));
+		memcpy(&new_word, new_hdr + i, sizeof(uint16_t));
+		if(i != offsetof(struct ipv4_hdr, check) && old_word != new_word)
+		{
+			sum += ((uint16_t) ~old_word) + new_word;
+		}
+	}
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t) ~sum;
+}
+
+
 /*
  * Function prototypes.
  */
@@ -308,6 +348,13 @@ void ip_set_saddr(struct ip_packet *const ip, const uint8_t *value)
 void ip_set_daddr(struct ip_packet *const ip, const uint8_t *value)
 	__attribute__((nonnull(1, 2)));
 
+/* Internet checksum functions */
+
+uint32_t ip_csum_partial(const uint32_t sum,
+                         const uint8_t *const data,
+                         const size_t len)
+	__attribute__((warn_unused_result, nonnull(2), pure));
+
 /**
  * @brief Get the IP version of an IP packet
  *
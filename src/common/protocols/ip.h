@@ -30,7 +30,7 @@
 #ifdef __KERNEL__
 #  include <endian.h>
 #else
-#  include "config.h" /* for WORDS_BIGENDIAN */
+#  include "config.h" /* for WORDS_BIGENDIAN and ROHC_SINGLE_IP_HDR */
 #endif
 
 
@@ -42,8 +42,18 @@
  *
  * The limit value was chosen arbitrarily. It should handle most real-life case
  * without hurting performances nor memory footprint.
+ *
+ * The library built with --enable-single-ip-hdr handles one single IP header:
+ * the structures are sized for it and the code dedicated to the inner IP
+ * headers is removed at build time. The packets with more IP headers are
+ * then compressed by the IP-only profiles or the Uncompressed profile. The
+ * Linux kernel module always handles several IP headers.
  */
-#define ROHC_MAX_IP_HDRS  2U
+#if !defined(__KERNEL__) && ROHC_SINGLE_IP_HDR == 1
+#  define ROHC_MAX_IP_HDRS  1U
+#else
+#  define ROHC_MAX_IP_HDRS  2U
+#endif
 
 
 /**
@@ -64,9 +74,14 @@
  * profiles.
  *
  * The limit value was chosen arbitrarily. It should handle most real-life case
- * without hurting performances nor memory footprint.
+ * without hurting performances nor memory footprint. The library built with
+ * --enable-single-ip-hdr handles one single IP extension header.
  */
-#define ROHC_MAX_IP_EXT_HDRS    3U
+#if !defined(__KERNEL__) && ROHC_SINGLE_IP_HDR == 1
+#  define ROHC_MAX_IP_EXT_HDRS    1U
+#else
+#  define ROHC_MAX_IP_EXT_HDRS    3U
+#endif
 
 
 /** The common IPv4/v6 header */
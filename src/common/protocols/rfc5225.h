@@ -576,5 +576,26 @@ typedef struct
 } __attribute__((packed)) profile_2_3_4_flags_t;
 
 
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(sizeof(co_repair_crc_t) == 2,
+               "co_repair_crc format should be exactly 2-byte long");
+_Static_assert(sizeof(pt_0_crc3_t) == 1,
+               "pt_0_crc3 format should be exactly 1-byte long");
+_Static_assert(sizeof(pt_0_crc7_t) == 2,
+               "pt_0_crc7 format should be exactly 2-byte long");
+_Static_assert(sizeof(pt_1_seq_id_t) == 2,
+               "pt_1_seq_id format should be exactly 2-byte long");
+_Static_assert(sizeof(pt_2_seq_id_t) == 3,
+               "pt_2_seq_id format should be exactly 3-byte long");
+_Static_assert(sizeof(co_common_base_t) == 3,
+               "co_common_base format should be exactly 3-byte long");
+_Static_assert(sizeof(profile_2_3_4_flags_t) == 1,
+               "profile_2_3_4_flags format should be exactly 1-byte long");
+#endif
+
+
 #endif /* ROHC_PROTOCOLS_RFC5225_H */
 
@@ -1041,6 +1041,46 @@ typedef struct
 } __attribute__((packed)) seq_8_t;
 
 
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(sizeof(co_common_t) == 5,
+               "co_common format should be exactly 5-byte long");
+_Static_assert(sizeof(rnd_1_t) == 4,
+               "rnd_1 format should be exactly 4-byte long");
+_Static_assert(sizeof(rnd_2_t) == 2,
+               "rnd_2 format should be exactly 2-byte long");
+_Static_assert(sizeof(rnd_3_t) == 3,
+               "rnd_3 format should be exactly 3-byte long");
+_Static_assert(sizeof(rnd_4_t) == 2,
+               "rnd_4 format should be exactly 2-byte long");
+_Static_assert(sizeof(rnd_5_t) == 5,
+               "rnd_5 format should be exactly 5-byte long");
+_Static_assert(sizeof(rnd_6_t) == 4,
+               "rnd_6 format should be exactly 4-byte long");
+_Static_assert(sizeof(rnd_7_t) == 6,
+               "rnd_7 format should be exactly 6-byte long");
+_Static_assert(sizeof(rnd_8_t) == 7,
+               "rnd_8 format should be exactly 7-byte long");
+_Static_assert(sizeof(seq_1_t) == 4,
+               "seq_1 format should be exactly 4-byte long");
+_Static_assert(sizeof(seq_2_t) == 3,
+               "seq_2 format should be exactly 3-byte long");
+_Static_assert(sizeof(seq_3_t) == 4,
+               "seq_3 format should be exactly 4-byte long");
+_Static_assert(sizeof(seq_4_t) == 2,
+               "seq_4 format should be exactly 2-byte long");
+_Static_assert(sizeof(seq_5_t) == 6,
+               "seq_5 format should be exactly 6-byte long");
+_Static_assert(sizeof(seq_6_t) == 5,
+               "seq_6 format should be exactly 5-byte long");
+_Static_assert(sizeof(seq_7_t) == 6,
+               "seq_7 format should be exactly 6-byte long");
+_Static_assert(sizeof(seq_8_t) == 7,
+               "seq_8 format should be exactly 7-byte long");
+#endif
+
 
 #endif /* ROHC_PROTOCOLS_RFC6846_H */
 
@@ -105,6 +105,8 @@ struct rohc_pkt_hdrs
 	uint8_t ip_hdrs_nr;                               /**< The number of IP headers */
 	struct rohc_pkt_ip_hdr ip_hdrs[ROHC_MAX_IP_HDRS]; /**< The IP headers */
 	const struct rohc_pkt_ip_hdr *innermost_ip_hdr;   /**< The innermost IP header */
+	uint16_t ipv4_frag;  /**< The MF flag and the fragment offset of the
+	                          innermost IPv4 header, 0 if not a fragment */
 
 	/* The transport header */
 	union
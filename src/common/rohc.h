@@ -33,6 +33,7 @@ extern "C"
 #endif
 
 #include <rohc/rohc_profiles.h>
+#include <rohc/rohc_traces.h>
 
 #include <stdlib.h>
 #include <stddef.h>
@@ -93,6 +94,10 @@ typedef enum
 	ROHC_STATUS_OUTPUT_TOO_SMALL  = 5,
 	/** The action encountered an undefined problem */
 	ROHC_STATUS_ERROR             = 6,
+	/** The action failed because the memory budget was exhausted */
+	ROHC_STATUS_NO_MEMORY         = 7,
+	/** The action failed because no packet fits in the requested length */
+	ROHC_STATUS_TOO_LARGE         = 8,
 
 } rohc_status_t;
 
@@ -196,6 +201,48 @@ typedef enum
 typedef uint16_t rohc_cid_t;
 
 
+/**
+ * @brief The prototype of the callback that allocates memory for contexts
+ *
+ * User-defined function that is called when the ROHC library requires memory
+ * for one of its compression or decompression contexts. The memory returned
+ * shall be aligned for any type of object, like the memory returned by
+ * malloc().
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_comp_set_mem_cbs or \ref rohc_decomp_set_mem_cbs
+ *
+ * @param size       The number of bytes to allocate
+ * @param priv_ctxt  The context given by the user when he/she set the callback,
+ *                   may be NULL.
+ * @return           The allocated memory, NULL on failure
+ *
+ * @see rohc_mem_free_cb_t
+ * @ingroup rohc
+ */
+typedef void * (*rohc_mem_alloc_cb_t) (const size_t size, void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The prototype of the callback that frees memory of contexts
+ *
+ * User-defined function that is called when the ROHC library releases memory
+ * that was allocated by the \ref rohc_mem_alloc_cb_t callback.
+ *
+ * @param ptr        The memory to free
+ * @param size       The number of bytes that were allocated
+ * @param priv_ctxt  The context given by the user when he/she set the callback,
+ *                   may be NULL.
+ *
+ * @see rohc_mem_alloc_cb_t
+ * @ingroup rohc
+ */
+typedef void (*rohc_mem_free_cb_t) (void *const ptr,
+                                    const size_t size,
+                                    void *const priv_ctxt);
+
+
 /**
  * @brief The different values of reordering offset
  *
@@ -210,6 +257,157 @@ typedef enum
 } rohc_reordering_offset_t;
 
 
+/** A ring of feedbacks between one decompressor and one compressor */
+struct rohc_feedback_ring;
+
+/** A ring of binary trace records */
+struct rohc_trace_ring;
+
+/** A set of ROHC channels that share the memory of their contexts */
+struct rohc_channel_set;
+
+
+/**
+ * @brief The prototype of the callback that prints the expanded traces
+ *
+ * User-defined function that is called by \ref rohc_trace_ring_expand for
+ * every trace record expanded into its text message.
+ *
+ * @param priv_ctxt  The private context given to \ref rohc_trace_ring_expand
+ * @param time_ns    The time of the trace, in nanoseconds since an arbitrary
+ *                   origin
+ * @param level      The level of the trace
+ * @param entity     The entity concerned by the trace
+ * @param profile    The number of the profile concerned by the trace
+ * @param msg        The text message of the trace
+ *
+ * @ingroup rohc
+ */
+typedef void (*rohc_trace_ring_print_cb_t) (void *const priv_ctxt,
+                                            const uint64_t time_ns,
+                                            const rohc_trace_level_t level,
+                                            const rohc_trace_entity_t entity,
+                                            const int profile,
+                                            const char *const msg);
+
+
+/** The number of buckets of one histogram of durations */
+#define ROHC_PERF_HISTO_BUCKETS_NR  128U
+
+
+/**
+ * @brief One histogram of durations
+ *
+ * The buckets are log-linear, as in HDR histograms: durations below 4 ns
+ * get one bucket per nanosecond, then every power of 2 is split into 4
+ * buckets of equal width. The relative error of one bucket is therefore at
+ * most 25%. The durations longer than the range of the last bucket, about
+ * 8.6 seconds, are counted in the last bucket. Use
+ * \ref rohc_perf_histo_bucket_min to get the lower bound of one bucket.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_perf_histo_bucket_min
+ */
+struct rohc_perf_histo
+{
+	/** The number of durations in the histogram */
+	uint64_t count;
+	/** The sum of all the durations (in nanoseconds) */
+	uint64_t sum_ns;
+	/** The shortest duration (in nanoseconds) */
+	uint64_t min_ns;
+	/** The longest duration (in nanoseconds) */
+	uint64_t max_ns;
+	/** The number of durations per bucket */
+	uint64_t buckets[ROHC_PERF_HISTO_BUCKETS_NR];
+};
+
+
+/**
+ * @brief The prototype of the callback that computes the CRCs of ROHC
+ *
+ * User-defined function that computes the 3-bit, 7-bit or 8-bit CRC defined
+ * by RFC 3095 §5.9 in place of the tables of the library. The result shall
+ * be bit-exact with the tables of the library: the CRC of some data is
+ * computed with several calls on consecutive pieces of the data, the CRC
+ * returned by one call being the initial value of the next one.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_comp_set_crc_engine or \ref rohc_decomp_set_crc_engine
+ *
+ * @param crc_bits   The size of the CRC: 3, 7 or 8 bits
+ * @param data       The data to compute the CRC over
+ * @param len        The length of the data
+ * @param init_val   The initial value of the CRC
+ * @param priv_ctxt  The context given by the user in the CRC engine,
+ *                   may be NULL.
+ * @return           The CRC of the data
+ *
+ * @see rohc_crc_engine
+ * @ingroup rohc
+ */
+typedef uint8_t (*rohc_crc_calc_cb_t) (const size_t crc_bits,
+                                       const uint8_t *const data,
+                                       const size_t len,
+                                       const uint8_t init_val,
+                                       void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The prototype of the callback that computes the FCS-32 of ROHC
+ *
+ * User-defined function that computes the FCS-32 of the segmented packets
+ * defined by RFC 3095 §5.2.5 in place of the tables of the library. The
+ * initial value and the result are not complemented, as the ones of the
+ * tables of the library.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_comp_set_crc_engine or \ref rohc_decomp_set_crc_engine
+ *
+ * @param data       The data to compute the CRC over
+ * @param len        The length of the data
+ * @param init_val   The initial value of the CRC
+ * @param priv_ctxt  The context given by the user in the CRC engine,
+ *                   may be NULL.
+ * @return           The CRC of the data
+ *
+ * @see rohc_crc_engine
+ * @ingroup rohc
+ */
+typedef uint32_t (*rohc_crc_fcs32_cb_t) (const uint8_t *const data,
+                                         const size_t len,
+                                         const uint32_t init_val,
+                                         void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The CRC engine of one compressor or decompressor
+ *
+ * The engine computes all the CRCs of the ROHC packets: the CRCs of the
+ * headers, the CRCs of the IR and feedback packets, and the FCS-32 of the
+ * segmented packets. The platforms with CRC instructions or with a CRC
+ * offload may give their own callbacks. The callbacks left NULL keep the
+ * tables of the library, the default engine.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_set_crc_engine
+ * @see rohc_decomp_set_crc_engine
+ */
+struct rohc_crc_engine
+{
+	/** The callback for the CRC-3, CRC-7 and CRC-8, NULL for the tables */
+	rohc_crc_calc_cb_t crc_calc;
+	/** The callback for the FCS-32, NULL for the tables */
+	rohc_crc_fcs32_cb_t fcs32_calc;
+	/** The context given to the callbacks, may be NULL */
+	void *priv_ctxt;
+};
+
+
 /*
  * Prototypes of public functions
  */
@@ -223,6 +421,37 @@ const char * ROHC_EXPORT rohc_strerror(const rohc_status_t status)
 const char * ROHC_EXPORT rohc_get_mode_descr(const rohc_mode_t mode)
 	__attribute__((warn_unused_result, const));
 
+struct rohc_feedback_ring * ROHC_EXPORT rohc_feedback_ring_new(const size_t slots_nr)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_feedback_ring_free(struct rohc_feedback_ring *const ring);
+
+struct rohc_channel_set * ROHC_EXPORT rohc_channel_set_new(void)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_channel_set_free(struct rohc_channel_set *const set);
+
+struct rohc_trace_ring * ROHC_EXPORT rohc_trace_ring_new(const size_t records_nr)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_trace_ring_free(struct rohc_trace_ring *const ring);
+
+void ROHC_EXPORT rohc_trace_ring_cb(void *const priv_ctxt,
+                                    const rohc_trace_level_t level,
+                                    const rohc_trace_entity_t entity,
+                                    const int profile,
+                                    const char *const format,
+                                    ...)
+	__attribute__((format(printf, 5, 6), nonnull(1, 5)));
+
+size_t ROHC_EXPORT rohc_trace_ring_expand(const struct rohc_trace_ring *const ring,
+                                          rohc_trace_ring_print_cb_t print_cb,
+                                          void *const priv_ctxt)
+	__attribute__((nonnull(1, 2)));
+
+uint64_t ROHC_EXPORT rohc_perf_histo_bucket_min(const size_t bucket)
+	__attribute__((warn_unused_result, const));
+
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
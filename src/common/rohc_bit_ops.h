@@ -118,6 +118,11 @@
 		const typeof(bits) _bits = (bits); \
 		const size_t _bits_nr = (bits_nr); \
 		const size_t _max = (max); \
+		/* no bit found yet: the field may hold the value of a previous packet */ \
+		if((field_nr) == 0) \
+		{ \
+			field = 0; \
+		} \
 		/* print a description of what we do */ \
 		rohc_decomp_debug(context, \
 		                  "%zd bits of " #field_descr " found in %s = 0x%x", \
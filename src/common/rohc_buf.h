@@ -109,6 +109,36 @@ struct rohc_buf
 };
 
 
+/**
+ * @brief A chain of network buffers for the ROHC library
+ *
+ * May represent one packet stored in several non-contiguous segments, eg. a
+ * header buffer followed by payload pages as delivered by network drivers.
+ * The segments are listed in the order of the packet bytes. Only the first
+ * segment is read by the ROHC library: it shall hold all the headers of the
+ * packet, the other segments hold payload only and are carried through by
+ * reference.
+ *
+ * \code
+   struct rohc_buf segs[3];
+   struct rohc_buf_chain packet;
+   ...
+   packet.segs = segs;
+   packet.segs_nr = 3;
+   packet.segs_max = 3;
+   ...
+\endcode
+ *
+ * @ingroup rohc
+ */
+struct rohc_buf_chain
+{
+	struct rohc_buf *segs;  /**< The segments of the chain */
+	size_t segs_nr;         /**< The number of segments in the chain */
+	size_t segs_max;        /**< The maximum number of segments in \e segs */
+};
+
+
 /**
  * @brief Initialize the given network buffer with no data
  *
@@ -231,6 +261,9 @@ static inline void rohc_buf_append_buf(struct rohc_buf *const dst,
 static inline void rohc_buf_reset(struct rohc_buf *const buf)
 	__attribute__((nonnull(1)));
 
+static inline size_t rohc_buf_chain_len(const struct rohc_buf_chain chain)
+	__attribute__((warn_unused_result, pure));
+
 
 /**
  * @brief Is the given network buffer malformed?
@@ -434,6 +467,28 @@ static inline void rohc_buf_reset(struct rohc_buf *const buf)
 }
 
 
+/**
+ * @brief Get the length of the packet stored in the given chain of buffers
+ *
+ * @param chain  The chain of network buffers
+ * @return       The length (in bytes) of all the segments of the chain
+ *
+ * @ingroup rohc
+ */
+static inline size_t rohc_buf_chain_len(const struct rohc_buf_chain chain)
+{
+	size_t len = 0;
+	size_t i;
+
+	for(i = 0; i < chain.segs_nr; i++)
+	{
+		len += chain.segs[i].len;
+	}
+
+	return len;
+}
+
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
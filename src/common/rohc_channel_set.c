@@ -0,0 +1,183 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_channel_set.c
+ * @brief  Sets of ROHC channels that share the memory of their contexts
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_channel_set.h"
+#include "rohc.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+
+static void rohc_channel_set_destroy(struct rohc_channel_set *const set)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Create a new set of ROHC channels
+ *
+ * Create a set that the compressors and decompressors of many ROHC channels,
+ * eg. the channels of all the terminals handled by one worker thread of a
+ * concentrator, may join with \ref rohc_comp_set_channel_set and
+ * \ref rohc_decomp_set_channel_set. The channels of the set then allocate
+ * their contexts, their RRU buffers and their scratch buffers from the slabs
+ * of one memory pool, so that a channel with only a few active flows does not
+ * keep slabs of its own. The memory of the set scales with the number of
+ * contexts in use on all its channels instead of the number of channels.
+ *
+ * The set is not thread-safe: all its channels shall be used by the same
+ * thread, or the user shall serialize the calls on them. Create one set per
+ * worker thread to avoid locks.
+ *
+ * @return  The created set if successful, NULL if creation failed
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_channel_set_free
+ * @see rohc_comp_set_channel_set
+ * @see rohc_decomp_set_channel_set
+ */
+struct rohc_channel_set * rohc_channel_set_new(void)
+{
+	struct rohc_channel_set *set;
+
+	set = calloc(1, sizeof(struct rohc_channel_set));
+	if(set == NULL)
+	{
+		goto error;
+	}
+	rohc_mempool_init(&set->mempool);
+	set->channels_nr = 0;
+	set->is_freed = false;
+
+	return set;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given set of ROHC channels
+ *
+ * The memory of the set is released once all the channels of the set are
+ * destroyed or left the set, so that the set may be freed before or after its
+ * channels.
+ *
+ * @param set  The set to destroy
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_channel_set_new
+ */
+void rohc_channel_set_free(struct rohc_channel_set *const set)
+{
+	if(set != NULL)
+	{
+		assert(!set->is_freed);
+		set->is_freed = true;
+		if(set->channels_nr == 0)
+		{
+			rohc_channel_set_destroy(set);
+		}
+	}
+}
+
+
+/**
+ * @brief Account one more channel in the given set
+ *
+ * @param set  The set the channel joins
+ */
+void rohc_channel_set_join(struct rohc_channel_set *const set)
+{
+	assert(!set->is_freed);
+	set->channels_nr++;
+}
+
+
+/**
+ * @brief Account one less channel in the given set
+ *
+ * The set is destroyed if it was freed by the user and the channel was the
+ * last one of the set.
+ *
+ * @param set  The set the channel leaves
+ */
+void rohc_channel_set_leave(struct rohc_channel_set *const set)
+{
+	assert(set->channels_nr > 0);
+	set->channels_nr--;
+	if(set->channels_nr == 0 && set->is_freed)
+	{
+		rohc_channel_set_destroy(set);
+	}
+}
+
+
+/**
+ * @brief Allocate memory for one channel of the given set
+ *
+ * The function is a \ref rohc_mem_alloc_cb_t callback.
+ *
+ * @param size  The number of bytes to allocate
+ * @param set   The set of the channel
+ * @return      The allocated memory, NULL if allocation failed
+ */
+void * rohc_channel_set_alloc(const size_t size, void *const set)
+{
+	struct rohc_channel_set *const channel_set = set;
+	return rohc_mempool_alloc(&channel_set->mempool, size);
+}
+
+
+/**
+ * @brief Release memory of one channel of the given set
+ *
+ * The function is a \ref rohc_mem_free_cb_t callback.
+ *
+ * @param ptr   The memory to release
+ * @param size  The number of bytes that were allocated
+ * @param set   The set of the channel
+ */
+void rohc_channel_set_release(void *const ptr,
+                              const size_t size,
+                              void *const set)
+{
+	struct rohc_channel_set *const channel_set = set;
+	rohc_mempool_release(&channel_set->mempool, ptr, size);
+}
+
+
+/**
+ * @brief Release the memory of the given set of ROHC channels
+ *
+ * @param set  The set to destroy, without any channel left
+ */
+static void rohc_channel_set_destroy(struct rohc_channel_set *const set)
+{
+	assert(set->channels_nr == 0);
+	assert(set->mempool.objs_nr == 0);
+	rohc_mempool_free(&set->mempool);
+	free(set);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_channel_set.h
+ * @brief  Sets of ROHC channels that share the memory of their contexts
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_CHANNEL_SET_H
+#define ROHC_CHANNEL_SET_H
+
+#include "rohc_mempool.h"
+
+#include <stddef.h>
+#include <stdbool.h>
+
+
+/**
+ * @brief One set of ROHC channels
+ *
+ * The compressors and decompressors of the set, called channels, carve the
+ * memory of their contexts, of their RRU buffers and of their scratch buffers
+ * from the slabs of one memory pool instead of one memory pool per channel.
+ * The memory that the set keeps thus grows with the number of contexts in use
+ * on all the channels, not with the number of channels.
+ *
+ * The set is destroyed once it was freed by the user and all its channels
+ * were destroyed or left the set.
+ */
+struct rohc_channel_set
+{
+	/** The memory pool shared by all the channels of the set */
+	struct rohc_mempool mempool;
+	/** The number of channels in the set */
+	size_t channels_nr;
+	/** Whether the user freed the set, the set being destroyed once the last
+	 *  channel leaves it */
+	bool is_freed;
+};
+
+
+void rohc_channel_set_join(struct rohc_channel_set *const set)
+	__attribute__((nonnull(1)));
+
+void rohc_channel_set_leave(struct rohc_channel_set *const set)
+	__attribute__((nonnull(1)));
+
+void * rohc_channel_set_alloc(const size_t size, void *const set)
+	__attribute__((warn_unused_result, nonnull(2)));
+
+void rohc_channel_set_release(void *const ptr,
+                              const size_t size,
+                              void *const set)
+	__attribute__((nonnull(3)));
+
+#endif
@@ -90,6 +90,10 @@ const char * rohc_strerror(const rohc_status_t status)
 			return "output buffer too small";
 		case ROHC_STATUS_ERROR:
 			return "undefined problem";
+		case ROHC_STATUS_NO_MEMORY:
+			return "memory budget exhausted";
+		case ROHC_STATUS_TOO_LARGE:
+			return "no packet fits in the requested length";
 		default:
 			return "no description";
 	}
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_ctxt_image.h
+ * @brief  The binary images of the compression/decompression contexts
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * One image starts with one header, then holds one record per context. Every
+ * record is made of one record header, the generic part of the context, then
+ * the profile-specific part of the context. The fields are stored in the
+ * byte order and the layout of the host: one image may only be restored by
+ * the same build of the library. No field is aligned, so the images may be
+ * read from any address, a file mapped in memory for example.
+ */
+
+#ifndef ROHC_CTXT_IMAGE_H
+#define ROHC_CTXT_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The magic number at the beginning of every image: "RHCI" */
+#define ROHC_CTXT_IMAGE_MAGIC  0x52484349U
+
+/** The major version of the format of the images */
+#define ROHC_CTXT_IMAGE_VERSION_MAJOR  0U
+/** The minor version of the format of the images */
+#define ROHC_CTXT_IMAGE_VERSION_MINOR  1U
+
+/** The image holds compression contexts */
+#define ROHC_CTXT_IMAGE_COMP    0U
+/** The image holds decompression contexts */
+#define ROHC_CTXT_IMAGE_DECOMP  1U
+
+
+/** The header of one image of contexts */
+struct rohc_ctxt_image_hdr
+{
+	uint32_t magic;          /**< \ref ROHC_CTXT_IMAGE_MAGIC */
+	uint8_t version_major;   /**< \ref ROHC_CTXT_IMAGE_VERSION_MAJOR */
+	uint8_t version_minor;   /**< \ref ROHC_CTXT_IMAGE_VERSION_MINOR */
+	uint8_t entity;          /**< \ref ROHC_CTXT_IMAGE_COMP or DECOMP */
+	uint8_t unused;
+	uint32_t ctxts_nr;       /**< The number of records in the image */
+	uint32_t len;            /**< The length of the image, header included */
+} __attribute__((packed));
+
+
+/** The header of the record of one context */
+struct rohc_ctxt_image_rec
+{
+	uint16_t profile_id;     /**< The profile of the context */
+	uint16_t cid;            /**< The CID of the context */
+	uint32_t generic_len;    /**< The length of the generic part */
+	uint32_t profile_len;    /**< The length of the profile-specific part */
+} __attribute__((packed));
+
+
+static inline bool rohc_ctxt_image_check(const uint8_t *const image,
+                                         const size_t image_len,
+                                         const uint8_t entity,
+                                         size_t *const ctxts_nr)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+static inline bool rohc_ctxt_image_get_rec(const uint8_t *const image,
+                                           const size_t image_len,
+                                           size_t *const offset,
+                                           struct rohc_ctxt_image_rec *const rec)
+	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
+
+static inline void rohc_ctxt_image_set_hdr(uint8_t *const image,
+                                           const uint8_t entity,
+                                           const size_t ctxts_nr,
+                                           const size_t image_len)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check the header of one image of contexts
+ *
+ * @param image           The image to check
+ * @param image_len       The length of the image
+ * @param entity          The expected entity of the image
+ * @param[out] ctxts_nr   The number of records in the image
+ * @return                true if the header is valid, false otherwise
+ */
+static inline bool rohc_ctxt_image_check(const uint8_t *const image,
+                                         const size_t image_len,
+                                         const uint8_t entity,
+                                         size_t *const ctxts_nr)
+{
+	struct rohc_ctxt_image_hdr hdr;
+
+	if(image_len < sizeof(struct rohc_ctxt_image_hdr))
+	{
+		goto error;
+	}
+	memcpy(&hdr, image, sizeof(struct rohc_ctxt_image_hdr));
+	if(hdr.magic != ROHC_CTXT_IMAGE_MAGIC ||
+	   hdr.version_major != ROHC_CTXT_IMAGE_VERSION_MAJOR ||
+	   hdr.entity != entity ||
+	   hdr.len != image_len)
+	{
+		goto error;
+	}
+	*ctxts_nr = hdr.ctxts_nr;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the header of the next record of one image of contexts
+ *
+ * The record is checked to fit in the image. The offset is moved to the
+ * generic part of the context.
+ *
+ * @param image           The image, checked with \ref rohc_ctxt_image_check
+ * @param image_len       The length of the image
+ * @param[in,out] offset  The offset of the record in the image
+ * @param[out] rec        The header of the record
+ * @return                true if the record is valid, false otherwise
+ */
+static inline bool rohc_ctxt_image_get_rec(const uint8_t *const image,
+                                           const size_t image_len,
+                                           size_t *const offset,
+                                           struct rohc_ctxt_image_rec *const rec)
+{
+	if((*offset) > image_len ||
+	   (image_len - (*offset)) < sizeof(struct rohc_ctxt_image_rec))
+	{
+		goto error;
+	}
+	memcpy(rec, image + (*offset), sizeof(struct rohc_ctxt_image_rec));
+	(*offset) += sizeof(struct rohc_ctxt_image_rec);
+
+	if(rec->generic_len > (image_len - (*offset)) ||
+	   rec->profile_len > (image_len - (*offset) - rec->generic_len))
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Write the header of one image of contexts
+ *
+ * The header is written once the records are known.
+ *
+ * @param[out] image  The image to write the header in
+ * @param entity      The entity of the image
+ * @param ctxts_nr    The number of records in the image
+ * @param image_len   The length of the image, header included
+ */
+static inline void rohc_ctxt_image_set_hdr(uint8_t *const image,
+                                           const uint8_t entity,
+                                           const size_t ctxts_nr,
+                                           const size_t image_len)
+{
+	const struct rohc_ctxt_image_hdr hdr = {
+		.magic = ROHC_CTXT_IMAGE_MAGIC,
+		.version_major = ROHC_CTXT_IMAGE_VERSION_MAJOR,
+		.version_minor = ROHC_CTXT_IMAGE_VERSION_MINOR,
+		.entity = entity,
+		.unused = 0,
+		.ctxts_nr = ctxts_nr,
+		.len = image_len,
+	};
+	memcpy(image, &hdr, sizeof(struct rohc_ctxt_image_hdr));
+}
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_div.h
+ * @brief  Division of 32-bit values by a constant without division instruction
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The division by a divisor that changes rarely is replaced by one
+ * multiplication, one or two shifts and maybe one addition with a magic
+ * number computed once for the divisor, see "Division by Invariant Integers
+ * using Multiplication" (Granlund and Montgomery, 1994).
+ */
+
+#ifndef ROHC_DIV_H
+#define ROHC_DIV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+
+/**
+ * @brief The precomputed inverse of a 32-bit divisor
+ */
+struct rohc_div32
+{
+	uint32_t divisor;  /**< The divisor */
+	uint32_t magic;    /**< The magic number, 0 for powers of 2 */
+	uint8_t shift;     /**< The final shift */
+	bool do_add;       /**< Whether the magic number overflows 32 bits */
+};
+
+
+/**
+ * @brief Compute the inverse of the given 32-bit divisor
+ *
+ * @param div      The inverse to compute
+ * @param divisor  The divisor, shall not be zero
+ */
+static inline void rohc_div32_init(struct rohc_div32 *const div,
+                                   const uint32_t divisor)
+{
+	const uint8_t floor_log2 = 31 - __builtin_clz(divisor);
+
+	assert(divisor != 0);
+	div->divisor = divisor;
+
+	if((divisor & (divisor - 1)) == 0)
+	{
+		div->magic = 0;
+		div->shift = floor_log2;
+		div->do_add = false;
+	}
+	else
+	{
+		/* compute 2^(32 + floor_log2) / divisor bit per bit, the 32-bit
+		 * targets may not divide 64-bit values */
+		uint64_t rem = ((uint64_t) 1) << floor_log2;
+		uint32_t quot = 0;
+		int i;
+
+		for(i = 0; i < 32; i++)
+		{
+			rem <<= 1;
+			quot <<= 1;
+			if(rem >= divisor)
+			{
+				rem -= divisor;
+				quot |= 1;
+			}
+		}
+
+		if((divisor - rem) < (((uint32_t) 1) << floor_log2))
+		{
+			div->do_add = false;
+		}
+		else
+		{
+			const uint64_t twice_rem = rem + rem;
+
+			quot += quot;
+			if(twice_rem >= divisor)
+			{
+				quot++;
+			}
+			div->do_add = true;
+		}
+		div->magic = quot + 1;
+		div->shift = floor_log2;
+	}
+}
+
+
+/**
+ * @brief Divide the given 32-bit value with the precomputed inverse
+ *
+ * @param value  The value to divide
+ * @param div    The inverse of the divisor
+ * @return       The quotient, same as value / divisor
+ */
+static inline uint32_t rohc_div32_quot(const uint32_t value,
+                                       const struct rohc_div32 *const div)
+{
+	uint32_t quot;
+
+	if(div->magic == 0)
+	{
+		quot = value >> div->shift;
+	}
+	else
+	{
+		quot = (((uint64_t) div->magic) * value) >> 32;
+		if(div->do_add)
+		{
+			quot = (((value - quot) >> 1) + quot) >> div->shift;
+		}
+		else
+		{
+			quot >>= div->shift;
+		}
+	}
+
+	return quot;
+}
+
+
+/**
+ * @brief Get the remainder of the division of the given 32-bit value
+ *
+ * @param value  The value to divide
+ * @param div    The inverse of the divisor
+ * @return       The remainder, same as value % divisor
+ */
+static inline uint32_t rohc_div32_rem(const uint32_t value,
+                                      const struct rohc_div32 *const div)
+{
+	return value - rohc_div32_quot(value, div) * div->divisor;
+}
+
+#endif
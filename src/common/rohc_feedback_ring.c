@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_feedback_ring.c
+ * @brief  Lock-free ring of feedbacks between one decompressor and one compressor
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_feedback_ring.h"
+#include "rohc.h"
+
+#include <stdlib.h>
+
+
+/**
+ * @brief Create a new ring of feedbacks
+ *
+ * Create a ring that carries feedbacks from one decompressor to one
+ * compressor of the same ROHC endpoint, so that they may run in two different
+ * threads without locking:
+ *  \li the feedbacks that the decompressor receives from the remote
+ *      compressor are delivered to the local compressor,
+ *  \li the feedbacks that the decompressor builds for the remote compressor
+ *      are piggybacked by the local compressor.
+ *
+ * Link the ring with the decompressor with \ref rohc_decomp_set_feedback_ring
+ * and with the compressor with \ref rohc_comp_set_feedback_ring. Only one
+ * decompressor and one compressor may be linked with one ring.
+ *
+ * @param slots_nr  The number of feedbacks the ring may hold, a power of 2 in
+ *                  range [1, 65536]
+ * @return          The created ring if successful, NULL if creation failed
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_feedback_ring_free
+ * @see rohc_decomp_set_feedback_ring
+ * @see rohc_comp_set_feedback_ring
+ */
+struct rohc_feedback_ring * rohc_feedback_ring_new(const size_t slots_nr)
+{
+	struct rohc_feedback_ring *ring;
+
+	/* the number of slots shall be a non-zero power of 2 */
+	if(slots_nr == 0 || slots_nr > ROHC_FEEDBACK_RING_SLOTS_MAX ||
+	   (slots_nr & (slots_nr - 1)) != 0)
+	{
+		goto error;
+	}
+
+	ring = calloc(1, sizeof(struct rohc_feedback_ring));
+	if(ring == NULL)
+	{
+		goto error;
+	}
+	ring->slots = calloc(slots_nr, sizeof(struct rohc_feedback_ring_slot));
+	if(ring->slots == NULL)
+	{
+		goto free_ring;
+	}
+	ring->mask = slots_nr - 1;
+	ring->head = 0;
+	ring->tail = 0;
+
+	return ring;
+
+free_ring:
+	free(ring);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given ring of feedbacks
+ *
+ * The decompressor and the compressor linked with the ring shall be
+ * destroyed or unlinked from the ring first.
+ *
+ * @param ring  The ring to destroy
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_feedback_ring_new
+ */
+void rohc_feedback_ring_free(struct rohc_feedback_ring *const ring)
+{
+	if(ring != NULL)
+	{
+		free(ring->slots);
+		free(ring);
+	}
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_feedback_ring.h
+ * @brief  Lock-free ring of feedbacks between one decompressor and one compressor
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_FEEDBACK_RING_H
+#define ROHC_FEEDBACK_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** The maximum number of slots of one feedback ring */
+#define ROHC_FEEDBACK_RING_SLOTS_MAX  65536U
+
+/** The maximum length of one feedback item: 2-byte header and 255-byte data */
+#define ROHC_FEEDBACK_RING_ITEM_MAX_LEN  (2U + 255U)
+
+
+/**
+ * @brief One slot of a feedback ring
+ */
+struct rohc_feedback_ring_slot
+{
+	/** Whether the feedback was received from the remote compressor, and
+	 *  shall be delivered to the local compressor, or was built by the local
+	 *  decompressor, and shall be sent to the remote compressor */
+	bool is_rcvd;
+	/** The length of the feedback item (header and data included) */
+	uint16_t len;
+	/** The feedback item (header and data included) */
+	uint8_t data[ROHC_FEEDBACK_RING_ITEM_MAX_LEN];
+};
+
+
+/**
+ * @brief One lock-free ring of feedbacks
+ *
+ * The ring links one decompressor, the only producer, with one compressor,
+ * the only consumer, so that they may run in two different threads without
+ * locking. The producer only writes the head index, the consumer only writes
+ * the tail index; both indexes only grow and the slot of one index is given
+ * by the index modulo the number of slots. The indexes are kept apart so
+ * that the two threads do not share one cache line for them.
+ */
+struct rohc_feedback_ring
+{
+	/** The slots of the ring */
+	struct rohc_feedback_ring_slot *slots;
+	/** The mask to apply on indexes to get slots, number of slots minus 1 */
+	size_t mask;
+
+	/** The index of the next slot to fill, written by the producer only */
+	size_t head;
+	uint8_t unused[64 - sizeof(size_t)]; /**< keep indexes on two cache lines */
+	/** The index of the next slot to drain, written by the consumer only */
+	size_t tail;
+};
+
+
+/**
+ * @brief Get the next free slot of the ring, producer side
+ *
+ * @param ring  The feedback ring
+ * @return      The free slot to fill, NULL if the ring is full
+ */
+static inline struct rohc_feedback_ring_slot *
+	rohc_feedback_ring_reserve(struct rohc_feedback_ring *const ring)
+{
+	const size_t head = ring->head;
+	const size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+	if((head - tail) > ring->mask)
+	{
+		return NULL;
+	}
+	return &(ring->slots[head & ring->mask]);
+}
+
+
+/**
+ * @brief Publish the slot got with \ref rohc_feedback_ring_reserve
+ *
+ * @param ring  The feedback ring
+ */
+static inline void rohc_feedback_ring_commit(struct rohc_feedback_ring *const ring)
+{
+	__atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Get one of the filled slots of the ring, consumer side
+ *
+ * @param ring  The feedback ring
+ * @param nr    The rank of the slot, 0 for the oldest one
+ * @return      The filled slot, NULL if there is not as many filled slots
+ */
+static inline const struct rohc_feedback_ring_slot *
+	rohc_feedback_ring_peek(const struct rohc_feedback_ring *const ring,
+	                        const size_t nr)
+{
+	const size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	const size_t tail = ring->tail;
+
+	if((head - tail) <= nr)
+	{
+		return NULL;
+	}
+	return &(ring->slots[(tail + nr) & ring->mask]);
+}
+
+
+/**
+ * @brief Give back the oldest filled slots of the ring to the producer
+ *
+ * @param ring  The feedback ring
+ * @param nr    The number of slots to give back
+ */
+static inline void rohc_feedback_ring_release(struct rohc_feedback_ring *const ring,
+                                              const size_t nr)
+{
+	__atomic_store_n(&ring->tail, ring->tail + nr, __ATOMIC_RELEASE);
+}
+
+#endif
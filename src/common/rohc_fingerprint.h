@@ -30,6 +30,7 @@
 #include "rohc_profiles.h"
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __KERNEL__
 #  include <endian.h>
@@ -65,11 +66,13 @@ struct rohc_fingerprint_base
 
 /**
  * @brief The unique fingerprint of one compression context or uncompressed packet
+ *
+ * The fingerprint is a variable-length key: the IP headers come last and only
+ * the IP headers actually present in the packet are part of the key, see
+ * \ref rohc_fingerprint_len. All the other bytes shall be zeroed.
  */
 struct rohc_fingerprint
 {
-	struct rohc_fingerprint_base base;
-
 	union
 	{
 		struct
@@ -82,7 +85,42 @@ struct rohc_fingerprint
 
 	uint32_t rtp_ssrc;
 
+	struct rohc_fingerprint_base base;
+
 } __attribute__((packed));
 
+
+static inline size_t rohc_fingerprint_base_len(const struct rohc_fingerprint_base *const base)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static inline size_t rohc_fingerprint_len(const struct rohc_fingerprint *const fingerprint)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+
+/**
+ * @brief Get the length of the significant part of the base fingerprint
+ *
+ * @param base  The base fingerprint
+ * @return      The length of the base fingerprint up to its last IP header
+ */
+static inline size_t rohc_fingerprint_base_len(const struct rohc_fingerprint_base *const base)
+{
+	return offsetof(struct rohc_fingerprint_base, ip_hdrs) +
+	       base->ip_hdrs_nr * sizeof(struct rohc_fingerprint_ip);
+}
+
+
+/**
+ * @brief Get the length of the significant part of the fingerprint
+ *
+ * @param fingerprint  The fingerprint
+ * @return             The length of the fingerprint up to its last IP header
+ */
+static inline size_t rohc_fingerprint_len(const struct rohc_fingerprint *const fingerprint)
+{
+	return offsetof(struct rohc_fingerprint, base) +
+	       rohc_fingerprint_base_len(&fingerprint->base);
+}
+
 #endif
 
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_hdr_image.h
+ * @brief  Detect the changes of a header against a stored image of it
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * A context stores the raw bytes of the last header it compressed. The new
+ * header is compared with that image under a byte mask that selects the
+ * fields the context tracks, 8 bytes at a time and without any branch on
+ * the header contents. The fields are compared one by one only if the masked
+ * comparison found a change.
+ */
+
+#ifndef ROHC_HDR_IMAGE_H
+#define ROHC_HDR_IMAGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+
+/**
+ * @brief Whether the masked bytes of one header differ from its stored image
+ *
+ * @param new_hdr  The new header
+ * @param old_hdr  The stored image of the previous header
+ * @param mask     The bits to compare, 1 for the bits the context tracks
+ * @param len      The length of the header, the image and the mask
+ * @return         true if at least one of the masked bits changed
+ */
+static inline bool rohc_hdr_image_changed(const uint8_t *const new_hdr,
+                                          const uint8_t *const old_hdr,
+                                          const uint8_t *const mask,
+                                          const size_t len)
+{
+	uint64_t diff = 0;
+	size_t i;
+
+	for(i = 0; (i + sizeof(uint64_t)) <= len; i += sizeof(uint64_t))
+	{
+		uint64_t new_word;
+		uint64_t old_word;
+		uint64_t mask_word;
+
+		memcpy(&new_word, new_hdr + i, sizeof(uint64_t));
+		memcpy(&old_word, old_hdr + i, sizeof(uint64_t));
+		memcpy(&mask_word, mask + i, sizeof(uint64_t));
+		diff |= (new_word ^ old_word) & mask_word;
+	}
+	for(; i < len; i++)
+	{
+		diff |= (new_hdr[i] ^ old_hdr[i]) & mask[i];
+	}
+
+	return (diff != 0);
+}
+
+#endif
+
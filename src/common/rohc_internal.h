@@ -199,6 +199,19 @@
 #define ROHC_PADDING_BYTE  0xe0
 
 
+/**
+ * @brief The length of the IPv4 fragment field of the IP-only contexts
+ *
+ * Once the IP fragments features are enabled on both sides, every packet of
+ * the ROHCv1 and ROHCv2 IP-only contexts carries the MF flag and the fragment
+ * offset of its innermost IPv4 header in network byte order right behind the
+ * ROHC header, the field is zero if the innermost header is not an IPv4
+ * fragment. No ROHC packet format of RFC 3095, RFC 3843 or RFC 5225 carries
+ * them, the fields are inferred to be zero.
+ */
+#define ROHC_IP_FRAG_FIELD_LEN  2U
+
+
 /**
  * @brief A number of bits required or retrieved
  */
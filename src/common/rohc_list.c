@@ -30,11 +30,12 @@
 #include <assert.h>
 
 
-static bool rohc_list_item_update(struct rohc_list_item *const list_item,
+static bool rohc_list_item_update(struct rohc_mempool *const mempool,
+                                  struct rohc_list_item *const list_item,
                                   const uint8_t item_type,
                                   const uint8_t *const item_data,
                                   const size_t item_len)
-	__attribute__((warn_unused_result, nonnull(1, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
 
 /**
@@ -52,6 +53,45 @@ void rohc_list_reset(struct rohc_list *const list)
 }
 
 
+/**
+ * @brief Allocate one compressed list from the given memory pool
+ *
+ * The lists identified by a gen_id are allocated on first use only, so that
+ * the contexts do not reserve memory for all the possible gen_id values.
+ *
+ * @param mempool  The memory pool to allocate the list from
+ * @param id       The ID of the list
+ * @return         The new empty list, NULL if memory is missing
+ */
+struct rohc_list * rohc_list_new(struct rohc_mempool *const mempool,
+                                 const uint16_t id)
+{
+	struct rohc_list *const list =
+		rohc_mempool_alloc(mempool, sizeof(struct rohc_list));
+
+	if(list != NULL)
+	{
+		rohc_list_reset(list);
+		list->id = id;
+	}
+
+	return list;
+}
+
+
+/**
+ * @brief Release one compressed list allocated by \ref rohc_list_new
+ *
+ * @param mempool  The memory pool the list was allocated from
+ * @param list     The list to release
+ */
+void rohc_list_free(struct rohc_mempool *const mempool,
+                    struct rohc_list *const list)
+{
+	rohc_mempool_release(mempool, list, sizeof(struct rohc_list));
+}
+
+
 /**
  * @brief Are the two given lists equal?
  *
@@ -128,10 +168,30 @@ void rohc_list_item_reset(struct rohc_list_item *const list_item)
 }
 
 
+/**
+ * @brief Release the data of the given list item
+ *
+ * @param mempool    The memory pool the item data was allocated from
+ * @param list_item  The item to release the data of
+ */
+void rohc_list_item_free(struct rohc_mempool *const mempool,
+                         struct rohc_list_item *const list_item)
+{
+	if(list_item->data != NULL)
+	{
+		rohc_mempool_release(mempool, list_item->data, list_item->data_max_len);
+		list_item->data = NULL;
+		list_item->data_max_len = 0;
+	}
+	rohc_list_item_reset(list_item);
+}
+
+
 /**
  * @brief Update the content of the given compressed item if it changed
  *
  * @param cmp_item   The callback function to compare two items
+ * @param mempool    The memory pool to allocate the item data from
  * @param list_item  The item to update
  * @param item_type  The type of the item to update
  * @param item_data  The data to update item with
@@ -141,6 +201,7 @@ void rohc_list_item_reset(struct rohc_list_item *const list_item)
  *                   -1 if a problem occurred
  */
 int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
+                                     struct rohc_mempool *const mempool,
                                      struct rohc_list_item *const list_item,
                                      const uint8_t item_type,
                                      const uint8_t *const item_data,
@@ -150,7 +211,7 @@ int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
 
 	if(!cmp_item(list_item, item_type, item_data, item_len))
 	{
-		if(rohc_list_item_update(list_item, item_type, item_data, item_len))
+		if(rohc_list_item_update(mempool, list_item, item_type, item_data, item_len))
 		{
 			status = 1;
 		}
@@ -171,13 +232,19 @@ int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
 /**
  * @brief Update the content the given compressed item
  *
+ * The item data is allocated from the memory pool on first use. It is
+ * allocated again, for the size class of the new item, only if the new item
+ * is larger than the memory already allocated.
+ *
+ * @param mempool    The memory pool to allocate the item data from
  * @param list_item  The item to update
  * @param item_type  The type of the item to update
  * @param item_data  The data to update item with
  * @param item_len   The data length (in bytes)
  * @return           true if the update was successful, false otherwise
  */
-static bool rohc_list_item_update(struct rohc_list_item *const list_item,
+static bool rohc_list_item_update(struct rohc_mempool *const mempool,
+                                  struct rohc_list_item *const list_item,
                                   const uint8_t item_type,
                                   const uint8_t *const item_data,
                                   const size_t item_len)
@@ -189,10 +256,32 @@ static bool rohc_list_item_update(struct rohc_list_item *const list_item,
 	{
 		return false;
 	}
+	if(item_len > list_item->data_max_len)
+	{
+		/* round the new length up to the size class of the memory pool, so
+		 * that the item may grow a little without allocating again */
+		size_t data_max_len = ROHC_MEMPOOL_OBJ_MIN_LEN;
+		uint8_t *data;
+
+		while(data_max_len < item_len)
+		{
+			data_max_len <<= 1;
+		}
+		data = rohc_mempool_alloc(mempool, data_max_len);
+		if(data == NULL)
+		{
+			return false;
+		}
+		if(list_item->data != NULL)
+		{
+			rohc_mempool_release(mempool, list_item->data, list_item->data_max_len);
+		}
+		list_item->data = data;
+		list_item->data_max_len = data_max_len;
+	}
 	memcpy(list_item->data, item_data, item_len);
 	list_item->length = item_len;
 	list_item->type = item_type;
 
 	return true;
 }
-
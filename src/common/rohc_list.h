@@ -28,6 +28,7 @@
 
 #include "protocols/ipv6.h"
 #include "protocols/ip_numbers.h"
+#include "rohc_mempool.h"
 
 #include <stdlib.h>
 
@@ -105,18 +106,21 @@ struct rohc_list_item
 
 	/** The length of the item data (in bytes) */
 	uint16_t length;
-	/** The item data */
-	uint8_t data[ROHC_LIST_ITEM_DATA_MAX];
+	/** The length of the memory allocated for the item data (in bytes) */
+	uint16_t data_max_len;
+	/** The item data, allocated from the memory pool of the list on first use
+	 *  and grown to the next size class when a larger item is recorded */
+	uint8_t *data;
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
 #if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
      (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
       (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
-_Static_assert((offsetof(struct rohc_list_item, data) % 8) == 0,
-               "data in struct rohc_list_item should be aligned on 8 bytes");
 _Static_assert((sizeof(struct rohc_list_item) % 8) == 0,
                "struct rohc_list_item length should be multiple of 8 bytes");
+_Static_assert(ROHC_LIST_ITEM_DATA_MAX <= ROHC_MEMPOOL_OBJ_MAX_LEN,
+               "item data should fit in the size classes of the memory pool");
 #endif
 
 
@@ -144,15 +148,28 @@ bool rohc_list_supersede(const struct rohc_list *const large,
                          const struct rohc_list *const small)
 	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 
+struct rohc_list * rohc_list_new(struct rohc_mempool *const mempool,
+                                  const uint16_t id)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_list_free(struct rohc_mempool *const mempool,
+                    struct rohc_list *const list)
+	__attribute__((nonnull(1, 2)));
+
 void rohc_list_item_reset(struct rohc_list_item *const list_item)
 	__attribute__((nonnull(1)));
 
+void rohc_list_item_free(struct rohc_mempool *const mempool,
+                         struct rohc_list_item *const list_item)
+	__attribute__((nonnull(1, 2)));
+
 int rohc_list_item_update_if_changed(rohc_list_item_cmp cmp_item,
+                                     struct rohc_mempool *const mempool,
                                      struct rohc_list_item *const list_item,
                                      const uint8_t item_type,
                                      const uint8_t *const item_data,
                                      const size_t item_len)
-	__attribute__((warn_unused_result, nonnull(2, 4)));
+	__attribute__((warn_unused_result, nonnull(2, 3, 5)));
 
 #endif
 
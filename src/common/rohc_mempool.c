@@ -0,0 +1,521 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_mempool.c
+ * @brief  Memory pool for the compression/decompression contexts
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_mempool.h"
+
+#ifndef __KERNEL__
+#  include "config.h" /* for ROHC_ALLOC_CHECK */
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+
+/** The header of one slab, stored before the objects of the slab */
+struct rohc_mempool_slab
+{
+	struct rohc_mempool_slab *next;  /**< The next slab of the memory pool */
+};
+
+
+/** The header of one released large object of the preallocated area, stored
+ *  within the object */
+struct rohc_mempool_large
+{
+	struct rohc_mempool_large *next;  /**< The next released large object */
+	size_t len;                       /**< The length of the object */
+};
+
+
+static size_t rohc_mempool_get_class(const size_t size)
+	__attribute__((warn_unused_result, const));
+
+static bool rohc_mempool_grow(struct rohc_mempool *const pool,
+                              const size_t class_idx)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void * rohc_mempool_carve(struct rohc_mempool *const pool,
+                                 const size_t len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static size_t rohc_mempool_get_large_len(const size_t size)
+	__attribute__((warn_unused_result, const));
+
+static void * rohc_mempool_alloc_large(struct rohc_mempool *const pool,
+                                       const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/**
+ * @brief Initialize a memory pool
+ *
+ * No memory is allocated until the first object is requested.
+ *
+ * @param pool  The memory pool to initialize
+ */
+void rohc_mempool_init(struct rohc_mempool *const pool)
+{
+	memset(pool, 0, sizeof(struct rohc_mempool));
+}
+
+
+/**
+ * @brief Free a memory pool and all its slabs
+ *
+ * All the objects of the memory pool shall have been released before. The
+ * budget of the memory pool is kept, the preallocated area is freed.
+ *
+ * @param pool  The memory pool to free
+ */
+void rohc_mempool_free(struct rohc_mempool *const pool)
+{
+	size_t i;
+
+	assert(pool->objs_nr == 0);
+
+	while(pool->slabs != NULL)
+	{
+		struct rohc_mempool_slab *const slab = pool->slabs;
+		pool->slabs = slab->next;
+		free(slab);
+	}
+	pool->slabs_nr = 0;
+	for(i = 0; i < ROHC_MEMPOOL_CLASSES_NR; i++)
+	{
+		pool->free_objs[i] = NULL;
+	}
+
+	free(pool->arena);
+	pool->arena = NULL;
+	pool->arena_next = NULL;
+	pool->arena_free_len = 0;
+	pool->arena_len = 0;
+	pool->free_large_objs = NULL;
+}
+
+
+/**
+ * @brief Preallocate the memory of a memory pool
+ *
+ * Allocate once the memory area that all the next objects are carved from:
+ * the memory pool does not call the system allocator until it is freed. The
+ * area is touched, so that no page fault happens on the first use of its
+ * objects either.
+ *
+ * The area is large enough for objects of \e objs_len bytes in total
+ * whatever their lengths, once rounded up to their size classes, plus one
+ * partially used slab per size class. The large objects are rounded up to a
+ * multiple of the largest size class. The memory released by the objects of
+ * one size class is reused for the next objects of the same size class only.
+ *
+ * The memory pool shall not use user callbacks and shall not have allocated
+ * objects. The slabs allocated before are freed.
+ *
+ * @param pool      The memory pool
+ * @param objs_len  The number of bytes of the objects to preallocate for
+ * @return          true if the memory was preallocated, false otherwise
+ */
+bool rohc_mempool_prealloc(struct rohc_mempool *const pool,
+                           const size_t objs_len)
+{
+	const size_t slack_len = ROHC_MEMPOOL_CLASSES_NR * ROHC_MEMPOOL_SLAB_LEN;
+	size_t arena_len;
+
+	if(pool->alloc_cb != NULL || pool->objs_nr > 0)
+	{
+		goto error;
+	}
+	if(objs_len > ((SIZE_MAX - slack_len - 2 * ROHC_MEMPOOL_OBJ_MIN_LEN) / 2))
+	{
+		goto error;
+	}
+	arena_len = objs_len * 2 + slack_len;
+	arena_len += (ROHC_MEMPOOL_OBJ_MIN_LEN -
+	              (arena_len % ROHC_MEMPOOL_OBJ_MIN_LEN)) % ROHC_MEMPOOL_OBJ_MIN_LEN;
+
+	rohc_mempool_free(pool);
+
+	/* room for the alignment of the objects on cache lines */
+	pool->arena = malloc(arena_len + ROHC_MEMPOOL_OBJ_MIN_LEN - 1);
+	if(pool->arena == NULL)
+	{
+		goto error;
+	}
+	memset(pool->arena, 0, arena_len + ROHC_MEMPOOL_OBJ_MIN_LEN - 1);
+	pool->arena_next = pool->arena;
+	pool->arena_next +=
+		(ROHC_MEMPOOL_OBJ_MIN_LEN -
+		 ((uintptr_t) pool->arena_next % ROHC_MEMPOOL_OBJ_MIN_LEN)) %
+		ROHC_MEMPOOL_OBJ_MIN_LEN;
+	pool->arena_free_len = arena_len;
+	pool->arena_len = arena_len;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the user callbacks that the memory pool shall use
+ *
+ * The callbacks may be changed only when no object is allocated. Give NULL
+ * for both callbacks to use the default slabs again.
+ *
+ * @param pool       The memory pool
+ * @param alloc_cb   The callback to allocate memory, or NULL
+ * @param free_cb    The callback to free memory, or NULL
+ * @param priv_ctxt  The private context given to the callbacks, may be NULL
+ * @return           true if the callbacks were set, false otherwise
+ */
+bool rohc_mempool_set_cbs(struct rohc_mempool *const pool,
+                          rohc_mem_alloc_cb_t alloc_cb,
+                          rohc_mem_free_cb_t free_cb,
+                          void *const priv_ctxt)
+{
+	if((alloc_cb == NULL) != (free_cb == NULL))
+	{
+		goto error;
+	}
+	if(pool->objs_nr > 0)
+	{
+		goto error;
+	}
+
+	/* the slabs are useless with user callbacks */
+	rohc_mempool_free(pool);
+
+	pool->alloc_cb = alloc_cb;
+	pool->free_cb = free_cb;
+	pool->cb_priv = priv_ctxt;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Allocate one zeroed object from a memory pool
+ *
+ * The allocation is refused if it would exceed the budget of the memory pool.
+ *
+ * @param pool  The memory pool
+ * @param size  The length of the object
+ * @return      The object, NULL if memory allocation failed
+ */
+void * rohc_mempool_alloc(struct rohc_mempool *const pool, const size_t size)
+{
+	void *obj;
+
+	/* the allocation shall not exceed the budget */
+	if(pool->budget > 0 &&
+	   (pool->objs_len > pool->budget || size > (pool->budget - pool->objs_len)))
+	{
+		pool->refused_nr++;
+		goto error;
+	}
+
+	if(pool->alloc_cb != NULL)
+	{
+		obj = pool->alloc_cb(size, pool->cb_priv);
+		if(obj == NULL)
+		{
+			goto error;
+		}
+	}
+	else if(size > ROHC_MEMPOOL_OBJ_MAX_LEN && pool->arena != NULL)
+	{
+		obj = rohc_mempool_alloc_large(pool, size);
+		if(obj == NULL)
+		{
+			goto error;
+		}
+	}
+	else if(size > ROHC_MEMPOOL_OBJ_MAX_LEN)
+	{
+		obj = malloc(size);
+		if(obj == NULL)
+		{
+			goto error;
+		}
+	}
+	else
+	{
+		const size_t class_idx = rohc_mempool_get_class(size);
+
+		if(pool->free_objs[class_idx] == NULL &&
+		   !rohc_mempool_grow(pool, class_idx))
+		{
+			goto error;
+		}
+		obj = pool->free_objs[class_idx];
+		memcpy(&pool->free_objs[class_idx], obj, sizeof(void *));
+	}
+	memset(obj, 0, size);
+	pool->objs_nr++;
+	pool->objs_len += size;
+
+	return obj;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Release one object to a memory pool
+ *
+ * @param pool  The memory pool
+ * @param obj   The object to release, may be NULL
+ * @param size  The length of the object, as given at allocation time
+ */
+void rohc_mempool_release(struct rohc_mempool *const pool,
+                          void *const obj,
+                          const size_t size)
+{
+	if(obj == NULL)
+	{
+		return;
+	}
+
+	assert(pool->objs_nr > 0);
+	pool->objs_nr--;
+	assert(pool->objs_len >= size);
+	pool->objs_len -= size;
+
+	if(pool->free_cb != NULL)
+	{
+		pool->free_cb(obj, size, pool->cb_priv);
+	}
+	else if(size > ROHC_MEMPOOL_OBJ_MAX_LEN && pool->arena != NULL)
+	{
+		struct rohc_mempool_large *const large = obj;
+
+		large->len = rohc_mempool_get_large_len(size);
+		large->next = pool->free_large_objs;
+		pool->free_large_objs = large;
+	}
+	else if(size > ROHC_MEMPOOL_OBJ_MAX_LEN)
+	{
+		free(obj);
+	}
+	else
+	{
+		const size_t class_idx = rohc_mempool_get_class(size);
+
+		memcpy(obj, &pool->free_objs[class_idx], sizeof(void *));
+		pool->free_objs[class_idx] = obj;
+	}
+}
+
+
+/**
+ * @brief Get the size class for objects of the given length
+ *
+ * @param size  The length of the objects, at most ROHC_MEMPOOL_OBJ_MAX_LEN
+ * @return      The index of the size class
+ */
+static size_t rohc_mempool_get_class(const size_t size)
+{
+	size_t class_idx = 0;
+
+	assert(size <= ROHC_MEMPOOL_OBJ_MAX_LEN);
+
+	while((ROHC_MEMPOOL_OBJ_MIN_LEN << class_idx) < size)
+	{
+		class_idx++;
+	}
+
+	return class_idx;
+}
+
+
+/**
+ * @brief Allocate a new slab and carve free objects of one size class from it
+ *
+ * @param pool       The memory pool
+ * @param class_idx  The size class of the objects to create
+ * @return           true if the objects were created, false otherwise
+ */
+static bool rohc_mempool_grow(struct rohc_mempool *const pool,
+                              const size_t class_idx)
+{
+	const size_t obj_len = ROHC_MEMPOOL_OBJ_MIN_LEN << class_idx;
+	const size_t objs_nr = ROHC_MEMPOOL_SLAB_LEN / obj_len;
+	uint8_t *objs;
+	size_t i;
+
+	if(pool->arena != NULL)
+	{
+		/* the slabs of a preallocated memory pool need no header, they are
+		 * freed with the preallocated area */
+		objs = rohc_mempool_carve(pool, ROHC_MEMPOOL_SLAB_LEN);
+		if(objs == NULL)
+		{
+			goto error;
+		}
+	}
+	else
+	{
+		struct rohc_mempool_slab *slab;
+
+		/* room for the header and the alignment of the objects on cache lines */
+		slab = malloc(sizeof(struct rohc_mempool_slab) + ROHC_MEMPOOL_OBJ_MIN_LEN - 1 +
+		              ROHC_MEMPOOL_SLAB_LEN);
+		if(slab == NULL)
+		{
+			goto error;
+		}
+		slab->next = pool->slabs;
+		pool->slabs = slab;
+
+		objs = (uint8_t *) (slab + 1);
+		objs += (ROHC_MEMPOOL_OBJ_MIN_LEN -
+		         ((uintptr_t) objs % ROHC_MEMPOOL_OBJ_MIN_LEN)) % ROHC_MEMPOOL_OBJ_MIN_LEN;
+	}
+	pool->slabs_nr++;
+
+	/* chain the objects in the list of free objects, first object first */
+	for(i = objs_nr; i > 0; i--)
+	{
+		void *const obj = objs + (i - 1) * obj_len;
+		memcpy(obj, &pool->free_objs[class_idx], sizeof(void *));
+		pool->free_objs[class_idx] = obj;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Carve memory from the preallocated area of a memory pool
+ *
+ * The memory is never given back to the area. The request is refused like the
+ * ones beyond the budget if the area is exhausted, and aborts the program if
+ * the library was built with the check of the allocations.
+ *
+ * @param pool  The memory pool, preallocated
+ * @param len   The length of the memory to carve
+ * @return      The cache-aligned memory, NULL if the area is exhausted
+ */
+static void * rohc_mempool_carve(struct rohc_mempool *const pool,
+                                 const size_t len)
+{
+	const size_t aligned_len = len + (ROHC_MEMPOOL_OBJ_MIN_LEN -
+	                                  (len % ROHC_MEMPOOL_OBJ_MIN_LEN)) %
+	                           ROHC_MEMPOOL_OBJ_MIN_LEN;
+	void *mem;
+
+	assert(pool->arena != NULL);
+
+	if(aligned_len > pool->arena_free_len)
+	{
+#if ROHC_ALLOC_CHECK == 1
+		/* more memory than preallocated is required */
+		abort();
+#endif
+		pool->refused_nr++;
+		goto error;
+	}
+	mem = pool->arena_next;
+	pool->arena_next += aligned_len;
+	pool->arena_free_len -= aligned_len;
+
+	return mem;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the length of the memory of one large object of the preallocated area
+ *
+ * The large objects are rounded up to a multiple of ROHC_MEMPOOL_OBJ_MAX_LEN,
+ * so that the objects of slightly different lengths reuse the same memory.
+ *
+ * @param size  The length of the object, more than ROHC_MEMPOOL_OBJ_MAX_LEN
+ * @return      The length of the memory for the object
+ */
+static size_t rohc_mempool_get_large_len(const size_t size)
+{
+	return size + (ROHC_MEMPOOL_OBJ_MAX_LEN - (size % ROHC_MEMPOOL_OBJ_MAX_LEN)) %
+	              ROHC_MEMPOOL_OBJ_MAX_LEN;
+}
+
+
+/**
+ * @brief Allocate one large object from the preallocated area of a memory pool
+ *
+ * A released object of the same rounded length is reused if any.
+ *
+ * @param pool  The memory pool, preallocated
+ * @param size  The length of the object, more than ROHC_MEMPOOL_OBJ_MAX_LEN
+ * @return      The object, NULL if the area is exhausted
+ */
+static void * rohc_mempool_alloc_large(struct rohc_mempool *const pool,
+                                       const size_t size)
+{
+	const size_t large_len = rohc_mempool_get_large_len(size);
+	struct rohc_mempool_large **prev = &pool->free_large_objs;
+
+	while((*prev) != NULL)
+	{
+		struct rohc_mempool_large *const large = (*prev);
+
+		if(large->len == large_len)
+		{
+			*prev = large->next;
+			return large;
+		}
+		prev = &large->next;
+	}
+
+	return rohc_mempool_carve(pool, large_len);
+}
+
+
+/**
+ * @brief Set the budget of a memory pool
+ *
+ * The objects already allocated are kept even if they exceed the new budget:
+ * next allocations are refused until enough objects are released.
+ *
+ * @param pool    The memory pool
+ * @param budget  The maximum number of bytes of the objects allocated,
+ *                0 for no budget
+ */
+void rohc_mempool_set_budget(struct rohc_mempool *const pool,
+                             const size_t budget)
+{
+	pool->budget = budget;
+}
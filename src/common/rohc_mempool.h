@@ -0,0 +1,140 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_mempool.h
+ * @brief  Memory pool for the compression/decompression contexts
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_MEMPOOL_H
+#define ROHC_MEMPOOL_H
+
+#include <rohc/rohc.h> /* for rohc_mem_alloc_cb_t and rohc_mem_free_cb_t */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** The length of the smallest objects of a memory pool, one cache line */
+#define ROHC_MEMPOOL_OBJ_MIN_LEN  64U
+
+/** The number of size classes of a memory pool: 64, 128, ..., 4096 bytes */
+#define ROHC_MEMPOOL_CLASSES_NR  7U
+
+/** The length of the largest objects carved from slabs, larger objects are
+ *  allocated one by one */
+#define ROHC_MEMPOOL_OBJ_MAX_LEN \
+	(ROHC_MEMPOOL_OBJ_MIN_LEN << (ROHC_MEMPOOL_CLASSES_NR - 1))
+
+/** The length of the memory area of one slab */
+#define ROHC_MEMPOOL_SLAB_LEN  16384U
+
+
+struct rohc_mempool_slab;
+struct rohc_mempool_large;
+
+
+/**
+ * @brief One memory pool
+ *
+ * The memory pool provides the memory for the profile-specific parts of the
+ * compression or decompression contexts. By default, objects are carved from
+ * slabs: every object is rounded up to a size class (a power of 2 number of
+ * cache lines) and every size class keeps its released objects in a free
+ * list, so creating and destroying contexts does not hit the system
+ * allocator once the slabs are warm. Objects are aligned on cache lines.
+ *
+ * The slabs are released only when the memory pool is freed.
+ *
+ * If user callbacks are set, they are used for all the allocations instead.
+ *
+ * If the memory pool was preallocated, the slabs and the large objects are
+ * carved from one memory area allocated once: the memory pool never calls the
+ * system allocator afterwards. The released large objects are kept in a free
+ * list for the next objects of the same length. The allocations that do not
+ * fit in the preallocated area are refused like the ones beyond the budget.
+ *
+ * The memory pool accounts the bytes of the objects in use, and refuses the
+ * allocations that would exceed its budget if one is set.
+ */
+struct rohc_mempool
+{
+	rohc_mem_alloc_cb_t alloc_cb;  /**< The user allocation callback, if any */
+	rohc_mem_free_cb_t free_cb;    /**< The user release callback, if any */
+	void *cb_priv;                 /**< The private context of the callbacks */
+
+	/** The released objects of every size class */
+	void *free_objs[ROHC_MEMPOOL_CLASSES_NR];
+	/** All the slabs allocated by the memory pool */
+	struct rohc_mempool_slab *slabs;
+	/** The number of objects currently allocated from the memory pool */
+	size_t objs_nr;
+	/** The number of bytes of the objects currently allocated */
+	size_t objs_len;
+	/** The number of slabs allocated by the memory pool */
+	size_t slabs_nr;
+	/** The maximum number of bytes of the objects allocated, 0 if none */
+	size_t budget;
+	/** The number of allocations refused because of the budget */
+	size_t refused_nr;
+
+	/** The preallocated memory area, NULL if the pool was not preallocated */
+	void *arena;
+	/** The cache-aligned start of the free part of the preallocated area */
+	uint8_t *arena_next;
+	/** The number of free bytes left in the preallocated area */
+	size_t arena_free_len;
+	/** The length of the preallocated area */
+	size_t arena_len;
+	/** The released large objects carved from the preallocated area */
+	struct rohc_mempool_large *free_large_objs;
+};
+
+
+void rohc_mempool_init(struct rohc_mempool *const pool)
+	__attribute__((nonnull(1)));
+
+void rohc_mempool_free(struct rohc_mempool *const pool)
+	__attribute__((nonnull(1)));
+
+bool rohc_mempool_set_cbs(struct rohc_mempool *const pool,
+                          rohc_mem_alloc_cb_t alloc_cb,
+                          rohc_mem_free_cb_t free_cb,
+                          void *const priv_ctxt)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool rohc_mempool_prealloc(struct rohc_mempool *const pool,
+                           const size_t objs_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_mempool_set_budget(struct rohc_mempool *const pool,
+                             const size_t budget)
+	__attribute__((nonnull(1)));
+
+void * rohc_mempool_alloc(struct rohc_mempool *const pool, const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_mempool_release(struct rohc_mempool *const pool,
+                          void *const obj,
+                          const size_t size)
+	__attribute__((nonnull(1)));
+
+#endif
+
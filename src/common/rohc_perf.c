@@ -0,0 +1,123 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_perf.c
+ * @brief  Measure the durations of the phases of packet processing
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_perf.h"
+
+#include <string.h>
+
+
+/** The number of buckets per power of 2, as a number of bits */
+#define ROHC_PERF_HISTO_SUB_BITS  2U
+
+/** The number of buckets per power of 2 */
+#define ROHC_PERF_HISTO_SUB_NR  (1U << ROHC_PERF_HISTO_SUB_BITS)
+
+
+/**
+ * @brief Reset one histogram of durations
+ *
+ * @param histo  The histogram to reset
+ */
+void rohc_perf_histo_reset(struct rohc_perf_histo *const histo)
+{
+	memset(histo, 0, sizeof(struct rohc_perf_histo));
+	histo->min_ns = UINT64_MAX;
+}
+
+
+/**
+ * @brief Add one duration to one histogram of durations
+ *
+ * @param histo        The histogram
+ * @param duration_ns  The duration to add (in nanoseconds)
+ */
+void rohc_perf_histo_add(struct rohc_perf_histo *const histo,
+                         const uint64_t duration_ns)
+{
+	size_t bucket;
+
+	if(duration_ns < ROHC_PERF_HISTO_SUB_NR)
+	{
+		bucket = duration_ns;
+	}
+	else
+	{
+		/* the power of 2 gives the group of buckets, the next bits give the
+		 * bucket in the group */
+		const size_t msb = 63 - __builtin_clzll(duration_ns);
+		bucket = ROHC_PERF_HISTO_SUB_NR * (msb - ROHC_PERF_HISTO_SUB_BITS + 1) +
+		         ((duration_ns >> (msb - ROHC_PERF_HISTO_SUB_BITS)) &
+		          (ROHC_PERF_HISTO_SUB_NR - 1));
+		if(bucket >= ROHC_PERF_HISTO_BUCKETS_NR)
+		{
+			bucket = ROHC_PERF_HISTO_BUCKETS_NR - 1;
+		}
+	}
+	histo->buckets[bucket]++;
+
+	histo->count++;
+	histo->sum_ns += duration_ns;
+	if(duration_ns < histo->min_ns)
+	{
+		histo->min_ns = duration_ns;
+	}
+	if(duration_ns > histo->max_ns)
+	{
+		histo->max_ns = duration_ns;
+	}
+}
+
+
+/**
+ * @brief Get the shortest duration counted in one bucket of a histogram
+ *
+ * The bucket counts the durations from its lower bound up to the lower bound
+ * of the next bucket (excluded).
+ *
+ * @param bucket  The index of the bucket, in range
+ *                [0, \ref ROHC_PERF_HISTO_BUCKETS_NR - 1]
+ * @return        The lower bound of the bucket (in nanoseconds),
+ *                UINT64_MAX if the bucket is out of range
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_comp_get_perf_info
+ * @see rohc_decomp_get_perf_info
+ */
+uint64_t rohc_perf_histo_bucket_min(const size_t bucket)
+{
+	const size_t group = bucket / ROHC_PERF_HISTO_SUB_NR;
+	const uint64_t sub = bucket % ROHC_PERF_HISTO_SUB_NR;
+
+	if(bucket >= ROHC_PERF_HISTO_BUCKETS_NR)
+	{
+		return UINT64_MAX;
+	}
+	else if(group == 0)
+	{
+		return bucket;
+	}
+
+	return (ROHC_PERF_HISTO_SUB_NR + sub) << (group - 1);
+}
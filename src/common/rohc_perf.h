@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_perf.h
+ * @brief  Measure the durations of the phases of packet processing
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_PERF_H
+#define ROHC_PERF_H
+
+#include "rohc.h"
+#include "rohc_time_internal.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** One clock that measures the phases of the processing of one packet */
+struct rohc_perf_clock
+{
+	/** Whether the measure is enabled or not */
+	bool is_enabled;
+	/** The time the processing of the packet started at (in nanoseconds) */
+	uint64_t start_ns;
+	/** The time the last phase ended at (in nanoseconds) */
+	uint64_t last_ns;
+};
+
+
+void rohc_perf_histo_reset(struct rohc_perf_histo *const histo)
+	__attribute__((nonnull(1)));
+
+void rohc_perf_histo_add(struct rohc_perf_histo *const histo,
+                         const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+
+static inline void rohc_perf_start(struct rohc_perf_clock *const clock,
+                                   const bool is_enabled)
+	__attribute__((nonnull(1)));
+
+static inline uint64_t rohc_perf_lap(struct rohc_perf_clock *const clock,
+                                     struct rohc_perf_histo *const histo)
+	__attribute__((nonnull(1, 2)));
+
+static inline uint64_t rohc_perf_stop(const struct rohc_perf_clock *const clock,
+                                      struct rohc_perf_histo *const histo)
+	__attribute__((nonnull(1, 2)));
+
+
+/**
+ * @brief Start measuring the processing of one packet
+ *
+ * @param clock       The clock to start
+ * @param is_enabled  Whether the measure is enabled or not, the clock costs
+ *                    one test per phase only if it is not
+ */
+static inline void rohc_perf_start(struct rohc_perf_clock *const clock,
+                                   const bool is_enabled)
+{
+	clock->is_enabled = is_enabled;
+	clock->start_ns = (is_enabled ? rohc_time_now_ns() : 0);
+	clock->last_ns = clock->start_ns;
+}
+
+
+/**
+ * @brief Record the duration of the phase that just ended
+ *
+ * @param clock  The clock of the packet
+ * @param histo  The histogram of the phase
+ * @return       The duration of the phase (in nanoseconds),
+ *               0 if the measure is disabled
+ */
+static inline uint64_t rohc_perf_lap(struct rohc_perf_clock *const clock,
+                                     struct rohc_perf_histo *const histo)
+{
+	uint64_t duration_ns = 0;
+
+	if(clock->is_enabled)
+	{
+		const uint64_t now_ns = rohc_time_now_ns();
+		duration_ns = now_ns - clock->last_ns;
+		rohc_perf_histo_add(histo, duration_ns);
+		clock->last_ns = now_ns;
+	}
+
+	return duration_ns;
+}
+
+
+/**
+ * @brief Record the duration of the whole processing of the packet
+ *
+ * The whole processing lasts until the end of the last phase.
+ *
+ * @param clock  The clock of the packet
+ * @param histo  The histogram of the whole processing
+ * @return       The duration of the whole processing (in nanoseconds),
+ *               0 if the measure is disabled
+ */
+static inline uint64_t rohc_perf_stop(const struct rohc_perf_clock *const clock,
+                                      struct rohc_perf_histo *const histo)
+{
+	uint64_t duration_ns = 0;
+
+	if(clock->is_enabled)
+	{
+		duration_ns = clock->last_ns - clock->start_ns;
+		rohc_perf_histo_add(histo, duration_ns);
+	}
+
+	return duration_ns;
+}
+
+#endif
+
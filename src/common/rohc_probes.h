@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_probes.h
+ * @brief  Static probe points of the ROHC library
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The probes are USDT probes of provider 'rohc' in userspace when the
+ * library is configured with --enable-usdt-probes, and tracepoints of
+ * system 'rohc' in the Linux kernel module. They cost nothing but a NOP
+ * when no tracer is attached, and they are compiled out otherwise.
+ *
+ * The probes and their arguments:
+ *  - comp_packet: CID, profile, packet type, uncompressed and compressed
+ *    header lengths of every compressed packet
+ *  - comp_ctxt_created: CID and profile of every new compression context
+ *  - comp_ctxt_recycled: CID and profile of every compression context
+ *    recycled to make room for a new one
+ *  - comp_state_change: CID, profile, old and new compression states
+ *  - comp_feedback: CID, profile and type of every feedback received
+ *  - decomp_crc_failure: CID, profile and packet type of every CRC failure
+ *  - decomp_crc_repair: CID, profile and algorithm of every repair attempt
+ */
+
+#ifndef ROHC_PROBES_H
+#define ROHC_PROBES_H
+
+#ifdef __KERNEL__
+
+#  include "rohc_trace_events.h"
+
+#  define ROHC_PROBE2(name, a1, a2) \
+	trace_rohc_##name(a1, a2)
+#  define ROHC_PROBE3(name, a1, a2, a3) \
+	trace_rohc_##name(a1, a2, a3)
+#  define ROHC_PROBE4(name, a1, a2, a3, a4) \
+	trace_rohc_##name(a1, a2, a3, a4)
+#  define ROHC_PROBE5(name, a1, a2, a3, a4, a5) \
+	trace_rohc_##name(a1, a2, a3, a4, a5)
+
+#else
+
+#  include "config.h" /* for ROHC_USDT_PROBES */
+
+#  if ROHC_USDT_PROBES == 1
+
+#    include <sys/sdt.h>
+
+#    define ROHC_PROBE2(name, a1, a2) \
+	DTRACE_PROBE2(rohc, name, a1, a2)
+#    define ROHC_PROBE3(name, a1, a2, a3) \
+	DTRACE_PROBE3(rohc, name, a1, a2, a3)
+#    define ROHC_PROBE4(name, a1, a2, a3, a4) \
+	DTRACE_PROBE4(rohc, name, a1, a2, a3, a4)
+#    define ROHC_PROBE5(name, a1, a2, a3, a4, a5) \
+	DTRACE_PROBE5(rohc, name, a1, a2, a3, a4, a5)
+
+#  else
+
+#    define ROHC_PROBE2(name, a1, a2) \
+	do { } while(0)
+#    define ROHC_PROBE3(name, a1, a2, a3) \
+	do { } while(0)
+#    define ROHC_PROBE4(name, a1, a2, a3, a4) \
+	do { } while(0)
+#    define ROHC_PROBE5(name, a1, a2, a3, a4, a5) \
+	do { } while(0)
+
+#  endif
+
+#endif
+
+#endif
+
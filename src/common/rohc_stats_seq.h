@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_stats_seq.h
+ * @brief  Sequence counter that publishes consistent statistics to readers
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The only writer of the statistics is the thread that processes packets.
+ * It makes the sequence counter odd before it updates the statistics and
+ * even again once they are updated. Readers from other threads copy the
+ * statistics and retry as long as the counter is odd or changed meanwhile.
+ * The writer never waits for readers.
+ */
+
+#ifndef ROHC_STATS_SEQ_H
+#define ROHC_STATS_SEQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+static inline void rohc_stats_write_begin(uint32_t *const seq)
+	__attribute__((nonnull(1)));
+
+static inline void rohc_stats_write_end(uint32_t *const seq)
+	__attribute__((nonnull(1)));
+
+static inline uint32_t rohc_stats_read_begin(const uint32_t *const seq)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static inline bool rohc_stats_read_retry(const uint32_t *const seq,
+                                         const uint32_t begin)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/**
+ * @brief Start updating the statistics protected by the given counter
+ *
+ * @param seq  The sequence counter of the statistics
+ */
+static inline void rohc_stats_write_begin(uint32_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Publish the statistics protected by the given counter
+ *
+ * @param seq  The sequence counter of the statistics
+ */
+static inline void rohc_stats_write_end(uint32_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Start reading the statistics protected by the given counter
+ *
+ * Wait for the writer to complete its update if one is in progress. The
+ * updates are a few additions long, so the wait is short.
+ *
+ * @param seq  The sequence counter of the statistics
+ * @return     The value of the counter to give to \ref rohc_stats_read_retry
+ */
+static inline uint32_t rohc_stats_read_begin(const uint32_t *const seq)
+{
+	uint32_t begin;
+
+	do
+	{
+		begin = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+	}
+	while((begin & 1) != 0);
+
+	return begin;
+}
+
+
+/**
+ * @brief Whether the statistics that were just read shall be read again
+ *
+ * @param seq    The sequence counter of the statistics
+ * @param begin  The value returned by \ref rohc_stats_read_begin
+ * @return       true if the writer updated the statistics while they were
+ *               read, false if the copy is consistent
+ */
+static inline bool rohc_stats_read_retry(const uint32_t *const seq,
+                                         const uint32_t begin)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return (__atomic_load_n(seq, __ATOMIC_RELAXED) != begin);
+}
+
+#endif
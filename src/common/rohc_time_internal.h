@@ -32,7 +32,11 @@
 #include "rohc_time.h" /* for public definition of struct rohc_ts */
 
 #ifndef __KERNEL__
+#  include <stdbool.h>
 #  include <sys/time.h>
+#  include <time.h>
+#else
+#  include <linux/ktime.h>
 #endif
 
 
@@ -40,6 +44,20 @@ static inline uint64_t rohc_time_interval(const struct rohc_ts begin,
                                           const struct rohc_ts end)
 	__attribute__((warn_unused_result, const));
 
+static inline struct rohc_ts rohc_time_add_us(const struct rohc_ts ts,
+                                              const uint64_t delay)
+	__attribute__((warn_unused_result, const));
+
+static inline bool rohc_time_is_before(const struct rohc_ts ts1,
+                                       const struct rohc_ts ts2)
+	__attribute__((warn_unused_result, const));
+
+static inline uint64_t rohc_time_now_ns(void)
+	__attribute__((warn_unused_result));
+
+static inline uint32_t rohc_time_ms32(const struct rohc_ts ts)
+	__attribute__((warn_unused_result, const));
+
 
 /**
  * @brief Compute the interval of time between 2 timestamps
@@ -67,5 +85,94 @@ static inline uint64_t rohc_time_interval(const struct rohc_ts begin,
 }
 
 
+/**
+ * @brief Add a delay to one timestamp
+ *
+ * @param ts     The timestamp (in seconds and nanoseconds)
+ * @param delay  The delay to add (in microseconds)
+ * @return       The timestamp plus the delay, the largest timestamp if the
+ *               seconds overflow
+ */
+static inline struct rohc_ts rohc_time_add_us(const struct rohc_ts ts,
+                                              const uint64_t delay)
+{
+	struct rohc_ts result;
+	uint64_t delay_sec = delay;
+	uint64_t delay_usec;
+
+#ifndef __KERNEL__
+	delay_usec = delay_sec % 1000000UL;
+	delay_sec /= 1000000UL;
+#else
+	delay_usec = do_div(delay_sec, 1000000UL);
+#endif
+
+	result.nsec = ts.nsec + delay_usec * 1000UL;
+	result.sec = ts.sec + delay_sec;
+	if(result.nsec >= 1000000000UL)
+	{
+		result.nsec -= 1000000000UL;
+		result.sec++;
+	}
+	if(result.sec < ts.sec)
+	{
+		result.sec = UINT64_MAX;
+		result.nsec = 0;
+	}
+
+	return result;
+}
+
+
+/**
+ * @brief Whether one timestamp is before another one
+ *
+ * @param ts1  The first timestamp (in seconds and nanoseconds)
+ * @param ts2  The second timestamp (in seconds and nanoseconds)
+ * @return     true if the first timestamp is strictly before the second one
+ */
+static inline bool rohc_time_is_before(const struct rohc_ts ts1,
+                                       const struct rohc_ts ts2)
+{
+	return (ts1.sec < ts2.sec || (ts1.sec == ts2.sec && ts1.nsec < ts2.nsec));
+}
+
+
+/**
+ * @brief Get the current time from a monotonic clock
+ *
+ * @return  The current time, in nanoseconds since an arbitrary origin
+ */
+static inline uint64_t rohc_time_now_ns(void)
+{
+#ifndef __KERNEL__
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000ULL + now.tv_nsec;
+#else
+	return ktime_get_ns();
+#endif
+}
+
+
+/**
+ * @brief Get the milliseconds of one timestamp on 32 bits
+ *
+ * The result wraps around every 49 days or so, so it is suitable for time
+ * differences only.
+ *
+ * @param ts  The timestamp (in seconds and nanoseconds)
+ * @return    The timestamp in milliseconds, modulo 2^32
+ */
+static inline uint32_t rohc_time_ms32(const struct rohc_ts ts)
+{
+	return ((uint32_t) ts.sec) * 1000U + ((uint32_t) ts.nsec) / 1000000U;
+}
+
+
 #endif /* ROHC_TIME_INTERNAL_H */
 
@@ -0,0 +1,527 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_trace_ring.c
+ * @brief  Lock-free ring of binary trace records
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_trace_ring.h"
+#include "rohc.h"
+#include "rohc_utils.h"
+#include "rohc_time_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdio.h> /* for snprintf(3) */
+#ifndef __KERNEL__
+#  include <sys/types.h>
+#endif
+
+
+/** The maximum length of one conversion specification of a format string */
+#define ROHC_TRACE_RING_SPEC_MAX_LEN  16U
+
+/** The maximum length of one trace message expanded from a record */
+#define ROHC_TRACE_RING_MSG_MAX_LEN  512U
+
+
+/** The length modifiers of the conversions of a format string */
+typedef enum
+{
+	ROHC_TRACE_LEN_NONE = 0,  /**< No length modifier */
+	ROHC_TRACE_LEN_HH,        /**< The 'hh' length modifier */
+	ROHC_TRACE_LEN_H,         /**< The 'h' length modifier */
+	ROHC_TRACE_LEN_L,         /**< The 'l' length modifier */
+	ROHC_TRACE_LEN_LL,        /**< The 'll' length modifier */
+	ROHC_TRACE_LEN_Z,         /**< The 'z' length modifier */
+	ROHC_TRACE_LEN_J,         /**< The 'j' length modifier */
+	ROHC_TRACE_LEN_T,         /**< The 't' length modifier */
+} rohc_trace_len_t;
+
+
+/** One conversion specification of a format string */
+struct rohc_trace_conv
+{
+	size_t flags_len;         /**< The length of the flags, width and precision */
+	rohc_trace_len_t length;  /**< The length modifier */
+	char conv;                /**< The conversion specifier */
+};
+
+
+static const char * rohc_trace_ring_parse_conv(const char *const spec,
+                                               struct rohc_trace_conv *const conv)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static size_t rohc_trace_ring_format(const struct rohc_trace_record *const record,
+                                     char *const msg,
+                                     const size_t msg_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/**
+ * @brief Create a new ring of binary trace records
+ *
+ * Create a flight recorder for the traces of compressors and decompressors:
+ * give \ref rohc_trace_ring_cb and the ring as trace callback to
+ * \ref rohc_comp_set_traces_cb2 or \ref rohc_decomp_set_traces_cb2. Every
+ * trace is then recorded in binary form, without being formatted, and the
+ * last records may be expanded into the usual text messages later with
+ * \ref rohc_trace_ring_expand, eg. after a decompression failure.
+ *
+ * @param records_nr  The number of records the ring may hold, a power of 2 in
+ *                    range [1, 1048576]
+ * @return            The created ring if successful, NULL if creation failed
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring_free
+ * @see rohc_trace_ring_cb
+ * @see rohc_trace_ring_expand
+ */
+struct rohc_trace_ring * rohc_trace_ring_new(const size_t records_nr)
+{
+	struct rohc_trace_ring *ring;
+
+	/* the number of records shall be a non-zero power of 2 */
+	if(records_nr == 0 || records_nr > ROHC_TRACE_RING_RECORDS_MAX ||
+	   (records_nr & (records_nr - 1)) != 0)
+	{
+		goto error;
+	}
+
+	ring = calloc(1, sizeof(struct rohc_trace_ring));
+	if(ring == NULL)
+	{
+		goto error;
+	}
+	ring->records = calloc(records_nr, sizeof(struct rohc_trace_record));
+	if(ring->records == NULL)
+	{
+		goto free_ring;
+	}
+	ring->mask = records_nr - 1;
+	ring->head = 0;
+
+	return ring;
+
+free_ring:
+	free(ring);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given ring of binary trace records
+ *
+ * The compressors and decompressors that record their traces in the ring
+ * shall be destroyed first.
+ *
+ * @param ring  The ring to destroy
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring_new
+ */
+void rohc_trace_ring_free(struct rohc_trace_ring *const ring)
+{
+	if(ring != NULL)
+	{
+		free(ring->records);
+		free(ring);
+	}
+}
+
+
+/**
+ * @brief Record one trace in a ring of binary trace records
+ *
+ * The function is a trace callback for \ref rohc_comp_set_traces_cb2 and
+ * \ref rohc_decomp_set_traces_cb2, with the ring as private context. It may
+ * be called from several threads at the same time.
+ *
+ * The arguments are recorded without being formatted. At most
+ * \ref ROHC_TRACE_RING_ARGS_MAX arguments are recorded, and the string
+ * arguments are truncated once \ref ROHC_TRACE_RING_STRS_LEN bytes are used.
+ *
+ * @param priv_ctxt  The ring of binary trace records
+ * @param level      The level of the trace
+ * @param entity     The entity concerned by the trace
+ * @param profile    The number of the profile concerned by the trace
+ * @param format     The format string of the trace
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring_new
+ * @see rohc_trace_ring_expand
+ */
+void rohc_trace_ring_cb(void *const priv_ctxt,
+                        const rohc_trace_level_t level,
+                        const rohc_trace_entity_t entity,
+                        const int profile,
+                        const char *const format,
+                        ...)
+{
+	struct rohc_trace_ring *const ring = priv_ctxt;
+	const uint64_t idx = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+	struct rohc_trace_record *const record = &(ring->records[idx & ring->mask]);
+	size_t strs_len = 0;
+	const char *walk;
+	va_list ap;
+
+	/* hide the record from the reader while it is overwritten */
+	__atomic_store_n(&record->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	record->time_ns = rohc_time_now_ns();
+	record->format = format;
+	record->profile = profile;
+	record->level = level;
+	record->entity = entity;
+	record->args_nr = 0;
+	record->is_truncated = false;
+
+	va_start(ap, format);
+	for(walk = strchr(format, '%'); walk != NULL; walk = strchr(walk, '%'))
+	{
+		struct rohc_trace_conv conv;
+		bool is_signed;
+		uint64_t arg;
+
+		walk = rohc_trace_ring_parse_conv(walk, &conv);
+		if(conv.conv == '%')
+		{
+			continue;
+		}
+		if(conv.conv == '\0' || record->args_nr >= ROHC_TRACE_RING_ARGS_MAX)
+		{
+			record->is_truncated = true;
+			break;
+		}
+		is_signed = (conv.conv == 'd' || conv.conv == 'i');
+
+		switch(conv.conv)
+		{
+			case 'd':
+			case 'i':
+			case 'u':
+			case 'x':
+			case 'X':
+			case 'o':
+			case 'c':
+				switch(conv.length)
+				{
+					case ROHC_TRACE_LEN_L:
+						arg = (is_signed ? (uint64_t) va_arg(ap, long) :
+						       (uint64_t) va_arg(ap, unsigned long));
+						break;
+					case ROHC_TRACE_LEN_LL:
+						arg = (is_signed ? (uint64_t) va_arg(ap, long long) :
+						       (uint64_t) va_arg(ap, unsigned long long));
+						break;
+					case ROHC_TRACE_LEN_Z:
+						arg = (is_signed ? (uint64_t) va_arg(ap, ssize_t) :
+						       (uint64_t) va_arg(ap, size_t));
+						break;
+					case ROHC_TRACE_LEN_J:
+						arg = (is_signed ? (uint64_t) va_arg(ap, intmax_t) :
+						       (uint64_t) va_arg(ap, uintmax_t));
+						break;
+					case ROHC_TRACE_LEN_T:
+						arg = (uint64_t) va_arg(ap, ptrdiff_t);
+						break;
+					case ROHC_TRACE_LEN_NONE:
+					case ROHC_TRACE_LEN_HH:
+					case ROHC_TRACE_LEN_H:
+					default:
+						/* shorter arguments are promoted to int */
+						arg = (is_signed ? (uint64_t) va_arg(ap, int) :
+						       (uint64_t) va_arg(ap, unsigned int));
+						break;
+				}
+				break;
+			case 'p':
+				arg = (uintptr_t) va_arg(ap, void *);
+				break;
+			case 's':
+			{
+				/* copy the string, truncated to the room left in the record;
+				 * once the room is exhausted, all the next strings share the
+				 * last NUL byte */
+				const char *const str = va_arg(ap, const char *);
+				const size_t room = ROHC_TRACE_RING_STRS_LEN - strs_len;
+				size_t str_len = (str == NULL ? 0 : strlen(str));
+
+				if(str_len >= room)
+				{
+					str_len = room - 1;
+				}
+				if(str_len > 0)
+				{
+					memcpy(record->strs + strs_len, str, str_len);
+				}
+				record->strs[strs_len + str_len] = '\0';
+				arg = strs_len;
+				strs_len = rohc_min(strs_len + str_len + 1,
+				                    ROHC_TRACE_RING_STRS_LEN - 1);
+				break;
+			}
+			default:
+				/* floating-point or unknown conversions are not recorded */
+				record->is_truncated = true;
+				goto end;
+		}
+		record->args[record->args_nr] = arg;
+		record->args_nr++;
+	}
+end:
+	va_end(ap);
+
+	/* publish the record */
+	__atomic_store_n(&record->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Expand the records of a ring of binary trace records into text
+ *
+ * The records still in the ring are expanded into the text messages that
+ * the traces would have printed, oldest first, and given to the callback.
+ * The records that are overwritten during the expansion are skipped.
+ *
+ * @param ring       The ring of binary trace records
+ * @param print_cb   The function to call for every expanded message
+ * @param priv_ctxt  The private context given to the callback, may be NULL
+ * @return           The number of messages given to the callback
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring_new
+ * @see rohc_trace_ring_cb
+ */
+size_t rohc_trace_ring_expand(const struct rohc_trace_ring *const ring,
+                              rohc_trace_ring_print_cb_t print_cb,
+                              void *const priv_ctxt)
+{
+	const uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	const uint64_t records_nr = ring->mask + 1;
+	uint64_t idx = (head > records_nr ? head - records_nr : 0);
+	size_t msgs_nr = 0;
+
+	for(; idx < head; idx++)
+	{
+		const struct rohc_trace_record *const slot = &(ring->records[idx & ring->mask]);
+		struct rohc_trace_record record;
+		char msg[ROHC_TRACE_RING_MSG_MAX_LEN];
+
+		/* copy the record, then check that it was not modified meanwhile */
+		if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != (idx + 1))
+		{
+			continue;
+		}
+		memcpy(&record, slot, sizeof(struct rohc_trace_record));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != (idx + 1))
+		{
+			continue;
+		}
+
+		if(rohc_trace_ring_format(&record, msg, ROHC_TRACE_RING_MSG_MAX_LEN) > 0)
+		{
+			print_cb(priv_ctxt, record.time_ns, record.level, record.entity,
+			         record.profile, msg);
+			msgs_nr++;
+		}
+	}
+
+	return msgs_nr;
+}
+
+
+/**
+ * @brief Parse one conversion specification of a format string
+ *
+ * @param spec       The conversion specification, starting with '%'
+ * @param[out] conv  The parsed conversion, with a '\0' specifier if the
+ *                   conversion is not supported
+ * @return           The first character after the conversion specification
+ */
+static const char * rohc_trace_ring_parse_conv(const char *const spec,
+                                               struct rohc_trace_conv *const conv)
+{
+	const char *walk = spec + 1;
+
+	/* flags, width and precision */
+	while(*walk != '\0' && strchr("-+ #0123456789.", *walk) != NULL)
+	{
+		walk++;
+	}
+	conv->flags_len = walk - (spec + 1);
+
+	/* length modifier */
+	conv->length = ROHC_TRACE_LEN_NONE;
+	if(walk[0] == 'h')
+	{
+		conv->length = (walk[1] == 'h' ? ROHC_TRACE_LEN_HH : ROHC_TRACE_LEN_H);
+		walk += (walk[1] == 'h' ? 2 : 1);
+	}
+	else if(walk[0] == 'l')
+	{
+		conv->length = (walk[1] == 'l' ? ROHC_TRACE_LEN_LL : ROHC_TRACE_LEN_L);
+		walk += (walk[1] == 'l' ? 2 : 1);
+	}
+	else if(walk[0] == 'z')
+	{
+		conv->length = ROHC_TRACE_LEN_Z;
+		walk++;
+	}
+	else if(walk[0] == 'j')
+	{
+		conv->length = ROHC_TRACE_LEN_J;
+		walk++;
+	}
+	else if(walk[0] == 't')
+	{
+		conv->length = ROHC_TRACE_LEN_T;
+		walk++;
+	}
+
+	/* conversion specifier */
+	if(*walk == '\0' || conv->flags_len > (ROHC_TRACE_RING_SPEC_MAX_LEN - 5))
+	{
+		conv->conv = '\0';
+	}
+	else
+	{
+		conv->conv = *walk;
+		walk++;
+	}
+
+	return walk;
+}
+
+
+/**
+ * @brief Expand one binary trace record into its text message
+ *
+ * @param record       The binary trace record
+ * @param msg          The buffer to store the message in
+ * @param msg_max_len  The length of the buffer
+ * @return             The length of the message
+ */
+static size_t rohc_trace_ring_format(const struct rohc_trace_record *const record,
+                                     char *const msg,
+                                     const size_t msg_max_len)
+{
+	const char *walk = record->format;
+	size_t args_nr = 0;
+	size_t msg_len = 0;
+
+	while(*walk != '\0' && msg_len < (msg_max_len - 1))
+	{
+		char spec[ROHC_TRACE_RING_SPEC_MAX_LEN];
+		struct rohc_trace_conv conv;
+		const char *conv_end;
+		int ret;
+
+		if(*walk != '%')
+		{
+			msg[msg_len] = *walk;
+			msg_len++;
+			walk++;
+			continue;
+		}
+
+		conv_end = rohc_trace_ring_parse_conv(walk, &conv);
+		if(conv.conv == '%')
+		{
+			msg[msg_len] = '%';
+			msg_len++;
+			walk = conv_end;
+			continue;
+		}
+		if(args_nr >= record->args_nr)
+		{
+			/* the remaining arguments were not recorded */
+			ret = snprintf(msg + msg_len, msg_max_len - msg_len, "[...]\n");
+			msg_len += (ret > 0 ? ret : 0);
+			break;
+		}
+
+		/* rebuild the conversion with the length modifier of the recorded
+		 * 64-bit argument */
+		memcpy(spec, walk, 1 + conv.flags_len);
+		spec[1 + conv.flags_len] = '\0';
+		switch(conv.conv)
+		{
+			case 's':
+				strcat(spec, "s");
+				ret = snprintf(msg + msg_len, msg_max_len - msg_len, spec,
+				               record->strs + record->args[args_nr]);
+				break;
+			case 'p':
+				strcat(spec, "p");
+				ret = snprintf(msg + msg_len, msg_max_len - msg_len, spec,
+				               (void *) (uintptr_t) record->args[args_nr]);
+				break;
+			case 'c':
+				strcat(spec, "c");
+				ret = snprintf(msg + msg_len, msg_max_len - msg_len, spec,
+				               (int) record->args[args_nr]);
+				break;
+			default:
+			{
+				uint64_t arg = record->args[args_nr];
+
+				if(conv.length == ROHC_TRACE_LEN_HH)
+				{
+					arg = (conv.conv == 'd' || conv.conv == 'i') ?
+					      (uint64_t) ((int64_t) ((int8_t) arg)) : (uint8_t) arg;
+				}
+				else if(conv.length == ROHC_TRACE_LEN_H)
+				{
+					arg = (conv.conv == 'd' || conv.conv == 'i') ?
+					      (uint64_t) ((int64_t) ((int16_t) arg)) : (uint16_t) arg;
+				}
+				spec[1 + conv.flags_len] = 'l';
+				spec[2 + conv.flags_len] = 'l';
+				spec[3 + conv.flags_len] = conv.conv;
+				spec[4 + conv.flags_len] = '\0';
+				ret = snprintf(msg + msg_len, msg_max_len - msg_len, spec,
+				               (unsigned long long) arg);
+				break;
+			}
+		}
+		if(ret > 0)
+		{
+			msg_len += ret;
+			if(msg_len >= msg_max_len)
+			{
+				msg_len = msg_max_len - 1;
+			}
+		}
+		args_nr++;
+		walk = conv_end;
+	}
+	msg[msg_len] = '\0';
+
+	return msg_len;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_trace_ring.h
+ * @brief  Lock-free ring of binary trace records
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_TRACE_RING_H
+#define ROHC_TRACE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** The maximum number of records of one trace ring */
+#define ROHC_TRACE_RING_RECORDS_MAX  1048576U
+
+/** The maximum number of arguments recorded for one trace, including
+ *  the file, line and function of the trace */
+#define ROHC_TRACE_RING_ARGS_MAX  8U
+
+/** The room for the string arguments of one trace record */
+#define ROHC_TRACE_RING_STRS_LEN  96U
+
+
+/**
+ * @brief One binary trace record
+ *
+ * The arguments are recorded in the order of the conversions of the format
+ * string, as 64-bit integers. String arguments are copied in \e strs, their
+ * argument is their offset in \e strs.
+ */
+struct rohc_trace_record
+{
+	/** The rank of the record plus one, 0 while the record is written */
+	uint64_t seq;
+	/** The time of the record, in nanoseconds since an arbitrary origin */
+	uint64_t time_ns;
+	/** The format string of the trace */
+	const char *format;
+	/** The profile concerned by the trace */
+	int profile;
+	/** The level of the trace */
+	uint8_t level;
+	/** The entity concerned by the trace */
+	uint8_t entity;
+	/** The number of arguments recorded */
+	uint8_t args_nr;
+	/** Whether the format has more arguments than the recorded ones */
+	bool is_truncated;
+	/** The arguments of the trace */
+	uint64_t args[ROHC_TRACE_RING_ARGS_MAX];
+	/** The string arguments of the trace, each one NUL-terminated */
+	char strs[ROHC_TRACE_RING_STRS_LEN];
+};
+
+
+/**
+ * @brief One lock-free ring of binary trace records
+ *
+ * The producers reserve records with one atomic increment of the head index
+ * and never wait: the oldest records are overwritten once the ring is full,
+ * like a flight recorder. Every record is published by writing its rank
+ * last, so that the reader skips the records being written or overwritten.
+ */
+struct rohc_trace_ring
+{
+	/** The records of the ring */
+	struct rohc_trace_record *records;
+	/** The mask to apply on indexes to get records, number of records minus 1 */
+	size_t mask;
+	/** The index of the next record to write */
+	uint64_t head;
+};
+
+#endif
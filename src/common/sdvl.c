@@ -25,7 +25,6 @@
  */
 
 #include "sdvl.h"
-#include "rohc_bit_ops.h"
 
 #include <assert.h>
 
@@ -44,6 +43,56 @@ typedef enum
 } rohc_sdvl_max_value_t;
 
 
+/** The SDVL length (in bytes) required to encode the given number of bits,
+ *  5 means that the bits cannot be SDVL-encoded */
+static const uint8_t sdvl_len_by_bits[32 + 1] =
+{
+	1,                          /* 0 bit, for value 0 */
+	1, 1, 1, 1, 1, 1, 1,        /* 1 to 7 bits */
+	2, 2, 2, 2, 2, 2, 2,        /* 8 to 14 bits */
+	3, 3, 3, 3, 3, 3, 3,        /* 15 to 21 bits */
+	4, 4, 4, 4, 4, 4, 4, 4,     /* 22 to 29 bits */
+	5, 5, 5,                    /* 30 to 32 bits */
+};
+
+/** The number of bits transmitted by 1, 2, 3 and 4 SDVL-encoded bytes */
+static const uint8_t sdvl_bits_by_len[4 + 1] =
+{
+	0,
+	ROHC_SDVL_MAX_BITS_IN_1_BYTE,
+	ROHC_SDVL_MAX_BITS_IN_2_BYTES,
+	ROHC_SDVL_MAX_BITS_IN_3_BYTES,
+	ROHC_SDVL_MAX_BITS_IN_4_BYTES,
+};
+
+/** The SDVL length (in bytes) indexed by the 3 first bits of the field */
+static const uint8_t sdvl_len_by_prefix[8] =
+{
+	1, 1, 1, 1,  /* bit pattern 0 */
+	2, 2,        /* bit pattern 10 */
+	3,           /* bit pattern 110 */
+	4,           /* bit pattern 111 */
+};
+
+/** The prefix bits of the first byte of 1, 2, 3 and 4 SDVL-encoded bytes */
+static const uint8_t sdvl_first_byte_prefix[4 + 1] =
+{
+	0x00, 0x00, 0x80, 0xc0, 0xe0
+};
+
+/** The value bits of the first byte of 1, 2, 3 and 4 SDVL-encoded bytes */
+static const uint8_t sdvl_first_byte_mask[4 + 1] =
+{
+	0x00, 0x7f, 0x3f, 0x1f, 0x1f
+};
+
+
+static inline void sdvl_write(uint8_t *const sdvl_bytes,
+                              const size_t sdvl_len,
+                              const uint32_t value)
+	__attribute__((nonnull(1)));
+
+
 /**
  * @brief Can the given value be encoded with SDVL?
  *
@@ -97,23 +146,7 @@ size_t sdvl_get_min_len(const size_t nr_min_required,
 		const size_t remaining = nr_min_required - nr_encoded;
 
 		assert(remaining <= ROHC_SDVL_MAX_BITS_IN_4_BYTES);
-
-		if(remaining <= ROHC_SDVL_MAX_BITS_IN_1_BYTE)
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-		}
-		else if(remaining <= ROHC_SDVL_MAX_BITS_IN_2_BYTES)
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-		}
-		else if(remaining <= ROHC_SDVL_MAX_BITS_IN_3_BYTES)
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-		}
-		else
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
-		}
+		nr_needed = sdvl_bits_by_len[sdvl_len_by_bits[remaining]];
 	}
 
 	assert((nr_encoded + nr_needed) >= nr_min_required);
@@ -133,32 +166,11 @@ size_t sdvl_get_min_len(const size_t nr_min_required,
  */
 size_t sdvl_get_encoded_len(const uint32_t value)
 {
-	size_t size;
+	/* the number of significant bits in value, 1 bit for value 0 */
+	const size_t bits_nr = 32 - __builtin_clz(value | 1);
 
-	/* find the length for SDVL-encoding */
-	if(value <= ROHC_SDVL_MAX_VALUE_IN_1_BYTE)
-	{
-		size = 1;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_2_BYTES)
-	{
-		size = 2;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_3_BYTES)
-	{
-		size = 3;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES)
-	{
-		size = 4;
-	}
-	else
-	{
-		/* value is too large for SDVL-encoding */
-		size = 5;
-	}
-
-	return size;
+	/* 5 bytes means that value is too large for SDVL-encoding */
+	return sdvl_len_by_bits[bits_nr];
 }
 
 
@@ -186,66 +198,20 @@ bool sdvl_encode(uint8_t *const sdvl_bytes,
 	/* encoding 0 bit is an error */
 	assert(bits_nr > 0);
 
-	/* encode the value according to the number of available bits */
-	if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_1_BYTE)
+	if(bits_nr > ROHC_SDVL_MAX_BITS_IN_4_BYTES)
 	{
-		*sdvl_bytes_nr = 1;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* bit pattern 0 */
-		sdvl_bytes[0] = value & 0x7f;
-	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_2_BYTES)
-	{
-		*sdvl_bytes_nr = 2;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* 2 = bit pattern 10 */
-		sdvl_bytes[0] = ((2 << 6) | ((value >> 8) & 0x3f)) & 0xff;
-		sdvl_bytes[1] = value & 0xff;
-	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_3_BYTES)
-	{
-		*sdvl_bytes_nr = 3;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* 6 = bit pattern 110 */
-		sdvl_bytes[0] = ((6 << 5) | ((value >> 16) & 0x1f)) & 0xff;
-		sdvl_bytes[1] = (value >> 8) & 0xff;
-		sdvl_bytes[2] = value & 0xff;
-	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_4_BYTES)
-	{
-		*sdvl_bytes_nr = 4;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* 7 = bit pattern 111 */
-		sdvl_bytes[0] = ((7 << 5) | ((value >> 24) & 0x1f)) & 0xff;
-		sdvl_bytes[1] = (value >> 16) & 0xff;
-		sdvl_bytes[2] = (value >> 8) & 0xff;
-		sdvl_bytes[3] = value & 0xff;
+		/* number of bytes needed is too large (value must be < 2^29) */
+		goto error;
 	}
-	else
+
+	/* encode the value according to the number of available bits */
+	*sdvl_bytes_nr = sdvl_len_by_bits[bits_nr];
+	if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
 	{
-		/* number of bytes needed is too large (value must be < 2^29) */
+		/* number of bytes needed is too large for buffer */
 		goto error;
 	}
+	sdvl_write(sdvl_bytes, *sdvl_bytes_nr, value);
 
 	return true;
 
@@ -257,6 +223,8 @@ error:
 /**
  * @brief Encode a value using Self-Describing Variable-Length (SDVL) encoding
  *
+ * Use the smallest SDVL length that is able to transmit the full value.
+ *
  * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
  *
  * Encoding failures may be due to a value greater than 2^29.
@@ -273,33 +241,22 @@ bool sdvl_encode_full(uint8_t *const sdvl_bytes,
                       size_t *const sdvl_bytes_nr,
                       const uint32_t value)
 {
-	size_t bits_nr;
+	const size_t sdvl_len = sdvl_get_encoded_len(value);
 
-	/* find the number of bits for SDVL-encoding */
-	if(value <= ROHC_SDVL_MAX_VALUE_IN_1_BYTE)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_2_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_3_BYTES)
+	if(sdvl_len > 4)
 	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
+		/* value is too large for SDVL-encoding */
+		goto error;
 	}
-	else
+	if(sdvl_bytes_max_nr < sdvl_len)
 	{
-		/* value is too large for SDVL-encoding */
+		/* number of bytes needed is too large for buffer */
 		goto error;
 	}
+	sdvl_write(sdvl_bytes, sdvl_len, value);
+	*sdvl_bytes_nr = sdvl_len;
 
-	return sdvl_encode(sdvl_bytes, sdvl_bytes_max_nr, sdvl_bytes_nr,
-	                   value, bits_nr);
+	return true;
 
 error:
 	return false;
@@ -324,6 +281,8 @@ size_t sdvl_decode(const uint8_t *const data,
                    size_t *const bits_nr)
 {
 	size_t sdvl_len;
+	uint32_t sdvl_value;
+	size_t i;
 
 	if(length < 1)
 	{
@@ -331,50 +290,21 @@ size_t sdvl_decode(const uint8_t *const data,
 		goto error;
 	}
 
-	if(!GET_BIT_7(data)) /* bit == 0 */
+	/* the prefix bits of the first byte give the length of the field */
+	sdvl_len = sdvl_len_by_prefix[data[0] >> 5];
+	if(length < sdvl_len)
 	{
-		*value = GET_BIT_0_6(data);
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-		sdvl_len = 1;
-	}
-	else if(GET_BIT_6_7(data) == (0x8 >> 2)) /* bits == 0b10 */
-	{
-		if(length < 2)
-		{
-			/* packet too small to decode SDVL field */
-			goto error;
-		}
-		*value = (GET_BIT_0_5(data) << 8 | GET_BIT_0_7(data + 1));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-		sdvl_len = 2;
-	}
-	else if(GET_BIT_5_7(data) == (0xc >> 1)) /* bits == 0b110 */
-	{
-		if(length < 3)
-		{
-			/* packet too small to decode SDVL field */
-			goto error;
-		}
-		*value = (GET_BIT_0_4(data) << 16 |
-		          GET_BIT_0_7(data + 1) << 8 |
-		          GET_BIT_0_7(data + 2));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-		sdvl_len = 3;
+		/* packet too small to decode SDVL field */
+		goto error;
 	}
-	else /* bits == 0b111 */
+
+	sdvl_value = data[0] & sdvl_first_byte_mask[sdvl_len];
+	for(i = 1; i < sdvl_len; i++)
 	{
-		if(length < 4)
-		{
-			/* packet too small to decode SDVL field */
-			goto error;
-		}
-		*value = (GET_BIT_0_4(data) << 24 |
-		          GET_BIT_0_7(data + 1) << 16 |
-		          GET_BIT_0_7(data + 2) << 8 |
-		          GET_BIT_0_7(data + 3));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
-		sdvl_len = 4;
+		sdvl_value = (sdvl_value << 8) | data[i];
 	}
+	*value = sdvl_value;
+	*bits_nr = sdvl_bits_by_len[sdvl_len];
 
 	return sdvl_len;
 
@@ -382,3 +312,26 @@ error:
 	return 0;
 }
 
+
+/**
+ * @brief Write the given value on the given number of SDVL bytes
+ *
+ * @param[out] sdvl_bytes  The SDVL-encoded bytes
+ * @param sdvl_len         The number of SDVL bytes to write, in range [1, 4]
+ * @param value            The value to encode
+ */
+static inline void sdvl_write(uint8_t *const sdvl_bytes,
+                              const size_t sdvl_len,
+                              const uint32_t value)
+{
+	size_t i;
+
+	assert(sdvl_len >= 1 && sdvl_len <= 4);
+
+	sdvl_bytes[0] = sdvl_first_byte_prefix[sdvl_len] |
+	                ((value >> ((sdvl_len - 1) * 8)) & sdvl_first_byte_mask[sdvl_len]);
+	for(i = 1; i < sdvl_len; i++)
+	{
+		sdvl_bytes[i] = (value >> ((sdvl_len - 1 - i) * 8)) & 0xff;
+	}
+}
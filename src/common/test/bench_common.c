@@ -0,0 +1,310 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    bench_common.c
+ * @brief   Microbenchmarks for the common encoding schemes
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * Measure the SDVL encoding and decoding, the CRC-3/7/8 and FCS-32
+ * computations, the Internet checksums, the LSB interpretation interval and
+ * the hash of the context fingerprints in isolation, so that optimizations of
+ * these kernels may be validated without the noise of the whole compression
+ * path.
+ *
+ * Every kernel is checked once before being measured, then one line is
+ * printed for each kernel:
+ *
+ *   BENCH  <kernel>  <operations>  <ns/operation>
+ */
+
+#include "sdvl.h"
+#include "crc.h"
+#include "interval.h"
+#include "ip.h"
+#include "hashtable.h"
+#include "rohc_fingerprint.h"
+#include "protocols/ip_numbers.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/** The default number of times every kernel is run */
+#define BENCH_ITERS_DEFAULT  200000U
+
+/** The number of distinct input values, shall be a power of 2 */
+#define BENCH_VALUES_NR  1024U
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+/** Run the given code the given number of times and print its mean duration */
+#define BENCH(name, iters_nr, ...) \
+	do { \
+		const uint64_t bench_start = bench_get_ns(); \
+		size_t i; \
+		for(i = 0; i < (iters_nr); i++) \
+		{ \
+			__VA_ARGS__; \
+		} \
+		bench_print(name, iters_nr, bench_get_ns() - bench_start); \
+	} while(0)
+
+
+/** Accumulate the kernel results so that the compiler cannot drop them */
+static volatile uint64_t bench_sink;
+
+
+static uint64_t bench_get_ns(void)
+	__attribute__((warn_unused_result));
+static void bench_print(const char *const name,
+                        const size_t ops_nr,
+                        const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Run the microbenchmarks of the common encoding schemes
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if all the kernels were checked and measured,
+ *              non-zero otherwise
+ */
+int main(int argc, char *argv[])
+{
+	static uint32_t values[BENCH_VALUES_NR];
+	static uint8_t sdvl_bufs[BENCH_VALUES_NR][5];
+	static size_t sdvl_lens[BENCH_VALUES_NR];
+	static uint8_t data[1500];
+	struct rohc_fingerprint fingerprints[2];
+	struct hashtable hashtable;
+	size_t iters_nr = BENCH_ITERS_DEFAULT;
+	uint64_t seed = 0x9e3779b97f4a7c15ULL;
+	int is_failure = 1;
+	size_t j;
+
+	if(argc == 2)
+	{
+		char *end;
+		iters_nr = strtoul(argv[1], &end, 10);
+		if(argv[1][0] == '\0' || (*end) != '\0' || iters_nr == 0)
+		{
+			fprintf(stderr, "bad number of iterations '%s'\n", argv[1]);
+			goto error;
+		}
+	}
+	else if(argc != 1)
+	{
+		printf("benchmark the common encoding schemes\n");
+		printf("usage: %s [ITERATIONS]\n", argv[0]);
+		goto error;
+	}
+
+	/* values of all the SDVL lengths, and pseudo-random data for the CRCs */
+	for(j = 0; j < BENCH_VALUES_NR; j++)
+	{
+		static const uint32_t masks[] = { 0x7f, 0x3fff, 0x1fffff, 0x1fffffff };
+		seed ^= seed >> 12;
+		seed ^= seed << 25;
+		seed ^= seed >> 27;
+		values[j] = ((uint32_t) (seed >> 32)) & masks[j % 4];
+	}
+	for(j = 0; j < sizeof(data); j++)
+	{
+		data[j] = (uint8_t) ((j * 151U + (j >> 8) * 17U) & 0xff);
+	}
+
+	/* SDVL: check the round trip, then measure both directions */
+	for(j = 0; j < BENCH_VALUES_NR; j++)
+	{
+		uint32_t decoded;
+		size_t bits_nr;
+		CHECK(sdvl_encode_full(sdvl_bufs[j], 5, &sdvl_lens[j], values[j]));
+		CHECK(sdvl_decode(sdvl_bufs[j], sdvl_lens[j], &decoded, &bits_nr) ==
+		      sdvl_lens[j]);
+		CHECK(decoded == values[j]);
+	}
+	BENCH("sdvl_encode_full", iters_nr,
+	      uint8_t buf[5];
+	      size_t len;
+	      CHECK(sdvl_encode_full(buf, 5, &len,
+	                             values[i & (BENCH_VALUES_NR - 1)]));
+	      bench_sink += buf[0] + len);
+	BENCH("sdvl_decode", iters_nr,
+	      const size_t k = i & (BENCH_VALUES_NR - 1);
+	      uint32_t decoded;
+	      size_t bits_nr;
+	      bench_sink += sdvl_decode(sdvl_bufs[k], sdvl_lens[k], &decoded,
+	                                &bits_nr) + decoded);
+
+	/* CRCs: the CRC-3/7/8 are computed on header-sized data, the FCS-32 on
+	 * both small and full-sized packets; the check values are the ones of
+	 * the well-known "123456789" string */
+	CHECK(crc_calculate(ROHC_CRC_TYPE_3, (const uint8_t *) "123456789", 9,
+	                    CRC_INIT_3) == 0x6);
+	CHECK(crc_calculate(ROHC_CRC_TYPE_7, (const uint8_t *) "123456789", 9,
+	                    CRC_INIT_7) == 0x53);
+	CHECK(crc_calculate(ROHC_CRC_TYPE_8, (const uint8_t *) "123456789", 9,
+	                    CRC_INIT_8) == 0xd0);
+	CHECK((~crc_calc_fcs32((const uint8_t *) "123456789", 9, CRC_INIT_FCS32))
+	      == 0xcbf43926);
+	BENCH("crc3_40bytes", iters_nr,
+	      bench_sink += crc_calculate(ROHC_CRC_TYPE_3, data + (i & 0xff), 40,
+	                                  CRC_INIT_3));
+	BENCH("crc7_40bytes", iters_nr,
+	      bench_sink += crc_calculate(ROHC_CRC_TYPE_7, data + (i & 0xff), 40,
+	                                  CRC_INIT_7));
+	BENCH("crc8_40bytes", iters_nr,
+	      bench_sink += crc_calculate(ROHC_CRC_TYPE_8, data + (i & 0xff), 40,
+	                                  CRC_INIT_8));
+	{
+		const uint8_t *bufs[16];
+		size_t lens[16];
+		uint8_t crcs[16];
+		for(j = 0; j < 16; j++)
+		{
+			bufs[j] = data + j * 16;
+			lens[j] = 40;
+		}
+		BENCH("crc7_40bytes_16lanes", iters_nr / 16,
+		      memset(crcs, CRC_INIT_7, 16);
+		      crc_calc_lanes(ROHC_CRC_TYPE_7, bufs, lens, crcs, 16);
+		      bench_sink += crcs[i & 0x0f]);
+	}
+	BENCH("fcs32_64bytes", iters_nr,
+	      bench_sink += crc_calc_fcs32(data + (i & 0xff), 64, CRC_INIT_FCS32));
+	BENCH("fcs32_1400bytes", iters_nr / 10,
+	      bench_sink += crc_calc_fcs32(data + (i & 0x3f), 1400, CRC_INIT_FCS32));
+
+	/* the Internet checksums of one IPv4 header and of a full-sized
+	 * payload */
+	CHECK(ip_csum_partial(0, (const uint8_t *) "\x01\x02\x03\x04", 4) == 0x0406);
+	BENCH("ipv4_csum_20bytes", iters_nr,
+	      bench_sink += ip_fast_csum(data + (i & 0xfc), 5));
+	BENCH("inet_csum_1400bytes", iters_nr / 10,
+	      bench_sink += ip_csum_partial(0, data + (i & 0x3f), 1400));
+
+	/* the LSB interpretation interval */
+	{
+		const struct rohc_interval32 interval = rohc_f_32bits(100, 4, 1);
+		CHECK(interval.min == 99 && interval.max == 114);
+	}
+	BENCH("rohc_f_32bits", iters_nr,
+	      const struct rohc_interval32 interval =
+	          rohc_f_32bits(values[i & (BENCH_VALUES_NR - 1)], 1 + (i % 32),
+	                        ROHC_LSB_SHIFT_SN);
+	      bench_sink += interval.min + interval.max);
+
+	/* the hash of the fingerprints of one IPv4/UDP and one IPv6/UDP flows */
+	memset(fingerprints, 0, sizeof(fingerprints));
+	fingerprints[0].src_port = 1234;
+	fingerprints[0].dst_port = 5678;
+	fingerprints[0].base.profile_id = ROHC_PROFILE_UDP;
+	fingerprints[0].base.ip_hdrs_nr = 1;
+	fingerprints[0].base.ip_hdrs[0].version = IPV4;
+	fingerprints[0].base.ip_hdrs[0].next_proto = ROHC_IPPROTO_UDP;
+	fingerprints[0].base.ip_hdrs[0].saddr.u32[0] = 0x0a000001;
+	fingerprints[0].base.ip_hdrs[0].daddr.u32[0] = 0x0a000002;
+	fingerprints[1] = fingerprints[0];
+	fingerprints[1].base.ip_hdrs[0].version = IPV6;
+	fingerprints[1].base.ip_hdrs[0].flow_label = 0x12345;
+	memset(fingerprints[1].base.ip_hdrs[0].saddr.u8, 0x20, 16);
+	memset(fingerprints[1].base.ip_hdrs[0].daddr.u8, 0x21, 16);
+	CHECK(hashtable_new(&hashtable, 0));
+	CHECK(hashtable_hash(&hashtable, &fingerprints[0],
+	                     rohc_fingerprint_len(&fingerprints[0])) !=
+	      hashtable_hash(&hashtable, &fingerprints[1],
+	                     rohc_fingerprint_len(&fingerprints[1])));
+	BENCH("fingerprint_hash", iters_nr,
+	      struct rohc_fingerprint *const fingerprint = &fingerprints[i & 1];
+	      fingerprint->src_port = (uint16_t) i;
+	      bench_sink += hashtable_hash(&hashtable, fingerprint,
+	                                   rohc_fingerprint_len(fingerprint)));
+	hashtable_set_hash(&hashtable, hashtable_siphash13, NULL);
+	BENCH("fingerprint_hash_siphash13", iters_nr,
+	      struct rohc_fingerprint *const fingerprint = &fingerprints[i & 1];
+	      fingerprint->src_port = (uint16_t) i;
+	      bench_sink += hashtable_hash(&hashtable, fingerprint,
+	                                   rohc_fingerprint_len(fingerprint)));
+	if(hashtable_aes_hash_available())
+	{
+		hashtable_set_hash(&hashtable, hashtable_aes_hash, NULL);
+		BENCH("fingerprint_hash_aes", iters_nr,
+		      struct rohc_fingerprint *const fingerprint = &fingerprints[i & 1];
+		      fingerprint->src_port = (uint16_t) i;
+		      bench_sink += hashtable_hash(&hashtable, fingerprint,
+		                                   rohc_fingerprint_len(fingerprint)));
+	}
+	hashtable_set_hash(&hashtable, hashtable_unkeyed_hash, NULL);
+	BENCH("fingerprint_hash_unkeyed", iters_nr,
+	      struct rohc_fingerprint *const fingerprint = &fingerprints[i & 1];
+	      fingerprint->src_port = (uint16_t) i;
+	      bench_sink += hashtable_hash(&hashtable, fingerprint,
+	                                   rohc_fingerprint_len(fingerprint)));
+	hashtable_free(&hashtable);
+
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t bench_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + ((uint64_t) now.tv_nsec);
+}
+
+
+/**
+ * @brief Print the mean duration of one kernel
+ *
+ * @param name         The name of the kernel
+ * @param ops_nr       The number of times the kernel was run
+ * @param duration_ns  The duration of all the runs (in nanoseconds)
+ */
+static void bench_print(const char *const name,
+                        const size_t ops_nr,
+                        const uint64_t duration_ns)
+{
+	printf("BENCH\t%s\t%zu\t%.2f\n", name, ops_nr,
+	       ops_nr == 0 ? 0.0 : ((double) duration_ns) / ((double) ops_nr));
+}
@@ -26,6 +26,7 @@
 #include "rohc_internal.h"
 #include <rohc/rohc_buf.h>
 #include "rohc_packets.h"
+#include "rohc_feedback_ring.h"
 #include "protocols/ip_numbers.h"
 #include "protocols/tcp.h"
 #include "protocols/rfc6846.h"
@@ -108,8 +109,12 @@ int main(int argc, char *argv[])
 		CHECK(strcmp(rohc_strerror(ROHC_STATUS_OUTPUT_TOO_SMALL), unknown) != 0);
 		CHECK(strcmp(rohc_strerror(ROHC_STATUS_ERROR), "") != 0);
 		CHECK(strcmp(rohc_strerror(ROHC_STATUS_ERROR), unknown) != 0);
+		CHECK(strcmp(rohc_strerror(ROHC_STATUS_NO_MEMORY), "") != 0);
+		CHECK(strcmp(rohc_strerror(ROHC_STATUS_NO_MEMORY), unknown) != 0);
+		CHECK(strcmp(rohc_strerror(ROHC_STATUS_TOO_LARGE), "") != 0);
+		CHECK(strcmp(rohc_strerror(ROHC_STATUS_TOO_LARGE), unknown) != 0);
 
-		CHECK(strcmp(rohc_strerror(ROHC_STATUS_ERROR + 1), unknown) == 0);
+		CHECK(strcmp(rohc_strerror(ROHC_STATUS_TOO_LARGE + 1), unknown) == 0);
 	}
 
 	/* rohc_get_mode_descr() */
@@ -719,6 +724,39 @@ int main(int argc, char *argv[])
 		CHECK(rohc_buf_is_empty(rbuf2) == true);
 	}
 
+	/* rohc_feedback_ring_new() and rohc_feedback_ring_free() */
+	{
+		struct rohc_feedback_ring *ring;
+		struct rohc_feedback_ring_slot *slot;
+		size_t i;
+
+		CHECK(rohc_feedback_ring_new(0) == NULL);
+		CHECK(rohc_feedback_ring_new(3) == NULL);
+		CHECK(rohc_feedback_ring_new(ROHC_FEEDBACK_RING_SLOTS_MAX * 2) == NULL);
+		rohc_feedback_ring_free(NULL);
+
+		ring = rohc_feedback_ring_new(4);
+		CHECK(ring != NULL);
+		CHECK(rohc_feedback_ring_peek(ring, 0) == NULL);
+		for(i = 0; i < 4; i++)
+		{
+			slot = rohc_feedback_ring_reserve(ring);
+			CHECK(slot != NULL);
+			slot->len = i;
+			rohc_feedback_ring_commit(ring);
+		}
+		CHECK(rohc_feedback_ring_reserve(ring) == NULL);
+		CHECK(rohc_feedback_ring_peek(ring, 3) != NULL);
+		CHECK(rohc_feedback_ring_peek(ring, 3)->len == 3);
+		CHECK(rohc_feedback_ring_peek(ring, 4) == NULL);
+		rohc_feedback_ring_release(ring, 1);
+		CHECK(rohc_feedback_ring_peek(ring, 0)->len == 1);
+		CHECK(rohc_feedback_ring_reserve(ring) != NULL);
+		rohc_feedback_ring_release(ring, 3);
+		CHECK(rohc_feedback_ring_peek(ring, 0) == NULL);
+		rohc_feedback_ring_free(ring);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_crc.c
+ * @brief   Test the CRC FCS-32 and header CRC computations
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "crc.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The size of the data used for the tests */
+#define DATA_LEN  2048U
+
+/** The maximum number of lanes used for the tests, more than one vector */
+#define LANES_MAX  20U
+
+
+/**
+ * @brief Compute the CRC FCS-32 bit per bit as a reference
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t crc_calc_fcs32_ref(const uint8_t *const data,
+                                   const size_t length,
+                                   const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+	size_t i;
+	size_t j;
+
+	for(i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for(j = 0; j < 8; j++)
+		{
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Compute the CRC-7 or CRC-8 one byte at a time as a reference
+ *
+ * @param table     The table of the CRC
+ * @param mask      The bits of the CRC
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The CRC
+ */
+static uint8_t crc_calc_bytewise_ref(const uint8_t table[256],
+                                     const uint8_t mask,
+                                     const uint8_t *const data,
+                                     const size_t length,
+                                     const uint8_t init_val)
+{
+	uint8_t crc = init_val;
+	size_t i;
+
+	for(i = 0; i < length; i++)
+	{
+		crc = table[data[i] ^ (crc & mask)];
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Test the CRC FCS-32 and header CRC computations
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static uint8_t data[DATA_LEN];
+	const uint8_t check_str[] = "123456789";
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t offset;
+	size_t len;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the CRC FCS-32 and header CRC computations\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(i = 0; i < DATA_LEN; i++)
+	{
+		data[i] = (uint8_t) ((i * 151U + (i >> 8) * 17U) & 0xff);
+	}
+
+	/* the well-known check value of CRC-32 */
+	CHECK((~crc_calc_fcs32(check_str, 9, CRC_INIT_FCS32)) == 0xcbf43926);
+	CHECK(crc_calc_fcs32(check_str, 0, CRC_INIT_FCS32) == CRC_INIT_FCS32);
+
+	/* all the lengths and alignments give the same result as the reference,
+	 * whatever the computation path used for them */
+	for(offset = 0; offset < 16; offset++)
+	{
+		for(len = 0; len <= 300 && (offset + len) <= DATA_LEN; len++)
+		{
+			CHECK(crc_calc_fcs32(data + offset, len, CRC_INIT_FCS32) ==
+			      crc_calc_fcs32_ref(data + offset, len, CRC_INIT_FCS32));
+		}
+	}
+	for(len = 300; len <= (DATA_LEN - 16); len += 61)
+	{
+		CHECK(crc_calc_fcs32(data + 3, len, 0x12345678) ==
+		      crc_calc_fcs32_ref(data + 3, len, 0x12345678));
+	}
+
+	/* the CRC may be computed in several steps */
+	for(len = 0; len <= DATA_LEN; len += 97)
+	{
+		const uint32_t crc = crc_calc_fcs32(data, len, CRC_INIT_FCS32);
+		CHECK(crc_calc_fcs32(data + len, DATA_LEN - len, crc) ==
+		      crc_calc_fcs32(data, DATA_LEN, CRC_INIT_FCS32));
+	}
+
+	/* the well-known check values of the header CRCs */
+	CHECK(crc_calculate(ROHC_CRC_TYPE_3, check_str, 9, CRC_INIT_3) == 0x6);
+	CHECK(crc_calculate(ROHC_CRC_TYPE_7, check_str, 9, CRC_INIT_7) == 0x53);
+	CHECK(crc_calculate(ROHC_CRC_TYPE_8, check_str, 9, CRC_INIT_8) == 0xd0);
+
+	/* the slicing-by-4 CRC-7 and CRC-8 give the same results as the CRCs
+	 * computed one byte at a time, whatever the lengths and alignments */
+	for(offset = 0; offset < 8; offset++)
+	{
+		for(len = 1; len <= 100; len++)
+		{
+			CHECK(crc_calculate(ROHC_CRC_TYPE_7, data + offset, len, CRC_INIT_7) ==
+			      crc_calc_bytewise_ref(crc_table_7, 0x7f, data + offset, len,
+			                            CRC_INIT_7));
+			CHECK(crc_calculate(ROHC_CRC_TYPE_8, data + offset, len, CRC_INIT_8) ==
+			      crc_calc_bytewise_ref(crc_table_8, 0xff, data + offset, len,
+			                            CRC_INIT_8));
+			CHECK(crc_calculate(ROHC_CRC_TYPE_8, data + offset, len, 0x5a) ==
+			      crc_calc_bytewise_ref(crc_table_8, 0xff, data + offset, len, 0x5a));
+		}
+	}
+
+	/* the header CRCs computed in lanes give the same results as the CRCs
+	 * computed one by one, whatever the number of lanes and their lengths */
+	{
+		const rohc_crc_type_t crc_types[] =
+			{ ROHC_CRC_TYPE_3, ROHC_CRC_TYPE_7, ROHC_CRC_TYPE_8 };
+		const uint8_t *bufs[LANES_MAX];
+		size_t lens[LANES_MAX];
+		uint8_t crcs[LANES_MAX];
+		size_t lanes_nr;
+		size_t type;
+		size_t lane;
+
+		for(type = 0; type < 3; type++)
+		{
+			for(lanes_nr = 1; lanes_nr <= LANES_MAX; lanes_nr++)
+			{
+				for(len = 0; len <= 100; len += 7)
+				{
+					for(lane = 0; lane < lanes_nr; lane++)
+					{
+						bufs[lane] = data + lane * 61;
+						lens[lane] = len + ((lane * 5) % 11) * (len % 3);
+						crcs[lane] = (uint8_t) ((lane * 37) & 0x7f);
+					}
+					crc_calc_lanes(crc_types[type], bufs, lens, crcs, lanes_nr);
+					for(lane = 0; lane < lanes_nr; lane++)
+					{
+						CHECK(crcs[lane] ==
+						      crc_calculate(crc_types[type], bufs[lane], lens[lane],
+						                    (uint8_t) ((lane * 37) & 0x7f)));
+					}
+				}
+			}
+		}
+
+		/* no CRC */
+		crcs[0] = 0x42;
+		crc_calc_lanes(ROHC_CRC_TYPE_NONE, bufs, lens, crcs, 1);
+		CHECK(crcs[0] == 0);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -65,6 +65,26 @@ uint64_t vectors[64] =
 	0x6ca4ecb15c5f91e1LLU, 0x9f626da15c9625f3LLU, 0xe51b38608ef25f57LLU, 0x958a324ceb064572LLU,
 };
 
+uint64_t vectors13[64] =
+{
+	0xabac0158050fc4dcLLU, 0xc9f49bf37d57ca93LLU, 0x82cb9b024dc7d44dLLU, 0x8bf80ab8e7ddf7fbLLU,
+	0xcf75576088d38328LLU, 0xdef9d52f49533b67LLU, 0xc50d2b50c59f22a7LLU, 0xd3927d989bb11140LLU,
+	0x369095118d299a8eLLU, 0x25a48eb36c063de4LLU, 0x79de85ee92ff097fLLU, 0x70c118c1f94dc352LLU,
+	0x78a384b157b4d9a2LLU, 0x306f760c1229ffa7LLU, 0x605aa111c0f95d34LLU, 0xd320d86d2a519956LLU,
+	0xcc4fdd1a7d908b66LLU, 0x9cf2689063dbd80cLLU, 0x8ffc389cb473e63eLLU, 0xf21f9de58d297d1cLLU,
+	0xc0dc2f46a6cce040LLU, 0xb992abfe2b45f844LLU, 0x7ffe7b9ba320872eLLU, 0x525a0e7fdae6c123LLU,
+	0xf464aeb267349c8cLLU, 0x45cd5928705b0979LLU, 0x3a3e35e3ca9913a5LLU, 0xa91dc74e4ade3b35LLU,
+	0xfb0bed02ef6cd00dLLU, 0x88d93cb44ab1e1f4LLU, 0x540f11d643c5e663LLU, 0x2370dd1f8c21d1bcLLU,
+	0x81157b6c16a7b60dLLU, 0x4d54b9e57a8ff9bfLLU, 0x759f12781f2a753eLLU, 0xcea1a3bebf186b91LLU,
+	0x2cf508d3ada26206LLU, 0xb6101c2da3c33057LLU, 0xb3f47496ae3a36a1LLU, 0x626b57547b108392LLU,
+	0xc1d2363299e41531LLU, 0x667cc1923f1ad944LLU, 0x65704ffec8138825LLU, 0x24f280d1c28949a6LLU,
+	0xc2ca1cedfaf8876bLLU, 0xc2164bfc9f042196LLU, 0xa16e9c9368b1d623LLU, 0x49fb169c8b5114fdLLU,
+	0x9f3143f8df074c46LLU, 0xc6fdaf2412cc86b3LLU, 0x7eaf49d10a52098fLLU, 0x1cf313559d292f9aLLU,
+	0xc44a30dda2f41f12LLU, 0x36fae98943a71ed0LLU, 0x318fb34c73f0bce6LLU, 0xa27abf3670a7e980LLU,
+	0xb4bcc0db243c6d75LLU, 0x23f8d852fdb71513LLU, 0x8f035f4da67d8a08LLU, 0xd89cd0e5b7e8f148LLU,
+	0xf6f4e6bcf7a644eeLLU, 0xaec59ad80f1837f2LLU, 0xc3b2f6154b6694e0LLU, 0x9d199062b7bbb3a8LLU,
+};
+
 
 int main(void)
 {
@@ -79,11 +99,12 @@ int main(void)
 	for (j=0; j<REPEATS; j++){
 		for (i=0; i<64; i++) {
 			assert(siphash24(plaintext, i, key) == vectors[i]);
+			assert(siphash13(plaintext, i, key) == vectors13[i]);
 		}
 	}
 	t1 = gettime_ns();
 
-	printf("%i tests passed in %.3fms, %.0fns per test\n", REPEATS*64, (t1-t0)/1000000., (t1-t0)/(REPEATS*64.));
+	printf("%i tests passed in %.3fms, %.0fns per test\n", REPEATS*128, (t1-t0)/1000000., (t1-t0)/(REPEATS*128.));
 	return 0;
 }
 
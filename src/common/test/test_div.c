@@ -0,0 +1,151 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_div.c
+ * @brief   Test the division of 32-bit values with precomputed inverses
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_div.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Check the division of several values by the given divisor
+ *
+ * @param divisor  The divisor
+ * @return         true if all quotients and remainders are correct
+ */
+static bool test_divisor(const uint32_t divisor)
+{
+	const uint32_t values[] = {
+		0, 1, 2, 3, 159, 160, 161, 0x7fffffff, 0x80000000, 0x80000001,
+		0xfffffffe, 0xffffffff, divisor - 1, divisor, divisor + 1,
+		divisor * 2 - 1, divisor * 2, 0xffffffff - divisor,
+		0xffffffff / divisor * divisor, 0xffffffff / divisor * divisor - 1
+	};
+	struct rohc_div32 div;
+	uint32_t value;
+	size_t i;
+
+	rohc_div32_init(&div, divisor);
+
+	for(i = 0; i < (sizeof(values) / sizeof(uint32_t)); i++)
+	{
+		if(rohc_div32_quot(values[i], &div) != (values[i] / divisor) ||
+		   rohc_div32_rem(values[i], &div) != (values[i] % divisor))
+		{
+			return false;
+		}
+	}
+	for(value = 0x12345; value < 0xfff00000; value += 0x7f4a7c15)
+	{
+		if(rohc_div32_quot(value, &div) != (value / divisor) ||
+		   rohc_div32_rem(value, &div) != (value % divisor))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Test the division of 32-bit values with precomputed inverses
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	uint32_t divisor;
+	size_t shift;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the division of 32-bit values with precomputed inverses\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* all small divisors, among them the usual RTP TS strides */
+	for(divisor = 1; divisor <= 70000; divisor++)
+	{
+		CHECK(test_divisor(divisor));
+	}
+
+	/* powers of 2 and their neighbours */
+	for(shift = 1; shift < 32; shift++)
+	{
+		CHECK(test_divisor((((uint32_t) 1) << shift) - 1));
+		CHECK(test_divisor(((uint32_t) 1) << shift));
+		CHECK(test_divisor((((uint32_t) 1) << shift) + 1));
+	}
+
+	/* some large divisors */
+	for(divisor = 0x7fff0000; divisor < 0xfff00000; divisor += 0x0099f1b3)
+	{
+		CHECK(test_divisor(divisor));
+	}
+	CHECK(test_divisor(0xffffffff));
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
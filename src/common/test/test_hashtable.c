@@ -0,0 +1,194 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_hashtable.c
+ * @brief   Test the hash table
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "hashtable.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The number of elements used for the tests */
+#define ELEMS_NR  1000U
+
+/** One element of the hash table */
+struct elem
+{
+	int value;
+	uint32_t key;
+	uint32_t group;
+};
+
+
+/**
+ * @brief Test the hash table
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static struct elem elems[ELEMS_NR];
+	struct hashtable hashtable;
+	struct hashtable groups;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t found_nr;
+	struct elem *e;
+	uint32_t key;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the hash table\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		elems[i].value = i;
+		elems[i].key = i * 7;
+		elems[i].group = i % 10;
+	}
+
+	/* table with one element per key */
+	CHECK(hashtable_new(&hashtable, offsetof(struct elem, key)) == true);
+	memset(hashtable.key, 0x42, sizeof(hashtable.key));
+	key = 0;
+	CHECK(hashtable_get(&hashtable, &key, sizeof(key)) == NULL);
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		CHECK(hashtable_add(&hashtable, &elems[i].key, sizeof(uint32_t),
+		                    &elems[i]) == true);
+	}
+	CHECK(hashtable.elems_nr == ELEMS_NR);
+	CHECK((hashtable.mask + 1) >= (2 * ELEMS_NR));
+	/* adding the same element again does nothing */
+	CHECK(hashtable_add(&hashtable, &elems[3].key, sizeof(uint32_t),
+	                    &elems[3]) == true);
+	CHECK(hashtable.elems_nr == ELEMS_NR);
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		key = i * 7;
+		CHECK(hashtable_get(&hashtable, &key, sizeof(key)) == &elems[i]);
+		key = i * 7 + 1;
+		CHECK(hashtable_get(&hashtable, &key, sizeof(key)) == NULL);
+	}
+	/* remove every other element, the remaining ones shall still be found */
+	for(i = 0; i < ELEMS_NR; i += 2)
+	{
+		hashtable_del(&hashtable, &elems[i].key, sizeof(uint32_t), &elems[i]);
+	}
+	CHECK(hashtable.elems_nr == (ELEMS_NR / 2));
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		key = i * 7;
+		e = hashtable_get(&hashtable, &key, sizeof(key));
+		CHECK(e == ((i % 2) == 0 ? NULL : &elems[i]));
+	}
+	/* removing an element that is not in the table does nothing */
+	hashtable_del(&hashtable, &elems[0].key, sizeof(uint32_t), &elems[0]);
+	CHECK(hashtable.elems_nr == (ELEMS_NR / 2));
+	hashtable_free(&hashtable);
+
+	/* table with several elements per key */
+	CHECK(hashtable_new(&groups, offsetof(struct elem, group)) == true);
+	memset(groups.key, 0x24, sizeof(groups.key));
+	for(i = 0; i < ELEMS_NR; i++)
+	{
+		CHECK(hashtable_add(&groups, &elems[i].group, sizeof(uint32_t),
+		                    &elems[i]) == true);
+	}
+	for(key = 0; key < 10; key++)
+	{
+		found_nr = 0;
+		for(e = hashtable_get(&groups, &key, sizeof(key));
+		    e != NULL;
+		    e = hashtable_get_next(&groups, &key, sizeof(key), e))
+		{
+			CHECK(e->group == key);
+			found_nr++;
+		}
+		CHECK(found_nr == (ELEMS_NR / 10));
+	}
+	for(i = 0; i < ELEMS_NR; i += 3)
+	{
+		hashtable_del(&groups, &elems[i].group, sizeof(uint32_t), &elems[i]);
+	}
+	found_nr = 0;
+	for(key = 0; key < 10; key++)
+	{
+		for(e = hashtable_get(&groups, &key, sizeof(key));
+		    e != NULL;
+		    e = hashtable_get_next(&groups, &key, sizeof(key), e))
+		{
+			CHECK(e->group == key);
+			CHECK((e->value % 3) != 0);
+			found_nr++;
+		}
+	}
+	CHECK(found_nr == groups.elems_nr);
+	CHECK(found_nr == (ELEMS_NR - (ELEMS_NR + 2) / 3));
+	hashtable_free(&groups);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
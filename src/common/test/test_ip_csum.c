@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_ip_csum.c
+ * @brief   Test the Internet checksum computations
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "ip.h"
+#include "rohc_utils.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The size of the data used for the tests */
+#define DATA_LEN  2048U
+
+
+/**
+ * @brief Compute an Internet checksum one 16-bit word at a time as a reference
+ *
+ * @param sum   The checksum being computed, not folded
+ * @param data  The bytes to add to the checksum
+ * @param len   The number of bytes
+ * @return      The updated checksum, folded
+ */
+static uint16_t ip_csum_ref(uint32_t sum,
+                            const uint8_t *const data,
+                            const size_t len)
+{
+	size_t i;
+
+	for(i = 0; i < len; i++)
+	{
+		sum += ((i % 2) == 0 ? (data[i] << 8) : data[i]);
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t) sum;
+}
+
+
+/**
+ * @brief Fold an Internet checksum on 16 bits
+ *
+ * @param sum  The checksum, not folded
+ * @return     The folded checksum
+ */
+static uint16_t ip_csum_fold(uint32_t sum)
+{
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return (uint16_t) sum;
+}
+
+
+/**
+ * @brief Test the Internet checksum computations
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static uint8_t data[DATA_LEN];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t offset;
+	size_t len;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the Internet checksum computations\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(i = 0; i < DATA_LEN; i++)
+	{
+		data[i] = (uint8_t) ((i * 151U + (i >> 8) * 17U) & 0xff);
+	}
+
+	/* a well-known IPv4 header, with its Checksum field set to zero */
+	{
+		const uint8_t ipv4[] = {
+			0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00,
+			0x40, 0x11, 0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01,
+			0xc0, 0xa8, 0x00, 0xc7,
+		};
+
+		CHECK(((~ip_csum_fold(ip_csum_partial(0, ipv4, sizeof(ipv4)))) & 0xffff) ==
+		      0xb861);
+		CHECK(ip_fast_csum(ipv4, 5) == rohc_hton16(0xb861));
+	}
+
+	/* all the lengths and alignments give the same result as the reference,
+	 * whatever the computation path used for them */
+	for(offset = 0; offset < 16; offset++)
+	{
+		for(len = 0; len <= 300 && (offset + len) <= DATA_LEN; len++)
+		{
+			CHECK(ip_csum_fold(ip_csum_partial(0, data + offset, len)) ==
+			      ip_csum_ref(0, data + offset, len));
+			CHECK(ip_csum_fold(ip_csum_partial(0x1234, data + offset, len)) ==
+			      ip_csum_ref(0x1234, data + offset, len));
+		}
+	}
+	for(len = 300; len <= (DATA_LEN - 16); len += 61)
+	{
+		CHECK(ip_csum_fold(ip_csum_partial(0x7fffffff, data + 3, len)) ==
+		      ip_csum_ref(0x7fffffff, data + 3, len));
+	}
+
+	/* the checksum may be computed in several steps of even lengths */
+	for(len = 0; len <= DATA_LEN; len += 98)
+	{
+		const uint32_t sum = ip_csum_partial(0, data, len);
+		CHECK(ip_csum_fold(ip_csum_partial(sum, data + len, DATA_LEN - len)) ==
+		      ip_csum_fold(ip_csum_partial(0, data, DATA_LEN)));
+	}
+
+	/* the data full of zeroes and full of ones */
+	memset(data, 0x00, DATA_LEN);
+	CHECK(ip_csum_fold(ip_csum_partial(0, data, DATA_LEN)) == 0x0000);
+	memset(data, 0xff, DATA_LEN);
+	CHECK(ip_csum_fold(ip_csum_partial(0, data, DATA_LEN)) == 0xffff);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_trace_ring.c
+ * @brief   Test the ring of binary trace records
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The number of records of the ring used for the tests */
+#define RECORDS_NR  8U
+
+/** The number of traces recorded in the ring, more than its records */
+#define TRACES_NR  20U
+
+/** The messages expanded from the ring */
+struct expanded
+{
+	size_t msgs_nr;
+	char msgs[RECORDS_NR][1024];
+	rohc_trace_level_t levels[RECORDS_NR];
+	rohc_trace_entity_t entities[RECORDS_NR];
+	int profiles[RECORDS_NR];
+};
+
+static void print_expanded(void *const priv_ctxt,
+                           const uint64_t time_ns,
+                           const rohc_trace_level_t level,
+                           const rohc_trace_entity_t entity,
+                           const int profile,
+                           const char *const msg)
+	__attribute__((nonnull(1, 6)));
+
+
+/**
+ * @brief Test the ring of binary trace records
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static struct expanded expanded;
+	static const char long_str[] =
+		"0123456789012345678901234567890123456789012345678901234567890123456789"
+		"0123456789012345678901234567890123456789";
+	struct rohc_trace_ring *ring;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	char expected[1024];
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the ring of binary trace records\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* the number of records shall be a non-zero power of 2 */
+	CHECK(rohc_trace_ring_new(0) == NULL);
+	CHECK(rohc_trace_ring_new(3) == NULL);
+	CHECK(rohc_trace_ring_new(2 * 1048576) == NULL);
+	ring = rohc_trace_ring_new(RECORDS_NR);
+	CHECK(ring != NULL);
+
+	/* an empty ring expands nothing */
+	CHECK(rohc_trace_ring_expand(ring, print_expanded, &expanded) == 0);
+
+	/* record more traces than the ring holds, only the last ones remain */
+	for(i = 0; i < TRACES_NR; i++)
+	{
+		rohc_trace_ring_cb(ring, ROHC_TRACE_DEBUG, ROHC_TRACE_COMP,
+		                   ROHC_PROFILE_RTP, "[%s:%d %s()] value %u %zu %s %%\n",
+		                   "file.c", 42, "func", (unsigned int) i, i * 1000,
+		                   (i % 2) ? "odd" : "even");
+	}
+	CHECK(rohc_trace_ring_expand(ring, print_expanded, &expanded) == RECORDS_NR);
+	CHECK(expanded.msgs_nr == RECORDS_NR);
+	for(i = 0; i < RECORDS_NR; i++)
+	{
+		const size_t n = TRACES_NR - RECORDS_NR + i;
+
+		snprintf(expected, sizeof(expected),
+		         "[file.c:42 func()] value %zu %zu %s %%\n", n, n * 1000,
+		         (n % 2) ? "odd" : "even");
+		trace(verbose, "%s", expanded.msgs[i]);
+		CHECK(strcmp(expanded.msgs[i], expected) == 0);
+		CHECK(expanded.levels[i] == ROHC_TRACE_DEBUG);
+		CHECK(expanded.entities[i] == ROHC_TRACE_COMP);
+		CHECK(expanded.profiles[i] == ROHC_PROFILE_RTP);
+	}
+
+	/* flags, width, precision and length modifiers are kept */
+	rohc_trace_ring_cb(ring, ROHC_TRACE_WARNING, ROHC_TRACE_DECOMP,
+	                   ROHC_PROFILE_UDP, "%-4d|%04x|%hhu|%hd|%ld|%.3s|%c\n",
+	                   -5, 0xabU, 257U, 65535, -70000L, "abcdef", 'z');
+	memset(&expanded, 0, sizeof(struct expanded));
+	CHECK(rohc_trace_ring_expand(ring, print_expanded, &expanded) == RECORDS_NR);
+	trace(verbose, "%s", expanded.msgs[RECORDS_NR - 1]);
+	CHECK(strcmp(expanded.msgs[RECORDS_NR - 1],
+	             "-5  |00ab|1|-1|-70000|abc|z\n") == 0);
+	CHECK(expanded.levels[RECORDS_NR - 1] == ROHC_TRACE_WARNING);
+	CHECK(expanded.entities[RECORDS_NR - 1] == ROHC_TRACE_DECOMP);
+	CHECK(expanded.profiles[RECORDS_NR - 1] == ROHC_PROFILE_UDP);
+
+	/* the arguments beyond the recorded ones are marked as missing */
+	rohc_trace_ring_cb(ring, ROHC_TRACE_DEBUG, ROHC_TRACE_COMP,
+	                   ROHC_PROFILE_IP, "%d %d %d %d %d %d %d %d %d %d\n",
+	                   1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+	rohc_trace_ring_cb(ring, ROHC_TRACE_DEBUG, ROHC_TRACE_COMP,
+	                   ROHC_PROFILE_IP, "ratio %u %f\n", 3U, 0.5);
+	memset(&expanded, 0, sizeof(struct expanded));
+	CHECK(rohc_trace_ring_expand(ring, print_expanded, &expanded) == RECORDS_NR);
+	trace(verbose, "%s", expanded.msgs[RECORDS_NR - 2]);
+	CHECK(strcmp(expanded.msgs[RECORDS_NR - 2], "1 2 3 4 5 6 7 8 [...]\n") == 0);
+	trace(verbose, "%s", expanded.msgs[RECORDS_NR - 1]);
+	CHECK(strcmp(expanded.msgs[RECORDS_NR - 1], "ratio 3 [...]\n") == 0);
+
+	/* the string arguments are truncated once the record is full */
+	rohc_trace_ring_cb(ring, ROHC_TRACE_DEBUG, ROHC_TRACE_COMP,
+	                   ROHC_PROFILE_IP, "%s|%s|%s\n", "first", long_str, "last");
+	memset(&expanded, 0, sizeof(struct expanded));
+	CHECK(rohc_trace_ring_expand(ring, print_expanded, &expanded) == RECORDS_NR);
+	trace(verbose, "%s", expanded.msgs[RECORDS_NR - 1]);
+	snprintf(expected, sizeof(expected), "first|%.89s|\n", long_str);
+	CHECK(strcmp(expanded.msgs[RECORDS_NR - 1], expected) == 0);
+
+	rohc_trace_ring_free(ring);
+
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Store one message expanded from the ring of binary trace records
+ *
+ * @param priv_ctxt  The messages expanded from the ring
+ * @param time_ns    The time of the trace
+ * @param level      The level of the trace
+ * @param entity     The entity concerned by the trace
+ * @param profile    The number of the profile concerned by the trace
+ * @param msg        The text message of the trace
+ */
+static void print_expanded(void *const priv_ctxt,
+                           const uint64_t time_ns __attribute__((unused)),
+                           const rohc_trace_level_t level,
+                           const rohc_trace_entity_t entity,
+                           const int profile,
+                           const char *const msg)
+{
+	struct expanded *const expanded = priv_ctxt;
+
+	assert(expanded->msgs_nr < RECORDS_NR);
+	strncpy(expanded->msgs[expanded->msgs_nr], msg, 1023);
+	expanded->msgs[expanded->msgs_nr][1023] = '\0';
+	expanded->levels[expanded->msgs_nr] = level;
+	expanded->entities[expanded->msgs_nr] = entity;
+	expanded->profiles[expanded->msgs_nr] = profile;
+	expanded->msgs_nr++;
+}
@@ -127,7 +127,8 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->sn);
 
 	/* create the ESP part of the profile context */
-	esp_context = malloc(sizeof(struct sc_esp_context));
+	esp_context = rohc_mempool_alloc(&context->compressor->mempool,
+	                                 sizeof(struct sc_esp_context));
 	if(esp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -135,6 +136,7 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 		goto clean;
 	}
 	rfc3095_ctxt->specific = esp_context;
+	rfc3095_ctxt->specific_len = sizeof(struct sc_esp_context);
 
 	/* initialize the ESP part of the profile context */
 	memcpy(&(esp_context->old_esp), uncomp_pkt_hdrs->esp, sizeof(struct esphdr));
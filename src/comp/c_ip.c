@@ -106,7 +106,7 @@ rohc_packet_t c_ip_decide_FO_packet(const struct rohc_comp_ctxt *const context)
 {
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(const struct rohc_comp_rfc3095_ctxt *const) context->specific;
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	rohc_packet_t packet;
 
 	if(does_at_least_one_sid_change(rfc3095_ctxt, oa_repetitions_nr))
@@ -156,7 +156,7 @@ rohc_packet_t c_ip_decide_FO_packet(const struct rohc_comp_ctxt *const context)
  */
 rohc_packet_t c_ip_decide_SO_packet(const struct rohc_comp_ctxt *const context)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const struct rfc3095_ip_hdr_changes *inner_ip_changes;
@@ -181,7 +181,7 @@ rohc_packet_t c_ip_decide_SO_packet(const struct rohc_comp_ctxt *const context)
 			}
 		}
 	}
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		inner_ip_changes = &rfc3095_ctxt->tmp.ip_hdr_changes[0];
 		outer_ip_changes = NULL;
@@ -228,7 +228,7 @@ rohc_packet_t c_ip_decide_SO_packet(const struct rohc_comp_ctxt *const context)
 		                "TOS/TC, TTL/HL, DF, IP ext list, NBO, RND fields changed "
 		                "for inner IP header");
 	}
-	else if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	else if(rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt) &&
 	        (outer_ip_changes->tos_tc_changed ||
 	         outer_ip_changes->ttl_hl_changed ||
 	         outer_ip_changes->df_changed ||
@@ -360,7 +360,7 @@ static bool max_6_bits_of_innermost_nonrnd_ipv4_id_required(const struct rohc_co
 {
 	bool is_possible;
 
-	if(ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(ctxt))
 	{
 		is_possible = (ctxt->ip_ctxts[0].version == IPV4 &&
 		               ctxt->ip_ctxts[0].info.v4.rnd != 1 &&
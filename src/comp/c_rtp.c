@@ -32,6 +32,7 @@
 #include "rohc_traces_internal.h"
 #include "rohc_packets.h"
 #include "rohc_utils.h"
+#include "rohc_time_internal.h"
 #include "sdvl.h"
 #include "crc.h"
 
@@ -137,7 +138,8 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->sn);
 
 	/* create the RTP part of the profile context */
-	rtp_context = malloc(sizeof(struct sc_rtp_context));
+	rtp_context = rohc_mempool_alloc(&context->compressor->mempool,
+	                                 sizeof(struct sc_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -145,6 +147,7 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 		goto clean;
 	}
 	rfc3095_ctxt->specific = rtp_context;
+	rfc3095_ctxt->specific_len = sizeof(struct sc_rtp_context);
 
 	/* initialize the RTP part of the profile context */
 	rtp_context->udp_checksum_change_count = 0;
@@ -160,12 +163,26 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rtp_context->old_rtp_pt = uncomp_pkt_hdrs->rtp->pt;
 	if(!c_create_sc(&rtp_context->ts_sc,
 	                context->compressor->oa_repetitions_nr,
+	                &context->compressor->mempool,
 	                context->compressor->trace_callback,
-	                context->compressor->trace_callback_priv))
+	                context->compressor->trace_callback_priv,
+	                context->compressor->trace_level))
 	{
 		rohc_comp_warn(context, "cannot create scaled RTP Timestamp encoding");
 		goto clean;
 	}
+	if(context->compressor->rtp_ts_strides != NULL)
+	{
+		/* the TS_STRIDE of the stream may be known from its payload type */
+		c_ts_sc_set_stride_hint(&rtp_context->ts_sc,
+		                        context->compressor->rtp_ts_strides[uncomp_pkt_hdrs->rtp->pt]);
+	}
+	if((context->compressor->features & ROHC_COMP_FEATURE_TIMER_BASED_TS) != 0)
+	{
+		/* the decompressor may approximate TS from the arrival times */
+		c_ts_sc_enable_timer(&rtp_context->ts_sc,
+		                     context->compressor->ts_timer_jitter);
+	}
 
 	/* init the RTP-specific temporary variables */
 	rtp_context->tmp.send_rtp_dynamic = 0;
@@ -243,7 +260,7 @@ static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *const c
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const struct sc_rtp_context *const rtp_context =
 		(struct sc_rtp_context *) rfc3095_ctxt->specific;
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	rohc_packet_t packet;
 
 	if(rtp_context->udp_checksum_change_count < oa_repetitions_nr)
@@ -320,7 +337,7 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *const c
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const struct sc_rtp_context *const rtp_context =
 		(struct sc_rtp_context *) rfc3095_ctxt->specific;
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const size_t nr_of_ip_hdr = rfc3095_ctxt->ip_hdr_nr;
 	const bool rnd_changed =
 		does_at_least_one_rnd_change(rfc3095_ctxt, oa_repetitions_nr);
@@ -340,7 +357,9 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *const c
 	bool is_ts_scaled;
 
 	is_ts_deducible = rohc_ts_sc_is_deducible(&rtp_context->ts_sc);
-	is_ts_scaled = (rtp_context->ts_sc.state == SEND_SCALED);
+	/* TIME_STRIDE is transmitted in extension 3 only */
+	is_ts_scaled = (rtp_context->ts_sc.state == SEND_SCALED &&
+	                !rohc_ts_sc_send_time_stride(&rtp_context->ts_sc));
 
 	rohc_comp_debug(context, "is_ts_deducible = %d, is_ts_scaled = %d, "
 	                "Marker bit = %d, nr_of_ip_hdr = %zu",
@@ -371,7 +390,7 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *const c
 	                   &outermost_ip_id_changed,
 	                   &outermost_ip_id_11bits_possible);
 
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		inner_ip_changes = &rfc3095_ctxt->tmp.ip_hdr_changes[0];
 		outer_ip_changes = NULL;
@@ -605,7 +624,8 @@ static rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *const cont
 	rtp_context = (struct sc_rtp_context *) rfc3095_ctxt->specific;
 
 	/* force extension type 3 if at least one RTP dynamic field changed
-	 *                     OR if TS cannot be transmitted scaled */
+	 *                     OR if TS cannot be transmitted scaled
+	 *                     OR if TIME_STRIDE shall be transmitted */
 	if(rtp_context->tmp.send_rtp_dynamic > 0)
 	{
 		rohc_comp_debug(context, "force EXT-3 because at least one RTP dynamic "
@@ -618,6 +638,12 @@ static rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *const cont
 		                "scaled");
 		ext = ROHC_EXT_3;
 	}
+	else if(rohc_ts_sc_send_time_stride(&rtp_context->ts_sc))
+	{
+		rohc_comp_debug(context, "force EXT-3 because TIME_STRIDE shall be "
+		                "transmitted");
+		ext = ROHC_EXT_3;
+	}
 	else
 	{
 		/* fallback on the algorithm shared by all IP-based profiles */
@@ -741,12 +767,13 @@ static void rtp_decide_state(struct rohc_comp_ctxt *const context)
 	}
 
 	/* force initializing TS, TS_STRIDE and TS_SCALED again after
-	 * transition back to IR */
+	 * transition back to IR, TIME_STRIDE as well */
 	if(context->state == ROHC_COMP_STATE_IR &&
 	   rtp_context->ts_sc.state > INIT_STRIDE)
 	{
 		rtp_context->ts_sc.state = INIT_STRIDE;
 		rtp_context->ts_sc.nr_init_stride_packets = 0;
+		c_ts_sc_resend_time_stride(&rtp_context->ts_sc);
 	}
 }
 
@@ -788,6 +815,7 @@ static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 	assert(rfc3095_ctxt->sn <= 0xffff);
 	c_add_ts(&rtp_context->ts_sc, rohc_ntoh32(uncomp_pkt_hdrs->rtp->timestamp),
 	         rfc3095_ctxt->sn);
+	c_ts_sc_add_time(&rtp_context->ts_sc, rohc_time_ms32(context->latest_used));
 
 	/* determine the number of TS bits to send wrt compression state */
 	if(rtp_context->ts_sc.state == INIT_TS ||
@@ -916,7 +944,7 @@ static size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const contex
 
 \endverbatim
  *
- * Parts 6 & 9 are not supported yet. The TIS flag in part 7 is not supported.
+ * Part 6 is not supported yet.
  *
  * @param context     The compression context
  * @param next_header The UDP/RTP headers
@@ -933,7 +961,7 @@ static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const conte
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	struct sc_rtp_context *const rtp_context =
 		(struct sc_rtp_context *) rfc3095_ctxt->specific;
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct udphdr *const udp = (struct udphdr *) next_header;
 	const struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
 	uint8_t byte;
@@ -952,10 +980,11 @@ static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const conte
 	/* part 2 */
 	byte = 0;
 	if(rtp_context->ts_sc.state == INIT_STRIDE ||
+	   rohc_ts_sc_send_time_stride(&rtp_context->ts_sc) ||
 	   rtp_context->tmp.ext_bit_changed ||
 	   rtp_context->rtp_extension_change_count < oa_repetitions_nr)
 	{
-		/* send TS_STRIDE and/or the eXtension (X) bit */
+		/* send TS_STRIDE, TIME_STRIDE and/or the eXtension (X) bit */
 		rx_byte = 1;
 		byte |= 1 << 4;
 	}
@@ -1016,15 +1045,13 @@ static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const conte
 		int tss;
 
 		/* part 7 */
-		tis = 0; /* TIS flag not supported yet */
+		tis = rohc_ts_sc_send_time_stride(&rtp_context->ts_sc);
 		tss = (rtp_context->ts_sc.state == INIT_STRIDE);
 
 		byte = 0;
 		byte |= (rtp->extension & 0x01) << 4;
 		byte |= (context->mode & 0x03) << 2;
-#if 0 /* TODO: handle TIS */
 		byte |= (tis & 0x01) << 1;
-#endif
 		byte |= tss & 0x01;
 		dest[counter + nr_written] = byte;
 		rohc_comp_debug(context, "(X = %u, Mode = %u, TIS = %u, TSS = %u) = 0x%02x",
@@ -1082,7 +1109,26 @@ static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const conte
 			}
 		}
 
-		/* part 9 not supported yet */
+		/* part 9 */
+		if(tis)
+		{
+			const uint32_t time_stride = rtp_context->ts_sc.time_stride;
+			size_t time_stride_sdvl_len;
+
+			/* TIME_STRIDE was checked for SDVL encoding when estimated */
+			if(!sdvl_encode_full(dest + counter + nr_written, 4U /* TODO */,
+			                     &time_stride_sdvl_len, time_stride))
+			{
+				rohc_comp_warn(context, "failed to SDVL-encode TIME_STRIDE %u",
+				               time_stride);
+				assert(0);
+			}
+			rohc_comp_debug(context, "send TIME_STRIDE = %u ms encoded with SDVL "
+			                "on %zu bytes", time_stride, time_stride_sdvl_len);
+			nr_written += time_stride_sdvl_len;
+
+			c_ts_sc_time_stride_sent(&rtp_context->ts_sc, oa_repetitions_nr);
+		}
 	}
 
 	return counter + nr_written;
@@ -1105,7 +1151,7 @@ static size_t rtp_changed_rtp_dynamic(const struct rohc_comp_ctxt *const context
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	struct sc_rtp_context *const rtp_context =
 		(struct sc_rtp_context *) rfc3095_ctxt->specific;
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	size_t fields = 0;
 
 	rohc_comp_debug(context, "find changes in RTP dynamic fields");
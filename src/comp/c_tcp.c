@@ -111,7 +111,14 @@ static bool tcp_detect_changes_tcp_hdr(struct rohc_comp_ctxt *const context,
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                        struct tcp_tmp_variables *const tmp)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
-
+static void tcp_detect_pure_ack(struct rohc_comp_ctxt *const context,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                const struct tcp_tmp_variables *const tmp)
+	__attribute__((nonnull(1, 2, 3)));
+static void tcp_detect_changes_summary(const struct rohc_comp_ctxt *const context,
+                                       const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                       struct tcp_tmp_variables *const tmp)
+	__attribute__((nonnull(1, 2, 3)));
 
 static void tcp_decide_state(struct rohc_comp_ctxt *const context,
                              struct rohc_ts pkt_time)
@@ -132,6 +139,11 @@ static rohc_packet_t tcp_decide_SO_packet(const struct rohc_comp_ctxt *const con
                                           const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                           const struct tcp_tmp_variables *const tmp)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+static bool tcp_decide_pure_ack_packet(const struct rohc_comp_ctxt *const context,
+                                       const ip_context_t *const ip_inner_context,
+                                       const struct tcp_tmp_variables *const tmp,
+                                       rohc_packet_t *const packet_type)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const context,
                                              const ip_context_t *const ip_inner_context,
                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -400,6 +412,9 @@ static void c_tcp_feedback_ack(struct rohc_comp_ctxt *const context,
                                const size_t sn_bits_nr,
                                const bool sn_not_valid)
 	__attribute__((nonnull(1)));
+static void c_tcp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
+	__attribute__((nonnull(1)));
 
 
 /**
@@ -421,7 +436,8 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	bool is_ok;
 
 	/* create the TCP part of the profile context */
-	tcp_ctxt = malloc(sizeof(struct sc_tcp_context));
+	tcp_ctxt = rohc_mempool_alloc(&ctxt->compressor->mempool,
+	                              sizeof(struct sc_tcp_context));
 	if(tcp_ctxt == NULL)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -437,7 +453,7 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	ctxt->num_sent_packets = base_ctxt->num_sent_packets;
 
 	/* MSN */
-	is_ok = wlsb_copy(&tcp_ctxt->msn_wlsb, &base_tcp_ctxt->msn_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->msn_wlsb, &base_tcp_ctxt->msn_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -446,7 +462,7 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	}
 
 	/* IP-ID offset */
-	is_ok = wlsb_copy(&tcp_ctxt->ip_id_wlsb, &base_tcp_ctxt->ip_id_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->ip_id_wlsb, &base_tcp_ctxt->ip_id_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -455,7 +471,7 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	}
 
 	/* innermost IPv4 TTL or IPv6 Hop Limit */
-	is_ok = wlsb_copy(&tcp_ctxt->ttl_hopl_wlsb, &base_tcp_ctxt->ttl_hopl_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->ttl_hopl_wlsb, &base_tcp_ctxt->ttl_hopl_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -465,7 +481,7 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	}
 
 	/* TCP window */
-	is_ok = wlsb_copy(&tcp_ctxt->window_wlsb, &base_tcp_ctxt->window_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->window_wlsb, &base_tcp_ctxt->window_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -474,14 +490,14 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	}
 
 	/* TCP sequence number */
-	is_ok = wlsb_copy(&tcp_ctxt->seq_wlsb, &base_tcp_ctxt->seq_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->seq_wlsb, &base_tcp_ctxt->seq_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
 		           "failed to create W-LSB context for TCP sequence number");
 		goto free_wlsb_window;
 	}
-	is_ok = wlsb_copy(&tcp_ctxt->seq_scaled_wlsb, &base_tcp_ctxt->seq_scaled_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->seq_scaled_wlsb, &base_tcp_ctxt->seq_scaled_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -491,14 +507,14 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	}
 
 	/* TCP acknowledgment (ACK) number */
-	is_ok = wlsb_copy(&tcp_ctxt->ack_wlsb, &base_tcp_ctxt->ack_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->ack_wlsb, &base_tcp_ctxt->ack_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
 		           "failed to create W-LSB context for TCP ACK number");
 		goto free_wlsb_seq_scaled;
 	}
-	is_ok = wlsb_copy(&tcp_ctxt->ack_scaled_wlsb, &base_tcp_ctxt->ack_scaled_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->ack_scaled_wlsb, &base_tcp_ctxt->ack_scaled_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -511,7 +527,7 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	rohc_comp_debug(ctxt, "MSN = 0x%04x / %u", tcp_ctxt->msn, tcp_ctxt->msn);
 
 	/* TCP option Timestamp (request) */
-	is_ok = wlsb_copy(&tcp_ctxt->tcp_opts.ts_req_wlsb, &base_tcp_ctxt->tcp_opts.ts_req_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->tcp_opts.ts_req_wlsb, &base_tcp_ctxt->tcp_opts.ts_req_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -520,7 +536,7 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 		goto free_wlsb_ack_scaled;
 	}
 	/* TCP option Timestamp (reply) */
-	is_ok = wlsb_copy(&tcp_ctxt->tcp_opts.ts_reply_wlsb, &base_tcp_ctxt->tcp_opts.ts_reply_wlsb);
+	is_ok = wlsb_complete_copy(&tcp_ctxt->tcp_opts.ts_reply_wlsb, &base_tcp_ctxt->tcp_opts.ts_reply_wlsb);
 	if(!is_ok)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -550,7 +566,8 @@ free_wlsb_ip_id:
 free_wlsb_msn:
 	wlsb_free(&tcp_ctxt->msn_wlsb);
 free_context:
-	free(tcp_ctxt);
+	rohc_mempool_release(&ctxt->compressor->mempool, tcp_ctxt,
+	                     sizeof(struct sc_tcp_context));
 error:
 	return false;
 }
@@ -571,6 +588,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
                                   const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_mempool *const mempool = &context->compressor->mempool;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 	struct sc_tcp_context *tcp_context;
 	size_t ip_hdr_pos;
@@ -581,7 +599,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	assert(uncomp_pkt_hdrs->tcp != NULL);
 
 	/* create the TCP part of the profile context */
-	tcp_context = calloc(1, sizeof(struct sc_tcp_context));
+	tcp_context = rohc_mempool_alloc(mempool, sizeof(struct sc_tcp_context));
 	if(tcp_context == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -638,9 +656,10 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	tcp_context->seq_num = rohc_ntoh32(tcp->seq_num);
 	tcp_context->ack_num = rohc_ntoh32(tcp->ack_num);
 	tcp_context->ack_stride = 0;
+	tcp_context->pure_ack_nr = 0;
 
 	/* MSN */
-	is_ok = wlsb_new(&tcp_context->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->msn_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -649,7 +668,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* IP-ID offset */
-	is_ok = wlsb_new(&tcp_context->ip_id_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ip_id_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -658,7 +677,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* innermost IPv4 TTL or IPv6 Hop Limit */
-	is_ok = wlsb_new(&tcp_context->ttl_hopl_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ttl_hopl_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -668,7 +687,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* TCP window */
-	is_ok = wlsb_new(&tcp_context->window_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->window_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -677,14 +696,14 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* TCP sequence number */
-	is_ok = wlsb_new(&tcp_context->seq_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->seq_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP sequence number");
 		goto free_wlsb_window;
 	}
-	is_ok = wlsb_new(&tcp_context->seq_scaled_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->seq_scaled_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -694,14 +713,14 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* TCP acknowledgment (ACK) number */
-	is_ok = wlsb_new(&tcp_context->ack_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ack_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP ACK number");
 		goto free_wlsb_seq_scaled;
 	}
-	is_ok = wlsb_new(&tcp_context->ack_scaled_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ack_scaled_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -716,14 +735,18 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	/* init the last list of TCP options */
 	tcp_context->tcp_opts.structure_nr_trans = 0;
 	tcp_context->tcp_opts.structure_nr = 0;
+	tcp_context->tcp_opts.arena_len = 0;
+	tcp_context->tcp_opts.pkt_idxs = 0;
 	// Initialize TCP options list index used
 	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
 	{
 		tcp_context->tcp_opts.list[i].used = false;
+		tcp_context->tcp_opts.list[i].data_len = 0;
+		tcp_context->tcp_opts.list[i].data_off = C_TCP_OPT_NO_DATA;
 	}
 
 	/* TCP option Timestamp (request) */
-	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_req_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_req_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -732,7 +755,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 		goto free_wlsb_ack_scaled;
 	}
 	/* TCP option Timestamp (reply) */
-	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_reply_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_reply_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -762,7 +785,8 @@ free_wlsb_ip_id:
 free_wlsb_msn:
 	wlsb_free(&tcp_context->msn_wlsb);
 free_context:
-	free(tcp_context);
+	rohc_mempool_release(&context->compressor->mempool, tcp_context,
+	                     sizeof(struct sc_tcp_context));
 error:
 	return false;
 }
@@ -787,7 +811,8 @@ static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	wlsb_free(&tcp_context->ip_id_wlsb);
 	wlsb_free(&tcp_context->ttl_hopl_wlsb);
 	wlsb_free(&tcp_context->msn_wlsb);
-	free(tcp_context);
+	rohc_mempool_release(&context->compressor->mempool, tcp_context,
+	                     sizeof(struct sc_tcp_context));
 }
 
 
@@ -866,7 +891,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
                         const size_t rohc_pkt_max_len,
                         rohc_packet_t *const packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct sc_tcp_context *const tcp_context = context->specific;
 	struct c_tcp_opts_ctxt *const tcp_opts = &(tcp_context->tcp_opts);
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
@@ -877,12 +902,16 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 
 	*packet_type = ROHC_PACKET_UNKNOWN;
 
+	/* widen the W-LSB windows back if ACKs stopped coming back */
+	c_tcp_set_wlsb_width(context, rohc_comp_wlsb_width_on_send(context));
+
 	/* detect changes between new uncompressed packet and context */
 	if(!tcp_detect_changes(context, ip_inner_context, uncomp_pkt_hdrs, &tmp))
 	{
 		rohc_comp_warn(context, "failed to detect changes in uncompressed packet");
 		goto error;
 	}
+	tcp_detect_pure_ack(context, uncomp_pkt_hdrs, &tmp);
 	if(tmp.tcp_opts.do_list_static_changed)
 	{
 		tcp_context->tcp_opts_list_static_trans_nr = 0;
@@ -893,6 +922,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		                "few packets");
 		tmp.tcp_opts.do_list_static_changed = true;
 	}
+	tcp_detect_changes_summary(context, uncomp_pkt_hdrs, &tmp);
 
 	/* decide in which state to go */
 	tcp_decide_state(context, uncomp_pkt_time);
@@ -1216,9 +1246,9 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 
 		/* encode base CID if different from IR-CR CID */
 		ir_cr_crc7 =
-			crc_calculate(ROHC_CRC_TYPE_7,
-			              (const uint8_t *const) uncomp_pkt_hdrs->ip_hdrs[0].ip,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_engine_calc(&context->compressor->crc_engine, ROHC_CRC_TYPE_7,
+			                (const uint8_t *const) uncomp_pkt_hdrs->ip_hdrs[0].ip,
+			                uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
 		rohc_remain_data[0] = (B ? 0x80 : 0x00) | (ir_cr_crc7 & 0x7f);
 		rohc_comp_debug(context, "B (%d) + CRC7 (0x%x on %zu bytes) = 0x%02x",
 		                GET_REAL(B), ir_cr_crc7, uncomp_pkt_hdrs->all_hdrs_len,
@@ -1286,8 +1316,9 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	}
 
 	/* IR(-CR|-DYN) header was successfully built, compute the CRC */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
-	                                       rohc_hdr_len, CRC_INIT_8);
+	rohc_pkt[crc_position] = crc_engine_calc(&context->compressor->crc_engine,
+	                                         ROHC_CRC_TYPE_8, rohc_pkt,
+	                                         rohc_hdr_len, CRC_INIT_8);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                rohc_hdr_len, rohc_pkt[crc_position]);
 
@@ -1373,16 +1404,18 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	   packet_type == ROHC_PACKET_TCP_CO_COMMON)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
-			              CRC_INIT_7);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_7, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
+			                CRC_INIT_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
-			              CRC_INIT_3);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_3, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
+			                CRC_INIT_3);
 		rohc_comp_debug(context, "CRC-3 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -1602,6 +1635,11 @@ static int co_baseheader(struct rohc_comp_ctxt *const context,
 	if(uncomp_pkt_hdrs->innermost_ip_hdr->version == IPV4)
 	{
 		const struct ipv4_hdr *const inner_ipv4 = uncomp_pkt_hdrs->innermost_ip_hdr->ipv4;
+		if(context->num_sent_packets > 0 &&
+		   inner_ip_ctxt->last_ip_id_behavior != inner_ip_ctxt->ip_id_behavior)
+		{
+			context->ip_id_behavior_changes_nr++;
+		}
 		inner_ip_ctxt->last_ip_id_behavior = inner_ip_ctxt->ip_id_behavior;
 		inner_ip_ctxt->last_ip_id = rohc_ntoh16(inner_ipv4->id);
 		inner_ip_ctxt->df = inner_ipv4->df;
@@ -2668,7 +2706,6 @@ static int c_tcp_build_co_common(const struct rohc_comp_ctxt *const context,
                                  uint8_t *const rohc_data,
                                  const size_t rohc_max_len)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 	co_common_t *const co_common = (co_common_t *) rohc_data;
 	uint8_t *co_common_opt = (uint8_t *) (co_common + 1); /* optional part */
@@ -2743,10 +2780,7 @@ static int c_tcp_build_co_common(const struct rohc_comp_ctxt *const context,
 
 	/* ack_stride */
 	{
-		const bool is_ack_stride_static =
-			tcp_is_ack_stride_static(tcp_context->ack_stride,
-			                         tcp_context->ack_num_scaling_nr,
-			                         oa_repetitions_nr);
+		const bool is_ack_stride_static = !(tmp->changes & TCP_CHG_ACK_STRIDE);
 		ret = c_static_or_irreg16(rohc_hton16(tcp_context->ack_stride),
 		                          is_ack_stride_static,
 		                          co_common_opt, rohc_remain_len, &indicator);
@@ -2977,7 +3011,7 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                struct tcp_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct sc_tcp_context *const tcp_context = context->specific;
 	size_t ip_hdr_pos;
 	bool pkt_outer_dscp_changed;
@@ -3075,8 +3109,22 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
 		}
 		else
 		{
-			inner_ip_ctxt->ip_id_behavior =
+			const rohc_ip_id_behavior_t detected_behavior =
 				rohc_comp_detect_ip_id_behavior(inner_ip_ctxt->last_ip_id, ip_id, 1, 19);
+
+			/* do not reclassify the IP-ID behavior on one IP-ID out of pattern */
+			inner_ip_ctxt->ip_id_behavior =
+				rohc_comp_ip_id_behavior_hysteresis(&inner_ip_ctxt->ip_id_hyst,
+				                                    inner_ip_ctxt->last_ip_id_behavior,
+				                                    detected_behavior, ip_id,
+				                                    context->compressor->ip_id_hysteresis_nr);
+			if(inner_ip_ctxt->ip_id_behavior != detected_behavior)
+			{
+				rohc_comp_debug(context, "IP-ID behaved as %s in packet, wait for "
+				                "%u consistent observations before changing behavior",
+				                rohc_ip_id_behavior_get_descr(detected_behavior),
+				                context->compressor->ip_id_hysteresis_nr);
+			}
 		}
 		rohc_comp_debug(context, "IP-ID now behaves as %s",
 		                rohc_ip_id_behavior_get_descr(inner_ip_ctxt->ip_id_behavior));
@@ -3204,7 +3252,7 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
                                          const uint8_t *const exts,
                                          const size_t max_exts_len)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct sc_tcp_context *const tcp_context = context->specific;
 	const uint8_t *remain_data = exts;
 	size_t remain_len = max_exts_len;
@@ -3386,6 +3434,134 @@ static uint16_t c_tcp_get_next_msn(const struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Detect whether the packet is one more pure ACK of the flow
+ *
+ * A pure ACK carries no payload, keeps the TCP sequence number and advances
+ * the TCP ACK number by \e ack_stride. The consecutive pure ACKs are counted,
+ * the TCP flows that carry only pure ACKs are then encoded with the shortcut
+ * of \ref tcp_decide_pure_ack_packet.
+ *
+ * @param context          The compression context
+ * @param uncomp_pkt_hdrs  The uncompressed headers to encode
+ * @param tmp              The temporary state for the compressed packet
+ */
+static void tcp_detect_pure_ack(struct rohc_comp_ctxt *const context,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                const struct tcp_tmp_variables *const tmp)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
+
+	if(uncomp_pkt_hdrs->payload_len == 0 &&
+	   tcp->ack_flag != 0 &&
+	   tcp->rsf_flags == 0 &&
+	   tcp_context->ack_stride != 0 &&
+	   tmp->seq_num == tcp_context->seq_num &&
+	   (tmp->ack_num - tcp_context->ack_num) == tcp_context->ack_stride)
+	{
+		if(tcp_context->pure_ack_nr < UINT8_MAX)
+		{
+			tcp_context->pure_ack_nr++;
+		}
+		rohc_comp_debug(context, "pure ACK #%u with ack_stride 0x%04x",
+		                tcp_context->pure_ack_nr, tcp_context->ack_stride);
+	}
+	else
+	{
+		tcp_context->pure_ack_nr = 0;
+	}
+}
+
+
+/**
+ * @brief Summarize the changes detected in the current packet
+ *
+ * The changes recorded field by field while detecting changes are gathered in
+ * one bitmask of TCP_CHG_* flags, and the numbers of bits required by the
+ * W-LSB fields are computed once. The packet decision then reads only from
+ * this summary instead of comparing the packet with the context again for
+ * every candidate packet type.
+ *
+ * @param context          The compression context
+ * @param uncomp_pkt_hdrs  The uncompressed headers to encode
+ * @param[in,out] tmp      The temporary state for the compressed packet
+ */
+static void tcp_detect_changes_summary(const struct rohc_comp_ctxt *const context,
+                                       const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                       struct tcp_tmp_variables *const tmp)
+{
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
+	uint32_t changes = 0;
+
+	changes |= (tmp->is_ipv6_exts_list_static_changed ? TCP_CHG_IPV6_EXTS_STATIC : 0);
+	changes |= (tmp->is_ipv6_exts_list_dyn_changed ? TCP_CHG_IPV6_EXTS_DYN : 0);
+	changes |= (tmp->outer_ip_ttl_changed ? TCP_CHG_OUTER_TTL_HOPL : 0);
+	changes |= (tmp->ip_id_behavior_changed ? TCP_CHG_IP_ID_BEHAVIOR : 0);
+	changes |= (tmp->ip_df_changed ? TCP_CHG_DF : 0);
+	changes |= (tmp->dscp_changed ? TCP_CHG_DSCP : 0);
+	changes |= (tmp->ttl_hopl_changed ? TCP_CHG_TTL_HOPL : 0);
+	changes |= (tmp->ecn_used_changed ? TCP_CHG_ECN_USED : 0);
+	changes |= (tmp->tcp_ack_flag_changed ? TCP_CHG_ACK_FLAG : 0);
+	changes |= ((tmp->tcp_urg_flag_present || tmp->tcp_urg_flag_changed) ?
+	            TCP_CHG_URG_FLAG : 0);
+	changes |= (tmp->tcp_urg_ptr_changed ? TCP_CHG_URG_PTR : 0);
+	changes |= (tmp->tcp_window_changed ? TCP_CHG_WINDOW : 0);
+	changes |= (!tmp->tcp_seq_num_unchanged ? TCP_CHG_SEQ_NUM : 0);
+	changes |= (!tmp->tcp_ack_num_unchanged ? TCP_CHG_ACK_NUM : 0);
+	changes |= (tcp->rsf_flags != 0 ? TCP_CHG_RSF_FLAGS : 0);
+	changes |= (!rsf_index_enc_possible(tcp->rsf_flags) ?
+	            TCP_CHG_RSF_NOT_INDEXABLE : 0);
+	changes |= ((tmp->tcp_opts.do_list_struct_changed ||
+	             tmp->tcp_opts.do_list_static_changed ||
+	             tmp->tcp_opts.opt_ts_do_transmit_item) ? TCP_CHG_OPTS_LIST : 0);
+	changes |= (!tcp_is_ack_stride_static(tcp_context->ack_stride,
+	                                      tcp_context->ack_num_scaling_nr,
+	                                      oa_repetitions_nr) ?
+	            TCP_CHG_ACK_STRIDE : 0);
+	changes |= ((tcp_context->seq_num_factor == 0 ||
+	             tcp_context->seq_num_scaling_nr < oa_repetitions_nr) ?
+	            TCP_CHG_SEQ_NOT_SCALED : 0);
+	changes |= (!tcp_is_ack_scaled_possible(tcp_context->ack_stride,
+	                                        tcp_context->ack_num_scaling_nr,
+	                                        oa_repetitions_nr) ?
+	            TCP_CHG_ACK_NOT_SCALED : 0);
+	tmp->changes = changes;
+
+	/* walk every W-LSB window once, whatever the number of packet types
+	 * that are tried afterwards */
+	tmp->bits_nr.msn =
+		wlsb_get_minkp_16bits(&tcp_context->msn_wlsb, tcp_context->msn,
+		                      ROHC_LSB_SHIFT_TCP_SN);
+	tmp->bits_nr.ip_id_p1 =
+		wlsb_get_minkp_16bits(&tcp_context->ip_id_wlsb, tmp->ip_id_delta, 1);
+	tmp->bits_nr.ip_id_p3 =
+		wlsb_get_minkp_16bits(&tcp_context->ip_id_wlsb, tmp->ip_id_delta, 3);
+	tmp->bits_nr.ttl_hopl =
+		wlsb_get_minkp_8bits(&tcp_context->ttl_hopl_wlsb,
+		                     uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
+		                     ROHC_LSB_SHIFT_TCP_TTL);
+	tmp->bits_nr.window =
+		wlsb_get_minkp_16bits(&tcp_context->window_wlsb,
+		                      rohc_ntoh16(tcp->window), 16383);
+	tmp->bits_nr.seq_scaled =
+		wlsb_get_minkp_32bits(&tcp_context->seq_scaled_wlsb,
+		                      tcp_context->seq_num_scaled, 7);
+	tmp->bits_nr.ack_scaled =
+		wlsb_get_minkp_32bits(&tcp_context->ack_scaled_wlsb,
+		                      tcp_context->ack_num_scaled, 3);
+
+	rohc_comp_debug(context, "changes = 0x%05x, bits required: MSN %u, "
+	                "IP-ID %u/%u, TTL/HL %u, window %u, scaled seq %u, "
+	                "scaled ACK %u", changes, tmp->bits_nr.msn,
+	                tmp->bits_nr.ip_id_p1, tmp->bits_nr.ip_id_p3,
+	                tmp->bits_nr.ttl_hopl, tmp->bits_nr.window,
+	                tmp->bits_nr.seq_scaled, tmp->bits_nr.ack_scaled);
+}
+
+
 /**
  * @brief Decide the state that should be used for the next packet.
  *
@@ -3400,7 +3576,7 @@ static uint16_t c_tcp_get_next_msn(const struct rohc_comp_ctxt *const context)
 static void tcp_decide_state(struct rohc_comp_ctxt *const context,
                              struct rohc_ts pkt_time)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const rohc_comp_state_t curr_state = context->state;
 	rohc_comp_state_t next_state;
 
@@ -3450,13 +3626,18 @@ static bool tcp_detect_changes_tcp_hdr(struct rohc_comp_ctxt *const context,
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                        struct tcp_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct sc_tcp_context *const tcp_context = context->specific;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 
 	tmp->seq_num = rohc_ntoh32(tcp->seq_num);
 	tmp->ack_num = rohc_ntoh32(tcp->ack_num);
 
+	/* the packet type is chosen by checking many (k, p) pairs for the sequence
+	 * and ACK numbers, walk their windows only once */
+	wlsb_get_range_32bits(&tcp_context->seq_wlsb, tmp->seq_num, &tmp->seq_range);
+	wlsb_get_range_32bits(&tcp_context->ack_wlsb, tmp->ack_num, &tmp->ack_range);
+
 	rohc_comp_debug(context, "new TCP seq = 0x%08x, ack_seq = 0x%08x",
 	                tmp->seq_num, tmp->ack_num);
 	rohc_comp_debug(context, "old TCP seq = 0x%08x, ack_seq = 0x%08x",
@@ -3554,6 +3735,16 @@ static bool tcp_detect_changes_tcp_hdr(struct rohc_comp_ctxt *const context,
 		{
 			ack_stride = tcp_context->ack_stride;
 		}
+		else if(ack_delta == tcp_context->ack_stride)
+		{
+			/* the ACK delta that was most used over the sliding window is used
+			 * once more, so it stays the most used one: record it without
+			 * walking the whole sliding window again (pure ACKs hit this case
+			 * for every packet) */
+			tcp_context->ack_deltas_width[tcp_context->ack_deltas_next] = ack_delta;
+			tcp_context->ack_deltas_next = (tcp_context->ack_deltas_next + 1) % 20;
+			ack_stride = tcp_context->ack_stride;
+		}
 		else
 		{
 			size_t ack_stride_count = 0;
@@ -3797,11 +3988,78 @@ static rohc_packet_t tcp_decide_SO_packet(const struct rohc_comp_ctxt *const con
                                           const struct tcp_tmp_variables *const tmp)
 {
 	const bool crc7_at_least = false;
+	rohc_packet_t packet_type;
+
+	if(tcp_decide_pure_ack_packet(context, ip_inner_context, tmp, &packet_type))
+	{
+		return packet_type;
+	}
+
 	return tcp_decide_FO_SO_packet(context, ip_inner_context, uncomp_pkt_hdrs,
 	                               tmp, crc7_at_least);
 }
 
 
+/**
+ * @brief Decide which packet to send for one more pure ACK when in SO state
+ *
+ * Once the flow sent enough pure ACKs in a row (see \ref tcp_detect_pure_ack),
+ * only the scaled ACK number changes from one packet to the next. The seq_4
+ * or rnd_4 packet is then chosen directly from the change summary
+ * instead of walking all the decisions of \ref tcp_decide_FO_SO_packet. The
+ * generic packet decision is kept if any field other than the ACK number
+ * changed or if the scaled ACK number does not fit the packet.
+ *
+ * @param context           The compression context
+ * @param ip_inner_context  The context of the inner IP header
+ * @param tmp               The temporary state for the compressed packet
+ * @param[out] packet_type  The packet type among ROHC_PACKET_TCP_SEQ_4 and
+ *                          ROHC_PACKET_TCP_RND_4
+ * @return                  true if the shortcut chose the packet type,
+ *                          false if the generic decision shall be used
+ */
+static bool tcp_decide_pure_ack_packet(const struct rohc_comp_ctxt *const context,
+                                       const ip_context_t *const ip_inner_context,
+                                       const struct tcp_tmp_variables *const tmp,
+                                       rohc_packet_t *const packet_type)
+{
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
+	const struct sc_tcp_context *const tcp_context = context->specific;
+
+	/* the flow shall be a pure ACK flow, nothing but the ACK number shall
+	 * change in the current packet, and the ACK number shall be scalable */
+	if(tcp_context->pure_ack_nr < oa_repetitions_nr ||
+	   (tmp->changes & ~TCP_CHG_SEQ_NOT_SCALED) != TCP_CHG_ACK_NUM)
+	{
+		return false;
+	}
+
+	/* then the W-LSB fields: 4 bits of MSN and 4 bits of scaled ACK number */
+	if(tmp->bits_nr.msn > 4 || tmp->bits_nr.ack_scaled > 4)
+	{
+		return false;
+	}
+
+	if(ip_inner_context->ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP)
+	{
+		if(tmp->bits_nr.ip_id_p1 > 3)
+		{
+			return false;
+		}
+		*packet_type = ROHC_PACKET_TCP_SEQ_4;
+	}
+	else
+	{
+		*packet_type = ROHC_PACKET_TCP_RND_4;
+	}
+
+	rohc_comp_debug(context, "code %s packet for pure ACK",
+	                rohc_get_packet_descr(*packet_type));
+
+	return true;
+}
+
+
 /**
  * @brief Decide which packet to send when in FO or SO state.
  *
@@ -3823,53 +4081,39 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
                                              const struct tcp_tmp_variables *const tmp,
                                              const bool crc7_at_least)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
-	struct sc_tcp_context *const tcp_context = context->specific;
-	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
+	const uint32_t changes = tmp->changes;
 	rohc_packet_t packet_type;
 
-	if(tmp->is_ipv6_exts_list_static_changed)
+	if(changes & TCP_CHG_IPV6_EXTS_STATIC)
 	{
 		rohc_comp_debug(context, "force packet IR because at least one IPv6 option "
 		                "changed its static part");
 		packet_type = ROHC_PACKET_IR;
 	}
-	else if(tmp->is_ipv6_exts_list_dyn_changed)
+	else if(changes & TCP_CHG_IPV6_EXTS_DYN)
 	{
 		rohc_comp_debug(context, "force packet IR-DYN because at least one IPv6 option "
 		                "changed its dynamic part");
 		packet_type = ROHC_PACKET_IR_DYN;
 	}
-	else if(!wlsb_is_kp_possible_16bits(&tcp_context->msn_wlsb, tcp_context->msn, 4,
-	                                    ROHC_LSB_SHIFT_TCP_SN))
+	else if(tmp->bits_nr.msn > 4)
 	{
 		rohc_comp_debug(context, "force packet IR-DYN because the MSN changed "
 		                "too much");
 		packet_type = ROHC_PACKET_IR_DYN;
 	}
-	else if(!rsf_index_enc_possible(tcp->rsf_flags))
+	else if(changes & TCP_CHG_RSF_NOT_INDEXABLE)
 	{
 		rohc_comp_debug(context, "force packet IR-DYN because the RSF flags are "
 		                "not compressible");
 		packet_type = ROHC_PACKET_IR_DYN;
 	}
-	else if(tmp->outer_ip_ttl_changed ||
-	        tmp->ip_id_behavior_changed ||
-	        tmp->ip_df_changed ||
-	        tmp->dscp_changed ||
-	        tmp->tcp_ack_flag_changed ||
-	        tmp->tcp_urg_flag_present ||
-	        tmp->tcp_urg_flag_changed ||
-	        tmp->tcp_urg_ptr_changed ||
-	        !tcp_is_ack_stride_static(tcp_context->ack_stride,
-	                                  tcp_context->ack_num_scaling_nr,
-	                                  oa_repetitions_nr))
+	else if(changes & TCP_CHG_CO_COMMON_ONLY)
 	{
 		TRACE_GOTO_CHOICE;
 		packet_type = ROHC_PACKET_TCP_CO_COMMON;
 	}
-	else if(tmp->ecn_used_changed ||
-	        tmp->ttl_hopl_changed)
+	else if(changes & (TCP_CHG_ECN_USED | TCP_CHG_TTL_HOPL))
 	{
 		/* use compressed header with a 7-bit CRC (rnd_8, seq_8 or common):
 		 *  - use common if too many LSB of sequence number are required
@@ -3877,25 +4121,21 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		 *  - use common if too many LSB of innermost TTL/Hop Limit are required
 		 *  - use common if window changed */
 		if(ip_inner_context->ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb, tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		   !tmp->tcp_window_changed)
+		   tmp->bits_nr.ip_id_p3 <= 4 &&
+		   wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191) &&
+		   tmp->bits_nr.ttl_hopl <= 3 &&
+		   !(changes & TCP_CHG_WINDOW))
 		{
 			/* ROHC_IP_ID_BEHAVIOR_SEQ or ROHC_IP_ID_BEHAVIOR_SEQ_SWAP */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
 		}
 		else if(ip_inner_context->ip_id_behavior > ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		        !tmp->tcp_window_changed)
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 65535) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383) &&
+		        tmp->bits_nr.ttl_hopl <= 3 &&
+		        !(changes & TCP_CHG_WINDOW))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_8;
@@ -3956,34 +4196,27 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
                                                  const struct tcp_tmp_variables *const tmp,
                                                  const bool crc7_at_least)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
-	struct sc_tcp_context *const tcp_context = context->specific;
-	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
+	const uint32_t changes = tmp->changes;
+	const bool ack_num_omitted =
+		!!(uncomp_pkt_hdrs->tcp->ack_flag == 0 || !(changes & TCP_CHG_ACK_NUM));
+	const bool seq_scaled_possible =
+		!!(!(changes & TCP_CHG_SEQ_NOT_SCALED) && tmp->bits_nr.seq_scaled <= 4);
+	const bool ack_scaled_possible =
+		!!(!(changes & TCP_CHG_ACK_NOT_SCALED) && tmp->bits_nr.ack_scaled <= 4);
 	rohc_packet_t packet_type;
 
-	if(tcp->rsf_flags == 0 &&
-	   !tmp->tcp_opts.do_list_struct_changed &&
-	   !tmp->tcp_opts.do_list_static_changed &&
-	   !tmp->tcp_opts.opt_ts_do_transmit_item &&
-	   !tmp->tcp_window_changed &&
-	   (tcp->ack_flag == 0 || tmp->tcp_ack_num_unchanged) &&
+	if(!(changes & (TCP_CHG_RSF_FLAGS | TCP_CHG_OPTS_LIST | TCP_CHG_WINDOW)) &&
+	   ack_num_omitted &&
 	   !crc7_at_least &&
-	   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-	                              tmp->ip_id_delta, 7, 3) &&
-	   tcp_context->seq_num_factor > 0 &&
-	   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-	   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-	                              tcp_context->seq_num_scaled, 4, 7))
+	   tmp->bits_nr.ip_id_p3 <= 7 &&
+	   seq_scaled_possible)
 	{
 		/* seq_2 is possible */
 		TRACE_GOTO_CHOICE;
 		assert(uncomp_pkt_hdrs->payload_len > 0);
 		packet_type = ROHC_PACKET_TCP_SEQ_2;
 	}
-	else if(tcp->rsf_flags != 0 ||
-	        tmp->tcp_opts.do_list_struct_changed ||
-	        tmp->tcp_opts.do_list_static_changed ||
-	        tmp->tcp_opts.opt_ts_do_transmit_item)
+	else if(changes & (TCP_CHG_RSF_FLAGS | TCP_CHG_OPTS_LIST))
 	{
 		/* seq_8 or co_common
 		 *
@@ -3993,14 +4226,11 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 		 *  - at most 15 LSB of the TCP ACK number are required,
 		 *  - at most 4 LSBs of IP-ID must be transmitted
 		 * otherwise use co_common packet */
-		if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		   !tmp->tcp_window_changed)
+		if(tmp->bits_nr.ip_id_p3 <= 4 &&
+		   wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191) &&
+		   tmp->bits_nr.ttl_hopl <= 3 &&
+		   !(changes & TCP_CHG_WINDOW))
 		{
 			/* seq_8 is possible */
 			TRACE_GOTO_CHOICE;
@@ -4012,16 +4242,14 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_CO_COMMON;
 		}
 	}
-	else if(tmp->tcp_window_changed)
+	else if(changes & TCP_CHG_WINDOW)
 	{
 		/* seq_7 or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->window_wlsb,
-		                              rohc_ntoh16(tcp->window), 15, 16383) &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 5, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 32767) &&
-		   tmp->tcp_seq_num_unchanged)
+		   tmp->bits_nr.window <= 15 &&
+		   tmp->bits_nr.ip_id_p3 <= 5 &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 16, 32767) &&
+		   !(changes & TCP_CHG_SEQ_NUM))
 		{
 			/* seq_7 is possible */
 			TRACE_GOTO_CHOICE;
@@ -4034,16 +4262,12 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_CO_COMMON;
 		}
 	}
-	else if(tcp->ack_flag == 0 || tmp->tcp_ack_num_unchanged)
+	else if(ack_num_omitted)
 	{
 		/* seq_2, seq_1 or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 7, 3) &&
-		   tcp_context->seq_num_factor > 0 &&
-		   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                              tcp_context->seq_num_scaled, 4, 7))
+		   tmp->bits_nr.ip_id_p3 <= 7 &&
+		   seq_scaled_possible)
 		{
 			/* seq_2 is possible */
 			TRACE_GOTO_CHOICE;
@@ -4051,19 +4275,17 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_SEQ_2;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 32767))
+		        tmp->bits_nr.ip_id_p3 <= 4 &&
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 32767))
 		{
 			/* seq_1 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_1;
 		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
+		else if(tmp->bits_nr.ip_id_p3 <= 4 &&
 		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
@@ -4074,34 +4296,27 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_CO_COMMON;
 		}
 	}
-	else if(tmp->tcp_seq_num_unchanged)
+	else if(!(changes & TCP_CHG_SEQ_NUM))
 	{
 		/* seq_4, seq_3, or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 3, 1) &&
-		   tcp_is_ack_scaled_possible(tcp_context->ack_stride,
-		                              tcp_context->ack_num_scaling_nr,
-		                              oa_repetitions_nr) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_scaled_wlsb,
-		                              tcp_context->ack_num_scaled, 4, 3))
+		   tmp->bits_nr.ip_id_p1 <= 3 &&
+		   ack_scaled_possible)
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_4;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		        tmp->bits_nr.ip_id_p3 <= 4 &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_3;
 		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
+		else if(tmp->bits_nr.ip_id_p3 <= 4 &&
 		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
@@ -4112,35 +4327,29 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_CO_COMMON;
 		}
 	}
-	else if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-	                                   tmp->ip_id_delta, 4, 3))
+	else if(tmp->bits_nr.ip_id_p3 <= 4)
 	{
 		/* sequence and acknowledgment numbers changed:
 		 * seq_6, seq_5, seq_8 or co_common */
 		if(!crc7_at_least &&
-		   tcp_context->seq_num_factor > 0 &&
-		   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                              tcp_context->seq_num_scaled, 4, 7) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		   seq_scaled_possible &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			assert(uncomp_pkt_hdrs->payload_len > 0);
 			packet_type = ROHC_PACKET_TCP_SEQ_6;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 32767))
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383) &&
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 32767))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_5;
 		}
-		else if(wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		        wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		        !tmp->tcp_window_changed)
+		else if(wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191) &&
+		        tmp->bits_nr.ttl_hopl <= 3 &&
+		        !(changes & TCP_CHG_WINDOW))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
@@ -4183,37 +4392,30 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
                                                  const struct tcp_tmp_variables *const tmp,
                                                  const bool crc7_at_least)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
-	struct sc_tcp_context *const tcp_context = context->specific;
-	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
+	const uint32_t changes = tmp->changes;
+	const bool ack_flag = !!(uncomp_pkt_hdrs->tcp->ack_flag != 0);
+	const bool seq_scaled_possible =
+		!!(uncomp_pkt_hdrs->payload_len > 0 &&
+		   !(changes & TCP_CHG_SEQ_NOT_SCALED) && tmp->bits_nr.seq_scaled <= 4);
+	const bool ack_scaled_possible =
+		!!(!(changes & TCP_CHG_ACK_NOT_SCALED) && tmp->bits_nr.ack_scaled <= 4);
 	rohc_packet_t packet_type;
 
-	if(tcp->rsf_flags == 0 &&
-	   !tmp->tcp_opts.do_list_struct_changed &&
-	   !tmp->tcp_opts.do_list_static_changed &&
-	   !tmp->tcp_opts.opt_ts_do_transmit_item &&
-	   !tmp->tcp_window_changed &&
+	if(!(changes & (TCP_CHG_RSF_FLAGS | TCP_CHG_OPTS_LIST | TCP_CHG_WINDOW)) &&
 	   !crc7_at_least &&
-	   tmp->tcp_ack_num_unchanged &&
-	   uncomp_pkt_hdrs->payload_len > 0 &&
-	   tcp_context->seq_num_factor > 0 &&
-	   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-	   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-	                              tcp_context->seq_num_scaled, 4, 7))
+	   !(changes & TCP_CHG_ACK_NUM) &&
+	   seq_scaled_possible)
 	{
 		/* rnd_2 is possible */
 		assert(uncomp_pkt_hdrs->payload_len > 0);
 		TRACE_GOTO_CHOICE;
 		packet_type = ROHC_PACKET_TCP_RND_2;
 	}
-	else if(tcp->rsf_flags != 0 ||
-	        tmp->tcp_opts.do_list_struct_changed ||
-	        tmp->tcp_opts.do_list_static_changed ||
-	        tmp->tcp_opts.opt_ts_do_transmit_item)
+	else if(changes & (TCP_CHG_RSF_FLAGS | TCP_CHG_OPTS_LIST))
 	{
-		if(!tmp->tcp_window_changed &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		if(!(changes & TCP_CHG_WINDOW) &&
+		   wlsb_range_is_kp_possible(&tmp->seq_range, 16, 65535) &&
+		   wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_8;
@@ -4226,11 +4428,11 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 	}
 	else /* unchanged structure of the list of TCP options */
 	{
-		if(tmp->tcp_window_changed)
+		if(changes & TCP_CHG_WINDOW)
 		{
 			if(!crc7_at_least &&
-			   tmp->tcp_seq_num_unchanged &&
-			   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 18, 65535))
+			   !(changes & TCP_CHG_SEQ_NUM) &&
+			   wlsb_range_is_kp_possible(&tmp->ack_range, 18, 65535))
 			{
 				/* rnd_7 is possible */
 				TRACE_GOTO_CHOICE;
@@ -4244,12 +4446,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 			}
 		}
 		else if(!crc7_at_least &&
-		        tmp->tcp_ack_num_unchanged &&
-		        uncomp_pkt_hdrs->payload_len > 0 &&
-		        tcp_context->seq_num_factor > 0 &&
-		        tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                                   tcp_context->seq_num_scaled, 4, 7))
+		        !(changes & TCP_CHG_ACK_NUM) &&
+		        seq_scaled_possible)
 		{
 			/* rnd_2 is possible */
 			assert(uncomp_pkt_hdrs->payload_len > 0);
@@ -4257,42 +4455,35 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_RND_2;
 		}
 		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        tcp_is_ack_scaled_possible(tcp_context->ack_stride,
-		                                   tcp_context->ack_num_scaling_nr,
-		                                   oa_repetitions_nr) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_scaled_wlsb,
-		                                   tcp_context->ack_num_scaled, 4, 3) &&
-		        tmp->tcp_seq_num_unchanged)
+		        ack_flag &&
+		        ack_scaled_possible &&
+		        !(changes & TCP_CHG_SEQ_NUM))
 		{
 			/* rnd_4 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_4;
 		}
 		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        tmp->tcp_seq_num_unchanged &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        ack_flag &&
+		        !(changes & TCP_CHG_SEQ_NUM) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			/* rnd_3 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_3;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 18, 65535) &&
-		        tmp->tcp_ack_num_unchanged)
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 18, 65535) &&
+		        !(changes & TCP_CHG_ACK_NUM))
 		{
 			/* rnd_1 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_1;
 		}
 		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        tcp_context->seq_num_factor > 0 &&
-		        tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                                   tcp_context->seq_num_scaled, 4, 7) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		        ack_flag &&
+		        seq_scaled_possible &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			/* ACK number present */
 			/* rnd_6 is possible */
@@ -4301,18 +4492,18 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_RND_6;
 		}
 		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        ack_flag &&
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 14, 8191) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 15, 8191))
 		{
 			/* ACK number present */
 			/* rnd_5 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_5;
 		}
-		else if(/* !tmp->tcp_window_changed && */
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		else if(/* !(changes & TCP_CHG_WINDOW) && */
+		        wlsb_range_is_kp_possible(&tmp->seq_range, 16, 65535) &&
+		        wlsb_range_is_kp_possible(&tmp->ack_range, 16, 16383))
 		{
 			/* fallback on rnd_8 */
 			TRACE_GOTO_CHOICE;
@@ -4352,7 +4543,7 @@ static bool tcp_detect_ecn_used_behavior(struct rohc_comp_ctxt *const context,
                                          const uint8_t pkt_outer_dscp_changed,
                                          const uint8_t pkt_res_val)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct sc_tcp_context *const tcp_context = context->specific;
 	bool ecn_used_changed;
 
@@ -4551,40 +4742,12 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
                              const uint8_t *const feedback_data,
                              const size_t feedback_data_len)
 {
-	const uint8_t *remain_data = feedback_data;
-	size_t remain_len = feedback_data_len;
-	const struct rohc_feedback_2_rfc6846 *feedback2;
+	struct rohc_comp_feedback_2 feedback2;
 
-	size_t opts_present[ROHC_FEEDBACK_OPT_MAX] = { 0 };
-
-	uint8_t crc_in_packet;
-	size_t crc_pos_from_end;
-
-	uint32_t sn_bits;
-	size_t sn_bits_nr;
-
-	/* retrieve acked SN */
-	if(remain_len < sizeof(struct rohc_feedback_2_rfc6846))
-	{
-		rohc_comp_warn(context, "malformed FEEDBACK-2: packet too short for the "
-		               "minimal %zu-byte header, only %zu bytes remaining",
-		               sizeof(struct rohc_feedback_2_rfc6846), remain_len);
-		goto error;
-	}
-	feedback2 = (const struct rohc_feedback_2_rfc6846 *) feedback_data;
-	sn_bits = (feedback2->sn1 << 8) | feedback2->sn2;
-	sn_bits_nr = 6 + 8;
-	crc_in_packet = feedback2->crc;
-	crc_pos_from_end = remain_len - 2;
-	remain_data += 3;
-	remain_len -= 3;
-
-	/* parse FEEDBACK-2 options */
-	if(!rohc_comp_feedback_parse_opts(context, packet, packet_len,
-	                                  remain_data, remain_len,
-	                                  opts_present, &sn_bits, &sn_bits_nr,
-	                                  ROHC_FEEDBACK_WITH_CRC_BASE,
-	                                  crc_in_packet, crc_pos_from_end))
+	/* parse FEEDBACK-2 base header and options, check CRC */
+	if(!rohc_comp_feedback_parse_2(context, packet, packet_len,
+	                               feedback_data, feedback_data_len,
+	                               ROHC_FEEDBACK_WITH_CRC_BASE, &feedback2))
 	{
 		rohc_comp_warn(context, "malformed FEEDBACK-2: failed to parse options");
 		goto error;
@@ -4594,18 +4757,19 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 	rohc_comp_change_mode(context, ROHC_O_MODE);
 
 	/* act according to the type of feedback */
-	switch(feedback2->ack_type)
+	switch(feedback2.ack_type)
 	{
 		case ROHC_FEEDBACK_ACK:
 		{
-			const bool sn_not_valid = !!(opts_present[ROHC_FEEDBACK_OPT_SN_NOT_VALID] > 0);
+			const bool sn_not_valid = feedback2.sn_not_valid;
 
-			rohc_comp_debug(context, "ACK received (CID = %u, %zu-bit SN = 0x%x, "
-			                "SN-not-valid = %d)", context->cid, sn_bits_nr, sn_bits,
-			                GET_REAL(sn_not_valid));
+			rohc_comp_debug(context, "ACK received (CID = %u, %u-bit SN = 0x%x, "
+			                "SN-not-valid = %d)", context->cid, feedback2.sn_bits_nr,
+			                feedback2.sn_bits, GET_REAL(sn_not_valid));
 
 			/* the compressor received a positive ACK */
-			c_tcp_feedback_ack(context, sn_bits, sn_bits_nr, sn_not_valid);
+			c_tcp_feedback_ack(context, feedback2.sn_bits, feedback2.sn_bits_nr,
+			                   sn_not_valid);
 			break;
 		}
 		case ROHC_FEEDBACK_NACK:
@@ -4618,6 +4782,10 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 			}
+			/* the link loses packets, so widen the W-LSB windows and repeat
+			 * the changes more */
+			c_tcp_set_wlsb_width(context, rohc_comp_wlsb_width_on_nack(context));
+			rohc_comp_oa_on_nack(context);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -4629,6 +4797,10 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 			          "STATIC-NACK received for CID %u", context->cid);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+			/* the link loses packets, so widen the W-LSB windows and repeat
+			 * the changes more */
+			c_tcp_set_wlsb_width(context, rohc_comp_wlsb_width_on_nack(context));
+			rohc_comp_oa_on_nack(context);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -4643,7 +4815,7 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 		{
 			/* impossible value */
 			rohc_comp_warn(context, "malformed FEEDBACK-2: unknown ACK type %u",
-			               feedback2->ack_type);
+			               feedback2.ack_type);
 			goto error;
 		}
 	}
@@ -4717,6 +4889,10 @@ static void c_tcp_feedback_ack(struct rohc_comp_ctxt *const context,
 		acked_nr = wlsb_ack(&tcp_context->msn_wlsb, sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 		                "from SN W-LSB", acked_nr);
+
+		/* adapt the W-LSB windows to the cadence of the ACKs */
+		c_tcp_set_wlsb_width(context, rohc_comp_wlsb_width_on_ack(context,
+			(tcp_context->msn - sn_bits) & ((1U << sn_bits_nr) - 1)));
 	}
 
 	/* RFC 6846, §5.2.2.1:
@@ -4767,6 +4943,37 @@ static void c_tcp_feedback_ack(struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Change the width of the W-LSB windows used to encode the packets
+ *
+ * The window of the MSN keeps its width: it tells which context-updating
+ * packets were acknowledged.
+ *
+ * @param context  The compression context
+ * @param width    The new width of the W-LSB windows
+ */
+static void c_tcp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+
+	if(width == tcp_context->seq_wlsb.window_width)
+	{
+		return;
+	}
+
+	wlsb_set_width(&tcp_context->ttl_hopl_wlsb, width);
+	wlsb_set_width(&tcp_context->ip_id_wlsb, width);
+	wlsb_set_width(&tcp_context->window_wlsb, width);
+	wlsb_set_width(&tcp_context->seq_wlsb, width);
+	wlsb_set_width(&tcp_context->seq_scaled_wlsb, width);
+	wlsb_set_width(&tcp_context->ack_wlsb, width);
+	wlsb_set_width(&tcp_context->ack_scaled_wlsb, width);
+	wlsb_set_width(&tcp_context->tcp_opts.ts_req_wlsb, width);
+	wlsb_set_width(&tcp_context->tcp_opts.ts_reply_wlsb, width);
+}
+
+
 /**
  * @brief Define the compression part of the TCP profile as described
  *        in the RFC 3095.
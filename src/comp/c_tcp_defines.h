@@ -35,6 +35,80 @@
 #include "c_tcp_opts_list.h"
 
 
+/*
+ * The summary of the changes in the current packet, see
+ * tcp_tmp_variables::changes
+ */
+
+/** At least one IPv6 extension header changed its static part */
+#define TCP_CHG_IPV6_EXTS_STATIC   (1U <<  0)
+/** At least one IPv6 extension header changed its dynamic part */
+#define TCP_CHG_IPV6_EXTS_DYN      (1U <<  1)
+/** At least one outer IPv4 TTL or IPv6 Hop Limit changed */
+#define TCP_CHG_OUTER_TTL_HOPL     (1U <<  2)
+/** The behavior of the innermost IP-ID field changed */
+#define TCP_CHG_IP_ID_BEHAVIOR     (1U <<  3)
+/** The innermost DF flag changed */
+#define TCP_CHG_DF                 (1U <<  4)
+/** The innermost DSCP changed */
+#define TCP_CHG_DSCP               (1U <<  5)
+/** The innermost IPv4 TTL or IPv6 Hop Limit changed */
+#define TCP_CHG_TTL_HOPL           (1U <<  6)
+/** The ecn_used flag changed */
+#define TCP_CHG_ECN_USED           (1U <<  7)
+/** The TCP ACK flag changed */
+#define TCP_CHG_ACK_FLAG           (1U <<  8)
+/** The TCP URG flag is set or changed */
+#define TCP_CHG_URG_FLAG           (1U <<  9)
+/** The TCP URG pointer changed */
+#define TCP_CHG_URG_PTR            (1U << 10)
+/** The TCP window changed */
+#define TCP_CHG_WINDOW             (1U << 11)
+/** The TCP sequence number changed */
+#define TCP_CHG_SEQ_NUM            (1U << 12)
+/** The TCP ACK number changed */
+#define TCP_CHG_ACK_NUM            (1U << 13)
+/** At least one of the TCP RST, SYN or FIN flags is set */
+#define TCP_CHG_RSF_FLAGS          (1U << 14)
+/** The RSF flags cannot be encoded with the rsf_index_enc() method */
+#define TCP_CHG_RSF_NOT_INDEXABLE  (1U << 15)
+/** The structure or the static part of the list of TCP options changed, or
+ * the TCP Timestamp option shall be transmitted */
+#define TCP_CHG_OPTS_LIST          (1U << 16)
+/** The ack_stride scaling factor shall be transmitted */
+#define TCP_CHG_ACK_STRIDE         (1U << 17)
+/** The TCP sequence number cannot be transmitted scaled */
+#define TCP_CHG_SEQ_NOT_SCALED     (1U << 18)
+/** The TCP ACK number cannot be transmitted scaled */
+#define TCP_CHG_ACK_NOT_SCALED     (1U << 19)
+
+/** The changes that only the co_common packet may transmit */
+#define TCP_CHG_CO_COMMON_ONLY \
+	(TCP_CHG_OUTER_TTL_HOPL | TCP_CHG_IP_ID_BEHAVIOR | TCP_CHG_DF | \
+	 TCP_CHG_DSCP | TCP_CHG_ACK_FLAG | TCP_CHG_URG_FLAG | TCP_CHG_URG_PTR | \
+	 TCP_CHG_ACK_STRIDE)
+
+
+/**
+ * @brief The minimal numbers of bits required to encode the W-LSB fields
+ *
+ * The numbers are computed once per packet, after the changes are detected,
+ * so that the packet decision does not walk the W-LSB windows again for every
+ * candidate packet type: a field may be sent on k bits if k is greater than or
+ * equal to the number recorded here.
+ */
+struct tcp_tmp_bits_nr
+{
+	uint8_t msn;         /**< The MSN, with p = ROHC_LSB_SHIFT_TCP_SN */
+	uint8_t ip_id_p1;    /**< The IP-ID / SN delta, with p = 1 */
+	uint8_t ip_id_p3;    /**< The IP-ID / SN delta, with p = 3 */
+	uint8_t ttl_hopl;    /**< The innermost TTL/HL, with p = ROHC_LSB_SHIFT_TCP_TTL */
+	uint8_t window;      /**< The TCP window, with p = 16383 */
+	uint8_t seq_scaled;  /**< The scaled sequence number, with p = 7 */
+	uint8_t ack_scaled;  /**< The scaled ACK number, with p = 3 */
+};
+
+
 /**
  * @brief Define the TCP-specific temporary variables in the profile
  *        compression context.
@@ -48,6 +122,10 @@ struct tcp_tmp_variables
 {
 	uint32_t seq_num;
 	uint32_t ack_num;
+	/** The offsets between the sequence number and the values of its window */
+	struct wlsb_range seq_range;
+	/** The offsets between the ACK number and the values of its window */
+	struct wlsb_range ack_range;
 
 	/** The IP-ID / SN delta (with bits swapped if necessary) */
 	uint16_t ip_id_delta;
@@ -79,6 +157,12 @@ struct tcp_tmp_variables
 
 	/** The temporary part of the context for TCP options */
 	struct c_tcp_opts_ctxt_tmp tcp_opts;
+
+	/** The summary of the changes in the current packet (TCP_CHG_* flags),
+	 * the only input of the packet decision with bits_nr */
+	uint32_t changes;
+	/** The minimal numbers of bits required to encode the W-LSB fields */
+	struct tcp_tmp_bits_nr bits_nr;
 };
 
 
@@ -155,6 +239,9 @@ struct sc_tcp_context
 	uint16_t window_nbo;
 
 	uint8_t ip_contexts_nr;
+	/** The number of consecutive pure ACKs (no payload, same sequence number,
+	 * ACK number advancing by ack_stride) */
+	uint8_t pure_ack_nr;
 	ip_context_t ip_contexts[ROHC_MAX_IP_HDRS];
 };
 
@@ -63,6 +63,23 @@ static uint8_t tcp_opt_ts_one_can_be_encoded(const struct c_wlsb *const wlsb,
                                              const uint32_t ts)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+static void c_tcp_detect_opt_ts_changes(const struct rohc_comp_ctxt *const context,
+                                        struct c_tcp_opts_ctxt *const opts_ctxt,
+                                        struct c_tcp_opts_ctxt_tmp *const tmp,
+                                        const uint8_t opt_idx,
+                                        const uint8_t *const opt_data)
+	__attribute__((nonnull(1, 2, 3, 5)));
+
+static int c_tcp_code_opt_ts_irreg(const struct rohc_comp_ctxt *const context,
+                                   struct c_tcp_opts_ctxt *const opts_ctxt,
+                                   const struct c_tcp_opts_ctxt_tmp *const tmp,
+                                   const uint8_t opt_idx,
+                                   const uint8_t *const opt_data,
+                                   const uint8_t opt_len,
+                                   uint8_t *const rohc_data,
+                                   const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5, 7)));
+
 static bool c_tcp_opt_get_type_len(const uint8_t *const opts_data,
                                    const size_t opts_len,
                                    uint8_t *const opt_type,
@@ -81,6 +98,10 @@ static void c_tcp_opt_record(struct c_tcp_opts_ctxt *const opts_ctxt,
                              const size_t pkt_opt_len)
 	__attribute__((nonnull(1, 3)));
 
+static void c_tcp_opts_arena_compact(struct c_tcp_opts_ctxt *const opts_ctxt,
+                                     const bool keep_pkt_only)
+	__attribute__((nonnull(1)));
+
 static void c_tcp_opt_trace(const struct rohc_comp_ctxt *const context,
                             const uint8_t opt_type,
                             const uint8_t *const opt_data,
@@ -500,6 +521,7 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 {
 	uint16_t indexes_in_use = 0;
 	const uint8_t opts_nr = uncomp_pkt_hdrs->tcp_opts.nr;
+	bool is_nop_ts_layout = true;
 	uint8_t opt_idx;
 	uint8_t opt_pos;
 
@@ -541,7 +563,33 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 	tmp->opt_ts_do_transmit_item = false;
 	tmp->idx_max = 0;
 
-	for(opt_pos = 0; opt_pos < opts_nr; opt_pos++)
+	/* bulk TCP flows carry the very same NOP, NOP, TS layout in every packet:
+	 * once that layout was transmitted enough times, the indexes of the
+	 * options are known and only the TS option may change, so skip the
+	 * per-option checks (lengths of NOP and TS are fixed by the parser) */
+	tmp->is_nop_ts_fast_path =
+		!!(!tmp->do_list_struct_changed && opts_ctxt->is_nop_ts_layout &&
+		   opts_ctxt->structure_nr_trans >= context->oa_repetitions_nr);
+	if(tmp->is_nop_ts_fast_path)
+	{
+		rohc_comp_debug(context, "  same NOP/TS layout as in previous packets");
+		for(opt_pos = 0; opt_pos < opts_nr; opt_pos++)
+		{
+			if(uncomp_pkt_hdrs->tcp_opts.types[opt_pos] == TCP_OPT_TS)
+			{
+				c_tcp_detect_opt_ts_changes(context, opts_ctxt, tmp, TCP_INDEX_TS,
+				                            uncomp_pkt_hdrs->tcp_opts.data[opt_pos]);
+				tmp->position2index[opt_pos] = TCP_INDEX_TS;
+			}
+			else
+			{
+				tmp->position2index[opt_pos] = TCP_INDEX_NOP;
+			}
+		}
+		tmp->idx_max = TCP_INDEX_TS;
+	}
+
+	for(opt_pos = 0; !tmp->is_nop_ts_fast_path && opt_pos < opts_nr; opt_pos++)
 	{
 		const uint8_t *const opt_data = uncomp_pkt_hdrs->tcp_opts.data[opt_pos];
 		const uint8_t opt_type = uncomp_pkt_hdrs->tcp_opts.types[opt_pos];
@@ -549,51 +597,18 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 
 		rohc_comp_debug(context, "  %u-byte TCP option %u found", opt_len, opt_type);
 
+		if(opt_type != TCP_OPT_NOP && opt_type != TCP_OPT_TS)
+		{
+			is_nop_ts_layout = false;
+		}
+
 		/* determine the index of the TCP option */
 		opt_idx = c_tcp_get_opt_index(context, opts_ctxt, opt_type, indexes_in_use);
 		indexes_in_use |= (1 << opt_idx);
 
 		if(opt_type == TCP_OPT_TS)
 		{
-			const struct tcp_option_timestamp *const opt_ts =
-				(struct tcp_option_timestamp *) (opt_data + 2);
-
-			tmp->opt_ts_present = true;
-
-			tmp->ts_req = rohc_ntoh32(opt_ts->ts);
-			tmp->ts_req_bytes_nr =
-				tcp_opt_ts_one_can_be_encoded(&opts_ctxt->ts_req_wlsb,
-				                              tmp->ts_req);
-
-			tmp->ts_reply = rohc_ntoh32(opt_ts->ts_reply);
-			tmp->ts_reply_bytes_nr =
-				tcp_opt_ts_one_can_be_encoded(&opts_ctxt->ts_reply_wlsb,
-				                              tmp->ts_reply);
-
-			if(tmp->ts_req_bytes_nr == 0 || tmp->ts_reply_bytes_nr == 0)
-			{
-				rohc_comp_debug(context, "    TS option shall be transmitted as "
-				                "list item in one of dynamic, replicate or CO "
-				                "chains");
-				tmp->opt_ts_do_transmit_item = true;
-				opts_ctxt->list[opt_idx].full_trans_nr = 0;
-				opts_ctxt->list[opt_idx].dyn_trans_nr = 0;
-			}
-			else if(opts_ctxt->list[opt_idx].full_trans_nr <
-			        context->compressor->oa_repetitions_nr)
-			{
-				rohc_comp_debug(context, "    TS option changed in the last few packets, "
-				                "TS option shall be transmitted at least %u times more "
-				                "as list item in one of dynamic, replicate or CO chains",
-				                context->compressor->oa_repetitions_nr -
-				                opts_ctxt->list[opt_idx].full_trans_nr);
-				tmp->opt_ts_do_transmit_item = true;
-			}
-			else
-			{
-				rohc_comp_debug(context, "    TS option can be encoded in "
-				                "irregular chain");
-			}
+			c_tcp_detect_opt_ts_changes(context, opts_ctxt, tmp, opt_idx, opt_data);
 		}
 
 		if(opts_ctxt->list[opt_idx].used)
@@ -616,7 +631,7 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 			}
 			else if(opt_type == TCP_OPT_WS &&
 			        (opts_ctxt->list[opt_idx].data_len != opt_len ||
-			         opts_ctxt->list[opt_idx].data.raw[2] != opt_data[2]))
+			         opts_ctxt->ws_value != opt_data[2]))
 			{
 				rohc_comp_debug(context, "    static option changed of value");
 				tmp->do_list_static_changed = true;
@@ -625,8 +640,7 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 			}
 			else if(opt_type == TCP_OPT_MSS &&
 			        (opts_ctxt->list[opt_idx].data_len != opt_len ||
-			         opts_ctxt->list[opt_idx].data.raw[2] != opt_data[2] ||
-			         opts_ctxt->list[opt_idx].data.raw[3] != opt_data[3]))
+			         memcmp(opts_ctxt->mss_value, opt_data + 2, 2) != 0))
 			{
 				rohc_comp_debug(context, "    static option changed of value");
 				tmp->do_list_static_changed = true;
@@ -635,8 +649,7 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 			}
 			else if(opt_idx == TCP_INDEX_SACK &&
 			        (tcp_ack_num_changed ||
-			         opt_len != opts_ctxt->list[opt_idx].data_len ||
-			         memcmp(opts_ctxt->list[opt_idx].data.raw, opt_data, opt_len) != 0))
+			         c_tcp_opt_changed(opts_ctxt, opt_idx, opt_data, opt_len)))
 			{
 				rohc_comp_debug(context, "    SACK option changed");
 				opts_ctxt->list[opt_idx].dyn_trans_nr = 0;
@@ -667,20 +680,20 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 			if(opt_idx != TCP_INDEX_NOP && opt_idx != TCP_INDEX_SACK_PERM)
 			{
 				if(opts_ctxt->list[opt_idx].full_trans_nr <
-				   context->compressor->oa_repetitions_nr)
+				   context->oa_repetitions_nr)
 				{
 					rohc_comp_debug(context, "    static part of option changed in last "
 					                "few packets, option shall be transmitted at least %u "
-					                "times more", context->compressor->oa_repetitions_nr -
+					                "times more", context->oa_repetitions_nr -
 					                opts_ctxt->list[opt_idx].full_trans_nr);
 				}
 				else if(opts_ctxt->list[opt_idx].dyn_trans_nr <
-				        context->compressor->oa_repetitions_nr)
+				        context->oa_repetitions_nr)
 				{
 					rohc_comp_debug(context, "    option '%s' changed of content "
 					                "in last few packets, option shall be transmitted "
 					                "at least %u times more", tcp_opt_get_descr(opt_type),
-					                context->compressor->oa_repetitions_nr -
+					                context->oa_repetitions_nr -
 					                opts_ctxt->list[opt_idx].dyn_trans_nr);
 				}
 				else
@@ -704,6 +717,7 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 			opts_ctxt->list[opt_idx].full_trans_nr = 0;
 			opts_ctxt->list[opt_idx].dyn_trans_nr = 0;
 			opts_ctxt->list[opt_idx].age = 0;
+			opts_ctxt->list[opt_idx].data_off = C_TCP_OPT_NO_DATA;
 			rohc_comp_debug(context, "    option '%s' (%u) will use new index %u",
 			                tcp_opt_get_descr(opt_type), opt_type, opt_idx);
 		}
@@ -716,6 +730,15 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 		/* record the structure of the current list TCP options in context */
 		opts_ctxt->structure[opt_pos] = opt_type;
 	}
+	if(!tmp->is_nop_ts_fast_path)
+	{
+		opts_ctxt->pkt_idxs = indexes_in_use;
+	}
+
+	if(!tmp->is_nop_ts_fast_path)
+	{
+		opts_ctxt->is_nop_ts_layout = !!(is_nop_ts_layout && tmp->opt_ts_present);
+	}
 
 	/* fewer options than in previous packet? */
 	for(opt_pos = opts_nr; opt_pos < opts_ctxt->structure_nr; opt_pos++)
@@ -745,13 +768,13 @@ void tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 		assert(opts_ctxt->structure_nr == opts_nr);
 		opts_ctxt->structure_nr_trans = 0;
 	}
-	else if(opts_ctxt->structure_nr_trans < context->compressor->oa_repetitions_nr)
+	else if(opts_ctxt->structure_nr_trans < context->oa_repetitions_nr)
 	{
 		/* the structure was transmitted but not enough times */
 		rohc_comp_debug(context, "structure of TCP options list changed in "
 		                "the last few packets, compressed list must be "
 		                "transmitted at least %u times more in the compressed "
-		                "base header", context->compressor->oa_repetitions_nr -
+		                "base header", context->oa_repetitions_nr -
 		                opts_ctxt->structure_nr_trans);
 		tmp->do_list_struct_changed = true;
 		assert(opts_ctxt->structure_nr == opts_nr);
@@ -957,7 +980,7 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
                               uint8_t *const comp_opts,
                               const size_t comp_opts_max_len)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	uint8_t *rohc_remain_data = comp_opts;
 	size_t rohc_remain_len = comp_opts_max_len;
 	size_t comp_opts_len = 0;
@@ -965,9 +988,38 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
 	const uint8_t opts_nr = uncomp_pkt_hdrs->tcp_opts.nr;
 	size_t opt_pos;
 
-	bool is_ok;
 	int ret;
 
+	/* with the NOP/TS layout, only the TS option has irregular content */
+	if(tmp->is_nop_ts_fast_path)
+	{
+		size_t ts_pos;
+
+		if(tmp->is_list_item_present[TCP_INDEX_TS])
+		{
+			rohc_comp_debug(context, "irregular chain: no irregular content for "
+			                "TCP options, TS option is transmitted in the compressed "
+			                "list of TCP options");
+			goto skip;
+		}
+		for(ts_pos = 0; uncomp_pkt_hdrs->tcp_opts.types[ts_pos] != TCP_OPT_TS; ts_pos++)
+		{
+			assert(ts_pos < opts_nr);
+		}
+		ret = c_tcp_code_opt_ts_irreg(context, opts_ctxt, tmp, TCP_INDEX_TS,
+		                              uncomp_pkt_hdrs->tcp_opts.data[ts_pos],
+		                              uncomp_pkt_hdrs->tcp_opts.lengths[ts_pos],
+		                              rohc_remain_data, rohc_remain_len);
+		if(ret < 0)
+		{
+			goto error;
+		}
+		rohc_comp_debug(context, "irregular chain: added %d bytes of irregular "
+		                "content for TCP option %u", ret, TCP_OPT_TS);
+		comp_opts_len += ret;
+		goto skip;
+	}
+
 	rohc_comp_debug(context, "irregular chain: encode irregular content for all "
 	                "TCP options");
 
@@ -999,40 +1051,17 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
 		/* encode the TCP option in its irregular form */
 		if(opt_type == TCP_OPT_TS)
 		{
-			size_t encoded_ts_lsb_len;
-
-			/* encode TS with ts_lsb() */
-			is_ok = c_tcp_ts_lsb_code(context, tmp->ts_req, tmp->ts_req_bytes_nr,
-			                          rohc_remain_data, rohc_remain_len,
-			                          &encoded_ts_lsb_len);
-			if(!is_ok)
-			{
-				rohc_comp_warn(context, "irregular chain: failed to encode echo "
-				               "request of TCP Timestamp option");
-				goto error;
-			}
-			rohc_remain_data += encoded_ts_lsb_len;
-			rohc_remain_len -= encoded_ts_lsb_len;
-			comp_opt_len += encoded_ts_lsb_len;
-
-			/* encode TS reply with ts_lsb()*/
-			is_ok = c_tcp_ts_lsb_code(context, tmp->ts_reply, tmp->ts_reply_bytes_nr,
-			                          rohc_remain_data, rohc_remain_len,
-			                          &encoded_ts_lsb_len);
-			if(!is_ok)
+			/* the TS option is transmitted once more in c_tcp_code_opt_ts_irreg() */
+			ret = c_tcp_code_opt_ts_irreg(context, opts_ctxt, tmp, opt_idx,
+			                              opt_data, opt_len, rohc_remain_data,
+			                              rohc_remain_len);
+			if(ret < 0)
 			{
-				rohc_comp_warn(context, "irregular chain: failed to encode echo "
-				               "reply of TCP Timestamp option");
 				goto error;
 			}
-			rohc_remain_data += encoded_ts_lsb_len;
-			rohc_remain_len -= encoded_ts_lsb_len;
-			comp_opt_len += encoded_ts_lsb_len;
-
-			/* save the option in context */
-			/* TODO: move at the very end of compression to avoid altering
-			 *       context in case of compression failure */
-			c_tcp_opt_record(opts_ctxt, opt_idx, opt_data, opt_len);
+			rohc_remain_data += ret;
+			rohc_remain_len -= ret;
+			comp_opt_len += ret;
 		}
 		else if(opt_type == TCP_OPT_SACK)
 		{
@@ -1119,12 +1148,14 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
 		comp_opts_len += comp_opt_len;
 
 		/* TCP option is transmitted towards decompressor once more */
-		if(opts_ctxt->list[opt_idx].dyn_trans_nr < oa_repetitions_nr)
+		if(opt_type != TCP_OPT_TS &&
+		   opts_ctxt->list[opt_idx].dyn_trans_nr < oa_repetitions_nr)
 		{
 			opts_ctxt->list[opt_idx].dyn_trans_nr++; /* TODO: do not update context here */
 		}
 	}
 
+skip:
 	return comp_opts_len;
 
 error:
@@ -1245,14 +1276,24 @@ static bool c_tcp_opt_changed(const struct c_tcp_opts_ctxt *const opts_ctxt,
                               const uint8_t *const pkt_opt,
                               const size_t pkt_opt_len)
 {
-	return (opts_ctxt->list[opt_idx].data_len != pkt_opt_len ||
-	        memcmp(opts_ctxt->list[opt_idx].data.raw, pkt_opt, pkt_opt_len) != 0);
+	const struct c_tcp_opt_ctxt *const opt_ctxt = &opts_ctxt->list[opt_idx];
+
+	/* the option that is not kept in the arena any more is considered as
+	 * changed, so that it is transmitted again */
+	return (opt_ctxt->data_len != pkt_opt_len ||
+	        opt_ctxt->data_off == C_TCP_OPT_NO_DATA ||
+	        memcmp(opts_ctxt->arena + opt_ctxt->data_off, pkt_opt, pkt_opt_len) != 0);
 }
 
 
 /**
  * @brief Record the TCP option in context
  *
+ * The values of the MSS and WS options are recorded in their fixed slots,
+ * the SACK and generic options in the arena. The options of the current
+ * packet always fit in the arena: the older options are dropped from the
+ * arena if there is no room left.
+ *
  * @param[out] opts_ctxt  The TCP compression context
  * @param opt_idx         The index of the TCP option in the TCP compression context
  * @param pkt_opt         The TCP option as found in the TCP packet
@@ -1263,8 +1304,78 @@ static void c_tcp_opt_record(struct c_tcp_opts_ctxt *const opts_ctxt,
                              const uint8_t *const pkt_opt,
                              const size_t pkt_opt_len)
 {
-	opts_ctxt->list[opt_idx].data_len = pkt_opt_len;
-	memcpy(opts_ctxt->list[opt_idx].data.raw, pkt_opt, pkt_opt_len);
+	struct c_tcp_opt_ctxt *const opt_ctxt = &opts_ctxt->list[opt_idx];
+
+	assert(pkt_opt_len <= ROHC_TCP_OPT_MAX_LEN);
+
+	if(opt_idx == TCP_INDEX_MSS)
+	{
+		memcpy(opts_ctxt->mss_value, pkt_opt + 2, 2);
+	}
+	else if(opt_idx == TCP_INDEX_WS)
+	{
+		opts_ctxt->ws_value = pkt_opt[2];
+	}
+	else if(opt_idx == TCP_INDEX_SACK || opt_idx >= TCP_INDEX_GENERIC7)
+	{
+		/* overwrite the option in place if its length did not change, move it
+		 * at the end of the arena otherwise */
+		if(opt_ctxt->data_off == C_TCP_OPT_NO_DATA ||
+		   opt_ctxt->data_len != pkt_opt_len)
+		{
+			opt_ctxt->data_off = C_TCP_OPT_NO_DATA;
+			if((opts_ctxt->arena_len + pkt_opt_len) > C_TCP_OPTS_ARENA_LEN)
+			{
+				c_tcp_opts_arena_compact(opts_ctxt, false);
+			}
+			if((opts_ctxt->arena_len + pkt_opt_len) > C_TCP_OPTS_ARENA_LEN)
+			{
+				c_tcp_opts_arena_compact(opts_ctxt, true);
+			}
+			assert((opts_ctxt->arena_len + pkt_opt_len) <= C_TCP_OPTS_ARENA_LEN);
+			opt_ctxt->data_off = opts_ctxt->arena_len;
+			opts_ctxt->arena_len += pkt_opt_len;
+		}
+		memcpy(opts_ctxt->arena + opt_ctxt->data_off, pkt_opt, pkt_opt_len);
+	}
+	opt_ctxt->data_len = pkt_opt_len;
+}
+
+
+/**
+ * @brief Remove the holes from the arena of the TCP options
+ *
+ * @param[in,out] opts_ctxt  The TCP compression context
+ * @param keep_pkt_only      Whether to drop the options that are not in the
+ *                           current packet from the arena
+ */
+static void c_tcp_opts_arena_compact(struct c_tcp_opts_ctxt *const opts_ctxt,
+                                     const bool keep_pkt_only)
+{
+	uint8_t arena[C_TCP_OPTS_ARENA_LEN];
+	uint8_t arena_len = 0;
+	uint8_t opt_idx;
+
+	for(opt_idx = TCP_INDEX_SACK; opt_idx <= MAX_TCP_OPTION_INDEX; opt_idx++)
+	{
+		struct c_tcp_opt_ctxt *const opt_ctxt = &opts_ctxt->list[opt_idx];
+
+		if(opt_ctxt->data_off == C_TCP_OPT_NO_DATA)
+		{
+			continue;
+		}
+		if(keep_pkt_only && (opts_ctxt->pkt_idxs & (1U << opt_idx)) == 0)
+		{
+			opt_ctxt->data_off = C_TCP_OPT_NO_DATA;
+			continue;
+		}
+		memcpy(arena + arena_len, opts_ctxt->arena + opt_ctxt->data_off,
+		       opt_ctxt->data_len);
+		opt_ctxt->data_off = arena_len;
+		arena_len += opt_ctxt->data_len;
+	}
+	memcpy(opts_ctxt->arena, arena, arena_len);
+	opts_ctxt->arena_len = arena_len;
 }
 
 
@@ -1591,14 +1702,14 @@ static bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context
 		                "or just changed", tcp_opt_get_descr(opt_type));
 		item_needed = true;
 	}
-	else if(opts_ctxt->list[opt_idx].full_trans_nr < context->compressor->oa_repetitions_nr)
+	else if(opts_ctxt->list[opt_idx].full_trans_nr < context->oa_repetitions_nr)
 	{
 		/* option was already transmitted and didn't change since then, but the
 		 * compressor is not confident yet that decompressor got the list item */
 		rohc_comp_debug(context, "TCP options list: option '%s' shall be "
 		                "transmitted %u times more to gain transmission confidence",
 		                tcp_opt_get_descr(opt_type),
-		                context->compressor->oa_repetitions_nr -
+		                context->oa_repetitions_nr -
 		                opts_ctxt->list[opt_idx].full_trans_nr);
 		item_needed = true;
 	}
@@ -1609,7 +1720,7 @@ static bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context
 		rohc_comp_debug(context, "TCP options list: option '%s' is unchanged and "
 		                "was transmitted at least %u times",
 		                tcp_opt_get_descr(opt_type),
-		                context->compressor->oa_repetitions_nr);
+		                context->oa_repetitions_nr);
 		item_needed = false;
 	}
 
@@ -1953,3 +2064,120 @@ error:
 	return -1;
 }
 
+
+/**
+ * @brief Detect the changes of the TCP Timestamp (TS) option
+ *
+ * @param context            The compression context
+ * @param[in,out] opts_ctxt  The compression context for TCP options
+ * @param[in,out] tmp        The temporary state for compressed TCP options
+ * @param opt_idx            The index of the TS option
+ * @param opt_data           The TS option of the packet
+ */
+static void c_tcp_detect_opt_ts_changes(const struct rohc_comp_ctxt *const context,
+                                        struct c_tcp_opts_ctxt *const opts_ctxt,
+                                        struct c_tcp_opts_ctxt_tmp *const tmp,
+                                        const uint8_t opt_idx,
+                                        const uint8_t *const opt_data)
+{
+	const struct tcp_option_timestamp *const opt_ts =
+		(struct tcp_option_timestamp *) (opt_data + 2);
+
+	tmp->opt_ts_present = true;
+
+	tmp->ts_req = rohc_ntoh32(opt_ts->ts);
+	tmp->ts_req_bytes_nr =
+		tcp_opt_ts_one_can_be_encoded(&opts_ctxt->ts_req_wlsb, tmp->ts_req);
+
+	tmp->ts_reply = rohc_ntoh32(opt_ts->ts_reply);
+	tmp->ts_reply_bytes_nr =
+		tcp_opt_ts_one_can_be_encoded(&opts_ctxt->ts_reply_wlsb, tmp->ts_reply);
+
+	if(tmp->ts_req_bytes_nr == 0 || tmp->ts_reply_bytes_nr == 0)
+	{
+		rohc_comp_debug(context, "    TS option shall be transmitted as "
+		                "list item in one of dynamic, replicate or CO "
+		                "chains");
+		tmp->opt_ts_do_transmit_item = true;
+		opts_ctxt->list[opt_idx].full_trans_nr = 0;
+		opts_ctxt->list[opt_idx].dyn_trans_nr = 0;
+	}
+	else if(opts_ctxt->list[opt_idx].full_trans_nr <
+	        context->oa_repetitions_nr)
+	{
+		rohc_comp_debug(context, "    TS option changed in the last few packets, "
+		                "TS option shall be transmitted at least %u times more "
+		                "as list item in one of dynamic, replicate or CO chains",
+		                context->oa_repetitions_nr -
+		                opts_ctxt->list[opt_idx].full_trans_nr);
+		tmp->opt_ts_do_transmit_item = true;
+	}
+	else
+	{
+		rohc_comp_debug(context, "    TS option can be encoded in "
+		                "irregular chain");
+	}
+}
+
+
+/**
+ * @brief Encode the TCP Timestamp (TS) option in the irregular chain
+ *
+ * @param context            The compression context
+ * @param[in,out] opts_ctxt  The compression context for TCP options
+ * @param tmp                The temporary state for compressed TCP options
+ * @param opt_idx            The index of the TS option
+ * @param opt_data           The TS option of the packet
+ * @param opt_len            The length of the TS option of the packet
+ * @param[out] rohc_data     The irregular content of the TS option
+ * @param rohc_max_len       The max remaining length in the ROHC buffer
+ * @return                   The length (in bytes) of the irregular content
+ *                           in case of success, -1 in case of failure
+ */
+static int c_tcp_code_opt_ts_irreg(const struct rohc_comp_ctxt *const context,
+                                   struct c_tcp_opts_ctxt *const opts_ctxt,
+                                   const struct c_tcp_opts_ctxt_tmp *const tmp,
+                                   const uint8_t opt_idx,
+                                   const uint8_t *const opt_data,
+                                   const uint8_t opt_len,
+                                   uint8_t *const rohc_data,
+                                   const size_t rohc_max_len)
+{
+	size_t encoded_ts_req_len;
+	size_t encoded_ts_reply_len;
+
+	/* encode TS with ts_lsb() */
+	if(!c_tcp_ts_lsb_code(context, tmp->ts_req, tmp->ts_req_bytes_nr,
+	                      rohc_data, rohc_max_len, &encoded_ts_req_len))
+	{
+		rohc_comp_warn(context, "irregular chain: failed to encode echo "
+		               "request of TCP Timestamp option");
+		goto error;
+	}
+
+	/* encode TS reply with ts_lsb()*/
+	if(!c_tcp_ts_lsb_code(context, tmp->ts_reply, tmp->ts_reply_bytes_nr,
+	                      rohc_data + encoded_ts_req_len,
+	                      rohc_max_len - encoded_ts_req_len, &encoded_ts_reply_len))
+	{
+		rohc_comp_warn(context, "irregular chain: failed to encode echo "
+		               "reply of TCP Timestamp option");
+		goto error;
+	}
+
+	/* save the option in context */
+	/* TODO: move at the very end of compression to avoid altering
+	 *       context in case of compression failure */
+	c_tcp_opt_record(opts_ctxt, opt_idx, opt_data, opt_len);
+
+	/* TCP option is transmitted towards decompressor once more */
+	if(opts_ctxt->list[opt_idx].dyn_trans_nr < context->oa_repetitions_nr)
+	{
+		opts_ctxt->list[opt_idx].dyn_trans_nr++; /* TODO: do not update context here */
+	}
+
+	return (encoded_ts_req_len + encoded_ts_reply_len);
+
+error:
+	return -1;
+}
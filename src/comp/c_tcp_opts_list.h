@@ -37,18 +37,28 @@
 #include <stddef.h>
 
 
+/**
+ * @brief The length of the arena of the compression context for TCP options
+ *
+ * The arena keeps the SACK and generic TCP options, the only ones of
+ * variable length. It is larger than the TCP options of one packet, so that
+ * it keeps the options of the current packet and a few older ones.
+ */
+#define C_TCP_OPTS_ARENA_LEN  64U
+
+/** The offset of one TCP option that is not kept in the arena */
+#define C_TCP_OPT_NO_DATA  0xffU
+
+
 /**
  * @brief The compression context for one TCP option
+ *
+ * The values of the MSS and WS options are kept in fixed slots of the
+ * compression context for TCP options, the SACK and generic options in its
+ * arena. The values of the TS option are kept in W-LSB windows.
  */
 struct c_tcp_opt_ctxt
 {
-	/** The TCP option data */
-	union
-	{
-		uint8_t raw[ROHC_TCP_OPT_MAX_LEN];
-		sack_block_t sack_blocks[4];
-		struct tcp_option_timestamp timestamp;
-	} data;
 	/** The number of times the full TCP option was transmitted */
 	uint8_t full_trans_nr;
 	/** The number of times the dynamic part of TCP option was transmitted */
@@ -60,14 +70,16 @@ struct c_tcp_opt_ctxt
 	uint8_t age;
 	/** The length of the TCP option */
 	uint8_t data_len;
+	/** The offset of the TCP option in the arena, \ref C_TCP_OPT_NO_DATA if
+	 *  the option is not kept */
+	uint8_t data_off;
+	uint8_t unused[1];
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
 #if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
      (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
       (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
-_Static_assert((offsetof(struct c_tcp_opt_ctxt, data) % 8) == 0,
-               "data in c_tcp_opt_ctxt should be aligned on 8 bytes");
 _Static_assert((sizeof(struct c_tcp_opt_ctxt) % 8) == 0,
                "c_tcp_opt_ctxt length should be multiple of 8 bytes");
 #endif
@@ -101,7 +113,10 @@ struct c_tcp_opts_ctxt_tmp
 	/** Whether the TCP option timestamp echo request is present in packet */
 	uint8_t opt_ts_present:1;
 	uint8_t opt_ts_do_transmit_item:1;
-	uint8_t unused:4;
+	/** Whether the options of the packet are the NOP/TS layout of the
+	 * previous packet, see \ref c_tcp_opts_ctxt::is_nop_ts_layout */
+	uint8_t is_nop_ts_fast_path:1;
+	uint8_t unused:3;
 
 	uint8_t ts_req_bytes_nr:4;
 	uint8_t ts_reply_bytes_nr:4;
@@ -131,13 +146,28 @@ struct c_tcp_opts_ctxt
 	uint8_t structure_nr;
 	struct c_tcp_opt_ctxt list[MAX_TCP_OPTION_INDEX + 1];
 
+	/** The value of the MSS option (in NBO) */
+	uint8_t mss_value[2];
+	/** The value of the WS option */
+	uint8_t ws_value;
+	/** The length of the arena in use, holes included */
+	uint8_t arena_len;
+	/** The indexes of the options of the current packet */
+	uint16_t pkt_idxs;
+	uint8_t unused2[2];
+	/** The SACK and generic TCP options, see \ref C_TCP_OPTS_ARENA_LEN */
+	uint8_t arena[C_TCP_OPTS_ARENA_LEN];
+
 	struct c_wlsb ts_req_wlsb;
 	struct c_wlsb ts_reply_wlsb;
 
 	/** The number of times the structure of the list of TCP options was
 	 * transmitted since it last changed */
 	uint8_t structure_nr_trans;
-	uint8_t unused[6];
+	/** Whether the structure of the list of TCP options is made of one TS
+	 * option and NOP options only, the common layout of bulk TCP flows */
+	bool is_nop_ts_layout;
+	uint8_t unused[5];
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -148,6 +178,8 @@ _Static_assert((offsetof(struct c_tcp_opts_ctxt, structure) % 8) == 0,
                "structure in c_tcp_opts_ctxt should be aligned on 8 bytes");
 _Static_assert((offsetof(struct c_tcp_opts_ctxt, list) % 8) == 0,
                "list in c_tcp_opts_ctxt should be aligned on 8 bytes");
+_Static_assert((offsetof(struct c_tcp_opts_ctxt, arena) % 8) == 0,
+               "arena in c_tcp_opts_ctxt should be aligned on 8 bytes");
 _Static_assert((offsetof(struct c_tcp_opts_ctxt, ts_req_wlsb) % 8) == 0,
                "ts_req_wlsb in c_tcp_opts_ctxt should be aligned on 8 bytes");
 _Static_assert((offsetof(struct c_tcp_opts_ctxt, ts_reply_wlsb) % 8) == 0,
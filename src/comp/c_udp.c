@@ -141,7 +141,8 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 	                rfc3095_ctxt->sn);
 
 	/* create the UDP part of the profile context */
-	udp_context = malloc(sizeof(struct sc_udp_context));
+	udp_context = rohc_mempool_alloc(&context->compressor->mempool,
+	                                 sizeof(struct sc_udp_context));
 	if(udp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -149,6 +150,7 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 		goto clean;
 	}
 	rfc3095_ctxt->specific = udp_context;
+	rfc3095_ctxt->specific_len = sizeof(struct sc_udp_context);
 
 	/* initialize the UDP part of the profile context */
 	udp_context->udp_checksum_change_count = 0;
@@ -402,7 +404,7 @@ static size_t udp_code_dynamic_udp_part(const struct rohc_comp_ctxt *const conte
 static int udp_changed_udp_dynamic(const struct rohc_comp_ctxt *context,
                                    const struct udphdr *udp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_udp_context *udp_context;
 
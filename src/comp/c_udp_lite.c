@@ -182,7 +182,8 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 	                rfc3095_ctxt->sn);
 
 	/* create the UDP-Lite part of the profile context */
-	udp_lite_context = malloc(sizeof(struct sc_udp_lite_context));
+	udp_lite_context = rohc_mempool_alloc(&context->compressor->mempool,
+	                                      sizeof(struct sc_udp_lite_context));
 	if(udp_lite_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -190,6 +191,7 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 		goto clean;
 	}
 	rfc3095_ctxt->specific = udp_lite_context;
+	rfc3095_ctxt->specific_len = sizeof(struct sc_udp_lite_context);
 
 	/* initialize the UDP-Lite part of the profile context */
 	udp_lite_context->cfp = 0;
@@ -517,7 +519,7 @@ static void udp_lite_init_cc(struct rohc_comp_ctxt *const context,
 static bool udp_lite_send_cce_packet(const struct rohc_comp_ctxt *const context,
                                      const struct udphdr *const udp_lite)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	struct sc_udp_lite_context *const udp_lite_context = rfc3095_ctxt->specific;
 	int is_coverage_inferred;
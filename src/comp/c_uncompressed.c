@@ -45,6 +45,16 @@ static bool c_uncompressed_create(struct rohc_comp_ctxt *const context,
 static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+/* save/restore context */
+static size_t c_uncompressed_save(const struct rohc_comp_ctxt *const ctxt,
+                                  uint8_t *const image,
+                                  const size_t image_max_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool c_uncompressed_restore(struct rohc_comp_ctxt *const ctxt,
+                                   const uint8_t *const image,
+                                   const size_t image_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 /* encode uncompressed packets */
 static int c_uncompressed_encode(struct rohc_comp_ctxt *const context,
                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -128,6 +138,41 @@ static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Save the Uncompressed part of one context in a context image
+ *
+ * The Uncompressed profile has no profile-specific part to save.
+ *
+ * @param ctxt           The compression context
+ * @param image          The image to save the context in, may be NULL
+ * @param image_max_len  The length available in the image
+ * @return               The length of the profile-specific part, always 0
+ */
+static size_t c_uncompressed_save(const struct rohc_comp_ctxt *const ctxt __attribute__((unused)),
+                                  uint8_t *const image __attribute__((unused)),
+                                  const size_t image_max_len __attribute__((unused)))
+{
+	return 0;
+}
+
+
+/**
+ * @brief Restore the Uncompressed part of one context from a context image
+ *
+ * @param ctxt       The compression context
+ * @param image      The part saved by \ref c_uncompressed_save
+ * @param image_len  The length of the part saved, shall be 0
+ * @return           true if successful, false otherwise
+ */
+static bool c_uncompressed_restore(struct rohc_comp_ctxt *const ctxt,
+                                   const uint8_t *const image __attribute__((unused)),
+                                   const size_t image_len)
+{
+	ctxt->specific = NULL;
+	return (image_len == 0);
+}
+
+
 /**
  * @brief Encode an IP packet according to a pattern decided by several
  *        different factors.
@@ -246,7 +291,7 @@ static void uncompressed_decide_state(struct rohc_comp_ctxt *const context,
                                       const struct rohc_ts pkt_time,
                                       const ip_version ip_vers)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 
 	/* non-IPv4/6 packets cannot be compressed with Normal packets because the
 	 * first byte could be mis-interpreted as ROHC packet types (see note at
@@ -424,7 +469,8 @@ static int uncompressed_code_IR_packet(const struct rohc_comp_ctxt *context,
 
 	/* part 5 */
 	rohc_pkt[counter] = 0;
-	rohc_pkt[counter] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter, CRC_INIT_8);
+	rohc_pkt[counter] = crc_engine_calc(&context->compressor->crc_engine,
+	                                    ROHC_CRC_TYPE_8, rohc_pkt, counter, CRC_INIT_8);
 	rohc_comp_debug(context, "CRC on %zu bytes = 0x%02x", counter,
 	                rohc_pkt[counter]);
 	counter++;
@@ -522,6 +568,8 @@ const struct rohc_comp_profile c_uncompressed_profile =
 	.id             = ROHC_PROFILE_UNCOMPRESSED, /* profile ID (RFC3095, §8) */
 	.create         = c_uncompressed_create,     /* profile handlers */
 	.destroy        = c_uncompressed_destroy,
+	.save           = c_uncompressed_save,
+	.restore        = c_uncompressed_restore,
 	.encode         = c_uncompressed_encode,
 	.feedback       = uncomp_feedback,
 };
@@ -0,0 +1,581 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   comp_rfc5225.c
+ * @brief  Functions shared by the ROHCv2 compression profiles
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "comp_rfc5225.h"
+#include "rohc_traces_internal.h"
+#include "rohc_bit_ops.h"
+#include "interval.h"
+#include "protocols/rfc5225.h"
+
+#include <string.h>
+#include <assert.h>
+
+
+/** The packet formats of the IP-only, IP/UDP and IP/UDP/RTP profiles */
+static const struct rohc_comp_rfc5225_pkt_candidate rohc_comp_rfc5225_nortp[] = {
+	/* pt_0_crc3: CRC-3, 4 MSN bits, IP-ID not transmitted */
+	{ ROHC_PACKET_PT_0_CRC3,
+	  ROHC_RFC5225_PKT_COND_CRC3 | ROHC_RFC5225_PKT_COND_MSN_4BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_NOT_SENT | ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* pt_0_crc7: 6 MSN bits, IP-ID not transmitted */
+	{ ROHC_PACKET_NORTP_PT_0_CRC7,
+	  ROHC_RFC5225_PKT_COND_MSN_6BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_NOT_SENT | ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* pt_1_seq_id: CRC-3, 6 MSN bits, 4 bits of sequential IP-ID offset */
+	{ ROHC_PACKET_NORTP_PT_1_SEQ_ID,
+	  ROHC_RFC5225_PKT_COND_CRC3 | ROHC_RFC5225_PKT_COND_MSN_6BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_SEQ | ROHC_RFC5225_PKT_COND_IPID_4BITS |
+	  ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* pt_2_seq_id: 8 MSN bits, 6 bits of sequential IP-ID offset */
+	{ ROHC_PACKET_NORTP_PT_2_SEQ_ID,
+	  ROHC_RFC5225_PKT_COND_MSN_8BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_SEQ | ROHC_RFC5225_PKT_COND_IPID_6BITS |
+	  ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* co_common: 8 MSN bits, outer DF and IP-ID behaviors unchanged */
+	{ ROHC_PACKET_CO_COMMON,
+	  ROHC_RFC5225_PKT_COND_MSN_8BITS | ROHC_RFC5225_PKT_COND_OUTER_STABLE },
+};
+
+/** The packet formats of the IP/ESP profile */
+static const struct rohc_comp_rfc5225_pkt_candidate rohc_comp_rfc5225_esp[] = {
+	/* pt_0_crc3: CRC-3, 4 MSN bits, IP-ID not transmitted */
+	{ ROHC_PACKET_PT_0_CRC3,
+	  ROHC_RFC5225_PKT_COND_CRC3 | ROHC_RFC5225_PKT_COND_MSN_4BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_NOT_SENT | ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* pt_0_crc7: 6 MSN bits, IP-ID not transmitted */
+	{ ROHC_PACKET_NORTP_PT_0_CRC7,
+	  ROHC_RFC5225_PKT_COND_MSN_6BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_NOT_SENT | ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* pt_1_seq_id: CRC-3, 6 MSN bits, 4 bits of sequential IP-ID offset */
+	{ ROHC_PACKET_NORTP_PT_1_SEQ_ID,
+	  ROHC_RFC5225_PKT_COND_CRC3 | ROHC_RFC5225_PKT_COND_MSN_6BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_SEQ | ROHC_RFC5225_PKT_COND_IPID_4BITS |
+	  ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* pt_2_seq_id: 8 MSN bits, 6 bits of sequential IP-ID offset */
+	{ ROHC_PACKET_NORTP_PT_2_SEQ_ID,
+	  ROHC_RFC5225_PKT_COND_MSN_8BITS |
+	  ROHC_RFC5225_PKT_COND_IPID_SEQ | ROHC_RFC5225_PKT_COND_IPID_6BITS |
+	  ROHC_RFC5225_PKT_COND_IP_STABLE | ROHC_RFC5225_PKT_COND_CTRL_STABLE },
+	/* co_common: the full ESP SN is transmitted in the irregular chain, only
+	 * the outer DF and IP-ID behaviors shall be unchanged */
+	{ ROHC_PACKET_CO_COMMON,
+	  ROHC_RFC5225_PKT_COND_OUTER_STABLE },
+};
+
+const struct rohc_comp_rfc5225_pkt_candidates rohc_comp_rfc5225_pkts_nortp = {
+	.nr = sizeof(rohc_comp_rfc5225_nortp) / sizeof(rohc_comp_rfc5225_nortp[0]),
+	.candidates = rohc_comp_rfc5225_nortp,
+};
+
+const struct rohc_comp_rfc5225_pkt_candidates rohc_comp_rfc5225_pkts_esp = {
+	.nr = sizeof(rohc_comp_rfc5225_esp) / sizeof(rohc_comp_rfc5225_esp[0]),
+	.candidates = rohc_comp_rfc5225_esp,
+};
+
+
+/**
+ * @brief Decide which packet to send when in FO or SO state
+ *
+ * The MSN and the innermost IP-ID offset are compared with their W-LSB
+ * windows once, then the numbers of bits required by all the packet formats
+ * are checked from the computed ranges. The smallest candidate of the
+ * profile whose requirements are all fulfilled is chosen, co_repair if none.
+ *
+ * @param ctxt           The compression context
+ * @param pkts           The packet formats that the profile may choose
+ * @param input          The current values that decide the packet format
+ * @param crc7_at_least  Whether packet types with CRC strictly smaller
+ *                       than 7 bits are allowed or not
+ * @return               The packet type among the candidates of the profile
+ *                       or ROHC_PACKET_CO_REPAIR
+ */
+rohc_packet_t rohc_comp_rfc5225_decide_FO_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                 const struct rohc_comp_rfc5225_pkt_candidates *const pkts,
+                                                 const struct rohc_comp_rfc5225_pkt_input *const input,
+                                                 const bool crc7_at_least)
+{
+	const rohc_reordering_offset_t reorder_ratio = ctxt->reorder_ratio;
+	rohc_packet_t packet_type = ROHC_PACKET_CO_REPAIR;
+	struct wlsb_range range;
+	uint16_t conds = 0;
+	size_t i;
+
+	if(!crc7_at_least)
+	{
+		conds |= ROHC_RFC5225_PKT_COND_CRC3;
+	}
+
+	/* how many MSN bits are required? */
+	if(input->msn_bits_nr == 32)
+	{
+		wlsb_get_range_32bits(input->msn_wlsb, input->msn, &range);
+	}
+	else
+	{
+		assert(input->msn_bits_nr == 16);
+		wlsb_get_range_16bits(input->msn_wlsb, input->msn, &range);
+	}
+	if(wlsb_range_is_kp_possible(&range, 4,
+	                             rohc_interval_get_rfc5225_msn_p(4, reorder_ratio)))
+	{
+		conds |= ROHC_RFC5225_PKT_COND_MSN_4BITS;
+	}
+	if(wlsb_range_is_kp_possible(&range, 6,
+	                             rohc_interval_get_rfc5225_msn_p(6, reorder_ratio)))
+	{
+		conds |= ROHC_RFC5225_PKT_COND_MSN_6BITS;
+	}
+	if(wlsb_range_is_kp_possible(&range, 8,
+	                             rohc_interval_get_rfc5225_msn_p(8, reorder_ratio)))
+	{
+		conds |= ROHC_RFC5225_PKT_COND_MSN_8BITS;
+	}
+
+	/* how is the innermost IP-ID transmitted? */
+	if(!input->is_ip_id_seq)
+	{
+		conds |= ROHC_RFC5225_PKT_COND_IPID_NOT_SENT;
+	}
+	else
+	{
+		conds |= ROHC_RFC5225_PKT_COND_IPID_SEQ;
+		if(input->is_ip_id_inferred)
+		{
+			conds |= ROHC_RFC5225_PKT_COND_IPID_NOT_SENT;
+		}
+		wlsb_get_range_16bits(input->ip_id_offset_wlsb, input->ip_id_offset, &range);
+		if(wlsb_range_is_kp_possible(&range, 4, rohc_interval_get_rfc5225_id_id_p(4)))
+		{
+			conds |= ROHC_RFC5225_PKT_COND_IPID_4BITS;
+		}
+		if(wlsb_range_is_kp_possible(&range, 6, rohc_interval_get_rfc5225_id_id_p(6)))
+		{
+			conds |= ROHC_RFC5225_PKT_COND_IPID_6BITS;
+		}
+	}
+
+	if(!input->ip_changed)
+	{
+		conds |= ROHC_RFC5225_PKT_COND_IP_STABLE;
+	}
+	if(!input->outer_ip_changed)
+	{
+		conds |= ROHC_RFC5225_PKT_COND_OUTER_STABLE;
+	}
+	/* the packet formats without control fields use the reorder ratio known
+	 * by the decompressor */
+	if(ctxt->reorder_ratio_trans_nr >= ctxt->oa_repetitions_nr)
+	{
+		conds |= ROHC_RFC5225_PKT_COND_CTRL_STABLE;
+	}
+
+	/* choose the smallest packet format whose requirements are fulfilled,
+	 * the co_repair packet is enough to transmit all the dynamic changes ;
+	 * if there were static changes, the context would have been reset by
+	 * the stream classifier */
+	for(i = 0; i < pkts->nr; i++)
+	{
+		const uint16_t required = pkts->candidates[i].required;
+
+		if((conds & required) == required)
+		{
+			packet_type = pkts->candidates[i].type;
+			break;
+		}
+	}
+	rohc_comp_debug(ctxt, "code %s packet (conditions 0x%03x)",
+	                rohc_get_packet_descr(packet_type), conds);
+
+	return packet_type;
+}
+
+
+
+/**
+ * @brief Save the profile-specific part of one ROHCv2 context in an image
+ *
+ * The profile-specific part is saved bytewise, then the entries of the W-LSB
+ * windows too wide to be stored inline follow.
+ *
+ * @param ctxt               The compression context
+ * @param specific_len       The length of the profile-specific part
+ * @param msn_wlsb_offset    The offset of the W-LSB object for the MSN
+ * @param ip_id_wlsb_offset  The offset of the W-LSB object for the IP-ID offset
+ * @param image              The image to save the context in, may be NULL
+ * @param image_max_len      The length available in the image
+ * @return                   The length of the profile-specific part of the
+ *                           context, saved only if it fits in the image
+ */
+size_t rohc_comp_rfc5225_save(const struct rohc_comp_ctxt *const ctxt,
+                              const size_t specific_len,
+                              const size_t msn_wlsb_offset,
+                              const size_t ip_id_wlsb_offset,
+                              uint8_t *const image,
+                              const size_t image_max_len)
+{
+	const uint8_t *const specific = ctxt->specific;
+	const struct c_wlsb *const msn_wlsb =
+		(const struct c_wlsb *) (specific + msn_wlsb_offset);
+	const struct c_wlsb *const ip_id_wlsb =
+		(const struct c_wlsb *) (specific + ip_id_wlsb_offset);
+	const size_t msn_wlsb_len = wlsb_get_image_len(msn_wlsb);
+	const size_t image_len =
+		specific_len + msn_wlsb_len + wlsb_get_image_len(ip_id_wlsb);
+
+	if(image != NULL && image_len <= image_max_len)
+	{
+		memcpy(image, specific, specific_len);
+		wlsb_save(msn_wlsb, image + specific_len);
+		wlsb_save(ip_id_wlsb, image + specific_len + msn_wlsb_len);
+	}
+
+	return image_len;
+}
+
+
+/**
+ * @brief Restore the profile-specific part of one ROHCv2 context from an image
+ *
+ * @param ctxt               The compression context
+ * @param specific_len       The length of the profile-specific part
+ * @param msn_wlsb_offset    The offset of the W-LSB object for the MSN
+ * @param ip_id_wlsb_offset  The offset of the W-LSB object for the IP-ID offset
+ * @param image              The part saved by \ref rohc_comp_rfc5225_save
+ * @param image_len          The length of the part saved
+ * @return                   true if successful, false otherwise
+ */
+bool rohc_comp_rfc5225_restore(struct rohc_comp_ctxt *const ctxt,
+                               const size_t specific_len,
+                               const size_t msn_wlsb_offset,
+                               const size_t ip_id_wlsb_offset,
+                               const uint8_t *const image,
+                               const size_t image_len)
+{
+	struct rohc_mempool *const mempool = &ctxt->compressor->mempool;
+	struct c_wlsb *msn_wlsb;
+	struct c_wlsb *ip_id_wlsb;
+	size_t msn_wlsb_len;
+	uint8_t *specific;
+
+	if(image_len < specific_len)
+	{
+		rohc_comp_warn(ctxt, "context image too short for the profile-specific "
+		               "part: %zu bytes while %zu bytes required at least",
+		               image_len, specific_len);
+		goto error;
+	}
+
+	specific = rohc_mempool_alloc(mempool, specific_len);
+	if(specific == NULL)
+	{
+		rohc_comp_warn(ctxt, "no memory for the profile-specific part of the "
+		               "restored context");
+		goto error;
+	}
+	memcpy(specific, image, specific_len);
+	msn_wlsb = (struct c_wlsb *) (specific + msn_wlsb_offset);
+	ip_id_wlsb = (struct c_wlsb *) (specific + ip_id_wlsb_offset);
+
+	/* the W-LSB windows are checked before their entries are located */
+	msn_wlsb_len = wlsb_get_image_len(msn_wlsb);
+	if(msn_wlsb_len > (image_len - specific_len))
+	{
+		rohc_comp_warn(ctxt, "malformed context image: truncated MSN window");
+		goto free_specific;
+	}
+	if(!wlsb_restore(msn_wlsb, mempool, image + specific_len, msn_wlsb_len))
+	{
+		rohc_comp_warn(ctxt, "malformed context image: bad MSN window");
+		goto free_specific;
+	}
+	if(!wlsb_restore(ip_id_wlsb, mempool, image + specific_len + msn_wlsb_len,
+	                 image_len - specific_len - msn_wlsb_len))
+	{
+		rohc_comp_warn(ctxt, "malformed context image: bad IP-ID offset window");
+		goto free_msn_wlsb;
+	}
+	ctxt->specific = specific;
+
+	return true;
+
+free_msn_wlsb:
+	wlsb_free(msn_wlsb);
+free_specific:
+	rohc_mempool_release(mempool, specific, specific_len);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decide the state that should be used for the next packet
+ *
+ * @param context  The compression context
+ * @param pkt_time The time of packet arrival
+ */
+void rohc_comp_rfc5225_decide_state(struct rohc_comp_ctxt *const context,
+                                    const struct rohc_ts pkt_time)
+{
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
+	const rohc_comp_state_t curr_state = context->state;
+	rohc_comp_state_t next_state;
+
+	assert(curr_state != ROHC_COMP_STATE_UNKNOWN);
+	assert(curr_state != ROHC_COMP_STATE_CR);
+
+	if(curr_state == ROHC_COMP_STATE_SO)
+	{
+		/* do not change state */
+		rohc_comp_debug(context, "stay in SO state");
+		next_state = ROHC_COMP_STATE_SO;
+		/* TODO: handle NACK and STATIC-NACK */
+	}
+	else if(context->state_oa_repeat_nr < oa_repetitions_nr)
+	{
+		rohc_comp_debug(context, "not enough packets transmitted in current state "
+		                "for the moment (%u/%u), so stay in current state",
+		                context->state_oa_repeat_nr, oa_repetitions_nr);
+		next_state = curr_state;
+	}
+	else
+	{
+		rohc_comp_debug(context, "enough packets transmitted in current state "
+		                "(%u/%u), go to upper state", context->state_oa_repeat_nr,
+		                oa_repetitions_nr);
+		next_state = ROHC_COMP_STATE_SO;
+	}
+
+	rohc_comp_change_state(context, next_state);
+
+	/* periodic refreshes in U-mode only */
+	if(context->mode == ROHC_U_MODE)
+	{
+		rohc_comp_periodic_down_transition(context, pkt_time);
+	}
+}
+
+
+/**
+ * @brief Build the static part of the IPv4 header
+ *
+ * @param ctxt            The compression context
+ * @param ipv4            The IPv4 header
+ * @param is_innermost    Whether the IPv4 header is the innermost IP header
+ * @param[out] rohc_data  The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+int rohc_comp_rfc5225_static_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                       const struct ipv4_hdr *const ipv4,
+                                       const bool is_innermost,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+{
+	ipv4_static_t *const ipv4_static = (ipv4_static_t *) rohc_data;
+	const size_t ipv4_static_len = sizeof(ipv4_static_t);
+
+	if(rohc_max_len < ipv4_static_len)
+	{
+		rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv4 static part: "
+		               "%zu bytes required, but only %zu bytes available",
+		               ipv4_static_len, rohc_max_len);
+		goto error;
+	}
+
+	ipv4_static->version_flag = 0;
+	ipv4_static->innermost_ip = GET_REAL(is_innermost);
+	ipv4_static->reserved = 0;
+	ipv4_static->protocol = ipv4->protocol;
+	rohc_comp_debug(ctxt, "IPv4 protocol = %u", ipv4_static->protocol);
+	ipv4_static->src_addr = ipv4->saddr;
+	ipv4_static->dst_addr = ipv4->daddr;
+
+	rohc_comp_dump_buf(ctxt, "IPv4 static part", rohc_data, ipv4_static_len);
+
+	return ipv4_static_len;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the static part of the IPv6 header
+ *
+ * @param ctxt            The compression context
+ * @param ipv6            The IPv6 header
+ * @param is_innermost    Whether the IPv6 header is the innermost IP header
+ * @param[out] rohc_data  The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+int rohc_comp_rfc5225_static_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                       const struct ipv6_hdr *const ipv6,
+                                       const bool is_innermost,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+{
+	size_t ipv6_static_len;
+
+	if(ipv6->flow1 == 0 && ipv6->flow2 == 0)
+	{
+		ipv6_static_nofl_t *const ipv6_static = (ipv6_static_nofl_t *) rohc_data;
+
+		ipv6_static_len = sizeof(ipv6_static_nofl_t);
+		if(rohc_max_len < ipv6_static_len)
+		{
+			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv6 static part: "
+			               "%zu bytes required, but only %zu bytes available",
+			               ipv6_static_len, rohc_max_len);
+			goto error;
+		}
+
+		ipv6_static->version_flag = 1;
+		ipv6_static->innermost_ip = GET_REAL(is_innermost);
+		ipv6_static->reserved1 = 0;
+		ipv6_static->flow_label_enc_discriminator = 0;
+		ipv6_static->reserved2 = 0;
+		ipv6_static->next_header = ipv6->nh;
+		memcpy(ipv6_static->src_addr, &ipv6->saddr, sizeof(struct ipv6_addr));
+		memcpy(ipv6_static->dst_addr, &ipv6->daddr, sizeof(struct ipv6_addr));
+	}
+	else
+	{
+		ipv6_static_fl_t *const ipv6_static = (ipv6_static_fl_t *) rohc_data;
+
+		ipv6_static_len = sizeof(ipv6_static_fl_t);
+		if(rohc_max_len < ipv6_static_len)
+		{
+			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv6 static part: "
+			               "%zu bytes required, but only %zu bytes available",
+			               ipv6_static_len, rohc_max_len);
+			goto error;
+		}
+
+		ipv6_static->version_flag = 1;
+		ipv6_static->innermost_ip = GET_REAL(is_innermost);
+		ipv6_static->reserved = 0;
+		ipv6_static->flow_label_enc_discriminator = 1;
+		ipv6_static->flow_label_msb = ipv6->flow1;
+		ipv6_static->flow_label_lsb = ipv6->flow2;
+		ipv6_static->next_header = ipv6->nh;
+		memcpy(ipv6_static->src_addr, &ipv6->saddr, sizeof(struct ipv6_addr));
+		memcpy(ipv6_static->dst_addr, &ipv6->daddr, sizeof(struct ipv6_addr));
+	}
+	rohc_comp_debug(ctxt, "IPv6 next header = %u", ipv6->nh);
+
+	rohc_comp_dump_buf(ctxt, "IPv6 static part", rohc_data, ipv6_static_len);
+
+	return ipv6_static_len;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the static part of the UDP header
+ *
+ * @param ctxt            The compression context
+ * @param udp             The UDP header
+ * @param[out] rohc_data  The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+int rohc_comp_rfc5225_static_udp_part(const struct rohc_comp_ctxt *const ctxt,
+                                      const struct udphdr *const udp,
+                                      uint8_t *const rohc_data,
+                                      const size_t rohc_max_len)
+{
+	udp_static_t *const udp_static = (udp_static_t *) rohc_data;
+	const size_t udp_static_len = sizeof(udp_static_t);
+
+	if(rohc_max_len < udp_static_len)
+	{
+		rohc_comp_warn(ctxt, "ROHC buffer too small for the UDP static part: "
+		               "%zu bytes required, but only %zu bytes available",
+		               udp_static_len, rohc_max_len);
+		goto error;
+	}
+
+	udp_static->src_port = udp->source;
+	udp_static->dst_port = udp->dest;
+
+	rohc_comp_dump_buf(ctxt, "UDP static part", rohc_data, udp_static_len);
+
+	return udp_static_len;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the irregular part of the UDP header
+ *
+ * @param ctxt            The compression context
+ * @param udp             The UDP header
+ * @param[out] rohc_data  The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+int rohc_comp_rfc5225_irreg_udp_part(const struct rohc_comp_ctxt *const ctxt,
+                                     const struct udphdr *const udp,
+                                     uint8_t *const rohc_data,
+                                     const size_t rohc_max_len)
+{
+	size_t udp_irreg_len;
+
+	if(udp->check == 0)
+	{
+		udp_irreg_len = 0;
+	}
+	else
+	{
+		udp_with_checksum_irregular_t *const udp_irreg =
+			(udp_with_checksum_irregular_t *) rohc_data;
+
+		udp_irreg_len = sizeof(udp_with_checksum_irregular_t);
+		if(rohc_max_len < udp_irreg_len)
+		{
+			rohc_comp_warn(ctxt, "ROHC buffer too small for the UDP irregular part: "
+			               "%zu bytes required, but only %zu bytes available",
+			               udp_irreg_len, rohc_max_len);
+			goto error;
+		}
+
+		udp_irreg->checksum = udp->check;
+	}
+
+	rohc_comp_dump_buf(ctxt, "UDP irregular part", rohc_data, udp_irreg_len);
+
+	return udp_irreg_len;
+
+error:
+	return -1;
+}
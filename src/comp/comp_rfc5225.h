@@ -0,0 +1,167 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   comp_rfc5225.h
+ * @brief  Functions shared by the ROHCv2 compression profiles
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_COMP_RFC5225_H
+#define ROHC_COMP_RFC5225_H
+
+#include "rohc_comp_internals.h"
+#include "schemes/comp_wlsb.h"
+#include "protocols/ip.h"
+#include "protocols/udp.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/**
+ * @brief The packet formats one ROHCv2 profile may choose in FO and SO states
+ *
+ * The candidates are sorted from the smallest packet format to the largest
+ * one. Every profile gives its own table, so that its packet formats and
+ * their requirements are defined in one place.
+ */
+struct rohc_comp_rfc5225_pkt_candidates
+{
+	/** The number of candidates of the table */
+	size_t nr;
+	/** The candidates of the table */
+	const struct rohc_comp_rfc5225_pkt_candidate
+	{
+		rohc_packet_t type;  /**< The packet format */
+		uint16_t required;   /**< The ROHC_RFC5225_PKT_COND_* it requires */
+	} *candidates;
+};
+
+
+/**
+ * @brief The current values that decide the packet format of one ROHCv2 packet
+ */
+struct rohc_comp_rfc5225_pkt_input
+{
+	/** The W-LSB object for the MSN */
+	const struct c_wlsb *msn_wlsb;
+	/** The MSN to encode */
+	uint32_t msn;
+	/** The length of the MSN field: 16 or 32 bits */
+	uint8_t msn_bits_nr;
+
+	/** The W-LSB object for the offset of the innermost IP-ID */
+	const struct c_wlsb *ip_id_offset_wlsb;
+	/** The offset of the innermost IP-ID to encode */
+	uint16_t ip_id_offset;
+	/** Whether the innermost IP-ID is sequential (swapped or not) */
+	bool is_ip_id_seq;
+	/** Whether the innermost sequential IP-ID is inferred from the MSN */
+	bool is_ip_id_inferred;
+
+	/** Whether one TOS/TC, DF or IP-ID behavior changed in one IP header */
+	bool ip_changed;
+	/** Whether one DF or IP-ID behavior changed in one outer IP header */
+	bool outer_ip_changed;
+};
+
+
+/** The CRC-3 is enough to protect the packet */
+#define ROHC_RFC5225_PKT_COND_CRC3          (1U << 0)
+/** 4 MSN bits are enough */
+#define ROHC_RFC5225_PKT_COND_MSN_4BITS     (1U << 1)
+/** 6 MSN bits are enough */
+#define ROHC_RFC5225_PKT_COND_MSN_6BITS     (1U << 2)
+/** 8 MSN bits are enough */
+#define ROHC_RFC5225_PKT_COND_MSN_8BITS     (1U << 3)
+/** The innermost IP-ID is random, zero or inferred from MSN */
+#define ROHC_RFC5225_PKT_COND_IPID_NOT_SENT (1U << 4)
+/** The innermost IP-ID is sequential (swapped or not) */
+#define ROHC_RFC5225_PKT_COND_IPID_SEQ      (1U << 5)
+/** 4 innermost IP-ID / MSN offset bits are enough */
+#define ROHC_RFC5225_PKT_COND_IPID_4BITS    (1U << 6)
+/** 6 innermost IP-ID / MSN offset bits are enough */
+#define ROHC_RFC5225_PKT_COND_IPID_6BITS    (1U << 7)
+/** No TOS/TC, DF nor IP-ID behavior changed in any IP header */
+#define ROHC_RFC5225_PKT_COND_IP_STABLE     (1U << 8)
+/** No DF nor IP-ID behavior changed in the outer IP headers */
+#define ROHC_RFC5225_PKT_COND_OUTER_STABLE  (1U << 9)
+/** The reorder ratio of the context was transmitted enough times */
+#define ROHC_RFC5225_PKT_COND_CTRL_STABLE   (1U << 10)
+
+
+/** The packet formats of the IP-only, IP/UDP and IP/UDP/RTP profiles */
+extern const struct rohc_comp_rfc5225_pkt_candidates rohc_comp_rfc5225_pkts_nortp;
+/** The packet formats of the IP/ESP profile */
+extern const struct rohc_comp_rfc5225_pkt_candidates rohc_comp_rfc5225_pkts_esp;
+
+rohc_packet_t rohc_comp_rfc5225_decide_FO_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                 const struct rohc_comp_rfc5225_pkt_candidates *const pkts,
+                                                 const struct rohc_comp_rfc5225_pkt_input *const input,
+                                                 const bool crc7_at_least)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+size_t rohc_comp_rfc5225_save(const struct rohc_comp_ctxt *const ctxt,
+                              const size_t specific_len,
+                              const size_t msn_wlsb_offset,
+                              const size_t ip_id_wlsb_offset,
+                              uint8_t *const image,
+                              const size_t image_max_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool rohc_comp_rfc5225_restore(struct rohc_comp_ctxt *const ctxt,
+                               const size_t specific_len,
+                               const size_t msn_wlsb_offset,
+                               const size_t ip_id_wlsb_offset,
+                               const uint8_t *const image,
+                               const size_t image_len)
+	__attribute__((warn_unused_result, nonnull(1, 5)));
+
+void rohc_comp_rfc5225_decide_state(struct rohc_comp_ctxt *const context,
+                                    const struct rohc_ts pkt_time)
+	__attribute__((nonnull(1)));
+
+int rohc_comp_rfc5225_static_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                       const struct ipv4_hdr *const ipv4,
+                                       const bool is_innermost,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+int rohc_comp_rfc5225_static_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                       const struct ipv6_hdr *const ipv6,
+                                       const bool is_innermost,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+int rohc_comp_rfc5225_static_udp_part(const struct rohc_comp_ctxt *const ctxt,
+                                      const struct udphdr *const udp,
+                                      uint8_t *const rohc_data,
+                                      const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+int rohc_comp_rfc5225_irreg_udp_part(const struct rohc_comp_ctxt *const ctxt,
+                                     const struct udphdr *const udp,
+                                     uint8_t *const rohc_data,
+                                     const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+#endif
+
@@ -25,6 +25,7 @@
  */
 
 #include "rohc_comp_internals.h"
+#include "comp_rfc5225.h"
 #include "rohc_traces.h"
 #include "rohc_traces_internal.h"
 #include "rohc_debug.h"
@@ -37,7 +38,7 @@
 #include "schemes/ip_ctxt.h"
 #include "schemes/comp_wlsb.h"
 #include "schemes/ip_id_offset.h"
-#include "schemes/rfc4996.h" /* for c_optional_ip_id_lsb */
+#include "sdvl.h"
 #include "crc.h"
 
 #include <assert.h>
@@ -151,6 +152,16 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+/* save/restore context */
+static size_t rohc_comp_rfc5225_ip_save(const struct rohc_comp_ctxt *const ctxt,
+                                        uint8_t *const image,
+                                        const size_t image_max_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool rohc_comp_rfc5225_ip_restore(struct rohc_comp_ctxt *const ctxt,
+                                         const uint8_t *const image,
+                                         const size_t image_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 /* encode ROHCv2 IP-only packets */
 static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -169,7 +180,7 @@ static void rohc_comp_rfc5225_ip_detect_changes_ipv4(struct rohc_comp_ctxt *cons
                                                      const bool is_innermost)
 	__attribute__((nonnull(1, 2, 3)));
 
-static int rohc_comp_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *const ctxt,
+static int rohc_comp_rfc5225_ip_code_IR_pkt(struct rohc_comp_ctxt *const ctxt,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                             uint8_t *const rohc_pkt,
                                             const size_t rohc_pkt_max_len)
@@ -181,6 +192,12 @@ static int rohc_comp_rfc5225_ip_code_co_repair_pkt(const struct rohc_comp_ctxt *
                                                    const size_t rohc_pkt_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static size_t rohc_comp_rfc5225_ip_get_CO_pkt_len(const struct rohc_comp_ctxt *const context,
+                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                                  const rohc_packet_t packet_type,
+                                                  size_t *const ip_id_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
 static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const context,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                             uint8_t *const rohc_pkt,
@@ -188,35 +205,31 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
                                             const rohc_packet_t packet_type)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static int rohc_comp_rfc5225_ip_build_pt_0_crc3_pkt(const struct rohc_comp_ctxt *const context,
-                                                    const uint8_t crc,
-                                                    uint8_t *const rohc_data,
-                                                    const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_0_crc3_pkt(const struct rohc_comp_ctxt *const context,
+                                                       const uint8_t crc,
+                                                       uint8_t *const rohc_data)
 	__attribute__((nonnull(1, 3), warn_unused_result));
 
-static int rohc_comp_rfc5225_ip_build_pt_0_crc7_pkt(const struct rohc_comp_ctxt *const context,
-                                                    const uint8_t crc,
-                                                    uint8_t *const rohc_data,
-                                                    const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_0_crc7_pkt(const struct rohc_comp_ctxt *const context,
+                                                       const uint8_t crc,
+                                                       uint8_t *const rohc_data)
 	__attribute__((nonnull(1, 3), warn_unused_result));
 
-static int rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctxt *const context,
-                                                      const uint8_t crc,
-                                                      uint8_t *const rohc_data,
-                                                      const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                         const uint8_t crc,
+                                                         uint8_t *const rohc_data)
 	__attribute__((nonnull(1, 3), warn_unused_result));
 
-static int rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctxt *const context,
-                                                      const uint8_t crc,
-                                                      uint8_t *const rohc_data,
-                                                      const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                         const uint8_t crc,
+                                                         uint8_t *const rohc_data)
 	__attribute__((nonnull(1, 3), warn_unused_result));
 
-static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt *const context,
-                                                    const uint8_t crc,
-                                                    uint8_t *const rohc_data,
-                                                    const size_t rohc_max_len)
-	__attribute__((nonnull(1, 3), warn_unused_result));
+static size_t rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt *const context,
+                                                       const uint8_t crc,
+                                                       const size_t ip_id_len,
+                                                       uint8_t *const rohc_data)
+	__attribute__((nonnull(1, 4), warn_unused_result));
 
 /* static chain */
 static int rohc_comp_rfc5225_ip_static_chain(const struct rohc_comp_ctxt *const ctxt,
@@ -224,19 +237,6 @@ static int rohc_comp_rfc5225_ip_static_chain(const struct rohc_comp_ctxt *const
                                              uint8_t *const rohc_pkt,
                                              const size_t rohc_pkt_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
-static int rohc_comp_rfc5225_ip_static_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
-                                                 const struct ipv4_hdr *const ipv4,
-                                                 const bool is_innermost,
-                                                 uint8_t *const rohc_data,
-                                                 const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
-static int rohc_comp_rfc5225_ip_static_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
-                                                 const struct ipv6_hdr *const ipv6,
-                                                 const bool is_innermost,
-                                                 uint8_t *const rohc_data,
-                                                 const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
-
 /* dynamic chain */
 static int rohc_comp_rfc5225_ip_dyn_chain(const struct rohc_comp_ctxt *const ctxt,
                                           const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -259,25 +259,22 @@ static int rohc_comp_rfc5225_ip_dyn_ipv6_part(const struct rohc_comp_ctxt *const
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
 
 /* irregular chain */
-static int rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
-                                            const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                            uint8_t *const rohc_pkt,
-                                            const size_t rohc_pkt_max_len)
-        __attribute__((warn_unused_result, nonnull(1, 2, 3)));
-static int rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
-                                                const ip_context_t *const ip_ctxt,
-                                                const struct ipv4_hdr *const ipv4,
-                                                const bool is_innermost,
-                                                uint8_t *const rohc_data,
-                                                const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
+                                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                               uint8_t *const rohc_pkt)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static size_t rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                                   const ip_context_t *const ip_ctxt,
+                                                   const struct ipv4_hdr *const ipv4,
+                                                   const bool is_innermost,
+                                                   uint8_t *const rohc_data)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+static size_t rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                                   const ip_context_t *const ip_ctxt,
+                                                   const struct ipv6_hdr *const ipv6,
+                                                   const bool is_innermost,
+                                                   uint8_t *const rohc_data)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
-static int rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
-                                                const ip_context_t *const ip_ctxt,
-                                                const struct ipv6_hdr *const ipv6,
-                                                const bool is_innermost,
-                                                uint8_t *const rohc_data,
-                                                const size_t rohc_max_len)
-        __attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
 
 /* deliver feedbacks */
 static bool rohc_comp_rfc5225_ip_feedback(struct rohc_comp_ctxt *const ctxt,
@@ -300,10 +297,6 @@ static void rohc_comp_rfc5225_ip_feedback_ack(struct rohc_comp_ctxt *const ctxt,
 	__attribute__((nonnull(1)));
 
 /* mode and state transitions */
-static void rohc_comp_rfc5225_ip_decide_state(struct rohc_comp_ctxt *const context,
-                                              const struct rohc_ts pkt_time)
-	__attribute__((nonnull(1)));
-
 /* decide packet */
 static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -318,12 +311,6 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
                                                            const bool crc7_at_least)
 	__attribute__((warn_unused_result, nonnull(1)));
 
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint16_t value,
-                                                  const rohc_reordering_offset_t reorder_ratio,
-                                                  const size_t k)
-	__attribute__((warn_unused_result, nonnull(1)));
-
 static bool rohc_comp_rfc5225_is_ipid_sequential(const rohc_ip_id_behavior_t behavior)
 	__attribute__((warn_unused_result, const));
 
@@ -354,12 +341,13 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
                                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_mempool *const mempool = &context->compressor->mempool;
 	struct rohc_comp_rfc5225_ip_ctxt *rfc5225_ctxt;
 	size_t ip_hdr_pos;
 	bool is_ok;
 
 	/* create the ROHCv2 IP-only part of the profile context */
-	rfc5225_ctxt = calloc(1, sizeof(struct rohc_comp_rfc5225_ip_ctxt));
+	rfc5225_ctxt = rohc_mempool_alloc(mempool, sizeof(struct rohc_comp_rfc5225_ip_ctxt));
 	if(rfc5225_ctxt == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -409,7 +397,7 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 	rfc5225_ctxt->ip_contexts_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
 	/* MSN */
-	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -419,7 +407,7 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 
 	/* innermost IP-ID offset */
 	is_ok = wlsb_new(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                 comp->oa_repetitions_nr);
+	                 comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -436,7 +424,8 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 free_wlsb_msn:
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
 free_context:
-	free(rfc5225_ctxt);
+	rohc_mempool_release(&context->compressor->mempool, rfc5225_ctxt,
+	                     sizeof(struct rohc_comp_rfc5225_ip_ctxt));
 error:
 	return false;
 }
@@ -456,7 +445,67 @@ static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
 
 	wlsb_free(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
-	free(rfc5225_ctxt);
+	rohc_mempool_release(&context->compressor->mempool, rfc5225_ctxt,
+	                     sizeof(struct rohc_comp_rfc5225_ip_ctxt));
+}
+
+
+/**
+ * @brief Save the ROHCv2 IP-only part of one context in a context image
+ *
+ * @param ctxt           The compression context
+ * @param image          The image to save the context in, may be NULL
+ * @param image_max_len  The length available in the image
+ * @return               The length of the profile-specific part of the
+ *                       context, saved only if it fits in the image
+ */
+static size_t rohc_comp_rfc5225_ip_save(const struct rohc_comp_ctxt *const ctxt,
+                                        uint8_t *const image,
+                                        const size_t image_max_len)
+{
+	return rohc_comp_rfc5225_save(ctxt, sizeof(struct rohc_comp_rfc5225_ip_ctxt),
+	                              offsetof(struct rohc_comp_rfc5225_ip_ctxt, msn_wlsb),
+	                              offsetof(struct rohc_comp_rfc5225_ip_ctxt, innermost_ip_id_offset_wlsb),
+	                              image, image_max_len);
+}
+
+
+/**
+ * @brief Restore the ROHCv2 IP-only part of one context from a context image
+ *
+ * @param ctxt       The compression context
+ * @param image      The part saved by \ref rohc_comp_rfc5225_ip_save
+ * @param image_len  The length of the part saved
+ * @return           true if successful, false otherwise
+ */
+static bool rohc_comp_rfc5225_ip_restore(struct rohc_comp_ctxt *const ctxt,
+                                         const uint8_t *const image,
+                                         const size_t image_len)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *rfc5225_ctxt;
+
+	if(!rohc_comp_rfc5225_restore(ctxt, sizeof(struct rohc_comp_rfc5225_ip_ctxt),
+	                              offsetof(struct rohc_comp_rfc5225_ip_ctxt, msn_wlsb),
+	                              offsetof(struct rohc_comp_rfc5225_ip_ctxt, innermost_ip_id_offset_wlsb),
+	                              image, image_len))
+	{
+		goto error;
+	}
+	rfc5225_ctxt = ctxt->specific;
+
+	if(rfc5225_ctxt->ip_contexts_nr == 0 ||
+	   rfc5225_ctxt->ip_contexts_nr > ROHC_MAX_IP_HDRS)
+	{
+		rohc_comp_warn(ctxt, "malformed context image: %zu IP headers",
+		               rfc5225_ctxt->ip_contexts_nr);
+		rohc_comp_rfc5225_ip_destroy(ctxt);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -488,7 +537,7 @@ static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
                                        const size_t rohc_pkt_max_len,
                                        rohc_packet_t *const packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
@@ -504,7 +553,7 @@ static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
 	rohc_comp_rfc5225_ip_detect_changes(context, uncomp_pkt_hdrs);
 
 	/* STEP 1: decide state */
-	rohc_comp_rfc5225_ip_decide_state(context, uncomp_pkt_time);
+	rohc_comp_rfc5225_decide_state(context, uncomp_pkt_time);
 
 	/* STEP 2: decide packet type */
 	*packet_type = rohc_comp_rfc5225_ip_decide_pkt(context);
@@ -576,6 +625,12 @@ static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
 
 		if(ip_hdr->version == IPV4)
 		{
+			if((ip_hdr_pos + 1) == rfc5225_ctxt->ip_contexts_nr &&
+			   context->num_sent_packets > 0 &&
+			   ip_ctxt->last_ip_id_behavior != ip_ctxt->ip_id_behavior)
+			{
+				context->ip_id_behavior_changes_nr++;
+			}
 			ip_ctxt->last_ip_id_behavior = ip_ctxt->ip_id_behavior;
 			ip_ctxt->last_ip_id = rohc_ntoh16(ip_hdr->ipv4->id);
 			/* add the new IP-ID offset to the W-LSB encoding object */
@@ -652,7 +707,7 @@ error:
 static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const context,
                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	ip_context_t *innermost_ip_ctxt = NULL;
 	size_t ip_hdr_pos;
@@ -767,9 +822,23 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		}
 		else
 		{
-			ip_id_behavior =
+			const rohc_ip_id_behavior_t detected_behavior =
 				rohc_comp_detect_ip_id_behavior(last_ip_id, ip_id,
 				                                rfc5225_ctxt->tmp.msn_offset, 19);
+
+			/* do not reclassify the IP-ID behavior on one IP-ID out of pattern */
+			ip_id_behavior =
+				rohc_comp_ip_id_behavior_hysteresis(&innermost_ip_ctxt->ip_id_hyst,
+				                                    last_ip_id_behavior,
+				                                    detected_behavior, ip_id,
+				                                    context->compressor->ip_id_hysteresis_nr);
+			if(ip_id_behavior != detected_behavior)
+			{
+				rohc_comp_debug(context, "IP-ID behaved as %s in packet, wait for "
+				                "%u consistent observations before changing behavior",
+				                rohc_ip_id_behavior_get_descr(detected_behavior),
+				                context->compressor->ip_id_hysteresis_nr);
+			}
 		}
 		/* TODO: avoid changing context here */
 		innermost_ip_ctxt->ip_id_behavior = ip_id_behavior;
@@ -1135,40 +1204,12 @@ static bool rohc_comp_rfc5225_ip_feedback_2(struct rohc_comp_ctxt *const ctxt,
                                             const uint8_t *const feedback_data,
                                             const size_t feedback_data_len)
 {
-	const uint8_t *remain_data = feedback_data;
-	size_t remain_len = feedback_data_len;
-	const struct rohc_feedback_2_rfc6846 *feedback2;
-
-	size_t opts_present[ROHC_FEEDBACK_OPT_MAX] = { 0 };
+	struct rohc_comp_feedback_2 feedback2;
 
-	uint8_t crc_in_packet;
-	size_t crc_pos_from_end;
-
-	uint32_t sn_bits;
-	size_t sn_bits_nr;
-
-	/* retrieve acked MSN */
-	if(remain_len < sizeof(struct rohc_feedback_2_rfc6846))
-	{
-		rohc_comp_warn(ctxt, "malformed FEEDBACK-2: packet too short for the "
-		               "minimal %zu-byte header, only %zu bytes remaining",
-		               sizeof(struct rohc_feedback_2_rfc6846), remain_len);
-		goto error;
-	}
-	feedback2 = (const struct rohc_feedback_2_rfc6846 *) feedback_data;
-	sn_bits = (feedback2->sn1 << 8) | feedback2->sn2;
-	sn_bits_nr = 6 + 8;
-	crc_in_packet = feedback2->crc;
-	crc_pos_from_end = remain_len - 2;
-	remain_data += 3;
-	remain_len -= 3;
-
-	/* parse FEEDBACK-2 options */
-	if(!rohc_comp_feedback_parse_opts(ctxt, packet, packet_len,
-	                                  remain_data, remain_len,
-	                                  opts_present, &sn_bits, &sn_bits_nr,
-	                                  ROHC_FEEDBACK_WITH_CRC_BASE,
-	                                  crc_in_packet, crc_pos_from_end))
+	/* parse FEEDBACK-2 base header and options, check CRC */
+	if(!rohc_comp_feedback_parse_2(ctxt, packet, packet_len,
+	                               feedback_data, feedback_data_len,
+	                               ROHC_FEEDBACK_WITH_CRC_BASE, &feedback2))
 	{
 		rohc_comp_warn(ctxt, "malformed FEEDBACK-2: failed to parse options");
 		goto error;
@@ -1178,19 +1219,19 @@ static bool rohc_comp_rfc5225_ip_feedback_2(struct rohc_comp_ctxt *const ctxt,
 	rohc_comp_change_mode(ctxt, ROHC_O_MODE);
 
 	/* act according to the type of feedback */
-	switch(feedback2->ack_type)
+	switch(feedback2.ack_type)
 	{
 		case ROHC_FEEDBACK_ACK:
 		{
-			const bool sn_not_valid =
-				!!(opts_present[ROHC_FEEDBACK_OPT_ACKNUMBER_NOT_VALID] > 0);
+			const bool sn_not_valid = feedback2.sn_not_valid;
 
-			rohc_comp_debug(ctxt, "ACK received (CID = %u, %zu-bit SN = 0x%x, "
-			                "ACKNUMBER-NOT-VALID = %d)", ctxt->cid, sn_bits_nr,
-			                sn_bits, GET_REAL(sn_not_valid));
+			rohc_comp_debug(ctxt, "ACK received (CID = %u, %u-bit SN = 0x%x, "
+			                "ACKNUMBER-NOT-VALID = %d)", ctxt->cid, feedback2.sn_bits_nr,
+			                feedback2.sn_bits, GET_REAL(sn_not_valid));
 
 			/* the compressor received a positive ACK */
-			rohc_comp_rfc5225_ip_feedback_ack(ctxt, sn_bits, sn_bits_nr, sn_not_valid);
+			rohc_comp_rfc5225_ip_feedback_ack(ctxt, feedback2.sn_bits,
+			                                  feedback2.sn_bits_nr, sn_not_valid);
 			break;
 		}
 		case ROHC_FEEDBACK_NACK:
@@ -1203,6 +1244,10 @@ static bool rohc_comp_rfc5225_ip_feedback_2(struct rohc_comp_ctxt *const ctxt,
 			{
 				rohc_comp_change_state(ctxt, ROHC_COMP_STATE_FO);
 			}
+			/* the link loses packets, so repeat the changes more */
+			rohc_comp_oa_on_nack(ctxt);
+			/* the link may reorder packets, so handle more reordering */
+			rohc_comp_reorder_on_nack(ctxt);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1214,6 +1259,8 @@ static bool rohc_comp_rfc5225_ip_feedback_2(struct rohc_comp_ctxt *const ctxt,
 			          "STATIC-NACK received for CID %u", ctxt->cid);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(ctxt, ROHC_COMP_STATE_IR);
+			/* the link loses packets, so repeat the changes more */
+			rohc_comp_oa_on_nack(ctxt);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1228,7 +1275,7 @@ static bool rohc_comp_rfc5225_ip_feedback_2(struct rohc_comp_ctxt *const ctxt,
 		{
 			/* impossible value */
 			rohc_comp_warn(ctxt, "malformed FEEDBACK-2: unknown ACK type %u",
-			               feedback2->ack_type);
+			               feedback2.ack_type);
 			goto error;
 		}
 	}
@@ -1324,52 +1371,6 @@ static void rohc_comp_rfc5225_ip_feedback_ack(struct rohc_comp_ctxt *const ctxt,
 }
 
 
-/**
- * @brief Decide the state that should be used for the next packet
- *
- * @param context  The compression context
- * @param pkt_time The time of packet arrival
- */
-static void rohc_comp_rfc5225_ip_decide_state(struct rohc_comp_ctxt *const context,
-                                              const struct rohc_ts pkt_time)
-{
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
-	const rohc_comp_state_t curr_state = context->state;
-	rohc_comp_state_t next_state;
-
-	assert(curr_state != ROHC_COMP_STATE_UNKNOWN);
-	assert(curr_state != ROHC_COMP_STATE_CR);
-
-	if(curr_state == ROHC_COMP_STATE_SO)
-	{
-		/* do not change state */
-		rohc_comp_debug(context, "stay in SO state");
-		next_state = ROHC_COMP_STATE_SO;
-		/* TODO: handle NACK and STATIC-NACK */
-	}
-	else if(context->state_oa_repeat_nr < oa_repetitions_nr)
-	{
-		rohc_comp_debug(context, "not enough packets transmitted in current state "
-		                "for the moment (%u/%u), so stay in current state",
-		                context->state_oa_repeat_nr, oa_repetitions_nr);
-		next_state = curr_state;
-	}
-	else
-	{
-		rohc_comp_debug(context, "enough packets transmitted in current state "
-		                "(%u/%u), go to upper state", context->state_oa_repeat_nr,
-		                oa_repetitions_nr);
-		next_state = ROHC_COMP_STATE_SO;
-	}
-
-	rohc_comp_change_state(context, next_state);
-
-	/* periodic refreshes in U-mode only */
-	if(context->mode == ROHC_U_MODE)
-	{
-		rohc_comp_periodic_down_transition(context, pkt_time);
-	}
-}
 
 
 /**
@@ -1479,163 +1480,41 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
                                                            const bool crc7_at_least)
 {
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
-	const uint8_t oa_repetitions_nr = ctxt->compressor->oa_repetitions_nr;
-	const rohc_reordering_offset_t reorder_ratio = ctxt->compressor->reorder_ratio;
+	const uint8_t oa_repetitions_nr = ctxt->oa_repetitions_nr;
 	const ip_context_t *const innermost_ip_ctxt =
 		&(rfc5225_ctxt->ip_contexts[rfc5225_ctxt->ip_contexts_nr - 1]);
-	const uint16_t innermost_ip_id = rfc5225_ctxt->tmp.innermost_ip_id;
-	const uint8_t innermost_ip_id_offset_trans_nr =
-		rfc5225_ctxt->innermost_ip_id_offset_trans_nr;
-	const rohc_ip_id_behavior_t innermost_ip_id_behavior =
-		innermost_ip_ctxt->ip_id_behavior;
+	struct rohc_comp_rfc5225_pkt_input input;
 	rohc_packet_t packet_type;
 
-	/* use pt_0_crc3 only if:
-	 *  - CRC-3 is enough to protect the compression
-	 *  - 4 MSN bits are enough
-	 *  - the innermost IP-ID is either:
-	 *     - random (transmitted in irregular chain),
-	 *     - zero (not transmitted at all),
-	 *     - sequential and inferred from MSN (and not transmitted at all).
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	if(!crc7_at_least &&
-	   rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                         rfc5225_ctxt->msn, reorder_ratio, 4) &&
-	   (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
-	    rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
-	                                           innermost_ip_id_offset_trans_nr,
-	                                           oa_repetitions_nr,
-	                                           innermost_ip_id)) &&
-	   !rfc5225_ctxt->tmp.outer_ip_flag &&
-	   !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	   !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	   !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code pt_0_crc3 packet");
-		packet_type = ROHC_PACKET_PT_0_CRC3;
-	}
-	/* use pt_0_crc7 only if:
-	 *  - 6 MSN bits are enough
-	 *  - the innermost IP-ID is either:
-	 *     - random (transmitted in irregular chain),
-	 *     - zero (not transmitted at all),
-	 *     - sequential and inferred from MSN (and not transmitted at all).
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
-	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
-	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
-	                                                innermost_ip_id_offset_trans_nr,
-	                                                oa_repetitions_nr,
-	                                                innermost_ip_id)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code pt_0_crc7 packet");
-		packet_type = ROHC_PACKET_NORTP_PT_0_CRC7;
-	}
-	/* use pt_1_seq_id only if:
-	 *  - CRC-3 is enough to protect the compression
-	 *  - 6 MSN bits are enough
-	 *  - innermost IP-ID is sequential (swapped or not)
-	 *  - 4 innermost IP-ID / SN offset bits are enough
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
-	        rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 4,
-	                                   rohc_interval_get_rfc5225_id_id_p(4)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		assert(innermost_ip_ctxt->version == IPV4);
-		rohc_comp_debug(ctxt, "code pt_1_seq_id packet");
-		packet_type = ROHC_PACKET_NORTP_PT_1_SEQ_ID;
-	}
-	/* use pt_2_seq_id only if:
-	 *  - innermost IP-ID is sequential (swapped or not)
-	 *  - 6 innermost IP-ID / SN offset bits are enough
-	 *  - 8 MSN bits are enough
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	else if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 6,
-	                                   rohc_interval_get_rfc5225_id_id_p(6)) &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 8) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code pt_2_seq_id packet");
-		packet_type = ROHC_PACKET_NORTP_PT_2_SEQ_ID;
-	}
-	/* use co_common only if:
-	 *  - 8 MSN bits are enough
-	 *  - the DF fields of all outer IP headers shall not be changing
-	 *  - the behavior of the outer IP-IDs shall not be changing
-	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 8) &&
-	        !rfc5225_ctxt->tmp.outer_df_changed &&
-	        !rfc5225_ctxt->tmp.outer_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code co_common packet");
-		packet_type = ROHC_PACKET_CO_COMMON;
-	}
-	else /* fallback on co_repair packet */
-	{
-		/* the co_repair packet is enough to transmit all the dynamic changes ;
-		 * if there were static changes, the context would have been reset by
-		 * the stream classifier */
-		rohc_comp_debug(ctxt, "code co_repair packet");
-		packet_type = ROHC_PACKET_CO_REPAIR;
-	}
+	input.msn_wlsb = &rfc5225_ctxt->msn_wlsb;
+	input.msn = rfc5225_ctxt->msn;
+	input.msn_bits_nr = 16;
+	input.ip_id_offset_wlsb = &rfc5225_ctxt->innermost_ip_id_offset_wlsb;
+	input.ip_id_offset = rfc5225_ctxt->tmp.innermost_ip_id_offset;
+	input.is_ip_id_seq =
+		rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_ctxt->ip_id_behavior);
+	input.is_ip_id_inferred =
+		(input.is_ip_id_seq &&
+		 rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
+		                                        rfc5225_ctxt->innermost_ip_id_offset_trans_nr,
+		                                        oa_repetitions_nr,
+		                                        rfc5225_ctxt->tmp.innermost_ip_id));
+	input.ip_changed = (rfc5225_ctxt->tmp.outer_ip_flag ||
+	                    rfc5225_ctxt->tmp.innermost_ip_flag ||
+	                    rfc5225_ctxt->tmp.at_least_one_df_changed ||
+	                    rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed);
+	input.outer_ip_changed = (rfc5225_ctxt->tmp.outer_df_changed ||
+	                          rfc5225_ctxt->tmp.outer_ip_id_behavior_changed);
+
+	packet_type = rohc_comp_rfc5225_decide_FO_SO_pkt(ctxt, &rohc_comp_rfc5225_pkts_nortp,
+	                                                 &input, crc7_at_least);
+	assert(packet_type != ROHC_PACKET_NORTP_PT_1_SEQ_ID ||
+	       innermost_ip_ctxt->version == IPV4);
 
 	return packet_type;
 }
 
 
-/**
- * @brief Define according to computed shift parameter if msn_lsb() is possible
- *
- * @param wlsb           The W-LSB object
- * @param value          The value to encode using the LSB algorithm
- * @param reorder_ratio  The reordering ratio
- * @param k              The number of bits for encoding
- * @return               true if msn_lsb is possible or not
- */
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-		                                            const uint16_t value,
-                                                  const rohc_reordering_offset_t reorder_ratio,
-                                                  const size_t k)
-{
-	/* compute p according to reorder ratio  */
-	rohc_lsb_shift_t p_computed = rohc_interval_get_rfc5225_msn_p(k, reorder_ratio);
-
-	return wlsb_is_kp_possible_16bits(wlsb, value, k, p_computed);
-}
-
-
 /**
  * @brief Whether the given IP-ID is sequential (swapped or not)
  *
@@ -1712,7 +1591,7 @@ static bool rohc_comp_rfc5225_is_seq_ipid_inferred(const ip_context_t *const ip_
  * @return                  The length of the ROHC packet if successful,
  *                          -1 otherwise
  */
-static int rohc_comp_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *context,
+static int rohc_comp_rfc5225_ip_code_IR_pkt(struct rohc_comp_ctxt *const context,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                             uint8_t *const rohc_pkt,
                                             const size_t rohc_pkt_max_len)
@@ -1776,8 +1655,9 @@ static int rohc_comp_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *context
 	rohc_hdr_len++;
 
 	/* add static chain */
-	ret = rohc_comp_rfc5225_ip_static_chain(context, uncomp_pkt_hdrs,
-	                                        rohc_remain_data, rohc_remain_len);
+	ret = rohc_comp_code_static_chain(context, uncomp_pkt_hdrs, rohc_pkt,
+	                                  rohc_hdr_len, rohc_pkt_max_len,
+	                                  rohc_comp_rfc5225_ip_static_chain);
 	if(ret < 0)
 	{
 		rohc_comp_warn(context, "failed to build the static chain of the IR packet");
@@ -1806,8 +1686,7 @@ static int rohc_comp_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *context
 	                   rohc_pkt, rohc_hdr_len);
 
 	/* IR header was successfully built, compute the CRC */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
-	                                       rohc_hdr_len, CRC_INIT_8);
+	rohc_pkt[crc_position] = rohc_comp_ir_crc(context, rohc_pkt, rohc_hdr_len);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                rohc_hdr_len, rohc_pkt[crc_position]);
 
@@ -1912,8 +1791,9 @@ static int rohc_comp_rfc5225_ip_code_co_repair_pkt(const struct rohc_comp_ctxt *
 		co_repair_crc->r1 = 0;
 		/* CRC-7 over uncompressed headers */
 		co_repair_crc->header_crc =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, co_repair_crc->header_crc);
 
@@ -1938,12 +1818,12 @@ static int rohc_comp_rfc5225_ip_code_co_repair_pkt(const struct rohc_comp_ctxt *
 		}
 		co_repair_crc->ctrl_crc =
 			compute_crc_ctrl_fields(context->profile->id,
-			                        context->compressor->reorder_ratio,
+			                        context->reorder_ratio,
 			                        rfc5225_ctxt->msn,
 			                        ip_id_behaviors, ip_id_behaviors_nr);
 		rohc_comp_debug(context, "CRC-3 on control fields = 0x%x "
 		                "(reorder_ratio = 0x%02x, MSN = 0x%04x, %zu IP-ID behaviors)",
-		                co_repair_crc->ctrl_crc, context->compressor->reorder_ratio,
+		                co_repair_crc->ctrl_crc, context->reorder_ratio,
 		                rfc5225_ctxt->msn, ip_id_behaviors_nr);
 
 		/* skip CRCs */
@@ -1980,6 +1860,120 @@ error:
 }
 
 
+/**
+ * @brief Compute the exact length of an IP-only CO packet
+ *
+ * Once the packet type is decided, the formats of all the fields of the CO
+ * packet are known, and so is its length. The length is computed before
+ * building the packet, so that the ROHC buffer is checked only once and the
+ * CO headers are written without checking the buffer again field by field.
+ *
+ * @param context           The compression context
+ * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param packet_type       The type of ROHC packet to create
+ * @param[out] ip_id_len    The length of the innermost IP-ID in co_common
+ * @return                  The length of the CO packet, CID included
+ */
+static size_t rohc_comp_rfc5225_ip_get_CO_pkt_len(const struct rohc_comp_ctxt *const context,
+                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                                  const rohc_packet_t packet_type,
+                                                  size_t *const ip_id_len)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	size_t pkt_len;
+	size_t ip_hdr_pos;
+
+	/* Add-CID or large CID bytes, the first byte of the CO header excluded */
+	if(context->compressor->medium.cid_type == ROHC_SMALL_CID)
+	{
+		pkt_len = (context->cid > 0 ? 1 : 0);
+	}
+	else
+	{
+		pkt_len = sdvl_get_encoded_len(context->cid);
+	}
+
+	/* the CO base header */
+	*ip_id_len = 0;
+	if(packet_type == ROHC_PACKET_PT_0_CRC3)
+	{
+		pkt_len += sizeof(pt_0_crc3_t);
+	}
+	else if(packet_type == ROHC_PACKET_NORTP_PT_0_CRC7)
+	{
+		pkt_len += sizeof(pt_0_crc7_t);
+	}
+	else if(packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
+	{
+		pkt_len += sizeof(pt_1_seq_id_t);
+	}
+	else if(packet_type == ROHC_PACKET_NORTP_PT_2_SEQ_ID)
+	{
+		pkt_len += sizeof(pt_2_seq_id_t);
+	}
+	else
+	{
+		const ip_context_t *const innermost_ip_ctxt =
+			&(rfc5225_ctxt->ip_contexts[rfc5225_ctxt->ip_contexts_nr - 1]);
+
+		assert(packet_type == ROHC_PACKET_CO_COMMON);
+
+		pkt_len += sizeof(co_common_base_t);
+		if(rfc5225_ctxt->tmp.innermost_df_changed ||
+		   rfc5225_ctxt->tmp.outer_ip_flag ||
+		   rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed)
+		{
+			pkt_len += sizeof(profile_2_3_4_flags_t);
+		}
+		if(rfc5225_ctxt->tmp.innermost_tos_tc_changed)
+		{
+			pkt_len++;
+		}
+		if(rfc5225_ctxt->tmp.innermost_ttl_hopl_changed)
+		{
+			pkt_len++;
+		}
+		pkt_len++; /* 8 LSB of MSN */
+
+		/* ip_id_sequential_variable() */
+		if(innermost_ip_ctxt->ip_id_behavior == ROHC_IP_ID_BEHAVIOR_SEQ ||
+		   innermost_ip_ctxt->ip_id_behavior == ROHC_IP_ID_BEHAVIOR_SEQ_SWAP)
+		{
+			if(wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+			                              rfc5225_ctxt->tmp.innermost_ip_id_offset, 8,
+			                              rohc_interval_get_rfc5225_id_id_p(8)))
+			{
+				*ip_id_len = 1;
+			}
+			else
+			{
+				*ip_id_len = sizeof(uint16_t);
+			}
+		}
+		pkt_len += *ip_id_len;
+	}
+
+	/* the irregular chain */
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_contexts_nr; ip_hdr_pos++)
+	{
+		const ip_context_t *const ip_ctxt = &(rfc5225_ctxt->ip_contexts[ip_hdr_pos]);
+		const bool is_innermost = !!(ip_hdr_pos + 1 == rfc5225_ctxt->ip_contexts_nr);
+
+		if(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos].version == IPV4 &&
+		   ip_ctxt->ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND)
+		{
+			pkt_len += sizeof(uint16_t);
+		}
+		if(!is_innermost && rfc5225_ctxt->tmp.outer_ip_flag)
+		{
+			pkt_len += 2; /* TOS/TC and TTL/HL */
+		}
+	}
+
+	return pkt_len;
+}
+
+
 /**
  * @brief Encode an IP packet as CO packet
  *
@@ -1998,28 +1992,60 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
                                             const rohc_packet_t packet_type)
 {
 	uint8_t *rohc_remain_data = rohc_pkt;
-	size_t rohc_remain_len = rohc_pkt_max_len;
+	size_t rohc_pkt_len;
+	size_t ip_id_len;
 	uint8_t crc_computed;
 	uint8_t save_first_byte;
 	size_t pos_1st_byte;
 	size_t pos_2nd_byte;
 	int ret;
 
+	if(packet_type == ROHC_PACKET_UNKNOWN)
+	{
+		rohc_comp_warn(context, "failed to find the packet type to encode");
+		goto error;
+	}
+	else if(packet_type != ROHC_PACKET_PT_0_CRC3 &&
+	        packet_type != ROHC_PACKET_NORTP_PT_0_CRC7 &&
+	        packet_type != ROHC_PACKET_NORTP_PT_1_SEQ_ID &&
+	        packet_type != ROHC_PACKET_NORTP_PT_2_SEQ_ID &&
+	        packet_type != ROHC_PACKET_CO_COMMON)
+	{
+		rohc_comp_warn(context, "packet type %d '%s' not supported by profile",
+		               packet_type, rohc_get_packet_descr(packet_type));
+		assert(0);
+		goto error;
+	}
+
+	/* check the ROHC buffer once for the whole CO packet */
+	rohc_pkt_len = rohc_comp_rfc5225_ip_get_CO_pkt_len(context, uncomp_pkt_hdrs,
+	                                                   packet_type, &ip_id_len);
+	if(rohc_pkt_max_len < rohc_pkt_len)
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for the %s packet: %zu "
+		               "bytes required, but only %zu bytes available",
+		               rohc_get_packet_descr(packet_type), rohc_pkt_len,
+		               rohc_pkt_max_len);
+		goto error;
+	}
+
 	/* let's compute the CRC on uncompressed headers */
 	if(packet_type == ROHC_PACKET_PT_0_CRC3 ||
 	   packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
 		rohc_comp_debug(context, "CRC-3 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -2028,18 +2054,16 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 	 * where first header byte shall be written, 'pos_2nd_byte' indicates the
 	 * location where the next header bytes shall be written */
 	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
-	                      rohc_remain_data, rohc_remain_len, &pos_1st_byte);
+	                      rohc_remain_data, rohc_pkt_max_len, &pos_1st_byte);
 	if(ret < 1)
 	{
-		rohc_comp_warn(context, "failed to encode %s CID %u: maybe the "
-		               "%zu-byte ROHC buffer is too small",
+		rohc_comp_warn(context, "failed to encode %s CID %u",
 		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
-		               "small" : "large", context->cid, rohc_remain_len);
+		               "small" : "large", context->cid);
 		goto error;
 	}
 	pos_2nd_byte = ret;
 	rohc_remain_data += ret;
-	rohc_remain_len -= ret;
 	rohc_comp_debug(context, "%s CID %u encoded on %d byte(s)",
 	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, ret - 1);
@@ -2052,104 +2076,43 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 	 * the CO header and restored afterwards */
 	save_first_byte = rohc_remain_data[-1];
 	rohc_remain_data--;
-	rohc_remain_len++;
 
-	/* build the specifi CO header */
+	/* build the specific CO header */
 	if(packet_type == ROHC_PACKET_PT_0_CRC3)
 	{
-		/* build the pt_0_crc3 ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_pt_0_crc3_pkt(context, crc_computed,
-		                                               rohc_remain_data,
-		                                               rohc_remain_len);
-		if(ret < 0)
-		{
-			rohc_comp_warn(context, "failed to build pt_0_crc3 packet");
-			goto error;
-		}
-		rohc_remain_data += ret;
-		rohc_remain_len -= ret;
+		rohc_remain_data +=
+			rohc_comp_rfc5225_ip_build_pt_0_crc3_pkt(context, crc_computed,
+			                                         rohc_remain_data);
 	}
 	else if(packet_type == ROHC_PACKET_NORTP_PT_0_CRC7)
 	{
-		/* build the pt_0_crc7 ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_pt_0_crc7_pkt(context, crc_computed,
-		                                               rohc_remain_data,
-		                                               rohc_remain_len);
-		if(ret < 0)
-		{
-			rohc_comp_warn(context, "failed to build pt_0_crc7 packet");
-			goto error;
-		}
-		rohc_remain_data += ret;
-		rohc_remain_len -= ret;
+		rohc_remain_data +=
+			rohc_comp_rfc5225_ip_build_pt_0_crc7_pkt(context, crc_computed,
+			                                         rohc_remain_data);
 	}
 	else if(packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
-		/* build the pt_1_seq_id ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(context, crc_computed,
-		                                                 rohc_remain_data,
-		                                                 rohc_remain_len);
-		if(ret < 0)
-		{
-			rohc_comp_warn(context, "failed to build pt_1_seq_id packet");
-			goto error;
-		}
-		rohc_remain_data += ret;
-		rohc_remain_len -= ret;
+		rohc_remain_data +=
+			rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(context, crc_computed,
+			                                           rohc_remain_data);
 	}
 	else if(packet_type == ROHC_PACKET_NORTP_PT_2_SEQ_ID)
 	{
-		/* build the pt_2_seq_id ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(context, crc_computed,
-		                                                 rohc_remain_data,
-		                                                 rohc_remain_len);
-		if(ret < 0)
-		{
-			rohc_comp_warn(context, "failed to build pt_2_seq_id packet");
-			goto error;
-		}
-		rohc_remain_data += ret;
-		rohc_remain_len -= ret;
+		rohc_remain_data +=
+			rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(context, crc_computed,
+			                                           rohc_remain_data);
 	}
-	else if(packet_type == ROHC_PACKET_CO_COMMON)
+	else /* ROHC_PACKET_CO_COMMON */
 	{
-		/* build the co_common ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_co_common_pkt(context, crc_computed,
-		                                               rohc_remain_data,
-		                                               rohc_remain_len);
-		if(ret < 0)
-		{
-			rohc_comp_warn(context, "failed to build co_common packet");
-			goto error;
-		}
-		rohc_remain_data += ret;
-		rohc_remain_len -= ret;
-	}
-	else if(packet_type == ROHC_PACKET_UNKNOWN)
-	{
-		rohc_comp_warn(context, "failed to find the packet type to encode");
-		goto error;
-	}
-	else
-	{
-		rohc_comp_warn(context, "packet type %d '%s' not supported by profile",
-		               packet_type, rohc_get_packet_descr(packet_type));
-		assert(0);
-		goto error;
+		rohc_remain_data +=
+			rohc_comp_rfc5225_ip_build_co_common_pkt(context, crc_computed,
+			                                         ip_id_len, rohc_remain_data);
 	}
 
 	/* add the irregular chain at the very end of the CO header */
-	ret = rohc_comp_rfc5225_ip_irreg_chain(context, uncomp_pkt_hdrs,
-	                                       rohc_remain_data, rohc_remain_len);
-	if(ret < 0)
-	{
-		rohc_comp_warn(context, "failed to build the irregular chain of the CO packet");
-		goto error;
-	}
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	rohc_remain_data += ret;
-#endif
-	rohc_remain_len -= ret;
+	rohc_remain_data +=
+		rohc_comp_rfc5225_ip_irreg_chain(context, uncomp_pkt_hdrs, rohc_remain_data);
+	assert(((size_t) (rohc_remain_data - rohc_pkt)) == rohc_pkt_len);
 
 	/* end of workaround: restore the saved octet */
 	if(context->compressor->medium.cid_type != ROHC_SMALL_CID)
@@ -2158,10 +2121,9 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 		rohc_pkt[pos_2nd_byte - 1] = save_first_byte;
 	}
 
-	rohc_comp_dump_buf(context, "CO packet", rohc_pkt,
-	                   rohc_pkt_max_len - rohc_remain_len);
+	rohc_comp_dump_buf(context, "CO packet", rohc_pkt, rohc_pkt_len);
 
-	return (rohc_pkt_max_len - rohc_remain_len);
+	return rohc_pkt_len;
 
 error:
 	return -1;
@@ -2202,8 +2164,8 @@ static int rohc_comp_rfc5225_ip_static_chain(const struct rohc_comp_ctxt *const
 
 		if(ip_hdr->version == IPV4)
 		{
-			ret = rohc_comp_rfc5225_ip_static_ipv4_part(ctxt, ip_hdr->ipv4, is_innermost,
-			                                            rohc_remain_data, rohc_remain_len);
+			ret = rohc_comp_rfc5225_static_ipv4_part(ctxt, ip_hdr->ipv4, is_innermost,
+			                                         rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
 				rohc_comp_warn(ctxt, "failed to build the IPv4 base header part "
@@ -2215,8 +2177,8 @@ static int rohc_comp_rfc5225_ip_static_chain(const struct rohc_comp_ctxt *const
 		}
 		else /* IPv6 */
 		{
-			ret = rohc_comp_rfc5225_ip_static_ipv6_part(ctxt, ip_hdr->ipv6, is_innermost,
-			                                            rohc_remain_data, rohc_remain_len);
+			ret = rohc_comp_rfc5225_static_ipv6_part(ctxt, ip_hdr->ipv6, is_innermost,
+			                                         rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
 				rohc_comp_warn(ctxt, "failed to build the IPv6 base header part "
@@ -2237,124 +2199,8 @@ error:
 }
 
 
-/**
- * @brief Build the static part of the IPv4 header
- *
- * @param ctxt            The compression context
- * @param ipv4            The IPv4 header
- * @param is_innermost    Whether the IPv4 header is the innermost IP header
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
- */
-static int rohc_comp_rfc5225_ip_static_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
-                                                 const struct ipv4_hdr *const ipv4,
-                                                 const bool is_innermost,
-                                                 uint8_t *const rohc_data,
-                                                 const size_t rohc_max_len)
-{
-	ipv4_static_t *const ipv4_static = (ipv4_static_t *) rohc_data;
-	const size_t ipv4_static_len = sizeof(ipv4_static_t);
-
-	if(rohc_max_len < ipv4_static_len)
-	{
-		rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv4 static part: "
-		               "%zu bytes required, but only %zu bytes available",
-		               ipv4_static_len, rohc_max_len);
-		goto error;
-	}
-
-	ipv4_static->version_flag = 0;
-	ipv4_static->innermost_ip = GET_REAL(is_innermost);
-	ipv4_static->reserved = 0;
-	ipv4_static->protocol = ipv4->protocol;
-	rohc_comp_debug(ctxt, "IPv4 protocol = %u", ipv4_static->protocol);
-	ipv4_static->src_addr = ipv4->saddr;
-	ipv4_static->dst_addr = ipv4->daddr;
-
-	rohc_comp_dump_buf(ctxt, "IPv4 static part", rohc_data, ipv4_static_len);
-
-	return ipv4_static_len;
-
-error:
-	return -1;
-}
-
-
-/**
- * @brief Build the static part of the IPv6 header
- *
- * @param ctxt            The compression context
- * @param ipv6            The IPv6 header
- * @param is_innermost    Whether the IPv6 header is the innermost IP header
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
- */
-static int rohc_comp_rfc5225_ip_static_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
-                                                 const struct ipv6_hdr *const ipv6,
-                                                 const bool is_innermost,
-                                                 uint8_t *const rohc_data,
-                                                 const size_t rohc_max_len)
-{
-	size_t ipv6_static_len;
-
-	if(ipv6->flow1 == 0 && ipv6->flow2 == 0)
-	{
-		ipv6_static_nofl_t *const ipv6_static = (ipv6_static_nofl_t *) rohc_data;
-
-		ipv6_static_len = sizeof(ipv6_static_nofl_t);
-		if(rohc_max_len < ipv6_static_len)
-		{
-			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv6 static part: "
-			               "%zu bytes required, but only %zu bytes available",
-			               ipv6_static_len, rohc_max_len);
-			goto error;
-		}
-
-		ipv6_static->version_flag = 1;
-		ipv6_static->innermost_ip = GET_REAL(is_innermost);
-		ipv6_static->reserved1 = 0;
-		ipv6_static->flow_label_enc_discriminator = 0;
-		ipv6_static->reserved2 = 0;
-		ipv6_static->next_header = ipv6->nh;
-		memcpy(ipv6_static->src_addr, &ipv6->saddr, sizeof(struct ipv6_addr));
-		memcpy(ipv6_static->dst_addr, &ipv6->daddr, sizeof(struct ipv6_addr));
-	}
-	else
-	{
-		ipv6_static_fl_t *const ipv6_static = (ipv6_static_fl_t *) rohc_data;
-
-		ipv6_static_len = sizeof(ipv6_static_fl_t);
-		if(rohc_max_len < ipv6_static_len)
-		{
-			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv6 static part: "
-			               "%zu bytes required, but only %zu bytes available",
-			               ipv6_static_len, rohc_max_len);
-			goto error;
-		}
-
-		ipv6_static->version_flag = 1;
-		ipv6_static->innermost_ip = GET_REAL(is_innermost);
-		ipv6_static->reserved = 0;
-		ipv6_static->flow_label_enc_discriminator = 1;
-		ipv6_static->flow_label_msb = ipv6->flow1;
-		ipv6_static->flow_label_lsb = ipv6->flow2;
-		ipv6_static->next_header = ipv6->nh;
-		memcpy(ipv6_static->src_addr, &ipv6->saddr, sizeof(struct ipv6_addr));
-		memcpy(ipv6_static->dst_addr, &ipv6->daddr, sizeof(struct ipv6_addr));
-	}
-	rohc_comp_debug(ctxt, "IPv6 next header = %u", ipv6->nh);
-
-	rohc_comp_dump_buf(ctxt, "IPv6 static part", rohc_data, ipv6_static_len);
 
-	return ipv6_static_len;
 
-error:
-	return -1;
-}
 
 
 /**
@@ -2470,7 +2316,7 @@ static int rohc_comp_rfc5225_ip_dyn_ipv4_part(const struct rohc_comp_ctxt *const
 		}
 
 		ipv4_dynamic->reserved = 0;
-		ipv4_dynamic->reorder_ratio = ctxt->compressor->reorder_ratio;
+		ipv4_dynamic->reorder_ratio = ctxt->reorder_ratio;
 		ipv4_dynamic->df = ipv4->df;
 		ipv4_dynamic->ip_id_behavior_innermost = ip_ctxt->ip_id_behavior;
 		ipv4_dynamic->tos_tc = ipv4->tos;
@@ -2616,7 +2462,7 @@ static int rohc_comp_rfc5225_ip_dyn_ipv6_part(const struct rohc_comp_ctxt *const
 			goto error;
 		}
 
-		ipv6_endpoint_dynamic->reorder_ratio = ctxt->compressor->reorder_ratio;
+		ipv6_endpoint_dynamic->reorder_ratio = ctxt->reorder_ratio;
 		ipv6_endpoint_dynamic->reserved = 0;
 
 		/* MSN */
@@ -2633,32 +2479,28 @@ error:
 
 
 /**
- * @brief Code the irregular chain of a ROHCv2 IP-only IR packet
+ * @brief Code the irregular chain of a ROHCv2 IP-only CO packet
+ *
+ * The ROHC buffer shall be large enough, see
+ * \ref rohc_comp_rfc5225_ip_get_CO_pkt_len
  *
  * @param ctxt              The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param rohc_pkt          OUT: The ROHC packet
- * @param rohc_pkt_max_len  The maximum length of the ROHC packet
- * @return                  The length of the ROHC packet if successful,
- *                          -1 otherwise
+ * @return                  The length of the irregular chain
  */
-static int rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
-                                            const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                            uint8_t *const rohc_pkt,
-                                            const size_t rohc_pkt_max_len)
+static size_t rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
+                                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                               uint8_t *const rohc_pkt)
 {
 	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
-
 	uint8_t *rohc_remain_data = rohc_pkt;
-	size_t rohc_remain_len = rohc_pkt_max_len;
-
 	size_t ip_hdr_pos;
-	int ret;
 
 	/* there is at least one IP header otherwise it won't be the IP-only profile */
 	assert(rfc5225_ctxt->ip_contexts_nr > 0);
 
-	/* add dynamic part for all IP headers */
+	/* add irregular part for all IP headers */
 	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_contexts_nr; ip_hdr_pos++)
 	{
 		const ip_context_t *const ip_ctxt = &(rfc5225_ctxt->ip_contexts[ip_hdr_pos]);
@@ -2670,38 +2512,21 @@ static int rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const c
 
 		if(ip_hdr->version == IPV4)
 		{
-			ret = rohc_comp_rfc5225_ip_irreg_ipv4_part(ctxt, ip_ctxt, ip_hdr->ipv4, is_innermost,
-			                                           rohc_remain_data, rohc_remain_len);
-			if(ret < 0)
-			{
-				rohc_comp_warn(ctxt, "failed to build the IPv4 base header part "
-				               "of the irregular chain");
-				goto error;
-			}
-			rohc_remain_data += ret;
-			rohc_remain_len -= ret;
+			rohc_remain_data +=
+				rohc_comp_rfc5225_ip_irreg_ipv4_part(ctxt, ip_ctxt, ip_hdr->ipv4,
+				                                     is_innermost, rohc_remain_data);
 		}
 		else /* IPv6 */
 		{
-			ret = rohc_comp_rfc5225_ip_irreg_ipv6_part(ctxt, ip_ctxt, ip_hdr->ipv6, is_innermost,
-			                                           rohc_remain_data, rohc_remain_len);
-			if(ret < 0)
-			{
-				rohc_comp_warn(ctxt, "failed to build the IPv6 base header part "
-				               "of the irregular chain");
-				goto error;
-			}
-			rohc_remain_data += ret;
-			rohc_remain_len -= ret;
+			rohc_remain_data +=
+				rohc_comp_rfc5225_ip_irreg_ipv6_part(ctxt, ip_ctxt, ip_hdr->ipv6,
+				                                     is_innermost, rohc_remain_data);
 
 			/* TODO: handle IPv6 extension headers */
 		}
 	}
 
-	return (rohc_pkt_max_len - rohc_remain_len);
-
-error:
-	return -1;
+	return (rohc_remain_data - rohc_pkt);
 }
 
 
@@ -2714,20 +2539,15 @@ error:
  * @param is_innermost    true if the IP header is the innermost of the packet,
  *                        false otherwise
  * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @return                The length appended in the ROHC buffer
  */
-static int rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
-                                                const ip_context_t *const ip_ctxt,
-                                                const struct ipv4_hdr *const ipv4,
-                                                const bool is_innermost,
-                                                uint8_t *const rohc_data,
-                                                const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                                   const ip_context_t *const ip_ctxt,
+                                                   const struct ipv4_hdr *const ipv4,
+                                                   const bool is_innermost,
+                                                   uint8_t *const rohc_data)
 {
 	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
-	uint8_t *rohc_remain_data = rohc_data;
-	size_t rohc_remain_len = rohc_max_len;
 	size_t ipv4_irreg_len = 0;
 
 	assert(ip_ctxt->version == IPV4);
@@ -2735,17 +2555,7 @@ static int rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *con
 	/* IP ID if random */
 	if(ip_ctxt->ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND)
 	{
-		if(rohc_remain_len < sizeof(uint16_t))
-		{
-			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv4 header "
-			               "irregular part: %zu bytes required for random IP-ID, "
-			               "but only %zu bytes available", sizeof(uint16_t),
-			               rohc_remain_len);
-			goto error;
-		}
-		memcpy(rohc_remain_data, &ipv4->id, sizeof(uint16_t));
-		rohc_remain_data += sizeof(uint16_t);
-		rohc_remain_len -= sizeof(uint16_t);
+		memcpy(rohc_data, &ipv4->id, sizeof(uint16_t));
 		ipv4_irreg_len += sizeof(uint16_t);
 		rohc_comp_debug(ctxt, "random IP-ID 0x%04x", rohc_ntoh16(ipv4->id));
 	}
@@ -2753,31 +2563,14 @@ static int rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *con
 	/* TOS and TTL for outer IP headers */
 	if(!is_innermost && rfc5225_ctxt->tmp.outer_ip_flag)
 	{
-		const size_t tos_ttl_req_len = 2;
-
-		if(rohc_remain_len < tos_ttl_req_len)
-		{
-			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv4 header "
-			               "irregular part: %zu bytes required for TOS and TTL, "
-			               "but only %zu bytes available", tos_ttl_req_len,
-			               rohc_remain_len);
-			goto error;
-		}
-		rohc_remain_data[0] = ipv4->tos;
-		rohc_remain_data[1] = ipv4->ttl;
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-		rohc_remain_data += tos_ttl_req_len;
-		rohc_remain_len -= tos_ttl_req_len;
-#endif
-		ipv4_irreg_len += tos_ttl_req_len;
+		rohc_data[ipv4_irreg_len] = ipv4->tos;
+		rohc_data[ipv4_irreg_len + 1] = ipv4->ttl;
+		ipv4_irreg_len += 2;
 	}
 
 	rohc_comp_dump_buf(ctxt, "IPv4 irregular part", rohc_data, ipv4_irreg_len);
 
 	return ipv4_irreg_len;
-
-error:
-	return -1;
 }
 
 
@@ -2790,20 +2583,15 @@ error:
  * @param is_innermost    true if the IP header is the innermost of the packet,
  *                        false otherwise
  * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @return                The length appended in the ROHC buffer
  */
-static int rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
-                                                const ip_context_t *const ip_ctxt,
-                                                const struct ipv6_hdr *const ipv6,
-                                                const bool is_innermost,
-                                                uint8_t *const rohc_data,
-                                                const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                                   const ip_context_t *const ip_ctxt,
+                                                   const struct ipv6_hdr *const ipv6,
+                                                   const bool is_innermost,
+                                                   uint8_t *const rohc_data)
 {
 	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
-	uint8_t *rohc_remain_data = rohc_data;
-	size_t rohc_remain_len = rohc_max_len;
 	size_t ipv6_irreg_len = 0;
 
 	assert(ip_ctxt->version == IPV6);
@@ -2811,31 +2599,14 @@ static int rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *con
 	/* TOS and TTL for outer IP headers */
 	if(!is_innermost && rfc5225_ctxt->tmp.outer_ip_flag)
 	{
-		const size_t tc_hl_req_len = 2;
-
-		if(rohc_remain_len < tc_hl_req_len)
-		{
-			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv6 header "
-			               "irregular part: %zu bytes required for TC and HL, "
-			               "but only %zu bytes available", tc_hl_req_len,
-			               rohc_remain_len);
-			goto error;
-		}
-		rohc_remain_data[0] = ipv6_get_tc(ipv6);
-		rohc_remain_data[1] = ipv6->hl;
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-		rohc_remain_data += tc_hl_req_len;
-		rohc_remain_len -= tc_hl_req_len;
-#endif
-		ipv6_irreg_len += tc_hl_req_len;
+		rohc_data[0] = ipv6_get_tc(ipv6);
+		rohc_data[1] = ipv6->hl;
+		ipv6_irreg_len += 2;
 	}
 
 	rohc_comp_dump_buf(ctxt, "IPv6 irregular part", rohc_data, ipv6_irreg_len);
 
 	return ipv6_irreg_len;
-
-error:
-	return -1;
 }
 
 
@@ -2845,34 +2616,20 @@ error:
  * @param context         The compression context
  * @param crc             The CRC on the uncompressed headers
  * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @return                The length appended in the ROHC buffer
  */
-static int rohc_comp_rfc5225_ip_build_pt_0_crc3_pkt(const struct rohc_comp_ctxt *const context,
-                                                    const uint8_t crc,
-                                                    uint8_t *const rohc_data,
-                                                    const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_0_crc3_pkt(const struct rohc_comp_ctxt *const context,
+                                                       const uint8_t crc,
+                                                       uint8_t *const rohc_data)
 {
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	pt_0_crc3_t *const pt_0_crc3 = (pt_0_crc3_t *) rohc_data;
 
-	if(rohc_max_len < sizeof(pt_0_crc3_t))
-	{
-		rohc_comp_warn(context, "ROHC buffer too small for the pt_0_crc3_t header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(pt_0_crc3_t), rohc_max_len);
-		goto error;
-	}
-
 	pt_0_crc3->discriminator = 0x0;
 	pt_0_crc3->msn = rfc5225_ctxt->msn & 0xf;
 	pt_0_crc3->header_crc = crc;
 
 	return sizeof(pt_0_crc3_t);
-
-error:
-	return -1;
 }
 
 
@@ -2882,35 +2639,21 @@ error:
  * @param context         The compression context
  * @param crc             The CRC on the uncompressed headers
  * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @return                The length appended in the ROHC buffer
  */
-static int rohc_comp_rfc5225_ip_build_pt_0_crc7_pkt(const struct rohc_comp_ctxt *const context,
-                                                    const uint8_t crc,
-                                                    uint8_t *const rohc_data,
-                                                    const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_0_crc7_pkt(const struct rohc_comp_ctxt *const context,
+                                                       const uint8_t crc,
+                                                       uint8_t *const rohc_data)
 {
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	pt_0_crc7_t *const pt_0_crc7 = (pt_0_crc7_t *) rohc_data;
 
-	if(rohc_max_len < sizeof(pt_0_crc7_t))
-	{
-		rohc_comp_warn(context, "ROHC buffer too small for the pt_0_crc7_t header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(pt_0_crc7_t), rohc_max_len);
-		goto error;
-	}
-
 	pt_0_crc7->discriminator = 0x4;
 	pt_0_crc7->msn_1 = (rfc5225_ctxt->msn >> 1) & 0x1f;
 	pt_0_crc7->msn_2 = rfc5225_ctxt->msn & 0x01;
 	pt_0_crc7->header_crc = crc;
 
 	return sizeof(pt_0_crc7_t);
-
-error:
-	return -1;
 }
 
 
@@ -2920,26 +2663,15 @@ error:
  * @param context         The compression context
  * @param crc             The CRC on the uncompressed headers
  * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @return                The length appended in the ROHC buffer
  */
-static int rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctxt *const context,
-                                                      const uint8_t crc,
-                                                      uint8_t *const rohc_data,
-                                                      const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                         const uint8_t crc,
+                                                         uint8_t *const rohc_data)
 {
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	pt_1_seq_id_t *const pt_1_seq_id = (pt_1_seq_id_t *) rohc_data;
 
-	if(rohc_max_len < sizeof(pt_1_seq_id_t))
-	{
-		rohc_comp_warn(context, "ROHC buffer too small for the pt_1_seq_id header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(pt_1_seq_id_t), rohc_max_len);
-		goto error;
-	}
-
 	pt_1_seq_id->discriminator = 0x5;
 	pt_1_seq_id->header_crc = crc;
 	pt_1_seq_id->msn_1 = (rfc5225_ctxt->msn >> 4) & 0x03;
@@ -2947,9 +2679,6 @@ static int rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctx
 	pt_1_seq_id->ip_id = rfc5225_ctxt->tmp.innermost_ip_id_offset & 0x0f;
 
 	return sizeof(pt_1_seq_id_t);
-
-error:
-	return -1;
 }
 
 
@@ -2959,26 +2688,15 @@ error:
  * @param context         The compression context
  * @param crc             The CRC on the uncompressed headers
  * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @return                The length appended in the ROHC buffer
  */
-static int rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctxt *const context,
-                                                      const uint8_t crc,
-                                                      uint8_t *const rohc_data,
-                                                      const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                         const uint8_t crc,
+                                                         uint8_t *const rohc_data)
 {
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	pt_2_seq_id_t *const pt_2_seq_id = (pt_2_seq_id_t *) rohc_data;
 
-	if(rohc_max_len < sizeof(pt_2_seq_id_t))
-	{
-		rohc_comp_warn(context, "ROHC buffer too small for the pt_2_seq_id header: "
-		               "%zu bytes required, but only %zu bytes available",
-		               sizeof(pt_2_seq_id_t), rohc_max_len);
-		goto error;
-	}
-
 	pt_2_seq_id->discriminator = 0x6;
 	pt_2_seq_id->ip_id_1 = (rfc5225_ctxt->tmp.innermost_ip_id_offset >> 1) & 0x1f;
 	pt_2_seq_id->ip_id_2 = rfc5225_ctxt->tmp.innermost_ip_id_offset & 0x01;
@@ -2986,9 +2704,6 @@ static int rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctx
 	pt_2_seq_id->msn = rfc5225_ctxt->msn & 0xff;
 
 	return sizeof(pt_2_seq_id_t);
-
-error:
-	return -1;
 }
 
 
@@ -2997,33 +2712,25 @@ error:
  *
  * @param context         The compression context
  * @param crc             The CRC on the uncompressed headers
+ * @param ip_id_len       The length of the innermost IP-ID, see
+ *                        \ref rohc_comp_rfc5225_ip_get_CO_pkt_len
  * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @return                The length appended in the ROHC buffer
  */
-static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt *const context,
-                                                    const uint8_t crc,
-                                                    uint8_t *const rohc_data,
-                                                    const size_t rohc_max_len)
+static size_t rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt *const context,
+                                                       const uint8_t crc,
+                                                       const size_t ip_id_len,
+                                                       uint8_t *const rohc_data)
 {
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	const ip_context_t *const innermost_ip_ctxt =
 		&(rfc5225_ctxt->ip_contexts[rfc5225_ctxt->ip_contexts_nr - 1]);
 	const uint8_t innermost_ip_id_behavior = innermost_ip_ctxt->ip_id_behavior;
 	uint8_t *rohc_remain_data = rohc_data;
-	size_t rohc_remain_len = rohc_max_len;
 	co_common_base_t *const co_common = (co_common_base_t *) rohc_remain_data;
 	size_t co_common_hdr_len = 0;
 
 	/* code the fixed part of the co_common packet */
-	if(rohc_remain_len < sizeof(co_common_base_t))
-	{
-		rohc_comp_warn(context, "ROHC buffer too small for the co_common base "
-		               "header: %zu bytes required, but only %zu bytes available",
-		               sizeof(co_common_base_t), rohc_remain_len);
-		goto error;
-	}
 	co_common->discriminator = 0xfa; /* '11111010' */
 	/* ip_id_indicator is set later in the function */
 	co_common->header_crc = crc;
@@ -3039,7 +2746,7 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 	}
 	co_common->ttl_hopl_ind = rfc5225_ctxt->tmp.innermost_ttl_hopl_changed;
 	co_common->tos_tc_ind = rfc5225_ctxt->tmp.innermost_tos_tc_changed;
-	co_common->reorder_ratio = context->compressor->reorder_ratio;
+	co_common->reorder_ratio = context->reorder_ratio;
 
 	/* CRC-3 over control fields */
 	{
@@ -3065,17 +2772,16 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 		}
 		co_common->control_crc3 =
 			compute_crc_ctrl_fields(context->profile->id,
-			                        context->compressor->reorder_ratio,
+			                        context->reorder_ratio,
 			                        rfc5225_ctxt->msn,
 			                        ip_id_behaviors, ip_id_behaviors_nr);
 		rohc_comp_debug(context, "CRC-3 on control fields = 0x%x "
 		                "(reorder_ratio = 0x%02x, MSN = 0x%04x, %zu IP-ID behaviors)",
-		                co_common->control_crc3, context->compressor->reorder_ratio,
+		                co_common->control_crc3, context->reorder_ratio,
 		                rfc5225_ctxt->msn, ip_id_behaviors_nr);
 	}
 
 	rohc_remain_data += sizeof(co_common_base_t);
-	rohc_remain_len -= sizeof(co_common_base_t);
 	co_common_hdr_len += sizeof(co_common_base_t);
 
 	/* code the variable part of the co_common packet */
@@ -3088,15 +2794,6 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 
 		rohc_comp_debug(context, "add profile_2_3_4_flags to co_common");
 
-		if(rohc_remain_len < sizeof(profile_2_3_4_flags_t))
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the co_common "
-			               "profile_2_3_4_flags: %zu bytes required, but only "
-			               "%zu bytes available", sizeof(profile_2_3_4_flags_t),
-			               rohc_remain_len);
-			goto error;
-		}
-
 		profile_2_3_4_flags->ip_outer_indicator = rfc5225_ctxt->tmp.outer_ip_flag;
 		profile_2_3_4_flags->df = rfc5225_ctxt->tmp.innermost_df;
 		assert(innermost_ip_id_behavior == (innermost_ip_id_behavior & 0x03));
@@ -3104,7 +2801,6 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 		profile_2_3_4_flags->reserved = 0;
 
 		rohc_remain_data += sizeof(profile_2_3_4_flags_t);
-		rohc_remain_len -= sizeof(profile_2_3_4_flags_t);
 		co_common_hdr_len += sizeof(profile_2_3_4_flags_t);
 	}
 
@@ -3112,16 +2808,8 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 	if(co_common->tos_tc_ind)
 	{
 		rohc_comp_debug(context, "add TOS/TC to co_common");
-		if(rohc_remain_len < 1)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the co_common "
-			               "innermost TOS/TC: 1 byte required, but only "
-			               "%zu bytes available", rohc_remain_len);
-			goto error;
-		}
 		rohc_remain_data[0] = rfc5225_ctxt->tmp.innermost_tos_tc;
 		rohc_remain_data++;
-		rohc_remain_len--;
 		co_common_hdr_len++;
 	}
 
@@ -3129,66 +2817,44 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 	if(co_common->ttl_hopl_ind)
 	{
 		rohc_comp_debug(context, "add TTL/HL to co_common");
-		if(rohc_remain_len < 1)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the co_common "
-			               "innermost TTL/HL: 1 byte required, but only "
-			               "%zu bytes available", rohc_remain_len);
-			goto error;
-		}
 		rohc_remain_data[0] = rfc5225_ctxt->tmp.innermost_ttl_hopl;
 		rohc_remain_data++;
-		rohc_remain_len--;
 		co_common_hdr_len++;
 	}
 
 	/* 8 LSB of MSN */
 	rohc_comp_debug(context, "add MSN to co_common");
-	if(rohc_remain_len < 1)
-	{
-		rohc_comp_warn(context, "ROHC buffer too small for the co_common "
-		               "8 LSB of MSN: 1 byte required, but only "
-		               "%zu bytes available", rohc_remain_len);
-			goto error;
-	}
 	rohc_remain_data[0] = rfc5225_ctxt->msn & 0xff;
 	rohc_remain_data++;
-	rohc_remain_len--;
 	co_common_hdr_len++;
 
-	/* innermost IP-ID */
+	/* innermost IP-ID: ip_id_sequential_variable(), the length was chosen
+	 * with the W-LSB window when the length of the packet was computed */
+	if(ip_id_len == 1)
 	{
-		int indicator;
-		int ret;
-
-		ret = c_optional_ip_id_lsb(innermost_ip_id_behavior,
-		                           rohc_hton16(rfc5225_ctxt->tmp.innermost_ip_id),
-		                           rfc5225_ctxt->tmp.innermost_ip_id_offset,
-		                           &rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-		                           rohc_interval_get_rfc5225_id_id_p(8),
-		                           rohc_remain_data, rohc_remain_len, &indicator);
-		if(ret < 0)
-		{
-			rohc_comp_warn(context, "failed to encode ip_id_sequential_variable()");
-			goto error;
-		}
-		rohc_comp_debug(context, "add %d bytes of innermost IP-ID to co_common", ret);
-		co_common->ip_id_ind = indicator;
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-		rohc_remain_data += ret;
-		rohc_remain_len -= ret;
-#endif
-		co_common_hdr_len += ret;
+		rohc_remain_data[0] = rfc5225_ctxt->tmp.innermost_ip_id_offset & 0xff;
+		co_common->ip_id_ind = 0;
+	}
+	else if(ip_id_len == sizeof(uint16_t))
+	{
+		const uint16_t ip_id_nbo = rohc_hton16(rfc5225_ctxt->tmp.innermost_ip_id);
+		memcpy(rohc_remain_data, &ip_id_nbo, sizeof(uint16_t));
+		co_common->ip_id_ind = 1;
 	}
+	else
+	{
+		assert(ip_id_len == 0);
+		co_common->ip_id_ind = 0;
+	}
+	rohc_comp_debug(context, "add %zu bytes of innermost IP-ID to co_common",
+	                ip_id_len);
+	co_common_hdr_len += ip_id_len;
 
 	/* co_common header was successfully built */
 	rohc_comp_debug(context, "co_common packet, length %zu", co_common_hdr_len);
 	rohc_comp_dump_buf(context, "current ROHC packet", rohc_data, co_common_hdr_len);
 
 	return co_common_hdr_len;
-
-error:
-	return -1;
 }
 
 
@@ -3202,6 +2868,8 @@ const struct rohc_comp_profile rohc_comp_rfc5225_ip_profile =
 	.create         = rohc_comp_rfc5225_ip_create,     /* profile handlers */
 	.clone          = NULL,
 	.destroy        = rohc_comp_rfc5225_ip_destroy,
+	.save           = rohc_comp_rfc5225_ip_save,
+	.restore        = rohc_comp_rfc5225_ip_restore,
 	.encode         = rohc_comp_rfc5225_ip_encode,
 	.feedback       = rohc_comp_rfc5225_ip_feedback,
 };
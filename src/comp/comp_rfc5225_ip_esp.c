@@ -23,6 +23,7 @@
  */
 
 #include "rohc_comp_internals.h"
+#include "comp_rfc5225.h"
 #include "rohc_traces.h"
 #include "rohc_traces_internal.h"
 #include "rohc_debug.h"
@@ -153,6 +154,16 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 static void rohc_comp_rfc5225_ip_esp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+/* save/restore context */
+static size_t rohc_comp_rfc5225_ip_esp_save(const struct rohc_comp_ctxt *const ctxt,
+                                            uint8_t *const image,
+                                            const size_t image_max_len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool rohc_comp_rfc5225_ip_esp_restore(struct rohc_comp_ctxt *const ctxt,
+                                             const uint8_t *const image,
+                                             const size_t image_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 /* encode ROHCv2 IP/ESP packets */
 static int rohc_comp_rfc5225_ip_esp_encode(struct rohc_comp_ctxt *const context,
                                            const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -171,7 +182,7 @@ static void rohc_comp_rfc5225_ip_esp_detect_changes_ipv4(struct rohc_comp_ctxt *
                                                          const bool is_innermost)
 	__attribute__((nonnull(1, 2, 3)));
 
-static int rohc_comp_rfc5225_ip_esp_code_IR_pkt(const struct rohc_comp_ctxt *const ctxt,
+static int rohc_comp_rfc5225_ip_esp_code_IR_pkt(struct rohc_comp_ctxt *const ctxt,
                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                 uint8_t *const rohc_pkt,
                                                 const size_t rohc_pkt_max_len)
@@ -226,18 +237,6 @@ static int rohc_comp_rfc5225_ip_esp_static_chain(const struct rohc_comp_ctxt *co
                                                  uint8_t *const rohc_pkt,
                                                  const size_t rohc_pkt_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
-static int rohc_comp_rfc5225_ip_esp_static_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
-                                                 const struct ipv4_hdr *const ipv4,
-                                                 const bool is_innermost,
-                                                 uint8_t *const rohc_data,
-                                                 const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
-static int rohc_comp_rfc5225_ip_esp_static_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
-                                                 const struct ipv6_hdr *const ipv6,
-                                                 const bool is_innermost,
-                                                 uint8_t *const rohc_data,
-                                                 const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 static int rohc_comp_rfc5225_ip_esp_static_esp_part(const struct rohc_comp_ctxt *const ctxt,
                                                     const struct esphdr *const esp,
                                                     uint8_t *const rohc_data,
@@ -310,10 +309,6 @@ static void rohc_comp_rfc5225_ip_esp_feedback_ack(struct rohc_comp_ctxt *const c
 	__attribute__((nonnull(1)));
 
 /* mode and state transitions */
-static void rohc_comp_rfc5225_ip_esp_decide_state(struct rohc_comp_ctxt *const context,
-                                                  const struct rohc_ts pkt_time)
-	__attribute__((nonnull(1)));
-
 /* decide packet */
 static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_pkt(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -373,6 +368,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_mempool *const mempool = &context->compressor->mempool;
 	struct rohc_comp_rfc5225_ip_esp_ctxt *rfc5225_ctxt;
 	size_t ip_hdr_pos;
 	bool is_ok;
@@ -381,7 +377,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 	assert(uncomp_pkt_hdrs->esp != NULL);
 
 	/* create the ROHCv2 IP/ESP part of the profile context */
-	rfc5225_ctxt = calloc(1, sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt));
+	rfc5225_ctxt = rohc_mempool_alloc(mempool, sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt));
 	if(rfc5225_ctxt == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -431,7 +427,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 	rfc5225_ctxt->ip_contexts_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
 	/* MSN */
-	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -441,7 +437,7 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 
 	/* innermost IP-ID offset */
 	is_ok = wlsb_new(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                 comp->oa_repetitions_nr);
+	                 comp->oa_repetitions_nr, mempool);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -462,7 +458,8 @@ static bool rohc_comp_rfc5225_ip_esp_create(struct rohc_comp_ctxt *const context
 free_wlsb_msn:
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
 free_context:
-	free(rfc5225_ctxt);
+	rohc_mempool_release(&context->compressor->mempool, rfc5225_ctxt,
+	                     sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt));
 error:
 	return false;
 }
@@ -482,7 +479,67 @@ static void rohc_comp_rfc5225_ip_esp_destroy(struct rohc_comp_ctxt *const contex
 
 	wlsb_free(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
-	free(rfc5225_ctxt);
+	rohc_mempool_release(&context->compressor->mempool, rfc5225_ctxt,
+	                     sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt));
+}
+
+
+/**
+ * @brief Save the ROHCv2 IP/ESP part of one context in a context image
+ *
+ * @param ctxt           The compression context
+ * @param image          The image to save the context in, may be NULL
+ * @param image_max_len  The length available in the image
+ * @return               The length of the profile-specific part of the
+ *                       context, saved only if it fits in the image
+ */
+static size_t rohc_comp_rfc5225_ip_esp_save(const struct rohc_comp_ctxt *const ctxt,
+                                            uint8_t *const image,
+                                            const size_t image_max_len)
+{
+	return rohc_comp_rfc5225_save(ctxt, sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt),
+	                              offsetof(struct rohc_comp_rfc5225_ip_esp_ctxt, msn_wlsb),
+	                              offsetof(struct rohc_comp_rfc5225_ip_esp_ctxt, innermost_ip_id_offset_wlsb),
+	                              image, image_max_len);
+}
+
+
+/**
+ * @brief Restore the ROHCv2 IP/ESP part of one context from a context image
+ *
+ * @param ctxt       The compression context
+ * @param image      The part saved by \ref rohc_comp_rfc5225_ip_esp_save
+ * @param image_len  The length of the part saved
+ * @return           true if successful, false otherwise
+ */
+static bool rohc_comp_rfc5225_ip_esp_restore(struct rohc_comp_ctxt *const ctxt,
+                                             const uint8_t *const image,
+                                             const size_t image_len)
+{
+	const struct rohc_comp_rfc5225_ip_esp_ctxt *rfc5225_ctxt;
+
+	if(!rohc_comp_rfc5225_restore(ctxt, sizeof(struct rohc_comp_rfc5225_ip_esp_ctxt),
+	                              offsetof(struct rohc_comp_rfc5225_ip_esp_ctxt, msn_wlsb),
+	                              offsetof(struct rohc_comp_rfc5225_ip_esp_ctxt, innermost_ip_id_offset_wlsb),
+	                              image, image_len))
+	{
+		goto error;
+	}
+	rfc5225_ctxt = ctxt->specific;
+
+	if(rfc5225_ctxt->ip_contexts_nr == 0 ||
+	   rfc5225_ctxt->ip_contexts_nr > ROHC_MAX_IP_HDRS)
+	{
+		rohc_comp_warn(ctxt, "malformed context image: %zu IP headers",
+		               rfc5225_ctxt->ip_contexts_nr);
+		rohc_comp_rfc5225_ip_esp_destroy(ctxt);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -514,7 +571,7 @@ static int rohc_comp_rfc5225_ip_esp_encode(struct rohc_comp_ctxt *const context,
                                            const size_t rohc_pkt_max_len,
                                            rohc_packet_t *const packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt = context->specific;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
@@ -530,7 +587,7 @@ static int rohc_comp_rfc5225_ip_esp_encode(struct rohc_comp_ctxt *const context,
 	rohc_comp_rfc5225_ip_esp_detect_changes(context, uncomp_pkt_hdrs);
 
 	/* STEP 1: decide state */
-	rohc_comp_rfc5225_ip_esp_decide_state(context, uncomp_pkt_time);
+	rohc_comp_rfc5225_decide_state(context, uncomp_pkt_time);
 
 	/* STEP 2: decide packet type */
 	*packet_type = rohc_comp_rfc5225_ip_esp_decide_pkt(context);
@@ -602,6 +659,12 @@ static int rohc_comp_rfc5225_ip_esp_encode(struct rohc_comp_ctxt *const context,
 
 		if(ip_hdr->version == IPV4)
 		{
+			if((ip_hdr_pos + 1) == rfc5225_ctxt->ip_contexts_nr &&
+			   context->num_sent_packets > 0 &&
+			   ip_ctxt->last_ip_id_behavior != ip_ctxt->ip_id_behavior)
+			{
+				context->ip_id_behavior_changes_nr++;
+			}
 			ip_ctxt->last_ip_id_behavior = ip_ctxt->ip_id_behavior;
 			ip_ctxt->last_ip_id = rohc_ntoh16(ip_hdr->ipv4->id);
 			/* add the new IP-ID offset to the W-LSB encoding object */
@@ -678,7 +741,7 @@ error:
 static void rohc_comp_rfc5225_ip_esp_detect_changes(struct rohc_comp_ctxt *const context,
                                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt = context->specific;
 	ip_context_t *innermost_ip_ctxt = NULL;
 	size_t ip_hdr_pos;
@@ -796,9 +859,23 @@ static void rohc_comp_rfc5225_ip_esp_detect_changes(struct rohc_comp_ctxt *const
 		}
 		else
 		{
-			ip_id_behavior =
+			const rohc_ip_id_behavior_t detected_behavior =
 				rohc_comp_detect_ip_id_behavior(last_ip_id, ip_id,
 				                                rfc5225_ctxt->tmp.msn_offset, 19);
+
+			/* do not reclassify the IP-ID behavior on one IP-ID out of pattern */
+			ip_id_behavior =
+				rohc_comp_ip_id_behavior_hysteresis(&innermost_ip_ctxt->ip_id_hyst,
+				                                    last_ip_id_behavior,
+				                                    detected_behavior, ip_id,
+				                                    context->compressor->ip_id_hysteresis_nr);
+			if(ip_id_behavior != detected_behavior)
+			{
+				rohc_comp_debug(context, "IP-ID behaved as %s in packet, wait for "
+				                "%u consistent observations before changing behavior",
+				                rohc_ip_id_behavior_get_descr(detected_behavior),
+				                context->compressor->ip_id_hysteresis_nr);
+			}
 		}
 		/* TODO: avoid changing context here */
 		innermost_ip_ctxt->ip_id_behavior = ip_id_behavior;
@@ -1165,40 +1242,12 @@ static bool rohc_comp_rfc5225_ip_esp_feedback_2(struct rohc_comp_ctxt *const ctx
                                                 const uint8_t *const feedback_data,
                                                 const size_t feedback_data_len)
 {
-	const uint8_t *remain_data = feedback_data;
-	size_t remain_len = feedback_data_len;
-	const struct rohc_feedback_2_rfc6846 *feedback2;
-
-	size_t opts_present[ROHC_FEEDBACK_OPT_MAX] = { 0 };
+	struct rohc_comp_feedback_2 feedback2;
 
-	uint8_t crc_in_packet;
-	size_t crc_pos_from_end;
-
-	uint32_t sn_bits;
-	size_t sn_bits_nr;
-
-	/* retrieve acked MSN */
-	if(remain_len < sizeof(struct rohc_feedback_2_rfc6846))
-	{
-		rohc_comp_warn(ctxt, "malformed FEEDBACK-2: packet too short for the "
-		               "minimal %zu-byte header, only %zu bytes remaining",
-		               sizeof(struct rohc_feedback_2_rfc6846), remain_len);
-		goto error;
-	}
-	feedback2 = (const struct rohc_feedback_2_rfc6846 *) feedback_data;
-	sn_bits = (feedback2->sn1 << 8) | feedback2->sn2;
-	sn_bits_nr = 6 + 8;
-	crc_in_packet = feedback2->crc;
-	crc_pos_from_end = remain_len - 2;
-	remain_data += 3;
-	remain_len -= 3;
-
-	/* parse FEEDBACK-2 options */
-	if(!rohc_comp_feedback_parse_opts(ctxt, packet, packet_len,
-	                                  remain_data, remain_len,
-	                                  opts_present, &sn_bits, &sn_bits_nr,
-	                                  ROHC_FEEDBACK_WITH_CRC_BASE,
-	                                  crc_in_packet, crc_pos_from_end))
+	/* parse FEEDBACK-2 base header and options, check CRC */
+	if(!rohc_comp_feedback_parse_2(ctxt, packet, packet_len,
+	                               feedback_data, feedback_data_len,
+	                               ROHC_FEEDBACK_WITH_CRC_BASE, &feedback2))
 	{
 		rohc_comp_warn(ctxt, "malformed FEEDBACK-2: failed to parse options");
 		goto error;
@@ -1208,19 +1257,19 @@ static bool rohc_comp_rfc5225_ip_esp_feedback_2(struct rohc_comp_ctxt *const ctx
 	rohc_comp_change_mode(ctxt, ROHC_O_MODE);
 
 	/* act according to the type of feedback */
-	switch(feedback2->ack_type)
+	switch(feedback2.ack_type)
 	{
 		case ROHC_FEEDBACK_ACK:
 		{
-			const bool sn_not_valid =
-				!!(opts_present[ROHC_FEEDBACK_OPT_ACKNUMBER_NOT_VALID] > 0);
+			const bool sn_not_valid = feedback2.sn_not_valid;
 
-			rohc_comp_debug(ctxt, "ACK received (CID = %u, %zu-bit SN = 0x%x, "
-			                "ACKNUMBER-NOT-VALID = %d)", ctxt->cid, sn_bits_nr,
-			                sn_bits, GET_REAL(sn_not_valid));
+			rohc_comp_debug(ctxt, "ACK received (CID = %u, %u-bit SN = 0x%x, "
+			                "ACKNUMBER-NOT-VALID = %d)", ctxt->cid, feedback2.sn_bits_nr,
+			                feedback2.sn_bits, GET_REAL(sn_not_valid));
 
 			/* the compressor received a positive ACK */
-			rohc_comp_rfc5225_ip_esp_feedback_ack(ctxt, sn_bits, sn_bits_nr, sn_not_valid);
+			rohc_comp_rfc5225_ip_esp_feedback_ack(ctxt, feedback2.sn_bits,
+			                                      feedback2.sn_bits_nr, sn_not_valid);
 			break;
 		}
 		case ROHC_FEEDBACK_NACK:
@@ -1233,6 +1282,10 @@ static bool rohc_comp_rfc5225_ip_esp_feedback_2(struct rohc_comp_ctxt *const ctx
 			{
 				rohc_comp_change_state(ctxt, ROHC_COMP_STATE_FO);
 			}
+			/* the link loses packets, so repeat the changes more */
+			rohc_comp_oa_on_nack(ctxt);
+			/* the link may reorder packets, so handle more reordering */
+			rohc_comp_reorder_on_nack(ctxt);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1244,6 +1297,8 @@ static bool rohc_comp_rfc5225_ip_esp_feedback_2(struct rohc_comp_ctxt *const ctx
 			          "STATIC-NACK received for CID %u", ctxt->cid);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(ctxt, ROHC_COMP_STATE_IR);
+			/* the link loses packets, so repeat the changes more */
+			rohc_comp_oa_on_nack(ctxt);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1258,7 +1313,7 @@ static bool rohc_comp_rfc5225_ip_esp_feedback_2(struct rohc_comp_ctxt *const ctx
 		{
 			/* impossible value */
 			rohc_comp_warn(ctxt, "malformed FEEDBACK-2: unknown ACK type %u",
-			               feedback2->ack_type);
+			               feedback2.ack_type);
 			goto error;
 		}
 	}
@@ -1354,52 +1409,6 @@ static void rohc_comp_rfc5225_ip_esp_feedback_ack(struct rohc_comp_ctxt *const c
 }
 
 
-/**
- * @brief Decide the state that should be used for the next packet
- *
- * @param context  The compression context
- * @param pkt_time The time of packet arrival
- */
-static void rohc_comp_rfc5225_ip_esp_decide_state(struct rohc_comp_ctxt *const context,
-                                                  const struct rohc_ts pkt_time)
-{
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
-	const rohc_comp_state_t curr_state = context->state;
-	rohc_comp_state_t next_state;
-
-	assert(curr_state != ROHC_COMP_STATE_UNKNOWN);
-	assert(curr_state != ROHC_COMP_STATE_CR);
-
-	if(curr_state == ROHC_COMP_STATE_SO)
-	{
-		/* do not change state */
-		rohc_comp_debug(context, "stay in SO state");
-		next_state = ROHC_COMP_STATE_SO;
-		/* TODO: handle NACK and STATIC-NACK */
-	}
-	else if(context->state_oa_repeat_nr < oa_repetitions_nr)
-	{
-		rohc_comp_debug(context, "not enough packets transmitted in current state "
-		                "for the moment (%u/%u), so stay in current state",
-		                context->state_oa_repeat_nr, oa_repetitions_nr);
-		next_state = curr_state;
-	}
-	else
-	{
-		rohc_comp_debug(context, "enough packets transmitted in current state "
-		                "(%u/%u), go to upper state", context->state_oa_repeat_nr,
-		                oa_repetitions_nr);
-		next_state = ROHC_COMP_STATE_SO;
-	}
-
-	rohc_comp_change_state(context, next_state);
-
-	/* periodic refreshes in U-mode only */
-	if(context->mode == ROHC_U_MODE)
-	{
-		rohc_comp_periodic_down_transition(context, pkt_time);
-	}
-}
 
 
 /**
@@ -1510,133 +1519,36 @@ static rohc_packet_t rohc_comp_rfc5225_ip_esp_decide_FO_SO_pkt(const struct rohc
 {
 	struct rohc_comp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt = ctxt->specific;
 	const int32_t msn_offset = rfc5225_ctxt->tmp.msn_offset;
-	const uint8_t oa_repetitions_nr = ctxt->compressor->oa_repetitions_nr;
-	const rohc_reordering_offset_t reorder_ratio = ctxt->compressor->reorder_ratio;
+	const uint8_t oa_repetitions_nr = ctxt->oa_repetitions_nr;
 	const ip_context_t *const innermost_ip_ctxt =
 		&(rfc5225_ctxt->ip_contexts[rfc5225_ctxt->ip_contexts_nr - 1]);
-	const uint16_t innermost_ip_id = rfc5225_ctxt->tmp.innermost_ip_id;
-	const uint8_t innermost_ip_id_offset_trans_nr =
-		rfc5225_ctxt->innermost_ip_id_offset_trans_nr;
-	const rohc_ip_id_behavior_t innermost_ip_id_behavior =
-		innermost_ip_ctxt->ip_id_behavior;
+	struct rohc_comp_rfc5225_pkt_input input;
 	rohc_packet_t packet_type;
 
-	/* use pt_0_crc3 only if:
-	 *  - CRC-3 is enough to protect the compression
-	 *  - 4 MSN bits are enough
-	 *  - the innermost IP-ID is either:
-	 *     - random (transmitted in irregular chain),
-	 *     - zero (not transmitted at all),
-	 *     - sequential and inferred from MSN (and not transmitted at all).
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	if(!crc7_at_least &&
-	   rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                         rfc5225_ctxt->msn, reorder_ratio, 4) &&
-	   (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
-	    rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
-	                                           innermost_ip_id_offset_trans_nr,
-	                                           oa_repetitions_nr,
-	                                           innermost_ip_id, msn_offset)) &&
-	   !rfc5225_ctxt->tmp.outer_ip_flag &&
-	   !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	   !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	   !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code pt_0_crc3 packet");
-		packet_type = ROHC_PACKET_PT_0_CRC3;
-	}
-	/* use pt_0_crc7 only if:
-	 *  - 6 MSN bits are enough
-	 *  - the innermost IP-ID is either:
-	 *     - random (transmitted in irregular chain),
-	 *     - zero (not transmitted at all),
-	 *     - sequential and inferred from MSN (and not transmitted at all).
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
-	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
-	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
-	                                                innermost_ip_id_offset_trans_nr,
-	                                                oa_repetitions_nr,
-	                                                innermost_ip_id, msn_offset)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code pt_0_crc7 packet");
-		packet_type = ROHC_PACKET_NORTP_PT_0_CRC7;
-	}
-	/* use pt_1_seq_id only if:
-	 *  - CRC-3 is enough to protect the compression
-	 *  - 6 MSN bits are enough
-	 *  - innermost IP-ID is sequential (swapped or not)
-	 *  - 4 innermost IP-ID / SN offset bits are enough
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
-	        rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 4,
-	                                   rohc_interval_get_rfc5225_id_id_p(4)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		assert(innermost_ip_ctxt->version == IPV4);
-		rohc_comp_debug(ctxt, "code pt_1_seq_id packet");
-		packet_type = ROHC_PACKET_NORTP_PT_1_SEQ_ID;
-	}
-	/* use pt_2_seq_id only if:
-	 *  - innermost IP-ID is sequential (swapped or not)
-	 *  - 6 innermost IP-ID / SN offset bits are enough
-	 *  - 8 MSN bits are enough
-	 *  - the TOS/TC fields of all IP headers shall not be changing
-	 *  - the behavior of the innermost IP-ID shall not be changing
-	 */
-	else if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 6,
-	                                   rohc_interval_get_rfc5225_id_id_p(6)) &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 8) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code pt_2_seq_id packet");
-		packet_type = ROHC_PACKET_NORTP_PT_2_SEQ_ID;
-	}
-	/* use co_common only if:
-	 *  - the DF fields of all outer IP headers shall not be changing
-	 *  - the behavior of the outer IP-IDs shall not be changing
-	 */
-	else if(!rfc5225_ctxt->tmp.outer_df_changed &&
-	        !rfc5225_ctxt->tmp.outer_ip_id_behavior_changed)
-	{
-		rohc_comp_debug(ctxt, "code co_common packet");
-		packet_type = ROHC_PACKET_CO_COMMON;
-	}
-	else /* fallback on co_repair packet */
-	{
-		/* the co_repair packet is enough to transmit all the dynamic changes ;
-		 * if there were static changes, the context would have been reset by
-		 * the stream classifier */
-		rohc_comp_debug(ctxt, "code co_repair packet");
-		packet_type = ROHC_PACKET_CO_REPAIR;
-	}
+	input.msn_wlsb = &rfc5225_ctxt->msn_wlsb;
+	input.msn = rfc5225_ctxt->msn;
+	input.msn_bits_nr = 32;
+	input.ip_id_offset_wlsb = &rfc5225_ctxt->innermost_ip_id_offset_wlsb;
+	input.ip_id_offset = rfc5225_ctxt->tmp.innermost_ip_id_offset;
+	input.is_ip_id_seq =
+		rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_ctxt->ip_id_behavior);
+	input.is_ip_id_inferred =
+		(input.is_ip_id_seq &&
+		 rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
+		                                        rfc5225_ctxt->innermost_ip_id_offset_trans_nr,
+		                                        oa_repetitions_nr,
+		                                        rfc5225_ctxt->tmp.innermost_ip_id, msn_offset));
+	input.ip_changed = (rfc5225_ctxt->tmp.outer_ip_flag ||
+	                    rfc5225_ctxt->tmp.innermost_ip_flag ||
+	                    rfc5225_ctxt->tmp.at_least_one_df_changed ||
+	                    rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed);
+	input.outer_ip_changed = (rfc5225_ctxt->tmp.outer_df_changed ||
+	                          rfc5225_ctxt->tmp.outer_ip_id_behavior_changed);
+
+	packet_type = rohc_comp_rfc5225_decide_FO_SO_pkt(ctxt, &rohc_comp_rfc5225_pkts_esp,
+	                                                 &input, crc7_at_least);
+	assert(packet_type != ROHC_PACKET_NORTP_PT_1_SEQ_ID ||
+	       innermost_ip_ctxt->version == IPV4);
 
 	return packet_type;
 }
@@ -1739,7 +1651,7 @@ static bool rohc_comp_rfc5225_is_seq_ipid_inferred(const ip_context_t *const ip_
  * @return                  The length of the ROHC packet if successful,
  *                          -1 otherwise
  */
-static int rohc_comp_rfc5225_ip_esp_code_IR_pkt(const struct rohc_comp_ctxt *context,
+static int rohc_comp_rfc5225_ip_esp_code_IR_pkt(struct rohc_comp_ctxt *const context,
                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                 uint8_t *const rohc_pkt,
                                                 const size_t rohc_pkt_max_len)
@@ -1803,8 +1715,9 @@ static int rohc_comp_rfc5225_ip_esp_code_IR_pkt(const struct rohc_comp_ctxt *con
 	rohc_hdr_len++;
 
 	/* add static chain */
-	ret = rohc_comp_rfc5225_ip_esp_static_chain(context, uncomp_pkt_hdrs,
-	                                            rohc_remain_data, rohc_remain_len);
+	ret = rohc_comp_code_static_chain(context, uncomp_pkt_hdrs, rohc_pkt,
+	                                  rohc_hdr_len, rohc_pkt_max_len,
+	                                  rohc_comp_rfc5225_ip_esp_static_chain);
 	if(ret < 0)
 	{
 		rohc_comp_warn(context, "failed to build the static chain of the IR packet");
@@ -1833,8 +1746,7 @@ static int rohc_comp_rfc5225_ip_esp_code_IR_pkt(const struct rohc_comp_ctxt *con
 	                   rohc_pkt, rohc_hdr_len);
 
 	/* IR header was successfully built, compute the CRC */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
-	                                       rohc_hdr_len, CRC_INIT_8);
+	rohc_pkt[crc_position] = rohc_comp_ir_crc(context, rohc_pkt, rohc_hdr_len);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                rohc_hdr_len, rohc_pkt[crc_position]);
 
@@ -1939,8 +1851,9 @@ static int rohc_comp_rfc5225_ip_esp_code_co_repair_pkt(const struct rohc_comp_ct
 		co_repair_crc->r1 = 0;
 		/* CRC-7 over uncompressed headers */
 		co_repair_crc->header_crc =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, co_repair_crc->header_crc);
 
@@ -1965,12 +1878,12 @@ static int rohc_comp_rfc5225_ip_esp_code_co_repair_pkt(const struct rohc_comp_ct
 		}
 		co_repair_crc->ctrl_crc =
 			compute_crc_ctrl_fields(context->profile->id,
-			                        context->compressor->reorder_ratio,
+			                        context->reorder_ratio,
 			                        rfc5225_ctxt->msn,
 			                        ip_id_behaviors, ip_id_behaviors_nr);
 		rohc_comp_debug(context, "CRC-3 on control fields = 0x%x "
 		                "(reorder_ratio = 0x%02x, %zu IP-ID behaviors)",
-		                co_repair_crc->ctrl_crc, context->compressor->reorder_ratio,
+		                co_repair_crc->ctrl_crc, context->reorder_ratio,
 		                ip_id_behaviors_nr);
 
 		/* skip CRCs */
@@ -2037,16 +1950,18 @@ static int rohc_comp_rfc5225_ip_esp_code_CO_pkt(const struct rohc_comp_ctxt *con
 	   packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
 		rohc_comp_debug(context, "CRC-3 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_engine_calc(&context->compressor->crc_engine,
+			                ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
+			                uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -2230,8 +2145,8 @@ static int rohc_comp_rfc5225_ip_esp_static_chain(const struct rohc_comp_ctxt *co
 
 		if(ip_hdr->version == IPV4)
 		{
-			ret = rohc_comp_rfc5225_ip_esp_static_ipv4_part(ctxt, ip_hdr->ipv4, is_innermost,
-			                                                rohc_remain_data, rohc_remain_len);
+			ret = rohc_comp_rfc5225_static_ipv4_part(ctxt, ip_hdr->ipv4, is_innermost,
+			                                         rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
 				rohc_comp_warn(ctxt, "failed to build the IPv4 base header part "
@@ -2243,8 +2158,8 @@ static int rohc_comp_rfc5225_ip_esp_static_chain(const struct rohc_comp_ctxt *co
 		}
 		else /* IPv6 */
 		{
-			ret = rohc_comp_rfc5225_ip_esp_static_ipv6_part(ctxt, ip_hdr->ipv6, is_innermost,
-			                                                rohc_remain_data, rohc_remain_len);
+			ret = rohc_comp_rfc5225_static_ipv6_part(ctxt, ip_hdr->ipv6, is_innermost,
+			                                         rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
 				rohc_comp_warn(ctxt, "failed to build the IPv6 base header part "
@@ -2278,124 +2193,8 @@ error:
 }
 
 
-/**
- * @brief Build the static part of the IPv4 header
- *
- * @param ctxt            The compression context
- * @param ipv4            The IPv4 header
- * @param is_innermost    Whether the IPv4 header is the innermost IP header
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
- */
-static int rohc_comp_rfc5225_ip_esp_static_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
-                                                     const struct ipv4_hdr *const ipv4,
-                                                     const bool is_innermost,
-                                                     uint8_t *const rohc_data,
-                                                     const size_t rohc_max_len)
-{
-	ipv4_static_t *const ipv4_static = (ipv4_static_t *) rohc_data;
-	const size_t ipv4_static_len = sizeof(ipv4_static_t);
-
-	if(rohc_max_len < ipv4_static_len)
-	{
-		rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv4 static part: "
-		               "%zu bytes required, but only %zu bytes available",
-		               ipv4_static_len, rohc_max_len);
-		goto error;
-	}
-
-	ipv4_static->version_flag = 0;
-	ipv4_static->innermost_ip = GET_REAL(is_innermost);
-	ipv4_static->reserved = 0;
-	ipv4_static->protocol = ipv4->protocol;
-	rohc_comp_debug(ctxt, "IPv4 protocol = %u", ipv4_static->protocol);
-	ipv4_static->src_addr = ipv4->saddr;
-	ipv4_static->dst_addr = ipv4->daddr;
-
-	rohc_comp_dump_buf(ctxt, "IPv4 static part", rohc_data, ipv4_static_len);
-
-	return ipv4_static_len;
-
-error:
-	return -1;
-}
 
 
-/**
- * @brief Build the static part of the IPv6 header
- *
- * @param ctxt            The compression context
- * @param ipv6            The IPv6 header
- * @param is_innermost    Whether the IPv6 header is the innermost IP header
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
- */
-static int rohc_comp_rfc5225_ip_esp_static_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
-                                                     const struct ipv6_hdr *const ipv6,
-                                                     const bool is_innermost,
-                                                     uint8_t *const rohc_data,
-                                                     const size_t rohc_max_len)
-{
-	size_t ipv6_static_len;
-
-	if(ipv6->flow1 == 0 && ipv6->flow2 == 0)
-	{
-		ipv6_static_nofl_t *const ipv6_static = (ipv6_static_nofl_t *) rohc_data;
-
-		ipv6_static_len = sizeof(ipv6_static_nofl_t);
-		if(rohc_max_len < ipv6_static_len)
-		{
-			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv6 static part: "
-			               "%zu bytes required, but only %zu bytes available",
-			               ipv6_static_len, rohc_max_len);
-			goto error;
-		}
-
-		ipv6_static->version_flag = 1;
-		ipv6_static->innermost_ip = GET_REAL(is_innermost);
-		ipv6_static->reserved1 = 0;
-		ipv6_static->flow_label_enc_discriminator = 0;
-		ipv6_static->reserved2 = 0;
-		ipv6_static->next_header = ipv6->nh;
-		memcpy(ipv6_static->src_addr, &ipv6->saddr, sizeof(struct ipv6_addr));
-		memcpy(ipv6_static->dst_addr, &ipv6->daddr, sizeof(struct ipv6_addr));
-	}
-	else
-	{
-		ipv6_static_fl_t *const ipv6_static = (ipv6_static_fl_t *) rohc_data;
-
-		ipv6_static_len = sizeof(ipv6_static_fl_t);
-		if(rohc_max_len < ipv6_static_len)
-		{
-			rohc_comp_warn(ctxt, "ROHC buffer too small for the IPv6 static part: "
-			               "%zu bytes required, but only %zu bytes available",
-			               ipv6_static_len, rohc_max_len);
-			goto error;
-		}
-
-		ipv6_static->version_flag = 1;
-		ipv6_static->innermost_ip = GET_REAL(is_innermost);
-		ipv6_static->reserved = 0;
-		ipv6_static->flow_label_enc_discriminator = 1;
-		ipv6_static->flow_label_msb = ipv6->flow1;
-		ipv6_static->flow_label_lsb = ipv6->flow2;
-		ipv6_static->next_header = ipv6->nh;
-		memcpy(ipv6_static->src_addr, &ipv6->saddr, sizeof(struct ipv6_addr));
-		memcpy(ipv6_static->dst_addr, &ipv6->daddr, sizeof(struct ipv6_addr));
-	}
-	rohc_comp_debug(ctxt, "IPv6 next header = %u", ipv6->nh);
-
-	rohc_comp_dump_buf(ctxt, "IPv6 static part", rohc_data, ipv6_static_len);
-
-	return ipv6_static_len;
-
-error:
-	return -1;
-}
 
 
 /**
@@ -2663,7 +2462,7 @@ static int rohc_comp_rfc5225_ip_esp_dyn_esp_part(const struct rohc_comp_ctxt *co
 
 	esp_dynamic->sequence_number = esp->sn;
 	esp_dynamic->reserved = 0;
-	esp_dynamic->reorder_ratio = ctxt->compressor->reorder_ratio;
+	esp_dynamic->reorder_ratio = ctxt->reorder_ratio;
 
 	rohc_comp_dump_buf(ctxt, "ESP dynamic part", rohc_data, esp_dynamic_len);
 
@@ -3083,7 +2882,7 @@ static int rohc_comp_rfc5225_ip_esp_build_co_common_pkt(const struct rohc_comp_c
 	}
 	co_common->ttl_hopl_ind = rfc5225_ctxt->tmp.innermost_ttl_hopl_changed;
 	co_common->tos_tc_ind = rfc5225_ctxt->tmp.innermost_tos_tc_changed;
-	co_common->reorder_ratio = context->compressor->reorder_ratio;
+	co_common->reorder_ratio = context->reorder_ratio;
 
 	/* CRC-3 over control fields */
 	{
@@ -3109,12 +2908,12 @@ static int rohc_comp_rfc5225_ip_esp_build_co_common_pkt(const struct rohc_comp_c
 		}
 		co_common->control_crc3 =
 			compute_crc_ctrl_fields(context->profile->id,
-			                        context->compressor->reorder_ratio,
+			                        context->reorder_ratio,
 			                        rfc5225_ctxt->msn,
 			                        ip_id_behaviors, ip_id_behaviors_nr);
 		rohc_comp_debug(context, "CRC-3 on control fields = 0x%x "
 		                "(reorder_ratio = 0x%02x, %zu IP-ID behaviors)",
-		                co_common->control_crc3, context->compressor->reorder_ratio,
+		                co_common->control_crc3, context->reorder_ratio,
 		                ip_id_behaviors_nr);
 	}
 
@@ -3357,6 +3156,8 @@ const struct rohc_comp_profile rohc_comp_rfc5225_ip_esp_profile =
 	.create         = rohc_comp_rfc5225_ip_esp_create,     /* profile handlers */
 	.clone          = NULL,
 	.destroy        = rohc_comp_rfc5225_ip_esp_destroy,
+	.save           = rohc_comp_rfc5225_ip_esp_save,
+	.restore        = rohc_comp_rfc5225_ip_esp_restore,
 	.encode         = rohc_comp_rfc5225_ip_esp_encode,
 	.feedback       = rohc_comp_rfc5225_ip_esp_feedback,
 };
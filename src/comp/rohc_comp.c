@@ -52,16 +52,21 @@
 #include "rohc_bit_ops.h"
 #include "ip.h"
 #include "crc.h"
+#include "interval.h"
 #include "protocols/ip.h"
 #include "schemes/ipv6_exts.h"
+#include "schemes/ip_id_offset.h"
 #include "protocols/udp.h"
 #include "protocols/ip_numbers.h"
 #include "c_tcp_opts_list.h"
 #include "feedback_parse.h"
+#include "rohc_feedback_ring.h"
 #include "hashtable.h"
-#include "hashtable_cr.h"
+#include "rohc_probes.h"
+#include "rohc_ctxt_image.h"
+#include "rohc_channel_set.h"
 
-#include "config.h" /* for PACKAGE_(NAME|URL|VERSION) */
+#include "config.h" /* for PACKAGE_(NAME|URL|VERSION) and ROHC_BUILD_PROFILE_* */
 
 #include <string.h>
 #include <inttypes.h>
@@ -96,27 +101,62 @@ extern const struct rohc_comp_profile rohc_comp_rfc5225_ip_udp_profile;
 extern const struct rohc_comp_profile rohc_comp_rfc5225_ip_esp_profile;
 extern const struct rohc_comp_profile rohc_comp_rfc5225_ip_udp_rtp_profile;
 
-/** The ROHC compression profiles */
+/** The types of the ROHC segments: non-final segment, then final segment */
+static const uint8_t rohc_comp_seg_types[2] = { 0xfe, 0xff };
+
+/** The CRC of one FEEDBACK-2, computed while the feedback is parsed */
+struct rohc_comp_feedback_crc
+{
+	/** The CRC engine of the compressor */
+	const struct rohc_crc_engine *engine;
+	uint8_t all;          /**< The CRC over all the bytes parsed so far */
+	uint8_t zeroed;       /**< The same CRC, with the last CRC field zeroed */
+	bool is_field_found;  /**< Whether one CRC field was found so far */
+};
+
+/** The ROHC compression profiles, only the ones built in the library */
 static const struct rohc_comp_profile *const
 	rohc_comp_profiles[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1] =
 {
 	[0] = {
+#if ROHC_BUILD_PROFILE_UNCOMP
 		[0] = &c_uncompressed_profile,
+#endif
+#if ROHC_BUILD_PROFILE_RTP
 		[1] = &c_rtp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_UDP
 		[2] = &c_udp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_ESP
 		[3] = &c_esp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_IP
 		[4] = &c_ip_profile,
+#endif
 		[5] = NULL,
+#if ROHC_BUILD_PROFILE_TCP
 		[6] = &c_tcp_profile,
+#endif
 		[7] = NULL,
+#if ROHC_BUILD_PROFILE_UDPLITE
 		[8] = &c_udp_lite_profile,
+#endif
 	},
 	[1] = {
 		[0] = NULL,
+#if ROHC_BUILD_PROFILE_V2RTP
 		[1] = &rohc_comp_rfc5225_ip_udp_rtp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_V2UDP
 		[2] = &rohc_comp_rfc5225_ip_udp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_V2ESP
 		[3] = &rohc_comp_rfc5225_ip_esp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_V2IP
 		[4] = &rohc_comp_rfc5225_ip_profile,
+#endif
 		[5] = NULL,
 		[6] = NULL,
 		[7] = NULL,
@@ -126,6 +166,22 @@ static const struct rohc_comp_profile *const
 
 
 
+/**
+ * @brief The profile of the given compression context
+ *
+ * If only one profile is built in the library, the profile of every context
+ * is known at build time: its handlers are then called directly instead of
+ * through the function pointers of the context, so that LTO may inline them.
+ */
+#ifdef ROHC_COMP_SINGLE_PROFILE
+#  define rohc_comp_ctxt_profile(ctxt) \
+	((void) (ctxt), &(ROHC_COMP_SINGLE_PROFILE))
+#else
+#  define rohc_comp_ctxt_profile(ctxt) \
+	((ctxt)->profile)
+#endif
+
+
 /*
  * Prototypes of private functions related to ROHC compression profiles
  */
@@ -133,7 +189,8 @@ static const struct rohc_comp_profile *const
 static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
                                             const struct rohc_buf *const packet,
                                             struct rohc_fingerprint *const fingerprint,
-                                            struct rohc_pkt_hdrs *const pkt_hdrs)
+                                            struct rohc_pkt_hdrs *const pkt_hdrs,
+                                            struct rohc_comp_rtp_verdict *const rtp_verdicts)
 	__attribute__((nonnull(1, 2, 3, 4), warn_unused_result));
 
 static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
@@ -145,6 +202,12 @@ static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
                                             size_t *const all_ipv6_exts_len)
 	__attribute__((nonnull(1, 2, 4, 5, 6, 7), warn_unused_result));
 
+static bool rohc_comp_check_hdrs_info(const struct rohc_comp *const comp,
+                                      const struct rohc_comp_hdrs_info *const hdrs_info,
+                                      const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                      const size_t all_ip_hdrs_len)
+	__attribute__((nonnull(1, 2, 3), warn_unused_result));
+
 static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const comp,
                                                const struct rohc_buf *const packet,
                                                const rohc_profile_t l3_profile,
@@ -153,7 +216,8 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
                                                const uint8_t *const l4_data,
                                                const size_t l4_len,
                                                struct rohc_fingerprint *const fingerprint,
-                                               struct rohc_pkt_hdrs *const pkt_hdrs)
+                                               struct rohc_pkt_hdrs *const pkt_hdrs,
+                                               struct rohc_comp_rtp_verdict *const rtp_verdicts)
 	__attribute__((nonnull(1, 2, 6, 8, 9), warn_unused_result));
 
 static bool rohc_comp_is_tcp_hdr_supported(const struct rohc_comp *const comp,
@@ -166,13 +230,114 @@ static bool rohc_comp_is_tcp_hdr_supported(const struct rohc_comp *const comp,
 static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
                                            const uint8_t *const packet,
                                            const size_t packet_len,
-                                           struct rohc_pkt_hdrs *const pkt_hdrs)
+                                           struct rohc_pkt_hdrs *const pkt_hdrs,
+                                           struct rohc_comp_rtp_verdict *const rtp_verdicts)
 	__attribute__((nonnull(1, 2, 4), warn_unused_result));
 
+static rohc_profile_t rohc_comp_get_class_profile(const struct rohc_comp *const comp,
+                                                  const rohc_comp_pkt_class_t pkt_class,
+                                                  const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                                  const size_t all_ipv6_exts_len)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+static void rohc_comp_set_profile_hdrs(const struct rohc_buf *const packet,
+                                       const uint8_t *const payload,
+                                       const size_t payload_len,
+                                       struct rohc_pkt_hdrs *const pkt_hdrs)
+	__attribute__((nonnull(1, 2, 4)));
+
+static void rohc_comp_set_profile_ports(const struct rohc_comp *const comp,
+                                        const uint16_t src_port,
+                                        const uint16_t dst_port,
+                                        struct rohc_fingerprint *const fingerprint)
+	__attribute__((nonnull(1, 4)));
+
+static void rohc_comp_get_rtp_verdict_key(const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                          struct rohc_comp_rtp_verdict *const key)
+	__attribute__((nonnull(1, 2)));
+
+static size_t rohc_comp_get_rtp_verdict_idx(const struct rohc_comp_rtp_verdict *const key)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static rohc_profile_t rohc_comp_classify(struct rohc_comp *const comp,
+                                         const struct rohc_buf *const packet,
+                                         struct rohc_fingerprint *const fingerprint,
+                                         struct rohc_pkt_hdrs *const pkt_hdrs)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static bool rohc_comp_get_uncomp_flow_key(const struct rohc_buf *const packet,
+                                          struct rohc_comp_uncomp_flow *const key)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static size_t rohc_comp_get_uncomp_flow_idx(const struct rohc_comp_uncomp_flow *const key)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static void rohc_comp_bulk_eval(struct rohc_comp *const comp,
+                                struct rohc_comp_ctxt *const c,
+                                const struct rohc_buf *const packet)
+	__attribute__((nonnull(1, 2, 3)));
+
 static bool rohc_comp_profile_enabled_nocheck(const struct rohc_comp *const comp,
                                               const rohc_profile_t profile)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+static void rohc_comp_update_profiles_by_class(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
+
+/*
+ * Prototypes of private functions related to ROHC compression
+ */
+
+static rohc_status_t rohc_comp_compress_pkt(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_packet,
+                                            struct rohc_buf *const payload,
+                                            const bool in_place,
+                                            struct rohc_comp_pkt_info *const info)
+	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_status_t rohc_comp_remap_cid(const struct rohc_comp *const comp,
+                                         struct rohc_buf *const rohc_packet,
+                                         const struct rohc_comp_pkt_info *const info,
+                                         const rohc_cid_t cid)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static rohc_status_t rohc_comp_encode_pkt(struct rohc_comp *const comp,
+                                          struct rohc_comp_ctxt *const c,
+                                          struct rohc_pkt_hdrs *const pkt_hdrs,
+                                          const struct rohc_ts arrival_time,
+                                          const size_t uncomp_len,
+                                          struct rohc_buf *const rohc_packet,
+                                          struct rohc_buf *const payload,
+                                          const bool in_place,
+                                          struct rohc_comp_pkt_info *const info,
+                                          struct rohc_perf_clock *const perf_clock)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6, 10)));
+static bool rohc_comp_gso_rebase_hdrs(struct rohc_comp *const comp,
+                                      const struct rohc_buf super_pkt,
+                                      struct rohc_pkt_hdrs *const pkt_hdrs)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static void rohc_comp_gso_build_seg(struct rohc_comp *const comp,
+                                    const struct rohc_buf super_pkt,
+                                    const uint8_t *const super_payload,
+                                    const size_t super_payload_len,
+                                    const size_t seg_idx,
+                                    const size_t seg_off,
+                                    const size_t seg_len,
+                                    const bool is_last_seg,
+                                    struct rohc_pkt_hdrs *const pkt_hdrs)
+	__attribute__((nonnull(1, 3, 9)));
+static uint16_t rohc_comp_gso_l4_csum(const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                      const uint8_t l4_proto,
+                                      const uint8_t *const l4_hdr,
+                                      const size_t l4_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static size_t rohc_comp_ip_frag_len(const struct rohc_comp *const comp,
+                                    const rohc_profile_t profile_id)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_comp_frag_rebase_hdrs(struct rohc_comp *const comp,
+                                       struct rohc_pkt_hdrs *const pkt_hdrs)
+	__attribute__((nonnull(1, 2)));
+
 
 /*
  * Prototypes of private functions related to ROHC compression contexts
@@ -180,6 +345,10 @@ static bool rohc_comp_profile_enabled_nocheck(const struct rohc_comp *const comp
 
 static bool c_create_contexts(struct rohc_comp *const comp)
 	__attribute__((warn_unused_result, nonnull(1)));
+static bool rohc_comp_set_cid_range(struct rohc_comp *const comp,
+                                    const rohc_cid_t min_cid,
+                                    const rohc_cid_t max_cid)
+	__attribute__((warn_unused_result, nonnull(1)));
 static void c_destroy_contexts(struct rohc_comp *const comp)
 	__attribute__((nonnull(1)));
 
@@ -190,16 +359,191 @@ static struct rohc_comp_ctxt *
 	                 const struct rohc_pkt_hdrs *const pkt_hdrs,
 	                 const struct rohc_ts pkt_time)
 	__attribute__((nonnull(1, 2, 3, 4), warn_unused_result));
+static bool c_init_context(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const c,
+                           const struct rohc_comp_profile *const profile,
+                           const struct rohc_fingerprint *const fingerprint,
+                           const struct rohc_pkt_hdrs *const pkt_hdrs,
+                           const struct rohc_ts pkt_time)
+	__attribute__((nonnull(1, 2, 3, 4, 5), warn_unused_result));
+static void c_reset_context(struct rohc_comp *const comp,
+                            struct rohc_comp_ctxt *const c,
+                            const rohc_cid_t cid,
+                            const struct rohc_comp_profile *const profile,
+                            const struct rohc_fingerprint *const fingerprint,
+                            const struct rohc_ts pkt_time)
+	__attribute__((nonnull(1, 2, 4, 5)));
+static size_t c_rru_get_iov(const struct rohc_comp *const comp,
+                            const size_t len,
+                            struct rohc_comp_seg_iov *const iov)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static rohc_status_t c_dryrun_copy_context(struct rohc_comp *const comp,
+                                           struct rohc_comp_ctxt *const scratch,
+                                           const struct rohc_comp_ctxt *const ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static rohc_status_t c_dryrun_new_context(struct rohc_comp *const comp,
+                                          struct rohc_comp_ctxt *const scratch,
+                                          const struct rohc_comp_profile *const profile,
+                                          const struct rohc_fingerprint *const fingerprint,
+                                          const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                          const struct rohc_ts pkt_time)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static struct rohc_comp_ctxt *
 	rohc_comp_find_ctxt(struct rohc_comp *const comp,
 	                    const struct rohc_comp_profile *const profile,
 	                    const struct rohc_buf *const packet,
 	                    const struct rohc_fingerprint *const pkt_fingerprint,
-	                    const struct rohc_pkt_hdrs *const pkt_hdrs)
+	                    const struct rohc_pkt_hdrs *const pkt_hdrs,
+	                    const bool may_shed)
 	__attribute__((nonnull(1, 2, 3, 4, 5), warn_unused_result));
 static struct rohc_comp_ctxt *
 	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static inline struct rohc_comp_ctxt *
+	c_ctxt_at(const struct rohc_comp *const comp, const rohc_cid_t cid)
+	__attribute__((nonnull(1), warn_unused_result));
+
+static inline size_t
+	c_flows_cache_idx(const struct rohc_fingerprint *const fingerprint)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+static inline size_t c_esp_spi_idx(const uint32_t esp_spi)
+	__attribute__((warn_unused_result, const));
+static inline size_t c_rss_idx(const uint32_t rss_hash)
+	__attribute__((warn_unused_result, const));
+static void c_flows_cache_add(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static inline size_t c_addr_key_len(const uint8_t ip_version)
+	__attribute__((warn_unused_result, const));
+static inline size_t c_addr_idx(const uint8_t ip_version,
+                                const uint8_t *const addr)
+	__attribute__((nonnull(2), warn_unused_result, pure));
+static inline size_t c_addr_link_at(const struct rohc_comp_ctxt *const ctxt,
+                                    const size_t idx)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+static void c_addr_index_add(struct rohc_comp *const comp,
+                             struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void c_addr_index_del(struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1)));
+static bool c_addr_prefix_match(const struct rohc_fingerprint_ip *const ip,
+                                const uint8_t *const addr,
+                                const struct rohc_comp_ctxt_filter *const filter)
+	__attribute__((nonnull(1, 2, 3), warn_unused_result, pure));
+static size_t c_ctxt_filter_match(const struct rohc_comp_ctxt *const ctxt,
+                                  const struct rohc_comp_ctxt_filter *const filter)
+	__attribute__((nonnull(1, 2), warn_unused_result, pure));
+static inline const void *
+	c_cr_dst_port_key(const struct rohc_fingerprint *const fingerprint)
+	__attribute__((nonnull(1), warn_unused_result, const));
+static inline size_t
+	c_cr_dst_port_key_len(const struct rohc_fingerprint *const fingerprint)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+static void c_lru_add_first(struct rohc_comp *const comp,
+                            struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void c_lru_del(struct rohc_comp *const comp,
+                      struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void c_release_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void c_cr_update_base(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+static size_t c_refresh_jitter(const struct rohc_comp_ctxt *const context,
+                               const size_t timeout)
+	__attribute__((warn_unused_result, nonnull(1)));
+static uint64_t c_refresh_timeout_us(const struct rohc_comp_ctxt *const context,
+                                     const uint64_t timeout_ms)
+	__attribute__((warn_unused_result, nonnull(1)));
+static uint64_t c_refresh_scale(const struct rohc_comp_ctxt *const context,
+                                const uint64_t timeout)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_refresh_scale_update(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+static bool c_ir_refresh_budget_avail(struct rohc_comp *const comp,
+                                      const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_ir_refresh_budget_update(struct rohc_comp *const comp,
+                                       const struct rohc_ts now)
+	__attribute__((nonnull(1)));
+static size_t c_pkts_until(const size_t count, const size_t timeout)
+	__attribute__((warn_unused_result, const));
+static rohc_comp_overload_t c_overload_level(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static bool c_overload_may_create(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool c_warmup_may_create(struct rohc_comp *const comp,
+                                const struct rohc_fingerprint *const fingerprint,
+                                const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_overload_measure(struct rohc_comp *const comp,
+                               const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+static void c_refresh_deadlines_reset(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+static uint8_t c_oa_repetitions(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_oa_on_send(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static uint64_t rohc_comp_hash_custom(const void *const data,
+                                      const size_t len,
+                                      const char key[16],
+                                      void *const priv)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+static rohc_reordering_offset_t c_reorder_ratio(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_reorder_ratio_change(struct rohc_comp_ctxt *const context,
+                                   const rohc_reordering_offset_t reorder_ratio)
+	__attribute__((nonnull(1)));
+static void c_reorder_on_send(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+static bool c_save_context(const struct rohc_comp_ctxt *const ctxt,
+                           uint8_t *const image,
+                           const size_t image_max_len,
+                           size_t *const rec_len)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static bool c_restore_context(struct rohc_comp *const comp,
+                              const struct rohc_ctxt_image_rec *const rec,
+                              const uint8_t *const data,
+                              const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool c_evict_for_budget(struct rohc_comp *const comp,
+                               const rohc_profile_t profile_id,
+                               const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_comp_ctxt *
+	c_evict_select(const struct rohc_comp *const comp,
+	               const rohc_profile_t profile_id,
+	               const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1)));
+static unsigned int c_evict_profile_rank(const rohc_profile_t profile_id)
+	__attribute__((warn_unused_result, const));
+static void c_ctxt_record(const struct rohc_comp_ctxt *const ctxt,
+                          struct rohc_comp_ctxt_record *const record)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_event(const struct rohc_comp_ctxt *const ctxt,
+                         const rohc_comp_ctxt_event_type_t type,
+                         const rohc_comp_state_t old_state,
+                         const rohc_mode_t old_mode)
+	__attribute__((nonnull(1)));
+static bool c_is_context_idle(const struct rohc_comp *const comp,
+                              const struct rohc_comp_ctxt *const ctxt,
+                              const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_free_ctxts_push(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static struct rohc_comp_ctxt * c_free_ctxts_pop(struct rohc_comp *const comp)
+	__attribute__((nonnull(1), warn_unused_result));
+static struct rohc_comp_ctxt * c_free_ctxts_take(struct rohc_comp *const comp,
+                                                 const rohc_cid_t cid)
+	__attribute__((nonnull(1), warn_unused_result));
+static struct rohc_comp_ctxt * c_ctxts_alloc_next(struct rohc_comp *const comp)
+	__attribute__((nonnull(1), warn_unused_result));
 
 static rohc_ctxt_affinity_t
 	rohc_comp_get_ctxt_affinity(const struct rohc_comp_ctxt *const ctxt,
@@ -212,28 +556,47 @@ static rohc_ctxt_affinity_t
  * Prototypes of private functions related to ROHC feedback
  */
 
+static rohc_status_t rohc_comp_compress_pkt_fb(struct rohc_comp *const comp,
+                                               const struct rohc_buf uncomp_packet,
+                                               struct rohc_buf *const rohc_packet,
+                                               struct rohc_buf *const feedbacks,
+                                               struct rohc_comp_pkt_info *const info)
+	__attribute__((warn_unused_result, nonnull(1)));
+static size_t rohc_comp_collect_feedbacks(struct rohc_comp *const comp,
+                                          uint8_t *const dst,
+                                          const size_t max_len,
+                                          size_t *const slots_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static void rohc_comp_piggyback_feedbacks(struct rohc_comp *const comp,
+                                          struct rohc_buf *const rohc_packet)
+	__attribute__((nonnull(1, 2)));
 static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
                                          const uint8_t *const packet,
                                          const size_t size)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
-
-static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
-                                         const uint8_t *const feedback,
-                                         const size_t feedback_len,
-                                         rohc_cid_t *const cid,
-                                         size_t *const cid_len)
+static struct rohc_comp_ctxt * rohc_comp_feedback_get_ctxt(struct rohc_comp *const comp,
+                                                           const uint8_t *const packet,
+                                                           const size_t size,
+                                                           size_t *const cid_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static bool rohc_comp_feedback_apply(struct rohc_comp *const comp,
+                                     struct rohc_comp_ctxt *const context,
+                                     const uint8_t *const packet,
+                                     const size_t size,
+                                     const size_t cid_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static void rohc_comp_feedback_crc_feed(struct rohc_comp_feedback_crc *const crc,
+                                        const uint8_t *const data,
+                                        const size_t data_len,
+                                        const bool is_crc_field)
+	__attribute__((nonnull(1, 2)));
 
 static bool rohc_comp_feedback_parse_opt_sn(const struct rohc_comp_ctxt *const context,
-                                            const uint8_t *const feedback_data,
-                                            const size_t feedback_data_len,
-                                            uint32_t *const sn_bits,
-                                            size_t *const sn_bits_nr)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
-
-static bool rohc_comp_feedback_check_opts(const struct rohc_comp_ctxt *const context,
-                                          const size_t opts_present[ROHC_FEEDBACK_OPT_MAX])
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+                                            const uint8_t *const opt_data,
+                                            const size_t opt_len,
+                                            struct rohc_comp_feedback_2 *const feedback2)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
 
 /*
@@ -307,6 +670,7 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 	const size_t reorder_ratio = ROHC_REORDERING_NONE; /* default reordering ratio */
 	struct rohc_comp *comp;
 	uint8_t profile_major;
+	size_t phase;
 	bool is_fine;
 
 	/* check input parameters */
@@ -345,10 +709,28 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 
 	comp->medium.cid_type = cid_type;
 	comp->medium.max_cid = max_cid;
+	comp->ctxts_min_cid = 0;
+	comp->ctxts_max_cid = max_cid;
 	comp->mrru = 0; /* no segmentation by default */
 	comp->rru = NULL; /* no segmentation by default */
+	comp->rru_iov_nr = 0; /* RRU copied in rru by default */
+	comp->rru_by_ref = false;
+	comp->chain_tail_len = 0; /* contiguous packets by default */
+	comp->hdrs_info = NULL; /* packets are classified by default */
+	comp->oa_repetitions_min = 0; /* no adaptive Optimistic Approach */
+	comp->oa_loss_permille = 0;
+	comp->refresh_adapt_min_pct = 100; /* no adaptive periodic refreshes */
+	comp->refresh_adapt_max_pct = 100;
+	comp->refresh_scale_pct = 100;
+	comp->reorder_ratio_auto = false; /* no adaptive reorder ratio */
+	comp->reorder_depth = 0;
+	comp->ip_id_hysteresis_nr = 1; /* reclassify the IP-ID behaviors at once */
 	comp->random_cb = rand_cb;
 	comp->random_cb_ctxt = rand_priv;
+	comp->rtp_detection_interval = 1; /* ask the RTP callback for every packet */
+	comp->ts_timer_jitter = ROHC_COMP_TS_TIMER_JITTER_DEFAULT;
+	comp->trace_level = ROHC_TRACE_DEBUG; /* all traces by default */
+	rohc_mempool_init(&comp->mempool);
 
 	/* all compression profiles are disabled by default */
 	for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
@@ -360,12 +742,21 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 			comp->enabled_profiles[profile_major][profile_minor] = false;
 		}
 	}
+	rohc_comp_update_profiles_by_class(comp);
 
 	/* reset statistics */
+	comp->stats_seq = 0;
 	comp->num_packets = 0;
 	comp->total_compressed_size = 0;
 	comp->total_uncompressed_size = 0;
 	comp->last_context = NULL;
+	for(phase = 0; phase < ROHC_COMP_PERF_PHASES_NR; phase++)
+	{
+		rohc_perf_histo_reset(&comp->perf_histos[phase]);
+	}
+
+	/* no feedback ring by default */
+	comp->feedback_ring = NULL;
 
 	/* set the default number of repetitions for Optimistic Approach */
 	is_fine = rohc_comp_set_optimistic_approach(comp, oa_repetitions_nr);
@@ -403,9 +794,6 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 	{
-		const unsigned int max_ctxts = max_cid + 1;
-		const size_t items_nr = 1 << (32 - __builtin_clz(max_ctxts - 1));
-		const size_t hashtable_size = items_nr << 5;
 		size_t i;
 
 		/* create hash table for finding contexts by their fingerprint */
@@ -415,7 +803,7 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 				comp->random_cb(comp, comp->random_cb_ctxt) & 0xff;
 		}
 		if(!hashtable_new(&comp->contexts_by_fingerprint,
-		                  sizeof(struct rohc_fingerprint), hashtable_size))
+		                  offsetof(struct rohc_comp_ctxt, fingerprint)))
 		{
 			goto destroy_contexts;
 		}
@@ -427,16 +815,31 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 			comp->contexts_cr.key[i] =
 				comp->random_cb(comp, comp->random_cb_ctxt) & 0xff;
 		}
-		if(!hashtable_cr_new(&comp->contexts_cr,
-		                     sizeof(struct rohc_fingerprint_base),
-		                     sizeof(struct rohc_fingerprint), hashtable_size))
+		if(!hashtable_new(&comp->contexts_cr,
+		                  offsetof(struct rohc_comp_ctxt, fingerprint.base)))
 		{
 			goto free_hashtable;
 		}
+
+		/* create hash table for finding Context Replication (CR) contexts
+		 * by their base fingerprint and destination port */
+		for(i = 0; i < sizeof(comp->contexts_cr_by_dst_port.key); i++)
+		{
+			comp->contexts_cr_by_dst_port.key[i] =
+				comp->random_cb(comp, comp->random_cb_ctxt) & 0xff;
+		}
+		if(!hashtable_new(&comp->contexts_cr_by_dst_port,
+		                  offsetof(struct rohc_comp_ctxt, fingerprint) +
+		                  offsetof(struct rohc_fingerprint, dst_port)))
+		{
+			goto free_hashtable_cr;
+		}
 	}
 
 	return comp;
 
+free_hashtable_cr:
+	hashtable_free(&comp->contexts_cr);
 free_hashtable:
 	hashtable_free(&comp->contexts_by_fingerprint);
 destroy_contexts:
@@ -448,6 +851,75 @@ error:
 }
 
 
+/**
+ * @brief Create a new ROHC compressor that uses only some of the CIDs
+ *
+ * Create a new ROHC compressor like \ref rohc_comp_new2 does, but restrict
+ * the CIDs that the compressor gives to new contexts to the range
+ * [\e cid_min, \e cid_max]. The other CIDs of the ROHC channel, in range
+ * [0, \e max_cid], are left to other compressors.
+ *
+ * Several compressors with disjoint ranges of CIDs may thus compress for the
+ * same ROHC channel, eg. one compressor per thread, without any locking. The
+ * application is responsible for always compressing the packets of one flow
+ * with the same compressor, and for delivering feedback to the compressor
+ * that owns the CID of the feedback, see \ref rohc_comp_get_cid_range.
+ *
+ * @param cid_type  The type of Context IDs (CID) that the ROHC compressor
+ *                  shall operate with, see \ref rohc_comp_new2
+ * @param max_cid   The maximum value of context IDs (CID) on the ROHC
+ *                  channel, see \ref rohc_comp_new2
+ * @param cid_min   The smallest CID the compressor may use
+ * @param cid_max   The largest CID the compressor may use, in range
+ *                  [\e cid_min, \e max_cid]
+ * @param rand_cb   The random callback to set
+ * @param rand_priv Private data that will be given to the callback, may be
+ *                  used as a context by user
+ * @return          The created compressor if successful,
+ *                  NULL if creation failed
+ *
+ * @warning Don't forget to free compressor memory with \ref rohc_comp_free
+ *          if \e rohc_comp_new_cid_range succeeded
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_new2
+ * @see rohc_comp_get_cid_range
+ */
+struct rohc_comp * rohc_comp_new_cid_range(const rohc_cid_type_t cid_type,
+                                           const rohc_cid_t max_cid,
+                                           const rohc_cid_t cid_min,
+                                           const rohc_cid_t cid_max,
+                                           const rohc_comp_random_cb_t rand_cb,
+                                           void *const rand_priv)
+{
+	struct rohc_comp *comp;
+
+	if(cid_min > cid_max || cid_max > max_cid)
+	{
+		goto error;
+	}
+
+	comp = rohc_comp_new2(cid_type, max_cid, rand_cb, rand_priv);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(!rohc_comp_set_cid_range(comp, cid_min, cid_max))
+	{
+		goto free_comp;
+	}
+
+	return comp;
+
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
 /**
  * @brief Destroy the given ROHC compressor
  *
@@ -479,16 +951,25 @@ void rohc_comp_free(struct rohc_comp *const comp)
 		           "free ROHC compressor");
 
 		/* free memory used by contexts */
-		hashtable_cr_free(&comp->contexts_cr);
+		hashtable_free(&comp->contexts_cr_by_dst_port);
+		hashtable_free(&comp->contexts_cr);
 		hashtable_free(&comp->contexts_by_fingerprint);
 		c_destroy_contexts(comp);
 
 		/* free RRU buffer */
-		if(comp->rru != NULL)
+		rohc_mempool_release(&comp->mempool, comp->rru, comp->mrru);
+		comp->rru = NULL;
+
+		rohc_mempool_free(&comp->mempool);
+		if(comp->channel_set != NULL)
 		{
-			zfree(comp->rru);
+			rohc_channel_set_leave(comp->channel_set);
 		}
 
+		/* free the bitmap of RTP ports and the TS_STRIDE of RTP payload types */
+		free(comp->rtp_ports);
+		free(comp->rtp_ts_strides);
+
 		/* free the compressor */
 		free(comp);
 	}
@@ -568,6 +1049,59 @@ error:
 }
 
 
+/**
+ * @brief Set the lowest level of the traces of the compressor
+ *
+ * The traces of lower levels are dropped before the trace callback is even
+ * called, so that they do not cost anything. By default, the traces of all
+ * levels are given to the callback set by \ref rohc_comp_set_traces_cb2.
+ *
+ * Like the trace callback, the level cannot be modified after library
+ * initialization: the parts of the contexts that print traces on their own
+ * keep the level they were created with.
+ *
+ * @param comp    The ROHC compressor
+ * @param level  The lowest level of the traces to give to the callback
+ * @return       true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_traces_cb2
+ */
+bool rohc_comp_set_trace_level(struct rohc_comp *const comp,
+                               const rohc_trace_level_t level)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* refuse to set a new trace level if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace level after initialization");
+		goto error;
+	}
+
+	if(level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unexpected trace "
+		           "level %d", level);
+		goto error;
+	}
+
+	comp->trace_level = level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get the best compression profile for the given network packet
  *
@@ -585,7 +1119,8 @@ error:
 static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
                                             const struct rohc_buf *const packet,
                                             struct rohc_fingerprint *const fingerprint,
-                                            struct rohc_pkt_hdrs *const pkt_hdrs)
+                                            struct rohc_pkt_hdrs *const pkt_hdrs,
+                                            struct rohc_comp_rtp_verdict *const rtp_verdicts)
 {
 	const uint8_t *remain_data = rohc_buf_data(*packet);
 	size_t remain_len = packet->len;
@@ -593,12 +1128,14 @@ static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
 	size_t all_ipv6_exts_len = 0;
 	uint8_t next_proto;
 	rohc_profile_t profile = ROHC_PROFILE_MAX;
+	rohc_profile_t l3_profile;
 
 	/* reset the fingerprint */
 	memset(fingerprint, 0, sizeof(struct rohc_fingerprint));
 
 	/* remember the beginning of all headers */
 	pkt_hdrs->all_hdrs = remain_data;
+	pkt_hdrs->ipv4_frag = 0;
 
 	/* ROHCv1 Uncompressed profile is possible if it is enabled */
 	if(rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_UNCOMPRESSED))
@@ -606,9 +1143,13 @@ static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "ROHCv1 Uncompressed profile is possible");
 		profile = ROHCv1_PROFILE_UNCOMPRESSED;
-		pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-		pkt_hdrs->payload_len = remain_len;
-		pkt_hdrs->payload = remain_data;
+		rohc_comp_set_profile_hdrs(packet, remain_data, remain_len, pkt_hdrs);
+
+		/* no other profile may compress the packet, so do not parse it */
+		if(comp->is_uncomp_passthrough)
+		{
+			goto passthrough;
+		}
 	}
 
 	/* check that the IP headers are supported by the ROHC profiles */
@@ -620,6 +1161,17 @@ static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
 		           "unsupported IP headers");
 		goto unsupported_ip_hdr;
 	}
+
+	/* the headers described by the user shall be the ones just checked */
+	if(comp->hdrs_info != NULL &&
+	   !rohc_comp_check_hdrs_info(comp, comp->hdrs_info, pkt_hdrs, all_ip_hdrs_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "the headers described by the user do not match the "
+		             "headers of the packet");
+		profile = ROHC_PROFILE_MAX;
+		goto bad_hdrs_info;
+	}
 	next_proto = pkt_hdrs->innermost_ip_hdr->next_proto;
 	remain_data += all_ip_hdrs_len;
 	remain_len -= all_ip_hdrs_len;
@@ -627,24 +1179,28 @@ static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
 	/* ROHCv1/v2 IP-only profiles are possible if they are enabled */
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "IP packet detected");
-	if(rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_IP))
+	l3_profile = rohc_comp_get_class_profile(comp, ROHC_COMP_PKT_CLASS_IP,
+	                                         pkt_hdrs, all_ipv6_exts_len);
+	if(pkt_hdrs->ipv4_frag != 0 && all_ip_hdrs_len > ROHC_COMP_FRAG_HDRS_MAX_LEN)
 	{
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "ROHCv1 IP-Only profile is possible");
-		profile = ROHCv1_PROFILE_IP;
-		pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-		pkt_hdrs->payload_len = remain_len;
-		pkt_hdrs->payload = remain_data;
+		           "%zu-byte IP headers of IPv4 fragment too long, %u bytes max",
+		           all_ip_hdrs_len, ROHC_COMP_FRAG_HDRS_MAX_LEN);
+		l3_profile = ROHC_PROFILE_MAX;
+	}
+	if(l3_profile != ROHC_PROFILE_MAX)
+	{
+		profile = l3_profile;
+		rohc_comp_set_profile_hdrs(packet, remain_data, remain_len, pkt_hdrs);
 	}
-	else if(all_ipv6_exts_len == 0 && /* TODO: ROHCv2: add IPv6 ext hdrs support */
-	        rohc_comp_profile_enabled_nocheck(comp, ROHCv2_PROFILE_IP))
+
+	/* the payload of the IPv4 fragments is not parsed, only the IP-only
+	 * profiles may compress them */
+	if(pkt_hdrs->ipv4_frag != 0)
 	{
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "ROHCv2 IP-Only profile is possible");
-		profile = ROHCv2_PROFILE_IP;
-		pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-		pkt_hdrs->payload_len = remain_len;
-		pkt_hdrs->payload = remain_data;
+		           "IPv4 fragment, do not parse its payload");
+		goto ip_fragment;
 	}
 
 	/* profiles cannot handle the packet if it bypasses internal limit
@@ -662,17 +1218,98 @@ static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
 	profile = rohc_comp_get_profile_l4(comp, packet,
 	                                   profile, all_ipv6_exts_len, next_proto,
 	                                   remain_data, remain_len,
-	                                   fingerprint, pkt_hdrs);
+	                                   fingerprint, pkt_hdrs, rtp_verdicts);
 
+ip_fragment:
 too_many_ip_hdrs:
 unsupported_ip_hdr:
+passthrough:
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "profile '%s' (0x%04x) will be used to compress the packet",
 	           rohc_get_profile_descr(profile), profile);
+bad_hdrs_info:
 	return profile;
 }
 
 
+/**
+ * @brief Do the headers described by the user match the parsed IP headers?
+ *
+ * The IP headers are located and checked by the compressor anyway, since
+ * the profiles rely on them. Their offsets and versions are thus compared
+ * with the ones given by the user, and so are the offset and the protocol
+ * of the transport header. If the compressor parsed less IP headers than
+ * described because of its internal limit, the next IP header stands for
+ * the transport header.
+ *
+ * @param comp             The ROHC compressor
+ * @param hdrs_info        The headers of the packet as described by the user
+ * @param pkt_hdrs         The information collected about the IP headers
+ * @param all_ip_hdrs_len  The length (in bytes) of the parsed IP headers
+ * @return                 true if the headers match, false otherwise
+ */
+static bool rohc_comp_check_hdrs_info(const struct rohc_comp *const comp,
+                                      const struct rohc_comp_hdrs_info *const hdrs_info,
+                                      const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                      const size_t all_ip_hdrs_len)
+{
+	const uint8_t next_proto = pkt_hdrs->innermost_ip_hdr->next_proto;
+	size_t l4_offset;
+	size_t i;
+
+	for(i = 0; i < pkt_hdrs->ip_hdrs_nr; i++)
+	{
+		const size_t ip_offset = pkt_hdrs->ip_hdrs[i].data - pkt_hdrs->all_hdrs;
+
+		if(i >= hdrs_info->ip_hdrs_nr ||
+		   hdrs_info->ip_versions[i] != pkt_hdrs->ip_hdrs[i].version ||
+		   hdrs_info->ip_offsets[i] != ip_offset)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "IPv%u header #%zu at offset %zu is not described by "
+			           "the user", pkt_hdrs->ip_hdrs[i].version, i + 1,
+			           ip_offset);
+			goto mismatch;
+		}
+	}
+
+	if(pkt_hdrs->ip_hdrs_nr < hdrs_info->ip_hdrs_nr)
+	{
+		if(!rohc_is_tunneling(next_proto))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "%u IP headers described by the user, but only %u found",
+			           hdrs_info->ip_hdrs_nr, pkt_hdrs->ip_hdrs_nr);
+			goto mismatch;
+		}
+		l4_offset = hdrs_info->ip_offsets[pkt_hdrs->ip_hdrs_nr];
+	}
+	else if(next_proto != hdrs_info->l4_proto)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "transport protocol %u described by the user, but %u found",
+		           hdrs_info->l4_proto, next_proto);
+		goto mismatch;
+	}
+	else
+	{
+		l4_offset = hdrs_info->l4_offset;
+	}
+	if(l4_offset != all_ip_hdrs_len)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "transport header described by the user at offset %zu, but "
+		           "found at offset %zu", l4_offset, all_ip_hdrs_len);
+		goto mismatch;
+	}
+
+	return true;
+
+mismatch:
+	return false;
+}
+
+
 /**
  * @brief Get the best compression profile for the given network packet
  *
@@ -700,9 +1337,11 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
                                                const uint8_t *const l4_data,
                                                const size_t l4_len,
                                                struct rohc_fingerprint *const fingerprint,
-                                               struct rohc_pkt_hdrs *const pkt_hdrs)
+                                               struct rohc_pkt_hdrs *const pkt_hdrs,
+                                               struct rohc_comp_rtp_verdict *const rtp_verdicts)
 {
 	rohc_profile_t profile = l3_profile;
+	rohc_profile_t l4_profile;
 	const uint8_t *remain_data = l4_data;
 	size_t remain_len = l4_len;
 
@@ -727,22 +1366,16 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
 		/* ROHCv1 IP/TCP profiles is possible if it is enabled */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "IP/TCP packet detected");
-		if(rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_IP_TCP))
+		l4_profile = rohc_comp_get_class_profile(comp, ROHC_COMP_PKT_CLASS_IP_TCP,
+		                                         pkt_hdrs, all_ipv6_exts_len);
+		if(l4_profile != ROHC_PROFILE_MAX)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv1 IP/TCP profile is possible");
-			profile = ROHCv1_PROFILE_IP_TCP;
+			profile = l4_profile;
 			pkt_hdrs->tcp = tcp_header;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
+			rohc_comp_set_profile_hdrs(packet, remain_data, remain_len, pkt_hdrs);
 			fingerprint->base.profile_id = profile;
-			fingerprint->src_port = rohc_ntoh16(tcp_header->src_port);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tsource port = %u", fingerprint->src_port);
-			fingerprint->dst_port = rohc_ntoh16(tcp_header->dst_port);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tdestination port = %u", fingerprint->dst_port);
+			rohc_comp_set_profile_ports(comp, tcp_header->src_port,
+			                            tcp_header->dst_port, fingerprint);
 		}
 	}
 	else if(l4_proto == ROHC_IPPROTO_UDP)
@@ -761,7 +1394,7 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
 
 		/* retrieve the UDP header and the UDP payload */
 		udp_header = (const struct udphdr *) remain_data;
-		udp_len = remain_len;
+		udp_len = remain_len + comp->chain_tail_len;
 		remain_data += sizeof(struct udphdr);
 		remain_len -= sizeof(struct udphdr);
 
@@ -778,43 +1411,20 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
 		/* ROHCv1/v2 IP/UDP profiles are possible if they are enabled */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "IP/UDP packet detected");
-		if(pkt_hdrs->ip_hdrs_nr <= ROHC_MAX_IP_HDRS_RFC3095 &&
-		   rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_IP_UDP))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv1 IP/UDP profile is possible");
-			profile = ROHCv1_PROFILE_IP_UDP;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
-			fingerprint->base.profile_id = profile;
-			fingerprint->src_port = rohc_ntoh16(udp_header->source);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tsource port = %u", fingerprint->src_port);
-			fingerprint->dst_port = rohc_ntoh16(udp_header->dest);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tdestination port = %u", fingerprint->dst_port);
-		}
-		else if(all_ipv6_exts_len == 0 && /* TODO: ROHCv2: add IPv6 ext hdrs support */
-		        rohc_comp_profile_enabled_nocheck(comp, ROHCv2_PROFILE_IP_UDP))
+		l4_profile = rohc_comp_get_class_profile(comp, ROHC_COMP_PKT_CLASS_IP_UDP,
+		                                         pkt_hdrs, all_ipv6_exts_len);
+		if(l4_profile != ROHC_PROFILE_MAX)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv2 IP/UDP profile is possible");
-			profile = ROHCv2_PROFILE_IP_UDP;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
+			profile = l4_profile;
+			rohc_comp_set_profile_hdrs(packet, remain_data, remain_len, pkt_hdrs);
 			fingerprint->base.profile_id = profile;
-			fingerprint->src_port = rohc_ntoh16(udp_header->source);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tsource port = %u", fingerprint->src_port);
-			fingerprint->dst_port = rohc_ntoh16(udp_header->dest);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tdestination port = %u", fingerprint->dst_port);
+			rohc_comp_set_profile_ports(comp, udp_header->source,
+			                            udp_header->dest, fingerprint);
 		}
 
 		/* check if the IP/UDP packet is a RTP packet */
-		if(!rohc_comp_is_rtp_hdr_supported(comp, remain_data, remain_len, pkt_hdrs))
+		if(!rohc_comp_is_rtp_hdr_supported(comp, remain_data, remain_len, pkt_hdrs,
+		                                   rtp_verdicts))
 		{
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			           "unsupported RTP header");
@@ -825,46 +1435,21 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
 		remain_data += sizeof(struct rtphdr);
 		remain_len -= sizeof(struct rtphdr);
 
-		/* ROHCv1/v2 IP/UDP/RTP profiles are possible if they are enabled */
+		/* ROHCv1/v2 IP/UDP/RTP profiles are possible if they are enabled,
+		 * ROHCv2 only supports RTP version 2 */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "IP/UDP/RTP packet detected by the RTP callback");
-		if(pkt_hdrs->ip_hdrs_nr <= ROHC_MAX_IP_HDRS_RFC3095 &&
-		   rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_IP_UDP_RTP))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv1 IP/UDP/RTP profile is possible");
-			profile = ROHCv1_PROFILE_IP_UDP_RTP;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
-			fingerprint->base.profile_id = profile;
-			fingerprint->src_port = rohc_ntoh16(udp_header->source);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tsource port = %u", fingerprint->src_port);
-			fingerprint->dst_port = rohc_ntoh16(udp_header->dest);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tdestination port = %u", fingerprint->dst_port);
-			fingerprint->rtp_ssrc = rohc_ntoh32(rtp->ssrc);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tSSRC = 0x%08x", fingerprint->rtp_ssrc);
-		}
-		else if(all_ipv6_exts_len == 0 && /* TODO: ROHCv2: add IPv6 ext hdrs support */
-		        rtp->version == 2 && /* ROHCv2 only supports RTP version 2 */
-		        rohc_comp_profile_enabled_nocheck(comp, ROHCv2_PROFILE_IP_UDP_RTP))
+		l4_profile = rohc_comp_get_class_profile(comp, rtp->version == 2 ?
+		                                         ROHC_COMP_PKT_CLASS_IP_RTP :
+		                                         ROHC_COMP_PKT_CLASS_IP_RTP_OTHER,
+		                                         pkt_hdrs, all_ipv6_exts_len);
+		if(l4_profile != ROHC_PROFILE_MAX)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv2 IP/UDP/RTP profile is possible");
-			profile = ROHCv2_PROFILE_IP_UDP_RTP;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
+			profile = l4_profile;
+			rohc_comp_set_profile_hdrs(packet, remain_data, remain_len, pkt_hdrs);
 			fingerprint->base.profile_id = profile;
-			fingerprint->src_port = rohc_ntoh16(udp_header->source);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tsource port = %u", fingerprint->src_port);
-			fingerprint->dst_port = rohc_ntoh16(udp_header->dest);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tdestination port = %u", fingerprint->dst_port);
+			rohc_comp_set_profile_ports(comp, udp_header->source,
+			                            udp_header->dest, fingerprint);
 			fingerprint->rtp_ssrc = rohc_ntoh32(rtp->ssrc);
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			           "\tSSRC = 0x%08x", fingerprint->rtp_ssrc);
@@ -889,29 +1474,12 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
 		/* ROHCv1/v2 IP/ESP profiles are possible if they are enabled */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "IP/ESP packet detected");
-		if(pkt_hdrs->ip_hdrs_nr <= ROHC_MAX_IP_HDRS_RFC3095 &&
-		   rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_IP_ESP))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv1 IP/ESP profile is possible");
-			profile = ROHCv1_PROFILE_IP_ESP;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
-			fingerprint->base.profile_id = profile;
-			fingerprint->esp_spi = rohc_ntoh32(esp->spi);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tSPI = 0x%08x", fingerprint->esp_spi);
-		}
-		else if(all_ipv6_exts_len == 0 && /* TODO: ROHCv2: add IPv6 ext hdrs support */
-		        rohc_comp_profile_enabled_nocheck(comp, ROHCv2_PROFILE_IP_ESP))
+		l4_profile = rohc_comp_get_class_profile(comp, ROHC_COMP_PKT_CLASS_IP_ESP,
+		                                         pkt_hdrs, all_ipv6_exts_len);
+		if(l4_profile != ROHC_PROFILE_MAX)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv2 IP/ESP profile is possible");
-			profile = ROHCv2_PROFILE_IP_ESP;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
+			profile = l4_profile;
+			rohc_comp_set_profile_hdrs(packet, remain_data, remain_len, pkt_hdrs);
 			fingerprint->base.profile_id = profile;
 			fingerprint->esp_spi = rohc_ntoh32(esp->spi);
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -937,39 +1505,15 @@ static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const com
 		/* ROHCv1/v2 IP/UDP-Lite profiles are possible if they are enabled */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "IP/UDP-Lite packet detected");
-		if(pkt_hdrs->ip_hdrs_nr <= ROHC_MAX_IP_HDRS_RFC3095 &&
-		   rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_IP_UDPLITE))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv1 IP/UDP-Lite profile is possible");
-			profile = ROHCv1_PROFILE_IP_UDPLITE;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
-			fingerprint->base.profile_id = profile;
-			fingerprint->src_port = rohc_ntoh16(udp_lite->source);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tsource port = %u", fingerprint->src_port);
-			fingerprint->dst_port = rohc_ntoh16(udp_lite->dest);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tdestination port = %u", fingerprint->dst_port);
-		}
-		else if(all_ipv6_exts_len == 0 && /* TODO: ROHCv2: add IPv6 ext hdrs support */
-		        rohc_comp_profile_enabled_nocheck(comp, ROHCv2_PROFILE_IP_UDPLITE))
+		l4_profile = rohc_comp_get_class_profile(comp, ROHC_COMP_PKT_CLASS_IP_UDPLITE,
+		                                         pkt_hdrs, all_ipv6_exts_len);
+		if(l4_profile != ROHC_PROFILE_MAX)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "ROHCv2 IP/ESP profile is possible");
-			profile = ROHCv2_PROFILE_IP_UDPLITE;
-			pkt_hdrs->all_hdrs_len = packet->len - remain_len;
-			pkt_hdrs->payload_len = remain_len;
-			pkt_hdrs->payload = remain_data;
+			profile = l4_profile;
+			rohc_comp_set_profile_hdrs(packet, remain_data, remain_len, pkt_hdrs);
 			fingerprint->base.profile_id = profile;
-			fingerprint->src_port = rohc_ntoh16(udp_lite->source);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tsource port = %u", fingerprint->src_port);
-			fingerprint->dst_port = rohc_ntoh16(udp_lite->dest);
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "\tdestination port = %u", fingerprint->dst_port);
+			rohc_comp_set_profile_ports(comp, udp_lite->source, udp_lite->dest,
+			                            fingerprint);
 		}
 	}
 
@@ -983,7 +1527,80 @@ unsupported_tcp_hdr:
 
 
 /**
- * @brief Are the given IP headers supported?
+ * @brief Get the best enabled profile for the given class of packets
+ *
+ * @param comp               The ROHC compressor
+ * @param pkt_class          The class of the packet
+ * @param pkt_hdrs           The information collected about the packet headers
+ * @param all_ipv6_exts_len  The length of the IPv6 extension headers
+ * @return                   The best enabled profile for the class of packets,
+ *                           ROHC_PROFILE_MAX if no enabled profile may
+ *                           compress the packet
+ */
+static rohc_profile_t rohc_comp_get_class_profile(const struct rohc_comp *const comp,
+                                                  const rohc_comp_pkt_class_t pkt_class,
+                                                  const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                                  const size_t all_ipv6_exts_len)
+{
+	const size_t too_many_ip_hdrs =
+		(pkt_hdrs->ip_hdrs_nr > ROHC_MAX_IP_HDRS_RFC3095);
+	const size_t has_ipv6_exts = (all_ipv6_exts_len != 0);
+	const rohc_profile_t profile =
+		comp->profiles_by_class[pkt_class][too_many_ip_hdrs][has_ipv6_exts];
+
+	if(profile != ROHC_PROFILE_MAX)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "%s profile is possible", rohc_get_profile_descr(profile));
+	}
+
+	return profile;
+}
+
+
+/**
+ * @brief Record the headers and payload for the profile chosen for a packet
+ *
+ * @param packet         The packet to compress
+ * @param payload        The payload of the packet for the chosen profile
+ * @param payload_len    The length of the payload of the packet
+ * @param[out] pkt_hdrs  The information collected about the packet headers
+ */
+static void rohc_comp_set_profile_hdrs(const struct rohc_buf *const packet,
+                                       const uint8_t *const payload,
+                                       const size_t payload_len,
+                                       struct rohc_pkt_hdrs *const pkt_hdrs)
+{
+	pkt_hdrs->all_hdrs_len = packet->len - payload_len;
+	pkt_hdrs->payload_len = payload_len;
+	pkt_hdrs->payload = payload;
+}
+
+
+/**
+ * @brief Record the transport ports in the fingerprint of a packet
+ *
+ * @param comp              The ROHC compressor
+ * @param src_port          The source port (in network byte order)
+ * @param dst_port          The destination port (in network byte order)
+ * @param[out] fingerprint  The fingerprint of the packet
+ */
+static void rohc_comp_set_profile_ports(const struct rohc_comp *const comp,
+                                        const uint16_t src_port,
+                                        const uint16_t dst_port,
+                                        struct rohc_fingerprint *const fingerprint)
+{
+	fingerprint->src_port = rohc_ntoh16(src_port);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "\tsource port = %u", fingerprint->src_port);
+	fingerprint->dst_port = rohc_ntoh16(dst_port);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "\tdestination port = %u", fingerprint->dst_port);
+}
+
+
+/**
+ * @brief Are the given IP headers supported?
  *
  * @param comp                    The ROHC compressor to compress the packet with
  * @param packet                  The packet to search the best compression profile
@@ -1021,6 +1638,7 @@ static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
 	do
 	{
 		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
+		const size_t ip_tot_len = remain_len + comp->chain_tail_len;
 
 		/* check minimal length for IP version */
 		if(remain_len < sizeof(struct ip_hdr))
@@ -1031,7 +1649,7 @@ static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
 			goto unsupported_ip_hdr;
 		}
 
-		pkt_hdrs->ip_hdrs[ip_hdrs_nr].tot_len = remain_len;
+		pkt_hdrs->ip_hdrs[ip_hdrs_nr].tot_len = ip_tot_len;
 		pkt_hdrs->ip_hdrs[ip_hdrs_nr].version = ip->version;
 
 		if(ip->version == IPV4)
@@ -1058,22 +1676,32 @@ static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
 			}
 
 			/* IPv4 total length shall be correct */
-			if(rohc_ntoh16(ipv4->tot_len) != remain_len)
+			if(rohc_ntoh16(ipv4->tot_len) != ip_tot_len)
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "IP packet #%zu is not supported: total length is %u "
 				           "while it shall be %zu", ip_hdrs_nr + 1,
-				           rohc_ntoh16(ipv4->tot_len), remain_len);
+				           rohc_ntoh16(ipv4->tot_len), ip_tot_len);
 				goto unsupported_ip_hdr;
 			}
 
-			/* check if the IPv4 header is a fragment */
+			/* check if the IPv4 header is a fragment: the IP-only profiles may
+			 * compress the fragments if asked to, but the payload of a fragment
+			 * is not parsed, so it cannot carry another IP header */
 			if(ipv4_is_fragment(ipv4))
 			{
+				if((comp->features & ROHC_COMP_FEATURE_IP_FRAGMENTS) == 0 ||
+				   rohc_is_tunneling(ipv4->protocol))
+				{
+					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+					           "IP packet #%zu is not supported: header is "
+					           "fragmented", ip_hdrs_nr + 1);
+					goto unsupported_ip_hdr;
+				}
+				pkt_hdrs->ipv4_frag = rohc_ntoh16(ipv4->frag_off) & (~IPV4_DF);
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "IP packet #%zu is not supported: header is fragmented",
-				           ip_hdrs_nr + 1);
-				goto unsupported_ip_hdr;
+				           "IP packet #%zu is a fragment (MF and offset = 0x%04x)",
+				           ip_hdrs_nr + 1, pkt_hdrs->ipv4_frag);
 			}
 
 			/* the IPv4 header checksum shall be correct in order to be inferred */
@@ -1120,12 +1748,12 @@ static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
 			remain_len -= sizeof(struct ipv6_hdr);
 
 			/* payload length shall be correct */
-			if(rohc_ntoh16(ipv6->plen) != remain_len)
+			if(rohc_ntoh16(ipv6->plen) != (ip_tot_len - sizeof(struct ipv6_hdr)))
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 				           "IP packet #%zu is not supported: payload length is %u "
 				           "while it shall be %zu", ip_hdrs_nr + 1,
-				           rohc_ntoh16(ipv6->plen), remain_len);
+				           rohc_ntoh16(ipv6->plen), ip_tot_len - sizeof(struct ipv6_hdr));
 				goto unsupported_ip_hdr;
 			}
 
@@ -1281,16 +1909,26 @@ unsupported_tcp_hdr:
 static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
                                            const uint8_t *const packet,
                                            const size_t packet_len,
-                                           struct rohc_pkt_hdrs *const pkt_hdrs)
+                                           struct rohc_pkt_hdrs *const pkt_hdrs,
+                                           struct rohc_comp_rtp_verdict *const rtp_verdicts)
 {
 	const uint8_t *remain_data = packet;
 	size_t remain_len = packet_len;
 	const uint8_t *udp_payload;
 	unsigned int udp_payload_size;
 	const struct rtphdr *rtp;
+	struct rohc_comp_rtp_verdict *verdict = NULL;
 	bool is_rtp = false;
 
-	if(comp->rtp_callback == NULL)
+	if(comp->hdrs_info != NULL)
+	{
+		/* the user already told whether the UDP payload is RTP or not */
+		if(!comp->hdrs_info->is_rtp)
+		{
+			goto unsupported_rtp_hdr;
+		}
+	}
+	else if(comp->rtp_ports == NULL && comp->rtp_callback == NULL)
 	{
 		goto unsupported_rtp_hdr;
 	}
@@ -1316,6 +1954,58 @@ static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
 		goto unsupported_rtp_hdr;
 	}
 
+	if(comp->hdrs_info != NULL)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "user described the IP/UDP packet as one IP/UDP/RTP packet");
+		is_rtp = true;
+		goto verdict_found;
+	}
+
+	/* UDP destination ports dedicated to RTP streams: the packet is a RTP
+	 * packet if it looks like a RTP version 2 packet and not like a RTCP
+	 * packet, the payload types 72 to 76 being the RTCP packet types 200
+	 * to 204 with the marker bit */
+	if(comp->rtp_ports != NULL)
+	{
+		const uint16_t dport = rohc_ntoh16(pkt_hdrs->udp->dest);
+
+		if((comp->rtp_ports[dport / 8] & (1U << (dport % 8))) != 0 &&
+		   rtp->version == 2 && (rtp->pt < 72 || rtp->pt > 76))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "UDP destination port %u is dedicated to RTP streams",
+			           dport);
+			is_rtp = true;
+			goto verdict_found;
+		}
+	}
+	if(comp->rtp_callback == NULL)
+	{
+		goto unsupported_rtp_hdr;
+	}
+
+	/* re-use the last verdict of the RTP callback for the UDP flow if the
+	 * callback shall not be asked for every packet */
+	if(rtp_verdicts != NULL && comp->rtp_detection_interval > 1)
+	{
+		struct rohc_comp_rtp_verdict key;
+
+		rohc_comp_get_rtp_verdict_key(pkt_hdrs, &key);
+		verdict = &rtp_verdicts[rohc_comp_get_rtp_verdict_idx(&key)];
+		if(verdict->reuse_nr > 0 &&
+		   memcmp(verdict, &key, offsetof(struct rohc_comp_rtp_verdict, is_rtp)) == 0)
+		{
+			verdict->reuse_nr--;
+			is_rtp = verdict->is_rtp;
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "re-use the last verdict of the RTP callback for the UDP "
+			           "flow (%u more packets)", verdict->reuse_nr);
+			goto verdict_found;
+		}
+		*verdict = key;
+	}
+
 	/* check if the IP/UDP packet is a RTP packet with the user callback
 	   dedicated to RTP stream detection: if the RTP callback returns true,
 	   consider that the packet matches the RTP profile */
@@ -1323,17 +2013,318 @@ static bool rohc_comp_is_rtp_hdr_supported(const struct rohc_comp *const comp,
 	                            (const uint8_t *) pkt_hdrs->udp,
 	                            udp_payload, udp_payload_size,
 	                            comp->rtp_private);
+	if(verdict != NULL)
+	{
+		verdict->is_rtp = is_rtp;
+		verdict->reuse_nr = rohc_min(comp->rtp_detection_interval - 1, UINT16_MAX);
+	}
+
 	if(is_rtp)
 	{
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "user said the IP/UDP packet is one IP/UDP/RTP packet");
 	}
 
+verdict_found:
 unsupported_rtp_hdr:
 	return is_rtp;
 }
 
 
+/**
+ * @brief Build the key of the RTP detection verdict for a UDP packet
+ *
+ * @param pkt_hdrs  The information collected about the packet headers
+ * @param[out] key  The verdict with only its key fields set
+ */
+static void rohc_comp_get_rtp_verdict_key(const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                          struct rohc_comp_rtp_verdict *const key)
+{
+	const struct rohc_pkt_ip_hdr *const ip = pkt_hdrs->innermost_ip_hdr;
+
+	memset(key, 0, sizeof(struct rohc_comp_rtp_verdict));
+	if(ip->version == IPV4)
+	{
+		key->saddr.u32[0] = ip->ipv4->saddr;
+		key->daddr.u32[0] = ip->ipv4->daddr;
+	}
+	else
+	{
+		memcpy(&key->saddr, &ip->ipv6->saddr, sizeof(struct ipv6_addr));
+		memcpy(&key->daddr, &ip->ipv6->daddr, sizeof(struct ipv6_addr));
+	}
+	key->sport = pkt_hdrs->udp->source;
+	key->dport = pkt_hdrs->udp->dest;
+	key->ip_version = ip->version;
+}
+
+
+/**
+ * @brief Get the entry of the cache of RTP detection verdicts for a UDP flow
+ *
+ * @param key  The verdict with only its key fields set
+ * @return     The index of the entry in the cache of RTP detection verdicts
+ */
+static size_t rohc_comp_get_rtp_verdict_idx(const struct rohc_comp_rtp_verdict *const key)
+{
+	uint32_t hash;
+
+	hash = key->saddr.u32[0] ^ key->saddr.u32[3] ^
+	       key->daddr.u32[0] ^ key->daddr.u32[3] ^
+	       ((uint32_t) key->sport << 16) ^ key->dport;
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return (hash & (ROHC_COMP_RTP_VERDICTS_LEN - 1));
+}
+
+
+/**
+ * @brief Find the best profile for a packet, skipping the classification of
+ *        the flows that only the Uncompressed profile accepted recently
+ *
+ * The flows that only the Uncompressed profile accepts would otherwise go
+ * through the whole rejection analysis of \ref rohc_comp_get_profile for
+ * every packet. See \ref rohc_comp_set_uncomp_flows_ttl. The bulk flows are
+ * skipped the same way, until their estimated savings grow again. See
+ * \ref rohc_comp_set_bulk_policy.
+ *
+ * @param comp              The ROHC compressor
+ * @param packet            The packet to find a compression profile for
+ * @param[out] fingerprint  The fingerprint of the packet
+ * @param[out] pkt_hdrs     The information collected about packet headers
+ * @return                  The ID of the profile that best suits the packet,
+ *                          ROHC_PROFILE_MAX if no profile can compress the
+ *                          packet
+ */
+static rohc_profile_t rohc_comp_classify(struct rohc_comp *const comp,
+                                         const struct rohc_buf *const packet,
+                                         struct rohc_fingerprint *const fingerprint,
+                                         struct rohc_pkt_hdrs *const pkt_hdrs)
+{
+	struct rohc_comp_uncomp_flow *flow = NULL;
+	struct rohc_comp_uncomp_flow key;
+	rohc_profile_t profile;
+
+	/* flows are remembered only if other profiles could compress them */
+	if((comp->uncomp_flows_ttl > 0 || comp->bulk_min_savings > 0) &&
+	   !comp->is_uncomp_passthrough &&
+	   rohc_comp_get_uncomp_flow_key(packet, &key))
+	{
+		flow = &comp->uncomp_flows[rohc_comp_get_uncomp_flow_idx(&key)];
+		if(memcmp(flow, &key, offsetof(struct rohc_comp_uncomp_flow, expiry)) == 0 &&
+		   packet->time.sec < flow->expiry && flow->is_bulk)
+		{
+			/* compress the bulk flow again as soon as its packets shrink
+			 * enough for compression to save more than the resume threshold */
+			flow->bulk_avg_len =
+				(flow->bulk_avg_len * 7U + rohc_min(packet->len, 0xffffU)) / 8U;
+			if((flow->bulk_saved_len * 1000U) >=
+			   (comp->bulk_resume_savings * (size_t) flow->bulk_avg_len))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "bulk flow now saves about %u bytes out of %u bytes "
+				           "per packet, compress it again", flow->bulk_saved_len,
+				           flow->bulk_avg_len);
+				flow->ip_version = 0;
+			}
+		}
+		if(memcmp(flow, &key, offsetof(struct rohc_comp_uncomp_flow, expiry)) == 0 &&
+		   packet->time.sec < flow->expiry)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "flow was recently %s, skip classification",
+			           (flow->is_bulk ? "found to save too few bytes" :
+			            "accepted by the Uncompressed profile only"));
+			memset(fingerprint, 0, sizeof(struct rohc_fingerprint));
+			pkt_hdrs->all_hdrs = rohc_buf_data(*packet);
+			rohc_comp_set_profile_hdrs(packet, rohc_buf_data(*packet), packet->len,
+			                           pkt_hdrs);
+			return ROHCv1_PROFILE_UNCOMPRESSED;
+		}
+	}
+
+	profile = rohc_comp_get_profile(comp, packet, fingerprint, pkt_hdrs,
+	                                comp->rtp_verdicts);
+
+	/* remember the flow if only the Uncompressed profile accepted it */
+	if(flow != NULL && comp->uncomp_flows_ttl > 0 &&
+	   profile == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		key.expiry = packet->time.sec + comp->uncomp_flows_ttl;
+		memcpy(flow, &key, sizeof(struct rohc_comp_uncomp_flow));
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "flow accepted by the Uncompressed profile only, skip its "
+		           "classification for %" PRIu64 " seconds",
+		           comp->uncomp_flows_ttl);
+	}
+
+	return profile;
+}
+
+
+/**
+ * @brief Build the key of the Uncompressed-only flow of a packet
+ *
+ * The key is read from the outer IP header and the TCP, UDP or UDP-Lite
+ * header right behind it, without any other check on the packet. The non-first
+ * fragments of IPv4 packets have no ports. The packets of other protocols, eg.
+ * tunnels or IPv6 extension headers, have no key since the flow cannot be
+ * told from the outer headers only.
+ *
+ * @param packet    The packet to build the key for
+ * @param[out] key  The flow with only its key fields set
+ * @return          true if the packet has a key, false otherwise
+ */
+static bool rohc_comp_get_uncomp_flow_key(const struct rohc_buf *const packet,
+                                          struct rohc_comp_uncomp_flow *const key)
+{
+	const uint8_t *const data = rohc_buf_data(*packet);
+	const size_t len = packet->len;
+	size_t ip_hdr_len;
+	bool has_ports = true;
+
+	memset(key, 0, sizeof(struct rohc_comp_uncomp_flow));
+	if(len < sizeof(struct ipv4_hdr))
+	{
+		goto no_key;
+	}
+	key->ip_version = (data[0] >> 4) & 0x0f;
+	if(key->ip_version == IPV4)
+	{
+		const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) data;
+
+		ip_hdr_len = ipv4->ihl * sizeof(uint32_t);
+		if(ip_hdr_len < sizeof(struct ipv4_hdr))
+		{
+			goto no_key;
+		}
+		key->saddr.u32[0] = ipv4->saddr;
+		key->daddr.u32[0] = ipv4->daddr;
+		key->proto = ipv4->protocol;
+		has_ports = ((rohc_ntoh16(ipv4->frag_off) & IPV4_OFFMASK) == 0);
+	}
+	else if(key->ip_version == IPV6 && len >= sizeof(struct ipv6_hdr))
+	{
+		const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) data;
+
+		ip_hdr_len = sizeof(struct ipv6_hdr);
+		memcpy(&key->saddr, &ipv6->saddr, sizeof(struct ipv6_addr));
+		memcpy(&key->daddr, &ipv6->daddr, sizeof(struct ipv6_addr));
+		key->proto = ipv6->nh;
+	}
+	else
+	{
+		goto no_key;
+	}
+
+	if(key->proto != ROHC_IPPROTO_TCP && key->proto != ROHC_IPPROTO_UDP &&
+	   key->proto != ROHC_IPPROTO_UDPLITE)
+	{
+		goto no_key;
+	}
+	if(has_ports)
+	{
+		if(len < (ip_hdr_len + sizeof(uint32_t)))
+		{
+			goto no_key;
+		}
+		memcpy(&key->sport, data + ip_hdr_len, sizeof(uint16_t));
+		memcpy(&key->dport, data + ip_hdr_len + sizeof(uint16_t), sizeof(uint16_t));
+	}
+
+	return true;
+
+no_key:
+	return false;
+}
+
+
+/**
+ * @brief Get the entry of the cache of Uncompressed-only flows for a flow
+ *
+ * @param key  The flow with only its key fields set
+ * @return     The index of the entry in the cache of Uncompressed-only flows
+ */
+static size_t rohc_comp_get_uncomp_flow_idx(const struct rohc_comp_uncomp_flow *const key)
+{
+	uint32_t hash;
+
+	hash = key->saddr.u32[0] ^ key->saddr.u32[3] ^
+	       key->daddr.u32[0] ^ key->daddr.u32[3] ^
+	       ((uint32_t) key->sport << 16) ^ key->dport ^ key->proto;
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return (hash & (ROHC_COMP_UNCOMP_FLOWS_LEN - 1));
+}
+
+
+/**
+ * @brief Send the flow of the context with the Uncompressed profile if
+ *        compression saves too few bytes
+ *
+ * The savings of the context are measured over the last
+ * \ref ROHC_COMP_BULK_EVAL_PKTS packets, from the statistics of the context:
+ * the header bytes saved by compression are compared with all the
+ * uncompressed bytes. See \ref rohc_comp_set_bulk_policy.
+ *
+ * @param comp    The ROHC compressor
+ * @param c       The compression context that just compressed the packet
+ * @param packet  The uncompressed packet that was just compressed
+ */
+static void rohc_comp_bulk_eval(struct rohc_comp *const comp,
+                                struct rohc_comp_ctxt *const c,
+                                const struct rohc_buf *const packet)
+{
+	struct rohc_comp_uncomp_flow key;
+	int64_t saved_len;
+	int64_t uncomp_len;
+	int pkts_nr;
+
+	if(comp->bulk_min_savings == 0 ||
+	   c->profile->id == ROHCv1_PROFILE_UNCOMPRESSED ||
+	   comp->is_uncomp_passthrough || comp->hdrs_info != NULL)
+	{
+		return;
+	}
+	pkts_nr = c->num_sent_packets - c->bulk_ref_pkts_nr;
+	if(pkts_nr < (int) ROHC_COMP_BULK_EVAL_PKTS)
+	{
+		return;
+	}
+
+	/* savings since the last measure, then start the next measure */
+	saved_len = (c->header_uncompressed_size - c->bulk_ref_hdr_uncomp_size) -
+	            (c->header_compressed_size - c->bulk_ref_hdr_comp_size);
+	uncomp_len = c->total_uncompressed_size - c->bulk_ref_uncomp_size;
+	c->bulk_ref_pkts_nr = c->num_sent_packets;
+	c->bulk_ref_uncomp_size = c->total_uncompressed_size;
+	c->bulk_ref_hdr_uncomp_size = c->header_uncompressed_size;
+	c->bulk_ref_hdr_comp_size = c->header_compressed_size;
+
+	if((saved_len * 1000) >= (uncomp_len * comp->bulk_min_savings) ||
+	   !rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_UNCOMPRESSED) ||
+	   !rohc_comp_get_uncomp_flow_key(packet, &key))
+	{
+		return;
+	}
+
+	/* remember the flow as a bulk flow, its next packets skip compression */
+	key.expiry = packet->time.sec + comp->bulk_ttl;
+	key.is_bulk = true;
+	key.bulk_saved_len = rohc_min(rohc_max(saved_len, 0) / pkts_nr, 0xffff);
+	key.bulk_avg_len = rohc_min(uncomp_len / pkts_nr, 0xffff);
+	memcpy(&comp->uncomp_flows[rohc_comp_get_uncomp_flow_idx(&key)], &key,
+	       sizeof(struct rohc_comp_uncomp_flow));
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "CID %u saves %" PRId64 " bytes out of %" PRId64 " bytes over "
+	           "%d packets, send its flow with the Uncompressed profile for "
+	           "%" PRIu64 " seconds", c->cid, saved_len, uncomp_len, pkts_nr,
+	           comp->bulk_ttl);
+}
+
+
 /**
  * @brief Compress the given uncompressed packet into a ROHC packet
  *
@@ -1369,6 +2360,9 @@ unsupported_rtp_hdr:
  *                          \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
  *                              output buffer is too small for the compressed
  *                              packet
+ *                          \li \ref ROHC_STATUS_NO_MEMORY if no context
+ *                              could be created within the memory budget
+ *                              set by \ref rohc_comp_set_mem_budget
  *                          \li \ref ROHC_STATUS_ERROR if an error occurred
  *
  * @ingroup rohc_comp
@@ -1404,509 +2398,571 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
                              const struct rohc_buf uncomp_packet,
                              struct rohc_buf *const rohc_packet)
 {
-	struct rohc_comp_ctxt *c;
-	rohc_packet_t packet_type;
-	int rohc_hdr_size;
-
-	const struct rohc_comp_profile *profile;
-	rohc_profile_t profile_id;
-
-	struct rohc_fingerprint fingerprint;
-	struct rohc_pkt_hdrs pkt_hdrs;
+	return rohc_compress5(comp, uncomp_packet, rohc_packet, NULL);
+}
 
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
 
+/**
+ * @brief Compress the given uncompressed packet and report about it
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, and
+ * fill the given structure with some information about the compressed
+ * packet at the same time. The information is the one that
+ * \ref rohc_comp_get_last_packet_info2 would return, without the cost of a
+ * second call.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @param[out] info         The information about the compressed packet,
+ *                          filled only if \ref ROHC_STATUS_OK or
+ *                          \ref ROHC_STATUS_SEGMENT is returned, may be NULL
+ * @return                  The same status values as \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress5(struct rohc_comp *const comp,
+                             const struct rohc_buf uncomp_packet,
+                             struct rohc_buf *const rohc_packet,
+                             struct rohc_comp_pkt_info *const info)
+{
 	/* check inputs validity */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(uncomp_packet))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is malformed");
-		goto error;
-	}
-	if(rohc_buf_is_empty(uncomp_packet))
+
+	return rohc_comp_compress_pkt_fb(comp, uncomp_packet, rohc_packet, NULL,
+	                                 info);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet and piggyback feedbacks on it
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, and
+ * piggyback the given feedbacks on the ROHC packet at the same time: the
+ * feedbacks are written at the beginning of the \e rohc_packet output buffer
+ * before the ROHC header is, so neither the ROHC packet nor the feedbacks
+ * are moved afterwards. The feedbacks of the ring linked with
+ * \ref rohc_comp_set_feedback_ring are piggybacked too.
+ *
+ * The given feedbacks are piggybacked all at once or not at all. They are
+ * not piggybacked if there is not enough room in the output buffer for them
+ * and for a ROHC packet as large as the uncompressed packet plus a few bytes,
+ * nor on ROHC segments. Once piggybacked, the \e feedbacks buffer is
+ * emptied. Otherwise it is left unchanged, ready for the next packet.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet, feedbacks
+ *                          included
+ * @param[in,out] feedbacks The feedbacks to piggyback, one or more complete
+ *                          feedback items
+ * @return                  The same status values as \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_compress_with_feedbacks(struct rohc_comp *const comp,
+                                           const struct rohc_buf uncomp_packet,
+                                           struct rohc_buf *const rohc_packet,
+                                           struct rohc_buf *const feedbacks)
+{
+	/* check inputs validity */
+	if(comp == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is empty");
 		goto error;
 	}
-	if(rohc_packet == NULL)
+	if(feedbacks == NULL || rohc_buf_is_malformed(*feedbacks))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is NULL");
+		             "given feedbacks are NULL or malformed");
 		goto error;
 	}
-	if(rohc_buf_is_malformed(*rohc_packet))
+
+	return rohc_comp_compress_pkt_fb(comp, uncomp_packet, rohc_packet,
+	                                 feedbacks, NULL);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet, but output the ROHC header only
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, but
+ * write only the ROHC header in the \e rohc_hdr output buffer. The payload of
+ * the packet is not copied behind the ROHC header: the \e payload buffer is
+ * set to point to the payload within the \e uncomp_packet buffer instead.
+ * The full ROHC packet is the ROHC header followed by the payload, so it may
+ * be transmitted without any copy with scatter/gather I/O, eg. writev(),
+ * sendmsg() or chained network buffers.
+ *
+ * The \e payload buffer shares the memory of the \e uncomp_packet buffer, so
+ * it is valid only as long as the memory of \e uncomp_packet is.
+ *
+ * The available length of the \e rohc_hdr buffer is the maximum length of the
+ * whole ROHC packet, ie. header and payload, as for \ref rohc_compress4. If
+ * the ROHC packet is too large, ROHC segmentation is used if possible: the
+ * whole ROHC packet is then stored within the compressor, no ROHC data is
+ * returned, the \e payload buffer is empty, and the ROHC segments shall be
+ * retrieved with \ref rohc_comp_get_segment2 as for \ref rohc_compress4.
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param[out] rohc_hdr  The resulting ROHC header
+ * @param[out] payload   The payload of the ROHC packet, within the memory of
+ *                       \e uncomp_packet
+ * @return               The same status values as \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_comp_get_segment2
+ */
+rohc_status_t rohc_compress_hdr(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                struct rohc_buf *const rohc_hdr,
+                                struct rohc_buf *const payload)
+{
+	/* check inputs validity */
+	if(comp == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*rohc_packet))
+	if(payload == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is not empty");
+		             "given payload is NULL");
 		goto error;
 	}
 
-	/* print uncompressed bytes */
-	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
-	{
-		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
-		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
-		                 "uncompressed data, max 100 bytes", uncomp_packet);
-	}
+	return rohc_comp_compress_pkt(comp, uncomp_packet, rohc_hdr, payload, false,
+	                              NULL);
 
-	/* what ROHC profile fits the uncompressed packet best? */
-	profile_id = rohc_comp_get_profile(comp, &uncomp_packet, &fingerprint, &pkt_hdrs);
-	if(profile_id == ROHC_PROFILE_MAX)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to find a matching profile among the enabled profiles "
-		             "for the uncompressed packet");
-		goto error;
-	}
+error:
+	return ROHC_STATUS_ERROR;
+}
 
-	/* find the profile identified by the given profile ID */
-	{
-		const uint8_t profile_major = (profile_id >> 8) & 0xff;
-		const uint8_t profile_minor = profile_id & 0xff;
-		profile = rohc_comp_profiles[profile_major][profile_minor];
-		if(profile == NULL)
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "profile '%s' (0x%04x) is not implemented yet",
-			             rohc_get_profile_descr(profile_id), profile_id);
-			goto error;
-		}
-	}
 
-	/* find the best profile context for the packet */
-	c = rohc_comp_find_ctxt(comp, profile, &uncomp_packet, &fingerprint, &pkt_hdrs);
-	if(c == NULL)
+/**
+ * @brief Compress the given uncompressed packet in place
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, but
+ * write the ROHC packet in the memory of the uncompressed packet instead of
+ * a separate output buffer. The payload is not moved: the ROHC header is
+ * written right before the payload, in place of the uncompressed headers
+ * and, if the ROHC header is larger than the uncompressed headers (eg. IR
+ * packets), in the headroom of the buffer.
+ *
+ * The headroom of the buffer, ie. its \e offset, is also used as a scratch
+ * area to build the ROHC header before it is moved in front of the payload,
+ * so the headroom shall be large enough for the ROHC header. Reserve at
+ * least as much headroom as the length of the uncompressed headers plus a
+ * few bytes of ROHC overhead.
+ *
+ * ROHC segmentation is never used because the ROHC packet always fits in the
+ * memory of the uncompressed packet.
+ *
+ * Packets compressed with the Uncompressed profile are passed through once
+ * the context left the IR state: the ROHC header of their Normal packets is
+ * the CID and the first byte of the packet only, the rest of the packet is
+ * neither copied nor moved. If the Uncompressed profile is the only enabled
+ * profile, the packets are not even parsed.
+ *
+ * @param comp         The ROHC compressor
+ * @param[in,out] pkt  in: the uncompressed packet to compress,
+ *                     out: the resulting ROHC packet if compression is
+ *                     successful, unchanged otherwise
+ * @return             Possible return values:
+ *                     \li \ref ROHC_STATUS_OK if a ROHC packet is returned
+ *                     \li \ref ROHC_STATUS_ERROR if an error occurred, eg. if
+ *                         the headroom is too small for the ROHC header
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress_in_place(struct rohc_comp *const comp,
+                                     struct rohc_buf *const pkt)
+{
+	struct rohc_buf rohc_hdr;
+	struct rohc_buf payload;
+	rohc_status_t status;
+
+	/* check inputs validity */
+	if(comp == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to find a matching context or to create a new "
-		             "context");
 		goto error;
 	}
-
-	/* create the ROHC packet: */
-	rohc_packet->len = 0;
-
-	/* use profile to compress packet */
-	rohc_comp_debug(c, "compress the packet #%d", comp->num_packets + 1);
-	rohc_hdr_size =
-		c->profile->encode(c, &pkt_hdrs, uncomp_packet.time,
-		                   rohc_buf_data(*rohc_packet),
-		                   rohc_buf_avail_len(*rohc_packet),
-		                   &packet_type);
-	if(rohc_hdr_size < 0)
+	if(pkt == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "error while compressing with profile '%s' (0x%04x)",
-		             rohc_get_profile_descr(profile_id), profile_id);
-		goto error_free_new_context;
-	}
-	rohc_packet->len += rohc_hdr_size;
-
-	if(profile_id == ROHCv1_PROFILE_UNCOMPRESSED &&
-	   packet_type == ROHC_PACKET_NORMAL)
-	{
-		pkt_hdrs.all_hdrs_len++;
-		pkt_hdrs.payload_len--;
-	}
-
-	/* increment the number of packets that were emitted in the current
-	 * compression state */
-	if(c->state_oa_repeat_nr < comp->oa_repetitions_nr)
-	{
-		c->state_oa_repeat_nr++;
-		rohc_comp_debug(c, "last change was transmitted %u/%u times",
-		                c->state_oa_repeat_nr, comp->oa_repetitions_nr);
+		             "given packet is NULL");
+		goto error;
 	}
 
-	/* the payload starts after the header, skip it */
-	rohc_buf_pull(rohc_packet, rohc_hdr_size);
-
-	/* is packet too large for output buffer? */
-	if(pkt_hdrs.payload_len > rohc_buf_avail_len(*rohc_packet))
-	{
-		const size_t max_rohc_buf_len =
-			rohc_buf_avail_len(*rohc_packet) + rohc_hdr_size;
-		uint32_t rru_crc;
-
-		/* resulting ROHC packet too large, segmentation may be a solution */
-		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		          "%s ROHC packet is too large for the given output buffer, "
-		          "try to segment it (input size = %zd, maximum output "
-		          "size = %zd, required output size = %d + %zd = %zd, "
-		          "MRRU = %zd)", rohc_get_packet_descr(packet_type),
-		          uncomp_packet.len, max_rohc_buf_len, rohc_hdr_size,
-		          pkt_hdrs.payload_len, rohc_hdr_size + pkt_hdrs.payload_len,
-		          comp->mrru);
-
-		/* in order to be segmented, a ROHC packet shall be <= MRRU
-		 * (remember that MRRU includes the CRC length) */
-		if((pkt_hdrs.payload_len + CRC_FCS32_LEN) > comp->mrru)
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "%s ROHC packet cannot be segmented: too large (%d + "
-			             "%zu + %u = %zu bytes) for MRRU (%zu bytes)",
-			             rohc_get_packet_descr(packet_type), rohc_hdr_size,
-			             pkt_hdrs.payload_len, CRC_FCS32_LEN, rohc_hdr_size +
-			             pkt_hdrs.payload_len + CRC_FCS32_LEN, comp->mrru);
-			goto error_free_new_context;
-		}
-		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		          "%s ROHC packet can be segmented (MRRU = %zd)",
-		          rohc_get_packet_descr(packet_type), comp->mrru);
-
-		/* store the whole ROHC packet in compressor (headers and payload only,
-		 * not feedbacks, feedbacks will be transmitted with the first segment
-		 * when rohc_comp_get_segment2() is called) */
-		if(comp->rru_len != 0)
-		{
-			/* warn users about previous, not yet retrieved RRU */
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "erase the existing %zd-byte RRU that was not "
-			             "retrieved yet (call rohc_comp_get_segment2() to add "
-			             "support for ROHC segments in your application)",
-			             comp->rru_len);
-		}
-		comp->rru_len = 0;
-		comp->rru_off = 0;
-		/* ROHC header */
-		rohc_buf_push(rohc_packet, rohc_hdr_size);
-		memcpy(comp->rru + comp->rru_off, rohc_buf_data(*rohc_packet),
-		       rohc_hdr_size);
-		comp->rru_len += rohc_hdr_size;
-		/* ROHC payload */
-		memcpy(comp->rru + comp->rru_off + comp->rru_len,
-		       rohc_buf_data_at(uncomp_packet, pkt_hdrs.all_hdrs_len),
-		       pkt_hdrs.payload_len);
-		comp->rru_len += pkt_hdrs.payload_len;
-		/* compute FCS-32 CRC over header and payload (optional feedbacks and
-		   the CRC field itself are excluded) */
-		rru_crc = crc_calc_fcs32(comp->rru + comp->rru_off, comp->rru_len,
-		                         CRC_INIT_FCS32);
-		memcpy(comp->rru + comp->rru_off + comp->rru_len, &rru_crc,
-		       CRC_FCS32_LEN);
-		comp->rru_len += CRC_FCS32_LEN;
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "RRU 32-bit FCS CRC = 0x%08x", rohc_ntoh32(rru_crc));
-		/* computed RRU must be <= MRRU */
-		assert(comp->rru_len <= comp->mrru);
-
-		/* reset the length of the ROHC packet: it shall be 0 for users */
-		rohc_packet->len = 0;
+	/* build the ROHC header in the headroom of the buffer, it does not overlap
+	 * with the uncompressed headers that are read during compression */
+	rohc_hdr = *pkt;
+	rohc_hdr.max_len = pkt->offset;
+	rohc_hdr.offset = 0;
+	rohc_hdr.len = 0;
 
-		/* report to users that segmentation is possible */
-		status = ROHC_STATUS_SEGMENT;
-	}
-	else
+	status = rohc_comp_compress_pkt(comp, *pkt, &rohc_hdr, &payload, true, NULL);
+	if(status != ROHC_STATUS_OK)
 	{
-		/* copy full payload after ROHC header */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "copy full %zd-byte payload", pkt_hdrs.payload_len);
-		rohc_buf_append(rohc_packet,
-		                rohc_buf_data_at(uncomp_packet, pkt_hdrs.all_hdrs_len),
-		                pkt_hdrs.payload_len);
-
-		/* unhide the ROHC header */
-		rohc_buf_push(rohc_packet, rohc_hdr_size);
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "ROHC size = %zd bytes (header = %d, payload = %zu), output "
-		           "buffer size = %zu", rohc_packet->len, rohc_hdr_size,
-		           pkt_hdrs.payload_len, rohc_buf_avail_len(*rohc_packet));
-
-		/* report to user that compression was successful */
-		status = ROHC_STATUS_OK;
+		goto error;
 	}
+	assert(rohc_hdr.len <= payload.offset);
 
-	/* update some statistics:
-	 *  - compressor statistics
-	 *  - context statistics (global + last packet + last 16 packets) */
-	comp->num_packets++;
-	comp->total_uncompressed_size += uncomp_packet.len;
-	comp->total_compressed_size += rohc_packet->len;
-	comp->last_context = c;
-
-	c->packet_type = packet_type;
-
-	c->total_uncompressed_size += uncomp_packet.len;
-	c->total_compressed_size += rohc_packet->len;
-	c->header_uncompressed_size += pkt_hdrs.all_hdrs_len;
-	c->header_compressed_size += rohc_hdr_size;
-	c->num_sent_packets++;
+	/* move the ROHC header right before the payload */
+	memmove(payload.data + payload.offset - rohc_hdr.len,
+	        rohc_buf_data(rohc_hdr), rohc_hdr.len);
+	rohc_buf_push(&payload, rohc_hdr.len);
 
-	c->total_last_uncompressed_size = uncomp_packet.len;
-	c->total_last_compressed_size = rohc_packet->len;
-	c->header_last_uncompressed_size = pkt_hdrs.all_hdrs_len;
-	c->header_last_compressed_size = rohc_hdr_size;
+	*pkt = payload;
 
-	/* compression is successful */
-	return status;
+	return ROHC_STATUS_OK;
 
-error_free_new_context:
-	/* free context if it was just created */
-	if(c->num_sent_packets <= 1)
-	{
-		if(c->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
-		{
-			comp->uncompressed_ctxt = NULL;
-		}
-		else
-		{
-			hashtable_del(&comp->contexts_by_fingerprint, &c->fingerprint);
-			/* TODO: replace TCP by CR capacity */
-			if(c->profile->id == ROHCv1_PROFILE_IP_TCP)
-			{
-				hashtable_cr_del(&comp->contexts_cr, &c->fingerprint);
-			}
-		}
-		c->profile->destroy(c);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
-	}
 error:
 	return ROHC_STATUS_ERROR;
 }
 
 
 /**
- * @brief Pad the given ROHC compressed packet
+ * @brief Predict the compression of the given uncompressed packet
  *
- * Add as many padding bytes as required to get a ROHC packet of the given length.
+ * The packet is classified, its context is looked up, and the profile
+ * decides the type of ROHC packet and encodes the ROHC header, as
+ * \ref rohc_compress4 would do right now. The encoding is done on a scratch
+ * copy of the context: the compressor and its contexts are not changed, the
+ * W-LSB windows, the counters, the state of the context and the statistics
+ * stay untouched. If no context exists yet for the packet, the prediction is
+ * the one of the first packet of a new context.
+ *
+ * The ROHC packet does not include the feedbacks that may be piggybacked
+ * by \ref rohc_compress4, and the packet is not segmented.
+ *
+ * The profile of the packet shall save its contexts in context images, see
+ * \ref rohc_comp_save_contexts.
  *
  * @param comp              The ROHC compressor
- * @param[in,out] rohc_pkt  The compressed ROHC packet to pad up to \e min_pkt_len
- * @param min_pkt_len       The minimum length of the ROHC packet
+ * @param uncomp_packet     The uncompressed packet to predict the ROHC
+ *                          packet for
+ * @param[out] rohc_hdr_len The length of the ROHC header
+ * @param[out] rohc_pkt_len The length of the whole ROHC packet, may be NULL
+ * @param[out] packet_type  The type of the ROHC packet
  * @return                  Possible return values:
- *                          \li \ref ROHC_STATUS_OK if a padded ROHC packet is
- *                              returned
- *                          \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
- *                              buffer is too small for the padded ROHC packet
- *                          \li \ref ROHC_STATUS_ERROR if an error occurred
+ *                          \li \ref ROHC_STATUS_OK if the prediction
+ *                              succeeded
+ *                          \li \ref ROHC_STATUS_NO_MEMORY if the scratch
+ *                              context could not be allocated within the
+ *                              memory budget of the compressor
+ *                          \li \ref ROHC_STATUS_ERROR if an error occurred,
+ *                              or if the profile cannot predict packets
  *
  * @ingroup rohc_comp
  *
  * @see rohc_compress4
  */
-rohc_status_t rohc_comp_pad(struct rohc_comp *const comp,
-                            struct rohc_buf *const rohc_pkt,
-                            const size_t min_pkt_len)
+rohc_status_t rohc_compress_dryrun(struct rohc_comp *const comp,
+                                   const struct rohc_buf uncomp_packet,
+                                   size_t *const rohc_hdr_len,
+                                   size_t *const rohc_pkt_len,
+                                   rohc_packet_t *const packet_type)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	const uint8_t padding_byte = ROHC_PADDING_BYTE;
-	size_t padding_bytes_nr = 0;
-	size_t i;
+	const struct rohc_comp_profile *profile;
+	const struct rohc_comp_ctxt *ctxt;
+	struct rohc_fingerprint fingerprint;
+	struct rohc_pkt_hdrs pkt_hdrs;
+	struct rohc_comp_ctxt *scratch;
+	rohc_profile_t profile_id;
+	uint8_t *hdr_buf;
+	size_t hdr_buf_len;
+	size_t payload_len;
+	rohc_status_t status = ROHC_STATUS_ERROR;
+	int hdr_len;
 
-	/* check inputs validity */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_pkt == NULL)
+	if(rohc_buf_is_malformed(uncomp_packet) || rohc_buf_is_empty(uncomp_packet))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_pkt is NULL");
+		             "given uncomp_packet is malformed or empty");
 		goto error;
 	}
-	if(rohc_buf_is_malformed(*rohc_pkt))
+	if(rohc_hdr_len == NULL || packet_type == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_pkt is malformed");
+		             "given rohc_hdr_len or packet_type is NULL");
 		goto error;
 	}
-	if(rohc_buf_is_empty(*rohc_pkt))
+
+	/* what ROHC profile fits the uncompressed packet best? */
+	profile_id = rohc_comp_get_profile(comp, &uncomp_packet, &fingerprint,
+	                                   &pkt_hdrs, comp->rtp_verdicts);
+	if(profile_id == ROHC_PROFILE_MAX)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_pkt is empty");
+		             "failed to find a matching profile among the enabled profiles "
+		             "for the uncompressed packet");
+		goto error;
+	}
+	profile = rohc_comp_profiles[(profile_id >> 8) & 0xff][profile_id & 0xff];
+	if(profile == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "profile '%s' (0x%04x) is not implemented yet",
+		             rohc_get_profile_descr(profile_id), profile_id);
+		goto error;
+	}
+	if(profile->save == NULL || profile->restore == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "profile '%s' (0x%04x) cannot predict packets",
+		             rohc_get_profile_descr(profile_id), profile_id);
 		goto error;
 	}
+	if(rohc_comp_ip_frag_len(comp, profile->id) != 0 && pkt_hdrs.ipv4_frag != 0)
+	{
+		rohc_comp_frag_rebase_hdrs(comp, &pkt_hdrs);
+	}
 
-	/* if ROHC packet is already smaller than the minimum length, prepend
-	 * some padding bytes before the ROHC packet up to the minimum length */
-	if(rohc_pkt->len >= min_pkt_len)
+	/* find the context of the packet, without updating the cache of flows */
+	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
 	{
-		padding_bytes_nr = 0;
+		ctxt = comp->uncompressed_ctxt;
 	}
 	else
 	{
-		padding_bytes_nr = min_pkt_len - rohc_pkt->len;
+		ctxt = hashtable_get(&comp->contexts_by_fingerprint, &fingerprint,
+		                     rohc_fingerprint_len(&fingerprint));
 	}
 
-	/* ROHC packet cannot be padded if buffer has not enough room before packet */
-	if(rohc_pkt->offset < padding_bytes_nr)
+	/* encode the ROHC header on a scratch copy of the context, or on a scratch
+	 * new context */
+	scratch = rohc_mempool_alloc(&comp->mempool, sizeof(struct rohc_comp_ctxt));
+	if(scratch == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "%zu-byte ROHC packet cannot be padded up to %zu bytes with "
-		             "%zu bytes: only %zu bytes available in buffer before ROHC "
-		             "data", rohc_pkt->len, min_pkt_len, padding_bytes_nr,
-		             rohc_pkt->offset);
-		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+		status = ROHC_STATUS_NO_MEMORY;
 		goto error;
 	}
+	if(ctxt != NULL)
+	{
+		status = c_dryrun_copy_context(comp, scratch, ctxt);
+	}
+	else
+	{
+		status = c_dryrun_new_context(comp, scratch, profile, &fingerprint,
+		                              &pkt_hdrs, uncomp_packet.time);
+	}
+	if(status != ROHC_STATUS_OK)
+	{
+		goto free_scratch;
+	}
 
-	/* add required padding bytes */
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "pad %zu-byte ROHC packet up to %zu bytes with %zu bytes",
-	           rohc_pkt->len, min_pkt_len, padding_bytes_nr);
-	for(i = 0; i < padding_bytes_nr; i++)
+	/* the ROHC header is never much larger than the uncompressed headers */
+	hdr_buf_len = pkt_hdrs.all_hdrs_len * 2 + ROHC_MEMPOOL_OBJ_MIN_LEN;
+	hdr_buf = rohc_mempool_alloc(&comp->mempool, hdr_buf_len);
+	if(hdr_buf == NULL)
 	{
-		rohc_buf_prepend(rohc_pkt, &padding_byte, 1);
+		status = ROHC_STATUS_NO_MEMORY;
+		goto destroy_scratch;
+	}
+	hdr_len = rohc_comp_ctxt_profile(scratch)->encode(scratch, &pkt_hdrs,
+	                                                  uncomp_packet.time,
+	                                                  hdr_buf, hdr_buf_len,
+	                                                  packet_type);
+	rohc_mempool_release(&comp->mempool, hdr_buf, hdr_buf_len);
+	if(hdr_len < 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "error while predicting the compression with profile '%s' "
+		             "(0x%04x)", rohc_get_profile_descr(profile_id), profile_id);
+		status = ROHC_STATUS_ERROR;
+		goto destroy_scratch;
 	}
-	assert(rohc_pkt->len >= min_pkt_len);
 
-	/* everything went fine */
-	status = ROHC_STATUS_OK;
+	payload_len = pkt_hdrs.payload_len;
+	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED &&
+	   (*packet_type) == ROHC_PACKET_NORMAL)
+	{
+		payload_len--;
+	}
+	hdr_len += rohc_comp_ip_frag_len(comp, profile->id);
+	*rohc_hdr_len = hdr_len;
+	if(rohc_pkt_len != NULL)
+	{
+		*rohc_pkt_len = hdr_len + payload_len;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, profile->id,
+	           "packet predicted as %s packet with %d bytes of ROHC header",
+	           rohc_get_packet_descr(*packet_type), hdr_len);
 
+destroy_scratch:
+	scratch->profile->destroy(scratch);
+free_scratch:
+	rohc_mempool_release(&comp->mempool, scratch, sizeof(struct rohc_comp_ctxt));
 error:
 	return status;
 }
 
 
 /**
- * @brief Get the next ROHC segment if any
+ * @brief Compress the given uncompressed packet within the given length
  *
- * Get the next ROHC segment if any.
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, but
+ * only if the resulting ROHC packet fits in the given length. The ROHC packet
+ * is first predicted with \ref rohc_compress_dryrun. If it does not fit, the
+ * periodic refreshes of the context are deferred to the next packets, so
+ * that a smaller packet type that the decompressor is still able to
+ * decompress may be used. If the packet still does not fit, nothing is
+ * compressed: the compressor and its contexts are not changed.
  *
- * To get all the segments of one ROHC packet, call this function until
- * \ref ROHC_STATUS_OK or \ref ROHC_STATUS_ERROR is returned.
+ * The ROHC packet is never segmented, and no feedback is piggybacked: the
+ * feedbacks wait for the next packets.
  *
- * @param comp          The ROHC compressor
- * @param[out] segment  The buffer where to store the ROHC segment
- * @return              Possible return values:
- *                       \li \ref ROHC_STATUS_SEGMENT if a ROHC segment is
- *                           returned and more segments are available,
- *                       \li \ref ROHC_STATUS_OK if a ROHC segment is returned
- *                           and no more ROHC segment is available
- *                       \li \ref ROHC_STATUS_ERROR if an error occurred
+ * The profile of the packet shall save its contexts in context images, see
+ * \ref rohc_comp_save_contexts.
  *
- * @ingroup rohc_comp
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @param max_len           The maximal length of the ROHC packet
+ * @return                  The same status values as \ref rohc_compress4,
+ *                          except \ref ROHC_STATUS_SEGMENT, plus
+ *                          \ref ROHC_STATUS_TOO_LARGE if no ROHC packet
+ *                          fits in the given length or in the output buffer
  *
- * \par Example:
- * \snippet test_segment.c define ROHC compressor
- * \code
-        ...
-        // compress the IP packet with a small ROHC buffer
-\endcode
- * \snippet test_segment.c segment ROHC packet #1
- * \snippet test_segment.c segment ROHC packet #2
- * \code
-                        ...
-                        // decompress the ROHC segment here, the function
-                        // rohc_decompress3 shall return ROHC_STATUS_OK
-                        // and no decompressed packet
-                        ...
-\endcode
- * \snippet test_segment.c segment ROHC packet #3
- * \code
-                // decompress the final ROHC segment here, the function
-                // rohc_decompress4 shall return ROHC_STATUS_OK
-\endcode
- * \snippet test_segment.c segment ROHC packet #4
- * \code
-                // handle compression error here
-                ...
-\endcode
+ * @ingroup rohc_comp
  *
- * @see rohc_comp_get_mrru
- * @see rohc_comp_set_mrru
  * @see rohc_compress4
+ * @see rohc_compress_dryrun
  */
-rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
-                                     struct rohc_buf *const segment)
-
+rohc_status_t rohc_compress_constrained(struct rohc_comp *const comp,
+                                        const struct rohc_buf uncomp_packet,
+                                        struct rohc_buf *const rohc_packet,
+                                        const size_t max_len)
 {
-	const size_t segment_type_len = 1; /* segment type byte */
-	size_t max_data_len;
+	rohc_packet_t packet_type;
+	size_t hdr_len;
+	size_t pkt_len;
+	size_t len_limit;
 	rohc_status_t status;
 
-	/* check input parameters */
 	if(comp == NULL)
 	{
-		goto error;
+		return ROHC_STATUS_ERROR;
 	}
-	if(segment == NULL)
+	if(rohc_packet == NULL || rohc_buf_is_malformed(*rohc_packet))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given segment cannot be NULL");
-		goto error;
+		             "given rohc_packet is NULL or malformed");
+		return ROHC_STATUS_ERROR;
 	}
-	if(rohc_buf_is_malformed(*segment))
+	len_limit = rohc_min(max_len, rohc_buf_avail_len(*rohc_packet));
+
+	/* predict the ROHC packet, then without the periodic refreshes if it is
+	 * too large */
+	status = rohc_compress_dryrun(comp, uncomp_packet, &hdr_len, &pkt_len,
+	                              &packet_type);
+	if(status == ROHC_STATUS_OK && pkt_len > len_limit)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given segment is malformed");
-		goto error;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "%s packet of %zu bytes does not fit in %zu bytes, try "
+		           "without periodic refreshes",
+		           rohc_get_packet_descr(packet_type), pkt_len, len_limit);
+		comp->defer_refreshes = true;
+		status = rohc_compress_dryrun(comp, uncomp_packet, &hdr_len, &pkt_len,
+		                              &packet_type);
 	}
-	if(!rohc_buf_is_empty(*segment))
+	if(status != ROHC_STATUS_OK)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given segment is not empty");
 		goto error;
 	}
-
-	/* no segment yet */
-	segment->len = 0;
-
-	/* abort if no RRU is available in the compressor */
-	if(comp->rru_len == 0)
+	if(pkt_len > len_limit)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "no RRU available in given compressor");
+		             "no ROHC packet fits in %zu bytes: %s packet of %zu bytes "
+		             "at least", len_limit, rohc_get_packet_descr(packet_type),
+		             pkt_len);
+		status = ROHC_STATUS_TOO_LARGE;
 		goto error;
 	}
 
-	/* abort is the given output buffer is too small for RRU */
-	if(rohc_buf_avail_len(*segment) <= segment_type_len)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "output buffer is too small for RRU, more than %zd bytes "
-		             "are required", segment_type_len);
-		goto error;
-	}
+	status = rohc_comp_compress_pkt(comp, uncomp_packet, rohc_packet, NULL,
+	                                false, NULL);
 
-	/* how many bytes of ROHC packet can we put in that new segment? */
-	max_data_len = rohc_min(rohc_buf_avail_len(*segment) - segment_type_len,
-	                        comp->rru_len);
-	assert(max_data_len > 0);
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "copy %zd bytes of the remaining %zd bytes of ROHC packet and "
-	           "CRC in the segment", max_data_len, comp->rru_len);
+error:
+	comp->defer_refreshes = false;
+	return status;
+}
 
-	/* set segment type with F bit set only for last segment */
-	rohc_buf_byte_at(*segment, 0) = 0xfe | (max_data_len == comp->rru_len);
-	segment->len++;
-	rohc_buf_pull(segment, 1);
 
-	/* copy remaining ROHC data (CRC included) */
-	rohc_buf_append(segment, comp->rru + comp->rru_off, max_data_len);
-	rohc_buf_pull(segment, max_data_len);
-	comp->rru_off += max_data_len;
-	comp->rru_len -= max_data_len;
+/**
+ * @brief Compress the given uncompressed packet, segment it without copy
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress_hdr does:
+ * only the ROHC header is written in the \e rohc_hdr output buffer, and the
+ * \e payload buffer is set to point to the payload within the
+ * \e uncomp_packet buffer.
+ *
+ * If the ROHC packet is too large for the \e rohc_hdr buffer, ROHC
+ * segmentation is used if possible as for \ref rohc_compress_hdr, but the
+ * Reconstructed Reception Unit (RRU) is not copied within the compressor:
+ * it references the ROHC header written in the memory of \e rohc_hdr and the
+ * payload within the memory of \e uncomp_packet, and the FCS-32 CRC of the
+ * RRU is computed on the fly over them. The ROHC segments shall then be
+ * retrieved with \ref rohc_comp_get_segment_iov, while the memory of both
+ * \e rohc_hdr and \e uncomp_packet is still valid and unchanged.
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param[out] rohc_hdr  The resulting ROHC header
+ * @param[out] payload   The payload of the ROHC packet, within the memory of
+ *                       \e uncomp_packet
+ * @return               The same status values as \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_hdr
+ * @see rohc_comp_get_segment_iov
+ */
+rohc_status_t rohc_compress_iov(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                struct rohc_buf *const rohc_hdr,
+                                struct rohc_buf *const payload)
+{
+	rohc_status_t status;
 
-	/* set status wrt to (non-)final segment */
-	if(comp->rru_len == 0)
+	/* check inputs validity */
+	if(comp == NULL)
 	{
-		/* final segment, no more segment available */
-		status = ROHC_STATUS_OK;
-		/* reset context for next RRU */
-		comp->rru_off = 0;
+		goto error;
 	}
-	else
+	if(payload == NULL)
 	{
-		/* non-final segment, more segments to available */
-		status = ROHC_STATUS_SEGMENT;
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given payload is NULL");
+		goto error;
 	}
 
-	/* shift backward the RRU data, header and the feedback data */
-	rohc_buf_push(segment, max_data_len + 1);
+	comp->rru_by_ref = true;
+	status = rohc_comp_compress_pkt(comp, uncomp_packet, rohc_hdr, payload,
+	                                false, NULL);
+	comp->rru_by_ref = false;
 
 	return status;
 
@@ -1916,658 +2972,8197 @@ error:
 
 
 /**
- * @brief Force the compressor to re-initialize all its contexts
+ * @brief Compress the given uncompressed packet stored in a chain of buffers
  *
- * Make all contexts restart their initialization with decompressor, ie. they
- * go in the lowest compression state. This function can be used once the
- * ROHC channel is established again after an interruption.
+ * Compress the given uncompressed packet as \ref rohc_compress_hdr does, but
+ * the uncompressed packet is stored in several non-contiguous segments, eg.
+ * a header buffer followed by payload pages. All the headers of the packet
+ * shall be in the first segment, the other segments hold payload only.
  *
- * The function implements the CONTEXT_REINITIALIZATION signal described by
- * RFC 3095 at §6.3.1 as:
- * \verbatim
-   CONTEXT_REINITIALIZATION -- signal
-   This parameter triggers a reinitialization of the entire context at
-   the decompressor, both the static and the dynamic part.  The
-   compressor MUST, when CONTEXT_REINITIALIZATION is triggered, back off
-   to the IR state and fully reinitialize the context by sending IR
-   packets with both the static and dynamic chains covering the entire
-   uncompressed headers until it is reasonably confident that the
-   decompressor contexts are reinitialized.  The context
-   reinitialization MUST be done for all contexts at the compressor.
-   This parameter may for instance be used to do context relocation at,
-   e.g., a cellular handover that results in a change of compression
-   point in the radio access network.
-\endverbatim
+ * Only the ROHC header is written in the \e rohc_hdr output buffer. The
+ * payload is not copied: the \e payload chain is set to reference the
+ * payload where it is, ie. the end of the first segment behind the headers
+ * if it is not empty, then the other segments unchanged. The full ROHC
+ * packet is the ROHC header followed by the segments of the \e payload
+ * chain. They are valid only as long as the memory of \e uncomp_chain is.
  *
- * @param comp  The ROHC compressor
- * @return      true in case of success, false otherwise
+ * The length of the \e rohc_hdr buffer limits the ROHC header only, the
+ * payload never counts against it. ROHC segmentation is thus never used.
+ *
+ * The payload of the packet is never read, except the bytes of the first
+ * segment given to the RTP detection callback, see
+ * \ref rohc_comp_set_rtp_detection_cb.
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_chain   The uncompressed packet to compress
+ * @param[out] rohc_hdr  The resulting ROHC header
+ * @param[out] payload   The payload of the ROHC packet, within the memory of
+ *                       \e uncomp_chain, it shall be able to hold as many
+ *                       segments as \e uncomp_chain
+ * @return               Possible return values:
+ *                       \li \ref ROHC_STATUS_OK if a ROHC header is returned
+ *                       \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if \e payload
+ *                           cannot hold all the segments of the payload
+ *                       \li \ref ROHC_STATUS_NO_MEMORY if no context could
+ *                           be created within the memory budget set by
+ *                           \ref rohc_comp_set_mem_budget
+ *                       \li \ref ROHC_STATUS_ERROR if an error occurred,
+ *                           eg. if \e rohc_hdr is too small for the ROHC
+ *                           header
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_compress_hdr
+ * @see rohc_decompress_chain
  */
-bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
+rohc_status_t rohc_compress_chain(struct rohc_comp *const comp,
+                                  const struct rohc_buf_chain uncomp_chain,
+                                  struct rohc_buf *const rohc_hdr,
+                                  struct rohc_buf_chain *const payload)
 {
-	rohc_cid_t i;
+	struct rohc_buf head_payload;
+	rohc_status_t status;
+	size_t i;
 
+	/* check inputs validity */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "force re-initialization for all %u contexts",
-	          comp->num_contexts_used);
-
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	if(uncomp_chain.segs == NULL || uncomp_chain.segs_nr == 0 ||
+	   uncomp_chain.segs_nr > uncomp_chain.segs_max)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_chain is malformed");
+		goto error;
+	}
+	if(payload == NULL || payload->segs == NULL)
 	{
-		if(comp->contexts[i].used)
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given payload is NULL");
+		goto error;
+	}
+	if(payload->segs_max < uncomp_chain.segs_nr)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given payload may hold %zu segments, but %zu segments "
+		             "may be required", payload->segs_max, uncomp_chain.segs_nr);
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	for(i = 1; i < uncomp_chain.segs_nr; i++)
+	{
+		if(rohc_buf_is_malformed(uncomp_chain.segs[i]))
 		{
-			if(!rohc_comp_reinit_context(&(comp->contexts[i])))
-			{
-				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				             "failed to force re-initialization for CID %u", i);
-				goto error;
-			}
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "segment #%zu of given uncomp_chain is malformed", i + 1);
+			goto error;
 		}
 	}
 
-	return true;
+	/* only the first segment is parsed, the length of the other ones is
+	 * accounted in the lengths of the headers */
+	comp->chain_tail_len =
+		rohc_buf_chain_len(uncomp_chain) - uncomp_chain.segs[0].len;
+	status = rohc_comp_compress_pkt(comp, uncomp_chain.segs[0], rohc_hdr,
+	                                &head_payload, true, NULL);
+	comp->chain_tail_len = 0;
+	if(status != ROHC_STATUS_OK)
+	{
+		goto error_status;
+	}
+
+	/* reference the payload: the end of the first segment, then the other
+	 * segments unchanged */
+	payload->segs_nr = 0;
+	if(head_payload.len > 0)
+	{
+		payload->segs[payload->segs_nr] = head_payload;
+		payload->segs_nr++;
+	}
+	for(i = 1; i < uncomp_chain.segs_nr; i++)
+	{
+		payload->segs[payload->segs_nr] = uncomp_chain.segs[i];
+		payload->segs_nr++;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "reference the payload without copy in %zu segments",
+	           payload->segs_nr);
+
+	return ROHC_STATUS_OK;
 
 error:
-	return false;
+	return ROHC_STATUS_ERROR;
+error_status:
+	return status;
 }
 
 
 /**
- * @brief Set the number of repetitions required to gain transmission confidence
- *
- * The Optimistic Approach is defined by RFC 3095 §5.3.1.1.1 as follow:
- *
- *   Transition to a higher compression state in Unidirectional mode is
- *   carried out according to the optimistic approach principle.  This
- *   means that the compressor transits to a higher compression state when
- *   it is fairly confident that the decompressor has received enough
- *   information to correctly decompress packets sent according to the
- *   higher compression state.
- *
- *   When the compressor is in the IR state, it will stay there until it
- *   assumes that the decompressor has correctly received the static
- *   context information.  For transition from the FO to the SO state, the
- *   compressor should be confident that the decompressor has all
- *   parameters needed to decompress according to a fixed pattern.
- *
- *   The compressor normally obtains its confidence about decompressor
- *   status by sending several packets with the same information according
- *   to the lower compression state.  If the decompressor receives any of
- *   these packets, it will be in sync with the compressor.  The number of
- *   consecutive packets to send for confidence is not defined in this
- *   document.
- *
- * This function allows the library users to set the number of repetitions
- * required by the ROHC compressor to gain confidence that the ROHC
- * decompressor got the transmitted information.
- *
- * It controls:
- *  - the number of IR packets transmitted in a row at context initialization,
- *  - the number of context-updating packets transmitted in case of stream change,
- *  - the number of transmissions of TS stride, list structures or list items
- *    before they are considered as known,
- *  - the width of the W-LSB window.
- *
- * The number of repetitions may be chosen as follow:
- *  a/ define the largest loss burst that you want to be robust to,
- *  b/ increment that number by one, so that at least one packet per burst
- *     is received by the decompressor.
- *
- * @warning The value can not be modified after library initialization
+ * @brief Compress the given uncompressed packet whose headers were parsed
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, but
+ * the headers of the packet are described by the user who already parsed
+ * them, eg. a network stack. The packet is not classified again: the caches
+ * of the classification are by-passed and the RTP detection is replaced by
+ * the verdict of the user, see \ref rohc_comp_hdrs_info. If the user gives
+ * the hash of the flow computed by the NIC, it indexes the compression
+ * context of the flow, so that the fingerprint of the packet is not hashed
+ * when the context is found there.
+ *
+ * The IP headers are still checked since the profiles rely on them. The
+ * description shall match the headers found by the compressor, otherwise
+ * \ref ROHC_STATUS_ERROR is returned. Headers that no profile but the
+ * Uncompressed one accepts are compressed as \ref rohc_compress4 does.
  *
- * @param comp            The ROHC compressor to configure
- * @param repetitions_nr  The number of repetitions (4 by default)
- * @return                true in case of success, false in case of failure
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param hdrs_info         The headers of the packet as parsed by the user
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @return                  The same status values as \ref rohc_compress4
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
  */
-bool rohc_comp_set_optimistic_approach(struct rohc_comp *const comp,
-                                       const size_t repetitions_nr)
+rohc_status_t rohc_compress_hdrs_info(struct rohc_comp *const comp,
+                                      const struct rohc_buf uncomp_packet,
+                                      const struct rohc_comp_hdrs_info *const hdrs_info,
+                                      struct rohc_buf *const rohc_packet)
 {
-	/* we need a valid compressor */
+	rohc_status_t status;
+	size_t i;
+
+	/* check inputs validity */
 	if(comp == NULL)
 	{
-		return false;
+		goto error;
 	}
-
-	/* the window width shall be in both ranges ]0;ROHC_WLSB_WIDTH_MAX]
-	 * and ]0;UINT8_MAX] */
-	if(repetitions_nr == 0 ||
-	   repetitions_nr > ROHC_WLSB_WIDTH_MAX ||
-	   repetitions_nr > UINT8_MAX)
+	if(hdrs_info == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
-		             "set the number of Optimistic Approach repetitions to %zu: "
-		             "value must be in range ]0;%u]",
-		             repetitions_nr, rohc_min(ROHC_WLSB_WIDTH_MAX, UINT8_MAX));
-		return false;
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given hdrs_info is NULL");
+		goto error;
 	}
-
-	/* refuse to set a value if compressor is in use */
-	if(comp->num_packets > 0)
+	if(hdrs_info->ip_hdrs_nr == 0 ||
+	   hdrs_info->ip_hdrs_nr > ROHC_COMP_HDRS_INFO_IP_MAX)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
-		             "modify the number of Optimistic Approach repetitions "
-		             "after initialization");
-		return false;
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given hdrs_info describes %u IP headers, but 1 to %u "
+		             "IP headers are expected", hdrs_info->ip_hdrs_nr,
+		             ROHC_COMP_HDRS_INFO_IP_MAX);
+		goto error;
+	}
+	if(hdrs_info->ip_offsets[0] != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given hdrs_info does not start with one IP header");
+		goto error;
+	}
+	for(i = 1; i < hdrs_info->ip_hdrs_nr; i++)
+	{
+		if(hdrs_info->ip_offsets[i] <= hdrs_info->ip_offsets[i - 1])
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "given hdrs_info describes IP header #%zu before IP "
+			             "header #%zu", i + 1, i);
+			goto error;
+		}
+	}
+	if(hdrs_info->l4_offset <= hdrs_info->ip_offsets[hdrs_info->ip_hdrs_nr - 1] ||
+	   hdrs_info->l4_offset > uncomp_packet.len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given hdrs_info describes the transport header at "
+		             "offset %u, out of the packet", hdrs_info->l4_offset);
+		goto error;
 	}
 
-	comp->oa_repetitions_nr = repetitions_nr;
+	comp->hdrs_info = hdrs_info;
+	status = rohc_comp_compress_pkt_fb(comp, uncomp_packet, rohc_packet, NULL,
+	                                   NULL);
+	comp->hdrs_info = NULL;
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "number of Optimistic Approach repetitions set to %u",
-	          comp->oa_repetitions_nr);
+	return status;
 
-	return true;
+error:
+	return ROHC_STATUS_ERROR;
 }
 
 
 /**
- * @brief Set the window width for the W-LSB encoding scheme
+ * @brief Compress a burst of uncompressed packets into ROHC packets
  *
- * Set the window width for the Window-based Least Significant Bits (W-LSB)
- * encoding. See section 4.5.2 of RFC 3095 for more details about the encoding
- * scheme.
+ * Compress the given uncompressed packets into ROHC packets, one after the
+ * other, as \ref rohc_compress4 would do for every single packet. The status
+ * of every packet is stored in the \e statuses array.
  *
- * The width of the W-LSB window is set to 4 by default.
+ * Compressing a burst of packets is cheaper than calling \ref rohc_compress4
+ * for every packet: the compressor is checked only once per burst and the
+ * headers of the next packet are prefetched while the current packet is
+ * compressed.
  *
- * @warning The value can not be modified after library initialization
+ * The ROHC compressor holds only one Reconstructed Reception Unit (RRU) at a
+ * time, so the compression of the burst stops with the first packet that
+ * requires ROHC segmentation (status \ref ROHC_STATUS_SEGMENT). Retrieve the
+ * ROHC segments with \ref rohc_comp_get_segment2, then call the function
+ * again for the remaining packets of the burst.
  *
- * @param comp   The ROHC compressor
- * @param width  The width of the W-LSB sliding window
- * @return       true in case of success, false in case of failure
+ * If the compressor is linked with a ring of feedbacks, the feedbacks of the
+ * ring are piggybacked on the ROHC packets as \ref rohc_compress4 does.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_pkts       The uncompressed packets to compress
+ * @param[out] rohc_pkts    The resulting compressed ROHC packets, every buffer
+ *                          shall be empty as for \ref rohc_compress4
+ * @param[out] statuses     The status of every packet, see \ref rohc_compress4
+ *                          for the possible values
+ * @param pkts_nr           The number of packets in the burst
+ * @return                  The number of packets that were processed, ie. the
+ *                          number of valid entries in \e statuses
  *
  * @ingroup rohc_comp
  *
- * @deprecated please use rohc_comp_set_optimistic_approach() instead
+ * @see rohc_compress4
+ * @see rohc_comp_get_segment2
  */
-bool rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
-                                     const size_t width)
+size_t rohc_compress_burst(struct rohc_comp *const comp,
+                           const struct rohc_buf *const uncomp_pkts,
+                           struct rohc_buf *const rohc_pkts,
+                           rohc_status_t *const statuses,
+                           const size_t pkts_nr)
 {
-	/* fallback on the new function */
-	return rohc_comp_set_optimistic_approach(comp, width);
+	return rohc_compress_burst2(comp, uncomp_pkts, rohc_pkts, statuses, NULL,
+	                            pkts_nr);
 }
 
 
 /**
- * @brief Set the reordering ratio for the W-LSB encoding scheme
+ * @brief Compress a burst of uncompressed packets and report about them
  *
- * The control field reorder_ratio specifies how much reordering is
- * handled by the W-LSB encoding of the MSN in ROHCv2 profiles.
- *
- * The reordering ration is set to ROHC_REORDERING_NONE by default.
+ * Compress the given uncompressed packets as \ref rohc_compress_burst does,
+ * and fill the \e infos array with some information about every packet at
+ * the same time, as \ref rohc_compress5 does for one single packet.
  *
- * @param comp           The ROHC compressor
- * @param reorder_ratio  The reordering ratio
- * @return               true in case of success,
- *                       false in case of failure
+ * @param comp              The ROHC compressor
+ * @param uncomp_pkts       The uncompressed packets to compress
+ * @param[out] rohc_pkts    The resulting compressed ROHC packets, see
+ *                          \ref rohc_compress_burst
+ * @param[out] statuses     The status of every packet, see \ref rohc_compress4
+ *                          for the possible values
+ * @param[out] infos        The information about every packet, filled only
+ *                          for the packets with status \ref ROHC_STATUS_OK
+ *                          or \ref ROHC_STATUS_SEGMENT, may be NULL
+ * @param pkts_nr           The number of packets in the burst
+ * @return                  The number of packets that were processed, ie. the
+ *                          number of valid entries in \e statuses
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_compress_burst
+ * @see rohc_compress5
  */
-bool rohc_comp_set_reorder_ratio(struct rohc_comp *const comp,
-                                 const rohc_reordering_offset_t reorder_ratio)
+size_t rohc_compress_burst2(struct rohc_comp *const comp,
+                            const struct rohc_buf *const uncomp_pkts,
+                            struct rohc_buf *const rohc_pkts,
+                            rohc_status_t *const statuses,
+                            struct rohc_comp_pkt_info *const infos,
+                            const size_t pkts_nr)
 {
-	/* we need a valid compressor */
+	size_t i;
+
+	/* check inputs validity */
 	if(comp == NULL)
 	{
-		return false;
+		goto error;
 	}
-
-	/* Check value of reorder ratio */
-	if(reorder_ratio != ROHC_REORDERING_NONE &&
-	   reorder_ratio != ROHC_REORDERING_QUARTER &&
-	   reorder_ratio != ROHC_REORDERING_HALF &&
-	   reorder_ratio != ROHC_REORDERING_THREEQUARTERS)
+	if(uncomp_pkts == NULL || rohc_pkts == NULL || statuses == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
-		             "set reorder ratio to %u: reorder ratio must be in range "
-		             "[%u;%u]", reorder_ratio, ROHC_REORDERING_NONE,
-		             ROHC_REORDERING_THREEQUARTERS);
-		return false;
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given packets or statuses are NULL");
+		goto error;
 	}
 
-	/* refuse to set a value if compressor is in use */
-	if(comp->num_packets > 0)
+	for(i = 0; i < pkts_nr; i++)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
-		             "modify reorder ratio after initialization");
-		return false;
-	}
+		/* fetch the headers of the next packet while the current one is
+		 * compressed */
+		if((i + 1) < pkts_nr)
+		{
+			__builtin_prefetch(rohc_buf_data(uncomp_pkts[i + 1]));
+		}
 
-	comp->reorder_ratio = reorder_ratio;
+		statuses[i] = rohc_comp_compress_pkt_fb(comp, uncomp_pkts[i],
+		                                        &rohc_pkts[i], NULL,
+		                                        (infos != NULL ? &infos[i] : NULL));
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "Reorder ratio set to %u", reorder_ratio);
+		/* only one RRU may be stored at a time */
+		if(statuses[i] == ROHC_STATUS_SEGMENT)
+		{
+			i++;
+			break;
+		}
+	}
 
-	return true;
+	return i;
+
+error:
+	return 0;
 }
 
 
 /**
- * @brief Set the timeouts in packets for IR and FO periodic refreshes
- *
- * Set the timeout values for IR and FO periodic refreshes. The IR timeout
- * shall be greater than the FO timeout. Both timeouts are expressed in
- * number of compressed packets.
- *
- * The IR timeout is set to \ref CHANGE_TO_IR_COUNT by default.
- * The FO timeout is set to \ref CHANGE_TO_FO_COUNT by default.
+ * @brief Prefetch the context of the given packet before compressing it
+ *
+ * The profile and the fingerprint of the uncompressed packet are computed as
+ * the compressor does, then the memory that the lookup of its context will
+ * read is prefetched into the CPU caches. Nothing else of the compressor is
+ * modified, and the function does nothing for the packets that no enabled
+ * profile may compress.
+ *
+ * The function is intended for the applications that compress one packet at
+ * a time and cannot use \ref rohc_compress_burst2: calling it for the packet
+ * i+2 before compressing the packet i hides the cache misses on the contexts
+ * that dominate when many flows share the compressor.
+ *
+ * The lookup is pipelined over the calls, so that no call waits for the
+ * memory it prefetches:
+ *  - the candidate context of the cache of the last flows, or of the index
+ *    of ESP contexts by SPI, and the slot of the hash table are prefetched
+ *    for the given packet,
+ *  - the context in the slot of the hash table prefetched by the previous
+ *    call is prefetched,
+ *  - the profile-specific parts of the contexts prefetched by the previous
+ *    call are prefetched.
+ * So the whole context of one packet is in the CPU caches after two more
+ * calls, whatever the packets given to them.
+ *
+ * The function shall be called from the thread that compresses the packets.
  *
- * @warning The values can not be modified after library initialization
- *
- * @param comp        The ROHC compressor
- * @param ir_timeout  The number of packets to compress before going back
- *                    to IR state to force a context refresh
- * @param fo_timeout  The number of packets to compress before going back
- *                    to FO state to force a context refresh
- * @return            true in case of success, false in case of failure
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet that will be compressed later
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_compress_burst2
  */
-bool rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
-                                      const size_t ir_timeout,
-                                      const size_t fo_timeout)
+void rohc_comp_prefetch(struct rohc_comp *const comp,
+                        const struct rohc_buf uncomp_packet)
 {
-	/* we need a valid compressor, positive non-zero timeouts,
-	 * and IR timeout > FO timeout */
+	const struct hashtable *ht;
+	struct rohc_fingerprint fingerprint;
+	struct rohc_pkt_hdrs pkt_hdrs;
+	rohc_profile_t profile_id;
+	size_t i;
+
 	if(comp == NULL)
 	{
-		return false;
+		return;
 	}
-	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	ht = &comp->contexts_by_fingerprint;
+
+	/* the contexts prefetched by the previous call are now in the CPU caches,
+	 * so their profile-specific parts may be prefetched without waiting */
+	for(i = 0; i < comp->prefetch.ctxts_nr; i++)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
-		             "timeouts for context periodic refreshes (IR timeout = %zd, "
-		             "FO timeout = %zd)", ir_timeout, fo_timeout);
-		return false;
+		const struct rohc_comp_ctxt *const ctxt = comp->prefetch.ctxts[i];
+
+		if(ctxt->used && ctxt->specific != NULL)
+		{
+			__builtin_prefetch(ctxt->specific);
+			__builtin_prefetch(((const uint8_t *) ctxt->specific) + 64);
+		}
 	}
+	comp->prefetch.ctxts_nr = 0;
 
-	/* refuse to set values if compressor is in use */
-	if(comp->num_packets > 0)
+	/* the slot of the hash table prefetched by the previous call is now in
+	 * the CPU caches too, prefetch the context it references */
+	if(comp->prefetch.has_hash)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unable to modify the timeouts for periodic refreshes "
-		             "after initialization");
-		return false;
+		const struct hashtable_slot *const slot =
+			&ht->slots[comp->prefetch.hash & ht->mask];
+
+		if(slot->elem != NULL && slot->hash == comp->prefetch.hash)
+		{
+			__builtin_prefetch(slot->elem);
+			__builtin_prefetch(((const uint8_t *) slot->elem) + 64);
+			comp->prefetch.ctxts[comp->prefetch.ctxts_nr] = slot->elem;
+			comp->prefetch.ctxts_nr++;
+		}
+		comp->prefetch.has_hash = false;
 	}
 
-	comp->periodic_refreshes_ir_timeout_pkts = ir_timeout;
-	comp->periodic_refreshes_fo_timeout_pkts = fo_timeout;
+	/* start the lookup of the context of the given packet */
+	if(rohc_buf_is_malformed(uncomp_packet) || rohc_buf_is_empty(uncomp_packet))
+	{
+		return;
+	}
+	profile_id = rohc_comp_get_profile(comp, &uncomp_packet, &fingerprint,
+	                                   &pkt_hdrs, NULL);
+	if(profile_id == ROHC_PROFILE_MAX)
+	{
+		return;
+	}
+	if(profile_id == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		if(comp->uncompressed_ctxt != NULL)
+		{
+			__builtin_prefetch(comp->uncompressed_ctxt);
+		}
+	}
+	else
+	{
+		const struct rohc_comp_ctxt *candidate;
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
-	          "context periodic refreshes set to %zd", ir_timeout);
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
-	          "context periodic refreshes set to %zd", fo_timeout);
+		if(rohc_comp_profile_is_esp(profile_id))
+		{
+			candidate = comp->esp_by_spi[c_esp_spi_idx(fingerprint.esp_spi)];
+		}
+		else
+		{
+			candidate = comp->flows_cache[c_flows_cache_idx(&fingerprint)];
+		}
+		if(candidate != NULL)
+		{
+			__builtin_prefetch(candidate);
+			__builtin_prefetch(((const uint8_t *) candidate) + 64);
+			comp->prefetch.ctxts[comp->prefetch.ctxts_nr] = candidate;
+			comp->prefetch.ctxts_nr++;
+		}
 
-	return true;
+		/* the candidate may belong to another flow, so prefetch the slot of
+		 * the hash table too ; the next call reads it */
+		comp->prefetch.hash =
+			hashtable_hash(ht, &fingerprint, rohc_fingerprint_len(&fingerprint));
+		comp->prefetch.has_hash = true;
+		__builtin_prefetch(&ht->slots[comp->prefetch.hash & ht->mask]);
+	}
 }
 
 
 /**
- * @brief Set the timeouts in ms for IR and FO periodic refreshes
- *
- * Set the timeout values for IR and FO periodic refreshes. The IR timeout
- * shall be greater than the FO timeout. Both timeouts are expressed in
- * milliseconds.
- *
- * The IR timeout is set to \ref CHANGE_TO_IR_TIME by default.
- * The FO timeout is set to \ref CHANGE_TO_FO_TIME by default.
- *
- * @warning The values can not be modified after library initialization
- *
- * @param comp        The ROHC compressor
- * @param ir_timeout  The delay (in ms) before going back to IR state
- *                    to force a context refresh
- * @param fo_timeout  The delay (in ms) before going back to FO state
- *                    to force a context refresh
- * @return            true in case of success, false in case of failure
+ * @brief Compress one TSO/GSO super-packet into several ROHC packets
+ *
+ * The super-packet is one IP/TCP or IP/UDP packet whose payload is larger
+ * than the MTU, as built by a host stack that offloads the segmentation to
+ * the network device (TCP Segmentation Offload or Generic Segmentation
+ * Offload). The payload is split into segments of \e gso_size bytes, the last
+ * segment may be shorter, and every segment is compressed into one ROHC
+ * packet as if the host stack had built it with the headers of the
+ * super-packet:
+ *  - the Total Length of the IPv4 headers and the Payload Length of the IPv6
+ *    headers are the ones of the segment,
+ *  - the IP-ID of the IPv4 headers is incremented by one for every segment,
+ *  - the TCP sequence number is advanced by the payload of the previous
+ *    segments, the FIN and PSH flags are kept for the last segment only and
+ *    the CWR flag for the first segment only,
+ *  - the UDP length is the one of the segment,
+ *  - the TCP and UDP checksums are computed for every segment, except the
+ *    zero UDP checksums of IPv4 packets that stay zero,
+ *  - the IPv4 header checksums are computed for every segment.
+ * So the checksums of the super-packet may be partial ones, eg. those of the
+ * packets with checksum offload.
+ *
+ * The super-packet is classified and its context is looked up only once, then
+ * only the headers of the segments are encoded. The payload of every segment
+ * is copied behind its ROHC header. The super-packet shall be compressed by
+ * the IP/TCP profile or by one of the IP/UDP profiles.
+ *
+ * Every ROHC packet shall be empty and have room for the headers of the
+ * super-packet, one segment of \e gso_size bytes, and 64 bytes more of ROHC
+ * overhead: the ROHC packets are never segmented with ROHC segmentation.
+ *
+ * If the compressor is linked with a ring of feedbacks, the feedbacks of the
+ * ring are piggybacked on the ROHC packets as \ref rohc_compress4 does.
+ *
+ * The compression stops at the first segment that fails to be compressed.
+ * The ROHC packets of the segments compressed before were already accounted
+ * in the compression contexts, so they shall be transmitted anyway.
+ *
+ * @param comp               The ROHC compressor
+ * @param super_pkt          The super-packet to compress
+ * @param gso_size           The length of the payload of every segment
+ * @param[out] rohc_pkts     The resulting ROHC packets, one per segment
+ * @param rohc_pkts_max      The number of buffers in \e rohc_pkts
+ * @param[out] rohc_pkts_nr  The number of ROHC packets returned
+ * @return                   Possible return values:
+ *                           \li \ref ROHC_STATUS_OK if all the segments
+ *                               were compressed
+ *                           \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if there
+ *                               are more segments than ROHC packets, then no
+ *                               segment is compressed, or if one ROHC packet
+ *                               is too small for its segment
+ *                           \li \ref ROHC_STATUS_NO_MEMORY if no context
+ *                               could be created within the memory budget
+ *                               set by \ref rohc_comp_set_mem_budget
+ *                           \li \ref ROHC_STATUS_ERROR if an error occurred,
+ *                               eg. if the super-packet is not supported
  *
  * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_compress_burst
  */
-bool rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const comp,
-                                           const uint64_t ir_timeout,
-                                           const uint64_t fo_timeout)
+rohc_status_t rohc_compress_gso(struct rohc_comp *const comp,
+                                const struct rohc_buf super_pkt,
+                                const size_t gso_size,
+                                struct rohc_buf *const rohc_pkts,
+                                const size_t rohc_pkts_max,
+                                size_t *const rohc_pkts_nr)
 {
-	/* we need a valid compressor, positive non-zero timeouts,
-	 * and IR timeout > FO timeout */
+	const struct rohc_comp_profile *profile;
+	struct rohc_fingerprint fingerprint;
+	struct rohc_pkt_hdrs pkt_hdrs;
+	struct rohc_perf_clock perf_clock;
+	struct rohc_comp_ctxt *c;
+	rohc_profile_t profile_id;
+	const uint8_t *super_payload;
+	size_t super_payload_len;
+	size_t mem_refused_nr;
+	size_t segs_nr;
+	size_t i;
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+
+	/* check inputs validity */
 	if(comp == NULL)
 	{
-		return false;
+		goto error;
 	}
-	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	if(rohc_pkts_nr == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "invalid timeouts for context periodic refreshes "
-		             "(IR timeout = %" PRIu64 " ms, FO timeout = %" PRIu64 " ms)",
-		             ir_timeout, fo_timeout);
-		return false;
+		             "given rohc_pkts_nr is NULL");
+		goto error;
 	}
-
-	/* refuse to set values if compressor is in use */
-	if(comp->num_packets > 0)
+	*rohc_pkts_nr = 0;
+	if(rohc_buf_is_malformed(super_pkt) || rohc_buf_is_empty(super_pkt))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unable to modify the timeouts for periodic refreshes "
-		             "after initialization");
-		return false;
+		             "given super-packet is malformed or empty");
+		goto error;
+	}
+	if(rohc_pkts == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_pkts is NULL");
+		goto error;
+	}
+	if(gso_size == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment size is zero");
+		goto error;
 	}
 
-	comp->periodic_refreshes_ir_timeout_time = ir_timeout;
-	comp->periodic_refreshes_fo_timeout_time = fo_timeout;
-
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
-	          "context periodic refreshes set to %" PRIu64 " ms", ir_timeout);
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
-	          "context periodic refreshes set to %" PRIu64 " ms", fo_timeout);
-
-	return true;
-}
+	rohc_perf_start(&perf_clock,
+	                !!((comp->features & ROHC_COMP_FEATURE_PERF_INFO) != 0));
 
+	/* classify the super-packet once for all its segments */
+	memset(&pkt_hdrs, 0, sizeof(struct rohc_pkt_hdrs));
+	profile_id = rohc_comp_get_profile(comp, &super_pkt, &fingerprint, &pkt_hdrs,
+	                                   comp->rtp_verdicts);
+	if(profile_id != ROHCv1_PROFILE_IP_TCP &&
+	   profile_id != ROHCv1_PROFILE_IP_UDP &&
+	   profile_id != ROHCv2_PROFILE_IP_UDP)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "super-packets shall be compressed by the IP/TCP or IP/UDP "
+		             "profiles, not by profile '%s' (0x%04x)",
+		             rohc_get_profile_descr(profile_id), profile_id);
+		goto error;
+	}
+	{
+		const uint8_t profile_major = (profile_id >> 8) & 0xff;
+		const uint8_t profile_minor = profile_id & 0xff;
+		profile = rohc_comp_profiles[profile_major][profile_minor];
+		if(profile == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "profile '%s' (0x%04x) is not implemented yet",
+			             rohc_get_profile_descr(profile_id), profile_id);
+			goto error;
+		}
+	}
+	rohc_perf_lap(&perf_clock, &comp->perf_histos[ROHC_COMP_PERF_CLASSIFY]);
 
-/**
- * @brief Set the number of uncompressed transmissions for list compression
- *
- * Set the number of transmissions required for list compression. This matches
- * the L parameter described in RFC 3095 and 4815. The compressor sends the
- * list items uncompressed L times before compressing them. The compressor
- * also sends the list structure L times before compressing it out.
+	/* how many segments? */
+	super_payload = pkt_hdrs.payload;
+	super_payload_len = pkt_hdrs.payload_len;
+	if(super_payload_len == 0)
+	{
+		segs_nr = 1;
+	}
+	else
+	{
+		segs_nr = (super_payload_len + gso_size - 1) / gso_size;
+	}
+	if(segs_nr > rohc_pkts_max)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "%zu segments of %zu bytes in the %zu-byte payload of the "
+		             "super-packet, but only %zu ROHC packets", segs_nr, gso_size,
+		             super_payload_len, rohc_pkts_max);
+		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+		goto error;
+	}
+	if(profile_id == ROHCv1_PROFILE_IP_TCP && segs_nr > 1 &&
+	   (pkt_hdrs.tcp->rsf_flags & (RSF_SYN_ONLY | RSF_RST_ONLY)) != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "TCP super-packets with the SYN or RST flag cannot be "
+		             "segmented");
+		goto error;
+	}
+
+	/* find the context of the super-packet once for all its segments */
+	mem_refused_nr = comp->mempool.refused_nr;
+	c = rohc_comp_find_ctxt(comp, profile, &super_pkt, &fingerprint, &pkt_hdrs,
+	                        false);
+	if(c == NULL)
+	{
+		if(comp->mempool.refused_nr != mem_refused_nr)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create a new context within the memory "
+			             "budget of %zu bytes", comp->mempool.budget);
+			status = ROHC_STATUS_NO_MEMORY;
+			goto error;
+		}
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to find a matching context or to create a new "
+		             "context");
+		goto error;
+	}
+	rohc_perf_lap(&perf_clock, &comp->perf_histos[ROHC_COMP_PERF_FIND_CTXT]);
+
+	/* the headers of the segments are built in the compressor */
+	if(!rohc_comp_gso_rebase_hdrs(comp, super_pkt, &pkt_hdrs))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "%zu-byte headers of super-packet too long, %u bytes max",
+		             pkt_hdrs.all_hdrs_len, ROHC_COMP_GSO_HDRS_MAX_LEN);
+		goto error;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "compress the %zu-byte payload of the super-packet in %zu "
+	           "segments of %zu bytes", super_payload_len, segs_nr, gso_size);
+
+	for(i = 0; i < segs_nr; i++)
+	{
+		const size_t seg_off = i * gso_size;
+		const size_t seg_len =
+			rohc_min(gso_size, super_payload_len - seg_off);
+		struct rohc_buf *const rohc_pkt = &rohc_pkts[i];
+
+		if(rohc_buf_is_malformed(*rohc_pkt) || !rohc_buf_is_empty(*rohc_pkt))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "ROHC packet #%zu is malformed or not empty", i + 1);
+			status = ROHC_STATUS_ERROR;
+			break;
+		}
+		if(rohc_buf_avail_len(*rohc_pkt) <
+		   (pkt_hdrs.all_hdrs_len + seg_len + ROHC_COMP_FEEDBACK_SLACK))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "ROHC packet #%zu is too small for the segment: %zu "
+			             "bytes available, %zu bytes required", i + 1,
+			             rohc_buf_avail_len(*rohc_pkt), pkt_hdrs.all_hdrs_len +
+			             seg_len + ROHC_COMP_FEEDBACK_SLACK);
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			break;
+		}
+		if(i > 0)
+		{
+			rohc_perf_start(&perf_clock,
+			                !!((comp->features & ROHC_COMP_FEATURE_PERF_INFO) != 0));
+		}
+
+		rohc_comp_gso_build_seg(comp, super_pkt, super_payload, super_payload_len,
+		                        i, seg_off, seg_len, (i + 1) == segs_nr, &pkt_hdrs);
+
+		status = rohc_comp_encode_pkt(comp, c, &pkt_hdrs, super_pkt.time,
+		                              pkt_hdrs.all_hdrs_len + seg_len, rohc_pkt,
+		                              NULL, false, NULL, &perf_clock);
+		if(status != ROHC_STATUS_OK)
+		{
+			break;
+		}
+		if(comp->feedback_ring != NULL)
+		{
+			rohc_comp_piggyback_feedbacks(comp, rohc_pkt);
+		}
+		(*rohc_pkts_nr)++;
+	}
+
+	return status;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Compress one packet once for many broadcast channels
+ *
+ * On broadcast links, the same flows are sent to many groups of receivers,
+ * every group being one ROHC channel with the same configuration. The
+ * compressor shall run in broadcast mode, see
+ * \ref ROHC_COMP_FEATURE_BROADCAST: its contexts stay in U-mode and its
+ * refreshes do not depend on any receiver, so the ROHC packet is valid on
+ * every channel. The packet is compressed once in the first ROHC packet,
+ * then copied in the other ones.
+ *
+ * The channels may give other CIDs to the contexts of the compressor: the
+ * CID used on every channel is then read in \e cid_maps, that holds
+ * \e channels_nr tables of MAX_CID + 1 CIDs, one table per channel, indexed
+ * by the CIDs of the compressor. The CIDs shall be of the CID type of the
+ * compressor, and no larger than its MAX_CID. The CRC of the IR, IR-DYN and
+ * IR-CR headers covers the CID, it is computed again for every channel that
+ * changes the CID.
+ *
+ * Every ROHC packet shall be empty and large enough for the whole ROHC
+ * packet, no feedback is piggybacked and ROHC segmentation is not used.
+ *
+ * @param comp              The ROHC compressor, in broadcast mode
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param cid_maps          The CIDs of the contexts on every channel,
+ *                          NULL to use the CIDs of the compressor
+ * @param[out] rohc_pkts    The resulting ROHC packets, one per channel
+ * @param channels_nr       The number of channels, ie. of buffers in
+ *                          \e rohc_pkts
+ * @param[out] info         The information about the compressed packet to
+ *                          fill if compression is successful, may be NULL
+ * @return                  Possible return values:
+ *                          \li \ref ROHC_STATUS_OK if the packet was
+ *                              compressed for all the channels
+ *                          \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if one ROHC
+ *                              packet is too small for the packet
+ *                          \li \ref ROHC_STATUS_NO_MEMORY if no context
+ *                              could be created within the memory budget
+ *                              set by \ref rohc_comp_set_mem_budget
+ *                          \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress5
+ */
+rohc_status_t rohc_compress_broadcast(struct rohc_comp *const comp,
+                                      const struct rohc_buf uncomp_packet,
+                                      const rohc_cid_t *const cid_maps,
+                                      struct rohc_buf *const rohc_pkts,
+                                      const size_t channels_nr,
+                                      struct rohc_comp_pkt_info *const info)
+{
+	struct rohc_comp_pkt_info pkt_info;
+	size_t i;
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+
+	/* check inputs validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if((comp->features & ROHC_COMP_FEATURE_BROADCAST) == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "compressor is not in broadcast mode");
+		goto error;
+	}
+	if(rohc_pkts == NULL || channels_nr == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_pkts is NULL or empty");
+		goto error;
+	}
+	for(i = 0; i < channels_nr; i++)
+	{
+		if(rohc_buf_is_malformed(rohc_pkts[i]) || !rohc_buf_is_empty(rohc_pkts[i]))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "given ROHC packet #%zu is malformed or not empty", i);
+			goto error;
+		}
+	}
+
+	/* compress the packet once */
+	status = rohc_comp_compress_pkt(comp, uncomp_packet, &rohc_pkts[0], NULL,
+	                                false, &pkt_info);
+	if(status == ROHC_STATUS_SEGMENT)
+	{
+		/* the RRU is not shared among the channels */
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "ROHC packet #0 is too small for the %zu-byte packet, ROHC "
+		             "segmentation is not used for broadcast channels",
+		             uncomp_packet.len);
+		comp->rru_len = 0;
+		comp->rru_off = 0;
+		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+		goto error;
+	}
+	else if(status != ROHC_STATUS_OK)
+	{
+		goto error;
+	}
+
+	/* copy it for the other channels, the first channel is handled last
+	 * since its packet is the one copied */
+	for(i = channels_nr; i > 0; i--)
+	{
+		struct rohc_buf *const rohc_pkt = &rohc_pkts[i - 1];
+
+		if((i - 1) > 0)
+		{
+			if(rohc_buf_avail_len(*rohc_pkt) < rohc_pkts[0].len)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "ROHC packet #%zu is too small for the %zu-byte ROHC "
+				             "packet", i - 1, rohc_pkts[0].len);
+				status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+				goto error;
+			}
+			rohc_buf_append_buf(rohc_pkt, rohc_pkts[0]);
+		}
+		if(cid_maps != NULL)
+		{
+			const rohc_cid_t cid =
+				cid_maps[(i - 1) * (comp->medium.max_cid + 1) + pkt_info.cid];
+
+			status = rohc_comp_remap_cid(comp, rohc_pkt, &pkt_info, cid);
+			if(status != ROHC_STATUS_OK)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to give CID %u to the ROHC packet of channel "
+				             "#%zu", cid, i - 1);
+				goto error;
+			}
+		}
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "%zu-byte ROHC packet given to %zu channels", rohc_pkts[0].len,
+	           channels_nr);
+
+	if(info != NULL)
+	{
+		memcpy(info, &pkt_info, sizeof(struct rohc_comp_pkt_info));
+	}
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Give another CID to one ROHC packet built by the compressor
+ *
+ * The ROHC packet shall hold no feedback and shall not be a ROHC segment.
+ * The CID field is rewritten in place, the rest of the packet is moved if
+ * the new CID field is shorter or longer than the previous one. The CRC of
+ * the IR, IR-DYN and IR-CR headers covers the CID, so it is computed again.
+ *
+ * @param comp              The ROHC compressor
+ * @param[in,out] rohc_packet  The ROHC packet to change
+ * @param info              The information about the ROHC packet
+ * @param cid               The new CID of the ROHC packet
+ * @return                  \ref ROHC_STATUS_OK if the CID was changed,
+ *                          \ref ROHC_STATUS_OUTPUT_TOO_SMALL if there is no
+ *                          room for a longer CID field,
+ *                          \ref ROHC_STATUS_ERROR if the CID is invalid
+ */
+static rohc_status_t rohc_comp_remap_cid(const struct rohc_comp *const comp,
+                                         struct rohc_buf *const rohc_packet,
+                                         const struct rohc_comp_pkt_info *const info,
+                                         const rohc_cid_t cid)
+{
+	const bool is_small_cid = (comp->medium.cid_type == ROHC_SMALL_CID);
+	/* the Add-CID is the first byte, the large CID follows the first byte */
+	const size_t cid_off = (is_small_cid ? 0 : 1);
+	uint8_t cid_field[2];
+	size_t old_cid_len;
+	size_t new_cid_len;
+	uint8_t *const pkt = rohc_buf_data(*rohc_packet);
+
+	if(cid == info->cid)
+	{
+		return ROHC_STATUS_OK;
+	}
+	if(cid > comp->medium.max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "CID %u is greater than MAX_CID %u", cid, comp->medium.max_cid);
+		goto error;
+	}
+
+	/* build the new CID field */
+	if(is_small_cid)
+	{
+		old_cid_len = (info->cid == 0 ? 0 : 1);
+		new_cid_len = (cid == 0 ? 0 : 1);
+		cid_field[0] = 0xe0 | (cid & 0x0f);
+	}
+	else
+	{
+		old_cid_len = sdvl_get_encoded_len(info->cid);
+		if(!sdvl_encode_full(cid_field, 2, &new_cid_len, cid))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to SDVL-encode large CID %u", cid);
+			goto error;
+		}
+	}
+	assert(rohc_packet->len >= (cid_off + old_cid_len));
+
+	/* move the rest of the packet if the CID field changes its length */
+	if(new_cid_len > old_cid_len &&
+	   rohc_buf_avail_len(*rohc_packet) < (rohc_packet->len + new_cid_len - old_cid_len))
+	{
+		goto error_too_small;
+	}
+	if(new_cid_len != old_cid_len)
+	{
+		memmove(pkt + cid_off + new_cid_len, pkt + cid_off + old_cid_len,
+		        rohc_packet->len - cid_off - old_cid_len);
+		rohc_packet->len = rohc_packet->len + new_cid_len - old_cid_len;
+	}
+	memcpy(pkt + cid_off, cid_field, new_cid_len);
+
+	/* the CRC of the IR, IR-DYN and IR-CR headers covers the CID field */
+	if(info->packet_type == ROHC_PACKET_IR ||
+	   info->packet_type == ROHC_PACKET_IR_DYN ||
+	   info->packet_type == ROHC_PACKET_IR_CR)
+	{
+		/* optional Add-CID + packet type + optional large CID + profile ID */
+		const size_t crc_pos = new_cid_len + 2;
+		const size_t hdr_len = info->hdr_len + new_cid_len - old_cid_len;
+
+		assert(hdr_len > crc_pos);
+		pkt[crc_pos] = 0;
+		if(info->profile_id == ROHCv1_PROFILE_UNCOMPRESSED)
+		{
+			/* the CRC of the Uncompressed profile stops before its field */
+			pkt[crc_pos] = crc_engine_calc(&comp->crc_engine,
+			                               ROHC_CRC_TYPE_8, pkt, crc_pos, CRC_INIT_8);
+		}
+		else
+		{
+			pkt[crc_pos] = crc_engine_calc(&comp->crc_engine,
+			                               ROHC_CRC_TYPE_8, pkt, hdr_len, CRC_INIT_8);
+		}
+	}
+
+	return ROHC_STATUS_OK;
+
+error_too_small:
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress one packet and piggyback feedbacks in the same pass
+ *
+ * The feedbacks are written at the beginning of the output buffer, then the
+ * ROHC packet is compressed behind them. There shall be room in the output
+ * buffer for the feedbacks and for a ROHC packet as large as the uncompressed
+ * packet plus \ref ROHC_COMP_FEEDBACK_SLACK bytes, so that the feedbacks
+ * never cause the segmentation of the ROHC packet. The feedbacks consumed
+ * from the ring are given back to the ring only if the packet is compressed.
+ * The feedbacks of the ring that did not fit are piggybacked afterwards by
+ * \ref rohc_comp_piggyback_feedbacks.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @param[in,out] feedbacks The feedbacks to piggyback all at once, emptied
+ *                          once piggybacked, may be NULL
+ * @param[out] info         The information about the compressed packet to
+ *                          fill if compression is successful, may be NULL
+ * @return                  The same status values as \ref rohc_compress4
+ */
+static rohc_status_t rohc_comp_compress_pkt_fb(struct rohc_comp *const comp,
+                                               const struct rohc_buf uncomp_packet,
+                                               struct rohc_buf *const rohc_packet,
+                                               struct rohc_buf *const feedbacks,
+                                               struct rohc_comp_pkt_info *const info)
+{
+	size_t feedbacks_room = 0;
+	size_t feedbacks_len = 0;
+	size_t slots_nr = 0;
+	bool with_feedbacks = false;
+	rohc_status_t status;
+
+	if((feedbacks == NULL || feedbacks->len == 0) && comp->feedback_ring == NULL)
+	{
+		return rohc_comp_compress_pkt(comp, uncomp_packet, rohc_packet, NULL,
+		                              false, info);
+	}
+
+	/* how many bytes of feedbacks may be written before the ROHC packet? */
+	if(rohc_packet != NULL && !rohc_buf_is_malformed(*rohc_packet) &&
+	   rohc_buf_is_empty(*rohc_packet) &&
+	   rohc_buf_avail_len(*rohc_packet) >
+	   (uncomp_packet.len + ROHC_COMP_FEEDBACK_SLACK))
+	{
+		feedbacks_room = rohc_buf_avail_len(*rohc_packet) -
+		                 uncomp_packet.len - ROHC_COMP_FEEDBACK_SLACK;
+	}
+
+	/* write the feedbacks, then hide them while the packet is compressed */
+	if(feedbacks != NULL && feedbacks->len > 0 &&
+	   feedbacks->len <= feedbacks_room)
+	{
+		rohc_buf_append_buf(rohc_packet, *feedbacks);
+		feedbacks_len += feedbacks->len;
+		with_feedbacks = true;
+	}
+	if(comp->feedback_ring != NULL && feedbacks_room > feedbacks_len)
+	{
+		const size_t ring_len =
+			rohc_comp_collect_feedbacks(comp, rohc_buf_data_at(*rohc_packet,
+			                                                   feedbacks_len),
+			                            feedbacks_room - feedbacks_len, &slots_nr);
+		rohc_packet->len += ring_len;
+		feedbacks_len += ring_len;
+	}
+	if(feedbacks_len > 0)
+	{
+		rohc_buf_pull(rohc_packet, feedbacks_len);
+	}
+
+	status = rohc_comp_compress_pkt(comp, uncomp_packet, rohc_packet, NULL,
+	                                false, info);
+
+	/* unhide the feedbacks if the packet was compressed, forget them
+	 * otherwise, the ring or the caller keeps them for the next packet */
+	if(feedbacks_len > 0)
+	{
+		rohc_buf_push(rohc_packet, feedbacks_len);
+		if(status != ROHC_STATUS_OK)
+		{
+			rohc_packet->len = 0;
+		}
+	}
+	if(status == ROHC_STATUS_OK)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "%zu bytes of feedbacks piggybacked in front of the ROHC "
+		           "packet", feedbacks_len);
+		if(with_feedbacks)
+		{
+			rohc_buf_pull(feedbacks, feedbacks->len);
+		}
+		if(comp->feedback_ring != NULL)
+		{
+			rohc_feedback_ring_release(comp->feedback_ring, slots_nr);
+			rohc_comp_piggyback_feedbacks(comp, rohc_packet);
+		}
+	}
+
+	return status;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet into a ROHC packet
+ *
+ * The statistics of the compressor and of the context are updated once for
+ * the packet.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @param[out] payload      NULL to copy the payload in \e rohc_packet behind
+ *                          the ROHC header, otherwise only the ROHC header is
+ *                          written in \e rohc_packet and the payload is
+ *                          referenced within \e uncomp_packet
+ * @param in_place          Whether the payload stays in place behind the ROHC
+ *                          header, ie. the length of \e rohc_packet limits the
+ *                          ROHC header only and segmentation is never used
+ * @param[out] info         The information about the compressed packet to
+ *                          fill if compression is successful, may be NULL
+ * @return                  The same status values as \ref rohc_compress4
+ */
+static rohc_status_t rohc_comp_compress_pkt(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_packet,
+                                            struct rohc_buf *const payload,
+                                            const bool in_place,
+                                            struct rohc_comp_pkt_info *const info)
+{
+	struct rohc_comp_ctxt *c;
+
+	const struct rohc_comp_profile *profile;
+	rohc_profile_t profile_id;
+
+	struct rohc_fingerprint fingerprint;
+	struct rohc_pkt_hdrs pkt_hdrs;
+
+	struct rohc_perf_clock perf_clock;
+	uint64_t overload_shed_nr;
+	uint64_t warmup_held_nr;
+	size_t mem_refused_nr;
+	rohc_status_t status;
+	const uint64_t start_ns =
+		(comp->overload_step_ns != 0 ? rohc_time_now_ns() : 0);
+
+	rohc_perf_start(&perf_clock,
+	                !!((comp->features & ROHC_COMP_FEATURE_PERF_INFO) != 0));
+
+	/* check inputs validity */
+	if(rohc_buf_is_malformed(uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is empty");
+		goto error;
+	}
+	if(rohc_packet == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is not empty");
+		goto error;
+	}
+
+	/* print uncompressed bytes */
+	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
+		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
+		                 "uncompressed data, max 100 bytes", uncomp_packet);
+	}
+
+	/* what ROHC profile fits the uncompressed packet best? the caches of
+	 * the classification are useless if the user described the headers */
+	if(comp->hdrs_info != NULL)
+	{
+		profile_id = rohc_comp_get_profile(comp, &uncomp_packet, &fingerprint,
+		                                   &pkt_hdrs, NULL);
+	}
+	else
+	{
+		profile_id = rohc_comp_classify(comp, &uncomp_packet, &fingerprint,
+		                                &pkt_hdrs);
+	}
+	if(profile_id == ROHC_PROFILE_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to find a matching profile among the enabled profiles "
+		             "for the uncompressed packet");
+		goto error;
+	}
+
+	/* find the profile identified by the given profile ID */
+	{
+		const uint8_t profile_major = (profile_id >> 8) & 0xff;
+		const uint8_t profile_minor = profile_id & 0xff;
+		profile = rohc_comp_profiles[profile_major][profile_minor];
+		if(profile == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "profile '%s' (0x%04x) is not implemented yet",
+			             rohc_get_profile_descr(profile_id), profile_id);
+			goto error;
+		}
+	}
+	rohc_perf_lap(&perf_clock, &comp->perf_histos[ROHC_COMP_PERF_CLASSIFY]);
+
+	/* the IP-only profiles compress the IPv4 fragments without their
+	 * fragmentation, that is carried behind the ROHC header */
+	if(rohc_comp_ip_frag_len(comp, profile->id) != 0 && pkt_hdrs.ipv4_frag != 0)
+	{
+		rohc_comp_frag_rebase_hdrs(comp, &pkt_hdrs);
+	}
+
+	/* the payload of a chain of buffers goes on behind its first segment */
+	pkt_hdrs.payload_len += comp->chain_tail_len;
+
+	/* find the best profile context for the packet */
+	mem_refused_nr = comp->mempool.refused_nr;
+	overload_shed_nr = comp->num_overload_shed;
+	warmup_held_nr = comp->num_warmup_held;
+	c = rohc_comp_find_ctxt(comp, profile, &uncomp_packet, &fingerprint, &pkt_hdrs,
+	                        true);
+	if(c == NULL && (comp->num_overload_shed != overload_shed_nr ||
+	                 comp->num_warmup_held != warmup_held_nr))
+	{
+		/* the overloaded compressor, or the warm-up of the new flow, refused a
+		 * new context to the flow, send the packet with the Uncompressed
+		 * profile instead */
+		profile = rohc_comp_profiles[0][ROHCv1_PROFILE_UNCOMPRESSED & 0xff];
+		memset(&fingerprint, 0, sizeof(struct rohc_fingerprint));
+		pkt_hdrs.all_hdrs = rohc_buf_data(uncomp_packet);
+		rohc_comp_set_profile_hdrs(&uncomp_packet, rohc_buf_data(uncomp_packet),
+		                           uncomp_packet.len, &pkt_hdrs);
+		pkt_hdrs.payload_len += comp->chain_tail_len;
+		c = rohc_comp_find_ctxt(comp, profile, &uncomp_packet, &fingerprint,
+		                        &pkt_hdrs, false);
+	}
+	if(c == NULL)
+	{
+		if(comp->mempool.refused_nr != mem_refused_nr)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create a new context within the memory "
+			             "budget of %zu bytes", comp->mempool.budget);
+			goto error_no_memory;
+		}
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to find a matching context or to create a new "
+		             "context");
+		goto error;
+	}
+	rohc_perf_lap(&perf_clock, &comp->perf_histos[ROHC_COMP_PERF_FIND_CTXT]);
+
+	/* the payload is referenced within the uncompressed packet */
+	if(payload != NULL)
+	{
+		*payload = uncomp_packet;
+	}
+
+	status = rohc_comp_encode_pkt(comp, c, &pkt_hdrs, uncomp_packet.time,
+	                              uncomp_packet.len + comp->chain_tail_len,
+	                              rohc_packet, payload, in_place, info, &perf_clock);
+	if(status == ROHC_STATUS_OK || status == ROHC_STATUS_SEGMENT)
+	{
+		rohc_comp_bulk_eval(comp, c, &uncomp_packet);
+		if(comp->overload_step_ns != 0)
+		{
+			c_overload_measure(comp, rohc_time_now_ns() - start_ns);
+		}
+	}
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+error_no_memory:
+	return ROHC_STATUS_NO_MEMORY;
+}
+
+
+/**
+ * @brief Encode the given classified packet with the given context
+ *
+ * The headers and the payload of the uncompressed packet are read through
+ * \e pkt_hdrs only, so the headers and the payload may be stored in
+ * different buffers.
+ *
+ * @param comp              The ROHC compressor
+ * @param c                 The compression context found for the packet
+ * @param pkt_hdrs          The information collected about the packet headers
+ * @param arrival_time      The arrival time of the uncompressed packet
+ * @param uncomp_len        The length of the uncompressed packet
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @param[in,out] payload   in: the whole uncompressed packet, out: the
+ *                          payload of the ROHC packet within the memory of
+ *                          the uncompressed packet, may be NULL to copy the
+ *                          payload behind the ROHC header
+ * @param in_place          Whether the ROHC packet shall be built in the
+ *                          memory of the uncompressed packet
+ * @param[out] info         The information about the compressed packet to
+ *                          fill if compression is successful, may be NULL
+ * @param perf_clock        The clock that measures the steps of compression
+ * @return                  The same status values as \ref rohc_compress4
+ */
+static rohc_status_t rohc_comp_encode_pkt(struct rohc_comp *const comp,
+                                          struct rohc_comp_ctxt *const c,
+                                          struct rohc_pkt_hdrs *const pkt_hdrs,
+                                          const struct rohc_ts arrival_time,
+                                          const size_t uncomp_len,
+                                          struct rohc_buf *const rohc_packet,
+                                          struct rohc_buf *const payload,
+                                          const bool in_place,
+                                          struct rohc_comp_pkt_info *const info,
+                                          struct rohc_perf_clock *const perf_clock)
+{
+	const rohc_profile_t profile_id = c->profile->id;
+	const size_t frag_len = rohc_comp_ip_frag_len(comp, profile_id);
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	uint64_t encode_ns;
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+
+	/* create the ROHC packet: */
+	rohc_packet->len = 0;
+
+	/* adapt the Optimistic Approach of the context to the losses */
+	if(comp->oa_repetitions_min != 0)
+	{
+		c_oa_on_send(c);
+	}
+
+	/* adapt the reorder ratio of the context to the reordering */
+	if(comp->reorder_ratio_auto)
+	{
+		c_reorder_on_send(c);
+	}
+
+	/* the IPv4 fragment field is written behind the ROHC header */
+	if(rohc_buf_avail_len(*rohc_packet) < frag_len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "output buffer too small for the IPv4 fragment field");
+		goto error_free_new_context;
+	}
+
+	/* use profile to compress packet */
+	rohc_comp_debug(c, "compress the packet #%" PRIu64, comp->num_packets + 1);
+	rohc_hdr_size =
+		rohc_comp_ctxt_profile(c)->encode(c, pkt_hdrs, arrival_time,
+		                                  rohc_buf_data(*rohc_packet),
+		                                  rohc_buf_avail_len(*rohc_packet) - frag_len,
+		                                  &packet_type);
+	if(rohc_hdr_size < 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "error while compressing with profile '%s' (0x%04x)",
+		             rohc_get_profile_descr(profile_id), profile_id);
+		goto error_free_new_context;
+	}
+	if(frag_len != 0)
+	{
+		const uint16_t ipv4_frag = rohc_hton16(pkt_hdrs->ipv4_frag);
+		memcpy(rohc_buf_data(*rohc_packet) + rohc_hdr_size, &ipv4_frag, frag_len);
+		rohc_hdr_size += frag_len;
+	}
+	rohc_packet->len += rohc_hdr_size;
+	encode_ns =
+		rohc_perf_lap(perf_clock, &comp->perf_histos[ROHC_COMP_PERF_ENCODE]);
+
+	/* the IR headers are accounted against the IR budget of the compressor */
+	if(comp->ir_refresh_budget != 0 &&
+	   (packet_type == ROHC_PACKET_IR || packet_type == ROHC_PACKET_IR_CR))
+	{
+		c_ir_refresh_budget_update(comp, arrival_time);
+		comp->ir_refresh_budget_used += rohc_hdr_size;
+	}
+
+	if(profile_id == ROHCv1_PROFILE_UNCOMPRESSED &&
+	   packet_type == ROHC_PACKET_NORMAL)
+	{
+		pkt_hdrs->all_hdrs_len++;
+		pkt_hdrs->payload++;
+		pkt_hdrs->payload_len--;
+	}
+
+	/* increment the number of packets that were emitted in the current
+	 * compression state */
+	if(c->state_oa_repeat_nr < c->oa_repetitions_nr)
+	{
+		c->state_oa_repeat_nr++;
+		rohc_comp_debug(c, "last change was transmitted %u/%u times",
+		                c->state_oa_repeat_nr, c->oa_repetitions_nr);
+	}
+
+	/* the IR, co_repair and co_common packets of the ROHCv2 profiles carry
+	 * the reorder ratio of the context */
+	if(c->reorder_ratio_trans_nr < comp->oa_repetitions_nr &&
+	   (packet_type == ROHC_PACKET_IR ||
+	    packet_type == ROHC_PACKET_CO_REPAIR ||
+	    packet_type == ROHC_PACKET_CO_COMMON))
+	{
+		c->reorder_ratio_trans_nr++;
+	}
+
+	/* the payload starts after the header, skip it */
+	rohc_buf_pull(rohc_packet, rohc_hdr_size);
+
+	/* is packet too large for output buffer? */
+	if(!in_place && pkt_hdrs->payload_len > rohc_buf_avail_len(*rohc_packet))
+	{
+		const size_t max_rohc_buf_len =
+			rohc_buf_avail_len(*rohc_packet) + rohc_hdr_size;
+		uint32_t rru_crc;
+
+		/* resulting ROHC packet too large, segmentation may be a solution */
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "%s ROHC packet is too large for the given output buffer, "
+		          "try to segment it (input size = %zd, maximum output "
+		          "size = %zd, required output size = %d + %zd = %zd, "
+		          "MRRU = %zd)", rohc_get_packet_descr(packet_type),
+		          uncomp_len, max_rohc_buf_len, rohc_hdr_size,
+		          pkt_hdrs->payload_len, rohc_hdr_size + pkt_hdrs->payload_len,
+		          comp->mrru);
+
+		/* in order to be segmented, a ROHC packet shall be <= MRRU
+		 * (remember that MRRU includes the CRC length) */
+		if((pkt_hdrs->payload_len + CRC_FCS32_LEN) > comp->mrru)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "%s ROHC packet cannot be segmented: too large (%d + "
+			             "%zu + %u = %zu bytes) for MRRU (%zu bytes)",
+			             rohc_get_packet_descr(packet_type), rohc_hdr_size,
+			             pkt_hdrs->payload_len, CRC_FCS32_LEN, rohc_hdr_size +
+			             pkt_hdrs->payload_len + CRC_FCS32_LEN, comp->mrru);
+			goto error_free_new_context;
+		}
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "%s ROHC packet can be segmented (MRRU = %zd)",
+		          rohc_get_packet_descr(packet_type), comp->mrru);
+
+		/* store the whole ROHC packet in compressor (headers and payload only,
+		 * not feedbacks, feedbacks will be transmitted with the first segment
+		 * when rohc_comp_get_segment2() is called) */
+		if(comp->rru_len != 0)
+		{
+			/* warn users about previous, not yet retrieved RRU */
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "erase the existing %zd-byte RRU that was not "
+			             "retrieved yet (call rohc_comp_get_segment2() to add "
+			             "support for ROHC segments in your application)",
+			             comp->rru_len);
+		}
+		comp->rru_len = 0;
+		comp->rru_off = 0;
+		rohc_buf_push(rohc_packet, rohc_hdr_size);
+		if(comp->rru_by_ref)
+		{
+			/* reference the ROHC header and the ROHC payload where they are,
+			 * compute the FCS-32 CRC over both of them on the fly */
+			comp->rru_iov[0].data = rohc_buf_data(*rohc_packet);
+			comp->rru_iov[0].len = rohc_hdr_size;
+			comp->rru_iov[1].data =
+				pkt_hdrs->payload;
+			comp->rru_iov[1].len = pkt_hdrs->payload_len;
+			rru_crc = crc_engine_fcs32(&comp->crc_engine, comp->rru_iov[0].data,
+			                           comp->rru_iov[0].len, CRC_INIT_FCS32);
+			rru_crc = crc_engine_fcs32(&comp->crc_engine, comp->rru_iov[1].data,
+			                           comp->rru_iov[1].len, rru_crc);
+			memcpy(comp->rru_crc, &rru_crc, CRC_FCS32_LEN);
+			comp->rru_iov[2].data = comp->rru_crc;
+			comp->rru_iov[2].len = CRC_FCS32_LEN;
+			comp->rru_iov_nr = 3;
+			comp->rru_len = rohc_hdr_size + pkt_hdrs->payload_len + CRC_FCS32_LEN;
+		}
+		else
+		{
+			/* ROHC header */
+			memcpy(comp->rru + comp->rru_off, rohc_buf_data(*rohc_packet),
+			       rohc_hdr_size);
+			comp->rru_len += rohc_hdr_size;
+			/* ROHC payload */
+			memcpy(comp->rru + comp->rru_off + comp->rru_len,
+			       pkt_hdrs->payload,
+			       pkt_hdrs->payload_len);
+			comp->rru_len += pkt_hdrs->payload_len;
+			/* compute FCS-32 CRC over header and payload (optional feedbacks and
+			   the CRC field itself are excluded) */
+			rru_crc = crc_engine_fcs32(&comp->crc_engine, comp->rru + comp->rru_off,
+			                           comp->rru_len, CRC_INIT_FCS32);
+			memcpy(comp->rru + comp->rru_off + comp->rru_len, &rru_crc,
+			       CRC_FCS32_LEN);
+			comp->rru_len += CRC_FCS32_LEN;
+			comp->rru_iov_nr = 0;
+		}
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "RRU 32-bit FCS CRC = 0x%08x", rohc_ntoh32(rru_crc));
+		/* computed RRU must be <= MRRU */
+		assert(comp->rru_len <= comp->mrru);
+
+		/* reset the length of the ROHC packet: it shall be 0 for users */
+		rohc_packet->len = 0;
+		if(payload != NULL)
+		{
+			payload->len = 0;
+		}
+
+		/* report to users that segmentation is possible */
+		status = ROHC_STATUS_SEGMENT;
+	}
+	else if(payload != NULL)
+	{
+		/* reference the payload within the uncompressed packet */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "reference %zd-byte payload without copy", pkt_hdrs->payload_len);
+		rohc_buf_pull(payload, pkt_hdrs->all_hdrs_len);
+
+		/* unhide the ROHC header */
+		rohc_buf_push(rohc_packet, rohc_hdr_size);
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "ROHC size = %zu bytes (header = %d, payload = %zu), output "
+		           "buffer size = %zu", rohc_packet->len + payload->len,
+		           rohc_hdr_size, payload->len, rohc_buf_avail_len(*rohc_packet));
+
+		/* report to user that compression was successful */
+		status = ROHC_STATUS_OK;
+	}
+	else
+	{
+		/* copy full payload after ROHC header */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "copy full %zd-byte payload", pkt_hdrs->payload_len);
+		rohc_buf_append(rohc_packet,
+		                pkt_hdrs->payload,
+		                pkt_hdrs->payload_len);
+
+		/* unhide the ROHC header */
+		rohc_buf_push(rohc_packet, rohc_hdr_size);
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "ROHC size = %zd bytes (header = %d, payload = %zu), output "
+		           "buffer size = %zu", rohc_packet->len, rohc_hdr_size,
+		           pkt_hdrs->payload_len, rohc_buf_avail_len(*rohc_packet));
+
+		/* report to user that compression was successful */
+		status = ROHC_STATUS_OK;
+	}
+
+	/* update some context and compressor statistics (global + last packet)
+	 * in one single update published to the readers of statistics */
+	rohc_stats_write_begin(&comp->stats_seq);
+
+	c->packet_type = packet_type;
+
+	c->total_uncompressed_size += uncomp_len;
+	c->total_compressed_size += rohc_packet->len;
+	if(payload != NULL)
+	{
+		c->total_compressed_size += payload->len + comp->chain_tail_len;
+	}
+	c->header_uncompressed_size += pkt_hdrs->all_hdrs_len;
+	c->header_compressed_size += rohc_hdr_size;
+	c->num_sent_packets++;
+	c->processing_ns += encode_ns;
+
+	c->total_last_uncompressed_size = uncomp_len;
+	c->total_last_compressed_size = rohc_packet->len;
+	if(payload != NULL)
+	{
+		c->total_last_compressed_size += payload->len + comp->chain_tail_len;
+	}
+	c->header_last_uncompressed_size = pkt_hdrs->all_hdrs_len;
+	c->header_last_compressed_size = rohc_hdr_size;
+	{
+		struct rohc_comp_pkt_stats *const pkt_stats =
+			&comp->pkt_stats[(profile_id >> 8) & 0xff][profile_id & 0xff][packet_type];
+		pkt_stats->packets_nr++;
+		pkt_stats->hdr_bytes_nr += rohc_hdr_size;
+		pkt_stats->uncomp_hdr_bytes_nr += pkt_hdrs->all_hdrs_len;
+	}
+
+	comp->num_packets++;
+	comp->total_uncompressed_size += uncomp_len;
+	comp->total_compressed_size += c->total_last_compressed_size;
+	if(c->is_refreshing)
+	{
+		comp->num_refresh_bytes += rohc_hdr_size;
+	}
+	comp->last_context = c;
+
+	rohc_stats_write_end(&comp->stats_seq);
+
+	if(info != NULL)
+	{
+		info->cid = c->cid;
+		info->profile_id = c->profile->id;
+		info->packet_type = packet_type;
+		info->context_state = c->state;
+		info->context_mode = c->mode;
+		info->is_context_init = (c->num_sent_packets == 1);
+		info->uncomp_hdr_len = pkt_hdrs->all_hdrs_len;
+		info->hdr_len = rohc_hdr_size;
+	}
+
+	ROHC_PROBE5(comp_packet, c->cid, c->profile->id, packet_type,
+	            pkt_hdrs->all_hdrs_len, rohc_hdr_size);
+
+	rohc_perf_lap(perf_clock, &comp->perf_histos[ROHC_COMP_PERF_PAYLOAD]);
+	rohc_perf_stop(perf_clock, &comp->perf_histos[ROHC_COMP_PERF_TOTAL]);
+
+	/* compression is successful */
+	return status;
+
+error_free_new_context:
+	/* free context if it was just created */
+	if(c->num_sent_packets <= 1)
+	{
+		c_ctxt_event(c, ROHC_COMP_CTXT_EVENT_RELEASED, c->state, c->mode);
+		c_release_context(comp, c);
+		c_free_ctxts_push(comp, c);
+	}
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Copy the headers of a super-packet to build the headers of its segments
+ *
+ * The headers of the super-packet are copied in the compressor, and the
+ * information collected about the headers of the super-packet is updated to
+ * describe the copy.
+ *
+ * @param comp               The ROHC compressor
+ * @param super_pkt          The super-packet
+ * @param[in,out] pkt_hdrs   The information collected about the headers
+ * @return                   true if the headers were copied,
+ *                           false if they are too long
+ */
+static bool rohc_comp_gso_rebase_hdrs(struct rohc_comp *const comp,
+                                      const struct rohc_buf super_pkt,
+                                      struct rohc_pkt_hdrs *const pkt_hdrs)
+{
+	const uint8_t *const super_hdrs = rohc_buf_data(super_pkt);
+	uint8_t *const hdrs = comp->gso_hdrs;
+	size_t i;
+
+	if(pkt_hdrs->all_hdrs_len > ROHC_COMP_GSO_HDRS_MAX_LEN)
+	{
+		return false;
+	}
+	memcpy(hdrs, super_hdrs, pkt_hdrs->all_hdrs_len);
+
+	for(i = 0; i < pkt_hdrs->ip_hdrs_nr; i++)
+	{
+		struct rohc_pkt_ip_hdr *const ip_hdr = &pkt_hdrs->ip_hdrs[i];
+		size_t j;
+
+		ip_hdr->data = hdrs + (ip_hdr->data - super_hdrs);
+		for(j = 0; j < ip_hdr->exts_nr; j++)
+		{
+			ip_hdr->exts[j].data = hdrs + (ip_hdr->exts[j].data - super_hdrs);
+		}
+	}
+	if(pkt_hdrs->innermost_ip_hdr->next_proto == ROHC_IPPROTO_TCP)
+	{
+		for(i = 0; i < pkt_hdrs->tcp_opts.nr; i++)
+		{
+			pkt_hdrs->tcp_opts.data[i] =
+				hdrs + (pkt_hdrs->tcp_opts.data[i] - super_hdrs);
+		}
+	}
+	pkt_hdrs->transport = hdrs + (pkt_hdrs->transport - super_hdrs);
+	pkt_hdrs->all_hdrs = hdrs;
+
+	return true;
+}
+
+
+/**
+ * @brief Get the length of the IPv4 fragment field behind the ROHC header
+ *
+ * The packets of the IP-only contexts carry the MF flag and the fragment
+ * offset of their innermost IPv4 header behind the ROHC header once
+ * \ref ROHC_COMP_FEATURE_IP_FRAGMENTS is enabled, see
+ * \ref ROHC_IP_FRAG_FIELD_LEN.
+ *
+ * @param comp        The ROHC compressor
+ * @param profile_id  The profile of the context
+ * @return            The length of the field, 0 if the context does not
+ *                    carry it
+ */
+static size_t rohc_comp_ip_frag_len(const struct rohc_comp *const comp,
+                                    const rohc_profile_t profile_id)
+{
+	if((comp->features & ROHC_COMP_FEATURE_IP_FRAGMENTS) == 0 ||
+	   (profile_id != ROHCv1_PROFILE_IP && profile_id != ROHCv2_PROFILE_IP))
+	{
+		return 0;
+	}
+	return ROHC_IP_FRAG_FIELD_LEN;
+}
+
+
+/**
+ * @brief Copy the IP headers of an IPv4 fragment without its fragmentation
+ *
+ * No ROHC packet format transmits the MF flag nor the fragment offset of the
+ * IPv4 headers. The IP headers of the fragment are thus copied in the
+ * compressor, the MF flag and the fragment offset of the innermost IPv4
+ * header are cleared in the copy and its checksum is computed again, so that
+ * the profile compresses (and computes its CRCs over) the headers that the
+ * decompressor builds before restoring the fragmentation. The payload of the
+ * fragment is not copied.
+ *
+ * @param comp               The ROHC compressor
+ * @param[in,out] pkt_hdrs   The information collected about the headers
+ */
+static void rohc_comp_frag_rebase_hdrs(struct rohc_comp *const comp,
+                                       struct rohc_pkt_hdrs *const pkt_hdrs)
+{
+	const uint8_t *const frag_hdrs = pkt_hdrs->all_hdrs;
+	uint8_t *const hdrs = comp->frag_hdrs;
+	const size_t ip_off = pkt_hdrs->innermost_ip_hdr->data - frag_hdrs;
+	struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) (hdrs + ip_off);
+	size_t i;
+
+	assert(pkt_hdrs->all_hdrs_len <= ROHC_COMP_FRAG_HDRS_MAX_LEN);
+	assert(pkt_hdrs->innermost_ip_hdr->version == IPV4);
+	memcpy(hdrs, frag_hdrs, pkt_hdrs->all_hdrs_len);
+
+	for(i = 0; i < pkt_hdrs->ip_hdrs_nr; i++)
+	{
+		struct rohc_pkt_ip_hdr *const ip_hdr = &pkt_hdrs->ip_hdrs[i];
+		size_t j;
+
+		ip_hdr->data = hdrs + (ip_hdr->data - frag_hdrs);
+		for(j = 0; j < ip_hdr->exts_nr; j++)
+		{
+			ip_hdr->exts[j].data = hdrs + (ip_hdr->exts[j].data - frag_hdrs);
+		}
+	}
+	pkt_hdrs->all_hdrs = hdrs;
+
+	ipv4->frag_off &= rohc_hton16(IPV4_DF);
+	ipv4->check = 0;
+	ipv4->check = ip_fast_csum(hdrs + ip_off, ipv4->ihl);
+}
+
+
+/**
+ * @brief Build the headers of one segment of a super-packet
+ *
+ * The headers of the segment are built in the copy made by
+ * \ref rohc_comp_gso_rebase_hdrs from the headers of the super-packet, that
+ * are not modified.
+ *
+ * @param comp               The ROHC compressor
+ * @param super_pkt          The super-packet
+ * @param super_payload      The payload of the super-packet
+ * @param super_payload_len  The length of the payload of the super-packet
+ * @param seg_idx            The index of the segment
+ * @param seg_off            The offset of the segment in the payload
+ * @param seg_len            The length of the payload of the segment
+ * @param is_last_seg        Whether the segment is the last one
+ * @param[in,out] pkt_hdrs   The information collected about the headers
+ */
+static void rohc_comp_gso_build_seg(struct rohc_comp *const comp,
+                                    const struct rohc_buf super_pkt,
+                                    const uint8_t *const super_payload,
+                                    const size_t super_payload_len,
+                                    const size_t seg_idx,
+                                    const size_t seg_off,
+                                    const size_t seg_len,
+                                    const bool is_last_seg,
+                                    struct rohc_pkt_hdrs *const pkt_hdrs)
+{
+	const uint8_t *const super_hdrs = rohc_buf_data(super_pkt);
+	uint8_t *const hdrs = comp->gso_hdrs;
+	const size_t len_diff = super_payload_len - seg_len;
+	const size_t l4_off = pkt_hdrs->transport - hdrs;
+	const size_t l4_hdr_len = pkt_hdrs->all_hdrs_len - l4_off;
+	uint8_t *const l4_hdr = hdrs + l4_off;
+	size_t i;
+
+	/* the lengths of all the IP headers, the IP-ID and the checksum of the
+	 * IPv4 headers */
+	for(i = 0; i < pkt_hdrs->ip_hdrs_nr; i++)
+	{
+		struct rohc_pkt_ip_hdr *const ip_hdr = &pkt_hdrs->ip_hdrs[i];
+		const size_t ip_off = ip_hdr->data - hdrs;
+
+		ip_hdr->tot_len = super_pkt.len - ip_off - len_diff;
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const super_ipv4 =
+				(const struct ipv4_hdr *) (super_hdrs + ip_off);
+			struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) (hdrs + ip_off);
+
+			ipv4->tot_len = rohc_hton16(ip_hdr->tot_len);
+			ipv4->id = rohc_hton16(rohc_ntoh16(super_ipv4->id) + seg_idx);
+			ipv4->check = 0;
+			ipv4->check = ip_fast_csum(hdrs + ip_off, ipv4->ihl);
+		}
+		else
+		{
+			struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) (hdrs + ip_off);
+			ipv6->plen = rohc_hton16(ip_hdr->tot_len - sizeof(struct ipv6_hdr));
+		}
+	}
+
+	/* the payload of the segment */
+	pkt_hdrs->payload = super_payload + seg_off;
+	pkt_hdrs->payload_len = seg_len;
+
+	/* the sequence number, the flags and the checksum of the TCP header, the
+	 * length and the checksum of the UDP header */
+	if(pkt_hdrs->innermost_ip_hdr->next_proto == ROHC_IPPROTO_TCP)
+	{
+		const struct tcphdr *const super_tcp =
+			(const struct tcphdr *) (super_hdrs + l4_off);
+		struct tcphdr *const tcp = (struct tcphdr *) l4_hdr;
+
+		tcp->seq_num = rohc_hton32(rohc_ntoh32(super_tcp->seq_num) + seg_off);
+		tcp->rsf_flags = super_tcp->rsf_flags;
+		tcp->psh_flag = super_tcp->psh_flag;
+		tcp->ecn_flags = super_tcp->ecn_flags;
+		if(!is_last_seg)
+		{
+			tcp->rsf_flags &= ~RSF_FIN_ONLY;
+			tcp->psh_flag = 0;
+		}
+		if(seg_idx > 0)
+		{
+			tcp->ecn_flags &= ~0x2; /* CWR flag */
+		}
+		tcp->checksum = 0;
+		tcp->checksum =
+			rohc_hton16(rohc_comp_gso_l4_csum(pkt_hdrs, ROHC_IPPROTO_TCP,
+			                                  l4_hdr, l4_hdr_len));
+	}
+	else
+	{
+		const struct udphdr *const super_udp =
+			(const struct udphdr *) (super_hdrs + l4_off);
+		struct udphdr *const udp = (struct udphdr *) l4_hdr;
+
+		udp->len = rohc_hton16(sizeof(struct udphdr) + seg_len);
+		if(super_udp->check != 0 || pkt_hdrs->innermost_ip_hdr->version != IPV4)
+		{
+			uint16_t check;
+
+			udp->check = 0;
+			check = rohc_comp_gso_l4_csum(pkt_hdrs, ROHC_IPPROTO_UDP,
+			                              l4_hdr, l4_hdr_len);
+			udp->check = rohc_hton16(check == 0 ? 0xffff : check);
+		}
+	}
+}
+
+
+/**
+ * @brief Compute the TCP or UDP checksum of one segment of a super-packet
+ *
+ * @param pkt_hdrs    The information collected about the headers of the
+ *                    segment
+ * @param l4_proto    The protocol of the transport header
+ * @param l4_hdr      The transport header with a zero checksum
+ * @param l4_hdr_len  The length of the transport header
+ * @return            The checksum (in host byte order)
+ */
+static uint16_t rohc_comp_gso_l4_csum(const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                      const uint8_t l4_proto,
+                                      const uint8_t *const l4_hdr,
+                                      const size_t l4_hdr_len)
+{
+	const struct rohc_pkt_ip_hdr *const ip_hdr = pkt_hdrs->innermost_ip_hdr;
+	const size_t l4_len = l4_hdr_len + pkt_hdrs->payload_len;
+	uint32_t sum;
+
+	/* the pseudo-header */
+	if(ip_hdr->version == IPV4)
+	{
+		sum = ip_csum_partial(0, (const uint8_t *) &ip_hdr->ipv4->saddr,
+		                      2 * sizeof(uint32_t));
+	}
+	else
+	{
+		sum = ip_csum_partial(0, (const uint8_t *) &ip_hdr->ipv6->saddr,
+		                      2 * sizeof(struct ipv6_addr));
+	}
+	sum += l4_proto + (l4_len >> 16) + (l4_len & 0xffff);
+
+	/* the transport header and the payload */
+	sum = ip_csum_partial(sum, l4_hdr, l4_hdr_len);
+	sum = ip_csum_partial(sum, pkt_hdrs->payload, pkt_hdrs->payload_len);
+
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return (~sum) & 0xffff;
+}
+
+
+/**
+ * @brief Pad the given ROHC compressed packet
+ *
+ * Add as many padding bytes as required to get a ROHC packet of the given length.
+ *
+ * @param comp              The ROHC compressor
+ * @param[in,out] rohc_pkt  The compressed ROHC packet to pad up to \e min_pkt_len
+ * @param min_pkt_len       The minimum length of the ROHC packet
+ * @return                  Possible return values:
+ *                          \li \ref ROHC_STATUS_OK if a padded ROHC packet is
+ *                              returned
+ *                          \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                              buffer is too small for the padded ROHC packet
+ *                          \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_comp_pad(struct rohc_comp *const comp,
+                            struct rohc_buf *const rohc_pkt,
+                            const size_t min_pkt_len)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	const uint8_t padding_byte = ROHC_PADDING_BYTE;
+	size_t padding_bytes_nr = 0;
+	size_t i;
+
+	/* check inputs validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_pkt == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_pkt is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*rohc_pkt))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_pkt is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(*rohc_pkt))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_pkt is empty");
+		goto error;
+	}
+
+	/* if ROHC packet is already smaller than the minimum length, prepend
+	 * some padding bytes before the ROHC packet up to the minimum length */
+	if(rohc_pkt->len >= min_pkt_len)
+	{
+		padding_bytes_nr = 0;
+	}
+	else
+	{
+		padding_bytes_nr = min_pkt_len - rohc_pkt->len;
+	}
+
+	/* ROHC packet cannot be padded if buffer has not enough room before packet */
+	if(rohc_pkt->offset < padding_bytes_nr)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "%zu-byte ROHC packet cannot be padded up to %zu bytes with "
+		             "%zu bytes: only %zu bytes available in buffer before ROHC "
+		             "data", rohc_pkt->len, min_pkt_len, padding_bytes_nr,
+		             rohc_pkt->offset);
+		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+		goto error;
+	}
+
+	/* add required padding bytes */
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "pad %zu-byte ROHC packet up to %zu bytes with %zu bytes",
+	           rohc_pkt->len, min_pkt_len, padding_bytes_nr);
+	for(i = 0; i < padding_bytes_nr; i++)
+	{
+		rohc_buf_prepend(rohc_pkt, &padding_byte, 1);
+	}
+	assert(rohc_pkt->len >= min_pkt_len);
+
+	/* everything went fine */
+	status = ROHC_STATUS_OK;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Get the next ROHC segment if any
+ *
+ * Get the next ROHC segment if any.
+ *
+ * To get all the segments of one ROHC packet, call this function until
+ * \ref ROHC_STATUS_OK or \ref ROHC_STATUS_ERROR is returned.
+ *
+ * @param comp          The ROHC compressor
+ * @param[out] segment  The buffer where to store the ROHC segment
+ * @return              Possible return values:
+ *                       \li \ref ROHC_STATUS_SEGMENT if a ROHC segment is
+ *                           returned and more segments are available,
+ *                       \li \ref ROHC_STATUS_OK if a ROHC segment is returned
+ *                           and no more ROHC segment is available
+ *                       \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC compressor
+ * \code
+        ...
+        // compress the IP packet with a small ROHC buffer
+\endcode
+ * \snippet test_segment.c segment ROHC packet #1
+ * \snippet test_segment.c segment ROHC packet #2
+ * \code
+                        ...
+                        // decompress the ROHC segment here, the function
+                        // rohc_decompress3 shall return ROHC_STATUS_OK
+                        // and no decompressed packet
+                        ...
+\endcode
+ * \snippet test_segment.c segment ROHC packet #3
+ * \code
+                // decompress the final ROHC segment here, the function
+                // rohc_decompress4 shall return ROHC_STATUS_OK
+\endcode
+ * \snippet test_segment.c segment ROHC packet #4
+ * \code
+                // handle compression error here
+                ...
+\endcode
+ *
+ * @see rohc_comp_get_mrru
+ * @see rohc_comp_set_mrru
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
+                                     struct rohc_buf *const segment)
+
+{
+	const size_t segment_type_len = 1; /* segment type byte */
+	struct rohc_comp_seg_iov iov[ROHC_COMP_SEG_IOV_MAX - 1];
+	size_t max_data_len;
+	size_t iov_nr;
+	size_t i;
+	rohc_status_t status;
+
+	/* check input parameters */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(segment == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment cannot be NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*segment))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*segment))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment is not empty");
+		goto error;
+	}
+
+	/* no segment yet */
+	segment->len = 0;
+
+	/* abort if no RRU is available in the compressor */
+	if(comp->rru_len == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no RRU available in given compressor");
+		goto error;
+	}
+
+	/* abort is the given output buffer is too small for RRU */
+	if(rohc_buf_avail_len(*segment) <= segment_type_len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "output buffer is too small for RRU, more than %zd bytes "
+		             "are required", segment_type_len);
+		goto error;
+	}
+
+	/* how many bytes of ROHC packet can we put in that new segment? */
+	max_data_len = rohc_min(rohc_buf_avail_len(*segment) - segment_type_len,
+	                        comp->rru_len);
+	assert(max_data_len > 0);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "copy %zd bytes of the remaining %zd bytes of ROHC packet and "
+	           "CRC in the segment", max_data_len, comp->rru_len);
+
+	/* set segment type with F bit set only for last segment */
+	rohc_buf_byte_at(*segment, 0) = 0xfe | (max_data_len == comp->rru_len);
+	segment->len++;
+	rohc_buf_pull(segment, 1);
+
+	/* copy remaining ROHC data (CRC included) */
+	iov_nr = c_rru_get_iov(comp, max_data_len, iov);
+	for(i = 0; i < iov_nr; i++)
+	{
+		rohc_buf_append(segment, iov[i].data, iov[i].len);
+	}
+	rohc_buf_pull(segment, max_data_len);
+	comp->rru_off += max_data_len;
+	comp->rru_len -= max_data_len;
+
+	/* set status wrt to (non-)final segment */
+	if(comp->rru_len == 0)
+	{
+		/* final segment, no more segment available */
+		status = ROHC_STATUS_OK;
+		/* reset context for next RRU */
+		comp->rru_off = 0;
+		comp->rru_iov_nr = 0;
+	}
+	else
+	{
+		/* non-final segment, more segments to available */
+		status = ROHC_STATUS_SEGMENT;
+	}
+
+	/* shift backward the RRU data, header and the feedback data */
+	rohc_buf_push(segment, max_data_len + 1);
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Get the descriptor of the next ROHC segment if any
+ *
+ * Get the next ROHC segment if any, as \ref rohc_comp_get_segment2 does, but
+ * without copying it: the segment is described by fragments of data that
+ * reference the segment type, the ROHC header, the payload and the CRC of
+ * the Reconstructed Reception Unit (RRU). The segment is the concatenation of
+ * the fragments, so it may be transmitted with scatter/gather I/O, eg.
+ * writev(), sendmsg() or chained network buffers.
+ *
+ * The fragments are valid until the next ROHC packet is compressed. Those of
+ * a RRU created by \ref rohc_compress_iov are valid only as long as the
+ * memory of the ROHC header and of the uncompressed packet is.
+ *
+ * To get all the segments of one ROHC packet, call this function until
+ * \ref ROHC_STATUS_OK or \ref ROHC_STATUS_ERROR is returned.
+ *
+ * @param comp          The ROHC compressor
+ * @param max_len       The maximal length of the ROHC segment, segment type
+ *                      included
+ * @param[out] iov      The fragments of data of the ROHC segment
+ * @param[out] iov_nr   The number of fragments of data of the ROHC segment
+ * @return              The same status values as \ref rohc_comp_get_segment2
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_iov
+ * @see rohc_comp_get_segment2
+ */
+rohc_status_t rohc_comp_get_segment_iov(struct rohc_comp *const comp,
+                                        const size_t max_len,
+                                        struct rohc_comp_seg_iov iov[ROHC_COMP_SEG_IOV_MAX],
+                                        size_t *const iov_nr)
+{
+	const size_t segment_type_len = 1; /* segment type byte */
+	size_t max_data_len;
+	bool is_final;
+
+	/* check input parameters */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(iov == NULL || iov_nr == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given iov or iov_nr cannot be NULL");
+		goto error;
+	}
+
+	/* abort if no RRU is available in the compressor */
+	if(comp->rru_len == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no RRU available in given compressor");
+		goto error;
+	}
+
+	/* abort is the given maximal length is too small for RRU */
+	if(max_len <= segment_type_len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "maximal length is too small for RRU, more than %zd bytes "
+		             "are required", segment_type_len);
+		goto error;
+	}
+
+	/* how many bytes of ROHC packet can we put in that new segment? */
+	max_data_len = rohc_min(max_len - segment_type_len, comp->rru_len);
+	is_final = (max_data_len == comp->rru_len);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "reference %zd bytes of the remaining %zd bytes of ROHC packet "
+	           "and CRC in the segment", max_data_len, comp->rru_len);
+
+	/* segment type with F bit set only for last segment, then the remaining
+	 * ROHC data (CRC included) */
+	iov[0].data = &rohc_comp_seg_types[is_final ? 1 : 0];
+	iov[0].len = segment_type_len;
+	*iov_nr = 1 + c_rru_get_iov(comp, max_data_len, iov + 1);
+	comp->rru_off += max_data_len;
+	comp->rru_len -= max_data_len;
+
+	/* set status wrt to (non-)final segment */
+	if(is_final)
+	{
+		/* reset context for next RRU */
+		comp->rru_off = 0;
+		comp->rru_iov_nr = 0;
+		return ROHC_STATUS_OK;
+	}
+
+	return ROHC_STATUS_SEGMENT;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Force the compressor to re-initialize all its contexts
+ *
+ * Make all contexts restart their initialization with decompressor, ie. they
+ * go in the lowest compression state. This function can be used once the
+ * ROHC channel is established again after an interruption.
+ *
+ * The function implements the CONTEXT_REINITIALIZATION signal described by
+ * RFC 3095 at §6.3.1 as:
+ * \verbatim
+   CONTEXT_REINITIALIZATION -- signal
+   This parameter triggers a reinitialization of the entire context at
+   the decompressor, both the static and the dynamic part.  The
+   compressor MUST, when CONTEXT_REINITIALIZATION is triggered, back off
+   to the IR state and fully reinitialize the context by sending IR
+   packets with both the static and dynamic chains covering the entire
+   uncompressed headers until it is reasonably confident that the
+   decompressor contexts are reinitialized.  The context
+   reinitialization MUST be done for all contexts at the compressor.
+   This parameter may for instance be used to do context relocation at,
+   e.g., a cellular handover that results in a change of compression
+   point in the radio access network.
+\endverbatim
+ *
+ * @param comp  The ROHC compressor
+ * @return      true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
+{
+	rohc_cid_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "force re-initialization for all %u contexts",
+	          comp->num_contexts_used);
+
+	for(i = comp->ctxts_min_cid; i < comp->ctxts_next_cid; i++)
+	{
+		struct rohc_comp_ctxt *const ctxt = c_ctxt_at(comp, i);
+
+		if(ctxt->used)
+		{
+			if(!rohc_comp_reinit_context(ctxt))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to force re-initialization for CID %u", i);
+				goto error;
+			}
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Force the compressor to re-initialize the contexts of some flows
+ *
+ * Make the contexts that match the given filter restart their initialization
+ * with decompressor, ie. they go in the lowest compression state, as
+ * \ref rohc_comp_force_contexts_reinit does for all the contexts. This
+ * function can be used when a route, a NAT binding or a tunnel endpoint
+ * changes: only the contexts of the flows of the address or prefix send IR
+ * packets again.
+ *
+ * The contexts are indexed by the first 24 bits of their IPv4 addresses and
+ * by the first 48 bits of their IPv6 addresses: the contexts of one IPv4
+ * prefix of 16 bits or more or of one IPv6 prefix of 40 bits or more are
+ * found without checking all the contexts.
+ *
+ * @param comp           The ROHC compressor
+ * @param filter         The filter of the contexts to re-initialize
+ * @param[out] ctxts_nr  The number of contexts re-initialized
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_force_contexts_reinit
+ */
+bool rohc_comp_invalidate_contexts(struct rohc_comp *const comp,
+                                   const struct rohc_comp_ctxt_filter *const filter,
+                                   size_t *const ctxts_nr)
+{
+	uint8_t walked_idx[ROHC_COMP_ADDR_INDEX_LEN / 8];
+	size_t addr_bits_nr;
+	size_t key_bits_nr;
+	size_t keys_nr;
+	size_t key_nr;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(filter == NULL || ctxts_nr == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to invalidate contexts: no filter or no counter "
+		             "given");
+		goto error;
+	}
+	if(filter->ip_version == IPV4)
+	{
+		addr_bits_nr = 32;
+	}
+	else if(filter->ip_version == IPV6)
+	{
+		addr_bits_nr = 128;
+	}
+	else
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to invalidate contexts: unknown IP version %u",
+		             filter->ip_version);
+		goto error;
+	}
+	if(filter->prefix_len > addr_bits_nr)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to invalidate contexts: prefix of %u bits longer "
+		             "than the IPv%u addresses", filter->prefix_len,
+		             filter->ip_version);
+		goto error;
+	}
+	*ctxts_nr = 0;
+
+	key_bits_nr = c_addr_key_len(filter->ip_version) * 8;
+	if((filter->prefix_len + ROHC_COMP_ADDR_INDEX_SPREAD_BITS) < key_bits_nr)
+	{
+		struct rohc_comp_ctxt *ctxt;
+
+		/* the prefix spreads over too many entries of the index, check all
+		 * the contexts in use instead */
+		for(ctxt = comp->ctxts_lru_first; ctxt != NULL; ctxt = ctxt->lru_next)
+		{
+			if(c_ctxt_filter_match(ctxt, filter) < ROHC_COMP_ADDR_LINKS_MAX)
+			{
+				if(!rohc_comp_reinit_context(ctxt))
+				{
+					goto reinit_error;
+				}
+				(*ctxts_nr)++;
+			}
+		}
+		goto end;
+	}
+
+	/* walk the entries of all the keys of the prefix: the bits of the keys
+	 * beyond the prefix, if any, are all within their last byte */
+	if(filter->prefix_len >= key_bits_nr)
+	{
+		keys_nr = 1;
+	}
+	else
+	{
+		keys_nr = (1U << (key_bits_nr - filter->prefix_len));
+	}
+	memset(walked_idx, 0, sizeof(walked_idx));
+	for(key_nr = 0; key_nr < keys_nr; key_nr++)
+	{
+		uint8_t key[ROHC_COMP_ADDR_INDEX_V6_KEY_LEN];
+		struct rohc_comp_ctxt *ctxt;
+		struct rohc_comp_ctxt *next;
+		size_t idx;
+
+		memcpy(key, filter->addr, key_bits_nr / 8);
+		key[key_bits_nr / 8 - 1] &= ~(keys_nr - 1);
+		key[key_bits_nr / 8 - 1] |= key_nr;
+		idx = c_addr_idx(filter->ip_version, key);
+
+		/* several keys may share one entry */
+		if((walked_idx[idx / 8] & (1U << (idx % 8))) != 0)
+		{
+			continue;
+		}
+		walked_idx[idx / 8] |= (1U << (idx % 8));
+
+		for(ctxt = comp->ctxts_by_addr[idx]; ctxt != NULL; ctxt = next)
+		{
+			const size_t link = c_ctxt_filter_match(ctxt, filter);
+
+			next = ctxt->addr_links[c_addr_link_at(ctxt, idx)].next;
+
+			/* the context is linked in the entries of all its addresses, so
+			 * re-initialize it from the entry of its first matching address
+			 * only */
+			if(link < ROHC_COMP_ADDR_LINKS_MAX)
+			{
+				const struct rohc_fingerprint_ip *const ip =
+					&(ctxt->fingerprint.base.ip_hdrs[link / 2]);
+				const uint8_t *const addr =
+					((link % 2) == 0 ? ip->saddr.u8 : ip->daddr.u8);
+
+				if(c_addr_idx(ip->version, addr) == idx)
+				{
+					if(!rohc_comp_reinit_context(ctxt))
+					{
+						goto reinit_error;
+					}
+					(*ctxts_nr)++;
+				}
+			}
+		}
+	}
+
+end:
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "force re-initialization for %zu contexts of one IPv%u prefix "
+	          "of %u bits", *ctxts_nr, filter->ip_version, filter->prefix_len);
+	return true;
+
+reinit_error:
+	rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	             "failed to force re-initialization for some contexts");
+error:
+	return false;
+}
+
+
+/**
+ * @brief Reset the compressor as if it was just created and configured
+ *
+ * Release all the compression contexts and forget the state of the ROHC
+ * channel: the flows, the ROHC segment being sent, the budget of IR
+ * refreshes and the statistics. The configuration of the compressor, eg. the
+ * enabled profiles, the MRRU, the W-LSB widths, the refresh timeouts and all
+ * the callbacks, is kept as is, so is the memory allocated for the contexts
+ * and their lookup tables.
+ *
+ * The function is meant to recover from the loss of the ROHC channel, eg. on
+ * a link flap, without the cost of destroying the compressor, creating and
+ * configuring a new one. The next packets are compressed in new contexts,
+ * with the same CIDs as a new compressor would use. The decompressor of
+ * the remote ROHC endpoint shall be reset too, see \ref rohc_decomp_reset.
+ *
+ * The \ref ROHC_COMP_CTXT_EVENT_RELEASED event is notified for every released
+ * context if a callback was set with \ref rohc_comp_set_ctxt_event_cb.
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if the compressor was reset, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_force_contexts_reinit
+ * @see rohc_decomp_reset
+ */
+bool rohc_comp_reset(struct rohc_comp *const comp)
+{
+	rohc_cid_t cid;
+	size_t phase;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "reset compressor: release all %u contexts", comp->num_contexts_used);
+
+	/* release all the contexts, and rebuild the list of free contexts so that
+	 * they are re-used from the smallest CID like in a new compressor */
+	comp->ctxts_free = NULL;
+	for(cid = comp->ctxts_next_cid; cid > comp->ctxts_min_cid; cid--)
+	{
+		struct rohc_comp_ctxt *const ctxt = c_ctxt_at(comp, cid - 1);
+
+		if(ctxt->used)
+		{
+			c_ctxt_event(ctxt, ROHC_COMP_CTXT_EVENT_RELEASED, ctxt->state, ctxt->mode);
+			c_release_context(comp, ctxt);
+		}
+		c_free_ctxts_push(comp, ctxt);
+	}
+	assert(comp->num_contexts_used == 0);
+	assert(comp->ctxts_lru_first == NULL);
+	assert(comp->uncompressed_ctxt == NULL);
+	comp->last_context = NULL;
+
+	/* forget the flows */
+	memset(comp->flows_cache, 0, sizeof(comp->flows_cache));
+	memset(comp->esp_by_spi, 0, sizeof(comp->esp_by_spi));
+	memset(comp->ctxts_by_rss, 0, sizeof(comp->ctxts_by_rss));
+	memset(comp->rtp_verdicts, 0, sizeof(comp->rtp_verdicts));
+	memset(comp->uncomp_flows, 0, sizeof(comp->uncomp_flows));
+
+	/* drop the ROHC segments that were not retrieved yet */
+	comp->rru_off = 0;
+	comp->rru_len = 0;
+	comp->rru_iov_nr = 0;
+
+	/* start a new period for the budget of IR refreshes */
+	comp->ir_refresh_budget_start.sec = 0;
+	comp->ir_refresh_budget_start.nsec = 0;
+	comp->ir_refresh_budget_used = 0;
+
+	/* the throttled compressor counts its packets from scratch */
+	comp->overload_next_ctxt_pkt = 0;
+
+	/* the new flows start their warm-up from scratch */
+	memset(comp->warmup_flows, 0, sizeof(comp->warmup_flows));
+
+	/* reset statistics */
+	rohc_stats_write_begin(&comp->stats_seq);
+	comp->num_packets = 0;
+	comp->total_compressed_size = 0;
+	comp->total_uncompressed_size = 0;
+	comp->num_contexts_evicted = 0;
+	comp->num_contexts_expired = 0;
+	comp->num_feedbacks_foreign = 0;
+	comp->num_ir_refreshes_deferred = 0;
+	comp->num_overload_shed = 0;
+	comp->num_warmup_held = 0;
+	comp->num_refreshes = 0;
+	comp->num_refresh_bytes = 0;
+	memset(comp->pkt_stats, 0, sizeof(comp->pkt_stats));
+	for(phase = 0; phase < ROHC_COMP_PERF_PHASES_NR; phase++)
+	{
+		rohc_perf_histo_reset(&comp->perf_histos[phase]);
+	}
+	rohc_stats_write_end(&comp->stats_seq);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the compression contexts that are idle for too long
+ *
+ * Release all the contexts that did not compress any packet during the delay
+ * configured with \ref rohc_comp_set_ctxt_idle_timeout. The CIDs of the
+ * released contexts are available again for new flows, so that the creation
+ * of a new context does not need to recycle a context that is still in use.
+ *
+ * The function is meant to be called periodically by the application, eg.
+ * from a housekeeping timer, outside of the compression of packets. The
+ * contexts are kept sorted from the most to the least recently used one, so
+ * the cost of one call is proportional to the number of released contexts.
+ *
+ * Nothing is released if no idle timeout was configured.
+ *
+ * @param comp  The ROHC compressor
+ * @param now   The current time, in the same time base as the timestamps
+ *              of the uncompressed packets given to the compressor
+ * @return      true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_ctxt_idle_timeout
+ */
+bool rohc_comp_expire(struct rohc_comp *const comp,
+                      const struct rohc_ts now)
+{
+	struct rohc_comp_ctxt *ctxt;
+	size_t expired_nr = 0;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(comp->ctxt_idle_timeout == 0)
+	{
+		/* contexts never expire */
+		goto skip;
+	}
+
+	/* walk the LRU list from the least recently used context, and stop at
+	 * the first context that is not idle */
+	ctxt = comp->ctxts_lru_last;
+	while(ctxt != NULL && c_is_context_idle(comp, ctxt, now))
+	{
+		struct rohc_comp_ctxt *const prev_ctxt = ctxt->lru_prev;
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "release idle context (CID %u with profile 0x%04x) last "
+		           "used at %" PRIu64 " seconds", ctxt->cid, ctxt->profile->id,
+		           ctxt->latest_used.sec);
+		c_ctxt_event(ctxt, ROHC_COMP_CTXT_EVENT_RELEASED, ctxt->state, ctxt->mode);
+		c_release_context(comp, ctxt);
+		c_free_ctxts_push(comp, ctxt);
+		expired_nr++;
+
+		ctxt = prev_ctxt;
+	}
+	if(expired_nr > 0)
+	{
+		rohc_stats_write_begin(&comp->stats_seq);
+		comp->num_contexts_expired += expired_nr;
+		rohc_stats_write_end(&comp->stats_seq);
+
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "%zu idle contexts released, %u contexts still in use",
+		          expired_nr, comp->num_contexts_used);
+	}
+
+skip:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compute the flow hash of the given uncompressed packet
+ *
+ * The flow hash is the hash the compressor uses internally to find the
+ * context of a packet: it is computed on the packet fingerprint, ie. the
+ * header fields that identify the flow for the profile that would compress
+ * the packet. All the packets of one flow thus get the same flow hash, and
+ * the flow hash may be used to steer packets to several compressors, eg. one
+ * per CPU core, so that the contexts of one flow stay on one compressor.
+ *
+ * No context is searched for, created or modified. The hash is keyed by a
+ * random key of the compressor, so flow hashes computed by different
+ * compressors differ.
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compute the flow hash for
+ * @param[out] hash      The flow hash of the packet
+ * @return               true if the flow hash was computed,
+ *                       false if no enabled profile may compress the packet
+ *                       or if one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_group_steer
+ */
+bool rohc_comp_flow_hash(const struct rohc_comp *const comp,
+                         const struct rohc_buf uncomp_packet,
+                         uint64_t *const hash)
+{
+	struct rohc_fingerprint fingerprint;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(uncomp_packet) || rohc_buf_is_empty(uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed or empty");
+		goto error;
+	}
+	if(hash == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given hash is NULL");
+		goto error;
+	}
+
+	if(!rohc_comp_get_fingerprint(comp, &uncomp_packet, &fingerprint))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no profile may compress the packet");
+		goto error;
+	}
+	*hash = hashtable_hash(&comp->contexts_by_fingerprint, &fingerprint,
+	                       rohc_fingerprint_len(&fingerprint));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the number of repetitions required to gain transmission confidence
+ *
+ * The Optimistic Approach is defined by RFC 3095 §5.3.1.1.1 as follow:
+ *
+ *   Transition to a higher compression state in Unidirectional mode is
+ *   carried out according to the optimistic approach principle.  This
+ *   means that the compressor transits to a higher compression state when
+ *   it is fairly confident that the decompressor has received enough
+ *   information to correctly decompress packets sent according to the
+ *   higher compression state.
+ *
+ *   When the compressor is in the IR state, it will stay there until it
+ *   assumes that the decompressor has correctly received the static
+ *   context information.  For transition from the FO to the SO state, the
+ *   compressor should be confident that the decompressor has all
+ *   parameters needed to decompress according to a fixed pattern.
+ *
+ *   The compressor normally obtains its confidence about decompressor
+ *   status by sending several packets with the same information according
+ *   to the lower compression state.  If the decompressor receives any of
+ *   these packets, it will be in sync with the compressor.  The number of
+ *   consecutive packets to send for confidence is not defined in this
+ *   document.
+ *
+ * This function allows the library users to set the number of repetitions
+ * required by the ROHC compressor to gain confidence that the ROHC
+ * decompressor got the transmitted information.
+ *
+ * It controls:
+ *  - the number of IR packets transmitted in a row at context initialization,
+ *  - the number of context-updating packets transmitted in case of stream change,
+ *  - the number of transmissions of TS stride, list structures or list items
+ *    before they are considered as known,
+ *  - the width of the W-LSB window.
+ *
+ * The number of repetitions may be chosen as follow:
+ *  a/ define the largest loss burst that you want to be robust to,
+ *  b/ increment that number by one, so that at least one packet per burst
+ *     is received by the decompressor.
+ *
+ * @warning The value can not be modified after library initialization
+ *
+ * @param comp            The ROHC compressor to configure
+ * @param repetitions_nr  The number of repetitions (4 by default)
+ * @return                true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_optimistic_approach(struct rohc_comp *const comp,
+                                       const size_t repetitions_nr)
+{
+	/* we need a valid compressor */
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	/* the window width shall be in both ranges ]0;ROHC_WLSB_WIDTH_MAX]
+	 * and ]0;UINT8_MAX] */
+	if(repetitions_nr == 0 ||
+	   repetitions_nr > ROHC_WLSB_WIDTH_MAX ||
+	   repetitions_nr > UINT8_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set the number of Optimistic Approach repetitions to %zu: "
+		             "value must be in range ]0;%u]",
+		             repetitions_nr, rohc_min(ROHC_WLSB_WIDTH_MAX, UINT8_MAX));
+		return false;
+	}
+
+	/* refuse to set a value if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		             "modify the number of Optimistic Approach repetitions "
+		             "after initialization");
+		return false;
+	}
+
+	comp->oa_repetitions_nr = repetitions_nr;
+	comp->oa_repetitions_min =
+		rohc_min(comp->oa_repetitions_min, comp->oa_repetitions_nr);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "number of Optimistic Approach repetitions set to %u",
+	          comp->oa_repetitions_nr);
+
+	return true;
+}
+
+
+/**
+ * @brief Adapt the number of Optimistic Approach repetitions to the losses
+ *
+ * Once enabled, every context adapts its number of repetitions of the
+ * Optimistic Approach to the losses it experiences, between the given minimum
+ * and the number configured with \ref rohc_comp_set_optimistic_approach:
+ *  \li in U-mode, the number of repetitions is the smallest one that makes
+ *      the loss of all the repetitions of one change unlikely (below 1/1000)
+ *      for the loss rate estimated by the application with
+ *      \ref rohc_comp_set_loss_estimate,
+ *  \li in O-mode and R-mode, the number of repetitions is raised at every
+ *      NACK or STATIC-NACK received for the context, and lowered by one
+ *      every time the context sent a few hundred packets without any NACK.
+ *
+ * On a clean link, the contexts thus repeat every change of the headers only
+ * a couple of times instead of the configured number of times, so the larger
+ * ROHC packets that carry the changes are sent less often.
+ *
+ * Adaptation is disabled by default.
+ *
+ * @param comp                The ROHC compressor
+ * @param min_repetitions_nr  The minimal number of repetitions, 0 to disable
+ *                            adaptation
+ * @return                    true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_optimistic_approach
+ * @see rohc_comp_set_loss_estimate
+ */
+bool rohc_comp_set_adaptive_oa(struct rohc_comp *const comp,
+                               const size_t min_repetitions_nr)
+{
+	struct rohc_comp_ctxt *ctxt;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(min_repetitions_nr > comp->oa_repetitions_nr)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set the minimal number of Optimistic Approach repetitions "
+		             "to %zu: value must be in range [0;%u]", min_repetitions_nr,
+		             comp->oa_repetitions_nr);
+		goto error;
+	}
+
+	comp->oa_repetitions_min = min_repetitions_nr;
+
+	/* the contexts in use restart from the number of repetitions that fits
+	 * their mode */
+	for(ctxt = comp->ctxts_lru_first; ctxt != NULL; ctxt = ctxt->lru_next)
+	{
+		if(ctxt->mode == ROHC_U_MODE || comp->oa_repetitions_min == 0)
+		{
+			ctxt->oa_repetitions_nr = c_oa_repetitions(comp);
+		}
+		else
+		{
+			ctxt->oa_repetitions_nr = comp->oa_repetitions_nr;
+		}
+		ctxt->oa_clean_pkts_nr = 0;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "adaptive Optimistic Approach %s (%u to %u repetitions)",
+	          comp->oa_repetitions_min != 0 ? "enabled" : "disabled",
+	          comp->oa_repetitions_min, comp->oa_repetitions_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the loss rate of the channel estimated by the application
+ *
+ * The contexts in U-mode receive no feedback, so they cannot observe the
+ * losses themselves. When \ref rohc_comp_set_adaptive_oa is enabled, they
+ * adapt their number of Optimistic Approach repetitions to the given
+ * estimation instead. When \ref rohc_comp_set_adaptive_refreshes is enabled,
+ * they adapt the timeouts of their periodic refreshes to it too. The
+ * estimation may be updated at any time, eg. from the statistics of the link
+ * layer, or from the decompression failures that the remote decompressor
+ * reports on a side channel.
+ *
+ * The loss rate is 0 by default.
+ *
+ * @param comp           The ROHC compressor
+ * @param loss_permille  The loss rate of the channel (in per thousand), in
+ *                       range [0;1000]
+ * @return               true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_adaptive_oa
+ * @see rohc_comp_set_adaptive_refreshes
+ */
+bool rohc_comp_set_loss_estimate(struct rohc_comp *const comp,
+                                 const unsigned int loss_permille)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(loss_permille > 1000)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set the loss estimate to %u/1000: value must be in range "
+		             "[0;1000]", loss_permille);
+		goto error;
+	}
+
+	comp->oa_loss_permille = loss_permille;
+	c_refresh_scale_update(comp);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "loss estimate set to %u/1000, %u Optimistic Approach repetitions "
+	           "in U-mode", comp->oa_loss_permille, c_oa_repetitions(comp));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the window width for the W-LSB encoding scheme
+ *
+ * Set the window width for the Window-based Least Significant Bits (W-LSB)
+ * encoding. See section 4.5.2 of RFC 3095 for more details about the encoding
+ * scheme.
+ *
+ * The width of the W-LSB window is set to 4 by default.
+ *
+ * @warning The value can not be modified after library initialization
+ *
+ * @param comp   The ROHC compressor
+ * @param width  The width of the W-LSB sliding window
+ * @return       true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @deprecated please use rohc_comp_set_optimistic_approach() instead
+ */
+bool rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
+                                     const size_t width)
+{
+	/* fallback on the new function */
+	return rohc_comp_set_optimistic_approach(comp, width);
+}
+
+
+/**
+ * @brief Set the reordering ratio for the W-LSB encoding scheme
+ *
+ * The control field reorder_ratio specifies how much reordering is
+ * handled by the W-LSB encoding of the MSN in ROHCv2 profiles.
+ *
+ * The reordering ration is set to ROHC_REORDERING_NONE by default.
+ *
+ * @param comp           The ROHC compressor
+ * @param reorder_ratio  The reordering ratio
+ * @return               true in case of success,
+ *                       false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_reorder_ratio(struct rohc_comp *const comp,
+                                 const rohc_reordering_offset_t reorder_ratio)
+{
+	/* we need a valid compressor */
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	/* Check value of reorder ratio */
+	if(reorder_ratio != ROHC_REORDERING_NONE &&
+	   reorder_ratio != ROHC_REORDERING_QUARTER &&
+	   reorder_ratio != ROHC_REORDERING_HALF &&
+	   reorder_ratio != ROHC_REORDERING_THREEQUARTERS)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set reorder ratio to %u: reorder ratio must be in range "
+		             "[%u;%u]", reorder_ratio, ROHC_REORDERING_NONE,
+		             ROHC_REORDERING_THREEQUARTERS);
+		return false;
+	}
+
+	/* refuse to set a value if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		             "modify reorder ratio after initialization");
+		return false;
+	}
+
+	comp->reorder_ratio = reorder_ratio;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "Reorder ratio set to %u", reorder_ratio);
+
+	return true;
+}
+
+
+/**
+ * @brief Adapt the reordering ratio of the ROHCv2 contexts to the reordering
+ *
+ * Once enabled, every context of the ROHCv2 profiles adapts the reorder_ratio
+ * control field to the reordering it experiences, up to the ratio set with
+ * \ref rohc_comp_set_reorder_ratio:
+ *  \li the smallest ratio whose 4-bit MSN interpretation interval handles
+ *      the reordering depth estimated by the application with
+ *      \ref rohc_comp_set_reorder_estimate is used at least,
+ *  \li in O-mode and R-mode, the ratio is raised by one step at every NACK
+ *      received for the context, and lowered by one step every time the
+ *      context sent a few hundred packets without any NACK.
+ *
+ * On an in-order link, the contexts thus send the smallest number of MSN
+ * bits instead of the bits required by the configured ratio. A new ratio is
+ * transmitted in co_common or co_repair packets before the smaller packets
+ * are sent again.
+ *
+ * Adaptation is disabled by default.
+ *
+ * @param comp     The ROHC compressor
+ * @param enabled  Whether to enable or disable adaptation
+ * @return         true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_reorder_ratio
+ * @see rohc_comp_set_reorder_estimate
+ */
+bool rohc_comp_set_adaptive_reorder(struct rohc_comp *const comp,
+                                    const bool enabled)
+{
+	struct rohc_comp_ctxt *ctxt;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->reorder_ratio_auto = enabled;
+
+	/* the contexts in use restart from the ratio that fits the estimate */
+	for(ctxt = comp->ctxts_lru_first; ctxt != NULL; ctxt = ctxt->lru_next)
+	{
+		c_reorder_ratio_change(ctxt, c_reorder_ratio(comp));
+		ctxt->reorder_clean_pkts_nr = 0;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "adaptive reorder ratio %s (up to %u)",
+	          comp->reorder_ratio_auto ? "enabled" : "disabled",
+	          comp->reorder_ratio);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the reordering depth of the channel estimated by the application
+ *
+ * The reordering depth is the number of packets that a late packet of the
+ * channel is overtaken by, eg. the largest \e misordered_packets_nr value
+ * reported by the decompressor at the other end of the channel. When
+ * \ref rohc_comp_set_adaptive_reorder is enabled, the ROHCv2 contexts use
+ * at least the reorder ratio that handles that reordering depth. The
+ * estimation may be updated at any time.
+ *
+ * The reordering depth is 0 by default.
+ *
+ * @param comp   The ROHC compressor
+ * @param depth  The reordering depth of the channel (in packets), in range
+ *               [0;65535]
+ * @return       true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_adaptive_reorder
+ */
+bool rohc_comp_set_reorder_estimate(struct rohc_comp *const comp,
+                                    const unsigned int depth)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(depth > 0xffff)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set the reordering depth to %u packets: value must be in "
+		             "range [0;65535]", depth);
+		goto error;
+	}
+
+	comp->reorder_depth = depth;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "reordering depth set to %u packets, reorder ratio %u at least",
+	           comp->reorder_depth, c_reorder_ratio(comp));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the timeouts in packets for IR and FO periodic refreshes
+ *
+ * Set the timeout values for IR and FO periodic refreshes. The IR timeout
+ * shall be greater than the FO timeout. Both timeouts are expressed in
+ * number of compressed packets.
+ *
+ * The IR timeout is set to \ref CHANGE_TO_IR_COUNT by default.
+ * The FO timeout is set to \ref CHANGE_TO_FO_COUNT by default.
+ *
+ * @warning The values can not be modified after library initialization
+ *
+ * @param comp        The ROHC compressor
+ * @param ir_timeout  The number of packets to compress before going back
+ *                    to IR state to force a context refresh
+ * @param fo_timeout  The number of packets to compress before going back
+ *                    to FO state to force a context refresh
+ * @return            true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
+                                      const size_t ir_timeout,
+                                      const size_t fo_timeout)
+{
+	/* we need a valid compressor, positive non-zero timeouts,
+	 * and IR timeout > FO timeout */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "timeouts for context periodic refreshes (IR timeout = %zd, "
+		             "FO timeout = %zd)", ir_timeout, fo_timeout);
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the timeouts for periodic refreshes "
+		             "after initialization");
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_timeout_pkts = ir_timeout;
+	comp->periodic_refreshes_fo_timeout_pkts = fo_timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
+	          "context periodic refreshes set to %zd", ir_timeout);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
+	          "context periodic refreshes set to %zd", fo_timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the timeouts in ms for IR and FO periodic refreshes
+ *
+ * Set the timeout values for IR and FO periodic refreshes. The IR timeout
+ * shall be greater than the FO timeout. Both timeouts are expressed in
+ * milliseconds.
+ *
+ * The IR timeout is set to \ref CHANGE_TO_IR_TIME by default.
+ * The FO timeout is set to \ref CHANGE_TO_FO_TIME by default.
+ *
+ * @warning The values can not be modified after library initialization
+ *
+ * @param comp        The ROHC compressor
+ * @param ir_timeout  The delay (in ms) before going back to IR state
+ *                    to force a context refresh
+ * @param fo_timeout  The delay (in ms) before going back to FO state
+ *                    to force a context refresh
+ * @return            true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const comp,
+                                           const uint64_t ir_timeout,
+                                           const uint64_t fo_timeout)
+{
+	/* we need a valid compressor, positive non-zero timeouts,
+	 * and IR timeout > FO timeout */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid timeouts for context periodic refreshes "
+		             "(IR timeout = %" PRIu64 " ms, FO timeout = %" PRIu64 " ms)",
+		             ir_timeout, fo_timeout);
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the timeouts for periodic refreshes "
+		             "after initialization");
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_timeout_time = ir_timeout;
+	comp->periodic_refreshes_fo_timeout_time = fo_timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
+	          "context periodic refreshes set to %" PRIu64 " ms", ir_timeout);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
+	          "context periodic refreshes set to %" PRIu64 " ms", fo_timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Adapt the periodic refreshes of the contexts in U-mode to the losses
+ *
+ * The contexts in U-mode are refreshed periodically, since they receive no
+ * feedback: on a clean channel, the refreshes are pure overhead, and on a
+ * bad channel, they are too rare to resynchronize the decompressor quickly
+ * after the losses. The timeouts of the periodic refreshes, both in packets
+ * and in time, may be adapted to the loss rate given by
+ * \ref rohc_comp_set_loss_estimate:
+ *  - without loss, the timeouts are stretched to \e max_pct percents of the
+ *    configured timeouts,
+ *  - at 1% of losses, the configured timeouts are used,
+ *  - at 10% of losses or more, the timeouts shrink to \e min_pct percents of
+ *    the configured timeouts.
+ * The timeouts are interpolated linearly in between. The contexts in O-mode
+ * and R-mode keep the configured timeouts.
+ *
+ * The header bytes sent by the periodic refreshes are reported by
+ * \ref rohc_comp_get_general_info. The periodic refreshes are not adapted by
+ * default, and may be adapted at any time.
+ *
+ * @param comp     The ROHC compressor
+ * @param min_pct  The shortest timeouts (in percent of the configured
+ *                 timeouts), in range [1;100]
+ * @param max_pct  The longest timeouts (in percent of the configured
+ *                 timeouts), in range [100;1000]
+ * @return         true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_loss_estimate
+ * @see rohc_comp_set_periodic_refreshes
+ * @see rohc_comp_set_periodic_refreshes_time
+ */
+bool rohc_comp_set_adaptive_refreshes(struct rohc_comp *const comp,
+                                      const unsigned int min_pct,
+                                      const unsigned int max_pct)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(min_pct < 1 || min_pct > 100 || max_pct < 100 || max_pct > 1000)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "adapt the periodic refreshes to [%u%%;%u%%] of their "
+		             "timeouts: range shall be within [1%%;1000%%] and contain "
+		             "100%%", min_pct, max_pct);
+		goto error;
+	}
+
+	comp->refresh_adapt_min_pct = min_pct;
+	comp->refresh_adapt_max_pct = max_pct;
+	c_refresh_scale_update(comp);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "periodic refreshes "
+	          "in U-mode adapted to [%u%%;%u%%] of their timeouts, %u%% for "
+	          "the current loss estimate", min_pct, max_pct,
+	          comp->refresh_scale_pct);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the delay after which an idle context may be released
+ *
+ * A compression context that did not compress any packet during the given
+ * delay is considered as idle. Idle contexts are released by
+ * \ref rohc_comp_expire, not during the compression of packets.
+ *
+ * Contexts never expire by default. The delay may be changed at any time.
+ *
+ * @param comp     The ROHC compressor
+ * @param timeout  The delay (in ms) without packet before a context is
+ *                 considered as idle, 0 to disable context expiry
+ * @return         true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_expire
+ */
+bool rohc_comp_set_ctxt_idle_timeout(struct rohc_comp *const comp,
+                                     const uint64_t timeout)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->ctxt_idle_timeout = timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "idle timeout "
+	          "for contexts set to %" PRIu64 " ms", timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the scheduler of the periodic refreshes of the compressor
+ *
+ * The periodic refreshes of one context are brought forward by a random
+ * share of their timeouts, between 0 and the given jitter: the contexts
+ * created or refreshed at the same time, after a link outage or after
+ * \ref rohc_comp_force_contexts_reinit for example, spread their next
+ * refreshes over time instead of refreshing all at once.
+ *
+ * The periodic IR refreshes may also be limited to a budget of bytes of IR
+ * headers per interval of time. All the IR headers that are sent count
+ * against the budget. Once the budget of the current interval is exhausted,
+ * the periodic IR refreshes wait for the next interval, and the contexts
+ * may do FO refreshes meanwhile. The IR packets that are required to
+ * (re-)establish contexts are never deferred.
+ *
+ * There is no jitter and no IR budget by default. The scheduler may be
+ * changed at any time.
+ *
+ * @param comp             The ROHC compressor
+ * @param jitter           The maximal jitter in percent of the timeouts of
+ *                         the periodic refreshes, in range [0 ; 50]
+ * @param ir_budget        The number of bytes of IR headers per interval,
+ *                         0 for no limit
+ * @param budget_interval  The length (in ms) of the intervals of the IR
+ *                         budget, ignored if there is no budget
+ * @return                 true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_periodic_refreshes
+ * @see rohc_comp_set_periodic_refreshes_time
+ */
+bool rohc_comp_set_refresh_scheduler(struct rohc_comp *const comp,
+                                     const unsigned int jitter,
+                                     const size_t ir_budget,
+                                     const uint64_t budget_interval)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(jitter > 50)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid jitter of %u%% for periodic refreshes: maximum "
+		             "50%%", jitter);
+		return false;
+	}
+	if(ir_budget != 0 && budget_interval == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid interval of 0 ms for the IR budget");
+		return false;
+	}
+
+	comp->refresh_jitter_pct = jitter;
+	comp->ir_refresh_budget = ir_budget;
+	comp->ir_refresh_budget_interval = budget_interval;
+	comp->ir_refresh_budget_used = 0;
+	c_refresh_deadlines_reset(comp);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "jitter for "
+	          "periodic refreshes set to %u%%", jitter);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "budget for IR "
+	          "refreshes set to %zu bytes per %" PRIu64 " ms", ir_budget,
+	          budget_interval);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the hysteresis on the changes of IP-ID behavior
+ *
+ * The IP-ID behavior of the innermost IPv4 header of the TCP and ROHCv2
+ * contexts (sequential, sequential swapped, random or zero) is reclassified
+ * once the new behavior was observed on the given number of consecutive
+ * packets. A host that interleaves the packets of several sockets thus does
+ * not change the behavior of its context back and forth, which would require
+ * larger ROHC headers each time. An IP-ID out of pattern breaks the sequence
+ * on two consecutive packets, so 3 observations at least are required to
+ * ignore them.
+ *
+ * The IP-ID behaviors are reclassified at once by default. The hysteresis
+ * may be changed at any time.
+ *
+ * @param comp             The ROHC compressor
+ * @param observations_nr  The number of consistent observations before the
+ *                         IP-ID behavior is reclassified, in range [1 ; 63]
+ * @return                 true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_contexts_info
+ */
+bool rohc_comp_set_ip_id_hysteresis(struct rohc_comp *const comp,
+                                    const size_t observations_nr)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(observations_nr < 1 || observations_nr > ROHC_IP_ID_HYSTERESIS_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid hysteresis of %zu observations for the IP-ID "
+		             "behaviors: should be in range [1 ; %u]", observations_nr,
+		             ROHC_IP_ID_HYSTERESIS_MAX);
+		return false;
+	}
+
+	comp->ip_id_hysteresis_nr = observations_nr;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "hysteresis for "
+	          "the IP-ID behaviors set to %zu observations", observations_nr);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the memory budget of the compressor
+ *
+ * Limit the memory that the compressor allocates for its contexts, their
+ * W-LSB windows and lists, and its RRU buffer. The memory is accounted by
+ * the compressor, see \ref rohc_comp_get_mem_info.
+ *
+ * When a new context would exceed the budget, the least recently used
+ * contexts are released to make room for it: only the idle ones if an idle
+ * timeout was set with \ref rohc_comp_set_ctxt_idle_timeout, any of them
+ * otherwise. If no context may be released, the packet is refused with
+ * \ref ROHC_STATUS_NO_MEMORY.
+ *
+ * There is no budget by default. The budget may be changed at any time: the
+ * memory already allocated is kept even if it exceeds the new budget.
+ *
+ * @param comp    The ROHC compressor
+ * @param budget  The maximum number of bytes to allocate, 0 for no budget
+ * @return        true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_mem_info
+ */
+bool rohc_comp_set_mem_budget(struct rohc_comp *const comp,
+                              const size_t budget)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	rohc_mempool_set_budget(&comp->mempool, budget);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "memory budget "
+	          "set to %zu bytes", budget);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the number of uncompressed transmissions for list compression
+ *
+ * Set the number of transmissions required for list compression. This matches
+ * the L parameter described in RFC 3095 and 4815. The compressor sends the
+ * list items uncompressed L times before compressing them. The compressor
+ * also sends the list structure L times before compressing it out.
+ *
+ * The L parameter is set to \ref ROHC_OA_REPEAT_DEFAULT by default.
+ *
+ * @warning The value can not be modified after library initialization
+ *
+ * @param comp           The ROHC compressor
+ * @param list_trans_nr  The number of times the list items or the list itself
+ *                       are sent uncompressed before being sent compressed
+ * @return               true if the new value is accepted,
+ *                       false if the value is rejected
+ *
+ * @ingroup rohc_comp
+ *
+ * @deprecated please use rohc_comp_set_optimistic_approach() instead
+ */
+bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
+                                 const size_t list_trans_nr)
+{
+	/* fallback on the new function */
+	return rohc_comp_set_optimistic_approach(comp, list_trans_nr);
+}
+
+
+/**
+ * @brief Set the RTP detection callback function
+ *
+ * Set or replace the callback function that the ROHC library will call to
+ * detect RTP streams among other UDP streams.
+ *
+ * The function is called once per UDP packet to compress, with the IP and
+ * UDP headers and the UDP payload. If the callback function returns true, the
+ * RTP profile is used for compression, otherwise the IP/UDP profile is used
+ * instead.
+ *
+ * Special value NULL may be used to disable the detection of RTP streams with
+ * the callback method. The detection will then be based on a list of UDP
+ * ports dedicated for RTP streams.
+ *
+ * @param comp        The ROHC compressor
+ * @param callback    The callback function used to detect RTP packets
+ *                    The callback is deactivated if NULL is given as parameter
+ * @param rtp_private A pointer to an external memory area
+ *                    provided and used by the callback user
+ * @return            true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet rtp_detection.c define RTP detection callback
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c define ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c create ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet rtp_detection.c set RTP detection callback
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c destroy ROHC compressor
+ *
+ * @see rohc_rtp_detection_callback_t
+ * @see rohc_comp_add_rtp_port
+ * @see rohc_comp_remove_rtp_port
+ * @see rohc_comp_reset_rtp_ports
+ */
+bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
+                                    rohc_rtp_detection_callback_t callback,
+                                    void *const rtp_private)
+{
+	/* sanity check on compressor */
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	/* set RTP detection callback, forget the verdicts of the previous one */
+	comp->rtp_callback = callback;
+	comp->rtp_private = rtp_private;
+	memset(comp->rtp_verdicts, 0, sizeof(comp->rtp_verdicts));
+
+	return true;
+}
+
+
+/**
+ * @brief Set the callback notified of the events of compression contexts
+ *
+ * Set the user-defined callback function that is called every time a
+ * compression context is created, recycled for a new flow, released, or
+ * changes its state or mode. Polling the information about the last
+ * compressed packet is thus not required to follow the contexts.
+ *
+ * The callback is called synchronously from the function of the compressor
+ * that caused the event. No event is notified when the compressor is
+ * destroyed.
+ *
+ * @param comp       The ROHC compressor
+ * @param callback   The callback function notified of events, NULL to stop
+ *                   notifying them
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_ctxt_event_cb_t
+ */
+bool rohc_comp_set_ctxt_event_cb(struct rohc_comp *const comp,
+                                 rohc_comp_ctxt_event_cb_t callback,
+                                 void *const priv_ctxt)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->ctxt_event_cb = callback;
+	comp->ctxt_event_cb_priv = priv_ctxt;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the hash function of the tables of contexts
+ *
+ * The contexts are found by the hash of the fingerprint of their flow. The
+ * default SipHash-2-4 keyed with a random secret prevents an attacker from
+ * choosing flows that collide in the tables, so that the lookups stay fast
+ * whatever the traffic. The other hash functions trade that hardening for
+ * the speed of the lookups:
+ *  \li \ref ROHC_COMP_HASH_SIPHASH13 and \ref ROHC_COMP_HASH_AES are still
+ *      keyed, but lighter,
+ *  \li \ref ROHC_COMP_HASH_UNKEYED is the fastest one, for trusted traffic
+ *      only,
+ *  \li \ref ROHC_COMP_HASH_CUSTOM calls the given callback, the random
+ *      secret of the table is given to it.
+ *
+ * The hash function may be changed only before the first context is
+ * created, since the hashes of the contexts are cached in the tables.
+ *
+ * @param comp       The ROHC compressor
+ * @param hash       The hash function to use
+ * @param callback   The callback for \ref ROHC_COMP_HASH_CUSTOM, ignored for
+ *                   the other hash functions
+ * @param priv_ctxt  An optional private context for the callback, may be NULL
+ * @return           true on success,
+ *                   false if the CPU has no AES instructions for
+ *                   \ref ROHC_COMP_HASH_AES, if no callback is given for
+ *                   \ref ROHC_COMP_HASH_CUSTOM, if contexts already exist,
+ *                   or in case of other failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_hash_cb_t
+ */
+bool rohc_comp_set_hash(struct rohc_comp *const comp,
+                        const rohc_comp_hash_t hash,
+                        rohc_comp_hash_cb_t callback,
+                        void *const priv_ctxt)
+{
+	hashtable_hash_fn_t hash_fn;
+	void *hash_priv = NULL;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(comp->num_contexts_used > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to set the hash function: %u contexts already "
+		             "exist", comp->num_contexts_used);
+		goto error;
+	}
+
+	switch(hash)
+	{
+		case ROHC_COMP_HASH_SIPHASH24:
+			hash_fn = hashtable_siphash24;
+			break;
+		case ROHC_COMP_HASH_SIPHASH13:
+			hash_fn = hashtable_siphash13;
+			break;
+		case ROHC_COMP_HASH_AES:
+			if(!hashtable_aes_hash_available())
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to set the hash function: the CPU has no "
+				             "AES instructions");
+				goto error;
+			}
+			hash_fn = hashtable_aes_hash;
+			break;
+		case ROHC_COMP_HASH_UNKEYED:
+			hash_fn = hashtable_unkeyed_hash;
+			break;
+		case ROHC_COMP_HASH_CUSTOM:
+			if(callback == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to set the hash function: no callback given");
+				goto error;
+			}
+			hash_fn = rohc_comp_hash_custom;
+			hash_priv = comp;
+			break;
+		default:
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to set the hash function: unknown hash %d", hash);
+			goto error;
+	}
+
+	comp->hash_cb = (hash == ROHC_COMP_HASH_CUSTOM ? callback : NULL);
+	comp->hash_cb_priv = (hash == ROHC_COMP_HASH_CUSTOM ? priv_ctxt : NULL);
+	hashtable_set_hash(&comp->contexts_by_fingerprint, hash_fn, hash_priv);
+	hashtable_set_hash(&comp->contexts_cr, hash_fn, hash_priv);
+	hashtable_set_hash(&comp->contexts_cr_by_dst_port, hash_fn, hash_priv);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "hash function of the tables of contexts set to %d", hash);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the policy that chooses the context to recycle
+ *
+ * One context in use is recycled when one new flow needs a context and all
+ * the CIDs are in use, or when the memory budget set with
+ * \ref rohc_comp_set_mem_budget is exhausted. The least recently used
+ * context is recycled by default. The other policies choose among the
+ * \ref ROHC_COMP_EVICT_CANDIDATES_MAX least recently used contexts, so that
+ * the choice stays cheap whatever the number of contexts:
+ *  \li \ref ROHC_COMP_EVICT_LFU recycles the context that compressed the
+ *      fewest packets,
+ *  \li \ref ROHC_COMP_EVICT_SIZE_WEIGHTED recycles the context that saved
+ *      the fewest bytes of headers,
+ *  \li \ref ROHC_COMP_EVICT_PROFILE_PRIORITY recycles the context of the
+ *      least valuable profile, from Uncompressed, IP-only, ESP, UDP and
+ *      UDP-Lite, TCP to RTP,
+ *  \li \ref ROHC_COMP_EVICT_CUSTOM calls the given callback.
+ *
+ * Ties are broken in favour of the least recently used context. All the
+ * policies recycle the least recently used context if it is idle, see
+ * \ref rohc_comp_set_ctxt_idle_timeout.
+ *
+ * The policy may be changed at any time.
+ *
+ * @param comp       The ROHC compressor
+ * @param policy     The eviction policy to use
+ * @param callback   The callback for \ref ROHC_COMP_EVICT_CUSTOM, ignored
+ *                   for the other policies
+ * @param priv_ctxt  An optional private context for the callback, may be NULL
+ * @return           true on success,
+ *                   false if no callback is given for
+ *                   \ref ROHC_COMP_EVICT_CUSTOM, or in case of other failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_evict_cb_t
+ */
+bool rohc_comp_set_evict_policy(struct rohc_comp *const comp,
+                                const rohc_comp_evict_t policy,
+                                rohc_comp_evict_cb_t callback,
+                                void *const priv_ctxt)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	switch(policy)
+	{
+		case ROHC_COMP_EVICT_LRU:
+		case ROHC_COMP_EVICT_LFU:
+		case ROHC_COMP_EVICT_SIZE_WEIGHTED:
+		case ROHC_COMP_EVICT_PROFILE_PRIORITY:
+			break;
+		case ROHC_COMP_EVICT_CUSTOM:
+			if(callback == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to set the eviction policy: no callback "
+				             "given");
+				goto error;
+			}
+			break;
+		default:
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to set the eviction policy: unknown policy %d",
+			             policy);
+			goto error;
+	}
+
+	comp->evict_policy = policy;
+	comp->evict_cb = (policy == ROHC_COMP_EVICT_CUSTOM ? callback : NULL);
+	comp->evict_cb_priv = (policy == ROHC_COMP_EVICT_CUSTOM ? priv_ctxt : NULL);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "eviction policy set to %d", policy);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the engine that computes the CRCs of the compressor
+ *
+ * The CRCs of the ROHC headers, of the IR packets, of the feedbacks and the
+ * FCS-32 of the ROHC segments are computed with the tables of the library by
+ * default. Set an engine to compute them with the CRC instructions of the
+ * platform or to offload them instead. The callbacks left NULL in the engine
+ * keep the tables of the library. Give NULL to go back to the tables for all
+ * the CRCs.
+ *
+ * The engine is copied, so it does not need to outlive the call. Its CRCs
+ * shall be bit-exact with the ones of the library, some of them are cached
+ * in the contexts.
+ *
+ * @param comp    The ROHC compressor
+ * @param engine  The CRC engine to use, or NULL for the tables of the library
+ * @return        true if the engine was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_crc_engine
+ */
+bool rohc_comp_set_crc_engine(struct rohc_comp *const comp,
+                              const struct rohc_crc_engine *const engine)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(engine == NULL)
+	{
+		memset(&comp->crc_engine, 0, sizeof(struct rohc_crc_engine));
+	}
+	else
+	{
+		memcpy(&comp->crc_engine, engine, sizeof(struct rohc_crc_engine));
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "CRC engine set: %s CRC-3/7/8, %s FCS-32",
+	           (comp->crc_engine.crc_calc != NULL ? "callback" : "tables"),
+	           (comp->crc_engine.fcs32_calc != NULL ? "callback" : "tables"));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Hash the fingerprint of one flow with the callback of the user
+ *
+ * @param data  The fingerprint of the flow to hash
+ * @param len   The length of the fingerprint of the flow
+ * @param key   The random secret of the table of contexts
+ * @param priv  The ROHC compressor
+ * @return      The 64-bit hash of the flow
+ */
+static uint64_t rohc_comp_hash_custom(const void *const data,
+                                      const size_t len,
+                                      const char key[16],
+                                      void *const priv)
+{
+	const struct rohc_comp *const comp = priv;
+
+	return comp->hash_cb(data, len, (const uint8_t *) key, comp->hash_cb_priv);
+}
+
+
+/**
+ * @brief Set the UDP ports dedicated to RTP streams
+ *
+ * Detect RTP streams by their UDP destination ports, without calling any
+ * user-defined callback. A UDP packet is considered as a RTP packet if its
+ * destination port is set in the given bitmap and if its payload looks like a
+ * RTP version 2 header that is not a RTCP packet. The bitmap holds one bit
+ * for every port: port \e p is bit (p % 8) of byte (p / 8).
+ *
+ * The bitmap is copied, so it may be freed or modified once the function
+ * returned. Special value NULL disables the detection by port.
+ *
+ * The detection by port is tried first. If it does not detect a RTP packet,
+ * the RTP detection callback is asked if one was set with
+ * \ref rohc_comp_set_rtp_detection_cb.
+ *
+ * @param comp   The ROHC compressor
+ * @param ports  The bitmap of \ref ROHC_COMP_RTP_PORTS_LEN bytes of the UDP
+ *               destination ports dedicated to RTP streams, or NULL
+ * @return       true if the ports were set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_rtp_detection_cb
+ */
+bool rohc_comp_set_rtp_ports(struct rohc_comp *const comp,
+                             const uint8_t *const ports)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(ports == NULL)
+	{
+		free(comp->rtp_ports);
+		comp->rtp_ports = NULL;
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "detection of RTP streams by UDP port disabled");
+	}
+	else
+	{
+		if(comp->rtp_ports == NULL)
+		{
+			comp->rtp_ports = malloc(ROHC_COMP_RTP_PORTS_LEN);
+			if(comp->rtp_ports == NULL)
+			{
+				rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "failed to allocate memory for the UDP ports "
+				           "dedicated to RTP streams");
+				goto error;
+			}
+		}
+		memcpy(comp->rtp_ports, ports, ROHC_COMP_RTP_PORTS_LEN);
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "detection of RTP streams by UDP port enabled");
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the TS_STRIDE expected for the RTP streams of one Payload Type
+ *
+ * The compressor shall observe the RTP Timestamp (TS) of several packets of
+ * a new RTP stream before it determines the TS_STRIDE of the stream and
+ * compresses the TS with the scaled encoding of RFC 3095, §4.5.3. When the
+ * Payload Type (PT) of the stream identifies a codec with a fixed packetization
+ * interval, eg. 160 for G.711 at 8 kHz with 20 ms packets, the TS_STRIDE may
+ * be given beforehand: the compressor then transmits it in the very first IR
+ * packet of the stream and reaches the scaled encoding as soon as it was
+ * transmitted enough times or acknowledged by the decompressor.
+ *
+ * The given TS_STRIDE is only a hint: if the TS of the stream does not
+ * increase by a multiple of it, the compressor determines the TS_STRIDE from
+ * the packets as usual.
+ *
+ * The TS_STRIDE is taken into account for the contexts created afterwards.
+ *
+ * @param comp       The ROHC compressor
+ * @param pt         The RTP Payload Type in range [0, \ref ROHC_COMP_RTP_PT_NR)
+ * @param ts_stride  The TS_STRIDE of the streams of the Payload Type, 0 to
+ *                   forget the TS_STRIDE of the Payload Type
+ * @return           true if the TS_STRIDE was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_rtp_ports
+ */
+bool rohc_comp_set_rtp_ts_stride(struct rohc_comp *const comp,
+                                 const uint8_t pt,
+                                 const uint32_t ts_stride)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(pt >= ROHC_COMP_RTP_PT_NR)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid RTP Payload Type %u: shall be in range [0, %u)",
+		             pt, ROHC_COMP_RTP_PT_NR);
+		goto error;
+	}
+	if(!sdvl_can_value_be_encoded(ts_stride))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid TS_STRIDE %u for RTP Payload Type %u: too large "
+		             "for SDVL encoding", ts_stride, pt);
+		goto error;
+	}
+
+	if(comp->rtp_ts_strides == NULL)
+	{
+		if(ts_stride == 0)
+		{
+			/* nothing to forget */
+			return true;
+		}
+		comp->rtp_ts_strides = calloc(ROHC_COMP_RTP_PT_NR, sizeof(uint32_t));
+		if(comp->rtp_ts_strides == NULL)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "failed to allocate memory for the TS_STRIDE of the RTP "
+			           "Payload Types");
+			goto error;
+		}
+	}
+	comp->rtp_ts_strides[pt] = ts_stride;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "TS_STRIDE %u expected for the RTP streams with Payload Type %u",
+	          ts_stride, pt);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the maximal jitter of the channel for the timer-based RTP TS
+ *
+ * When the \ref ROHC_COMP_FEATURE_TIMER_BASED_TS feature is enabled, the
+ * compressor estimates the time between two consecutive RTP TS_SCALED
+ * values of a stream from the arrival times of its packets, see the
+ * \e time field of \ref rohc_buf. Once this TIME_STRIDE is transmitted, the
+ * decompressor approximates the TS_SCALED of every packet from its arrival
+ * time, so that the compressor only transmits the bits needed to correct the
+ * approximation (RFC 3095, §4.5.4).
+ *
+ * The maximal jitter is the largest difference between the transit times of
+ * two packets of the same stream from the compressor to the decompressor.
+ * A larger jitter makes the compressor transmit more bits of TS_SCALED. A
+ * jitter smaller than the real one makes the decompressor fail to decode
+ * the TS of the late packets.
+ *
+ * The jitter is taken into account for the contexts created afterwards. The
+ * default jitter is 20 ms.
+ *
+ * @param comp        The ROHC compressor
+ * @param max_jitter  The maximal jitter of the channel (in milliseconds), at
+ *                    most 100000 ms
+ * @return            true if the jitter was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_features
+ */
+bool rohc_comp_set_ts_timer_jitter(struct rohc_comp *const comp,
+                                   const uint32_t max_jitter)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(max_jitter > 100000U)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid jitter %u ms: shall be at most 100000 ms",
+		             max_jitter);
+		goto error;
+	}
+
+	comp->ts_timer_jitter = max_jitter;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "maximal jitter set to %u ms for the timer-based RTP TS",
+	          max_jitter);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set how often the RTP detection callback is asked for one UDP flow
+ *
+ * By default, the RTP detection callback set with
+ * \ref rohc_comp_set_rtp_detection_cb is called for every UDP packet. If the
+ * callback classifies packets by flow only, the compressor may remember its
+ * verdict for the flow and ask it again only once every \e packets_nr
+ * packets of the flow, so that most packets skip the callback.
+ *
+ * A UDP flow is identified by its innermost IP addresses and its UDP ports.
+ * The last verdicts are kept for a limited number of flows, so the callback
+ * might be asked more often than requested when many flows are compressed.
+ * Changing the callback forgets all the verdicts.
+ *
+ * @param comp        The ROHC compressor
+ * @param packets_nr  The number of packets of one UDP flow for which the
+ *                    callback is asked once, 1 to ask for every packet
+ * @return            true if the interval was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_rtp_detection_cb
+ */
+bool rohc_comp_set_rtp_detection_interval(struct rohc_comp *const comp,
+                                          const size_t packets_nr)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(packets_nr == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid interval for RTP detection: at least one packet "
+		             "required");
+		goto error;
+	}
+
+	comp->rtp_detection_interval = packets_nr;
+	memset(comp->rtp_verdicts, 0, sizeof(comp->rtp_verdicts));
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "RTP detection callback asked once every %zu packets of every "
+	          "UDP flow", packets_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set how long the flows that only the Uncompressed profile accepts
+ *        skip the classification of their packets
+ *
+ * By default, every packet is classified to find the profile that best suits
+ * it. The packets that no enabled profile but the Uncompressed profile
+ * accepts, eg. packets with IPv4 options, IP fragments or TCP segments with
+ * unsupported TCP options, go through the whole rejection analysis again and
+ * again. If the flow of such a packet is remembered, its next packets are
+ * sent with the Uncompressed profile straight away during \e ttl seconds,
+ * even if some of them could have been compressed by another profile.
+ *
+ * A flow is identified by the outer IP addresses, the transport protocol and
+ * the TCP, UDP or UDP-Lite ports. The packets of other protocols are always
+ * classified. The time of the packets given to \ref rohc_compress4 is used
+ * to expire the flows. The flows are kept for a limited number of flows only.
+ * Changing the enabled profiles or the features forgets all the flows.
+ *
+ * The Uncompressed profile shall be enabled for flows to be remembered.
+ *
+ * @param comp  The ROHC compressor
+ * @param ttl   How long (in seconds) one flow is remembered, 0 to classify
+ *              every packet (default)
+ * @return      true if the duration was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ */
+bool rohc_comp_set_uncomp_flows_ttl(struct rohc_comp *const comp,
+                                    const uint64_t ttl)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->uncomp_flows_ttl = ttl;
+	memset(comp->uncomp_flows, 0, sizeof(comp->uncomp_flows));
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "flows accepted by the Uncompressed profile only are remembered "
+	          "during %" PRIu64 " seconds", ttl);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the policy that sends the flows that compression barely shrinks
+ *        with the Uncompressed profile
+ *
+ * Compression costs about the same CPU time for every packet, whatever the
+ * bytes it saves: it saves most of the bytes of small VoIP packets, but only
+ * a few percents of the bytes of large packets of bulk transfers, eg. TCP
+ * downloads. When the CPU is the bottleneck, sending the bulk flows with the
+ * Uncompressed profile spends the CPU time where it saves the most.
+ *
+ * Every context measures the header bytes that compression saved over its
+ * last \ref ROHC_COMP_BULK_EVAL_PKTS packets. If they are fewer than
+ * \e min_savings per thousand of the uncompressed bytes, the flow of the context
+ * is sent with the Uncompressed profile and skips the classification, as the
+ * flows of \ref rohc_comp_set_uncomp_flows_ttl do:
+ *  - as soon as the measured savings per packet become larger than
+ *    \e resume_savings per thousand of the smoothed length of its packets, eg.
+ *    because the payload of the packets shrinks,
+ *  - or after \e ttl seconds, to measure its savings again,
+ * the flow is compressed again by its context. The gap between both
+ * thresholds keeps the flows from switching back and forth.
+ *
+ * The thresholds are the objective of the policy and may be changed at any
+ * time, eg. raised when the CPU load is high and lowered when it is not.
+ *
+ * A flow is identified as in \ref rohc_comp_set_uncomp_flows_ttl, and the
+ * same limited number of flows is kept. The Uncompressed profile shall be
+ * enabled for flows to be sent with it. The policy is not applied when the
+ * headers are described by \ref rohc_compress_hdrs_info.
+ *
+ * @param comp            The ROHC compressor
+ * @param min_savings     The savings (in per thousand of the uncompressed bytes)
+ *                        below which the flows are sent with the Uncompressed
+ *                        profile, 0 to disable the policy (default)
+ * @param resume_savings  The savings (in per thousand of the uncompressed bytes)
+ *                        above which the flows are compressed again, at least
+ *                        \e min_savings and at most 1000
+ * @param ttl             How long (in seconds) the flows are sent with the
+ *                        Uncompressed profile at most, not 0 if the policy is
+ *                        enabled
+ * @return                true if the policy was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_uncomp_flows_ttl
+ */
+bool rohc_comp_set_bulk_policy(struct rohc_comp *const comp,
+                               const unsigned int min_savings,
+                               const unsigned int resume_savings,
+                               const uint64_t ttl)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(min_savings > resume_savings || resume_savings > 1000)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to set the bulk policy: the resume threshold "
+		             "%u/1000 must be in range [%u;1000]", resume_savings,
+		             min_savings);
+		goto error;
+	}
+	if(min_savings > 0 && ttl == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to set the bulk policy: the TTL of the bulk flows "
+		             "must not be zero");
+		goto error;
+	}
+
+	comp->bulk_min_savings = min_savings;
+	comp->bulk_resume_savings = resume_savings;
+	comp->bulk_ttl = ttl;
+	memset(comp->uncomp_flows, 0, sizeof(comp->uncomp_flows));
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "flows saving less than %u/1000 of their bytes are sent with the "
+	          "Uncompressed profile until they save more than %u/1000 or during "
+	          "%" PRIu64 " seconds", min_savings, resume_savings, ttl);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the step of degradation of the overloaded compressor
+ *
+ * When the CPU that runs the compressor saturates, the packets that cannot be
+ * compressed in time are dropped. An overloaded compressor may instead spend
+ * less CPU time per packet, at the expense of some of the bytes saved by
+ * compression, see \ref rohc_comp_overload_t:
+ *  - the periodic IR refreshes, the most expensive packets of the contexts
+ *    that already exist, are deferred up to twice their timeouts,
+ *  - the new contexts are throttled, then no new context is created at all:
+ *    the packets of the new flows are sent with the Uncompressed profile,
+ *    that costs almost nothing, until the load decreases.
+ * The contexts that already exist keep compressing their flows at full
+ * efficiency whatever the step.
+ *
+ * The step is given by the application, eg. from the length of its queue of
+ * packets, and may be changed at any time. The compressor may also derive
+ * it from its own latency, see \ref rohc_comp_set_overload_latency: the
+ * highest of both steps applies. The current step is reported by
+ * \ref rohc_comp_get_general_info.
+ *
+ * The Uncompressed profile shall be enabled for new flows to be sent with it.
+ * The super-packets of \ref rohc_compress_gso always get a context.
+ *
+ * @param comp   The ROHC compressor
+ * @param level  The step of degradation, \ref ROHC_COMP_OVERLOAD_NONE by
+ *               default
+ * @return       true if the step was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_overload_latency
+ */
+bool rohc_comp_set_overload(struct rohc_comp *const comp,
+                            const rohc_comp_overload_t level)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(level > ROHC_COMP_OVERLOAD_SHED)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to set the overload step: unknown step %d", level);
+		goto error;
+	}
+
+	comp->overload_asked = level;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "overload step set to %d by the application", level);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Derive the step of degradation of the compressor from its latency
+ *
+ * The compressor measures the time it spends to compress every packet, and
+ * smoothes it over the last packets. Every \e step_ns of smoothed time per
+ * packet raises the degradation of the compressor by one step, see
+ * \ref rohc_comp_set_overload: eg. with a step of 2000 ns, the IR refreshes
+ * are deferred from 2000 ns per packet, and the new flows are sent with the
+ * Uncompressed profile from 6000 ns per packet. The degradation goes down
+ * again once the time per packet is a quarter of step below the current
+ * step.
+ *
+ * Measuring the latency reads the monotonic clock twice per packet. The
+ * latency is not measured by default.
+ *
+ * @param comp     The ROHC compressor
+ * @param step_ns  The compression time per packet (in ns) of one step of
+ *                 degradation, 0 to not measure the latency
+ * @return         true if the latency is measured as requested,
+ *                 false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_overload
+ */
+bool rohc_comp_set_overload_latency(struct rohc_comp *const comp,
+                                    const uint64_t step_ns)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->overload_step_ns = step_ns;
+	comp->overload_avg_ns = 0;
+	comp->overload_measured = ROHC_COMP_OVERLOAD_NONE;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "overload step raised every %" PRIu64 " ns of compression time "
+	          "per packet", step_ns);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the warm-up of the new flows before they get a context
+ *
+ * Many flows are made of one or two packets only, eg. DNS or NTP requests,
+ * or the SYN of TCP scans. Every one of them would create a context, send a
+ * full IR packet larger than its uncompressed headers, and recycle a useful
+ * context once all the CIDs are in use.
+ *
+ * During its warm-up, one new flow is sent with the Uncompressed profile. It
+ * gets a context of the best profile once it has shown the given number of
+ * packets within the given time. The packets are counted in a small table
+ * indexed by the hash of the fingerprint of the flows: two new flows may
+ * share one entry, so that one of them may get its context a bit earlier.
+ *
+ * The warm-up is disabled by default. It is always disabled if the
+ * Uncompressed profile is disabled. The flows that already have a context
+ * are not affected.
+ *
+ * @param comp       The ROHC compressor
+ * @param pkts_nr    The number of packets one new flow shall show before it
+ *                   gets a context, 0 or 1 to disable the warm-up
+ * @param window_ms  The time (in milliseconds) the packets are counted over,
+ *                   from the first one, 0 for no limit
+ * @return           true if the warm-up is set as requested,
+ *                   false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_general_info
+ */
+bool rohc_comp_set_warmup(struct rohc_comp *const comp,
+                          const size_t pkts_nr,
+                          const uint64_t window_ms)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->warmup_pkts_nr = pkts_nr;
+	comp->warmup_window_ms = window_ms;
+	memset(comp->warmup_flows, 0, sizeof(comp->warmup_flows));
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "new flows get a context after %zu packets within %" PRIu64
+	          " ms", pkts_nr, window_ms);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the callbacks used to allocate the memory of the contexts
+ *
+ * By default, the profile-specific parts of the compression contexts are
+ * carved from slabs that the compressor allocates as needed and keeps until
+ * it is destroyed. Those slabs are cache-aligned and are not shared with other
+ * compressors, so the creation and destruction of contexts do not hit the
+ * system allocator once the slabs are allocated. The blocks of contexts, their
+ * W-LSB windows and list tables, and the RRU buffer for segmentation are
+ * allocated the same way.
+ *
+ * Set user-defined callbacks to provide that memory from another allocator
+ * instead, eg. a per-core memory pool of the application, or memory mapped
+ * on huge pages of the NUMA node of the core that runs the compressor. Give
+ * NULL for both callbacks to go back to the default slabs.
+ *
+ * The callbacks cannot be changed once a context was created. The RRU buffer
+ * set by \ref rohc_comp_set_mrru before is moved to the new allocator.
+ *
+ * @param comp       The ROHC compressor
+ * @param alloc_cb   The callback to allocate memory, or NULL
+ * @param free_cb    The callback to free memory, or NULL
+ * @param priv_ctxt  The private context given to the callbacks, may be NULL
+ * @return           true if the callbacks were set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_mem_alloc_cb_t
+ * @see rohc_mem_free_cb_t
+ */
+bool rohc_comp_set_mem_cbs(struct rohc_comp *const comp,
+                           rohc_mem_alloc_cb_t alloc_cb,
+                           rohc_mem_free_cb_t free_cb,
+                           void *const priv_ctxt)
+{
+	struct rohc_mempool new_mempool;
+
+	rohc_mempool_init(&new_mempool);
+
+	/* sanity check on compressor */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* the memory of existing contexts would be freed with the wrong callbacks,
+	 * the blocks of contexts are kept once they were allocated */
+	if(comp->ctxts_next_cid != comp->ctxts_min_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "memory callbacks cannot be changed after the creation "
+		             "of contexts");
+		goto error;
+	}
+	assert(comp->num_contexts_used == 0);
+
+	/* the new allocator keeps the memory budget */
+	rohc_mempool_set_budget(&new_mempool, comp->mempool.budget);
+	new_mempool.refused_nr = comp->mempool.refused_nr;
+
+	if(!rohc_mempool_set_cbs(&new_mempool, alloc_cb, free_cb, priv_ctxt))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to set memory callbacks: both callbacks shall be "
+		             "NULL or non-NULL");
+		goto error;
+	}
+
+	/* move the RRU buffer to the new allocator */
+	if(comp->rru != NULL)
+	{
+		uint8_t *const new_rru_buf = rohc_mempool_alloc(&new_mempool, comp->mrru);
+		if(new_rru_buf == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to set memory callbacks: failed to allocate "
+			             "%zu bytes of memory for MRRU buffer", comp->mrru);
+			rohc_mempool_free(&new_mempool);
+			goto error;
+		}
+		memcpy(new_rru_buf, comp->rru, comp->mrru);
+		rohc_mempool_release(&comp->mempool, comp->rru, comp->mrru);
+		comp->rru = new_rru_buf;
+	}
+
+	rohc_mempool_free(&comp->mempool);
+	comp->mempool = new_mempool;
+
+	/* the compressor does not use the memory of its channel set any more */
+	if(comp->channel_set != NULL)
+	{
+		rohc_channel_set_leave(comp->channel_set);
+		comp->channel_set = NULL;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Preallocate all the memory that the compressor needs
+ *
+ * Allocate once all the memory that the compressor may need after setup for
+ * its contexts, their W-LSB windows and lists, its RRU buffer and the scratch
+ * contexts of \ref rohc_compress_dryrun, and reserve the slots of its tables
+ * of contexts for the maximum number of contexts. Neither the compression of
+ * packets, nor the delivery of feedback, nor the creation and the release of
+ * contexts call the system allocator afterwards.
+ *
+ * The memory is sized from the memory budget set by
+ * \ref rohc_comp_set_mem_budget if any, from the maximum number of contexts
+ * otherwise. Set a budget for compressors with many large CIDs. Beyond that
+ * memory, new contexts are refused as if the budget was exceeded. If the
+ * library was built with the check of the allocations
+ * (\e --enable-rohc-alloc-check), the program is aborted instead, so that
+ * tests may prove that the preallocated memory is large enough.
+ *
+ * The memory cannot be preallocated once a context was created, nor with
+ * memory callbacks: setting memory callbacks or a set of channels afterwards
+ * gives the preallocated memory back. The RRU buffer set by
+ * \ref rohc_comp_set_mrru before is moved to the preallocated memory. The
+ * configuration functions called afterwards may still allocate memory.
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if the memory was preallocated, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_mem_budget
+ * @see rohc_comp_get_mem_info
+ */
+bool rohc_comp_preallocate(struct rohc_comp *const comp)
+{
+	struct rohc_mempool new_mempool;
+	size_t contexts_nr;
+	size_t objs_len;
+
+	rohc_mempool_init(&new_mempool);
+
+	/* sanity check on compressor */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* the memory of existing contexts shall not move */
+	if(comp->ctxts_next_cid != comp->ctxts_min_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "memory cannot be preallocated after the creation of "
+		             "contexts");
+		goto error;
+	}
+	assert(comp->num_contexts_used == 0);
+	if(comp->mempool.alloc_cb != NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "memory cannot be preallocated with memory callbacks or "
+		             "in a set of channels");
+		goto error;
+	}
+
+	/* the contexts, the blocks of contexts, the RRU buffer, and the scratch
+	 * context with its header buffer */
+	contexts_nr = comp->ctxts_max_cid - comp->ctxts_min_cid + 1;
+	if(comp->mempool.budget > 0)
+	{
+		objs_len = comp->mempool.budget;
+	}
+	else
+	{
+		objs_len = (contexts_nr + 1) * ROHC_COMP_PREALLOC_CTXT_LEN +
+		           comp->ctxts_blocks_nr * ROHC_COMP_CTXTS_BLOCK_LEN *
+		           sizeof(struct rohc_comp_ctxt) +
+		           sizeof(struct rohc_comp_ctxt) + comp->mrru;
+	}
+
+	/* the tables of contexts shall never grow, with one more context for the
+	 * scratch context */
+	if(!hashtable_reserve(&comp->contexts_by_fingerprint, contexts_nr + 1) ||
+	   !hashtable_reserve(&comp->contexts_cr, contexts_nr + 1) ||
+	   !hashtable_reserve(&comp->contexts_cr_by_dst_port, contexts_nr + 1))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to reserve the slots of the tables of contexts");
+		goto error;
+	}
+
+	/* the new allocator keeps the memory budget */
+	rohc_mempool_set_budget(&new_mempool, comp->mempool.budget);
+	new_mempool.refused_nr = comp->mempool.refused_nr;
+
+	if(!rohc_mempool_prealloc(&new_mempool, objs_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to preallocate memory for %zu bytes of contexts",
+		             objs_len);
+		goto error;
+	}
+
+	/* move the RRU buffer to the preallocated memory */
+	if(comp->rru != NULL)
+	{
+		uint8_t *const new_rru_buf = rohc_mempool_alloc(&new_mempool, comp->mrru);
+		if(new_rru_buf == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to preallocate memory: failed to allocate "
+			             "%zu bytes of memory for MRRU buffer", comp->mrru);
+			rohc_mempool_free(&new_mempool);
+			goto error;
+		}
+		memcpy(new_rru_buf, comp->rru, comp->mrru);
+		rohc_mempool_release(&comp->mempool, comp->rru, comp->mrru);
+		comp->rru = new_rru_buf;
+	}
+
+	rohc_mempool_free(&comp->mempool);
+	comp->mempool = new_mempool;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "%zu bytes of "
+	          "memory preallocated for %zu contexts", new_mempool.arena_len,
+	          contexts_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Make the compressor join a set of ROHC channels
+ *
+ * By default, every compressor keeps slabs of its own for the memory of its
+ * contexts, see \ref rohc_comp_set_mem_cbs. Once in a set of channels, the
+ * compressor carves that memory from the slabs of the set instead, so that the
+ * memory kept by many channels with a few active flows each scales with the
+ * number of flows instead of the number of channels. The RRU buffer set by
+ * \ref rohc_comp_set_mrru and the scratch contexts of
+ * \ref rohc_compress_dryrun are allocated the same way.
+ *
+ * The compressor shall be used by the same thread as all the other channels
+ * of the set. Give NULL to leave the set and go back to the default slabs.
+ * Like the memory callbacks, the set cannot be changed once a context was
+ * created.
+ *
+ * @param comp  The ROHC compressor
+ * @param set   The set of channels to join, or NULL
+ * @return      true if the compressor joined or left the set,
+ *              false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_channel_set_new
+ * @see rohc_comp_set_mem_cbs
+ */
+bool rohc_comp_set_channel_set(struct rohc_comp *const comp,
+                               struct rohc_channel_set *const set)
+{
+	const bool is_set = (set != NULL);
+
+	if(!rohc_comp_set_mem_cbs(comp,
+	                          is_set ? rohc_channel_set_alloc : NULL,
+	                          is_set ? rohc_channel_set_release : NULL,
+	                          set))
+	{
+		goto error;
+	}
+	if(is_set)
+	{
+		rohc_channel_set_join(set);
+		comp->channel_set = set;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Is the given compression profile enabled for a compressor?
+ *
+ * @param comp     The ROHC compressor, shall be valid
+ * @param profile  The profile to ask status for
+ * @return         Possible return values:
+ *                  \li true if the profile exists and is enabled,
+ *                  \li false if the profile does not exist,
+ *                  \li false if the profile is disabled
+ *
+ * @see rohc_comp_profile_enabled
+ */
+static bool rohc_comp_profile_enabled_nocheck(const struct rohc_comp *const comp,
+                                              const rohc_profile_t profile)
+{
+	const uint8_t profile_major = (profile >> 8) & 0xff;
+	const uint8_t profile_minor = profile & 0xff;
+	return comp->enabled_profiles[profile_major][profile_minor];
+}
+
+
+/**
+ * @brief Update the best enabled profile for every class of packets
+ *
+ * The ROHCv1 profile of a class is preferred over the ROHCv2 one. The
+ * RFC3095-based profiles are limited to \ref ROHC_MAX_IP_HDRS_RFC3095 IP
+ * headers, except the IP-only profile that supports Static Chain Termination.
+ * ROHCv2 profiles do not support IPv6 extension headers yet.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void rohc_comp_update_profiles_by_class(struct rohc_comp *const comp)
+{
+	/* the ROHCv1 and ROHCv2 profiles that handle every class of packets */
+	const rohc_profile_t class_profiles[ROHC_COMP_PKT_CLASS_MAX][2] = {
+		[ROHC_COMP_PKT_CLASS_IP]           = { ROHCv1_PROFILE_IP,
+		                                       ROHCv2_PROFILE_IP },
+		[ROHC_COMP_PKT_CLASS_IP_TCP]       = { ROHCv1_PROFILE_IP_TCP,
+		                                       ROHC_PROFILE_MAX },
+		[ROHC_COMP_PKT_CLASS_IP_UDP]       = { ROHCv1_PROFILE_IP_UDP,
+		                                       ROHCv2_PROFILE_IP_UDP },
+		[ROHC_COMP_PKT_CLASS_IP_RTP]       = { ROHCv1_PROFILE_IP_UDP_RTP,
+		                                       ROHCv2_PROFILE_IP_UDP_RTP },
+		[ROHC_COMP_PKT_CLASS_IP_RTP_OTHER] = { ROHCv1_PROFILE_IP_UDP_RTP,
+		                                       ROHC_PROFILE_MAX },
+		[ROHC_COMP_PKT_CLASS_IP_ESP]       = { ROHCv1_PROFILE_IP_ESP,
+		                                       ROHCv2_PROFILE_IP_ESP },
+		[ROHC_COMP_PKT_CLASS_IP_UDPLITE]   = { ROHCv1_PROFILE_IP_UDPLITE,
+		                                       ROHCv2_PROFILE_IP_UDPLITE },
+	};
+	size_t pkt_class;
+
+	/* the profiles that accept the flows may have changed */
+	memset(comp->uncomp_flows, 0, sizeof(comp->uncomp_flows));
+
+	comp->is_uncomp_passthrough =
+		rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_UNCOMPRESSED);
+
+	for(pkt_class = 0; pkt_class < ROHC_COMP_PKT_CLASS_MAX; pkt_class++)
+	{
+		const rohc_profile_t v1_profile = class_profiles[pkt_class][0];
+		const rohc_profile_t v2_profile = class_profiles[pkt_class][1];
+		const bool is_v1_unlimited = (pkt_class == ROHC_COMP_PKT_CLASS_IP ||
+		                              pkt_class == ROHC_COMP_PKT_CLASS_IP_TCP);
+		size_t too_many_ip_hdrs;
+
+		for(too_many_ip_hdrs = 0; too_many_ip_hdrs < 2; too_many_ip_hdrs++)
+		{
+			size_t has_ipv6_exts;
+
+			for(has_ipv6_exts = 0; has_ipv6_exts < 2; has_ipv6_exts++)
+			{
+				rohc_profile_t profile = ROHC_PROFILE_MAX;
+
+				if((is_v1_unlimited || !too_many_ip_hdrs) &&
+				   rohc_comp_profile_enabled_nocheck(comp, v1_profile))
+				{
+					profile = v1_profile;
+				}
+				else if(!has_ipv6_exts && /* TODO: ROHCv2: add IPv6 ext hdrs support */
+				        v2_profile != ROHC_PROFILE_MAX &&
+				        rohc_comp_profile_enabled_nocheck(comp, v2_profile))
+				{
+					profile = v2_profile;
+				}
+				comp->profiles_by_class[pkt_class][too_many_ip_hdrs][has_ipv6_exts] =
+					profile;
+				if(profile != ROHC_PROFILE_MAX)
+				{
+					comp->is_uncomp_passthrough = false;
+				}
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief Is the given compression profile enabled for a compressor?
+ *
+ * Is the given compression profile enabled or disabled for a compressor?
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to ask status for
+ * @return         Possible return values:
+ *                  \li true if the profile exists and is enabled,
+ *                  \li false if the compressor is not valid, the profile
+ *                      does not exist, or the profile is disabled
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profile
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_profile_enabled(const struct rohc_comp *const comp,
+                               const rohc_profile_t profile)
+{
+	const uint8_t profile_major = (profile >> 8) & 0xff;
+	const uint8_t profile_minor = profile & 0xff;
+	bool is_profile_enabled;
+
+	if(comp == NULL ||
+	   profile_major > ROHC_PROFILE_ID_MAJOR_MAX ||
+	   profile_minor > ROHC_PROFILE_ID_MINOR_MAX)
+	{
+		is_profile_enabled = false;
+	}
+	else
+	{
+		is_profile_enabled = comp->enabled_profiles[profile_major][profile_minor];
+	}
+
+	return is_profile_enabled;
+}
+
+
+/**
+ * @brief Enable a compression profile for a compressor
+ *
+ * Enable a compression profiles for a compressor.
+ *
+ * The ROHC compressor does not use the compression profiles that are not
+ * enabled. Thus not enabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If the profile is already enabled, nothing is performed and success is
+ * reported.
+ *
+ * The ROHCv1 and ROHCv2 profiles are incompatible. The same profile cannot
+ * be enabled in both versions 1 and 2.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to enable
+ * @return         true if the profile exists,
+ *                 false if the profile does not exist or a similar profile is already enabled
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet simple_rohc_program.c define ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c enable ROHC compression profile
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profile
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_enable_profile(struct rohc_comp *const comp,
+                              const rohc_profile_t profile)
+{
+	const uint8_t profile_major = (profile >> 8) & 0xff;
+	const uint8_t profile_minor = profile & 0xff;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(profile_major > ROHC_PROFILE_ID_MAJOR_MAX ||
+	   profile_minor > ROHC_PROFILE_ID_MINOR_MAX ||
+	   rohc_comp_profiles[profile_major][profile_minor] == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported ROHC compression profile ID 0x%04x", profile);
+		goto error;
+	}
+
+	/* the same profile cannot be enabled in both ROHCv1 and ROHCv2 versions:
+	 * check if the corresponding profile in the other ROHC version is already
+	 * enabled or not */
+	if(rohc_comp_profile_enabled_nocheck(comp, rohc_profile_get_other_version(profile)))
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "failed to enable ROHC compression profile 0x%04x: "
+		           "incompatible profile 0x%04x is already enabled",
+		           profile, rohc_profile_get_other_version(profile));
+		goto error;
+	}
+
+	/* RFC5225, §6.1:
+	 * The compressor MUST NOT use ROHC segmentation (see Section 5.2.5 of
+	 * [RFC4995]), i.e., the Maximum Reconstructed Reception Unit (MRRU)
+	 * MUST be set to 0, if the configuration of the ROHC channel contains
+	 * at least one ROHCv2 profile in the list of supported profiles (i.e.,
+	 * the PROFILES parameter) and if the channel cannot guarantee in-order
+	 * delivery of packets between compression endpoints.
+	 */
+	if(rohc_profile_is_rohcv2(profile) && comp->mrru > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "failed to enable ROHC compression profile 0x%04x: ROHC "
+		           "segmentation is not compatible with ROHCv2 profiles", profile);
+		goto error;
+	}
+
+	/* mark the profile as enabled */
+	comp->enabled_profiles[profile_major][profile_minor] = true;
+	rohc_comp_update_profiles_by_class(comp);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "ROHC compression profile (ID = 0x%04x) enabled", profile);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Disable a compression profile for a compressor
+ *
+ * Disable a compression profile for a compressor.
+ *
+ * The ROHC compressor does not use the compression profiles that were
+ * disabled. Thus disabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If the profile is already disabled, nothing is performed and success is
+ * reported.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to disable
+ * @return         true if the profile exists,
+ *                 false if the profile does not exist
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_disable_profile(struct rohc_comp *const comp,
+                               const rohc_profile_t profile)
+{
+	const uint8_t profile_major = (profile >> 8) & 0xff;
+	const uint8_t profile_minor = profile & 0xff;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(profile_major > ROHC_PROFILE_ID_MAJOR_MAX ||
+	   profile_minor > ROHC_PROFILE_ID_MINOR_MAX ||
+	   rohc_comp_profiles[profile_major][profile_minor] == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported ROHC compression profile ID 0x%04x", profile);
+		goto error;
+	}
+
+	/* mark the profile as disabled */
+	comp->enabled_profiles[profile_major][profile_minor] = false;
+	rohc_comp_update_profiles_by_class(comp);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "ROHC compression profile (ID = 0x%04x) disabled", profile);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable several compression profiles for a compressor
+ *
+ * Enable several compression profiles for a compressor. The list of profiles
+ * to enable shall stop with -1.
+ *
+ * The ROHC compressor does not use the compression profiles that are not
+ * enabled. Thus not enabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If one or more of the profiles are already enabled, nothing is performed
+ * and success is reported.
+ *
+ * @param comp  The ROHC compressor
+ * @param ...   The sequence of compression profiles to enable, the sequence
+ *              shall be terminated by -1
+ * @return      true if all of the profiles exist,
+ *              false if at least one of the profiles does not exist
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet simple_rohc_program.c define ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c enable ROHC compression profiles
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_disable_profile
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_enable_profiles(struct rohc_comp *const comp,
+                               ...)
+{
+	va_list profiles;
+	int profile_id;
+	size_t err_nr = 0;
+	bool is_ok;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	va_start(profiles, comp);
+
+	while((profile_id = va_arg(profiles, int)) >= 0)
+	{
+		is_ok = rohc_comp_enable_profile(comp, profile_id);
+		if(!is_ok)
+		{
+			err_nr++;
+		}
+	}
+
+	va_end(profiles);
+
+	return (err_nr == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Disable several compression profiles for a compressor
+ *
+ * Disable several compression profiles for a compressor. The list of profiles
+ * to disable shall stop with -1.
+ *
+ * The ROHC compressor does not use the compression profiles that were
+ * disabled. Thus disabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If one or more of the profiles are already disabled, nothing is performed
+ * and success is reported.
+ *
+ * @param comp  The ROHC compressor
+ * @param ...   The sequence of compression profiles to disable, the sequence
+ *              shall be terminated by -1
+ * @return      true if all of the profiles exist,
+ *              false if at least one of the profiles does not exist
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profile
+ */
+bool rohc_comp_disable_profiles(struct rohc_comp *const comp,
+                                ...)
+{
+	va_list profiles;
+	int profile_id;
+	size_t err_nr = 0;
+	bool is_ok;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	va_start(profiles, comp);
+
+	while((profile_id = va_arg(profiles, int)) >= 0)
+	{
+		is_ok = rohc_comp_disable_profile(comp, profile_id);
+		if(!is_ok)
+		{
+			err_nr++;
+		}
+	}
+
+	va_end(profiles);
+
+	return (err_nr == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If set to 0, segmentation is disabled as no segment headers are allowed
+ * on the channel. No segment will be generated.
+ *
+ * According to RF5225 §6.1, ROHC segmentation cannot be enabled if any
+ * ROHCv2 profile is also enabled.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
+ *
+ * @param comp  The ROHC compressor
+ * @param mrru  The new MRRU value (in bytes)
+ * @return      true if the MRRU was successfully set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC compressor
+ * \code
+        size_t mrru = 500;
+        ...
+\endcode
+ * \snippet test_segment.c set compressor MRRU
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_comp_get_mrru
+ * @see rohc_comp_get_segment2
+ * @see rohc_decomp_set_mrru
+ */
+bool rohc_comp_set_mrru(struct rohc_comp *const comp,
+                        const size_t mrru)
+{
+	/* compressor must be valid */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
+	if(mrru > ROHC_MAX_MRRU)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unexpected MRRU value: must be in range [0, %d]",
+		             ROHC_MAX_MRRU);
+		goto error;
+	}
+
+	/* RFC5225, §6.1:
+	 * The compressor MUST NOT use ROHC segmentation (see Section 5.2.5 of
+	 * [RFC4995]), i.e., the Maximum Reconstructed Reception Unit (MRRU)
+	 * MUST be set to 0, if the configuration of the ROHC channel contains
+	 * at least one ROHCv2 profile in the list of supported profiles (i.e.,
+	 * the PROFILES parameter) and if the channel cannot guarantee in-order
+	 * delivery of packets between compression endpoints.
+	 */
+	if(mrru > 0)
+	{
+		uint8_t profile_major;
+
+		for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
+		{
+			uint8_t profile_minor;
+
+			for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
+			{
+				const uint16_t profile_id = (profile_major << 8) | profile_minor;
+
+				if(rohc_comp_profile_enabled_nocheck(comp, profile_id) &&
+				   rohc_profile_is_rohcv2(profile_id))
+				{
+					rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+					             "failed to set MRRU to %zu bytes: segmentation is not "
+					             "compatible with ROHCv2 profile 0x%04x that is enabled",
+					             mrru, profile_id);
+					goto error;
+				}
+			}
+		}
+	}
+
+	/* set new MRRU */
+	if(mrru == 0)
+	{
+		rohc_mempool_release(&comp->mempool, comp->rru, comp->mrru);
+		comp->rru = NULL;
+	}
+	else
+	{
+		uint8_t *const new_rru_buf = rohc_mempool_alloc(&comp->mempool, mrru);
+		if(new_rru_buf == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to set MRRU: failed to allocate %zu bytes "
+			             "of memory for MRRU buffer", mrru);
+			goto error;
+		}
+		rohc_mempool_release(&comp->mempool, comp->rru, comp->mrru);
+		comp->rru = new_rru_buf;
+	}
+	comp->mrru = mrru;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "MRRU is now set to %zu", comp->mrru);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * Get the current Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If MRRU value is 0, segmentation is disabled.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
+ *
+ * @param comp       The ROHC compressor
+ * @param[out] mrru  The current MRRU value (in bytes)
+ * @return           true if MRRU was successfully retrieved, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC compressor
+ * \code
+        size_t mrru;
+        ...
+\endcode
+ * \snippet test_non_regression.c get compressor MRRU
+ * \code
+        printf("the current MMRU at compressor is %zu bytes\n", mrru);
+        ...
+\endcode
+ *
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_segment2
+ * @see rohc_decomp_set_mrru
+ * @see rohc_decomp_get_mrru
+ */
+bool rohc_comp_get_mrru(const struct rohc_comp *const comp,
+                        size_t *const mrru)
+{
+	if(comp == NULL || mrru == NULL)
+	{
+		goto error;
+	}
+
+	*mrru = comp->mrru;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the maximal CID value the compressor uses
+ *
+ * Get the maximal CID value the compressor uses, ie. the \e MAX_CID parameter
+ * defined in RFC 3095.
+ *
+ * @param comp          The ROHC compressor
+ * @param[out] max_cid  The current maximal CID value
+ * @return              true if MAX_CID was successfully retrieved,
+ *                      false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_get_max_cid(const struct rohc_comp *const comp,
+                           size_t *const max_cid)
+{
+	if(comp == NULL || max_cid == NULL)
+	{
+		goto error;
+	}
+
+	*max_cid = comp->medium.max_cid;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the range of CIDs the compressor uses
+ *
+ * Get the range of CIDs the compressor gives to new contexts. The range is
+ * [0, MAX_CID] unless the compressor was created with
+ * \ref rohc_comp_new_cid_range.
+ *
+ * @param comp          The ROHC compressor
+ * @param[out] cid_min  The smallest CID the compressor uses
+ * @param[out] cid_max  The largest CID the compressor uses
+ * @return              true if the CID range was successfully retrieved,
+ *                      false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_get_cid_range(const struct rohc_comp *const comp,
+                             rohc_cid_t *const cid_min,
+                             rohc_cid_t *const cid_max)
+{
+	if(comp == NULL || cid_min == NULL || cid_max == NULL)
+	{
+		goto error;
+	}
+
+	*cid_min = comp->ctxts_min_cid;
+	*cid_max = comp->ctxts_max_cid;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CID type that the compressor uses
+ *
+ * Get the CID type that the compressor currently uses.
+ *
+ * @param comp           The ROHC compressor
+ * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
+ *                       \ref ROHC_LARGE_CID
+ * @return               true if the CID type was successfully retrieved,
+ *                       false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_get_cid_type(const struct rohc_comp *const comp,
+                            rohc_cid_type_t *const cid_type)
+{
+	if(comp == NULL || cid_type == NULL)
+	{
+		goto error;
+	}
+
+	*cid_type = comp->medium.cid_type;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable/disable features for ROHC compressor
+ *
+ * Enable/disable features for ROHC compressor. Features control whether
+ * mechanisms defined as optional by RFCs are enabled or not.
+ *
+ * Available features are listed by \ref rohc_comp_features_t. They may be
+ * combined by XOR'ing them together.
+ *
+ * @warning Changing the feature set while library is used is not supported
+ *
+ * @param comp      The ROHC compressor
+ * @param features  The feature set to enable/disable
+ * @return          true if the feature set was successfully enabled/disabled,
+ *                  false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_features_t
+ */
+bool rohc_comp_set_features(struct rohc_comp *const comp,
+                            const rohc_comp_features_t features)
+{
+	const rohc_comp_features_t all_features =
+		ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
+		ROHC_COMP_FEATURE_DUMP_PACKETS |
+		ROHC_COMP_FEATURE_TIME_BASED_REFRESHES |
+		ROHC_COMP_FEATURE_PERF_INFO |
+		ROHC_COMP_FEATURE_TIMER_BASED_TS |
+		ROHC_COMP_FEATURE_BROADCAST |
+		ROHC_COMP_FEATURE_IP_FRAGMENTS;
+
+	/* compressor must be valid */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* reject unsupported features */
+	if((features & all_features) != features)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported (supported features "
+		             "set is 0x%x)", features, all_features);
+		goto error;
+	}
+
+	/* record new feature set, the time-based refreshes may have changed */
+	comp->features = features;
+	c_refresh_deadlines_reset(comp);
+	memset(comp->uncomp_flows, 0, sizeof(comp->uncomp_flows));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver a feedback packet to the compressor
+ *
+ * When feedback is received by the decompressor, this function is called and
+ * delivers the feedback to the right profile/context of the compressor.
+ *
+ * @param comp   The ROHC compressor
+ * @param packet The feedback data
+ * @param size   The length of the feedback packet
+ * @return       true if the feedback was successfully taken into account,
+ *               false if the feedback could not be taken into account
+ */
+static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
+                                         const uint8_t *const packet,
+                                         const size_t size)
+{
+	struct rohc_comp_ctxt *context;
+	size_t cid_len;
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "deliver %zu byte(s) of feedback to the right context", size);
+
+	/* find the context the feedback is for */
+	context = rohc_comp_feedback_get_ctxt(comp, packet, size, &cid_len);
+	if(context == NULL)
+	{
+		goto error;
+	}
+
+	/* deliver feedback to profile with the context */
+	if(!rohc_comp_feedback_apply(comp, context, packet, size, cid_len))
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Find the compression context that one feedback is for
+ *
+ * @param comp          The ROHC compressor
+ * @param packet        The feedback data
+ * @param size          The length of the feedback data
+ * @param[out] cid_len  The length of the CID at the beginning of the feedback
+ * @return              The compression context, NULL if not found
+ */
+static struct rohc_comp_ctxt * rohc_comp_feedback_get_ctxt(struct rohc_comp *const comp,
+                                                           const uint8_t *const packet,
+                                                           const size_t size,
+                                                           size_t *const cid_len)
+{
+	struct rohc_comp_ctxt *context;
+	rohc_cid_t cid;
+
+	/* extract the CID from feedback */
+	if(!rohc_comp_feedback_parse_cid(comp, packet, size, &cid, cid_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: failed to extract CID from "
+		             "feedback");
+		goto error;
+	}
+
+	/* the CID may belong to another compressor of the ROHC channel */
+	if(cid < comp->ctxts_min_cid || cid > comp->ctxts_max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: CID %u is out of the CID "
+		             "range [%u, %u] of the compressor, feedback is for "
+		             "another compressor", cid, comp->ctxts_min_cid,
+		             comp->ctxts_max_cid);
+		rohc_stats_write_begin(&comp->stats_seq);
+		comp->num_feedbacks_foreign++;
+		rohc_stats_write_end(&comp->stats_seq);
+		goto error;
+	}
+
+	/* find context */
+	context = c_get_context(comp, cid);
+	if(context == NULL)
+	{
+		/* context was not found */
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: context with CID %u not found",
+		             cid);
+		goto error;
+	}
+	assert(context->cid == cid);
+	assert(context->used == 1);
+
+	return context;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Deliver one feedback to the profile of its compression context
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context the feedback is for
+ * @param packet   The feedback data
+ * @param size     The length of the feedback data
+ * @param cid_len  The length of the CID at the beginning of the feedback
+ * @return         true if the feedback was successfully taken into account,
+ *                 false if the feedback could not be taken into account
+ */
+static bool rohc_comp_feedback_apply(struct rohc_comp *const comp,
+                                     struct rohc_comp_ctxt *const context,
+                                     const uint8_t *const packet,
+                                     const size_t size,
+                                     const size_t cid_len)
+{
+	const uint8_t *const remain_data = packet + cid_len;
+	const size_t remain_len = size - cid_len;
+	enum rohc_feedback_type feedback_type;
+
+	/* the ROHC packets of a broadcast compressor are shared by many channels,
+	 * the feedback of one receiver shall not change them */
+	if((comp->features & ROHC_COMP_FEATURE_BROADCAST) != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: the compressor is in "
+		             "broadcast mode");
+		goto error;
+	}
+
+	/* FEEDBACK-1 or FEEDBACK-2 ? */
+	if(remain_len == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: empty feedback data");
+		goto error;
+	}
+	else if(remain_len == 1)
+	{
+		feedback_type = ROHC_FEEDBACK_1;
+	}
+	else
+	{
+		feedback_type = ROHC_FEEDBACK_2;
+	}
+
+	/* deliver feedback to profile with the context */
+	if(!rohc_comp_ctxt_profile(context)->feedback(context, feedback_type,
+	                                              packet, size,
+	                                              remain_data, remain_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: failed to handle FEEDBACK-%d",
+		             feedback_type);
+		goto error;
+	}
+
+	/* everything went fine */
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "FEEDBACK-%d data successfully handled", feedback_type);
+	ROHC_PROBE3(comp_feedback, context->cid, context->profile->id,
+	            feedback_type);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver a feedback packet to the compressor
+ *
+ * When feedback data is received by a decompressor, this function may be
+ * called to deliver the feedback data to the corresponding profile/context
+ * on the same-side associated compressor.
+ *
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data
+ * @return          true if the feedback was successfully taken into account,
+ *                  false if the feedback could not be taken into account
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
+                                 const struct rohc_buf feedback)
+{
+	struct rohc_buf remain_data = feedback;
+	size_t feedbacks_nr = 0;
+	size_t nr_failures = 0;
+
+	/* sanity checks */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(remain_data))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: feedback is malformed");
+		goto error;
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "deliver %zu byte(s) of feedback to the right context",
+	           remain_data.len);
+
+	/* there is nothing for compressor if feedback contains no byte at all */
+	if(rohc_buf_is_empty(remain_data))
+	{
+		goto ignore;
+	}
+
+	/* parse as much feedback data as possible */
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+		size_t feedback_len;
+
+		feedbacks_nr++;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to parse a feedback item");
+			goto error;
+		}
+		feedback_len = feedback_hdr_len + feedback_data_len;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "feedback found (header = %zu bytes, data = %zu bytes)",
+		           feedback_hdr_len, feedback_data_len);
+
+		/* reject feedback item if it doesn't fit in the available data */
+		if(feedback_len > remain_data.len)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "the %zu-byte feedback is too large for the %zu-byte "
+			             "remaining ROHC data", feedback_len, remain_data.len);
+			goto error;
+		}
+
+		/* skip the feedback header */
+		rohc_buf_pull(&remain_data, feedback_hdr_len);
+
+		/* deliver the feedback data to the compressor */
+		if(!__rohc_comp_deliver_feedback(comp, rohc_buf_data(remain_data),
+		                                 feedback_data_len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback item #%zu", feedbacks_nr);
+			nr_failures++;
+		}
+
+		/* skip the feedback data */
+		rohc_buf_pull(&remain_data, feedback_data_len);
+	}
+
+	return (nr_failures == 0);
+
+ignore:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver a burst of feedback items to the compressor
+ *
+ * Same as \ref rohc_comp_deliver_feedback2, but optimized for the frames of
+ * the reverse channel that carry many feedback items at once: the items are
+ * parsed and their contexts are found in one pass, then they are applied in
+ * a second pass. A positive ACK is skipped if a later positive ACK for the
+ * same context is found in the same pass: the decompressor builds the
+ * feedback items in order, so the later ACK acknowledges a higher SN and
+ * supersedes the earlier one. Negative ACKs are always applied, in order.
+ *
+ * @param comp       The ROHC compressor
+ * @param feedbacks  The feedback items
+ * @return           true if all the feedback items were successfully taken
+ *                   into account, false if at least one item could not be
+ *                   taken into account
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_deliver_feedback2
+ */
+bool rohc_comp_deliver_feedback_burst(struct rohc_comp *const comp,
+                                      const struct rohc_buf feedbacks)
+{
+	struct rohc_buf remain_data = feedbacks;
+	size_t feedbacks_nr = 0;
+	size_t skipped_nr = 0;
+	size_t nr_failures = 0;
+
+	/* sanity checks */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(remain_data))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: feedback is malformed");
+		goto error;
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "deliver a burst of %zu byte(s) of feedback", remain_data.len);
+
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		struct rohc_comp_feedback_item *const items = comp->feedback_burst;
+		size_t items_nr = 0;
+		size_t i;
+
+		/* first pass: parse the feedback items and find their contexts */
+		while(items_nr < ROHC_COMP_FEEDBACK_BURST_LEN && remain_data.len > 0 &&
+		      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+		{
+			struct rohc_comp_feedback_item *const item = &(items[items_nr]);
+			size_t feedback_hdr_len;
+			size_t feedback_data_len;
+
+			feedbacks_nr++;
+
+			if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+			                           &feedback_data_len))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to parse a feedback item");
+				goto error;
+			}
+			if((feedback_hdr_len + feedback_data_len) > remain_data.len)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "the %zu-byte feedback is too large for the %zu-byte "
+				             "remaining ROHC data", feedback_hdr_len +
+				             feedback_data_len, remain_data.len);
+				goto error;
+			}
+			rohc_buf_pull(&remain_data, feedback_hdr_len);
+
+			item->data = rohc_buf_data(remain_data);
+			item->len = feedback_data_len;
+			item->context = rohc_comp_feedback_get_ctxt(comp, item->data, item->len,
+			                                            &item->cid_len);
+			if(item->context == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to deliver feedback item #%zu", feedbacks_nr);
+				nr_failures++;
+			}
+			else
+			{
+				/* FEEDBACK-1 is always an ACK, FEEDBACK-2 starts with Acktype */
+				const size_t remain_len = item->len - item->cid_len;
+				item->is_ack =
+					(remain_len == 1 ||
+					 (remain_len > 1 &&
+					  (item->data[item->cid_len] >> 6) == ROHC_FEEDBACK_ACK));
+				items_nr++;
+			}
+
+			rohc_buf_pull(&remain_data, feedback_data_len);
+		}
+
+		/* second pass: apply the feedback items not superseded by later ACKs */
+		for(i = 0; i < items_nr; i++)
+		{
+			bool is_superseded = false;
+			size_t j;
+
+			for(j = i + 1; items[i].is_ack && !is_superseded && j < items_nr; j++)
+			{
+				is_superseded =
+					(items[j].is_ack && items[j].context == items[i].context);
+			}
+			if(is_superseded)
+			{
+				skipped_nr++;
+				continue;
+			}
+
+			if(!rohc_comp_feedback_apply(comp, items[i].context, items[i].data,
+			                             items[i].len, items[i].cid_len))
+			{
+				nr_failures++;
+			}
+		}
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "%zu feedback items delivered, %zu ACKs superseded by later "
+	           "ones, %zu failures", feedbacks_nr, skipped_nr, nr_failures);
+
+	return (nr_failures == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Link the ROHC compressor with a ring of feedbacks
+ *
+ * Once linked with the ring, the compressor consumes the feedbacks that the
+ * same-side decompressor pushes in the ring: the feedbacks received from the
+ * remote compressor are delivered to the compressor contexts, the feedbacks
+ * built for the remote decompressor are piggybacked on the ROHC packets
+ * returned by \ref rohc_compress4 or \ref rohc_compress_burst. See \ref rohc_comp_drain_feedback_ring
+ * to consume the feedbacks without compressing any packet.
+ *
+ * @param comp  The ROHC compressor
+ * @param ring  The ring of feedbacks, NULL to unlink the compressor
+ * @return      true if the ring was successfully linked,
+ *              false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_feedback_ring_new
+ * @see rohc_decomp_set_feedback_ring
+ */
+bool rohc_comp_set_feedback_ring(struct rohc_comp *const comp,
+                                 struct rohc_feedback_ring *const ring)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->feedback_ring = ring;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "compressor %s feedback ring", ring != NULL ?
+	           "linked with" : "unlinked from");
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Consume the feedbacks of the ring linked with the ROHC compressor
+ *
+ * Deliver to the compressor contexts all the feedbacks that the same-side
+ * decompressor received, and write at the end of the given buffer the
+ * feedbacks that the same-side decompressor built for the remote compressor,
+ * in the order they were pushed in the ring. Consumption stops at the first
+ * feedback to send that does not fit in the buffer.
+ *
+ * @param comp                The ROHC compressor
+ * @param[out] feedback_send  The buffer to store the feedbacks to send in,
+ *                            may be NULL to only deliver the received
+ *                            feedbacks up to the first feedback to send
+ * @return                    true if all the consumed received feedbacks were
+ *                            successfully delivered, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_feedback_ring
+ */
+bool rohc_comp_drain_feedback_ring(struct rohc_comp *const comp,
+                                   struct rohc_buf *const feedback_send)
+{
+	const struct rohc_feedback_ring_slot *slot;
+	size_t nr_failures = 0;
+	size_t nr = 0;
+
+	if(comp == NULL || comp->feedback_ring == NULL)
+	{
+		goto error;
+	}
+	if(feedback_send != NULL && rohc_buf_is_malformed(*feedback_send))
+	{
+		goto error;
+	}
+
+	while((slot = rohc_feedback_ring_peek(comp->feedback_ring, nr)) != NULL)
+	{
+		if(slot->is_rcvd)
+		{
+			const struct rohc_ts time = { .sec = 0, .nsec = 0 };
+			const struct rohc_buf feedback =
+				rohc_buf_init_full((uint8_t *) slot->data, slot->len, time);
+			if(!rohc_comp_deliver_feedback2(comp, feedback))
+			{
+				nr_failures++;
+			}
+		}
+		else if(feedback_send != NULL &&
+		        (feedback_send->len + slot->len) <= rohc_buf_avail_len(*feedback_send))
+		{
+			rohc_buf_append(feedback_send, slot->data, slot->len);
+		}
+		else
+		{
+			break;
+		}
+		nr++;
+	}
+	rohc_feedback_ring_release(comp->feedback_ring, nr);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "%zu feedbacks consumed from ring", nr);
+
+	return (nr_failures == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Collect the feedbacks of the ring to piggyback on one ROHC packet
+ *
+ * The received feedbacks at the head of the ring are delivered to the
+ * compressor contexts and given back to the ring. The feedbacks to send that
+ * follow them are then copied in the given buffer, up to the first one that
+ * does not fit or up to the next received feedback. They are not given back
+ * to the ring: the caller shall do it once they are piggybacked.
+ *
+ * @param comp            The ROHC compressor
+ * @param[out] dst        The buffer to copy the feedbacks to send in
+ * @param max_len         The maximal length of the feedbacks to send
+ * @param[out] slots_nr   The number of slots of the copied feedbacks
+ * @return                The length of the copied feedbacks
+ */
+static size_t rohc_comp_collect_feedbacks(struct rohc_comp *const comp,
+                                          uint8_t *const dst,
+                                          const size_t max_len,
+                                          size_t *const slots_nr)
+{
+	const struct rohc_feedback_ring_slot *slot;
+	size_t len = 0;
+	size_t nr = 0;
+
+	/* deliver the received feedbacks at the head of the ring */
+	while((slot = rohc_feedback_ring_peek(comp->feedback_ring, nr)) != NULL &&
+	      slot->is_rcvd)
+	{
+		const struct rohc_ts time = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf feedback =
+			rohc_buf_init_full((uint8_t *) slot->data, slot->len, time);
+		if(!rohc_comp_deliver_feedback2(comp, feedback))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback from ring");
+		}
+		nr++;
+	}
+	rohc_feedback_ring_release(comp->feedback_ring, nr);
+
+	/* copy the feedbacks to send that follow them */
+	nr = 0;
+	while((slot = rohc_feedback_ring_peek(comp->feedback_ring, nr)) != NULL &&
+	      !slot->is_rcvd && (len + slot->len) <= max_len)
+	{
+		memcpy(dst + len, slot->data, slot->len);
+		len += slot->len;
+		nr++;
+	}
+	*slots_nr = nr;
+
+	return len;
+}
+
+
+/**
+ * @brief Piggyback the feedbacks of the ring on one ROHC packet
+ *
+ * The feedbacks built by the same-side decompressor are written before the
+ * ROHC packet, in the headroom of the buffer or by moving the ROHC packet
+ * towards the end of the buffer. The received feedbacks found on the way are
+ * delivered to the compressor contexts. Consumption stops at the first
+ * feedback to send that does not fit in the buffer.
+ *
+ * @param comp                 The ROHC compressor
+ * @param[in,out] rohc_packet  The ROHC packet to piggyback feedbacks on
+ */
+static void rohc_comp_piggyback_feedbacks(struct rohc_comp *const comp,
+                                          struct rohc_buf *const rohc_packet)
+{
+	const struct rohc_feedback_ring_slot *slot;
+	size_t nr = 0;
+
+	while((slot = rohc_feedback_ring_peek(comp->feedback_ring, nr)) != NULL)
+	{
+		if(slot->is_rcvd)
+		{
+			const struct rohc_ts time = { .sec = 0, .nsec = 0 };
+			const struct rohc_buf feedback =
+				rohc_buf_init_full((uint8_t *) slot->data, slot->len, time);
+			if(!rohc_comp_deliver_feedback2(comp, feedback))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to deliver feedback from ring");
+			}
+		}
+		else if(slot->len <= rohc_packet->offset)
+		{
+			rohc_buf_prepend(rohc_packet, slot->data, slot->len);
+		}
+		else if((rohc_packet->len + slot->len) <= rohc_buf_avail_len(*rohc_packet))
+		{
+			memmove(rohc_buf_data(*rohc_packet) + slot->len,
+			        rohc_buf_data(*rohc_packet), rohc_packet->len);
+			memcpy(rohc_buf_data(*rohc_packet), slot->data, slot->len);
+			rohc_packet->len += slot->len;
+		}
+		else
+		{
+			break;
+		}
+		nr++;
+	}
+	rohc_feedback_ring_release(comp->feedback_ring, nr);
+}
+
+
+/**
+ * @brief Get some information about the last compressed packet
+ *
+ * Get some information about the last compressed packet.
+ *
+ * The function may be called from another thread than the one that
+ * compresses packets: the sizes and the packet type are then those of one
+ * same packet.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_last_packet_info2_t structure for details about
+ * fields that are supported in the above versions.
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_last_packet_info2_t
+ */
+bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
+                                     rohc_comp_last_packet_info2_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(comp->last_context == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "last context found in compressor is not valid");
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for last packet information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		uint32_t seq;
+
+		if(info->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "last packet information", info->version_minor);
+			goto error;
+		}
+
+		do
+		{
+			const struct rohc_comp_ctxt *ctxt;
+
+			seq = rohc_stats_read_begin(&comp->stats_seq);
+			ctxt = comp->last_context;
+
+			/* base fields for major version 0 */
+			info->context_id = ctxt->cid;
+			info->is_context_init = (ctxt->num_sent_packets == 1);
+			info->context_mode = ctxt->mode;
+			info->context_state = ctxt->state;
+			info->context_used = (ctxt->used ? true : false);
+			info->profile_id = ctxt->profile->id;
+			info->packet_type = ctxt->packet_type;
+			info->total_last_uncomp_size = ctxt->total_last_uncompressed_size;
+			info->header_last_uncomp_size = ctxt->header_last_uncompressed_size;
+			info->total_last_comp_size = ctxt->total_last_compressed_size;
+			info->header_last_comp_size = ctxt->header_last_compressed_size;
+		}
+		while(rohc_stats_read_retry(&comp->stats_seq, seq));
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for last "
+		           "packet information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get a snapshot of the statistics of the compressor
+ *
+ * Get the 64-bit statistics of the compressor, with the statistics of the
+ * compressed packets broken down by profile and by packet type.
+ *
+ * The statistics may be read from another thread than the one that
+ * compresses packets: they are copied as one consistent snapshot and the
+ * compressor is never blocked by the reader.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param comp           The ROHC compressor to get statistics from
+ * @param[in,out] stats  The structure where statistics will be stored
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_stats_t
+ */
+bool rohc_comp_get_stats(const struct rohc_comp *const comp,
+                         rohc_comp_stats_t *const stats)
+{
+	uint32_t seq;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(stats == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for statistics is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		if(stats->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "statistics", stats->version_minor);
+			goto error;
+		}
+		do
+		{
+			seq = rohc_stats_read_begin(&comp->stats_seq);
+			stats->packets_nr = comp->num_packets;
+			stats->uncomp_bytes_nr = comp->total_uncompressed_size;
+			stats->comp_bytes_nr = comp->total_compressed_size;
+			memcpy(stats->pkts, comp->pkt_stats, sizeof(comp->pkt_stats));
+		}
+		while(rohc_stats_read_retry(&comp->stats_seq, seq));
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "statistics", stats->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some information about the memory used by the compressor
+ *
+ * Get the number of bytes allocated by the compressor for its contexts,
+ * their W-LSB windows and lists, and its RRU buffer, together with the
+ * memory budget set by \ref rohc_comp_set_mem_budget.
+ *
+ * The function shall be called from the thread that compresses packets.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_mem_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_mem_info_t
+ */
+bool rohc_comp_get_mem_info(const struct rohc_comp *const comp,
+                            rohc_comp_mem_info_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for memory information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		if(info->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "memory information", info->version_minor);
+			goto error;
+		}
+		info->used_bytes_nr = comp->mempool.objs_len;
+		info->slabs_bytes_nr = comp->mempool.slabs_nr * ROHC_MEMPOOL_SLAB_LEN;
+		info->budget_bytes_nr = comp->mempool.budget;
+		info->refused_nr = comp->mempool.refused_nr;
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "memory information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Export the records of the compression contexts in use
+ *
+ * Fill the given array with one record for every context in use, from the
+ * most recently used context to the least recently used one. Only the
+ * contexts in use are visited, so the export does not depend on MAX_CID.
+ * The number of contexts in use is given by \ref rohc_comp_get_general_info.
+ *
+ * @param comp         The ROHC compressor to get contexts from
+ * @param records      The array of records to fill
+ * @param records_max  The maximum number of records to fill
+ * @return             The number of records filled, 0 in case of error
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_ctxt_record
+ */
+size_t rohc_comp_get_contexts_info(const struct rohc_comp *const comp,
+                                   struct rohc_comp_ctxt_record *const records,
+                                   const size_t records_max)
+{
+	const struct rohc_comp_ctxt *ctxt;
+	size_t records_nr = 0;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(records == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "array of context records is not valid");
+		goto error;
+	}
+
+	for(ctxt = comp->ctxts_lru_first;
+	    ctxt != NULL && records_nr < records_max;
+	    ctxt = ctxt->lru_next)
+	{
+		c_ctxt_record(ctxt, &records[records_nr]);
+		records_nr++;
+	}
+
+	return records_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Fill the public record of one compression context in use
+ *
+ * @param ctxt    The compression context in use
+ * @param record  OUT: The record to fill
+ */
+static void c_ctxt_record(const struct rohc_comp_ctxt *const ctxt,
+                          struct rohc_comp_ctxt_record *const record)
+{
+	record->cid = ctxt->cid;
+	record->profile_id = ctxt->profile->id;
+	record->state = ctxt->state;
+	record->mode = ctxt->mode;
+	record->packets_nr = ctxt->num_sent_packets;
+	record->hdr_bytes_nr = ctxt->header_compressed_size;
+	record->uncomp_hdr_bytes_nr = ctxt->header_uncompressed_size;
+	record->last_used_sec = ctxt->latest_used.sec;
+	record->ip_id_behavior_changes_nr = ctxt->ip_id_behavior_changes_nr;
+	record->processing_ns = ctxt->processing_ns;
+}
+
+
+/**
+ * @brief Save the compression contexts in use in a binary image
+ *
+ * One record is saved for every context in use, from the least recently used
+ * context to the most recently used one: its generic part, its
+ * profile-specific part, and its W-LSB windows. The image may be written to
+ * a file, then given to \ref rohc_comp_restore_contexts after one restart,
+ * so that the flows go on in the FO or SO states without sending IR packets
+ * again.
+ *
+ * Only the contexts of the Uncompressed and ROHCv2 profiles are saved, the
+ * contexts of the other profiles are skipped: their flows restart in the IR
+ * state. The contexts being replicated are skipped too.
+ *
+ * The image is only valid for the same build of the library on the same
+ * architecture. It is not aligned, so it may be read from any address.
+ *
+ * @param comp            The ROHC compressor to save the contexts of
+ * @param image           The buffer to save the image in, may be NULL
+ * @param image_max_len   The length of the buffer
+ * @param[out] image_len  The length of the image, even if it does not fit
+ *                        in the buffer
+ * @return                true if the image was saved,
+ *                        false if the buffer is too small or in case of error
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_restore_contexts
+ */
+bool rohc_comp_save_contexts(const struct rohc_comp *const comp,
+                             uint8_t *const image,
+                             const size_t image_max_len,
+                             size_t *const image_len)
+{
+	const struct rohc_comp_ctxt *ctxt;
+	size_t ctxts_nr = 0;
+	size_t len;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(image_len == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "length of context image is not valid");
+		goto error;
+	}
+
+	len = sizeof(struct rohc_ctxt_image_hdr);
+	for(ctxt = comp->ctxts_lru_last; ctxt != NULL; ctxt = ctxt->lru_prev)
+	{
+		const bool is_room = (image != NULL && len < image_max_len);
+		size_t rec_len;
+
+		if(c_save_context(ctxt, is_room ? image + len : NULL,
+		                  is_room ? image_max_len - len : 0, &rec_len))
+		{
+			len += rec_len;
+			ctxts_nr++;
+		}
+	}
+	*image_len = len;
+
+	if(image == NULL || len > image_max_len)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "buffer too small for context image: %zu bytes required, "
+		           "only %zu bytes available", len, image_max_len);
+		goto error;
+	}
+	if(len > UINT32_MAX)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "context image too large: %zu bytes", len);
+		goto error;
+	}
+	rohc_ctxt_image_set_hdr(image, ROHC_CTXT_IMAGE_COMP, ctxts_nr, len);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts saved in a context image of %zu bytes",
+	          ctxts_nr, len);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Restore the compression contexts saved in a binary image
+ *
+ * Every context saved by \ref rohc_comp_save_contexts is restored with the
+ * same CID, so that the remote decompressor keeps on decompressing the flows.
+ * The records of the contexts that cannot be restored are skipped, and their
+ * flows restart in the IR state:
+ *  \li the CID is out of the range of the compressor or already in use,
+ *  \li the profile is disabled,
+ *  \li the context is malformed,
+ *  \li memory is missing.
+ *
+ * The statistics of the restored contexts start again from zero, except the
+ * number of packets sent that the profiles rely on. The periodic refreshes
+ * and the idle timeouts take the given time as the last time the contexts
+ * were used.
+ *
+ * @param comp           The ROHC compressor to restore the contexts in
+ * @param image          The image saved by \ref rohc_comp_save_contexts
+ * @param image_len      The length of the image
+ * @param now            The current time
+ * @param[out] ctxts_nr  The number of contexts restored
+ * @return               true if the image was read, even if some contexts
+ *                       were skipped, false if the image is malformed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_save_contexts
+ */
+bool rohc_comp_restore_contexts(struct rohc_comp *const comp,
+                                const uint8_t *const image,
+                                const size_t image_len,
+                                const struct rohc_ts now,
+                                size_t *const ctxts_nr)
+{
+	size_t recs_nr;
+	size_t offset;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(image == NULL || ctxts_nr == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "context image or number of contexts is not valid");
+		goto error;
+	}
+	if(!rohc_ctxt_image_check(image, image_len, ROHC_CTXT_IMAGE_COMP, &recs_nr))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "malformed context image: unexpected header");
+		goto error;
+	}
+
+	*ctxts_nr = 0;
+	offset = sizeof(struct rohc_ctxt_image_hdr);
+	for(i = 0; i < recs_nr; i++)
+	{
+		struct rohc_ctxt_image_rec rec;
+
+		if(!rohc_ctxt_image_get_rec(image, image_len, &offset, &rec))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "malformed context image: record #%zu is truncated", i + 1);
+			goto error;
+		}
+		if(c_restore_context(comp, &rec, image + offset, now))
+		{
+			(*ctxts_nr)++;
+		}
+		offset += rec.generic_len + rec.profile_len;
+	}
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts restored from a context image of %zu records",
+	          *ctxts_nr, recs_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Export one compression context in a binary image
+ *
+ * The context is saved in an image of one record, in the format of
+ * \ref rohc_comp_save_contexts. The image may be given to
+ * \ref rohc_comp_import_context on another compressor of the same channel
+ * to move the context without resetting it, to rebalance the flows between
+ * several compressors or to keep one standby compressor up-to-date.
+ *
+ * If the context is released, its CID is free for new flows once the export
+ * succeeded: the context is expected to go on in another compressor.
+ *
+ * @param comp            The ROHC compressor to export the context from
+ * @param cid             The CID of the context to export
+ * @param do_release      Whether to release the context once exported
+ * @param image           The buffer to save the image in, may be NULL
+ * @param image_max_len   The length of the buffer
+ * @param[out] image_len  The length of the image, even if it does not fit
+ *                        in the buffer
+ * @return                true if the image was saved, false if the context
+ *                        is not in use or cannot be exported, if the buffer
+ *                        is too small, or in case of error
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_import_context
+ */
+bool rohc_comp_export_context(struct rohc_comp *const comp,
+                              const rohc_cid_t cid,
+                              const bool do_release,
+                              uint8_t *const image,
+                              const size_t image_max_len,
+                              size_t *const image_len)
+{
+	const size_t hdr_len = sizeof(struct rohc_ctxt_image_hdr);
+	struct rohc_comp_ctxt *ctxt;
+	size_t rec_len;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(image_len == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "length of context image is not valid");
+		goto error;
+	}
+	if(cid < comp->ctxts_min_cid || cid >= comp->ctxts_next_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to export context with CID %u: context not in use",
+		             cid);
+		goto error;
+	}
+	ctxt = c_ctxt_at(comp, cid);
+	if(!ctxt->used)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to export context with CID %u: context not in use",
+		             cid);
+		goto error;
+	}
+
+	if(!c_save_context(ctxt, (image != NULL && hdr_len < image_max_len) ?
+	                         image + hdr_len : NULL,
+	                   (image != NULL && hdr_len < image_max_len) ?
+	                   image_max_len - hdr_len : 0, &rec_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ctxt->profile->id,
+		             "failed to export context with CID %u: profile does not "
+		             "support context images", cid);
+		goto error;
+	}
+	*image_len = hdr_len + rec_len;
+	if(image == NULL || (*image_len) > image_max_len)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ctxt->profile->id,
+		           "buffer too small for context image: %zu bytes required, "
+		           "only %zu bytes available", *image_len, image_max_len);
+		goto error;
+	}
+	rohc_ctxt_image_set_hdr(image, ROHC_CTXT_IMAGE_COMP, 1, *image_len);
+	rohc_info(comp, ROHC_TRACE_COMP, ctxt->profile->id,
+	          "context with CID %u exported in a context image of %zu bytes",
+	          cid, *image_len);
+
+	if(do_release)
+	{
+		if(comp->last_context == ctxt)
+		{
+			comp->last_context = NULL;
+		}
+		c_ctxt_event(ctxt, ROHC_COMP_CTXT_EVENT_RELEASED, ctxt->state, ctxt->mode);
+		c_release_context(comp, ctxt);
+		c_free_ctxts_push(comp, ctxt);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Import one compression context from a binary image
+ *
+ * The context exported by \ref rohc_comp_export_context is inserted in the
+ * compressor with the same CID, in the same state and mode. It is indexed by
+ * its fingerprint, and as a base context for Context Replication if it is
+ * established, so that the packets of the flow are compressed at once
+ * without sending IR packets again.
+ *
+ * @param comp       The ROHC compressor to import the context in
+ * @param image      The image exported with \ref rohc_comp_export_context
+ * @param image_len  The length of the image
+ * @param now        The current time
+ * @return           true if the context was imported, false if the image is
+ *                   malformed or if the context cannot be imported, see
+ *                   \ref rohc_comp_restore_contexts
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_export_context
+ */
+bool rohc_comp_import_context(struct rohc_comp *const comp,
+                              const uint8_t *const image,
+                              const size_t image_len,
+                              const struct rohc_ts now)
+{
+	struct rohc_ctxt_image_rec rec;
+	size_t offset = sizeof(struct rohc_ctxt_image_hdr);
+	size_t recs_nr;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(image == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "context image is not valid");
+		goto error;
+	}
+	if(!rohc_ctxt_image_check(image, image_len, ROHC_CTXT_IMAGE_COMP, &recs_nr) ||
+	   recs_nr != 1 ||
+	   !rohc_ctxt_image_get_rec(image, image_len, &offset, &rec))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "malformed context image: one context expected");
+		goto error;
+	}
+
+	return c_restore_context(comp, &rec, image + offset, now);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Create one compression context ahead of the first packet of a flow
+ *
+ * The context for the flow of the given template packet is created with the
+ * given CID, outside of the data path: the classification of the packet and
+ * the creation of the profile-specific context do not delay the first packet
+ * of the flow anymore. The template packet is not compressed: the context
+ * starts in the IR state, so the first packet of the flow that is given to
+ * \ref rohc_compress4 is sent as an IR packet that establishes the context
+ * with the remote decompressor.
+ *
+ * The headers of the template packet shall be the ones of the flow. The
+ * payload is not used, and the fields that change from packet to packet
+ * (IP-ID, RTP SN and TS for example) are updated by the first packet.
+ *
+ * @param comp          The ROHC compressor
+ * @param template_pkt  The template packet of the flow
+ * @param cid           The CID of the context to create, it shall be unused
+ * @return              true if the context was created,
+ *                      false if no profile matches the template packet, if
+ *                      one context already exists for the flow, if the CID
+ *                      is already in use or out of range, or in case of
+ *                      error
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_prewarm_context(struct rohc_comp *const comp,
+                               const struct rohc_buf template_pkt,
+                               const rohc_cid_t cid)
+{
+	const struct rohc_comp_profile *profile;
+	struct rohc_fingerprint fingerprint;
+	struct rohc_pkt_hdrs pkt_hdrs;
+	struct rohc_comp_ctxt *ctxt;
+	rohc_profile_t profile_id;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(template_pkt) || rohc_buf_is_empty(template_pkt))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given template packet is malformed or empty");
+		goto error;
+	}
+	if(cid < comp->ctxts_min_cid || cid > comp->ctxts_max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "CID %u is outside the range [%u ; %u] of the compressor",
+		             cid, comp->ctxts_min_cid, comp->ctxts_max_cid);
+		goto error;
+	}
+
+	/* what ROHC profile fits the template packet best? */
+	profile_id = rohc_comp_get_profile(comp, &template_pkt, &fingerprint,
+	                                   &pkt_hdrs, comp->rtp_verdicts);
+	if(profile_id == ROHC_PROFILE_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to find a matching profile among the enabled profiles "
+		             "for the template packet");
+		goto error;
+	}
+	profile = rohc_comp_profiles[(profile_id >> 8) & 0xff][profile_id & 0xff];
+	if(profile == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "profile '%s' (0x%04x) is not implemented yet",
+		             rohc_get_profile_descr(profile_id), profile_id);
+		goto error;
+	}
+
+	/* the flow shall not be compressed yet */
+	if((profile->id == ROHCv1_PROFILE_UNCOMPRESSED) ?
+	   (comp->uncompressed_ctxt != NULL) :
+	   (hashtable_get(&comp->contexts_by_fingerprint, &fingerprint,
+	                  rohc_fingerprint_len(&fingerprint)) != NULL))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "one context already exists for the flow of the template "
+		             "packet");
+		goto error;
+	}
+
+	ctxt = c_free_ctxts_take(comp, cid);
+	if(ctxt == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "CID %u is already in use or no memory", cid);
+		goto error;
+	}
+	if(!c_init_context(comp, ctxt, profile, &fingerprint, &pkt_hdrs,
+	                   template_pkt.time))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "failed to create the context with CID %u", cid);
+		goto error;
+	}
+	if(profile->id != ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		c_flows_cache_add(comp, ctxt);
+	}
+	rohc_info(comp, ROHC_TRACE_COMP, profile->id,
+	          "context with CID %u pre-warmed for profile '%s' (0x%04x)", cid,
+	          rohc_get_profile_descr(profile->id), profile->id);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the durations of the phases of compression
+ *
+ * Get the histograms of the durations of the phases of compression. The
+ * durations are measured only once the \ref ROHC_COMP_FEATURE_PERF_INFO
+ * feature is enabled with \ref rohc_comp_set_features, the histograms are
+ * empty otherwise.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_perf_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_perf_info_t
+ * @see rohc_perf_histo_bucket_min
+ */
+bool rohc_comp_get_perf_info(const struct rohc_comp *const comp,
+                             rohc_comp_perf_info_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for performance information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		if(info->version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "performance information", info->version_minor);
+			goto error;
+		}
+		memcpy(info->phases, comp->perf_histos, sizeof(comp->perf_histos));
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "performance information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some general information about the compressor
+ *
+ * Get some general information about the compressor.
+ *
+ * The counters may be read from another thread than the one that
+ * compresses packets, see \ref rohc_comp_get_stats.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_general_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *
+ * See the \ref rohc_comp_general_info_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_general_info_t
+ */
+bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
+                                rohc_comp_general_info_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for general information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		uint32_t seq;
+
+		if(info->version_minor > 7)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "general information", info->version_minor);
+			goto error;
+		}
+
+		do
+		{
+			seq = rohc_stats_read_begin(&comp->stats_seq);
+
+			/* base fields for major version 0 */
+			info->contexts_nr = comp->num_contexts_used;
+			info->packets_nr = comp->num_packets;
+			info->uncomp_bytes_nr = comp->total_uncompressed_size;
+			info->comp_bytes_nr = comp->total_compressed_size;
+
+			/* new fields added by minor versions */
+			if(info->version_minor >= 1)
+			{
+				info->contexts_evicted_nr = comp->num_contexts_evicted;
+			}
+			if(info->version_minor >= 2)
+			{
+				info->contexts_expired_nr = comp->num_contexts_expired;
+			}
+			if(info->version_minor >= 3)
+			{
+				info->feedbacks_foreign_nr = comp->num_feedbacks_foreign;
+			}
+			if(info->version_minor >= 4)
+			{
+				info->ir_refreshes_deferred_nr = comp->num_ir_refreshes_deferred;
+			}
+			if(info->version_minor >= 5)
+			{
+				info->overload_level = c_overload_level(comp);
+				info->overload_shed_nr = comp->num_overload_shed;
+			}
+			if(info->version_minor >= 6)
+			{
+				info->refreshes_nr = comp->num_refreshes;
+				info->refresh_bytes_nr = comp->num_refresh_bytes;
+			}
+			if(info->version_minor >= 7)
+			{
+				info->warmup_held_nr = comp->num_warmup_held;
+			}
+		}
+		while(rohc_stats_read_retry(&comp->stats_seq, seq));
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "general information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Give a description for the given ROHC compression context state
+ *
+ * Give a description for the given ROHC compression context state.
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of compression context states
+ * used by the library. If unsure, ask on the mailing list.
+ *
+ * @param state  The compression context state to get a description for
+ * @return       A string that describes the given compression context state
+ *
+ * @ingroup rohc_comp
+ */
+const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
+{
+	switch(state)
+	{
+		case ROHC_COMP_STATE_IR:
+			return "IR";
+		case ROHC_COMP_STATE_FO:
+			return "FO";
+		case ROHC_COMP_STATE_SO:
+			return "SO";
+		case ROHC_COMP_STATE_CR:
+			return "CR";
+		case ROHC_COMP_STATE_UNKNOWN:
+		default:
+			return "no description";
+	}
+}
+
+
+/*
+ * Definitions of private functions
+ */
+
+
+/**
+ * @brief Create a compression context
+ *
+ * @param comp         The ROHC compressor
+ * @param profile      The profile to associate the context with
+ * @param fingerprint  The packet/context fingerprint
+ * @param pkt_hdrs     The information collected about packet headers
+ * @param pkt_time     The arrival time of the packet
+ * @return             The compression context if successful, NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	c_create_context(struct rohc_comp *const comp,
+	                 const struct rohc_comp_profile *const profile,
+	                 const struct rohc_fingerprint *const fingerprint,
+	                 const struct rohc_pkt_hdrs *const pkt_hdrs,
+	                 const struct rohc_ts pkt_time)
+{
+	struct rohc_comp_ctxt *c;
+	rohc_cid_t cid_to_use;
+
+	/* if all the contexts in the array are used:
+	 *   => recycle the context chosen by the eviction policy to make room
+	 * if at least one context in the array is not used:
+	 *   => pick the first unused context
+	 */
+	if(comp->num_contexts_used > (comp->ctxts_max_cid - comp->ctxts_min_cid))
+	{
+		/* all the contexts in the array were used, recycle the context chosen
+		 * by the eviction policy to make some room */
+		c = c_evict_select(comp, profile->id, pkt_time);
+		assert(c != NULL);
+		cid_to_use = c->cid;
+
+		/* destroy the context before replacing it with a new one */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "recycle context (CID %u with profile 0x%04x)",
+		           cid_to_use, c->profile->id);
+		ROHC_PROBE2(comp_ctxt_recycled, cid_to_use, c->profile->id);
+		c_ctxt_event(c, ROHC_COMP_CTXT_EVENT_RECYCLED, c->state, c->mode);
+		c_release_context(comp, c);
+		rohc_stats_write_begin(&comp->stats_seq);
+		comp->num_contexts_evicted++;
+		rohc_stats_write_end(&comp->stats_seq);
+	}
+	else
+	{
+		/* there was at least one unused context in the array, pick the first
+		 * unused context in the list of free contexts */
+		c = c_free_ctxts_pop(comp);
+		if(c == NULL)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "cannot allocate memory for a new context");
+			goto error;
+		}
+		cid_to_use = c->cid;
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "take the first unused context (CID %u)", cid_to_use);
+	}
+
+	if(!c_init_context(comp, c, profile, fingerprint, pkt_hdrs, pkt_time))
+	{
+		goto error;
+	}
+
+	return c;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Initialize one unused compression context for the given packet
+ *
+ * The context is initialized from the packet, or as a replication of the
+ * best base context if Context Replication is possible. The context is then
+ * marked as used. The context is given back to the list of free contexts in
+ * case of failure.
+ *
+ * @param comp         The ROHC compressor
+ * @param c            The unused context, its CID shall be set
+ * @param profile      The profile to associate the context with
+ * @param fingerprint  The packet/context fingerprint
+ * @param pkt_hdrs     The information collected about packet headers
+ * @param pkt_time     The arrival time of the packet
+ * @return             true if successful, false otherwise
+ */
+static bool c_init_context(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const c,
+                           const struct rohc_comp_profile *const profile,
+                           const struct rohc_fingerprint *const fingerprint,
+                           const struct rohc_pkt_hdrs *const pkt_hdrs,
+                           const struct rohc_ts pkt_time)
+{
+	const rohc_cid_t cid_to_use = c->cid;
+	const struct rohc_comp_ctxt *base_ctxt = NULL;
+
+	/* search for a possible base context if Context Replication is possible */
+	if(rohc_comp_profile_has_cr(profile))
+	{
+		const size_t base_len = rohc_fingerprint_base_len(&fingerprint->base);
+		size_t best_ctxt_affinity = ROHC_AFFINITY_NONE;
+		struct rohc_comp_ctxt *candidate;
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "search a base context for Context Replication");
+
+		/* first look for a base context of medium affinity that shares the
+		 * destination port with the packet: the index is exact, so the first
+		 * candidate that accepts the replication is the best one */
+		for(candidate = hashtable_get(&comp->contexts_cr_by_dst_port,
+		                              c_cr_dst_port_key(fingerprint),
+		                              c_cr_dst_port_key_len(fingerprint));
+		    candidate != NULL && base_ctxt == NULL;
+		    candidate = hashtable_get_next(&comp->contexts_cr_by_dst_port,
+		                                   c_cr_dst_port_key(fingerprint),
+		                                   c_cr_dst_port_key_len(fingerprint),
+		                                   candidate))
+		{
+			assert(candidate->fingerprint.src_port != fingerprint->src_port);
+			if(profile->is_cr_possible(candidate, pkt_hdrs))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "CR: context CID %u shares the destination port with "
+				           "packet, maximum affinity reached", candidate->cid);
+				base_ctxt = candidate;
+				best_ctxt_affinity = ROHC_AFFINITY_MED;
+			}
+		}
+
+		/* otherwise, search among all the base contexts that we may clone the
+		 * new context from */
+		for(candidate = (base_ctxt != NULL ? NULL :
+		                 hashtable_get(&comp->contexts_cr, &fingerprint->base,
+		                               base_len));
+		    candidate != NULL;
+		    candidate = hashtable_get_next(&comp->contexts_cr, &fingerprint->base,
+		                                   base_len, candidate))
+		{
+			/* context partially matches the fingerprint of the packet */
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "CR: context CID %u shares enough with packet for base context",
+			           candidate->cid);
+
+			/* check if context may be used as a base context */
+			if(!profile->is_cr_possible(candidate, pkt_hdrs))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "CR: context CID %u cannot be used as base context: "
+				           "IR-CR packet cannot transmit some differences",
+				           candidate->cid);
+			}
+			else
+			{
+				/* context can be used base context for Context Replication (CR),
+				 * compute how much it shares with packet */
+				rohc_ctxt_affinity_t ctxt_affinity = ROHC_AFFINITY_LOW;
+				if(candidate->fingerprint.src_port == fingerprint->src_port)
+				{
+					ctxt_affinity++;
+				}
+				if(candidate->fingerprint.dst_port == fingerprint->dst_port)
+				{
+					ctxt_affinity++;
+				}
+				assert(ctxt_affinity != ROHC_AFFINITY_HIGH);
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "CR: context CID %u scores %u as base context",
+				           candidate->cid, ctxt_affinity);
+				if(ctxt_affinity > best_ctxt_affinity)
+				{
+					base_ctxt = candidate;
+					best_ctxt_affinity = ctxt_affinity;
+					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+					           "CR: context CID %u is the best base context found yet",
+					           candidate->cid);
+					if(ctxt_affinity == ROHC_AFFINITY_MED)
+					{
+						rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+						           "CR: maximum affinity reached, stop search");
+						break;
+					}
+				}
+			}
+		}
+
+		if(base_ctxt != NULL)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "CR: context CID %u is the best base context found",
+			           base_ctxt->cid);
+		}
+		else
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "CR: no context may be used as base context");
+		}
+	}
+
+	/* context replication? */
+	if(base_ctxt != NULL)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "create context with CID %u as a replication of context "
+		           "with CID %u", cid_to_use, base_ctxt->cid);
+
+		/* copy the base context, then reset some parts of it */
+		memcpy(c, base_ctxt, sizeof(struct rohc_comp_ctxt));
+		c->do_ctxt_replication = true;
+		c->cr_base_cid = base_ctxt->cid;
+		c->state = ROHC_COMP_STATE_CR;
+	}
+	else
+	{
+		c->do_ctxt_replication = false;
+		c->state = ROHC_COMP_STATE_IR;
+	}
+
+	c_reset_context(comp, c, cid_to_use, profile, fingerprint, pkt_time);
+
+	/* create profile-specific context */
+	if(c->do_ctxt_replication)
+	{
+		if(!profile->clone(c, base_ctxt))
+		{
+			goto free_ctxt;
+		}
+	}
+	else
+	{
+		if(!profile->create(c, pkt_hdrs))
+		{
+			goto free_ctxt;
+		}
+	}
+
+	/* insert the context in the hash table of contexts to efficiently find it
+	 * again through its fingerprint */
+	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		comp->uncompressed_ctxt = c;
+	}
+	else if(!hashtable_add(&comp->contexts_by_fingerprint, &(c->fingerprint),
+	                       rohc_fingerprint_len(&c->fingerprint), c))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to insert context with CID %u in the hash table",
+		             cid_to_use);
+		profile->destroy(c);
+		goto free_ctxt;
+	}
+	else
+	{
+		c_addr_index_add(comp, c);
+	}
+
+	/* if creation is successful, mark the context as used */
+	c->used = 1;
+	c->first_used = pkt_time.sec;
+	c->latest_used = pkt_time;
+	assert(comp->num_contexts_used <= (comp->ctxts_max_cid - comp->ctxts_min_cid));
+	comp->num_contexts_used++;
+	c_lru_add_first(comp, c);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "context (CID %u) created at %" PRIu64 " seconds (num_used = %u)",
+	           c->cid, c->latest_used.sec, comp->num_contexts_used);
+	ROHC_PROBE2(comp_ctxt_created, c->cid, profile->id);
+	c_ctxt_event(c, ROHC_COMP_CTXT_EVENT_CREATED, c->state, c->mode);
+	return true;
+
+free_ctxt:
+	c->used = 0;
+	c_free_ctxts_push(comp, c);
+	return false;
+}
+
+
+/**
+ * @brief Reset the generic part of one compression context for a new flow
  *
- * The L parameter is set to \ref ROHC_OA_REPEAT_DEFAULT by default.
+ * @param comp         The ROHC compressor
+ * @param c            The compression context to reset
+ * @param cid          The CID of the context
+ * @param profile      The profile to associate the context with
+ * @param fingerprint  The packet/context fingerprint
+ * @param pkt_time     The arrival time of the packet
+ */
+static void c_reset_context(struct rohc_comp *const comp,
+                            struct rohc_comp_ctxt *const c,
+                            const rohc_cid_t cid,
+                            const struct rohc_comp_profile *const profile,
+                            const struct rohc_fingerprint *const fingerprint,
+                            const struct rohc_ts pkt_time)
+{
+	memcpy(&c->fingerprint, fingerprint, sizeof(struct rohc_fingerprint));
+
+	c->state_oa_repeat_nr = 0;
+	c->go_back_fo_count = 0;
+	c->go_back_fo_time = pkt_time;
+	c->go_back_ir_count = 0;
+	c->go_back_ir_time = pkt_time;
+	c->refresh_jitter = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
+	c->refresh_pkts_left = 0;
+	c->is_refreshing = false;
+
+	rohc_stats_write_begin(&comp->stats_seq);
+
+	c->total_uncompressed_size = 0;
+	c->total_compressed_size = 0;
+	c->header_uncompressed_size = 0;
+	c->header_compressed_size = 0;
+
+	c->total_last_uncompressed_size = 0;
+	c->total_last_compressed_size = 0;
+	c->header_last_uncompressed_size = 0;
+	c->header_last_compressed_size = 0;
+	c->ip_id_behavior_changes_nr = 0;
+	c->processing_ns = 0;
+
+	c->num_sent_packets = 0;
+
+	c->bulk_ref_pkts_nr = 0;
+	c->bulk_ref_uncomp_size = 0;
+	c->bulk_ref_hdr_uncomp_size = 0;
+	c->bulk_ref_hdr_comp_size = 0;
+
+	rohc_stats_write_end(&comp->stats_seq);
+
+	/* the static chain is built again for the CID of the new context */
+	c->static_chain.len = 0;
+
+	c->wlsb_width = comp->oa_repetitions_nr;
+	c->oa_repetitions_nr = c_oa_repetitions(comp);
+	c->oa_clean_pkts_nr = 0;
+	c->reorder_ratio = c_reorder_ratio(comp);
+	c->reorder_ratio_trans_nr = comp->oa_repetitions_nr; /* sent in IR packets */
+	c->reorder_clean_pkts_nr = 0;
+	c->wlsb_ack_in_window = false;
+	c->wlsb_ack_lag = 0;
+	c->wlsb_ack_interval = 0;
+	c->wlsb_ack_pkt_nr = 0;
+
+	c->cid = cid;
+	c->profile = profile;
+
+	c->mode = ROHC_U_MODE;
+
+	c->compressor = comp;
+	c->is_dryrun = false;
+}
+
+
+/**
+ * @brief Get the fragments of the next bytes of the RRU
  *
- * @warning The value can not be modified after library initialization
+ * The RRU is either the one copied in the compressor or the one that
+ * references the ROHC header, the payload and the CRC.
  *
- * @param comp           The ROHC compressor
- * @param list_trans_nr  The number of times the list items or the list itself
- *                       are sent uncompressed before being sent compressed
- * @return               true if the new value is accepted,
- *                       false if the value is rejected
+ * @param comp      The ROHC compressor
+ * @param len       The number of bytes of the RRU from the current offset
+ * @param[out] iov  The fragments of data, 3 at most
+ * @return          The number of fragments of data
+ */
+static size_t c_rru_get_iov(const struct rohc_comp *const comp,
+                            const size_t len,
+                            struct rohc_comp_seg_iov *const iov)
+{
+	size_t skip = comp->rru_off;
+	size_t remain = len;
+	size_t iov_nr = 0;
+	size_t i;
+
+	assert(len <= comp->rru_len);
+
+	if(comp->rru_iov_nr == 0)
+	{
+		iov[0].data = comp->rru + comp->rru_off;
+		iov[0].len = len;
+		return 1;
+	}
+
+	for(i = 0; i < comp->rru_iov_nr && remain > 0; i++)
+	{
+		if(skip >= comp->rru_iov[i].len)
+		{
+			skip -= comp->rru_iov[i].len;
+			continue;
+		}
+		iov[iov_nr].data = comp->rru_iov[i].data + skip;
+		iov[iov_nr].len = rohc_min(comp->rru_iov[i].len - skip, remain);
+		remain -= iov[iov_nr].len;
+		skip = 0;
+		iov_nr++;
+	}
+	assert(remain == 0);
+
+	return iov_nr;
+}
+
+
+/**
+ * @brief Copy one compression context into a scratch context for a dry run
  *
- * @ingroup rohc_comp
+ * The profile-specific part is duplicated through a context image, so that
+ * the encoding of the scratch context does not change the original one.
  *
- * @deprecated please use rohc_comp_set_optimistic_approach() instead
+ * @param comp     The ROHC compressor
+ * @param scratch  The scratch context
+ * @param ctxt     The compression context to copy
+ * @return         \ref ROHC_STATUS_OK if successful,
+ *                 \ref ROHC_STATUS_NO_MEMORY if memory is missing,
+ *                 \ref ROHC_STATUS_ERROR otherwise
+ */
+static rohc_status_t c_dryrun_copy_context(struct rohc_comp *const comp,
+                                           struct rohc_comp_ctxt *const scratch,
+                                           const struct rohc_comp_ctxt *const ctxt)
+{
+	const size_t image_len = ctxt->profile->save(ctxt, NULL, 0);
+	uint8_t empty_image = 0;
+	uint8_t *image = &empty_image;
+	bool is_restored;
+
+	if(image_len > 0)
+	{
+		image = rohc_mempool_alloc(&comp->mempool, image_len);
+		if(image == NULL)
+		{
+			return ROHC_STATUS_NO_MEMORY;
+		}
+		if(ctxt->profile->save(ctxt, image, image_len) != image_len)
+		{
+			rohc_mempool_release(&comp->mempool, image, image_len);
+			return ROHC_STATUS_ERROR;
+		}
+	}
+
+	memcpy(scratch, ctxt, sizeof(struct rohc_comp_ctxt));
+	scratch->is_dryrun = true;
+	scratch->specific = NULL;
+	is_restored = ctxt->profile->restore(scratch, image, image_len);
+
+	if(image_len > 0)
+	{
+		rohc_mempool_release(&comp->mempool, image, image_len);
+	}
+
+	return (is_restored ? ROHC_STATUS_OK : ROHC_STATUS_ERROR);
+}
+
+
+/**
+ * @brief Create a scratch context for the dry run of the first packet of a flow
+ *
+ * The scratch context gets the CID that a new context would get, so that the
+ * ROHC header has the same length.
+ *
+ * @param comp         The ROHC compressor
+ * @param scratch      The scratch context
+ * @param profile      The profile to associate the context with
+ * @param fingerprint  The packet fingerprint
+ * @param pkt_hdrs     The information collected about packet headers
+ * @param pkt_time     The arrival time of the packet
+ * @return             \ref ROHC_STATUS_OK if successful,
+ *                     \ref ROHC_STATUS_ERROR otherwise
+ */
+static rohc_status_t c_dryrun_new_context(struct rohc_comp *const comp,
+                                          struct rohc_comp_ctxt *const scratch,
+                                          const struct rohc_comp_profile *const profile,
+                                          const struct rohc_fingerprint *const fingerprint,
+                                          const struct rohc_pkt_hdrs *const pkt_hdrs,
+                                          const struct rohc_ts pkt_time)
+{
+	rohc_cid_t cid;
+
+	/* the CID of the context chosen by the eviction policy if one context
+	 * would be recycled, the first unused CID otherwise */
+	if(comp->num_contexts_used > (comp->ctxts_max_cid - comp->ctxts_min_cid))
+	{
+		cid = c_evict_select(comp, profile->id, pkt_time)->cid;
+	}
+	else if(comp->ctxts_free != NULL)
+	{
+		cid = comp->ctxts_free->cid;
+	}
+	else
+	{
+		cid = comp->ctxts_next_cid;
+	}
+
+	memset(scratch, 0, sizeof(struct rohc_comp_ctxt));
+	scratch->do_ctxt_replication = false;
+	scratch->state = ROHC_COMP_STATE_IR;
+	c_reset_context(comp, scratch, cid, profile, fingerprint, pkt_time);
+	scratch->is_dryrun = true;
+	if(!profile->create(scratch, pkt_hdrs))
+	{
+		return ROHC_STATUS_ERROR;
+	}
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Compute the affinity between the given packet and context
+ *
+ * @param ctxt             The context to compute the affinity with
+ * @param pkt_fingerprint  The fingerprint of the packet to compute the affinity with
+ * @param pkt_hdrs         The information collected about packet headers
+ * @return                 The affinity between the packet and context
+ */
+static rohc_ctxt_affinity_t
+	rohc_comp_get_ctxt_affinity(const struct rohc_comp_ctxt *const ctxt,
+	                            const struct rohc_fingerprint *const pkt_fingerprint,
+	                            const struct rohc_pkt_hdrs *const pkt_hdrs)
+{
+	size_t affinity;
+
+	if(memcmp(&ctxt->fingerprint.base, &pkt_fingerprint->base,
+	          sizeof(struct rohc_fingerprint_base)) == 0)
+	{
+		/* the context partially matches, it might be used as a base for Context
+		 * Replication (CR) since the profile of the packet supports CR */
+		assert(rohc_comp_profile_has_cr(ctxt->profile));
+		if(ctxt->profile->is_cr_possible(ctxt, pkt_hdrs))
+		{
+			/* context can be used base context for Context Replication (CR),
+			 * compute how much it shares with packet */
+			affinity = ROHC_AFFINITY_LOW;
+			if(ctxt->fingerprint.src_port == pkt_fingerprint->src_port)
+			{
+				affinity++;
+			}
+			if(ctxt->fingerprint.dst_port == pkt_fingerprint->dst_port)
+			{
+				affinity++;
+			}
+		}
+		else
+		{
+			affinity = ROHC_AFFINITY_NONE;
+		}
+	}
+	else
+	{
+		affinity = ROHC_AFFINITY_NONE;
+	}
+
+	return affinity;
+}
+
+
+/**
+ * @brief Find a compression context given an IP packet
+ *
+ * @param comp             The ROHC compressor
+ * @param profile          The profile to use
+ * @param packet           The packet to find a compression context for
+ * @param pkt_fingerprint  The packet fingerprint
+ * @param pkt_hdrs         The information collected about packet headers
+ * @param may_shed         Whether the overloaded compressor, or the warm-up of
+ *                         the new flows, may refuse a new context to the
+ *                         packet, the refusal being counted in the
+ *                         statistics of the compressor
+ * @return                 The context if found or successfully created,
+ *                         NULL if not found
  */
-bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
-                                 const size_t list_trans_nr)
+static struct rohc_comp_ctxt *
+	rohc_comp_find_ctxt(struct rohc_comp *const comp,
+	                    const struct rohc_comp_profile *const profile,
+	                    const struct rohc_buf *const packet,
+	                    const struct rohc_fingerprint *const pkt_fingerprint,
+	                    const struct rohc_pkt_hdrs *const pkt_hdrs,
+	                    const bool may_shed)
 {
-	/* fallback on the new function */
-	return rohc_comp_set_optimistic_approach(comp, list_trans_nr);
+	struct rohc_comp_ctxt **rss_entry = NULL;
+	struct rohc_comp_ctxt *context;
+
+	/* the hash computed by the NIC, if given, is the first index to look at
+	 * for the profiles without any other index */
+	if(comp->hdrs_info != NULL && comp->hdrs_info->has_rss_hash &&
+	   profile->id != ROHCv1_PROFILE_UNCOMPRESSED &&
+	   !rohc_comp_profile_is_esp(profile->id))
+	{
+		rss_entry = &comp->ctxts_by_rss[c_rss_idx(comp->hdrs_info->rss_hash)];
+	}
+
+	/* get the context matching the packet */
+	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		/* there is already one context with the Uncompressed profile, and
+		 * there is no need for several contexts, let's re-use that one */
+		context = comp->uncompressed_ctxt;
+	}
+	else if(rohc_comp_profile_is_esp(profile->id))
+	{
+		const size_t fingerprint_len = rohc_fingerprint_len(pkt_fingerprint);
+		const size_t spi_idx = c_esp_spi_idx(pkt_fingerprint->esp_spi);
+
+		/* search for the context of the SA, first in the index by SPI, then in
+		 * the hash table ; the SPI alone does not identify the SA, so check the
+		 * whole fingerprint, outer addresses included */
+		context = comp->esp_by_spi[spi_idx];
+		if(context == NULL ||
+		   context->fingerprint.esp_spi != pkt_fingerprint->esp_spi ||
+		   memcmp(&context->fingerprint, pkt_fingerprint, fingerprint_len) != 0)
+		{
+			context = hashtable_get(&comp->contexts_by_fingerprint,
+			                        pkt_fingerprint, fingerprint_len);
+			if(context != NULL)
+			{
+				comp->esp_by_spi[spi_idx] = context;
+			}
+		}
+	}
+	else /* non-Uncompressed profiles */
+	{
+		const size_t fingerprint_len = rohc_fingerprint_len(pkt_fingerprint);
+		const size_t cache_idx = c_flows_cache_idx(pkt_fingerprint);
+
+		/* search for an existing context matching the packet fingerprint,
+		 * first in the index by NIC hash, then in the cache of the last flows,
+		 * then in the hash table */
+		context = (rss_entry != NULL ? *rss_entry : NULL);
+		if(context == NULL || !context->used ||
+		   memcmp(&context->fingerprint, pkt_fingerprint, fingerprint_len) != 0)
+		{
+			context = comp->flows_cache[cache_idx];
+			if(context == NULL ||
+			   memcmp(&context->fingerprint, pkt_fingerprint, fingerprint_len) != 0)
+			{
+				context = hashtable_get(&comp->contexts_by_fingerprint,
+				                        pkt_fingerprint, fingerprint_len);
+				if(context != NULL)
+				{
+					comp->flows_cache[cache_idx] = context;
+				}
+			}
+			if(context != NULL && rss_entry != NULL)
+			{
+				*rss_entry = context;
+			}
+		}
+
+		/* hmmm, looks like we could re-use that context ; if Context Replication
+		 * is in action, check that the base context didn't change too much */
+		if(context != NULL &&
+		   rohc_comp_profile_has_cr(profile) &&
+		   context->do_ctxt_replication &&
+		   context->state == ROHC_COMP_STATE_CR &&
+		   context->state_oa_repeat_nr < context->oa_repetitions_nr)
+		{
+			/* Context Replication is in action, so check whether the base context
+			 * changed too much to be re-used or not */
+			const struct rohc_comp_ctxt *const base_ctxt =
+				c_ctxt_at(comp, context->cr_base_cid);
+			rohc_ctxt_affinity_t base_ctxt_affinity;
+
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "Context Replication in action (%u/%u packets sent): check "
+			           "for CID %u whether base context with CID %u changed too much",
+			           context->state_oa_repeat_nr, context->oa_repetitions_nr,
+			           context->cid, base_ctxt->cid);
+
+			/* there are two ways the base context may have changed:
+			 *   - the base context now matches exactly the replicated context
+			 *   - the base context does not share enough with the replicated context */
+			base_ctxt_affinity =
+				rohc_comp_get_ctxt_affinity(base_ctxt, pkt_fingerprint, pkt_hdrs);
+			if(base_ctxt_affinity != ROHC_AFFINITY_NONE)
+			{
+				/* no large change, we may continue the Context Replication */
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "re-using context CID %u as a replication of context "
+				           "CID %u", context->cid, base_ctxt->cid);
+			}
+			else
+			{
+				/* too much change, we need to interrupt the Context Replication */
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "cannot re-use context CID %u as replication of context "
+				           "CID %u, the base context changed too much", context->cid,
+				           base_ctxt->cid);
+				context = NULL;
+				/* TODO: destroy that half-opened context */
+			}
+		}
+	}
+
+	if(context != NULL)
+	{
+		/* matching context found, update use timestamp */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "re-using context CID %u", context->cid);
+		context->latest_used = packet->time;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "context (CID %u) used at %" PRIu64 " seconds",
+		           context->cid, context->latest_used.sec);
+		if(comp->ctxts_lru_first != context)
+		{
+			c_lru_del(comp, context);
+			c_lru_add_first(comp, context);
+		}
+	}
+	else if(may_shed && profile->id != ROHCv1_PROFILE_UNCOMPRESSED &&
+	        !c_overload_may_create(comp))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no existing context found for packet, but the compressor "
+		           "is overloaded: do not create it");
+		rohc_stats_write_begin(&comp->stats_seq);
+		comp->num_overload_shed++;
+		rohc_stats_write_end(&comp->stats_seq);
+	}
+	else if(may_shed && profile->id != ROHCv1_PROFILE_UNCOMPRESSED &&
+	        !c_warmup_may_create(comp, pkt_fingerprint, packet->time))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no existing context found for packet, but the new flow "
+		           "is still warming up: do not create it");
+		rohc_stats_write_begin(&comp->stats_seq);
+		comp->num_warmup_held++;
+		rohc_stats_write_end(&comp->stats_seq);
+	}
+	else /* context not found, create a new one */
+	{
+		size_t mem_refused_nr;
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no existing context found for packet, create it");
+
+		/* create the new context from packet (and from the base context if
+		 * Context Replication is possible), release the contexts chosen by the
+		 * eviction policy as long as the memory budget refuses the creation */
+		do
+		{
+			mem_refused_nr = comp->mempool.refused_nr;
+			context = c_create_context(comp, profile, pkt_fingerprint, pkt_hdrs,
+			                           packet->time);
+		}
+		while(context == NULL && comp->mempool.refused_nr != mem_refused_nr &&
+		      c_evict_for_budget(comp, profile->id, packet->time));
+		if(context == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create a new context");
+		}
+		else if(profile->id != ROHCv1_PROFILE_UNCOMPRESSED)
+		{
+			c_flows_cache_add(comp, context);
+			if(rss_entry != NULL)
+			{
+				*rss_entry = context;
+			}
+		}
+	}
+
+	return context;
 }
 
 
 /**
- * @brief Set the RTP detection callback function
- *
- * Set or replace the callback function that the ROHC library will call to
- * detect RTP streams among other UDP streams.
- *
- * The function is called once per UDP packet to compress, with the IP and
- * UDP headers and the UDP payload. If the callback function returns true, the
- * RTP profile is used for compression, otherwise the IP/UDP profile is used
- * instead.
+ * @brief Find out a context given its CID
  *
- * Special value NULL may be used to disable the detection of RTP streams with
- * the callback method. The detection will then be based on a list of UDP
- * ports dedicated for RTP streams.
+ * @param comp The ROHC compressor
+ * @param cid  The CID of the context to find
+ * @return     The context with the given CID if found, NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	struct rohc_comp_ctxt *ctxt;
+
+	/* the context with the given CID must have been allocated */
+	if(cid < comp->ctxts_min_cid || cid >= comp->ctxts_next_cid)
+	{
+		goto not_found;
+	}
+
+	/* the context with the given CID must be in use */
+	ctxt = c_ctxt_at(comp, cid);
+	if(ctxt->used == 0)
+	{
+		goto not_found;
+	}
+
+	return ctxt;
+
+not_found:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the context with the given CID in the table of contexts
  *
- * @param comp        The ROHC compressor
- * @param callback    The callback function used to detect RTP packets
- *                    The callback is deactivated if NULL is given as parameter
- * @param rtp_private A pointer to an external memory area
- *                    provided and used by the callback user
- * @return            true on success, false otherwise
+ * The block of contexts that contains the given CID shall be allocated, ie.
+ * the CID shall have been used at least once.
  *
- * @ingroup rohc_comp
+ * @param comp The ROHC compressor
+ * @param cid  The CID of the context to get
+ * @return     The context with the given CID, used or not
+ */
+static inline struct rohc_comp_ctxt *
+	c_ctxt_at(const struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	const size_t idx = cid - comp->ctxts_min_cid;
+	const size_t block_idx = idx / ROHC_COMP_CTXTS_BLOCK_LEN;
+
+	assert(cid >= comp->ctxts_min_cid);
+	assert(cid < comp->ctxts_next_cid);
+	assert(block_idx < comp->ctxts_blocks_nr);
+	assert(comp->ctxts_blocks[block_idx] != NULL);
+
+	return &(comp->ctxts_blocks[block_idx][idx % ROHC_COMP_CTXTS_BLOCK_LEN]);
+}
+
+
+/**
+ * @brief Create the table of compression contexts
  *
- * \par Example:
- * \snippet rtp_detection.c define RTP detection callback
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c define ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c create ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet rtp_detection.c set RTP detection callback
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c destroy ROHC compressor
+ * Only the first level of the table is allocated: the blocks of contexts
+ * are allocated later when their first CID is used.
  *
- * @see rohc_rtp_detection_callback_t
- * @see rohc_comp_add_rtp_port
- * @see rohc_comp_remove_rtp_port
- * @see rohc_comp_reset_rtp_ports
+ * @param comp The ROHC compressor
+ * @return     true if the creation is successful, false otherwise
  */
-bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
-                                    rohc_rtp_detection_callback_t callback,
-                                    void *const rtp_private)
+static bool c_create_contexts(struct rohc_comp *const comp)
 {
-	/* sanity check on compressor */
-	if(comp == NULL)
+	assert(comp->ctxts_blocks == NULL);
+
+	comp->num_contexts_used = 0;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "create enough room for %u contexts (CIDs %u to %u)",
+	          comp->ctxts_max_cid - comp->ctxts_min_cid + 1,
+	          comp->ctxts_min_cid, comp->ctxts_max_cid);
+
+	comp->ctxts_blocks_nr =
+		(comp->ctxts_max_cid - comp->ctxts_min_cid + ROHC_COMP_CTXTS_BLOCK_LEN) /
+		ROHC_COMP_CTXTS_BLOCK_LEN;
+	comp->ctxts_blocks = calloc(comp->ctxts_blocks_nr,
+	                            sizeof(struct rohc_comp_ctxt *));
+	if(comp->ctxts_blocks == NULL)
 	{
-		return false;
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for contexts");
+		goto error;
 	}
 
-	/* set RTP detection callback */
-	comp->rtp_callback = callback;
-	comp->rtp_private = rtp_private;
+	/* no context was used yet */
+	comp->ctxts_next_cid = comp->ctxts_min_cid;
+	comp->ctxts_free = NULL;
+	comp->ctxts_lru_first = NULL;
+	comp->ctxts_lru_last = NULL;
 
 	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Is the given compression profile enabled for a compressor?
+ * @brief Destroy all the compression contexts in the context array
  *
- * @param comp     The ROHC compressor, shall be valid
- * @param profile  The profile to ask status for
- * @return         Possible return values:
- *                  \li true if the profile exists and is enabled,
- *                  \li false if the profile does not exist,
- *                  \li false if the profile is disabled
+ * The profile-specific contexts are also destroyed.
  *
- * @see rohc_comp_profile_enabled
+ * @param comp The ROHC compressor
  */
-static bool rohc_comp_profile_enabled_nocheck(const struct rohc_comp *const comp,
-                                              const rohc_profile_t profile)
+static void c_destroy_contexts(struct rohc_comp *const comp)
 {
-	const uint8_t profile_major = (profile >> 8) & 0xff;
-	const uint8_t profile_minor = profile & 0xff;
-	return comp->enabled_profiles[profile_major][profile_minor];
-}
+	rohc_cid_t i;
+	size_t j;
 
+	for(i = comp->ctxts_min_cid; i < comp->ctxts_next_cid; i++)
+	{
+		struct rohc_comp_ctxt *const ctxt = c_ctxt_at(comp, i);
 
-/**
- * @brief Is the given compression profile enabled for a compressor?
- *
- * Is the given compression profile enabled or disabled for a compressor?
- *
- * @param comp     The ROHC compressor
- * @param profile  The profile to ask status for
- * @return         Possible return values:
- *                  \li true if the profile exists and is enabled,
- *                  \li false if the compressor is not valid, the profile
- *                      does not exist, or the profile is disabled
+		if(ctxt->used && ctxt->profile != NULL)
+		{
+			ctxt->profile->destroy(ctxt);
+		}
+
+		if(ctxt->used)
+		{
+			ctxt->used = 0;
+			assert(comp->num_contexts_used > 0);
+			comp->num_contexts_used--;
+		}
+	}
+	assert(comp->num_contexts_used == 0);
+
+	for(j = 0; j < comp->ctxts_blocks_nr; j++)
+	{
+		rohc_mempool_release(&comp->mempool, comp->ctxts_blocks[j],
+		                     ROHC_COMP_CTXTS_BLOCK_LEN * sizeof(struct rohc_comp_ctxt));
+	}
+	free(comp->ctxts_blocks);
+	comp->ctxts_blocks = NULL;
+	comp->ctxts_blocks_nr = 0;
+	comp->ctxts_next_cid = comp->ctxts_min_cid;
+	comp->ctxts_free = NULL;
+	comp->ctxts_lru_first = NULL;
+	comp->ctxts_lru_last = NULL;
+	memset(comp->flows_cache, 0, sizeof(comp->flows_cache));
+	memset(comp->esp_by_spi, 0, sizeof(comp->esp_by_spi));
+	memset(comp->ctxts_by_rss, 0, sizeof(comp->ctxts_by_rss));
+	memset(comp->ctxts_by_addr, 0, sizeof(comp->ctxts_by_addr));
+	memset(&comp->prefetch, 0, sizeof(comp->prefetch));
+}
+
+
+/**
+ * @brief Add the given context at the head of the LRU list
  *
- * @ingroup rohc_comp
+ * The context becomes the most recently used context.
  *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profile
- * @see rohc_comp_disable_profiles
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to add to the LRU list
  */
-bool rohc_comp_profile_enabled(const struct rohc_comp *const comp,
-                               const rohc_profile_t profile)
+static void c_lru_add_first(struct rohc_comp *const comp,
+                            struct rohc_comp_ctxt *const ctxt)
 {
-	const uint8_t profile_major = (profile >> 8) & 0xff;
-	const uint8_t profile_minor = profile & 0xff;
-	bool is_profile_enabled;
-
-	if(comp == NULL ||
-	   profile_major > ROHC_PROFILE_ID_MAJOR_MAX ||
-	   profile_minor > ROHC_PROFILE_ID_MINOR_MAX)
+	ctxt->lru_prev = NULL;
+	ctxt->lru_next = comp->ctxts_lru_first;
+	if(comp->ctxts_lru_first != NULL)
 	{
-		is_profile_enabled = false;
+		comp->ctxts_lru_first->lru_prev = ctxt;
 	}
 	else
 	{
-		is_profile_enabled = comp->enabled_profiles[profile_major][profile_minor];
+		comp->ctxts_lru_last = ctxt;
 	}
-
-	return is_profile_enabled;
+	comp->ctxts_lru_first = ctxt;
 }
 
 
 /**
- * @brief Enable a compression profile for a compressor
- *
- * Enable a compression profiles for a compressor.
- *
- * The ROHC compressor does not use the compression profiles that are not
- * enabled. Thus not enabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
- *
- * If the profile is already enabled, nothing is performed and success is
- * reported.
- *
- * The ROHCv1 and ROHCv2 profiles are incompatible. The same profile cannot
- * be enabled in both versions 1 and 2.
- *
- * @param comp     The ROHC compressor
- * @param profile  The profile to enable
- * @return         true if the profile exists,
- *                 false if the profile does not exist or a similar profile is already enabled
- *
- * @ingroup rohc_comp
- *
- * \par Example:
- * \snippet simple_rohc_program.c define ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c enable ROHC compression profile
- * \code
-        ...
-\endcode
+ * @brief Remove the given context from the LRU list
  *
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profile
- * @see rohc_comp_disable_profiles
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to remove from the LRU list
  */
-bool rohc_comp_enable_profile(struct rohc_comp *const comp,
-                              const rohc_profile_t profile)
+static void c_lru_del(struct rohc_comp *const comp,
+                      struct rohc_comp_ctxt *const ctxt)
 {
-	const uint8_t profile_major = (profile >> 8) & 0xff;
-	const uint8_t profile_minor = profile & 0xff;
-
-	if(comp == NULL)
+	if(ctxt->lru_prev != NULL)
 	{
-		goto error;
+		ctxt->lru_prev->lru_next = ctxt->lru_next;
 	}
-	if(profile_major > ROHC_PROFILE_ID_MAJOR_MAX ||
-	   profile_minor > ROHC_PROFILE_ID_MINOR_MAX ||
-	   rohc_comp_profiles[profile_major][profile_minor] == NULL)
+	else
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "unsupported ROHC compression profile ID 0x%04x", profile);
-		goto error;
+		comp->ctxts_lru_first = ctxt->lru_next;
 	}
-
-	/* the same profile cannot be enabled in both ROHCv1 and ROHCv2 versions:
-	 * check if the corresponding profile in the other ROHC version is already
-	 * enabled or not */
-	if(rohc_comp_profile_enabled_nocheck(comp, rohc_profile_get_other_version(profile)))
+	if(ctxt->lru_next != NULL)
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "failed to enable ROHC compression profile 0x%04x: "
-		           "incompatible profile 0x%04x is already enabled",
-		           profile, rohc_profile_get_other_version(profile));
-		goto error;
+		ctxt->lru_next->lru_prev = ctxt->lru_prev;
 	}
-
-	/* RFC5225, §6.1:
-	 * The compressor MUST NOT use ROHC segmentation (see Section 5.2.5 of
-	 * [RFC4995]), i.e., the Maximum Reconstructed Reception Unit (MRRU)
-	 * MUST be set to 0, if the configuration of the ROHC channel contains
-	 * at least one ROHCv2 profile in the list of supported profiles (i.e.,
-	 * the PROFILES parameter) and if the channel cannot guarantee in-order
-	 * delivery of packets between compression endpoints.
-	 */
-	if(rohc_profile_is_rohcv2(profile) && comp->mrru > 0)
+	else
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "failed to enable ROHC compression profile 0x%04x: ROHC "
-		           "segmentation is not compatible with ROHCv2 profiles", profile);
-		goto error;
+		comp->ctxts_lru_last = ctxt->lru_prev;
 	}
-
-	/* mark the profile as enabled */
-	comp->enabled_profiles[profile_major][profile_minor] = true;
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "ROHC compression profile (ID = 0x%04x) enabled", profile);
-
-	return true;
-
-error:
-	return false;
+	ctxt->lru_prev = NULL;
+	ctxt->lru_next = NULL;
 }
 
 
 /**
- * @brief Disable a compression profile for a compressor
- *
- * Disable a compression profile for a compressor.
- *
- * The ROHC compressor does not use the compression profiles that were
- * disabled. Thus disabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
- *
- * If the profile is already disabled, nothing is performed and success is
- * reported.
- *
- * @param comp     The ROHC compressor
- * @param profile  The profile to disable
- * @return         true if the profile exists,
- *                 false if the profile does not exist
+ * @brief Release the given used context
  *
- * @ingroup rohc_comp
+ * Remove the context from the lookup tables and from the LRU list, then
+ * destroy its profile-specific part. The caller is responsible for re-using
+ * the context or for adding it to the list of free contexts.
  *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profiles
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to release
  */
-bool rohc_comp_disable_profile(struct rohc_comp *const comp,
-                               const rohc_profile_t profile)
+static void c_release_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
 {
-	const uint8_t profile_major = (profile >> 8) & 0xff;
-	const uint8_t profile_minor = profile & 0xff;
+	assert(ctxt->used);
 
-	if(comp == NULL)
+	if(ctxt->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
 	{
-		goto error;
+		comp->uncompressed_ctxt = NULL;
 	}
-	if(profile_major > ROHC_PROFILE_ID_MAJOR_MAX ||
-	   profile_minor > ROHC_PROFILE_ID_MINOR_MAX ||
-	   rohc_comp_profiles[profile_major][profile_minor] == NULL)
+	else
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "unsupported ROHC compression profile ID 0x%04x", profile);
+		const size_t cache_idx = c_flows_cache_idx(&ctxt->fingerprint);
+		const size_t spi_idx = c_esp_spi_idx(ctxt->fingerprint.esp_spi);
+
+		if(comp->flows_cache[cache_idx] == ctxt)
+		{
+			comp->flows_cache[cache_idx] = NULL;
+		}
+		if(comp->esp_by_spi[spi_idx] == ctxt)
+		{
+			comp->esp_by_spi[spi_idx] = NULL;
+		}
+		hashtable_del(&comp->contexts_by_fingerprint, &ctxt->fingerprint,
+		              rohc_fingerprint_len(&ctxt->fingerprint), ctxt);
+		c_addr_index_del(ctxt);
+		if(rohc_comp_profile_has_cr(ctxt->profile))
+		{
+			hashtable_del(&comp->contexts_cr, &ctxt->fingerprint.base,
+			              rohc_fingerprint_base_len(&ctxt->fingerprint.base), ctxt);
+			hashtable_del(&comp->contexts_cr_by_dst_port,
+			              c_cr_dst_port_key(&ctxt->fingerprint),
+			              c_cr_dst_port_key_len(&ctxt->fingerprint), ctxt);
+		}
+	}
+	ctxt->profile->destroy(ctxt);
+	ctxt->used = 0;
+	assert(comp->num_contexts_used > 0);
+	comp->num_contexts_used--;
+	c_lru_del(comp, ctxt);
+}
+
+
+/**
+ * @brief Save one compression context as one record of a context image
+ *
+ * @param ctxt           The compression context
+ * @param image          The buffer to save the record in, may be NULL
+ * @param image_max_len  The length of the buffer
+ * @param[out] rec_len   The length of the record, saved only if it fits in
+ *                       the buffer
+ * @return               true if the context may be saved, false if it may not
+ */
+static bool c_save_context(const struct rohc_comp_ctxt *const ctxt,
+                           uint8_t *const image,
+                           const size_t image_max_len,
+                           size_t *const rec_len)
+{
+	const size_t rec_hdrs_len =
+		sizeof(struct rohc_ctxt_image_rec) + sizeof(struct rohc_comp_ctxt_image);
+	const bool is_room = (image != NULL && rec_hdrs_len <= image_max_len);
+	size_t profile_len;
+
+	if(ctxt->profile->save == NULL || ctxt->state == ROHC_COMP_STATE_CR)
+	{
+		rohc_debug(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
+		           "context with CID %u cannot be saved in context image",
+		           ctxt->cid);
 		goto error;
 	}
 
-	/* mark the profile as disabled */
-	comp->enabled_profiles[profile_major][profile_minor] = false;
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "ROHC compression profile (ID = 0x%04x) disabled", profile);
+	profile_len =
+		ctxt->profile->save(ctxt, is_room ? image + rec_hdrs_len : NULL,
+		                    is_room ? image_max_len - rec_hdrs_len : 0);
+	*rec_len = rec_hdrs_len + profile_len;
+
+	if(is_room && (*rec_len) <= image_max_len)
+	{
+		const struct rohc_ctxt_image_rec rec = {
+			.profile_id = ctxt->profile->id,
+			.cid = ctxt->cid,
+			.generic_len = sizeof(struct rohc_comp_ctxt_image),
+			.profile_len = profile_len,
+		};
+		struct rohc_comp_ctxt_image generic;
+
+		memset(&generic, 0, sizeof(struct rohc_comp_ctxt_image));
+		generic.mode = ctxt->mode;
+		generic.state = ctxt->state;
+		generic.state_oa_repeat_nr = ctxt->state_oa_repeat_nr;
+		generic.wlsb_width = ctxt->wlsb_width;
+		generic.wlsb_ack_in_window = ctxt->wlsb_ack_in_window;
+		generic.num_sent_packets = ctxt->num_sent_packets;
+		generic.go_back_fo_count = ctxt->go_back_fo_count;
+		generic.go_back_ir_count = ctxt->go_back_ir_count;
+		generic.wlsb_ack_lag = ctxt->wlsb_ack_lag;
+		generic.wlsb_ack_interval = ctxt->wlsb_ack_interval;
+		generic.wlsb_ack_pkt_nr = ctxt->wlsb_ack_pkt_nr;
+		memcpy(&generic.fingerprint, &ctxt->fingerprint,
+		       sizeof(struct rohc_fingerprint));
+		memcpy(&generic.static_chain, &ctxt->static_chain,
+		       sizeof(struct rohc_comp_static_chain));
+
+		memcpy(image, &rec, sizeof(struct rohc_ctxt_image_rec));
+		memcpy(image + sizeof(struct rohc_ctxt_image_rec), &generic,
+		       sizeof(struct rohc_comp_ctxt_image));
+	}
 
 	return true;
 
@@ -2577,125 +11172,236 @@ error:
 
 
 /**
- * @brief Enable several compression profiles for a compressor
+ * @brief Restore one compression context from its record in a context image
  *
- * Enable several compression profiles for a compressor. The list of profiles
- * to enable shall stop with -1.
- *
- * The ROHC compressor does not use the compression profiles that are not
- * enabled. Thus not enabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
- *
- * If one or more of the profiles are already enabled, nothing is performed
- * and success is reported.
- *
- * @param comp  The ROHC compressor
- * @param ...   The sequence of compression profiles to enable, the sequence
- *              shall be terminated by -1
- * @return      true if all of the profiles exist,
- *              false if at least one of the profiles does not exist
- *
- * @ingroup rohc_comp
- *
- * \par Example:
- * \snippet simple_rohc_program.c define ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c enable ROHC compression profiles
- * \code
-        ...
-\endcode
- *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_disable_profile
- * @see rohc_comp_disable_profiles
+ * @param comp   The ROHC compressor
+ * @param rec    The header of the record
+ * @param data   The generic part of the context followed by its
+ *               profile-specific part
+ * @param now    The current time
+ * @return       true if the context was restored, false if it was skipped
  */
-bool rohc_comp_enable_profiles(struct rohc_comp *const comp,
-                               ...)
+static bool c_restore_context(struct rohc_comp *const comp,
+                              const struct rohc_ctxt_image_rec *const rec,
+                              const uint8_t *const data,
+                              const struct rohc_ts now)
 {
-	va_list profiles;
-	int profile_id;
-	size_t err_nr = 0;
-	bool is_ok;
+	const uint8_t profile_major = (rec->profile_id >> 8) & 0xff;
+	const uint8_t profile_minor = rec->profile_id & 0xff;
+	const struct rohc_comp_profile *profile = NULL;
+	struct rohc_comp_ctxt_image generic;
+	struct rohc_comp_ctxt *ctxt;
 
-	if(comp == NULL)
+	if(profile_major <= ROHC_PROFILE_ID_MAJOR_MAX &&
+	   profile_minor <= ROHC_PROFILE_ID_MINOR_MAX &&
+	   rohc_comp_profile_enabled_nocheck(comp, rec->profile_id))
+	{
+		profile = rohc_comp_profiles[profile_major][profile_minor];
+	}
+	if(profile == NULL || profile->restore == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "skip context with CID %u of context image: profile "
+		             "0x%04x cannot be restored", rec->cid, rec->profile_id);
+		goto error;
+	}
+	if(rec->cid < comp->ctxts_min_cid || rec->cid > comp->ctxts_max_cid)
 	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "skip context with CID %u of context image: CID out of "
+		             "range [%u, %u]", rec->cid, comp->ctxts_min_cid,
+		             comp->ctxts_max_cid);
 		goto error;
 	}
 
-	va_start(profiles, comp);
+	/* check the generic part before taking the context */
+	if(rec->generic_len != sizeof(struct rohc_comp_ctxt_image))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "skip context with CID %u of context image: unexpected "
+		             "length %u for the generic part", rec->cid, rec->generic_len);
+		goto error;
+	}
+	memcpy(&generic, data, sizeof(struct rohc_comp_ctxt_image));
+	if(generic.mode < ROHC_U_MODE || generic.mode > ROHC_R_MODE ||
+	   generic.state < ROHC_COMP_STATE_IR || generic.state > ROHC_COMP_STATE_SO ||
+	   generic.wlsb_width == 0 ||
+	   generic.fingerprint.base.ip_hdrs_nr > ROHC_MAX_IP_HDRS ||
+	   generic.static_chain.len > ROHC_COMP_STATIC_CHAIN_MAX_LEN)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "skip context with CID %u of context image: malformed "
+		             "generic part", rec->cid);
+		goto error;
+	}
 
-	while((profile_id = va_arg(profiles, int)) >= 0)
+	ctxt = c_free_ctxts_take(comp, rec->cid);
+	if(ctxt == NULL)
 	{
-		is_ok = rohc_comp_enable_profile(comp, profile_id);
-		if(!is_ok)
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "skip context with CID %u of context image: CID already "
+		             "in use or no memory", rec->cid);
+		goto error;
+	}
+
+	ctxt->compressor = comp;
+	ctxt->is_dryrun = false;
+	ctxt->profile = profile;
+	ctxt->mode = generic.mode;
+	ctxt->state = generic.state;
+	ctxt->packet_type = ROHC_PACKET_UNKNOWN;
+	ctxt->state_oa_repeat_nr = generic.state_oa_repeat_nr;
+	ctxt->wlsb_width = generic.wlsb_width;
+	ctxt->oa_repetitions_nr = comp->oa_repetitions_nr;
+	ctxt->oa_clean_pkts_nr = 0;
+	/* the image does not record the reorder ratio the decompressor knows, so
+	 * transmit it again if it may differ */
+	ctxt->reorder_ratio = c_reorder_ratio(comp);
+	ctxt->reorder_ratio_trans_nr =
+		(ctxt->reorder_ratio == comp->reorder_ratio ? comp->oa_repetitions_nr : 0);
+	ctxt->reorder_clean_pkts_nr = 0;
+	ctxt->go_back_fo_count = generic.go_back_fo_count;
+	ctxt->go_back_fo_time = now;
+	ctxt->go_back_ir_count = generic.go_back_ir_count;
+	ctxt->go_back_ir_time = now;
+	ctxt->refresh_jitter = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
+	ctxt->refresh_pkts_left = 0;
+	ctxt->is_refreshing = false;
+	ctxt->wlsb_ack_lag = generic.wlsb_ack_lag;
+	ctxt->wlsb_ack_interval = generic.wlsb_ack_interval;
+	ctxt->wlsb_ack_pkt_nr = generic.wlsb_ack_pkt_nr;
+	ctxt->wlsb_ack_in_window = !!generic.wlsb_ack_in_window;
+	ctxt->do_ctxt_replication = false;
+	ctxt->cr_base_cid = 0;
+	memcpy(&ctxt->fingerprint, &generic.fingerprint,
+	       sizeof(struct rohc_fingerprint));
+	memcpy(&ctxt->static_chain, &generic.static_chain,
+	       sizeof(struct rohc_comp_static_chain));
+
+	rohc_stats_write_begin(&comp->stats_seq);
+	ctxt->num_sent_packets = generic.num_sent_packets;
+	ctxt->total_uncompressed_size = 0;
+	ctxt->total_compressed_size = 0;
+	ctxt->header_uncompressed_size = 0;
+	ctxt->header_compressed_size = 0;
+	ctxt->total_last_uncompressed_size = 0;
+	ctxt->total_last_compressed_size = 0;
+	ctxt->header_last_uncompressed_size = 0;
+	ctxt->header_last_compressed_size = 0;
+	ctxt->ip_id_behavior_changes_nr = 0;
+	ctxt->processing_ns = 0;
+	rohc_stats_write_end(&comp->stats_seq);
+	ctxt->bulk_ref_pkts_nr = ctxt->num_sent_packets;
+	ctxt->bulk_ref_uncomp_size = 0;
+	ctxt->bulk_ref_hdr_uncomp_size = 0;
+	ctxt->bulk_ref_hdr_comp_size = 0;
+
+	if(!profile->restore(ctxt, data + rec->generic_len, rec->profile_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "skip context with CID %u of context image: malformed "
+		             "profile-specific part", rec->cid);
+		goto free_ctxt;
+	}
+
+	/* insert the context in the lookup tables as a new context */
+	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		if(comp->uncompressed_ctxt != NULL)
 		{
-			err_nr++;
+			rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+			             "skip context with CID %u of context image: one "
+			             "Uncompressed context is already in use", rec->cid);
+			profile->destroy(ctxt);
+			goto free_ctxt;
 		}
+		comp->uncompressed_ctxt = ctxt;
+	}
+	else if(hashtable_get(&comp->contexts_by_fingerprint, &ctxt->fingerprint,
+	                      rohc_fingerprint_len(&ctxt->fingerprint)) != NULL ||
+	        !hashtable_add(&comp->contexts_by_fingerprint, &ctxt->fingerprint,
+	                       rohc_fingerprint_len(&ctxt->fingerprint), ctxt))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, profile->id,
+		             "skip context with CID %u of context image: failed to "
+		             "insert it in the hash table", rec->cid);
+		profile->destroy(ctxt);
+		goto free_ctxt;
+	}
+	else
+	{
+		c_addr_index_add(comp, ctxt);
 	}
 
-	va_end(profiles);
+	ctxt->used = 1;
+	ctxt->first_used = now.sec;
+	ctxt->latest_used = now;
+	assert(comp->num_contexts_used <= (comp->ctxts_max_cid - comp->ctxts_min_cid));
+	comp->num_contexts_used++;
+	c_lru_add_first(comp, ctxt);
+	if(ctxt->profile->id != ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		c_cr_update_base(ctxt);
+	}
 
-	return (err_nr == 0);
+	rohc_debug(comp, ROHC_TRACE_COMP, profile->id,
+	           "context with CID %u restored in state %d and mode %d",
+	           ctxt->cid, ctxt->state, ctxt->mode);
+	c_ctxt_event(ctxt, ROHC_COMP_CTXT_EVENT_CREATED, ctxt->state, ctxt->mode);
 
+	return true;
+
+free_ctxt:
+	ctxt->used = 0;
+	c_free_ctxts_push(comp, ctxt);
 error:
 	return false;
 }
 
 
 /**
- * @brief Disable several compression profiles for a compressor
- *
- * Disable several compression profiles for a compressor. The list of profiles
- * to disable shall stop with -1.
- *
- * The ROHC compressor does not use the compression profiles that were
- * disabled. Thus disabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
- *
- * If one or more of the profiles are already disabled, nothing is performed
- * and success is reported.
- *
- * @param comp  The ROHC compressor
- * @param ...   The sequence of compression profiles to disable, the sequence
- *              shall be terminated by -1
- * @return      true if all of the profiles exist,
- *              false if at least one of the profiles does not exist
+ * @brief Release one context to stay within the budget
  *
- * @ingroup rohc_comp
+ * If an idle timeout was set with \ref rohc_comp_set_ctxt_idle_timeout, the
+ * least recently used context is released only if it is idle. Otherwise,
+ * the context chosen by the eviction policy is released as when all the
+ * CIDs are in use.
  *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profile
+ * @param comp        The ROHC compressor
+ * @param profile_id  The profile of the new context
+ * @param now         The arrival time of the packet that needs a new context
+ * @return            true if one context was released, false if none may be
  */
-bool rohc_comp_disable_profiles(struct rohc_comp *const comp,
-                                ...)
+static bool c_evict_for_budget(struct rohc_comp *const comp,
+                               const rohc_profile_t profile_id,
+                               const struct rohc_ts now)
 {
-	va_list profiles;
-	int profile_id;
-	size_t err_nr = 0;
-	bool is_ok;
+	struct rohc_comp_ctxt *ctxt = comp->ctxts_lru_last;
 
-	if(comp == NULL)
+	if(ctxt == NULL)
 	{
 		goto error;
 	}
-
-	va_start(profiles, comp);
-
-	while((profile_id = va_arg(profiles, int)) >= 0)
+	if(comp->ctxt_idle_timeout != 0 && !c_is_context_idle(comp, ctxt, now))
 	{
-		is_ok = rohc_comp_disable_profile(comp, profile_id);
-		if(!is_ok)
-		{
-			err_nr++;
-		}
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "memory budget exhausted, but the least recently used "
+		           "context (CID %u) is not idle", ctxt->cid);
+		goto error;
 	}
+	ctxt = c_evict_select(comp, profile_id, now);
 
-	va_end(profiles);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "memory budget exhausted, release context (CID %u with "
+	           "profile 0x%04x)", ctxt->cid, ctxt->profile->id);
+	c_ctxt_event(ctxt, ROHC_COMP_CTXT_EVENT_RELEASED, ctxt->state, ctxt->mode);
+	c_release_context(comp, ctxt);
+	c_free_ctxts_push(comp, ctxt);
+	rohc_stats_write_begin(&comp->stats_seq);
+	comp->num_contexts_evicted++;
+	rohc_stats_write_end(&comp->stats_seq);
 
-	return (err_nr == 0);
+	return true;
 
 error:
 	return false;
@@ -2703,1377 +11409,1663 @@ error:
 
 
 /**
- * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
- *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If set to 0, segmentation is disabled as no segment headers are allowed
- * on the channel. No segment will be generated.
- *
- * According to RF5225 §6.1, ROHC segmentation cannot be enabled if any
- * ROHCv2 profile is also enabled.
- *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
- *
- * @param comp  The ROHC compressor
- * @param mrru  The new MRRU value (in bytes)
- * @return      true if the MRRU was successfully set, false otherwise
- *
- * @ingroup rohc_comp
+ * @brief Choose the context to recycle according to the eviction policy
  *
- * \par Example:
- * \snippet test_segment.c define ROHC compressor
- * \code
-        size_t mrru = 500;
-        ...
-\endcode
- * \snippet test_segment.c set compressor MRRU
- * \code
-        ...
-\endcode
+ * The least recently used context is chosen by the LRU policy, or by any
+ * policy if it is idle. The other policies choose among the
+ * \ref ROHC_COMP_EVICT_CANDIDATES_MAX least recently used contexts found at
+ * the tail of the LRU list, the least recently used one wins the ties.
  *
- * @see rohc_comp_get_mrru
- * @see rohc_comp_get_segment2
- * @see rohc_decomp_set_mrru
+ * @param comp        The ROHC compressor
+ * @param profile_id  The profile of the new context
+ * @param now         The arrival time of the packet that needs a new context
+ * @return            The context to recycle, NULL if no context is in use
  */
-bool rohc_comp_set_mrru(struct rohc_comp *const comp,
-                        const size_t mrru)
+static struct rohc_comp_ctxt *
+	c_evict_select(const struct rohc_comp *const comp,
+	               const rohc_profile_t profile_id,
+	               const struct rohc_ts now)
 {
-	/* compressor must be valid */
-	if(comp == NULL)
+	struct rohc_comp_ctxt *candidates[ROHC_COMP_EVICT_CANDIDATES_MAX];
+	struct rohc_comp_ctxt *victim = comp->ctxts_lru_last;
+	struct rohc_comp_ctxt *ctxt;
+	size_t candidates_nr = 0;
+	size_t i;
+
+	if(victim == NULL || comp->evict_policy == ROHC_COMP_EVICT_LRU ||
+	   (comp->ctxt_idle_timeout != 0 && c_is_context_idle(comp, victim, now)))
 	{
-		/* cannot print a trace without a valid compressor */
-		goto error;
+		return victim;
 	}
 
-	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
-	if(mrru > ROHC_MAX_MRRU)
+	for(ctxt = victim;
+	    ctxt != NULL && candidates_nr < ROHC_COMP_EVICT_CANDIDATES_MAX;
+	    ctxt = ctxt->lru_prev)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unexpected MRRU value: must be in range [0, %d]",
-		             ROHC_MAX_MRRU);
-		goto error;
+		candidates[candidates_nr] = ctxt;
+		candidates_nr++;
 	}
 
-	/* RFC5225, §6.1:
-	 * The compressor MUST NOT use ROHC segmentation (see Section 5.2.5 of
-	 * [RFC4995]), i.e., the Maximum Reconstructed Reception Unit (MRRU)
-	 * MUST be set to 0, if the configuration of the ROHC channel contains
-	 * at least one ROHCv2 profile in the list of supported profiles (i.e.,
-	 * the PROFILES parameter) and if the channel cannot guarantee in-order
-	 * delivery of packets between compression endpoints.
-	 */
-	if(mrru > 0)
+	switch(comp->evict_policy)
 	{
-		uint8_t profile_major;
-
-		for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
-		{
-			uint8_t profile_minor;
-
-			for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
+		case ROHC_COMP_EVICT_LFU:
+			for(i = 1; i < candidates_nr; i++)
 			{
-				const uint16_t profile_id = (profile_major << 8) | profile_minor;
-
-				if(rohc_comp_profile_enabled_nocheck(comp, profile_id) &&
-				   rohc_profile_is_rohcv2(profile_id))
+				if(candidates[i]->num_sent_packets < victim->num_sent_packets)
 				{
-					rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					             "failed to set MRRU to %zu bytes: segmentation is not "
-					             "compatible with ROHCv2 profile 0x%04x that is enabled",
-					             mrru, profile_id);
-					goto error;
+					victim = candidates[i];
+				}
+			}
+			break;
+		case ROHC_COMP_EVICT_SIZE_WEIGHTED:
+			for(i = 1; i < candidates_nr; i++)
+			{
+				const int64_t saved = (int64_t) candidates[i]->header_uncompressed_size -
+				                      candidates[i]->header_compressed_size;
+				const int64_t victim_saved = (int64_t) victim->header_uncompressed_size -
+				                             victim->header_compressed_size;
+				if(saved < victim_saved)
+				{
+					victim = candidates[i];
+				}
+			}
+			break;
+		case ROHC_COMP_EVICT_PROFILE_PRIORITY:
+			for(i = 1; i < candidates_nr; i++)
+			{
+				if(c_evict_profile_rank(candidates[i]->profile->id) <
+				   c_evict_profile_rank(victim->profile->id))
+				{
+					victim = candidates[i];
 				}
 			}
+			break;
+		case ROHC_COMP_EVICT_CUSTOM:
+		{
+			struct rohc_comp_ctxt_record records[ROHC_COMP_EVICT_CANDIDATES_MAX];
+			size_t chosen;
+
+			for(i = 0; i < candidates_nr; i++)
+			{
+				c_ctxt_record(candidates[i], &records[i]);
+			}
+			chosen = comp->evict_cb(records, candidates_nr, profile_id,
+			                        comp->evict_cb_priv);
+			if(chosen < candidates_nr)
+			{
+				victim = candidates[chosen];
+			}
+			break;
 		}
+		case ROHC_COMP_EVICT_LRU:
+		default:
+			break;
 	}
 
-	/* set new MRRU */
-	if(mrru == 0)
-	{
-		comp->rru = NULL;
-	}
-	else
-	{
-		uint8_t *const new_rru_buf = malloc(mrru);
-		if(new_rru_buf == NULL)
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to set MRRU: failed to allocate %zu bytes "
-			             "of memory for MRRU buffer", mrru);
-			goto error;
-		}
-		if(comp->rru != NULL)
-		{
-			zfree(comp->rru);
-		}
-		comp->rru = new_rru_buf;
+	return victim;
+}
+
+
+/**
+ * @brief Get the rank of one profile for the profile-priority eviction
+ *
+ * The profiles that save the most bytes per packet get the highest ranks,
+ * the contexts with the lowest rank are recycled first.
+ *
+ * @param profile_id  The profile of the context
+ * @return            The rank of the profile
+ */
+static unsigned int c_evict_profile_rank(const rohc_profile_t profile_id)
+{
+	switch(profile_id)
+	{
+		case ROHCv1_PROFILE_IP_UDP_RTP:
+		case ROHCv1_PROFILE_IP_UDP_RTP_LLA:
+		case ROHCv1_PROFILE_IP_UDPLITE_RTP:
+		case ROHCv2_PROFILE_IP_UDP_RTP:
+		case ROHCv2_PROFILE_IP_UDPLITE_RTP:
+			return 5;
+		case ROHCv1_PROFILE_IP_TCP:
+			return 4;
+		case ROHCv1_PROFILE_IP_UDP:
+		case ROHCv1_PROFILE_IP_UDPLITE:
+		case ROHCv2_PROFILE_IP_UDP:
+		case ROHCv2_PROFILE_IP_UDPLITE:
+			return 3;
+		case ROHCv1_PROFILE_IP_ESP:
+		case ROHCv2_PROFILE_IP_ESP:
+			return 2;
+		case ROHCv1_PROFILE_IP:
+		case ROHCv2_PROFILE_IP:
+			return 1;
+		case ROHCv1_PROFILE_UNCOMPRESSED:
+		default:
+			return 0;
 	}
-	comp->mrru = mrru;
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "MRRU is now set to %zu", comp->mrru);
+}
 
-	return true;
 
-error:
-	return false;
+/**
+ * @brief Notify the user of one event of the life of a compression context
+ *
+ * Nothing is done if no callback was set with
+ * \ref rohc_comp_set_ctxt_event_cb.
+ *
+ * @param ctxt       The compression context
+ * @param type       The type of the event
+ * @param old_state  The state of the context before the event
+ * @param old_mode   The mode of the context before the event
+ */
+static void c_ctxt_event(const struct rohc_comp_ctxt *const ctxt,
+                         const rohc_comp_ctxt_event_type_t type,
+                         const rohc_comp_state_t old_state,
+                         const rohc_mode_t old_mode)
+{
+	const struct rohc_comp *const comp = ctxt->compressor;
+
+	if(comp->ctxt_event_cb != NULL && !ctxt->is_dryrun)
+	{
+		const struct rohc_comp_ctxt_event event = {
+			.type = type,
+			.cid = ctxt->cid,
+			.profile_id = ctxt->profile->id,
+			.old_state = old_state,
+			.state = ctxt->state,
+			.old_mode = old_mode,
+			.mode = ctxt->mode,
+		};
+		comp->ctxt_event_cb(comp, &event, comp->ctxt_event_cb_priv);
+	}
 }
 
 
 /**
- * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
+ * @brief Get the entry of the cache of the last flows for a fingerprint
  *
- * Get the current Maximum Reconstructed Reception Unit (MRRU).
+ * The hash folds the words of the fingerprint that change the most between
+ * flows: the ports or SPI, the RTP SSRC and the innermost IP addresses.
  *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
+ * @param fingerprint  The fingerprint of a packet or context, with at least
+ *                     one IP header
+ * @return             The index of the entry in the cache of the last flows
+ */
+static inline size_t
+	c_flows_cache_idx(const struct rohc_fingerprint *const fingerprint)
+{
+	const struct rohc_fingerprint_ip *const ip =
+		&fingerprint->base.ip_hdrs[fingerprint->base.ip_hdrs_nr - 1];
+	uint32_t hash;
+
+	hash = fingerprint->esp_spi ^ fingerprint->rtp_ssrc ^
+	       ip->saddr.u32[0] ^ ip->saddr.u32[3] ^
+	       ip->daddr.u32[0] ^ ip->daddr.u32[3] ^
+	       fingerprint->base.profile_id;
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return (hash & (ROHC_COMP_FLOWS_CACHE_LEN - 1));
+}
+
+
+/**
+ * @brief Get the entry of the index of the ESP contexts for a SPI
  *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If MRRU value is 0, segmentation is disabled.
+ * The SPIs are chosen by the IPsec peers, often in sequence, so mix all
+ * their bits into the bits of the index.
  *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
+ * @param esp_spi  The SPI of the ESP flow
+ * @return         The index of the entry in the index of ESP contexts
+ */
+static inline size_t c_esp_spi_idx(const uint32_t esp_spi)
+{
+	return ((esp_spi * 0x9e3779b1U) >> (32U - ROHC_COMP_ESP_SPI_INDEX_BITS));
+}
+
+
+/**
+ * @brief Get the entry of the index of the contexts for a NIC hash
  *
- * @param comp       The ROHC compressor
- * @param[out] mrru  The current MRRU value (in bytes)
- * @return           true if MRRU was successfully retrieved, false otherwise
+ * The NIC spreads the flows over its queues with the low bits of the hash,
+ * so the flows of one queue share them: mix all the bits of the hash into
+ * the bits of the index.
  *
- * @ingroup rohc_comp
+ * @param rss_hash  The hash of the flow computed by the NIC
+ * @return          The index of the entry in the index of contexts
+ */
+static inline size_t c_rss_idx(const uint32_t rss_hash)
+{
+	return ((rss_hash * 0x9e3779b1U) >> (32U - ROHC_COMP_RSS_INDEX_BITS));
+}
+
+
+/**
+ * @brief Remember the context of the last packet of its flow
  *
- * \par Example:
- * \snippet test_segment.c define ROHC compressor
- * \code
-        size_t mrru;
-        ...
-\endcode
- * \snippet test_non_regression.c get compressor MRRU
- * \code
-        printf("the current MMRU at compressor is %zu bytes\n", mrru);
-        ...
-\endcode
+ * The contexts of the ESP profiles go to the index by SPI, the other
+ * contexts go to the cache of the last flows.
  *
- * @see rohc_comp_set_mrru
- * @see rohc_comp_get_segment2
- * @see rohc_decomp_set_mrru
- * @see rohc_decomp_get_mrru
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context, not the Uncompressed one
  */
-bool rohc_comp_get_mrru(const struct rohc_comp *const comp,
-                        size_t *const mrru)
+static void c_flows_cache_add(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
 {
-	if(comp == NULL || mrru == NULL)
+	if(rohc_comp_profile_is_esp(ctxt->profile->id))
 	{
-		goto error;
+		comp->esp_by_spi[c_esp_spi_idx(ctxt->fingerprint.esp_spi)] = ctxt;
 	}
+	else
+	{
+		comp->flows_cache[c_flows_cache_idx(&ctxt->fingerprint)] = ctxt;
+	}
+}
 
-	*mrru = comp->mrru;
-	return true;
 
-error:
-	return false;
+/**
+ * @brief Get the length of the key of one address in the index of contexts
+ *        by address prefix
+ *
+ * @param ip_version  The version of the IP address, 4 or 6
+ * @return            The length of the prefix of the address used as key
+ *                    (in bytes)
+ */
+static inline size_t c_addr_key_len(const uint8_t ip_version)
+{
+	return (ip_version == IPV4 ? ROHC_COMP_ADDR_INDEX_V4_KEY_LEN :
+	        ROHC_COMP_ADDR_INDEX_V6_KEY_LEN);
 }
 
 
 /**
- * @brief Get the maximal CID value the compressor uses
- *
- * Get the maximal CID value the compressor uses, ie. the \e MAX_CID parameter
- * defined in RFC 3095.
+ * @brief Get the entry of the index of contexts by address prefix for one
+ *        address
  *
- * @param comp          The ROHC compressor
- * @param[out] max_cid  The current maximal CID value
- * @return              true if MAX_CID was successfully retrieved,
- *                      false otherwise
+ * Only the first bytes of the address are part of the key, so that all the
+ * addresses of one prefix share one entry: the contexts of one prefix are
+ * found without hashing all the addresses of the prefix.
  *
- * @ingroup rohc_comp
+ * @param ip_version  The version of the IP address, 4 or 6
+ * @param addr        The IP address
+ * @return            The index of the entry in the index of contexts
  */
-bool rohc_comp_get_max_cid(const struct rohc_comp *const comp,
-                           size_t *const max_cid)
+static inline size_t c_addr_idx(const uint8_t ip_version,
+                                const uint8_t *const addr)
 {
-	if(comp == NULL || max_cid == NULL)
+	const size_t key_len = c_addr_key_len(ip_version);
+	uint64_t key = ip_version;
+	size_t i;
+
+	for(i = 0; i < key_len; i++)
 	{
-		goto error;
+		key = (key << 8) | addr[i];
 	}
 
-	*max_cid = comp->medium.max_cid;
-	return true;
-
-error:
-	return false;
+	return ((key * 0x9e3779b97f4a7c15ULL) >> (64U - ROHC_COMP_ADDR_INDEX_BITS));
 }
 
 
 /**
- * @brief Get the CID type that the compressor uses
- *
- * Get the CID type that the compressor currently uses.
- *
- * @param comp           The ROHC compressor
- * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
- *                       \ref ROHC_LARGE_CID
- * @return               true if the CID type was successfully retrieved,
- *                       false otherwise
+ * @brief Get the address of one context linked in one entry of the index of
+ *        contexts by address prefix
  *
- * @ingroup rohc_comp
+ * @param ctxt  The compression context
+ * @param idx   The index of the entry in the index of contexts
+ * @return      The link of the context in the entry,
+ *              ROHC_COMP_ADDR_LINKS_MAX if the context is not linked in
  */
-bool rohc_comp_get_cid_type(const struct rohc_comp *const comp,
-                            rohc_cid_type_t *const cid_type)
+static inline size_t c_addr_link_at(const struct rohc_comp_ctxt *const ctxt,
+                                    const size_t idx)
 {
-	if(comp == NULL || cid_type == NULL)
+	size_t link;
+
+	for(link = 0; link < ROHC_COMP_ADDR_LINKS_MAX; link++)
 	{
-		goto error;
+		if(ctxt->addr_idx[link] == idx)
+		{
+			break;
+		}
 	}
 
-	*cid_type = comp->medium.cid_type;
-	return true;
-
-error:
-	return false;
+	return link;
 }
 
 
 /**
- * @brief Enable/disable features for ROHC compressor
- *
- * Enable/disable features for ROHC compressor. Features control whether
- * mechanisms defined as optional by RFCs are enabled or not.
- *
- * Available features are listed by \ref rohc_comp_features_t. They may be
- * combined by XOR'ing them together.
- *
- * @warning Changing the feature set while library is used is not supported
- *
- * @param comp      The ROHC compressor
- * @param features  The feature set to enable/disable
- * @return          true if the feature set was successfully enabled/disabled,
- *                  false if a problem occurred
+ * @brief Add one context to the index of contexts by address prefix
  *
- * @ingroup rohc_comp
+ * The source and destination addresses of all the IP headers are linked in
+ * the index, the addresses that share the entry of one previous address of
+ * the context excepted, so that one context is linked at most once in every
+ * entry.
  *
- * @see rohc_comp_features_t
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context, not the Uncompressed one
  */
-bool rohc_comp_set_features(struct rohc_comp *const comp,
-                            const rohc_comp_features_t features)
+static void c_addr_index_add(struct rohc_comp *const comp,
+                             struct rohc_comp_ctxt *const ctxt)
 {
-	const rohc_comp_features_t all_features =
-		ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
-		ROHC_COMP_FEATURE_DUMP_PACKETS |
-		ROHC_COMP_FEATURE_TIME_BASED_REFRESHES;
+	size_t link;
 
-	/* compressor must be valid */
-	if(comp == NULL)
+	for(link = 0; link < ROHC_COMP_ADDR_LINKS_MAX; link++)
 	{
-		/* cannot print a trace without a valid compressor */
-		goto error;
+		ctxt->addr_idx[link] = ROHC_COMP_ADDR_INDEX_NONE;
+		ctxt->addr_links[link].next = NULL;
+		ctxt->addr_links[link].pprev = NULL;
 	}
 
-	/* reject unsupported features */
-	if((features & all_features) != features)
+	for(link = 0; link < (ctxt->fingerprint.base.ip_hdrs_nr * 2U); link++)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "feature set 0x%x is not supported (supported features "
-		             "set is 0x%x)", features, all_features);
-		goto error;
-	}
-
-	/* record new feature set */
-	comp->features = features;
+		const struct rohc_fingerprint_ip *const ip =
+			&(ctxt->fingerprint.base.ip_hdrs[link / 2]);
+		const uint8_t *const addr = ((link % 2) == 0 ? ip->saddr.u8 : ip->daddr.u8);
+		const size_t idx = c_addr_idx(ip->version, addr);
 
-	return true;
+		if(c_addr_link_at(ctxt, idx) == ROHC_COMP_ADDR_LINKS_MAX)
+		{
+			struct rohc_comp_ctxt *const head = comp->ctxts_by_addr[idx];
 
-error:
-	return false;
+			ctxt->addr_links[link].next = head;
+			ctxt->addr_links[link].pprev = &(comp->ctxts_by_addr[idx]);
+			if(head != NULL)
+			{
+				head->addr_links[c_addr_link_at(head, idx)].pprev =
+					&(ctxt->addr_links[link].next);
+			}
+			comp->ctxts_by_addr[idx] = ctxt;
+			ctxt->addr_idx[link] = idx;
+		}
+	}
 }
 
 
 /**
- * @brief Deliver a feedback packet to the compressor
- *
- * When feedback is received by the decompressor, this function is called and
- * delivers the feedback to the right profile/context of the compressor.
+ * @brief Remove one context from the index of contexts by address prefix
  *
- * @param comp   The ROHC compressor
- * @param packet The feedback data
- * @param size   The length of the feedback packet
- * @return       true if the feedback was successfully taken into account,
- *               false if the feedback could not be taken into account
+ * @param ctxt  The compression context, not the Uncompressed one
  */
-static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
-                                         const uint8_t *const packet,
-                                         const size_t size)
+static void c_addr_index_del(struct rohc_comp_ctxt *const ctxt)
 {
-	struct rohc_comp_ctxt *context;
-	const uint8_t *remain_data = packet;
-	size_t remain_len = size;
-	enum rohc_feedback_type feedback_type;
-	rohc_cid_t cid;
-	size_t cid_len;
-
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "deliver %zu byte(s) of feedback to the right context", size);
+	size_t link;
 
-	/* extract the CID from feedback */
-	if(!rohc_comp_feedback_parse_cid(comp, remain_data, remain_len, &cid, &cid_len))
+	for(link = 0; link < ROHC_COMP_ADDR_LINKS_MAX; link++)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: failed to extract CID from "
-		             "feedback");
-		goto error;
-	}
-	remain_data += cid_len;
-	remain_len -= cid_len;
+		if(ctxt->addr_idx[link] != ROHC_COMP_ADDR_INDEX_NONE)
+		{
+			struct rohc_comp_ctxt *const next = ctxt->addr_links[link].next;
 
-	/* find context */
-	context = c_get_context(comp, cid);
-	if(context == NULL)
-	{
-		/* context was not found */
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: context with CID %u not found",
-		             cid);
-		goto error;
+			*(ctxt->addr_links[link].pprev) = next;
+			if(next != NULL)
+			{
+				next->addr_links[c_addr_link_at(next, ctxt->addr_idx[link])].pprev =
+					ctxt->addr_links[link].pprev;
+			}
+			ctxt->addr_idx[link] = ROHC_COMP_ADDR_INDEX_NONE;
+		}
 	}
-	assert(context->cid == cid);
-	assert(context->used == 1);
+}
 
-	/* FEEDBACK-1 or FEEDBACK-2 ? */
-	if(remain_len == 0)
+
+/**
+ * @brief Whether one address of one context belongs to the prefix of a filter
+ *
+ * @param ip      The fingerprint of the IP header of the address
+ * @param addr    The source or destination address of the IP header
+ * @param filter  The filter of contexts
+ * @return        true if the address belongs to the prefix, false otherwise
+ */
+static bool c_addr_prefix_match(const struct rohc_fingerprint_ip *const ip,
+                                const uint8_t *const addr,
+                                const struct rohc_comp_ctxt_filter *const filter)
+{
+	const size_t bytes_nr = filter->prefix_len / 8;
+	const size_t bits_nr = filter->prefix_len % 8;
+
+	if(ip->version != filter->ip_version)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: empty feedback data");
-		goto error;
+		return false;
 	}
-	else if(remain_len == 1)
+	if(memcmp(addr, filter->addr, bytes_nr) != 0)
 	{
-		feedback_type = ROHC_FEEDBACK_1;
+		return false;
 	}
-	else
+	if(bits_nr > 0)
 	{
-		feedback_type = ROHC_FEEDBACK_2;
-	}
+		const uint8_t mask = (0xffU << (8 - bits_nr)) & 0xff;
 
-	/* deliver feedback to profile with the context */
-	if(!context->profile->feedback(context, feedback_type, packet, size,
-	                               remain_data, remain_len))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: failed to handle FEEDBACK-%d",
-		             feedback_type);
-		goto error;
+		if(((addr[bytes_nr] ^ filter->addr[bytes_nr]) & mask) != 0)
+		{
+			return false;
+		}
 	}
 
-	/* everything went fine */
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "FEEDBACK-%d data successfully handled", feedback_type);
-
 	return true;
-
-error:
-	return false;
 }
 
 
 /**
- * @brief Deliver a feedback packet to the compressor
- *
- * When feedback data is received by a decompressor, this function may be
- * called to deliver the feedback data to the corresponding profile/context
- * on the same-side associated compressor.
- *
- * @param comp      The ROHC compressor
- * @param feedback  The feedback data
- * @return          true if the feedback was successfully taken into account,
- *                  false if the feedback could not be taken into account
+ * @brief Whether one context matches one filter of contexts
  *
- * @ingroup rohc_comp
+ * @param ctxt    The compression context
+ * @param filter  The filter of contexts
+ * @return        The first address of the context that belongs to the
+ *                prefix of the filter if the context matches,
+ *                ROHC_COMP_ADDR_LINKS_MAX otherwise
  */
-bool rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
-                                 const struct rohc_buf feedback)
+static size_t c_ctxt_filter_match(const struct rohc_comp_ctxt *const ctxt,
+                                  const struct rohc_comp_ctxt_filter *const filter)
 {
-	struct rohc_buf remain_data = feedback;
-	size_t feedbacks_nr = 0;
-	size_t nr_failures = 0;
+	const rohc_profile_t profile_id = ctxt->profile->id;
+	size_t link;
 
-	/* sanity checks */
-	if(comp == NULL)
-	{
-		goto error;
-	}
-	if(rohc_buf_is_malformed(remain_data))
+	/* the Uncompressed context is not part of the index */
+	if(profile_id == ROHCv1_PROFILE_UNCOMPRESSED)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: feedback is malformed");
-		goto error;
+		return ROHC_COMP_ADDR_LINKS_MAX;
 	}
-
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "deliver %zu byte(s) of feedback to the right context",
-	           remain_data.len);
-
-	/* there is nothing for compressor if feedback contains no byte at all */
-	if(rohc_buf_is_empty(remain_data))
+	if(filter->has_profile && profile_id != filter->profile_id)
 	{
-		goto ignore;
+		return ROHC_COMP_ADDR_LINKS_MAX;
 	}
-
-	/* parse as much feedback data as possible */
-	while(remain_data.len > 0 &&
-	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	if(filter->has_port)
 	{
-		size_t feedback_hdr_len;
-		size_t feedback_data_len;
-		size_t feedback_len;
-
-		feedbacks_nr++;
-
-		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
-		                           &feedback_data_len))
+		if(profile_id == ROHCv1_PROFILE_IP ||
+		   profile_id == ROHCv2_PROFILE_IP ||
+		   rohc_comp_profile_is_esp(profile_id))
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to parse a feedback item");
-			goto error;
+			return ROHC_COMP_ADDR_LINKS_MAX;
 		}
-		feedback_len = feedback_hdr_len + feedback_data_len;
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "feedback found (header = %zu bytes, data = %zu bytes)",
-		           feedback_hdr_len, feedback_data_len);
-
-		/* reject feedback item if it doesn't fit in the available data */
-		if(feedback_len > remain_data.len)
+		if(ctxt->fingerprint.src_port != filter->port &&
+		   ctxt->fingerprint.dst_port != filter->port)
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "the %zu-byte feedback is too large for the %zu-byte "
-			             "remaining ROHC data", feedback_len, remain_data.len);
-			goto error;
+			return ROHC_COMP_ADDR_LINKS_MAX;
 		}
+	}
 
-		/* skip the feedback header */
-		rohc_buf_pull(&remain_data, feedback_hdr_len);
+	for(link = 0; link < (ctxt->fingerprint.base.ip_hdrs_nr * 2U); link++)
+	{
+		const struct rohc_fingerprint_ip *const ip =
+			&(ctxt->fingerprint.base.ip_hdrs[link / 2]);
+		const uint8_t *const addr = ((link % 2) == 0 ? ip->saddr.u8 : ip->daddr.u8);
 
-		/* deliver the feedback data to the compressor */
-		if(!__rohc_comp_deliver_feedback(comp, rohc_buf_data(remain_data),
-		                                 feedback_data_len))
+		if(c_addr_prefix_match(ip, addr, filter))
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to deliver feedback item #%zu", feedbacks_nr);
-			nr_failures++;
+			return link;
 		}
-
-		/* skip the feedback data */
-		rohc_buf_pull(&remain_data, feedback_data_len);
 	}
 
-	return (nr_failures == 0);
+	return ROHC_COMP_ADDR_LINKS_MAX;
+}
 
-ignore:
-	return true;
 
-error:
-	return false;
+/**
+ * @brief Get the key of a fingerprint in the index of CR base contexts
+ *        by destination port
+ *
+ * The key runs from the destination port up to the last IP header of the
+ * base fingerprint, so it also covers the RTP SSRC that is always zero for
+ * the profiles that support Context Replication.
+ *
+ * @param fingerprint  The fingerprint of a packet or context
+ * @return             The start of the key within the fingerprint
+ */
+static inline const void *
+	c_cr_dst_port_key(const struct rohc_fingerprint *const fingerprint)
+{
+	return ((const uint8_t *) fingerprint) +
+	       offsetof(struct rohc_fingerprint, dst_port);
 }
 
 
 /**
- * @brief Get some information about the last compressed packet
+ * @brief Get the length of the key of a fingerprint in the index of CR base
+ *        contexts by destination port
  *
- * Get some information about the last compressed packet.
+ * @param fingerprint  The fingerprint of a packet or context
+ * @return             The length of the key within the fingerprint
+ */
+static inline size_t
+	c_cr_dst_port_key_len(const struct rohc_fingerprint *const fingerprint)
+{
+	return rohc_fingerprint_len(fingerprint) -
+	       offsetof(struct rohc_fingerprint, dst_port);
+}
+
+
+/**
+ * @brief Whether the given context received no packet for too long
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
+ * A context that was used after the given time is never idle, even if the
+ * clocks of the application are not monotonic.
  *
- * See the \ref rohc_comp_last_packet_info2_t structure for details about
- * fields that are supported in the above versions.
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context
+ * @param now   The current time
+ * @return      true if the context is idle, false otherwise
+ */
+static bool c_is_context_idle(const struct rohc_comp *const comp,
+                              const struct rohc_comp_ctxt *const ctxt,
+                              const struct rohc_ts now)
+{
+	if(now.sec < ctxt->latest_used.sec ||
+	   (now.sec == ctxt->latest_used.sec && now.nsec < ctxt->latest_used.nsec))
+	{
+		return false;
+	}
+
+	return (rohc_time_interval(ctxt->latest_used, now) >=
+	        comp->ctxt_idle_timeout * 1000U);
+}
+
+
+/**
+ * @brief Add the given unused context to the list of free contexts
  *
- * @param comp          The ROHC compressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param comp  The ROHC compressor
+ * @param ctxt  The unused compression context
+ */
+static void c_free_ctxts_push(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+{
+	assert(ctxt->used == 0);
+	ctxt->lru_prev = NULL;
+	ctxt->lru_next = comp->ctxts_free;
+	comp->ctxts_free = ctxt;
+}
+
+
+/**
+ * @brief Take an unused context
+ *
+ * The contexts that were released are re-used first. If there is none, the
+ * smallest CID that was never used is taken, and the block of contexts that
+ * contains it is allocated if needed.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The unused compression context, NULL if all contexts are used
+ *              or if memory allocation failed
+ */
+static struct rohc_comp_ctxt * c_free_ctxts_pop(struct rohc_comp *const comp)
+{
+	struct rohc_comp_ctxt *ctxt = comp->ctxts_free;
+
+	if(ctxt != NULL)
+	{
+		comp->ctxts_free = ctxt->lru_next;
+		ctxt->lru_next = NULL;
+	}
+	else
+	{
+		ctxt = c_ctxts_alloc_next(comp);
+	}
+
+	return ctxt;
+}
+
+
+/**
+ * @brief Take the unused context with the given CID
  *
- * @ingroup rohc_comp
+ * The released contexts are searched first. If the CID was never used, the
+ * contexts up to the CID are taken, the ones before the CID are added to the
+ * list of free contexts.
  *
- * @see rohc_comp_last_packet_info2_t
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context to take
+ * @return      The unused compression context, NULL if the context is used
+ *              or if memory allocation failed
  */
-bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
-                                     rohc_comp_last_packet_info2_t *const info)
+static struct rohc_comp_ctxt * c_free_ctxts_take(struct rohc_comp *const comp,
+                                                 const rohc_cid_t cid)
 {
-	if(comp == NULL)
-	{
-		goto error;
-	}
+	struct rohc_comp_ctxt **prev_next;
+	struct rohc_comp_ctxt *ctxt;
 
-	if(comp->last_context == NULL)
+	assert(cid >= comp->ctxts_min_cid);
+	assert(cid <= comp->ctxts_max_cid);
+
+	for(prev_next = &comp->ctxts_free; (*prev_next) != NULL;
+	    prev_next = &((*prev_next)->lru_next))
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "last context found in compressor is not valid");
-		goto error;
+		if((*prev_next)->cid == cid)
+		{
+			ctxt = (*prev_next);
+			(*prev_next) = ctxt->lru_next;
+			ctxt->lru_next = NULL;
+			goto found;
+		}
 	}
 
-	if(info == NULL)
+	/* the CIDs below the next CID that are not free are used */
+	if(cid < comp->ctxts_next_cid)
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "structure for last packet information is not valid");
 		goto error;
 	}
-
-	/* check compatibility version */
-	if(info->version_major == 0)
+	do
 	{
-		/* base fields for major version 0 */
-		info->context_id = comp->last_context->cid;
-		info->is_context_init = (comp->last_context->num_sent_packets == 1);
-		info->context_mode = comp->last_context->mode;
-		info->context_state = comp->last_context->state;
-		info->context_used = (comp->last_context->used ? true : false);
-		info->profile_id = comp->last_context->profile->id;
-		info->packet_type = comp->last_context->packet_type;
-		info->total_last_uncomp_size = comp->last_context->total_last_uncompressed_size;
-		info->header_last_uncomp_size = comp->last_context->header_last_uncompressed_size;
-		info->total_last_comp_size = comp->last_context->total_last_compressed_size;
-		info->header_last_comp_size = comp->last_context->header_last_compressed_size;
-
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		ctxt = c_ctxts_alloc_next(comp);
+		if(ctxt == NULL)
 		{
-			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "last packet information", info->version_minor);
 			goto error;
 		}
+		if(ctxt->cid != cid)
+		{
+			c_free_ctxts_push(comp, ctxt);
+		}
 	}
-	else
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for last "
-		           "packet information", info->version_major);
-		goto error;
-	}
+	while(ctxt->cid != cid);
 
-	return true;
+found:
+	return ctxt;
 
 error:
-	return false;
+	return NULL;
 }
 
 
 /**
- * @brief Get some general information about the compressor
- *
- * Get some general information about the compressor.
+ * @brief Take the smallest CID that was never used
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_comp_general_info_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
- *
- * See the \ref rohc_comp_general_info_t structure for details about fields
- * that are supported in the above versions.
- *
- * @param comp          The ROHC compressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
- *
- * @ingroup rohc_comp
+ * The block of contexts that contains the CID is allocated if needed.
  *
- * @see rohc_comp_general_info_t
+ * @param comp  The ROHC compressor
+ * @return      The unused compression context, NULL if all the CIDs were
+ *              used once or if memory allocation failed
  */
-bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
-                                rohc_comp_general_info_t *const info)
+static struct rohc_comp_ctxt * c_ctxts_alloc_next(struct rohc_comp *const comp)
 {
-	if(comp == NULL)
-	{
-		goto error;
-	}
-
-	if(info == NULL)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "structure for general information is not valid");
-		goto error;
-	}
+	struct rohc_comp_ctxt *ctxt = NULL;
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	if(comp->ctxts_next_cid <= comp->ctxts_max_cid)
 	{
-		/* base fields for major version 0 */
-		info->contexts_nr = comp->num_contexts_used;
-		info->packets_nr = comp->num_packets;
-		info->uncomp_bytes_nr = comp->total_uncompressed_size;
-		info->comp_bytes_nr = comp->total_compressed_size;
+		const rohc_cid_t cid = comp->ctxts_next_cid;
+		const size_t block_idx =
+			(cid - comp->ctxts_min_cid) / ROHC_COMP_CTXTS_BLOCK_LEN;
 
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		assert(block_idx < comp->ctxts_blocks_nr);
+		if(comp->ctxts_blocks[block_idx] == NULL)
 		{
-			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "general information", info->version_minor);
-			goto error;
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "allocate the block of contexts for CIDs %zu to %zu",
+			           comp->ctxts_min_cid + block_idx * ROHC_COMP_CTXTS_BLOCK_LEN,
+			           comp->ctxts_min_cid + (block_idx + 1) * ROHC_COMP_CTXTS_BLOCK_LEN - 1);
+			comp->ctxts_blocks[block_idx] =
+				rohc_mempool_alloc(&comp->mempool,
+				                   ROHC_COMP_CTXTS_BLOCK_LEN * sizeof(struct rohc_comp_ctxt));
+			if(comp->ctxts_blocks[block_idx] == NULL)
+			{
+				goto error;
+			}
 		}
-	}
-	else
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for "
-		           "general information", info->version_major);
-		goto error;
+		comp->ctxts_next_cid++;
+		ctxt = c_ctxt_at(comp, cid);
+		ctxt->cid = cid;
 	}
 
-	return true;
+	return ctxt;
 
 error:
-	return false;
+	return NULL;
 }
 
 
 /**
- * @brief Give a description for the given ROHC compression context state
- *
- * Give a description for the given ROHC compression context state.
- *
- * The descriptions are not part of the API. They may change between
- * releases without any warning. Do NOT use them for other means that
- * providing to users a textual description of compression context states
- * used by the library. If unsure, ask on the mailing list.
- *
- * @param state  The compression context state to get a description for
- * @return       A string that describes the given compression context state
+ * @brief Change the mode of the context.
  *
- * @ingroup rohc_comp
+ * @param context  The compression context
+ * @param new_mode The new mode the context must enter in
  */
-const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
+void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
+                           const rohc_mode_t new_mode)
 {
-	switch(state)
+	if(context->mode != new_mode)
 	{
-		case ROHC_COMP_STATE_IR:
-			return "IR";
-		case ROHC_COMP_STATE_FO:
-			return "FO";
-		case ROHC_COMP_STATE_SO:
-			return "SO";
-		case ROHC_COMP_STATE_CR:
-			return "CR";
-		case ROHC_COMP_STATE_UNKNOWN:
-		default:
-			return "no description";
+		const rohc_mode_t old_mode = context->mode;
+
+		/* TODO: R-mode is not yet supported */
+		if(new_mode == ROHC_R_MODE)
+		{
+			rohc_comp_warn(context, "ignore change to R-mode because R-mode is "
+			               "not supported yet");
+			return;
+		}
+		/* TODO: downward transition to U-mode is not yet supported */
+		if(new_mode == ROHC_U_MODE)
+		{
+			rohc_comp_warn(context, "ignore change to U-mode because such a "
+			               "transition is not supported yet");
+			return;
+		}
+
+		/* change mode and go back to IR state */
+		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: change from mode %d to mode %d",
+		          context->cid, context->mode, new_mode);
+		context->mode = new_mode;
+		c_ctxt_event(context, ROHC_COMP_CTXT_EVENT_MODE, context->state, old_mode);
+
+		c_cr_update_base(context);
 	}
 }
 
 
-/*
- * Definitions of private functions
+/**
+ * @brief Change the state of the context.
+ *
+ * @param context   The compression context
+ * @param new_state The new state the context must enter in
  */
+void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
+                            const rohc_comp_state_t new_state)
+{
+	if(new_state != context->state)
+	{
+		const rohc_comp_state_t old_state = context->state;
+
+		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: change from state %d to state %d",
+		          context->cid, context->state, new_state);
+		ROHC_PROBE4(comp_state_change, context->cid, context->profile->id,
+		            context->state, new_state);
+
+		/* reset counters */
+		context->state_oa_repeat_nr = 0;
+		context->refresh_pkts_left = 0;
+		if(new_state == ROHC_COMP_STATE_SO)
+		{
+			context->is_refreshing = false;
+		}
+
+		/* change state */
+		context->state = new_state;
+		c_ctxt_event(context, ROHC_COMP_CTXT_EVENT_STATE, old_state, context->mode);
+
+		c_cr_update_base(context);
+	}
+}
 
 
 /**
- * @brief Create a compression context
+ * @brief Register or unregister one context as a base context for CR
  *
- * @param comp         The ROHC compressor
- * @param profile      The profile to associate the context with
- * @param fingerprint  The packet/context fingerprint
- * @param pkt_hdrs     The information collected about packet headers
- * @param pkt_time     The arrival time of the packet
- * @return             The compression context if successful, NULL otherwise
+ * @param context  The compression context
  */
-static struct rohc_comp_ctxt *
-	c_create_context(struct rohc_comp *const comp,
-	                 const struct rohc_comp_profile *const profile,
-	                 const struct rohc_fingerprint *const fingerprint,
-	                 const struct rohc_pkt_hdrs *const pkt_hdrs,
-	                 const struct rohc_ts pkt_time)
+static void c_cr_update_base(struct rohc_comp_ctxt *const context)
 {
-	const struct rohc_comp_ctxt *base_ctxt = NULL;
-	struct rohc_comp_ctxt *c;
-	rohc_cid_t cid_to_use;
-
-	cid_to_use = 0;
+	if(context->is_dryrun)
+	{
+		return;
+	}
 
-	/* if all the contexts in the array are used:
-	 *   => recycle the oldest context to make room
-	 * if at least one context in the array is not used:
-	 *   => pick the first unused context
+	/* the context can be used as a base context for Context Replication
+	 * if it is fully established with the remote decompressor: fully
+	 * established means that the static part of the context was explicitly
+	 * acknowledged by the decompressor through one ACK protected by a CRC
 	 */
-	if(comp->num_contexts_used > comp->medium.max_cid)
+	if(rohc_comp_profile_has_cr(context->profile))
 	{
-		/* all the contexts in the array were used, recycle the oldest context
-		 * to make some room */
-
-		uint64_t oldest;
-		rohc_cid_t i;
-
-		/* find the oldest context */
-		oldest = 0xffffffff;
-		for(i = 0; i <= comp->medium.max_cid; i++)
+		if(context->mode > ROHC_U_MODE &&
+		   (context->state == ROHC_COMP_STATE_FO ||
+		    context->state == ROHC_COMP_STATE_SO))
 		{
-			if(comp->contexts[i].latest_used < oldest)
+			rohc_comp_debug(context, "CR: context CID %u is considered as "
+			                "established", context->cid);
+			if(!hashtable_add(&context->compressor->contexts_cr,
+			                  &context->fingerprint.base,
+			                  rohc_fingerprint_base_len(&context->fingerprint.base),
+			                  context))
+			{
+				rohc_comp_warn(context, "CR: failed to register context CID %u "
+				               "as a base context", context->cid);
+			}
+			else if(!hashtable_add(&context->compressor->contexts_cr_by_dst_port,
+			                       c_cr_dst_port_key(&context->fingerprint),
+			                       c_cr_dst_port_key_len(&context->fingerprint),
+			                       context))
 			{
-				oldest = comp->contexts[i].latest_used;
-				cid_to_use = i;
+				rohc_comp_warn(context, "CR: failed to index base context CID %u "
+				               "by destination port", context->cid);
+				hashtable_del(&context->compressor->contexts_cr,
+				              &context->fingerprint.base,
+				              rohc_fingerprint_base_len(&context->fingerprint.base),
+				              context);
 			}
 		}
-		c = &comp->contexts[cid_to_use];
+		else
+		{
+			rohc_comp_debug(context, "CR: context CID %u is not considered as "
+			                "established", context->cid);
+			hashtable_del(&context->compressor->contexts_cr,
+			              &context->fingerprint.base,
+			              rohc_fingerprint_base_len(&context->fingerprint.base),
+			              context);
+			hashtable_del(&context->compressor->contexts_cr_by_dst_port,
+			              c_cr_dst_port_key(&context->fingerprint),
+			              c_cr_dst_port_key_len(&context->fingerprint),
+			              context);
+		}
+	}
+}
 
-		/* destroy the oldest context before replacing it with a new one */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "recycle oldest context (CID %u with profile 0x%04x)",
-		           cid_to_use, c->profile->id);
-		if(c->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+
+/**
+ * @brief Periodically change the context state after a certain number
+ *        of packets.
+ *
+ * @param context   The compression context
+ * @param pkt_time  The time of packet arrival
+ */
+void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context,
+                                        const struct rohc_ts pkt_time)
+{
+	struct rohc_comp *const comp = context->compressor;
+	size_t ir_timeout_pkts;
+	size_t fo_timeout_pkts;
+	bool time_based;
+	rohc_comp_state_t next_state;
+	bool is_ir_due;
+
+	/* no periodic refresh is due before the deadline of the context */
+	if(context->refresh_pkts_left > 0 &&
+	   rohc_time_is_before(pkt_time, context->refresh_deadline))
+	{
+		assert(context->state == ROHC_COMP_STATE_SO);
+		context->refresh_pkts_left--;
+		context->go_back_ir_count++;
+		context->go_back_fo_count++;
+		return;
+	}
+
+	ir_timeout_pkts =
+		c_refresh_scale(context, comp->periodic_refreshes_ir_timeout_pkts);
+	ir_timeout_pkts -= c_refresh_jitter(context, ir_timeout_pkts);
+	fo_timeout_pkts =
+		c_refresh_scale(context, comp->periodic_refreshes_fo_timeout_pkts);
+	fo_timeout_pkts -= c_refresh_jitter(context, fo_timeout_pkts);
+	time_based = ((comp->features & ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) != 0);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+	           "CID %u: timeouts for periodic refreshes: FO = %zu / %zu, "
+	           "IR = %zu / %zu", context->cid, context->go_back_fo_count,
+	           fo_timeout_pkts, context->go_back_ir_count, ir_timeout_pkts);
+
+	if(context->go_back_ir_count >= ir_timeout_pkts)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: periodic change to IR state", context->cid);
+		is_ir_due = true;
+	}
+	else if(time_based &&
+	        rohc_time_interval(context->go_back_ir_time, pkt_time) >=
+	        c_refresh_timeout_us(context, comp->periodic_refreshes_ir_timeout_time))
+	{
+		const uint64_t interval_since_ir_refresh =
+			rohc_time_interval(context->go_back_ir_time, pkt_time);
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: force IR refresh since %" PRIu64 " us elapsed since "
+		          "last IR packet", context->cid, interval_since_ir_refresh);
+		is_ir_due = true;
+	}
+	else
+	{
+		is_ir_due = false;
+	}
+
+	/* the IR refresh waits for the next interval if the IR budget of the
+	 * compressor is exhausted, the FO refresh may be done meanwhile */
+	if(is_ir_due && !comp->defer_refreshes &&
+	   !c_ir_refresh_budget_avail(comp, pkt_time))
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: IR refresh deferred, %zu bytes of IR headers already "
+		          "sent in the current interval", context->cid,
+		          comp->ir_refresh_budget_used);
+		if(!context->is_dryrun)
 		{
-			comp->uncompressed_ctxt = NULL;
+			rohc_stats_write_begin(&comp->stats_seq);
+			comp->num_ir_refreshes_deferred++;
+			rohc_stats_write_end(&comp->stats_seq);
 		}
-		else
+		is_ir_due = false;
+	}
+
+	/* the overloaded compressor defers the periodic IR refreshes up to twice
+	 * their timeouts, the FO refresh may be done meanwhile */
+	if(is_ir_due && !comp->defer_refreshes &&
+	   c_overload_level(comp) >= ROHC_COMP_OVERLOAD_DEFER &&
+	   context->go_back_ir_count < (ir_timeout_pkts * 2) &&
+	   (!time_based ||
+	    rohc_time_interval(context->go_back_ir_time, pkt_time) <
+	    (c_refresh_timeout_us(context, comp->periodic_refreshes_ir_timeout_time) * 2)))
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: IR refresh deferred, the compressor is overloaded",
+		          context->cid);
+		if(!context->is_dryrun)
 		{
-			hashtable_del(&comp->contexts_by_fingerprint, &c->fingerprint);
-			/* TODO: replace TCP by CR capacity */
-			if(c->profile->id == ROHCv1_PROFILE_IP_TCP)
-			{
-				hashtable_cr_del(&comp->contexts_cr, &c->fingerprint);
-			}
+			rohc_stats_write_begin(&comp->stats_seq);
+			comp->num_ir_refreshes_deferred++;
+			rohc_stats_write_end(&comp->stats_seq);
 		}
-		c->profile->destroy(&comp->contexts[cid_to_use]);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		is_ir_due = false;
+	}
+
+	if(comp->defer_refreshes)
+	{
+		/* the packet shall fit in a length that the refresh would exceed:
+		 * keep the counters, the refreshes are done by the next packets */
+		rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+		           "CID %u: periodic refreshes deferred for a size-constrained "
+		           "packet", context->cid);
+		next_state = context->state;
+	}
+	else if(is_ir_due)
+	{
+		context->go_back_ir_count = 0;
+		context->refresh_jitter = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
+		next_state = ROHC_COMP_STATE_IR;
+	}
+	else if(context->go_back_fo_count >= fo_timeout_pkts)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: periodic change to FO state", context->cid);
+		context->go_back_fo_count = 0;
+		next_state = ROHC_COMP_STATE_FO;
+	}
+	else if(time_based &&
+	        rohc_time_interval(context->go_back_fo_time, pkt_time) >=
+	        c_refresh_timeout_us(context, comp->periodic_refreshes_fo_timeout_time))
+	{
+		const uint64_t interval_since_fo_refresh =
+			rohc_time_interval(context->go_back_fo_time, pkt_time);
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: force FO refresh since %" PRIu64 " us elapsed since "
+		          "last FO packet", context->cid, interval_since_fo_refresh);
+		context->go_back_fo_count = 0;
+		next_state = ROHC_COMP_STATE_FO;
 	}
 	else
 	{
-		/* there was at least one unused context in the array, pick the first
-		 * unused context in the context array */
-
-		rohc_cid_t i;
-
-		/* find the first unused context */
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].used == 0)
-			{
-				cid_to_use = i;
-				break;
-			}
-		}
-		c = &comp->contexts[cid_to_use];
-
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "take the first unused context (CID %u)", cid_to_use);
+		next_state = context->state;
 	}
 
-	/* search for a possible base context if Context Replication is possible */
-	/* TODO: replace TCP by CR capacity */
-	if(profile->id == ROHCv1_PROFILE_IP_TCP)
+	/* the header bytes are accounted to the refresh until the context is
+	 * back in SO state */
+	if(next_state != context->state && !context->is_dryrun)
 	{
-		size_t best_ctxt_affinity = ROHC_AFFINITY_NONE;
-		struct rohc_comp_ctxt *candidate;
-
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "search a base context for Context Replication");
-
-		/* search for a base context that we may clone the new context from */
-		for(candidate = hashtable_cr_get_first(&comp->contexts_cr, fingerprint);
-		    candidate != NULL;
-		    candidate = hashtable_cr_get_next(&comp->contexts_cr, fingerprint,
-		                                      candidate))
-		{
-			/* context partially matches the fingerprint of the packet */
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "CR: context CID %u shares enough with packet for base context",
-			           candidate->cid);
+		context->is_refreshing = true;
+		rohc_stats_write_begin(&comp->stats_seq);
+		comp->num_refreshes++;
+		rohc_stats_write_end(&comp->stats_seq);
+	}
+	rohc_comp_change_state(context, next_state);
 
-			/* check if context may be used as a base context */
-			if(!profile->is_cr_possible(candidate, pkt_hdrs))
-			{
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "CR: context CID %u cannot be used as base context: "
-				           "IR-CR packet cannot transmit some differences",
-				           candidate->cid);
-			}
-			else
-			{
-				/* context can be used base context for Context Replication (CR),
-				 * compute how much it shares with packet */
-				rohc_ctxt_affinity_t ctxt_affinity = ROHC_AFFINITY_LOW;
-				if(candidate->fingerprint.src_port == fingerprint->src_port)
-				{
-					ctxt_affinity++;
-				}
-				if(candidate->fingerprint.dst_port == fingerprint->dst_port)
-				{
-					ctxt_affinity++;
-				}
-				assert(ctxt_affinity != ROHC_AFFINITY_HIGH);
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "CR: context CID %u scores %u as base context",
-				           candidate->cid, ctxt_affinity);
-				if(ctxt_affinity > best_ctxt_affinity)
-				{
-					base_ctxt = candidate;
-					best_ctxt_affinity = ctxt_affinity;
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "CR: context CID %u is the best base context found yet",
-					           candidate->cid);
-					if(ctxt_affinity == ROHC_AFFINITY_MED)
-					{
-						rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-						           "CR: maximum affinity reached, stop search");
-						break;
-					}
-				}
-			}
-		}
+	if(context->state == ROHC_COMP_STATE_SO)
+	{
+		context->go_back_ir_count++;
+		context->go_back_fo_count++;
 
-		if(base_ctxt != NULL)
+		/* in SO state, the counters and the times of the refreshes only move
+		 * forward: compute when the next refresh is due once, the next packets
+		 * are only compared with the deadline */
+		context->refresh_pkts_left =
+			rohc_min(c_pkts_until(context->go_back_ir_count, ir_timeout_pkts),
+			         c_pkts_until(context->go_back_fo_count, fo_timeout_pkts));
+		if(time_based)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "CR: context CID %u is the best base context found",
-			           base_ctxt->cid);
+			const struct rohc_ts ir_deadline =
+				rohc_time_add_us(context->go_back_ir_time,
+				                 c_refresh_timeout_us(context,
+				                                      comp->periodic_refreshes_ir_timeout_time));
+			const struct rohc_ts fo_deadline =
+				rohc_time_add_us(context->go_back_fo_time,
+				                 c_refresh_timeout_us(context,
+				                                      comp->periodic_refreshes_fo_timeout_time));
+			context->refresh_deadline =
+				(rohc_time_is_before(ir_deadline, fo_deadline) ? ir_deadline : fo_deadline);
 		}
 		else
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "CR: no context may be used as base context");
+			context->refresh_deadline.sec = UINT64_MAX;
+			context->refresh_deadline.nsec = 0;
 		}
 	}
-
-	/* context replication? */
-	if(base_ctxt != NULL)
+	else if(context->state == ROHC_COMP_STATE_FO)
 	{
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "create context with CID %u as a replication of context "
-		           "with CID %u", cid_to_use, base_ctxt->cid);
-
-		/* copy the base context, then reset some parts of it */
-		memcpy(c, base_ctxt, sizeof(struct rohc_comp_ctxt));
-		c->do_ctxt_replication = true;
-		c->cr_base_cid = base_ctxt->cid;
-		c->state = ROHC_COMP_STATE_CR;
+		context->go_back_ir_count++;
+		context->go_back_fo_time = pkt_time;
 	}
-	else
+	else /* ROHC_COMP_STATE_IR */
 	{
-		c->do_ctxt_replication = false;
-		c->state = ROHC_COMP_STATE_IR;
+		context->go_back_fo_time = pkt_time;
+		context->go_back_ir_time = pkt_time;
 	}
+}
 
-	memcpy(&c->fingerprint, fingerprint, sizeof(struct rohc_fingerprint));
 
-	c->state_oa_repeat_nr = 0;
-	c->go_back_fo_count = 0;
-	c->go_back_fo_time = pkt_time;
-	c->go_back_ir_count = 0;
-	c->go_back_ir_time = pkt_time;
+/**
+ * @brief Compute the number of packets before one counter reaches a timeout
+ *
+ * @param count    The counter
+ * @param timeout  The timeout
+ * @return         The number of packets before the timeout, 0 if the
+ *                 timeout is already reached
+ */
+static size_t c_pkts_until(const size_t count, const size_t timeout)
+{
+	return (count < timeout ? timeout - count : 0);
+}
 
-	c->total_uncompressed_size = 0;
-	c->total_compressed_size = 0;
-	c->header_uncompressed_size = 0;
-	c->header_compressed_size = 0;
 
-	c->total_last_uncompressed_size = 0;
-	c->total_last_compressed_size = 0;
-	c->header_last_uncompressed_size = 0;
-	c->header_last_compressed_size = 0;
+/**
+ * @brief Get the current step of degradation of the compressor
+ *
+ * @param comp  The ROHC compressor
+ * @return      The step asked by the application or derived from the
+ *              compression latency, the highest of both
+ */
+static rohc_comp_overload_t c_overload_level(const struct rohc_comp *const comp)
+{
+	return rohc_max(comp->overload_asked, comp->overload_measured);
+}
 
-	c->num_sent_packets = 0;
 
-	c->cid = cid_to_use;
-	c->profile = profile;
+/**
+ * @brief Whether the compressor may create a new context for a new flow
+ *
+ * The new flows that are refused a new context are sent with the Uncompressed
+ * profile, so a new context is never refused if the Uncompressed profile is
+ * disabled.
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if a new context may be created, false if the new flow
+ *              shall be sent with the Uncompressed profile
+ */
+static bool c_overload_may_create(struct rohc_comp *const comp)
+{
+	const rohc_comp_overload_t level = c_overload_level(comp);
 
-	c->mode = ROHC_U_MODE;
+	if(level < ROHC_COMP_OVERLOAD_THROTTLE ||
+	   !rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_UNCOMPRESSED))
+	{
+		return true;
+	}
+	if(level == ROHC_COMP_OVERLOAD_THROTTLE &&
+	   comp->num_packets >= comp->overload_next_ctxt_pkt)
+	{
+		comp->overload_next_ctxt_pkt =
+			comp->num_packets + ROHC_COMP_OVERLOAD_CTXT_PKTS;
+		return true;
+	}
 
-	c->compressor = comp;
+	return false;
+}
 
-	/* create profile-specific context */
-	if(c->do_ctxt_replication)
+
+/**
+ * @brief Whether the new flow ended its warm-up and may get a new context
+ *
+ * The packets of the new flow are counted from the first one, the count
+ * starts again once the warm-up window elapsed. The entry of the flow is
+ * taken over by any other new flow that hashes to it.
+ *
+ * @param comp         The ROHC compressor
+ * @param fingerprint  The fingerprint of the new flow
+ * @param now          The arrival time of the packet of the new flow
+ * @return             true if a new context may be created, false if the new
+ *                     flow shall be sent with the Uncompressed profile
+ */
+static bool c_warmup_may_create(struct rohc_comp *const comp,
+                                const struct rohc_fingerprint *const fingerprint,
+                                const struct rohc_ts now)
+{
+	struct rohc_comp_warmup_flow *entry;
+	uint64_t hash;
+
+	if(comp->warmup_pkts_nr <= 1 ||
+	   !rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_UNCOMPRESSED))
 	{
-		if(!profile->clone(c, base_ctxt))
-		{
-			return NULL;
-		}
+		return true;
 	}
-	else
+
+	hash = hashtable_hash(&comp->contexts_by_fingerprint, fingerprint,
+	                      rohc_fingerprint_len(fingerprint));
+	entry = &comp->warmup_flows[hash & (ROHC_COMP_WARMUP_FLOWS_LEN - 1)];
+	if(entry->pkts_nr == 0 || entry->hash != hash ||
+	   (comp->warmup_window_ms != 0 &&
+	    rohc_time_interval(entry->first, now) > (comp->warmup_window_ms * 1000U)))
 	{
-		if(!profile->create(c, pkt_hdrs))
-		{
-			return NULL;
-		}
+		/* first packet of the flow within the window */
+		entry->hash = hash;
+		entry->first = now;
+		entry->pkts_nr = 1;
+	}
+	else if(entry->pkts_nr < comp->warmup_pkts_nr)
+	{
+		entry->pkts_nr++;
 	}
 
-	/* if creation is successful, mark the context as used */
-	c->used = 1;
-	c->first_used = pkt_time.sec;
-	c->latest_used = pkt_time.sec;
-	assert(comp->num_contexts_used <= comp->medium.max_cid);
-	comp->num_contexts_used++;
+	/* the entry is kept once the warm-up ended, so that the flow still gets
+	 * its context if the creation fails for another reason */
+	return (entry->pkts_nr >= comp->warmup_pkts_nr);
+}
 
-	/* insert the context in the hash table of contexts to efficiently find it
-	 * again through its fingerprint */
-	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+
+/**
+ * @brief Derive the step of degradation from the latency of one packet
+ *
+ * The compression time per packet is smoothed over about 16 packets. The
+ * degradation goes one step up once the smoothed time reaches the next step,
+ * and one step down once it is a quarter of step below the current one, so
+ * that the step does not switch back and forth.
+ *
+ * @param comp         The ROHC compressor
+ * @param duration_ns  The time spent to compress the packet (in ns)
+ */
+static void c_overload_measure(struct rohc_comp *const comp,
+                               const uint64_t duration_ns)
+{
+	const uint64_t step_ns = comp->overload_step_ns;
+	const rohc_comp_overload_t level = comp->overload_measured;
+
+	comp->overload_avg_ns =
+		comp->overload_avg_ns - comp->overload_avg_ns / 16 + duration_ns / 16;
+
+	if(level < ROHC_COMP_OVERLOAD_SHED &&
+	   comp->overload_avg_ns >= (step_ns * (level + 1)))
 	{
-		comp->uncompressed_ctxt = c;
+		comp->overload_measured = level + 1;
+	}
+	else if(level > ROHC_COMP_OVERLOAD_NONE &&
+	        (comp->overload_avg_ns * 4) < (step_ns * (level * 4 - 1)))
+	{
+		comp->overload_measured = level - 1;
 	}
 	else
 	{
-		hashtable_add(&comp->contexts_by_fingerprint, &(c->fingerprint), c);
+		return;
 	}
 
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "context (CID %u) created at %" PRIu64 " seconds (num_used = %u)",
-	           c->cid, c->latest_used, comp->num_contexts_used);
-	return c;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "compression "
+	          "takes %" PRIu64 " ns per packet: overload step %d -> %d",
+	          comp->overload_avg_ns, level, comp->overload_measured);
 }
 
 
 /**
- * @brief Compute the affinity between the given packet and context
+ * @brief Check the periodic refreshes of all contexts on their next packet
  *
- * @param ctxt             The context to compute the affinity with
- * @param pkt_fingerprint  The fingerprint of the packet to compute the affinity with
- * @param pkt_hdrs         The information collected about packet headers
- * @return                 The affinity between the packet and context
+ * The deadlines of the periodic refreshes are computed again, after a change
+ * of the configuration of the refreshes for example.
+ *
+ * @param comp  The ROHC compressor
  */
-static rohc_ctxt_affinity_t
-	rohc_comp_get_ctxt_affinity(const struct rohc_comp_ctxt *const ctxt,
-	                            const struct rohc_fingerprint *const pkt_fingerprint,
-	                            const struct rohc_pkt_hdrs *const pkt_hdrs)
+static void c_refresh_deadlines_reset(struct rohc_comp *const comp)
 {
-	size_t affinity;
+	struct rohc_comp_ctxt *ctxt;
 
-	/* TODO: replace TCP by CR capacity */
-	assert(pkt_fingerprint->base.profile_id == ROHCv1_PROFILE_IP_TCP);
-	assert(ctxt->profile->id == ROHCv1_PROFILE_IP_TCP);
+	for(ctxt = comp->ctxts_lru_first; ctxt != NULL; ctxt = ctxt->lru_next)
+	{
+		ctxt->refresh_pkts_left = 0;
+	}
+}
 
-	if(memcmp(&ctxt->fingerprint.base, &pkt_fingerprint->base,
-	          sizeof(struct rohc_fingerprint_base)) == 0)
+
+/**
+ * @brief Get the number of Optimistic Approach repetitions for U-mode
+ *
+ * Without adaptation, the number configured with
+ * \ref rohc_comp_set_optimistic_approach. With adaptation, the smallest
+ * number of repetitions for which all the repetitions of one change are lost
+ * with a probability below 1/1000, for the loss rate estimated by the
+ * application, in range [min, configured].
+ *
+ * @param comp  The ROHC compressor
+ * @return      The number of repetitions
+ */
+static uint8_t c_oa_repetitions(const struct rohc_comp *const comp)
+{
+	uint32_t all_lost_ppm = 1000000U; /* 10^6 = probability 1 */
+	uint8_t repetitions_nr = 0;
+
+	if(comp->oa_repetitions_min == 0)
 	{
-		/* the TCP context partially matches, it might be used as a base for Context
-		 * Replication (CR) */
-		if(ctxt->profile->is_cr_possible(ctxt, pkt_hdrs))
-		{
-			/* context can be used base context for Context Replication (CR),
-			 * compute how much it shares with packet */
-			affinity = ROHC_AFFINITY_LOW;
-			if(ctxt->fingerprint.src_port == pkt_fingerprint->src_port)
-			{
-				affinity++;
-			}
-			if(ctxt->fingerprint.dst_port == pkt_fingerprint->dst_port)
-			{
-				affinity++;
-			}
-		}
-		else
-		{
-			affinity = ROHC_AFFINITY_NONE;
-		}
+		return comp->oa_repetitions_nr;
 	}
-	else
+
+	while(all_lost_ppm > 1000U && repetitions_nr < comp->oa_repetitions_nr)
 	{
-		affinity = ROHC_AFFINITY_NONE;
+		all_lost_ppm = all_lost_ppm * comp->oa_loss_permille / 1000U;
+		repetitions_nr++;
 	}
 
-	return affinity;
+	return rohc_max(repetitions_nr, comp->oa_repetitions_min);
+}
+
+
+/**
+ * @brief Compute how much one periodic refresh of one context is brought
+ *        forward
+ *
+ * The jitter is a share of the timeout of the refresh between 0 and the
+ * maximal jitter of the compressor, drawn randomly for every context: the
+ * contexts created or refreshed at the same time do not refresh at the same
+ * time again.
+ *
+ * @param context  The compression context
+ * @param timeout  The timeout of the periodic refresh
+ * @return         The jitter, lower than the timeout
+ */
+static size_t c_refresh_jitter(const struct rohc_comp_ctxt *const context,
+                               const size_t timeout)
+{
+	const size_t timeout_max = SIZE_MAX / 100U;
+	const size_t max_jitter =
+		(rohc_min(timeout, timeout_max) * context->compressor->refresh_jitter_pct) /
+		100U;
+
+	return (size_t) ((((uint64_t) max_jitter) * context->refresh_jitter) >> 16);
 }
 
 
 /**
- * @brief Find a compression context given an IP packet
+ * @brief Compute the time-based timeout of one periodic refresh of one context
  *
- * @param comp             The ROHC compressor
- * @param profile          The profile to use
- * @param packet           The packet to find a compression context for
- * @param pkt_fingerprint  The packet fingerprint
- * @param pkt_hdrs         The information collected about packet headers
- * @return                 The context if found or successfully created,
- *                         NULL if not found
+ * @param context     The compression context
+ * @param timeout_ms  The timeout (in ms) of the periodic refresh
+ * @return            The timeout (in us) minus the jitter of the context
  */
-static struct rohc_comp_ctxt *
-	rohc_comp_find_ctxt(struct rohc_comp *const comp,
-	                    const struct rohc_comp_profile *const profile,
-	                    const struct rohc_buf *const packet,
-	                    const struct rohc_fingerprint *const pkt_fingerprint,
-	                    const struct rohc_pkt_hdrs *const pkt_hdrs)
+static uint64_t c_refresh_timeout_us(const struct rohc_comp_ctxt *const context,
+                                     const uint64_t timeout_ms)
 {
-	struct rohc_comp_ctxt *context;
+	const uint64_t scaled_ms = c_refresh_scale(context, timeout_ms);
+	const size_t timeout = rohc_min(scaled_ms, SIZE_MAX / 100U);
 
-	/* get the context matching the packet */
-	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+	return (scaled_ms - c_refresh_jitter(context, timeout)) * 1000U;
+}
+
+
+/**
+ * @brief Adapt one timeout of the periodic refreshes to the losses
+ *
+ * @param context  The compression context
+ * @param timeout  The configured timeout of the periodic refresh
+ * @return         The timeout adapted to the loss estimate if the context is
+ *                 in U-mode, the configured timeout otherwise
+ */
+static uint64_t c_refresh_scale(const struct rohc_comp_ctxt *const context,
+                                const uint64_t timeout)
+{
+	const unsigned int scale_pct = context->compressor->refresh_scale_pct;
+
+	if(context->mode != ROHC_U_MODE || scale_pct == 100)
 	{
-		/* there is already one context with the Uncompressed profile, and
-		 * there is no need for several contexts, let's re-use that one */
-		context = comp->uncompressed_ctxt;
+		return timeout;
 	}
-	else /* non-Uncompressed profiles */
-	{
-		/* search for an existing context matching the packet fingerprint */
-		context = hashtable_get(&comp->contexts_by_fingerprint, pkt_fingerprint);
 
-		/* hmmm, looks like we could re-use that context ; if Context Replication
-		 * is in action, check that the base context didn't change too much */
-		if(context != NULL &&
-		   profile->id == ROHCv1_PROFILE_IP_TCP && /* TODO: replace TCP by CR capacity */
-		   context->do_ctxt_replication &&
-		   context->state == ROHC_COMP_STATE_CR &&
-		   context->state_oa_repeat_nr < comp->oa_repetitions_nr)
-		{
-			/* Context Replication is in action, so check whether the base context
-			 * changed too much to be re-used or not */
-			const struct rohc_comp_ctxt *const base_ctxt =
-				&(comp->contexts[context->cr_base_cid]);
-			rohc_ctxt_affinity_t base_ctxt_affinity;
+	return rohc_max((timeout / 100U) * scale_pct +
+	                ((timeout % 100U) * scale_pct) / 100U, 1U);
+}
 
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "Context Replication in action (%u/%u packets sent): check "
-			           "for CID %u whether base context with CID %u changed too much",
-			           context->state_oa_repeat_nr, comp->oa_repetitions_nr,
-			           context->cid, base_ctxt->cid);
 
-			/* there are two ways the base context may have changed:
-			 *   - the base context now matches exactly the replicated context
-			 *   - the base context does not share enough with the replicated context */
-			base_ctxt_affinity =
-				rohc_comp_get_ctxt_affinity(base_ctxt, pkt_fingerprint, pkt_hdrs);
-			if(base_ctxt_affinity != ROHC_AFFINITY_NONE)
-			{
-				/* no large change, we may continue the Context Replication */
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "re-using context CID %u as a replication of context "
-				           "CID %u", context->cid, base_ctxt->cid);
-			}
-			else
-			{
-				/* too much change, we need to interrupt the Context Replication */
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "cannot re-use context CID %u as replication of context "
-				           "CID %u, the base context changed too much", context->cid,
-				           base_ctxt->cid);
-				context = NULL;
-				/* TODO: destroy that half-opened context */
-			}
-		}
-	}
+/**
+ * @brief Compute how much the periodic refreshes in U-mode are stretched or
+ *        shrunk for the current loss estimate
+ *
+ * The contexts check their periodic refreshes again on their next packet if
+ * the timeouts changed.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void c_refresh_scale_update(struct rohc_comp *const comp)
+{
+	const unsigned int loss = comp->oa_loss_permille;
+	const unsigned int min_pct = comp->refresh_adapt_min_pct;
+	const unsigned int max_pct = comp->refresh_adapt_max_pct;
+	unsigned int scale_pct;
 
-	if(context != NULL)
+	if(loss <= ROHC_COMP_REFRESH_LOSS_REF)
 	{
-		/* matching context found, update use timestamp */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "re-using context CID %u", context->cid);
-		context->latest_used = packet->time.sec;
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "context (CID %u) used at %" PRIu64 " seconds",
-		           context->cid, context->latest_used);
+		scale_pct = max_pct - ((max_pct - 100U) * loss) / ROHC_COMP_REFRESH_LOSS_REF;
 	}
-	else /* context not found, create a new one */
+	else if(loss < ROHC_COMP_REFRESH_LOSS_MAX)
 	{
-
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "no existing context found for packet, create it");
-
-		/* create the new context from packet (and from the base context if
-		 * Context Replication is possible) */
-		context = c_create_context(comp, profile, pkt_fingerprint, pkt_hdrs, packet->time);
-		if(context == NULL)
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to create a new context");
-		}
+		scale_pct = 100U - ((100U - min_pct) * (loss - ROHC_COMP_REFRESH_LOSS_REF)) /
+		            (ROHC_COMP_REFRESH_LOSS_MAX - ROHC_COMP_REFRESH_LOSS_REF);
+	}
+	else
+	{
+		scale_pct = min_pct;
 	}
 
-	return context;
+	if(scale_pct != comp->refresh_scale_pct)
+	{
+		comp->refresh_scale_pct = scale_pct;
+		c_refresh_deadlines_reset(comp);
+	}
 }
 
 
 /**
- * @brief Find out a context given its CID
+ * @brief Whether the IR budget of the compressor allows one more IR refresh
  *
- * @param comp The ROHC compressor
- * @param cid  The CID of the context to find
- * @return     The context with the given CID if found, NULL otherwise
+ * @param comp  The ROHC compressor
+ * @param now   The current time
+ * @return      true if one IR refresh may be sent, false if it shall wait for
+ *              the next interval
  */
-static struct rohc_comp_ctxt *
-	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+static bool c_ir_refresh_budget_avail(struct rohc_comp *const comp,
+                                      const struct rohc_ts now)
 {
-	/* the CID must not be larger than the context array */
-	if(cid > comp->medium.max_cid)
-	{
-		goto not_found;
-	}
-
-	/* the context with the given CID must be in use */
-	if(comp->contexts[cid].used == 0)
+	if(comp->ir_refresh_budget == 0)
 	{
-		goto not_found;
+		return true;
 	}
+	c_ir_refresh_budget_update(comp, now);
 
-	return &(comp->contexts[cid]);
-
-not_found:
-	return NULL;
+	return (comp->ir_refresh_budget_used < comp->ir_refresh_budget);
 }
 
 
 /**
- * @brief Create the array of compression contexts
+ * @brief Start a new interval of the IR budget if the current one expired
  *
- * @param comp The ROHC compressor
- * @return     true if the creation is successful, false otherwise
+ * @param comp  The ROHC compressor
+ * @param now   The current time
  */
-static bool c_create_contexts(struct rohc_comp *const comp)
+static void c_ir_refresh_budget_update(struct rohc_comp *const comp,
+                                       const struct rohc_ts now)
 {
-	assert(comp->contexts == NULL);
+	if(rohc_time_interval(comp->ir_refresh_budget_start, now) >=
+	   comp->ir_refresh_budget_interval * 1000U)
+	{
+		comp->ir_refresh_budget_start = now;
+		comp->ir_refresh_budget_used = 0;
+	}
+}
 
-	comp->num_contexts_used = 0;
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "create enough room for %u contexts (MAX_CID = %u)",
-	          comp->medium.max_cid + 1, comp->medium.max_cid);
+/**
+ * @brief Adapt the width of the W-LSB windows of a context to one positive ACK
+ *
+ * The windows shall keep the acknowledged packet until the next ACK comes
+ * back, even if one ACK is lost: the width follows the number of packets
+ * already sent after the acknowledged one, plus twice the number of packets
+ * sent between two ACKs. The windows are narrowed one entry per ACK, and
+ * widened at once. They stay inside the W-LSB objects: contexts configured
+ * with wider windows keep their width.
+ *
+ * @param context  The compression context that received a positive ACK
+ * @param ack_lag  The number of packets sent after the acknowledged one
+ * @return         The width of the W-LSB windows of the context
+ */
+size_t rohc_comp_wlsb_width_on_ack(struct rohc_comp_ctxt *const context,
+                                   const size_t ack_lag)
+{
+	const size_t interval = context->num_sent_packets - context->wlsb_ack_pkt_nr;
+	size_t width;
 
-	comp->contexts = calloc(comp->medium.max_cid + 1,
-	                        sizeof(struct rohc_comp_ctxt));
-	if(comp->contexts == NULL)
+	if(context->compressor->oa_repetitions_nr > ROHC_WLSB_INLINE_WIDTH)
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "cannot allocate memory for contexts");
-		goto error;
+		return context->wlsb_width;
 	}
 
-	return true;
+	/* smooth the number of packets between ACKs over the last few ACKs */
+	if(context->wlsb_ack_interval == 0)
+	{
+		context->wlsb_ack_interval = interval;
+	}
+	else
+	{
+		context->wlsb_ack_interval = (context->wlsb_ack_interval * 3 + interval + 2) / 4;
+	}
+	context->wlsb_ack_lag = ack_lag;
+	context->wlsb_ack_pkt_nr = context->num_sent_packets;
+	context->wlsb_ack_in_window = true;
 
-error:
-	return false;
+	width = rohc_min(ack_lag, ROHC_WLSB_INLINE_WIDTH) +
+	        2 * rohc_max(interval, context->wlsb_ack_interval) + 1;
+	width = rohc_max(width, ROHC_WLSB_WIDTH_MIN);
+	width = rohc_min(width, ROHC_WLSB_INLINE_WIDTH);
+	if(width < context->wlsb_width)
+	{
+		width = context->wlsb_width - 1;
+	}
+	if(width != context->wlsb_width)
+	{
+		rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		           "CID %u: ACK after %zu packets with a lag of %zu packets, "
+		           "W-LSB width %u -> %zu", context->cid, interval, ack_lag,
+		           context->wlsb_width, width);
+		context->wlsb_width = width;
+	}
+
+	return context->wlsb_width;
 }
 
 
 /**
- * @brief Destroy all the compression contexts in the context array
- *
- * The profile-specific contexts are also destroyed.
+ * @brief Widen the W-LSB windows of a context after one negative ACK
  *
- * @param comp The ROHC compressor
+ * @param context  The compression context that received a NACK or STATIC-NACK
+ * @return         The width of the W-LSB windows of the context
  */
-static void c_destroy_contexts(struct rohc_comp *const comp)
+size_t rohc_comp_wlsb_width_on_nack(struct rohc_comp_ctxt *const context)
 {
-	rohc_cid_t i;
-
-	assert(comp->contexts != NULL);
-
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	if(context->compressor->oa_repetitions_nr <= ROHC_WLSB_INLINE_WIDTH)
 	{
-		if(comp->contexts[i].used && comp->contexts[i].profile != NULL)
-		{
-			comp->contexts[i].profile->destroy(&comp->contexts[i]);
-		}
+		const size_t width =
+			rohc_min(context->wlsb_width * 2U, ROHC_WLSB_INLINE_WIDTH);
 
-		if(comp->contexts[i].used)
-		{
-			comp->contexts[i].used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
-		}
+		rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		           "CID %u: negative ACK, W-LSB width %u -> %zu", context->cid,
+		           context->wlsb_width, width);
+		context->wlsb_width = width;
+		context->wlsb_ack_in_window = false;
 	}
-	assert(comp->num_contexts_used == 0);
 
-	free(comp->contexts);
-	comp->contexts = NULL;
+	return context->wlsb_width;
 }
 
 
 /**
- * @brief Change the mode of the context.
+ * @brief Widen the W-LSB windows of a context if ACKs stopped coming back
+ *
+ * Called before every packet is encoded. Once the packet acknowledged by the
+ * last ACK is about to leave the windows, they are widened back to the width
+ * configured with \ref rohc_comp_set_optimistic_approach if they are
+ * narrower.
  *
  * @param context  The compression context
- * @param new_mode The new mode the context must enter in
+ * @return         The width of the W-LSB windows of the context
  */
-void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
-                           const rohc_mode_t new_mode)
+size_t rohc_comp_wlsb_width_on_send(struct rohc_comp_ctxt *const context)
 {
-	if(context->mode != new_mode)
+	if(context->wlsb_ack_in_window)
 	{
-		/* TODO: R-mode is not yet supported */
-		if(new_mode == ROHC_R_MODE)
-		{
-			rohc_comp_warn(context, "ignore change to R-mode because R-mode is "
-			               "not supported yet");
-			return;
-		}
-		/* TODO: downward transition to U-mode is not yet supported */
-		if(new_mode == ROHC_U_MODE)
-		{
-			rohc_comp_warn(context, "ignore change to U-mode because such a "
-			               "transition is not supported yet");
-			return;
-		}
-
-		/* change mode and go back to IR state */
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		          "CID %u: change from mode %d to mode %d",
-		          context->cid, context->mode, new_mode);
-		context->mode = new_mode;
+		const size_t sent_nr = context->num_sent_packets - context->wlsb_ack_pkt_nr;
 
-		/* the context can be used as a base context for Context Replication
-		 * if it is fully established with the remote decompressor: fully
-		 * established means that the static part of the context was explicitly
-		 * acknowledged by the decompressor through one ACK protected by a CRC
-		 */
-		if(context->profile->id == ROHCv1_PROFILE_IP_TCP) /* TODO: replace TCP by CR capacity */
+		if((context->wlsb_ack_lag + sent_nr + 1) >= context->wlsb_width)
 		{
-			if(context->mode > ROHC_U_MODE &&
-			   (context->state == ROHC_COMP_STATE_FO ||
-			    context->state == ROHC_COMP_STATE_SO))
-			{
-				rohc_comp_debug(context, "CR: context CID %u is considered as "
-				                "established", context->cid);
-				hashtable_cr_add(&context->compressor->contexts_cr,
-				                 &context->fingerprint, context);
-			}
-			else
+			if(context->wlsb_width < context->compressor->oa_repetitions_nr)
 			{
-				rohc_comp_debug(context, "CR: context CID %u is not considered as "
-				                "established", context->cid);
-				hashtable_cr_del(&context->compressor->contexts_cr,
-				                 &context->fingerprint);
+				rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+				           "CID %u: no ACK for %zu packets, W-LSB width %u -> %u",
+				           context->cid, sent_nr, context->wlsb_width,
+				           context->compressor->oa_repetitions_nr);
+				context->wlsb_width = context->compressor->oa_repetitions_nr;
 			}
+			context->wlsb_ack_in_window = false;
 		}
 	}
+
+	return context->wlsb_width;
 }
 
 
 /**
- * @brief Change the state of the context.
+ * @brief Repeat the changes more after one negative ACK
  *
- * @param context   The compression context
- * @param new_state The new state the context must enter in
+ * The number of repetitions of the Optimistic Approach of the context is
+ * doubled, up to the number configured with
+ * \ref rohc_comp_set_optimistic_approach, if adaptation is enabled with
+ * \ref rohc_comp_set_adaptive_oa.
+ *
+ * @param context  The compression context that received a NACK or STATIC-NACK
  */
-void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
-                            const rohc_comp_state_t new_state)
+void rohc_comp_oa_on_nack(struct rohc_comp_ctxt *const context)
 {
-	if(new_state != context->state)
-	{
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		          "CID %u: change from state %d to state %d",
-		          context->cid, context->state, new_state);
+	const struct rohc_comp *const comp = context->compressor;
 
-		/* reset counters */
-		context->state_oa_repeat_nr = 0;
-
-		/* change state */
-		context->state = new_state;
+	if(comp->oa_repetitions_min != 0)
+	{
+		const uint8_t repetitions_nr =
+			rohc_min(context->oa_repetitions_nr * 2U, comp->oa_repetitions_nr);
 
-		/* the context can be used as a base context for Context Replication
-		 * if it is fully established with the remote decompressor: fully
-		 * established means that the static part of the context was explicitly
-		 * acknowledged by the decompressor through one ACK protected by a CRC
-		 */
-		if(context->profile->id == ROHCv1_PROFILE_IP_TCP) /* TODO: replace TCP by CR capacity */
-		{
-			if(context->mode > ROHC_U_MODE &&
-			   (context->state == ROHC_COMP_STATE_FO ||
-			    context->state == ROHC_COMP_STATE_SO))
-			{
-				rohc_comp_debug(context, "CR: context CID %u is considered as "
-				                "established", context->cid);
-				hashtable_cr_add(&context->compressor->contexts_cr,
-				                 &context->fingerprint, context);
-			}
-			else
-			{
-				rohc_comp_debug(context, "CR: context CID %u is not considered as "
-				                "established", context->cid);
-				hashtable_cr_del(&context->compressor->contexts_cr,
-				                 &context->fingerprint);
-			}
-		}
+		rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+		           "CID %u: negative ACK, Optimistic Approach repetitions "
+		           "%u -> %u", context->cid, context->oa_repetitions_nr,
+		           repetitions_nr);
+		context->oa_repetitions_nr = repetitions_nr;
+		context->oa_clean_pkts_nr = 0;
 	}
 }
 
 
 /**
- * @brief Periodically change the context state after a certain number
- *        of packets.
+ * @brief Adapt the Optimistic Approach of a context before one packet is sent
  *
- * @param context   The compression context
- * @param pkt_time  The time of packet arrival
+ * In U-mode, the number of repetitions follows the loss estimate of the
+ * application. In O-mode and R-mode, it is lowered by one every
+ * \ref ROHC_COMP_OA_CLEAN_PKTS packets sent without negative ACK.
+ *
+ * @param context  The compression context
  */
-void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context,
-                                        const struct rohc_ts pkt_time)
+static void c_oa_on_send(struct rohc_comp_ctxt *const context)
 {
-	rohc_comp_state_t next_state;
-
-	rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-	           "CID %u: timeouts for periodic refreshes: FO = %zu / %zu, "
-	           "IR = %zu / %zu", context->cid, context->go_back_fo_count,
-	           context->compressor->periodic_refreshes_fo_timeout_pkts,
-	           context->go_back_ir_count,
-	           context->compressor->periodic_refreshes_ir_timeout_pkts);
+	const struct rohc_comp *const comp = context->compressor;
 
-	if(context->go_back_ir_count >=
-	   context->compressor->periodic_refreshes_ir_timeout_pkts)
+	if(context->mode == ROHC_U_MODE)
 	{
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		          "CID %u: periodic change to IR state", context->cid);
-		context->go_back_ir_count = 0;
-		next_state = ROHC_COMP_STATE_IR;
+		context->oa_repetitions_nr = c_oa_repetitions(comp);
 	}
-	else if((context->compressor->features & ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) != 0 &&
-	        rohc_time_interval(context->go_back_ir_time, pkt_time) >=
-	        context->compressor->periodic_refreshes_ir_timeout_time * 1000U)
+	else
 	{
-		const uint64_t interval_since_ir_refresh =
-			rohc_time_interval(context->go_back_ir_time, pkt_time);
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		          "CID %u: force IR refresh since %" PRIu64 " us elapsed since "
-		          "last IR packet", context->cid, interval_since_ir_refresh);
-		context->go_back_ir_count = 0;
-		next_state = ROHC_COMP_STATE_IR;
+		context->oa_clean_pkts_nr++;
+		if(context->oa_clean_pkts_nr >= ROHC_COMP_OA_CLEAN_PKTS &&
+		   context->oa_repetitions_nr > comp->oa_repetitions_min)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+			           "CID %u: no negative ACK for %zu packets, Optimistic "
+			           "Approach repetitions %u -> %u", context->cid,
+			           context->oa_clean_pkts_nr, context->oa_repetitions_nr,
+			           context->oa_repetitions_nr - 1);
+			context->oa_repetitions_nr--;
+			context->oa_clean_pkts_nr = 0;
+		}
 	}
-	else if(context->go_back_fo_count >=
-	        context->compressor->periodic_refreshes_fo_timeout_pkts)
+}
+
+
+/**
+ * @brief Get the smallest reorder ratio for the contexts of the compressor
+ *
+ * Without adaptation, the ratio configured with
+ * \ref rohc_comp_set_reorder_ratio. With adaptation, the smallest ratio for
+ * which the interpretation interval of 4 MSN bits handles the reordering
+ * depth estimated by the application, up to the configured ratio.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The reorder ratio
+ */
+static rohc_reordering_offset_t c_reorder_ratio(const struct rohc_comp *const comp)
+{
+	rohc_reordering_offset_t reorder_ratio = ROHC_REORDERING_NONE;
+
+	if(!comp->reorder_ratio_auto)
 	{
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		          "CID %u: periodic change to FO state", context->cid);
-		context->go_back_fo_count = 0;
-		next_state = ROHC_COMP_STATE_FO;
+		return comp->reorder_ratio;
 	}
-	else if((context->compressor->features & ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) != 0 &&
-	        rohc_time_interval(context->go_back_fo_time, pkt_time) >=
-	        context->compressor->periodic_refreshes_fo_timeout_time * 1000U)
+
+	while(reorder_ratio < comp->reorder_ratio &&
+	      rohc_interval_get_rfc5225_msn_p(4, reorder_ratio) < comp->reorder_depth)
 	{
-		const uint64_t interval_since_fo_refresh =
-			rohc_time_interval(context->go_back_fo_time, pkt_time);
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		          "CID %u: force FO refresh since %" PRIu64 " us elapsed since "
-		          "last FO packet", context->cid, interval_since_fo_refresh);
-		context->go_back_fo_count = 0;
-		next_state = ROHC_COMP_STATE_FO;
+		reorder_ratio++;
 	}
-	else
+
+	return reorder_ratio;
+}
+
+
+/**
+ * @brief Change the reorder ratio of one context
+ *
+ * The new ratio shall be transmitted in co_common or co_repair packets before
+ * the smaller packets that use it are sent.
+ *
+ * @param context        The compression context
+ * @param reorder_ratio  The new reorder ratio
+ */
+static void c_reorder_ratio_change(struct rohc_comp_ctxt *const context,
+                                   const rohc_reordering_offset_t reorder_ratio)
+{
+	if(reorder_ratio != context->reorder_ratio)
 	{
-		next_state = context->state;
+		rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		           "CID %u: reorder ratio %u -> %u", context->cid,
+		           context->reorder_ratio, reorder_ratio);
+		context->reorder_ratio = reorder_ratio;
+		context->reorder_ratio_trans_nr = 0;
 	}
+}
 
-	rohc_comp_change_state(context, next_state);
 
-	if(context->state == ROHC_COMP_STATE_SO)
+/**
+ * @brief Handle more reordering after one negative ACK
+ *
+ * The reorder ratio of the context is raised by one step, up to the ratio
+ * configured with \ref rohc_comp_set_reorder_ratio, if adaptation is enabled
+ * with \ref rohc_comp_set_adaptive_reorder.
+ *
+ * @param context  The compression context that received a NACK
+ */
+void rohc_comp_reorder_on_nack(struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp *const comp = context->compressor;
+
+	if(comp->reorder_ratio_auto &&
+	   context->reorder_ratio < comp->reorder_ratio)
 	{
-		context->go_back_ir_count++;
-		context->go_back_fo_count++;
+		c_reorder_ratio_change(context, context->reorder_ratio + 1);
 	}
-	else if(context->state == ROHC_COMP_STATE_FO)
+	context->reorder_clean_pkts_nr = 0;
+}
+
+
+/**
+ * @brief Adapt the reorder ratio of a context before one packet is sent
+ *
+ * The ratio never goes below the one that handles the reordering depth
+ * estimated by the application. In O-mode and R-mode, it is lowered by one
+ * step every \ref ROHC_COMP_OA_CLEAN_PKTS packets sent without negative ACK.
+ *
+ * @param context  The compression context
+ */
+static void c_reorder_on_send(struct rohc_comp_ctxt *const context)
+{
+	const rohc_reordering_offset_t min_ratio = c_reorder_ratio(context->compressor);
+
+	if(context->mode == ROHC_U_MODE || context->reorder_ratio < min_ratio)
 	{
-		context->go_back_ir_count++;
-		context->go_back_fo_time = pkt_time;
+		c_reorder_ratio_change(context, min_ratio);
 	}
-	else /* ROHC_COMP_STATE_IR */
+	else if(context->reorder_ratio > min_ratio)
 	{
-		context->go_back_fo_time = pkt_time;
-		context->go_back_ir_time = pkt_time;
+		context->reorder_clean_pkts_nr++;
+		if(context->reorder_clean_pkts_nr >= ROHC_COMP_OA_CLEAN_PKTS)
+		{
+			c_reorder_ratio_change(context, context->reorder_ratio - 1);
+			context->reorder_clean_pkts_nr = 0;
+		}
 	}
 }
 
@@ -4097,6 +13089,174 @@ bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Build the static chain of one IR packet
+ *
+ * The static chain of a context never changes, so it is built with the given
+ * profile-specific function for the first IR packet only, and it is copied
+ * from the context for the next IR packets. The CRC-8 over the IR header up
+ * to the end of the static chain is kept too, see \ref rohc_comp_ir_crc.
+ *
+ * @param context            The compression context
+ * @param uncomp_pkt_hdrs    The uncompressed headers to encode
+ * @param ir_hdr             The IR header being built
+ * @param ir_hdr_len         The length of the IR header before the static chain
+ * @param ir_hdr_max_len     The maximum length of the IR header
+ * @param code_static_chain  The profile-specific function that builds the
+ *                           static chain
+ * @return                   The length of the static chain if successful,
+ *                           -1 otherwise
+ */
+int rohc_comp_code_static_chain(struct rohc_comp_ctxt *const context,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                uint8_t *const ir_hdr,
+                                const size_t ir_hdr_len,
+                                const size_t ir_hdr_max_len,
+                                rohc_comp_code_static_chain_t code_static_chain)
+{
+	struct rohc_comp_static_chain *const static_chain = &(context->static_chain);
+	uint8_t *const rohc_data = ir_hdr + ir_hdr_len;
+	const size_t rohc_max_len = ir_hdr_max_len - ir_hdr_len;
+	int ret;
+
+	assert(ir_hdr_len <= ir_hdr_max_len);
+
+	if(static_chain->len > 0 &&
+	   static_chain->ir_hdr_len == (ir_hdr_len + static_chain->len))
+	{
+		/* static chain already built for a previous IR packet */
+		if(rohc_max_len < static_chain->len)
+		{
+			rohc_comp_warn(context, "ROHC buffer too small for the %u-byte static "
+			               "chain: only %zu bytes available", static_chain->len,
+			               rohc_max_len);
+			goto error;
+		}
+		memcpy(rohc_data, static_chain->data, static_chain->len);
+		rohc_comp_debug(context, "%u-byte static chain copied from context",
+		                static_chain->len);
+		ret = static_chain->len;
+	}
+	else
+	{
+		/* first IR packet of the context: build the static chain, and keep it
+		 * for the next IR packets if it is not too large */
+		ret = code_static_chain(context, uncomp_pkt_hdrs, rohc_data, rohc_max_len);
+		if(ret < 0)
+		{
+			goto error;
+		}
+		if(((size_t) ret) <= ROHC_COMP_STATIC_CHAIN_MAX_LEN &&
+		   (ir_hdr_len + ret) <= UINT8_MAX)
+		{
+			memcpy(static_chain->data, rohc_data, ret);
+			static_chain->len = ret;
+			static_chain->ir_hdr_len = ir_hdr_len + ret;
+			static_chain->ir_crc = crc_engine_calc(&context->compressor->crc_engine,
+			                                       ROHC_CRC_TYPE_8, ir_hdr,
+			                                       static_chain->ir_hdr_len,
+			                                       CRC_INIT_8);
+		}
+	}
+
+	return ret;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Compute the CRC-8 of one IR header
+ *
+ * The CRC computation starts from the CRC kept with the static chain of the
+ * context, if any, so that only the bytes after the static chain are read.
+ *
+ * @param context     The compression context
+ * @param ir_hdr      The IR header with a zero CRC field
+ * @param ir_hdr_len  The length of the IR header
+ * @return            The CRC-8 of the IR header
+ */
+uint8_t rohc_comp_ir_crc(const struct rohc_comp_ctxt *const context,
+                         const uint8_t *const ir_hdr,
+                         const size_t ir_hdr_len)
+{
+	const struct rohc_comp_static_chain *const static_chain =
+		&(context->static_chain);
+	uint8_t crc;
+
+	if(static_chain->len > 0 && ir_hdr_len >= static_chain->ir_hdr_len)
+	{
+		crc = crc_engine_calc(&context->compressor->crc_engine,
+		                      ROHC_CRC_TYPE_8, ir_hdr + static_chain->ir_hdr_len,
+		                      ir_hdr_len - static_chain->ir_hdr_len,
+		                      static_chain->ir_crc);
+	}
+	else
+	{
+		crc = crc_engine_calc(&context->compressor->crc_engine,
+		                      ROHC_CRC_TYPE_8, ir_hdr, ir_hdr_len, CRC_INIT_8);
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Restrict the CIDs that the compressor may use
+ *
+ * Used to give every compressor of one ROHC channel a disjoint part of the
+ * CID space of the channel. The CID range shall be changed before the first
+ * context is created.
+ *
+ * @param comp     The ROHC compressor
+ * @param min_cid  The smallest CID the compressor may use
+ * @param max_cid  The largest CID the compressor may use, not greater than
+ *                 the MAX_CID of the compressor
+ * @return         true if the CID range was changed, false if memory for the
+ *                 contexts could not be allocated
+ */
+static bool rohc_comp_set_cid_range(struct rohc_comp *const comp,
+                                    const rohc_cid_t min_cid,
+                                    const rohc_cid_t max_cid)
+{
+	assert(comp->num_contexts_used == 0);
+	assert(min_cid <= max_cid);
+	assert(max_cid <= comp->medium.max_cid);
+
+	c_destroy_contexts(comp);
+	comp->ctxts_min_cid = min_cid;
+	comp->ctxts_max_cid = max_cid;
+
+	return c_create_contexts(comp);
+}
+
+
+/**
+ * @brief Compute the fingerprint of the given uncompressed packet
+ *
+ * The fingerprint is the one the compressor would use to find the context
+ * of the packet, given the profiles that are enabled.
+ *
+ * @param comp              The ROHC compressor
+ * @param packet            The uncompressed packet
+ * @param[out] fingerprint  The fingerprint of the packet
+ * @return                  true if one profile may compress the packet,
+ *                          false otherwise
+ */
+bool rohc_comp_get_fingerprint(const struct rohc_comp *const comp,
+                               const struct rohc_buf *const packet,
+                               struct rohc_fingerprint *const fingerprint)
+{
+	struct rohc_pkt_hdrs pkt_hdrs;
+
+	/* the verdicts of the RTP detection callback are neither used nor updated,
+	 * the compressor might be in use by another thread */
+	return (rohc_comp_get_profile(comp, packet, fingerprint, &pkt_hdrs, NULL) !=
+	        ROHC_PROFILE_MAX);
+}
+
+
 /**
  * @brief Parse ROHC feedback CID
  *
@@ -4108,11 +13268,11 @@ bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
  * @return              true if feedback CID was successfully parsed,
  *                      false if feedback CID is malformed
  */
-static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
-                                         const uint8_t *const feedback,
-                                         const size_t feedback_len,
-                                         rohc_cid_t *const cid,
-                                         size_t *const cid_len)
+bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
+                                  const uint8_t *const feedback,
+                                  const size_t feedback_len,
+                                  rohc_cid_t *const cid,
+                                  size_t *const cid_len)
 {
 	/* decode CID */
 	if(comp->medium.cid_type == ROHC_LARGE_CID)
@@ -4166,50 +13326,117 @@ error:
 
 
 /**
- * @brief Parse FEEDBACK-2 options
+ * @brief Parse one FEEDBACK-2 in one single pass
  *
- * @param context            The ROHC decompression context
+ * The base header and the options of the feedback are parsed, the options
+ * are checked against the compression profile, and the CRC of the feedback
+ * is computed while the options are walked through. The profiles get the
+ * result in one compact structure.
+ *
+ * @param context            The ROHC compression context
  * @param packet             The whole feedback packet with CID bits
  * @param packet_len         The length of the whole feedback packet with CID bits
  * @param feedback_data      The feedback data without the CID bits
  * @param feedback_data_len  The length of the feedback data without the CID bits
- * @param[out] opts_present  Whether options are present or not
- * @param[out] sn_bits       in: the SN bits collected in base header
- *                           out: the SN bits collected in base header and options
- * @param[out] sn_bits_nr    in: the number of SN bits collected in base header
- *                           out: the number of SN bits collected in base header
- *                                and options
- * @param crc_type           Whether the CRC is present in base header or in option
- * @param crc_in_packet      The CRC of the feedback packet
- * @param crc_pos_from_end   The position of the CRC byte from the end of the
- *                           feedback packet
- * @return                   true if feedback options were successfully parsed,
- *                           false if feedback options were malformed or CRC is wrong
- */
-bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
-                                   const uint8_t *const packet,
-                                   const size_t packet_len,
-                                   const uint8_t *const feedback_data,
-                                   const size_t feedback_data_len,
-                                   size_t opts_present[ROHC_FEEDBACK_OPT_MAX],
-                                   uint32_t *const sn_bits,
-                                   size_t *const sn_bits_nr,
-                                   const rohc_feedback_crc_t crc_type,
-                                   uint8_t crc_in_packet,
-                                   size_t crc_pos_from_end)
+ * @param crc_type           ROHC_FEEDBACK_WITH_CRC_OPT for the RFC3095 format
+ *                           (CRC in option only), ROHC_FEEDBACK_WITH_CRC_BASE
+ *                           for the RFC6846 format (CRC in base header)
+ * @param[out] feedback2     The information parsed from the FEEDBACK-2
+ * @return                   true if the FEEDBACK-2 was successfully parsed,
+ *                           false if it is malformed or if its CRC is wrong
+ */
+bool rohc_comp_feedback_parse_2(const struct rohc_comp_ctxt *const context,
+                                const uint8_t *const packet,
+                                const size_t packet_len,
+                                const uint8_t *const feedback_data,
+                                const size_t feedback_data_len,
+                                const rohc_feedback_crc_t crc_type,
+                                struct rohc_comp_feedback_2 *const feedback2)
 {
 	const uint8_t *remain_data = feedback_data;
 	size_t remain_len = feedback_data_len;
+	uint8_t opts_present[ROHC_FEEDBACK_OPT_MAX] = { 0 };
+	uint16_t opts_crc_required = 0;
+	uint16_t opts_crc_suggested = 0;
+	struct rohc_comp_feedback_crc crc = {
+		.engine = &context->compressor->crc_engine,
+		.all = CRC_INIT_8,
+		.is_field_found = false
+	};
+	uint8_t crc_in_packet = 0;
+	uint8_t opt_type;
+
+	/* the feedback data is at the very end of the feedback packet */
+	assert(feedback_data >= packet);
+	assert((feedback_data + feedback_data_len) == (packet + packet_len));
+	assert(context->profile->id < ROHC_PROFILE_MAX);
+
+	feedback2->sn_not_valid = false;
+	feedback2->is_rejected = false;
+
+	/* parse the base header */
+	if(crc_type == ROHC_FEEDBACK_WITH_CRC_BASE)
+	{
+		const struct rohc_feedback_2_rfc6846 *const hdr =
+			(const struct rohc_feedback_2_rfc6846 *) remain_data;
+
+		if(remain_len < sizeof(struct rohc_feedback_2_rfc6846))
+		{
+			rohc_comp_warn(context, "malformed FEEDBACK-2: packet too short for the "
+			               "minimal %zu-byte header, only %zu bytes remaining",
+			               sizeof(struct rohc_feedback_2_rfc6846), remain_len);
+			goto error;
+		}
+		feedback2->ack_type = hdr->ack_type;
+		feedback2->mode = 0;
+		feedback2->sn_bits = (hdr->sn1 << 8) | hdr->sn2;
+		feedback2->sn_bits_nr = 6 + 8;
+
+		/* the CRC of the base header is the first CRC field of the feedback */
+		crc_in_packet = hdr->crc;
+		rohc_comp_feedback_crc_feed(&crc, packet, (&hdr->crc) - packet, false);
+		rohc_comp_feedback_crc_feed(&crc, &hdr->crc, 1, true);
+
+		remain_data += sizeof(struct rohc_feedback_2_rfc6846);
+		remain_len -= sizeof(struct rohc_feedback_2_rfc6846);
+	}
+	else
+	{
+		const struct rohc_feedback_2_rfc3095 *const hdr =
+			(const struct rohc_feedback_2_rfc3095 *) remain_data;
+
+		assert(crc_type == ROHC_FEEDBACK_WITH_CRC_OPT);
+		if(remain_len < sizeof(struct rohc_feedback_2_rfc3095))
+		{
+			rohc_comp_warn(context, "malformed FEEDBACK-2: packet too short for the "
+			               "minimal %zu-byte header, only %zu bytes remaining",
+			               sizeof(struct rohc_feedback_2_rfc3095), remain_len);
+			goto error;
+		}
+		feedback2->ack_type = hdr->ack_type;
+		feedback2->mode = hdr->mode;
+		feedback2->sn_bits = (hdr->sn1 << 8) | hdr->sn2;
+		feedback2->sn_bits_nr = 4 + 8;
+
+		remain_data += sizeof(struct rohc_feedback_2_rfc3095);
+		remain_len -= sizeof(struct rohc_feedback_2_rfc3095);
+		rohc_comp_feedback_crc_feed(&crc, packet, remain_data - packet, false);
+	}
 
-	/* parse options */
+	/* parse options, check them and compute the CRC at the same time */
 	while(remain_len > 0)
 	{
-		const uint8_t opt_type = (remain_data[0] >> 4) & 0x0f;
 		const uint8_t opt_len = (remain_data[0] & 0x0f) + 1;
-		const char *const opt_name = rohc_feedback_opt_charac[opt_type].name;
-		const size_t opt_unknown = rohc_feedback_opt_charac[opt_type].unknown;
-		const size_t opt_supported = rohc_feedback_opt_charac[opt_type].supported;
-		const size_t opt_exp_len = rohc_feedback_opt_charac[opt_type].expected_len;
+		const char *opt_name;
+		size_t opt_unknown;
+		size_t opt_supported;
+		size_t opt_exp_len;
+
+		opt_type = (remain_data[0] >> 4) & 0x0f;
+		opt_name = rohc_feedback_opt_charac[opt_type].name;
+		opt_unknown = rohc_feedback_opt_charac[opt_type].unknown;
+		opt_supported = rohc_feedback_opt_charac[opt_type].supported;
+		opt_exp_len = rohc_feedback_opt_charac[opt_type].expected_len;
 
 		rohc_comp_debug(context, "FEEDBACK-2: %s option (%u) found",
 		                opt_name, opt_type);
@@ -4228,12 +13455,14 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
 			/* unknown options must be ignored (see RFC3095, §5.7.6.10) */
 			rohc_comp_warn(context, "FEEDBACK-2: %s option (%d) is not unknown, "
 			               "ignore it", opt_name, opt_type);
+			rohc_comp_feedback_crc_feed(&crc, remain_data, opt_len, false);
 		}
 		else if(!opt_supported)
 		{
 			/* unknown options must be ignored (see RFC3095, §5.7.6.10) */
 			rohc_comp_warn(context, "FEEDBACK-2: %s option (%d) is not supported "
 			               "yet, ignore it", opt_name, opt_type);
+			rohc_comp_feedback_crc_feed(&crc, remain_data, opt_len, false);
 		}
 		else if(opt_len != opt_exp_len) /* check real length against the expected one */
 		{
@@ -4242,76 +13471,149 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
 			               opt_name, opt_type, opt_len, opt_exp_len);
 			goto error;
 		}
-		else if(opt_type == ROHC_FEEDBACK_OPT_CRC)
+		else
 		{
-			if(opts_present[opt_type] == 0)
+			const size_t max_occurs =
+				rohc_feedback_opt_charac[opt_type].max_occurs[context->profile->id];
+
+			/* is the option supported by the current compression profile? */
+			if(max_occurs == 0)
 			{
-				/* first CRC option */
-				crc_in_packet = remain_data[1];
+				if(opts_present[opt_type] == 0)
+				{
+					rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) is "
+					               "not defined for the compression profile '%s' (%d)",
+					               opt_name, opt_type,
+					               rohc_get_profile_descr(context->profile->id),
+					               context->profile->id);
+				}
+#ifdef ROHC_RFC_STRICT_DECOMPRESSOR
+				goto error;
+#endif
 			}
-			else if(crc_in_packet != remain_data[1])
+			/* some options cannot be specified multiple times */
+			else if(opts_present[opt_type] >= max_occurs)
 			{
-				/* multiple CRC options are allowed, but they must be identical
-				 * (see RFC4815, §8.6) */
-				rohc_comp_warn(context, "malformed FEEDBACK-2: duplicate CRC option "
-				               "#%zu specifies a CRC value 0x%02x instead of CRC "
-				               "0x%02x specified in the first CRC option",
-				               opts_present[opt_type], remain_data[1], crc_in_packet);
+				rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) is "
+				               "specified more than %zu times while compression "
+				               "profile '%s' (%d) allows only %zu times", opt_name,
+				               opt_type, max_occurs,
+				               rohc_get_profile_descr(context->profile->id),
+				               context->profile->id, max_occurs);
 				goto error;
 			}
-			crc_pos_from_end = remain_len - 1; /* TODO: handle multiple CRC options */
-		}
-		else if(opt_type == ROHC_FEEDBACK_OPT_SN)
-		{
-			if(!rohc_comp_feedback_parse_opt_sn(context, remain_data, remain_len,
-			                                    sn_bits, sn_bits_nr))
+
+			/* some options cannot be specified without CRC, the CRC presence is
+			 * checked once all options are parsed */
+			switch(rohc_feedback_opt_charac[opt_type].crc_req)
 			{
-				rohc_comp_warn(context, "malformed FEEDBACK-2: malformed SN option");
-				goto error;
+				case ROHC_FEEDBACK_OPT_CRC_REQUIRED:
+					opts_crc_required |= (1U << opt_type);
+					break;
+				case ROHC_FEEDBACK_OPT_CRC_SUGGESTED:
+					opts_crc_suggested |= (1U << opt_type);
+					break;
+				case ROHC_FEEDBACK_OPT_CRC_NOT_REQUIRED:
+					break;
+				default:
+					assert(0);
+					goto error;
+			}
+
+			if(opt_type == ROHC_FEEDBACK_OPT_CRC)
+			{
+				if(opts_present[opt_type] == 0)
+				{
+					/* first CRC option */
+					crc_in_packet = remain_data[1];
+				}
+				else if(crc_in_packet != remain_data[1])
+				{
+					/* multiple CRC options are allowed, but they must be identical
+					 * (see RFC4815, §8.6) */
+					rohc_comp_warn(context, "malformed FEEDBACK-2: duplicate CRC option "
+					               "#%u specifies a CRC value 0x%02x instead of CRC "
+					               "0x%02x specified in the first CRC option",
+					               opts_present[opt_type], remain_data[1], crc_in_packet);
+					goto error;
+				}
+				/* the CRC is computed with the field of the last CRC option zeroed */
+				rohc_comp_feedback_crc_feed(&crc, remain_data, 1, false);
+				rohc_comp_feedback_crc_feed(&crc, remain_data + 1, 1, true);
+			}
+			else
+			{
+				if(opt_type == ROHC_FEEDBACK_OPT_SN)
+				{
+					if(!rohc_comp_feedback_parse_opt_sn(context, remain_data, opt_len,
+					                                    feedback2))
+					{
+						rohc_comp_warn(context, "malformed FEEDBACK-2: malformed SN option");
+						goto error;
+					}
+				}
+				else if(opt_type == ROHC_FEEDBACK_OPT_SN_NOT_VALID)
+				{
+					feedback2->sn_not_valid = true;
+				}
+				else if(opt_type == ROHC_FEEDBACK_OPT_REJECT)
+				{
+					feedback2->is_rejected = true;
+				}
+				rohc_comp_feedback_crc_feed(&crc, remain_data, opt_len, false);
 			}
 		}
 
-		/* one more occurrence of the option */
-		opts_present[opt_type]++;
+		/* one more occurrence of the option, the max occurrences of the options
+		 * are far below the saturation value */
+		if(opts_present[opt_type] < UINT8_MAX)
+		{
+			opts_present[opt_type]++;
+		}
 
 		/* skip option */
 		remain_data += opt_len;
 		remain_len -= opt_len;
 	}
 
-	/* sanity checks:
-	 *  - some profiles do not support all options
-	 *  - some options cannot be specified multiple times
-	 *  - some options cannot be specified without CRC */
-	if(!rohc_comp_feedback_check_opts(context, opts_present))
+	/* some options cannot be specified without CRC */
+	if(opts_present[ROHC_FEEDBACK_OPT_CRC] == 0 &&
+	   (opts_crc_required | opts_crc_suggested) != 0)
 	{
-		rohc_comp_warn(context, "malformed FEEDBACK-2: malformed or unexpected options");
-		goto error;
+		for(opt_type = 0; opt_type < ROHC_FEEDBACK_OPT_MAX; opt_type++)
+		{
+			if((opts_crc_required & (1U << opt_type)) != 0)
+			{
+				rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) "
+				               "must be specified along with a CRC option",
+				               rohc_feedback_opt_charac[opt_type].name, opt_type);
+				goto error;
+			}
+			else if((opts_crc_suggested & (1U << opt_type)) != 0)
+			{
+				rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) "
+				               "should be specified along with a CRC option",
+				               rohc_feedback_opt_charac[opt_type].name, opt_type);
+#ifdef ROHC_RFC_STRICT_DECOMPRESSOR
+				goto error;
+#endif
+			}
+		}
 	}
 
 	/* check CRC if present in feedback */
-	if(opts_present[ROHC_FEEDBACK_OPT_CRC] > 0 ||
-	   crc_type == ROHC_FEEDBACK_WITH_CRC_BASE)
+	feedback2->is_crc_present = (opts_present[ROHC_FEEDBACK_OPT_CRC] > 0 ||
+	                             crc_type == ROHC_FEEDBACK_WITH_CRC_BASE);
+	if(feedback2->is_crc_present)
 	{
-		const size_t zeroed_crc_len = 1;
-		const uint8_t zeroed_crc = 0x00;
-		uint8_t crc_computed;
-
-		/* compute the CRC of the feedback packet (skip CRC byte) */
-		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet,
-		                             packet_len - crc_pos_from_end, CRC_INIT_8);
-		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, &zeroed_crc, zeroed_crc_len,
-		                             crc_computed);
-		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet + packet_len -
-		                             crc_pos_from_end + 1, crc_pos_from_end - 1,
-		                             crc_computed);
+		assert(crc.is_field_found);
 
 		/* ignore feedback in case of bad CRC */
-		if(crc_in_packet != crc_computed)
+		if(crc_in_packet != crc.zeroed)
 		{
 			rohc_comp_warn(context, "CRC check failed: CRC computed on %zu bytes "
 			               "(0x%02x) does not match packet CRC (0x%02x)",
-			               packet_len, crc_computed, crc_in_packet);
+			               packet_len, crc.zeroed, crc_in_packet);
 			goto error;
 		}
 	}
@@ -4323,30 +13625,64 @@ error:
 }
 
 
+/**
+ * @brief Compute the CRC of one FEEDBACK-2 with some more bytes
+ *
+ * The CRC is computed over the whole feedback packet, with the field of the
+ * last CRC found in the feedback zeroed. As the last CRC field is not known
+ * before the end of the feedback, the CRC is computed both with and without
+ * the last CRC field found so far zeroed.
+ *
+ * @param crc           The CRC being computed
+ * @param data          The bytes to compute the CRC over
+ * @param data_len      The number of bytes to compute the CRC over
+ * @param is_crc_field  Whether the bytes are one CRC field
+ */
+static void rohc_comp_feedback_crc_feed(struct rohc_comp_feedback_crc *const crc,
+                                        const uint8_t *const data,
+                                        const size_t data_len,
+                                        const bool is_crc_field)
+{
+	if(is_crc_field)
+	{
+		const uint8_t zeroed_crc = 0x00;
+
+		assert(data_len == 1);
+		crc->zeroed = crc_engine_calc(crc->engine,
+		                              ROHC_CRC_TYPE_8, &zeroed_crc, 1, crc->all);
+		crc->is_field_found = true;
+	}
+	else if(crc->is_field_found)
+	{
+		crc->zeroed = crc_engine_calc(crc->engine,
+		                              ROHC_CRC_TYPE_8, data, data_len, crc->zeroed);
+	}
+	crc->all = crc_engine_calc(crc->engine,
+	                           ROHC_CRC_TYPE_8, data, data_len, crc->all);
+}
+
+
 /**
  * @brief Parse the FEEDBACK-2 SN option
  *
- * @param context            The ROHC decompression context
- * @param feedback_data      The feedback data without the CID bits
- * @param feedback_data_len  The length of the feedback data without the CID bits
- * @param[out] sn_bits       in: the SN bits collected in base header
- *                           out: the SN bits collected in base header and options
- * @param[out] sn_bits_nr    in: the number of SN bits collected in base header
- *                           out: the number of SN bits collected in base header
- *                                and options
- * @return                   true if feedback options were successfully parsed,
- *                           false if feedback options were malformed or CRC is wrong
+ * @param context            The ROHC compression context
+ * @param opt_data           The SN option
+ * @param opt_len            The length of the SN option
+ * @param[in,out] feedback2  in: the SN bits collected so far
+ *                           out: the SN bits with the ones of the option
+ * @return                   true if the SN option was successfully parsed,
+ *                           false if the SN option is malformed
  */
 static bool rohc_comp_feedback_parse_opt_sn(const struct rohc_comp_ctxt *const context,
-                                            const uint8_t *const feedback_data,
-                                            const size_t feedback_data_len,
-                                            uint32_t *const sn_bits,
-                                            size_t *const sn_bits_nr)
+                                            const uint8_t *const opt_data,
+                                            const size_t opt_len,
+                                            struct rohc_comp_feedback_2 *const feedback2)
 {
-	const uint8_t *remain_data = feedback_data;
+	uint32_t *const sn_bits = &feedback2->sn_bits;
+	uint8_t *const sn_bits_nr = &feedback2->sn_bits_nr;
 
 	/* min length already checked in caller function */
-	assert(feedback_data_len >= 2);
+	assert(opt_len >= 2);
 
 	if(context->profile->id == ROHC_PROFILE_TCP)
 	{
@@ -4362,7 +13698,7 @@ static bool rohc_comp_feedback_parse_opt_sn(const struct rohc_comp_ctxt *const c
 			goto error;
 #endif
 		}
-		(*sn_bits) = ((*sn_bits) << 2) + ((remain_data[1] >> 6) & 0x03);
+		(*sn_bits) = ((*sn_bits) << 2) + ((opt_data[1] >> 6) & 0x03);
 		(*sn_bits_nr) += 2;
 	}
 	else if(context->profile->id == ROHC_PROFILE_ESP)
@@ -4379,7 +13715,7 @@ static bool rohc_comp_feedback_parse_opt_sn(const struct rohc_comp_ctxt *const c
 			goto error;
 #endif
 		}
-		(*sn_bits) = ((*sn_bits) << 8) + (remain_data[1] & 0xff);
+		(*sn_bits) = ((*sn_bits) << 8) + (opt_data[1] & 0xff);
 		(*sn_bits_nr) += 8;
 	}
 	else /* non-TCP and non-ESP profiles */
@@ -4396,7 +13732,7 @@ static bool rohc_comp_feedback_parse_opt_sn(const struct rohc_comp_ctxt *const c
 			goto error;
 #endif
 		}
-		(*sn_bits) = ((*sn_bits) << 8) + (remain_data[1] & 0xff);
+		(*sn_bits) = ((*sn_bits) << 8) + (opt_data[1] & 0xff);
 		(*sn_bits_nr) += 8;
 	}
 
@@ -4408,92 +13744,3 @@ error:
 #endif
 }
 
-
-/**
- * @brief Check FEEDBACK-2 options
- *
- * sanity checks:
- *  - some profiles do not support all options
- *  - some options cannot be specified multiple times
- *  - some options cannot be specified without CRC
- *
- * @param context       The ROHC decompression context
- * @param opts_present  Whether options are present or not
- * @return              true if feedback options are valid,
- *                      false if feedback options are not valid
- */
-static bool rohc_comp_feedback_check_opts(const struct rohc_comp_ctxt *const context,
-                                          const size_t opts_present[ROHC_FEEDBACK_OPT_MAX])
-{
-	uint8_t opt_type;
-	assert(context->profile->id < ROHC_PROFILE_MAX);
-
-	for(opt_type = 0; opt_type < ROHC_FEEDBACK_OPT_MAX; opt_type++)
-	{
-		if(opts_present[opt_type] > 0 &&
-		   !rohc_feedback_opt_charac[opt_type].unknown &&
-		   rohc_feedback_opt_charac[opt_type].supported)
-		{
-			const size_t max_occurs =
-				rohc_feedback_opt_charac[opt_type].max_occurs[context->profile->id];
-
-			/* is the option supported by the current compression profile? */
-			if(max_occurs == 0)
-			{
-				rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) is "
-				               "not defined for the compression profile '%s' (%d)",
-				               rohc_feedback_opt_charac[opt_type].name, opt_type,
-				               rohc_get_profile_descr(context->profile->id),
-				               context->profile->id);
-#ifdef ROHC_RFC_STRICT_DECOMPRESSOR
-				goto error;
-#endif
-			}
-			/* warn about multiple options */
-			else if(opts_present[opt_type] > max_occurs)
-			{
-				rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) is "
-				               "specified %zu times while compression profile '%s' "
-				               "(%d) allows only %zu times",
-				               rohc_feedback_opt_charac[opt_type].name, opt_type,
-				               opts_present[opt_type],
-				               rohc_get_profile_descr(context->profile->id),
-				               context->profile->id, max_occurs);
-				goto error;
-			}
-
-			/* some options cannot be specified without CRC */
-			if(opts_present[ROHC_FEEDBACK_OPT_CRC] == 0)
-			{
-				switch(rohc_feedback_opt_charac[opt_type].crc_req)
-				{
-					case ROHC_FEEDBACK_OPT_CRC_REQUIRED:
-						rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) "
-						               "must be specified along with a CRC option",
-						               rohc_feedback_opt_charac[opt_type].name, opt_type);
-						goto error;
-					case ROHC_FEEDBACK_OPT_CRC_SUGGESTED:
-						rohc_comp_warn(context, "malformed FEEDBACK-2: %s option (%u) "
-						               "should be specified along with a CRC option",
-						               rohc_feedback_opt_charac[opt_type].name, opt_type);
-#ifdef ROHC_RFC_STRICT_DECOMPRESSOR
-						goto error;
-#else
-						break;
-#endif
-					case ROHC_FEEDBACK_OPT_CRC_NOT_REQUIRED:
-						break;
-					default:
-						assert(0);
-						goto error;
-				}
-			}
-		}
-	}
-
-	return true;
-
-error:
-	return false;
-}
-
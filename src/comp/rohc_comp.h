@@ -60,6 +60,28 @@ extern "C"
  */
 
 struct rohc_comp;
+struct rohc_comp_group;
+struct rohc_comp_queue;
+
+
+/**
+ * @brief The length (in bytes) of the bitmap of RTP ports
+ *
+ * The bitmap holds one bit for every UDP port, see \ref rohc_comp_set_rtp_ports.
+ *
+ * @ingroup rohc_comp
+ */
+#define ROHC_COMP_RTP_PORTS_LEN  (65536U / 8U)
+
+
+/**
+ * @brief The number of RTP Payload Types that may be given a TS_STRIDE
+ *
+ * See \ref rohc_comp_set_rtp_ts_stride.
+ *
+ * @ingroup rohc_comp
+ */
+#define ROHC_COMP_RTP_PT_NR  128U
 
 
 /*
@@ -162,6 +184,39 @@ typedef struct
 } __attribute__((packed)) rohc_comp_last_packet_info2_t;
 
 
+/**
+ * @brief Some information about one compressed packet
+ *
+ * The structure is filled during the compression of the packet by
+ * \ref rohc_compress5 and \ref rohc_compress_burst2, so that no extra call
+ * is required to account for every packet.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress5
+ * @see rohc_compress_burst2
+ */
+struct rohc_comp_pkt_info
+{
+	/** The Context ID (CID) of the context used for the packet */
+	rohc_cid_t cid;
+	/** The profile of the context used for the packet */
+	rohc_profile_t profile_id;
+	/** The type of ROHC packet created for the packet */
+	rohc_packet_t packet_type;
+	/** The state of the context once the packet is compressed */
+	rohc_comp_state_t context_state;
+	/** The mode of the context once the packet is compressed */
+	rohc_mode_t context_mode;
+	/** Whether the context was initialized (created/re-used) by the packet */
+	bool is_context_init;
+	/** The length (in bytes) of the uncompressed headers of the packet */
+	size_t uncomp_hdr_len;
+	/** The length (in bytes) of the ROHC header of the packet */
+	size_t hdr_len;
+};
+
+
 /**
  * @brief Some general information about the compressor
  *
@@ -190,6 +245,13 @@ typedef struct
  * Supported versions:
  *  - major 0 and minor = 0 contains: version_major, version_minor,
  *    contexts_nr, packets_nr, uncomp_bytes_nr, and comp_bytes_nr.
+ *  - major 0 and minor = 1 adds: contexts_evicted_nr.
+ *  - major 0 and minor = 2 adds: contexts_expired_nr.
+ *  - major 0 and minor = 3 adds: feedbacks_foreign_nr.
+ *  - major 0 and minor = 4 adds: ir_refreshes_deferred_nr.
+ *  - major 0 and minor = 5 adds: overload_level and overload_shed_nr.
+ *  - major 0 and minor = 6 adds: refreshes_nr and refresh_bytes_nr.
+ *  - major 0 and minor = 7 adds: warmup_held_nr.
  *
  * @ingroup rohc_comp
  *
@@ -209,9 +271,221 @@ typedef struct
 	unsigned long uncomp_bytes_nr;
 	/** The number of compressed bytes produced by the compressor */
 	unsigned long comp_bytes_nr;
+	/** The number of contexts recycled to make room for new contexts
+	 *  (added by minor 1) */
+	unsigned long contexts_evicted_nr;
+	/** The number of idle contexts released by \ref rohc_comp_expire
+	 *  (added by minor 2) */
+	unsigned long contexts_expired_nr;
+	/** The number of feedback items for CIDs out of the CID range of the
+	 *  compressor, ie. for other compressors (added by minor 3) */
+	unsigned long feedbacks_foreign_nr;
+	/** The number of periodic IR refreshes deferred by the IR budget, see
+	 *  \ref rohc_comp_set_refresh_scheduler, or by the overload of the
+	 *  compressor, see \ref rohc_comp_set_overload (added by minor 4) */
+	unsigned long ir_refreshes_deferred_nr;
+	/** The current step of degradation of the compressor, see
+	 *  \ref rohc_comp_overload_t (added by minor 5) */
+	unsigned short overload_level;
+	/** The number of packets of new flows sent with the Uncompressed profile
+	 *  because the compressor was overloaded (added by minor 5) */
+	unsigned long overload_shed_nr;
+	/** The number of periodic refreshes of the contexts (added by minor 6) */
+	unsigned long refreshes_nr;
+	/** The number of bytes of the ROHC headers sent by the periodic refreshes,
+	 *  from the refresh until the context is back in SO state
+	 *  (added by minor 6) */
+	unsigned long refresh_bytes_nr;
+	/** The number of packets of new flows sent with the Uncompressed profile
+	 *  during their warm-up, see \ref rohc_comp_set_warmup
+	 *  (added by minor 7) */
+	unsigned long warmup_held_nr;
 } __attribute__((packed)) rohc_comp_general_info_t;
 
 
+/**
+ * @brief The statistics of the packets of one type compressed with one profile
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_stats_t
+ */
+struct rohc_comp_pkt_stats
+{
+	/** The number of compressed packets */
+	uint64_t packets_nr;
+	/** The cumulated length of their ROHC headers (in bytes) */
+	uint64_t hdr_bytes_nr;
+	/** The cumulated length of their uncompressed headers (in bytes) */
+	uint64_t uncomp_hdr_bytes_nr;
+};
+
+
+/**
+ * @brief The statistics of the compressor
+ *
+ * The structure is used by the \ref rohc_comp_get_stats function to store a
+ * snapshot of the 64-bit statistics of the compressor. The statistics of
+ * the compressed packets are broken down by profile and by packet type: the
+ * \e pkts table is indexed by the major and minor numbers of the profile ID,
+ * then by the \ref rohc_packet_t packet type, eg.
+ * pkts[(ROHCv1_PROFILE_IP_UDP_RTP >> 8) & 0xff][ROHCv1_PROFILE_IP_UDP_RTP & 0xff][ROHC_PACKET_UO_0].
+ * The structure is about 28 KiB large.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    packets_nr, uncomp_bytes_nr, comp_bytes_nr and pkts.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_stats
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The number of packets processed by the compressor */
+	uint64_t packets_nr;
+	/** The number of uncompressed bytes received by the compressor */
+	uint64_t uncomp_bytes_nr;
+	/** The number of compressed bytes produced by the compressor */
+	uint64_t comp_bytes_nr;
+	/** The statistics of the compressed packets per profile and packet type */
+	struct rohc_comp_pkt_stats
+		pkts[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1][ROHC_PACKET_MAX];
+} __attribute__((packed)) rohc_comp_stats_t;
+
+
+/**
+ * @brief Some information about the memory used by the compressor
+ *
+ * The structure is used by the \ref rohc_comp_get_mem_info function to store
+ * the accounting of the memory allocated by the compressor for its contexts,
+ * their W-LSB windows and lists, and its RRU buffer.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_mem_info
+ * @see rohc_comp_set_mem_budget
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The number of bytes currently allocated */
+	size_t used_bytes_nr;
+	/** The number of bytes of the slabs that the allocated bytes are carved
+	 *  from, unused if memory callbacks are set */
+	size_t slabs_bytes_nr;
+	/** The memory budget (in bytes), 0 if none */
+	size_t budget_bytes_nr;
+	/** The number of allocations refused because of the memory budget */
+	unsigned long refused_nr;
+} __attribute__((packed)) rohc_comp_mem_info_t;
+
+
+/**
+ * @brief The record of one compression context in use
+ *
+ * The records are exported in bulk by \ref rohc_comp_get_contexts_info.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_contexts_info
+ */
+struct rohc_comp_ctxt_record
+{
+	/** The Context ID (CID) of the context */
+	rohc_cid_t cid;
+	/** The profile of the context */
+	rohc_profile_t profile_id;
+	/** The state of the context */
+	rohc_comp_state_t state;
+	/** The mode of the context */
+	rohc_mode_t mode;
+	/** The number of packets compressed with the context */
+	uint64_t packets_nr;
+	/** The cumulated length of the ROHC headers produced (in bytes) */
+	uint64_t hdr_bytes_nr;
+	/** The cumulated length of the uncompressed headers received (in bytes) */
+	uint64_t uncomp_hdr_bytes_nr;
+	/** The time the context was last used (in seconds) */
+	uint64_t last_used_sec;
+	/** The number of changes of the innermost IP-ID behavior, see
+	 *  \ref rohc_comp_set_ip_id_hysteresis */
+	uint64_t ip_id_behavior_changes_nr;
+	/** The cumulated time spent to encode the ROHC headers (in nanoseconds),
+	 *  measured only if the \ref ROHC_COMP_FEATURE_PERF_INFO feature is
+	 *  enabled */
+	uint64_t processing_ns;
+};
+
+
+/**
+ * @brief The phases of compression measured by the compressor
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_perf_info_t
+ */
+typedef enum
+{
+	/** Classify the packet and find the best profile for it */
+	ROHC_COMP_PERF_CLASSIFY   = 0,
+	/** Find the context of the packet or create a new one */
+	ROHC_COMP_PERF_FIND_CTXT  = 1,
+	/** Encode the ROHC header */
+	ROHC_COMP_PERF_ENCODE     = 2,
+	/** Copy the payload behind the ROHC header or build the RRU */
+	ROHC_COMP_PERF_PAYLOAD    = 3,
+	/** The whole compression of the packet */
+	ROHC_COMP_PERF_TOTAL      = 4,
+
+} rohc_comp_perf_phase_t;
+
+/** The number of phases of compression measured by the compressor */
+#define ROHC_COMP_PERF_PHASES_NR  5U
+
+
+/**
+ * @brief The durations of the phases of compression
+ *
+ * The structure is used by the \ref rohc_comp_get_perf_info function to
+ * store the histograms of the durations of the phases of compression. The
+ * durations are measured only if the \ref ROHC_COMP_FEATURE_PERF_INFO
+ * feature is enabled. The phases of the packets that the compressor fails
+ * to compress are measured, but not their whole compression.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor and
+ *    phases.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_perf_info
+ * @see rohc_perf_histo_bucket_min
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The histograms of the durations, indexed by \ref rohc_comp_perf_phase_t */
+	struct rohc_perf_histo phases[ROHC_COMP_PERF_PHASES_NR];
+} __attribute__((packed)) rohc_comp_perf_info_t;
+
+
 /**
  * @brief The different features of the ROHC compressor
  *
@@ -235,6 +509,23 @@ typedef enum
 	ROHC_COMP_FEATURE_DUMP_PACKETS    = (1 << 3),
 	/** Allow periodic refreshes based on inter-packet time */
 	ROHC_COMP_FEATURE_TIME_BASED_REFRESHES = (1 << 4),
+	/** Measure the durations of the phases of compression, see
+	 *  \ref rohc_comp_get_perf_info (beware: performance impact) */
+	ROHC_COMP_FEATURE_PERF_INFO = (1 << 5),
+	/** Compress the RTP TS with the timer-based encoding of RFC 3095, §4.5.4,
+	 *  the decompressor shall enable \ref ROHC_DECOMP_FEATURE_TIMER_BASED_TS
+	 *  too, see \ref rohc_comp_set_ts_timer_jitter */
+	ROHC_COMP_FEATURE_TIMER_BASED_TS = (1 << 6),
+	/** Share the ROHC packets among many broadcast channels with the same
+	 *  configuration, see \ref rohc_compress_broadcast: the feedbacks are
+	 *  refused, so the contexts stay in U-mode */
+	ROHC_COMP_FEATURE_BROADCAST = (1 << 7),
+	/** Compress the IPv4 fragments with the IP-only profiles instead of the
+	 *  Uncompressed profile: every packet of the IP-only contexts then
+	 *  carries the MF flag and the fragment offset of its innermost IPv4
+	 *  header behind the ROHC header, the decompressor shall enable
+	 *  \ref ROHC_DECOMP_FEATURE_IP_FRAGMENTS too */
+	ROHC_COMP_FEATURE_IP_FRAGMENTS = (1 << 8),
 
 } rohc_comp_features_t;
 
@@ -269,6 +560,84 @@ typedef bool (*rohc_rtp_detection_callback_t)(const unsigned char *const ip,
 	__attribute__((warn_unused_result));
 
 
+/**
+ * @brief The events of the life of compression contexts
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_ctxt_event_cb
+ */
+typedef enum
+{
+	/** A new context was created */
+	ROHC_COMP_CTXT_EVENT_CREATED  = 0,
+	/** The least recently used context was recycled for a new flow */
+	ROHC_COMP_CTXT_EVENT_RECYCLED = 1,
+	/** A context was released because it was idle, its creation failed, to
+	 *  stay within the memory budget, or because the compressor was reset */
+	ROHC_COMP_CTXT_EVENT_RELEASED = 2,
+	/** The state of a context changed */
+	ROHC_COMP_CTXT_EVENT_STATE    = 3,
+	/** The mode of a context changed */
+	ROHC_COMP_CTXT_EVENT_MODE     = 4,
+
+} rohc_comp_ctxt_event_type_t;
+
+
+/**
+ * @brief One event of the life of a compression context
+ *
+ * The old and new states and modes are the same, except for the state and
+ * mode events. They are the initial state and mode of the context for the
+ * creation event.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_ctxt_event_cb
+ */
+struct rohc_comp_ctxt_event
+{
+	/** The type of the event */
+	rohc_comp_ctxt_event_type_t type;
+	/** The Context ID (CID) of the context */
+	rohc_cid_t cid;
+	/** The profile of the context */
+	rohc_profile_t profile_id;
+	/** The state of the context before the event */
+	rohc_comp_state_t old_state;
+	/** The state of the context after the event */
+	rohc_comp_state_t state;
+	/** The mode of the context before the event */
+	rohc_mode_t old_mode;
+	/** The mode of the context after the event */
+	rohc_mode_t mode;
+};
+
+
+/**
+ * @brief The prototype of the callback for the events of compression contexts
+ *
+ * User-defined function that is called by the ROHC library every time a
+ * compression context is created, recycled, released, or changes its state
+ * or mode. The function is called synchronously from the compression or
+ * feedback delivery function that caused the event, so it shall be short.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_comp_set_ctxt_event_cb
+ *
+ * @param comp       The ROHC compressor
+ * @param event      The event of the compression context
+ * @param priv_ctxt  The private context given by the user when he/she called
+ *                   the \ref rohc_comp_set_ctxt_event_cb function, may be NULL
+ *
+ * @see rohc_comp_set_ctxt_event_cb
+ * @ingroup rohc_comp
+ */
+typedef void (*rohc_comp_ctxt_event_cb_t)(const struct rohc_comp *const comp,
+                                          const struct rohc_comp_ctxt_event *const event,
+                                          void *const priv_ctxt);
+
+
 /**
  * @brief The prototype of the callback for random numbers
  *
@@ -291,6 +660,292 @@ typedef int (*rohc_comp_random_cb_t) (const struct rohc_comp *const comp,
 	__attribute__((warn_unused_result));
 
 
+/**
+ * @brief The hash functions of the tables of contexts of one compressor
+ *
+ * The keyed hash functions use a secret drawn from the random callback of
+ * the compressor, so that the flows cannot be chosen to collide in the
+ * tables of contexts and slow down the lookups.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_hash
+ */
+typedef enum
+{
+	/** SipHash-2-4 keyed with a random secret, the default */
+	ROHC_COMP_HASH_SIPHASH24 = 0,
+	/** SipHash-1-3 keyed with a random secret, faster than SipHash-2-4 */
+	ROHC_COMP_HASH_SIPHASH13 = 1,
+	/** A hash made of AES rounds keyed with a random secret, the fastest
+	 *  keyed hash, only if the CPU has AES instructions (AES-NI on x86,
+	 *  ARMv8 Cryptographic Extension) */
+	ROHC_COMP_HASH_AES       = 2,
+	/** A hash without any secret, for trusted traffic only */
+	ROHC_COMP_HASH_UNKEYED   = 3,
+	/** The hash function given by the application */
+	ROHC_COMP_HASH_CUSTOM    = 4,
+
+} rohc_comp_hash_t;
+
+
+/**
+ * @brief The prototype of the callback for hashing the flows
+ *
+ * User-defined function that hashes the fingerprint of one flow for the
+ * tables of contexts of one compressor.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_comp_set_hash
+ *
+ * @param data       The fingerprint of the flow to hash
+ * @param len        The length of the fingerprint of the flow
+ * @param key        The random secret of the table of contexts
+ * @param priv_ctxt  The private context given by the user when he/she
+ *                   called the \ref rohc_comp_set_hash function, may be NULL
+ * @return           The 64-bit hash of the flow
+ *
+ * @see rohc_comp_set_hash
+ * @ingroup rohc_comp
+ */
+typedef uint64_t (*rohc_comp_hash_cb_t)(const uint8_t *const data,
+                                        const size_t len,
+                                        const uint8_t key[16],
+                                        void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The policies that choose the context to recycle
+ *
+ * One context in use is recycled when one new flow needs a context and no
+ * CID is left, or when the memory budget is exhausted. All the policies but
+ * \ref ROHC_COMP_EVICT_LRU choose among the few least recently used
+ * contexts, so that the choice stays cheap whatever the number of contexts.
+ * All the policies recycle the least recently used context if it is idle,
+ * see \ref rohc_comp_set_ctxt_idle_timeout.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_evict_policy
+ */
+typedef enum
+{
+	/** The least recently used context, the default */
+	ROHC_COMP_EVICT_LRU              = 0,
+	/** The context that compressed the fewest packets */
+	ROHC_COMP_EVICT_LFU              = 1,
+	/** The context that saved the fewest bytes of headers */
+	ROHC_COMP_EVICT_SIZE_WEIGHTED    = 2,
+	/** The context of the profile that saves the fewest bytes per packet,
+	 *  so that RTP flows are not recycled for UDP flows for example */
+	ROHC_COMP_EVICT_PROFILE_PRIORITY = 3,
+	/** The context chosen by the callback given by the application */
+	ROHC_COMP_EVICT_CUSTOM           = 4,
+
+} rohc_comp_evict_t;
+
+
+/**
+ * @brief The prototype of the callback for choosing the context to recycle
+ *
+ * User-defined function that chooses the context to recycle among the least
+ * recently used contexts of one compressor. The candidates are given from
+ * the least recently used one. The function shall not use the compressor:
+ * it may be called by \ref rohc_compress_dryrun too.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_comp_set_evict_policy
+ *
+ * @param candidates     The records of the candidate contexts
+ * @param candidates_nr  The number of candidate contexts, at least 1
+ * @param profile_id     The profile of the new context
+ * @param priv_ctxt      The private context given by the user when he/she
+ *                       called the \ref rohc_comp_set_evict_policy function,
+ *                       may be NULL
+ * @return               The index of the candidate to recycle, the least
+ *                       recently used candidate is recycled if the index is
+ *                       out of range
+ *
+ * @see rohc_comp_set_evict_policy
+ * @ingroup rohc_comp
+ */
+typedef size_t (*rohc_comp_evict_cb_t)(const struct rohc_comp_ctxt_record candidates[],
+                                       const size_t candidates_nr,
+                                       const rohc_profile_t profile_id,
+                                       void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The steps of degradation of one overloaded compressor
+ *
+ * Every step keeps the degradations of the previous steps. The contexts
+ * that already exist keep compressing their flows whatever the step, so
+ * that the bytes saved by compression decrease smoothly with the load.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_overload
+ * @see rohc_comp_set_overload_latency
+ */
+typedef enum
+{
+	/** The compressor is not overloaded, nothing is degraded */
+	ROHC_COMP_OVERLOAD_NONE     = 0,
+	/** The periodic IR refreshes are deferred up to twice their timeouts */
+	ROHC_COMP_OVERLOAD_DEFER    = 1,
+	/** One new context is created every 64 packets at most, the other new
+	 *  flows are sent with the Uncompressed profile meanwhile */
+	ROHC_COMP_OVERLOAD_THROTTLE = 2,
+	/** No new context is created, all the new flows are sent with the
+	 *  Uncompressed profile */
+	ROHC_COMP_OVERLOAD_SHED     = 3,
+
+} rohc_comp_overload_t;
+
+
+/** The maximal number of fragments of data in one ROHC segment: the segment
+ *  type, the ROHC header, the payload and the CRC of the RRU */
+#define ROHC_COMP_SEG_IOV_MAX  4U
+
+
+/**
+ * @brief One fragment of data of one ROHC segment
+ *
+ * The ROHC segments returned by \ref rohc_comp_get_segment_iov are made of
+ * several fragments of data that are not copied: the segment type byte, some
+ * bytes of the ROHC header, some bytes of the payload of the uncompressed
+ * packet, and some bytes of the CRC of the Reconstructed Reception Unit (RRU).
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_segment_iov
+ */
+struct rohc_comp_seg_iov
+{
+	/** The first byte of the fragment */
+	const uint8_t *data;
+	/** The length of the fragment (in bytes) */
+	size_t len;
+};
+
+
+/** The maximal number of IP headers described by \ref rohc_comp_hdrs_info */
+#define ROHC_COMP_HDRS_INFO_IP_MAX  2U
+
+
+/**
+ * @brief The headers of one uncompressed packet, as already parsed by the user
+ *
+ * The structure is given to \ref rohc_compress_hdrs_info by applications
+ * that already parsed the headers of the packet, eg. a network stack or a
+ * packet classifier. It describes where the IP headers and the transport
+ * header are located in the packet, so that the compressor does not
+ * classify the packet again. The offsets are counted in bytes from the
+ * beginning of the packet, the IPv6 extension headers of one IP header are
+ * part of it.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_hdrs_info
+ */
+struct rohc_comp_hdrs_info
+{
+	/** The number of IP headers, at least 1 */
+	uint8_t ip_hdrs_nr;
+	/** The versions of the IP headers, 4 or 6 */
+	uint8_t ip_versions[ROHC_COMP_HDRS_INFO_IP_MAX];
+	/** The offsets of the IP headers, the first one shall be 0 */
+	uint16_t ip_offsets[ROHC_COMP_HDRS_INFO_IP_MAX];
+	/** The protocol of the transport header, ie. the next header of the
+	 *  innermost IP header once its IPv6 extension headers are skipped */
+	uint8_t l4_proto;
+	/** The offset of the transport header */
+	uint16_t l4_offset;
+	/** Whether the UDP payload starts with a RTP header, the RTP detection
+	 *  of the compressor being skipped */
+	bool is_rtp;
+	/** Whether \e rss_hash is given */
+	bool has_rss_hash;
+	/** The hash of the flow computed by the NIC, eg. the Toeplitz RSS hash,
+	 *  used to find the compression context of the flow without hashing
+	 *  the headers again */
+	uint32_t rss_hash;
+};
+
+
+/**
+ * @brief The filter of the compression contexts to invalidate
+ *
+ * The filter selects the contexts with one IP header, outer or inner, whose
+ * source or destination address belongs to the given prefix. The contexts
+ * may be further restricted to one transport port and/or one profile.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_invalidate_contexts
+ */
+struct rohc_comp_ctxt_filter
+{
+	/** The version of the IP address, 4 or 6 */
+	uint8_t ip_version;
+	/** The length of the prefix (in bits), 32 or 128 for one single IPv4 or
+	 *  IPv6 address, 0 for all the addresses of the IP version */
+	uint8_t prefix_len;
+	/** The address or the prefix, in network byte order, only the 4 first
+	 *  bytes being used for IPv4 */
+	uint8_t addr[16];
+	/** Whether \e port is given */
+	bool has_port;
+	/** The source or destination port of the transport header (in host
+	 *  byte order), the contexts of the profiles without port never match */
+	uint16_t port;
+	/** Whether \e profile_id is given */
+	bool has_profile;
+	/** The profile of the contexts */
+	rohc_profile_t profile_id;
+};
+
+
+/**
+ * @brief One submission to a queue of ROHC compression
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_submit
+ */
+struct rohc_comp_sqe
+{
+	/** The uncompressed packet to compress */
+	struct rohc_buf uncomp_pkt;
+	/** The empty buffer to store the ROHC packet in, as for
+	 *  \ref rohc_compress4 */
+	struct rohc_buf rohc_pkt;
+	/** The tag of the caller, given back by the completion */
+	uint64_t tag;
+};
+
+
+/**
+ * @brief One completion of a queue of ROHC compression
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_reap
+ */
+struct rohc_comp_cqe
+{
+	/** The status of the compression, see \ref rohc_compress4 */
+	rohc_status_t status;
+	/** The length of the ROHC packet, stored in the buffer that was submitted
+	 *  from its offset */
+	size_t len;
+	/** The tag that was submitted with the packet */
+	uint64_t tag;
+};
+
+
 /*
  * Prototypes of main public functions related to ROHC compression
  */
@@ -301,6 +956,15 @@ struct rohc_comp * ROHC_EXPORT rohc_comp_new2(const rohc_cid_type_t cid_type,
                                               void *const rand_priv)
 	__attribute__((warn_unused_result));
 
+struct rohc_comp * ROHC_EXPORT
+	rohc_comp_new_cid_range(const rohc_cid_type_t cid_type,
+	                        const rohc_cid_t max_cid,
+	                        const rohc_cid_t cid_min,
+	                        const rohc_cid_t cid_max,
+	                        const rohc_comp_random_cb_t rand_cb,
+	                        void *const rand_priv)
+	__attribute__((warn_unused_result));
+
 void ROHC_EXPORT rohc_comp_free(struct rohc_comp *const comp);
 
 bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
@@ -308,11 +972,102 @@ bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
                                           void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_trace_level(struct rohc_comp *const comp,
+                                           const rohc_trace_level_t level)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_compress4(struct rohc_comp *const comp,
                                          const struct rohc_buf uncomp_packet,
                                          struct rohc_buf *const rohc_packet)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_compress5(struct rohc_comp *const comp,
+                                         const struct rohc_buf uncomp_packet,
+                                         struct rohc_buf *const rohc_packet,
+                                         struct rohc_comp_pkt_info *const info)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_with_feedbacks(struct rohc_comp *const comp,
+                                                       const struct rohc_buf uncomp_packet,
+                                                       struct rohc_buf *const rohc_packet,
+                                                       struct rohc_buf *const feedbacks)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_hdr(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_hdr,
+                                            struct rohc_buf *const payload)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_in_place(struct rohc_comp *const comp,
+                                                 struct rohc_buf *const pkt)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_dryrun(struct rohc_comp *const comp,
+                                               const struct rohc_buf uncomp_packet,
+                                               size_t *const rohc_hdr_len,
+                                               size_t *const rohc_pkt_len,
+                                               rohc_packet_t *const packet_type)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_constrained(struct rohc_comp *const comp,
+                                                    const struct rohc_buf uncomp_packet,
+                                                    struct rohc_buf *const rohc_packet,
+                                                    const size_t max_len)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_iov(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_hdr,
+                                            struct rohc_buf *const payload)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_chain(struct rohc_comp *const comp,
+                                              const struct rohc_buf_chain uncomp_chain,
+                                              struct rohc_buf *const rohc_hdr,
+                                              struct rohc_buf_chain *const payload)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_hdrs_info(struct rohc_comp *const comp,
+                                                  const struct rohc_buf uncomp_packet,
+                                                  const struct rohc_comp_hdrs_info *const hdrs_info,
+                                                  struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_compress_burst(struct rohc_comp *const comp,
+                                       const struct rohc_buf *const uncomp_pkts,
+                                       struct rohc_buf *const rohc_pkts,
+                                       rohc_status_t *const statuses,
+                                       const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_compress_burst2(struct rohc_comp *const comp,
+                                        const struct rohc_buf *const uncomp_pkts,
+                                        struct rohc_buf *const rohc_pkts,
+                                        rohc_status_t *const statuses,
+                                        struct rohc_comp_pkt_info *const infos,
+                                        const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_prefetch(struct rohc_comp *const comp,
+                                    const struct rohc_buf uncomp_packet);
+
+rohc_status_t ROHC_EXPORT rohc_compress_gso(struct rohc_comp *const comp,
+                                            const struct rohc_buf super_pkt,
+                                            const size_t gso_size,
+                                            struct rohc_buf *const rohc_pkts,
+                                            const size_t rohc_pkts_max,
+                                            size_t *const rohc_pkts_nr)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_broadcast(struct rohc_comp *const comp,
+                                                  const struct rohc_buf uncomp_packet,
+                                                  const rohc_cid_t *const cid_maps,
+                                                  struct rohc_buf *const rohc_pkts,
+                                                  const size_t channels_nr,
+                                                  struct rohc_comp_pkt_info *const info)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_comp_pad(struct rohc_comp *const comp,
                                         struct rohc_buf *const rohc_packet,
                                         const size_t min_pkt_len)
@@ -322,9 +1077,32 @@ rohc_status_t ROHC_EXPORT rohc_comp_get_segment2(struct rohc_comp *const comp,
                                                  struct rohc_buf *const segment)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_comp_get_segment_iov(struct rohc_comp *const comp,
+                                                    const size_t max_len,
+                                                    struct rohc_comp_seg_iov iov[ROHC_COMP_SEG_IOV_MAX],
+                                                    size_t *const iov_nr)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_invalidate_contexts(struct rohc_comp *const comp,
+                                               const struct rohc_comp_ctxt_filter *const filter,
+                                               size_t *const ctxts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_reset(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_expire(struct rohc_comp *const comp,
+                                  const struct rohc_ts now)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_flow_hash(const struct rohc_comp *const comp,
+                                     const struct rohc_buf uncomp_packet,
+                                     uint64_t *const hash)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions related to user interaction
@@ -359,6 +1137,11 @@ bool ROHC_EXPORT rohc_comp_get_max_cid(const struct rohc_comp *const comp,
                                        size_t *const max_cid)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_cid_range(const struct rohc_comp *const comp,
+                                         rohc_cid_t *const cid_min,
+                                         rohc_cid_t *const cid_max)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_get_cid_type(const struct rohc_comp *const comp,
                                         rohc_cid_type_t *const cid_type)
 	__attribute__((warn_unused_result));
@@ -368,6 +1151,76 @@ bool ROHC_EXPORT rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
                                                 void *const rtp_private)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_ctxt_event_cb(struct rohc_comp *const comp,
+                                             rohc_comp_ctxt_event_cb_t callback,
+                                             void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_hash(struct rohc_comp *const comp,
+                                    const rohc_comp_hash_t hash,
+                                    rohc_comp_hash_cb_t callback,
+                                    void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_evict_policy(struct rohc_comp *const comp,
+                                            const rohc_comp_evict_t policy,
+                                            rohc_comp_evict_cb_t callback,
+                                            void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_crc_engine(struct rohc_comp *const comp,
+                                          const struct rohc_crc_engine *const engine)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_rtp_detection_interval(struct rohc_comp *const comp,
+                                                      const size_t packets_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_uncomp_flows_ttl(struct rohc_comp *const comp,
+                                                const uint64_t ttl)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_bulk_policy(struct rohc_comp *const comp,
+                                           const unsigned int min_savings,
+                                           const unsigned int resume_savings,
+                                           const uint64_t ttl)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_overload(struct rohc_comp *const comp,
+                                        const rohc_comp_overload_t level)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_overload_latency(struct rohc_comp *const comp,
+                                                const uint64_t step_ns)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_warmup(struct rohc_comp *const comp,
+                                      const size_t pkts_nr,
+                                      const uint64_t window_ms)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_rtp_ports(struct rohc_comp *const comp,
+                                         const uint8_t *const ports)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_rtp_ts_stride(struct rohc_comp *const comp,
+                                             const uint8_t pt,
+                                             const uint32_t ts_stride)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_ts_timer_jitter(struct rohc_comp *const comp,
+                                               const uint32_t max_jitter)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_mem_cbs(struct rohc_comp *const comp,
+                                       rohc_mem_alloc_cb_t alloc_cb,
+                                       rohc_mem_free_cb_t free_cb,
+                                       void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_preallocate(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_features(struct rohc_comp *const comp,
                                         const rohc_comp_features_t features)
 	__attribute__((warn_unused_result));
@@ -376,6 +1229,22 @@ bool ROHC_EXPORT rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
                                              const struct rohc_buf feedback)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_deliver_feedback_burst(struct rohc_comp *const comp,
+                                                  const struct rohc_buf feedbacks)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_channel_set(struct rohc_comp *const comp,
+                                           struct rohc_channel_set *const set)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_feedback_ring(struct rohc_comp *const comp,
+                                             struct rohc_feedback_ring *const ring)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_drain_feedback_ring(struct rohc_comp *const comp,
+                                               struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions that configure robustness to packet
@@ -386,6 +1255,14 @@ bool ROHC_EXPORT rohc_comp_set_optimistic_approach(struct rohc_comp *const comp,
                                                    const size_t repetitions_nr)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_adaptive_oa(struct rohc_comp *const comp,
+                                           const size_t min_repetitions_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_loss_estimate(struct rohc_comp *const comp,
+                                             const unsigned int loss_permille)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
                                                  const size_t width)
 	__attribute__((warn_unused_result))
@@ -395,6 +1272,14 @@ bool ROHC_EXPORT rohc_comp_set_reorder_ratio(struct rohc_comp *const comp,
                                              const rohc_reordering_offset_t reorder_ratio)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_adaptive_reorder(struct rohc_comp *const comp,
+                                                const bool enabled)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_reorder_estimate(struct rohc_comp *const comp,
+                                                const unsigned int depth)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
                                                   const size_t ir_timeout,
                                                   const size_t fo_timeout)
@@ -405,6 +1290,29 @@ bool ROHC_EXPORT rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const c
                                                        const uint64_t fo_timeout)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_adaptive_refreshes(struct rohc_comp *const comp,
+                                                  const unsigned int min_pct,
+                                                  const unsigned int max_pct)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_ctxt_idle_timeout(struct rohc_comp *const comp,
+                                                 const uint64_t timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_refresh_scheduler(struct rohc_comp *const comp,
+                                                 const unsigned int jitter,
+                                                 const size_t ir_budget,
+                                                 const uint64_t budget_interval)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_ip_id_hysteresis(struct rohc_comp *const comp,
+                                                const size_t observations_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_mem_budget(struct rohc_comp *const comp,
+                                          const size_t budget)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
                                              const size_t list_trans_nr)
 	__attribute__((warn_unused_result))
@@ -419,6 +1327,55 @@ bool ROHC_EXPORT rohc_comp_get_general_info(const struct rohc_comp *const comp,
                                             rohc_comp_general_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_stats(const struct rohc_comp *const comp,
+                                     rohc_comp_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_mem_info(const struct rohc_comp *const comp,
+                                        rohc_comp_mem_info_t *const info)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_comp_get_contexts_info(const struct rohc_comp *const comp,
+                                               struct rohc_comp_ctxt_record *const records,
+                                               const size_t records_max)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_save_contexts(const struct rohc_comp *const comp,
+                                         uint8_t *const image,
+                                         const size_t image_max_len,
+                                         size_t *const image_len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_restore_contexts(struct rohc_comp *const comp,
+                                            const uint8_t *const image,
+                                            const size_t image_len,
+                                            const struct rohc_ts now,
+                                            size_t *const ctxts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_export_context(struct rohc_comp *const comp,
+                                          const rohc_cid_t cid,
+                                          const bool do_release,
+                                          uint8_t *const image,
+                                          const size_t image_max_len,
+                                          size_t *const image_len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_import_context(struct rohc_comp *const comp,
+                                          const uint8_t *const image,
+                                          const size_t image_len,
+                                          const struct rohc_ts now)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_prewarm_context(struct rohc_comp *const comp,
+                                           const struct rohc_buf template_pkt,
+                                           const rohc_cid_t cid)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_perf_info(const struct rohc_comp *const comp,
+                                         rohc_comp_perf_info_t *const info)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
                                                  rohc_comp_last_packet_info2_t *const info)
 	__attribute__((warn_unused_result));
@@ -427,6 +1384,68 @@ const char * ROHC_EXPORT rohc_comp_get_state_descr(const rohc_comp_state_t state
 	__attribute__((warn_unused_result, const));
 
 
+/*
+ * Prototypes of public functions related to groups of ROHC compressors
+ */
+
+struct rohc_comp_group * ROHC_EXPORT
+	rohc_comp_group_new(const rohc_cid_type_t cid_type,
+	                    const rohc_cid_t max_cid,
+	                    const size_t shards_nr,
+	                    const rohc_comp_random_cb_t rand_cb,
+	                    void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_group_free(struct rohc_comp_group *const group);
+
+size_t ROHC_EXPORT rohc_comp_group_get_shards_nr(const struct rohc_comp_group *const group)
+	__attribute__((warn_unused_result));
+
+struct rohc_comp * ROHC_EXPORT
+	rohc_comp_group_get_shard(const struct rohc_comp_group *const group,
+	                          const size_t shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_group_steer(const struct rohc_comp_group *const group,
+                                       const struct rohc_buf uncomp_packet,
+                                       size_t *const shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_group_route_feedback(const struct rohc_comp_group *const group,
+                                                struct rohc_buf *const feedback,
+                                                struct rohc_buf *const feedback_item,
+                                                size_t *const shard_idx)
+	__attribute__((warn_unused_result));
+
+
+/*
+ * Prototypes of public functions related to queues of ROHC compression
+ */
+
+struct rohc_comp_queue * ROHC_EXPORT
+	rohc_comp_queue_new(struct rohc_comp *const comp,
+	                    const size_t slots_nr)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_queue_free(struct rohc_comp_queue *const queue);
+
+bool ROHC_EXPORT rohc_comp_queue_submit(struct rohc_comp_queue *const queue,
+                                        const struct rohc_comp_sqe *const sqe)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_comp_queue_submit_burst(struct rohc_comp_queue *const queue,
+                                                const struct rohc_comp_sqe *const sqes,
+                                                const size_t sqes_nr)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_comp_queue_run(struct rohc_comp_queue *const queue);
+
+size_t ROHC_EXPORT rohc_comp_queue_reap(struct rohc_comp_queue *const queue,
+                                        struct rohc_comp_cqe *const cqes,
+                                        const size_t max_nr)
+	__attribute__((warn_unused_result));
+
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
@@ -0,0 +1,347 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_comp_group.c
+ * @brief  Groups of ROHC compressors that share the CID space of one channel
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_comp.h"
+#include "rohc_comp_internals.h"
+#include "feedback_parse.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+
+/**
+ * @brief A group of ROHC compressors for one ROHC channel
+ *
+ * Every compressor of the group, called a shard, owns a disjoint range of
+ * the CIDs of the channel. Every shard may thus be used by a different thread
+ * without any locking, the flows being steered to the shards by the hash of
+ * their fingerprint.
+ */
+struct rohc_comp_group
+{
+	/** The number of shards in the group */
+	size_t shards_nr;
+	/** The shards of the group */
+	struct rohc_comp **shards;
+	/** The CIDs that every shard may use start from the CID stored for the
+	 *  shard, ordered the same way as the shards */
+	rohc_cid_t *shards_min_cid;
+};
+
+
+/**
+ * @brief Create a new group of ROHC compressors
+ *
+ * Create as many ROHC compressors as requested that share the given CID space
+ * of one ROHC channel: every compressor, or shard, gets its own contiguous
+ * part of the CIDs in range [0, \e max_cid]. The shards shall then be
+ * configured as usual, all of them the same way, with the functions that are
+ * available for one compressor. Retrieve them with
+ * \ref rohc_comp_group_get_shard.
+ *
+ * Every shard is a full compressor with its own contexts, so that every shard
+ * may be used by its own thread without locking. The packets of a flow shall
+ * always be compressed by the same shard: use \ref rohc_comp_group_steer to
+ * find out which one.
+ *
+ * The user-defined callback for random numbers may be called by all the
+ * shards, it shall thus be thread-safe.
+ *
+ * @param cid_type   The type of Context IDs (CID) of the ROHC channel
+ * @param max_cid    The maximum value of CIDs on the ROHC channel, see
+ *                   \ref rohc_comp_new2 for accepted values
+ * @param shards_nr  The number of compressors in the group, in range
+ *                   [1, \e max_cid + 1]
+ * @param rand_cb    The random callback to set
+ * @param rand_priv  Private data that will be given to the callback, may be
+ *                   used as a context by user
+ * @return           The created group of compressors if successful,
+ *                   NULL if creation failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_group_free
+ * @see rohc_comp_group_get_shard
+ */
+struct rohc_comp_group * rohc_comp_group_new(const rohc_cid_type_t cid_type,
+                                             const rohc_cid_t max_cid,
+                                             const size_t shards_nr,
+                                             const rohc_comp_random_cb_t rand_cb,
+                                             void *const rand_priv)
+{
+	const size_t cids_nr = max_cid + 1;
+	struct rohc_comp_group *group;
+	size_t i;
+
+	if(shards_nr == 0 || shards_nr > cids_nr)
+	{
+		goto error;
+	}
+
+	group = calloc(1, sizeof(struct rohc_comp_group));
+	if(group == NULL)
+	{
+		goto error;
+	}
+	group->shards = calloc(shards_nr, sizeof(struct rohc_comp *));
+	if(group->shards == NULL)
+	{
+		goto free_group;
+	}
+	group->shards_min_cid = calloc(shards_nr, sizeof(rohc_cid_t));
+	if(group->shards_min_cid == NULL)
+	{
+		goto free_group;
+	}
+
+	/* split the CID space in ranges of almost equal lengths */
+	for(i = 0; i < shards_nr; i++)
+	{
+		const rohc_cid_t min_cid = (i * cids_nr) / shards_nr;
+		const rohc_cid_t shard_max_cid = ((i + 1) * cids_nr) / shards_nr - 1;
+
+		group->shards[i] = rohc_comp_new_cid_range(cid_type, max_cid, min_cid,
+		                                           shard_max_cid, rand_cb, rand_priv);
+		if(group->shards[i] == NULL)
+		{
+			goto free_group;
+		}
+		group->shards_nr++;
+		group->shards_min_cid[i] = min_cid;
+	}
+
+	return group;
+
+free_group:
+	rohc_comp_group_free(group);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given group of ROHC compressors
+ *
+ * Destroy all the compressors of the group too.
+ *
+ * @param group  The group of ROHC compressors to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_group_new
+ */
+void rohc_comp_group_free(struct rohc_comp_group *const group)
+{
+	if(group != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < group->shards_nr; i++)
+		{
+			rohc_comp_free(group->shards[i]);
+		}
+		free(group->shards_min_cid);
+		free(group->shards);
+		free(group);
+	}
+}
+
+
+/**
+ * @brief Get the number of compressors in the given group
+ *
+ * @param group  The group of ROHC compressors
+ * @return       The number of compressors in the group, 0 if the group is
+ *               not valid
+ *
+ * @ingroup rohc_comp
+ */
+size_t rohc_comp_group_get_shards_nr(const struct rohc_comp_group *const group)
+{
+	if(group == NULL)
+	{
+		return 0;
+	}
+
+	return group->shards_nr;
+}
+
+
+/**
+ * @brief Get one compressor of the given group
+ *
+ * The compressor belongs to the group: it shall not be destroyed with
+ * \ref rohc_comp_free.
+ *
+ * @param group      The group of ROHC compressors
+ * @param shard_idx  The index of the compressor in the group
+ * @return           The compressor, NULL if the group or the index is not
+ *                   valid
+ *
+ * @ingroup rohc_comp
+ */
+struct rohc_comp * rohc_comp_group_get_shard(const struct rohc_comp_group *const group,
+                                             const size_t shard_idx)
+{
+	if(group == NULL || shard_idx >= group->shards_nr)
+	{
+		return NULL;
+	}
+
+	return group->shards[shard_idx];
+}
+
+
+/**
+ * @brief Find out which compressor of the group shall compress a packet
+ *
+ * All the packets of one flow are steered to the same compressor, so that
+ * the context of the flow is owned by one compressor only. The packet is
+ * classified with the configuration of the first compressor of the group:
+ * all compressors shall be configured the same way. The index is the flow
+ * hash of the packet computed by \ref rohc_comp_flow_hash on the first
+ * compressor, modulo the number of compressors in the group.
+ *
+ * The function does not modify any compressor, it may thus be called by
+ * the thread that distributes packets while the compressors are in use by
+ * other threads, as long as their configuration is not changed.
+ *
+ * @param group           The group of ROHC compressors
+ * @param uncomp_packet   The uncompressed packet to steer
+ * @param[out] shard_idx  The index of the compressor that shall compress
+ *                        the packet
+ * @return                true if the packet was steered,
+ *                        false if no enabled profile may compress it
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_group_steer(const struct rohc_comp_group *const group,
+                           const struct rohc_buf uncomp_packet,
+                           size_t *const shard_idx)
+{
+	uint64_t hash;
+
+	if(group == NULL || shard_idx == NULL)
+	{
+		goto error;
+	}
+
+	if(!rohc_comp_flow_hash(group->shards[0], uncomp_packet, &hash))
+	{
+		goto error;
+	}
+	*shard_idx = hash % group->shards_nr;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Find out which compressor of the group owns a feedback item
+ *
+ * Take the first feedback item out of the given feedback data, and find out
+ * the compressor that owns the context the feedback item is about, ie. the
+ * compressor that shall receive the feedback item with
+ * \ref rohc_comp_deliver_feedback2. Call the function again as long as some
+ * feedback data remains.
+ *
+ * @param group               The group of ROHC compressors
+ * @param[in,out] feedback    The feedback data, the first feedback item is
+ *                            removed from it on success
+ * @param[out] feedback_item  The first feedback item, it points to the same
+ *                            memory as the feedback data
+ * @param[out] shard_idx      The index of the compressor that owns the
+ *                            feedback item
+ * @return                    true if the feedback item is routed,
+ *                            false if the feedback data is malformed
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_group_route_feedback(const struct rohc_comp_group *const group,
+                                    struct rohc_buf *const feedback,
+                                    struct rohc_buf *const feedback_item,
+                                    size_t *const shard_idx)
+{
+	size_t feedback_hdr_len;
+	size_t feedback_data_len;
+	size_t feedback_len;
+	rohc_cid_t cid;
+	size_t cid_len;
+	size_t i;
+
+	if(group == NULL || feedback == NULL || feedback_item == NULL ||
+	   shard_idx == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*feedback) || rohc_buf_is_empty(*feedback))
+	{
+		goto error;
+	}
+
+	/* parse the first feedback item */
+	if(!rohc_packet_is_feedback(rohc_buf_byte(*feedback)))
+	{
+		goto error;
+	}
+	if(!rohc_feedback_get_size(*feedback, &feedback_hdr_len, &feedback_data_len))
+	{
+		goto error;
+	}
+	feedback_len = feedback_hdr_len + feedback_data_len;
+	if(feedback_len > feedback->len)
+	{
+		goto error;
+	}
+	if(!rohc_comp_feedback_parse_cid(group->shards[0],
+	                                 rohc_buf_data(*feedback) + feedback_hdr_len,
+	                                 feedback_data_len, &cid, &cid_len))
+	{
+		goto error;
+	}
+	if(cid > group->shards[0]->medium.max_cid)
+	{
+		goto error;
+	}
+
+	/* the shard owns all the CIDs up to the first CID of the next shard */
+	i = 0;
+	while((i + 1) < group->shards_nr && cid >= group->shards_min_cid[i + 1])
+	{
+		i++;
+	}
+	*shard_idx = i;
+
+	*feedback_item = *feedback;
+	feedback_item->len = feedback_len;
+	rohc_buf_pull(feedback, feedback_len);
+
+	return true;
+
+error:
+	return false;
+}
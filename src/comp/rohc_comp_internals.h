@@ -35,7 +35,11 @@
 #include "schemes/comp_wlsb.h"
 #include "protocols/uncomp_pkt_hdrs.h"
 #include "feedback.h"
+#include "crc.h"
 #include "hashtable.h"
+#include "rohc_mempool.h"
+#include "rohc_perf.h"
+#include "rohc_stats_seq.h"
 
 #include <stdbool.h>
 
@@ -63,6 +67,109 @@
  *  before changing back the state to FO (periodic refreshes) */
 #define CHANGE_TO_FO_TIME  500U
 
+/** The number of packets sent without negative ACK after which the adaptive
+ *  number of repetitions of the Optimistic Approach of one context decreases */
+#define ROHC_COMP_OA_CLEAN_PKTS  256U
+
+/** The bytes of the output buffer left for the ROHC header to grow beyond
+ *  the uncompressed headers when feedbacks are piggybacked in front of the
+ *  ROHC header in the same pass */
+#define ROHC_COMP_FEEDBACK_SLACK  64U
+
+/** The maximum length of the headers of the super-packets given to
+ *  \ref rohc_compress_gso */
+#define ROHC_COMP_GSO_HDRS_MAX_LEN  256U
+
+/** The maximum length of the IP headers of the IPv4 fragments compressed
+ *  with \ref ROHC_COMP_FEATURE_IP_FRAGMENTS */
+#define ROHC_COMP_FRAG_HDRS_MAX_LEN  256U
+
+/** The number of compression contexts in one block of the context table,
+ *  blocks are allocated only when one of their CIDs is used for the first
+ *  time */
+#define ROHC_COMP_CTXTS_BLOCK_LEN  64U
+
+/** The memory preallocated for the profile-specific part of every context by
+ *  \ref rohc_comp_preallocate, the RFC 3095 contexts being the largest ones */
+#define ROHC_COMP_PREALLOC_CTXT_LEN  8192U
+
+/** The number of least recently used contexts among which the eviction
+ *  policies other than LRU choose the context to recycle */
+#define ROHC_COMP_EVICT_CANDIDATES_MAX  8U
+
+/** The number of entries of the cache of the last flows, a power of two */
+#define ROHC_COMP_FLOWS_CACHE_LEN  8U
+
+/** The number of bits of the index of the ESP contexts by SPI */
+#define ROHC_COMP_ESP_SPI_INDEX_BITS  10U
+/** The number of entries of the index of the ESP contexts by SPI */
+#define ROHC_COMP_ESP_SPI_INDEX_LEN  (1U << ROHC_COMP_ESP_SPI_INDEX_BITS)
+
+/** The number of bits of the index of the contexts by NIC hash */
+#define ROHC_COMP_RSS_INDEX_BITS  10U
+/** The number of entries of the index of the contexts by NIC hash */
+#define ROHC_COMP_RSS_INDEX_LEN  (1U << ROHC_COMP_RSS_INDEX_BITS)
+
+/** The number of bits of the index of the contexts by address prefix */
+#define ROHC_COMP_ADDR_INDEX_BITS  10U
+/** The number of entries of the index of the contexts by address prefix */
+#define ROHC_COMP_ADDR_INDEX_LEN  (1U << ROHC_COMP_ADDR_INDEX_BITS)
+/** The length of the IPv4 prefixes the contexts are indexed by (in bytes) */
+#define ROHC_COMP_ADDR_INDEX_V4_KEY_LEN  3U
+/** The length of the IPv6 prefixes the contexts are indexed by (in bytes) */
+#define ROHC_COMP_ADDR_INDEX_V6_KEY_LEN  6U
+/** The max number of bits that a shorter prefix may lack to be found in the
+ *  index of contexts by address prefix, instead of checking all contexts */
+#define ROHC_COMP_ADDR_INDEX_SPREAD_BITS  8U
+/** The number of addresses of one context in the index by address prefix */
+#define ROHC_COMP_ADDR_LINKS_MAX  (ROHC_MAX_IP_HDRS * 2U)
+/** The address of the context that is not in the index by address prefix */
+#define ROHC_COMP_ADDR_INDEX_NONE  0xffffU
+
+/** The max number of contexts that \ref rohc_comp_prefetch keeps in flight
+ *  between two calls: one from the caches, one from the hash table */
+#define ROHC_COMP_PREFETCH_CTXTS_MAX  2U
+
+/** The number of entries of the cache of RTP detection verdicts, a power
+ *  of two */
+#define ROHC_COMP_RTP_VERDICTS_LEN  64U
+
+/** The number of entries of the cache of the flows that only the Uncompressed
+ *  profile accepts, a power of two */
+#define ROHC_COMP_UNCOMP_FLOWS_LEN  64U
+
+/** The number of entries of the table that counts the packets of the new
+ *  flows in warm-up, a power of two, see \ref rohc_comp_set_warmup */
+#define ROHC_COMP_WARMUP_FLOWS_LEN  256U
+
+/** The number of packets over which the bulk policy measures the savings of
+ *  one context, see \ref rohc_comp_set_bulk_policy */
+#define ROHC_COMP_BULK_EVAL_PKTS  64U
+
+/** The loss rate (in per thousand) at which the adaptive periodic refreshes
+ *  keep their configured timeouts, see \ref rohc_comp_set_adaptive_refreshes */
+#define ROHC_COMP_REFRESH_LOSS_REF  10U
+
+/** The loss rate (in per thousand) from which the adaptive periodic
+ *  refreshes are the most frequent */
+#define ROHC_COMP_REFRESH_LOSS_MAX  100U
+
+/** The number of packets after which an overloaded compressor throttled
+ *  to \ref ROHC_COMP_OVERLOAD_THROTTLE may create one more context */
+#define ROHC_COMP_OVERLOAD_CTXT_PKTS  64U
+
+/** The number of feedback items that \ref rohc_comp_deliver_feedback_burst
+ *  parses before it applies them */
+#define ROHC_COMP_FEEDBACK_BURST_LEN  64U
+
+/** The maximum length of the static chain kept by one context: the static
+ *  parts of two IPv6 headers and of the UDP/RTP or ESP headers */
+#define ROHC_COMP_STATIC_CHAIN_MAX_LEN  96U
+
+/** The default maximal jitter (in milliseconds) of the channel for the
+ *  timer-based encoding of the RTP TS */
+#define ROHC_COMP_TS_TIMER_JITTER_DEFAULT  20U
+
 
 /** Print a warning trace for the given compression context */
 #define rohc_comp_warn(context, format, ...) \
@@ -79,7 +186,8 @@
 /** Dump a buffer for the given compression context */
 #define rohc_comp_dump_buf(context, descr, buf, buf_len) \
 	do { \
-		if(((context)->compressor->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0) { \
+		if(((context)->compressor->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0 && \
+		   (context)->compressor->trace_level == ROHC_TRACE_DEBUG) { \
 			rohc_dump_buf((context)->compressor->trace_callback, \
 			              (context)->compressor->trace_callback_priv, \
 			              ROHC_TRACE_COMP, ROHC_TRACE_DEBUG, \
@@ -102,6 +210,106 @@ struct rohc_pkt_hdrs;
  */
 
 
+/**
+ * @brief The classes of packets that the compression profiles are chosen for
+ *
+ * The class of a packet is given by its innermost headers. Every class is
+ * handled by one ROHCv1 profile and at most one ROHCv2 profile.
+ */
+typedef enum
+{
+	ROHC_COMP_PKT_CLASS_IP           = 0, /**< IP-only packets */
+	ROHC_COMP_PKT_CLASS_IP_TCP       = 1, /**< IP/TCP packets */
+	ROHC_COMP_PKT_CLASS_IP_UDP       = 2, /**< IP/UDP packets */
+	ROHC_COMP_PKT_CLASS_IP_RTP       = 3, /**< IP/UDP/RTP packets with RTP version 2 */
+	ROHC_COMP_PKT_CLASS_IP_RTP_OTHER = 4, /**< IP/UDP/RTP packets with another RTP version */
+	ROHC_COMP_PKT_CLASS_IP_ESP       = 5, /**< IP/ESP packets */
+	ROHC_COMP_PKT_CLASS_IP_UDPLITE   = 6, /**< IP/UDP-Lite packets */
+	ROHC_COMP_PKT_CLASS_MAX          = 7, /**< The number of classes of packets */
+} rohc_comp_pkt_class_t;
+
+
+/**
+ * @brief The verdict of the RTP detection callback for one UDP flow
+ *
+ * The flow is identified by the innermost IP addresses and by the UDP ports.
+ */
+struct rohc_comp_rtp_verdict
+{
+	struct ipv6_addr saddr;  /**< The innermost source address (IPv4 or IPv6) */
+	struct ipv6_addr daddr;  /**< The innermost destination address (IPv4 or IPv6) */
+	uint16_t sport;          /**< The UDP source port (in network byte order) */
+	uint16_t dport;          /**< The UDP destination port (in network byte order) */
+	uint8_t ip_version;      /**< The innermost IP version, 0 if entry is unused */
+	bool is_rtp;             /**< Whether the callback detected RTP for the flow */
+	uint16_t reuse_nr;       /**< How many more packets may re-use the verdict */
+};
+
+
+/**
+ * @brief One flow that only the Uncompressed profile accepted
+ */
+struct rohc_comp_uncomp_flow
+{
+	struct ipv6_addr saddr;  /**< The outer source address (IPv4 or IPv6) */
+	struct ipv6_addr daddr;  /**< The outer destination address (IPv4 or IPv6) */
+	uint16_t sport;          /**< The source port (in network byte order) */
+	uint16_t dport;          /**< The destination port (in network byte order) */
+	uint8_t ip_version;      /**< The outer IP version, 0 if entry is unused */
+	uint8_t proto;           /**< The transport protocol of the flow */
+	uint64_t expiry;         /**< The time (in seconds) the entry expires at */
+	/** Whether the flow was sent to the Uncompressed profile by the bulk
+	 *  policy, see \ref rohc_comp_set_bulk_policy */
+	bool is_bulk;
+	/** The header bytes that compression saved per packet of the bulk flow */
+	uint16_t bulk_saved_len;
+	/** The smoothed length of the packets of the bulk flow */
+	uint16_t bulk_avg_len;
+};
+
+
+
+/**
+ * @brief The packets counted for one new flow in warm-up
+ */
+struct rohc_comp_warmup_flow
+{
+	uint64_t hash;          /**< The hash of the fingerprint of the flow */
+	struct rohc_ts first;   /**< The arrival time of the first packet counted */
+	size_t pkts_nr;         /**< The packets counted, 0 if entry is unused */
+};
+
+/**
+ * @brief One feedback item parsed by \ref rohc_comp_deliver_feedback_burst
+ */
+struct rohc_comp_feedback_item
+{
+	const uint8_t *data;            /**< The feedback data, CID included */
+	size_t len;                     /**< The length of the feedback data */
+	size_t cid_len;                 /**< The length of the CID */
+	struct rohc_comp_ctxt *context; /**< The context the feedback is for */
+	bool is_ack;                    /**< Whether the feedback is a positive ACK */
+};
+
+
+/**
+ * @brief One FEEDBACK-2 parsed by \ref rohc_comp_feedback_parse_2
+ *
+ * The base header, the options and the CRC of the feedback are parsed and
+ * checked in one single pass, then handed to the profiles.
+ */
+struct rohc_comp_feedback_2
+{
+	uint32_t sn_bits;     /**< The SN bits collected in base header and options */
+	uint8_t sn_bits_nr;   /**< The number of SN bits */
+	uint8_t ack_type;     /**< The type of acknowledgement */
+	uint8_t mode;         /**< The requested mode (RFC3095 format only) */
+	bool is_crc_present;  /**< Whether a valid CRC protects the feedback */
+	bool sn_not_valid;    /**< Whether the SN-NOT-VALID option is present */
+	bool is_rejected;     /**< Whether the REJECT option is present */
+};
+
+
 /**
  * @brief The ROHC compressor
  */
@@ -113,16 +321,87 @@ struct rohc_comp
 	/** Enabled/disabled features for the compressor */
 	rohc_comp_features_t features;
 
-	/** The array of compression contexts that use the compressor */
-	struct rohc_comp_ctxt *contexts;
-	/** The number of compression contexts in use in the array */
+	/** The table of compression contexts that use the compressor: an array
+	 *  of pointers to blocks of ROHC_COMP_CTXTS_BLOCK_LEN contexts, every
+	 *  block being allocated on demand, indexed from the smallest CID */
+	struct rohc_comp_ctxt **ctxts_blocks;
+	/** The number of blocks in the table of compression contexts */
+	size_t ctxts_blocks_nr;
+	/** The smallest CID the compressor may use, 0 unless the compressor is
+	 *  one shard of a compressor group */
+	rohc_cid_t ctxts_min_cid;
+	/** The largest CID the compressor may use, MAX_CID unless the compressor
+	 *  is one shard of a compressor group */
+	rohc_cid_t ctxts_max_cid;
+	/** The smallest CID that was never used yet, all the contexts with a
+	 *  larger CID are not allocated yet */
+	rohc_cid_t ctxts_next_cid;
+	/** The number of compression contexts in use in the table */
 	uint16_t num_contexts_used;
+	/** The unused contexts, chained together to find a free CID in O(1) */
+	struct rohc_comp_ctxt *ctxts_free;
+	/** The most recently used context of the LRU list of used contexts */
+	struct rohc_comp_ctxt *ctxts_lru_first;
+	/** The least recently used context of the LRU list of used contexts,
+	 *  ie. the context to recycle first when all contexts are in use */
+	struct rohc_comp_ctxt *ctxts_lru_last;
 	struct hashtable contexts_by_fingerprint;
+	/** The contexts of the last flows, indexed by a cheap hash of their
+	 *  fingerprints, to skip the lookup in the hash table for back-to-back
+	 *  packets of the same flows */
+	struct rohc_comp_ctxt *flows_cache[ROHC_COMP_FLOWS_CACHE_LEN];
+	/** The contexts of the ESP flows, indexed by a hash of their SPI, to find
+	 *  the context of one SA among thousands without the hash table ; every
+	 *  hit is verified against the whole fingerprint, outer addresses
+	 *  included */
+	struct rohc_comp_ctxt *esp_by_spi[ROHC_COMP_ESP_SPI_INDEX_LEN];
+	/** The contexts of the flows, indexed by the hash computed by the NIC
+	 *  and given by the user, to skip the hash of the fingerprint ; the
+	 *  entries are not cleared when contexts are released, so every hit is
+	 *  verified against the whole fingerprint of contexts in use */
+	struct rohc_comp_ctxt *ctxts_by_rss[ROHC_COMP_RSS_INDEX_LEN];
+	/** The contexts of the flows, indexed by the prefixes of the addresses
+	 *  of their IP headers, to find the contexts of one address or prefix
+	 *  without checking all the contexts, see
+	 *  \ref rohc_comp_invalidate_contexts ; the contexts of one entry are
+	 *  chained through their \e addr_links */
+	struct rohc_comp_ctxt *ctxts_by_addr[ROHC_COMP_ADDR_INDEX_LEN];
+	/** The lookups started by \ref rohc_comp_prefetch and completed by its
+	 *  next call, once the prefetched memory is in the CPU caches */
+	struct
+	{
+		/** The hash of the fingerprint of the last packet given */
+		uint64_t hash;
+		/** Whether the hash table slot of \e hash remains to be read */
+		bool has_hash;
+		/** The number of contexts whose specific parts remain to be prefetched */
+		size_t ctxts_nr;
+		/** The contexts whose specific parts remain to be prefetched */
+		const struct rohc_comp_ctxt *ctxts[ROHC_COMP_PREFETCH_CTXTS_MAX];
+	} prefetch;
 	struct hashtable contexts_cr;
+	/** The same Context Replication (CR) base contexts, indexed by their
+	 *  base fingerprint and their destination port, to find one base context
+	 *  of medium affinity without walking all the candidates */
+	struct hashtable contexts_cr_by_dst_port;
 	struct rohc_comp_ctxt *uncompressed_ctxt;
+	/** The memory pool for the profile-specific parts of the contexts */
+	struct rohc_mempool mempool;
+	/** The set of channels the memory pool takes its memory from, if any */
+	struct rohc_channel_set *channel_set;
 
 	/** Which profiles are enabled and with one are not? */
 	bool enabled_profiles[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The best enabled profile for every class of packets, indexed by the
+	 *  class of packets, by whether the packet has more IP headers than the
+	 *  RFC3095-based profiles support, and by whether the packet has IPv6
+	 *  extension headers ; ROHC_PROFILE_MAX if no enabled profile may compress
+	 *  the packet (updated every time a profile is enabled or disabled) */
+	rohc_profile_t profiles_by_class[ROHC_COMP_PKT_CLASS_MAX][2][2];
+	/** Whether no enabled profile but the Uncompressed profile may compress
+	 *  packets: packets are then passed through the Uncompressed profile
+	 *  without being classified (updated with \e profiles_by_class) */
+	bool is_uncomp_passthrough;
 
 	/* CRC-related variables: */
 
@@ -136,24 +415,139 @@ struct rohc_comp
 	size_t rru_off;
 	/** The number of the remaining bytes in the RRU buffer */
 	size_t rru_len;
+	/** The fragments of the RRU when it references the ROHC header and the
+	 *  payload instead of holding a copy of them: the ROHC header, the
+	 *  payload and the CRC, 0 fragment if the RRU is copied in \e rru */
+	struct rohc_comp_seg_iov rru_iov[3];
+	/** The number of fragments of the RRU, 0 if the RRU is copied in \e rru */
+	size_t rru_iov_nr;
+	/** The CRC of the RRU referenced by \e rru_iov */
+	uint8_t rru_crc[CRC_FCS32_LEN];
+	/** Whether the RRU of the packet being compressed by
+	 *  \ref rohc_compress_iov shall be referenced instead of copied */
+	bool rru_by_ref;
+
+
+	/* variables related to the compression of chains of buffers */
+
+	/** The length (in bytes) of the segments behind the first one of the
+	 *  chain being compressed by \ref rohc_compress_chain, 0 if the packet
+	 *  being compressed is contiguous */
+	size_t chain_tail_len;
+
+	/** The headers of the packet being compressed by
+	 *  \ref rohc_compress_hdrs_info as parsed by the user, NULL if the
+	 *  packet shall be classified by the compressor */
+	const struct rohc_comp_hdrs_info *hdrs_info;
+
+
+	/* variables related to the compression of super-packets */
+
+	/** The headers of the segment of the super-packet being compressed by
+	 *  \ref rohc_compress_gso, built from the headers of the super-packet */
+	uint8_t gso_hdrs[ROHC_COMP_GSO_HDRS_MAX_LEN];
+
+
+	/* variables related to the compression of IP fragments */
+
+	/** The IP headers of the IPv4 fragment being compressed, without its MF
+	 *  flag and its fragment offset, see \ref ROHC_COMP_FEATURE_IP_FRAGMENTS */
+	uint8_t frag_hdrs[ROHC_COMP_FRAG_HDRS_MAX_LEN];
 
 
 	/* variables related to RTP detection */
 
+	/** The bitmap of the UDP destination ports dedicated to RTP streams,
+	 *  NULL if RTP streams are not detected by port */
+	uint8_t *rtp_ports;
+	/** The TS_STRIDE expected for every RTP Payload Type, 0 if unknown, NULL
+	 *  if no TS_STRIDE was given at all */
+	uint32_t *rtp_ts_strides;
+	/** The maximal jitter (in milliseconds) of the channel between the
+	 *  compressor and the decompressor, for the timer-based encoding of the
+	 *  RTP TS */
+	uint32_t ts_timer_jitter;
 	/** The callback function used to detect RTP packet */
 	rohc_rtp_detection_callback_t rtp_callback;
 	/** Pointer to an external memory area provided/used by the callback user */
 	void *rtp_private;
+	/** The number of packets of one UDP flow for which the callback is asked
+	 *  only once, 1 to ask the callback for every packet */
+	size_t rtp_detection_interval;
+	/** The last verdicts of the callback, indexed by a hash of the UDP flow */
+	struct rohc_comp_rtp_verdict rtp_verdicts[ROHC_COMP_RTP_VERDICTS_LEN];
+
+	/** How long (in seconds) the flows that only the Uncompressed profile
+	 *  accepted skip the classification, 0 to classify every packet */
+	uint64_t uncomp_flows_ttl;
+	/** The flows that only the Uncompressed profile accepted recently,
+	 *  indexed by a hash of the flow */
+	struct rohc_comp_uncomp_flow uncomp_flows[ROHC_COMP_UNCOMP_FLOWS_LEN];
+	/** The savings (in per thousand of the uncompressed bytes) below which the
+	 *  flows are sent with the Uncompressed profile, 0 to disable the bulk
+	 *  policy */
+	unsigned int bulk_min_savings;
+	/** The estimated savings (in per thousand of the uncompressed bytes) above
+	 *  which the bulk flows are compressed again */
+	unsigned int bulk_resume_savings;
+	/** How long (in seconds) the bulk flows are sent with the Uncompressed
+	 *  profile before their savings are measured again */
+	uint64_t bulk_ttl;
+
+	/** The step of degradation asked by the application, see
+	 *  \ref rohc_comp_set_overload */
+	rohc_comp_overload_t overload_asked;
+	/** The step of degradation derived from the compression latency */
+	rohc_comp_overload_t overload_measured;
+	/** The compression time per packet (in ns) of one step of degradation,
+	 *  0 if the latency is not measured, see
+	 *  \ref rohc_comp_set_overload_latency */
+	uint64_t overload_step_ns;
+	/** The smoothed compression time per packet (in ns) */
+	uint64_t overload_avg_ns;
+	/** The number of packets from which the throttled compressor may create
+	 *  one more context */
+	uint64_t overload_next_ctxt_pkt;
+
+	/** The number of packets one new flow shall show before it gets a
+	 *  context, 0 or 1 to create the contexts at once */
+	size_t warmup_pkts_nr;
+	/** The time (in milliseconds) the packets of the new flows are counted
+	 *  over, 0 for no limit */
+	uint64_t warmup_window_ms;
+	/** The packets of the new flows in warm-up, indexed by the hash of their
+	 *  fingerprint */
+	struct rohc_comp_warmup_flow warmup_flows[ROHC_COMP_WARMUP_FLOWS_LEN];
 
 
 	/* some statistics about the compression process: */
 
+	/** The sequence counter that publishes the statistics of the compressor
+	 *  and of its contexts to other threads, odd while they are updated */
+	uint32_t stats_seq;
 	/** The number of sent packets */
-	int num_packets;
+	uint64_t num_packets;
 	/** The size of all the received uncompressed IP packets */
-	int total_uncompressed_size;
+	uint64_t total_uncompressed_size;
 	/** The size of all the sent compressed ROHC packets */
-	int total_compressed_size;
+	uint64_t total_compressed_size;
+	/** The number of contexts recycled to make room for new contexts */
+	unsigned long num_contexts_evicted;
+	/** The number of idle contexts released by \ref rohc_comp_expire */
+	unsigned long num_contexts_expired;
+	/** The number of feedback items for CIDs out of the CID range of the
+	 *  compressor */
+	unsigned long num_feedbacks_foreign;
+	/** The durations of the phases of compression, indexed by
+	 *  \ref rohc_comp_perf_phase_t */
+	struct rohc_perf_histo perf_histos[ROHC_COMP_PERF_PHASES_NR];
+
+	/** The feedback items parsed by \ref rohc_comp_deliver_feedback_burst */
+	struct rohc_comp_feedback_item feedback_burst[ROHC_COMP_FEEDBACK_BURST_LEN];
+
+	/** The ring to consume the feedbacks of the same-side decompressor from,
+	 *  may be NULL */
+	struct rohc_feedback_ring *feedback_ring;
 
 	/** The last context used by the compressor */
 	struct rohc_comp_ctxt *last_context;
@@ -171,9 +565,24 @@ struct rohc_comp
 
 	/** The nr of Optimistic Approach repetitions to gain transmission confidence */
 	uint8_t oa_repetitions_nr;
+	/** The minimal number of repetitions of the Optimistic Approach of the
+	 *  contexts, 0 if the number of repetitions is not adapted to losses */
+	uint8_t oa_repetitions_min;
+	/** The loss rate (in per thousand) of the channel estimated by the application,
+	 *  used by the contexts in U-mode */
+	uint16_t oa_loss_permille;
 	/** The reorder offset specifies how much reordering is handled by the
 	 *  W-LSB encoding of the MSN in ROHCv2 profiles */
 	rohc_reordering_offset_t reorder_ratio;
+	/** Whether the contexts adapt their reorder ratio to the reordering they
+	 *  observe, up to \e reorder_ratio */
+	bool reorder_ratio_auto;
+	/** The reordering depth (in packets) of the channel estimated by the
+	 *  application, used by the contexts that adapt their reorder ratio */
+	uint16_t reorder_depth;
+	/** The number of consistent observations before the IP-ID behavior of
+	 *  a context is reclassified, 1 to reclassify at once */
+	uint8_t ip_id_hysteresis_nr;
 	/** The maximal number of packets sent in > IR states (= FO and SO
 	 *  states) before changing back the state to IR (periodic refreshes) */
 	size_t periodic_refreshes_ir_timeout_pkts;
@@ -186,13 +595,85 @@ struct rohc_comp
 	/** The maximal delay spent in > FO states (= SO state) before changing back
 	 *  the state to FO (periodic refreshes) */
 	uint64_t periodic_refreshes_fo_timeout_time;
+	/** The maximal jitter (in percent of the timeouts) that brings forward
+	 *  the periodic refreshes of every context */
+	uint8_t refresh_jitter_pct;
+	/** The shortest timeouts (in percent of the configured timeouts) of the
+	 *  periodic refreshes in U-mode, on the worst channels */
+	uint16_t refresh_adapt_min_pct;
+	/** The longest timeouts (in percent of the configured timeouts) of the
+	 *  periodic refreshes in U-mode, on the channels without loss */
+	uint16_t refresh_adapt_max_pct;
+	/** The timeouts (in percent of the configured timeouts) of the periodic
+	 *  refreshes in U-mode for the current loss estimate */
+	uint16_t refresh_scale_pct;
+	/** The maximal number of bytes of IR headers per interval beyond which
+	 *  the periodic IR refreshes are deferred, 0 for no limit */
+	size_t ir_refresh_budget;
+	/** The length (in ms) of the intervals of the IR budget */
+	uint64_t ir_refresh_budget_interval;
+	/** The beginning of the current interval of the IR budget */
+	struct rohc_ts ir_refresh_budget_start;
+	/** The number of bytes of IR headers sent in the current interval */
+	size_t ir_refresh_budget_used;
+	/** The number of periodic IR refreshes deferred by the IR budget or by
+	 *  the overload of the compressor */
+	uint64_t num_ir_refreshes_deferred;
+	/** The number of packets of new flows sent with the Uncompressed profile
+	 *  because the compressor was overloaded */
+	uint64_t num_overload_shed;
+	/** The number of packets of new flows sent with the Uncompressed profile
+	 *  during their warm-up */
+	uint64_t num_warmup_held;
+	/** The number of periodic refreshes of the contexts */
+	uint64_t num_refreshes;
+	/** The number of bytes of the ROHC headers sent by the periodic refreshes,
+	 *  until the contexts are back in SO state */
+	uint64_t num_refresh_bytes;
+	/** Whether the periodic refreshes are deferred for the packet being
+	 *  compressed by \ref rohc_compress_constrained */
+	bool defer_refreshes;
+	/** The delay (in ms) without packet after which a context is idle and
+	 *  released by \ref rohc_comp_expire, 0 if contexts never expire */
+	uint64_t ctxt_idle_timeout;
 	/** Maximum Reconstructed Reception Unit */
 	size_t mrru;
 
+	/** The callback function notified of the events of contexts, NULL if
+	 *  the events are not notified */
+	rohc_comp_ctxt_event_cb_t ctxt_event_cb;
+	/** The private context of the callback function notified of events */
+	void *ctxt_event_cb_priv;
+
+	/** The user-defined callback that hashes the flows, if
+	 *  \ref ROHC_COMP_HASH_CUSTOM is used */
+	rohc_comp_hash_cb_t hash_cb;
+	/** The private context of the callback that hashes the flows */
+	void *hash_cb_priv;
+
+	/** The policy that chooses the context to recycle when no CID is left */
+	rohc_comp_evict_t evict_policy;
+	/** The user-defined callback that chooses the context to recycle, if
+	 *  \ref ROHC_COMP_EVICT_CUSTOM is used */
+	rohc_comp_evict_cb_t evict_cb;
+	/** The private context of the callback that chooses the context */
+	void *evict_cb_priv;
+
+	/** The engine that computes the CRCs, the tables of the library for the
+	 *  callbacks left NULL */
+	struct rohc_crc_engine crc_engine;
+
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces given to the callback function */
+	rohc_trace_level_t trace_level;
+
+	/** The statistics of the compressed packets, indexed by the major and
+	 *  minor numbers of their profile ID and by their packet type */
+	struct rohc_comp_pkt_stats
+		pkt_stats[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1][ROHC_PACKET_MAX];
 };
 
 
@@ -234,6 +715,36 @@ struct rohc_comp_profile
 	void (*destroy)(struct rohc_comp_ctxt *const context)
 		__attribute__((nonnull(1)));
 
+	/**
+	 * @brief The handler used to save the profile-specific part of the
+	 *        compression context in a context image, NULL if the profile
+	 *        does not support context images
+	 *
+	 * @param ctxt           The compression context
+	 * @param image          The image to save the context in, may be NULL
+	 * @param image_max_len  The length available in the image
+	 * @return               The length of the profile-specific part of the
+	 *                       context, saved only if it fits in the image
+	 */
+	size_t (*save)(const struct rohc_comp_ctxt *const ctxt,
+	               uint8_t *const image,
+	               const size_t image_max_len)
+		__attribute__((warn_unused_result, nonnull(1)));
+
+	/**
+	 * @brief The handler used to restore the profile-specific part of the
+	 *        compression context from a context image
+	 *
+	 * @param ctxt       The compression context
+	 * @param image      The profile-specific part saved by the save handler
+	 * @param image_len  The length of the profile-specific part
+	 * @return           true if successful, false otherwise
+	 */
+	bool (*restore)(struct rohc_comp_ctxt *const ctxt,
+	                const uint8_t *const image,
+	                const size_t image_len)
+		__attribute__((warn_unused_result, nonnull(1, 2)));
+
 	/**
 	 * @brief The handler used to check whether Context Replication is possible
 	 */
@@ -276,54 +787,180 @@ struct rohc_comp_profile
 
 
 /**
- * @brief The ROHC compression context
+ * @brief Whether the given profile supports Context Replication (CR)
+ *
+ * A profile supports CR if it may clone a context from a base context and
+ * tell whether a base context is close enough to one packet. Context
+ * Replication and the IR-CR packet are defined by RFC 4164 for the ROHC-TCP
+ * profile only: neither the RFC 3095 nor the RFC 5225 profiles define an
+ * IR-CR packet, so they cannot support CR.
+ *
+ * @param profile  The compression profile
+ * @return         true if the profile supports CR, false if it does not
  */
-struct rohc_comp_ctxt
+static inline bool rohc_comp_profile_has_cr(const struct rohc_comp_profile *const profile)
 {
-	struct rohc_comp_ctxt *prev;
+	return (profile->clone != NULL && profile->is_cr_possible != NULL);
+}
+
+
+/**
+ * @brief Is the given profile one of the ESP profiles?
+ *
+ * The contexts of the ESP profiles are indexed by their SPI.
+ *
+ * @param profile_id  The ID of the compression profile
+ * @return            true for the ROHCv1 and ROHCv2 ESP profiles
+ */
+static inline bool rohc_comp_profile_is_esp(const rohc_profile_t profile_id)
+{
+	return (profile_id == ROHCv1_PROFILE_IP_ESP ||
+	        profile_id == ROHCv2_PROFILE_IP_ESP);
+}
+
+
+/** The profile-specific function that builds the static chain of IR packets */
+typedef int (*rohc_comp_code_static_chain_t)(const struct rohc_comp_ctxt *const ctxt,
+                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                             uint8_t *const rohc_data,
+                                             const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+
+/**
+ * @brief The link of one address of one context in the index of contexts by
+ *        address prefix
+ */
+struct rohc_comp_addr_link
+{
+	/** The next context of the same entry of the index */
 	struct rohc_comp_ctxt *next;
-	struct rohc_comp_ctxt *prev_cr;
-	struct rohc_comp_ctxt *next_cr;
+	/** The pointer to the context in the previous link of the same entry */
+	struct rohc_comp_ctxt **pprev;
+};
 
+
+/**
+ * @brief The static chain of one context, built for the first IR packet only
+ *
+ * The static fields of the headers are part of the context fingerprint, so
+ * the static chain of one context never changes.
+ */
+struct rohc_comp_static_chain
+{
+	/** The length of the static chain, 0 if not built yet */
+	uint8_t len;
+	/** The length of the IR header up to the end of the static chain */
+	uint8_t ir_hdr_len;
+	/** The CRC-8 over the IR header up to the end of the static chain */
+	uint8_t ir_crc;
+	/** The static chain */
+	uint8_t data[ROHC_COMP_STATIC_CHAIN_MAX_LEN];
+};
+
+
+/**
+ * @brief The generic part of one compression context in a context image
+ *
+ * The lookup tables, the lists and the statistics of the context, except the
+ * number of packets sent, are not saved: they are rebuilt or reset when the
+ * context is restored.
+ */
+struct rohc_comp_ctxt_image
+{
+	uint8_t mode;                 /**< The mode of the context */
+	uint8_t state;                /**< The state of the context */
+	uint8_t state_oa_repeat_nr;   /**< The repetitions in the current state */
+	uint8_t wlsb_width;           /**< The width of the W-LSB windows */
+	uint8_t wlsb_ack_in_window;   /**< Whether the last ACK was in the window */
+	uint8_t unused[3];
+	uint32_t num_sent_packets;    /**< The number of packets sent */
+	uint32_t go_back_fo_count;    /**< The packets since the last FO refresh */
+	uint32_t go_back_ir_count;    /**< The packets since the last IR refresh */
+	uint32_t wlsb_ack_lag;        /**< The packets sent after the last ACKed one */
+	uint32_t wlsb_ack_interval;   /**< The packets between two positive ACKs */
+	uint32_t wlsb_ack_pkt_nr;     /**< The packets sent at the last positive ACK */
 	/** The fingerprint of the context */
 	struct rohc_fingerprint fingerprint;
+	/** The static chain built for the CID of the context */
+	struct rohc_comp_static_chain static_chain;
+} __attribute__((packed));
 
-	/** Whether the context is in use or not */
-	int used;
-	/** The time when the context was created (in seconds) */
-	uint64_t latest_used;
-	/** The time when the context was last used (in seconds) */
-	uint64_t first_used;
 
-	/** The context unique ID (CID) */
-	rohc_cid_t cid;
+/**
+ * @brief The ROHC compression context
+ *
+ * The fields read or written for every compressed packet come first, so that
+ * they share the first cache lines of the context. The statistics, the
+ * fingerprint and the static chain, only used on specific events, follow.
+ */
+struct rohc_comp_ctxt
+{
+	/* below are the fields used for every packet */
 
 	/** The associated compressor */
 	struct rohc_comp *compressor;
-
 	/** The associated profile */
 	const struct rohc_comp_profile *profile;
 	/** Profile-specific data, defined by the profiles */
 	void *specific;
 
-	/** Whether Context Replication (CR) may be used */
-	bool do_ctxt_replication;
-	/** The base context for Context Replication (CR) */
-	rohc_cid_t cr_base_cid;
+	/** The previous (more recently used) context in the LRU list, unused
+	 *  if the context is not in use */
+	struct rohc_comp_ctxt *lru_prev;
+	/** The next (less recently used) context in the LRU list, or the next
+	 *  free context if the context is not in use */
+	struct rohc_comp_ctxt *lru_next;
+
+	/** The time when the context was last used */
+	struct rohc_ts latest_used;
 
 	/** The operation mode in which the context operates among:
 	 *  ROHC_U_MODE, ROHC_O_MODE, ROHC_R_MODE */
 	rohc_mode_t mode;
 	/** The operation state in which the context operates: IR, FO, SO */
 	rohc_comp_state_t state;
-
-	/* below are some statistics */
-
 	/* The type of ROHC packet created for the last compressed packet */
 	rohc_packet_t packet_type;
 
+	/** The context unique ID (CID) */
+	rohc_cid_t cid;
 	/** The number of packets sent while in the different compression states */
 	uint8_t state_oa_repeat_nr;
+	/**
+	 * @brief The width of the W-LSB windows of the context, adapted to the
+	 *        cadence of the positive ACKs received for the context
+	 * @see rohc_comp_wlsb_width_on_ack
+	 */
+	uint8_t wlsb_width;
+	/**
+	 * @brief The number of repetitions of the Optimistic Approach for the
+	 *        context, adapted to the losses if enabled
+	 * @see rohc_comp_set_adaptive_oa
+	 */
+	uint8_t oa_repetitions_nr;
+	/** The packets sent since the last negative ACK or the last decrease of
+	 *  the number of repetitions of the Optimistic Approach */
+	size_t oa_clean_pkts_nr;
+	/**
+	 * @brief The reorder ratio of the ROHCv2 context, adapted to the
+	 *        reordering if enabled
+	 * @see rohc_comp_set_adaptive_reorder
+	 */
+	rohc_reordering_offset_t reorder_ratio;
+	/** The number of transmissions of the reorder ratio since it changed */
+	uint8_t reorder_ratio_trans_nr;
+	/** The packets sent since the last negative ACK or the last decrease of
+	 *  the reorder ratio */
+	size_t reorder_clean_pkts_nr;
+
+	/** Whether the context is in use or not */
+	int used;
+	/** Whether the context is the scratch copy of \ref rohc_compress_dryrun:
+	 *  it is neither registered in the compressor nor notified */
+	bool is_dryrun;
+	/** The number of sent packets */
+	int num_sent_packets;
 
 	/**
 	 * @brief The number of packet sent while in SO state, used for the periodic
@@ -332,23 +969,63 @@ struct rohc_comp_ctxt
 	 */
 	size_t go_back_fo_count;
 	/**
-	 * @brief The last time that the context was in FO state, used for the
+	 * @brief The number of packet sent while in FO or SO state, used for the
 	 *        periodic refreshes of the context
 	 * @see rohc_comp_periodic_down_transition
 	 */
-	struct rohc_ts go_back_fo_time;
+	size_t go_back_ir_count;
 	/**
-	 * @brief The number of packet sent while in FO or SO state, used for the
+	 * @brief The last time that the context was in FO state, used for the
 	 *        periodic refreshes of the context
 	 * @see rohc_comp_periodic_down_transition
 	 */
-	size_t go_back_ir_count;
+	struct rohc_ts go_back_fo_time;
 	/**
 	 * @brief The last time that the context was in IR state, used for the
 	 *        periodic refreshes of the context
 	 * @see rohc_comp_periodic_down_transition
 	 */
 	struct rohc_ts go_back_ir_time;
+	/**
+	 * @brief The random draw that sets how much the next periodic refreshes
+	 *        of the context are brought forward
+	 * @see rohc_comp_set_refresh_scheduler
+	 */
+	uint16_t refresh_jitter;
+	/**
+	 * @brief The number of packets the context may still compress in SO state
+	 *        before the next periodic refresh, 0 to check the refreshes on
+	 *        the next packet
+	 * @see rohc_comp_periodic_down_transition
+	 */
+	size_t refresh_pkts_left;
+	/**
+	 * @brief The time of the next time-based periodic refresh of the context
+	 *        in SO state
+	 * @see rohc_comp_periodic_down_transition
+	 */
+	struct rohc_ts refresh_deadline;
+	/** Whether the context is doing a periodic refresh, ie. it went back to
+	 *  the IR or FO state for a periodic refresh and is not in SO state yet */
+	bool is_refreshing;
+
+	/** The number of packets sent after the acknowledged one, when the last
+	 *  positive ACK was received */
+	size_t wlsb_ack_lag;
+	/** The smoothed number of packets sent between two positive ACKs */
+	size_t wlsb_ack_interval;
+	/** The number of sent packets when the last positive ACK was received */
+	int wlsb_ack_pkt_nr;
+	/** Whether the packet acknowledged by the last positive ACK is still
+	 *  part of the W-LSB windows */
+	bool wlsb_ack_in_window;
+
+	/** Whether Context Replication (CR) may be used */
+	bool do_ctxt_replication;
+	/** The base context for Context Replication (CR) */
+	rohc_cid_t cr_base_cid;
+
+	/* below are some statistics */
 
 	/** The cumulated size of the uncompressed packets */
 	int total_uncompressed_size;
@@ -368,8 +1045,39 @@ struct rohc_comp_ctxt
 	/** The header size of the last compressed packet */
 	int header_last_compressed_size;
 
-	/** The number of sent packets */
-	int num_sent_packets;
+	/** The numbers of packets, of uncompressed bytes, of uncompressed header
+	 *  bytes and of compressed header bytes when the bulk policy measured the
+	 *  savings of the context for the last time */
+	int bulk_ref_pkts_nr;
+	int bulk_ref_uncomp_size;
+	int bulk_ref_hdr_uncomp_size;
+	int bulk_ref_hdr_comp_size;
+
+	/** The number of changes of the innermost IP-ID behavior */
+	uint64_t ip_id_behavior_changes_nr;
+	/** The cumulated time spent to encode the ROHC headers of the context (in
+	 *  nanoseconds), measured only if \ref ROHC_COMP_FEATURE_PERF_INFO is
+	 *  enabled */
+	uint64_t processing_ns;
+
+	/** The time when the context was created (in seconds) */
+	uint64_t first_used;
+
+	/* below are the fields used on context lookup, creation or refresh */
+
+	/** The fingerprint of the context */
+	struct rohc_fingerprint fingerprint;
+
+	/** The links of the source and destination addresses of the IP headers
+	 *  in the index of contexts by address prefix */
+	struct rohc_comp_addr_link addr_links[ROHC_COMP_ADDR_LINKS_MAX];
+	/** The entries of the index of contexts by address prefix the addresses
+	 *  are linked in, ROHC_COMP_ADDR_INDEX_NONE for the addresses that are
+	 *  absent or that share the entry of a previous address */
+	uint16_t addr_idx[ROHC_COMP_ADDR_LINKS_MAX];
+
+	/** The static chain of the context */
+	struct rohc_comp_static_chain static_chain;
 };
 
 
@@ -385,21 +1093,54 @@ void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context,
                                         const struct rohc_ts pkt_time)
 	__attribute__((nonnull(1)));
 
+size_t rohc_comp_wlsb_width_on_ack(struct rohc_comp_ctxt *const context,
+                                   const size_t ack_lag)
+	__attribute__((warn_unused_result, nonnull(1)));
+size_t rohc_comp_wlsb_width_on_nack(struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+size_t rohc_comp_wlsb_width_on_send(struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_comp_oa_on_nack(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+void rohc_comp_reorder_on_nack(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+int rohc_comp_code_static_chain(struct rohc_comp_ctxt *const context,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                uint8_t *const ir_hdr,
+                                const size_t ir_hdr_len,
+                                const size_t ir_hdr_max_len,
+                                rohc_comp_code_static_chain_t code_static_chain)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6)));
+uint8_t rohc_comp_ir_crc(const struct rohc_comp_ctxt *const context,
+                         const uint8_t *const ir_hdr,
+                         const size_t ir_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rohc_comp_get_fingerprint(const struct rohc_comp *const comp,
+                               const struct rohc_buf *const packet,
+                               struct rohc_fingerprint *const fingerprint)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
 bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
-bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
-                                   const uint8_t *const packet,
-                                   const size_t packet_len,
-                                   const uint8_t *const feedback_data,
-                                   const size_t feedback_data_len,
-                                   size_t opts_present[ROHC_FEEDBACK_OPT_MAX],
-                                   uint32_t *const sn_bits,
-                                   size_t *const sn_bits_nr,
-                                   const rohc_feedback_crc_t crc_type,
-                                   uint8_t crc_in_packet,
-                                   size_t crc_pos_from_end)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 7, 8)));
+bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
+                                  const uint8_t *const feedback,
+                                  const size_t feedback_len,
+                                  rohc_cid_t *const cid,
+                                  size_t *const cid_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+bool rohc_comp_feedback_parse_2(const struct rohc_comp_ctxt *const context,
+                                const uint8_t *const packet,
+                                const size_t packet_len,
+                                const uint8_t *const feedback_data,
+                                const size_t feedback_data_len,
+                                const rohc_feedback_crc_t crc_type,
+                                struct rohc_comp_feedback_2 *const feedback2)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 7)));
 
 #endif
 
@@ -0,0 +1,509 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_comp_queue.c
+ * @brief  Submission and completion rings around one ROHC compressor
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "rohc_comp.h"
+#include "rohc_comp_internals.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+
+/** The maximum number of slots of the rings of one queue */
+#define ROHC_COMP_QUEUE_SLOTS_MAX  65536U
+
+/** The maximum number of packets the worker gives to the burst API at once */
+#define ROHC_COMP_QUEUE_BURST_MAX  32U
+
+
+/**
+ * @brief One slot of the submission ring
+ *
+ * The sequence number of the slot tells who may use it: equal to the index
+ * of the slot, the slot is free for the submitter that claims that index;
+ * equal to the index plus one, the slot is filled for the worker.
+ */
+struct rohc_comp_queue_sq_slot
+{
+	size_t seq;               /**< The sequence number of the slot */
+	struct rohc_comp_sqe sqe; /**< The submission */
+};
+
+
+/**
+ * @brief One slot of the completion ring
+ *
+ * The sequence number works the same way as for the submission ring, the
+ * worker fills the slots and the reapers drain them.
+ */
+struct rohc_comp_queue_cq_slot
+{
+	size_t seq;               /**< The sequence number of the slot */
+	struct rohc_comp_cqe cqe; /**< The completion */
+};
+
+
+/**
+ * @brief A queue of ROHC compression around one compressor
+ *
+ * The submitters, that may be many threads, claim the slots of the
+ * submission ring by moving its head with compare-and-swap; the worker is the
+ * only one to drain the submission ring and to fill the completion ring; the
+ * reapers, that may be many threads, claim the slots of the completion ring
+ * by moving its tail with compare-and-swap. Every slot is published with its
+ * sequence number, so that a slot being written is never read. The indexes
+ * written by different threads are kept on different cache lines.
+ */
+struct rohc_comp_queue
+{
+	/** The compressor the worker compresses the packets with */
+	struct rohc_comp *comp;
+	/** The mask to apply on indexes to get slots, number of slots minus 1 */
+	size_t mask;
+	/** The slots of the submission ring */
+	struct rohc_comp_queue_sq_slot *sq;
+	/** The slots of the completion ring */
+	struct rohc_comp_queue_cq_slot *cq;
+
+	/** The burst of packets the worker gives to the compressor */
+	struct rohc_buf uncomp_pkts[ROHC_COMP_QUEUE_BURST_MAX];
+	/** The ROHC packets of the burst */
+	struct rohc_buf rohc_pkts[ROHC_COMP_QUEUE_BURST_MAX];
+	/** The statuses of the packets of the burst */
+	rohc_status_t statuses[ROHC_COMP_QUEUE_BURST_MAX];
+	/** The tags of the packets of the burst */
+	uint64_t tags[ROHC_COMP_QUEUE_BURST_MAX];
+
+	uint8_t unused1[64]; /**< keep indexes on their own cache lines */
+	/** The next submission index to claim, written by the submitters */
+	size_t sq_head;
+	uint8_t unused2[64 - sizeof(size_t)]; /**< keep indexes on their own cache lines */
+	/** The next submission index to drain, written by the worker only */
+	size_t sq_tail;
+	/** The next completion index to fill, written by the worker only */
+	size_t cq_head;
+	uint8_t unused3[64 - 2 * sizeof(size_t)]; /**< keep indexes on their own cache lines */
+	/** The next completion index to claim, written by the reapers */
+	size_t cq_tail;
+};
+
+
+/**
+ * @brief Create a new queue of ROHC compression around one compressor
+ *
+ * The queue decouples the threads that have packets to compress from the
+ * thread that compresses them, as io_uring does for system calls:
+ *  \li any thread submits packets with \ref rohc_comp_queue_submit, without
+ *      locking and without waiting for their compression,
+ *  \li one worker thread, eg. on a dedicated core, calls
+ *      \ref rohc_comp_queue_run to compress the submitted packets in bursts
+ *      with \ref rohc_compress_burst,
+ *  \li any thread retrieves the results with \ref rohc_comp_queue_reap.
+ *
+ * The compressor shall only be used by the worker thread once linked with
+ * the queue, eg. one shard of a group of compressors (see
+ * \ref rohc_comp_group_get_shard) per worker. The ROHC segmentation shall
+ * not be enabled on the compressor, since nobody would retrieve the segments.
+ *
+ * @param comp      The ROHC compressor the worker uses
+ * @param slots_nr  The number of packets the queue may hold, a power of 2 in
+ *                  range [1, 65536]
+ * @return          The created queue if successful, NULL if creation failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_free
+ */
+struct rohc_comp_queue * rohc_comp_queue_new(struct rohc_comp *const comp,
+                                             const size_t slots_nr)
+{
+	struct rohc_comp_queue *queue;
+	size_t i;
+
+	/* the number of slots shall be a non-zero power of 2 */
+	if(comp == NULL || slots_nr == 0 || slots_nr > ROHC_COMP_QUEUE_SLOTS_MAX ||
+	   (slots_nr & (slots_nr - 1)) != 0)
+	{
+		goto error;
+	}
+
+	queue = calloc(1, sizeof(struct rohc_comp_queue));
+	if(queue == NULL)
+	{
+		goto error;
+	}
+	queue->sq = calloc(slots_nr, sizeof(struct rohc_comp_queue_sq_slot));
+	if(queue->sq == NULL)
+	{
+		goto free_queue;
+	}
+	queue->cq = calloc(slots_nr, sizeof(struct rohc_comp_queue_cq_slot));
+	if(queue->cq == NULL)
+	{
+		goto free_sq;
+	}
+	for(i = 0; i < slots_nr; i++)
+	{
+		queue->sq[i].seq = i;
+		queue->cq[i].seq = i;
+	}
+	queue->comp = comp;
+	queue->mask = slots_nr - 1;
+	queue->sq_head = 0;
+	queue->sq_tail = 0;
+	queue->cq_head = 0;
+	queue->cq_tail = 0;
+
+	return queue;
+
+free_sq:
+	free(queue->sq);
+free_queue:
+	free(queue);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given queue of ROHC compression
+ *
+ * The submitted packets that were not compressed yet and the completions
+ * that were not reaped yet are dropped. The compressor is not destroyed.
+ *
+ * @param queue  The queue to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_new
+ */
+void rohc_comp_queue_free(struct rohc_comp_queue *const queue)
+{
+	if(queue != NULL)
+	{
+		free(queue->cq);
+		free(queue->sq);
+		free(queue);
+	}
+}
+
+
+/**
+ * @brief Submit one packet to compress to the queue
+ *
+ * May be called by any thread at the same time as the other submitters, the
+ * worker and the reapers. The uncompressed packet and the buffer for the
+ * ROHC packet shall stay valid until the completion with the same tag is
+ * reaped.
+ *
+ * @param queue  The queue of ROHC compression
+ * @param sqe    The packet to compress, the buffer for the ROHC packet and
+ *               the tag of the caller
+ * @return       true if the packet was submitted,
+ *               false if the queue is full or a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_submit_burst
+ * @see rohc_comp_queue_reap
+ */
+bool rohc_comp_queue_submit(struct rohc_comp_queue *const queue,
+                            const struct rohc_comp_sqe *const sqe)
+{
+	return (rohc_comp_queue_submit_burst(queue, sqe, 1) == 1);
+}
+
+
+/**
+ * @brief Submit several packets to compress to the queue at once
+ *
+ * The packets are given to the worker in the order of the array, one after
+ * the other, without any packet of another submitter between them. One
+ * single atomic operation is required for the whole burst, so the
+ * submitters that have several packets at once, eg. all the packets read
+ * from one socket, contend less on the queue.
+ *
+ * The packets of one flow are compressed in the order they were submitted
+ * as long as the flow is fed by one single thread.
+ *
+ * May be called by any thread at the same time as the other submitters, the
+ * worker and the reapers. The uncompressed packets and the buffers for the
+ * ROHC packets shall stay valid until the completions with the same tags
+ * are reaped.
+ *
+ * @param queue    The queue of ROHC compression
+ * @param sqes     The packets to compress, the buffers for the ROHC packets
+ *                 and the tags of the caller
+ * @param sqes_nr  The number of packets to submit
+ * @return         The number of packets that were submitted, ie. the first
+ *                 ones of the array, less than sqes_nr if the queue is full,
+ *                 0 if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_submit
+ * @see rohc_comp_queue_reap
+ */
+size_t rohc_comp_queue_submit_burst(struct rohc_comp_queue *const queue,
+                                    const struct rohc_comp_sqe *const sqes,
+                                    const size_t sqes_nr)
+{
+	size_t free_nr;
+	size_t pos;
+	size_t i;
+
+	if(queue == NULL || sqes == NULL)
+	{
+		goto error;
+	}
+
+	/* claim the free slots at the head of the ring, the worker drains the
+	 * slots in order so the free slots are contiguous */
+	pos = __atomic_load_n(&queue->sq_head, __ATOMIC_RELAXED);
+	do
+	{
+		for(free_nr = 0; free_nr < sqes_nr; free_nr++)
+		{
+			const struct rohc_comp_queue_sq_slot *const slot =
+				&(queue->sq[(pos + free_nr) & queue->mask]);
+			if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != (pos + free_nr))
+			{
+				break;
+			}
+		}
+		if(free_nr == 0)
+		{
+			const struct rohc_comp_queue_sq_slot *const slot =
+				&(queue->sq[pos & queue->mask]);
+			const size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+			if(sqes_nr == 0 || (intptr_t) (seq - pos) < 0)
+			{
+				/* nothing to submit, or the slot still holds the submission of
+				 * the previous round */
+				goto error;
+			}
+			/* another submitter claimed the slot, try again further */
+			pos = __atomic_load_n(&queue->sq_head, __ATOMIC_RELAXED);
+			continue;
+		}
+		/* pos is reloaded if another submitter claimed the slots meanwhile */
+	}
+	while(free_nr == 0 ||
+	      !__atomic_compare_exchange_n(&queue->sq_head, &pos, pos + free_nr, true,
+	                                   __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	/* fill the slots, then publish them for the worker */
+	for(i = 0; i < free_nr; i++)
+	{
+		struct rohc_comp_queue_sq_slot *const slot =
+			&(queue->sq[(pos + i) & queue->mask]);
+		slot->sqe = sqes[i];
+		__atomic_store_n(&slot->seq, pos + i + 1, __ATOMIC_RELEASE);
+	}
+
+	return free_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Compress the packets submitted to the queue
+ *
+ * Drain the submitted packets in bursts given to \ref rohc_compress_burst,
+ * and publish one completion for every packet. Compression stops when no
+ * packet is submitted or when the completion ring is full, the completions
+ * shall then be reaped first.
+ *
+ * Shall be called by one single thread, the only one that uses the
+ * compressor of the queue.
+ *
+ * @param queue  The queue of ROHC compression
+ * @return       The number of packets that were compressed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_submit
+ * @see rohc_comp_queue_reap
+ */
+size_t rohc_comp_queue_run(struct rohc_comp_queue *const queue)
+{
+	size_t total_nr = 0;
+	size_t pkts_nr;
+
+	if(queue == NULL)
+	{
+		goto error;
+	}
+
+	do
+	{
+		size_t done_nr;
+		size_t i;
+
+		/* take the submitted packets that have a free completion slot */
+		for(pkts_nr = 0; pkts_nr < ROHC_COMP_QUEUE_BURST_MAX; pkts_nr++)
+		{
+			const size_t sq_pos = queue->sq_tail + pkts_nr;
+			const size_t cq_pos = queue->cq_head + pkts_nr;
+			struct rohc_comp_queue_sq_slot *const sq_slot =
+				&(queue->sq[sq_pos & queue->mask]);
+			const struct rohc_comp_queue_cq_slot *const cq_slot =
+				&(queue->cq[cq_pos & queue->mask]);
+
+			if(__atomic_load_n(&sq_slot->seq, __ATOMIC_ACQUIRE) != (sq_pos + 1) ||
+			   __atomic_load_n(&cq_slot->seq, __ATOMIC_ACQUIRE) != cq_pos)
+			{
+				break;
+			}
+			queue->uncomp_pkts[pkts_nr] = sq_slot->sqe.uncomp_pkt;
+			queue->rohc_pkts[pkts_nr] = sq_slot->sqe.rohc_pkt;
+			queue->tags[pkts_nr] = sq_slot->sqe.tag;
+
+			/* give the submission slot back to the submitters */
+			__atomic_store_n(&sq_slot->seq, sq_pos + queue->mask + 1,
+			                 __ATOMIC_RELEASE);
+		}
+		queue->sq_tail += pkts_nr;
+
+		/* compress the burst, the burst API stops at the packets that require
+		 * segmentation, go on with the next ones */
+		for(done_nr = 0; done_nr < pkts_nr; )
+		{
+			size_t nr = rohc_compress_burst(queue->comp,
+			                                queue->uncomp_pkts + done_nr,
+			                                queue->rohc_pkts + done_nr,
+			                                queue->statuses + done_nr,
+			                                pkts_nr - done_nr);
+			if(nr == 0)
+			{
+				/* the compressor refused the whole burst */
+				for(i = done_nr; i < pkts_nr; i++)
+				{
+					queue->statuses[i] = ROHC_STATUS_ERROR;
+				}
+				nr = pkts_nr - done_nr;
+			}
+			done_nr += nr;
+		}
+
+		/* publish the completions for the reapers */
+		for(i = 0; i < pkts_nr; i++)
+		{
+			const size_t cq_pos = queue->cq_head + i;
+			struct rohc_comp_queue_cq_slot *const cq_slot =
+				&(queue->cq[cq_pos & queue->mask]);
+
+			cq_slot->cqe.status = queue->statuses[i];
+			cq_slot->cqe.len =
+				(queue->statuses[i] == ROHC_STATUS_OK ? queue->rohc_pkts[i].len : 0);
+			cq_slot->cqe.tag = queue->tags[i];
+			__atomic_store_n(&cq_slot->seq, cq_pos + 1, __ATOMIC_RELEASE);
+		}
+		queue->cq_head += pkts_nr;
+
+		total_nr += pkts_nr;
+	}
+	while(pkts_nr == ROHC_COMP_QUEUE_BURST_MAX);
+
+	return total_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Retrieve the completions of the packets compressed by the queue
+ *
+ * May be called by any thread at the same time as the submitters, the
+ * worker and the other reapers. The completions are retrieved in the order
+ * the packets were compressed.
+ *
+ * @param queue       The queue of ROHC compression
+ * @param[out] cqes   The completions
+ * @param max_nr      The maximum number of completions to retrieve
+ * @return            The number of completions that were retrieved
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_queue_submit
+ */
+size_t rohc_comp_queue_reap(struct rohc_comp_queue *const queue,
+                            struct rohc_comp_cqe *const cqes,
+                            const size_t max_nr)
+{
+	size_t nr;
+
+	if(queue == NULL || cqes == NULL)
+	{
+		goto error;
+	}
+
+	for(nr = 0; nr < max_nr; nr++)
+	{
+		struct rohc_comp_queue_cq_slot *slot;
+		size_t pos;
+
+		/* claim the slot at the tail of the ring, if the worker filled it */
+		pos = __atomic_load_n(&queue->cq_tail, __ATOMIC_RELAXED);
+		for(;;)
+		{
+			size_t seq;
+
+			slot = &(queue->cq[pos & queue->mask]);
+			seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+			if(seq == (pos + 1))
+			{
+				if(__atomic_compare_exchange_n(&queue->cq_tail, &pos, pos + 1, true,
+				                               __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				{
+					break;
+				}
+				/* another reaper claimed the slot, pos was reloaded */
+			}
+			else if((intptr_t) (seq - (pos + 1)) < 0)
+			{
+				/* no more completion */
+				goto end;
+			}
+			else
+			{
+				pos = __atomic_load_n(&queue->cq_tail, __ATOMIC_RELAXED);
+			}
+		}
+
+		/* copy the completion, then give the slot back to the worker */
+		cqes[nr] = slot->cqe;
+		__atomic_store_n(&slot->seq, pos + queue->mask + 1, __ATOMIC_RELEASE);
+	}
+
+end:
+	return nr;
+
+error:
+	return 0;
+}
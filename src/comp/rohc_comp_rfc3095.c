@@ -41,6 +41,7 @@
 #include "schemes/comp_list_ipv6.h"
 #include "sdvl.h"
 #include "crc.h"
+#include "rohc_hdr_image.h"
 
 #include <stdint.h>
 #include <string.h>
@@ -56,10 +57,12 @@
 static bool ip_header_info_new(struct ip_header_info *const header_info,
                                const struct rohc_pkt_ip_hdr *const ip,
                                const size_t oa_repetitions_nr,
+                               struct rohc_mempool *const mempool,
                                const int profile_id,
                                rohc_trace_callback2_t trace_cb,
-                               void *const trace_cb_priv)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+                               void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 static void ip_header_info_free(struct ip_header_info *const header_info)
 	__attribute__((nonnull(1)));
 
@@ -68,33 +71,15 @@ static void c_init_tmp_variables(struct generic_tmp_vars *const tmp_vars);
 static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
-static rohc_ext_t decide_extension_uor2(const struct rohc_comp_ctxt *const context,
-                                        const bool innermost_ip_id_changed,
-                                        const bool innermost_ip_id_3bits_possible,
-                                        const bool innermost_ip_id_8bits_possible,
-                                        const bool innermost_ip_id_11bits_possible,
-                                        const bool outermost_ip_id_changed,
-                                        const bool outermost_ip_id_11bits_possible)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uor2rtp(const struct rohc_comp_ctxt *const context,
-                                           const bool innermost_ip_id_changed,
-                                           const bool outermost_ip_id_changed)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uor2ts(const struct rohc_comp_ctxt *const context,
-                                          const bool innermost_ip_id_changed,
-                                          const bool innermost_ip_id_8bits_possible,
-                                          const bool outermost_ip_id_changed)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uor2id(const struct rohc_comp_ctxt *const context,
-                                          const bool innermost_ip_id_5bits_possible,
-                                          const bool innermost_ip_id_8bits_possible,
-                                          const bool outermost_ip_id_changed)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uo1id(const struct rohc_comp_ctxt *const context,
-                                         const bool innermost_ip_id_5bits_possible,
-                                         const bool innermost_ip_id_8bits_possible,
-                                         const bool outermost_ip_id_changed)
-	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t rohc_ext_get_ext0_packet(const rohc_packet_t packet_type)
+	__attribute__((warn_unused_result, const));
+static const struct rohc_ext_rule *
+	rohc_ext_get_rules(const rohc_packet_t packet_type)
+	__attribute__((warn_unused_result, const));
+static uint32_t rohc_ext_get_conds(const struct rohc_comp_ctxt *const context,
+                                   const rohc_packet_t packet_type,
+                                   uint8_t *const nr_ts_bits)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
 
 static int code_packet(struct rohc_comp_ctxt *const context,
                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -119,8 +104,8 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 
 static int rohc_code_static_part(const struct rohc_comp_ctxt *const context,
                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                 uint8_t *const rohc_pkt,
-                                 int counter)
+                                 uint8_t *const rohc_data,
+                                 const size_t rohc_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 static int rohc_code_static_ip_part(const struct rohc_comp_ctxt *const context,
@@ -322,14 +307,14 @@ static void update_context_ip_hdr(const struct rohc_comp_ctxt *const context,
                                   const struct rohc_pkt_ip_hdr *const ip)
 	__attribute__((nonnull(1, 2, 3)));
 
-static void rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const context,
+static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const context,
                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
-	__attribute__((nonnull(1, 2)));
-static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool detect_ip_changes(const struct rohc_comp_ctxt *const context,
                               /* TODO: const */ struct ip_header_info *const header_info,
                               const struct rohc_pkt_ip_hdr *const ip,
                               struct rfc3095_ip_hdr_changes *const changes)
-	__attribute__((nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 static void detect_ip_id_behaviours(struct rohc_comp_ctxt *const context,
                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 	__attribute__((nonnull(1, 2)));
@@ -341,6 +326,9 @@ static void detect_ip_id_behaviour(const struct rohc_comp_ctxt *const context,
 static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool encode_uncomp_fields_uo0(struct rohc_comp_ctxt *const context,
+                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static void rohc_get_innermost_ipv4_non_rnd(const struct rohc_comp_ctxt *const context,
                                             ip_header_pos_t *const pos,
@@ -369,6 +357,9 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
                                            const bool sn_not_valid)
 	__attribute__((nonnull(1)));
 
+static void rohc_comp_rfc3095_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                             const size_t width)
+	__attribute__((nonnull(1)));
 
 
 /*
@@ -381,17 +372,22 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
  * @param header_info        The IP header info to initialize
  * @param ip                 The IP header
  * @param oa_repetitions_nr  The number of repetitions for Optimistic Approach
+ * @param mempool            The memory pool to allocate the W-LSB windows and
+ *                           the IPv6 extension header lists from
  * @param profile_id         The ID of the associated compression profile
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_level        The lowest level of the traces to print
  * @return                   true if successful, false otherwise
  */
 static bool ip_header_info_new(struct ip_header_info *const header_info,
                                const struct rohc_pkt_ip_hdr *const ip,
                                const size_t oa_repetitions_nr,
+                               struct rohc_mempool *const mempool,
                                const int profile_id,
                                rohc_trace_callback2_t trace_cb,
-                               void *const trace_cb_priv)
+                               void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level)
 {
 	bool is_ok;
 
@@ -408,12 +404,16 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 		memcpy(&header_info->info.v4.old_ip, ip->ipv4, sizeof(struct ipv4_hdr));
 
 		/* init the parameters to encode the IP-ID with W-LSB encoding */
-		is_ok = wlsb_new(&header_info->info.v4.ip_id_window, oa_repetitions_nr);
+		is_ok = wlsb_new(&header_info->info.v4.ip_id_window, oa_repetitions_nr,
+		                 mempool);
 		if(!is_ok)
 		{
-			__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_ERROR,
-			             ROHC_TRACE_COMP, profile_id,
-			             "no memory to allocate W-LSB encoding for IP-ID");
+			if(ROHC_TRACE_ERROR >= trace_level)
+			{
+				__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_ERROR,
+				             ROHC_TRACE_COMP, profile_id,
+				             "no memory to allocate W-LSB encoding for IP-ID");
+			}
 			goto error;
 		}
 
@@ -431,8 +431,9 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 		memcpy(&header_info->info.v6.old_ip, ip->ipv6, sizeof(struct ipv6_hdr));
 
 		/* init the compression context for IPv6 extension header list */
-		rohc_comp_list_ipv6_new(&header_info->info.v6.ext_comp, oa_repetitions_nr,
-		                        profile_id, trace_cb, trace_cb_priv);
+		rohc_comp_list_ipv6_new(&header_info->info.v6.ext_comp, mempool,
+		                        oa_repetitions_nr, profile_id, trace_cb,
+		                        trace_cb_priv, trace_level);
 	}
 
 	return true;
@@ -534,7 +535,8 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "new generic context required for a new stream");
 
 	/* allocate memory for the generic part of the context */
-	rfc3095_ctxt = calloc(1, sizeof(struct rohc_comp_rfc3095_ctxt));
+	rfc3095_ctxt = rohc_mempool_alloc(&context->compressor->mempool,
+	                                  sizeof(struct rohc_comp_rfc3095_ctxt));
 	if(rfc3095_ctxt == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -544,14 +546,16 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	context->specific = rfc3095_ctxt;
 
 	/* init the parameters to encode the SN with W-LSB encoding */
-	is_ok = wlsb_new(&rfc3095_ctxt->sn_window, context->compressor->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc3095_ctxt->sn_window, context->compressor->oa_repetitions_nr,
+	                 &context->compressor->mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "no memory to allocate W-LSB encoding for SN");
 		goto free_generic_context;
 	}
-	is_ok = wlsb_new(&rfc3095_ctxt->msn_non_acked, context->compressor->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc3095_ctxt->msn_non_acked, context->compressor->oa_repetitions_nr,
+	                 &context->compressor->mempool);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -570,9 +574,11 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 		           "init context for IP header #%zu", ip_hdr_pos + 1);
 		if(!ip_header_info_new(ip_ctxt, pkt_ip_hdr,
 		                       context->compressor->oa_repetitions_nr,
+		                       &context->compressor->mempool,
 		                       context->profile->id,
 		                       context->compressor->trace_callback,
-		                       context->compressor->trace_callback_priv))
+		                       context->compressor->trace_callback_priv,
+		                       context->compressor->trace_level))
 		{
 			goto free_header_info;
 		}
@@ -601,7 +607,8 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 
 	/* init the profile-specific variables to safe values */
 	rfc3095_ctxt->specific = NULL;
-	rfc3095_ctxt->next_header_proto = uncomp_pkt_hdrs->ip_hdrs[1].next_proto;
+	rfc3095_ctxt->specific_len = 0;
+	rfc3095_ctxt->next_header_proto = uncomp_pkt_hdrs->innermost_ip_hdr->next_proto;
 	rfc3095_ctxt->next_header_len = 0;
 	rfc3095_ctxt->decide_state = rohc_comp_rfc3095_decide_state;
 	rfc3095_ctxt->decide_FO_packet = NULL;
@@ -635,7 +642,8 @@ free_header_info:
 free_sn_window:
 	wlsb_free(&rfc3095_ctxt->sn_window);
 free_generic_context:
-	free(rfc3095_ctxt);
+	rohc_mempool_release(&context->compressor->mempool, rfc3095_ctxt,
+	                     sizeof(struct rohc_comp_rfc3095_ctxt));
 quit:
 	return false;
 }
@@ -662,8 +670,10 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	wlsb_free(&rfc3095_ctxt->msn_non_acked);
 	wlsb_free(&rfc3095_ctxt->sn_window);
 
-	zfree(rfc3095_ctxt->specific);
-	free(rfc3095_ctxt);
+	rohc_mempool_release(&context->compressor->mempool, rfc3095_ctxt->specific,
+	                     rfc3095_ctxt->specific_len);
+	rohc_mempool_release(&context->compressor->mempool, rfc3095_ctxt,
+	                     sizeof(struct rohc_comp_rfc3095_ctxt));
 }
 
 
@@ -704,8 +714,16 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 
 	*packet_type = ROHC_PACKET_UNKNOWN;
 
+	/* widen the W-LSB windows back if ACKs stopped coming back */
+	rohc_comp_rfc3095_set_wlsb_width(context, rohc_comp_wlsb_width_on_send(context));
+
 	/* detect changes between new uncompressed packet and context */
-	rohc_comp_rfc3095_detect_changes(context, uncomp_pkt_hdrs);
+	if(!rohc_comp_rfc3095_detect_changes(context, uncomp_pkt_hdrs))
+	{
+		rohc_comp_warn(context, "failed to detect changes in uncompressed "
+		               "packet");
+		goto error;
+	}
 
 	/* decide in which state to go */
 	rfc3095_ctxt->decide_state(context);
@@ -714,29 +732,48 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 		rohc_comp_periodic_down_transition(context, uncomp_pkt_time);
 	}
 
-	/* compute how many bits are needed to send header fields */
-	if(!encode_uncomp_fields(context, uncomp_pkt_hdrs))
+	/* in SO state, the profiles without transport fields to encode build the
+	 * UO-0 packet directly if it fits, otherwise compute how many bits are
+	 * needed to send header fields, then decide which packet to send */
+	if(context->state == ROHC_COMP_STATE_SO &&
+	   rfc3095_ctxt->encode_uncomp_fields == NULL &&
+	   encode_uncomp_fields_uo0(context, uncomp_pkt_hdrs))
 	{
-		rohc_comp_warn(context, "failed to compute how many bits are needed "
-		               "to send header fields");
-		goto error;
+		rohc_comp_debug(context, "packet 'UO-0' chosen for steady flow");
+		*packet_type = ROHC_PACKET_UO_0;
+		size = code_UO0_packet(context, uncomp_pkt_hdrs,
+		                       rohc_pkt, rohc_pkt_max_len, *packet_type);
+		if(size < 0)
+		{
+			goto error;
+		}
 	}
+	else
+	{
+		/* compute how many bits are needed to send header fields */
+		if(!encode_uncomp_fields(context, uncomp_pkt_hdrs))
+		{
+			rohc_comp_warn(context, "failed to compute how many bits are needed "
+			               "to send header fields");
+			goto error;
+		}
 
-	/* decide which packet to send */
-	*packet_type = decide_packet(context);
+		/* decide which packet to send */
+		*packet_type = decide_packet(context);
 
-	/* does the packet update the decompressor context? */
-	if(rohc_packet_carry_crc_7_or_8(*packet_type))
-	{
-		rfc3095_ctxt->msn_of_last_ctxt_updating_pkt = rfc3095_ctxt->sn;
-	}
+		/* does the packet update the decompressor context? */
+		if(rohc_packet_carry_crc_7_or_8(*packet_type))
+		{
+			rfc3095_ctxt->msn_of_last_ctxt_updating_pkt = rfc3095_ctxt->sn;
+		}
 
-	/* code the ROHC header (and the extension if needed) */
-	size = code_packet(context, uncomp_pkt_hdrs,
-	                   rohc_pkt, rohc_pkt_max_len, *packet_type);
-	if(size < 0)
-	{
-		goto error;
+		/* code the ROHC header (and the extension if needed) */
+		size = code_packet(context, uncomp_pkt_hdrs,
+		                   rohc_pkt, rohc_pkt_max_len, *packet_type);
+		if(size < 0)
+		{
+			goto error;
+		}
 	}
 
 	/* update the context with the new headers */
@@ -835,41 +872,24 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
                                          const uint8_t *const feedback_data,
                                          const size_t feedback_data_len)
 {
-	const uint8_t *remain_data = feedback_data;
-	size_t remain_len = feedback_data_len;
-	const struct rohc_feedback_2_rfc3095 *feedback2;
-
-	size_t opts_present[ROHC_FEEDBACK_OPT_MAX] = { 0 };
-
-	uint32_t sn_bits;
-	size_t sn_bits_nr;
-
-	assert(remain_len >= 2);
+	struct rohc_comp_feedback_2 feedback2;
 
-	/* retrieve requested mode acked SN */
-	feedback2 = (const struct rohc_feedback_2_rfc3095 *) remain_data;
-	sn_bits = (feedback2->sn1 << 8) | feedback2->sn2;
-	sn_bits_nr = 4 + 8;
-	remain_data += 2;
-	remain_len -= 2;
-
-	/* parse FEEDBACK-2 options */
-	if(!rohc_comp_feedback_parse_opts(context, packet, packet_len,
-	                                  remain_data, remain_len, opts_present,
-	                                  &sn_bits, &sn_bits_nr,
-	                                  ROHC_FEEDBACK_WITH_CRC_OPT, 0, 0))
+	/* parse FEEDBACK-2 base header and options, check CRC */
+	if(!rohc_comp_feedback_parse_2(context, packet, packet_len,
+	                               feedback_data, feedback_data_len,
+	                               ROHC_FEEDBACK_WITH_CRC_OPT, &feedback2))
 	{
 		rohc_comp_warn(context, "malformed FEEDBACK-2: failed to parse options");
 		goto error;
 	}
 
 	/* change mode if present in feedback */
-	if(feedback2->mode != 0)
+	if(feedback2.mode != 0)
 	{
 		rohc_comp_debug(context, "FEEDBACK-2: decompressor asks for %s (%d)",
-		                rohc_get_mode_descr(feedback2->mode), feedback2->mode);
+		                rohc_get_mode_descr(feedback2.mode), feedback2.mode);
 
-		if(feedback2->mode != context->mode)
+		if(feedback2.mode != context->mode)
 		{
 			/* TODO: implement transition restrictions:
 			 *  - RFC 3095, §5.6.3: transition from O-mode to R-mode
@@ -879,13 +899,13 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			 */
 			rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 			          "mode change (%d -> %d) requested by feedback for CID %u",
-			          context->mode, feedback2->mode, context->cid);
+			          context->mode, feedback2.mode, context->cid);
 
 			/* RFC 3095, §5.6.1: mode can be changed only if feedback is protected
 			 * by a CRC */
-			if(opts_present[ROHC_FEEDBACK_OPT_CRC] > 0)
+			if(feedback2.is_crc_present)
 			{
-				rohc_comp_change_mode(context, feedback2->mode);
+				rohc_comp_change_mode(context, feedback2.mode);
 			}
 			else
 			{
@@ -898,18 +918,19 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 	}
 
 	/* act according to the type of feedback */
-	switch(feedback2->ack_type)
+	switch(feedback2.ack_type)
 	{
 		case ROHC_FEEDBACK_ACK:
 		{
-			const bool sn_not_valid = !!(opts_present[ROHC_FEEDBACK_OPT_SN_NOT_VALID] > 0);
+			const bool sn_not_valid = feedback2.sn_not_valid;
 
-			rohc_comp_debug(context, "ACK received (CID = %u, %zu-bit SN = 0x%x, "
-			                "SN-not-valid = %d)", context->cid, sn_bits_nr, sn_bits,
-			                GET_REAL(sn_not_valid));
+			rohc_comp_debug(context, "ACK received (CID = %u, %u-bit SN = 0x%x, "
+			                "SN-not-valid = %d)", context->cid, feedback2.sn_bits_nr,
+			                feedback2.sn_bits, GET_REAL(sn_not_valid));
 
 			/* the compressor received a positive ACK */
-			rohc_comp_rfc3095_feedback_ack(context, sn_bits, sn_bits_nr, sn_not_valid);
+			rohc_comp_rfc3095_feedback_ack(context, feedback2.sn_bits,
+			                               feedback2.sn_bits_nr, sn_not_valid);
 			break;
 		}
 		case ROHC_FEEDBACK_NACK:
@@ -922,6 +943,10 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 			}
+			/* the link loses packets, so widen the W-LSB windows and repeat
+			 * the changes more */
+			rohc_comp_rfc3095_set_wlsb_width(context, rohc_comp_wlsb_width_on_nack(context));
+			rohc_comp_oa_on_nack(context);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -933,6 +958,10 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			          "STATIC-NACK received for CID %u", context->cid);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+			/* the link loses packets, so widen the W-LSB windows and repeat
+			 * the changes more */
+			rohc_comp_rfc3095_set_wlsb_width(context, rohc_comp_wlsb_width_on_nack(context));
+			rohc_comp_oa_on_nack(context);
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -947,7 +976,7 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 		{
 			/* impossible value */
 			rohc_comp_warn(context, "malformed FEEDBACK-2: unknown ACK type %u",
-			               feedback2->ack_type);
+			               feedback2.ack_type);
 			goto error;
 		}
 	}
@@ -972,17 +1001,53 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
                                            const size_t sn_bits_nr,
                                            const bool sn_not_valid)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	size_t ip_hdr_pos;
 
 	/* always ack MSN to detect cases for improved ACK(O) transitions */
 	if(!sn_not_valid)
 	{
+		const uint32_t sn_mask =
+			(sn_bits_nr < 32 ? ((1U << sn_bits_nr) - 1) : 0xffffffffUL);
 		const size_t acked_nr =
 			wlsb_ack(&rfc3095_ctxt->msn_non_acked, sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 		                "from MSN W-LSB", acked_nr);
+
+		/* adapt the W-LSB windows to the cadence of the ACKs */
+		rohc_comp_rfc3095_set_wlsb_width(context,
+			rohc_comp_wlsb_width_on_ack(context, (rfc3095_ctxt->sn - sn_bits) & sn_mask));
+
+		/* in O- and R-modes, the decompressor knows TS_STRIDE once it
+		 * acknowledged one of the last packets that all transmitted it, so
+		 * TS_SCALED may be sent at once (RFC 3095, §4.5.3) */
+		if(context->profile->id == ROHC_PROFILE_RTP &&
+		   context->mode != ROHC_U_MODE)
+		{
+			struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+			if(rtp_context->ts_sc.state == INIT_STRIDE &&
+			   ((rfc3095_ctxt->sn - sn_bits) & sn_mask) <
+			   rtp_context->ts_sc.nr_init_stride_packets)
+			{
+				rohc_comp_debug(context, "ACK of SN %u confirms TS_STRIDE %u, "
+				                "send TS_SCALED from now on", sn_bits,
+				                rtp_context->ts_sc.ts_stride);
+				rtp_context->ts_sc.state = SEND_SCALED;
+			}
+
+			/* same for TIME_STRIDE and the timer-based encoding of TS_SCALED */
+			if(rohc_ts_sc_send_time_stride(&rtp_context->ts_sc) &&
+			   ((rfc3095_ctxt->sn - sn_bits) & sn_mask) <
+			   rtp_context->ts_sc.nr_init_time_stride_packets)
+			{
+				rohc_comp_debug(context, "ACK of SN %u confirms TIME_STRIDE %u ms, "
+				                "use the timer-based encoding from now on", sn_bits,
+				                rtp_context->ts_sc.time_stride);
+				rtp_context->ts_sc.send_time_stride = false;
+			}
+		}
 	}
 
 	if(context->mode == ROHC_U_MODE)
@@ -1141,13 +1206,55 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Change the width of the W-LSB windows used to encode the packets
+ *
+ * The window of the non-acknowledged MSNs keeps its width: it tells which
+ * context-updating packets were acknowledged.
+ *
+ * @param context  The compression context
+ * @param width    The new width of the W-LSB windows
+ */
+static void rohc_comp_rfc3095_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                             const size_t width)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	size_t ip_hdr_pos;
+
+	if(width == rfc3095_ctxt->sn_window.window_width)
+	{
+		return;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		struct ip_header_info *const ip_ctxt = &(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
+
+		if(ip_ctxt->version == IPV4)
+		{
+			wlsb_set_width(&ip_ctxt->info.v4.ip_id_window, width);
+		}
+	}
+	wlsb_set_width(&rfc3095_ctxt->sn_window, width);
+	if(context->profile->id == ROHC_PROFILE_RTP)
+	{
+		struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+		wlsb_set_width(&rtp_context->ts_sc.ts_scaled_wlsb, width);
+		wlsb_set_width(&rtp_context->ts_sc.ts_unscaled_wlsb, width);
+		wlsb_set_width(&rtp_context->ts_sc.time_offsets_wlsb, width);
+	}
+}
+
+
 /**
  * @brief Detect changes between packet and context
  *
  * @param context          The compression context to compare
  * @param uncomp_pkt_hdrs  The uncompressed headers to encode
+ * @return                 true if changes were successfully detected,
+ *                         false otherwise
  */
-static void rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const context,
+static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const context,
                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt =
@@ -1175,7 +1282,10 @@ static void rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 		struct rfc3095_ip_hdr_changes *const ip_hdr_changes =
 			&(rfc3095_ctxt->tmp.ip_hdr_changes[ip_hdr_pos]);
 
-		detect_ip_changes(context, ip_ctxt, ip_hdr, ip_hdr_changes);
+		if(!detect_ip_changes(context, ip_ctxt, ip_hdr, ip_hdr_changes))
+		{
+			goto error;
+		}
 
 		if(ip_hdr_changes->tos_tc_just_changed)
 		{
@@ -1207,6 +1317,11 @@ static void rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 			}
 		}
 	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -1222,7 +1337,7 @@ static void rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
  */
 void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const rohc_comp_state_t curr_state = context->state;
 	rohc_comp_state_t next_state;
 
@@ -1368,25 +1483,9 @@ static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 		}
 		rohc_comp_debug(context, "extension '%s' chosen", rohc_get_ext_descr(extension));
 
-		if(packet == ROHC_PACKET_UO_1_ID && extension != ROHC_EXT_NONE)
-		{
-			packet = ROHC_PACKET_UO_1_ID_EXT0 + extension;
-		}
-		else if(packet == ROHC_PACKET_UOR_2 && extension != ROHC_EXT_NONE)
-		{
-			packet = ROHC_PACKET_UOR_2_EXT0 + extension;
-		}
-		else if(packet == ROHC_PACKET_UOR_2_RTP && extension != ROHC_EXT_NONE)
-		{
-			packet = ROHC_PACKET_UOR_2_RTP_EXT0 + extension;
-		}
-		else if(packet == ROHC_PACKET_UOR_2_ID && extension != ROHC_EXT_NONE)
-		{
-			packet = ROHC_PACKET_UOR_2_ID_EXT0 + extension;
-		}
-		else if(packet == ROHC_PACKET_UOR_2_TS && extension != ROHC_EXT_NONE)
+		if(extension != ROHC_EXT_NONE)
 		{
-			packet = ROHC_PACKET_UOR_2_TS_EXT0 + extension;
+			packet = rohc_ext_get_ext0_packet(packet) + extension;
 		}
 		rohc_comp_debug(context, "packet '%s' chosen", rohc_get_packet_descr(packet));
 	}
@@ -1609,13 +1708,14 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	rohc_pkt[counter] = 0;
 	counter++;
 
-	/* part 6: static part */
-	ret = rohc_code_static_part(context, uncomp_pkt_hdrs, rohc_pkt, counter);
+	/* part 6: static part, built for the first IR packet of the context only */
+	ret = rohc_comp_code_static_chain(context, uncomp_pkt_hdrs, rohc_pkt, counter,
+	                                  rohc_pkt_max_len, rohc_code_static_part);
 	if(ret < 0)
 	{
 		goto error;
 	}
-	counter = ret;
+	counter += ret;
 
 	/* part 7: if we do not want dynamic part in IR packet, we should not
 	 * send the following */
@@ -1640,8 +1740,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	}
 
 	/* part 5 */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                       CRC_INIT_8);
+	rohc_pkt[crc_position] = rohc_comp_ir_crc(context, rohc_pkt, counter);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -1784,8 +1883,9 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 	}
 
 	/* part 5 */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                       CRC_INIT_8);
+	rohc_pkt[crc_position] = crc_engine_calc(&context->compressor->crc_engine,
+	                                         ROHC_CRC_TYPE_8, rohc_pkt, counter,
+	                                         CRC_INIT_8);
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -1805,17 +1905,19 @@ error:
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
- * @param rohc_pkt          The ROHC buffer
- * @param counter           The current position in the ROHC buffer
- * @return                  The new position in the ROHC buffer
+ * @param rohc_data         The ROHC buffer
+ * @param rohc_max_len      The maximum length of the ROHC buffer
+ * @return                  The length of the static part if successful,
+ *                          -1 otherwise
  */
 static int rohc_code_static_part(const struct rohc_comp_ctxt *const context,
                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                 uint8_t *const rohc_pkt,
-                                 int counter)
+                                 uint8_t *const rohc_data,
+                                 const size_t rohc_max_len __attribute__((unused)))
 {
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
+	int counter = 0;
 	size_t ip_hdr_pos;
 	int ret;
 
@@ -1828,7 +1930,7 @@ static int rohc_code_static_part(const struct rohc_comp_ctxt *const context,
 			&(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
 
 		ret = rohc_code_static_ip_part(context, ip_ctxt, pkt_ip_hdr,
-		                               rohc_pkt, counter);
+		                               rohc_data, counter);
 		if(ret < 0)
 		{
 			goto error;
@@ -1840,7 +1942,7 @@ static int rohc_code_static_part(const struct rohc_comp_ctxt *const context,
 	if(rfc3095_ctxt->code_static_part != NULL && uncomp_pkt_hdrs->transport != NULL)
 	{
 		ret = rfc3095_ctxt->code_static_part(context, uncomp_pkt_hdrs->transport,
-		                                     rohc_pkt, counter);
+		                                     rohc_data, counter);
 		if(ret < 0)
 		{
 			goto error;
@@ -2353,7 +2455,7 @@ static int code_uo_remainder(struct rohc_comp_ctxt *const context,
 	size_t outer_ip_hdr_pos;
 	size_t inner_ip_hdr_pos;
 
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		inner_ip_hdr_pos = 0;
 	}
@@ -2364,7 +2466,7 @@ static int code_uo_remainder(struct rohc_comp_ctxt *const context,
 	}
 
 	/* parts 6: IP-ID of outer IPv4 header if RND2=1 */
-	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	if(rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt) &&
 	   rfc3095_ctxt->ip_ctxts[outer_ip_hdr_pos].version == IPV4 &&
 	   rfc3095_ctxt->ip_ctxts[outer_ip_hdr_pos].info.v4.rnd == 1)
 	{
@@ -2543,7 +2645,7 @@ static int rohc_comp_rfc3095_build_uo1_pkt(struct rohc_comp_ctxt *const context,
                                            const size_t rohc_pkt_max_len,
                                            const rohc_packet_t packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const bool is_rtp = !!(context->profile->id == ROHC_PROFILE_RTP);
@@ -2832,7 +2934,7 @@ static int rohc_comp_rfc3095_build_uo1ts_pkt(struct rohc_comp_ctxt *const contex
                                              const size_t rohc_pkt_max_len,
                                              const rohc_packet_t packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const struct sc_rtp_context *const rtp_context =
@@ -2992,7 +3094,7 @@ static int rohc_comp_rfc3095_build_uo1id_pkt(struct rohc_comp_ctxt *const contex
                                              const size_t rohc_pkt_max_len,
                                              const rohc_packet_t packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	struct sc_rtp_context *const rtp_context =
@@ -3484,8 +3586,8 @@ static int code_UO2_packet(struct rohc_comp_ctxt *const context,
 	/* part 5: partially calculate the third byte, then remember the position
 	 *         of the third byte, its final value is currently unknown
 	 *
-	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
-	 * if the CRC-STATIC fields did not change */
+	 * The CRC is computed only on the CRC-DYNAMIC fields if the CRC-STATIC
+	 * fields did not change, see compute_uo_crc() */
 	t_byte = compute_uo_crc(context, uncomp_pkt_hdrs, ROHC_CRC_TYPE_7, CRC_INIT_7);
 	t_byte_position = counter;
 	counter++;
@@ -4225,7 +4327,7 @@ static int code_UOR2_ID_bytes(const struct rohc_comp_ctxt *const context,
                               uint8_t *const s_byte,
                               uint8_t *const t_byte)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
 
@@ -4939,7 +5041,7 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
                                 int counter,
                                 const rohc_packet_t packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = /* TODO: const */
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const bool is_rtp = (context->profile->id == ROHC_PROFILE_RTP);
@@ -4982,7 +5084,7 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
 	 * values of the I and I2 flags for additional non-random IP-ID bits */
 	rohc_comp_rfc3095_get_ext3_I_flags(context, uncomp_pkt_hdrs, packet_type,
 	                                   &innermost_ipv4_non_rnd, &I, &I2);
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		inner_ip = &uncomp_pkt_hdrs->ip_hdrs[0];
 		inner_ip_ctxt = &rfc3095_ctxt->ip_ctxts[0];
@@ -5057,7 +5159,8 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
 	 *    base header (UO-1-ID only),
 	 *  - RTP eXtension bit changed in this packet,
 	 *  - RTP eXtension bit changed in the last few packets,
-	 *  - RTP TS and TS_STRIDE must be initialized.
+	 *  - RTP TS and TS_STRIDE must be initialized,
+	 *  - TIME_STRIDE must be transmitted.
 	 */
 	rtp = (rtp_context->tmp.rtp_pt_changed ||
 	       rtp_context->rtp_pt_change_count < oa_repetitions_nr ||
@@ -5066,10 +5169,11 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
 	       (packet_type == ROHC_PACKET_UO_1_ID_EXT3 && rtp_context->tmp.is_marker_bit_set) ||
 	       rtp_context->tmp.ext_bit_changed ||
 	       rtp_context->rtp_extension_change_count < oa_repetitions_nr ||
-	       (rtp_context->ts_sc.state == INIT_STRIDE));
+	       (rtp_context->ts_sc.state == INIT_STRIDE) ||
+	       rohc_ts_sc_send_time_stride(&rtp_context->ts_sc));
 
 	/* ip2 bit (force ip2=1 if I2=1, otherwise I2 is not sent) */
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		ip2 = 0;
 	}
@@ -5291,7 +5395,7 @@ static int code_EXT3_nortp_packet(struct rohc_comp_ctxt *const context,
 	 * values of the I and I2 flags for additional non-random IP-ID bits */
 	rohc_comp_rfc3095_get_ext3_I_flags(context, uncomp_pkt_hdrs, packet_type,
 	                                   &innermost_ipv4_non_rnd, &I, &I2);
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		inner_ip = &uncomp_pkt_hdrs->ip_hdrs[0];
 		inner_ip_ctxt = &rfc3095_ctxt->ip_ctxts[0];
@@ -5314,7 +5418,7 @@ static int code_EXT3_nortp_packet(struct rohc_comp_ctxt *const context,
 	S = !rfc3095_ctxt->tmp.sn_5bits_possible;
 
 	/* ip2 bit (force ip2=1 if I2=1, otherwise I2 is not sent) */
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		ip2 = 0;
 	}
@@ -5462,7 +5566,7 @@ static int code_EXT3_nortp_packet(struct rohc_comp_ctxt *const context,
                          2 = Bidirectional Optimistic,
                          3 = Bidirectional Reliable.
 
- Parts 3 & 5 are not supported yet.
+ Part 3 is not supported yet.
 
 \endverbatim
  *
@@ -5480,10 +5584,11 @@ static int rtp_header_flags_and_fields(const struct rohc_comp_ctxt *const contex
                                        uint8_t *const dest,
                                        int counter)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
 	int tss;
+	int tis;
 	int rpt;
 	uint8_t byte;
 
@@ -5496,12 +5601,14 @@ static int rtp_header_flags_and_fields(const struct rohc_comp_ctxt *const contex
 	       rtp_context->tmp.padding_bit_changed ||
 	       rtp_context->rtp_padding_change_count < oa_repetitions_nr);
 	tss = (rtp_context->ts_sc.state == INIT_STRIDE);
+	tis = rohc_ts_sc_send_time_stride(&rtp_context->ts_sc);
 	byte = 0;
 	byte |= (context->mode & 0x03) << 6;
 	byte |= (rpt & 0x01) << 5;
 	byte |= (uncomp_pkt_hdrs->rtp->m & 0x01) << 4;
 	byte |= (uncomp_pkt_hdrs->rtp->extension & 0x01) << 3;
 	byte |= (tss & 0x01) << 1;
+	byte |= tis & 0x01;
 	rohc_comp_debug(context, "RTP flags = 0x%x", byte);
 	dest[counter] = byte;
 	counter++;
@@ -5577,7 +5684,27 @@ static int rtp_header_flags_and_fields(const struct rohc_comp_ctxt *const contex
 		}
 	}
 
-	/* part 5: not supported yet */
+	/* part 5 */
+	if(tis)
+	{
+		const uint32_t time_stride = rtp_context->ts_sc.time_stride;
+		size_t sdvl_size;
+
+		/* TIME_STRIDE was checked for SDVL encoding when estimated */
+		if(!sdvl_encode_full(dest + counter, 4U /* TODO */, &sdvl_size,
+		                     time_stride))
+		{
+			rohc_comp_warn(context, "TIME_STRIDE too large for SDVL (%u)",
+			               time_stride);
+			goto error;
+		}
+		counter += sdvl_size;
+
+		rohc_comp_debug(context, "TIME_STRIDE %u ms is SDVL-encoded on %zd "
+		                "byte(s)", time_stride, sdvl_size);
+
+		c_ts_sc_time_stride_sent(&rtp_context->ts_sc, oa_repetitions_nr);
+	}
 
 	return counter;
 
@@ -5801,7 +5928,8 @@ static uint8_t compute_uo_crc(struct rohc_comp_ctxt *const context,
 	}
 	else
 	{
-		crc = rfc3095_ctxt->compute_crc_static(uncomp_pkt_hdrs, crc_type, crc);
+		crc = rfc3095_ctxt->compute_crc_static(&context->compressor->crc_engine,
+		                                       uncomp_pkt_hdrs, crc_type, crc);
 		rohc_comp_debug(context, "compute CRC-STATIC-%d = 0x%x from packet",
 		                crc_type, crc);
 
@@ -5821,7 +5949,8 @@ static uint8_t compute_uo_crc(struct rohc_comp_ctxt *const context,
 	}
 
 	/* compute CRC on CRC-DYNAMIC fields */
-	crc = rfc3095_ctxt->compute_crc_dynamic(uncomp_pkt_hdrs, crc_type, crc);
+	crc = rfc3095_ctxt->compute_crc_dynamic(&context->compressor->crc_engine,
+	                                        uncomp_pkt_hdrs, crc_type, crc);
 	rohc_comp_debug(context, "compute CRC-%d = 0x%x from packet",
 	                crc_type, crc);
 
@@ -5897,6 +6026,19 @@ static void update_context_ip_hdr(const struct rohc_comp_ctxt *const context,
 }
 
 
+/** The IPv4 fields that \ref detect_ip_changes tracks: TOS, DF and TTL */
+static const uint8_t rohc_comp_rfc3095_ipv4_mask[sizeof(struct ipv4_hdr)] = {
+	0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00,
+	0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00,
+};
+
+/** The IPv6 fields that \ref detect_ip_changes tracks: TC and HL */
+static const uint8_t rohc_comp_rfc3095_ipv6_mask[sizeof(struct ipv6_hdr)] = {
+	0x0f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+};
+
+
 /**
  * @brief Find the IP fields that changed between the profile and a new
  *        IP packet.
@@ -5905,39 +6047,73 @@ static void update_context_ip_hdr(const struct rohc_comp_ctxt *const context,
  * @param header_info    The header info stored in the profile
  * @param ip             The header of the new IP packet
  * @param[out] changes   The detected changes
+ * @return               true if changes were successfully detected,
+ *                       false otherwise
  */
-static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
+static bool detect_ip_changes(const struct rohc_comp_ctxt *const context,
                               /* TODO: const */ struct ip_header_info *const header_info,
                               const struct rohc_pkt_ip_hdr *const ip,
                               struct rfc3095_ip_hdr_changes *const changes)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
-	uint8_t old_tos;
-	uint8_t old_ttl;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
+	bool hdr_changed;
 
+	/* compare the TOS/TC, TTL/HL and DF fields with the previous IP header at
+	 * once, then compare them one by one only if one of them changed */
 	if(ip->version == IPV4)
 	{
-		const struct ipv4_hdr *old_ip;
+		const struct ipv4_hdr *const old_ip = &header_info->info.v4.old_ip;
 
-		old_ip = &header_info->info.v4.old_ip;
-		old_tos = old_ip->tos;
-		old_ttl = old_ip->ttl;
+		hdr_changed =
+			rohc_hdr_image_changed((const uint8_t *) ip->ipv4,
+			                       (const uint8_t *) old_ip,
+			                       rohc_comp_rfc3095_ipv4_mask,
+			                       sizeof(struct ipv4_hdr));
+		if(!hdr_changed)
+		{
+			changes->tos_tc_just_changed = false;
+			changes->ttl_hl_just_changed = false;
+			changes->df_just_changed = false;
+		}
+		else
+		{
+			changes->tos_tc_just_changed = !!(old_ip->tos != ip->tos_tc);
+			changes->ttl_hl_just_changed = !!(old_ip->ttl != ip->ttl_hl);
+			changes->df_just_changed = !!(old_ip->df != ip->ipv4->df);
+			rohc_comp_debug(context, "TOS 0x%02x -> 0x%02x, TTL %u -> %u, "
+			                "DF %u -> %u", old_ip->tos, ip->tos_tc, old_ip->ttl,
+			                ip->ttl_hl, old_ip->df, ip->ipv4->df);
+		}
 	}
 	else /* IPV6 */
 	{
-		const struct ipv6_hdr *old_ip;
+		const struct ipv6_hdr *const old_ip = &header_info->info.v6.old_ip;
 
-		old_ip = &header_info->info.v6.old_ip;
-		old_tos = ipv6_get_tc(old_ip);
-		old_ttl = old_ip->hl;
+		hdr_changed =
+			rohc_hdr_image_changed((const uint8_t *) ip->ipv6,
+			                       (const uint8_t *) old_ip,
+			                       rohc_comp_rfc3095_ipv6_mask,
+			                       sizeof(struct ipv6_hdr));
+		if(!hdr_changed)
+		{
+			changes->tos_tc_just_changed = false;
+			changes->ttl_hl_just_changed = false;
+		}
+		else
+		{
+			changes->tos_tc_just_changed = !!(ipv6_get_tc(old_ip) != ip->tos_tc);
+			changes->ttl_hl_just_changed = !!(old_ip->hl != ip->ttl_hl);
+			rohc_comp_debug(context, "TC 0x%02x -> 0x%02x, HL %u -> %u",
+			                ipv6_get_tc(old_ip), ip->tos_tc, old_ip->hl, ip->ttl_hl);
+		}
+		/* no DF for IPv6 */
+		changes->df_just_changed = false;
 	}
 
 	/* detect changes of IPv4 TOS or IPv6 TC */
-	changes->tos_tc_just_changed = !!(old_tos != ip->tos_tc);
 	if(changes->tos_tc_just_changed)
 	{
-		rohc_comp_debug(context, "TOS/TC changed from 0x%02x to 0x%02x",
-		                old_tos, ip->tos_tc);
+		rohc_comp_debug(context, "TOS/TC just changed");
 		changes->tos_tc_changed = true;
 	}
 	else if(header_info->tos_count < oa_repetitions_nr)
@@ -5952,11 +6128,9 @@ static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
 	}
 
 	/* detect changes of IPv4 TTL or IPv6 HL */
-	changes->ttl_hl_just_changed = !!(old_ttl != ip->ttl_hl);
 	if(changes->ttl_hl_just_changed)
 	{
-		rohc_comp_debug(context, "TTL/HL changed from 0x%02x to 0x%02x",
-		                old_ttl, ip->ttl_hl);
+		rohc_comp_debug(context, "TTL/HL just changed");
 		changes->ttl_hl_changed = true;
 	}
 	else if(header_info->ttl_count < oa_repetitions_nr)
@@ -5972,16 +6146,10 @@ static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
 	/* IPv4 flags related to IP-ID */
 	if(ip->version == IPV4)
 	{
-		uint8_t old_df;
-		uint8_t df;
-
 		/* check the Don't Fragment flag for change (IPv4 only) */
-		df = ip->ipv4->df;
-		old_df = header_info->info.v4.old_ip.df;
-		changes->df_just_changed = !!(df != old_df);
 		if(changes->df_just_changed)
 		{
-			rohc_comp_debug(context, "DF changed from %u to %u", old_df, df);
+			rohc_comp_debug(context, "DF just changed");
 			changes->df_changed = true;
 		}
 		else if(header_info->info.v4.df_count < oa_repetitions_nr)
@@ -6060,8 +6228,13 @@ static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
 		bool list_struct_changed;
 		bool list_content_changed;
 
-		detect_ipv6_ext_changes(&header_info->info.v6.ext_comp, ip,
-		                        &list_struct_changed, &list_content_changed);
+		if(!detect_ipv6_ext_changes(&header_info->info.v6.ext_comp, ip,
+		                            &list_struct_changed, &list_content_changed))
+		{
+			rohc_comp_warn(context, "failed to detect changes in the list of "
+			               "IPv6 extension headers");
+			goto error;
+		}
 
 		changes->ext_list_struct_changed = list_struct_changed;
 		if(changes->ext_list_struct_changed)
@@ -6085,6 +6258,11 @@ static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
 		changes->sid_just_changed = false;
 		changes->sid_changed = false;
 	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -6249,57 +6427,53 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		                rfc3095_ctxt->sn);
 		if(context->profile->id == ROHC_PROFILE_RTP)
 		{
+			/* p depends on k for RTP SN, so walk the window only once to get the
+			 * range of offsets, then check every k */
+			struct wlsb_range sn_range;
+
+			wlsb_get_range_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+			                      &sn_range);
 			rfc3095_ctxt->tmp.sn_4bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           4, rohc_interval_compute_p_rtp_sn(4));
+				wlsb_range_is_kp_possible(&sn_range, 4, rohc_interval_compute_p_rtp_sn(4));
 			rfc3095_ctxt->tmp.sn_7bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           7, rohc_interval_compute_p_rtp_sn(7));
+				wlsb_range_is_kp_possible(&sn_range, 7, rohc_interval_compute_p_rtp_sn(7));
 			rfc3095_ctxt->tmp.sn_12bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           12, rohc_interval_compute_p_rtp_sn(12));
+				wlsb_range_is_kp_possible(&sn_range, 12, rohc_interval_compute_p_rtp_sn(12));
 
 			rfc3095_ctxt->tmp.sn_6bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           6, rohc_interval_compute_p_rtp_sn(6));
+				wlsb_range_is_kp_possible(&sn_range, 6, rohc_interval_compute_p_rtp_sn(6));
 			rfc3095_ctxt->tmp.sn_9bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           9, rohc_interval_compute_p_rtp_sn(9));
+				wlsb_range_is_kp_possible(&sn_range, 9, rohc_interval_compute_p_rtp_sn(9));
 			rfc3095_ctxt->tmp.sn_14bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           14, rohc_interval_compute_p_rtp_sn(14));
+				wlsb_range_is_kp_possible(&sn_range, 14, rohc_interval_compute_p_rtp_sn(14));
 		}
 		else if(context->profile->id == ROHC_PROFILE_ESP)
 		{
+			struct wlsb_range sn_range;
+
 			rfc3095_ctxt->tmp.sn_4bits_possible =
 				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
 				                           4, rohc_interval_compute_p_esp_sn(4));
 
+			wlsb_get_range_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+			                      &sn_range);
 			rfc3095_ctxt->tmp.sn_5bits_possible =
-				wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           5, rohc_interval_compute_p_esp_sn(5));
+				wlsb_range_is_kp_possible(&sn_range, 5, rohc_interval_compute_p_esp_sn(5));
 			rfc3095_ctxt->tmp.sn_8bits_possible =
-				wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           8, rohc_interval_compute_p_esp_sn(8));
+				wlsb_range_is_kp_possible(&sn_range, 8, rohc_interval_compute_p_esp_sn(8));
 			rfc3095_ctxt->tmp.sn_13bits_possible =
-				wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           13, rohc_interval_compute_p_esp_sn(13));
+				wlsb_range_is_kp_possible(&sn_range, 13, rohc_interval_compute_p_esp_sn(13));
 		}
 		else
 		{
-			rfc3095_ctxt->tmp.sn_4bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           4, ROHC_LSB_SHIFT_SN);
+			const size_t sn_min_bits_nr =
+				wlsb_get_minkp_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+				                      ROHC_LSB_SHIFT_SN);
 
-			rfc3095_ctxt->tmp.sn_5bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           5, ROHC_LSB_SHIFT_SN);
-			rfc3095_ctxt->tmp.sn_8bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           8, ROHC_LSB_SHIFT_SN);
-			rfc3095_ctxt->tmp.sn_13bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           13, ROHC_LSB_SHIFT_SN);
+			rfc3095_ctxt->tmp.sn_4bits_possible = (sn_min_bits_nr <= 4);
+			rfc3095_ctxt->tmp.sn_5bits_possible = (sn_min_bits_nr <= 5);
+			rfc3095_ctxt->tmp.sn_8bits_possible = (sn_min_bits_nr <= 8);
+			rfc3095_ctxt->tmp.sn_13bits_possible = (sn_min_bits_nr <= 13);
 		}
 		if(rfc3095_ctxt->tmp.sn_4bits_possible)
 		{
@@ -6388,30 +6562,17 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 			else
 			{
 				/* send only required bits in FO or SO states */
-				ip_changes->ip_id_changed =
-					!wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                            ip_ctxt->info.v4.id_delta,
-					                            0, ROHC_LSB_SHIFT_IP_ID);
-				ip_changes->ip_id_3bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           3, ROHC_LSB_SHIFT_IP_ID);
-				ip_changes->ip_id_5bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           5, ROHC_LSB_SHIFT_IP_ID);
-				ip_changes->ip_id_6bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           6, ROHC_LSB_SHIFT_IP_ID);
-				ip_changes->ip_id_8bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           8, ROHC_LSB_SHIFT_IP_ID);
-				ip_changes->ip_id_11bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           11, ROHC_LSB_SHIFT_IP_ID);
+				const size_t ip_id_min_bits_nr =
+					wlsb_get_minkp_16bits(&ip_ctxt->info.v4.ip_id_window,
+					                      ip_ctxt->info.v4.id_delta,
+					                      ROHC_LSB_SHIFT_IP_ID);
+
+				ip_changes->ip_id_changed = (ip_id_min_bits_nr > 0);
+				ip_changes->ip_id_3bits_possible = (ip_id_min_bits_nr <= 3);
+				ip_changes->ip_id_5bits_possible = (ip_id_min_bits_nr <= 5);
+				ip_changes->ip_id_6bits_possible = (ip_id_min_bits_nr <= 6);
+				ip_changes->ip_id_8bits_possible = (ip_id_min_bits_nr <= 8);
+				ip_changes->ip_id_11bits_possible = (ip_id_min_bits_nr <= 11);
 			}
 			rohc_comp_debug(context, "  %s bits are required to encode new IP-ID delta",
 			                ip_changes->ip_id_changed ? "some" : "no");
@@ -6453,6 +6614,259 @@ error:
 }
 
 
+/**
+ * @brief Encode the uncompressed fields of a steady flow for UO-0 packet
+ *
+ * Check whether the UO-0 packet that \ref c_ip_decide_SO_packet would choose
+ * in SO state may be sent: no IP field changed now or in the last few
+ * packets, 4 bits are enough for the SN and no IP-ID bit is required. Only
+ * the k values of the UO-0 packet are checked against the W-LSB windows,
+ * instead of the minimal k values for all the packet types as in
+ * \ref encode_uncomp_fields.
+ *
+ * The IP-ID / SN deltas are computed along the way for the update of the
+ * context. If the function returns false, \ref encode_uncomp_fields shall be
+ * called to encode the fields in the generic way.
+ *
+ * @param context          The compression context
+ * @param uncomp_pkt_hdrs  The uncompressed headers to encode
+ * @return                 true if the UO-0 packet may be sent,
+ *                         false if the generic way shall be used
+ */
+static bool encode_uncomp_fields_uo0(struct rohc_comp_ctxt *const context,
+                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
+	size_t ip_hdr_pos;
+
+	/* 4 bits shall be enough for the SN, and the SN shall be transmittable
+	 * in the UOR-2 packet (that one is for the ESP profile only, the window
+	 * being walked with 32-bit arithmetic for the larger packets) */
+	if(context->profile->id == ROHC_PROFILE_ESP)
+	{
+		if(!wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+		                               4, rohc_interval_compute_p_esp_sn(4)) ||
+		   !wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+		                               13, rohc_interval_compute_p_esp_sn(13)))
+		{
+			return false;
+		}
+	}
+	else if(!wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+	                                    4, ROHC_LSB_SHIFT_SN))
+	{
+		return false;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		struct ip_header_info *const ip_ctxt =
+			&(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
+		struct rfc3095_ip_hdr_changes *const ip_changes =
+			&(rfc3095_ctxt->tmp.ip_hdr_changes[ip_hdr_pos]);
+
+		/* no IP field shall have changed now or in the last few packets */
+		if(ip_changes->tos_tc_changed ||
+		   ip_changes->ttl_hl_changed ||
+		   ip_changes->df_changed ||
+		   ip_changes->ext_list_struct_changed ||
+		   ip_changes->ext_list_content_changed ||
+		   ip_changes->nbo_changed ||
+		   ip_changes->rnd_changed)
+		{
+			return false;
+		}
+
+		if(ip_ctxt->version == IPV4)
+		{
+			const uint16_t id = uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos].ipv4->id;
+			const bool is_little_endian =
+				(ip_ctxt->info.v4.rnd == 0 && ip_ctxt->info.v4.nbo == 0);
+			const uint16_t id_nbo = (is_little_endian ? swab16(id) : id);
+
+			if(ip_ctxt->info.v4.sid_count < oa_repetitions_nr)
+			{
+				return false;
+			}
+
+			/* no IP-ID bit shall be required if IP-ID is neither random nor
+			 * constant */
+			ip_ctxt->info.v4.id_delta = rohc_ntoh16(id_nbo) - rfc3095_ctxt->sn;
+			if(ip_ctxt->info.v4.rnd == 0 && ip_ctxt->info.v4.sid == 0 &&
+			   !wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
+			                               ip_ctxt->info.v4.id_delta, 0,
+			                               ROHC_LSB_SHIFT_IP_ID))
+			{
+				return false;
+			}
+			ip_changes->ip_id_changed = false;
+		}
+	}
+
+	return true;
+}
+
+
+/** The conditions that the extensions of UO-1-ID/UOR-2* packets may require */
+#define ROHC_EXT_COND_SN_4BITS             (1U <<  0)
+#define ROHC_EXT_COND_SN_5BITS             (1U <<  1)
+#define ROHC_EXT_COND_SN_6BITS             (1U <<  2)
+#define ROHC_EXT_COND_SN_7BITS             (1U <<  3)
+#define ROHC_EXT_COND_SN_8BITS             (1U <<  4)
+#define ROHC_EXT_COND_SN_9BITS             (1U <<  5)
+#define ROHC_EXT_COND_INNER_IPID_CHANGED   (1U <<  6)
+#define ROHC_EXT_COND_INNER_IPID_3BITS     (1U <<  7)
+#define ROHC_EXT_COND_INNER_IPID_5BITS     (1U <<  8)
+#define ROHC_EXT_COND_INNER_IPID_8BITS     (1U <<  9)
+#define ROHC_EXT_COND_INNER_IPID_11BITS    (1U << 10)
+#define ROHC_EXT_COND_OUTER_IPID_CHANGED   (1U << 11)
+#define ROHC_EXT_COND_OUTER_IPID_11BITS    (1U << 12)
+#define ROHC_EXT_COND_TWO_IP_HDRS          (1U << 13)
+#define ROHC_EXT_COND_TS_DEDUCIBLE         (1U << 14)
+#define ROHC_EXT_COND_MARKER               (1U << 15)
+
+/** Shorter names for the conditions in the rules below */
+#define EXT_SN(n)  ROHC_EXT_COND_SN_##n##BITS
+#define EXT_IIC    ROHC_EXT_COND_INNER_IPID_CHANGED
+#define EXT_II(n)  ROHC_EXT_COND_INNER_IPID_##n##BITS
+#define EXT_OIC    ROHC_EXT_COND_OUTER_IPID_CHANGED
+#define EXT_OI11   ROHC_EXT_COND_OUTER_IPID_11BITS
+#define EXT_2IP    ROHC_EXT_COND_TWO_IP_HDRS
+#define EXT_TSD    ROHC_EXT_COND_TS_DEDUCIBLE
+#define EXT_M      ROHC_EXT_COND_MARKER
+
+/** The number of rules per packet type: no extension, EXT-0, EXT-1, EXT-2 */
+#define ROHC_EXT_RULES_NR  4U
+
+
+/**
+ * @brief One rule to choose the extension of one UO-1-ID/UOR-2* packet
+ *
+ * The rule matches if all the required conditions are fulfilled, none of the
+ * forbidden ones is, and the TS bits fit in the packet with the extension.
+ */
+struct rohc_ext_rule
+{
+	uint32_t required;    /**< The ROHC_EXT_COND_* that shall be fulfilled */
+	uint32_t forbidden;   /**< The ROHC_EXT_COND_* that shall not be fulfilled */
+	uint8_t ts_bits_max;  /**< The maximum number of TS bits */
+	rohc_ext_t ext;       /**< The extension chosen if the rule matches */
+};
+
+/** Define one rule of the extension decision tables */
+#define EXT_RULE(_ext, _required, _forbidden, _ts_bits_max) \
+	{ .required = (_required), .forbidden = (_forbidden), \
+	  .ts_bits_max = (_ts_bits_max), .ext = (_ext) }
+
+
+/** The extension rules for the UOR-2 packet (non-RTP profiles) */
+static const struct rohc_ext_rule rohc_ext_rules_uor2[ROHC_EXT_RULES_NR] = {
+	EXT_RULE(ROHC_EXT_NONE, EXT_SN(5), EXT_IIC | EXT_OIC, 32),
+	EXT_RULE(ROHC_EXT_0, EXT_SN(8) | EXT_IIC | EXT_II(3), EXT_OIC, 32),
+	EXT_RULE(ROHC_EXT_1, EXT_SN(8) | EXT_IIC | EXT_II(11), EXT_OIC, 32),
+	EXT_RULE(ROHC_EXT_2, EXT_2IP | EXT_SN(8) | EXT_IIC | EXT_II(8) | EXT_OI11, 0, 32),
+};
+
+/** The extension rules for the UOR-2-RTP packet */
+static const struct rohc_ext_rule rohc_ext_rules_uor2rtp[ROHC_EXT_RULES_NR] = {
+	EXT_RULE(ROHC_EXT_NONE, EXT_SN(6), EXT_IIC | EXT_OIC,  6),
+	EXT_RULE(ROHC_EXT_0,    EXT_SN(9), EXT_IIC | EXT_OIC,  9),
+	EXT_RULE(ROHC_EXT_1,    EXT_SN(9), EXT_IIC | EXT_OIC, 17),
+	EXT_RULE(ROHC_EXT_2,    EXT_SN(9), EXT_IIC | EXT_OIC, 25),
+};
+
+/** The extension rules for the UOR-2-TS packet */
+static const struct rohc_ext_rule rohc_ext_rules_uor2ts[ROHC_EXT_RULES_NR] = {
+	EXT_RULE(ROHC_EXT_NONE, EXT_SN(6), EXT_IIC | EXT_OIC,  5),
+	EXT_RULE(ROHC_EXT_0,    EXT_SN(9), EXT_IIC | EXT_OIC,  8),
+	EXT_RULE(ROHC_EXT_1,    EXT_SN(9) | EXT_II(8), EXT_OIC,  8),
+	EXT_RULE(ROHC_EXT_2,    EXT_SN(9) | EXT_II(8), EXT_OIC, 16),
+};
+
+/** The extension rules for the UOR-2-ID packet */
+static const struct rohc_ext_rule rohc_ext_rules_uor2id[ROHC_EXT_RULES_NR] = {
+	EXT_RULE(ROHC_EXT_NONE, EXT_SN(6) | EXT_TSD | EXT_II(5), EXT_OIC, 32),
+	EXT_RULE(ROHC_EXT_0,    EXT_SN(9) | EXT_TSD | EXT_II(8), EXT_OIC, 32),
+	EXT_RULE(ROHC_EXT_1,    EXT_SN(9) | EXT_II(8), EXT_OIC, 8),
+	EXT_RULE(ROHC_EXT_2,    EXT_SN(9), EXT_OIC, 8),
+};
+
+/** The extension rules for the UO-1-ID packet */
+static const struct rohc_ext_rule rohc_ext_rules_uo1id[ROHC_EXT_RULES_NR] = {
+	EXT_RULE(ROHC_EXT_NONE, EXT_SN(4) | EXT_TSD | EXT_II(5), EXT_OIC | EXT_M, 32),
+	EXT_RULE(ROHC_EXT_0,    EXT_SN(7) | EXT_TSD | EXT_II(8), EXT_OIC | EXT_M, 32),
+	EXT_RULE(ROHC_EXT_1,    EXT_SN(7) | EXT_II(8), EXT_OIC | EXT_M, 8),
+	EXT_RULE(ROHC_EXT_2,    EXT_SN(7), EXT_OIC | EXT_M, 8),
+};
+
+#undef EXT_RULE
+#undef EXT_SN
+#undef EXT_IIC
+#undef EXT_II
+#undef EXT_OIC
+#undef EXT_OI11
+#undef EXT_2IP
+#undef EXT_TSD
+#undef EXT_M
+
+
+/**
+ * @brief Get the packet type with EXT-0 for the given packet type
+ *
+ * The packet types with EXT-1, EXT-2 and EXT-3 follow the one with EXT-0.
+ *
+ * @param packet_type  The UO-1-ID or UOR-2* packet type without extension
+ * @return             The same packet type with EXT-0
+ */
+static rohc_packet_t rohc_ext_get_ext0_packet(const rohc_packet_t packet_type)
+{
+	switch(packet_type)
+	{
+		case ROHC_PACKET_UO_1_ID:
+			return ROHC_PACKET_UO_1_ID_EXT0;
+		case ROHC_PACKET_UOR_2:
+			return ROHC_PACKET_UOR_2_EXT0;
+		case ROHC_PACKET_UOR_2_RTP:
+			return ROHC_PACKET_UOR_2_RTP_EXT0;
+		case ROHC_PACKET_UOR_2_ID:
+			return ROHC_PACKET_UOR_2_ID_EXT0;
+		case ROHC_PACKET_UOR_2_TS:
+		default:
+			assert(packet_type == ROHC_PACKET_UOR_2_TS);
+			return ROHC_PACKET_UOR_2_TS_EXT0;
+	}
+}
+
+
+/**
+ * @brief Get the extension rules for the given packet type
+ *
+ * @param packet_type  The type of ROHC packet that is created
+ * @return             The ROHC_EXT_RULES_NR rules of the packet type,
+ *                     NULL if the packet type has no extension
+ */
+static const struct rohc_ext_rule *
+	rohc_ext_get_rules(const rohc_packet_t packet_type)
+{
+	switch(packet_type)
+	{
+		case ROHC_PACKET_UOR_2:
+			return rohc_ext_rules_uor2;
+		case ROHC_PACKET_UOR_2_RTP:
+			return rohc_ext_rules_uor2rtp;
+		case ROHC_PACKET_UOR_2_TS:
+			return rohc_ext_rules_uor2ts;
+		case ROHC_PACKET_UOR_2_ID:
+			return rohc_ext_rules_uor2id;
+		case ROHC_PACKET_UO_1_ID:
+			return rohc_ext_rules_uo1id;
+		default:
+			return NULL;
+	}
+}
+
+
 /**
  * @brief Decide what extension shall be used in the UO-1-ID/UOR-2 packet
  *
@@ -6470,16 +6884,9 @@ rohc_ext_t decide_extension(const struct rohc_comp_ctxt *const context,
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	const struct rfc3095_ip_hdr_changes *inner_ip_changes;
 	const struct rfc3095_ip_hdr_changes *outer_ip_changes;
-	bool innermost_ip_id_changed;
-	bool innermost_ip_id_3bits_possible;
-	bool innermost_ip_id_5bits_possible;
-	bool innermost_ip_id_8bits_possible;
-	bool innermost_ip_id_11bits_possible;
-	bool outermost_ip_id_changed;
-	bool outermost_ip_id_11bits_possible;
 	rohc_ext_t ext;
 
-	if(rfc3095_ctxt->ip_hdr_nr == 1)
+	if(!rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt))
 	{
 		inner_ip_changes = &rfc3095_ctxt->tmp.ip_hdr_changes[0];
 		outer_ip_changes = NULL;
@@ -6505,7 +6912,7 @@ rohc_ext_t decide_extension(const struct rohc_comp_ctxt *const context,
 		                "IP header");
 		ext = ROHC_EXT_3;
 	}
-	else if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	else if(rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt) &&
 	        (outer_ip_changes->tos_tc_changed ||
 	         outer_ip_changes->ttl_hl_changed ||
 	         outer_ip_changes->df_changed ||
@@ -6522,55 +6929,28 @@ rohc_ext_t decide_extension(const struct rohc_comp_ctxt *const context,
 	}
 	else
 	{
-		/* determine the number of IP-ID bits and the IP-ID offset of the
-		 * innermost IPv4 header with non-random IP-ID */
-		rohc_get_ipid_bits(context,
-		                   &innermost_ip_id_changed,
-		                   &innermost_ip_id_3bits_possible,
-		                   &innermost_ip_id_5bits_possible,
-		                   &innermost_ip_id_8bits_possible,
-		                   &innermost_ip_id_11bits_possible,
-		                   &outermost_ip_id_changed,
-		                   &outermost_ip_id_11bits_possible);
-
-		switch(packet_type)
-		{
-			case ROHC_PACKET_UOR_2:
-				ext = decide_extension_uor2(context,
-				                            innermost_ip_id_changed,
-				                            innermost_ip_id_3bits_possible,
-				                            innermost_ip_id_8bits_possible,
-				                            innermost_ip_id_11bits_possible,
-				                            outermost_ip_id_changed,
-				                            outermost_ip_id_11bits_possible);
-				break;
-			case ROHC_PACKET_UOR_2_RTP:
-				ext = decide_extension_uor2rtp(context,
-				                               innermost_ip_id_changed,
-				                               outermost_ip_id_changed);
-				break;
-			case ROHC_PACKET_UOR_2_TS:
-				ext = decide_extension_uor2ts(context,
-				                              innermost_ip_id_changed,
-				                              innermost_ip_id_8bits_possible,
-				                              outermost_ip_id_changed);
-				break;
-			case ROHC_PACKET_UOR_2_ID:
-				ext = decide_extension_uor2id(context,
-				                              innermost_ip_id_5bits_possible,
-				                              innermost_ip_id_8bits_possible,
-				                              outermost_ip_id_changed);
-				break;
-			case ROHC_PACKET_UO_1_ID:
-				ext = decide_extension_uo1id(context,
-				                              innermost_ip_id_5bits_possible,
-				                              innermost_ip_id_8bits_possible,
-				                              outermost_ip_id_changed);
-				break;
-			default:
-				rohc_assert(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-				            false, error, "bad packet type (%d)", packet_type);
+		const struct rohc_ext_rule *rules;
+		uint32_t conds;
+		uint8_t nr_ts_bits;
+		unsigned int matches = 0;
+		unsigned int i;
+
+		rules = rohc_ext_get_rules(packet_type);
+		rohc_assert(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		            rules != NULL, error, "bad packet type (%d)", packet_type);
+
+		/* evaluate all the rules of the packet type at once, then pick the
+		 * first one that matches, EXT-3 if none matches */
+		conds = rohc_ext_get_conds(context, packet_type, &nr_ts_bits);
+		for(i = 0; i < ROHC_EXT_RULES_NR; i++)
+		{
+			const bool match =
+				((conds & rules[i].required) == rules[i].required) &&
+				((conds & rules[i].forbidden) == 0) &&
+				nr_ts_bits <= rules[i].ts_bits_max;
+			matches |= ((unsigned int) match) << i;
 		}
+		ext = (matches == 0 ? ROHC_EXT_3 : rules[__builtin_ctz(matches)].ext);
 	}
 
 	return ext;
@@ -6581,309 +6961,74 @@ error:
 
 
 /**
- * @brief Decide what extension shall be used in the UOR-2 packet (non-RTP).
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
+ * @brief Get the conditions that the extensions of UO-1-ID/UOR-2* packets
+ *        may require
  *
- * @param context                          The compression context
- * @param innermost_ip_id_changed          Whether the innermost IP-ID changed
- * @param innermost_ip_id_3bits_possible   Whether the innermost IP-ID may be
- *                                         encoded on 3 bits
- * @param innermost_ip_id_8bits_possible   Whether the innermost IP-ID may be
- *                                         encoded on 8 bits
- * @param innermost_ip_id_11bits_possible  Whether the innermost IP-ID may be
- *                                         encoded on 11 bits
- * @param outermost_ip_id_changed          Whether the outermost IP-ID changed
- * @param outermost_ip_id_11bits_possible  Whether the outermost IP-ID may be
- *                                         encoded on 11 bits
- * @return                                 The extension code among ROHC_EXT_NONE,
- *                                         ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uor2(const struct rohc_comp_ctxt *const context,
-                                        const bool innermost_ip_id_changed,
-                                        const bool innermost_ip_id_3bits_possible,
-                                        const bool innermost_ip_id_8bits_possible,
-                                        const bool innermost_ip_id_11bits_possible,
-                                        const bool outermost_ip_id_changed,
-                                        const bool outermost_ip_id_11bits_possible)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	rohc_ext_t ext;
-
-	if(rfc3095_ctxt->tmp.sn_5bits_possible &&
-	   !innermost_ip_id_changed &&
-	   !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.sn_8bits_possible &&
-	        innermost_ip_id_changed && innermost_ip_id_3bits_possible &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.sn_8bits_possible &&
-	        innermost_ip_id_changed && innermost_ip_id_11bits_possible &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->ip_hdr_nr > 1 &&
-	        rfc3095_ctxt->tmp.sn_8bits_possible &&
-	        innermost_ip_id_changed && innermost_ip_id_8bits_possible &&
-	        outermost_ip_id_11bits_possible)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
-}
-
-
-/**
- * @brief Decide what extension shall be used in the UOR-2 packet (RTP).
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                  The compression context
- * @param innermost_ip_id_changed  Whether the innermost IP-ID changed
- * @param outermost_ip_id_changed  Whether the outermost IP-ID changed
- * @return                         The extension code among ROHC_EXT_NONE,
- *                                 ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uor2rtp(const struct rohc_comp_ctxt *const context,
-                                           const bool innermost_ip_id_changed,
-                                           const bool outermost_ip_id_changed)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const uint8_t nr_ts_bits = rtp_context->tmp.nr_ts_bits;
-	rohc_ext_t ext;
-
-	if(rfc3095_ctxt->tmp.sn_6bits_possible &&
-	   nr_ts_bits <= 6 &&
-	   !innermost_ip_id_changed &&
-	   !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 9 &&
-	        !innermost_ip_id_changed &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 17 &&
-	        !innermost_ip_id_changed &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 25 &&
-	        !innermost_ip_id_changed &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
-}
-
-
-/**
- * @brief Decide what extension shall be used in the UO-1-ID/UOR-2 packet.
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                         The compression context
- * @param innermost_ip_id_changed         Whether the innermost IP-ID changed
- * @param innermost_ip_id_8bits_possible  Whether the innermost IP-ID may be
- *                                        encoded on 8 bits
- * @param outermost_ip_id_changed         Whether the outermost IP-ID changed
- * @return                                The extension code among ROHC_EXT_NONE,
- *                                        ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uor2ts(const struct rohc_comp_ctxt *const context,
-                                          const bool innermost_ip_id_changed,
-                                          const bool innermost_ip_id_8bits_possible,
-                                          const bool outermost_ip_id_changed)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const uint8_t nr_ts_bits = rtp_context->tmp.nr_ts_bits;
-	rohc_ext_t ext;
-
-	if(rfc3095_ctxt->tmp.sn_6bits_possible &&
-	   nr_ts_bits <= 5 &&
-	   !innermost_ip_id_changed &&
-	   !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 8 &&
-	        !innermost_ip_id_changed &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 8 &&
-	        innermost_ip_id_8bits_possible &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 16 &&
-	        innermost_ip_id_8bits_possible &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
-}
-
-
-/**
- * @brief Decide what extension shall be used in the UOR-2-ID packet.
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                          The compression context
- * @param innermost_ip_id_5bits_possible   Whether the innermost IP-ID may be
- *                                         encoded on 5 bits
- * @param innermost_ip_id_8bits_possible   Whether the innermost IP-ID may be
- *                                         encoded on 8 bits
- * @param outermost_ip_id_changed          Whether the outermost IP-ID changed
- * @return                                 The extension code among ROHC_EXT_NONE,
- *                                         ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
+ * @param context          The compression context
+ * @param packet_type      The type of ROHC packet that is created
+ * @param[out] nr_ts_bits  The number of TS bits to transmit, 0 for non-RTP
+ *                         packets
+ * @return                 The ROHC_EXT_COND_* flags that are fulfilled
  */
-static rohc_ext_t decide_extension_uor2id(const struct rohc_comp_ctxt *const context,
-                                          const bool innermost_ip_id_5bits_possible,
-                                          const bool innermost_ip_id_8bits_possible,
-                                          const bool outermost_ip_id_changed)
+static uint32_t rohc_ext_get_conds(const struct rohc_comp_ctxt *const context,
+                                   const rohc_packet_t packet_type,
+                                   uint8_t *const nr_ts_bits)
 {
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const uint8_t nr_ts_bits = rtp_context->tmp.nr_ts_bits;
-	rohc_ext_t ext;
+	bool innermost_ip_id_changed;
+	bool innermost_ip_id_3bits_possible;
+	bool innermost_ip_id_5bits_possible;
+	bool innermost_ip_id_8bits_possible;
+	bool innermost_ip_id_11bits_possible;
+	bool outermost_ip_id_changed;
+	bool outermost_ip_id_11bits_possible;
+	uint32_t conds = 0;
 
-	if(rfc3095_ctxt->tmp.sn_6bits_possible &&
-	   (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	   innermost_ip_id_5bits_possible &&
-	   !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	        innermost_ip_id_8bits_possible &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 8 &&
-	        innermost_ip_id_8bits_possible &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.sn_9bits_possible &&
-	        nr_ts_bits <= 8 &&
-//	        nr_innermost_ip_id_bits <= 16 &&
-	        !outermost_ip_id_changed)
-	{
-		ext = ROHC_EXT_2;
+	/* determine the number of IP-ID bits and the IP-ID offset of the
+	 * innermost IPv4 header with non-random IP-ID */
+	rohc_get_ipid_bits(context,
+	                   &innermost_ip_id_changed,
+	                   &innermost_ip_id_3bits_possible,
+	                   &innermost_ip_id_5bits_possible,
+	                   &innermost_ip_id_8bits_possible,
+	                   &innermost_ip_id_11bits_possible,
+	                   &outermost_ip_id_changed,
+	                   &outermost_ip_id_11bits_possible);
+
+	conds |= rfc3095_ctxt->tmp.sn_4bits_possible ? ROHC_EXT_COND_SN_4BITS : 0;
+	conds |= rfc3095_ctxt->tmp.sn_5bits_possible ? ROHC_EXT_COND_SN_5BITS : 0;
+	conds |= rfc3095_ctxt->tmp.sn_6bits_possible ? ROHC_EXT_COND_SN_6BITS : 0;
+	conds |= rfc3095_ctxt->tmp.sn_7bits_possible ? ROHC_EXT_COND_SN_7BITS : 0;
+	conds |= rfc3095_ctxt->tmp.sn_8bits_possible ? ROHC_EXT_COND_SN_8BITS : 0;
+	conds |= rfc3095_ctxt->tmp.sn_9bits_possible ? ROHC_EXT_COND_SN_9BITS : 0;
+	conds |= innermost_ip_id_changed ? ROHC_EXT_COND_INNER_IPID_CHANGED : 0;
+	conds |= innermost_ip_id_3bits_possible ? ROHC_EXT_COND_INNER_IPID_3BITS : 0;
+	conds |= innermost_ip_id_5bits_possible ? ROHC_EXT_COND_INNER_IPID_5BITS : 0;
+	conds |= innermost_ip_id_8bits_possible ? ROHC_EXT_COND_INNER_IPID_8BITS : 0;
+	conds |= innermost_ip_id_11bits_possible ? ROHC_EXT_COND_INNER_IPID_11BITS : 0;
+	conds |= outermost_ip_id_changed ? ROHC_EXT_COND_OUTER_IPID_CHANGED : 0;
+	conds |= outermost_ip_id_11bits_possible ? ROHC_EXT_COND_OUTER_IPID_11BITS : 0;
+	conds |= rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt) ? ROHC_EXT_COND_TWO_IP_HDRS : 0;
+
+	/* the RTP-specific conditions, the context of non-RTP profiles has no
+	 * TS nor Marker bit */
+	if(packet_type == ROHC_PACKET_UOR_2)
+	{
+		*nr_ts_bits = 0;
 	}
 	else
 	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
-}
-
+		const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
 
-/**
- * @brief Decide what extension shall be used in the UO-1-ID packet.
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                         The compression context
- * @param innermost_ip_id_5bits_possible  Whether the innermost IP-ID may be
- *                                        encoded on 5 bits
- * @param innermost_ip_id_8bits_possible  Whether the innermost IP-ID may be
- *                                        encoded on 8 bits
- * @param outermost_ip_id_changed         Whether the outermost IP-ID changed
- * @return                                The extension code among ROHC_EXT_NONE,
- *                                        ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uo1id(const struct rohc_comp_ctxt *const context,
-                                         const bool innermost_ip_id_5bits_possible,
-                                         const bool innermost_ip_id_8bits_possible,
-                                         const bool outermost_ip_id_changed)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const uint8_t nr_ts_bits = rtp_context->tmp.nr_ts_bits;
-	rohc_ext_t ext;
-
-	if(rfc3095_ctxt->tmp.sn_4bits_possible &&
-	   (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	   innermost_ip_id_5bits_possible &&
-	   !outermost_ip_id_changed &&
-	   !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.sn_7bits_possible &&
-	        (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	        innermost_ip_id_8bits_possible &&
-	        !outermost_ip_id_changed &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.sn_7bits_possible &&
-	        nr_ts_bits <= 8 &&
-	        innermost_ip_id_8bits_possible &&
-	        !outermost_ip_id_changed &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.sn_7bits_possible &&
-	        nr_ts_bits <= 8 &&
-//	        nr_innermost_ip_id_bits <= 16 &&
-	        !outermost_ip_id_changed &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
+		*nr_ts_bits = rtp_context->tmp.nr_ts_bits;
+		if((*nr_ts_bits) == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc))
+		{
+			conds |= ROHC_EXT_COND_TS_DEDUCIBLE;
+		}
+		conds |= rtp_context->tmp.is_marker_bit_set ? ROHC_EXT_COND_MARKER : 0;
 	}
 
-	return ext;
+	return conds;
 }
 
 
@@ -6904,7 +7049,7 @@ static void rohc_get_innermost_ipv4_non_rnd(const struct rohc_comp_ctxt *const c
 {
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 
-	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	if(rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt) &&
 	   rfc3095_ctxt->ip_ctxts[1].version == IPV4 &&
 	   rfc3095_ctxt->ip_ctxts[1].info.v4.rnd == 0)
 	{
@@ -6962,7 +7107,7 @@ void rohc_get_ipid_bits(const struct rohc_comp_ctxt *const context,
 	const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 
-	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	if(rohc_comp_rfc3095_has_inner_ip(rfc3095_ctxt) &&
 	   rfc3095_ctxt->ip_ctxts[1].version == IPV4 &&
 	   rfc3095_ctxt->ip_ctxts[1].info.v4.rnd == 0)
 	{
@@ -7042,7 +7187,7 @@ static void rohc_comp_rfc3095_get_ext3_I_flags(const struct rohc_comp_ctxt *cons
                                                uint8_t *const I,
                                                uint8_t *const I2)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt = context->specific;
 
 	if(uncomp_pkt_hdrs->ip_hdrs_nr == 1)
@@ -315,19 +315,23 @@ struct rohc_comp_rfc3095_ctxt
 		__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 	/// @brief The handler used to compute the CRC-STATIC value
-	uint8_t (*compute_crc_static)(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+	uint8_t (*compute_crc_static)(const struct rohc_crc_engine *const crc_engine,
+	                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
 	                              const rohc_crc_type_t crc_type,
 	                              const uint8_t init_val)
-		__attribute__((nonnull(1), warn_unused_result));
+		__attribute__((nonnull(1, 2), warn_unused_result));
 
 	/// @brief The handler used to compute the CRC-DYNAMIC value
-	uint8_t (*compute_crc_dynamic)(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+	uint8_t (*compute_crc_dynamic)(const struct rohc_crc_engine *const crc_engine,
+	                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
 	                               const rohc_crc_type_t crc_type,
 	                               const uint8_t init_val)
-		__attribute__((nonnull(1), warn_unused_result));
+		__attribute__((nonnull(1, 2), warn_unused_result));
 
 	/// Profile-specific data
 	void *specific;
+	/// The length of the profile-specific data
+	size_t specific_len;
 };
 
 
@@ -376,6 +380,22 @@ void rohc_get_ipid_bits(const struct rohc_comp_ctxt *const context,
 	__attribute__((nonnull(1, 2, 3, 4, 5, 6, 7, 8)));
 
 
+/**
+ * @brief Is there an inner IP header in the given context?
+ *
+ * Always false if the library handles one single IP header (see
+ * \ref ROHC_MAX_IP_HDRS), so that the code dedicated to the inner IP header
+ * is removed at build time.
+ *
+ * @param ctxt  The generic compression context
+ * @return      true if the context compresses 2 IP headers, false otherwise
+ */
+static inline bool rohc_comp_rfc3095_has_inner_ip(const struct rohc_comp_rfc3095_ctxt *const ctxt)
+{
+	return (ROHC_MAX_IP_HDRS > 1 && ctxt->ip_hdr_nr > 1);
+}
+
+
 /**
  * @brief How many IP headers are IPv4 headers with non-random IP-IDs ?
  *
@@ -36,16 +36,25 @@
 
 
 
-static void build_ipv6_ext_pkt_list(struct list_comp *const comp,
+static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
                                     const struct rohc_pkt_ip_hdr *const ip,
                                     struct rohc_list *const pkt_list)
-	__attribute__((nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static bool rohc_list_is_ref_list_unchanged(const struct list_comp *const comp,
+                                            const struct rohc_pkt_ip_hdr *const ip)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 
 static unsigned int rohc_list_get_nearest_list(const struct list_comp *const comp,
                                                const struct rohc_list *const pkt_list,
                                                bool *const is_new_list)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static void rohc_list_set_counter(struct list_comp *const comp,
+                                  const unsigned int gen_id,
+                                  const uint8_t counter)
+	__attribute__((nonnull(1)));
+
 static int rohc_list_decide_type(struct list_comp *const comp)
 	__attribute__((warn_unused_result, nonnull(1)));
 
@@ -125,8 +134,10 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
  * @param ip                         The IP packet to compress
  * @param[out] list_struct_changed   Whether the structure of the list changed
  * @param[out] list_content_changed  Whether the content of the list changed
+ * @return                           true if changes were successfully detected,
+ *                                   false if memory for the list was missing
  */
-void detect_ipv6_ext_changes(struct list_comp *const comp,
+bool detect_ipv6_ext_changes(struct list_comp *const comp,
                              const struct rohc_pkt_ip_hdr *const ip,
                              bool *const list_struct_changed,
                              bool *const list_content_changed)
@@ -135,24 +146,53 @@ void detect_ipv6_ext_changes(struct list_comp *const comp,
 	struct rohc_list pkt_list;
 	bool is_new_list = false;
 
-	/* parse all extension headers:
-	 *  - update the related entries in the translation table,
-	 *  - create the list for the packet */
-	build_ipv6_ext_pkt_list(comp, ip, &pkt_list);
+	/* in the most common case, the extension headers of the packet are the
+	 * very same as the ones of the current reference list: neither the
+	 * translation table nor the lists need to be updated then */
+	if(rohc_list_is_ref_list_unchanged(comp, ip))
+	{
+		rc_list_debug(comp, "extension headers match the reference list with "
+		              "gen_id %u", comp->ref_id);
+		new_cur_id = comp->ref_id;
+	}
+	else
+	{
+		/* parse all extension headers:
+		 *  - update the related entries in the translation table,
+		 *  - create the list for the packet */
+		if(!build_ipv6_ext_pkt_list(comp, ip, &pkt_list))
+		{
+			rohc_comp_list_warn(comp, "failed to update the translation table");
+			goto error;
+		}
 
-	/* now that translation table is updated and packet list is generated,
-	 * search for a context list with the same structure or use an anonymous
-	 * list */
-	new_cur_id = rohc_list_get_nearest_list(comp, &pkt_list, &is_new_list);
+		/* now that translation table is updated and packet list is generated,
+		 * search for a context list with the same structure or use an
+		 * anonymous list */
+		new_cur_id = rohc_list_get_nearest_list(comp, &pkt_list, &is_new_list);
+	}
 	if(is_new_list)
 	{
 		/* TODO: context should not be overwritten until compression is fully OK */
-		assert(comp->lists[new_cur_id].id == new_cur_id);
-		memcpy(comp->lists[new_cur_id].items, pkt_list.items,
+		if(comp->lists[new_cur_id] == NULL)
+		{
+			comp->lists[new_cur_id] = rohc_list_new(comp->mempool, new_cur_id);
+			if(comp->lists[new_cur_id] == NULL)
+			{
+				rohc_comp_list_warn(comp, "failed to allocate list with gen_id %u",
+				                    new_cur_id);
+				goto error;
+			}
+		}
+		assert(comp->lists[new_cur_id]->id == new_cur_id);
+		memcpy(comp->lists[new_cur_id]->items, pkt_list.items,
 		       ROHC_LIST_ITEMS_MAX * sizeof(struct rohc_list_item *));
-		comp->lists[new_cur_id].items_nr = pkt_list.items_nr;
-		comp->lists[new_cur_id].counter = 0;
-		comp->lists[ROHC_LIST_GEN_ID_ANON].counter = 0;
+		comp->lists[new_cur_id]->items_nr = pkt_list.items_nr;
+		rohc_list_set_counter(comp, new_cur_id, 0);
+		if(comp->lists[ROHC_LIST_GEN_ID_ANON] != NULL)
+		{
+			comp->lists[ROHC_LIST_GEN_ID_ANON]->counter = 0;
+		}
 	}
 
 	/* do we need to send some bits of the compressed list? */
@@ -162,10 +202,10 @@ void detect_ipv6_ext_changes(struct list_comp *const comp,
 		              "IPv6 header because it changed");
 		*list_struct_changed = true;
 		*list_content_changed = true;
-		comp->lists[new_cur_id].counter = 0;
+		rohc_list_set_counter(comp, new_cur_id, 0);
 	}
 	else if(new_cur_id != ROHC_LIST_GEN_ID_NONE &&
-	        comp->lists[new_cur_id].counter < comp->oa_repetitions_nr)
+	        comp->lists[new_cur_id]->counter < comp->oa_repetitions_nr)
 	{
 		rc_list_debug(comp, "send some bits for extension header list of the "
 		              "IPv6 header because it was not sent enough times");
@@ -178,9 +218,9 @@ void detect_ipv6_ext_changes(struct list_comp *const comp,
 
 		*list_struct_changed = false;
 		*list_content_changed = false;
-		for(i = 0; i < comp->lists[comp->cur_id].items_nr; i++)
+		for(i = 0; i < comp->lists[comp->cur_id]->items_nr; i++)
 		{
-			if(!comp->lists[comp->cur_id].items[i]->known)
+			if(!comp->lists[comp->cur_id]->items[i]->known)
 			{
 				*list_content_changed = true;
 				break;
@@ -196,6 +236,11 @@ void detect_ipv6_ext_changes(struct list_comp *const comp,
 
 	/* TODO: should not be overwritten until compression is fully OK */
 	comp->cur_id = new_cur_id;
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -209,8 +254,10 @@ void detect_ipv6_ext_changes(struct list_comp *const comp,
  * @param comp           The list compressor
  * @param ip             The IP packet to compress
  * @param[out] pkt_list  The list of extension headers for the current packet
+ * @return               true if the list was built, false if memory for one
+ *                       item of the translation table was missing
  */
-static void build_ipv6_ext_pkt_list(struct list_comp *const comp,
+static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
                                     const struct rohc_pkt_ip_hdr *const ip,
                                     struct rohc_list *const pkt_list)
 {
@@ -241,11 +288,14 @@ static void build_ipv6_ext_pkt_list(struct list_comp *const comp,
 		/* update item in translation table if it changed */
 		/* TODO: context should not be overwritten until compression is fully OK */
 		/* TODO: put comp const in params once context is not overwritten any more */
-		ret = rohc_list_item_update_if_changed(comp->cmp_item,
+		ret = rohc_list_item_update_if_changed(comp->cmp_item, comp->mempool,
 		                                       &(comp->trans_table[index_table]),
 		                                       ext->type, ext->data, ext->len);
-		assert(ret >= 0);
-		if(ret == 1)
+		if(ret < 0)
+		{
+			return false;
+		}
+		else if(ret == 1)
 		{
 			rc_list_debug(comp, "  entry #%d updated in translation table",
 			              index_table);
@@ -264,6 +314,8 @@ static void build_ipv6_ext_pkt_list(struct list_comp *const comp,
 		              comp->trans_table[index_table].known ? "known" : "not-yet-known",
 		              comp->trans_table[index_table].counter, comp->oa_repetitions_nr);
 	}
+
+	return true;
 }
 
 
@@ -316,12 +368,12 @@ int rohc_list_encode(struct list_comp *const comp,
 	if(comp->cur_id == ROHC_LIST_GEN_ID_ANON)
 	{
 		rc_list_debug(comp, "send anonymous list for the #%u time",
-		              comp->lists[comp->cur_id].counter + 1);
+		              comp->lists[comp->cur_id]->counter + 1);
 	}
 	else
 	{
 		rc_list_debug(comp, "send list with generation ID %u for the #%u time",
-		              comp->cur_id, comp->lists[comp->cur_id].counter + 1);
+		              comp->cur_id, comp->lists[comp->cur_id]->counter + 1);
 	}
 
 	return counter;
@@ -352,30 +404,31 @@ void rohc_list_update_context(struct list_comp *const comp)
 
 	/* the items of the current list were sent once more, increment their
 	 * counters and check whether they are known or not */
-	for(i = 0; i < comp->lists[comp->cur_id].items_nr; i++)
+	for(i = 0; i < comp->lists[comp->cur_id]->items_nr; i++)
 	{
-		if(!comp->lists[comp->cur_id].items[i]->known)
+		if(!comp->lists[comp->cur_id]->items[i]->known)
 		{
-			comp->lists[comp->cur_id].items[i]->counter++;
-			if(comp->lists[comp->cur_id].items[i]->counter >= comp->oa_repetitions_nr)
+			comp->lists[comp->cur_id]->items[i]->counter++;
+			if(comp->lists[comp->cur_id]->items[i]->counter >= comp->oa_repetitions_nr)
 			{
-				comp->lists[comp->cur_id].items[i]->known = true;
+				comp->lists[comp->cur_id]->items[i]->known = true;
 			}
 		}
 	}
 
 	/* current list was sent once more, do we update the reference list? */
-	if(comp->lists[comp->cur_id].counter < comp->oa_repetitions_nr)
+	if(comp->lists[comp->cur_id]->counter < comp->oa_repetitions_nr)
 	{
-		comp->lists[comp->cur_id].counter++;
+		rohc_list_set_counter(comp, comp->cur_id,
+		                      comp->lists[comp->cur_id]->counter + 1);
 		rc_list_debug(comp, "current list (gen_id = %u) was sent %u/%u times",
-		              comp->cur_id, comp->lists[comp->cur_id].counter,
+		              comp->cur_id, comp->lists[comp->cur_id]->counter,
 		              comp->oa_repetitions_nr);
 
 		/* do we update the reference list? */
 		if(comp->cur_id != comp->ref_id &&
 		   comp->cur_id != ROHC_LIST_GEN_ID_ANON &&
-		   comp->lists[comp->cur_id].counter >= comp->oa_repetitions_nr)
+		   comp->lists[comp->cur_id]->counter >= comp->oa_repetitions_nr)
 		{
 			if(comp->ref_id != ROHC_LIST_GEN_ID_NONE)
 			{
@@ -399,6 +452,47 @@ void rohc_list_update_context(struct list_comp *const comp)
 }
 
 
+/**
+ * @brief Are the extension headers of the packet the ones of the reference list?
+ *
+ * The check is done on the reference list only when it is the current list
+ * too, ie. in the steady state of the list compression. In that case, the
+ * translation table would not be updated and the reference list would be
+ * selected again by \ref rohc_list_get_nearest_list, so the packet list does
+ * not need to be built.
+ *
+ * @param comp  The list compressor
+ * @param ip    The IP packet to compress
+ * @return      true if the packet extension headers are the ones of the
+ *              reference list, false if the full search is required
+ */
+static bool rohc_list_is_ref_list_unchanged(const struct list_comp *const comp,
+                                            const struct rohc_pkt_ip_hdr *const ip)
+{
+	const struct rohc_list *ref_list;
+	bool is_unchanged;
+	uint8_t ext_num;
+
+	if(comp->ref_id == ROHC_LIST_GEN_ID_NONE ||
+	   comp->cur_id != comp->ref_id)
+	{
+		return false;
+	}
+	ref_list = comp->lists[comp->ref_id];
+	assert(ref_list != NULL);
+
+	is_unchanged = (ref_list->items_nr == ip->exts_nr);
+	for(ext_num = 0; is_unchanged && ext_num < ip->exts_nr; ext_num++)
+	{
+		const struct rohc_pkt_ip_ext_hdr *const ext = ip->exts + ext_num;
+		is_unchanged = comp->cmp_item(ref_list->items[ext_num], ext->type,
+		                              ext->data, ext->len);
+	}
+
+	return is_unchanged;
+}
+
+
 /**
  * @brief Search the nearest list for the packet list
  *
@@ -420,13 +514,14 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	const uint8_t anon_thres = 2;
 	unsigned int new_cur_id = ROHC_LIST_GEN_ID_NONE;
 	unsigned int gen_id;
+	size_t word;
 
 	/* check the reference list first as it is probably the correct one */
 	if(comp->ref_id != ROHC_LIST_GEN_ID_NONE &&
-	   rohc_list_equal(pkt_list, &comp->lists[comp->ref_id]))
+	   rohc_list_equal(pkt_list, comp->lists[comp->ref_id]))
 	{
 		/* reference list matches, no need for a new list */
-		rc_list_debug(comp, "send reference list with gen_id = %u (counter = %u)", comp->ref_id, comp->lists[comp->ref_id].counter);
+		rc_list_debug(comp, "send reference list with gen_id = %u (counter = %u)", comp->ref_id, comp->lists[comp->ref_id]->counter);
 		*is_new_list = false;
 		return comp->ref_id;
 	}
@@ -434,19 +529,30 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	              comp->ref_id);
 
 	/* search for an identified list that matches the packet one, avoid the
-	 * reference list that we already checked, stop on first unused list */
-	for(gen_id = 0; new_cur_id == ROHC_LIST_GEN_ID_NONE &&
-	                gen_id <= ROHC_LIST_GEN_ID_MAX; gen_id++)
-	{
-		rc_list_debug(comp, "compare current list with existing list "
-		              "with gen_id %u (counter = %u)", gen_id, comp->lists[gen_id].counter);
-		if(gen_id != comp->ref_id &&
-		   comp->lists[gen_id].counter > 0 &&
-		   rohc_list_equal(pkt_list, &comp->lists[gen_id]))
+	 * reference list that we already checked: only the lists that were
+	 * already sent are compared, they are walked in the order of their
+	 * gen_ids through the bitmap of the sent lists */
+	for(word = 0; new_cur_id == ROHC_LIST_GEN_ID_NONE &&
+	              word < ROHC_LIST_SENT_IDS_WORDS; word++)
+	{
+		uint64_t sent_ids = comp->sent_ids[word];
+
+		while(new_cur_id == ROHC_LIST_GEN_ID_NONE && sent_ids != 0)
 		{
-			rc_list_debug(comp, "current list matches the existing list "
-			              "with gen_id %u", gen_id);
-			new_cur_id = gen_id;
+			gen_id = word * 64 + __builtin_ctzll(sent_ids);
+			sent_ids &= sent_ids - 1;
+			assert(comp->lists[gen_id] != NULL);
+			assert(comp->lists[gen_id]->counter > 0);
+			rc_list_debug(comp, "compare current list with existing list "
+			              "with gen_id %u (counter = %u)", gen_id,
+			              comp->lists[gen_id]->counter);
+			if(gen_id != comp->ref_id &&
+			   rohc_list_equal(pkt_list, comp->lists[gen_id]))
+			{
+				rc_list_debug(comp, "current list matches the existing list "
+				              "with gen_id %u", gen_id);
+				new_cur_id = gen_id;
+			}
 		}
 	}
 
@@ -456,7 +562,7 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	{
 		rc_list_debug(comp, "send existing context list with gen_id %u "
 		              "(already sent %u times)", new_cur_id,
-		              comp->lists[new_cur_id].counter);
+		              comp->lists[new_cur_id]->counter);
 		*is_new_list = false;
 		return new_cur_id;
 	}
@@ -476,8 +582,9 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	}
 
 	/* try to use an anonymous list */
-	if(comp->lists[ROHC_LIST_GEN_ID_ANON].counter == 0 ||
-	   !rohc_list_equal(pkt_list, &comp->lists[ROHC_LIST_GEN_ID_ANON]))
+	if(comp->lists[ROHC_LIST_GEN_ID_ANON] == NULL ||
+	   comp->lists[ROHC_LIST_GEN_ID_ANON]->counter == 0 ||
+	   !rohc_list_equal(pkt_list, comp->lists[ROHC_LIST_GEN_ID_ANON]))
 	{
 		/* new or changed anonymous list */
 		rc_list_debug(comp, "send current list as anonymous list (transmitted "
@@ -489,11 +596,11 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 
 	/* anonymous list matches, either use it as an anonymous list another time
 	 * or promote it an identified list */
-	if((comp->lists[ROHC_LIST_GEN_ID_ANON].counter + 1) < anon_thres)
+	if((comp->lists[ROHC_LIST_GEN_ID_ANON]->counter + 1) < anon_thres)
 	{
 		/* too early to promote anonymous list to an identified list with a gen_id */
 		rc_list_debug(comp, "send current list as anonymous list (transmitted "
-		              "%u / %u)", comp->lists[ROHC_LIST_GEN_ID_ANON].counter,
+		              "%u / %u)", comp->lists[ROHC_LIST_GEN_ID_ANON]->counter,
 		              anon_thres);
 		*is_new_list = false;
 		return ROHC_LIST_GEN_ID_ANON;
@@ -503,18 +610,24 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	 *  - search for the first unused list,
 	 *  - if no unused list was found, get the next free gen_id
 	 *  - in all cases, avoid re-using ref_id */
-	for(gen_id = 0; new_cur_id == ROHC_LIST_GEN_ID_NONE &&
-	                gen_id <= ROHC_LIST_GEN_ID_MAX; gen_id++)
+	for(word = 0; new_cur_id == ROHC_LIST_GEN_ID_NONE &&
+	              word < ROHC_LIST_SENT_IDS_WORDS; word++)
 	{
-		if(gen_id != comp->ref_id && comp->lists[gen_id].counter == 0)
+		uint64_t free_ids = ~(comp->sent_ids[word]);
+
+		if(comp->ref_id != ROHC_LIST_GEN_ID_NONE && (comp->ref_id / 64) == word)
+		{
+			free_ids &= ~(((uint64_t) 1) << (comp->ref_id % 64));
+		}
+		if(free_ids != 0)
 		{
-			rc_list_debug(comp, "gen_id %u is free, use it", gen_id);
-			new_cur_id = gen_id;
+			new_cur_id = word * 64 + __builtin_ctzll(free_ids);
+			rc_list_debug(comp, "gen_id %u is free, use it", new_cur_id);
 		}
 	}
 	if(new_cur_id == ROHC_LIST_GEN_ID_NONE)
 	{
-		new_cur_id = gen_id % (ROHC_LIST_GEN_ID_MAX + 1);
+		new_cur_id = 0;
 		rc_list_debug(comp, "no free gen_id found, re-use gen_id %u", new_cur_id);
 		if(new_cur_id == comp->ref_id)
 		{
@@ -526,12 +639,46 @@ static unsigned int rohc_list_get_nearest_list(const struct list_comp *const com
 	}
 	rc_list_debug(comp, "the anonymous list is going to be transmitted for the "
 	              "%u time, promote it to an identified list with gen_id = %u",
-	              comp->lists[ROHC_LIST_GEN_ID_ANON].counter + 1, new_cur_id);
+	              comp->lists[ROHC_LIST_GEN_ID_ANON]->counter + 1, new_cur_id);
 	*is_new_list = true;
 	return new_cur_id;
 }
 
 
+/**
+ * @brief Set the number of transmissions of one list
+ *
+ * The bitmap of the lists that were already sent is updated accordingly.
+ *
+ * @param comp     The list compressor
+ * @param gen_id   The gen_id of the list, or the anonymous list
+ * @param counter  The new number of transmissions of the list
+ */
+static void rohc_list_set_counter(struct list_comp *const comp,
+                                  const unsigned int gen_id,
+                                  const uint8_t counter)
+{
+	assert(gen_id <= ROHC_LIST_GEN_ID_ANON);
+	assert(comp->lists[gen_id] != NULL);
+
+	comp->lists[gen_id]->counter = counter;
+
+	if(gen_id <= ROHC_LIST_GEN_ID_MAX)
+	{
+		const uint64_t bit = ((uint64_t) 1) << (gen_id % 64);
+
+		if(counter > 0)
+		{
+			comp->sent_ids[gen_id / 64] |= bit;
+		}
+		else
+		{
+			comp->sent_ids[gen_id / 64] &= ~bit;
+		}
+	}
+}
+
+
 /**
  * @brief Decide the encoding type for compression list
  *
@@ -552,7 +699,7 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		              "reference list yet");
 		encoding_type = 0;
 	}
-	else if(comp->lists[comp->ref_id].items_nr == 0)
+	else if(comp->lists[comp->ref_id]->items_nr == 0)
 	{
 		/* empty reference list, so use encoding type 0 (RFC 4815, §5.7 reads
 		 * that encoding types 1, 2, and 3 must not be used with an empty
@@ -562,7 +709,7 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		encoding_type = 0;
 	}
 	else if(comp->cur_id == comp->ref_id ||
-	        comp->lists[comp->cur_id].counter > 0)
+	        comp->lists[comp->cur_id]->counter > 0)
 	{
 		/* the structure of the list did not change, so use encoding type 0 */
 		rc_list_debug(comp, "use list encoding type 0 because the structure of "
@@ -570,14 +717,14 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		              "changed)");
 		encoding_type = 0;
 	}
-	else if(comp->lists[comp->cur_id].items_nr <=
-	        comp->lists[comp->ref_id].items_nr)
+	else if(comp->lists[comp->cur_id]->items_nr <=
+	        comp->lists[comp->ref_id]->items_nr)
 	{
 		/* the structure of the list changed, there are fewer items in the
 		 * current list than in the reference list: are all the items of the
 		 * current list in the reference list? */
-		if(!rohc_list_supersede(&comp->lists[comp->ref_id],
-		                        &comp->lists[comp->cur_id]))
+		if(!rohc_list_supersede(comp->lists[comp->ref_id],
+		                        comp->lists[comp->cur_id]))
 		{
 			/* some items of the current list are not present in the reference
 			 * list, so the 'Remove Then Insert scheme' (type 3) is required
@@ -593,9 +740,9 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 			 * items */
 			size_t k;
 			encoding_type = 2;
-			for(k = 0; k < comp->lists[comp->cur_id].items_nr; k++)
+			for(k = 0; k < comp->lists[comp->cur_id]->items_nr; k++)
 			{
-				if(!comp->lists[comp->cur_id].items[k]->known)
+				if(!comp->lists[comp->cur_id]->items[k]->known)
 				{
 					encoding_type = 0;
 					break;
@@ -608,8 +755,8 @@ static int rohc_list_decide_type(struct list_comp *const comp)
 		/* the structure of the list changed, there are more items in the
 		 * current list than in the reference list: are all the items of the
 		 * reference list in the current list? */
-		if(rohc_list_supersede(&comp->lists[comp->cur_id],
-		                       &comp->lists[comp->ref_id]))
+		if(rohc_list_supersede(comp->lists[comp->cur_id],
+		                       comp->lists[comp->ref_id]))
 		{
 			/* all the items of the reference list are present in the current
 			 * list, so the 'Insertion Only scheme' (type 1) may be used to
@@ -719,14 +866,14 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 	assert(comp->cur_id != ROHC_LIST_GEN_ID_NONE);
 
 	/* retrieve the number of items in the current list */
-	m = comp->lists[comp->cur_id].items_nr;
+	m = comp->lists[comp->cur_id]->items_nr;
 	assert(m <= ROHC_LIST_ITEMS_MAX);
 
 	/* determine whether we should use 4-bit or 8-bit indexes */
 	{
 		uint8_t ins_mask[ROHC_LIST_ITEMS_MAX] = { 1 };
 
-		ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
+		ps = rohc_list_compute_ps(comp, comp->lists[comp->cur_id], ins_mask, m);
 		if(ps != 0 && ps != 1)
 		{
 			goto error;
@@ -760,7 +907,7 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 		/* write all XIs in packet */
 		for(k = 0; k < m; k++, counter++)
 		{
-			const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+			const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 			int index_table;
 
 			/* one more occurrence of this item */
@@ -797,7 +944,7 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 		/* write all XIs in packet 2 by 2 */
 		for(k = 0; k < m; k += 2, counter++)
 		{
-			const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+			const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 			int index_table;
 
 			/* one more occurrence of this item */
@@ -832,7 +979,7 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 			if((k + 1) < m)
 			{
 				const struct rohc_list_item *const item2 =
-					comp->lists[comp->cur_id].items[k + 1];
+					comp->lists[comp->cur_id]->items[k + 1];
 				int index_table2;
 
 				/* one more occurrence of this item */
@@ -873,7 +1020,7 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 	/* part 4: n items (only unknown items) */
 	for(k = 0; k < m; k++)
 	{
-		const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+		const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 
 		/* copy the list element if not known yet */
 		if(!item->known)
@@ -990,7 +1137,7 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 	assert(comp->cur_id != ROHC_LIST_GEN_ID_NONE);
 
 	/* retrieve the number of items in the current list */
-	m = comp->lists[comp->cur_id].items_nr;
+	m = comp->lists[comp->cur_id]->items_nr;
 	assert(m <= ROHC_LIST_ITEMS_MAX);
 
 	/* part 1: ET, GP (PS will be set later) */
@@ -1017,8 +1164,8 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 
 	/* part 4: insertion mask */
 	ins_mask_len =
-		rohc_list_compute_ins_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_ins_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, ins_mask,
 		                           dest + counter, 2 /* TODO */);
 	if(ins_mask_len != 1 && ins_mask_len != 2)
@@ -1029,7 +1176,7 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 	counter += ins_mask_len;
 
 	/* determine whether we should use 4-bit or 8-bit indexes */
-	ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
+	ps = rohc_list_compute_ps(comp, comp->lists[comp->cur_id], ins_mask, m);
 	if(ps != 0 && ps != 1)
 	{
 		goto error;
@@ -1039,7 +1186,7 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 	{
 		uint8_t first_4b_xi;
 
-		ret = rohc_list_build_XIs(comp, &(comp->lists[comp->cur_id]), ins_mask, ps,
+		ret = rohc_list_build_XIs(comp, comp->lists[comp->cur_id], ins_mask, ps,
 		                          dest + counter, m /* TODO */, &first_4b_xi);
 		if(ret < 0)
 		{
@@ -1057,7 +1204,7 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 	/* part 6: n items (only unknown items) */
 	for(k = 0; k < m; k++)
 	{
-		const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+		const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 
 		/* skip element if it present in the reference list */
 		if(ins_mask[k] == 0 && item->known)
@@ -1151,7 +1298,7 @@ static int rohc_list_encode_type_2(struct list_comp *const comp,
 	assert(comp->cur_id != ROHC_LIST_GEN_ID_NONE);
 
 	/* retrieve the number of items in the reference list */
-	count = comp->lists[comp->ref_id].items_nr;
+	count = comp->lists[comp->ref_id]->items_nr;
 	assert(count <= ROHC_LIST_ITEMS_MAX);
 
 	/* part 1: ET, GP, res and Count */
@@ -1178,8 +1325,8 @@ static int rohc_list_encode_type_2(struct list_comp *const comp,
 
 	/* part 4: removal mask */
 	rem_mask_len =
-		rohc_list_compute_rem_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_rem_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, dest + counter, 2 /* TODO */);
 	if(rem_mask_len != 1 && rem_mask_len != 2)
 	{
@@ -1310,10 +1457,10 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 	assert(comp->cur_id != ROHC_LIST_GEN_ID_NONE);
 
 	/* retrieve the number of items in the reference list */
-	assert(comp->lists[comp->ref_id].items_nr <= ROHC_LIST_ITEMS_MAX);
+	assert(comp->lists[comp->ref_id]->items_nr <= ROHC_LIST_ITEMS_MAX);
 
 	/* retrieve the number of items in the current list */
-	m = comp->lists[comp->cur_id].items_nr;
+	m = comp->lists[comp->cur_id]->items_nr;
 	assert(m <= ROHC_LIST_ITEMS_MAX);
 
 	/* part 1: ET, GP (PS will be set later) */
@@ -1340,8 +1487,8 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 
 	/* part 4: removal mask */
 	rem_mask_len =
-		rohc_list_compute_rem_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_rem_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, dest + counter, 2 /* TODO */);
 	if(rem_mask_len != 1 && rem_mask_len != 2)
 	{
@@ -1352,8 +1499,8 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 
 	/* part 5: insertion mask */
 	ins_mask_len =
-		rohc_list_compute_ins_mask(comp, &(comp->lists[comp->ref_id]),
-		                           &(comp->lists[comp->cur_id]),
+		rohc_list_compute_ins_mask(comp, comp->lists[comp->ref_id],
+		                           comp->lists[comp->cur_id],
 		                           rem_mask, ins_mask,
 		                           dest + counter, 2 /* TODO */);
 	if(ins_mask_len != 1 && ins_mask_len != 2)
@@ -1364,7 +1511,7 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 	counter += ins_mask_len;
 
 	/* determine whether we should use 4-bit or 8-bit indexes */
-	ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
+	ps = rohc_list_compute_ps(comp, comp->lists[comp->cur_id], ins_mask, m);
 	if(ps != 0 && ps != 1)
 	{
 		goto error;
@@ -1374,7 +1521,7 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 	{
 		uint8_t first_4b_xi;
 
-		ret = rohc_list_build_XIs(comp, &(comp->lists[comp->cur_id]), ins_mask, ps,
+		ret = rohc_list_build_XIs(comp, comp->lists[comp->cur_id], ins_mask, ps,
 		                          dest + counter, m /* TODO */, &first_4b_xi);
 		if(ret < 0)
 		{
@@ -1392,7 +1539,7 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 	/* part 7: n items (only unknown items) */
 	for(k = 0; k < m; k++)
 	{
-		const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
+		const struct rohc_list_item *const item = comp->lists[comp->cur_id]->items[k];
 
 		/* skip element if it present in the reference list */
 		if(ins_mask[k] == 0 && item->known)
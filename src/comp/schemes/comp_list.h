@@ -37,6 +37,10 @@
 	           format, ##__VA_ARGS__)
 
 
+/** The number of 64-bit words of the bitmap of the sent lists */
+#define ROHC_LIST_SENT_IDS_WORDS  ((ROHC_LIST_GEN_ID_MAX + 1) / 64)
+
+
 /**
  * @brief The list compressor
  */
@@ -45,8 +49,16 @@ struct list_comp
 	/** The translation table */
 	struct rohc_list_item trans_table[ROHC_LIST_MAX_ITEM];
 
-	/* All the possible named lists, indexed by gen_id */
-	struct rohc_list lists[ROHC_LIST_GEN_ID_MAX + 2];
+	/** All the possible named lists and the anonymous list, indexed by gen_id,
+	 *  allocated on first use, NULL if never used */
+	struct rohc_list *lists[ROHC_LIST_GEN_ID_MAX + 2];
+	/** The named lists that were already sent at least once, one bit per
+	 *  gen_id, maintained as the lists are sent and redefined in order to
+	 *  search the lists without walking over all the possible gen_ids */
+	uint64_t sent_ids[ROHC_LIST_SENT_IDS_WORDS];
+
+	/** The memory pool the lists and the item data are allocated from */
+	struct rohc_mempool *mempool;
 
 	/** The ID of the reference list */
 	unsigned int ref_id;
@@ -72,16 +84,18 @@ struct list_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces given to the callback function */
+	rohc_trace_level_t trace_level;
 	/** The profile ID the compression list was created for */
 	int profile_id;
 };
 
 
-void detect_ipv6_ext_changes(struct list_comp *const comp,
+bool detect_ipv6_ext_changes(struct list_comp *const comp,
                              const struct rohc_pkt_ip_hdr *const ip,
                              bool *const list_struct_changed,
                              bool *const list_content_changed)
-	__attribute__((nonnull(1, 2, 3, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
 int rohc_list_encode(struct list_comp *const comp,
                      uint8_t *const dest,
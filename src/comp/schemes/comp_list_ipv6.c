@@ -42,17 +42,24 @@ static bool cmp_ipv6_ext(const struct rohc_list_item *const item,
 /**
  * @brief Create one context for compressing lists of IPv6 extension headers
  *
+ * The lists and the data of the items are allocated from the given memory
+ * pool on first use only.
+ *
  * @param comp               The context to create
+ * @param mempool            The memory pool to allocate lists and items from
  * @param oa_repetitions_nr  The number of repetitions for Optimistic Approach
  * @param profile_id         The ID of the associated decompression profile
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_level        The lowest level of the traces to print
  */
 void rohc_comp_list_ipv6_new(struct list_comp *const comp,
+                             struct rohc_mempool *const mempool,
                              const size_t oa_repetitions_nr,
                              const int profile_id,
                              rohc_trace_callback2_t trace_cb,
-                             void *const trace_cb_priv)
+                             void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level)
 {
 	size_t i;
 
@@ -64,14 +71,17 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
 
 	for(i = 0; i <= ROHC_LIST_GEN_ID_ANON; i++)
 	{
-		rohc_list_reset(&comp->lists[i]);
-		comp->lists[i].id = i;
+		comp->lists[i] = NULL;
 	}
+	memset(comp->sent_ids, 0, sizeof(comp->sent_ids));
 
 	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
 	{
+		comp->trans_table[i].data = NULL;
+		comp->trans_table[i].data_max_len = 0;
 		rohc_list_item_reset(&comp->trans_table[i]);
 	}
+	comp->mempool = mempool;
 
 	comp->oa_repetitions_nr = oa_repetitions_nr;
 
@@ -82,6 +92,7 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
 	/* traces */
 	comp->trace_callback = trace_cb;
 	comp->trace_callback_priv = trace_cb_priv;
+	comp->trace_level = trace_level;
 	comp->profile_id = profile_id;
 }
 
@@ -93,6 +104,19 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
  */
 void rohc_comp_list_ipv6_free(struct list_comp *const comp)
 {
+	size_t i;
+
+	for(i = 0; i <= ROHC_LIST_GEN_ID_ANON; i++)
+	{
+		if(comp->lists[i] != NULL)
+		{
+			rohc_list_free(comp->mempool, comp->lists[i]);
+		}
+	}
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		rohc_list_item_free(comp->mempool, &comp->trans_table[i]);
+	}
 	memset(comp, 0, sizeof(struct list_comp));
 }
 
@@ -30,11 +30,13 @@
 
 
 void rohc_comp_list_ipv6_new(struct list_comp *const comp,
+                             struct rohc_mempool *const mempool,
                              const size_t oa_repetitions_nr,
                              const int profile_id,
                              rohc_trace_callback2_t trace_cb,
-                             void *const trace_cb_priv)
-	__attribute__((nonnull(1)));
+                             void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level)
+	__attribute__((nonnull(1, 2)));
 
 void rohc_comp_list_ipv6_free(struct list_comp *const comp)
 	__attribute__((nonnull(1)));
@@ -37,6 +37,71 @@
 	rohc_debug(entity_struct, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, \
 	           format, ##__VA_ARGS__)
 
+/** The TS_SCALED increase over which TIME_STRIDE is estimated */
+#define ROHC_TS_SC_TIME_STRIDE_SPAN  32U
+
+
+static void c_ts_sc_set_stride(struct ts_sc_comp *const ts_sc,
+                               const uint32_t ts_stride)
+	__attribute__((nonnull(1)));
+
+static void c_ts_sc_reset_time_stride(struct ts_sc_comp *const ts_sc)
+	__attribute__((nonnull(1)));
+
+static size_t c_ts_sc_nb_bits_timer(const struct ts_sc_comp *const ts_sc)
+	__attribute__((nonnull(1), warn_unused_result));
+
+static int64_t c_ts_sc_div_floor(const int64_t x, const uint32_t d)
+	__attribute__((warn_unused_result, const));
+
+
+/**
+ * @brief Set the TS_STRIDE value and compute its inverse if it changed
+ *
+ * The inverse replaces the divisions by TS_STRIDE on every packet with
+ * multiplications and shifts.
+ *
+ * @param ts_sc      The ts_sc_comp object
+ * @param ts_stride  The new TS_STRIDE value, shall not be zero
+ */
+static void c_ts_sc_set_stride(struct ts_sc_comp *const ts_sc,
+                               const uint32_t ts_stride)
+{
+	assert(ts_stride != 0);
+	if(ts_stride != ts_sc->ts_stride_div.divisor)
+	{
+		rohc_div32_init(&ts_sc->ts_stride_div, ts_stride);
+
+		/* TS_SCALED changes meaning, so does TIME_STRIDE */
+		c_ts_sc_reset_time_stride(ts_sc);
+	}
+	ts_sc->ts_stride = ts_stride;
+}
+
+
+/**
+ * @brief Forget TIME_STRIDE and the time offsets of the last packets
+ *
+ * The decompressor forgets TIME_STRIDE as well when TS_STRIDE changes, so
+ * TIME_STRIDE shall be estimated and transmitted again.
+ *
+ * @param ts_sc  The ts_sc_comp object
+ */
+static void c_ts_sc_reset_time_stride(struct ts_sc_comp *const ts_sc)
+{
+	if(ts_sc->time_stride != 0)
+	{
+		ts_debug(ts_sc, "TS_STRIDE changed, forget TIME_STRIDE %u",
+		         ts_sc->time_stride);
+	}
+	ts_sc->time_stride = 0;
+	ts_sc->send_time_stride = false;
+	ts_sc->nr_init_time_stride_packets = 0;
+	ts_sc->is_time_stride_ref_init = false;
+	ts_sc->is_time_offset_valid = false;
+	wlsb_reset(&ts_sc->time_offsets_wlsb);
+}
+
 
 /**
  * @brief Create the ts_sc_comp object
@@ -44,21 +109,26 @@
  * @param ts_sc              The ts_sc_comp object to create
  * @param wlsb_window_width  The width of the W-LSB sliding window to use
  *                           for TS_STRIDE (must be > 0)
+ * @param mempool            The memory pool to allocate the W-LSB windows from
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
  *                           callback, may be NULL
+ * @param trace_level        The lowest level of the traces to print
  * @return                   true if creation is successful, false otherwise
  */
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
+                 struct rohc_mempool *const mempool,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_level)
 {
 	bool is_ok;
 
 	assert(wlsb_window_width > 0);
 
 	ts_sc->ts_stride = 0;
+	ts_sc->ts_stride_div.divisor = 0;
 	ts_sc->ts_scaled = 0;
 	ts_sc->ts_offset = 0;
 	ts_sc->old_ts = 0;
@@ -70,12 +140,26 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 	ts_sc->state = INIT_TS;
 	ts_sc->are_old_val_init = false;
 	ts_sc->nr_init_stride_packets = 0;
+	ts_sc->ts_stride_hint = 0;
+
+	ts_sc->is_timer_enabled = false;
+	ts_sc->send_time_stride = false;
+	ts_sc->is_time_offset_valid = false;
+	ts_sc->is_time_stride_ref_init = false;
+	ts_sc->nr_init_time_stride_packets = 0;
+	ts_sc->timer_jitter = 0;
+	ts_sc->time_stride = 0;
+	ts_sc->time = 0;
+	ts_sc->time_offset = 0;
+	ts_sc->time_stride_ref_time = 0;
+	ts_sc->time_stride_ref_ts_scaled = 0;
 
 	ts_sc->trace_callback = trace_cb;
 	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_level = trace_level;
 
 	/* W-LSB context for TS_SCALED */
-	is_ok = wlsb_new(&ts_sc->ts_scaled_wlsb, wlsb_window_width);
+	is_ok = wlsb_new(&ts_sc->ts_scaled_wlsb, wlsb_window_width, mempool);
 	if(!is_ok)
 	{
 		rohc_error(ts_sc, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -84,7 +168,7 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 	}
 
 	/* W-LSB context for unscaled TS */
-	is_ok = wlsb_new(&ts_sc->ts_unscaled_wlsb, wlsb_window_width);
+	is_ok = wlsb_new(&ts_sc->ts_unscaled_wlsb, wlsb_window_width, mempool);
 	if(!is_ok)
 	{
 		rohc_error(ts_sc, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -92,8 +176,19 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 		goto free_ts_scaled_wlsb;
 	}
 
+	/* W-LSB context for the time offsets of the timer-based encoding */
+	is_ok = wlsb_new(&ts_sc->time_offsets_wlsb, wlsb_window_width, mempool);
+	if(!is_ok)
+	{
+		rohc_error(ts_sc, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot create a W-LSB window for time offsets");
+		goto free_ts_unscaled_wlsb;
+	}
+
 	return true;
 
+free_ts_unscaled_wlsb:
+	wlsb_free(&ts_sc->ts_unscaled_wlsb);
 free_ts_scaled_wlsb:
 	wlsb_free(&ts_sc->ts_scaled_wlsb);
 error:
@@ -108,11 +203,175 @@ error:
  */
 void c_destroy_sc(struct ts_sc_comp *const ts_sc)
 {
+	wlsb_free(&ts_sc->time_offsets_wlsb);
 	wlsb_free(&ts_sc->ts_unscaled_wlsb);
 	wlsb_free(&ts_sc->ts_scaled_wlsb);
 }
 
 
+/**
+ * @brief Give the TS_STRIDE expected for the stream before its first TS
+ *
+ * The expected TS_STRIDE is used from the first TS on, so that TS_STRIDE is
+ * transmitted in the first packet instead of being computed later from the
+ * delta between two TS. It is forgotten as soon as one TS delta is not a
+ * multiple of it.
+ *
+ * @param ts_sc      The ts_sc_comp object
+ * @param ts_stride  The expected TS_STRIDE, 0 if unknown
+ */
+void c_ts_sc_set_stride_hint(struct ts_sc_comp *const ts_sc,
+                             const uint32_t ts_stride)
+{
+	assert(!ts_sc->are_old_val_init);
+	assert(sdvl_can_value_be_encoded(ts_stride));
+	ts_sc->ts_stride_hint = ts_stride;
+}
+
+
+/**
+ * @brief Allow the timer-based encoding of TS_SCALED
+ *
+ * See section 4.5.4 of RFC 3095: once TIME_STRIDE is known by both sides,
+ * the decompressor approximates TS_SCALED from the arrival time of the
+ * packet, so that the compressor only transmits the bits that correct the
+ * approximation.
+ *
+ * @param ts_sc       The ts_sc_comp object
+ * @param max_jitter  The maximal jitter (in milliseconds) of the channel
+ *                    between the compressor and the decompressor
+ */
+void c_ts_sc_enable_timer(struct ts_sc_comp *const ts_sc,
+                          const uint32_t max_jitter)
+{
+	ts_sc->is_timer_enabled = true;
+	ts_sc->timer_jitter = max_jitter;
+}
+
+
+/**
+ * @brief Store the arrival time of the packet whose TS was just added
+ *
+ * Estimate TIME_STRIDE from the arrival times of the packets if it is not
+ * known yet, then compute the time offset of the packet, ie. its TS_SCALED
+ * converted in milliseconds minus its arrival time. The offsets between two
+ * packets tell how far the approximation of TS_SCALED by the decompressor
+ * may be.
+ *
+ * @param ts_sc  The ts_sc_comp object
+ * @param time   The arrival time of the packet (in milliseconds)
+ */
+void c_ts_sc_add_time(struct ts_sc_comp *const ts_sc,
+                      const uint32_t time)
+{
+	uint32_t ts_scaled;
+
+	ts_sc->time = time;
+	ts_sc->is_time_offset_valid = false;
+
+	if(!ts_sc->is_timer_enabled || ts_sc->ts_stride == 0)
+	{
+		return;
+	}
+
+	/* TS_SCALED as the decompressor computes it, whatever the state */
+	ts_scaled = rohc_div32_quot(ts_sc->ts, &ts_sc->ts_stride_div);
+
+	if(ts_sc->time_stride == 0)
+	{
+		const uint32_t ts_scaled_delta = ts_scaled - ts_sc->time_stride_ref_ts_scaled;
+		const uint32_t time_delta = time - ts_sc->time_stride_ref_time;
+		uint32_t time_stride;
+
+		/* restart the estimation if TS or time went backward */
+		if(!ts_sc->is_time_stride_ref_init ||
+		   ts_scaled_delta >= 0x80000000U || time_delta >= 0x80000000U)
+		{
+			ts_sc->time_stride_ref_time = time;
+			ts_sc->time_stride_ref_ts_scaled = ts_scaled;
+			ts_sc->is_time_stride_ref_init = true;
+			return;
+		}
+		if(ts_scaled_delta < ROHC_TS_SC_TIME_STRIDE_SPAN)
+		{
+			return;
+		}
+
+		time_stride = (time_delta + ts_scaled_delta / 2) / ts_scaled_delta;
+		if(time_stride == 0 || !sdvl_can_value_be_encoded(time_stride))
+		{
+			ts_debug(ts_sc, "TIME_STRIDE of %u ms for %u TS_SCALED cannot be "
+			         "transmitted, estimate it again", time_delta, ts_scaled_delta);
+			ts_sc->time_stride_ref_time = time;
+			ts_sc->time_stride_ref_ts_scaled = ts_scaled;
+			return;
+		}
+		ts_debug(ts_sc, "TIME_STRIDE = %u ms / %u = %u ms", time_delta,
+		         ts_scaled_delta, time_stride);
+		ts_sc->time_stride = time_stride;
+		ts_sc->send_time_stride = true;
+		ts_sc->nr_init_time_stride_packets = 0;
+	}
+
+	ts_sc->time_offset = ts_scaled * ts_sc->time_stride - time;
+	ts_sc->is_time_offset_valid = true;
+	ts_debug(ts_sc, "time offset = %u * %u - %u = %u", ts_scaled,
+	         ts_sc->time_stride, time, ts_sc->time_offset);
+}
+
+
+/**
+ * @brief Whether TIME_STRIDE shall be transmitted in the current packet
+ *
+ * @param ts_sc  The ts_sc_comp object
+ * @return       true if TIME_STRIDE shall be transmitted, false otherwise
+ */
+bool rohc_ts_sc_send_time_stride(const struct ts_sc_comp *const ts_sc)
+{
+	return (ts_sc->time_stride != 0 && ts_sc->send_time_stride);
+}
+
+
+/**
+ * @brief Record that TIME_STRIDE was transmitted in the current packet
+ *
+ * TS_SCALED is compressed with the timer-based encoding alone once
+ * TIME_STRIDE was transmitted enough times.
+ *
+ * @param ts_sc              The ts_sc_comp object
+ * @param oa_repetitions_nr  The number of transmissions for robustness
+ */
+void c_ts_sc_time_stride_sent(struct ts_sc_comp *const ts_sc,
+                              const uint8_t oa_repetitions_nr)
+{
+	if(ts_sc->nr_init_time_stride_packets < oa_repetitions_nr)
+	{
+		ts_sc->nr_init_time_stride_packets++;
+	}
+	if(ts_sc->nr_init_time_stride_packets >= oa_repetitions_nr)
+	{
+		ts_debug(ts_sc, "TIME_STRIDE transmitted at least %u times, so use "
+		         "the timer-based encoding of TS_SCALED", oa_repetitions_nr);
+		ts_sc->send_time_stride = false;
+	}
+}
+
+
+/**
+ * @brief Transmit TIME_STRIDE again, eg. after a transition back to IR
+ *
+ * @param ts_sc  The ts_sc_comp object
+ */
+void c_ts_sc_resend_time_stride(struct ts_sc_comp *const ts_sc)
+{
+	if(ts_sc->time_stride != 0)
+	{
+		ts_sc->send_time_stride = true;
+		ts_sc->nr_init_time_stride_packets = 0;
+	}
+}
+
+
 /**
  * @brief Store the new TS, calculate new values and update the state
  *
@@ -139,12 +398,27 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 	ts_sc->ts = ts;
 	ts_sc->sn = sn;
 
-	/* if we had no old values, TS_STRIDE cannot be computed yet */
+	/* if we had no old values, TS_STRIDE cannot be computed yet, but it may
+	 * be expected for the stream */
 	if(!ts_sc->are_old_val_init)
 	{
 		assert(ts_sc->state == INIT_TS);
-		ts_debug(ts_sc, "TS_STRIDE cannot be computed, stay in INIT_TS state");
 		ts_sc->are_old_val_init = true;
+		if(ts_sc->ts_stride_hint == 0)
+		{
+			ts_debug(ts_sc, "TS_STRIDE cannot be computed, stay in INIT_TS state");
+			return;
+		}
+		ts_debug(ts_sc, "TS_STRIDE %u is expected, go to INIT_STRIDE state",
+		         ts_sc->ts_stride_hint);
+		ts_sc->state = INIT_STRIDE;
+		ts_sc->nr_init_stride_packets = 0;
+		c_ts_sc_set_stride(ts_sc, ts_sc->ts_stride_hint);
+		ts_sc->ts_offset = rohc_div32_rem(ts_sc->ts, &ts_sc->ts_stride_div);
+		ts_sc->ts_scaled = rohc_div32_quot(ts_sc->ts - ts_sc->ts_offset,
+		                                   &ts_sc->ts_stride_div);
+		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", ts_sc->ts,
+		         ts_sc->ts_offset, ts_sc->ts_stride, ts_sc->ts_scaled);
 		return;
 	}
 
@@ -200,27 +474,46 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 
 	if(ts_sc->state == INIT_STRIDE)
 	{
+		uint32_t ts_stride = ts_sc->ts_delta;
+
 		/* TS is changing and TS_STRIDE can be computed but TS_STRIDE was
 		 * not transmitted enough times to the decompressor to be used */
 		ts_debug(ts_sc, "state INIT_STRIDE");
 
+		/* keep the expected TS_STRIDE as long as TS changes by multiples of it */
+		if(ts_sc->ts_stride_hint != 0)
+		{
+			if((ts_sc->ts_delta % ts_sc->ts_stride_hint) == 0)
+			{
+				ts_stride = ts_sc->ts_stride_hint;
+			}
+			else
+			{
+				ts_debug(ts_sc, "TS delta %u is not a multiple of the expected "
+				         "TS_STRIDE %u, forget it", ts_sc->ts_delta,
+				         ts_sc->ts_stride_hint);
+				ts_sc->ts_stride_hint = 0;
+			}
+		}
+
 		/* reset INIT_STRIDE counter if TS_STRIDE/TS_OFFSET changed */
-		if(ts_sc->ts_delta != ts_sc->ts_stride ||
-		   (ts_sc->ts % ts_sc->ts_delta) != ts_sc->ts_offset)
+		if(ts_stride != ts_sc->ts_stride ||
+		   rohc_div32_rem(ts_sc->ts, &ts_sc->ts_stride_div) != ts_sc->ts_offset)
 		{
 			ts_debug(ts_sc, "TS_STRIDE and/or TS_OFFSET changed");
 			ts_sc->nr_init_stride_packets = 0;
 		}
 
 		/* compute TS_STRIDE, TS_OFFSET and TS_SCALED */
-		ts_sc->ts_stride = ts_sc->ts_delta;
+		c_ts_sc_set_stride(ts_sc, ts_stride);
 		ts_debug(ts_sc, "TS_STRIDE = %u", ts_sc->ts_stride);
 		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_offset = ts_sc->ts % ts_sc->ts_stride;
+		ts_sc->ts_offset = rohc_div32_rem(ts_sc->ts, &ts_sc->ts_stride_div);
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         ts_sc->ts, ts_sc->ts_stride, ts_sc->ts_offset);
 		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_scaled = (ts_sc->ts - ts_sc->ts_offset) / ts_sc->ts_stride;
+		ts_sc->ts_scaled = rohc_div32_quot(ts_sc->ts - ts_sc->ts_offset,
+		                                   &ts_sc->ts_stride_div);
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", ts_sc->ts,
 		         ts_sc->ts_offset, ts_sc->ts_stride, ts_sc->ts_scaled);
 	}
@@ -239,7 +532,7 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 		if(ts_sc->ts_delta != ts_sc->ts_stride)
 		{
 			assert(ts_sc->ts_stride != 0);
-			if((ts_sc->ts_delta % ts_sc->ts_stride) != 0)
+			if(rohc_div32_rem(ts_sc->ts_delta, &ts_sc->ts_stride_div) != 0)
 			{
 				/* TS delta changed and is not a multiple of previous TS_STRIDE:
 				 * record the new value as TS_STRIDE and transmit it several
@@ -251,9 +544,20 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 				ts_sc->state = INIT_STRIDE;
 				ts_sc->nr_init_stride_packets = 0;
 				ts_debug(ts_sc, "state -> INIT_STRIDE");
-				ts_sc->ts_stride = ts_sc->ts_delta;
+				c_ts_sc_set_stride(ts_sc, ts_sc->ts_delta);
+			}
+			else if(rohc_div32_quot(ts_sc->ts_delta, &ts_sc->ts_stride_div) != sn_delta &&
+			        ts_sc->time_stride != 0 && !ts_sc->send_time_stride)
+			{
+				/* TS delta changed but is a multiple of previous TS_STRIDE, and
+				 * the decompressor approximates the jump from the arrival time:
+				 * keep on sending TS_SCALED */
+				ts_debug(ts_sc, "/!\\ TS delta changed but is a multiple of "
+				         "previous TS_STRIDE, so do not change TS_STRIDE and "
+				         "send the timer-based TS_SCALED (probably a silence "
+				         "period at source)");
 			}
-			else if((ts_sc->ts_delta / ts_sc->ts_stride) != sn_delta)
+			else if(rohc_div32_quot(ts_sc->ts_delta, &ts_sc->ts_stride_div) != sn_delta)
 			{
 				/* TS delta changed but is a multiple of previous TS_STRIDE:
 				 * do not change TS_STRIDE, but transmit all TS bits several
@@ -278,13 +582,14 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 
 		/* update TS_OFFSET is needed */
 		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_offset = ts_sc->ts % ts_sc->ts_stride;
+		ts_sc->ts_offset = rohc_div32_rem(ts_sc->ts, &ts_sc->ts_stride_div);
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         ts_sc->ts, ts_sc->ts_stride, ts_sc->ts_offset);
 
 		/* compute TS_SCALED */
 		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_scaled = (ts_sc->ts - ts_sc->ts_offset) / ts_sc->ts_stride;
+		ts_sc->ts_scaled = rohc_div32_quot(ts_sc->ts - ts_sc->ts_offset,
+		                                   &ts_sc->ts_stride_div);
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", ts_sc->ts,
 		         ts_sc->ts_offset, ts_sc->ts_stride, ts_sc->ts_scaled);
 
@@ -372,95 +677,100 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
  */
 size_t nb_bits_unscaled(const struct ts_sc_comp *const ts_sc)
 {
+	struct wlsb_range ts_range;
 	size_t nr_ts_bits;
 
-	if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                              0, rohc_interval_compute_p_rtp_ts(0)))
+	/* p depends on k for RTP TS, so walk the window only once to get the
+	 * range of offsets, then check every k */
+	wlsb_get_range_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts, &ts_range);
+
+	if(wlsb_range_is_kp_possible(&ts_range, 0,
+	                             rohc_interval_compute_p_rtp_ts(0)))
 	{
 		nr_ts_bits = 0;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   5, rohc_interval_compute_p_rtp_ts(5)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 5,
+	                                  rohc_interval_compute_p_rtp_ts(5)))
 	{
 		nr_ts_bits = 5;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   6, rohc_interval_compute_p_rtp_ts(6)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 6,
+	                                  rohc_interval_compute_p_rtp_ts(6)))
 	{
 		nr_ts_bits = 6;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   7, rohc_interval_compute_p_rtp_ts(7)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 7,
+	                                  rohc_interval_compute_p_rtp_ts(7)))
 	{
 		nr_ts_bits = 7;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   8, rohc_interval_compute_p_rtp_ts(8)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 8,
+	                                  rohc_interval_compute_p_rtp_ts(8)))
 	{
 		nr_ts_bits = 8;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   9, rohc_interval_compute_p_rtp_ts(9)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 9,
+	                                  rohc_interval_compute_p_rtp_ts(9)))
 	{
 		nr_ts_bits = 9;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   12, rohc_interval_compute_p_rtp_ts(12)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 12,
+	                                  rohc_interval_compute_p_rtp_ts(12)))
 	{
 		nr_ts_bits = 12;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   13, rohc_interval_compute_p_rtp_ts(13)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 13,
+	                                  rohc_interval_compute_p_rtp_ts(13)))
 	{
 		nr_ts_bits = 13;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   14, rohc_interval_compute_p_rtp_ts(14)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 14,
+	                                  rohc_interval_compute_p_rtp_ts(14)))
 	{
 		nr_ts_bits = 14;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   16, rohc_interval_compute_p_rtp_ts(16)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 16,
+	                                  rohc_interval_compute_p_rtp_ts(16)))
 	{
 		nr_ts_bits = 16;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   17, rohc_interval_compute_p_rtp_ts(17)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 17,
+	                                  rohc_interval_compute_p_rtp_ts(17)))
 	{
 		nr_ts_bits = 17;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   19, rohc_interval_compute_p_rtp_ts(19)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 19,
+	                                  rohc_interval_compute_p_rtp_ts(19)))
 	{
 		nr_ts_bits = 19;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   20, rohc_interval_compute_p_rtp_ts(20)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 20,
+	                                  rohc_interval_compute_p_rtp_ts(20)))
 	{
 		nr_ts_bits = 20;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   21, rohc_interval_compute_p_rtp_ts(21)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 21,
+	                                  rohc_interval_compute_p_rtp_ts(21)))
 	{
 		nr_ts_bits = 21;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   25, rohc_interval_compute_p_rtp_ts(25)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 25,
+	                                  rohc_interval_compute_p_rtp_ts(25)))
 	{
 		nr_ts_bits = 25;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   26, rohc_interval_compute_p_rtp_ts(26)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 26,
+	                                  rohc_interval_compute_p_rtp_ts(26)))
 	{
 		nr_ts_bits = 26;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   27, rohc_interval_compute_p_rtp_ts(27)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 27,
+	                                  rohc_interval_compute_p_rtp_ts(27)))
 	{
 		nr_ts_bits = 27;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   29, rohc_interval_compute_p_rtp_ts(29)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 29,
+	                                  rohc_interval_compute_p_rtp_ts(29)))
 	{
 		nr_ts_bits = 29;
 	}
@@ -482,6 +792,13 @@ size_t nb_bits_unscaled(const struct ts_sc_comp *const ts_sc)
 void add_unscaled(struct ts_sc_comp *const ts_sc, const uint16_t sn)
 {
 	c_add_wlsb(&ts_sc->ts_unscaled_wlsb, sn, ts_sc->ts);
+
+	/* the decompressor takes every packet as reference for the timer-based
+	 * encoding, whether its TS is scaled or not */
+	if(ts_sc->is_time_offset_valid)
+	{
+		c_add_wlsb(&ts_sc->time_offsets_wlsb, sn, ts_sc->time_offset);
+	}
 }
 
 
@@ -493,95 +810,100 @@ void add_unscaled(struct ts_sc_comp *const ts_sc, const uint16_t sn)
  */
 size_t nb_bits_scaled(const struct ts_sc_comp *const ts_sc)
 {
+	struct wlsb_range ts_range;
 	size_t nr_ts_bits;
 
-	if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                              0, rohc_interval_compute_p_rtp_ts(0)))
+	/* p depends on k for RTP TS, so walk the window only once to get the
+	 * range of offsets, then check every k */
+	wlsb_get_range_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled, &ts_range);
+
+	if(wlsb_range_is_kp_possible(&ts_range, 0,
+	                             rohc_interval_compute_p_rtp_ts(0)))
 	{
 		nr_ts_bits = 0;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   5, rohc_interval_compute_p_rtp_ts(5)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 5,
+	                                  rohc_interval_compute_p_rtp_ts(5)))
 	{
 		nr_ts_bits = 5;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   6, rohc_interval_compute_p_rtp_ts(6)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 6,
+	                                  rohc_interval_compute_p_rtp_ts(6)))
 	{
 		nr_ts_bits = 6;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   7, rohc_interval_compute_p_rtp_ts(7)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 7,
+	                                  rohc_interval_compute_p_rtp_ts(7)))
 	{
 		nr_ts_bits = 7;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   8, rohc_interval_compute_p_rtp_ts(8)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 8,
+	                                  rohc_interval_compute_p_rtp_ts(8)))
 	{
 		nr_ts_bits = 8;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   9, rohc_interval_compute_p_rtp_ts(9)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 9,
+	                                  rohc_interval_compute_p_rtp_ts(9)))
 	{
 		nr_ts_bits = 9;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   12, rohc_interval_compute_p_rtp_ts(12)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 12,
+	                                  rohc_interval_compute_p_rtp_ts(12)))
 	{
 		nr_ts_bits = 12;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   13, rohc_interval_compute_p_rtp_ts(13)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 13,
+	                                  rohc_interval_compute_p_rtp_ts(13)))
 	{
 		nr_ts_bits = 13;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   14, rohc_interval_compute_p_rtp_ts(14)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 14,
+	                                  rohc_interval_compute_p_rtp_ts(14)))
 	{
 		nr_ts_bits = 14;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   16, rohc_interval_compute_p_rtp_ts(16)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 16,
+	                                  rohc_interval_compute_p_rtp_ts(16)))
 	{
 		nr_ts_bits = 16;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   17, rohc_interval_compute_p_rtp_ts(17)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 17,
+	                                  rohc_interval_compute_p_rtp_ts(17)))
 	{
 		nr_ts_bits = 17;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   19, rohc_interval_compute_p_rtp_ts(19)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 19,
+	                                  rohc_interval_compute_p_rtp_ts(19)))
 	{
 		nr_ts_bits = 19;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   20, rohc_interval_compute_p_rtp_ts(20)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 20,
+	                                  rohc_interval_compute_p_rtp_ts(20)))
 	{
 		nr_ts_bits = 20;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   21, rohc_interval_compute_p_rtp_ts(21)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 21,
+	                                  rohc_interval_compute_p_rtp_ts(21)))
 	{
 		nr_ts_bits = 21;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   25, rohc_interval_compute_p_rtp_ts(25)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 25,
+	                                  rohc_interval_compute_p_rtp_ts(25)))
 	{
 		nr_ts_bits = 25;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   26, rohc_interval_compute_p_rtp_ts(26)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 26,
+	                                  rohc_interval_compute_p_rtp_ts(26)))
 	{
 		nr_ts_bits = 26;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   27, rohc_interval_compute_p_rtp_ts(27)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 27,
+	                                  rohc_interval_compute_p_rtp_ts(27)))
 	{
 		nr_ts_bits = 27;
 	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   29, rohc_interval_compute_p_rtp_ts(29)))
+	else if(wlsb_range_is_kp_possible(&ts_range, 29,
+	                                  rohc_interval_compute_p_rtp_ts(29)))
 	{
 		nr_ts_bits = 29;
 	}
@@ -597,10 +919,108 @@ size_t nb_bits_scaled(const struct ts_sc_comp *const ts_sc)
 		nr_ts_bits = 1;
 	}
 
+	/* once the decompressor may know TIME_STRIDE, it interprets the TS_SCALED
+	 * bits with the timer-based encoding: send enough bits for both encodings
+	 * while TIME_STRIDE is transmitted, then for the timer-based one only */
+	if(nr_ts_bits > 0 && ts_sc->time_stride != 0)
+	{
+		const size_t nr_ts_bits_timer = c_ts_sc_nb_bits_timer(ts_sc);
+
+		if(!ts_sc->send_time_stride)
+		{
+			nr_ts_bits = nr_ts_bits_timer;
+		}
+		else if(nr_ts_bits_timer > nr_ts_bits)
+		{
+			nr_ts_bits = nr_ts_bits_timer;
+		}
+	}
+
 	return nr_ts_bits;
 }
 
 
+/**
+ * @brief Return the number of bits needed to encode TS_SCALED with timer
+ *
+ * The decompressor approximates TS_SCALED with the TS_SCALED and the arrival
+ * time of its reference packet, see section 4.5.4 of RFC 3095:
+ *   approx = TS_SCALED_ref + round((arrival_time - arrival_time_ref) /
+ *                                  TIME_STRIDE)
+ * then it decodes the k bits of TS_SCALED in the interpretation interval
+ * [approx + 1 - 2^(k-1), approx + 2^(k-1)].
+ *
+ * Every packet of the W-LSB window may be the reference. For each of them,
+ * the difference between the time offsets of the packet and the reference
+ * is the error of the approximation in milliseconds, up to the jitter of
+ * the channel and the precision of the clocks.
+ *
+ * @param ts_sc  The ts_sc_comp object
+ * @return       The number of bits needed to encode TS_SCALED
+ */
+static size_t c_ts_sc_nb_bits_timer(const struct ts_sc_comp *const ts_sc)
+{
+	const int64_t margin = ((int64_t) ts_sc->timer_jitter) + 2;
+	struct wlsb_range range;
+	int64_t err_min;
+	int64_t err_max;
+	size_t k;
+
+	if(!ts_sc->is_time_offset_valid || ts_sc->time_offsets_wlsb.count == 0)
+	{
+		return 32;
+	}
+
+	/* the errors of the approximation in TS_SCALED units, rounding of the
+	 * approximation included */
+	wlsb_get_range_32bits(&ts_sc->time_offsets_wlsb, ts_sc->time_offset, &range);
+	err_min = c_ts_sc_div_floor(range.min - margin, ts_sc->time_stride) - 1;
+	err_max = -c_ts_sc_div_floor(-(range.max + margin), ts_sc->time_stride) + 1;
+
+	for(k = 1; k < 32; k++)
+	{
+		const int64_t half = ((int64_t) 1) << (k - 1);
+
+		if(err_min >= (1 - half) && err_max <= half)
+		{
+			break;
+		}
+	}
+	ts_debug(ts_sc, "TS_SCALED approximation error in [%ld, %ld], so %zu "
+	         "bits required with timer-based encoding", (long) err_min,
+	         (long) err_max, k);
+
+	return k;
+}
+
+
+/**
+ * @brief Divide and round towards minus infinity
+ *
+ * The magnitude of the dividend shall be smaller than 2^32 - d, so that the
+ * division is done on 32 bits.
+ *
+ * @param x  The dividend
+ * @param d  The divisor, shall not be zero
+ * @return   The quotient rounded towards minus infinity
+ */
+static int64_t c_ts_sc_div_floor(const int64_t x, const uint32_t d)
+{
+	int64_t quot;
+
+	if(x >= 0)
+	{
+		quot = ((uint32_t) x) / d;
+	}
+	else
+	{
+		quot = -((int64_t) ((((uint32_t) (-x)) + d - 1) / d));
+	}
+
+	return quot;
+}
+
+
 /**
  * @brief Add a new TS_SCALED value to the ts_sc_comp object
  *
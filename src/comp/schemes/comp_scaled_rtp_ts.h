@@ -32,6 +32,7 @@
 #define ROHC_COMP_SCHEMES_SCALED_RTP_TS_H
 
 #include "comp_wlsb.h"
+#include "rohc_div.h"
 #include "rohc_traces.h"
 
 #include <stdbool.h>
@@ -64,6 +65,8 @@ struct ts_sc_comp
 {
 	/// The TS_STRIDE value
 	uint32_t ts_stride;
+	/** The inverse of TS_STRIDE, computed again only when TS_STRIDE changes */
+	struct rohc_div32 ts_stride_div;
 
 	/// The TS_SCALED value
 	uint32_t ts_scaled;
@@ -98,10 +101,47 @@ struct ts_sc_comp
 	/// The difference between old and current TS
 	uint32_t ts_delta;
 
+	/** The TS_STRIDE expected for the stream, 0 if unknown or if the TS of
+	 *  the stream contradicted it */
+	uint32_t ts_stride_hint;
+
+	/* the attributes below are related to the timer-based compression of
+	 * TS_SCALED (see section 4.5.4 of RFC 3095) */
+
+	/** Whether TS_SCALED may be compressed with the timer-based encoding */
+	bool is_timer_enabled;
+	/** Whether TIME_STRIDE shall be transmitted before the timer-based
+	 *  encoding is used alone */
+	bool send_time_stride;
+	/** Whether the time offset of the current packet is valid */
+	bool is_time_offset_valid;
+	/** Whether the reference to estimate TIME_STRIDE is initialized */
+	bool is_time_stride_ref_init;
+	/** The number of packets that transmitted TIME_STRIDE */
+	size_t nr_init_time_stride_packets;
+	/** The maximal jitter (in milliseconds) of the channel between the
+	 *  compressor and the decompressor */
+	uint32_t timer_jitter;
+	/** The TIME_STRIDE value (in milliseconds), 0 if not determined yet */
+	uint32_t time_stride;
+	/** The arrival time (in milliseconds) of the current packet */
+	uint32_t time;
+	/** The time offset of the current packet, ie. TS_SCALED * TIME_STRIDE
+	 *  minus the arrival time */
+	uint32_t time_offset;
+	/** The W-LSB object of the time offsets of the last packets */
+	struct c_wlsb time_offsets_wlsb;
+	/** The arrival time of the packet TIME_STRIDE is estimated from */
+	uint32_t time_stride_ref_time;
+	/** The TS_SCALED of the packet TIME_STRIDE is estimated from */
+	uint32_t time_stride_ref_ts_scaled;
+
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces given to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
@@ -112,12 +152,32 @@ struct ts_sc_comp
 
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
+                 struct rohc_mempool *const mempool,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
-	__attribute__((warn_unused_result, nonnull(1)));
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_level)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
 void c_destroy_sc(struct ts_sc_comp *const ts_sc)
 	__attribute__((nonnull(1)));
 
+void c_ts_sc_set_stride_hint(struct ts_sc_comp *const ts_sc,
+                             const uint32_t ts_stride)
+	__attribute__((nonnull(1)));
+
+void c_ts_sc_enable_timer(struct ts_sc_comp *const ts_sc,
+                          const uint32_t max_jitter)
+	__attribute__((nonnull(1)));
+void c_ts_sc_add_time(struct ts_sc_comp *const ts_sc,
+                      const uint32_t time)
+	__attribute__((nonnull(1)));
+bool rohc_ts_sc_send_time_stride(const struct ts_sc_comp *const ts_sc)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+void c_ts_sc_time_stride_sent(struct ts_sc_comp *const ts_sc,
+                              const uint8_t oa_repetitions_nr)
+	__attribute__((nonnull(1)));
+void c_ts_sc_resend_time_stride(struct ts_sc_comp *const ts_sc)
+	__attribute__((nonnull(1)));
+
 void c_add_ts(struct ts_sc_comp *const ts_sc,
               const uint32_t ts,
               const uint16_t sn)
@@ -27,6 +27,7 @@
 
 #include "comp_wlsb.h"
 #include "interval.h" /* for the rohc_f_*bits() functions */
+#include "rohc_utils.h"
 
 #include <string.h>
 #include <assert.h>
@@ -38,6 +39,25 @@
 
 static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 	__attribute__((warn_unused_result, const));
+static size_t wlsb_get_newest(const struct c_wlsb *const wlsb)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static size_t wlsb_get_nth_older(const struct c_wlsb *const wlsb,
+                                 const size_t nth)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static size_t wlsb_find_sn_dist(const struct c_wlsb *const wlsb,
+                                const uint32_t dist)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static size_t wlsb_get_minkp(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             const rohc_lsb_shift_t p,
+                             const uint8_t bits_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void wlsb_get_range(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           const uint8_t bits_nr,
+                           struct wlsb_range *const range)
+	__attribute__((nonnull(1, 4)));
 
 
 /*
@@ -50,20 +70,33 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
  *
  * @param[in,out] wlsb The W-LSB encoding object to create
  * @param window_width The number of entries in the window (power of 2)
+ * @param mempool      The memory pool to allocate the window from
  * @return             true if the W-LSB encoding object was created,
  *                     false if it was not
  */
 bool wlsb_new(struct c_wlsb *const wlsb,
-              const size_t window_width)
+              const size_t window_width,
+              struct rohc_mempool *const mempool)
 {
 	assert(window_width > 0);
 	assert(window_width <= ROHC_WLSB_WIDTH_MAX);
 
-	wlsb->window = malloc(sizeof(struct c_window) * window_width);
-	if(wlsb->window == NULL)
+	if(window_width <= ROHC_WLSB_INLINE_WIDTH)
 	{
-		goto error;
+		wlsb->sns = wlsb->inline_sns;
+		wlsb->values = wlsb->inline_values;
+	}
+	else
+	{
+		/* one block for both the SNs and the values */
+		wlsb->sns = rohc_mempool_alloc(mempool, sizeof(uint32_t) * window_width * 2);
+		if(wlsb->sns == NULL)
+		{
+			goto error;
+		}
+		wlsb->values = wlsb->sns + window_width;
 	}
+	wlsb->mempool = mempool;
 
 	wlsb->next = 0;
 	wlsb->count = 0;
@@ -88,18 +121,172 @@ error:
 bool wlsb_copy(struct c_wlsb *const dst,
                const struct c_wlsb *const src)
 {
-	const size_t window_mem_size = sizeof(struct c_window) * dst->window_width;
+	const size_t entries_mem_size = sizeof(uint32_t) * src->window_width;
 
 	dst->next = src->next;
 	dst->count = src->count;
 	dst->window_width = src->window_width;
 
-	dst->window = malloc(window_mem_size);
-	if(dst->window == NULL)
+	if(src->window_width <= ROHC_WLSB_INLINE_WIDTH)
+	{
+		dst->sns = dst->inline_sns;
+		dst->values = dst->inline_values;
+	}
+	else
+	{
+		dst->sns = rohc_mempool_alloc(src->mempool, entries_mem_size * 2);
+		if(dst->sns == NULL)
+		{
+			goto error;
+		}
+		dst->values = dst->sns + src->window_width;
+	}
+	dst->mempool = src->mempool;
+	memcpy(dst->sns, src->sns, entries_mem_size);
+	memcpy(dst->values, src->values, entries_mem_size);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Complete the copy of a W-LSB encoding object duplicated with memcpy()
+ *
+ * The inline entries were already duplicated along with the object, so only
+ * the pointers to them are fixed. The entries of wider windows are still
+ * shared with the source object, so they are duplicated in a new block.
+ *
+ * @param[in,out] dst  The W-LSB object that holds a bytewise copy of \e src
+ * @param src          The W-LSB encoding object that was copied
+ * @return             true if the W-LSB encoding object was completed,
+ *                     false if it was not
+ */
+bool wlsb_complete_copy(struct c_wlsb *const dst,
+                        const struct c_wlsb *const src)
+{
+	assert(dst->window_width == src->window_width);
+
+	if(src->window_width <= ROHC_WLSB_INLINE_WIDTH)
+	{
+		dst->sns = dst->inline_sns;
+		dst->values = dst->inline_values;
+	}
+	else
+	{
+		const size_t entries_mem_size = sizeof(uint32_t) * src->window_width;
+
+		dst->sns = rohc_mempool_alloc(src->mempool, entries_mem_size * 2);
+		if(dst->sns == NULL)
+		{
+			goto error;
+		}
+		dst->values = dst->sns + src->window_width;
+		memcpy(dst->sns, src->sns, entries_mem_size);
+		memcpy(dst->values, src->values, entries_mem_size);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the length of the entries of a W-LSB object in a context image
+ *
+ * The inline entries are saved along with the W-LSB object, so only the
+ * entries of wider windows are saved after the profile-specific part of the
+ * context, see \ref wlsb_save.
+ *
+ * @param wlsb  The W-LSB object
+ * @return      The length of the entries to save
+ */
+size_t wlsb_get_image_len(const struct c_wlsb *const wlsb)
+{
+	size_t image_len;
+
+	if(wlsb->window_width <= ROHC_WLSB_INLINE_WIDTH)
+	{
+		image_len = 0;
+	}
+	else
+	{
+		image_len = sizeof(uint32_t) * wlsb->window_width * 2;
+	}
+
+	return image_len;
+}
+
+
+/**
+ * @brief Save the entries of a W-LSB object in a context image
+ *
+ * @param wlsb        The W-LSB object
+ * @param[out] image  The image, at least \ref wlsb_get_image_len bytes long
+ */
+void wlsb_save(const struct c_wlsb *const wlsb, uint8_t *const image)
+{
+	if(wlsb->window_width > ROHC_WLSB_INLINE_WIDTH)
+	{
+		const size_t entries_mem_size = sizeof(uint32_t) * wlsb->window_width;
+
+		memcpy(image, wlsb->sns, entries_mem_size);
+		memcpy(image + entries_mem_size, wlsb->values, entries_mem_size);
+	}
+}
+
+
+/**
+ * @brief Restore a W-LSB object copied bytewise from a context image
+ *
+ * The object read from the image is checked, then its pointers are fixed.
+ * The entries of wider windows are restored in a new block from the given
+ * part of the image.
+ *
+ * @param[in,out] wlsb  The W-LSB object that holds a bytewise copy from the image
+ * @param mempool       The memory pool to allocate wider windows from
+ * @param image         The entries saved by \ref wlsb_save
+ * @param image_len     The length of the entries, shall be
+ *                      \ref wlsb_get_image_len bytes
+ * @return              true if the W-LSB object was restored,
+ *                      false if it was not
+ */
+bool wlsb_restore(struct c_wlsb *const wlsb,
+                  struct rohc_mempool *const mempool,
+                  const uint8_t *const image,
+                  const size_t image_len)
+{
+	if(wlsb->window_width == 0 ||
+	   wlsb->next >= wlsb->window_width ||
+	   wlsb->count > wlsb->window_width ||
+	   image_len != wlsb_get_image_len(wlsb))
 	{
 		goto error;
 	}
-	memcpy(dst->window, src->window, window_mem_size);
+
+	if(wlsb->window_width <= ROHC_WLSB_INLINE_WIDTH)
+	{
+		wlsb->sns = wlsb->inline_sns;
+		wlsb->values = wlsb->inline_values;
+	}
+	else
+	{
+		const size_t entries_mem_size = sizeof(uint32_t) * wlsb->window_width;
+
+		assert(image != NULL);
+		wlsb->sns = rohc_mempool_alloc(mempool, entries_mem_size * 2);
+		if(wlsb->sns == NULL)
+		{
+			goto error;
+		}
+		wlsb->values = wlsb->sns + wlsb->window_width;
+		memcpy(wlsb->sns, image, entries_mem_size * 2);
+	}
+	wlsb->mempool = mempool;
 
 	return true;
 
@@ -115,13 +302,79 @@ error:
  */
 void wlsb_free(struct c_wlsb *const wlsb)
 {
-	free(wlsb->window);
+	if(wlsb->window_width > ROHC_WLSB_INLINE_WIDTH)
+	{
+		rohc_mempool_release(wlsb->mempool, wlsb->sns,
+		                     sizeof(uint32_t) * wlsb->window_width * 2);
+	}
+}
+
+
+/**
+ * @brief Forget all the entries of a W-LSB encoding object
+ *
+ * The window is filled again by the next values added, as for a new W-LSB
+ * object.
+ *
+ * @param wlsb  The W-LSB object
+ */
+void wlsb_reset(struct c_wlsb *const wlsb)
+{
+	wlsb->next = 0;
+	wlsb->count = 0;
+}
+
+
+/**
+ * @brief Change the width of a W-LSB encoding object
+ *
+ * The newest entries are kept when the window is narrowed. The window is
+ * filled by the next values added when it is widened. Only the windows stored
+ * inside the W-LSB object may be resized.
+ *
+ * @param wlsb       The W-LSB object
+ * @param new_width  The new number of entries in the window
+ */
+void wlsb_set_width(struct c_wlsb *const wlsb, const size_t new_width)
+{
+	assert(new_width > 0);
+	assert(new_width <= ROHC_WLSB_INLINE_WIDTH);
+	assert(wlsb->window_width <= ROHC_WLSB_INLINE_WIDTH);
+
+	if(wlsb->count > 0 && new_width != wlsb->window_width)
+	{
+		const size_t kept_nr = rohc_min(wlsb->count, new_width);
+		uint32_t sns[ROHC_WLSB_INLINE_WIDTH];
+		uint32_t values[ROHC_WLSB_INLINE_WIDTH];
+		size_t entry = wlsb->next;
+		size_t i;
+
+		/* copy the kept entries from the newest one to the oldest one */
+		for(i = 0; i < kept_nr; i++)
+		{
+			entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
+			sns[i] = wlsb->sns[entry];
+			values[i] = wlsb->values[entry];
+		}
+
+		/* store them back from the oldest one to the newest one */
+		for(i = 0; i < kept_nr; i++)
+		{
+			wlsb->sns[i] = sns[kept_nr - 1 - i];
+			wlsb->values[i] = values[kept_nr - 1 - i];
+		}
+		wlsb->next = kept_nr % new_width;
+		wlsb->count = kept_nr;
+	}
+	wlsb->window_width = new_width;
 }
 
 
 /**
  * @brief Add a value into a W-LSB encoding object
  *
+ * The oldest entry is overwritten once the window is full.
+ *
  * @param wlsb  The W-LSB object
  * @param sn    The Sequence Number (SN) for the new entry
  * @param value The value to base the LSB coding on
@@ -130,22 +383,12 @@ void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
                 const uint32_t value)
 {
-	if(wlsb->count == 0)
-	{
-		uint8_t i;
-		for(i = 0; i < wlsb->window_width; i++)
-		{
-			wlsb->window[i].sn = sn;
-			wlsb->window[i].value = value;
-			wlsb->next = 1;
-		}
-		wlsb->count = wlsb->window_width;
-	}
-	else
+	wlsb->sns[wlsb->next] = sn;
+	wlsb->values[wlsb->next] = value;
+	wlsb->next = (wlsb->next + 1) % wlsb->window_width;
+	if(wlsb->count < wlsb->window_width)
 	{
-		wlsb->window[wlsb->next].sn = sn;
-		wlsb->window[wlsb->next].value = value;
-		wlsb->next = (wlsb->next + 1) % wlsb->window_width;
+		wlsb->count++;
 	}
 }
 
@@ -183,16 +426,18 @@ bool wlsb_is_kp_possible_8bits(const struct c_wlsb *const wlsb,
 	else
 	{
 		const uint8_t interval_width = (1U << k) - 1; /* interval width = 2^k - 1 */
+		size_t entry = wlsb_get_newest(wlsb);
 		size_t i;
 
 		enc_possible = true;
 
 		/* find the minimal number of bits of the value required to be able
 		 * to recreate it thanks to ANY value in the window */
-		for(i = 0; i < wlsb->window_width; i++)
+		for(i = 0; i < wlsb->count; i++)
 		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint8_t v_ref = entry->value;
+			const uint8_t v_ref = wlsb->values[entry];
+
+			entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
 
 			/* compute the minimal and maximal values of the interval:
 			 *   min = v_ref - p
@@ -259,16 +504,18 @@ bool wlsb_is_kp_possible_16bits(const struct c_wlsb *const wlsb,
 	else
 	{
 		const uint16_t interval_width = (1U << k) - 1; /* interval width = 2^k - 1 */
+		size_t entry = wlsb_get_newest(wlsb);
 		size_t i;
 
 		enc_possible = true;
 
 		/* find the minimal number of bits of the value required to be able
 		 * to recreate it thanks to ANY value in the window */
-		for(i = 0; i < wlsb->window_width; i++)
+		for(i = 0; i < wlsb->count; i++)
 		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint16_t v_ref = entry->value;
+			const uint16_t v_ref = wlsb->values[entry];
+
+			entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
 
 			/* compute the minimal and maximal values of the interval:
 			 *   min = v_ref - p
@@ -337,16 +584,18 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
 	else
 	{
 		const uint32_t interval_width = (1U << k) - 1; /* interval width = 2^k - 1 */
+		size_t entry = wlsb_get_newest(wlsb);
 		size_t i;
 
 		enc_possible = true;
 
 		/* find the minimal number of bits of the value required to be able
 		 * to recreate it thanks to ANY value in the window */
-		for(i = 0; i < wlsb->window_width; i++)
+		for(i = 0; i < wlsb->count; i++)
 		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint32_t v_ref = entry->value;
+			const uint32_t v_ref = wlsb->values[entry];
+
+			entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
 
 			/* compute the minimal and maximal values of the interval:
 			 *   min = v_ref - p
@@ -380,11 +629,180 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
 }
 
 
+/**
+ * @brief Get the minimal number of bits required to encode the given value
+ *
+ * The function is dedicated to 8-bit fields. The window is walked only once,
+ * instead of once per k with wlsb_is_kp_possible_8bits().
+ *
+ * @param wlsb   The W-LSB object
+ * @param value  The value to encode using the LSB algorithm
+ * @param p      The shift parameter p
+ * @return       The minimal number of bits k such that
+ *               wlsb_is_kp_possible_8bits(wlsb, value, k, p) is true
+ */
+size_t wlsb_get_minkp_8bits(const struct c_wlsb *const wlsb,
+                            const uint8_t value,
+                            const rohc_lsb_shift_t p)
+{
+	return wlsb_get_minkp(wlsb, value, p, 8);
+}
+
+
+/**
+ * @brief Get the minimal number of bits required to encode the given value
+ *
+ * The function is dedicated to 16-bit fields. The window is walked only once,
+ * instead of once per k with wlsb_is_kp_possible_16bits().
+ *
+ * @param wlsb   The W-LSB object
+ * @param value  The value to encode using the LSB algorithm
+ * @param p      The shift parameter p
+ * @return       The minimal number of bits k such that
+ *               wlsb_is_kp_possible_16bits(wlsb, value, k, p) is true
+ */
+size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
+                             const uint16_t value,
+                             const rohc_lsb_shift_t p)
+{
+	return wlsb_get_minkp(wlsb, value, p, 16);
+}
+
+
+/**
+ * @brief Get the minimal number of bits required to encode the given value
+ *
+ * The function is dedicated to 32-bit fields. The window is walked only once,
+ * instead of once per k with wlsb_is_kp_possible_32bits().
+ *
+ * @param wlsb   The W-LSB object
+ * @param value  The value to encode using the LSB algorithm
+ * @param p      The shift parameter p
+ * @return       The minimal number of bits k such that
+ *               wlsb_is_kp_possible_32bits(wlsb, value, k, p) is true
+ */
+size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             const rohc_lsb_shift_t p)
+{
+	return wlsb_get_minkp(wlsb, value, p, 32);
+}
+
+
+/**
+ * @brief Compute the range of offsets between an 8-bit value and the window
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param[out] range  The range of offsets for the value
+ */
+void wlsb_get_range_8bits(const struct c_wlsb *const wlsb,
+                          const uint8_t value,
+                          struct wlsb_range *const range)
+{
+	wlsb_get_range(wlsb, value, 8, range);
+}
+
+
+/**
+ * @brief Compute the range of offsets between a 16-bit value and the window
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param[out] range  The range of offsets for the value
+ */
+void wlsb_get_range_16bits(const struct c_wlsb *const wlsb,
+                           const uint16_t value,
+                           struct wlsb_range *const range)
+{
+	wlsb_get_range(wlsb, value, 16, range);
+}
+
+
+/**
+ * @brief Compute the range of offsets between a 32-bit value and the window
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param[out] range  The range of offsets for the value
+ */
+void wlsb_get_range_32bits(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           struct wlsb_range *const range)
+{
+	wlsb_get_range(wlsb, value, 32, range);
+}
+
+
+/**
+ * @brief Find out whether the given number of bits is enough to encode value
+ *
+ * Give the same answer as the wlsb_is_kp_possible_*bits() functions but in
+ * constant time: the value is in the interpretation intervals of all the
+ * window entries if all its offsets are in [-p, 2^k - 1 - p]. The window is
+ * walked again only if that interval straddles the field boundaries.
+ *
+ * The W-LSB object shall not change between the computation of the range
+ * and the call to this function.
+ *
+ * @param range  The range of offsets computed for the value
+ * @param k      The number of bits for encoding
+ * @param p      The shift parameter p
+ * @return       true if the number of bits is enough for encoding or not
+ */
+bool wlsb_range_is_kp_possible(const struct wlsb_range *const range,
+                               const size_t k,
+                               const rohc_lsb_shift_t p)
+{
+	const int64_t half = ((int64_t) 1) << (range->bits_nr - 1);
+	const int64_t interval_min = -((int64_t) p);
+	bool enc_possible;
+
+	assert(k <= range->bits_nr);
+
+	if(k == range->bits_nr)
+	{
+		enc_possible = true;
+	}
+	/* use all bits if the window contains no value */
+	else if(range->wlsb->count == 0)
+	{
+		enc_possible = false;
+	}
+	else
+	{
+		const int64_t interval_max = interval_min + (((int64_t) 1) << k) - 1;
+
+		if(interval_min >= -half && interval_max < half)
+		{
+			enc_possible = (range->min >= interval_min &&
+			                range->max <= interval_max);
+		}
+		else if(range->bits_nr == 8)
+		{
+			enc_possible = wlsb_is_kp_possible_8bits(range->wlsb, range->value, k, p);
+		}
+		else if(range->bits_nr == 16)
+		{
+			enc_possible = wlsb_is_kp_possible_16bits(range->wlsb, range->value, k, p);
+		}
+		else
+		{
+			enc_possible = wlsb_is_kp_possible_32bits(range->wlsb, range->value, k, p);
+		}
+	}
+
+	return enc_possible;
+}
+
+
 /**
  * @brief Acknowledge based on the Sequence Number (SN)
  *
- * Removes all window entries older (and including) than the one that matches
- * the given SN bits.
+ * Removes all window entries older than the one that matches the given SN
+ * bits. The matching entry is searched by dichotomy, then the window is
+ * truncated in constant time. The window is walked entry by entry only if it
+ * spans more SNs than the given SN bits may tell apart.
  *
  * @param wlsb        The W-LSB object
  * @param sn_bits     The LSB of the SN to acknowledge
@@ -395,13 +813,16 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const uint32_t sn_bits,
                 const size_t sn_bits_nr)
 {
-	size_t entry = wlsb->next;
 	uint32_t sn_mask;
-	bool do_remove = false;
-	uint32_t sn = wlsb->window[entry].sn;
-	uint32_t value = wlsb->window[entry].value;
-	uint8_t i;
-	size_t acked_nr = 0;
+	uint32_t newest_sn;
+	uint32_t oldest_dist;
+	size_t acked_nr;
+	size_t nth;
+
+	if(wlsb->count == 0)
+	{
+		return 0;
+	}
 
 	if(sn_bits_nr < 32)
 	{
@@ -412,26 +833,50 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 		sn_mask = 0xffffffffUL;
 	}
 
-	/* search for the window entry that matches the given SN LSB
-	 * starting from the one */
-	for(i = 0; i < wlsb->count; i++)
+	newest_sn = wlsb->sns[wlsb_get_newest(wlsb)];
+	oldest_dist = newest_sn - wlsb->sns[wlsb_get_nth_older(wlsb, wlsb->count - 1)];
+
+	if(oldest_dist <= sn_mask)
 	{
-		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
-		if(do_remove)
+		/* all the SNs of the window are told apart by their LSB: the SN bits
+		 * match the entry whose SN is at the same distance from the SN of the
+		 * newest entry */
+		const uint32_t dist = (newest_sn - sn_bits) & sn_mask;
+
+		nth = wlsb_find_sn_dist(wlsb, dist);
+		if(nth < wlsb->count &&
+		   (newest_sn - wlsb->sns[wlsb_get_nth_older(wlsb, nth)]) != dist)
 		{
-			wlsb->window[entry].sn = sn;
-			wlsb->window[entry].value = value;
-			acked_nr++;
+			nth = wlsb->count;
 		}
-		else if((wlsb->window[entry].sn & sn_mask) == sn_bits)
+	}
+	else
+	{
+		/* search for the window entry that matches the given SN LSB
+		 * starting from the newest one */
+		size_t entry = wlsb->next;
+
+		for(nth = 0; nth < wlsb->count; nth++)
 		{
-			/* remove all the older window entries */
-			do_remove = true;
-			sn = wlsb->window[entry].sn;
-			value = wlsb->window[entry].value;
+			entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
+			if((wlsb->sns[entry] & sn_mask) == sn_bits)
+			{
+				break;
+			}
 		}
 	}
 
+	/* remove all the older window entries */
+	if(nth < wlsb->count)
+	{
+		acked_nr = wlsb->count - 1 - nth;
+		wlsb->count = nth + 1;
+	}
+	else
+	{
+		acked_nr = 0;
+	}
+
 	return acked_nr;
 }
 
@@ -439,31 +884,26 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 /**
  * @brief Whether the given SN is present in the given WLSB window
  *
- * @param wlsb  The WLSB in which to search for the SN
+ * The window is searched by dichotomy.
+ *
+ * @param wlsb  The W-LSB object in which to search for the SN
  * @param sn    The SN to search for
  * @return      true if the SN is found, false if not
  */
 bool wlsb_is_sn_present(struct c_wlsb *const wlsb, const uint32_t sn)
 {
-	size_t entry = wlsb->next;
-	size_t i;
+	uint32_t dist;
+	size_t nth;
 
-	/* search for the window entry that matches the given SN LSB
-	 * starting from the one */
-	for(i = 0; i < wlsb->count; i++)
+	if(wlsb->count == 0)
 	{
-		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
-		if(sn == wlsb->window[entry].sn)
-		{
-			return true;
-		}
-		else if(sn > wlsb->window[entry].sn)
-		{
-			return false;
-		}
+		return false;
 	}
 
-	return false;
+	dist = wlsb->sns[wlsb_get_newest(wlsb)] - sn;
+	nth = wlsb_find_sn_dist(wlsb, dist);
+
+	return (nth < wlsb->count && wlsb->sns[wlsb_get_nth_older(wlsb, nth)] == sn);
 }
 
 
@@ -484,3 +924,171 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 	return ((entry == 0) ? max : (entry - 1));
 }
 
+
+/**
+ * @brief Get the newest entry of a W-LSB window that contains entries
+ *
+ * @param wlsb  The W-LSB object
+ * @return      The newest entry
+ */
+static size_t wlsb_get_newest(const struct c_wlsb *const wlsb)
+{
+	return wlsb_get_next_older(wlsb->next, wlsb->window_width - 1);
+}
+
+
+/**
+ * @brief Get the entry that is nth older than the newest one
+ *
+ * @param wlsb  The W-LSB object
+ * @param nth   The position of the entry, 0 for the newest one,
+ *              shall be smaller than the count of entries
+ * @return      The entry
+ */
+static size_t wlsb_get_nth_older(const struct c_wlsb *const wlsb,
+                                 const size_t nth)
+{
+	const size_t newest = wlsb_get_newest(wlsb);
+
+	return ((newest >= nth) ? (newest - nth) : (newest + wlsb->window_width - nth));
+}
+
+
+/**
+ * @brief Search the W-LSB window for the newest entry at the given SN distance
+ *
+ * The SNs of the entries increase from the oldest entry to the newest one,
+ * so their distances to the SN of the newest entry decrease from the oldest
+ * entry to the newest one, even if the SNs wrap around. The window may thus
+ * be searched by dichotomy.
+ *
+ * @param wlsb  The W-LSB object, shall contain entries
+ * @param dist  The distance to the SN of the newest entry
+ * @return      The position of the newest entry whose SN is at least at the
+ *              given distance from the SN of the newest entry, 0 for the
+ *              newest entry, the count of entries if there is none
+ */
+static size_t wlsb_find_sn_dist(const struct c_wlsb *const wlsb,
+                                const uint32_t dist)
+{
+	const uint32_t newest_sn = wlsb->sns[wlsb_get_newest(wlsb)];
+	size_t low = 0;
+	size_t high = wlsb->count;
+
+	while(low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+		const uint32_t middle_dist =
+			newest_sn - wlsb->sns[wlsb_get_nth_older(wlsb, middle)];
+
+		if(middle_dist < dist)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+
+/**
+ * @brief Get the minimal number of bits required to encode the given value
+ *
+ * The value may be encoded on k bits if, for every entry of the window, its
+ * distance to the lower bound of the interpretation interval of the entry
+ * (v_ref - p) is smaller than 2^k.
+ *
+ * @param wlsb     The W-LSB object
+ * @param value    The value to encode using the LSB algorithm
+ * @param p        The shift parameter p
+ * @param bits_nr  The length of the field (8, 16 or 32 bits)
+ * @return         The minimal number of bits for encoding
+ */
+static size_t wlsb_get_minkp(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             const rohc_lsb_shift_t p,
+                             const uint8_t bits_nr)
+{
+	const uint32_t mask = (bits_nr == 32 ? 0xffffffffU : ((1U << bits_nr) - 1));
+	uint32_t max_dist = 0;
+	size_t entry;
+	size_t k;
+	size_t i;
+
+	/* use all bits if the window contains no value */
+	if(wlsb->count == 0)
+	{
+		return bits_nr;
+	}
+
+	entry = wlsb_get_newest(wlsb);
+	for(i = 0; i < wlsb->count; i++)
+	{
+		const uint32_t min = wlsb->values[entry] - p;
+		const uint32_t dist = (value - min) & mask;
+
+		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
+
+		if(dist > max_dist)
+		{
+			max_dist = dist;
+		}
+	}
+
+	for(k = 0; k < bits_nr && (max_dist >> k) != 0; k++)
+	{
+	}
+
+	return k;
+}
+
+
+/**
+ * @brief Compute the range of offsets between a value and the window
+ *
+ * @param wlsb        The W-LSB object
+ * @param value       The value to encode using the LSB algorithm
+ * @param bits_nr     The length of the field (8, 16 or 32 bits)
+ * @param[out] range  The range of offsets for the value
+ */
+static void wlsb_get_range(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           const uint8_t bits_nr,
+                           struct wlsb_range *const range)
+{
+	const uint32_t mask = (bits_nr == 32 ? 0xffffffffU : ((1U << bits_nr) - 1));
+	const int64_t half = ((int64_t) 1) << (bits_nr - 1);
+	size_t entry = wlsb_get_newest(wlsb);
+	size_t i;
+
+	range->wlsb = wlsb;
+	range->value = value & mask;
+	range->bits_nr = bits_nr;
+	range->min = half;
+	range->max = -half;
+
+	for(i = 0; i < wlsb->count; i++)
+	{
+		/* the offset value - v_ref in [-2^(bits_nr-1), 2^(bits_nr-1)[ */
+		int64_t offset = (value - wlsb->values[entry]) & mask;
+
+		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
+
+		if(offset >= half)
+		{
+			offset -= 2 * half;
+		}
+		if(offset < range->min)
+		{
+			range->min = offset;
+		}
+		if(offset > range->max)
+		{
+			range->max = offset;
+		}
+	}
+}
@@ -28,6 +28,7 @@
 #define ROHC_COMP_SCHEMES_WLSB_H
 
 #include "interval.h" /* for rohc_lsb_shift_t */
+#include "rohc_mempool.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -40,72 +41,124 @@
  */
 
 /**
- * @brief One W-LSB window entry
+ * @brief The largest window whose entries are stored inside the W-LSB object
+ *
+ * Wider windows are allocated from the memory pool of the compressor. The
+ * default is twice the default window width. It shall be even.
  */
-struct c_window
-{
-	uint32_t sn;     /**< The Sequence Number (SN) associated with the entry
-	                      (used to acknowledge the entry) */
-	uint32_t value;  /**< The value stored in the window entry */
-};
-
-/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
-#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
-     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
-      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
-_Static_assert((offsetof(struct c_window, sn) % 8) == 0,
-               "sn in c_window should be aligned on 8 bytes");
-_Static_assert((offsetof(struct c_window, value) % 4) == 0,
-               "value in c_window should be aligned on 4 bytes");
-_Static_assert((sizeof(struct c_window) % 8) == 0,
-               "c_window length should be multiple of 8 bytes");
+#ifndef ROHC_WLSB_INLINE_WIDTH
+#  define ROHC_WLSB_INLINE_WIDTH  8U
 #endif
 
+/** The narrowest window the compression contexts adapt their windows to */
+#define ROHC_WLSB_WIDTH_MIN  2U
+
 
 /**
  * @brief One W-LSB encoding object
+ *
+ * The SNs and the values of the window entries are stored in two separate
+ * arrays, so that the window scans only read the values. The arrays are
+ * part of the object for windows of at most ROHC_WLSB_INLINE_WIDTH entries:
+ * the object shall then be duplicated with wlsb_copy(), or with memcpy()
+ * completed by wlsb_complete_copy(), never with memcpy() alone.
  */
 struct c_wlsb
 {
-	/** The window in which previous values of the encoded value are stored */
-	struct c_window *window;
+	/** The Sequence Numbers (SN) associated with the entries (used to
+	 *  acknowledge the entries) */
+	uint32_t *sns;
+	/** The values stored in the window entries */
+	uint32_t *values;
+	/** The memory pool to allocate the windows too wide to be inline from */
+	struct rohc_mempool *mempool;
 
 	/** The width of the window */
-	uint8_t window_width; /* TODO: R-mode needs a non-fixed window width */
+	uint8_t window_width;
 
 	/** A pointer on the next entry in the window */
 	uint8_t next;
 
-	/** The count of entries in the window */
+	/** The count of entries in the window, the newest ones before next */
 	uint8_t count;
 
+	uint8_t unused[5];
+
+	/** The SNs of the window entries if the window is inline */
+	uint32_t inline_sns[ROHC_WLSB_INLINE_WIDTH];
+	/** The values of the window entries if the window is inline */
+	uint32_t inline_values[ROHC_WLSB_INLINE_WIDTH];
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
 #if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
      (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
       (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
-_Static_assert((offsetof(struct c_wlsb, window) % 8) == 0,
-               "window in c_wlsb should be aligned on 8 bytes");
+_Static_assert((offsetof(struct c_wlsb, sns) % 8) == 0,
+               "sns in c_wlsb should be aligned on 8 bytes");
+_Static_assert((offsetof(struct c_wlsb, inline_sns) % 8) == 0,
+               "inline_sns in c_wlsb should be aligned on 8 bytes");
 _Static_assert((sizeof(struct c_wlsb) % 8) == 0,
                "c_wlsb length should be multiple of 8 bytes");
 #endif
 
 
+/**
+ * @brief The offsets between one value and all the values of a W-LSB window
+ *
+ * The range is computed once for a value with one of the
+ * wlsb_get_range_*bits() functions. It then tells whether k bits are enough
+ * to encode the value for any (k, p) without walking the window again.
+ */
+struct wlsb_range
+{
+	/** The W-LSB encoding object the range was computed for */
+	const struct c_wlsb *wlsb;
+	/** The smallest offset (value - v_ref) of the window, signed */
+	int64_t min;
+	/** The largest offset (value - v_ref) of the window, signed */
+	int64_t max;
+	/** The value to encode */
+	uint32_t value;
+	/** The length of the field (8, 16 or 32 bits) */
+	uint8_t bits_nr;
+};
+
+
 
 /*
  * Public function prototypes:
  */
 
 bool wlsb_new(struct c_wlsb *const wlsb,
-              const size_t window_width)
-	__attribute__((warn_unused_result, nonnull(1)));
+              const size_t window_width,
+              struct rohc_mempool *const mempool)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
 bool wlsb_copy(struct c_wlsb *const dst,
                const struct c_wlsb *const src)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool wlsb_complete_copy(struct c_wlsb *const dst,
+                        const struct c_wlsb *const src)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 void wlsb_free(struct c_wlsb *const wlsb)
 	__attribute__((nonnull(1)));
 
+size_t wlsb_get_image_len(const struct c_wlsb *const wlsb)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+void wlsb_save(const struct c_wlsb *const wlsb, uint8_t *const image)
+	__attribute__((nonnull(1, 2)));
+bool wlsb_restore(struct c_wlsb *const wlsb,
+                  struct rohc_mempool *const mempool,
+                  const uint8_t *const image,
+                  const size_t image_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+void wlsb_reset(struct c_wlsb *const wlsb)
+	__attribute__((nonnull(1)));
+
+void wlsb_set_width(struct c_wlsb *const wlsb, const size_t new_width)
+	__attribute__((nonnull(1)));
+
 void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
                 const uint32_t value)
@@ -129,6 +182,36 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
                                 const rohc_lsb_shift_t p)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+size_t wlsb_get_minkp_8bits(const struct c_wlsb *const wlsb,
+                            const uint8_t value,
+                            const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
+                             const uint16_t value,
+                             const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void wlsb_get_range_8bits(const struct c_wlsb *const wlsb,
+                          const uint8_t value,
+                          struct wlsb_range *const range)
+	__attribute__((nonnull(1, 3)));
+void wlsb_get_range_16bits(const struct c_wlsb *const wlsb,
+                           const uint16_t value,
+                           struct wlsb_range *const range)
+	__attribute__((nonnull(1, 3)));
+void wlsb_get_range_32bits(const struct c_wlsb *const wlsb,
+                           const uint32_t value,
+                           struct wlsb_range *const range)
+	__attribute__((nonnull(1, 3)));
+bool wlsb_range_is_kp_possible(const struct wlsb_range *const range,
+                               const size_t k,
+                               const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const uint32_t sn_bits,
                 const size_t sn_bits_nr)
@@ -33,6 +33,7 @@
 #include "protocols/ipv6.h"
 #include "protocols/tcp.h"
 #include "ip.h"
+#include "ip_id_offset.h"
 
 
 /**
@@ -101,11 +102,12 @@ typedef struct
 	uint8_t version:4;
 	uint8_t ip_id_behavior:2;
 	uint8_t last_ip_id_behavior:2;
+	struct rohc_ip_id_hysteresis ip_id_hyst;
 
 	/* Context Replication */
 	bool cr_ttl_hopl_present;
 
-	uint8_t unused2[5];
+	uint8_t unused2[4];
 
 } ip_context_t;
 
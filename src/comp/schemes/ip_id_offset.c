@@ -114,3 +114,70 @@ rohc_ip_id_behavior_t rohc_comp_detect_ip_id_behavior(const uint16_t last_ip_id,
 	return behavior;
 }
 
+
+
+/**
+ * @brief Delay the change of behavior of the IPv4 Identification field
+ *
+ * A single IP-ID out of pattern, eg. one packet of another socket of the
+ * host, shall not change the IP-ID behavior of the context back and forth.
+ * The new behavior is adopted once it was observed on the given number of
+ * consecutive packets. Until then, the current behavior is kept as long as
+ * it is able to transmit the IP-ID: the sequential behaviors transmit any
+ * IP-ID offset with enough LSB bits and the random behavior transmits the
+ * IP-ID in full, but the zero behavior cannot transmit a non-zero IP-ID.
+ *
+ * One IP-ID out of pattern breaks the sequence twice: at the packet that
+ * carries it and at the next one. So at least 3 observations are required
+ * to ignore them.
+ *
+ * @param hyst             The hysteresis of the IP header
+ * @param cur_behavior     The current IP-ID behavior of the context
+ * @param new_behavior     The IP-ID behavior detected for the current packet
+ * @param new_ip_id        The IP-ID value of the current packet (in HBO)
+ * @param observations_nr  The number of consistent observations required
+ *                         to change the behavior, 1 to change it at once
+ * @return                 The IP-ID behavior to use for the current packet
+ */
+rohc_ip_id_behavior_t
+	rohc_comp_ip_id_behavior_hysteresis(struct rohc_ip_id_hysteresis *const hyst,
+	                                    const rohc_ip_id_behavior_t cur_behavior,
+	                                    const rohc_ip_id_behavior_t new_behavior,
+	                                    const uint16_t new_ip_id,
+	                                    const uint8_t observations_nr)
+{
+	rohc_ip_id_behavior_t behavior;
+
+	if(new_behavior == cur_behavior || observations_nr <= 1 ||
+	   (cur_behavior == ROHC_IP_ID_BEHAVIOR_ZERO && new_ip_id != 0))
+	{
+		/* no change, no hysteresis, or current behavior unable to transmit
+		 * the new IP-ID */
+		hyst->votes_nr = 0;
+		behavior = new_behavior;
+	}
+	else
+	{
+		if(hyst->votes_nr == 0 || hyst->candidate != new_behavior)
+		{
+			hyst->candidate = new_behavior;
+			hyst->votes_nr = 1;
+		}
+		else
+		{
+			hyst->votes_nr++;
+		}
+
+		if(hyst->votes_nr >= observations_nr)
+		{
+			hyst->votes_nr = 0;
+			behavior = new_behavior;
+		}
+		else
+		{
+			behavior = cur_behavior;
+		}
+	}
+
+	return behavior;
+}
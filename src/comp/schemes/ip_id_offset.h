@@ -31,6 +31,23 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+
+/**
+ * @brief The hysteresis on the changes of behavior of one IPv4 Identification
+ *
+ * @see rohc_comp_ip_id_behavior_hysteresis
+ */
+struct rohc_ip_id_hysteresis
+{
+	uint8_t candidate:2; /**< The behavior observed but not adopted yet */
+	uint8_t votes_nr:6;  /**< The consecutive observations of the candidate */
+} __attribute__((packed));
+
+/** The maximal number of consistent observations before an IP-ID behavior
+ *  is reclassified */
+#define ROHC_IP_ID_HYSTERESIS_MAX  63U
+
+
 bool is_ip_id_increasing(const uint16_t old_id,
                          const uint16_t new_id,
                          const uint16_t max_delta)
@@ -42,5 +59,13 @@ rohc_ip_id_behavior_t rohc_comp_detect_ip_id_behavior(const uint16_t last_ip_id,
                                                       const uint16_t max_delta)
 	__attribute__((warn_unused_result, const));
 
+rohc_ip_id_behavior_t
+	rohc_comp_ip_id_behavior_hysteresis(struct rohc_ip_id_hysteresis *const hyst,
+	                                    const rohc_ip_id_behavior_t cur_behavior,
+	                                    const rohc_ip_id_behavior_t new_behavior,
+	                                    const uint16_t new_ip_id,
+	                                    const uint8_t observations_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 #endif
 
@@ -27,19 +27,21 @@
 #include "rohc_utils.h"
 
 
-static int c_tcp_sack_code_block(const struct rohc_comp_ctxt *const context,
-                                 const uint32_t reference,
-                                 const sack_block_t *const sack_block,
-                                 uint8_t *const rohc_data,
-                                 const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
+/** The number of SACK fields in one SACK option: start and end of every block */
+#define TCP_SACK_FIELDS_MAX_NR  (TCP_SACK_BLOCKS_MAX_NR * 2)
 
-static int c_tcp_sack_code_pure_lsb(const struct rohc_comp_ctxt *const context,
-                                    const uint32_t base,
-                                    const uint32_t field,
-                                    uint8_t *const rohc_data,
-                                    const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+/**
+ * @brief The discriminator bits of the SACK fields encoded on 2, 3, 4 and
+ *        5 bytes, aligned on the first byte of the encoded field
+ */
+static const uint8_t c_tcp_sack_discriminators[5 + 1] =
+{
+	0x00, 0x00, 0x00, 0x80, 0xc0, 0xff
+};
+
+
+static size_t c_tcp_sack_field_len(const uint32_t sack_field)
+	__attribute__((warn_unused_result, const));
 
 
 /**
@@ -48,6 +50,11 @@ static int c_tcp_sack_code_pure_lsb(const struct rohc_comp_ctxt *const context,
  * See RFC6846 page 68
  * (and RFC2018 for Selective Acknowledgement option)
  *
+ * All the SACK blocks are encoded at once: the offsets of all the fields
+ * against their references are computed first, then the lengths of their
+ * encodings, so that the ROHC buffer is checked only once before all the
+ * fields are written in one pass.
+ *
  * @param context         The compression context
  * @param ack_value       The ack value
  * @param sack_blocks     The SACK blocks to compress
@@ -67,12 +74,7 @@ int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
                         uint8_t *const rohc_data,
                         const size_t rohc_max_len)
 {
-	uint8_t * rohc_remain_data = rohc_data;
-	size_t rohc_remain_len = rohc_max_len;
-	const sack_block_t *block;
-	size_t blocks_nr;
-	size_t i;
-	int ret;
+	size_t rohc_len;
 
 	rohc_comp_debug(context, "%schanged TCP option SACK (reference ACK = 0x%08x)",
 	                (is_unchanged ? "un" : ""), ack_value);
@@ -89,106 +91,83 @@ int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
 	/* the irregular chain supports a special encoding for unchanged option */
 	if(is_unchanged)
 	{
-		rohc_remain_data[0] = 0x00;
-		rohc_remain_data++;
-		rohc_remain_len--;
+		rohc_data[0] = 0x00;
+		rohc_len = 1;
 	}
 	else
 	{
-		uint32_t reference;
+		/* the SACK fields and their references: the first block uses ACK as
+		 * reference, the end of every block uses the start of the block as
+		 * reference, the next block uses the current block end as reference */
+		uint32_t values[TCP_SACK_FIELDS_MAX_NR + 1];
+		uint32_t sack_fields[TCP_SACK_FIELDS_MAX_NR];
+		uint8_t sack_fields_len[TCP_SACK_FIELDS_MAX_NR];
+		size_t fields_nr;
+		size_t blocks_nr;
+		size_t i;
 
 		/* determine the number of SACK blocks
 		 * (integer division checked by \ref c_tcp_check_profile ) */
 		blocks_nr = length / sizeof(sack_block_t);
-		rohc_remain_data[0] = blocks_nr;
-		rohc_remain_data++;
-		rohc_remain_len--;
+		assert(blocks_nr <= TCP_SACK_BLOCKS_MAX_NR);
+		fields_nr = blocks_nr * 2;
 
-		/* compress every SACK block, one by one:
-		 *  - first block uses ACK as reference
-		 *  - next block uses current block end as reference */
-		for(i = 0, reference = ack_value, block = sack_blocks;
-		    i < blocks_nr;
-		    i++, reference = rohc_ntoh32(block->block_end), block++)
+		values[0] = ack_value;
+		for(i = 0; i < blocks_nr; i++)
 		{
+			values[i * 2 + 1] = rohc_ntoh32(sack_blocks[i].block_start);
+			values[i * 2 + 2] = rohc_ntoh32(sack_blocks[i].block_end);
 			rohc_comp_debug(context, "block of SACK option: reference = 0x%08x, "
-			                "start = 0x%08x, end = 0x%08x", reference,
-			                rohc_ntoh32(block->block_start),
-			                rohc_ntoh32(block->block_end));
-			ret = c_tcp_sack_code_block(context, reference, block,
-			                            rohc_remain_data, rohc_remain_len);
-			if(ret < 0)
-			{
-				rohc_comp_warn(context, "failed to encode SACK block #%zu", i + 1);
-				goto error;
-			}
-			rohc_remain_data += ret;
-			rohc_remain_len -= ret;
+			                "start = 0x%08x, end = 0x%08x", values[i * 2],
+			                values[i * 2 + 1], values[i * 2 + 2]);
 		}
-	}
 
-	return (rohc_max_len - rohc_remain_len);
-
-error:
-	return -1;
-}
-
-
-/**
- * @brief Compress one SACK block
- *
- * See RFC6846 page 68
- * (and RFC2018 for Selective Acknowledgement option)
- *
- * @param context         The compression context
- * @param reference       The reference value
- * @param sack_block      The SACK block to compress
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
- */
-static int c_tcp_sack_code_block(const struct rohc_comp_ctxt *const context,
-                                 const uint32_t reference,
-                                 const sack_block_t *const sack_block,
-                                 uint8_t *const rohc_data,
-                                 const size_t rohc_max_len)
-{
-	uint8_t *rohc_remain_data = rohc_data;
-	size_t rohc_remain_len = rohc_max_len;
-	int ret;
+		/* sack_var_length_enc(reference) of all the fields at once: first the
+		 * offsets against the references (if reference can be >= field,
+		 * overflow is expected), then the lengths of their encodings */
+		for(i = 0; i < fields_nr; i++)
+		{
+			sack_fields[i] = values[i + 1] - values[i];
+		}
+		rohc_len = 1;
+		for(i = 0; i < fields_nr; i++)
+		{
+			sack_fields_len[i] = c_tcp_sack_field_len(sack_fields[i]);
+			rohc_len += sack_fields_len[i];
+		}
+		if(rohc_max_len < rohc_len)
+		{
+			rohc_comp_warn(context, "ROHC buffer too small for the TCP option SACK: "
+			               "%zu bytes required, but only %zu bytes available",
+			               rohc_len, rohc_max_len);
+			goto error;
+		}
 
-	rohc_comp_debug(context, "reference = 0x%x, block_start = 0x%x, block_end "
-	                "= 0x%x", reference, rohc_ntoh32(sack_block->block_start),
-	                rohc_ntoh32(sack_block->block_end));
+		/* write the number of blocks, then all the fields in one pass: the
+		 * discriminator bits of every field are merged with its first byte */
+		rohc_data[0] = blocks_nr;
+		for(i = 0, rohc_len = 1; i < fields_nr; i++)
+		{
+			const size_t field_len = sack_fields_len[i];
+			const uint64_t field_bits =
+				(((uint64_t) c_tcp_sack_discriminators[field_len]) <<
+				 ((field_len - 1) * 8)) | sack_fields[i];
+			size_t j;
 
-	/* block_start =:= sack_var_length_enc(reference) */
-	ret = c_tcp_sack_code_pure_lsb(context, reference,
-	                               rohc_ntoh32(sack_block->block_start),
-	                               rohc_remain_data, rohc_remain_len);
-	if(ret < 0)
-	{
-		rohc_comp_warn(context, "failed to encode the SACK block start");
-		goto error;
-	}
-	rohc_remain_data += ret;
-	rohc_remain_len -= ret;
+			for(j = 0; j < field_len; j++)
+			{
+				rohc_data[rohc_len + j] =
+					(field_bits >> ((field_len - 1 - j) * 8)) & 0xff;
+			}
+			rohc_len += field_len;
 
-	/* block_end =:= sack_var_length_enc(block_start) */
-	ret = c_tcp_sack_code_pure_lsb(context, rohc_ntoh32(sack_block->block_start),
-	                               rohc_ntoh32(sack_block->block_end),
-	                               rohc_remain_data, rohc_remain_len);
-	if(ret < 0)
-	{
-		rohc_comp_warn(context, "failed to encode the SACK block end");
-		goto error;
+			rohc_comp_debug(context, "sack_field = 0x%x (0x%x - 0x%x) encoded on "
+			                "%zu bytes (discriminator included)", sack_fields[i],
+			                values[i + 1], values[i], field_len);
+		}
 	}
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	rohc_remain_data += ret;
-#endif
-	rohc_remain_len -= ret;
 
-	return (rohc_max_len - rohc_remain_len);
+	return rohc_len;
 
 error:
 	return -1;
@@ -196,99 +175,19 @@ error:
 
 
 /**
- * @brief Compress one SACK field value
+ * @brief Get the length of the encoding of one SACK field
  *
- * See RFC6846 page 67
- * (and RFC2018 for Selective Acknowledgement option)
+ * See RFC6846 page 67: the field is encoded on 2 bytes with discriminator
+ * '0', 3 bytes with discriminator '10', 4 bytes with discriminator '110', or
+ * 5 bytes with discriminator '11111111'. The length is computed without any
+ * branch, the comparisons simply add up.
  *
- * @param context         The compression context
- * @param base            The base value
- * @param field           The value to compress
- * @param[out] rohc_data  The ROHC packet being built
- * @param rohc_max_len    The max remaining length in the ROHC buffer
- * @return                The length appended in the ROHC buffer if positive,
- *                        -1 in case of error
+ * @param sack_field  The SACK field to encode
+ * @return            The length (in bytes) of the encoded field
  */
-static int c_tcp_sack_code_pure_lsb(const struct rohc_comp_ctxt *const context,
-                                    const uint32_t base,
-                                    const uint32_t field,
-                                    uint8_t *const rohc_data,
-                                    const size_t rohc_max_len)
+static size_t c_tcp_sack_field_len(const uint32_t sack_field)
 {
-	/* if base can be >= field, overflow is expected */
-	const uint32_t sack_field = field - base;
-	size_t len;
-
-	if(sack_field < 0x8000)
-	{
-		/* 2 bytes with discriminator '0' */
-		len = 2;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = (sack_field >> 8) & 0x7f;
-		rohc_data[1] = sack_field & 0xff;
-	}
-	else if(sack_field < 0x400000)
-	{
-		/* 3 bytes with discriminator '10' */
-		len = 3;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = 0x80 | ((sack_field >> 16) & 0x3f);
-		rohc_data[1] = (sack_field >> 8) & 0xff;
-		rohc_data[2] = sack_field & 0xff;
-	}
-	else if(sack_field < 0x20000000)
-	{
-		/* 4 bytes with discriminator '110' */
-		len = 4;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = 0xc0 | ((sack_field >> 24) & 0x1f);
-		rohc_data[1] = (sack_field >> 16) & 0xff;
-		rohc_data[2] = (sack_field >> 8) & 0xff;
-		rohc_data[3] = sack_field & 0xff;
-	}
-	else
-	{
-		/* 5 bytes with discriminator '11111111' */
-		len = 5;
-		if(rohc_max_len < len)
-		{
-			rohc_comp_warn(context, "ROHC buffer too small for the SACK pure LSB: "
-			               "%zu bytes required, but only %zu bytes available",
-			               len, rohc_max_len);
-			goto error;
-		}
-		rohc_data[0] = 0xff;
-		rohc_data[1] = (sack_field >> 24) & 0xff;
-		rohc_data[2] = (sack_field >> 16) & 0xff;
-		rohc_data[3] = (sack_field >> 8) & 0xff;
-		rohc_data[4] = sack_field & 0xff;
-	}
-
-	rohc_comp_debug(context, "sack_field = 0x%x (0x%x - 0x%x) encoded on %zu "
-	                "bytes (discriminator included)", sack_field, field,
-	                base, len);
-
-	return len;
-
-error:
-	return -1;
+	return (2 + (sack_field >= 0x8000) + (sack_field >= 0x400000) +
+	        (sack_field >= 0x20000000));
 }
 
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    bench_comp_schemes.c
+ * @brief   Microbenchmarks for the encoding schemes of the compressor
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * Measure the W-LSB k-selection, the scaled RTP TS encoding, the RFC 4996
+ * encoders and the coding of the TCP SACK and TS options in isolation, so
+ * that optimizations of these kernels may be validated without the noise of
+ * the whole compression path.
+ *
+ * Every kernel is checked once before being measured, then one line is
+ * printed for each kernel:
+ *
+ *   BENCH  <kernel>  <operations>  <ns/operation>
+ */
+
+#include "comp_wlsb.h"
+#include "comp_scaled_rtp_ts.h"
+#include "rfc4996.h"
+#include "tcp_ts.h"
+#include "tcp_sack.h"
+#include "rohc_comp_internals.h"
+#include "rohc_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/** The default number of times every kernel is run */
+#define BENCH_ITERS_DEFAULT  200000U
+
+/** The width of the W-LSB sliding windows, the default of the library */
+#define BENCH_WLSB_WIDTH  4U
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+/** Run the given code the given number of times and print its mean duration */
+#define BENCH(name, iters_nr, ...) \
+	do { \
+		const uint64_t bench_start = bench_get_ns(); \
+		size_t i; \
+		for(i = 0; i < (iters_nr); i++) \
+		{ \
+			__VA_ARGS__; \
+		} \
+		bench_print(name, iters_nr, bench_get_ns() - bench_start); \
+	} while(0)
+
+
+/** Accumulate the kernel results so that the compiler cannot drop them */
+static volatile uint64_t bench_sink;
+
+
+static uint64_t bench_get_ns(void)
+	__attribute__((warn_unused_result));
+static void bench_print(const char *const name,
+                        const size_t ops_nr,
+                        const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Run the microbenchmarks of the encoding schemes of the compressor
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if all the kernels were checked and measured,
+ *              non-zero otherwise
+ */
+int main(int argc, char *argv[])
+{
+	/* a fake compression context for the TCP option encoders: traces are
+	 * disabled, so that only the encoding itself is measured */
+	struct rohc_comp comp = { .trace_callback = NULL };
+	const struct rohc_comp_profile profile = { .id = ROHC_PROFILE_TCP };
+	const struct rohc_comp_ctxt context = { .compressor = &comp, .profile = &profile };
+	struct rohc_mempool mempool;
+	struct c_wlsb wlsb16;
+	struct c_wlsb wlsb32;
+	struct ts_sc_comp ts_sc;
+	sack_block_t sack_blocks[TCP_SACK_BLOCKS_MAX_NR];
+	uint8_t rohc_data[64];
+	size_t iters_nr = BENCH_ITERS_DEFAULT;
+	int is_failure = 1;
+	uint32_t sn;
+	size_t j;
+
+	if(argc == 2)
+	{
+		char *end;
+		iters_nr = strtoul(argv[1], &end, 10);
+		if(argv[1][0] == '\0' || (*end) != '\0' || iters_nr == 0)
+		{
+			fprintf(stderr, "bad number of iterations '%s'\n", argv[1]);
+			goto error;
+		}
+	}
+	else if(argc != 1)
+	{
+		printf("benchmark the encoding schemes of the compressor\n");
+		printf("usage: %s [ITERATIONS]\n", argv[0]);
+		goto error;
+	}
+
+	rohc_mempool_init(&mempool);
+
+	/* W-LSB k-selection against a full window of increasing values, as for
+	 * the SN of a flow without losses */
+	if(!wlsb_new(&wlsb16, BENCH_WLSB_WIDTH, &mempool))
+	{
+		fprintf(stderr, "failed to create the 16-bit W-LSB context\n");
+		goto free_mempool;
+	}
+	if(!wlsb_new(&wlsb32, BENCH_WLSB_WIDTH, &mempool))
+	{
+		fprintf(stderr, "failed to create the 32-bit W-LSB context\n");
+		goto free_wlsb16;
+	}
+	for(sn = 0; sn < BENCH_WLSB_WIDTH; sn++)
+	{
+		c_add_wlsb(&wlsb16, sn, 0xfff0 + sn);
+		c_add_wlsb(&wlsb32, sn, 0xfffffff0 + sn * 1460);
+	}
+	{
+		const size_t k = wlsb_get_minkp_16bits(&wlsb16, 0xfff0 + sn, -1);
+		CHECK(k > 0 && k < 16);
+		CHECK(wlsb_is_kp_possible_16bits(&wlsb16, 0xfff0 + sn, k, -1));
+		CHECK(!wlsb_is_kp_possible_16bits(&wlsb16, 0xfff0 + sn, k - 1, -1));
+	}
+	BENCH("wlsb_is_kp_possible_8bits", iters_nr,
+	      bench_sink += wlsb_is_kp_possible_8bits(&wlsb16, (uint8_t) (0xf0 + sn + (i & 0xf)),
+	                                              1 + (i & 7), 0));
+	BENCH("wlsb_is_kp_possible_16bits", iters_nr,
+	      bench_sink += wlsb_is_kp_possible_16bits(&wlsb16, 0xfff0 + sn + (i & 0xf),
+	                                               1 + (i & 15), -1));
+	BENCH("wlsb_is_kp_possible_32bits", iters_nr,
+	      bench_sink += wlsb_is_kp_possible_32bits(&wlsb32, 0xfffffff0 + (sn + (i & 0xf)) * 1460,
+	                                               1 + (i & 31), 63));
+	BENCH("wlsb_get_minkp_32bits", iters_nr,
+	      bench_sink += wlsb_get_minkp_32bits(&wlsb32, 0xfffffff0 + (sn + (i & 0xf)) * 1460, 63));
+	BENCH("wlsb_range_32bits_4kp", iters_nr,
+	      struct wlsb_range range;
+	      wlsb_get_range_32bits(&wlsb32, 0xfffffff0 + (sn + (i & 0xf)) * 1460, &range);
+	      bench_sink += wlsb_range_is_kp_possible(&range, 8, 63) +
+	                    wlsb_range_is_kp_possible(&range, 14, 63) +
+	                    wlsb_range_is_kp_possible(&range, 18, 63) +
+	                    wlsb_range_is_kp_possible(&range, 30, 63));
+
+	/* scaled RTP TS: one 20-ms audio flow, the state is forced to
+	 * SEND_SCALED once TS_STRIDE is known as the RTP profile does after
+	 * enough transmissions of TS_STRIDE */
+	if(!c_create_sc(&ts_sc, BENCH_WLSB_WIDTH, &mempool, NULL, NULL,
+	                ROHC_TRACE_ERROR))
+	{
+		fprintf(stderr, "failed to create the scaled RTP TS context\n");
+		goto free_wlsb32;
+	}
+	for(sn = 0; sn < 4; sn++)
+	{
+		c_add_ts(&ts_sc, sn * 160, sn);
+		add_scaled(&ts_sc, sn);
+		add_unscaled(&ts_sc, sn);
+	}
+	CHECK(ts_sc.state == INIT_STRIDE);
+	CHECK(get_ts_stride(&ts_sc) == 160);
+	ts_sc.state = SEND_SCALED;
+	BENCH("c_add_ts_scaled", iters_nr,
+	      const uint16_t cur_sn = (uint16_t) (sn + i);
+	      c_add_ts(&ts_sc, (sn + i) * 160, cur_sn);
+	      bench_sink += nb_bits_scaled(&ts_sc) + rohc_ts_sc_is_deducible(&ts_sc);
+	      add_scaled(&ts_sc, cur_sn));
+	CHECK(ts_sc.state == SEND_SCALED);
+	CHECK(get_ts_scaled(&ts_sc) == (sn + iters_nr - 1));
+	c_destroy_sc(&ts_sc);
+
+	/* the RFC 4996 encoders */
+	{
+		int indicator;
+		CHECK(c_static_or_irreg32(0x11223344, false, rohc_data, 4, &indicator) == 4);
+		CHECK(indicator == 1);
+		CHECK(c_zero_or_irreg32(0, rohc_data, 4, &indicator) == 0);
+		CHECK(indicator == 1);
+		CHECK(variable_length_32_enc(true, 0, &wlsb32, rohc_data, 4,
+		                             &indicator) == 0);
+		CHECK(indicator == 0);
+	}
+	BENCH("c_static_or_irreg32", iters_nr,
+	      int indicator;
+	      bench_sink += c_static_or_irreg32(i, (i & 1), rohc_data, 4, &indicator) +
+	                    indicator);
+	BENCH("c_zero_or_irreg32", iters_nr,
+	      int indicator;
+	      bench_sink += c_zero_or_irreg32(i & 0x10, rohc_data, 4, &indicator) +
+	                    indicator);
+	BENCH("variable_length_32_enc", iters_nr,
+	      int indicator;
+	      bench_sink += variable_length_32_enc((i & 3) == 0,
+	                                           0xfffffff0 + (sn + (i & 0x3ff)) * 1460,
+	                                           &wlsb32, rohc_data, 4, &indicator) +
+	                    indicator);
+	BENCH("c_optional_ip_id_lsb", iters_nr,
+	      int indicator;
+	      bench_sink += c_optional_ip_id_lsb(ROHC_IP_ID_BEHAVIOR_SEQ_SWAP,
+	                                         (uint16_t) i, 0xfff0 + sn + (i & 0x1ff),
+	                                         &wlsb16, 3, rohc_data, 2, &indicator) +
+	                    indicator);
+	BENCH("c_field_scaling", iters_nr,
+	      uint32_t scaled;
+	      uint32_t residue;
+	      c_field_scaling(&scaled, &residue, 1460, i * 1460 + 17);
+	      bench_sink += scaled + residue);
+	BENCH("dscp_encode", iters_nr,
+	      int indicator;
+	      bench_sink += dscp_encode((i & 1), i & 0x3f, rohc_data, 1, &indicator) +
+	                    indicator);
+
+	/* the TCP TS option: the LSB coding of one timestamp on 1 to 4 bytes */
+	{
+		size_t len;
+		CHECK(c_tcp_ts_lsb_code(&context, 0x12345678, 4, rohc_data,
+		                        sizeof(rohc_data), &len));
+		CHECK(len == 4);
+		CHECK(c_tcp_ts_lsb_code(&context, 0x12345678, 1, rohc_data,
+		                        sizeof(rohc_data), &len));
+		CHECK(len == 1 && rohc_data[0] == 0x78);
+	}
+	BENCH("c_tcp_ts_lsb_code", iters_nr,
+	      size_t len;
+	      CHECK(c_tcp_ts_lsb_code(&context, i * 10, 1 + (i & 3), rohc_data,
+	                              sizeof(rohc_data), &len));
+	      bench_sink += len + rohc_data[0]);
+
+	/* the TCP SACK option: 1 to 4 blocks above the ACK number */
+	for(j = 0; j < TCP_SACK_BLOCKS_MAX_NR; j++)
+	{
+		sack_blocks[j].block_start = rohc_hton32(0x10000000 + j * 0x3000);
+		sack_blocks[j].block_end = rohc_hton32(0x10000000 + j * 0x3000 + 0x1000);
+	}
+	CHECK(c_tcp_opt_sack_code(&context, 0x0fff0000, sack_blocks,
+	                          sizeof(sack_block_t), false, rohc_data,
+	                          sizeof(rohc_data)) > 0);
+	CHECK(rohc_data[0] == 1);
+	BENCH("c_tcp_opt_sack_code", iters_nr,
+	      const uint8_t blocks_len = sizeof(sack_block_t) * (1 + (i & 3));
+	      const int ret = c_tcp_opt_sack_code(&context, 0x0fff0000 + (i & 0xffff),
+	                                          sack_blocks, blocks_len, false,
+	                                          rohc_data, sizeof(rohc_data));
+	      CHECK(ret > 0);
+	      bench_sink += ret);
+
+	is_failure = 0;
+
+free_wlsb32:
+	wlsb_free(&wlsb32);
+free_wlsb16:
+	wlsb_free(&wlsb16);
+free_mempool:
+	rohc_mempool_free(&mempool);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t bench_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + ((uint64_t) now.tv_nsec);
+}
+
+
+/**
+ * @brief Print the mean duration of one kernel
+ *
+ * @param name         The name of the kernel
+ * @param ops_nr       The number of times the kernel was run
+ * @param duration_ns  The duration of all the runs (in nanoseconds)
+ */
+static void bench_print(const char *const name,
+                        const size_t ops_nr,
+                        const uint64_t duration_ns)
+{
+	printf("BENCH\t%s\t%zu\t%.2f\n", name, ops_nr,
+	       ops_nr == 0 ? 0.0 : ((double) duration_ns) / ((double) ops_nr));
+}
@@ -117,6 +117,7 @@ static bool run_test_variable_length_32_enc(const bool be_verbose)
 #define comp_max_len sizeof(uint32_t)
 	uint8_t comp_data[comp_max_len];
 	struct c_wlsb wlsb;
+	struct rohc_mempool mempool;
 	uint32_t old_value;
 	bool is_success = false;
 	size_t i;
@@ -168,7 +169,8 @@ static bool run_test_variable_length_32_enc(const bool be_verbose)
 	};
 
 	/* create the W-LSB context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, &mempool);
 	if(!is_ok)
 	{
 		trace(be_verbose, "failed to create W-LSB context\n");
@@ -225,6 +227,7 @@ static bool run_test_variable_length_32_enc(const bool be_verbose)
 
 free_wlsb:
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
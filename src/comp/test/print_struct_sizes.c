@@ -26,6 +26,7 @@
 #include <c_tcp_defines.h>
 
 #include <stdio.h>
+#include <stddef.h>
 
 
 /**
@@ -52,6 +53,8 @@ int main(void)
 	/* context */
 	printf("\n");
 	printf("sizeof(struct rohc_comp_ctxt) = %zu\n", sizeof(struct rohc_comp_ctxt));
+	printf("\toffsetof(struct rohc_comp_ctxt, total_uncompressed_size) = %zu\n",
+	       offsetof(struct rohc_comp_ctxt, total_uncompressed_size));
 	printf("\tsizeof(struct rohc_fingerprint) = %zu\n", sizeof(struct rohc_fingerprint));
 	printf("\t\tsizeof(struct rohc_fingerprint_base) = %zu\n", sizeof(struct rohc_fingerprint_base));
 	printf("\t\t\tsizeof(struct rohc_fingerprint_ip) = %zu\n", sizeof(struct rohc_fingerprint_ip));
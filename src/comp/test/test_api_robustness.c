@@ -26,6 +26,7 @@
 #include "rohc_comp.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
@@ -51,6 +52,28 @@
 static int random_cb(const struct rohc_comp *const comp,
                      void *const user_context)
 	__attribute__((warn_unused_result));
+static void * mem_alloc_cb(const size_t size, void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+static void mem_free_cb(void *const ptr, const size_t size, void *const priv_ctxt);
+static void ctxt_event_cb(const struct rohc_comp *const comp,
+                          const struct rohc_comp_ctxt_event *const event,
+                          void *const priv_ctxt);
+static uint64_t hash_cb(const uint8_t *const data,
+                        const size_t len,
+                        const uint8_t key[16],
+                        void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+static size_t evict_cb(const struct rohc_comp_ctxt_record candidates[],
+                       const size_t candidates_nr,
+                       const rohc_profile_t profile_id,
+                       void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+static uint8_t crc_calc_cb(const size_t crc_bits,
+                           const uint8_t *const data,
+                           const size_t len,
+                           const uint8_t init_val,
+                           void *const priv_ctxt)
+	__attribute__((warn_unused_result));
 
 
 /**
@@ -121,6 +144,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == true);
 	}
 
+	/* rohc_comp_set_trace_level() */
+	CHECK(rohc_comp_set_trace_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_comp_profile_enabled() */
 	CHECK(rohc_comp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_GENERAL) == false);
@@ -240,6 +269,112 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_optimistic_approach(comp, 64) == true);
 	CHECK(rohc_comp_set_optimistic_approach(comp, 16) == true);
 
+	/* rohc_comp_set_adaptive_oa() and rohc_comp_set_loss_estimate() */
+	CHECK(rohc_comp_set_adaptive_oa(NULL, 1) == false);
+	CHECK(rohc_comp_set_adaptive_oa(comp, 17) == false);
+	CHECK(rohc_comp_set_adaptive_oa(comp, 16) == true);
+	CHECK(rohc_comp_set_adaptive_oa(comp, 0) == true);
+	CHECK(rohc_comp_set_loss_estimate(NULL, 0) == false);
+	CHECK(rohc_comp_set_loss_estimate(comp, 1001) == false);
+	CHECK(rohc_comp_set_loss_estimate(comp, 1000) == true);
+	CHECK(rohc_comp_set_loss_estimate(comp, 0) == true);
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_adaptive_oa(comp2, 1) == true);
+
+		/* on a clean link, the IR packet is sent once only */
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte(rohc_pkt) == 0xfd);
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte(rohc_pkt) != 0xfd);
+
+		/* on a lossy link, the IR packets are repeated the configured times */
+		CHECK(rohc_comp_set_loss_estimate(comp2, 500) == true);
+		CHECK(rohc_comp_force_contexts_reinit(comp2) == true);
+		for(size_t i = 0; i < 4; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_buf_byte(rohc_pkt) == 0xfd);
+		}
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte(rohc_pkt) != 0xfd);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_set_adaptive_reorder() and rohc_comp_set_reorder_estimate() */
+	CHECK(rohc_comp_set_adaptive_reorder(NULL, true) == false);
+	CHECK(rohc_comp_set_adaptive_reorder(comp, true) == true);
+	CHECK(rohc_comp_set_adaptive_reorder(comp, false) == true);
+	CHECK(rohc_comp_set_reorder_estimate(NULL, 0) == false);
+	CHECK(rohc_comp_set_reorder_estimate(comp, 65536) == false);
+	CHECK(rohc_comp_set_reorder_estimate(comp, 65535) == true);
+	CHECK(rohc_comp_set_reorder_estimate(comp, 0) == true);
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_reorder_ratio(comp2, ROHC_REORDERING_THREEQUARTERS) == true);
+		CHECK(rohc_comp_set_adaptive_reorder(comp2, true) == true);
+		for(size_t i = 0; i < 4; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_buf_byte(rohc_pkt) == 0xfd);
+		}
+		for(size_t i = 0; i < 2; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+		CHECK(rohc_buf_byte(rohc_pkt) != 0xfa);
+
+		/* a new reorder ratio is transmitted in co_common packets first */
+		CHECK(rohc_comp_set_reorder_estimate(comp2, 10) == true);
+		for(size_t i = 0; i < 4; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_buf_byte(rohc_pkt) == 0xfa);
+			CHECK((rohc_buf_byte_at(rohc_pkt, 2) & 0x18) ==
+			      (ROHC_REORDERING_THREEQUARTERS << 3));
+		}
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte(rohc_pkt) != 0xfa);
+		rohc_comp_free(comp2);
+	}
+
 	/* rohc_comp_set_periodic_refreshes() */
 	CHECK(rohc_comp_set_periodic_refreshes(NULL, 1700, 700) == false);
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 0, 700) == false);
@@ -254,6 +389,71 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 5, 10) == false);
 	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 10, 5) == true);
 
+	/* rohc_comp_set_adaptive_refreshes() */
+	CHECK(rohc_comp_set_adaptive_refreshes(NULL, 25, 400) == false);
+	CHECK(rohc_comp_set_adaptive_refreshes(comp, 0, 400) == false);
+	CHECK(rohc_comp_set_adaptive_refreshes(comp, 101, 400) == false);
+	CHECK(rohc_comp_set_adaptive_refreshes(comp, 25, 99) == false);
+	CHECK(rohc_comp_set_adaptive_refreshes(comp, 25, 1001) == false);
+	CHECK(rohc_comp_set_adaptive_refreshes(comp, 100, 100) == true);
+	{
+		struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[40];
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		rohc_comp_general_info_t general_info;
+		unsigned long refreshes_nr[3];
+		unsigned long refresh_bytes_nr = 0;
+		struct rohc_comp *comp2;
+		size_t phase;
+		size_t i;
+
+		/* one IPv4/UDP flow */
+		memset(buf, 0, sizeof(buf));
+		buf[0] = 0x45;
+		buf[3] = sizeof(buf);
+		buf[8] = 0x40;
+		buf[9] = 0x11;
+		buf[12] = 0xc0; buf[13] = 0xa8; buf[14] = 0x13; buf[15] = 0x01;
+		buf[16] = 0xc0; buf[17] = 0xa8; buf[18] = 0x13; buf[19] = 0x05;
+		buf[20] = 0x04; buf[21] = 0xd2; buf[22] = 0x16; buf[23] = 0x2e;
+		buf[25] = sizeof(buf) - 20;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHCv1_PROFILE_IP_UDP, -1) == true);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_set_periodic_refreshes(comp2, 40, 20) == true);
+		CHECK(rohc_comp_set_adaptive_refreshes(comp2, 25, 400) == true);
+		memset(&general_info, 0, sizeof(rohc_comp_general_info_t));
+		general_info.version_minor = 6;
+
+		/* the refreshes are rare without loss, and frequent with many losses */
+		for(phase = 0; phase < 3; phase++)
+		{
+			const unsigned int losses[3] = { 0, 10, 100 };
+
+			CHECK(rohc_comp_set_loss_estimate(comp2, losses[phase]) == true);
+			CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+			refreshes_nr[phase] = general_info.refreshes_nr;
+			refresh_bytes_nr = general_info.refresh_bytes_nr;
+			for(i = 0; i < 400; i++)
+			{
+				rohc_pkt.len = 0;
+				CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			}
+			CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+			refreshes_nr[phase] = general_info.refreshes_nr - refreshes_nr[phase];
+			CHECK(general_info.refresh_bytes_nr > refresh_bytes_nr);
+		}
+		CHECK(refreshes_nr[0] > 0);
+		CHECK(refreshes_nr[0] < refreshes_nr[1]);
+		CHECK(refreshes_nr[1] < refreshes_nr[2]);
+
+		rohc_comp_free(comp2);
+	}
+
 	/* rohc_comp_set_rtp_detection_cb() */
 	{
 		rohc_rtp_detection_callback_t fct =
@@ -262,6 +462,374 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_rtp_detection_cb(comp, fct, NULL) == true);
 	}
 
+	/* rohc_comp_set_rtp_detection_interval() */
+	CHECK(rohc_comp_set_rtp_detection_interval(NULL, 10) == false);
+	CHECK(rohc_comp_set_rtp_detection_interval(comp, 0) == false);
+	CHECK(rohc_comp_set_rtp_detection_interval(comp, 10) == true);
+	CHECK(rohc_comp_set_rtp_detection_interval(comp, 1) == true);
+
+	/* rohc_comp_set_uncomp_flows_ttl() */
+	CHECK(rohc_comp_set_uncomp_flows_ttl(NULL, 10) == false);
+	CHECK(rohc_comp_set_uncomp_flows_ttl(comp, 10) == true);
+	CHECK(rohc_comp_set_uncomp_flows_ttl(comp, 0) == true);
+	{
+		struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x20,  0x00, 0x00, 0x20, 0x00,
+			0x40, 0x11, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x04, 0xd2, 0x16, 0x2e,
+			0x00, 0x0c, 0x00, 0x00,  0x01, 0x02, 0x03, 0x04
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp_pkt_info info;
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                ROHCv1_PROFILE_IP_UDP, -1) == true);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_set_uncomp_flows_ttl(comp2, 10) == true);
+
+		/* the IP fragment is accepted by the Uncompressed profile only */
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+
+		/* the next packets of the flow are not classified during the TTL */
+		buf[6] = 0x00;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+
+		/* other flows are still classified */
+		buf[21] = 0xd3;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+		buf[21] = 0xd2;
+
+		/* the flow is classified again once the TTL expired */
+		ts.sec += 10;
+		pkt.time = ts;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+
+		/* changing the enabled profiles forgets the flows */
+		buf[6] = 0x20;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv1_PROFILE_IP) == true);
+		buf[6] = 0x00;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_set_bulk_policy() */
+	CHECK(rohc_comp_set_bulk_policy(NULL, 50, 100, 10) == false);
+	CHECK(rohc_comp_set_bulk_policy(comp, 100, 50, 10) == false);
+	CHECK(rohc_comp_set_bulk_policy(comp, 50, 1001, 10) == false);
+	CHECK(rohc_comp_set_bulk_policy(comp, 50, 100, 0) == false);
+	CHECK(rohc_comp_set_bulk_policy(comp, 0, 0, 0) == true);
+	{
+		struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[1428];
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[1500];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 1500);
+		struct rohc_comp_pkt_info info;
+		struct rohc_comp *comp2;
+		size_t i;
+
+		/* one IPv4/UDP packet with a large payload */
+		memset(buf, 0, sizeof(buf));
+		buf[0] = 0x45;
+		buf[2] = sizeof(buf) >> 8;
+		buf[3] = sizeof(buf) & 0xff;
+		buf[8] = 0x40;
+		buf[9] = 0x11;
+		buf[12] = 0xc0; buf[13] = 0xa8; buf[14] = 0x13; buf[15] = 0x01;
+		buf[16] = 0xc0; buf[17] = 0xa8; buf[18] = 0x13; buf[19] = 0x05;
+		buf[20] = 0x04; buf[21] = 0xd2; buf[22] = 0x16; buf[23] = 0x2e;
+		buf[24] = (sizeof(buf) - 20) >> 8;
+		buf[25] = (sizeof(buf) - 20) & 0xff;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                ROHCv1_PROFILE_IP_UDP, -1) == true);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_set_bulk_policy(comp2, 50, 100, 10) == true);
+
+		/* the large packets of the flow are compressed until their savings
+		 * are measured over 64 packets, then they are sent uncompressed */
+		for(i = 0; i < 64; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+			CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+		}
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+
+		/* the flow is compressed again once its packets are small enough */
+		pkt.len = 40;
+		buf[2] = 0;
+		buf[3] = 40;
+		buf[24] = 0;
+		buf[25] = 20;
+		for(i = 0; i < 100 && info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		}
+		CHECK(i > 1 && i < 100);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+
+		/* the bulk flow is measured again once the TTL expired */
+		pkt.len = sizeof(buf);
+		buf[2] = sizeof(buf) >> 8;
+		buf[3] = sizeof(buf) & 0xff;
+		buf[24] = (sizeof(buf) - 20) >> 8;
+		buf[25] = (sizeof(buf) - 20) & 0xff;
+		for(i = 0; i < 200 && info.profile_id == ROHCv1_PROFILE_IP_UDP; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		}
+		CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+		ts.sec += 10;
+		pkt.time = ts;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+
+		/* no flow is sent uncompressed once the policy is disabled */
+		CHECK(rohc_comp_set_bulk_policy(comp2, 0, 0, 0) == true);
+		for(i = 0; i < 128; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+			CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+		}
+
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_set_overload() and rohc_comp_set_overload_latency() */
+	CHECK(rohc_comp_set_overload(NULL, ROHC_COMP_OVERLOAD_NONE) == false);
+	CHECK(rohc_comp_set_overload(comp, ROHC_COMP_OVERLOAD_SHED + 1) == false);
+	CHECK(rohc_comp_set_overload(comp, ROHC_COMP_OVERLOAD_NONE) == true);
+	CHECK(rohc_comp_set_overload_latency(NULL, 1000) == false);
+	CHECK(rohc_comp_set_overload_latency(comp, 0) == true);
+	{
+		struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[40];
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp_pkt_info info;
+		rohc_comp_general_info_t general_info;
+		struct rohc_comp *comp2;
+		size_t ir_normal_nr;
+		size_t ir_nr;
+		size_t i;
+
+		/* IPv4/UDP packets, the flow is given by the last byte of the
+		 * destination port */
+		memset(buf, 0, sizeof(buf));
+		buf[0] = 0x45;
+		buf[3] = sizeof(buf);
+		buf[8] = 0x40;
+		buf[9] = 0x11;
+		buf[12] = 0xc0; buf[13] = 0xa8; buf[14] = 0x13; buf[15] = 0x01;
+		buf[16] = 0xc0; buf[17] = 0xa8; buf[18] = 0x13; buf[19] = 0x05;
+		buf[20] = 0x04; buf[21] = 0xd2; buf[22] = 0x16; buf[23] = 0x00;
+		buf[25] = sizeof(buf) - 20;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                ROHCv1_PROFILE_IP_UDP, -1) == true);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_set_periodic_refreshes(comp2, 10, 5) == true);
+		memset(&general_info, 0, sizeof(rohc_comp_general_info_t));
+		general_info.version_minor = 5;
+
+		/* the IR refreshes of the flow are deferred up to twice their timeout */
+		for(ir_nr = 0, i = 0; i < 40; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+			CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+			ir_nr += (info.packet_type == ROHC_PACKET_IR);
+		}
+		CHECK(ir_nr > 4);
+		ir_normal_nr = ir_nr;
+		CHECK(rohc_comp_set_overload(comp2, ROHC_COMP_OVERLOAD_DEFER) == true);
+		for(ir_nr = 0, i = 0; i < 40; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+			CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+			ir_nr += (info.packet_type == ROHC_PACKET_IR);
+		}
+		CHECK(ir_nr > 0 && ir_nr < ir_normal_nr);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.overload_level == ROHC_COMP_OVERLOAD_DEFER);
+		CHECK(general_info.ir_refreshes_deferred_nr > 0);
+		CHECK(general_info.overload_shed_nr == 0);
+
+		/* no new flow gets a context, the existing flow keeps its context */
+		CHECK(rohc_comp_set_overload(comp2, ROHC_COMP_OVERLOAD_SHED) == true);
+		buf[23] = 0x01;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+		buf[23] = 0x00;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.overload_level == ROHC_COMP_OVERLOAD_SHED);
+		CHECK(general_info.overload_shed_nr == 1);
+
+		/* one new flow gets a context every 64 packets */
+		CHECK(rohc_comp_set_overload(comp2, ROHC_COMP_OVERLOAD_THROTTLE) == true);
+		buf[23] = 0x02;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+		buf[23] = 0x03;
+		for(i = 0; i < 100 && info.profile_id != ROHCv1_PROFILE_UNCOMPRESSED; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		}
+		CHECK(i == 1);
+		for(i = 0; i < 100 && info.profile_id != ROHCv1_PROFILE_IP_UDP; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		}
+		CHECK(i == 63);
+
+		/* new flows get contexts again once the compressor is not overloaded */
+		CHECK(rohc_comp_set_overload(comp2, ROHC_COMP_OVERLOAD_NONE) == true);
+		buf[23] = 0x04;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+
+		/* any compression is too slow for a step of 1 ns */
+		CHECK(rohc_comp_set_overload_latency(comp2, 1) == true);
+		for(i = 0; i < 10; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		}
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.overload_level == ROHC_COMP_OVERLOAD_SHED);
+		buf[23] = 0x05;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+		CHECK(rohc_comp_set_overload_latency(comp2, 0) == true);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.overload_level == ROHC_COMP_OVERLOAD_NONE);
+
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_set_warmup() */
+	CHECK(rohc_comp_set_warmup(NULL, 3, 1000) == false);
+	CHECK(rohc_comp_set_warmup(comp, 0, 0) == true);
+	{
+		struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[40];
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp_pkt_info info;
+		rohc_comp_general_info_t general_info;
+		struct rohc_comp *comp2;
+
+		/* IPv4/UDP packets, the flow is given by the last byte of the
+		 * destination port */
+		memset(buf, 0, sizeof(buf));
+		buf[0] = 0x45;
+		buf[3] = sizeof(buf);
+		buf[8] = 0x40;
+		buf[9] = 0x11;
+		buf[12] = 0xc0; buf[13] = 0xa8; buf[14] = 0x13; buf[15] = 0x01;
+		buf[16] = 0xc0; buf[17] = 0xa8; buf[18] = 0x13; buf[19] = 0x05;
+		buf[20] = 0x04; buf[21] = 0xd2; buf[22] = 0x16; buf[23] = 0x00;
+		buf[25] = sizeof(buf) - 20;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profiles(comp2, ROHCv1_PROFILE_UNCOMPRESSED,
+		                                ROHCv1_PROFILE_IP_UDP, -1) == true);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_set_warmup(comp2, 3, 100) == true);
+		memset(&general_info, 0, sizeof(rohc_comp_general_info_t));
+		general_info.version_minor = 7;
+
+		/* the 2 first packets of the new flow are not compressed, the 3rd one
+		 * gets a context */
+		for(size_t i = 0; i < 3; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+			CHECK(info.profile_id == (i < 2 ? ROHCv1_PROFILE_UNCOMPRESSED :
+			                          ROHCv1_PROFILE_IP_UDP));
+		}
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.warmup_held_nr == 2);
+		CHECK(general_info.contexts_nr == 2);
+
+		/* the packets of one new flow too far apart never end its warm-up */
+		buf[23] = 0x01;
+		for(size_t i = 0; i < 5; i++)
+		{
+			pkt.time.nsec = (i % 2) * 200 * 1000 * 1000;
+			pkt.time.sec += (i % 2 == 0);
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+			CHECK(info.profile_id == ROHCv1_PROFILE_UNCOMPRESSED);
+		}
+
+		/* the existing flow is not affected, and the warm-up may be disabled */
+		buf[23] = 0x00;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+		CHECK(rohc_comp_set_warmup(comp2, 1, 0) == true);
+		buf[23] = 0x02;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &info) == ROHC_STATUS_OK);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP_UDP);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.warmup_held_nr == 7);
+
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_set_mem_cbs() */
+	CHECK(rohc_comp_set_mem_cbs(NULL, mem_alloc_cb, mem_free_cb, NULL) == false);
+	CHECK(rohc_comp_set_mem_cbs(comp, mem_alloc_cb, NULL, NULL) == false);
+	CHECK(rohc_comp_set_mem_cbs(comp, NULL, mem_free_cb, NULL) == false);
+	CHECK(rohc_comp_set_mem_cbs(comp, NULL, NULL, NULL) == true);
+	CHECK(rohc_comp_set_mem_cbs(comp, mem_alloc_cb, mem_free_cb, NULL) == true);
+
 	/* rohc_comp_set_mrru() */
 	CHECK(rohc_comp_set_mrru(NULL, 10) == false);
 	CHECK(rohc_comp_set_mrru(comp, 65535 + 1) == false);
@@ -281,6 +849,52 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_mrru(comp, &mrru) == true);
 		CHECK(mrru == 65535);
 	}
+
+	/* rohc_comp_set_mem_cbs() moves the RRU buffer */
+	CHECK(rohc_comp_set_mem_cbs(comp, NULL, NULL, NULL) == true);
+	CHECK(rohc_comp_set_mem_cbs(comp, mem_alloc_cb, mem_free_cb, NULL) == true);
+
+	/* rohc_comp_preallocate() moves the RRU buffer, but not with callbacks */
+	CHECK(rohc_comp_preallocate(NULL) == false);
+	CHECK(rohc_comp_preallocate(comp) == false);
+	CHECK(rohc_comp_set_mem_cbs(comp, NULL, NULL, NULL) == true);
+	CHECK(rohc_comp_preallocate(comp) == true);
+	CHECK(rohc_comp_set_mem_cbs(comp, mem_alloc_cb, mem_free_cb, NULL) == true);
+
+	/* rohc_comp_set_channel_set() */
+	{
+		struct rohc_channel_set *const set = rohc_channel_set_new();
+		struct rohc_comp *comps[2];
+		size_t i;
+
+		CHECK(set != NULL);
+		CHECK(rohc_comp_set_channel_set(NULL, set) == false);
+		for(i = 0; i < 2; i++)
+		{
+			rohc_comp_mem_info_t info = { .version_major = 0, .version_minor = 0 };
+
+			comps[i] = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+			                          random_cb, NULL);
+			CHECK(comps[i] != NULL);
+			CHECK(rohc_comp_set_channel_set(comps[i], set) == true);
+			CHECK(rohc_comp_set_mrru(comps[i], 1000) == true);
+
+			/* the RRU buffer is carved from the slabs of the set */
+			CHECK(rohc_comp_get_mem_info(comps[i], &info) == true);
+			CHECK(info.used_bytes_nr >= 1000);
+			CHECK(info.slabs_bytes_nr == 0);
+		}
+
+		/* leave the set, then join it again */
+		CHECK(rohc_comp_set_channel_set(comps[0], NULL) == true);
+		CHECK(rohc_comp_set_channel_set(comps[0], set) == true);
+
+		/* the set is destroyed with its last channel */
+		rohc_channel_set_free(set);
+		rohc_comp_free(comps[0]);
+		rohc_comp_free(comps[1]);
+	}
+
 	/* disable MRRU for next tests */
 	CHECK(rohc_comp_set_mrru(comp, 0) == true);
 
@@ -353,6 +967,311 @@ int main(int argc, char *argv[])
 		pkt2.offset = 0;
 		pkt2.len = 0;
 		CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+
+		/* rohc_compress5() */
+		{
+			struct rohc_comp_pkt_info info;
+			pkt2.len = 0;
+			CHECK(rohc_compress5(NULL, pkt, &pkt2, &info) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress5(comp, pkt, &pkt2, NULL) == ROHC_STATUS_OK);
+			pkt2.len = 0;
+			memset(&info, 0, sizeof(struct rohc_comp_pkt_info));
+			CHECK(rohc_compress5(comp, pkt, &pkt2, &info) == ROHC_STATUS_OK);
+			CHECK(info.profile_id == ROHCv1_PROFILE_IP);
+			CHECK(info.is_context_init == false);
+			CHECK(info.uncomp_hdr_len > 0);
+			CHECK(info.hdr_len > 0);
+			CHECK(pkt2.len == (info.hdr_len + pkt.len - info.uncomp_hdr_len));
+		}
+
+		/* rohc_compress_hdrs_info() */
+		{
+			struct rohc_comp_hdrs_info hdrs_info;
+			memset(&hdrs_info, 0, sizeof(struct rohc_comp_hdrs_info));
+			hdrs_info.ip_hdrs_nr = 1;
+			hdrs_info.ip_versions[0] = 4;
+			hdrs_info.l4_proto = 1; /* ICMP */
+			hdrs_info.l4_offset = 20;
+			pkt2.len = 0;
+			CHECK(rohc_compress_hdrs_info(NULL, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_hdrs_info(comp, pkt, NULL, &pkt2) == ROHC_STATUS_ERROR);
+			hdrs_info.ip_hdrs_nr = 0;
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			hdrs_info.ip_hdrs_nr = ROHC_COMP_HDRS_INFO_IP_MAX + 1;
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			hdrs_info.ip_hdrs_nr = 1;
+			hdrs_info.ip_offsets[0] = 1;
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			hdrs_info.ip_offsets[0] = 0;
+			hdrs_info.l4_offset = pkt.len + 1;
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			/* the description shall match the packet */
+			hdrs_info.l4_offset = 24;
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			hdrs_info.l4_offset = 20;
+			hdrs_info.l4_proto = 17; /* UDP */
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			hdrs_info.l4_proto = 1; /* ICMP */
+			hdrs_info.ip_versions[0] = 6;
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_ERROR);
+			hdrs_info.ip_versions[0] = 4;
+			CHECK(pkt2.len == 0);
+			CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_OK);
+			CHECK(pkt2.len > 0);
+			/* the hash of the flow computed by the NIC */
+			hdrs_info.has_rss_hash = true;
+			hdrs_info.rss_hash = 0x12345678;
+			for(size_t i = 0; i < 2; i++)
+			{
+				pkt2.len = 0;
+				CHECK(rohc_compress_hdrs_info(comp, pkt, &hdrs_info, &pkt2) == ROHC_STATUS_OK);
+				CHECK(pkt2.len > 0);
+			}
+		}
+
+		/* rohc_comp_flow_hash() */
+		{
+			uint64_t hash;
+			uint64_t hash2;
+			CHECK(rohc_comp_flow_hash(NULL, pkt, &hash) == false);
+			pkt1.len = 0;
+			CHECK(rohc_comp_flow_hash(comp, pkt1, &hash) == false);
+			pkt1.len = 1;
+			CHECK(rohc_comp_flow_hash(comp, pkt, NULL) == false);
+			CHECK(rohc_comp_flow_hash(comp, pkt, &hash) == true);
+			/* the payload is not part of the flow */
+			buf[sizeof(buf) - 1]++;
+			CHECK(rohc_comp_flow_hash(comp, pkt, &hash2) == true);
+			CHECK(hash2 == hash);
+			buf[sizeof(buf) - 1]--;
+		}
+	}
+
+	/* rohc_compress_hdr() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_hdr = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_buf payload;
+		CHECK(rohc_compress_hdr(NULL, pkt, &rohc_hdr, &payload) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hdr(comp, pkt, NULL, &payload) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hdr(comp, pkt, &rohc_hdr, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hdr(comp, pkt, &rohc_hdr, &payload) == ROHC_STATUS_OK);
+		CHECK(rohc_hdr.len > 0);
+		CHECK(payload.data == buf);
+		CHECK(payload.len > 0);
+		CHECK((payload.offset + payload.len) == sizeof(buf));
+	}
+
+	/* rohc_compress_in_place() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t ip_pkt[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		uint8_t buf[100 + sizeof(ip_pkt)];
+		struct rohc_buf pkt = rohc_buf_init_empty(buf, sizeof(buf));
+		CHECK(rohc_compress_in_place(NULL, &pkt) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_in_place(comp, NULL) == ROHC_STATUS_ERROR);
+		/* no headroom for the ROHC header */
+		rohc_buf_append(&pkt, ip_pkt, sizeof(ip_pkt));
+		CHECK(rohc_compress_in_place(comp, &pkt) == ROHC_STATUS_ERROR);
+		CHECK(pkt.offset == 0 && pkt.len == sizeof(ip_pkt));
+		/* enough headroom for the ROHC header */
+		pkt.offset = 100;
+		pkt.len = 0;
+		pkt.time = ts;
+		rohc_buf_append(&pkt, ip_pkt, sizeof(ip_pkt));
+		CHECK(rohc_compress_in_place(comp, &pkt) == ROHC_STATUS_OK);
+		CHECK(pkt.len > 0);
+		CHECK((pkt.offset + pkt.len) == sizeof(buf));
+		CHECK(memcmp(buf + sizeof(buf) - 8, ip_pkt + 20, 8) == 0);
+	}
+
+	/* rohc_compress_burst() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkts[2] =
+		{
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+		};
+		uint8_t out1[100];
+		uint8_t out2[100];
+		struct rohc_buf rohc_pkts[2] =
+		{
+			rohc_buf_init_empty(out1, 100),
+			rohc_buf_init_empty(out2, 100),
+		};
+		rohc_status_t statuses[2];
+		CHECK(rohc_compress_burst(NULL, pkts, rohc_pkts, statuses, 2) == 0);
+		CHECK(rohc_compress_burst(comp, NULL, rohc_pkts, statuses, 2) == 0);
+		CHECK(rohc_compress_burst(comp, pkts, NULL, statuses, 2) == 0);
+		CHECK(rohc_compress_burst(comp, pkts, rohc_pkts, NULL, 2) == 0);
+		CHECK(rohc_compress_burst(comp, pkts, rohc_pkts, statuses, 0) == 0);
+		pkts[0].len = 0;
+		CHECK(rohc_compress_burst(comp, pkts, rohc_pkts, statuses, 2) == 2);
+		CHECK(statuses[0] == ROHC_STATUS_ERROR);
+		CHECK(statuses[1] == ROHC_STATUS_OK);
+		pkts[0].len = sizeof(buf);
+		rohc_pkts[1].len = 0;
+		CHECK(rohc_compress_burst(comp, pkts, rohc_pkts, statuses, 2) == 2);
+		CHECK(statuses[0] == ROHC_STATUS_OK);
+		CHECK(statuses[1] == ROHC_STATUS_OK);
+
+		/* rohc_compress_burst2() */
+		{
+			struct rohc_comp_pkt_info infos[2];
+			memset(infos, 0, sizeof(infos));
+			rohc_pkts[0].len = 0;
+			rohc_pkts[1].len = 0;
+			CHECK(rohc_compress_burst2(NULL, pkts, rohc_pkts, statuses, infos, 2) == 0);
+			CHECK(rohc_compress_burst2(comp, pkts, rohc_pkts, statuses, infos, 2) == 2);
+			CHECK(statuses[0] == ROHC_STATUS_OK);
+			CHECK(statuses[1] == ROHC_STATUS_OK);
+			for(size_t i = 0; i < 2; i++)
+			{
+				CHECK(infos[i].cid == infos[0].cid);
+				CHECK(infos[i].hdr_len > 0);
+				CHECK(rohc_pkts[i].len == (infos[i].hdr_len + pkts[i].len -
+				                           infos[i].uncomp_hdr_len));
+			}
+		}
+
+		/* rohc_comp_prefetch() */
+		{
+			struct rohc_buf malformed = rohc_buf_init_full(NULL, 1, ts);
+			struct rohc_comp_pkt_info infos[2];
+			rohc_comp_prefetch(NULL, pkts[0]);
+			rohc_comp_prefetch(comp, malformed);
+			pkts[0].len = 0;
+			rohc_comp_prefetch(comp, pkts[0]);
+			pkts[0].len = sizeof(buf);
+			/* the lookup is completed by the next calls */
+			rohc_comp_prefetch(comp, pkts[0]);
+			rohc_comp_prefetch(comp, pkts[1]);
+			rohc_comp_prefetch(comp, malformed);
+			rohc_comp_prefetch(comp, malformed);
+			/* compression is not changed by the prefetches */
+			rohc_pkts[0].len = 0;
+			rohc_pkts[1].len = 0;
+			CHECK(rohc_compress_burst2(comp, pkts, rohc_pkts, statuses, infos, 2) == 2);
+			CHECK(statuses[0] == ROHC_STATUS_OK);
+			CHECK(statuses[1] == ROHC_STATUS_OK);
+			CHECK(infos[0].cid == infos[1].cid);
+		}
+
+		/* rohc_compress_gso() */
+		{
+			size_t rohc_pkts_nr = 42;
+			rohc_pkts[0].len = 0;
+			rohc_pkts[1].len = 0;
+			CHECK(rohc_compress_gso(NULL, pkts[0], 1000, rohc_pkts, 2,
+			                        &rohc_pkts_nr) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_gso(comp, pkts[0], 1000, rohc_pkts, 2,
+			                        NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_gso(comp, pkts[0], 1000, NULL, 2,
+			                        &rohc_pkts_nr) == ROHC_STATUS_ERROR);
+			CHECK(rohc_pkts_nr == 0);
+			CHECK(rohc_compress_gso(comp, pkts[0], 0, rohc_pkts, 2,
+			                        &rohc_pkts_nr) == ROHC_STATUS_ERROR);
+			pkts[0].len = 0;
+			CHECK(rohc_compress_gso(comp, pkts[0], 1000, rohc_pkts, 2,
+			                        &rohc_pkts_nr) == ROHC_STATUS_ERROR);
+			pkts[0].len = sizeof(buf);
+			/* ICMP is not compressed by the IP/TCP or IP/UDP profiles */
+			CHECK(rohc_compress_gso(comp, pkts[0], 1000, rohc_pkts, 2,
+			                        &rohc_pkts_nr) == ROHC_STATUS_ERROR);
+			CHECK(rohc_pkts_nr == 0);
+			CHECK(rohc_pkts[0].len == 0);
+		}
+
+		/* rohc_compress_broadcast() */
+		{
+			rohc_cid_t cid_maps[2 * (ROHC_SMALL_CID_MAX + 1)];
+			struct rohc_comp_pkt_info info;
+			struct rohc_comp *comp2;
+			uint8_t feedback_buf[] = { 0xf1, 0x00 };
+			const struct rohc_buf feedback =
+				rohc_buf_init_full(feedback_buf, sizeof(feedback_buf), ts);
+
+			comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+			CHECK(comp2 != NULL);
+			CHECK(rohc_comp_enable_profile(comp2, ROHCv1_PROFILE_IP) == true);
+			rohc_pkts[0].len = 0;
+			rohc_pkts[1].len = 0;
+			CHECK(rohc_compress_broadcast(NULL, pkts[0], NULL, rohc_pkts, 2,
+			                              NULL) == ROHC_STATUS_ERROR);
+			/* broadcast mode is required */
+			CHECK(rohc_compress_broadcast(comp2, pkts[0], NULL, rohc_pkts, 2,
+			                              NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_BROADCAST) == true);
+			CHECK(rohc_compress_broadcast(comp2, pkts[0], NULL, NULL, 2,
+			                              NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_broadcast(comp2, pkts[0], NULL, rohc_pkts, 0,
+			                              NULL) == ROHC_STATUS_ERROR);
+			rohc_pkts[1].len = 1;
+			CHECK(rohc_compress_broadcast(comp2, pkts[0], NULL, rohc_pkts, 2,
+			                              NULL) == ROHC_STATUS_ERROR);
+			rohc_pkts[1].len = 0;
+
+			/* the same packet on every channel */
+			CHECK(rohc_compress_broadcast(comp2, pkts[0], NULL, rohc_pkts, 2,
+			                              &info) == ROHC_STATUS_OK);
+			CHECK(info.cid == 0);
+			CHECK(info.packet_type == ROHC_PACKET_IR);
+			CHECK(rohc_pkts[0].len > 0);
+			CHECK(rohc_pkts[1].len == rohc_pkts[0].len);
+			CHECK(memcmp(out1, out2, rohc_pkts[0].len) == 0);
+
+			/* the second channel gives CID 5 to the context */
+			for(size_t i = 0; i <= ROHC_SMALL_CID_MAX; i++)
+			{
+				cid_maps[i] = i;
+				cid_maps[ROHC_SMALL_CID_MAX + 1 + i] = 5;
+			}
+			rohc_pkts[0].len = 0;
+			rohc_pkts[1].len = 0;
+			CHECK(rohc_compress_broadcast(comp2, pkts[0], cid_maps, rohc_pkts, 2,
+			                              &info) == ROHC_STATUS_OK);
+			CHECK(rohc_pkts[1].len == (rohc_pkts[0].len + 1));
+			CHECK(rohc_buf_byte_at(rohc_pkts[1], 0) == 0xe5);
+			if(info.packet_type != ROHC_PACKET_IR)
+			{
+				CHECK(memcmp(out1, out2 + 1, rohc_pkts[0].len) == 0);
+			}
+
+			/* no room for the Add-CID */
+			rohc_pkts[0].len = 0;
+			rohc_pkts[1].len = 0;
+			rohc_pkts[1].max_len = info.hdr_len + pkts[0].len - info.uncomp_hdr_len;
+			CHECK(rohc_compress_broadcast(comp2, pkts[0], cid_maps, rohc_pkts, 2,
+			                              NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+			rohc_pkts[1].max_len = sizeof(out2);
+
+			/* the feedbacks are refused */
+			CHECK(rohc_comp_deliver_feedback2(comp2, feedback) == false);
+			rohc_comp_free(comp2);
+		}
 	}
 
 	/* rohc_comp_get_last_packet_info2() */
@@ -383,54 +1302,1811 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_general_info(comp, &info) == false);
 		info.version_minor = 0;
 		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_evicted_nr == 0);
+		info.version_minor = 2;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_expired_nr == 0);
+		info.version_minor = 3;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.feedbacks_foreign_nr == 0);
+		info.version_minor = 4;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.ir_refreshes_deferred_nr == 0);
+		info.version_minor = 5;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.overload_level == ROHC_COMP_OVERLOAD_NONE);
+		CHECK(info.overload_shed_nr == 0);
+		info.version_minor = 6;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.refreshes_nr == 0);
+		CHECK(info.refresh_bytes_nr == 0);
+		info.version_minor = 7;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.warmup_held_nr == 0);
+		info.version_minor = 8;
+		CHECK(rohc_comp_get_general_info(comp, &info) == false);
 	}
 
-	/* rohc_comp_get_state_descr() */
-	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_IR), "IR") == 0);
-	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_FO), "FO") == 0);
-	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_SO), "SO") == 0);
-	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_CR), "CR") == 0);
-	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_CR + 1), "no description") == 0);
-
-	/* rohc_comp_force_contexts_reinit() with some contexts init'ed */
-	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
+	/* rohc_comp_get_stats() */
+	{
+		static rohc_comp_stats_t stats;
+		uint64_t packets_nr = 0;
+		uint64_t hdr_bytes_nr = 0;
+		memset(&stats, 0, sizeof(rohc_comp_stats_t));
+		CHECK(rohc_comp_get_stats(NULL, &stats) == false);
+		CHECK(rohc_comp_get_stats(comp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_comp_get_stats(comp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 1;
+		CHECK(rohc_comp_get_stats(comp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_comp_get_stats(comp, &stats) == true);
+		CHECK(stats.packets_nr > 0);
+		CHECK(stats.comp_bytes_nr > 0);
+		CHECK(stats.uncomp_bytes_nr > 0);
+		for(size_t major = 0; major <= ROHC_PROFILE_ID_MAJOR_MAX; major++)
+		{
+			for(size_t minor = 0; minor <= ROHC_PROFILE_ID_MINOR_MAX; minor++)
+			{
+				for(size_t type = 0; type < ROHC_PACKET_MAX; type++)
+				{
+					packets_nr += stats.pkts[major][minor][type].packets_nr;
+					hdr_bytes_nr += stats.pkts[major][minor][type].hdr_bytes_nr;
+				}
+			}
+		}
+		CHECK(packets_nr == stats.packets_nr);
+		CHECK(hdr_bytes_nr > 0);
+		CHECK(hdr_bytes_nr <= stats.comp_bytes_nr);
+	}
 
-	/* rohc_comp_set_features */
-	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_COMPAT_1_6_x) == false);
-	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
-	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_DUMP_PACKETS) == true);
-	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) == true);
-	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
+	/* rohc_comp_get_contexts_info() */
+	{
+		struct rohc_comp_ctxt_record records[2];
+		rohc_comp_general_info_t info;
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr > 0);
+		CHECK(rohc_comp_get_contexts_info(NULL, records, 2) == 0);
+		CHECK(rohc_comp_get_contexts_info(comp, NULL, 2) == 0);
+		CHECK(rohc_comp_get_contexts_info(comp, records, 0) == 0);
+		CHECK(rohc_comp_get_contexts_info(comp, records, 2) == info.contexts_nr);
+		CHECK(records[0].packets_nr > 0);
+		CHECK(records[0].hdr_bytes_nr > 0);
+		CHECK(records[0].uncomp_hdr_bytes_nr > 0);
+		/* nothing is measured without the feature */
+		CHECK(records[0].processing_ns == 0);
+	}
 
-	/* rohc_comp_deliver_feedback2() */
+	/* rohc_comp_get_perf_info() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
-		uint8_t buf[] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
-		struct rohc_buf pkt = rohc_buf_init_full(buf, 5, ts);
-
-		CHECK(rohc_comp_deliver_feedback2(NULL, pkt) == false);
-		pkt.len = 0; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
-		pkt.len = 1; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
-		pkt.len = 2; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
-		pkt.len = 3; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
-		pkt.len = 4; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
-		pkt.len = 5; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		rohc_comp_perf_info_t info;
+		uint64_t buckets_count = 0;
+		memset(&info, 0, sizeof(rohc_comp_perf_info_t));
+		CHECK(rohc_comp_get_perf_info(NULL, &info) == false);
+		CHECK(rohc_comp_get_perf_info(comp, NULL) == false);
+		info.version_major = 0xffff;
+		CHECK(rohc_comp_get_perf_info(comp, &info) == false);
+		info.version_major = 0;
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_perf_info(comp, &info) == false);
+		info.version_minor = 0;
+		/* nothing is measured without the feature */
+		CHECK(rohc_comp_get_perf_info(comp, &info) == true);
+		CHECK(info.phases[ROHC_COMP_PERF_TOTAL].count == 0);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_PERF_INFO) == true);
+		CHECK(rohc_compress4(comp, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_perf_info(comp, &info) == true);
+		for(size_t i = 0; i < ROHC_COMP_PERF_PHASES_NR; i++)
+		{
+			CHECK(info.phases[i].count == 1);
+			CHECK(info.phases[i].min_ns == info.phases[i].max_ns);
+			CHECK(info.phases[i].sum_ns == info.phases[i].max_ns);
+		}
+		for(size_t i = 0; i < ROHC_PERF_HISTO_BUCKETS_NR; i++)
+		{
+			if(info.phases[ROHC_COMP_PERF_TOTAL].buckets[i] != 0)
+			{
+				CHECK(rohc_perf_histo_bucket_min(i) <= info.phases[ROHC_COMP_PERF_TOTAL].max_ns);
+			}
+			buckets_count += info.phases[ROHC_COMP_PERF_TOTAL].buckets[i];
+		}
+		CHECK(buckets_count == 1);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
+		/* the measured encoding is attributed to the context of the packet */
+		{
+			struct rohc_comp_ctxt_record records[2];
+			const size_t records_nr = rohc_comp_get_contexts_info(comp, records, 2);
+			uint64_t processing_ns = 0;
+			CHECK(records_nr > 0);
+			for(size_t i = 0; i < records_nr; i++)
+			{
+				processing_ns += records[i].processing_ns;
+			}
+			CHECK(processing_ns == info.phases[ROHC_COMP_PERF_ENCODE].sum_ns);
+		}
 	}
 
-	/* several functions with some packets already compressed */
+	/* rohc_comp_set_ctxt_event_cb() */
 	{
-		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
-		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		size_t events_nr[ROHC_COMP_CTXT_EVENT_MODE + 1] = { 0 };
+		struct rohc_comp *comp2;
 
-		CHECK(rohc_comp_set_optimistic_approach(comp, 16) == false);
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, 0, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv1_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_ctxt_event_cb(NULL, ctxt_event_cb, events_nr) == false);
+		CHECK(rohc_comp_set_ctxt_event_cb(comp2, ctxt_event_cb, events_nr) == true);
+		for(size_t i = 0; i < 10; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_CREATED] == 1);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_RECYCLED] == 0);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_RELEASED] == 0);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_STATE] > 0);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_MODE] == 0);
+		/* a new flow recycles the only context */
+		buf[15] = 0x02;
+		buf[11] = 0x89;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_CREATED] == 2);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_RECYCLED] == 1);
 
-		CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == false);
+		/* rohc_comp_reset() releases the context and resets the statistics,
+		 * the next packet starts a new context with an IR packet */
+		CHECK(rohc_comp_reset(NULL) == false);
+		CHECK(rohc_comp_reset(comp2) == true);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_RELEASED] == 1);
+		{
+			rohc_comp_general_info_t info = { .version_major = 0, .version_minor = 0 };
+			CHECK(rohc_comp_get_general_info(comp2, &info) == true);
+			CHECK(info.contexts_nr == 0);
+			CHECK(info.packets_nr == 0);
+		}
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte(rohc_pkt) == 0xfd);
+		CHECK(events_nr[ROHC_COMP_CTXT_EVENT_CREATED] == 3);
+		rohc_comp_free(comp2);
 	}
 
-	/* rohc_comp_free() */
+	/* rohc_comp_set_hash() */
+	{
+		const rohc_comp_hash_t hashes[] =
+		{
+			ROHC_COMP_HASH_SIPHASH24, ROHC_COMP_HASH_SIPHASH13,
+			ROHC_COMP_HASH_AES, ROHC_COMP_HASH_UNKEYED, ROHC_COMP_HASH_CUSTOM
+		};
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp *comp2;
+		size_t hash_calls_nr;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, 4, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_set_hash(NULL, ROHC_COMP_HASH_SIPHASH13, NULL, NULL) == false);
+		CHECK(rohc_comp_set_hash(comp2, ROHC_COMP_HASH_CUSTOM + 1, NULL, NULL) == false);
+		CHECK(rohc_comp_set_hash(comp2, ROHC_COMP_HASH_CUSTOM, NULL, NULL) == false);
+		rohc_comp_free(comp2);
+
+		for(size_t i = 0; i < (sizeof(hashes) / sizeof(hashes[0])); i++)
+		{
+			rohc_comp_general_info_t info = { .version_major = 0, .version_minor = 0 };
+			bool is_set;
+
+			comp2 = rohc_comp_new2(ROHC_SMALL_CID, 4, random_cb, NULL);
+			CHECK(comp2 != NULL);
+			CHECK(rohc_comp_enable_profile(comp2, ROHCv1_PROFILE_IP) == true);
+			hash_calls_nr = 0;
+			is_set = rohc_comp_set_hash(comp2, hashes[i], hash_cb, &hash_calls_nr);
+			/* the CPU may have no AES instructions */
+			CHECK(is_set || hashes[i] == ROHC_COMP_HASH_AES);
+
+			/* 2 flows, 2 contexts, whatever the hash */
+			for(size_t j = 0; j < 4; j++)
+			{
+				buf[15] = 0x01 + (j % 2);
+				buf[11] = 0x8a - (j % 2);
+				rohc_pkt.len = 0;
+				CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			}
+			CHECK(rohc_comp_get_general_info(comp2, &info) == true);
+			CHECK(info.contexts_nr == 2);
+			/* the callback is called for the custom hash only */
+			CHECK((hash_calls_nr > 0) == (hashes[i] == ROHC_COMP_HASH_CUSTOM));
+
+			/* the contexts exist, the hash cannot be changed anymore */
+			CHECK(rohc_comp_set_hash(comp2, ROHC_COMP_HASH_SIPHASH24, NULL, NULL) == false);
+			rohc_comp_free(comp2);
+		}
+		buf[15] = 0x01;
+		buf[11] = 0x8a;
+	}
+
+	/* rohc_comp_set_evict_policy() */
+	{
+		const rohc_comp_evict_t policies[] =
+		{
+			ROHC_COMP_EVICT_LRU, ROHC_COMP_EVICT_LFU,
+			ROHC_COMP_EVICT_SIZE_WEIGHTED, ROHC_COMP_EVICT_PROFILE_PRIORITY,
+			ROHC_COMP_EVICT_CUSTOM
+		};
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp *comp2;
+		size_t evict_calls_nr;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, 1, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_set_evict_policy(NULL, ROHC_COMP_EVICT_LFU, NULL, NULL) == false);
+		CHECK(rohc_comp_set_evict_policy(comp2, ROHC_COMP_EVICT_CUSTOM + 1, NULL, NULL) == false);
+		CHECK(rohc_comp_set_evict_policy(comp2, ROHC_COMP_EVICT_CUSTOM, NULL, NULL) == false);
+		rohc_comp_free(comp2);
+
+		for(size_t i = 0; i < (sizeof(policies) / sizeof(policies[0])); i++)
+		{
+			struct rohc_comp_ctxt_record records[2];
+			uint64_t packets_max = 0;
+			size_t records_nr;
+
+			comp2 = rohc_comp_new2(ROHC_SMALL_CID, 1, random_cb, NULL);
+			CHECK(comp2 != NULL);
+			CHECK(rohc_comp_enable_profile(comp2, ROHCv1_PROFILE_IP) == true);
+			evict_calls_nr = 0;
+			CHECK(rohc_comp_set_evict_policy(comp2, policies[i], evict_cb,
+			                                 &evict_calls_nr) == true);
+
+			/* 2 CIDs: 5 packets of flow 1, then 1 packet of flow 2, then flow 3
+			 * recycles flow 1 (least recently used) or flow 2 (least frequently
+			 * used, fewest bytes saved, or chosen by the callback) */
+			for(size_t j = 0; j < 7; j++)
+			{
+				const size_t flow = (j < 5 ? 0 : j - 4);
+				buf[15] = 0x01 + flow;
+				buf[11] = 0x8a - flow;
+				rohc_pkt.len = 0;
+				CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			}
+			records_nr = rohc_comp_get_contexts_info(comp2, records, 2);
+			CHECK(records_nr == 2);
+			for(size_t j = 0; j < records_nr; j++)
+			{
+				if(records[j].packets_nr > packets_max)
+				{
+					packets_max = records[j].packets_nr;
+				}
+			}
+			/* all the contexts share one profile, priority is LRU */
+			if(policies[i] == ROHC_COMP_EVICT_LRU ||
+			   policies[i] == ROHC_COMP_EVICT_PROFILE_PRIORITY)
+			{
+				CHECK(packets_max == 1);
+			}
+			else
+			{
+				CHECK(packets_max == 5);
+			}
+			/* the callback is called for the custom policy only */
+			CHECK((evict_calls_nr > 0) == (policies[i] == ROHC_COMP_EVICT_CUSTOM));
+			rohc_comp_free(comp2);
+		}
+		buf[15] = 0x01;
+		buf[11] = 0x8a;
+	}
+
+	/* rohc_comp_set_crc_engine() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffers[3][100];
+		struct rohc_buf rohc_pkts[3] =
+		{
+			rohc_buf_init_empty(rohc_buffers[0], 100),
+			rohc_buf_init_empty(rohc_buffers[1], 100),
+			rohc_buf_init_empty(rohc_buffers[2], 100),
+		};
+		size_t crc_calls_nr = 0;
+		const struct rohc_crc_engine engines[3] =
+		{
+			/* the tables of the library */
+			{ .crc_calc = NULL, .fcs32_calc = NULL, .priv_ctxt = NULL },
+			/* a CRC callback that is wrong on purpose */
+			{ .crc_calc = crc_calc_cb, .fcs32_calc = NULL, .priv_ctxt = &crc_calls_nr },
+			/* the same callback, but the tables are restored before the first
+			 * packet */
+			{ .crc_calc = crc_calc_cb, .fcs32_calc = NULL, .priv_ctxt = &crc_calls_nr },
+		};
+		struct rohc_comp *comps[3];
+
+		CHECK(rohc_comp_set_crc_engine(NULL, &engines[0]) == false);
+		for(size_t i = 0; i < 3; i++)
+		{
+			comps[i] = rohc_comp_new2(ROHC_SMALL_CID, 4, random_cb, NULL);
+			CHECK(comps[i] != NULL);
+			CHECK(rohc_comp_enable_profile(comps[i], ROHCv1_PROFILE_IP) == true);
+			CHECK(rohc_comp_set_crc_engine(comps[i], &engines[i]) == true);
+		}
+		CHECK(rohc_comp_set_crc_engine(comps[2], NULL) == true);
+
+		/* IR then UO-0 packets: the CRC-8 of the IR packets and the CRC-3 of
+		 * the UO-0 packets are computed by the engine */
+		for(size_t j = 0; j < 5; j++)
+		{
+			for(size_t i = 0; i < 3; i++)
+			{
+				rohc_pkts[i].len = 0;
+				CHECK(rohc_compress4(comps[i], pkt, &rohc_pkts[i]) == ROHC_STATUS_OK);
+			}
+			CHECK(rohc_pkts[1].len == rohc_pkts[0].len);
+			CHECK(memcmp(rohc_buf_data(rohc_pkts[1]), rohc_buf_data(rohc_pkts[0]),
+			             rohc_pkts[0].len) != 0);
+			CHECK(rohc_pkts[2].len == rohc_pkts[0].len);
+			CHECK(memcmp(rohc_buf_data(rohc_pkts[2]), rohc_buf_data(rohc_pkts[0]),
+			             rohc_pkts[0].len) == 0);
+		}
+		CHECK(crc_calls_nr > 0);
+
+		for(size_t i = 0; i < 3; i++)
+		{
+			rohc_comp_free(comps[i]);
+		}
+	}
+
+	/* many ESP SAs, more than the entries of the index by SPI, and several
+	 * SAs with the same SPI but different outer addresses */
+	{
+		const rohc_profile_t esp_profiles[] =
+			{ ROHCv1_PROFILE_IP_ESP, ROHCv2_PROFILE_IP_ESP };
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x24,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x32, 0x93, 0x51,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00,  0x01, 0x02, 0x03, 0x04,
+			0x05, 0x06, 0x07, 0x08
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		const size_t sas_nr = 3000;
+
+		for(size_t i = 0; i < (sizeof(esp_profiles) / sizeof(esp_profiles[0])); i++)
+		{
+			rohc_comp_general_info_t info = { .version_major = 0, .version_minor = 0 };
+			struct rohc_comp *comp2;
+
+			comp2 = rohc_comp_new2(ROHC_LARGE_CID, 4000, random_cb, NULL);
+			CHECK(comp2 != NULL);
+			CHECK(rohc_comp_enable_profile(comp2, esp_profiles[i]) == true);
+			for(size_t sn = 1; sn <= 3; sn++)
+			{
+				for(size_t sa = 0; sa < sas_nr; sa++)
+				{
+					const uint32_t spi = 0x1000 + sa / 2;
+
+					buf[19] = 0x05 + (sa % 2);
+					buf[11] = 0x51 - (sa % 2);
+					buf[20] = (spi >> 24) & 0xff;
+					buf[21] = (spi >> 16) & 0xff;
+					buf[22] = (spi >> 8) & 0xff;
+					buf[23] = spi & 0xff;
+					buf[27] = sn;
+					rohc_pkt.len = 0;
+					CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+				}
+				/* one context per SA, found again for the next packets */
+				CHECK(rohc_comp_get_general_info(comp2, &info) == true);
+				CHECK(info.contexts_nr == sas_nr);
+				CHECK(info.packets_nr == sas_nr * sn);
+			}
+			rohc_comp_free(comp2);
+		}
+	}
+
+	/* rohc_comp_set_mem_budget() and rohc_comp_get_mem_info() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		rohc_comp_general_info_t general_info;
+		rohc_comp_mem_info_t info;
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv1_PROFILE_IP) == true);
+		memset(&info, 0, sizeof(rohc_comp_mem_info_t));
+		CHECK(rohc_comp_get_mem_info(NULL, &info) == false);
+		CHECK(rohc_comp_get_mem_info(comp2, NULL) == false);
+		info.version_major = 0xffff;
+		CHECK(rohc_comp_get_mem_info(comp2, &info) == false);
+		info.version_major = 0;
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_mem_info(comp2, &info) == false);
+		info.version_minor = 0;
+		CHECK(rohc_comp_get_mem_info(comp2, &info) == true);
+		CHECK(info.budget_bytes_nr == 0);
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_mem_info(comp2, &info) == true);
+		CHECK(info.used_bytes_nr > 0);
+		CHECK(info.refused_nr == 0);
+
+		/* no room for a second context: the first one is released */
+		CHECK(rohc_comp_set_mem_budget(NULL, info.used_bytes_nr) == false);
+		CHECK(rohc_comp_set_mem_budget(comp2, info.used_bytes_nr) == true);
+		buf[15] = 0x02;
+		buf[11] = 0x89;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		memset(&general_info, 0, sizeof(rohc_comp_general_info_t));
+		general_info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.contexts_nr == 1);
+		CHECK(general_info.contexts_evicted_nr == 1);
+		CHECK(rohc_comp_get_mem_info(comp2, &info) == true);
+		CHECK(info.used_bytes_nr <= info.budget_bytes_nr);
+		CHECK(info.refused_nr > 0);
+
+		/* the context in use is not idle: the new flow is refused */
+		CHECK(rohc_comp_set_ctxt_idle_timeout(comp2, 1000) == true);
+		buf[15] = 0x03;
+		buf[11] = 0x88;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_NO_MEMORY);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.contexts_nr == 1);
+		CHECK(general_info.contexts_evicted_nr == 1);
+
+		/* no budget anymore */
+		CHECK(rohc_comp_set_mem_budget(comp2, 0) == true);
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_preallocate(comp2) == false);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.contexts_nr == 2);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_save_contexts() and rohc_comp_restore_contexts() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		uint8_t rohc_buffer2[100];
+		struct rohc_buf rohc_pkt2 = rohc_buf_init_empty(rohc_buffer2, 100);
+		uint8_t image[1000];
+		size_t image_len;
+		size_t ctxts_nr;
+		struct rohc_comp *comp2;
+		struct rohc_comp *comp3;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		for(size_t i = 0; i < 10; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+
+		CHECK(rohc_comp_save_contexts(NULL, image, sizeof(image), &image_len) == false);
+		CHECK(rohc_comp_save_contexts(comp2, image, sizeof(image), NULL) == false);
+		CHECK(rohc_comp_save_contexts(comp2, NULL, 0, &image_len) == false);
+		CHECK(image_len > 0 && image_len <= sizeof(image));
+		CHECK(rohc_comp_save_contexts(comp2, image, image_len - 1, &image_len) == false);
+		CHECK(rohc_comp_save_contexts(comp2, image, sizeof(image), &image_len) == true);
+
+		comp3 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp3 != NULL);
+		CHECK(rohc_comp_enable_profile(comp3, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_restore_contexts(NULL, image, image_len, ts, &ctxts_nr) == false);
+		CHECK(rohc_comp_restore_contexts(comp3, NULL, image_len, ts, &ctxts_nr) == false);
+		CHECK(rohc_comp_restore_contexts(comp3, image, image_len, ts, NULL) == false);
+		CHECK(rohc_comp_restore_contexts(comp3, image, image_len - 1, ts, &ctxts_nr) == false);
+		CHECK(rohc_comp_restore_contexts(comp3, image, image_len, ts, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 1);
+		/* the CID is already in use */
+		CHECK(rohc_comp_restore_contexts(comp3, image, image_len, ts, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 0);
+
+		/* the restored context compresses as the saved one */
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_compress4(comp3, pkt, &rohc_pkt2) == ROHC_STATUS_OK);
+		CHECK(rohc_pkt.len == rohc_pkt2.len);
+		CHECK(memcmp(rohc_buf_data(rohc_pkt), rohc_buf_data(rohc_pkt2),
+		             rohc_pkt.len) == 0);
+		rohc_comp_free(comp3);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_export_context() and rohc_comp_import_context() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		uint8_t rohc_buffer2[100];
+		struct rohc_buf rohc_pkt2 = rohc_buf_init_empty(rohc_buffer2, 100);
+		rohc_comp_general_info_t general_info = {
+			.version_major = 0,
+			.version_minor = 0,
+		};
+		uint8_t image[1000];
+		size_t image_len;
+		struct rohc_comp *comp2;
+		struct rohc_comp *comp3;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		for(size_t i = 0; i < 10; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+
+		CHECK(rohc_comp_export_context(NULL, 0, false, image, sizeof(image), &image_len) == false);
+		CHECK(rohc_comp_export_context(comp2, 0, false, image, sizeof(image), NULL) == false);
+		CHECK(rohc_comp_export_context(comp2, 1, false, image, sizeof(image), &image_len) == false);
+		CHECK(rohc_comp_export_context(comp2, 0, false, NULL, 0, &image_len) == false);
+		CHECK(image_len > 0 && image_len <= sizeof(image));
+		CHECK(rohc_comp_export_context(comp2, 0, false, image, image_len - 1, &image_len) == false);
+		CHECK(rohc_comp_export_context(comp2, 0, false, image, sizeof(image), &image_len) == true);
+
+		comp3 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp3 != NULL);
+		CHECK(rohc_comp_enable_profile(comp3, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_import_context(NULL, image, image_len, ts) == false);
+		CHECK(rohc_comp_import_context(comp3, NULL, image_len, ts) == false);
+		CHECK(rohc_comp_import_context(comp3, image, image_len - 1, ts) == false);
+		CHECK(rohc_comp_import_context(comp3, image, image_len, ts) == true);
+		/* the CID is already in use */
+		CHECK(rohc_comp_import_context(comp3, image, image_len, ts) == false);
+
+		/* the imported context compresses as the exported one */
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_compress4(comp3, pkt, &rohc_pkt2) == ROHC_STATUS_OK);
+		CHECK(rohc_pkt.len == rohc_pkt2.len);
+		CHECK(memcmp(rohc_buf_data(rohc_pkt), rohc_buf_data(rohc_pkt2),
+		             rohc_pkt.len) == 0);
+
+		/* the released context is not in use anymore */
+		CHECK(rohc_comp_export_context(comp2, 0, true, image, sizeof(image), &image_len) == true);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.contexts_nr == 0);
+		CHECK(rohc_comp_export_context(comp2, 0, true, image, sizeof(image), &image_len) == false);
+		rohc_comp_free(comp3);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_set_refresh_scheduler() */
+	{
+		struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		rohc_comp_general_info_t general_info;
+		size_t ir_nr[2] = { 0, 0 };
+		struct rohc_comp *comp2;
+
+		for(size_t with_budget = 0; with_budget <= 1; with_budget++)
+		{
+			comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+			CHECK(comp2 != NULL);
+			CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+			CHECK(rohc_comp_set_periodic_refreshes(comp2, 10, 5) == true);
+			if(with_budget)
+			{
+				CHECK(rohc_comp_set_refresh_scheduler(NULL, 0, 1, 1000) == false);
+				CHECK(rohc_comp_set_refresh_scheduler(comp2, 51, 1, 1000) == false);
+				CHECK(rohc_comp_set_refresh_scheduler(comp2, 0, 1, 0) == false);
+				CHECK(rohc_comp_set_refresh_scheduler(comp2, 50, 0, 0) == true);
+				CHECK(rohc_comp_set_refresh_scheduler(comp2, 0, 1, 1000) == true);
+			}
+			for(size_t i = 0; i < 30; i++)
+			{
+				rohc_pkt.len = 0;
+				CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+				if(rohc_buf_byte_at(rohc_pkt, 0) == 0xfd)
+				{
+					ir_nr[with_budget]++;
+				}
+			}
+			memset(&general_info, 0, sizeof(rohc_comp_general_info_t));
+			general_info.version_minor = 4;
+			CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+			CHECK((general_info.ir_refreshes_deferred_nr > 0) == with_budget);
+			if(with_budget)
+			{
+				/* the deferred IR refresh is sent in the next interval */
+				pkt.time.sec = 2;
+				rohc_pkt.len = 0;
+				CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+				CHECK(rohc_buf_byte_at(rohc_pkt, 0) == 0xfd);
+				pkt.time.sec = 0;
+			}
+			rohc_comp_free(comp2);
+		}
+		/* the periodic IR refreshes are deferred, not the first IR packets */
+		CHECK(ir_nr[1] > 0);
+		CHECK(ir_nr[1] < ir_nr[0]);
+	}
+
+	/* rohc_comp_set_ip_id_hysteresis() */
+	{
+		struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp_ctxt_record record;
+		uint64_t changes_nr[2] = { 0, 0 };
+		struct rohc_comp *comp2;
+
+		CHECK(rohc_comp_set_ip_id_hysteresis(NULL, 3) == false);
+		CHECK(rohc_comp_set_ip_id_hysteresis(comp, 0) == false);
+		CHECK(rohc_comp_set_ip_id_hysteresis(comp, 64) == false);
+		CHECK(rohc_comp_set_ip_id_hysteresis(comp, 1) == true);
+
+		for(size_t with_hysteresis = 0; with_hysteresis <= 1; with_hysteresis++)
+		{
+			comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+			CHECK(comp2 != NULL);
+			CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+			if(with_hysteresis)
+			{
+				CHECK(rohc_comp_set_ip_id_hysteresis(comp2, 3) == true);
+			}
+			/* sequential IP-IDs with one IP-ID out of pattern every 10 packets */
+			for(uint16_t i = 0; i < 40; i++)
+			{
+				const uint16_t ip_id = ((i % 10) == 5 ? 0xabcd : i);
+				uint32_t sum = 0;
+
+				buf[4] = (ip_id >> 8) & 0xff;
+				buf[5] = ip_id & 0xff;
+				buf[10] = 0;
+				buf[11] = 0;
+				for(size_t j = 0; j < 20; j += 2)
+				{
+					sum += (buf[j] << 8) | buf[j + 1];
+				}
+				sum = (sum & 0xffff) + (sum >> 16);
+				sum = (sum & 0xffff) + (sum >> 16);
+				buf[10] = ((~sum) >> 8) & 0xff;
+				buf[11] = (~sum) & 0xff;
+
+				rohc_pkt.len = 0;
+				CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			}
+			CHECK(rohc_comp_get_contexts_info(comp2, &record, 1) == 1);
+			changes_nr[with_hysteresis] = record.ip_id_behavior_changes_nr;
+			rohc_comp_free(comp2);
+		}
+		/* the IP-IDs out of pattern do not change the behavior anymore */
+		CHECK(changes_nr[0] > 0);
+		CHECK(changes_nr[1] == 0);
+	}
+
+	/* periodic refreshes on time, compared with the deadlines of contexts */
+	{
+		struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_periodic_refreshes_time(comp2, 1000, 500) == true);
+		CHECK(rohc_comp_set_features(comp2, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) == true);
+		for(size_t i = 0; i < 20; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) != 0xfd);
+		pkt.time.nsec = 400000000;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) != 0xfd);
+		pkt.time.nsec = 600000000;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) != 0xfd);
+		pkt.time.sec = 1;
+		pkt.time.nsec = 100000000;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) == 0xfd);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_compress_dryrun() */
+	{
+		struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		rohc_comp_general_info_t general_info = {
+			.version_major = 0,
+			.version_minor = 0,
+		};
+		struct rohc_comp_pkt_info pkt_info;
+		rohc_packet_t packet_type;
+		size_t hdr_len;
+		size_t pkt_len;
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_compress_dryrun(comp2, pkt, &hdr_len, &pkt_len, &packet_type) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_compress_dryrun(NULL, pkt, &hdr_len, &pkt_len, &packet_type) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_dryrun(comp2, pkt, NULL, &pkt_len, &packet_type) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_dryrun(comp2, pkt, &hdr_len, &pkt_len, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_dryrun(comp2, pkt, &hdr_len, NULL, &packet_type) == ROHC_STATUS_OK);
+		CHECK(packet_type == ROHC_PACKET_IR);
+
+		/* the predictions match the compressed packets, and do not change the
+		 * contexts */
+		for(size_t i = 0; i < 10; i++)
+		{
+			CHECK(rohc_compress_dryrun(comp2, pkt, &hdr_len, &pkt_len, &packet_type) == ROHC_STATUS_OK);
+			CHECK(rohc_compress_dryrun(comp2, pkt, &hdr_len, &pkt_len, &packet_type) == ROHC_STATUS_OK);
+			CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+			CHECK(general_info.packets_nr == i);
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress5(comp2, pkt, &rohc_pkt, &pkt_info) == ROHC_STATUS_OK);
+			CHECK(pkt_info.packet_type == packet_type);
+			CHECK(pkt_info.hdr_len == hdr_len);
+			CHECK(rohc_pkt.len == pkt_len);
+		}
+		CHECK(packet_type != ROHC_PACKET_IR);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_compress_constrained() */
+	{
+		struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		rohc_comp_general_info_t general_info = {
+			.version_major = 0,
+			.version_minor = 0,
+		};
+		const size_t max_len = 12;
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_periodic_refreshes(comp2, 10, 5) == true);
+		CHECK(rohc_compress_constrained(NULL, pkt, &rohc_pkt, max_len) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_constrained(comp2, pkt, NULL, max_len) == ROHC_STATUS_ERROR);
+
+		/* the IR packet of a new context cannot be avoided */
+		CHECK(rohc_compress_constrained(comp2, pkt, &rohc_pkt, max_len) == ROHC_STATUS_TOO_LARGE);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.contexts_nr == 0);
+		CHECK(general_info.packets_nr == 0);
+		CHECK(rohc_compress_constrained(comp2, pkt, &rohc_pkt, sizeof(rohc_buffer)) == ROHC_STATUS_OK);
+		CHECK(rohc_pkt.len > max_len);
+		for(size_t i = 0; i < 10; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+		CHECK(rohc_pkt.len <= max_len);
+
+		/* the periodic refreshes are deferred while the packets are constrained */
+		for(size_t i = 0; i < 30; i++)
+		{
+			rohc_pkt.len = 0;
+			CHECK(rohc_compress_constrained(comp2, pkt, &rohc_pkt, max_len) == ROHC_STATUS_OK);
+			CHECK(rohc_pkt.len <= max_len);
+		}
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_pkt.len > max_len);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_compress_with_feedbacks() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t fb_buffer[] = { 0xf2, 0x20, 0x01 };
+		struct rohc_buf feedbacks =
+			rohc_buf_init_full(fb_buffer, sizeof(fb_buffer), ts);
+		uint8_t rohc_buffer[200];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 200);
+		uint8_t rohc_buffer2[200];
+		struct rohc_buf rohc_pkt2 = rohc_buf_init_empty(rohc_buffer2, 200);
+		struct rohc_comp *comp2;
+		struct rohc_comp *comp3;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		comp3 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp3 != NULL);
+		CHECK(rohc_comp_enable_profile(comp3, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_compress_with_feedbacks(NULL, pkt, &rohc_pkt, &feedbacks) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_with_feedbacks(comp3, pkt, &rohc_pkt, NULL) == ROHC_STATUS_ERROR);
+
+		/* the feedbacks are written in front of the ROHC packet */
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt2) == ROHC_STATUS_OK);
+		CHECK(rohc_compress_with_feedbacks(comp3, pkt, &rohc_pkt, &feedbacks) == ROHC_STATUS_OK);
+		CHECK(feedbacks.len == 0);
+		CHECK(rohc_pkt.offset == 0);
+		CHECK(rohc_pkt.len == (sizeof(fb_buffer) + rohc_pkt2.len));
+		CHECK(memcmp(rohc_buf_data(rohc_pkt), fb_buffer, sizeof(fb_buffer)) == 0);
+		CHECK(memcmp(rohc_buf_data_at(rohc_pkt, sizeof(fb_buffer)),
+		             rohc_buf_data(rohc_pkt2), rohc_pkt2.len) == 0);
+
+		/* the feedbacks wait if the output buffer is too small */
+		rohc_buf_push(&feedbacks, sizeof(fb_buffer));
+		rohc_pkt.max_len = sizeof(buf) + 1;
+		rohc_pkt.offset = 0;
+		rohc_pkt.len = 0;
+		CHECK(rohc_compress_with_feedbacks(comp3, pkt, &rohc_pkt, &feedbacks) == ROHC_STATUS_OK);
+		CHECK(feedbacks.len == sizeof(fb_buffer));
+		CHECK(rohc_pkt.len > 0);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) != fb_buffer[0]);
+
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp3);
+	}
+
+	/* rohc_compress_iov() and rohc_comp_get_segment_iov() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t hdrs[] =
+		{
+			0x45, 0x00, 0x00, 0x80,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x26,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		uint8_t buf[128];
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[60];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 60);
+		uint8_t hdr_buffer[60];
+		struct rohc_buf rohc_hdr = rohc_buf_init_empty(hdr_buffer, 60);
+		uint8_t big_buffer[200];
+		struct rohc_buf big_hdr = rohc_buf_init_empty(big_buffer, 200);
+		struct rohc_buf payload;
+		uint8_t seg_buffer[40];
+		struct rohc_buf seg = rohc_buf_init_empty(seg_buffer, 40);
+		struct rohc_comp_seg_iov iov[ROHC_COMP_SEG_IOV_MAX];
+		size_t iov_nr;
+		struct rohc_comp *comp2;
+		struct rohc_comp *comp3;
+		rohc_status_t status2;
+		rohc_status_t status3;
+		size_t segs_nr = 0;
+
+		memcpy(buf, hdrs, sizeof(hdrs));
+		for(size_t i = sizeof(hdrs); i < sizeof(buf); i++)
+		{
+			buf[i] = i;
+		}
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_mrru(comp2, 500) == true);
+		comp3 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp3 != NULL);
+		CHECK(rohc_comp_enable_profile(comp3, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_mrru(comp3, 500) == true);
+
+		CHECK(rohc_compress_iov(NULL, pkt, &rohc_hdr, &payload) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_iov(comp3, pkt, &rohc_hdr, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_iov(NULL, 40, iov, &iov_nr) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_iov(comp3, 40, NULL, &iov_nr) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_iov(comp3, 40, iov, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_comp_get_segment_iov(comp3, 40, iov, &iov_nr) == ROHC_STATUS_ERROR);
+
+		/* the segments described without copy are the copied segments */
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_SEGMENT);
+		CHECK(rohc_compress_iov(comp3, pkt, &rohc_hdr, &payload) == ROHC_STATUS_SEGMENT);
+		CHECK(rohc_hdr.len == 0);
+		CHECK(payload.len == 0);
+		CHECK(rohc_comp_get_segment_iov(comp3, 1, iov, &iov_nr) == ROHC_STATUS_ERROR);
+		do
+		{
+			size_t seg_len = 0;
+
+			seg.len = 0;
+			status2 = rohc_comp_get_segment2(comp2, &seg);
+			status3 = rohc_comp_get_segment_iov(comp3, 40, iov, &iov_nr);
+			CHECK(status2 == status3);
+			CHECK(iov_nr >= 2 && iov_nr <= ROHC_COMP_SEG_IOV_MAX);
+			for(size_t i = 0; i < iov_nr; i++)
+			{
+				CHECK(seg_len + iov[i].len <= seg.len);
+				CHECK(memcmp(rohc_buf_data_at(seg, seg_len), iov[i].data,
+				             iov[i].len) == 0);
+				seg_len += iov[i].len;
+			}
+			CHECK(seg_len == seg.len);
+			segs_nr++;
+		}
+		while(status3 == ROHC_STATUS_SEGMENT);
+		CHECK(status3 == ROHC_STATUS_OK);
+		CHECK(segs_nr > 1);
+		CHECK(rohc_comp_get_segment_iov(comp3, 40, iov, &iov_nr) == ROHC_STATUS_ERROR);
+
+		/* no segmentation if the ROHC packet fits */
+		CHECK(rohc_compress_iov(comp3, pkt, &big_hdr, &payload) == ROHC_STATUS_OK);
+		CHECK(big_hdr.len > 0);
+		CHECK(payload.len == sizeof(buf) - sizeof(hdrs));
+		CHECK(rohc_comp_get_segment_iov(comp3, 40, iov, &iov_nr) == ROHC_STATUS_ERROR);
+
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp3);
+	}
+
+	/* rohc_compress_chain() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t hdrs[] =
+		{
+			0x45, 0x00, 0x00, 0x80,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x26,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05
+		};
+		uint8_t buf[128];
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		struct rohc_buf segs[3];
+		struct rohc_buf_chain chain = { .segs = segs, .segs_nr = 3, .segs_max = 3 };
+		struct rohc_buf payload_segs[3];
+		struct rohc_buf_chain payload =
+			{ .segs = payload_segs, .segs_nr = 0, .segs_max = 3 };
+		uint8_t rohc_buffer[200];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 200);
+		uint8_t hdr_buffer[60];
+		struct rohc_buf rohc_hdr = rohc_buf_init_empty(hdr_buffer, 60);
+		struct rohc_comp *comp2;
+		struct rohc_comp *comp3;
+
+		memcpy(buf, hdrs, sizeof(hdrs));
+		for(size_t i = sizeof(hdrs); i < sizeof(buf); i++)
+		{
+			buf[i] = i & 0xff;
+		}
+		for(size_t i = 0; i < 3; i++)
+		{
+			segs[i] = pkt;
+		}
+		segs[0].len = 40;
+		segs[1].offset = 40;
+		segs[1].len = 60;
+		segs[2].offset = 100;
+		segs[2].len = sizeof(buf) - 100;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHC_PROFILE_IP) == true);
+		comp3 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp3 != NULL);
+		CHECK(rohc_comp_enable_profile(comp3, ROHC_PROFILE_IP) == true);
+
+		CHECK(rohc_compress_chain(NULL, chain, &rohc_hdr, &payload) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_chain(comp3, chain, &rohc_hdr, NULL) == ROHC_STATUS_ERROR);
+		chain.segs_nr = 0;
+		CHECK(rohc_compress_chain(comp3, chain, &rohc_hdr, &payload) == ROHC_STATUS_ERROR);
+		chain.segs_nr = 4;
+		CHECK(rohc_compress_chain(comp3, chain, &rohc_hdr, &payload) == ROHC_STATUS_ERROR);
+		chain.segs_nr = 3;
+		payload.segs_max = 2;
+		CHECK(rohc_compress_chain(comp3, chain, &rohc_hdr, &payload) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+		payload.segs_max = 3;
+
+		/* the headers shall be in the first segment */
+		segs[0].len = 10;
+		segs[1].offset = 10;
+		segs[1].len = 90;
+		CHECK(rohc_compress_chain(comp3, chain, &rohc_hdr, &payload) == ROHC_STATUS_ERROR);
+		segs[0].len = 40;
+		segs[1].offset = 40;
+		segs[1].len = 60;
+
+		/* the ROHC packets are the ones of the contiguous packet */
+		for(size_t n = 0; n < 5; n++)
+		{
+			size_t payload_len = 0;
+
+			rohc_buf_reset(&rohc_pkt);
+			rohc_buf_reset(&rohc_hdr);
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_compress_chain(comp3, chain, &rohc_hdr, &payload) == ROHC_STATUS_OK);
+			CHECK(rohc_hdr.len > 0);
+			CHECK(payload.segs_nr == 3);
+			CHECK(payload.segs[0].len == (segs[0].len - sizeof(hdrs)));
+			CHECK(rohc_buf_data(payload.segs[0]) == (buf + sizeof(hdrs)));
+			CHECK(rohc_buf_data(payload.segs[1]) == rohc_buf_data(segs[1]));
+			CHECK(rohc_buf_data(payload.segs[2]) == rohc_buf_data(segs[2]));
+			CHECK(rohc_buf_chain_len(payload) == (sizeof(buf) - sizeof(hdrs)));
+			CHECK(rohc_pkt.len == (rohc_hdr.len + rohc_buf_chain_len(payload)));
+			CHECK(memcmp(rohc_buf_data(rohc_pkt), rohc_buf_data(rohc_hdr),
+			             rohc_hdr.len) == 0);
+			for(size_t i = 0; i < payload.segs_nr; i++)
+			{
+				CHECK(memcmp(rohc_buf_data_at(rohc_pkt, rohc_hdr.len + payload_len),
+				             rohc_buf_data(payload.segs[i]), payload.segs[i].len) == 0);
+				payload_len += payload.segs[i].len;
+			}
+		}
+
+		/* no payload in the first segment */
+		segs[0].len = sizeof(hdrs);
+		segs[1].offset = sizeof(hdrs);
+		segs[1].len = 100 - sizeof(hdrs);
+		rohc_buf_reset(&rohc_hdr);
+		CHECK(rohc_compress_chain(comp3, chain, &rohc_hdr, &payload) == ROHC_STATUS_OK);
+		CHECK(payload.segs_nr == 2);
+		CHECK(rohc_buf_chain_len(payload) == (sizeof(buf) - sizeof(hdrs)));
+
+		rohc_comp_free(comp2);
+		rohc_comp_free(comp3);
+	}
+
+	/* rohc_comp_prewarm_context() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf2[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x89,  0xc0, 0xa8, 0x13, 0x02,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt2 = rohc_buf_init_full(buf2, sizeof(buf2), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		rohc_comp_general_info_t general_info = {
+			.version_major = 0,
+			.version_minor = 0,
+		};
+		struct rohc_comp *comp2;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_prewarm_context(comp2, pkt, 5) == false);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_prewarm_context(NULL, pkt, 5) == false);
+		CHECK(rohc_comp_prewarm_context(comp2, pkt, ROHC_SMALL_CID_MAX + 1) == false);
+		CHECK(rohc_comp_prewarm_context(comp2, pkt, 5) == true);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.contexts_nr == 1);
+		/* the flow already has one context */
+		CHECK(rohc_comp_prewarm_context(comp2, pkt, 6) == false);
+		/* the CID is already in use */
+		CHECK(rohc_comp_prewarm_context(comp2, pkt2, 5) == false);
+
+		/* the first packet of the flow is an IR packet on the given CID */
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_pkt.len > 2);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) == 0xe5);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 1) == 0xfd);
+		CHECK(rohc_comp_get_general_info(comp2, &general_info) == true);
+		CHECK(general_info.contexts_nr == 1);
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_invalidate_contexts() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf2[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x89,  0xc0, 0xa8, 0x13, 0x02,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt2 = rohc_buf_init_full(buf2, sizeof(buf2), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		struct rohc_comp_ctxt_filter filter = {
+			.ip_version = 4,
+			.prefix_len = 32,
+			.addr = { 0xc0, 0xa8, 0x13, 0x01 },
+			.has_port = false,
+			.port = 0,
+			.has_profile = false,
+			.profile_id = ROHCv2_PROFILE_IP,
+		};
+		struct rohc_comp *comp2;
+		size_t ctxts_nr;
+		size_t i;
+
+		comp2 = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_comp_invalidate_contexts(NULL, &filter, &ctxts_nr) == false);
+		CHECK(rohc_comp_invalidate_contexts(comp2, NULL, &ctxts_nr) == false);
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, NULL) == false);
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 0);
+
+		/* two flows that leave the IR state */
+		for(i = 0; i < 20; i++)
+		{
+			rohc_buf_reset(&rohc_pkt);
+			CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			rohc_buf_reset(&rohc_pkt);
+			CHECK(rohc_compress4(comp2, pkt2, &rohc_pkt) == ROHC_STATUS_OK);
+		}
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) != 0xfd);
+
+		/* malformed filters */
+		filter.ip_version = 5;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == false);
+		filter.ip_version = 4;
+		filter.prefix_len = 33;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == false);
+
+		/* one source address, one common destination address */
+		filter.prefix_len = 32;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 1);
+		rohc_buf_reset(&rohc_pkt);
+		CHECK(rohc_compress4(comp2, pkt2, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) != 0xfd);
+		rohc_buf_reset(&rohc_pkt);
+		CHECK(rohc_compress4(comp2, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte_at(rohc_pkt, 0) == 0xfd);
+		filter.addr[3] = 0x05;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 2);
+
+		/* prefixes found through the index or through all the contexts */
+		filter.prefix_len = 24;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 2);
+		filter.prefix_len = 31;
+		filter.addr[3] = 0x02;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 1);
+		filter.prefix_len = 16;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 2);
+		filter.prefix_len = 0;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 2);
+		filter.prefix_len = 8;
+		filter.addr[0] = 0x0a;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 0);
+		filter.ip_version = 6;
+		filter.prefix_len = 0;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 0);
+
+		/* the IP-only contexts have no port, their profile shall match */
+		filter.ip_version = 4;
+		filter.has_port = true;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 0);
+		filter.has_port = false;
+		filter.has_profile = true;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 2);
+		filter.profile_id = ROHCv1_PROFILE_IP;
+		CHECK(rohc_comp_invalidate_contexts(comp2, &filter, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 0);
+
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_get_state_descr() */
+	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_IR), "IR") == 0);
+	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_FO), "FO") == 0);
+	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_SO), "SO") == 0);
+	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_CR), "CR") == 0);
+	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_CR + 1), "no description") == 0);
+
+	/* rohc_comp_force_contexts_reinit() with some contexts init'ed */
+	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
+
+	/* rohc_comp_set_features */
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_COMPAT_1_6_x) == false);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_DUMP_PACKETS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIMER_BASED_TS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_IP_FRAGMENTS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
+
+	/* rohc_comp_deliver_feedback2() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 5, ts);
+
+		CHECK(rohc_comp_deliver_feedback2(NULL, pkt) == false);
+		pkt.len = 0; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
+		pkt.len = 1; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
+		pkt.len = 2; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
+		pkt.len = 3; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
+		pkt.len = 4; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == false);
+		pkt.len = 5; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
+	}
+
+	/* rohc_comp_deliver_feedback_burst() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] = { 0xf4, 0x20, 0x01, 0x11, 0x39,
+		                  0xf4, 0x20, 0x01, 0x11, 0x39 };
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 10, ts);
+
+		CHECK(rohc_comp_deliver_feedback_burst(NULL, pkt) == false);
+		pkt.len = 0; CHECK(rohc_comp_deliver_feedback_burst(comp, pkt) == true);
+		pkt.len = 1; CHECK(rohc_comp_deliver_feedback_burst(comp, pkt) == false);
+		pkt.len = 4; CHECK(rohc_comp_deliver_feedback_burst(comp, pkt) == false);
+		pkt.len = 5; CHECK(rohc_comp_deliver_feedback_burst(comp, pkt) == true);
+		pkt.len = 7; CHECK(rohc_comp_deliver_feedback_burst(comp, pkt) == false);
+		pkt.len = 10; CHECK(rohc_comp_deliver_feedback_burst(comp, pkt) == true);
+	}
+
+	/* rohc_comp_set_feedback_ring() and rohc_comp_drain_feedback_ring() */
+	{
+		struct rohc_feedback_ring *const ring = rohc_feedback_ring_new(16);
+		uint8_t buf[100];
+		struct rohc_buf feedback = rohc_buf_init_empty(buf, 100);
+
+		CHECK(ring != NULL);
+
+		CHECK(rohc_comp_drain_feedback_ring(comp, &feedback) == false);
+		CHECK(rohc_comp_set_feedback_ring(NULL, ring) == false);
+		CHECK(rohc_comp_set_feedback_ring(comp, ring) == true);
+		CHECK(rohc_comp_drain_feedback_ring(NULL, &feedback) == false);
+		CHECK(rohc_comp_drain_feedback_ring(comp, NULL) == true);
+		CHECK(rohc_comp_drain_feedback_ring(comp, &feedback) == true);
+		CHECK(feedback.len == 0);
+		CHECK(rohc_comp_set_feedback_ring(comp, NULL) == true);
+		CHECK(rohc_comp_drain_feedback_ring(comp, &feedback) == false);
+
+		rohc_feedback_ring_free(ring);
+	}
+
+	/* several functions with some packets already compressed */
+	{
+		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
+		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
+		CHECK(rohc_comp_set_trace_level(comp, ROHC_TRACE_ERROR) == false);
+
+		CHECK(rohc_comp_set_optimistic_approach(comp, 16) == false);
+
+		CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == false);
+	}
+
+	/* rohc_comp_set_ctxt_idle_timeout() and rohc_comp_expire() */
+	{
+		const struct rohc_ts ts1 = { .sec = 0, .nsec = 0 };
+		const struct rohc_ts ts2 = { .sec = 11, .nsec = 0 };
+		rohc_comp_general_info_t info;
+		size_t contexts_nr;
+
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		info.version_minor = 2;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		contexts_nr = info.contexts_nr;
+		CHECK(contexts_nr > 0);
+
+		CHECK(rohc_comp_expire(NULL, ts2) == false);
+		CHECK(rohc_comp_expire(comp, ts2) == true);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == contexts_nr);
+
+		CHECK(rohc_comp_set_ctxt_idle_timeout(NULL, 10000) == false);
+		CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 10000) == true);
+		CHECK(rohc_comp_expire(comp, ts1) == true);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == contexts_nr);
+		CHECK(info.contexts_expired_nr == 0);
+		CHECK(rohc_comp_expire(comp, ts2) == true);
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == 0);
+		CHECK(info.contexts_expired_nr == contexts_nr);
+	}
+
+	/* rohc_comp_free() */
 	rohc_comp_free(NULL);
 	rohc_comp_free(comp);
 
+	/* rohc_comp_new_cid_range() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] = { 0xf2, 0x05, 0x00,  0xf2, 0x0e, 0x00 };
+		const struct rohc_buf feedback1 = rohc_buf_init_full(buf, 3, ts);
+		struct rohc_buf feedback2 = rohc_buf_init_full(buf, 6, ts);
+		rohc_comp_general_info_t info;
+		rohc_cid_t cid_min;
+		rohc_cid_t cid_max;
+
+		CHECK(rohc_comp_new_cid_range(ROHC_LARGE_CID, 15, 9, 8, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_new_cid_range(ROHC_LARGE_CID, 15, 8, 16, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_new_cid_range(ROHC_LARGE_CID, 15, 8, 11, NULL, NULL) == NULL);
+		comp = rohc_comp_new_cid_range(ROHC_LARGE_CID, 15, 8, 11, random_cb, NULL);
+		CHECK(comp != NULL);
+
+		/* rohc_comp_get_cid_range() */
+		CHECK(rohc_comp_get_cid_range(NULL, &cid_min, &cid_max) == false);
+		CHECK(rohc_comp_get_cid_range(comp, NULL, &cid_max) == false);
+		CHECK(rohc_comp_get_cid_range(comp, &cid_min, NULL) == false);
+		CHECK(rohc_comp_get_cid_range(comp, &cid_min, &cid_max) == true);
+		CHECK(cid_min == 8);
+		CHECK(cid_max == 11);
+
+		/* feedback for CIDs of other compressors */
+		CHECK(rohc_comp_deliver_feedback2(comp, feedback1) == false);
+		rohc_buf_pull(&feedback2, 3);
+		CHECK(rohc_comp_deliver_feedback2(comp, feedback2) == false);
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		info.version_minor = 3;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.feedbacks_foreign_nr == 2);
+
+		rohc_comp_free(comp);
+
+		/* the default CID range is the whole CID space */
+		comp = rohc_comp_new2(ROHC_LARGE_CID, 15, random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_get_cid_range(comp, &cid_min, &cid_max) == true);
+		CHECK(cid_min == 0);
+		CHECK(cid_max == 15);
+		rohc_comp_free(comp);
+	}
+
+	/* rohc_comp_set_rtp_ports() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x2c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x11, 0x93, 0x6a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x04, 0xd2, 0x13, 0x8c,
+			0x00, 0x18, 0x00, 0x00,  0x80, 0x00, 0x00, 0x01,
+			0x00, 0x00, 0x00, 0xa0,  0x12, 0x34, 0x56, 0x78,
+			0xde, 0xad, 0xbe, 0xef
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t rohc_buffer[100];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+		uint8_t ports[ROHC_COMP_RTP_PORTS_LEN];
+		rohc_comp_last_packet_info2_t info;
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_UDP, ROHC_PROFILE_RTP,
+		                                -1) == true);
+		memset(ports, 0, ROHC_COMP_RTP_PORTS_LEN);
+		ports[5004 / 8] |= 1U << (5004 % 8);
+		CHECK(rohc_comp_set_rtp_ports(NULL, ports) == false);
+		CHECK(rohc_comp_set_rtp_ports(comp, NULL) == true);
+		CHECK(rohc_comp_set_rtp_ports(comp, ports) == true);
+		CHECK(rohc_comp_set_rtp_ports(comp, ports) == true);
+
+		/* the packet for UDP port 5004 is compressed with the RTP profile */
+		CHECK(rohc_compress4(comp, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+		CHECK(info.profile_id == ROHC_PROFILE_RTP);
+
+		/* rohc_comp_set_rtp_ts_stride() */
+		{
+			const size_t ir_len = rohc_pkt.len;
+
+			CHECK(rohc_comp_set_rtp_ts_stride(NULL, 0, 160) == false);
+			CHECK(rohc_comp_set_rtp_ts_stride(comp, ROHC_COMP_RTP_PT_NR, 160) == false);
+			CHECK(rohc_comp_set_rtp_ts_stride(comp, 0, 1U << 29) == false);
+			CHECK(rohc_comp_set_rtp_ts_stride(comp, 8, 0) == true);
+			CHECK(rohc_comp_set_rtp_ts_stride(comp, 0, 160) == true);
+
+			/* the IR packet of a new stream with Payload Type 0 transmits the
+			 * 2-byte SDVL-encoded TS_STRIDE too */
+			rohc_comp_free(comp);
+			comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+			CHECK(comp != NULL);
+			CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_RTP) == true);
+			CHECK(rohc_comp_set_rtp_ports(comp, ports) == true);
+			CHECK(rohc_comp_set_rtp_ts_stride(comp, 0, 160) == true);
+			rohc_buf_reset(&rohc_pkt);
+			CHECK(rohc_compress4(comp, pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK(rohc_pkt.len == ir_len + 2);
+		}
+
+		/* rohc_comp_set_ts_timer_jitter() */
+		CHECK(rohc_comp_set_ts_timer_jitter(NULL, 20) == false);
+		CHECK(rohc_comp_set_ts_timer_jitter(comp, 100001) == false);
+		CHECK(rohc_comp_set_ts_timer_jitter(comp, 0) == true);
+		CHECK(rohc_comp_set_ts_timer_jitter(comp, 100000) == true);
+		CHECK(rohc_comp_set_ts_timer_jitter(comp, 20) == true);
+
+		rohc_comp_free(comp);
+	}
+
+	/* rohc_comp_group_new() */
+	{
+		struct rohc_comp_group *group;
+
+		CHECK(rohc_comp_group_new(ROHC_LARGE_CID, 15, 0, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_group_new(ROHC_LARGE_CID, 15, 17, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_group_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1, 4,
+		                          random_cb, NULL) == NULL);
+		CHECK(rohc_comp_group_new(ROHC_LARGE_CID, 15, 4, NULL, NULL) == NULL);
+		group = rohc_comp_group_new(ROHC_LARGE_CID, 15, 16, random_cb, NULL);
+		CHECK(group != NULL);
+		rohc_comp_group_free(group);
+		group = rohc_comp_group_new(ROHC_LARGE_CID, 15, 4, random_cb, NULL);
+		CHECK(group != NULL);
+
+		/* rohc_comp_group_get_shards_nr() and rohc_comp_group_get_shard() */
+		CHECK(rohc_comp_group_get_shards_nr(NULL) == 0);
+		CHECK(rohc_comp_group_get_shards_nr(group) == 4);
+		CHECK(rohc_comp_group_get_shard(NULL, 0) == NULL);
+		CHECK(rohc_comp_group_get_shard(group, 4) == NULL);
+		for(size_t i = 0; i < 4; i++)
+		{
+			struct rohc_comp *const shard = rohc_comp_group_get_shard(group, i);
+			size_t max_cid;
+			CHECK(shard != NULL);
+			CHECK(rohc_comp_get_max_cid(shard, &max_cid) == true);
+			CHECK(max_cid == 15);
+		}
+
+		/* rohc_comp_group_steer() */
+		{
+			const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+			uint8_t buf[] =
+			{
+				0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+				0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+				0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+				0x9b, 0x42, 0x00, 0x01
+			};
+			const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+			uint8_t rohc_buffer[100];
+			struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_buffer, 100);
+			rohc_comp_last_packet_info2_t info;
+			size_t shard_idx;
+			size_t shard_idx2;
+
+			/* no profile enabled yet */
+			CHECK(rohc_comp_group_steer(group, pkt, &shard_idx) == false);
+
+			for(size_t i = 0; i < 4; i++)
+			{
+				CHECK(rohc_comp_enable_profile(rohc_comp_group_get_shard(group, i),
+				                               ROHC_PROFILE_IP) == true);
+			}
+			CHECK(rohc_comp_group_steer(NULL, pkt, &shard_idx) == false);
+			CHECK(rohc_comp_group_steer(group, pkt, NULL) == false);
+			CHECK(rohc_comp_group_steer(group, pkt, &shard_idx) == true);
+			CHECK(shard_idx < 4);
+			CHECK(rohc_comp_group_steer(group, pkt, &shard_idx2) == true);
+			CHECK(shard_idx2 == shard_idx);
+
+			/* the context of the shard uses one CID of the shard */
+			CHECK(rohc_compress4(rohc_comp_group_get_shard(group, shard_idx),
+			                     pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			CHECK(rohc_comp_get_last_packet_info2(rohc_comp_group_get_shard(group, shard_idx),
+			                                      &info) == true);
+			CHECK(info.context_id == shard_idx * 4);
+		}
+
+		/* rohc_comp_group_route_feedback() */
+		{
+			const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+			uint8_t buf[] = { 0xf2, 0x00, 0x00,  0xf2, 0x0d, 0x00,  0xf4, 0x07 };
+			struct rohc_buf feedback = rohc_buf_init_full(buf, sizeof(buf), ts);
+			struct rohc_buf feedback_item;
+			size_t shard_idx;
+
+			CHECK(rohc_comp_group_route_feedback(NULL, &feedback, &feedback_item,
+			                                     &shard_idx) == false);
+			CHECK(rohc_comp_group_route_feedback(group, NULL, &feedback_item,
+			                                     &shard_idx) == false);
+			CHECK(rohc_comp_group_route_feedback(group, &feedback, NULL,
+			                                     &shard_idx) == false);
+			CHECK(rohc_comp_group_route_feedback(group, &feedback, &feedback_item,
+			                                     NULL) == false);
+			CHECK(rohc_comp_group_route_feedback(group, &feedback, &feedback_item,
+			                                     &shard_idx) == true);
+			CHECK(shard_idx == 0);
+			CHECK(feedback_item.len == 3);
+			CHECK(rohc_buf_data(feedback_item) == buf);
+			CHECK(feedback.len == 5);
+			CHECK(rohc_comp_group_route_feedback(group, &feedback, &feedback_item,
+			                                     &shard_idx) == true);
+			CHECK(shard_idx == 3);
+			CHECK(feedback_item.len == 3);
+			CHECK(feedback.len == 2);
+			/* truncated feedback item */
+			CHECK(rohc_comp_group_route_feedback(group, &feedback, &feedback_item,
+			                                     &shard_idx) == false);
+			CHECK(feedback.len == 2);
+			/* not a feedback item */
+			buf[6] = 0x00;
+			CHECK(rohc_comp_group_route_feedback(group, &feedback, &feedback_item,
+			                                     &shard_idx) == false);
+		}
+
+		/* rohc_comp_group_free() */
+		rohc_comp_group_free(NULL);
+		rohc_comp_group_free(group);
+	}
+
+	/* rohc_comp_queue_new() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		uint8_t out[5][100];
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		struct rohc_buf rohc_pkts[5];
+		struct rohc_comp_queue *queue;
+		struct rohc_comp_sqe sqe;
+		struct rohc_comp_cqe cqes[5];
+
+		comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+
+		CHECK(rohc_comp_queue_new(NULL, 4) == NULL);
+		CHECK(rohc_comp_queue_new(comp, 0) == NULL);
+		CHECK(rohc_comp_queue_new(comp, 3) == NULL);
+		CHECK(rohc_comp_queue_new(comp, 131072) == NULL);
+		queue = rohc_comp_queue_new(comp, 65536);
+		CHECK(queue != NULL);
+		rohc_comp_queue_free(queue);
+		queue = rohc_comp_queue_new(comp, 4);
+		CHECK(queue != NULL);
+
+		/* rohc_comp_queue_submit() */
+		for(size_t i = 0; i < 5; i++)
+		{
+			const struct rohc_buf rohc_pkt = rohc_buf_init_empty(out[i], 100);
+			rohc_pkts[i] = rohc_pkt;
+		}
+		sqe.uncomp_pkt = pkt;
+		CHECK(rohc_comp_queue_submit(NULL, &sqe) == false);
+		CHECK(rohc_comp_queue_submit(queue, NULL) == false);
+		for(size_t i = 0; i < 4; i++)
+		{
+			sqe.rohc_pkt = rohc_pkts[i];
+			sqe.tag = 100 + i;
+			CHECK(rohc_comp_queue_submit(queue, &sqe) == true);
+		}
+		/* the queue is full */
+		sqe.rohc_pkt = rohc_pkts[4];
+		sqe.tag = 104;
+		CHECK(rohc_comp_queue_submit(queue, &sqe) == false);
+
+		/* rohc_comp_queue_reap() before compression */
+		CHECK(rohc_comp_queue_reap(queue, cqes, 5) == 0);
+
+		/* rohc_comp_queue_run() */
+		CHECK(rohc_comp_queue_run(NULL) == 0);
+		CHECK(rohc_comp_queue_run(queue) == 4);
+		CHECK(rohc_comp_queue_run(queue) == 0);
+
+		/* the completion ring is full, the submission ring is not */
+		CHECK(rohc_comp_queue_submit(queue, &sqe) == true);
+		CHECK(rohc_comp_queue_run(queue) == 0);
+
+		/* rohc_comp_queue_reap() */
+		CHECK(rohc_comp_queue_reap(NULL, cqes, 5) == 0);
+		CHECK(rohc_comp_queue_reap(queue, NULL, 5) == 0);
+		CHECK(rohc_comp_queue_reap(queue, cqes, 0) == 0);
+		CHECK(rohc_comp_queue_reap(queue, cqes, 3) == 3);
+		CHECK(rohc_comp_queue_reap(queue, cqes + 3, 5) == 1);
+		for(size_t i = 0; i < 4; i++)
+		{
+			CHECK(cqes[i].tag == 100 + i);
+			CHECK(cqes[i].status == ROHC_STATUS_OK);
+			CHECK(cqes[i].len > 0);
+		}
+		/* the first packet is an IR packet */
+		CHECK(out[0][0] == 0xfd);
+
+		/* the last packet is compressed once the completions were reaped */
+		CHECK(rohc_comp_queue_run(queue) == 1);
+		CHECK(rohc_comp_queue_reap(queue, cqes, 5) == 1);
+		CHECK(cqes[0].tag == 104);
+		CHECK(cqes[0].status == ROHC_STATUS_OK);
+
+		/* a packet that cannot be compressed */
+		sqe.uncomp_pkt.len = 0;
+		CHECK(rohc_comp_queue_submit(queue, &sqe) == true);
+		CHECK(rohc_comp_queue_run(queue) == 1);
+		CHECK(rohc_comp_queue_reap(queue, cqes, 5) == 1);
+		CHECK(cqes[0].tag == 104);
+		CHECK(cqes[0].status == ROHC_STATUS_ERROR);
+		CHECK(cqes[0].len == 0);
+
+		/* rohc_comp_queue_submit_burst() */
+		{
+			struct rohc_comp_sqe sqes[5];
+
+			for(size_t i = 0; i < 5; i++)
+			{
+				sqes[i].uncomp_pkt = pkt;
+				sqes[i].rohc_pkt = rohc_pkts[i];
+				sqes[i].tag = 200 + i;
+			}
+			CHECK(rohc_comp_queue_submit_burst(NULL, sqes, 5) == 0);
+			CHECK(rohc_comp_queue_submit_burst(queue, NULL, 5) == 0);
+			CHECK(rohc_comp_queue_submit_burst(queue, sqes, 0) == 0);
+			CHECK(rohc_comp_queue_submit_burst(queue, sqes, 2) == 2);
+			/* the queue is full after 2 more packets */
+			CHECK(rohc_comp_queue_submit_burst(queue, sqes + 2, 3) == 2);
+			CHECK(rohc_comp_queue_submit_burst(queue, sqes + 4, 1) == 0);
+			CHECK(rohc_comp_queue_run(queue) == 4);
+			CHECK(rohc_comp_queue_submit_burst(queue, sqes + 4, 1) == 1);
+			CHECK(rohc_comp_queue_reap(queue, cqes, 5) == 4);
+			CHECK(rohc_comp_queue_run(queue) == 1);
+			CHECK(rohc_comp_queue_reap(queue, cqes + 4, 1) == 1);
+			for(size_t i = 0; i < 5; i++)
+			{
+				CHECK(cqes[i].tag == 200 + i);
+				CHECK(cqes[i].status == ROHC_STATUS_OK);
+			}
+		}
+
+		/* rohc_comp_queue_free() */
+		rohc_comp_queue_free(NULL);
+		rohc_comp_queue_free(queue);
+		rohc_comp_free(comp);
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -453,3 +3129,118 @@ static int random_cb(const struct rohc_comp *const comp __attribute__((unused)),
 	return 0; /* fake */
 }
 
+
+/**
+ * @brief Memory allocation callback: use the system allocator
+ *
+ * @param size       The number of bytes to allocate
+ * @param priv_ctxt  Private data
+ * @return           The allocated memory, NULL if allocation failed
+ */
+static void * mem_alloc_cb(const size_t size,
+                           void *const priv_ctxt __attribute__((unused)))
+{
+	return malloc(size);
+}
+
+
+/**
+ * @brief Memory release callback: use the system allocator
+ *
+ * @param ptr        The memory to release
+ * @param size       The number of bytes to release
+ * @param priv_ctxt  Private data
+ */
+static void mem_free_cb(void *const ptr,
+                        const size_t size __attribute__((unused)),
+                        void *const priv_ctxt __attribute__((unused)))
+{
+	free(ptr);
+}
+
+
+/**
+ * @brief Context event callback: count the events per type
+ *
+ * @param comp       The ROHC compressor
+ * @param event      The event of the compression context
+ * @param priv_ctxt  The numbers of events per type
+ */
+static void ctxt_event_cb(const struct rohc_comp *const comp __attribute__((unused)),
+                          const struct rohc_comp_ctxt_event *const event,
+                          void *const priv_ctxt)
+{
+	size_t *const events_nr = priv_ctxt;
+
+	assert(event->type <= ROHC_COMP_CTXT_EVENT_MODE);
+	assert(event->cid == 0);
+	assert(event->profile_id == ROHCv1_PROFILE_IP);
+	if(event->type == ROHC_COMP_CTXT_EVENT_STATE)
+	{
+		assert(event->old_state != event->state);
+	}
+	events_nr[event->type]++;
+}
+
+
+/**
+ * @brief Fake hash callback: count calls and make all the flows collide
+ *
+ * @param data       The fingerprint of the flow to hash
+ * @param len        The length of the fingerprint of the flow
+ * @param key        The random secret of the table of contexts
+ * @param priv_ctxt  The number of calls
+ * @return           Always 42
+ */
+static uint64_t hash_cb(const uint8_t *const data __attribute__((unused)),
+                        const size_t len __attribute__((unused)),
+                        const uint8_t key[16] __attribute__((unused)),
+                        void *const priv_ctxt)
+{
+	size_t *const hash_calls_nr = priv_ctxt;
+	(*hash_calls_nr)++;
+	return 42;
+}
+
+
+/**
+ * @brief Eviction callback: count the calls, recycle the second candidate
+ *
+ * @param candidates     The records of the candidate contexts
+ * @param candidates_nr  The number of candidate contexts
+ * @param profile_id     The profile of the new context
+ * @param priv_ctxt      The number of calls
+ * @return               Always 1
+ */
+static size_t evict_cb(const struct rohc_comp_ctxt_record candidates[] __attribute__((unused)),
+                       const size_t candidates_nr __attribute__((unused)),
+                       const rohc_profile_t profile_id __attribute__((unused)),
+                       void *const priv_ctxt)
+{
+	size_t *const evict_calls_nr = priv_ctxt;
+	(*evict_calls_nr)++;
+	return 1;
+}
+
+
+/**
+ * @brief CRC callback: count the calls and return a wrong CRC
+ *
+ * @param crc_bits   The size of the CRC
+ * @param data       The data to compute the CRC over
+ * @param len        The length of the data
+ * @param init_val   The initial value of the CRC
+ * @param priv_ctxt  The number of calls
+ * @return           The complemented initial value
+ */
+static uint8_t crc_calc_cb(const size_t crc_bits,
+                           const uint8_t *const data __attribute__((unused)),
+                           const size_t len __attribute__((unused)),
+                           const uint8_t init_val,
+                           void *const priv_ctxt)
+{
+	size_t *const crc_calls_nr = priv_ctxt;
+
+	(*crc_calls_nr)++;
+	return (~init_val) & ((1U << crc_bits) - 1);
+}
@@ -64,10 +64,6 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 static int esp_parse_static_esp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
                                 size_t length,
@@ -115,39 +111,19 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
-	struct d_esp_context *esp_context;
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = *persist_ctxt;
 
 	assert(context->decompressor != NULL);
 	assert(context->profile != NULL);
 
-	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
-	                               context->decompressor->trace_callback,
-	                               context->decompressor->trace_callback_priv,
-	                               context->profile->id))
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "failed to create the generic decompression context");
-		goto quit;
-	}
-	rfc3095_ctxt = *persist_ctxt;
-
-	/* create the ESP-specific part of the context */
-	esp_context = calloc(1, sizeof(struct d_esp_context));
-	if(esp_context == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the ESP-specific context");
-		goto destroy_context;
-	}
-	rfc3095_ctxt->specific = esp_context;
+	/* create the generic context and the ESP-specific part of the context */
+	rohc_decomp_rfc3095_create(context, rfc3095_ctxt, volat_ctxt,
+	                           sizeof(struct d_esp_context), sizeof(struct esphdr));
 
 	/* create the LSB decoding context for SN (same shift value as RTP) */
 	rohc_lsb_init(&rfc3095_ctxt->sn_lsb_ctxt, 32);
 
 	/* some ESP-specific values and functions */
-	rfc3095_ctxt->next_header_len = sizeof(struct esphdr);
 	rfc3095_ctxt->parse_static_next_hdr = esp_parse_static_esp;
 	rfc3095_ctxt->parse_dyn_next_hdr = esp_parse_dynamic_esp;
 	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
@@ -158,63 +134,10 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_dynamic = esp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = esp_update_context;
 
-	/* create the ESP-specific part of the header changes */
-	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = calloc(1, sizeof(struct esphdr));
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the ESP-specific part of the "
-		           "outer IP header changes");
-		goto free_esp_context;
-	}
-
-	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = calloc(1, sizeof(struct esphdr));
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the ESP-specific part of the "
-		           "inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-
 	/* set next header to ESP */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_ESP;
 
 	return true;
-
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_esp_context:
-	zfree(esp_context);
-destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
-quit:
-	return false;
-}
-
-
-/**
- * @brief Destroy the context
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
- */
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	/* clean ESP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-
-	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -413,14 +336,20 @@ const struct rohc_decomp_profile d_esp_profile =
 {
 	.id              = ROHC_PROFILE_ESP, /* profile ID (RFC 3095, §8) */
 	.msn_max_bits    = 32,
+	.persist_ctxt_len   = ROHC_DECOMP_RFC3095_CTXT_LEN(sizeof(struct d_esp_context),
+	                                                   sizeof(struct esphdr)),
+	.extr_bits_len      = sizeof(struct rohc_extr_bits),
+	.decoded_values_len = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_esp_create,
-	.free_context    = (rohc_decomp_free_context_t) d_esp_destroy,
+	.free_context    = rohc_decomp_rfc3095_free,
 	.detect_pkt_type = ip_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) rfc3095_decomp_build_hdrs,
+	.decode_fast     = (rohc_decomp_decode_fast_t) rfc3095_decomp_decode_fast,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.get_decoded_sn  = (rohc_decomp_get_decoded_sn_t) rohc_decomp_rfc3095_get_decoded_sn,
 };
 
@@ -45,10 +45,6 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                         const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 
 /**
  * @brief Create the IP decompression context.
@@ -66,23 +62,13 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = *persist_ctxt;
 
 	assert(context->decompressor != NULL);
 	assert(context->profile != NULL);
 
-	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
-	                               context->decompressor->trace_callback,
-	                               context->decompressor->trace_callback_priv,
-	                               context->profile->id))
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "failed to create the generic decompression context");
-		goto quit;
-	}
-	rfc3095_ctxt = *persist_ctxt;
-	rfc3095_ctxt->specific = NULL;
+	/* create the generic context, no profile-specific part nor next header */
+	rohc_decomp_rfc3095_create(context, rfc3095_ctxt, volat_ctxt, 0, 0);
 
 	/* create the LSB decoding context for SN */
 	rohc_lsb_init(&rfc3095_ctxt->sn_lsb_ctxt, 16);
@@ -92,25 +78,6 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
 
 	return true;
-
-quit:
-	return false;
-}
-
-
-/**
- * @brief Destroy the given IP-only context
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
- */
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                         const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -137,37 +104,11 @@ rohc_packet_t ip_detect_packet_type(const struct rohc_decomp_ctxt *const context
 	rohc_decomp_debug(context, "try to determine the header from first byte "
 	                  "0x%02x", rohc_packet[0]);
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
-	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
-	{
-		/* UO-1 packet */
-		type = ROHC_PACKET_UO_1;
-	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
-	{
-		/* UOR-2 packet */
-		type = ROHC_PACKET_UOR_2;
-	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
-	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
-	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
-	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
-	}
-	else
+	type = rohc_decomp_rfc3095_pkt_types[rohc_packet[0]];
+	if(type == ROHC_PACKET_UNKNOWN)
 	{
-		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
 		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
 	}
 
 	return type;
@@ -521,14 +462,19 @@ const struct rohc_decomp_profile d_ip_profile =
 {
 	.id              = ROHC_PROFILE_IP, /* profile ID (see 5 in RFC 3843) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_len   = ROHC_DECOMP_RFC3095_CTXT_LEN(0, 0),
+	.extr_bits_len      = sizeof(struct rohc_extr_bits),
+	.decoded_values_len = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_ip_create,
-	.free_context    = (rohc_decomp_free_context_t) d_ip_destroy,
+	.free_context    = rohc_decomp_rfc3095_free,
 	.detect_pkt_type = ip_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) rfc3095_decomp_build_hdrs,
+	.decode_fast     = (rohc_decomp_decode_fast_t) rfc3095_decomp_decode_fast,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.get_decoded_sn  = (rohc_decomp_get_decoded_sn_t) rohc_decomp_rfc3095_get_decoded_sn,
 };
 
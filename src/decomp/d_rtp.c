@@ -35,6 +35,7 @@
 #include "rohc_utils.h"
 #include "sdvl.h"
 #include "crc.h"
+#include "rohc_time_internal.h"
 #include "schemes/decomp_scaled_rtp_ts.h"
 #include "rohc_decomp_detect_packet.h"
 #include "protocols/udp.h"
@@ -72,26 +73,14 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
                                             const size_t large_cid_len)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static rohc_packet_t rtp_choose_uo1_variant(const struct rohc_decomp_ctxt *const context,
-                                            const uint8_t *const packet,
-                                            const size_t rohc_length)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
-
-static rohc_packet_t rtp_choose_uor2_variant(const struct rohc_decomp_ctxt *const context,
-                                             const uint8_t *const packet,
-                                             const size_t rohc_length,
-                                             const size_t large_cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rtp_has_ipv4_non_rnd_ctxt(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 
 static int rtp_parse_static_rtp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
@@ -158,6 +147,58 @@ static inline bool is_inner_ipv4_rnd_ctxt(const struct rohc_decomp_rfc3095_ctxt
 	__attribute__((warn_unused_result, nonnull(1)));
 
 
+/*
+ * Packet detection tables
+ */
+
+/**
+ * @brief The RTP packet types indexed by the disambiguation state and the
+ *        first byte of the packet
+ *
+ * There is no easy way to disambiguate UO-1-ID/TS and UO-1-RTP packets,
+ * nor UOR-2-ID/TS and UOR-2-RTP packets. RFC 3095, sections 5.7.3 and 5.7.4
+ * tell that:
+ *  - *-RTP packets cannot be used if the context contains at least one
+ *    IPv4 header with value(RND) = 0,
+ *  - *-ID and *-TS packets cannot be used if there is no IPv4 header in the
+ *    context or if value(RND) and value(RND2) are both 1.
+ *
+ * The first index is thus whether the context contains at least one IPv4
+ * header with context(RND) = 0. The T bit of UO-1-ID/TS packets is in the
+ * first byte, but the one of UOR-2-ID/TS packets is in the second byte: the
+ * UOR-2-ID entry stands for both UOR-2-ID and UOR-2-TS packets.
+ *
+ * The UOR-2 packet type is only a first guess: the packet is reparsed as
+ * UOR-2-RTP or UOR-2-ID/TS later if the RND flags in packet contradict it.
+ */
+static const uint8_t rtp_pkt_types[2][256] =
+{
+	/* no IPv4 header with context(RND) = 0: *-RTP packets */
+	[false] = {
+		[0x00 ... 0x7f] = ROHC_PACKET_UO_0,       /* 0xxxxxxx */
+		[0x80 ... 0xbf] = ROHC_PACKET_UO_1_RTP,   /* 10xxxxxx */
+		[0xc0 ... 0xdf] = ROHC_PACKET_UOR_2_RTP,  /* 110xxxxx */
+		[0xe0 ... 0xf7] = ROHC_PACKET_UNKNOWN,
+		[0xf8]          = ROHC_PACKET_IR_DYN,     /* 11111000 */
+		[0xf9 ... 0xfb] = ROHC_PACKET_UNKNOWN,
+		[0xfc ... 0xfd] = ROHC_PACKET_IR,         /* 1111110x */
+		[0xfe ... 0xff] = ROHC_PACKET_UNKNOWN,
+	},
+	/* at least one IPv4 header with context(RND) = 0: *-ID/TS packets */
+	[true] = {
+		[0x00 ... 0x7f] = ROHC_PACKET_UO_0,       /* 0xxxxxxx */
+		[0x80 ... 0x9f] = ROHC_PACKET_UO_1_ID,    /* 100xxxxx (T = 0) */
+		[0xa0 ... 0xbf] = ROHC_PACKET_UO_1_TS,    /* 101xxxxx (T = 1) */
+		[0xc0 ... 0xdf] = ROHC_PACKET_UOR_2_ID,   /* 110xxxxx (T in 2nd byte) */
+		[0xe0 ... 0xf7] = ROHC_PACKET_UNKNOWN,
+		[0xf8]          = ROHC_PACKET_IR_DYN,     /* 11111000 */
+		[0xf9 ... 0xfb] = ROHC_PACKET_UNKNOWN,
+		[0xfc ... 0xfd] = ROHC_PACKET_IR,         /* 1111110x */
+		[0xfe ... 0xff] = ROHC_PACKET_UNKNOWN,
+	},
+};
+
+
 /*
  * Definitions of functions
  */
@@ -178,34 +219,17 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = *persist_ctxt;
 	struct d_rtp_context *rtp_context;
 	const size_t nh_len = sizeof(struct udphdr) + sizeof(struct rtphdr);
 
 	assert(context->decompressor != NULL);
 	assert(context->profile != NULL);
 
-	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
-	                               context->decompressor->trace_callback,
-	                               context->decompressor->trace_callback_priv,
-	                               context->profile->id))
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "failed to create the generic decompression context");
-		goto quit;
-	}
-	rfc3095_ctxt = *persist_ctxt;
-
-	/* create the RTP-specific part of the context */
-	rtp_context = calloc(1, sizeof(struct d_rtp_context));
-	if(rtp_context == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the RTP-specific context");
-		goto destroy_context;
-	}
-	rfc3095_ctxt->specific = rtp_context;
+	/* create the generic context and the RTP-specific part of the context */
+	rohc_decomp_rfc3095_create(context, rfc3095_ctxt, volat_ctxt,
+	                           sizeof(struct d_rtp_context), nh_len);
+	rtp_context = rfc3095_ctxt->specific;
 
 	/* create the LSB decoding context for SN */
 	rohc_lsb_init(&rfc3095_ctxt->sn_lsb_ctxt, 16);
@@ -215,7 +239,6 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	rtp_context->udp_check_present = ROHC_TRISTATE_NONE;
 
 	/* some RTP-specific values and functions */
-	rfc3095_ctxt->next_header_len = nh_len;
 	rfc3095_ctxt->parse_static_next_hdr = rtp_parse_static_rtp;
 	rfc3095_ctxt->parse_dyn_next_hdr = rtp_parse_dynamic_rtp;
 	rfc3095_ctxt->parse_ext3 = rtp_parse_ext3;
@@ -226,67 +249,15 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_dynamic = rtp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = rtp_update_context;
 
-	/* create the UDP-specific part of the header changes */
-	rfc3095_ctxt->outer_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->outer_ip_changes->next_header = calloc(1, nh_len);
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the RTP-specific part of the "
-		           "outer IP header changes");
-		goto free_rtp_context;
-	}
-
-	rfc3095_ctxt->inner_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->inner_ip_changes->next_header = calloc(1, nh_len);
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the RTP-specific part of the "
-		           "inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-
 	/* set next header to UDP */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_UDP;
 
 	/* create the scaled RTP Timestamp decoding context */
 	d_init_sc(&rtp_context->ts_scaled_ctxt, context->decompressor->trace_callback,
-	          context->decompressor->trace_callback_priv);
+	          context->decompressor->trace_callback_priv,
+	          context->decompressor->trace_level);
 
 	return true;
-
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_rtp_context:
-	zfree(rtp_context);
-destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
-quit:
-	return false;
-}
-
-
-/**
- * @brief Destroy the given RTP context
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
- */
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	/* clean UDP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-
-	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -304,6 +275,7 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
                                             const size_t rohc_length,
                                             const size_t large_cid_len)
 {
+	const bool has_ipv4_non_rnd = rtp_has_ipv4_non_rnd_ctxt(context->persist_ctxt);
 	rohc_packet_t type;
 
 	/* at least one byte required to check discriminator byte in packet
@@ -313,38 +285,17 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
 	rohc_decomp_debug(context, "try to determine the header from first byte "
 	                  "0x%02x", rohc_packet[0]);
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
-	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
-	{
-		/* choose between the UO-1-RTP, UO-1-ID, and UO-1-TS variants */
-		type = rtp_choose_uo1_variant(context, rohc_packet, rohc_length);
-	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
-	{
-		/* choose between the UOR-2-RTP, UOR-2-ID, and UOR-2-TS variants */
-		type = rtp_choose_uor2_variant(context, rohc_packet, rohc_length,
-		                               large_cid_len);
-	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
+	type = rtp_pkt_types[has_ipv4_non_rnd][rohc_packet[0]];
+	if(type == ROHC_PACKET_UOR_2_ID &&
+	   rohc_decomp_packet_is_uor2_ts(rohc_packet, rohc_length, large_cid_len))
 	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
+		/* UOR-2-TS packet: T = 1 in the second byte */
+		type = ROHC_PACKET_UOR_2_TS;
 	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
+	else if(type == ROHC_PACKET_UNKNOWN)
 	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
-	}
-	else
-	{
-		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
 		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
 	}
 
 	return type;
@@ -352,210 +303,21 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
 
 
 /**
- * @brief Choose between UO-1-RTP, UO-1-TS, and UO-1-ID variants
+ * @brief Does the context contain at least one IPv4 header with RND = 0?
  *
- * This function is useful to choose which packet type to try to parse in the
- * UO-1* families.
+ * This is the disambiguation state between the *-RTP and the *-ID/TS
+ * variants of the UO-1* and UOR-2* packets.
  *
- * @param context        The decompression context
- * @param packet         The ROHC packet
- * @param rohc_length    The length of the ROHC packet
- * @return               The packet type
+ * @param rfc3095_ctxt  The generic decompression context
+ * @return              true if at least one IPv4 header has context(RND) = 0,
+ *                      false otherwise
  */
-static rohc_packet_t rtp_choose_uo1_variant(const struct rohc_decomp_ctxt *const context,
-                                            const uint8_t *const packet,
-                                            const size_t rohc_length)
+static bool rtp_has_ipv4_non_rnd_ctxt(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
-	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	rohc_packet_t type;
-	size_t nr_ipv4_non_rnd;
-	size_t nr_ipv4;
-
-	/* compute the number of IPv4 headers, and IPv4 with context(RND) = 0 */
-	nr_ipv4 = 0;
-	nr_ipv4_non_rnd = 0;
-	if(is_outer_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_outer_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-	if(is_inner_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_inner_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-
-	/* There is no easy way to disambiguate UO-1-ID/TS and UO-1-RTP
-	 * packets. The following algorithm is based on notes you may
-	 * read in RFC 3095, section 5.7.3:
-	 *  - UO-1-RTP cannot be used if the context contains at least one
-	 *    IPv4 header with value(RND) = 0. This disambiguates it from
-	 *    UO-1-ID and UO-1-TS.
-	 *  - UO-1-ID cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - UO-1-TS cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - T: T = 0 indicates format UO-1-ID;
-	 *       T = 1 indicates format UO-1-TS.
-	 */
-	if(nr_ipv4 == 0)
-	{
-		/* no IPv4 header at all, so only UO-1-RTP packet can be used */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: no IPv4 "
-		                  "header at all, so parse as UO-1-RTP");
-		type = ROHC_PACKET_UO_1_RTP;
-	}
-	else if(nr_ipv4_non_rnd == 0)
-	{
-		/* there is no IPv4 header with context(RND) = 0, and UO-1* packets
-		 * have either no value(RND) or value(RND) = context(RND) if they have
-		 * one. So only UO-1-RTP packet can be used */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: no IPv4 "
-		                  "header with context(RND) = 0, so parse as "
-		                  "UO-1-RTP");
-		type = ROHC_PACKET_UO_1_RTP;
-	}
-	else
-	{
-		/* there is at least one IPv4 header with context(RND) = 0, and UO-1*
-		 * packets have either no value(RND) or value(RND) = context(RND) if
-		 * they have one. So only UO-1-TS/ID are possible */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: at least one "
-		                  "IP header is IPv4 with context(RND) = 0, so parse "
-		                  "as UO-1-ID or UO-1-TS");
-
-		/* UO-1-ID or UO-1-TS packet, check the T field */
-		if(rohc_decomp_packet_is_uo1_ts(packet, rohc_length))
-		{
-			/* UO-1-TS packet */
-			rohc_decomp_debug(context, "UO-1* packet disambiguation: T = 1, "
-			                  "so parse as UO-1-TS");
-			type = ROHC_PACKET_UO_1_TS;
-		}
-		else
-		{
-			/* UO-1-ID packet */
-			rohc_decomp_debug(context, "UO-1* packet disambiguation: T = 0, "
-			                  "so parse as UO-1-ID");
-			type = ROHC_PACKET_UO_1_ID;
-		}
-	}
-
-	return type;
-}
-
-
-/**
- * @brief Choose between UOR-2-RTP, UOR-2-TS, and UOR-2-ID variants
- *
- * This function is useful to choose which packet type to try to decode (may
- * change later, causing a packet reparse) in the UOR-2* family.
- *
- * @param context        The decompression context
- * @param packet         The ROHC packet
- * @param rohc_length    The length of the ROHC packet
- * @param large_cid_len  The length of the optional large CID field
- * @return               The packet type
- */
-static rohc_packet_t rtp_choose_uor2_variant(const struct rohc_decomp_ctxt *const context,
-                                             const uint8_t *const packet,
-                                             const size_t rohc_length,
-                                             const size_t large_cid_len)
-{
-	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	rohc_packet_t type;
-	size_t nr_ipv4_non_rnd;
-	size_t nr_ipv4;
-
-	/* compute the number of IPv4 headers, and IPv4 with context(RND) = 0 */
-	nr_ipv4 = 0;
-	nr_ipv4_non_rnd = 0;
-	if(is_outer_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_outer_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-	if(is_inner_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_inner_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-
-	/* There is no easy way to disambiguate UOR-2-ID/TS and UOR-2-RTP
-	 * packets. The following algorithm is based on notes you may
-	 * read in RFC 3095, section 5.7.4:
-	 *  - UOR-2-RTP cannot be used if the context contains at least one
-	 *    IPv4 header with value(RND) = 0. This disambiguates it from
-	 *    UOR-2-ID and UOR-2-TS.
-	 *  - UOR-2-ID cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - UOR-2-TS cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - T: T = 0 indicates format UOR-2-ID;
-	 *       T = 1 indicates format UOR-2-TS.
-	 */
-	if(nr_ipv4 == 0)
-	{
-		/* no IPv4 header at all, so only *-RTP packet can be used */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: no IPv4 "
-		                  "header at all, so parse as UOR-2-RTP");
-		type = ROHC_PACKET_UOR_2_RTP;
-	}
-	else if(nr_ipv4_non_rnd == 0)
-	{
-		/* there is no IPv4 header with context(RND) = 0, but maybe there is a
-		 * IPv4 header with value(RND) = 0 (the ROHC packet may contain a RND
-		 * field and update context). So try parsing UOR-2-RTP, and fallback
-		 * on UOR-2-TS/ID if value(RND) = 0 is found. */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: no IPv4 "
-		                  "header with context(RND) = 0, so try parsing as "
-		                  "UOR-2-RTP, and fallback on UOR-2-ID/TS later if "
-		                  "value(RND) = 0 in packet");
-		type = ROHC_PACKET_UOR_2_RTP;
-	}
-	else
-	{
-		/* there is at least one IPv4 header with context(RND) = 0, but maybe
-		 * there is a IPv4 header with value(RND) = 1 (the ROHC packet may
-		 * contain a RND field and update context), so try parsing UOR-2-TS/ID,
-		 * and fallback on UOR-2-RTP if value(RND) = 1 is found */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: at least one "
-		                  "IP header is IPv4 with context(RND) = 0, so try "
-		                  "parsing as UOR-2-ID/TS, and fallback on UOR-2-RTP "
-		                  "later if value(RND) = 1 in packet");
-
-		/* UOR-2-ID or UOR-2-TS packet, check the T field */
-		if(rohc_decomp_packet_is_uor2_ts(packet, rohc_length, large_cid_len))
-		{
-			/* UOR-2-TS packet */
-			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 1, "
-			                  "so try parsing as UOR-2-TS, and fallback on "
-			                  "UOR-2-RTP later if value(RND) = 1 in packet");
-			type = ROHC_PACKET_UOR_2_TS;
-		}
-		else
-		{
-			/* UOR-2-ID packet */
-			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 0, "
-			                  "so try parsing as UOR-2-ID, and fallback on "
-			                  "UOR-2-RTP later if value(RND) = 1 in packet");
-			type = ROHC_PACKET_UOR_2_ID;
-		}
-	}
-
-	return type;
+	return ((is_outer_ipv4_ctxt(rfc3095_ctxt) &&
+	         !is_outer_ipv4_rnd_ctxt(rfc3095_ctxt)) ||
+	        (is_inner_ipv4_ctxt(rfc3095_ctxt) &&
+	         !is_inner_ipv4_rnd_ctxt(rfc3095_ctxt)));
 }
 
 
@@ -784,17 +546,26 @@ static int rtp_parse_dynamic_rtp(const struct rohc_decomp_ctxt *const context,
 		/* part 9 */
 		if(tis)
 		{
-			/* check the minimal length to decode the SDVL-encoded TIME_STRIDE */
-			if(remain_len < 1)
+			size_t time_stride_sdvl_len;
+
+			/* decode the SDVL-encoded TIME_STRIDE field */
+			time_stride_sdvl_len = sdvl_decode(packet, remain_len,
+			                                   &bits->time_stride,
+			                                   &bits->time_stride_nr);
+			if(time_stride_sdvl_len == 0)
 			{
-				rohc_decomp_warn(context, "ROHC packet too small (len = %zu) for "
-				                 "1st byte of SDVL-encoded TIME_STRIDE", remain_len);
+				rohc_decomp_warn(context, "failed to decode SDVL-encoded "
+				                 "TIME_STRIDE field");
 				goto error;
 			}
+			rohc_decomp_debug(context, "TIME_STRIDE read = %u ms",
+			                  bits->time_stride);
 
-			/* not supported yet */
-			rohc_decomp_debug(context, "TIME_STRIDE field not supported yet");
-			goto error;
+			/* skip the SDVL-encoded TIME_STRIDE field in packet */
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+			packet += time_stride_sdvl_len;
+#endif
+			remain_len -= time_stride_sdvl_len;
 		}
 	}
 
@@ -1430,9 +1201,24 @@ static int rtp_parse_rtp_hdr_fields(const struct rohc_decomp_ctxt *const context
 
 	if(tis)
 	{
-		/* TODO: TIME_STRIDE */
-		rohc_decomp_warn(context, "TIME_STRIDE not supported yet");
-		goto error;
+		size_t time_stride_size;
+
+		/* decode SDVL-encoded TIME_STRIDE value */
+		time_stride_size = sdvl_decode(rohc_remain_data, rohc_remain_len,
+		                               &bits->time_stride, &bits->time_stride_nr);
+		if(time_stride_size == 0)
+		{
+			rohc_decomp_warn(context, "failed to decode SDVL-encoded "
+			                 "TIME_STRIDE field");
+			goto error;
+		}
+		rohc_decomp_debug(context, "decoded TIME_STRIDE = %u ms",
+		                  bits->time_stride);
+
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+		rohc_remain_data += time_stride_size;
+#endif
+		rohc_remain_len -= time_stride_size;
 	}
 
 	return (rohc_data_len - rohc_remain_len);
@@ -1732,10 +1518,26 @@ static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 
 		bool ts_decode_ok;
 
-		rohc_decomp_debug(context, "TS is scaled");
-		ts_decode_ok = ts_decode_scaled_bits(&rtp_context->ts_scaled_ctxt,
-		                                     bits->ts, bits->ts_nr,
-		                                     &decoded->ts);
+		if((context->decompressor->features &
+		    ROHC_DECOMP_FEATURE_TIMER_BASED_TS) != 0 &&
+		   rtp_context->ts_scaled_ctxt.time_stride != 0)
+		{
+			/* the compressor transmitted TIME_STRIDE, so it encodes TS_SCALED
+			 * with regard to the arrival time of the packet */
+			rohc_decomp_debug(context, "TS is scaled and timer-based");
+			ts_decode_ok =
+				ts_decode_scaled_bits_timer(&rtp_context->ts_scaled_ctxt,
+				                            bits->ts, bits->ts_nr,
+				                            rohc_time_ms32(context->pkt_arrival_time),
+				                            &decoded->ts);
+		}
+		else
+		{
+			rohc_decomp_debug(context, "TS is scaled");
+			ts_decode_ok = ts_decode_scaled_bits(&rtp_context->ts_scaled_ctxt,
+			                                     bits->ts, bits->ts_nr,
+			                                     &decoded->ts);
+		}
 		if(!ts_decode_ok)
 		{
 			rohc_decomp_debug(context, "failed to decode %zd-bit TS_SCALED 0x%x",
@@ -1761,6 +1563,9 @@ static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 	}
 	rohc_decomp_debug(context, "decoded SSRC = %u", decoded->rtp_ssrc);
 
+	/* decode TIME_STRIDE */
+	decoded->time_stride = (bits->time_stride_nr > 0 ? bits->time_stride : 0);
+
 	return true;
 
 error:
@@ -1842,7 +1647,13 @@ static void rtp_update_context(struct rohc_decomp_ctxt *const context,
 
 	/* update context for RTP fields */
 	assert(decoded->sn <= 0xffff);
-	ts_update_context(&rtp_context->ts_scaled_ctxt, decoded->ts, decoded->sn);
+	if(decoded->time_stride != 0 &&
+	   (context->decompressor->features & ROHC_DECOMP_FEATURE_TIMER_BASED_TS) != 0)
+	{
+		d_record_time_stride(&rtp_context->ts_scaled_ctxt, decoded->time_stride);
+	}
+	ts_update_context(&rtp_context->ts_scaled_ctxt, decoded->ts, decoded->sn,
+	                  rohc_time_ms32(context->pkt_arrival_time));
 	rtp->version = decoded->rtp_version;
 	rtp->padding = decoded->rtp_p;
 	rtp->extension = decoded->rtp_x;
@@ -1917,14 +1728,21 @@ const struct rohc_decomp_profile d_rtp_profile =
 {
 	.id              = ROHC_PROFILE_RTP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_len   = ROHC_DECOMP_RFC3095_CTXT_LEN(sizeof(struct d_rtp_context),
+	                                                   sizeof(struct udphdr) +
+	                                                   sizeof(struct rtphdr)),
+	.extr_bits_len      = sizeof(struct rohc_extr_bits),
+	.decoded_values_len = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_rtp_create,
-	.free_context    = (rohc_decomp_free_context_t) d_rtp_destroy,
+	.free_context    = rohc_decomp_rfc3095_free,
 	.detect_pkt_type = rtp_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) rfc3095_decomp_build_hdrs,
+	.decode_fast     = (rohc_decomp_decode_fast_t) rfc3095_decomp_decode_fast,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.get_decoded_sn  = (rohc_decomp_get_decoded_sn_t) rohc_decomp_rfc3095_get_decoded_sn,
 };
 
@@ -69,10 +69,6 @@ static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
                                    const struct rohc_tcp_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
@@ -399,6 +395,8 @@ static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
 	       sizeof(struct d_tcp_opts_ctxt));
 	memcpy(&tcp_ctxt->opt_sack_blocks, &base_tcp_ctxt->opt_sack_blocks,
 	       sizeof(struct d_tcp_opt_sack));
+	memcpy(&tcp_ctxt->tcp_opts_block, &base_tcp_ctxt->tcp_opts_block,
+	       sizeof(struct d_tcp_opts_block));
 	tcp_ctxt->ip_contexts_nr = base_tcp_ctxt->ip_contexts_nr;
 	memcpy(&tcp_ctxt->ip_contexts, &base_tcp_ctxt->ip_contexts,
 	       ROHC_MAX_IP_HDRS * sizeof(ip_context_t));
@@ -466,21 +464,12 @@ static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
  * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if creation succeeded, false in case of problem
  */
-static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
+static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context __attribute__((unused)),
                                   struct d_tcp_context **const persist_ctxt,
                                   struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	struct d_tcp_context *tcp_context;
-
-	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct d_tcp_context));
-	if((*persist_ctxt) == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "not enough memory for the TCP decompression context");
-		goto quit;
-	}
-	tcp_context = *persist_ctxt;
+	struct d_tcp_context *const tcp_context = *persist_ctxt;
+	size_t i;
 
 	/* create the LSB decoding context for the MSN */
 	rohc_lsb_init(&tcp_context->msn_lsb_ctxt, 16);
@@ -510,55 +499,69 @@ static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
 	/* create the LSB decoding context for the TCP option Timestamp echo
 	 * reply */
 	rohc_lsb_init(&tcp_context->opt_ts_rep_lsb_ctxt, 32);
+	/* no TCP options were built yet */
+	tcp_context->tcp_opts_block.is_valid = false;
+	/* no payload of generic TCP options was received yet */
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		tcp_context->tcp_opts.bits[i].load_off = D_TCP_OPT_NO_LOAD;
+	}
 
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_tcp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_tcp_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto free_extr_bits;
-	}
 
 	return true;
-
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(tcp_context);
-quit:
-	return false;
 }
 
 
 /**
- * @brief Destroy the context.
+ * @brief The TCP packet types indexed by the innermost IP-ID behavior and the
+ *        first byte of the packet
  *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param tcp_context  The persistent decompression context for the TCP profile
- * @param volat_ctxt   The volatile decompression context
+ * The first index is whether the innermost IP-ID behavior is sequential
+ * (swapped or not): the seq_* and rnd_* packets share their discriminators,
+ * see RFC 6846, section 8.3.
  */
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static const uint8_t tcp_pkt_types[2][256] =
 {
-	/* free the TCP decompression context itself */
-	free(tcp_context);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-}
+	/* random or zero innermost IP-ID: rnd_* packets */
+	[false] = {
+		[0x00 ... 0x7f] = ROHC_PACKET_TCP_RND_3,      /* 0xxxxxxx */
+		[0x80 ... 0x9f] = ROHC_PACKET_TCP_RND_5,      /* 100xxxxx */
+		[0xa0 ... 0xaf] = ROHC_PACKET_TCP_RND_6,      /* 1010xxxx */
+		[0xb0 ... 0xb7] = ROHC_PACKET_TCP_RND_8,      /* 10110xxx */
+		[0xb8 ... 0xbb] = ROHC_PACKET_TCP_RND_1,      /* 101110xx */
+		[0xbc ... 0xbf] = ROHC_PACKET_TCP_RND_7,      /* 101111xx */
+		[0xc0 ... 0xcf] = ROHC_PACKET_TCP_RND_2,      /* 1100xxxx */
+		[0xd0 ... 0xdf] = ROHC_PACKET_TCP_RND_4,      /* 1101xxxx */
+		[0xe0 ... 0xf7] = ROHC_PACKET_UNKNOWN,
+		[0xf8]          = ROHC_PACKET_IR_DYN,         /* 11111000 */
+		[0xf9]          = ROHC_PACKET_UNKNOWN,
+		[0xfa ... 0xfb] = ROHC_PACKET_TCP_CO_COMMON,  /* 1111101x */
+		[0xfc]          = ROHC_PACKET_IR_CR,          /* 11111100 */
+		[0xfd]          = ROHC_PACKET_IR,             /* 11111101 */
+		[0xfe ... 0xff] = ROHC_PACKET_UNKNOWN,
+	},
+	/* sequential innermost IP-ID: seq_* packets */
+	[true] = {
+		[0x00 ... 0x7f] = ROHC_PACKET_TCP_SEQ_4,      /* 0xxxxxxx */
+		[0x80 ... 0x8f] = ROHC_PACKET_TCP_SEQ_5,      /* 1000xxxx */
+		[0x90 ... 0x9f] = ROHC_PACKET_TCP_SEQ_3,      /* 1001xxxx */
+		[0xa0 ... 0xaf] = ROHC_PACKET_TCP_SEQ_1,      /* 1010xxxx */
+		[0xb0 ... 0xbf] = ROHC_PACKET_TCP_SEQ_8,      /* 1011xxxx */
+		[0xc0 ... 0xcf] = ROHC_PACKET_TCP_SEQ_7,      /* 1100xxxx */
+		[0xd0 ... 0xd7] = ROHC_PACKET_TCP_SEQ_2,      /* 11010xxx */
+		[0xd8 ... 0xdf] = ROHC_PACKET_TCP_SEQ_6,      /* 11011xxx */
+		[0xe0 ... 0xf7] = ROHC_PACKET_UNKNOWN,
+		[0xf8]          = ROHC_PACKET_IR_DYN,         /* 11111000 */
+		[0xf9]          = ROHC_PACKET_UNKNOWN,
+		[0xfa ... 0xfb] = ROHC_PACKET_TCP_CO_COMMON,  /* 1111101x */
+		[0xfc]          = ROHC_PACKET_IR_CR,          /* 11111100 */
+		[0xfd]          = ROHC_PACKET_IR,             /* 11111101 */
+		[0xfe ... 0xff] = ROHC_PACKET_UNKNOWN,
+	},
+};
 
 
 /**
@@ -585,120 +588,41 @@ static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const
 	rohc_decomp_debug(context, "try to determine the header from first byte "
 	                  "0x%02x", rohc_packet[0]);
 
-	if(rohc_packet[0] == ROHC_PACKET_TYPE_IR)
-	{
-		type = ROHC_PACKET_IR;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_IR_CR)
-	{
-		type = ROHC_PACKET_IR_CR;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_IR_DYN)
+	if(context->num_recv_packets == 0)
 	{
-		type = ROHC_PACKET_IR_DYN;
+		/* only IR, IR-CR and IR-DYN packets are possible without context:
+		 * they do not depend on the IP-ID behavior */
+		type = tcp_pkt_types[false][rohc_packet[0]];
+		if(type != ROHC_PACKET_IR &&
+		   type != ROHC_PACKET_IR_CR &&
+		   type != ROHC_PACKET_IR_DYN)
+		{
+			rohc_decomp_warn(context, "non IR(-DYN) packet received without "
+			                 "initialized context: cannot determine the packet "
+			                 "type");
+			goto error;
+		}
 	}
 	else
 	{
+		const ip_context_t *innermost_hdr_ctxt;
 		uint8_t innermost_ip_id_behavior;
 		bool is_ip_id_seq;
 
 		/* detect the version and IP-ID behavior of the innermost IP header */
-		{
-			const ip_context_t *innermost_hdr_ctxt;
-			if(context->num_recv_packets == 0)
-			{
-				rohc_decomp_warn(context, "non IR(-DYN) packet received without "
-				                 "initialized context: cannot determine the packet "
-				                 "type");
-				goto error;
-			}
-			assert(tcp_context->ip_contexts_nr > 0);
-			innermost_hdr_ctxt =
-				&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr - 1]);
-			innermost_ip_id_behavior = innermost_hdr_ctxt->ip_id_behavior;
-			is_ip_id_seq = (innermost_ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP);
-			rohc_decomp_debug(context, "IPv%u header #%u is the innermost IP header",
-			                  innermost_hdr_ctxt->version, tcp_context->ip_contexts_nr);
-		}
+		assert(tcp_context->ip_contexts_nr > 0);
+		innermost_hdr_ctxt =
+			&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr - 1]);
+		innermost_ip_id_behavior = innermost_hdr_ctxt->ip_id_behavior;
+		is_ip_id_seq = (innermost_ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP);
+		rohc_decomp_debug(context, "IPv%u header #%u is the innermost IP header",
+		                  innermost_hdr_ctxt->version, tcp_context->ip_contexts_nr);
 
 		rohc_decomp_debug(context, "try to determine the header from first byte "
 		                  "0x%02x and innermost IP-ID behavior %s", rohc_packet[0],
 		                  rohc_ip_id_behavior_get_descr(innermost_ip_id_behavior));
 
-		if(rohc_packet[0] & 0x80)
-		{
-			switch(rohc_packet[0] & 0xf0)
-			{
-				case 0x80: /* 1000 = seq_5 / rnd_5 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_5 : ROHC_PACKET_TCP_RND_5);
-					break;
-				case 0x90: /* 1001 = seq_3 / rnd_5 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_3 : ROHC_PACKET_TCP_RND_5);
-					break;
-				case 0xa0: /* 1010 = seq_1 / rnd_6 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_1 : ROHC_PACKET_TCP_RND_6);
-					break;
-				case 0xb0: /* 1011 = seq_8 / rnd_1 / rnd_7 / rnd_8 */
-					if(is_ip_id_seq)
-					{
-						type = ROHC_PACKET_TCP_SEQ_8;
-					}
-					else if(rohc_packet[0] & 0x08)
-					{
-						if(rohc_packet[0] & 0x04)
-						{
-							type = ROHC_PACKET_TCP_RND_7;
-						}
-						else
-						{
-							type = ROHC_PACKET_TCP_RND_1;
-						}
-					}
-					else
-					{
-						type = ROHC_PACKET_TCP_RND_8;
-					}
-					break;
-				case 0xc0: /* 1100 = seq_7 / rnd_2 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_7 : ROHC_PACKET_TCP_RND_2);
-					break;
-				case 0xd0: /* 1101 = seq_2 / seq_6 / rnd_4 */
-					if(is_ip_id_seq)
-					{
-						if(rohc_packet[0] & 0x08)
-						{
-							type = ROHC_PACKET_TCP_SEQ_6;
-						}
-						else
-						{
-							type = ROHC_PACKET_TCP_SEQ_2;
-						}
-					}
-					else
-					{
-						type = ROHC_PACKET_TCP_RND_4;
-					}
-					break;
-				case 0xf0: /* 1111 = common */
-					if((rohc_packet[0] & 0xfe) == 0xfa)
-					{
-						type = ROHC_PACKET_TCP_CO_COMMON;
-					}
-					else
-					{
-						type = ROHC_PACKET_UNKNOWN;
-					}
-					break;
-				default:
-					type = ROHC_PACKET_UNKNOWN;
-					break;
-			}
-		}
-		else
-		{
-			/* seq_4 / rnd_3 */
-			type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_4 : ROHC_PACKET_TCP_RND_3);
-		}
+		type = tcp_pkt_types[is_ip_id_seq][rohc_packet[0]];
 	}
 
 	return type;
@@ -1175,6 +1099,7 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	/* remaining ROHC data not parsed yet */
 	const uint8_t *rohc_remain_data;
 	size_t rohc_remain_len;
+	const uint8_t *base_hdr;
 
 	const ip_context_t *ip_inner_context;
 	struct rohc_tcp_extr_ip_bits *inner_ip_bits;
@@ -1216,13 +1141,22 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* copy the first bytes of header in a contiguous buffer
-	 * to be able to map packet structures to the ROHC bytes */
-	packed_rohc_packet[0] = rohc_packet[0];
-	memcpy(packed_rohc_packet + 1, rohc_packet + 1 + large_cid_len,
-	       rohc_min(rohc_remain_len - large_cid_len, packed_rohc_packet_max_len) - 1);
-	rohc_remain_data = packed_rohc_packet;
+	/* the base header is contiguous if there is no large CID, so map the
+	 * packet structures directly to the ROHC bytes; otherwise copy the first
+	 * bytes of header in a contiguous buffer */
 	rohc_remain_len = rohc_min(rohc_remain_len - large_cid_len, packed_rohc_packet_max_len);
+	if(large_cid_len == 0)
+	{
+		rohc_remain_data = rohc_packet;
+	}
+	else
+	{
+		packed_rohc_packet[0] = rohc_packet[0];
+		memcpy(packed_rohc_packet + 1, rohc_packet + 1 + large_cid_len,
+		       rohc_remain_len - 1);
+		rohc_remain_data = packed_rohc_packet;
+	}
+	base_hdr = rohc_remain_data;
 	*rohc_hdr_len = 0;
 
 	/* parse the packet type we detected earlier */
@@ -1300,8 +1234,7 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 #endif
 		(*rohc_hdr_len) += co_pkt_len;
 	}
-	rohc_decomp_dump_buf(context, "ROHC base header", packed_rohc_packet,
-	                     *rohc_hdr_len);
+	rohc_decomp_dump_buf(context, "ROHC base header", base_hdr, *rohc_hdr_len);
 
 	/* revert the buffer trick since the base header is parsed */
 	rohc_remain_data = rohc_packet + large_cid_len + (*rohc_hdr_len);
@@ -2700,7 +2633,9 @@ static void d_tcp_reset_extr_bits(const struct rohc_decomp_ctxt *const context,
 	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
 	{
 		bits->tcp_opts.bits[i].used = false;
+		bits->tcp_opts.bits[i].load_off = D_TCP_OPT_NO_LOAD;
 	}
+	bits->tcp_opts.arena_len = 0;
 
 	/* if context handled at least one packet, init the list of IP headers */
 	if(context->num_recv_packets >= 1)
@@ -3230,12 +3165,13 @@ static bool d_tcp_decode_bits_tcp_hdr(const struct rohc_decomp_ctxt *const conte
 			                 "for a packet with an empty payload");
 			goto error;
 		}
+		decoded->seq_num_residue = tcp_context->seq_num_residue;
 		decoded->seq_num = decoded->seq_num_scaled * payload_len +
-		                   tcp_context->seq_num_residue;
+		                   decoded->seq_num_residue;
 		rohc_decomp_debug(context, "  seq_number_scaled = 0x%x, payload size = %zu, "
 		                  "seq_number_residue = 0x%x -> seq_number = 0x%x",
 		                  decoded->seq_num_scaled, payload_len,
-		                  tcp_context->seq_num_residue, decoded->seq_num);
+		                  decoded->seq_num_residue, decoded->seq_num);
 	}
 	else
 	{
@@ -3646,7 +3582,7 @@ static bool d_tcp_decode_bits_tcp_opts(const struct rohc_decomp_ctxt *const cont
 			/* decode TS request field */
 			if(!d_tcp_decode_opt_ts_field(context, "request",
 			                              &tcp_context->opt_ts_req_lsb_ctxt,
-			                              bits->tcp_opts.bits[TCP_INDEX_TS].data.ts.req,
+			                              bits->tcp_opts.ts.req,
 			                              &decoded->opt_ts_req))
 			{
 				rohc_decomp_warn(context, "failed to decode TimeStamp option: failed to "
@@ -3659,7 +3595,7 @@ static bool d_tcp_decode_bits_tcp_opts(const struct rohc_decomp_ctxt *const cont
 			/* decode TS reply field */
 			if(!d_tcp_decode_opt_ts_field(context, "reply",
 			                              &tcp_context->opt_ts_rep_lsb_ctxt,
-			                              bits->tcp_opts.bits[TCP_INDEX_TS].data.ts.rep,
+			                              bits->tcp_opts.ts.rep,
 			                              &decoded->opt_ts_rep))
 			{
 				rohc_decomp_warn(context, "failed to decode TimeStamp option: failed to "
@@ -3672,7 +3608,7 @@ static bool d_tcp_decode_bits_tcp_opts(const struct rohc_decomp_ctxt *const cont
 		else if(opt_index == TCP_INDEX_SACK)
 		{
 			d_tcp_decode_opt_sack(context, decoded->ack_num,
-			                      bits->tcp_opts.bits[TCP_INDEX_SACK].data.sack,
+			                      bits->tcp_opts.sack,
 			                      &decoded->opt_sack_blocks);
 		}
 		else if(opt_index >= TCP_INDEX_GENERIC7)
@@ -3682,22 +3618,32 @@ static bool d_tcp_decode_bits_tcp_opts(const struct rohc_decomp_ctxt *const cont
 			if(bits->tcp_opts.bits[opt_index].data.generic.type == TCP_GENERIC_OPT_STATIC ||
 			   bits->tcp_opts.bits[opt_index].data.generic.type == TCP_GENERIC_OPT_STABLE)
 			{
-				if(!tcp_context->tcp_opts.bits[opt_index].used)
+				const struct d_tcp_opt_ctxt *const ctxt_opt =
+					&(tcp_context->tcp_opts.bits[opt_index]);
+
+				if(!ctxt_opt->used || ctxt_opt->load_off == D_TCP_OPT_NO_LOAD)
 				{
 					rohc_decomp_warn(context, "failed to decode generic option: packet "
 					                 "reports that option is static, but context "
 					                 "knows nothing about its value");
 					goto error;
 				}
-				opt_bits->data.generic.load_len =
-					tcp_context->tcp_opts.bits[opt_index].data.generic.load_len;
-				memcpy(opt_bits->data.generic.load,
-				       tcp_context->tcp_opts.bits[opt_index].data.generic.load,
-				       opt_bits->data.generic.load_len);
+				if(!d_tcp_opts_arena_store(&decoded->tcp_opts, opt_bits,
+				                           tcp_context->tcp_opts.arena + ctxt_opt->load_off,
+				                           ctxt_opt->load_len))
+				{
+					rohc_decomp_warn(context, "failed to decode generic option: no "
+					                 "room left for its %u-byte payload",
+					                 ctxt_opt->load_len);
+					goto error;
+				}
 			}
 		}
 	}
 
+	/* may the TCP options of the previous packet be reused? */
+	decoded->tcp_opts_block_reused = d_tcp_opts_block_match(context, decoded);
+
 	return true;
 
 error:
@@ -4495,21 +4441,7 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	/* TCP Urgent pointer is sent every time, nothing to update in context */
 
 	/* copy the information collected on TCP options */
-	tcp_context->tcp_opts.nr = decoded->tcp_opts.nr;
-	memcpy(&tcp_context->tcp_opts.structure, &decoded->tcp_opts.structure,
-	       sizeof(uint8_t) * ROHC_TCP_OPTS_MAX);
-	memcpy(&tcp_context->tcp_opts.expected_dynamic, &decoded->tcp_opts.expected_dynamic,
-	       sizeof(bool) * ROHC_TCP_OPTS_MAX);
-	memcpy(&tcp_context->tcp_opts.found, &decoded->tcp_opts.found,
-	       sizeof(bool) * ROHC_TCP_OPTS_MAX);
-	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
-	{
-		if(decoded->tcp_opts.bits[i].used)
-		{
-			memcpy(&tcp_context->tcp_opts.bits[i], &decoded->tcp_opts.bits[i],
-			       sizeof(struct d_tcp_opt_ctxt));
-		}
-	}
+	d_tcp_opts_update_ctxt(&tcp_context->tcp_opts, &decoded->tcp_opts);
 	for(i = 0; i < decoded->tcp_opts.nr; i++)
 	{
 		const uint8_t opt_index = decoded->tcp_opts.structure[i];
@@ -4532,6 +4464,7 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 			       sizeof(struct d_tcp_opt_sack));
 		}
 	}
+	d_tcp_opts_block_update(context, decoded, &tcp_context->tcp_opts_block);
 }
 
 
@@ -4561,8 +4494,12 @@ const struct rohc_decomp_profile d_tcp_profile =
 {
 	.id              = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_len   = sizeof(struct d_tcp_context),
+	.persist_ctxt_is_flat = true,
+	.extr_bits_len      = sizeof(struct rohc_tcp_extr_bits),
+	.decoded_values_len = sizeof(struct rohc_tcp_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_tcp_create_from_pkt,
-	.free_context    = (rohc_decomp_free_context_t) d_tcp_destroy,
+	.free_context    = NULL,
 	.detect_pkt_type = tcp_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) d_tcp_parse_packet,
 	.decode_bits     = (rohc_decomp_decode_bits_t) d_tcp_decode_bits,
@@ -42,6 +42,13 @@
 #include <stdint.h>
 
 
+/** The length of the arena that stores the loads of generic TCP options */
+#define D_TCP_OPTS_ARENA_LEN  64U
+
+/** The offset of a generic TCP option that has no load in the arena */
+#define D_TCP_OPT_NO_LOAD  0xffU
+
+
 /** The decompression context for one TCP option */
 struct d_tcp_opt_ctxt /* TODO: doxygen */
 {
@@ -64,24 +71,22 @@ struct d_tcp_opt_ctxt /* TODO: doxygen */
 		} ws;
 		struct
 		{
-			struct rohc_lsb_field32 req;  /**< The context for the TS request field */
-			struct rohc_lsb_field32 rep;  /**< The context for the TS reply field */
-		} ts;
-		struct d_tcp_opt_sack sack; /* TODO: ptr inside is not needed */
-		struct
-		{
-			uint8_t load[ROHC_TCP_OPT_MAX_LEN];
 			enum
 			{
 				TCP_GENERIC_OPT_STATIC,
 				TCP_GENERIC_OPT_STABLE,
 				TCP_GENERIC_OPT_FULL,
 			} type;
-			uint8_t load_len;
 		} generic;
 	} data;
 	bool used;
 	uint8_t type;
+	/** The offset of the load of the generic option in the arena of the list,
+	 * D_TCP_OPT_NO_LOAD if the arena holds no load for the option */
+	uint8_t load_off;
+	uint8_t load_len;   /**< The length of the load of the generic option */
+	uint8_t load_age;   /**< The number of packets without the generic option */
+	uint8_t unused[7];  /**< pad struct up to multiple of 8 bytes */
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -96,20 +101,21 @@ _Static_assert((offsetof(struct d_tcp_opt_ctxt, data.mss) % 8) == 0,
                "data.mss in d_tcp_opt_ctxt should be aligned on 8 bytes");
 _Static_assert((offsetof(struct d_tcp_opt_ctxt, data.ws) % 8) == 0,
                "data.ws in d_tcp_opt_ctxt should be aligned on 8 bytes");
-_Static_assert((offsetof(struct d_tcp_opt_ctxt, data.ts) % 8) == 0,
-               "data.ts in d_tcp_opt_ctxt should be aligned on 8 bytes");
-_Static_assert((offsetof(struct d_tcp_opt_ctxt, data.sack) % 8) == 0,
-               "data.sack in d_tcp_opt_ctxt should be aligned on 8 bytes");
 _Static_assert((offsetof(struct d_tcp_opt_ctxt, data.generic) % 8) == 0,
                "data.generic in d_tcp_opt_ctxt should be aligned on 8 bytes");
-_Static_assert((offsetof(struct d_tcp_opt_ctxt, data.generic.load) % 8) == 0,
-               "data.generic.load in d_tcp_opt_ctxt should be aligned on 8 bytes");
 _Static_assert((sizeof(struct d_tcp_opt_ctxt) % 8) == 0,
                "d_tcp_opt_ctxt length should be multiple of 8 bytes");
 #endif
 
 
-/** The decompression context for TCP options */
+/**
+ * @brief The decompression context for TCP options
+ *
+ * The TS and SACK options are decoded from fixed slots. The loads of the
+ * generic options are stored one after the other in a small arena: most flows
+ * use a few small options, so the list does not pay for the maximum length of
+ * every option.
+ */
 struct d_tcp_opts_ctxt
 {
 	/** The structure of the list of TCP options */
@@ -129,6 +135,19 @@ struct d_tcp_opts_ctxt
 	/** The bits of TCP options extracted from the dynamic chain, the tail of
 	 * co_common/seq_8/rnd_8 packets, or the irregular chain */
 	struct d_tcp_opt_ctxt bits[MAX_TCP_OPTION_INDEX + 1];
+
+	/** The bits of the TS option */
+	struct
+	{
+		struct rohc_lsb_field32 req;  /**< The context for the TS request field */
+		struct rohc_lsb_field32 rep;  /**< The context for the TS reply field */
+	} ts;
+	struct d_tcp_opt_sack sack; /**< The bits of the SACK option */
+
+	uint8_t arena_len;  /**< The number of bytes used in the arena */
+	uint8_t unused4[7]; /**< pad struct up to multiple of 8 bytes, align next fields */
+	/** The loads of the generic TCP options */
+	uint8_t arena[D_TCP_OPTS_ARENA_LEN];
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -143,11 +162,47 @@ _Static_assert((offsetof(struct d_tcp_opts_ctxt, found) % 8) == 0,
                "found in d_tcp_opts_ctxt should be aligned on 8 bytes");
 _Static_assert((offsetof(struct d_tcp_opts_ctxt, bits) % 8) == 0,
                "bits in d_tcp_opts_ctxt should be aligned on 8 bytes");
+_Static_assert((offsetof(struct d_tcp_opts_ctxt, ts) % 8) == 0,
+               "ts in d_tcp_opts_ctxt should be aligned on 8 bytes");
+_Static_assert((offsetof(struct d_tcp_opts_ctxt, sack) % 8) == 0,
+               "sack in d_tcp_opts_ctxt should be aligned on 8 bytes");
+_Static_assert((offsetof(struct d_tcp_opts_ctxt, arena) % 8) == 0,
+               "arena in d_tcp_opts_ctxt should be aligned on 8 bytes");
 _Static_assert((sizeof(struct d_tcp_opts_ctxt) % 8) == 0,
                "d_tcp_opts_ctxt length should be multiple of 8 bytes");
 #endif
 
 
+/**
+ * @brief The TCP options of the last packet, as they were built
+ *
+ * Most packets keep the structure and the values of the TCP options of the
+ * previous packet, only the TS values and sometimes the SACK blocks change:
+ * the options are then copied from the block and patched in place.
+ */
+struct d_tcp_opts_block
+{
+	/** The bytes of the TCP options */
+	uint8_t data[ROHC_TCP_OPTS_LEN_MAX_PROTO];
+	uint8_t len;             /**< The length of the TCP options (in bytes) */
+	uint8_t ts_off;          /**< The offset of the TS option, if any */
+	uint8_t sack_off;        /**< The offset of the SACK option, if any */
+	uint8_t sack_blocks_nr;  /**< The number of blocks of the SACK option */
+	bool is_ts_present;      /**< Whether the TS option is present */
+	bool is_sack_present;    /**< Whether the SACK option is present */
+	bool is_valid;           /**< Whether the block matches the context */
+	uint8_t unused[1];
+};
+
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert((sizeof(struct d_tcp_opts_block) % 8) == 0,
+               "d_tcp_opts_block length should be multiple of 8 bytes");
+#endif
+
+
 /** Define the TCP part of the decompression profile context */
 struct d_tcp_context
 {
@@ -198,6 +253,8 @@ struct d_tcp_context
 	/* TCP SACK option */
 	struct d_tcp_opt_sack opt_sack_blocks;  /**< The TCP SACK blocks */
 
+	/** The TCP options of the last packet, as they were built */
+	struct d_tcp_opts_block tcp_opts_block;
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -222,6 +279,8 @@ _Static_assert((offsetof(struct d_tcp_context, opt_ts_rep_lsb_ctxt) % 8) == 0,
                "opt_ts_rep_lsb_ctxt in d_tcp_context should be aligned on 8 bytes");
 _Static_assert((offsetof(struct d_tcp_context, opt_sack_blocks) % 8) == 0,
                "opt_sack_blocks in d_tcp_context should be aligned on 8 bytes");
+_Static_assert((offsetof(struct d_tcp_context, tcp_opts_block) % 8) == 0,
+               "tcp_opts_block in d_tcp_context should be aligned on 8 bytes");
 _Static_assert((offsetof(struct d_tcp_context, ip_contexts) % 8) == 0,
                "ip_contexts in d_tcp_context should be aligned on 8 bytes");
 _Static_assert((sizeof(struct d_tcp_context) % 8) == 0,
@@ -476,7 +535,9 @@ struct rohc_tcp_decoded_values
 	/** The decoded values related to the IP headers */
 	struct rohc_tcp_decoded_ip_values ip[ROHC_MAX_IP_HDRS];
 	uint8_t ip_nr;  /**< The number of the decoded IP headers */
-	uint8_t unused[7];
+	/** Whether the TCP options are rebuilt from the block of the context */
+	bool tcp_opts_block_reused;
+	uint8_t unused[6];
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -56,14 +56,16 @@ struct d_tcp_opt /* TODO */
 	int (*parse_list_item)(const struct rohc_decomp_ctxt *const context,
 	                       const uint8_t *const data,
 	                       const size_t data_len,
-	                       struct d_tcp_opt_ctxt *const opt_ctxt)
-		__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+	                       struct d_tcp_opt_ctxt *const opt_ctxt,
+	                       struct d_tcp_opts_ctxt *const opts)
+		__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 	int (*parse_irregular)(const struct rohc_decomp_ctxt *const context,
 	                       const uint8_t *const data,
 	                       const size_t data_len,
 	                       const uint8_t opt_index,
-	                       struct d_tcp_opt_ctxt *const opt_ctxt)
-		__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+	                       struct d_tcp_opt_ctxt *const opt_ctxt,
+	                       struct d_tcp_opts_ctxt *const opts)
+		__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 	bool (*build)(const struct rohc_decomp_ctxt *const context,
 	              const struct rohc_tcp_decoded_values *const decoded,
 	              const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -96,7 +98,7 @@ static int d_tcp_opt_list_parse_item(const struct rohc_decomp_ctxt *const contex
                                      const struct d_tcp_opt_index opt_index,
                                      const uint8_t *const item,
                                      const size_t item_max_len,
-                                     struct d_tcp_opt_ctxt opts_bits[MAX_TCP_OPTION_INDEX + 1])
+                                     struct d_tcp_opts_ctxt *const tcp_opts)
 	__attribute__((warn_unused_result, nonnull(1, 4, 6)));
 
 #ifndef ROHC_NO_TRACES
@@ -113,14 +115,16 @@ static bool tcp_opt_is_well_known(const uint8_t idx)
 static int d_tcp_parse_nop_list_item(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const data,
                                      const size_t data_len,
-                                     struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                     struct d_tcp_opt_ctxt *const opt_ctxt,
+                                     struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_nop_irreg(const struct rohc_decomp_ctxt *const context,
                                  const uint8_t *const data,
                                  const size_t data_len,
                                  const uint8_t opt_index,
-                                 struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                 struct d_tcp_opt_ctxt *const opt_ctxt,
+                                 struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_nop(const struct rohc_decomp_ctxt *const context,
                             const struct rohc_tcp_decoded_values *const decoded,
                             const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -131,14 +135,16 @@ static bool d_tcp_build_nop(const struct rohc_decomp_ctxt *const context,
 static int d_tcp_parse_eol_list_item(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const data,
                                      const size_t data_len,
-                                     struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                     struct d_tcp_opt_ctxt *const opt_ctxt,
+                                     struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_eol_irreg(const struct rohc_decomp_ctxt *const context,
                                  const uint8_t *const data,
                                  const size_t data_len,
                                  const uint8_t opt_index,
-                                 struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                 struct d_tcp_opt_ctxt *const opt_ctxt,
+                                 struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_eol(const struct rohc_decomp_ctxt *const context,
                             const struct rohc_tcp_decoded_values *const decoded,
                             const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -149,14 +155,16 @@ static bool d_tcp_build_eol(const struct rohc_decomp_ctxt *const context,
 static int d_tcp_parse_mss_list_item(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const data,
                                      const size_t data_len,
-                                     struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                     struct d_tcp_opt_ctxt *const opt_ctxt,
+                                     struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_mss_irreg(const struct rohc_decomp_ctxt *const context,
                                  const uint8_t *const data,
                                  const size_t data_len,
                                  const uint8_t opt_index,
-                                 struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                 struct d_tcp_opt_ctxt *const opt_ctxt,
+                                 struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_mss(const struct rohc_decomp_ctxt *const context,
                             const struct rohc_tcp_decoded_values *const decoded,
                             const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -167,14 +175,16 @@ static bool d_tcp_build_mss(const struct rohc_decomp_ctxt *const context,
 static int d_tcp_parse_ws_list_item(const struct rohc_decomp_ctxt *const context,
                                     const uint8_t *const data,
                                     const size_t data_len,
-                                    struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                    struct d_tcp_opt_ctxt *const opt_ctxt,
+                                    struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_ws_irreg(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *const data,
                                 const size_t data_len,
                                 const uint8_t opt_index,
-                                struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                struct d_tcp_opt_ctxt *const opt_ctxt,
+                                struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_ws(const struct rohc_decomp_ctxt *const context,
                            const struct rohc_tcp_decoded_values *const decoded,
                            const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -185,14 +195,16 @@ static bool d_tcp_build_ws(const struct rohc_decomp_ctxt *const context,
 static int d_tcp_parse_ts_list_item(const struct rohc_decomp_ctxt *const context,
                                     const uint8_t *const data,
                                     const size_t data_len,
-                                    struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                    struct d_tcp_opt_ctxt *const opt_ctxt,
+                                    struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_ts_irreg(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *const data,
                                 const size_t data_len,
                                 const uint8_t opt_index,
-                                struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                struct d_tcp_opt_ctxt *const opt_ctxt,
+                                struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_ts(const struct rohc_decomp_ctxt *const context,
                            const struct rohc_tcp_decoded_values *const decoded,
                            const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -203,14 +215,16 @@ static bool d_tcp_build_ts(const struct rohc_decomp_ctxt *const context,
 static int d_tcp_parse_sack_perm_list_item(const struct rohc_decomp_ctxt *const context,
                                            const uint8_t *const data,
                                            const size_t data_len,
-                                           struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                           struct d_tcp_opt_ctxt *const opt_ctxt,
+                                           struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_sack_perm_irreg(const struct rohc_decomp_ctxt *const context,
                                        const uint8_t *const data,
                                        const size_t data_len,
                                        const uint8_t opt_index,
-                                       struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                       struct d_tcp_opt_ctxt *const opt_ctxt,
+                                       struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_sack_perm(const struct rohc_decomp_ctxt *const context,
                                   const struct rohc_tcp_decoded_values *const decoded,
                                   const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -221,14 +235,16 @@ static bool d_tcp_build_sack_perm(const struct rohc_decomp_ctxt *const context,
 static int d_tcp_parse_sack_list_item(const struct rohc_decomp_ctxt *const context,
                                       const uint8_t *const data,
                                       const size_t data_len,
-                                      struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                      struct d_tcp_opt_ctxt *const opt_ctxt,
+                                      struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_sack_irreg(const struct rohc_decomp_ctxt *const context,
                                   const uint8_t *const data,
                                   const size_t data_len,
                                   const uint8_t opt_index,
-                                  struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                  struct d_tcp_opt_ctxt *const opt_ctxt,
+                                  struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_sack(const struct rohc_decomp_ctxt *const context,
                              const struct rohc_tcp_decoded_values *const decoded,
                              const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -239,14 +255,16 @@ static bool d_tcp_build_sack(const struct rohc_decomp_ctxt *const context,
 static int d_tcp_parse_generic_list_item(const struct rohc_decomp_ctxt *const context,
                                          const uint8_t *const data,
                                          const size_t data_len,
-                                         struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+                                         struct d_tcp_opt_ctxt *const opt_ctxt,
+                                         struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int d_tcp_parse_generic_irreg(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const data,
                                      const size_t data_len,
                                      const uint8_t opt_index,
-                                     struct d_tcp_opt_ctxt *const opt_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+                                     struct d_tcp_opt_ctxt *const opt_ctxt,
+                                     struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
 static bool d_tcp_build_generic(const struct rohc_decomp_ctxt *const context,
                                 const struct rohc_tcp_decoded_values *const decoded,
                                 const struct d_tcp_opt_ctxt *const tcp_opt,
@@ -256,6 +274,16 @@ static bool d_tcp_build_generic(const struct rohc_decomp_ctxt *const context,
 
 
 /* TODO */
+static void d_tcp_opts_block_patch(const struct d_tcp_opts_block *const block,
+                                   const struct rohc_tcp_decoded_values *const decoded,
+                                   uint8_t *const opts)
+	__attribute__((nonnull(1, 2, 3)));
+
+static bool d_tcp_opts_arena_evict(struct d_tcp_opts_ctxt *const opts)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void d_tcp_opts_arena_compact(struct d_tcp_opts_ctxt *const opts)
+	__attribute__((nonnull(1)));
+
 static struct d_tcp_opt d_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
 {
 	[TCP_INDEX_NOP]       = { TCP_INDEX_NOP, true, TCP_OPT_NOP,
@@ -447,7 +475,7 @@ int d_tcp_parse_tcp_opts_irreg(const struct rohc_decomp_ctxt *const context,
 			/* parse TCP option */
 			ret = d_tcp_opts[opt_index].parse_irregular(context, remain_data,
 			                                            remain_len, opt_index,
-			                                            tcp_opt);
+			                                            tcp_opt, tcp_opts);
 			if(ret < 0)
 			{
 				rohc_decomp_warn(context, "malformed ROHC packet: failed to parse item "
@@ -590,7 +618,7 @@ static int d_tcp_opt_list_parse_items(const struct rohc_decomp_ctxt *const conte
 		/* parse one list item */
 		rohc_decomp_debug(context, "  TCP options list: XI #%u:", i);
 		ret = d_tcp_opt_list_parse_item(context, is_dynamic_chain, opt_indexes[i],
-		                                remain_data, remain_len, tcp_opts->bits);
+		                                remain_data, remain_len, tcp_opts);
 		if(ret < 0)
 		{
 			rohc_decomp_warn(context, "malformed ROHC packet: failed to parse item "
@@ -623,9 +651,9 @@ static int d_tcp_opt_list_parse_item(const struct rohc_decomp_ctxt *const contex
                                      const struct d_tcp_opt_index opt_index,
                                      const uint8_t *const item,
                                      const size_t item_max_len,
-                                     struct d_tcp_opt_ctxt opts_bits[MAX_TCP_OPTION_INDEX + 1])
+                                     struct d_tcp_opts_ctxt *const tcp_opts)
 {
-	struct d_tcp_opt_ctxt *const opt_bits = &(opts_bits[opt_index.index]);
+	struct d_tcp_opt_ctxt *const opt_bits = &(tcp_opts->bits[opt_index.index]);
 	const uint8_t *remain_data = item;
 	size_t remain_len = item_max_len;
 	int ret;
@@ -657,7 +685,8 @@ static int d_tcp_opt_list_parse_item(const struct rohc_decomp_ctxt *const contex
 
 	/* parse TCP option */
 	ret = d_tcp_opts[opt_index.index].parse_list_item(context, remain_data,
-	                                                  remain_len, opt_bits);
+	                                                  remain_len, opt_bits,
+	                                                  tcp_opts);
 	if(ret < 0)
 	{
 		rohc_decomp_warn(context, "malformed ROHC packet: failed to parse item "
@@ -718,7 +747,8 @@ static bool tcp_opt_is_well_known(const uint8_t idx)
 static int d_tcp_parse_nop_list_item(const struct rohc_decomp_ctxt *const context __attribute__((unused)),
                                      const uint8_t *const data __attribute__((unused)),
                                      const size_t data_len __attribute__((unused)),
-                                     struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)))
+                                     struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                     struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	return 0;
 }
@@ -729,7 +759,8 @@ static int d_tcp_parse_nop_irreg(const struct rohc_decomp_ctxt *const context __
                                  const uint8_t *const data __attribute__((unused)),
                                  const size_t data_len __attribute__((unused)),
                                  const uint8_t opt_index __attribute__((unused)),
-                                 struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)))
+                                 struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                 struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	return 0;
 }
@@ -765,7 +796,8 @@ error:
 static int d_tcp_parse_eol_list_item(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const data,
                                      const size_t data_len,
-                                     struct d_tcp_opt_ctxt *const opt_ctxt)
+                                     struct d_tcp_opt_ctxt *const opt_ctxt,
+                                     struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	const size_t eol_list_item_len = sizeof(uint8_t);
 	size_t eol_uncomp_len;
@@ -804,7 +836,8 @@ static int d_tcp_parse_eol_irreg(const struct rohc_decomp_ctxt *const context __
                                  const uint8_t *const data __attribute__((unused)),
                                  const size_t data_len __attribute__((unused)),
                                  const uint8_t opt_index __attribute__((unused)),
-                                 struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)))
+                                 struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                 struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	opt_ctxt->data.eol.is_static = true;
 	return 0;
@@ -846,7 +879,8 @@ error:
 static int d_tcp_parse_mss_list_item(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const data,
                                      const size_t data_len,
-                                     struct d_tcp_opt_ctxt *const opt_ctxt)
+                                     struct d_tcp_opt_ctxt *const opt_ctxt,
+                                     struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	const size_t mss_list_item_len = sizeof(uint16_t);
 
@@ -875,7 +909,8 @@ static int d_tcp_parse_mss_irreg(const struct rohc_decomp_ctxt *const context __
                                  const uint8_t *const data __attribute__((unused)),
                                  const size_t data_len __attribute__((unused)),
                                  const uint8_t opt_index __attribute__((unused)),
-                                 struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)))
+                                 struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                 struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	opt_ctxt->data.mss.is_static = true;
 	return 0;
@@ -917,7 +952,8 @@ error:
 static int d_tcp_parse_ws_list_item(const struct rohc_decomp_ctxt *const context,
                                     const uint8_t *const data,
                                     const size_t data_len,
-                                    struct d_tcp_opt_ctxt *const opt_ctxt)
+                                    struct d_tcp_opt_ctxt *const opt_ctxt,
+                                    struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	const size_t ws_list_item_len = sizeof(uint8_t);
 
@@ -943,7 +979,8 @@ static int d_tcp_parse_ws_irreg(const struct rohc_decomp_ctxt *const context __a
                                 const uint8_t *const data __attribute__((unused)),
                                 const size_t data_len __attribute__((unused)),
                                 const uint8_t opt_index __attribute__((unused)),
-                                struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)))
+                                struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	opt_ctxt->data.ws.is_static = true;
 	return 0;
@@ -983,7 +1020,8 @@ error:
 static int d_tcp_parse_ts_list_item(const struct rohc_decomp_ctxt *const context,
                                     const uint8_t *const data,
                                     const size_t data_len,
-                                    struct d_tcp_opt_ctxt *const opt_ctxt)
+                                    struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                    struct d_tcp_opts_ctxt *const opts)
 {
 	const struct tcp_option_timestamp *const opt_ts =
 		(struct tcp_option_timestamp *) data;
@@ -998,10 +1036,10 @@ static int d_tcp_parse_ts_list_item(const struct rohc_decomp_ctxt *const context
 		goto error;
 	}
 
-	opt_ctxt->data.ts.req.bits = rohc_ntoh32(opt_ts->ts);
-	opt_ctxt->data.ts.req.bits_nr = 32;
-	opt_ctxt->data.ts.rep.bits = rohc_ntoh32(opt_ts->ts_reply);
-	opt_ctxt->data.ts.rep.bits_nr = 32;
+	opts->ts.req.bits = rohc_ntoh32(opt_ts->ts);
+	opts->ts.req.bits_nr = 32;
+	opts->ts.rep.bits = rohc_ntoh32(opt_ts->ts_reply);
+	opts->ts.rep.bits_nr = 32;
 
 	return ts_list_item_len;
 
@@ -1015,7 +1053,8 @@ static int d_tcp_parse_ts_irreg(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *const data,
                                 const size_t data_len,
                                 const uint8_t opt_index __attribute__((unused)),
-                                struct d_tcp_opt_ctxt *const opt_ctxt)
+                                struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                struct d_tcp_opts_ctxt *const opts)
 {
 	const uint8_t *remain_data = data;
 	size_t remain_len = data_len;
@@ -1024,7 +1063,7 @@ static int d_tcp_parse_ts_irreg(const struct rohc_decomp_ctxt *const context,
 
 	/* parse TS echo request */
 	ret = d_tcp_ts_lsb_parse(context, remain_data, remain_len,
-	                         &opt_ctxt->data.ts.req);
+	                         &opts->ts.req);
 	if(ret < 0)
 	{
 		rohc_decomp_warn(context, "failed to parse TS echo request");
@@ -1036,7 +1075,7 @@ static int d_tcp_parse_ts_irreg(const struct rohc_decomp_ctxt *const context,
 
 	/* parse TS echo reply */
 	ret = d_tcp_ts_lsb_parse(context, remain_data, remain_len,
-	                         &opt_ctxt->data.ts.rep);
+	                         &opts->ts.rep);
 	if(ret < 0)
 	{
 		rohc_decomp_warn(context, "failed to parse TS echo reply");
@@ -1093,7 +1132,8 @@ error:
 static int d_tcp_parse_sack_perm_list_item(const struct rohc_decomp_ctxt *const context __attribute__((unused)),
                                            const uint8_t *const data __attribute__((unused)),
                                            const size_t data_len __attribute__((unused)),
-                                           struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)))
+                                           struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                           struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	return 0;
 }
@@ -1104,7 +1144,8 @@ static int d_tcp_parse_sack_perm_irreg(const struct rohc_decomp_ctxt *const cont
                                        const uint8_t *const data __attribute__((unused)),
                                        const size_t data_len __attribute__((unused)),
                                        const uint8_t opt_index __attribute__((unused)),
-                                       struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)))
+                                       struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                       struct d_tcp_opts_ctxt *const opts __attribute__((unused)))
 {
 	return 0;
 }
@@ -1142,12 +1183,13 @@ error:
 static int d_tcp_parse_sack_list_item(const struct rohc_decomp_ctxt *const context,
                                       const uint8_t *const data,
                                       const size_t data_len,
-                                      struct d_tcp_opt_ctxt *const opt_ctxt)
+                                      struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                      struct d_tcp_opts_ctxt *const opts)
 {
 	int ret;
 
 	/* parse the SACK blocks */
-	ret = d_tcp_sack_parse(context, data, data_len, &opt_ctxt->data.sack);
+	ret = d_tcp_sack_parse(context, data, data_len, &opts->sack);
 	if(ret < 0)
 	{
 		rohc_decomp_warn(context, "malformed ROHC packet: malformed TCP option "
@@ -1156,7 +1198,7 @@ static int d_tcp_parse_sack_list_item(const struct rohc_decomp_ctxt *const conte
 	}
 
 	/* unchanged encoding is only accepted in irregular chain */
-	if(opt_ctxt->data.sack.blocks_nr == 0)
+	if(opts->sack.blocks_nr == 0)
 	{
 		rohc_decomp_warn(context, "malformed ROHC packet: malformed TCP option "
 		                 "items: encoding with no SACK block is only allowed in "
@@ -1176,12 +1218,13 @@ static int d_tcp_parse_sack_irreg(const struct rohc_decomp_ctxt *const context,
                                   const uint8_t *const data,
                                   const size_t data_len,
                                   const uint8_t opt_index __attribute__((unused)),
-                                  struct d_tcp_opt_ctxt *const opt_ctxt)
+                                  struct d_tcp_opt_ctxt *const opt_ctxt __attribute__((unused)),
+                                  struct d_tcp_opts_ctxt *const opts)
 {
 	int ret;
 
 	/* parse the SACK blocks */
-	ret = d_tcp_sack_parse(context, data, data_len, &opt_ctxt->data.sack);
+	ret = d_tcp_sack_parse(context, data, data_len, &opts->sack);
 	if(ret < 0)
 	{
 		rohc_decomp_warn(context, "malformed ROHC packet: malformed TCP option "
@@ -1233,7 +1276,8 @@ error:
 static int d_tcp_parse_generic_list_item(const struct rohc_decomp_ctxt *const context,
                                          const uint8_t *const data,
                                          const size_t data_len,
-                                         struct d_tcp_opt_ctxt *const opt_ctxt)
+                                         struct d_tcp_opt_ctxt *const opt_ctxt,
+                                         struct d_tcp_opts_ctxt *const opts)
 {
 	const size_t opt_hdr_len = ROHC_TCP_OPT_HDR_LEN;
 	uint8_t opt_type;
@@ -1308,8 +1352,10 @@ static int d_tcp_parse_generic_list_item(const struct rohc_decomp_ctxt *const co
 			                 "from %u to %u", opt_ctxt->type, opt_type);
 			goto error;
 		}
-		if(opt_load_len != opt_ctxt->data.generic.load_len || /* TODO */
-		   memcmp(data + opt_hdr_len, opt_ctxt->data.generic.load, opt_load_len) != 0)
+		if(opt_ctxt->load_off == D_TCP_OPT_NO_LOAD ||
+		   opt_load_len != opt_ctxt->load_len || /* TODO */
+		   memcmp(data + opt_hdr_len, opts->arena + opt_ctxt->load_off,
+		          opt_load_len) != 0)
 		{
 			rohc_decomp_warn(context, "malformed TCP options list: malformed TCP "
 			                 "option items: payload of TCP generic option changed");
@@ -1319,8 +1365,12 @@ static int d_tcp_parse_generic_list_item(const struct rohc_decomp_ctxt *const co
 
 	/* save the option type and payload */
 	opt_ctxt->type = opt_type;
-	opt_ctxt->data.generic.load_len = opt_load_len;
-	memcpy(opt_ctxt->data.generic.load, data + opt_hdr_len, opt_load_len);
+	if(!d_tcp_opts_arena_store(opts, opt_ctxt, data + opt_hdr_len, opt_load_len))
+	{
+		rohc_decomp_warn(context, "failed to store the %u-byte payload of the TCP "
+		                 "generic option: no room left for it", opt_load_len);
+		goto error;
+	}
 	rohc_decomp_debug(context, "    TCP option payload = %u bytes", opt_load_len);
 
 	return opt_len;
@@ -1335,7 +1385,8 @@ static int d_tcp_parse_generic_irreg(const struct rohc_decomp_ctxt *const contex
                                      const uint8_t *const data,
                                      const size_t data_len,
                                      const uint8_t opt_index __attribute__((unused)),
-                                     struct d_tcp_opt_ctxt *const opt_ctxt)
+                                     struct d_tcp_opt_ctxt *const opt_ctxt,
+                                     struct d_tcp_opts_ctxt *const opts)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	const struct d_tcp_opt_ctxt *persist;
@@ -1384,7 +1435,7 @@ static int d_tcp_parse_generic_irreg(const struct rohc_decomp_ctxt *const contex
 			 *   contents      =:=
 			 *     irregular(length_lsb.UVALUE*8-16) [ length_lsb.UVALUE*8-16 ];
 			 */
-			const size_t opt_load_len = persist->data.generic.load_len;
+			const size_t opt_load_len = persist->load_len;
 
 			if(data_len < (read + opt_load_len))
 			{
@@ -1395,9 +1446,14 @@ static int d_tcp_parse_generic_irreg(const struct rohc_decomp_ctxt *const contex
 				goto error;
 			}
 			opt_ctxt->data.generic.type = TCP_GENERIC_OPT_FULL;
-			opt_ctxt->data.generic.load_len = opt_load_len;
 			assert(opt_load_len <= ROHC_TCP_OPT_MAX_LEN);
-			memcpy(opt_ctxt->data.generic.load, data + read, opt_load_len);
+			if(!d_tcp_opts_arena_store(opts, opt_ctxt, data + read, opt_load_len))
+			{
+				rohc_decomp_warn(context, "failed to store the %zu-byte payload of "
+				                 "the TCP generic option: no room left for it",
+				                 opt_load_len);
+				goto error;
+			}
 			read += opt_load_len;
 			rohc_decomp_debug(context, "TCP generic option payload = %zu bytes",
 			                  opt_load_len);
@@ -1421,13 +1477,13 @@ error:
 
 /* TODO */
 static bool d_tcp_build_generic(const struct rohc_decomp_ctxt *const context,
-                                const struct rohc_tcp_decoded_values *const decoded __attribute__((unused)),
+                                const struct rohc_tcp_decoded_values *const decoded,
                                 const struct d_tcp_opt_ctxt *const tcp_opt,
                                 struct rohc_buf *const uncomp_packet,
                                 size_t *const opt_len)
 {
 	const uint8_t opt_type = tcp_opt->type;
-	const size_t load_len = tcp_opt->data.generic.load_len;
+	const size_t load_len = tcp_opt->load_len;
 	const size_t generic_len = 2 + load_len;
 
 	if(rohc_buf_avail_len(*uncomp_packet) < generic_len)
@@ -1440,7 +1496,9 @@ static bool d_tcp_build_generic(const struct rohc_decomp_ctxt *const context,
 	rohc_buf_byte_at(*uncomp_packet, 0) = opt_type;
 	rohc_buf_byte_at(*uncomp_packet, 1) = generic_len;
 	uncomp_packet->len += 2;
-	rohc_buf_append(uncomp_packet, tcp_opt->data.generic.load, load_len);
+	assert(tcp_opt->load_off != D_TCP_OPT_NO_LOAD);
+	rohc_buf_append(uncomp_packet, decoded->tcp_opts.arena + tcp_opt->load_off,
+	                load_len);
 	*opt_len = generic_len;
 
 	return true;
@@ -1462,6 +1520,31 @@ bool d_tcp_build_tcp_opts(const struct rohc_decomp_ctxt *const context,
 
 	*opts_len = 0;
 
+	/* same TCP options as the previous packet: copy the options that were
+	 * built for it, then update the TS and SACK values in place */
+	if(decoded->tcp_opts_block_reused)
+	{
+		const struct d_tcp_context *const tcp_context = context->persist_ctxt;
+		const struct d_tcp_opts_block *const block = &(tcp_context->tcp_opts_block);
+
+		assert(block->is_valid);
+		if(rohc_buf_avail_len(*uncomp_packet) < block->len)
+		{
+			rohc_decomp_warn(context, "output buffer too small for the %u-byte "
+			                 "TCP options", block->len);
+			goto error;
+		}
+		rohc_buf_append(uncomp_packet, block->data, block->len);
+		d_tcp_opts_block_patch(block, decoded, rohc_buf_data(*uncomp_packet));
+		rohc_buf_pull(uncomp_packet, block->len);
+		*opts_len = block->len;
+
+		rohc_decomp_debug(context, "  %u TCP options rebuilt on %zu bytes from "
+		                  "the options of the previous packet",
+		                  decoded->tcp_opts.nr, *opts_len);
+		return true;
+	}
+
 	for(i = 0; i < decoded->tcp_opts.nr; i++)
 	{
 		const uint8_t opt_index = decoded->tcp_opts.structure[i];
@@ -1518,3 +1601,399 @@ error:
 	return false;
 }
 
+
+/**
+ * @brief Store the payload of one generic TCP option in the arena of a list
+ *
+ * The payload overwrites the previous payload of the option if they have the
+ * same length, otherwise it is appended at the end of the arena. When there is
+ * no room left, the arena is compacted and the payloads of the options that
+ * are not part of the list structure are dropped, the oldest ones first.
+ *
+ * @param opts      The list of TCP options that owns the arena
+ * @param opt       The generic TCP option of the list
+ * @param load      The payload of the generic TCP option
+ * @param load_len  The length of the payload
+ * @return          true if the payload was stored,
+ *                  false if there is no room for it in the arena
+ */
+bool d_tcp_opts_arena_store(struct d_tcp_opts_ctxt *const opts,
+                            struct d_tcp_opt_ctxt *const opt,
+                            const uint8_t *const load,
+                            const size_t load_len)
+{
+	assert(load_len <= ROHC_TCP_OPT_MAX_LEN);
+
+	if(opt->load_off != D_TCP_OPT_NO_LOAD && opt->load_len == load_len)
+	{
+		memcpy(opts->arena + opt->load_off, load, load_len);
+		return true;
+	}
+	opt->load_off = D_TCP_OPT_NO_LOAD;
+
+	if(load_len > (D_TCP_OPTS_ARENA_LEN - opts->arena_len))
+	{
+		d_tcp_opts_arena_compact(opts);
+	}
+	while(load_len > (D_TCP_OPTS_ARENA_LEN - opts->arena_len))
+	{
+		if(!d_tcp_opts_arena_evict(opts))
+		{
+			return false;
+		}
+		d_tcp_opts_arena_compact(opts);
+	}
+
+	memcpy(opts->arena + opts->arena_len, load, load_len);
+	opt->load_off = opts->arena_len;
+	opt->load_len = load_len;
+	opts->arena_len += load_len;
+
+	return true;
+}
+
+
+/**
+ * @brief Update the TCP options of the context with the decoded ones
+ *
+ * The payloads of the generic options are copied in the arena of the context.
+ * The payloads of the generic options that are not part of the new list are
+ * kept as long as there is room for them, since the compressor may reference
+ * them again later.
+ *
+ * @param ctxt_opts  The TCP options of the context
+ * @param new_opts   The TCP options decoded from the ROHC packet
+ */
+void d_tcp_opts_update_ctxt(struct d_tcp_opts_ctxt *const ctxt_opts,
+                            const struct d_tcp_opts_ctxt *const new_opts)
+{
+	uint16_t structure_idxs = 0;
+	size_t i;
+
+	ctxt_opts->nr = new_opts->nr;
+	memcpy(&ctxt_opts->structure, &new_opts->structure,
+	       sizeof(uint8_t) * ROHC_TCP_OPTS_MAX);
+	memcpy(&ctxt_opts->expected_dynamic, &new_opts->expected_dynamic,
+	       sizeof(bool) * ROHC_TCP_OPTS_MAX);
+	memcpy(&ctxt_opts->found, &new_opts->found, sizeof(bool) * ROHC_TCP_OPTS_MAX);
+	for(i = 0; i < new_opts->nr; i++)
+	{
+		structure_idxs |= (1U << new_opts->structure[i]);
+	}
+
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		struct d_tcp_opt_ctxt *const opt = &(ctxt_opts->bits[i]);
+		const struct d_tcp_opt_ctxt *const new_opt = &(new_opts->bits[i]);
+
+		if(i < TCP_INDEX_GENERIC7)
+		{
+			if(new_opt->used)
+			{
+				memcpy(opt, new_opt, sizeof(struct d_tcp_opt_ctxt));
+			}
+		}
+		else
+		{
+			/* the payload is not copied with the option: it points in the arena
+			 * of the decoded options, not in the one of the context */
+			const uint8_t load_off = opt->load_off;
+			const uint8_t load_len = opt->load_len;
+			const uint8_t load_age = opt->load_age;
+
+			if(new_opt->used)
+			{
+				memcpy(opt, new_opt, sizeof(struct d_tcp_opt_ctxt));
+				opt->load_off = load_off;
+				opt->load_len = load_len;
+				opt->load_age = load_age;
+				/* forget the previous payload if the new one cannot overwrite it */
+				if(new_opt->load_off != D_TCP_OPT_NO_LOAD &&
+				   new_opt->load_len != load_len)
+				{
+					opt->load_off = D_TCP_OPT_NO_LOAD;
+				}
+			}
+			if((structure_idxs & (1U << i)) != 0)
+			{
+				opt->load_age = 0;
+			}
+			else if(opt->load_age < 0xff)
+			{
+				opt->load_age++;
+			}
+		}
+	}
+
+	/* the payloads of the options of one packet always fit in the arena once
+	 * the payloads of the other options were dropped */
+	for(i = 0; i < new_opts->nr; i++)
+	{
+		const uint8_t opt_index = new_opts->structure[i];
+		const struct d_tcp_opt_ctxt *const new_opt = &(new_opts->bits[opt_index]);
+
+		if(opt_index >= TCP_INDEX_GENERIC7 &&
+		   new_opt->load_off != D_TCP_OPT_NO_LOAD &&
+		   !d_tcp_opts_arena_store(ctxt_opts, &(ctxt_opts->bits[opt_index]),
+		                           new_opts->arena + new_opt->load_off,
+		                           new_opt->load_len))
+		{
+			assert(0);
+		}
+	}
+}
+
+
+/**
+ * @brief Drop the oldest payload of the arena that is not part of the list
+ *
+ * @param opts  The list of TCP options that owns the arena
+ * @return      true if one payload was dropped, false if all the payloads
+ *              belong to options of the list
+ */
+static bool d_tcp_opts_arena_evict(struct d_tcp_opts_ctxt *const opts)
+{
+	struct d_tcp_opt_ctxt *oldest = NULL;
+	uint16_t structure_idxs = 0;
+	size_t i;
+
+	for(i = 0; i < opts->nr; i++)
+	{
+		structure_idxs |= (1U << opts->structure[i]);
+	}
+	for(i = TCP_INDEX_GENERIC7; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		struct d_tcp_opt_ctxt *const opt = &(opts->bits[i]);
+
+		if(opt->load_off != D_TCP_OPT_NO_LOAD &&
+		   (structure_idxs & (1U << i)) == 0 &&
+		   (oldest == NULL || opt->load_age > oldest->load_age))
+		{
+			oldest = opt;
+		}
+	}
+	if(oldest == NULL)
+	{
+		return false;
+	}
+	oldest->load_off = D_TCP_OPT_NO_LOAD;
+
+	return true;
+}
+
+
+/**
+ * @brief Move the payloads of the arena at its beginning, without holes
+ *
+ * @param opts  The list of TCP options that owns the arena
+ */
+static void d_tcp_opts_arena_compact(struct d_tcp_opts_ctxt *const opts)
+{
+	uint8_t arena[D_TCP_OPTS_ARENA_LEN];
+	uint8_t arena_len = 0;
+	size_t i;
+
+	for(i = TCP_INDEX_GENERIC7; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		struct d_tcp_opt_ctxt *const opt = &(opts->bits[i]);
+
+		if(opt->load_off != D_TCP_OPT_NO_LOAD)
+		{
+			memcpy(arena + arena_len, opts->arena + opt->load_off, opt->load_len);
+			opt->load_off = arena_len;
+			arena_len += opt->load_len;
+		}
+	}
+	memcpy(opts->arena, arena, arena_len);
+	opts->arena_len = arena_len;
+}
+
+
+/**
+ * @brief Whether the TCP options of the previous packet may be reused
+ *
+ * The TCP options of the previous packet may be reused if the new packet
+ * got the very same list of TCP options with the very same values, except
+ * for the TS values and the SACK blocks that are updated in place.
+ *
+ * @param context  The decompression context
+ * @param decoded  The values decoded from the ROHC packet
+ * @return         true if the options of the previous packet may be reused,
+ *                 false if all the TCP options shall be built again
+ */
+bool d_tcp_opts_block_match(const struct rohc_decomp_ctxt *const context,
+                            const struct rohc_tcp_decoded_values *const decoded)
+{
+	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	const struct d_tcp_opts_block *const block = &(tcp_context->tcp_opts_block);
+	const struct d_tcp_opts_ctxt *const ctxt_opts = &(tcp_context->tcp_opts);
+	size_t i;
+
+	if(!block->is_valid || decoded->tcp_opts.nr != ctxt_opts->nr)
+	{
+		return false;
+	}
+
+	for(i = 0; i < decoded->tcp_opts.nr; i++)
+	{
+		const uint8_t opt_index = decoded->tcp_opts.structure[i];
+		const struct d_tcp_opt_ctxt *const new_opt = &(decoded->tcp_opts.bits[opt_index]);
+		const struct d_tcp_opt_ctxt *const old_opt = &(ctxt_opts->bits[opt_index]);
+
+		if(opt_index != ctxt_opts->structure[i] ||
+		   !decoded->tcp_opts.found[i] ||
+		   !old_opt->used ||
+		   new_opt->type != old_opt->type)
+		{
+			return false;
+		}
+
+		switch(opt_index)
+		{
+			case TCP_INDEX_NOP:
+			case TCP_INDEX_SACK_PERM:
+			case TCP_INDEX_TS:
+				break;
+			case TCP_INDEX_EOL:
+				if(new_opt->data.eol.len != old_opt->data.eol.len)
+				{
+					return false;
+				}
+				break;
+			case TCP_INDEX_MSS:
+				if(new_opt->data.mss.value != old_opt->data.mss.value)
+				{
+					return false;
+				}
+				break;
+			case TCP_INDEX_WS:
+				if(new_opt->data.ws.value != old_opt->data.ws.value)
+				{
+					return false;
+				}
+				break;
+			case TCP_INDEX_SACK:
+				if(decoded->opt_sack_blocks.blocks_nr != block->sack_blocks_nr)
+				{
+					return false;
+				}
+				break;
+			default:
+				if(old_opt->load_off == D_TCP_OPT_NO_LOAD ||
+				   new_opt->load_len != old_opt->load_len ||
+				   memcmp(decoded->tcp_opts.arena + new_opt->load_off,
+				          ctxt_opts->arena + old_opt->load_off,
+				          new_opt->load_len) != 0)
+				{
+					return false;
+				}
+				break;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Update the block of TCP options with the options of the new packet
+ *
+ * If the block was reused for the new packet, only the TS values and the SACK
+ * blocks are updated. Otherwise, all the TCP options are built again in the
+ * block. The block is marked as invalid if it cannot be built.
+ *
+ * @param context  The decompression context
+ * @param decoded  The values decoded from the ROHC packet
+ * @param block    The block of TCP options to update
+ */
+void d_tcp_opts_block_update(const struct rohc_decomp_ctxt *const context,
+                             const struct rohc_tcp_decoded_values *const decoded,
+                             struct d_tcp_opts_block *const block)
+{
+	struct rohc_buf opts = rohc_buf_init_empty(block->data, ROHC_TCP_OPTS_LEN_MAX_PROTO);
+	size_t opts_len = 0;
+	size_t i;
+
+	if(decoded->tcp_opts_block_reused)
+	{
+		d_tcp_opts_block_patch(block, decoded, block->data);
+		return;
+	}
+
+	block->is_valid = false;
+	block->is_ts_present = false;
+	block->is_sack_present = false;
+	block->sack_blocks_nr = 0;
+
+	for(i = 0; i < decoded->tcp_opts.nr; i++)
+	{
+		const uint8_t opt_index = decoded->tcp_opts.structure[i];
+		const struct d_tcp_opt_ctxt *const tcp_opt = &(decoded->tcp_opts.bits[opt_index]);
+		size_t opt_len;
+
+		if(!decoded->tcp_opts.found[i])
+		{
+			return;
+		}
+
+		/* TS and SACK options are updated in place, so they shall appear
+		 * at most once in the list */
+		if(opt_index == TCP_INDEX_TS)
+		{
+			if(block->is_ts_present)
+			{
+				return;
+			}
+			block->is_ts_present = true;
+			block->ts_off = opts_len;
+		}
+		else if(opt_index == TCP_INDEX_SACK)
+		{
+			if(block->is_sack_present)
+			{
+				return;
+			}
+			block->is_sack_present = true;
+			block->sack_off = opts_len;
+			block->sack_blocks_nr = decoded->opt_sack_blocks.blocks_nr;
+		}
+
+		if(!d_tcp_opts[opt_index].build(context, decoded, tcp_opt, &opts, &opt_len))
+		{
+			return;
+		}
+		rohc_buf_pull(&opts, opt_len);
+		opts_len += opt_len;
+	}
+
+	block->len = opts_len;
+	block->is_valid = true;
+}
+
+
+/**
+ * @brief Write the TS values and the SACK blocks of the new packet in the
+ *        given TCP options
+ *
+ * @param block    The block of TCP options the options were copied from
+ * @param decoded  The values decoded from the ROHC packet
+ * @param opts     The TCP options to update
+ */
+static void d_tcp_opts_block_patch(const struct d_tcp_opts_block *const block,
+                                   const struct rohc_tcp_decoded_values *const decoded,
+                                   uint8_t *const opts)
+{
+	if(block->is_ts_present)
+	{
+		const struct tcp_option_timestamp ts_load = {
+			.ts = rohc_hton32(decoded->opt_ts_req),
+			.ts_reply = rohc_hton32(decoded->opt_ts_rep)
+		};
+		memcpy(opts + block->ts_off + 2, &ts_load, sizeof(struct tcp_option_timestamp));
+	}
+	if(block->is_sack_present)
+	{
+		memcpy(opts + block->sack_off + 2, decoded->opt_sack_blocks.blocks,
+		       sizeof(sack_block_t) * block->sack_blocks_nr);
+	}
+}
@@ -55,5 +55,24 @@ bool d_tcp_build_tcp_opts(const struct rohc_decomp_ctxt *const context,
                           size_t *const opts_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
+bool d_tcp_opts_block_match(const struct rohc_decomp_ctxt *const context,
+                            const struct rohc_tcp_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool d_tcp_opts_arena_store(struct d_tcp_opts_ctxt *const opts,
+                            struct d_tcp_opt_ctxt *const opt,
+                            const uint8_t *const load,
+                            const size_t load_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+void d_tcp_opts_update_ctxt(struct d_tcp_opts_ctxt *const ctxt_opts,
+                            const struct d_tcp_opts_ctxt *const new_opts)
+	__attribute__((nonnull(1, 2)));
+
+void d_tcp_opts_block_update(const struct rohc_decomp_ctxt *const context,
+                             const struct rohc_tcp_decoded_values *const decoded,
+                             struct d_tcp_opts_block *const block)
+	__attribute__((nonnull(1, 2, 3)));
+
 #endif /* ROHC_DECOMP_TCP_OPTS_LIST_H */
 
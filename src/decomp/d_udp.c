@@ -63,10 +63,6 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 static int udp_parse_dynamic_udp(const struct rohc_decomp_ctxt *const context,
                                  const uint8_t *packet,
                                  const size_t length,
@@ -111,33 +107,16 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = *persist_ctxt;
 	struct d_udp_context *udp_context;
 
 	assert(context->decompressor != NULL);
 	assert(context->profile != NULL);
 
-	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
-	                               context->decompressor->trace_callback,
-	                               context->decompressor->trace_callback_priv,
-	                               context->profile->id))
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "failed to create the generic decompression context");
-		goto quit;
-	}
-	rfc3095_ctxt = *persist_ctxt;
-
-	/* create the UDP-specific part of the context */
-	udp_context = calloc(1, sizeof(struct d_udp_context));
-	if(udp_context == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-specific context");
-		goto destroy_context;
-	}
-	rfc3095_ctxt->specific = udp_context;
+	/* create the generic context and the UDP-specific part of the context */
+	rohc_decomp_rfc3095_create(context, rfc3095_ctxt, volat_ctxt,
+	                           sizeof(struct d_udp_context), sizeof(struct udphdr));
+	udp_context = rfc3095_ctxt->specific;
 
 	/* create the LSB decoding context for SN */
 	rohc_lsb_init(&rfc3095_ctxt->sn_lsb_ctxt, 16);
@@ -147,7 +126,6 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	udp_context->udp_check_present = ROHC_TRISTATE_NONE;
 
 	/* some UDP-specific values and functions */
-	rfc3095_ctxt->next_header_len = sizeof(struct udphdr);
 	rfc3095_ctxt->parse_static_next_hdr = udp_parse_static_udp;
 	rfc3095_ctxt->parse_dyn_next_hdr = udp_parse_dynamic_udp;
 	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
@@ -158,63 +136,10 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = udp_update_context;
 
-	/* create the UDP-specific part of the header changes */
-	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = calloc(1, sizeof(struct udphdr));
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-specific part of the "
-		           "outer IP header changes");
-		goto free_udp_context;
-	}
-
-	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = calloc(1, sizeof(struct udphdr));
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-specific part of the "
-		           "inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-
 	/* set next header to UDP */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_UDP;
 
 	return true;
-
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_udp_context:
-	zfree(udp_context);
-destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
-quit:
-	return false;
-}
-
-
-/**
- * @brief Destroy the context.
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
- */
-static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	/* clean UDP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-
-	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -575,14 +500,20 @@ const struct rohc_decomp_profile d_udp_profile =
 {
 	.id              = ROHC_PROFILE_UDP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_len   = ROHC_DECOMP_RFC3095_CTXT_LEN(sizeof(struct d_udp_context),
+	                                                   sizeof(struct udphdr)),
+	.extr_bits_len      = sizeof(struct rohc_extr_bits),
+	.decoded_values_len = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_udp_create,
-	.free_context    = (rohc_decomp_free_context_t) d_udp_destroy,
+	.free_context    = rohc_decomp_rfc3095_free,
 	.detect_pkt_type = ip_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) rfc3095_decomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) rfc3095_decomp_build_hdrs,
+	.decode_fast     = (rohc_decomp_decode_fast_t) rfc3095_decomp_decode_fast,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.get_decoded_sn  = (rohc_decomp_get_decoded_sn_t) rohc_decomp_rfc3095_get_decoded_sn,
 };
 
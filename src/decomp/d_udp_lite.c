@@ -74,10 +74,6 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 static rohc_packet_t udp_lite_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                                  const uint8_t *const rohc_packet,
                                                  const size_t rohc_length,
@@ -141,33 +137,16 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
                               struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = *persist_ctxt;
 	struct d_udp_lite_context *udp_lite_context;
 
 	assert(context->decompressor != NULL);
 	assert(context->profile != NULL);
 
-	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
-	                               context->decompressor->trace_callback,
-	                               context->decompressor->trace_callback_priv,
-	                               context->profile->id))
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "failed to create the generic decompression context");
-		goto quit;
-	}
-	rfc3095_ctxt = *persist_ctxt;
-
-	/* create the UDP-Lite-specific part of the context */
-	udp_lite_context = calloc(1, sizeof(struct d_udp_lite_context));
-	if(udp_lite_context == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-Lite-specific context");
-		goto destroy_context;
-	}
-	rfc3095_ctxt->specific = udp_lite_context;
+	/* create the generic context and the UDP-Lite-specific part of the context */
+	rohc_decomp_rfc3095_create(context, rfc3095_ctxt, volat_ctxt,
+	                           sizeof(struct d_udp_lite_context), sizeof(struct udphdr));
+	udp_lite_context = rfc3095_ctxt->specific;
 
 	/* create the LSB decoding context for SN */
 	rohc_lsb_init(&rfc3095_ctxt->sn_lsb_ctxt, 16);
@@ -178,7 +157,6 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	udp_lite_context->cfi = ROHC_TRISTATE_NONE;
 
 	/* some UDP-Lite-specific values and functions */
-	rfc3095_ctxt->next_header_len = sizeof(struct udphdr);
 	rfc3095_ctxt->parse_static_next_hdr = udp_parse_static_udp;
 	rfc3095_ctxt->parse_dyn_next_hdr = udp_lite_parse_dynamic_udp;
 	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
@@ -189,63 +167,10 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
 	rfc3095_ctxt->update_context = udp_lite_update_context;
 
-	/* create the UDP-Lite-specific part of the header changes */
-	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = calloc(1, sizeof(struct udphdr));
-	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-Lite-specific part "
-		           "of the outer IP header changes");
-		goto free_udp_context;
-	}
-
-	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = calloc(1, sizeof(struct udphdr));
-	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the UDP-Lite-specific part "
-		           "of the inner IP header changes");
-		goto free_outer_ip_changes_next_header;
-	}
-
 	/* set next header to UDP-Lite */
 	rfc3095_ctxt->next_header_proto = ROHC_IPPROTO_UDPLITE;
 
 	return true;
-
-free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_udp_context:
-	zfree(udp_lite_context);
-destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
-quit:
-	return false;
-}
-
-
-/**
- * @brief Destroy the context.
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
- */
-static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	/* clean UDP-specific memory */
-	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
-
-	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 }
 
 
@@ -768,8 +693,12 @@ const struct rohc_decomp_profile d_udplite_profile =
 {
 	.id              = ROHC_PROFILE_UDPLITE, /* profile ID (RFC 4019, §7) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_len   = ROHC_DECOMP_RFC3095_CTXT_LEN(sizeof(struct d_udp_lite_context),
+	                                                   sizeof(struct udphdr)),
+	.extr_bits_len      = sizeof(struct rohc_extr_bits),
+	.decoded_values_len = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_udp_lite_create,
-	.free_context    = (rohc_decomp_free_context_t) d_udp_lite_destroy,
+	.free_context    = rohc_decomp_rfc3095_free,
 	.detect_pkt_type = udp_lite_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) d_udp_lite_parse,
 	.decode_bits     = (rohc_decomp_decode_bits_t) rfc3095_decomp_decode_bits,
@@ -777,5 +706,6 @@ const struct rohc_decomp_profile d_udplite_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.get_decoded_sn  = (rohc_decomp_get_decoded_sn_t) rohc_decomp_rfc3095_get_decoded_sn,
 };
 
@@ -63,10 +63,6 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
                                struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void uncomp_free_context(void *const persist_ctxt,
-                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
-
 static rohc_packet_t uncomp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
@@ -152,52 +148,14 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
 {
 	assert(context->profile->id == ROHC_PROFILE_UNCOMPRESSED);
 
-	/* persistent part */
-	*persist_ctxt = NULL;
+	/* no persistent part */
+	assert((*persist_ctxt) == NULL);
 
 	/* volatile part */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_uncomp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto error;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_uncomp_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto free_extr_bits;
-	}
 
 	return true;
-
-free_extr_bits:
-	free(volat_ctxt->extr_bits);
-error:
-	return false;
-}
-
-
-/**
- * @brief Destroy profile-specific data, nothing to destroy for the
- *        uncompressed profile.
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param persist_ctxt  The persistent part of the decompression context
- * @param volat_ctxt    The volatile part of the decompression context
- */
-static void uncomp_free_context(void *const persist_ctxt,
-                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	assert(persist_ctxt == NULL);
-	free(volat_ctxt->extr_bits);
-	free(volat_ctxt->decoded_values);
 }
 
 
@@ -548,8 +506,12 @@ const struct rohc_decomp_profile d_uncomp_profile =
 {
 	.id              = ROHC_PROFILE_UNCOMPRESSED, /* profile ID (RFC3095 §8) */
 	.msn_max_bits    = 0, /* no MSN */
+	.persist_ctxt_len   = 0, /* no persistent context */
+	.persist_ctxt_is_flat = true,
+	.extr_bits_len      = sizeof(struct rohc_uncomp_extr_bits),
+	.decoded_values_len = sizeof(struct rohc_uncomp_decoded),
 	.new_context     = uncomp_new_context,
-	.free_context    = uncomp_free_context,
+	.free_context    = NULL,
 	.detect_pkt_type = uncomp_detect_pkt_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) uncomp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) uncomp_decode_bits,
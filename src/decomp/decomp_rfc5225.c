@@ -0,0 +1,589 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   decomp_rfc5225.c
+ * @brief  Functions shared by the ROHCv2 decompression profiles
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "decomp_rfc5225.h"
+#include "rohc_traces_internal.h"
+#include "rohc_decomp_detect_packet.h"
+#include "protocols/ip_numbers.h"
+#include "protocols/ip.h"
+#include "protocols/rfc5225.h"
+#include "rohc_bit_ops.h"
+
+#include <string.h>
+#include <assert.h>
+
+
+static bool decomp_rfc5225_build_ip_hdr(const struct rohc_decomp_ctxt *const ctxt,
+                                        const struct rohc_rfc5225_decoded_ip *const decoded,
+                                        struct rohc_buf *const uncomp_pkt,
+                                        size_t *const ip_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static bool decomp_rfc5225_build_ipv4_hdr(const struct rohc_decomp_ctxt *const ctxt,
+                                          const struct rohc_rfc5225_decoded_ip *const decoded,
+                                          struct rohc_buf *const uncomp_pkt,
+                                          size_t *const ip_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static bool decomp_rfc5225_build_ipv6_hdr(const struct rohc_decomp_ctxt *const ctxt,
+                                          const struct rohc_rfc5225_decoded_ip *const decoded,
+                                          struct rohc_buf *const uncomp_pkt,
+                                          size_t *const ip_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+
+/**
+ * @brief Detect the type of ROHC packet for the ROHCv2 profiles
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param context        The decompression context
+ * @param rohc_packet    The ROHC packet
+ * @param rohc_length    The length of the ROHC packet
+ * @param large_cid_len  The length of the optional large CID field
+ * @return               The packet type
+ */
+rohc_packet_t decomp_rfc5225_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
+                                             const uint8_t *const rohc_packet,
+                                             const size_t rohc_length,
+                                             const size_t large_cid_len __attribute__((unused)))
+{
+	rohc_packet_t type;
+
+	/* at least one byte required to check discriminator byte in packet
+	 * (already checked by rohc_decomp_find_context) */
+	assert(rohc_length >= 1);
+
+	rohc_decomp_debug(context, "try to determine the header from first byte "
+	                  "0x%02x", rohc_packet[0]);
+
+	type = rohc_decomp_rfc5225_pkt_types[rohc_packet[0]];
+
+	return type;
+}
+
+
+/**
+ * @brief Decode the static IP header of the ROHC packet
+ *
+ * @param ctxt               The decompression context
+ * @param rohc_pkt           The remaining part of the ROHC packet
+ * @param rohc_len           The remaining length (in bytes) of the ROHC packet
+ * @param[out] ip_bits       The bits extracted from the IP part of the static chain
+ * @param[out] is_innermost  Whether the IP header is the innermost IP header
+ * @return                   The length of static IP header in case of success,
+ *                           -1 if an error occurs
+ */
+int decomp_rfc5225_parse_static_ip(const struct rohc_decomp_ctxt *const ctxt,
+                                   const uint8_t *const rohc_pkt,
+                                   const size_t rohc_len,
+                                   struct rohc_rfc5225_ip_bits *const ip_bits,
+                                   bool *const is_innermost)
+{
+	const uint8_t *remain_data = rohc_pkt;
+	size_t remain_len = rohc_len;
+	size_t read = 0;
+
+	rohc_decomp_debug(ctxt, "parse IP static part");
+
+	/* at least 1 byte required to read the version flag */
+	if(remain_len < 1)
+	{
+		rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for the "
+		                 "version flag of the IP static part");
+		goto error;
+	}
+
+	/* parse IPv4 static part or IPv6 static part? */
+	if(GET_BIT_7(remain_data) == 0)
+	{
+		const ipv4_static_t *const ipv4_static = (ipv4_static_t *) remain_data;
+
+		rohc_decomp_debug(ctxt, "  IPv4 static part");
+		ip_bits->version = IPV4;
+
+		if(remain_len < sizeof(ipv4_static_t))
+		{
+			rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for the "
+			                 "IPv4 static part");
+			goto error;
+		}
+
+		*is_innermost = !!(ipv4_static->innermost_ip == 1);
+		if(ipv4_static->reserved != 0)
+		{
+			rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field is not "
+			                 "zero, but 0x%x", ipv4_static->reserved);
+			goto error;
+		}
+		ip_bits->proto = ipv4_static->protocol;
+		ip_bits->proto_nr = 8;
+		memcpy(ip_bits->saddr, &ipv4_static->src_addr, sizeof(uint32_t));
+		ip_bits->saddr_nr = 32;
+		memcpy(ip_bits->daddr, &ipv4_static->dst_addr, sizeof(uint32_t));
+		ip_bits->daddr_nr = 32;
+
+		/* IP extension headers not supported for IPv4 */
+		/* TODO: handle IP extension headers */
+
+		read += sizeof(ipv4_static_t);
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+		remain_data += sizeof(ipv4_static_t);
+		remain_len -= sizeof(ipv4_static_t);
+#endif
+	}
+	else
+	{
+		rohc_decomp_debug(ctxt, "  IPv6 static part");
+		ip_bits->version = IPV6;
+
+		/* static with or without flow label? */
+		if(GET_BIT_4(remain_data) == 0)
+		{
+			const ipv6_static_nofl_t *const ipv6_static =
+				(ipv6_static_nofl_t *) remain_data;
+
+			if(remain_len < sizeof(ipv6_static_nofl_t))
+			{
+				rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for "
+				                 "the IPv6 static part");
+				goto error;
+			}
+
+			*is_innermost = !!(ipv6_static->innermost_ip == 1);
+			if(ipv6_static->reserved1 != 0)
+			{
+				rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field #1 is "
+				                 "not zero, but 0x%x", ipv6_static->reserved1);
+				goto error;
+			}
+			if(ipv6_static->reserved2 != 0)
+			{
+				rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field #2 is "
+				                 "not zero, but 0x%x", ipv6_static->reserved2);
+				goto error;
+			}
+			ip_bits->flowid = 0;
+			ip_bits->flowid_nr = 20;
+			ip_bits->proto = ipv6_static->next_header;
+			ip_bits->proto_nr = 8;
+			memcpy(ip_bits->saddr, &ipv6_static->src_addr, sizeof(uint32_t) * 4);
+			ip_bits->saddr_nr = 128;
+			memcpy(ip_bits->daddr, &ipv6_static->dst_addr, sizeof(uint32_t) * 4);
+			ip_bits->daddr_nr = 128;
+
+			read += sizeof(ipv6_static_nofl_t);
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+			remain_data += sizeof(ipv6_static_nofl_t);
+			remain_len -= sizeof(ipv6_static_nofl_t);
+#endif
+		}
+		else
+		{
+			const ipv6_static_fl_t *const ipv6_static =
+				(ipv6_static_fl_t *) remain_data;
+
+			if(remain_len < sizeof(ipv6_static_fl_t))
+			{
+				rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for "
+				                 "the IPv6 static part");
+				goto error;
+			}
+
+			*is_innermost = !!(ipv6_static->innermost_ip == 1);
+			if(ipv6_static->reserved != 0)
+			{
+				rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field is "
+				                 "not zero, but 0x%x", ipv6_static->reserved);
+				goto error;
+			}
+			ip_bits->flowid = (ipv6_static->flow_label_msb << 16) |
+			                  rohc_ntoh16(ipv6_static->flow_label_lsb);
+			assert((ip_bits->flowid & 0xfffff) == ip_bits->flowid);
+			rohc_decomp_debug(ctxt, "  IPv6 flow label = 0x%05x", ip_bits->flowid);
+			ip_bits->flowid_nr = 20;
+			ip_bits->proto = ipv6_static->next_header;
+			ip_bits->proto_nr = 8;
+			memcpy(ip_bits->saddr, &ipv6_static->src_addr, sizeof(uint32_t) * 4);
+			ip_bits->saddr_nr = 128;
+			memcpy(ip_bits->daddr, &ipv6_static->dst_addr, sizeof(uint32_t) * 4);
+			ip_bits->daddr_nr = 128;
+
+			read += sizeof(ipv6_static_fl_t);
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+			remain_data += sizeof(ipv6_static_fl_t);
+			remain_len -= sizeof(ipv6_static_fl_t);
+#endif
+		}
+
+		/* TODO: handle IPv6 extension headers */
+	}
+	rohc_decomp_dump_buf(ctxt, "IP static part", rohc_pkt, read);
+
+	return read;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Decode the irregular IP header of the ROHC packet
+ *
+ * @param ctxt           The decompression context
+ * @param rohc_pkt       The remaining part of the ROHC packet
+ * @param rohc_len       The remaining length (in bytes) of the ROHC packet
+ * @param is_innermost   Whether the IP header is the innermost IP header or not
+ * @param ip_id_behavior The IP-ID behavior of the IP header
+ *                       (may be different from the context)
+ * @param outer_ip_flag  Whether the TOS/TC or TTL/HL fields of outer IP headers
+ *                       are present or not
+ * @param[out] ip_bits   The bits extracted from the IP part of the irregular chain
+ * @return               The length of dynamic IP header in case of success,
+ *                       -1 if an error occurs
+ */
+int decomp_rfc5225_parse_irreg_ip(const struct rohc_decomp_ctxt *const ctxt,
+                                  const uint8_t *const rohc_pkt,
+                                  const size_t rohc_len,
+                                  const bool is_innermost,
+                                  const rohc_ip_id_behavior_t ip_id_behavior,
+                                  const bool outer_ip_flag,
+                                  struct rohc_rfc5225_ip_bits *const ip_bits)
+{
+
+	const uint8_t *remain_data = rohc_pkt;
+	size_t remain_len = rohc_len;
+	size_t size = 0;
+
+	rohc_decomp_debug(ctxt, "parse IP irregular part");
+
+	/* the innermost IPv4 IP-ID is transmitted in full if it is random */
+	if(ip_bits->version == IPV4 && ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND)
+	{
+		uint16_t ip_id;
+
+		if(remain_len < sizeof(uint16_t))
+		{
+			rohc_decomp_warn(ctxt, "packet too short for random IP-ID: only "
+			                 "%zu bytes available while at least %zu bytes "
+			                 "required", remain_len, sizeof(uint16_t));
+			goto error;
+		}
+		memcpy(&ip_id, remain_data, sizeof(uint16_t));
+		remain_data += sizeof(uint16_t);
+		remain_len -= sizeof(uint16_t);
+		size += sizeof(uint16_t);
+		rohc_decomp_debug(ctxt, "read ip_id = 0x%04x (ip_id_behavior = %d)",
+		                  ip_id, ip_id_behavior);
+		ip_bits->id.bits = rohc_ntoh16(ip_id);
+		ip_bits->id.bits_nr = 16;
+		rohc_decomp_debug(ctxt, "new IP-ID = 0x%04x", ip_bits->id.bits);
+	}
+
+	/* the TOS/TC and TTL/HL fields of outer IP headers are transmitted in full
+	 * if the outer_ip_flag is set to 1 (ie. only in co_common header) */
+	if(!is_innermost && outer_ip_flag)
+	{
+		size_t tos_ttl_req_len = 2;
+
+		if(remain_len < tos_ttl_req_len)
+		{
+			rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for "
+			                 "TOS and TTL in IPv4 irregular part");
+			goto error;
+		}
+		ip_bits->tos_tc_bits = remain_data[0];
+		ip_bits->tos_tc_bits_nr = 8;
+		ip_bits->ttl_hl = remain_data[1];
+		ip_bits->ttl_hl_nr = 8;
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+		remain_data += tos_ttl_req_len;
+		remain_len -= tos_ttl_req_len;
+#endif
+		size += tos_ttl_req_len;
+		rohc_decomp_debug(ctxt, "TOS/TC = 0x%x, ttl_hopl = 0x%x",
+		                  ip_bits->tos_tc_bits, ip_bits->ttl_hl);
+	}
+
+	rohc_decomp_dump_buf(ctxt, "IP irregular part", rohc_pkt, size);
+
+	return size;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build all of the uncompressed IP headers
+ *
+ * Build all of the uncompressed IP headers - IPv4 or IPv6 - from the context
+ * and packet information.
+ *
+ * @param ctxt              The decompression context
+ * @param ip_decoded        The values decoded for the IP headers
+ * @param ip_nr             The number of IP headers
+ * @param[out] uncomp_pkt   The uncompressed packet being built
+ * @param[out] ip_hdrs_len  The length of all the IP headers (in bytes)
+ * @return                  true if IP headers were successfully built,
+ *                          false if the output \e uncomp_packet was not
+ *                          large enough
+ */
+bool decomp_rfc5225_build_ip_hdrs(const struct rohc_decomp_ctxt *const ctxt,
+                                  const struct rohc_rfc5225_decoded_ip *const ip_decoded,
+                                  const size_t ip_nr,
+                                  struct rohc_buf *const uncomp_pkt,
+                                  size_t *const ip_hdrs_len)
+{
+	size_t ip_hdr_nr;
+
+	assert(ip_nr > 0);
+
+	rohc_decomp_debug(ctxt, "build the %zu IP headers", ip_nr);
+
+	*ip_hdrs_len = 0;
+	for(ip_hdr_nr = 0; ip_hdr_nr < ip_nr; ip_hdr_nr++)
+	{
+		size_t ip_hdr_len = 0;
+
+		if(!decomp_rfc5225_build_ip_hdr(ctxt, &(ip_decoded[ip_hdr_nr]), uncomp_pkt,
+		                                &ip_hdr_len))
+		{
+			rohc_decomp_warn(ctxt, "failed to build uncompressed IP header #%zu",
+			                 ip_hdr_nr + 1);
+			goto error;
+		}
+		*ip_hdrs_len += ip_hdr_len;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one single uncompressed IP header
+ *
+ * Build one single uncompressed IP header - IPv4 or IPv6 - from the context
+ * and packet information.
+ *
+ * @param ctxt             The decompression context
+ * @param decoded          The values decoded from the ROHC packet
+ * @param[out] uncomp_pkt  The uncompressed packet being built
+ * @param[out] ip_hdr_len  The length of the IP header (in bytes)
+ * @return                 true if IP header was successfully built,
+ *                         false if the output \e uncomp_packet was not
+ *                         large enough
+ */
+static bool decomp_rfc5225_build_ip_hdr(const struct rohc_decomp_ctxt *const ctxt,
+                                        const struct rohc_rfc5225_decoded_ip *const decoded,
+                                        struct rohc_buf *const uncomp_pkt,
+                                        size_t *const ip_hdr_len)
+{
+	if(decoded->version == IPV4)
+	{
+		if(!decomp_rfc5225_build_ipv4_hdr(ctxt, decoded, uncomp_pkt,
+		                                  ip_hdr_len))
+		{
+			rohc_decomp_warn(ctxt, "failed to build uncompressed IPv4 header");
+			goto error;
+		}
+	}
+	else
+	{
+		if(!decomp_rfc5225_build_ipv6_hdr(ctxt, decoded, uncomp_pkt, ip_hdr_len))
+		{
+			rohc_decomp_warn(ctxt, "failed to build uncompressed IPv6 header");
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one single uncompressed IPv4 header
+ *
+ * Build one single uncompressed IPv4 header from the context and packet
+ * information.
+ *
+ * @param ctxt             The decompression context
+ * @param decoded          The values decoded from the ROHC packet
+ * @param[out] uncomp_pkt  The uncompressed packet being built
+ * @param[out] ip_hdr_len  The length of the IPv4 header (in bytes)
+ * @return                 true if IPv4 header was successfully built,
+ *                         false if the output \e uncomp_packet was not
+ *                         large enough
+ */
+static bool decomp_rfc5225_build_ipv4_hdr(const struct rohc_decomp_ctxt *const ctxt,
+                                          const struct rohc_rfc5225_decoded_ip *const decoded,
+                                          struct rohc_buf *const uncomp_pkt,
+                                          size_t *const ip_hdr_len)
+{
+	struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) rohc_buf_data(*uncomp_pkt);
+	const size_t hdr_len = sizeof(struct ipv4_hdr);
+
+	rohc_decomp_debug(ctxt, "  build %zu-byte IPv4 header", hdr_len);
+
+	if(rohc_buf_avail_len(*uncomp_pkt) < hdr_len)
+	{
+		rohc_decomp_warn(ctxt, "output buffer too small for the %zu-byte IPv4 "
+		                 "header", hdr_len);
+		goto error;
+	}
+
+	/* static part */
+	ipv4->version = decoded->version;
+	rohc_decomp_debug(ctxt, "    version = %u", ipv4->version);
+	ipv4->ihl = hdr_len / sizeof(uint32_t);
+	rohc_decomp_debug(ctxt, "    ihl = %u", ipv4->ihl);
+	ipv4->protocol = decoded->proto;
+	memcpy(&ipv4->saddr, decoded->saddr, 4);
+	rohc_decomp_debug(ctxt, "    src addr = 0x%08x", rohc_hton32(ipv4->saddr));
+	memcpy(&ipv4->daddr, decoded->daddr, 4);
+	rohc_decomp_debug(ctxt, "    dst addr = 0x%08x", rohc_hton32(ipv4->daddr));
+
+	/* dynamic part */
+	ipv4->frag_off = 0;
+	ipv4->df = decoded->df;
+	ipv4->tos = decoded->tos_tc;
+	ipv4->ttl = decoded->ttl;
+	rohc_decomp_debug(ctxt, "    TOS = 0x%02x, TTL = %u", ipv4->tos, ipv4->ttl);
+	/* IP-ID */
+	ipv4->id = rohc_hton16(decoded->id);
+	rohc_decomp_debug(ctxt, "    %s IP-ID = 0x%04x",
+	                  rohc_ip_id_behavior_get_descr(decoded->id_behavior),
+	                  rohc_ntoh16(ipv4->id));
+
+	/* length and checksums will be computed once all headers are built */
+
+	/* skip IPv4 header */
+	uncomp_pkt->len += hdr_len;
+	rohc_buf_pull(uncomp_pkt, hdr_len);
+	*ip_hdr_len += hdr_len;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one single uncompressed IPv6 header
+ *
+ * Build one single uncompressed IPv6 header - including IPv6 extension
+ * headers - from the context and packet information.
+ *
+ * @param ctxt             The decompression context
+ * @param decoded          The values decoded from the ROHC packet
+ * @param[out] uncomp_pkt  The uncompressed packet being built
+ * @param[out] ip_hdr_len  The length of the IPv6 header (in bytes)
+ * @return                 true if IPv6 header was successfully built,
+ *                         false if the output \e uncomp_packet was not
+ *                         large enough
+ */
+static bool decomp_rfc5225_build_ipv6_hdr(const struct rohc_decomp_ctxt *const ctxt,
+                                          const struct rohc_rfc5225_decoded_ip *const decoded,
+                                          struct rohc_buf *const uncomp_pkt,
+                                          size_t *const ip_hdr_len)
+{
+	struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) rohc_buf_data(*uncomp_pkt);
+	const size_t hdr_len = sizeof(struct ipv6_hdr);
+	const size_t ipv6_exts_len = 0; /* TODO: handle IP extension headers */
+	const size_t full_ipv6_len = hdr_len + ipv6_exts_len;
+
+	rohc_decomp_debug(ctxt, "  build %zu-byte IPv6 header (with %zu bytes of "
+	                  "extension headers)", full_ipv6_len, ipv6_exts_len);
+
+	if(rohc_buf_avail_len(*uncomp_pkt) < full_ipv6_len)
+	{
+		rohc_decomp_warn(ctxt, "output buffer too small for the %zu-byte IPv6 "
+		                 "header (with %zu bytes of extension headers)",
+		                 full_ipv6_len, ipv6_exts_len);
+		goto error;
+	}
+
+	/* static part */
+	ipv6->version = decoded->version;
+	rohc_decomp_debug(ctxt, "    version = %u", ipv6->version);
+	ipv6_set_flow_label(ipv6, decoded->flowid);
+	rohc_decomp_debug(ctxt, "    flow label = 0x%01x%04x",
+	                  ipv6->flow1, rohc_ntoh16(ipv6->flow2));
+	ipv6->nh = decoded->proto;
+	memcpy(&ipv6->saddr, decoded->saddr, sizeof(struct ipv6_addr));
+	memcpy(&ipv6->daddr, decoded->daddr, sizeof(struct ipv6_addr));
+
+	/* dynamic part */
+	ipv6_set_tc(ipv6, decoded->tos_tc);
+	ipv6->hl = decoded->ttl;
+	rohc_decomp_debug(ctxt, "    TC = 0x%02x, HL = %u", decoded->tos_tc, ipv6->hl);
+
+	/* total length will be computed once all headers are built */
+
+	/* skip IPv6 header */
+	uncomp_pkt->len += hdr_len;
+	rohc_buf_pull(uncomp_pkt, hdr_len);
+	*ip_hdr_len += hdr_len;
+
+	/* TODO: handle IP extension headers */
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Attempt a packet/context repair upon CRC failure
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param decomp             The ROHC decompressor
+ * @param context            The decompression context
+ * @param pkt_arrival_time   The arrival time of the ROHC packet that caused
+ *                           the CRC failure
+ * @param[in,out] crc_corr   The context for corrections upon CRC failures
+ * @param[in,out] extr_bits  The bits extracted from the ROHC header
+ * @return                   true if repair is possible, false if not
+ */
+bool decomp_rfc5225_attempt_repair(const struct rohc_decomp *const decomp __attribute__((unused)),
+                                   const struct rohc_decomp_ctxt *const context __attribute__((unused)),
+                                   const struct rohc_ts pkt_arrival_time __attribute__((unused)),
+                                   struct rohc_decomp_crc_corr_ctxt *const crc_corr __attribute__((unused)),
+                                   void *const extr_bits __attribute__((unused)))
+{
+	/* there is no packet/context repair for ROHCv2 profiles */
+	rohc_decomp_debug(context, "there is no packet/context repair for ROHCv2");
+	return false;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   decomp_rfc5225.h
+ * @brief  Functions shared by the ROHCv2 decompression profiles
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_DECOMP_RFC5225_H
+#define ROHC_DECOMP_RFC5225_H
+
+#include "rohc_decomp_internals.h"
+#include "schemes/decomp_wlsb.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** The outer or inner IP bits extracted from ROHC headers */
+struct rohc_rfc5225_ip_bits
+{
+	uint8_t version:4;  /**< The version bits found in static chain of IR header */
+
+	uint8_t tos_tc_bits;         /**< The IP TOS/TC bits */
+	size_t tos_tc_bits_nr;       /**< The number of IP TOS/TC bits */
+
+	uint8_t id_behavior:2;       /**< The IP-ID behavior bits */
+	size_t id_behavior_nr;       /**< The number of IP-ID behavior bits */
+	struct rohc_lsb_field16 id;  /**< The IP-ID bits */
+
+	uint8_t df:1;    /**< The DF bits found in dynamic chain of IR/IR-DYN
+	                      header or in extension header */
+	size_t df_nr;    /**< The number of DF bits found */
+
+	uint8_t ttl_hl;   /**< The IP TTL/HL bits */
+	size_t ttl_hl_nr; /**< The number of IP TTL/HL bits */
+
+	uint8_t proto;   /**< The protocol/next header bits found static chain
+	                      of IR header or in extension header */
+	size_t proto_nr; /**< The number of protocol/next header bits */
+
+	uint32_t flowid:20;  /**< The IPv6 flow ID bits found in static chain */
+	size_t flowid_nr;    /**< The number of flow label bits */
+
+	uint8_t saddr[16];   /**< The source address bits found in static chain */
+	size_t saddr_nr;     /**< The number of source address bits */
+
+	uint8_t daddr[16];   /**< The destination address bits found in static chain */
+	size_t daddr_nr;     /**< The number of source address bits */
+
+	/* TODO: handle IPv6 extension headers */
+};
+
+
+/** The IP values decoded from the extracted ROHC bits */
+struct rohc_rfc5225_decoded_ip
+{
+	uint8_t version:4;   /**< The decoded version field */
+	uint8_t tos_tc;      /**< The decoded TOS/TC field */
+	rohc_ip_id_behavior_t id_behavior; /**< The decoded IP-ID behavior (IPv4 only) */
+	uint16_t id;         /**< The decoded IP-ID field (IPv4 only) */
+	uint8_t df:1;        /**< The decoded DF field (IPv4 only) */
+	uint8_t ttl;         /**< The decoded TTL/HL field */
+	uint8_t proto;       /**< The decoded protocol/NH field */
+	uint8_t nbo:1;       /**< The decoded NBO field (IPv4 only) */
+	uint8_t rnd:1;       /**< The decoded RND field (IPv4 only) */
+	uint32_t flowid:20;  /**< The decoded flow ID field (IPv6 only) */
+	uint8_t saddr[16];   /**< The decoded source address field */
+	uint8_t daddr[16];   /**< The decoded destination address field */
+};
+
+
+rohc_packet_t decomp_rfc5225_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
+                                             const uint8_t *const rohc_packet,
+                                             const size_t rohc_length,
+                                             const size_t large_cid_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool decomp_rfc5225_attempt_repair(const struct rohc_decomp *const decomp,
+                                   const struct rohc_decomp_ctxt *const context,
+                                   const struct rohc_ts pkt_arrival_time,
+                                   struct rohc_decomp_crc_corr_ctxt *const crc_corr,
+                                   void *const extr_bits)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+
+int decomp_rfc5225_parse_static_ip(const struct rohc_decomp_ctxt *const ctxt,
+                                   const uint8_t *const rohc_pkt,
+                                   const size_t rohc_len,
+                                   struct rohc_rfc5225_ip_bits *const ip_bits,
+                                   bool *const is_innermost)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+
+int decomp_rfc5225_parse_irreg_ip(const struct rohc_decomp_ctxt *const ctxt,
+                                  const uint8_t *const rohc_pkt,
+                                  const size_t rohc_len,
+                                  const bool is_innermost,
+                                  const rohc_ip_id_behavior_t ip_id_behavior,
+                                  const bool outer_ip_flag,
+                                  struct rohc_rfc5225_ip_bits *const ip_bits)
+	__attribute__((warn_unused_result, nonnull(1, 2, 7)));
+
+bool decomp_rfc5225_build_ip_hdrs(const struct rohc_decomp_ctxt *const context,
+                                  const struct rohc_rfc5225_decoded_ip *const ip_decoded,
+                                  const size_t ip_nr,
+                                  struct rohc_buf *const uncomp_packet,
+                                  size_t *const ip_hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+
+#endif
+
@@ -26,7 +26,8 @@
 #include "rohc_decomp.h"
 #include "rohc_decomp_internals.h"
 #include "rohc_traces_internal.h"
-#include "rohc_decomp_detect_packet.h" /* for rohc_decomp_packet_is_ir() */
+#include "rohc_decomp_detect_packet.h"
+#include "decomp_rfc5225.h"
 #include "protocols/ip_numbers.h"
 #include "protocols/ip.h"
 #include "protocols/rfc5225.h"
@@ -63,42 +64,6 @@ struct rohc_decomp_rfc5225_ip_esp_ctxt
 };
 
 
-/** The outer or inner IP bits extracted from ROHC headers */
-struct rohc_rfc5225_ip_bits
-{
-	uint8_t version:4;  /**< The version bits found in static chain of IR header */
-
-	uint8_t tos_tc_bits;         /**< The IP TOS/TC bits */
-	size_t tos_tc_bits_nr;       /**< The number of IP TOS/TC bits */
-
-	uint8_t id_behavior:2;       /**< The IP-ID behavior bits */
-	size_t id_behavior_nr;       /**< The number of IP-ID behavior bits */
-	struct rohc_lsb_field16 id;  /**< The IP-ID bits */
-
-	uint8_t df:1;    /**< The DF bits found in dynamic chain of IR/IR-DYN
-	                      header or in extension header */
-	size_t df_nr;    /**< The number of DF bits found */
-
-	uint8_t ttl_hl;   /**< The IP TTL/HL bits */
-	size_t ttl_hl_nr; /**< The number of IP TTL/HL bits */
-
-	uint8_t proto;   /**< The protocol/next header bits found static chain
-	                      of IR header or in extension header */
-	size_t proto_nr; /**< The number of protocol/next header bits */
-
-	uint32_t flowid:20;  /**< The IPv6 flow ID bits found in static chain */
-	size_t flowid_nr;    /**< The number of flow label bits */
-
-	uint8_t saddr[16];   /**< The source address bits found in static chain */
-	size_t saddr_nr;     /**< The number of source address bits */
-
-	uint8_t daddr[16];   /**< The destination address bits found in static chain */
-	size_t daddr_nr;     /**< The number of source address bits */
-
-	/* TODO: handle IPv6 extension headers */
-};
-
-
 /** The bits extracted from ROHCv2 IP/ESP header */
 struct rohc_rfc5225_bits
 {
@@ -122,24 +87,6 @@ struct rohc_rfc5225_bits
 };
 
 
-/** The IP values decoded from the extracted ROHC bits */
-struct rohc_rfc5225_decoded_ip
-{
-	uint8_t version:4;   /**< The decoded version field */
-	uint8_t tos_tc;      /**< The decoded TOS/TC field */
-	rohc_ip_id_behavior_t id_behavior; /**< The decoded IP-ID behavior (IPv4 only) */
-	uint16_t id;         /**< The decoded IP-ID field (IPv4 only) */
-	uint8_t df:1;        /**< The decoded DF field (IPv4 only) */
-	uint8_t ttl;         /**< The decoded TTL/HL field */
-	uint8_t proto;       /**< The decoded protocol/NH field */
-	uint8_t nbo:1;       /**< The decoded NBO field (IPv4 only) */
-	uint8_t rnd:1;       /**< The decoded RND field (IPv4 only) */
-	uint32_t flowid:20;  /**< The decoded flow ID field (IPv6 only) */
-	uint8_t saddr[16];   /**< The decoded source address field */
-	uint8_t daddr[16];   /**< The decoded destination address field */
-};
-
-
 /** The values decoded from the bits extracted from ROHCv2 IP/ESP header */
 struct rohc_rfc5225_decoded
 {
@@ -165,16 +112,6 @@ static bool decomp_rfc5225_ip_esp_new_context(const struct rohc_decomp_ctxt *con
                                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void decomp_rfc5225_ip_esp_free_context(struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
-static rohc_packet_t decomp_rfc5225_ip_esp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
-                                                           const uint8_t *const rohc_packet,
-                                                           const size_t rohc_length,
-                                                           const size_t large_cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
-
 static bool decomp_rfc5225_ip_esp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                                             const struct rohc_buf rohc_packet,
                                             const size_t large_cid_len,
@@ -260,12 +197,6 @@ static bool decomp_rfc5225_ip_esp_parse_static_chain(const struct rohc_decomp_ct
                                                      struct rohc_rfc5225_bits *const bits,
                                                      size_t *const parsed_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
-static int decomp_rfc5225_ip_esp_parse_static_ip(const struct rohc_decomp_ctxt *const ctxt,
-                                                 const uint8_t *const rohc_pkt,
-                                                 const size_t rohc_len,
-                                                 struct rohc_rfc5225_ip_bits *const ip_bits,
-                                                 bool *const is_innermost)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 static int decomp_rfc5225_ip_esp_parse_static_esp(const struct rohc_decomp_ctxt *const ctxt,
                                                   const uint8_t *rohc_pkt,
                                                   const size_t rohc_len,
@@ -298,15 +229,6 @@ static bool decomp_rfc5225_ip_esp_parse_irreg_chain(const struct rohc_decomp_ctx
                                                     struct rohc_rfc5225_bits *const bits,
                                                     size_t *const parsed_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
-static int decomp_rfc5225_ip_esp_parse_irreg_ip(const struct rohc_decomp_ctxt *const ctxt,
-                                                const uint8_t *const rohc_pkt,
-                                                const size_t rohc_len,
-                                                const bool is_innermost,
-                                                const rohc_ip_id_behavior_t ip_id_behavior,
-                                                const bool outer_ip_flag,
-                                                struct rohc_rfc5225_ip_bits *const ip_bits)
-	__attribute__((warn_unused_result, nonnull(1, 2, 7)));
-
 /* decoding parsed fields */
 static rohc_status_t decomp_rfc5225_ip_esp_decode_bits(const struct rohc_decomp_ctxt *const ctxt,
                                                        const struct rohc_rfc5225_bits *const bits,
@@ -335,26 +257,6 @@ static rohc_status_t decomp_rfc5225_ip_esp_build_hdrs(const struct rohc_decomp *
                                                       struct rohc_buf *const uncomp_hdrs,
                                                       size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
-static bool decomp_rfc5225_ip_esp_build_ip_hdrs(const struct rohc_decomp_ctxt *const context,
-                                                const struct rohc_rfc5225_decoded *const decoded,
-                                                struct rohc_buf *const uncomp_packet,
-                                                size_t *const ip_hdrs_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
-static bool decomp_rfc5225_ip_esp_build_ip_hdr(const struct rohc_decomp_ctxt *const ctxt,
-                                               const struct rohc_rfc5225_decoded_ip *const decoded,
-                                               struct rohc_buf *const uncomp_pkt,
-                                               size_t *const ip_hdr_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
-static bool decomp_rfc5225_ip_esp_build_ipv4_hdr(const struct rohc_decomp_ctxt *const ctxt,
-                                                 const struct rohc_rfc5225_decoded_ip *const decoded,
-                                                 struct rohc_buf *const uncomp_pkt,
-                                                 size_t *const ip_hdr_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
-static bool decomp_rfc5225_ip_esp_build_ipv6_hdr(const struct rohc_decomp_ctxt *const ctxt,
-                                                 const struct rohc_rfc5225_decoded_ip *const decoded,
-                                                 struct rohc_buf *const uncomp_pkt,
-                                                 size_t *const ip_hdr_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 static bool decomp_rfc5225_ip_esp_build_esp_hdr(const struct rohc_decomp_ctxt *const context,
                                                 const struct rohc_rfc5225_decoded *const decoded,
                                                 struct rohc_buf *const uncomp_packet,
@@ -368,13 +270,6 @@ static void decomp_rfc5225_ip_esp_update_ctxt(struct rohc_decomp_ctxt *const con
                                               bool *const do_change_mode)
 	__attribute__((nonnull(1, 2, 4)));
 
-static bool decomp_rfc5225_ip_esp_attempt_repair(const struct rohc_decomp *const decomp,
-                                                 const struct rohc_decomp_ctxt *const context,
-                                                 const struct rohc_ts pkt_arrival_time,
-                                                 struct rohc_decomp_crc_corr_ctxt *const crc_corr,
-                                                 void *const extr_bits)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
-
 static uint32_t decomp_rfc5225_ip_esp_get_sn(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
@@ -401,21 +296,11 @@ static size_t sdvl_sn_lsb_decode(const uint8_t *const data,
  * @return                   true if the ROHCv2 IP/ESP context was successfully
  *                           created, false if a problem occurred
  */
-static bool decomp_rfc5225_ip_esp_new_context(const struct rohc_decomp_ctxt *const context,
+static bool decomp_rfc5225_ip_esp_new_context(const struct rohc_decomp_ctxt *const context __attribute__((unused)),
                                               void **const persist_ctxt,
                                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
-	struct rohc_decomp_rfc5225_ip_esp_ctxt *rfc5225_ctxt;
-
-	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc5225_ip_esp_ctxt));
-	if((*persist_ctxt) == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "not enough memory for the ROHCv2 IP/ESP decompression context");
-		goto error;
-	}
-	rfc5225_ctxt = *persist_ctxt;
+	struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt = *persist_ctxt;
 
 	/* create the LSB decoding context for the MSN */
 	rohc_lsb_init(&rfc5225_ctxt->msn_lsb_ctxt, 32);
@@ -428,115 +313,11 @@ static bool decomp_rfc5225_ip_esp_new_context(const struct rohc_decomp_ctxt *con
 	/* volatile part */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_rfc5225_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/ESP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_rfc5225_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/ESP decompression context");
-		goto free_extr_bits;
-	}
 
 	return true;
-
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(rfc5225_ctxt);
-error:
-	return false;
-}
-
-
-/**
- * @brief Destroy profile-specific data, nothing to destroy for the
- *        ROHCv2 IP/ESP profile
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param rfc5225_ctxt  The persistent decompression context for the IP/ESP profile
- * @param volat_ctxt    The volatile part of the decompression context
- */
-static void decomp_rfc5225_ip_esp_free_context(struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	/* free the ROHCv2 IP/ESP decompression context itself */
-	free(rfc5225_ctxt);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
 }
 
 
-/**
- * @brief Detect the type of ROHC packet for the ROHCv2 IP/ESP profile
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param context        The decompression context
- * @param rohc_packet    The ROHC packet
- * @param rohc_length    The length of the ROHC packet
- * @param large_cid_len  The length of the optional large CID field
- * @return               The packet type
- */
-static rohc_packet_t decomp_rfc5225_ip_esp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
-                                                           const uint8_t *const rohc_packet,
-                                                           const size_t rohc_length,
-                                                           const size_t large_cid_len __attribute__((unused)))
-{
-	rohc_packet_t type;
-
-	/* at least one byte required to check discriminator byte in packet
-	 * (already checked by rohc_decomp_find_context) */
-	assert(rohc_length >= 1);
-
-	rohc_decomp_debug(context, "try to determine the header from first byte "
-	                  "0x%02x", rohc_packet[0]);
-
-	if(GET_BIT_7(rohc_packet) == 0) /* 1-bit discriminator '0' */
-	{
-		type = ROHC_PACKET_PT_0_CRC3;
-	}
-	else if(GET_BIT_5_7(rohc_packet) == 0x04) /* 3-bit discriminator '100' */
-	{
-		type = ROHC_PACKET_NORTP_PT_0_CRC7;
-	}
-	else if(GET_BIT_5_7(rohc_packet) == 0x05) /* 3-bit discriminator '101' */
-	{
-		type = ROHC_PACKET_NORTP_PT_1_SEQ_ID;
-	}
-	else if(GET_BIT_5_7(rohc_packet) == 0x06) /* 3-bit discriminator '110' */
-	{
-		type = ROHC_PACKET_NORTP_PT_2_SEQ_ID;
-	}
-	else if(GET_BIT_0_7(rohc_packet) == 0xfa) /* 8-bit discriminator '11111010' */
-	{
-		type = ROHC_PACKET_CO_COMMON;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_CO_REPAIR) /* 8-bit '11111011' */
-	{
-		type = ROHC_PACKET_CO_REPAIR;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_IR) /* 8-bit '11111101' */
-	{
-		type = ROHC_PACKET_IR;
-	}
-	else
-	{
-		type = ROHC_PACKET_UNKNOWN;
-	}
-
-	return type;
-}
 
 
 /**
@@ -634,6 +415,7 @@ static void decomp_rfc5225_ip_esp_reset_extr_bits(const struct rohc_decomp_ctxt
 	bits->reorder_ratio_nr = 0;
 	bits->outer_ip_flag_nr = 0;
 	bits->ctrl_crc.type = ROHC_CRC_TYPE_NONE;
+	bits->esp_spi_nr = 0;
 
 	/* if context handled at least one packet, init the list of IP headers */
 	if(ctxt->num_recv_packets >= 1)
@@ -878,13 +660,17 @@ static bool decomp_rfc5225_ip_esp_parse_co(const struct rohc_decomp_ctxt *const
 	 * - the large CID if any */
 	assert(remain_len >= (1 + large_cid_len));
 
-	/* copy the first bytes of header in a contiguous buffer
-	 * to be able to map packet structures to the ROHC bytes */
-	packed_rohc_packet[0] = remain_data[0];
-	memcpy(packed_rohc_packet + 1, remain_data + 1 + large_cid_len,
-	       (int)rohc_min(remain_len - large_cid_len, packed_rohc_packet_max_len) - 1);
-	remain_data = packed_rohc_packet;
+	/* the base header is contiguous if there is no large CID, so map the
+	 * packet structures directly to the ROHC bytes; otherwise copy the first
+	 * bytes of header in a contiguous buffer */
 	remain_len = rohc_min(remain_len - large_cid_len, packed_rohc_packet_max_len);
+	if(large_cid_len > 0)
+	{
+		packed_rohc_packet[0] = remain_data[0];
+		memcpy(packed_rohc_packet + 1, remain_data + 1 + large_cid_len,
+		       remain_len - 1);
+		remain_data = packed_rohc_packet;
+	}
 
 	if(packet_type == ROHC_PACKET_PT_0_CRC3)
 	{
@@ -1416,8 +1202,8 @@ static bool decomp_rfc5225_ip_esp_parse_static_chain(const struct rohc_decomp_ct
 	{
 		struct rohc_rfc5225_ip_bits *const ip_bits = &(bits->ip[ip_hdrs_nr]);
 
-		ret = decomp_rfc5225_ip_esp_parse_static_ip(ctxt, remain_data, remain_len,
-		                                            ip_bits, &is_innermost);
+		ret = decomp_rfc5225_parse_static_ip(ctxt, remain_data, remain_len,
+		                                     ip_bits, &is_innermost);
 		if(ret < 0)
 		{
 			rohc_decomp_warn(ctxt, "malformed ROHC packet: malformed IP static part");
@@ -1463,168 +1249,6 @@ error:
 }
 
 
-/**
- * @brief Decode the static IP header of the ROHC packet
- *
- * @param ctxt               The decompression context
- * @param rohc_pkt           The remaining part of the ROHC packet
- * @param rohc_len           The remaining length (in bytes) of the ROHC packet
- * @param[out] ip_bits       The bits extracted from the IP part of the static chain
- * @param[out] is_innermost  Whether the IP header is the innermost IP header
- * @return                   The length of static IP header in case of success,
- *                           -1 if an error occurs
- */
-static int decomp_rfc5225_ip_esp_parse_static_ip(const struct rohc_decomp_ctxt *const ctxt,
-                                                 const uint8_t *const rohc_pkt,
-                                                 const size_t rohc_len,
-                                                 struct rohc_rfc5225_ip_bits *const ip_bits,
-                                                 bool *const is_innermost)
-{
-	const uint8_t *remain_data = rohc_pkt;
-	size_t remain_len = rohc_len;
-	size_t read = 0;
-
-	rohc_decomp_debug(ctxt, "parse IP static part");
-
-	/* at least 1 byte required to read the version flag */
-	if(remain_len < 1)
-	{
-		rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for the "
-		                 "version flag of the IP static part");
-		goto error;
-	}
-
-	/* parse IPv4 static part or IPv6 static part? */
-	if(GET_BIT_7(remain_data) == 0)
-	{
-		const ipv4_static_t *const ipv4_static = (ipv4_static_t *) remain_data;
-
-		rohc_decomp_debug(ctxt, "  IPv4 static part");
-		ip_bits->version = IPV4;
-
-		if(remain_len < sizeof(ipv4_static_t))
-		{
-			rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for the "
-			                 "IPv4 static part");
-			goto error;
-		}
-
-		*is_innermost = !!(ipv4_static->innermost_ip == 1);
-		if(ipv4_static->reserved != 0)
-		{
-			rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field is not "
-			                 "zero, but 0x%x", ipv4_static->reserved);
-			goto error;
-		}
-		ip_bits->proto = ipv4_static->protocol;
-		ip_bits->proto_nr = 8;
-		memcpy(ip_bits->saddr, &ipv4_static->src_addr, sizeof(uint32_t));
-		ip_bits->saddr_nr = 32;
-		memcpy(ip_bits->daddr, &ipv4_static->dst_addr, sizeof(uint32_t));
-		ip_bits->daddr_nr = 32;
-
-		/* IP extension headers not supported for IPv4 */
-		/* TODO: handle IP extension headers */
-
-		read += sizeof(ipv4_static_t);
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-		remain_data += sizeof(ipv4_static_t);
-		remain_len -= sizeof(ipv4_static_t);
-#endif
-	}
-	else
-	{
-		rohc_decomp_debug(ctxt, "  IPv6 static part");
-		ip_bits->version = IPV6;
-
-		/* static with or without flow label? */
-		if(GET_BIT_4(remain_data) == 0)
-		{
-			const ipv6_static_nofl_t *const ipv6_static =
-				(ipv6_static_nofl_t *) remain_data;
-
-			if(remain_len < sizeof(ipv6_static_nofl_t))
-			{
-				rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for "
-				                 "the IPv6 static part");
-				goto error;
-			}
-
-			*is_innermost = !!(ipv6_static->innermost_ip == 1);
-			if(ipv6_static->reserved1 != 0)
-			{
-				rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field #1 is "
-				                 "not zero, but 0x%x", ipv6_static->reserved1);
-				goto error;
-			}
-			if(ipv6_static->reserved2 != 0)
-			{
-				rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field #2 is "
-				                 "not zero, but 0x%x", ipv6_static->reserved2);
-				goto error;
-			}
-			ip_bits->flowid = 0;
-			ip_bits->flowid_nr = 20;
-			ip_bits->proto = ipv6_static->next_header;
-			ip_bits->proto_nr = 8;
-			memcpy(ip_bits->saddr, &ipv6_static->src_addr, sizeof(uint32_t) * 4);
-			ip_bits->saddr_nr = 128;
-			memcpy(ip_bits->daddr, &ipv6_static->dst_addr, sizeof(uint32_t) * 4);
-			ip_bits->daddr_nr = 128;
-
-			read += sizeof(ipv6_static_nofl_t);
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-			remain_data += sizeof(ipv6_static_nofl_t);
-			remain_len -= sizeof(ipv6_static_nofl_t);
-#endif
-		}
-		else
-		{
-			const ipv6_static_fl_t *const ipv6_static =
-				(ipv6_static_fl_t *) remain_data;
-
-			if(remain_len < sizeof(ipv6_static_fl_t))
-			{
-				rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for "
-				                 "the IPv6 static part");
-				goto error;
-			}
-
-			*is_innermost = !!(ipv6_static->innermost_ip == 1);
-			if(ipv6_static->reserved != 0)
-			{
-				rohc_decomp_warn(ctxt, "malformed ROHC packet: reserved field is "
-				                 "not zero, but 0x%x", ipv6_static->reserved);
-				goto error;
-			}
-			ip_bits->flowid = (ipv6_static->flow_label_msb << 16) |
-			                  rohc_ntoh16(ipv6_static->flow_label_lsb);
-			assert((ip_bits->flowid & 0xfffff) == ip_bits->flowid);
-			rohc_decomp_debug(ctxt, "  IPv6 flow label = 0x%05x", ip_bits->flowid);
-			ip_bits->flowid_nr = 20;
-			ip_bits->proto = ipv6_static->next_header;
-			ip_bits->proto_nr = 8;
-			memcpy(ip_bits->saddr, &ipv6_static->src_addr, sizeof(uint32_t) * 4);
-			ip_bits->saddr_nr = 128;
-			memcpy(ip_bits->daddr, &ipv6_static->dst_addr, sizeof(uint32_t) * 4);
-			ip_bits->daddr_nr = 128;
-
-			read += sizeof(ipv6_static_fl_t);
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-			remain_data += sizeof(ipv6_static_fl_t);
-			remain_len -= sizeof(ipv6_static_fl_t);
-#endif
-		}
-
-		/* TODO: handle IPv6 extension headers */
-	}
-	rohc_decomp_dump_buf(ctxt, "IP static part", rohc_pkt, read);
-
-	return read;
-
-error:
-	return -1;
-}
 
 
 /**
@@ -1965,9 +1589,9 @@ static bool decomp_rfc5225_ip_esp_parse_irreg_chain(const struct rohc_decomp_ctx
 			ip_id_behavior = ip_context->ip_id_behavior;
 		}
 
-		ret = decomp_rfc5225_ip_esp_parse_irreg_ip(ctxt, remain_data, remain_len,
-		                                           is_innermost, ip_id_behavior,
-		                                           outer_ip_flag, ip_bits);
+		ret = decomp_rfc5225_parse_irreg_ip(ctxt, remain_data, remain_len,
+		                                    is_innermost, ip_id_behavior,
+		                                    outer_ip_flag, ip_bits);
 		if(ret < 0)
 		{
 			rohc_decomp_warn(ctxt, "malformed ROHC packet: malformed IP irregular part");
@@ -1988,91 +1612,6 @@ error:
 }
 
 
-/**
- * @brief Decode the irregular IP header of the ROHC packet
- *
- * @param ctxt           The decompression context
- * @param rohc_pkt       The remaining part of the ROHC packet
- * @param rohc_len       The remaining length (in bytes) of the ROHC packet
- * @param is_innermost   Whether the IP header is the innermost IP header or not
- * @param ip_id_behavior The IP-ID behavior of the IP header
- *                       (may be different from the context)
- * @param outer_ip_flag  Whether the TOS/TC or TTL/HL fields of outer IP headers
- *                       are present or not
- * @param[out] ip_bits   The bits extracted from the IP part of the irregular chain
- * @return               The length of dynamic IP header in case of success,
- *                       -1 if an error occurs
- */
-static int decomp_rfc5225_ip_esp_parse_irreg_ip(const struct rohc_decomp_ctxt *const ctxt,
-                                                const uint8_t *const rohc_pkt,
-                                                const size_t rohc_len,
-                                                const bool is_innermost,
-                                                const rohc_ip_id_behavior_t ip_id_behavior,
-                                                const bool outer_ip_flag,
-                                                struct rohc_rfc5225_ip_bits *const ip_bits)
-{
-
-	const uint8_t *remain_data = rohc_pkt;
-	size_t remain_len = rohc_len;
-	size_t size = 0;
-
-	rohc_decomp_debug(ctxt, "parse IP irregular part");
-
-	/* the innermost IPv4 IP-ID is transmitted in full if it is random */
-	if(ip_bits->version == IPV4 && ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND)
-	{
-		uint16_t ip_id;
-
-		if(remain_len < sizeof(uint16_t))
-		{
-			rohc_decomp_warn(ctxt, "packet too short for random IP-ID: only "
-			                 "%zu bytes available while at least %zu bytes "
-			                 "required", remain_len, sizeof(uint16_t));
-			goto error;
-		}
-		memcpy(&ip_id, remain_data, sizeof(uint16_t));
-		remain_data += sizeof(uint16_t);
-		remain_len -= sizeof(uint16_t);
-		size += sizeof(uint16_t);
-		rohc_decomp_debug(ctxt, "read ip_id = 0x%04x (ip_id_behavior = %d)",
-		                  ip_id, ip_id_behavior);
-		ip_bits->id.bits = rohc_ntoh16(ip_id);
-		ip_bits->id.bits_nr = 16;
-		rohc_decomp_debug(ctxt, "new IP-ID = 0x%04x", ip_bits->id.bits);
-	}
-
-	/* the TOS/TC and TTL/HL fields of outer IP headers are transmitted in full
-	 * if the outer_ip_flag is set to 1 (ie. only in co_common header) */
-	if(!is_innermost && outer_ip_flag)
-	{
-		size_t tos_ttl_req_len = 2;
-
-		if(remain_len < tos_ttl_req_len)
-		{
-			rohc_decomp_warn(ctxt, "malformed ROHC packet: too short for "
-			                 "TOS and TTL in IPv4 irregular part");
-			goto error;
-		}
-		ip_bits->tos_tc_bits = remain_data[0];
-		ip_bits->tos_tc_bits_nr = 8;
-		ip_bits->ttl_hl = remain_data[1];
-		ip_bits->ttl_hl_nr = 8;
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-		remain_data += tos_ttl_req_len;
-		remain_len -= tos_ttl_req_len;
-#endif
-		size += tos_ttl_req_len;
-		rohc_decomp_debug(ctxt, "TOS/TC = 0x%x, ttl_hopl = 0x%x",
-		                  ip_bits->tos_tc_bits, ip_bits->ttl_hl);
-	}
-
-	rohc_decomp_dump_buf(ctxt, "IP irregular part", rohc_pkt, size);
-
-	return size;
-
-error:
-	return -1;
-}
 
 
 /**
@@ -2106,13 +1645,19 @@ static rohc_status_t decomp_rfc5225_ip_esp_decode_bits(const struct rohc_decomp_
 	}
 	else
 	{
+		const rohc_reordering_offset_t reorder_ratio =
+			(bits->reorder_ratio_nr > 0 ? bits->reorder_ratio : rfc5225_ctxt->reorder_ratio);
 		const rohc_lsb_shift_t p_computed =
-			rohc_interval_get_rfc5225_msn_p(bits->msn.bits_nr, bits->reorder_ratio);
+			rohc_interval_get_rfc5225_msn_p(bits->msn.bits_nr, reorder_ratio);
 		uint32_t msn_decoded32;
 
 		assert(bits->msn.bits_nr > 0); /* all packets contain some MSN bits */
 
-		if(!rohc_lsb_decode(&rfc5225_ctxt->msn_lsb_ctxt, ROHC_LSB_REF_0, 0,
+		/* the MSN is the ESP SN, so it is often the successor of the MSN of the
+		 * previous packet */
+		if(!rohc_lsb_decode_next(&rfc5225_ctxt->msn_lsb_ctxt, bits->msn.bits,
+		                         bits->msn.bits_nr, p_computed, &msn_decoded32) &&
+		   !rohc_lsb_decode(&rfc5225_ctxt->msn_lsb_ctxt, ROHC_LSB_REF_0, 0,
 		                    bits->msn.bits, bits->msn.bits_nr, p_computed,
 		                    &msn_decoded32))
 		{
@@ -2177,7 +1722,7 @@ static rohc_status_t decomp_rfc5225_ip_esp_decode_bits(const struct rohc_decomp_
 			 * https://www.rfc-editor.org/errata_search.php?rfc=5225&eid=2703 */
 			if(rfc5225_ctxt->ip_contexts[ip_hdr_pos].version == IPV4)
 			{
-				ip_id_behaviors[ip_id_behaviors_nr] = bits->ip[ip_hdr_pos].id_behavior;
+				ip_id_behaviors[ip_id_behaviors_nr] = decoded->ip[ip_hdr_pos].id_behavior;
 				rohc_decomp_debug(ctxt, "IP-ID behavior #%zu of IPv4 header #%zu "
 				                  "= 0x%02x", ip_id_behaviors_nr + 1, ip_hdr_pos + 1,
 				                  ip_id_behaviors[ip_id_behaviors_nr]);
@@ -2574,8 +2119,8 @@ static rohc_status_t decomp_rfc5225_ip_esp_build_hdrs(const struct rohc_decomp *
 	*uncomp_hdrs_len = 0;
 
 	/* build IP headers */
-	if(!decomp_rfc5225_ip_esp_build_ip_hdrs(context, decoded, uncomp_hdrs,
-	                                        &ip_hdrs_len))
+	if(!decomp_rfc5225_build_ip_hdrs(context, decoded->ip, decoded->ip_nr,
+	                                 uncomp_hdrs, &ip_hdrs_len))
 	{
 		rohc_decomp_warn(context, "failed to build uncompressed IP headers");
 		goto error_output_too_small;
@@ -2670,231 +2215,12 @@ error_output_too_small:
 }
 
 
-/**
- * @brief Build all of the uncompressed IP headers
- *
- * Build all of the uncompressed IP headers - IPv4 or IPv6 - from the context
- * and packet information.
- *
- * @param ctxt              The decompression context
- * @param decoded           The values decoded from the ROHC packet
- * @param[out] uncomp_pkt   The uncompressed packet being built
- * @param[out] ip_hdrs_len  The length of all the IP headers (in bytes)
- * @return                  true if IP headers were successfully built,
- *                          false if the output \e uncomp_packet was not
- *                          large enough
- */
-static bool decomp_rfc5225_ip_esp_build_ip_hdrs(const struct rohc_decomp_ctxt *const ctxt,
-                                                const struct rohc_rfc5225_decoded *const decoded,
-                                                struct rohc_buf *const uncomp_pkt,
-                                                size_t *const ip_hdrs_len)
-{
-	size_t ip_hdr_nr;
 
-	assert(decoded->ip_nr > 0);
 
-	rohc_decomp_debug(ctxt, "build the %zu IP headers", decoded->ip_nr);
 
-	*ip_hdrs_len = 0;
-	for(ip_hdr_nr = 0; ip_hdr_nr < decoded->ip_nr; ip_hdr_nr++)
-	{
-		const struct rohc_rfc5225_decoded_ip *const ip_decoded =
-			&(decoded->ip[ip_hdr_nr]);
-		size_t ip_hdr_len = 0;
 
-		if(!decomp_rfc5225_ip_esp_build_ip_hdr(ctxt, ip_decoded, uncomp_pkt,
-		                                       &ip_hdr_len))
-		{
-			rohc_decomp_warn(ctxt, "failed to build uncompressed IP header #%zu",
-			                 ip_hdr_nr + 1);
-			goto error;
-		}
-		*ip_hdrs_len += ip_hdr_len;
-	}
 
-	return true;
 
-error:
-	return false;
-}
-
-
-/**
- * @brief Build one single uncompressed IP header
- *
- * Build one single uncompressed IP header - IPv4 or IPv6 - from the context
- * and packet information.
- *
- * @param ctxt             The decompression context
- * @param decoded          The values decoded from the ROHC packet
- * @param[out] uncomp_pkt  The uncompressed packet being built
- * @param[out] ip_hdr_len  The length of the IP header (in bytes)
- * @return                 true if IP header was successfully built,
- *                         false if the output \e uncomp_packet was not
- *                         large enough
- */
-static bool decomp_rfc5225_ip_esp_build_ip_hdr(const struct rohc_decomp_ctxt *const ctxt,
-                                               const struct rohc_rfc5225_decoded_ip *const decoded,
-                                               struct rohc_buf *const uncomp_pkt,
-                                               size_t *const ip_hdr_len)
-{
-	if(decoded->version == IPV4)
-	{
-		if(!decomp_rfc5225_ip_esp_build_ipv4_hdr(ctxt, decoded, uncomp_pkt,
-		                                         ip_hdr_len))
-		{
-			rohc_decomp_warn(ctxt, "failed to build uncompressed IPv4 header");
-			goto error;
-		}
-	}
-	else
-	{
-		if(!decomp_rfc5225_ip_esp_build_ipv6_hdr(ctxt, decoded, uncomp_pkt, ip_hdr_len))
-		{
-			rohc_decomp_warn(ctxt, "failed to build uncompressed IPv6 header");
-			goto error;
-		}
-	}
-
-	return true;
-
-error:
-	return false;
-}
-
-
-/**
- * @brief Build one single uncompressed IPv4 header
- *
- * Build one single uncompressed IPv4 header from the context and packet
- * information.
- *
- * @param ctxt             The decompression context
- * @param decoded          The values decoded from the ROHC packet
- * @param[out] uncomp_pkt  The uncompressed packet being built
- * @param[out] ip_hdr_len  The length of the IPv4 header (in bytes)
- * @return                 true if IPv4 header was successfully built,
- *                         false if the output \e uncomp_packet was not
- *                         large enough
- */
-static bool decomp_rfc5225_ip_esp_build_ipv4_hdr(const struct rohc_decomp_ctxt *const ctxt,
-                                                 const struct rohc_rfc5225_decoded_ip *const decoded,
-                                                 struct rohc_buf *const uncomp_pkt,
-                                                 size_t *const ip_hdr_len)
-{
-	struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) rohc_buf_data(*uncomp_pkt);
-	const size_t hdr_len = sizeof(struct ipv4_hdr);
-
-	rohc_decomp_debug(ctxt, "  build %zu-byte IPv4 header", hdr_len);
-
-	if(rohc_buf_avail_len(*uncomp_pkt) < hdr_len)
-	{
-		rohc_decomp_warn(ctxt, "output buffer too small for the %zu-byte IPv4 "
-		                 "header", hdr_len);
-		goto error;
-	}
-
-	/* static part */
-	ipv4->version = decoded->version;
-	rohc_decomp_debug(ctxt, "    version = %u", ipv4->version);
-	ipv4->ihl = hdr_len / sizeof(uint32_t);
-	rohc_decomp_debug(ctxt, "    ihl = %u", ipv4->ihl);
-	ipv4->protocol = decoded->proto;
-	memcpy(&ipv4->saddr, decoded->saddr, 4);
-	rohc_decomp_debug(ctxt, "    src addr = 0x%08x", rohc_hton32(ipv4->saddr));
-	memcpy(&ipv4->daddr, decoded->daddr, 4);
-	rohc_decomp_debug(ctxt, "    dst addr = 0x%08x", rohc_hton32(ipv4->daddr));
-
-	/* dynamic part */
-	ipv4->frag_off = 0;
-	ipv4->df = decoded->df;
-	ipv4->tos = decoded->tos_tc;
-	ipv4->ttl = decoded->ttl;
-	rohc_decomp_debug(ctxt, "    TOS = 0x%02x, TTL = %u", ipv4->tos, ipv4->ttl);
-	/* IP-ID */
-	ipv4->id = rohc_hton16(decoded->id);
-	rohc_decomp_debug(ctxt, "    %s IP-ID = 0x%04x",
-	                  rohc_ip_id_behavior_get_descr(decoded->id_behavior),
-	                  rohc_ntoh16(ipv4->id));
-
-	/* length and checksums will be computed once all headers are built */
-
-	/* skip IPv4 header */
-	uncomp_pkt->len += hdr_len;
-	rohc_buf_pull(uncomp_pkt, hdr_len);
-	*ip_hdr_len += hdr_len;
-
-	return true;
-
-error:
-	return false;
-}
-
-
-/**
- * @brief Build one single uncompressed IPv6 header
- *
- * Build one single uncompressed IPv6 header - including IPv6 extension
- * headers - from the context and packet information.
- *
- * @param ctxt             The decompression context
- * @param decoded          The values decoded from the ROHC packet
- * @param[out] uncomp_pkt  The uncompressed packet being built
- * @param[out] ip_hdr_len  The length of the IPv6 header (in bytes)
- * @return                 true if IPv6 header was successfully built,
- *                         false if the output \e uncomp_packet was not
- *                         large enough
- */
-static bool decomp_rfc5225_ip_esp_build_ipv6_hdr(const struct rohc_decomp_ctxt *const ctxt,
-                                                 const struct rohc_rfc5225_decoded_ip *const decoded,
-                                                 struct rohc_buf *const uncomp_pkt,
-                                                 size_t *const ip_hdr_len)
-{
-	struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) rohc_buf_data(*uncomp_pkt);
-	const size_t hdr_len = sizeof(struct ipv6_hdr);
-	const size_t ipv6_exts_len = 0; /* TODO: handle IP extension headers */
-	const size_t full_ipv6_len = hdr_len + ipv6_exts_len;
-
-	rohc_decomp_debug(ctxt, "  build %zu-byte IPv6 header (with %zu bytes of "
-	                  "extension headers)", full_ipv6_len, ipv6_exts_len);
-
-	if(rohc_buf_avail_len(*uncomp_pkt) < full_ipv6_len)
-	{
-		rohc_decomp_warn(ctxt, "output buffer too small for the %zu-byte IPv6 "
-		                 "header (with %zu bytes of extension headers)",
-		                 full_ipv6_len, ipv6_exts_len);
-		goto error;
-	}
-
-	/* static part */
-	ipv6->version = decoded->version;
-	rohc_decomp_debug(ctxt, "    version = %u", ipv6->version);
-	ipv6_set_flow_label(ipv6, decoded->flowid);
-	rohc_decomp_debug(ctxt, "    flow label = 0x%01x%04x",
-	                  ipv6->flow1, rohc_ntoh16(ipv6->flow2));
-	ipv6->nh = decoded->proto;
-	memcpy(&ipv6->saddr, decoded->saddr, sizeof(struct ipv6_addr));
-	memcpy(&ipv6->daddr, decoded->daddr, sizeof(struct ipv6_addr));
-
-	/* dynamic part */
-	ipv6_set_tc(ipv6, decoded->tos_tc);
-	ipv6->hl = decoded->ttl;
-	rohc_decomp_debug(ctxt, "    TC = 0x%02x, HL = %u", decoded->tos_tc, ipv6->hl);
-
-	/* total length will be computed once all headers are built */
-
-	/* skip IPv6 header */
-	uncomp_pkt->len += hdr_len;
-	rohc_buf_pull(uncomp_pkt, hdr_len);
-	*ip_hdr_len += hdr_len;
-
-	/* TODO: handle IP extension headers */
-
-	return true;
-
-error:
-	return false;
-}
 
 
 /**
@@ -3028,35 +2354,17 @@ static void decomp_rfc5225_ip_esp_update_ctxt(struct rohc_decomp_ctxt *const con
 		}
 	}
 	rfc5225_ctxt->ip_contexts_nr = decoded->ip_nr;
-}
 
+	/* reorder ratio */
+	rfc5225_ctxt->reorder_ratio = decoded->reorder_ratio;
 
-/**
- * @brief Attempt a packet/context repair upon CRC failure
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param decomp             The ROHC decompressor
- * @param context            The decompression context
- * @param pkt_arrival_time   The arrival time of the ROHC packet that caused
- *                           the CRC failure
- * @param[in,out] crc_corr   The context for corrections upon CRC failures
- * @param[in,out] extr_bits  The bits extracted from the ROHC header
- * @return                   true if repair is possible, false if not
- */
-static bool decomp_rfc5225_ip_esp_attempt_repair(const struct rohc_decomp *const decomp __attribute__((unused)),
-                                                 const struct rohc_decomp_ctxt *const context __attribute__((unused)),
-                                                 const struct rohc_ts pkt_arrival_time __attribute__((unused)),
-                                                 struct rohc_decomp_crc_corr_ctxt *const crc_corr __attribute__((unused)),
-                                                 void *const extr_bits __attribute__((unused)))
-{
-	/* there is no packet/context repair for ROHCv2 profiles */
-	rohc_decomp_debug(context, "there is no packet/context repair for ROHCv2");
-	return false;
+	/* update context for the ESP header */
+	rfc5225_ctxt->esp_spi = decoded->esp_spi;
 }
 
 
+
+
 /**
  * @brief Get the reference SN value of the context
  *
@@ -3183,14 +2491,18 @@ const struct rohc_decomp_profile rohc_decomp_rfc5225_ip_esp_profile =
 {
 	.id              = ROHCv2_PROFILE_IP_ESP, /* profile ID (RFC5225, ROHCv2 IP/ESP) */
 	.msn_max_bits    = 32,
+	.persist_ctxt_len   = sizeof(struct rohc_decomp_rfc5225_ip_esp_ctxt),
+	.persist_ctxt_is_flat = true,
+	.extr_bits_len      = sizeof(struct rohc_rfc5225_bits),
+	.decoded_values_len = sizeof(struct rohc_rfc5225_decoded),
 	.new_context     = decomp_rfc5225_ip_esp_new_context,
-	.free_context    = (rohc_decomp_free_context_t) decomp_rfc5225_ip_esp_free_context,
-	.detect_pkt_type = decomp_rfc5225_ip_esp_detect_pkt_type,
+	.free_context    = NULL,
+	.detect_pkt_type = decomp_rfc5225_detect_pkt_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) decomp_rfc5225_ip_esp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) decomp_rfc5225_ip_esp_decode_bits,
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) decomp_rfc5225_ip_esp_build_hdrs,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) decomp_rfc5225_ip_esp_update_ctxt,
-	.attempt_repair  = (rohc_decomp_attempt_repair_t) decomp_rfc5225_ip_esp_attempt_repair,
+	.attempt_repair  = (rohc_decomp_attempt_repair_t) decomp_rfc5225_attempt_repair,
 	.get_sn          = decomp_rfc5225_ip_esp_get_sn,
 };
 
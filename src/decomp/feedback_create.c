@@ -41,11 +41,10 @@
  * Prototypes of private functions.
  */
 
-static bool f_append_cid(struct d_feedback *const feedback,
-                         const uint16_t cid,
-                         const rohc_cid_type_t cid_type,
-                         size_t *const cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+static size_t f_write_cid(uint8_t *const cid_field,
+                          const uint16_t cid,
+                          const rohc_cid_type_t cid_type)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 
 /**
@@ -297,130 +296,93 @@ error:
 
 
 /**
- * @brief Append the CID to the feedback packet.
+ * @brief Write the CID of the feedback packet.
  *
- * @param feedback     The feedback packet to which the CID must be appended
- * @param cid          The Context ID (CID) to append
- * @param cid_type     The type of CID used for the feedback
- * @param[out] cid_len The length of the add-CID or large CID field
- * @return             Whether the CID is successfully appended or not
+ * @param[out] cid_field  The location of the add-CID or large CID field
+ * @param cid             The Context ID (CID) to write
+ * @param cid_type        The type of CID used for the feedback
+ * @return                The length of the add-CID or large CID field,
+ *                        0 if the large CID cannot be encoded
  */
-static bool f_append_cid(struct d_feedback *const feedback,
-                         const uint16_t cid,
-                         const rohc_cid_type_t cid_type,
-                         size_t *const cid_len)
+static size_t f_write_cid(uint8_t *const cid_field,
+                          const uint16_t cid,
+                          const rohc_cid_type_t cid_type)
 {
-	size_t i;
+	size_t cid_len;
 
 	if(cid_type == ROHC_LARGE_CID)
 	{
 		/* large CIDs are used */
 		assert(cid <= ROHC_LARGE_CID_MAX);
 
-		/* determine the number of bits required for the SDVL-encoded large CID */
-		*cid_len = sdvl_get_encoded_len(cid);
-		assert((*cid_len) == 1 || (*cid_len) == 2); /* ensured by SDVL algorithm */
-
-		/* check if the feedback packet can contain a SDVL-encoded large CID */
-		if((feedback->size + (*cid_len)) > FEEDBACK_DATA_MAX_LEN)
-		{
-#ifdef ROHC_FEEDBACK_DEBUG
-			printf("feedback packet is too small for large CID\n");
-#endif
-			return false;
-		}
-
-#ifdef ROHC_FEEDBACK_DEBUG
-		printf("add %zu bytes for large CID to feedback\n", *cid_len);
-#endif
-
-		/* move feedback data to make space for the SDVL-encoded large CID */
-		assert(feedback->size >= 1);
-		for(i = feedback->size; i > 0; i--)
-		{
-			feedback->data[i - 1 + (*cid_len)] = feedback->data[i - 1];
-		}
-
 		/* SDVL-encode the large CID */
-		if(!sdvl_encode_full(feedback->data, 4U /* TODO */, cid_len, cid))
+		if(!sdvl_encode_full(cid_field, 2U, &cid_len, cid))
 		{
 #ifdef ROHC_FEEDBACK_DEBUG
 			printf("failed to SDVL-encoded large CID %u, should never "
 			       "happen!\n", cid);
 #endif
-			return false;
+			return 0;
 		}
-		feedback->size += (*cid_len);
+		assert(cid_len == 1 || cid_len == 2); /* ensured by SDVL algorithm */
+#ifdef ROHC_FEEDBACK_DEBUG
+		printf("add %zu bytes for large CID to feedback\n", cid_len);
+#endif
 	}
-	else /* small CID */
+	else if(cid != 0) /* small non-zero CID */
 	{
-		/* small CIDs are used */
 		assert(cid <= ROHC_SMALL_CID_MAX);
 
-		/* add 1 byte only if CID is non-zero */
-		if(cid != 0)
-		{
+		/* write the Add-CID byte to the feedback packet */
+		cid_field[0] = 0xe0 | (cid & 0xf);
+		cid_len = 1;
 #ifdef ROHC_FEEDBACK_DEBUG
-			printf("add 1 byte for small CID to feedback\n");
+		printf("add 1 byte for small CID to feedback\n");
 #endif
-
-			/* move feedback data to make space for the small CID */
-			assert(feedback->size >= 1);
-			for(i = feedback->size; i > 0; i--)
-			{
-				feedback->data[i] = feedback->data[i - 1];
-			}
-
-			/* write the small CID to the feedback packet */
-			feedback->data[0] = 0xe0;
-			feedback->data[0] = (cid & 0xf) | feedback->data[0];
-			feedback->size++;
-			*cid_len = 1;
-		}
+	}
+	else /* small CID 0 */
+	{
 #ifdef ROHC_FEEDBACK_DEBUG
-		else
-		{
-			printf("no need to prepend Add-CID byte to feedback\n");
-			*cid_len = 0;
-		}
+		printf("no need to prepend Add-CID byte to feedback\n");
 #endif
+		cid_len = 0;
 	}
 
-	return true;
+	return cid_len;
 }
 
 
 /**
- * @brief Wrap the feedback packet and add a CRC option if specified.
+ * @brief Wrap the feedback packet into the given buffer
+ *
+ * Write the feedback type, the CID and the feedback data at the end of the
+ * given buffer, add the CRC option if specified, then compute the CRC in
+ * place. Nothing is written if the buffer is too small for the feedback.
  *
  * @warning CID may be greater than MAX_CID if the context was not found and
  *          generated a No Context feedback; it must however respect CID type
  *
- * @param feedback          The feedback packet to which the CID must be
- *                          appended
+ * @param feedback          The feedback packet to wrap
  * @param cid               The Context ID (CID) to append
  * @param cid_type          The type of CID used for the feedback
  * @param protect_with_crc  Whether the CRC option must be added or not
- * @param final_size        OUT: The final size of the feedback packet
- * @return                  The feedback packet if successful, NULL otherwise
+ * @param crc_engine        The CRC engine of the decompressor
+ * @param[in,out] buf       The buffer to write the feedback packet in
+ * @return                  true if successful, false otherwise
  */
-uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
-                          const uint16_t cid,
-                          const rohc_cid_type_t cid_type,
-                          const rohc_feedback_crc_t protect_with_crc,
-                          size_t *const final_size)
+bool f_wrap_feedback(struct d_feedback *const feedback,
+                     const uint16_t cid,
+                     const rohc_cid_type_t cid_type,
+                     const rohc_feedback_crc_t protect_with_crc,
+                     const struct rohc_crc_engine *const crc_engine,
+                     struct rohc_buf *const buf)
 {
-	uint8_t *feedback_packet;
-	size_t feedback_cid_len = 0;
+	const size_t cid_len =
+		(cid_type == ROHC_LARGE_CID ? sdvl_get_encoded_len(cid) : (cid != 0 ? 1 : 0));
 	size_t crc_pos = 0;
-	uint8_t crc;
-
-	/* append the CID to the feedback packet */
-	if(!f_append_cid(feedback, cid, cid_type, &feedback_cid_len))
-	{
-		goto error;
-	}
-	assert(feedback_cid_len <= 2);
+	size_t feedback_hdr_len;
+	size_t feedback_len;
+	uint8_t *feedback_pkt;
 
 	/* add the CRC option if specified */
 	if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_OPT)
@@ -436,14 +398,13 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
 			goto error;
 		}
 		/* CRC goes in the last byte of the feedback (CRC option is the last one) */
-		crc_pos = feedback->size - 1;
+		crc_pos = cid_len + feedback->size - 1;
 	}
 	else if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_BASE)
 	{
 		/* CRC goes in the last byte of the base header */
-		const size_t feedback_type_len = 1;
-		const size_t feedback_base_hdr_len = 2;
-		crc_pos = feedback_type_len + feedback_cid_len + feedback_base_hdr_len - 1;
+		const size_t feedback_base_hdr_len = 3;
+		crc_pos = cid_len + feedback_base_hdr_len - 1;
 	}
 	else if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
 	{
@@ -451,31 +412,51 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
 		goto error;
 	}
 
-	/* allocate memory for the feedback packet */
-	feedback_packet = (uint8_t *) malloc(feedback->size);
-	if(feedback_packet == NULL)
+	/* the feedback type and its size */
+	feedback_len = cid_len + feedback->size;
+	feedback_hdr_len = 1 + (feedback_len < 8 ? 0 : 1);
+	if((buf->len + feedback_hdr_len + feedback_len) > rohc_buf_avail_len(*buf))
 	{
-		goto error;
+#ifdef ROHC_FEEDBACK_DEBUG
+		printf("buffer is too small for the %zu-byte feedback\n",
+		       feedback_hdr_len + feedback_len);
+#endif
+		goto skip;
+	}
+	feedback_pkt = rohc_buf_data_at(*buf, buf->len);
+	if(feedback_len < 8)
+	{
+		feedback_pkt[0] = 0xf0 | feedback_len;
+	}
+	else
+	{
+		feedback_pkt[0] = 0xf0;
+		feedback_pkt[1] = feedback_len;
 	}
+	feedback_pkt += feedback_hdr_len;
 
-	/* duplicate the feedback packet */
-	memcpy(feedback_packet, feedback->data, feedback->size);
+	/* the CID then the feedback data */
+	if(f_write_cid(feedback_pkt, cid, cid_type) != cid_len)
+	{
+		goto error;
+	}
+	memcpy(feedback_pkt + cid_len, feedback->data, feedback->size);
 
 	/* compute the CRC and store it in the feedback packet if specified */
 	if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
 	{
-		crc = crc_calculate(ROHC_CRC_TYPE_8, feedback_packet, feedback->size,
-		                    CRC_INIT_8);
-		feedback_packet[crc_pos] = crc;
+		feedback_pkt[crc_pos] =
+			crc_engine_calc(crc_engine, ROHC_CRC_TYPE_8, feedback_pkt, feedback_len,
+			                CRC_INIT_8);
 	}
 
-	*final_size = feedback->size;
-	feedback->size = 0;
+	buf->len += feedback_hdr_len + feedback_len;
 
-	return feedback_packet;
+skip:
+	feedback->size = 0;
+	return true;
 
 error:
 	feedback->size = 0;
-	return NULL;
+	return false;
 }
-
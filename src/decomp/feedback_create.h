@@ -80,12 +80,13 @@ bool f_add_option(struct d_feedback *const feedback,
                   const size_t data_len)
 	__attribute__((warn_unused_result, nonnull(1)));
 
-uint8_t * f_wrap_feedback(struct d_feedback *feedback,
-                          const uint16_t cid,
-                          const rohc_cid_type_t cid_type,
-                          const rohc_feedback_crc_t protect_with_crc,
-                          size_t *const final_size)
-	__attribute__((warn_unused_result, nonnull(1, 5)));
+bool f_wrap_feedback(struct d_feedback *const feedback,
+                     const uint16_t cid,
+                     const rohc_cid_type_t cid_type,
+                     const rohc_feedback_crc_t protect_with_crc,
+                     const struct rohc_crc_engine *const crc_engine,
+                     struct rohc_buf *const buf)
+	__attribute__((warn_unused_result, nonnull(1, 5, 6)));
 
 
 #endif
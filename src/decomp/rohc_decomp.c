@@ -46,10 +46,21 @@
 #include "rohc_debug.h"
 #include "feedback_create.h"
 #include "feedback_parse.h"
+#include "rohc_feedback_ring.h"
+#include "rohc_channel_set.h"
 #include "sdvl.h"
 #include "rohc_add_cid.h"
 #include "rohc_decomp_detect_packet.h"
 #include "crc.h"
+#include "rohc_probes.h"
+#include "rohc_ctxt_image.h"
+#include "ip.h"
+#include "protocols/ip_numbers.h"
+#include "protocols/ipv4.h"
+#include "protocols/ipv6.h"
+#include "protocols/tcp.h"
+
+#include "config.h" /* for ROHC_BUILD_PROFILE_* */
 
 #include <string.h>
 #include <stdarg.h>
@@ -73,27 +84,49 @@ extern const struct rohc_decomp_profile rohc_decomp_rfc5225_ip_esp_profile;
 extern const struct rohc_decomp_profile rohc_decomp_rfc5225_ip_udp_rtp_profile;
 
 
-/** The ROHC decompression profiles */
+/** The ROHC decompression profiles, only the ones built in the library */
 static const struct rohc_decomp_profile *const
 	rohc_decomp_profiles[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1] =
 {
 	[0] = {
+#if ROHC_BUILD_PROFILE_UNCOMP
 		[0] = &d_uncomp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_RTP
 		[1] = &d_rtp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_UDP
 		[2] = &d_udp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_ESP
 		[3] = &d_esp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_IP
 		[4] = &d_ip_profile,
+#endif
 		[5] = NULL,
+#if ROHC_BUILD_PROFILE_TCP
 		[6] = &d_tcp_profile,
+#endif
 		[7] = NULL,
+#if ROHC_BUILD_PROFILE_UDPLITE
 		[8] = &d_udplite_profile,
+#endif
 	},
 	[1] = {
 		[0] = NULL,
+#if ROHC_BUILD_PROFILE_V2RTP
 		[1] = &rohc_decomp_rfc5225_ip_udp_rtp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_V2UDP
 		[2] = &rohc_decomp_rfc5225_ip_udp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_V2ESP
 		[3] = &rohc_decomp_rfc5225_ip_esp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_V2IP
 		[4] = &rohc_decomp_rfc5225_ip_profile,
+#endif
 		[5] = NULL,
 		[6] = NULL,
 		[7] = NULL,
@@ -102,6 +135,22 @@ static const struct rohc_decomp_profile *const
 };
 
 
+/**
+ * @brief The profile of the given decompression context
+ *
+ * If only one profile is built in the library, the profile of every context
+ * is known at build time: its handlers are then called directly instead of
+ * through the function pointers of the context, so that LTO may inline them.
+ */
+#ifdef ROHC_DECOMP_SINGLE_PROFILE
+#  define rohc_decomp_ctxt_profile(ctxt) \
+	((void) (ctxt), &(ROHC_DECOMP_SINGLE_PROFILE))
+#else
+#  define rohc_decomp_ctxt_profile(ctxt) \
+	((ctxt)->profile)
+#endif
+
+
 /*
  * Definitions of private structures
  */
@@ -137,6 +186,35 @@ struct rohc_decomp_stream
 	size_t sn_bits_nr;         /**< The number of SN LSB bits (if context found) */
 	rohc_packet_t packet_type; /**< The type of the decompressed packet */
 	bool crc_failed;           /**< Whether the packet failed the CRC check or not */
+	struct rohc_ts arrival_time; /**< The arrival time of the packet */
+	size_t feedbacks_offset;   /**< The offset of the piggybacked feedbacks */
+	size_t feedbacks_len;      /**< The length of the piggybacked feedbacks */
+	size_t feedbacks_nr;       /**< The number of piggybacked feedbacks */
+};
+
+
+/**
+ * @brief The train of TCP segments coalesced by \ref rohc_decompress_burst_gro
+ *
+ * The segments of one train were decompressed by the same context, they all
+ * have the same headers but the lengths, the IP-ID, the TCP sequence number,
+ * some TCP flags and the checksums, and their payloads are consecutive.
+ */
+struct rohc_decomp_gro_train
+{
+	size_t head;           /**< The index of the first segment in the burst */
+	size_t segs_nr;        /**< The number of segments, 0 if no train */
+	rohc_cid_t cid;        /**< The CID of the context of the segments */
+	bool is_ipv6;          /**< Whether the segments are IPv6 or IPv4 ones */
+	bool is_closed;        /**< Whether no segment may be appended anymore */
+	size_t tcp_off;        /**< The offset of the TCP header */
+	size_t hdr_len;        /**< The length of the IP and TCP headers */
+	size_t gso_size;       /**< The payload length of the first segment */
+	size_t payload_len;    /**< The payload length of all the segments */
+	uint32_t payload_sum;  /**< The checksum of the payloads, not folded */
+	uint32_t next_seq;     /**< The TCP sequence number of the next segment */
+	uint16_t next_ip_id;   /**< The IP-ID of the next IPv4 segment */
+	uint8_t last_flags;    /**< The FIN and PSH flags of the last segment */
 };
 
 
@@ -167,15 +245,79 @@ static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const de
 	__attribute__((nonnull(1), warn_unused_result));
 static void context_free(struct rohc_decomp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static void rohc_decomp_ctxts_used_add(struct rohc_decomp *const decomp,
+                                       struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void rohc_decomp_ctxts_used_del(struct rohc_decomp *const decomp,
+                                       struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_decomp_restore_context(struct rohc_decomp *const decomp,
+                                        const struct rohc_ctxt_image_rec *const rec,
+                                        const uint8_t *const data,
+                                        const struct rohc_ts now)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void rohc_decomp_ctxt_event(const struct rohc_decomp_ctxt *const context,
+                                   const rohc_decomp_ctxt_event_type_t type)
+	__attribute__((nonnull(1)));
+static size_t context_len(const struct rohc_decomp_profile *const profile)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static bool rohc_decomp_create_scratch(struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static rohc_status_t rohc_decomp_decompress_pkt(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf rohc_packet,
+                                                struct rohc_buf *const uncomp_packet,
+                                                struct rohc_buf *const rcvd_feedback,
+                                                struct rohc_buf *const feedback_send,
+                                                const bool in_place,
+                                                struct rohc_decomp_pkt_info *const info)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+
+static void rohc_decomp_burst_prefetch(const struct rohc_decomp *const decomp,
+                                       const struct rohc_buf *const rohc_pkts,
+                                       const size_t pkts_nr)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_decomp_peek_cid_nocheck(const struct rohc_decomp *const decomp,
+                                         const struct rohc_buf rohc_packet,
+                                         rohc_cid_t *const cid,
+                                         size_t *const feedback_offset,
+                                         size_t *const feedback_len)
+	__attribute__((warn_unused_result, nonnull(1, 3, 4, 5)));
+
+static bool rohc_decomp_gro_start(struct rohc_decomp_gro_train *const train,
+                                  const size_t idx,
+                                  const struct rohc_buf uncomp_pkt,
+                                  const struct rohc_decomp_pkt_info *const info)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static bool rohc_decomp_gro_append(struct rohc_decomp_gro_train *const train,
+                                   struct rohc_buf *const head_pkt,
+                                   const struct rohc_buf uncomp_pkt,
+                                   const struct rohc_decomp_pkt_info *const info)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static void rohc_decomp_gro_close(struct rohc_decomp_gro_train *const train,
+                                  struct rohc_buf *const head_pkt,
+                                  struct rohc_decomp_gro_info *const gro_info)
+	__attribute__((nonnull(1, 2, 3)));
+static uint32_t rohc_decomp_gro_payload_sum(const struct rohc_decomp_gro_train *const train,
+                                            const uint8_t *const pkt,
+                                            const size_t pkt_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint32_t rohc_decomp_gro_pseudo_sum(const struct rohc_decomp_gro_train *const train,
+                                           const uint8_t *const pkt,
+                                           const size_t pkt_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static uint16_t rohc_decomp_gro_csum_fold(uint32_t sum)
+	__attribute__((warn_unused_result, const));
 
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
                                      struct rohc_buf *const rcvd_feedback,
+                                     const bool in_place,
                                      struct rohc_decomp_stream *const stream)
-	__attribute__((nonnull(1, 3, 5), warn_unused_result));
+	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
-static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
+static bool rohc_decomp_decode_cid(const struct rohc_decomp *const decomp,
                                    const uint8_t *packet,
                                    unsigned int len,
                                    rohc_cid_t *const cid,
@@ -197,6 +339,11 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
                                               struct rohc_decomp_ctxt **const context,
                                               bool *const context_created)
 	__attribute__((warn_unused_result, nonnull(1, 2, 7, 8, 9)));
+static rohc_status_t rohc_decomp_drop_early(const struct rohc_decomp *const decomp,
+                                            const uint8_t *const packet,
+                                            const size_t packet_len,
+                                            struct rohc_decomp_stream *const stream)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
 static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             struct rohc_decomp_ctxt *const context,
@@ -204,19 +351,28 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const bool in_place,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
-	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 8, 9)));
 
-static rohc_status_t rohc_decomp_try_decode_pkt(const struct rohc_decomp *const decomp,
+static rohc_status_t rohc_decomp_try_decode_pkt(struct rohc_decomp *const decomp,
                                                 const struct rohc_decomp_ctxt *const context,
                                                 const rohc_packet_t packet_type,
                                                 const struct rohc_decomp_crc *const extr_crc_bits,
                                                 const void *const extr_bits,
                                                 const size_t payload_len,
                                                 void *const decoded_values,
-                                                struct rohc_buf *const uncomp_packet)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
+                                                const bool do_build_hdrs,
+                                                struct rohc_buf *const uncomp_packet,
+                                                struct rohc_perf_clock *const perf_clock)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 9, 10)));
+
+static bool rohc_decomp_set_ip_frag(const struct rohc_decomp_ctxt *const context,
+                                    uint8_t *const hdrs,
+                                    const size_t hdrs_len,
+                                    const uint16_t ipv4_frag)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static bool rohc_decomp_check_ir_crc(const struct rohc_decomp_ctxt *const context,
                                      const uint8_t *const rohc_hdr,
@@ -238,16 +394,39 @@ static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
                                        bool *const do_change_mode)
 	__attribute__((nonnull(1, 2, 5)));
 
+static bool rohc_decomp_dup_cache_match(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context,
+                                        const rohc_packet_t packet_type,
+                                        const struct rohc_buf rohc_packet,
+                                        const size_t rohc_hdr_len,
+                                        const size_t payload_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static rohc_status_t rohc_decomp_dup_cache_emit(const struct rohc_decomp_ctxt *const context,
+                                                struct rohc_buf *const uncomp_packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_decomp_dup_cache_record(const struct rohc_decomp *const decomp,
+                                         struct rohc_decomp_ctxt *const context,
+                                         const rohc_packet_t packet_type,
+                                         const struct rohc_buf rohc_packet,
+                                         const size_t rohc_hdr_len,
+                                         const size_t payload_len,
+                                         const struct rohc_buf uncomp_packet,
+                                         const size_t uncomp_hdr_len)
+	__attribute__((nonnull(1, 2)));
+
 /* functions to receive feedbacks for the same-site ROHC compressor */
-static bool rohc_decomp_parse_feedbacks(struct rohc_decomp *const decomp,
+static bool rohc_decomp_parse_feedbacks(const struct rohc_decomp *const decomp,
                                         struct rohc_buf *const rohc_data,
-                                        struct rohc_buf *const feedbacks)
+                                        struct rohc_feedback_ring *const ring,
+                                        struct rohc_buf *const feedbacks,
+                                        size_t *const feedbacks_nr)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
-static bool rohc_decomp_parse_feedback(struct rohc_decomp *const decomp,
+static bool rohc_decomp_parse_feedback(const struct rohc_decomp *const decomp,
                                        struct rohc_buf *const rohc_data,
+                                       struct rohc_feedback_ring *const ring,
                                        struct rohc_buf *const feedback,
                                        size_t *const feedback_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
 
 /* function related to the transmission of feedback to the remote ROHC compressor */
 static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
@@ -258,10 +437,65 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
                                       const struct rohc_decomp_stream *const stream,
                                       struct rohc_buf *const feedback)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_decomp_feedback_send(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_stream *const stream,
+                                      const enum rohc_feedback_ack_type ack_type,
+                                      struct d_feedback *const sfeedback,
+                                      const rohc_feedback_crc_t crc_present,
+                                      struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static bool rohc_decomp_nack_bucket_take(struct rohc_decomp *const decomp,
+                                         const rohc_cid_t cid,
+                                         const struct rohc_ts arrival_time)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+/* functions related to the reorder buffer */
+static bool rohc_decomp_reorder_hold(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_ctxt *const context,
+                                     const rohc_packet_t packet_type,
+                                     const struct rohc_buf rohc_packet,
+                                     const size_t add_cid_len,
+                                     const bool in_place,
+                                     const void *const decoded_values)
+	__attribute__((warn_unused_result, nonnull(1, 2, 7)));
+static uint32_t rohc_decomp_reorder_gap(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_reorder_slot *const slot)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+/* functions related to the reassembly of ROHC segments */
+static bool rohc_decomp_rru_is_ref(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packet)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_decomp_rru_read(const struct rohc_decomp *const decomp,
+                                 const size_t offset,
+                                 const size_t len,
+                                 uint8_t *const data)
+	__attribute__((nonnull(1, 4)));
+static void rohc_decomp_rru_flatten(struct rohc_decomp *const decomp,
+                                    const size_t rru_len)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_rru_update_crc(struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1)));
 
 /* statistics-related functions */
 static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 	__attribute__((nonnull(1)));
+static void rohc_decomp_perf_lap(struct rohc_decomp *const decomp,
+                                 struct rohc_perf_clock *const perf_clock,
+                                 const rohc_decomp_perf_phase_t phase)
+	__attribute__((nonnull(1, 2)));
+static void rohc_decomp_perf_stop(struct rohc_decomp *const decomp,
+                                  const struct rohc_perf_clock *const perf_clock)
+	__attribute__((nonnull(1, 2)));
+static void rohc_decomp_pkt_stats_add(struct rohc_decomp *const decomp,
+                                      const rohc_profile_t profile_id,
+                                      const rohc_packet_t packet_type,
+                                      const rohc_status_t status,
+                                      const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_ctxt_cost_add(const struct rohc_decomp *const decomp,
+                                      struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
 
 
 
@@ -302,23 +536,40 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
                                                 const struct rohc_ts arrival_time)
 {
 	struct rohc_decomp_ctxt *context;
+	uint8_t *ctxt_part;
 
 	assert(cid <= ROHC_LARGE_CID_MAX);
 
-	/* allocate memory for the decompression context */
-	context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
+	/* allocate one memory block for the decompression context and its
+	 * persistent profile-specific part */
+	context = rohc_mempool_alloc(&decomp->mempool, context_len(profile));
 	if(context == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
 		             "cannot allocate memory for the contexts");
 		goto error;
 	}
+	ctxt_part = ((uint8_t *) context) +
+	            rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_ctxt));
+	if(profile->persist_ctxt_len > 0)
+	{
+		context->persist_ctxt = ctxt_part;
+		ctxt_part += rohc_decomp_ctxt_part_len(profile->persist_ctxt_len);
+	}
+	else
+	{
+		context->persist_ctxt = NULL;
+	}
+	context->volat_ctxt.extr_bits = decomp->extr_bits;
+	context->volat_ctxt.decoded_values = decomp->decoded_values;
 
 	/* record the CID */
 	context->cid = cid;
 
 	/* associate the decompressor with the context */
 	context->decompressor = decomp;
+	context->used_prev = NULL;
+	context->used_next = NULL;
 
 	/* associate the decompression profile with the context */
 	context->profile = profile;
@@ -347,7 +598,9 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->crc_corr.arrival_times_index = 0;
 
 	/* init some statistics */
+	rohc_stats_write_begin(&decomp->stats_seq);
 	context->num_recv_packets = 0;
+	context->processing_ns = 0;
 	context->total_uncompressed_size = 0;
 	context->total_compressed_size = 0;
 	context->header_uncompressed_size = 0;
@@ -359,12 +612,15 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->corrected_crc_failures = 0;
 	context->corrected_sn_wraparounds = 0;
 	context->corrected_wrong_sn_updates = 0;
+	rohc_stats_write_end(&decomp->stats_seq);
 	context->nr_lost_packets = 0;
 	context->nr_misordered_packets = 0;
 	context->is_duplicated = 0;
+	context->dup_cache.rohc_hdr_len = 0;
 
 	context->first_used = arrival_time.sec;
 	context->latest_used = arrival_time.sec;
+	context->flow_id = decomp->flows_nr;
 
 	/* create the profile-specific parts of the decompression context (performed
 	 * at the every end so that everything is initialized in context first) */
@@ -380,11 +636,12 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	 * might have MAX_CID + 2 contexts) */
 	assert(decomp->num_contexts_used <= (decomp->medium.max_cid + 1));
 	decomp->num_contexts_used++;
+	decomp->flows_nr++;
 
 	return context;
 
 destroy_context:
-	zfree(context);
+	rohc_mempool_release(&decomp->mempool, context, context_len(profile));
 error:
 	return NULL;
 }
@@ -405,14 +662,256 @@ static void context_free(struct rohc_decomp_ctxt *const context)
 	           "free context with CID %u", context->cid);
 
 	/* destroy the profile-specific data */
-	context->profile->free_context(context->persist_ctxt, &context->volat_ctxt);
+	if(context->profile->free_context != NULL)
+	{
+		context->profile->free_context(context, context->persist_ctxt,
+		                               &context->volat_ctxt);
+	}
 
 	/* decompressor got one more context */
 	assert(context->decompressor->num_contexts_used > 0);
 	context->decompressor->num_contexts_used--;
 
-	/* destroy the context itself */
-	free(context);
+	/* destroy the context itself along with its profile-specific parts */
+	rohc_mempool_release(&context->decompressor->mempool, context,
+	                     context_len(context->profile));
+}
+
+
+/**
+ * @brief Add the given context at the head of the list of contexts in use
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context installed in the table
+ */
+static void rohc_decomp_ctxts_used_add(struct rohc_decomp *const decomp,
+                                       struct rohc_decomp_ctxt *const context)
+{
+	context->used_prev = NULL;
+	context->used_next = decomp->ctxts_used_first;
+	if(decomp->ctxts_used_first != NULL)
+	{
+		decomp->ctxts_used_first->used_prev = context;
+	}
+	decomp->ctxts_used_first = context;
+}
+
+
+/**
+ * @brief Remove the given context from the list of contexts in use
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context removed from the table
+ */
+static void rohc_decomp_ctxts_used_del(struct rohc_decomp *const decomp,
+                                       struct rohc_decomp_ctxt *const context)
+{
+	if(context->used_prev != NULL)
+	{
+		context->used_prev->used_next = context->used_next;
+	}
+	else
+	{
+		decomp->ctxts_used_first = context->used_next;
+	}
+	if(context->used_next != NULL)
+	{
+		context->used_next->used_prev = context->used_prev;
+	}
+	context->used_prev = NULL;
+	context->used_next = NULL;
+}
+
+
+/**
+ * @brief Restore one decompression context from its record in a context image
+ *
+ * @param decomp  The ROHC decompressor
+ * @param rec     The header of the record
+ * @param data    The generic part of the context followed by its
+ *                persistent profile-specific part
+ * @param now     The current time
+ * @return        true if the context was restored, false if it was skipped
+ */
+static bool rohc_decomp_restore_context(struct rohc_decomp *const decomp,
+                                        const struct rohc_ctxt_image_rec *const rec,
+                                        const uint8_t *const data,
+                                        const struct rohc_ts now)
+{
+	const struct rohc_decomp_profile *profile;
+	struct rohc_decomp_ctxt_image generic;
+	struct rohc_decomp_ctxt *context;
+
+	profile = find_profile(decomp, rec->profile_id);
+	if(profile == NULL || !profile->persist_ctxt_is_flat)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "skip context with CID %u of context image: profile "
+		             "0x%04x cannot be restored", rec->cid, rec->profile_id);
+		goto error;
+	}
+	if(rec->cid > decomp->medium.max_cid)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "skip context with CID %u of context image: CID greater "
+		             "than MAX_CID %u", rec->cid, decomp->medium.max_cid);
+		goto error;
+	}
+	if(rec->generic_len != sizeof(struct rohc_decomp_ctxt_image) ||
+	   rec->profile_len != profile->persist_ctxt_len)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "skip context with CID %u of context image: unexpected "
+		             "lengths %u and %u", rec->cid, rec->generic_len,
+		             rec->profile_len);
+		goto error;
+	}
+	memcpy(&generic, data, sizeof(struct rohc_decomp_ctxt_image));
+	if(generic.mode < ROHC_U_MODE || generic.mode > ROHC_R_MODE ||
+	   generic.state < ROHC_DECOMP_STATE_NC || generic.state > ROHC_DECOMP_STATE_FC)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "skip context with CID %u of context image: malformed "
+		             "generic part", rec->cid);
+		goto error;
+	}
+
+	context = context_create(decomp, rec->cid, profile, now);
+	if(context == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "skip context with CID %u of context image: failed to "
+		             "create context", rec->cid);
+		goto error;
+	}
+	context->mode = generic.mode;
+	context->state = generic.state;
+	context->last_pkts_errors = generic.last_pkts_errors;
+	rohc_stats_write_begin(&decomp->stats_seq);
+	context->num_recv_packets = generic.num_recv_packets;
+	rohc_stats_write_end(&decomp->stats_seq);
+	if(profile->persist_ctxt_len > 0)
+	{
+		memcpy(context->persist_ctxt, data + rec->generic_len,
+		       profile->persist_ctxt_len);
+	}
+
+	/* replace the context that may use the CID */
+	if(decomp->contexts[rec->cid] != NULL)
+	{
+		rohc_decomp_ctxt_event(decomp->contexts[rec->cid],
+		                       ROHC_DECOMP_CTXT_EVENT_FREED);
+		rohc_decomp_ctxts_used_del(decomp, decomp->contexts[rec->cid]);
+		if(decomp->last_context == decomp->contexts[rec->cid])
+		{
+			decomp->last_context = NULL;
+		}
+		context_free(decomp->contexts[rec->cid]);
+	}
+	decomp->contexts[rec->cid] = context;
+	rohc_decomp_ctxts_used_add(decomp, context);
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, profile->id,
+	           "context with CID %u restored in state %d and mode %d",
+	           context->cid, context->state, context->mode);
+	rohc_decomp_ctxt_event(context, ROHC_DECOMP_CTXT_EVENT_CREATED);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Notify the user of one event of the life of a decompression context
+ *
+ * Nothing is done if no callback was set with
+ * \ref rohc_decomp_set_ctxt_event_cb.
+ *
+ * @param context  The decompression context
+ * @param type     The type of the event
+ */
+static void rohc_decomp_ctxt_event(const struct rohc_decomp_ctxt *const context,
+                                   const rohc_decomp_ctxt_event_type_t type)
+{
+	const struct rohc_decomp *const decomp = context->decompressor;
+
+	if(decomp->ctxt_event_cb != NULL)
+	{
+		const struct rohc_decomp_ctxt_event event = {
+			.type = type,
+			.cid = context->cid,
+			.profile_id = context->profile->id,
+			.state = context->state,
+			.mode = context->mode,
+		};
+		decomp->ctxt_event_cb(decomp, &event, decomp->ctxt_event_cb_priv);
+	}
+}
+
+
+/**
+ * @brief Get the length of the memory block of one decompression context
+ *
+ * The block holds the context, then the persistent part of the profile, each
+ * of them aligned. The extracted bits and the decoded values are not part of
+ * the block, they are shared by all the contexts of the decompressor.
+ *
+ * @param profile  The profile of the context
+ * @return         The length of the memory block of the context
+ */
+static size_t context_len(const struct rohc_decomp_profile *const profile)
+{
+	return rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_ctxt)) +
+	       rohc_decomp_ctxt_part_len(profile->persist_ctxt_len);
+}
+
+
+/**
+ * @brief Create the scratch memory shared by all the decompression contexts
+ *
+ * The extracted bits and the decoded values are used only during the
+ * decompression of one single packet, so all the contexts of the
+ * decompressor share one memory block large enough for every profile.
+ *
+ * @param decomp  The decompressor
+ * @return        true if the scratch memory was created, false otherwise
+ */
+static bool rohc_decomp_create_scratch(struct rohc_decomp *const decomp)
+{
+	size_t extr_bits_len = 0;
+	size_t decoded_values_len = 0;
+	uint8_t profile_major;
+
+	for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
+	{
+		uint8_t profile_minor;
+
+		for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
+		{
+			const struct rohc_decomp_profile *const profile =
+				rohc_decomp_profiles[profile_major][profile_minor];
+
+			if(profile != NULL)
+			{
+				extr_bits_len = rohc_max(extr_bits_len, profile->extr_bits_len);
+				decoded_values_len =
+					rohc_max(decoded_values_len, profile->decoded_values_len);
+			}
+		}
+	}
+	extr_bits_len = rohc_decomp_ctxt_part_len(extr_bits_len);
+	decoded_values_len = rohc_decomp_ctxt_part_len(decoded_values_len);
+
+	decomp->extr_bits = calloc(1, extr_bits_len + decoded_values_len);
+	if(decomp->extr_bits == NULL)
+	{
+		return false;
+	}
+	decomp->decoded_values = ((uint8_t *) decomp->extr_bits) + extr_bits_len;
+
+	return true;
 }
 
 
@@ -525,6 +1024,14 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	/* no trace callback during decompressor creation */
 	decomp->trace_callback = NULL;
 	decomp->trace_callback_priv = NULL;
+	decomp->trace_level = ROHC_TRACE_DEBUG; /* all traces by default */
+
+	/* no notification of the events of contexts by default */
+	decomp->ctxt_event_cb = NULL;
+	decomp->ctxt_event_cb_priv = NULL;
+
+	/* use the tables of the library for all the CRCs */
+	memset(&decomp->crc_engine, 0, sizeof(struct rohc_crc_engine));
 
 	/* default feature set (empty for the moment) */
 	decomp->features = ROHC_DECOMP_FEATURE_NONE;
@@ -547,14 +1054,27 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	/* the operational mode the decompressor shall target for all its contexts */
 	decomp->target_mode = mode;
 
+	/* no memory for contexts yet */
+	rohc_mempool_init(&decomp->mempool);
+	decomp->channel_set = NULL;
+
+	/* the scratch memory for the volatile parts of all contexts */
+	is_fine = rohc_decomp_create_scratch(decomp);
+	if(!is_fine)
+	{
+		goto destroy_decomp;
+	}
+
 	/* initialize the array of decompression contexts to its minimal value */
 	decomp->contexts = NULL;
 	decomp->num_contexts_used = 0;
+	decomp->flows_nr = 0;
 	is_fine = rohc_decomp_create_contexts(decomp, decomp->medium.max_cid);
 	if(!is_fine)
 	{
-		goto destroy_decomp;
+		goto free_scratch;
 	}
+	decomp->ctxts_used_first = NULL;
 	decomp->last_context = NULL;
 
 	/* counters and thresholds for feedbacks and downward state transitions */
@@ -575,17 +1095,41 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
 	}
 
+	/* no feedback accumulated yet */
+	decomp->feedbacks_pending_nr = 0;
+	/* no feedback ring by default */
+	decomp->feedback_ring = NULL;
+
+	/* no reorder buffer by default */
+	decomp->reorder_slots = NULL;
+	decomp->reorder_depth = 0;
+	decomp->reorder_max_delay = 0;
+	decomp->reorder_held_nr = 0;
+	decomp->reorder_releasing = false;
+
 	/* no Reconstructed Reception Unit (RRU) at the moment */
 	decomp->rru_len = 0;
+	decomp->rru_segs_nr = 0;
+	decomp->rru_copied_len = 0;
+	decomp->rru_crc = CRC_INIT_FCS32;
+	decomp->rru_crc_len = 0;
+	/* contiguous ROHC packets by default */
+	decomp->chain_by_ref = false;
+	decomp->chain_tail_len = 0;
+	decomp->chain_head_payload = NULL;
+	decomp->chain_head_payload_len = 0;
 	/* no segmentation by default */
 	decomp->mrru = 0;
 	decomp->rru = NULL;
 
 	/* reset the decompressor statistics */
+	decomp->stats_seq = 0;
 	rohc_decomp_reset_stats(decomp);
 
 	return decomp;
 
+free_scratch:
+	free(decomp->extr_bits);
 destroy_decomp:
 	free(decomp);
 error:
@@ -640,12 +1184,19 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 		}
 	}
 	zfree(decomp->contexts);
+	zfree(decomp->nack_buckets);
 	assert(decomp->num_contexts_used == 0);
+	zfree(decomp->reorder_slots);
+	free(decomp->extr_bits);
 
 	/* free RRU buffer */
-	if(decomp->rru != NULL)
+	rohc_mempool_release(&decomp->mempool, decomp->rru, decomp->mrru);
+	decomp->rru = NULL;
+
+	rohc_mempool_free(&decomp->mempool);
+	if(decomp->channel_set != NULL)
 	{
-		zfree(decomp->rru);
+		rohc_channel_set_leave(decomp->channel_set);
 	}
 
 	/* destroy the decompressor itself */
@@ -656,6 +1207,99 @@ error:
 }
 
 
+/**
+ * @brief Reset the decompressor as if it was just created and configured
+ *
+ * Free all the decompression contexts and forget the state of the ROHC
+ * channel: the feedbacks not sent yet, the ROHC segments received so far
+ * and the statistics. The configuration of the decompressor, eg. the enabled
+ * profiles, the MRRU, the feedback rate limits and all the callbacks, is kept
+ * as is, so is the memory allocated for the table of contexts. The memory of
+ * the freed contexts goes back to the memory pool of the decompressor for the
+ * next contexts.
+ *
+ * The function is meant to recover from the loss of the ROHC channel, eg. on
+ * a link flap, without the cost of destroying the decompressor, creating and
+ * configuring a new one. The compressor of the remote ROHC endpoint shall be
+ * reset too, see \ref rohc_comp_reset.
+ *
+ * The \ref ROHC_DECOMP_CTXT_EVENT_FREED event is notified for every freed
+ * context if a callback was set with \ref rohc_decomp_set_ctxt_event_cb.
+ *
+ * @param decomp  The ROHC decompressor
+ * @return        true if the decompressor was reset, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_comp_reset
+ */
+bool rohc_decomp_reset(struct rohc_decomp *const decomp)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "reset decompressor: free all %u contexts",
+	          decomp->num_contexts_used);
+
+	/* free all the contexts */
+	while(decomp->ctxts_used_first != NULL)
+	{
+		struct rohc_decomp_ctxt *const context = decomp->ctxts_used_first;
+
+		rohc_decomp_ctxt_event(context, ROHC_DECOMP_CTXT_EVENT_FREED);
+		rohc_decomp_ctxts_used_del(decomp, context);
+		decomp->contexts[context->cid] = NULL;
+		context_free(context);
+	}
+	assert(decomp->num_contexts_used == 0);
+	decomp->last_context = NULL;
+
+	/* forget the feedbacks */
+	decomp->last_pkts_errors = 0;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed = 0;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent = 0;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed = 0;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent = 0;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed = 0;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
+	memset(decomp->nack_buckets, 0,
+	       (decomp->medium.max_cid + 1) * sizeof(struct rohc_decomp_nack_bucket));
+	decomp->feedbacks_pending_nr = 0;
+
+	/* drop the packets held by the reorder buffer */
+	if(decomp->reorder_slots != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < ROHC_DECOMP_REORDER_SLOTS_NR; i++)
+		{
+			decomp->reorder_slots[i].len = 0;
+		}
+	}
+	decomp->reorder_held_nr = 0;
+
+	/* drop the ROHC segments received so far */
+	decomp->rru_len = 0;
+	decomp->rru_segs_nr = 0;
+	decomp->rru_copied_len = 0;
+	decomp->rru_crc = CRC_INIT_FCS32;
+	decomp->rru_crc_len = 0;
+
+	/* reset statistics */
+	rohc_stats_write_begin(&decomp->stats_seq);
+	rohc_decomp_reset_stats(decomp);
+	rohc_stats_write_end(&decomp->stats_seq);
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Decompress the given ROHC packet into one uncompressed packet
  *
@@ -698,6 +1342,10 @@ error:
  *                                 decompression context matches the CID
  *                                 stored in the given ROHC packet and the
  *                                 ROHC packet is not an IR packet
+ *                            \li \ref ROHC_STATUS_NO_MEMORY if the ROHC
+ *                                packet required a new context that could
+ *                                not be created within the memory budget
+ *                                set by \ref rohc_decomp_set_mem_budget
  *                            \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
  *                                output buffer is too small for the
  *                                compressed packet
@@ -729,24 +1377,49 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
                                struct rohc_buf *const rcvd_feedback,
                                struct rohc_buf *const feedback_send)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	struct rohc_decomp_stream stream;
+	return rohc_decompress4(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
+	                        feedback_send, NULL);
+}
 
-	/* check inputs validity */
-	if(decomp == NULL)
-	{
-		goto error;
-	}
-	if(rohc_buf_is_malformed(rohc_packet))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
-		goto error;
-	}
-	if(rohc_buf_is_empty(rohc_packet))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is empty");
+
+/**
+ * @brief Decompress the given ROHC packet and report about it
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 does, and fill
+ * the given structure with some information about the decompressed packet
+ * at the same time. The information is the one that
+ * \ref rohc_decomp_get_last_packet_info would return, without the cost of a
+ * second call.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer, see
+ *                            \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @param[out] info           The information about the decompressed packet,
+ *                            filled only if \ref ROHC_STATUS_OK is returned
+ *                            and \e uncomp_packet is not empty, but the
+ *                            references to the piggybacked feedbacks that are
+ *                            filled whenever \ref ROHC_STATUS_OK is returned,
+ *                            may be NULL
+ * @return                    The same status values as \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress4(struct rohc_decomp *const decomp,
+                               const struct rohc_buf rohc_packet,
+                               struct rohc_buf *const uncomp_packet,
+                               struct rohc_buf *const rcvd_feedback,
+                               struct rohc_buf *const feedback_send,
+                               struct rohc_decomp_pkt_info *const info)
+{
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
 		goto error;
 	}
 	if(uncomp_packet == NULL)
@@ -767,1656 +1440,4435 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 		             "given uncomp_packet is not empty");
 		goto error;
 	}
-	if(rcvd_feedback != NULL)
+
+	return rohc_decomp_decompress_pkt(decomp, rohc_packet, uncomp_packet,
+	                                  rcvd_feedback, feedback_send, false, info);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet in place
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 does, but write
+ * the uncompressed packet in the memory of the ROHC packet instead of a
+ * separate output buffer. The payload is not moved: the uncompressed headers
+ * are written right before the payload, in place of the ROHC header and of
+ * the headroom of the buffer.
+ *
+ * The headroom of the buffer, ie. its \e offset, is also used as a scratch
+ * area to build the uncompressed headers before they are moved in front of
+ * the payload, so the headroom shall be large enough for the uncompressed
+ * headers. If it is not, \ref ROHC_STATUS_OUTPUT_TOO_SMALL is returned.
+ *
+ * ROHC segments cannot be decompressed in place since the reconstructed
+ * packet does not fit in the memory of one segment: use
+ * \ref rohc_decompress3 for them.
+ *
+ * Normal packets of the Uncompressed profile are stripped of their CID in
+ * place: only the first byte of the packet is moved, the rest of the packet
+ * is neither copied nor moved.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[in,out] pkt         in: the ROHC packet to decompress,
+ *                            out: the resulting uncompressed packet if
+ *                            decompression is successful, unchanged
+ *                            otherwise (the packet is empty if the ROHC
+ *                            packet contained feedback only)
+ * @param[out] rcvd_feedback  The feedback received from the remote peer, see
+ *                            \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @return                    The same status values as \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_in_place(struct rohc_decomp *const decomp,
+                                       struct rohc_buf *const pkt,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf uncomp_packet;
+	rohc_status_t status;
+
+	/* check inputs validity */
+	if(decomp == NULL)
 	{
-		if(rohc_buf_is_malformed(*rcvd_feedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given rcvd_feedback is malformed");
-			goto error;
-		}
-		if(!rohc_buf_is_empty(*rcvd_feedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given rcvd_feedback is not empty");
-			goto error;
-		}
+		goto error;
 	}
-	if(feedback_send != NULL)
+	if(pkt == NULL)
 	{
-		if(rohc_buf_is_malformed(*feedback_send))
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is NULL");
+		goto error;
+	}
+
+	/* build the uncompressed headers in the headroom of the buffer, it does
+	 * not overlap with the ROHC header that is read during decompression */
+	uncomp_packet = *pkt;
+	uncomp_packet.max_len = pkt->offset;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
+
+	status = rohc_decomp_decompress_pkt(decomp, *pkt, &uncomp_packet,
+	                                    rcvd_feedback, feedback_send, true, NULL);
+	if(status == ROHC_STATUS_OK)
+	{
+		if(uncomp_packet.len > 0)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given feedback_send is malformed");
-			goto error;
+			/* uncompressed headers were moved in front of the payload */
+			pkt->offset = uncomp_packet.offset;
 		}
-		if(!rohc_buf_is_empty(*feedback_send))
+		else
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given feedback_send is not empty");
-			goto error;
+			/* feedback-only packet */
+			pkt->offset += pkt->len;
 		}
+		pkt->len = uncomp_packet.len;
 	}
 
-	decomp->stats.received++;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
-	           decomp->stats.received);
+	return status;
 
-	/* print compressed bytes */
-	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
-	{
-		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
-		                 "compressed data, max 100 bytes", rohc_packet);
-	}
+error:
+	return ROHC_STATUS_ERROR;
+}
 
-	/* decode ROHC header */
-	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
-	                         &stream);
-	assert(status != ROHC_STATUS_SEGMENT);
 
-	/* handle mode transitions if context was found and it is still valid */
-	if(stream.context != NULL)
+/**
+ * @brief Decompress the given ROHC packet stored in a chain of buffers
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 does, but the
+ * ROHC packet is stored in several non-contiguous segments, eg. a header
+ * buffer followed by payload pages. The whole ROHC header, feedbacks and
+ * padding included, shall be in the first segment, the other segments hold
+ * payload only.
+ *
+ * Only the uncompressed headers are written in the \e uncomp_hdrs output
+ * buffer. The payload is not copied: the \e payload chain is set to
+ * reference the payload where it is, ie. the end of the first segment behind
+ * the ROHC header if it is not empty, then the other segments unchanged. The
+ * full uncompressed packet is the uncompressed headers followed by the
+ * segments of the \e payload chain. They are valid only as long as the
+ * memory of \e rohc_chain is.
+ *
+ * ROHC segments cannot be decompressed from a chain of buffers, and the
+ * packets are never held by the reorder buffer.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_chain          The ROHC packet to decompress
+ * @param[out] uncomp_hdrs    The resulting uncompressed headers, empty if the
+ *                            ROHC packet contained feedback only
+ * @param[out] payload        The payload of the uncompressed packet, within
+ *                            the memory of \e rohc_chain, it shall be able to
+ *                            hold as many segments as \e rohc_chain
+ * @param[out] rcvd_feedback  The feedback received from the remote peer, see
+ *                            \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @return                    The same status values as \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ * @see rohc_compress_chain
+ */
+rohc_status_t rohc_decompress_chain(struct rohc_decomp *const decomp,
+                                    const struct rohc_buf_chain rohc_chain,
+                                    struct rohc_buf *const uncomp_hdrs,
+                                    struct rohc_buf_chain *const payload,
+                                    struct rohc_buf *const rcvd_feedback,
+                                    struct rohc_buf *const feedback_send)
+{
+	const struct rohc_buf *head;
+	rohc_status_t status;
+	size_t i;
+
+	/* check inputs validity */
+	if(decomp == NULL)
 	{
-		if(stream.context->mode == ROHC_U_MODE)
-		{
-			if(decomp->target_mode == ROHC_U_MODE)
-			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "stay in U-mode as requested by user");
-			}
-			else if(decomp->target_mode == ROHC_O_MODE)
-			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "transit from U-mode to O-mode as requested by user");
-				stream.context->mode = ROHC_O_MODE;
-				/* ACK(O), NACK(O) or STATIC-NACK(O) will transmit the mode
-				 * transition to the remote compressor */
-				stream.mode = ROHC_O_MODE;
-				stream.do_change_mode = true;
-			}
-			else /* R-mode */
-			{
-				assert(0); /* TODO: R-mode not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
-			}
-		}
-		else if(stream.context->mode == ROHC_O_MODE)
-		{
-			if(decomp->target_mode == ROHC_U_MODE)
-			{
-				assert(0); /* TODO: O- to U-mode transition not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
-			}
-			else if(decomp->target_mode == ROHC_O_MODE)
-			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "stay in O-mode as requested by user");
-			}
-			else /* R-mode */
-			{
-				assert(0); /* TODO: R-mode not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
-			}
-		}
-		else /* R-mode */
+		goto error;
+	}
+	if(rohc_chain.segs == NULL || rohc_chain.segs_nr == 0 ||
+	   rohc_chain.segs_nr > rohc_chain.segs_max)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_chain is malformed");
+		goto error;
+	}
+	for(i = 1; i < rohc_chain.segs_nr; i++)
+	{
+		if(rohc_buf_is_malformed(rohc_chain.segs[i]))
 		{
-			assert(0); /* TODO: R-mode not supported yet */
-			status = ROHC_STATUS_ERROR;
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "segment #%zu of given rohc_chain is malformed", i + 1);
 			goto error;
 		}
 	}
-
-	/* update statistics and send feedback if needed */
-	if(status == ROHC_STATUS_OK)
+	if(uncomp_hdrs == NULL)
 	{
-		/* print a trace to report success (the context may be NULL if packet
-		 * was a feedback-only packet) */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-		           "packet decompression succeeded");
-
-		/* do not update statistics and build positive feedback for feedback-only
-		 * packets */
-		if(uncomp_packet->len > 0)
-		{
-			/* update statistics */
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-			           "update decompressor and context statistics");
-			assert(stream.context != NULL);
-			stream.context->num_recv_packets++;
-			stream.context->last_packet_type = stream.packet_type;
-			stream.context->total_last_uncompressed_size = uncomp_packet->len;
-			stream.context->total_uncompressed_size += uncomp_packet->len;
-			stream.context->total_last_compressed_size = rohc_packet.len;
-			stream.context->total_compressed_size += rohc_packet.len;
-			decomp->stats.total_uncompressed_size += uncomp_packet->len;
-			decomp->stats.total_compressed_size += rohc_packet.len;
-
-			/* build positive feedback if asked by user and if needed by decompressor */
-			if(!rohc_decomp_feedback_ack(decomp, &stream, feedback_send))
-			{
-				rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				             "failed to build positive feedback");
-				status = ROHC_STATUS_ERROR;
-				goto error;
-			}
-		}
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_hdrs is NULL");
+		goto error;
 	}
-	else /* packet failed to be decompressed */
+	if(rohc_buf_is_malformed(*uncomp_hdrs))
 	{
-		/* in case of failure, users shall get an empty decompressed packet */
-		uncomp_packet->len = 0;
-
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-		             "packet decompression failed: %s (%d)",
-		             rohc_strerror(status), status);
-
-		/* update statistics */
-		if(stream.context != NULL)
-		{
-			stream.context->num_recv_packets++;
-		}
-		switch(status)
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_hdrs is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*uncomp_hdrs))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_hdrs is not empty");
+		goto error;
+	}
+	if(payload == NULL || payload->segs == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given payload is NULL");
+		goto error;
+	}
+	if(payload->segs_max < rohc_chain.segs_nr)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given payload may hold %zu segments, but %zu segments "
+		             "may be required", payload->segs_max, rohc_chain.segs_nr);
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	head = &rohc_chain.segs[0];
+
+	/* only the first segment is parsed, the length of the other ones is
+	 * accounted in the length of the payload */
+	decomp->chain_by_ref = true;
+	decomp->chain_tail_len = rohc_buf_chain_len(rohc_chain) - head->len;
+	decomp->chain_head_payload = NULL;
+	decomp->chain_head_payload_len = 0;
+	status = rohc_decomp_decompress_pkt(decomp, *head, uncomp_hdrs,
+	                                    rcvd_feedback, feedback_send, false, NULL);
+	decomp->chain_by_ref = false;
+	decomp->chain_tail_len = 0;
+
+	/* reference the payload: the end of the first segment, then the other
+	 * segments unchanged */
+	payload->segs_nr = 0;
+	if(status == ROHC_STATUS_OK && decomp->chain_head_payload != NULL)
+	{
+		if(decomp->chain_head_payload_len > 0)
 		{
-			case ROHC_STATUS_MALFORMED:
-			case ROHC_STATUS_OUTPUT_TOO_SMALL:
-			case ROHC_STATUS_ERROR:
-				decomp->stats.failed_decomp++;
-				break;
-			case ROHC_STATUS_NO_CONTEXT:
-				decomp->stats.failed_no_context++;
-				break;
-			case ROHC_STATUS_BAD_CRC:
-				decomp->stats.failed_crc++;
-				break;
-			case ROHC_STATUS_OK: /* success codes shall not happen */
-			case ROHC_STATUS_SEGMENT:
-			default:
-				assert(0);
-				status = ROHC_STATUS_ERROR;
-				goto error;
-		}
+			struct rohc_buf *const head_payload = &payload->segs[payload->segs_nr];
 
-		/* build negative feedback if asked by user and if needed by decompressor */
-		if(!rohc_decomp_feedback_nack(decomp, &stream, feedback_send))
+			*head_payload = *head;
+			head_payload->offset = decomp->chain_head_payload - head->data;
+			head_payload->len = decomp->chain_head_payload_len;
+			payload->segs_nr++;
+		}
+		for(i = 1; i < rohc_chain.segs_nr; i++)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-			             "failed to build negative feedback");
-			status = ROHC_STATUS_ERROR;
-			goto error;
+			payload->segs[payload->segs_nr] = rohc_chain.segs[i];
+			payload->segs_nr++;
 		}
 	}
+	decomp->chain_head_payload = NULL;
+	decomp->chain_head_payload_len = 0;
 
-error:
 	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+/**
+ * @brief Decompress a burst of ROHC packets
+ *
+ * Decompress the given ROHC packets as \ref rohc_decompress_burst2 does,
+ * without feedback buffers per packet: the feedbacks received from the
+ * remote peer and the feedbacks built by the decompressor are stored in the
+ * ring of feedbacks linked with \ref rohc_decomp_set_feedback_ring, or
+ * accumulated until \ref rohc_decomp_flush_feedback is called if feedback
+ * coalescing is enabled. They are lost otherwise.
+ *
+ * @param decomp            The ROHC decompressor
+ * @param rohc_pkts         The ROHC packets to decompress
+ * @param[out] uncomp_pkts  The resulting uncompressed packets, every buffer
+ *                          shall be empty as for \ref rohc_decompress4
+ * @param[out] statuses     The status of every packet, see
+ *                          \ref rohc_decompress3 for the possible values
+ * @param[out] infos        The information about every packet, filled only
+ *                          for the packets with status \ref ROHC_STATUS_OK,
+ *                          may be NULL
+ * @param pkts_nr           The number of packets in the burst
+ * @return                  The number of packets that were processed, ie. the
+ *                          number of valid entries in \e statuses
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress_burst2
+ * @see rohc_decomp_set_feedback_ring
+ */
+size_t rohc_decompress_burst(struct rohc_decomp *const decomp,
+                             const struct rohc_buf *const rohc_pkts,
+                             struct rohc_buf *const uncomp_pkts,
+                             rohc_status_t *const statuses,
+                             struct rohc_decomp_pkt_info *const infos,
+                             const size_t pkts_nr)
+{
+	return rohc_decompress_burst2(decomp, rohc_pkts, uncomp_pkts, NULL, NULL,
+	                              statuses, infos, pkts_nr);
 }
 
 
 /**
- * @brief Decompress the compressed headers.
+ * @brief Decompress a burst of ROHC packets with feedback buffers per packet
  *
- * @param decomp              The ROHC decompressor
- * @param rohc_packet         The ROHC packet to decode
- * @param[out] uncomp_packet  The uncompressed packet
- * @param[out] rcvd_feedback  The feedback received from the remote peer for
- *                            the same-side associated ROHC compressor through
- *                            the feedback channel:
- *                            \li If NULL, ignore the received feedback data
- *                            \li If not NULL, store the received feedback in
- *                                at the given address
- * @param[out] stream         The information about the decompressed stream,
- *                            required for sending feedback to compressor
- * @return                    Possible return values:
- *                            \li ROHC_STATUS_OK if packet is successfully
- *                                decoded,
- *                            \li ROHC_STATUS_NO_CONTEXT if no matching
- *                                context was found and packet cannot create
- *                                a new context (or failed to do so),
- *                            \li ROHC_STATUS_MALFORMED if packet is
- *                                malformed,
- *                            \li ROHC_STATUS_BAD_CRC if a CRC error occurs,
- *                            \li ROHC_STATUS_ERROR if another error occurs
+ * Decompress the given ROHC packets, one after the other, as
+ * \ref rohc_decompress4 would do for every single packet. The status of every
+ * packet is stored in the \e statuses array.
+ *
+ * Decompressing a burst of packets is cheaper than calling
+ * \ref rohc_decompress4 for every packet: the decompressor and the arrays
+ * are checked only once per burst, and the CIDs of the next packets of the
+ * burst are decoded and their contexts are prefetched before the packets
+ * are decompressed, so that the profiles work on contexts that are already
+ * in cache.
+ *
+ * The feedback buffers work as the ones of \ref rohc_decompress3, with one
+ * buffer per packet. If one array of feedback buffers is NULL, the related
+ * feedbacks are handled as \ref rohc_decompress_burst does.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param rohc_pkts            The ROHC packets to decompress
+ * @param[out] uncomp_pkts     The resulting uncompressed packets, every
+ *                             buffer shall be empty as for
+ *                             \ref rohc_decompress4
+ * @param[out] rcvd_feedbacks  The feedbacks received from the remote peer
+ *                             within every packet, may be NULL
+ * @param[out] feedbacks_send  The feedbacks to be transmitted to the remote
+ *                             compressor for every packet, may be NULL
+ * @param[out] statuses        The status of every packet, see
+ *                             \ref rohc_decompress3 for the possible values
+ * @param[out] infos           The information about every packet, filled
+ *                             only for the packets with status
+ *                             \ref ROHC_STATUS_OK, may be NULL
+ * @param pkts_nr              The number of packets in the burst
+ * @return                     The number of packets that were processed, ie.
+ *                             the number of valid entries in \e statuses
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ * @see rohc_decompress_burst
  */
-static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
-                                     const struct rohc_buf rohc_packet,
-                                     struct rohc_buf *const uncomp_packet,
-                                     struct rohc_buf *const rcvd_feedback,
-                                     struct rohc_decomp_stream *const stream)
+size_t rohc_decompress_burst2(struct rohc_decomp *const decomp,
+                              const struct rohc_buf *const rohc_pkts,
+                              struct rohc_buf *const uncomp_pkts,
+                              struct rohc_buf *const rcvd_feedbacks,
+                              struct rohc_buf *const feedbacks_send,
+                              rohc_status_t *const statuses,
+                              struct rohc_decomp_pkt_info *const infos,
+                              const size_t pkts_nr)
 {
-	const struct rohc_decomp_profile *profile;
-	bool is_new_context = false;
-	size_t sn_feedback_min_bits;
-	size_t add_cid_len;
-	size_t large_cid_len;
-
-	struct rohc_buf remain_rohc_data = rohc_packet;
-	const uint8_t *walk;
-	size_t remain_len;
-
-	rohc_status_t status;
-
-	/* at the beginning, context is not found yet but channel CID type is known */
-	stream->profile_id = ROHC_PROFILE_GENERAL;
-	stream->cid_type = decomp->medium.cid_type;
-	stream->cid_found = false;
-	stream->cid = UINT16_MAX;
-	stream->context_found = false;
-	stream->context = NULL;
-	stream->mode = ROHC_UNKNOWN_MODE;
-	stream->state = ROHC_DECOMP_STATE_UNKNOWN;
-	stream->do_change_mode = false;
-	stream->sn_bits = 0; /* must be set to 0 until we get some bits */
-	stream->sn_bits_nr = 0;
-	stream->packet_type = ROHC_PACKET_UNKNOWN;
-	stream->crc_failed = false;
+	size_t i;
 
-	/* empty ROHC packets are not considered as valid */
-	if(remain_rohc_data.len < 1)
+	/* check inputs validity */
+	if(decomp == NULL)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "ROHC packet too small (len = %zu, at least 1 byte "
-		             "required)", remain_rohc_data.len);
-		goto error_malformed;
+		goto error;
 	}
-
-	/* skip padding bits if some are present */
-	rohc_decomp_parse_padding(decomp, &remain_rohc_data);
-
-	/* padding-only packets are not allowed according to RFC 3095, §5.2:
-	 *   Padding is any number (zero or more) of padding octets.  Either of
-	 *   Feedback or Header must be present. */
-	if(remain_rohc_data.len == 0)
+	if(rohc_pkts == NULL || uncomp_pkts == NULL || statuses == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "padding-only packet is not allowed");
-		goto error_malformed;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packets or statuses are NULL");
+		goto error;
 	}
 
-	/* extract feedback items if present */
-	if(!rohc_decomp_parse_feedbacks(decomp, &remain_rohc_data, rcvd_feedback))
+	for(i = 0; i < pkts_nr; i++)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "failed to decode feedback items at the beginning of the "
-		             "ROHC packet");
-		goto error_malformed;
+		/* look up the contexts of the next packets before decompressing them */
+		if((i % ROHC_DECOMP_BURST_PREFETCH_NR) == 0)
+		{
+			rohc_decomp_burst_prefetch(decomp, rohc_pkts + i,
+			                           rohc_min(pkts_nr - i,
+			                                    ROHC_DECOMP_BURST_PREFETCH_NR));
+		}
+
+		if(rohc_buf_is_malformed(uncomp_pkts[i]) ||
+		   !rohc_buf_is_empty(uncomp_pkts[i]))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given uncomp_packet #%zu is malformed or not empty",
+			             i + 1);
+			statuses[i] = ROHC_STATUS_ERROR;
+			continue;
+		}
+
+		statuses[i] =
+			rohc_decomp_decompress_pkt(decomp, rohc_pkts[i], &uncomp_pkts[i],
+			                           (rcvd_feedbacks != NULL ?
+			                            &rcvd_feedbacks[i] : NULL),
+			                           (feedbacks_send != NULL ?
+			                            &feedbacks_send[i] : NULL),
+			                           false, (infos != NULL ? &infos[i] : NULL));
 	}
-	if(rcvd_feedback != NULL)
+
+	return i;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Decompress a burst of ROHC packets and coalesce the TCP segments
+ *
+ * Decompress the given ROHC packets as \ref rohc_decompress_burst does, then
+ * coalesce the consecutive IP/TCP segments of one same context into one
+ * super-packet as the Generic Receive Offload (GRO) of a network device
+ * would do: the host stack, or the TUN interface the packets are written to,
+ * pays its per-packet overhead only once per train of segments.
+ *
+ * A decompressed packet is appended to the previous one if:
+ *  - both packets were decompressed by the same ROHCv1 IP/TCP context,
+ *  - both packets are one IPv4 header without options nor fragmentation or
+ *    one IPv6 header without extension headers, followed by the TCP header,
+ *  - the headers of both packets are the same, but the lengths, the IP-ID,
+ *    the TCP sequence number, the CWR, PSH and FIN flags, and the checksums,
+ *  - the IP-ID and the TCP sequence number of the packet follow the ones of
+ *    the previous packet, and no SYN, RST or URG flag is set,
+ *  - the previous packet has neither the PSH nor the FIN flag, and the
+ *    payload of the packet is not longer than the one of the first packet
+ *    of the train, all the segments but the last one have the same length,
+ *  - the coalesced packet fits in the buffer of the first packet of the
+ *    train, and in 64 KB.
+ *
+ * The coalesced packet is stored in the buffer of the first packet of the
+ * train: its headers are the ones of the first packet with the lengths of
+ * the coalesced packet, and the PSH and FIN flags of the last packet. Its
+ * IPv4 and TCP checksums are valid: the TCP checksum is derived from the
+ * checksums of the segments without reading their payloads again. The
+ * buffers of the next packets of the train are left empty, their status is
+ * \ref ROHC_STATUS_OK and the \e segs_nr field of their GRO information is
+ * zero.
+ *
+ * Feedbacks are handled as \ref rohc_decompress_burst does.
+ *
+ * @param decomp            The ROHC decompressor
+ * @param rohc_pkts         The ROHC packets to decompress
+ * @param[out] uncomp_pkts  The resulting uncompressed packets, every buffer
+ *                          shall be empty as for \ref rohc_decompress4
+ * @param[out] statuses     The status of every packet, see
+ *                          \ref rohc_decompress3 for the possible values
+ * @param[out] gro_infos    The GRO information about every packet, valid
+ *                          only for the packets with status
+ *                          \ref ROHC_STATUS_OK
+ * @param pkts_nr           The number of packets in the burst
+ * @return                  The number of packets that were processed, ie. the
+ *                          number of valid entries in \e statuses
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress_burst
+ */
+size_t rohc_decompress_burst_gro(struct rohc_decomp *const decomp,
+                                 const struct rohc_buf *const rohc_pkts,
+                                 struct rohc_buf *const uncomp_pkts,
+                                 rohc_status_t *const statuses,
+                                 struct rohc_decomp_gro_info *const gro_infos,
+                                 const size_t pkts_nr)
+{
+	struct rohc_decomp_gro_train train;
+	size_t i;
+
+	/* check inputs validity */
+	if(decomp == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "decompressor received %zu bytes of feedback for the "
-		           "same-side associated compressor", rcvd_feedback->len);
+		goto error;
 	}
-	walk = rohc_buf_data(remain_rohc_data);
-	remain_len = remain_rohc_data.len;
-
-	/* is there some data after feedback? */
-	if(remain_rohc_data.len == 0)
+	if(rohc_pkts == NULL || uncomp_pkts == NULL || statuses == NULL ||
+	   gro_infos == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "feedback-only packet, stop decompression");
-		goto skip;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packets, statuses or GRO information are NULL");
+		goto error;
 	}
 
-	/* ROHC segment? */
-	if(rohc_decomp_packet_is_segment(walk))
+	train.segs_nr = 0;
+	for(i = 0; i < pkts_nr; i++)
 	{
-		const bool is_final = !!GET_REAL(GET_BIT_0(walk));
-		uint32_t crc_computed;
+		struct rohc_decomp_pkt_info info;
 
-		/* skip the segment type byte */
-		walk++;
-		remain_len--;
-		rohc_buf_pull(&remain_rohc_data, 1);
+		/* look up the contexts of the next packets before decompressing them */
+		if((i % ROHC_DECOMP_BURST_PREFETCH_NR) == 0)
+		{
+			rohc_decomp_burst_prefetch(decomp, rohc_pkts + i,
+			                           rohc_min(pkts_nr - i,
+			                                    ROHC_DECOMP_BURST_PREFETCH_NR));
+		}
 
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "ROHC packet is a %zu-byte %s segment", remain_len,
-		           is_final ? "final" : "non-final");
+		memset(&gro_infos[i], 0, sizeof(struct rohc_decomp_gro_info));
+		gro_infos[i].segs_nr = 1;
 
-		/* store all the remaining ROHC data in RRU */
-		if((decomp->rru_len + remain_len) > decomp->mrru)
+		if(rohc_buf_is_malformed(uncomp_pkts[i]) ||
+		   !rohc_buf_is_empty(uncomp_pkts[i]))
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid RRU: received segment is too large for MRRU "
-			             "(%zu bytes already received, %zu bytes received, "
-			             "MRRU = %zu bytes", decomp->rru_len, remain_len,
-			             decomp->mrru);
-			/* dicard RRU */
-			decomp->rru_len = 0;
-			goto error_malformed;
+			             "given uncomp_packet #%zu is malformed or not empty",
+			             i + 1);
+			statuses[i] = ROHC_STATUS_ERROR;
+		}
+		else
+		{
+			statuses[i] =
+				rohc_decomp_decompress_pkt(decomp, rohc_pkts[i], &uncomp_pkts[i],
+				                           NULL, NULL, false, &info);
+		}
+		if(statuses[i] != ROHC_STATUS_OK || uncomp_pkts[i].len == 0)
+		{
+			/* the train is broken by failures and by feedback-only packets */
+			if(train.segs_nr > 0)
+			{
+				rohc_decomp_gro_close(&train, &uncomp_pkts[train.head],
+				                      &gro_infos[train.head]);
+			}
+			continue;
 		}
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "append new segment to the %zd bytes we already received",
-		           decomp->rru_len);
-		memcpy(decomp->rru + decomp->rru_len, walk, remain_len);
-		decomp->rru_len += remain_len;
 
-		/* stop decoding here is not final segment */
-		if(!is_final)
+		/* append the packet to the current train if possible */
+		if(train.segs_nr > 0 &&
+		   rohc_decomp_gro_append(&train, &uncomp_pkts[train.head],
+		                          uncomp_pkts[i], &info))
 		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			           "%zd bytes of RRU already received, wait for more "
-			           "segments before decompressing RRU", decomp->rru_len);
-			goto skip;
+			uncomp_pkts[i].len = 0;
+			gro_infos[i].segs_nr = 0;
+			continue;
 		}
 
-		/* final segment received, let's check CRC */
-		if(decomp->rru_len <= 4)
+		/* start a new train otherwise */
+		if(train.segs_nr > 0)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid %zd-byte RRU: should be more than 4-byte long",
-			             decomp->rru_len);
-			/* discard RRU */
-			decomp->rru_len = 0;
-			goto error_malformed;
+			rohc_decomp_gro_close(&train, &uncomp_pkts[train.head],
+			                      &gro_infos[train.head]);
 		}
-		decomp->rru_len -= 4;
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "final segment received, check the 4-byte CRC of the "
-		           "%zd-byte RRU", decomp->rru_len);
-		crc_computed = crc_calc_fcs32(decomp->rru, decomp->rru_len,
-		                              CRC_INIT_FCS32);
-		if(memcmp(&crc_computed, decomp->rru + decomp->rru_len, 4) != 0)
+		if(!rohc_decomp_gro_start(&train, i, uncomp_pkts[i], &info))
 		{
-			uint32_t crc_packet;
-			memcpy(&crc_packet, decomp->rru + decomp->rru_len, 4);
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid %zd-byte RRU: bad CRC (packet = 0x%08x, "
-			             "computed = 0x%08x)", decomp->rru_len,
-			             rohc_ntoh32(crc_packet), rohc_ntoh32(crc_computed));
-			/* discard RRU */
-			decomp->rru_len = 0;
-			goto error_crc;
+			train.segs_nr = 0;
 		}
+	}
+	if(train.segs_nr > 0)
+	{
+		rohc_decomp_gro_close(&train, &uncomp_pkts[train.head],
+		                      &gro_infos[train.head]);
+	}
 
-		/* CRC of segment is OK, let's decode RRU */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "final segment received, decode the %zd-byte RRU",
-		           decomp->rru_len);
-		walk = decomp->rru;
-		remain_len = decomp->rru_len;
-		remain_rohc_data.offset = 0;
-		remain_rohc_data.data = decomp->rru;
-		remain_rohc_data.len = decomp->rru_len;
-		remain_rohc_data.max_len = decomp->rru_len;
+	return i;
 
-		/* reset context for next RRU */
-		decomp->rru_len = 0;
-	}
+error:
+	return 0;
+}
 
-	/* decode small or large CID */
-	if(!rohc_decomp_decode_cid(decomp, walk, remain_len, &stream->cid,
-	                           &add_cid_len, &large_cid_len))
+
+
+/**
+ * @brief Peek at the CID of the given ROHC packet without decompressing it
+ *
+ * Skip the padding and the piggybacked feedback items at the beginning of the
+ * given ROHC packet, then decode its add-CID or large CID field. Nothing is
+ * allocated, and neither the decompressor nor its contexts are modified, so
+ * the function may be used to dispatch ROHC packets by CID to several
+ * decompressors, eg. one per thread, before \ref rohc_decompress3 is called on
+ * the selected one.
+ *
+ * Feedback-only packets and ROHC segments carry no CID outside of the RRU,
+ * so they are reported as failures.
+ *
+ * @param decomp                The ROHC decompressor that gives the CID type
+ * @param rohc_packet           The ROHC packet to peek at
+ * @param[out] cid              The CID of the ROHC packet
+ * @param[out] feedback_offset  The offset of the piggybacked feedback items
+ *                              in the ROHC packet, ie. the end of padding
+ * @param[out] feedback_len     The length of the piggybacked feedback items,
+ *                              0 if there is no feedback
+ * @return                      true if the CID was found,
+ *                              false if the packet is malformed, contains
+ *                              feedback only, or is a ROHC segment
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+bool rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                          const struct rohc_buf rohc_packet,
+                          rohc_cid_t *const cid,
+                          size_t *const feedback_offset,
+                          size_t *const feedback_len)
+{
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(rohc_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "failed to decode small or large CID in packet");
-		goto error_malformed;
+		             "given rohc_packet is malformed");
+		goto error;
 	}
-	stream->cid_found = true;
-
-	/* check whether the decoded CID is allowed by the decompressor */
-	if(stream->cid > decomp->medium.max_cid)
+	if(cid == NULL || feedback_offset == NULL || feedback_len == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unexpected CID %u received: MAX_CID was set to %u",
-		             stream->cid, decomp->medium.max_cid);
-		goto error_no_context;
+		             "given cid, feedback_offset or feedback_len is NULL");
+		goto error;
 	}
 
-	/* skip add-CID if present */
-	walk += add_cid_len;
-	remain_len -= add_cid_len;
-	rohc_buf_pull(&remain_rohc_data, add_cid_len);
+	return rohc_decomp_peek_cid_nocheck(decomp, rohc_packet, cid,
+	                                    feedback_offset, feedback_len);
 
-	/* find the context according to the CID found in CID,
-	 * create it if needed (and possible) */
-	status = rohc_decomp_find_context(decomp, walk, remain_len, stream->cid,
-	                                  large_cid_len, rohc_packet.time,
-	                                  &stream->profile_id, &stream->context,
-	                                  &is_new_context);
-	if(status == ROHC_STATUS_MALFORMED)
+error:
+	return false;
+}
+
+
+/**
+ * @brief Prefetch the context of the given ROHC packet before decompressing it
+ *
+ * The CID of the ROHC packet is decoded as \ref rohc_decomp_peek_cid does,
+ * then the decompression context and the beginning of its profile-specific
+ * part are prefetched into the CPU caches. Nothing is modified, and the
+ * function does nothing for feedback-only packets, ROHC segments, malformed
+ * packets and unknown contexts.
+ *
+ * The function is intended for the applications that decompress one packet
+ * at a time and cannot use \ref rohc_decompress_burst2: calling it for the
+ * packet i+2 before decompressing the packet i hides the cache misses on the
+ * context that dominate when many flows share the decompressor.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet that will be decompressed later
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_peek_cid
+ * @see rohc_decompress3
+ */
+void rohc_decomp_prefetch(const struct rohc_decomp *const decomp,
+                          const struct rohc_buf rohc_packet)
+{
+	const struct rohc_decomp_ctxt *context;
+	size_t feedback_offset;
+	size_t feedback_len;
+	rohc_cid_t cid;
+
+	if(decomp == NULL || rohc_buf_is_malformed(rohc_packet) ||
+	   !rohc_decomp_peek_cid_nocheck(decomp, rohc_packet, &cid,
+	                                 &feedback_offset, &feedback_len) ||
+	   cid > decomp->medium.max_cid)
 	{
-		/* no additional feedback information to collect */
-		goto error_malformed;
+		return;
 	}
-	else if(status == ROHC_STATUS_NO_CONTEXT)
+
+	context = decomp->contexts[cid];
+	if(context != NULL)
+	{
+		/* the persistent profile-specific part is allocated right after the
+		 * context, so its address does not depend on the context content */
+		const uint8_t *const persist_ctxt = ((const uint8_t *) context) +
+			rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_ctxt));
+
+		__builtin_prefetch(context);
+		__builtin_prefetch(((const uint8_t *) context) + 64);
+		__builtin_prefetch(persist_ctxt);
+		__builtin_prefetch(persist_ctxt + 64);
+	}
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet
+ *
+ * The common part of \ref rohc_decompress4 and \ref rohc_decompress_in_place.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor
+ * @param in_place            Whether \e uncomp_packet is the headroom of the
+ *                            ROHC packet, ie. the payload shall not be copied
+ *                            but the uncompressed headers moved right before
+ *                            it
+ * @param[out] info           The information about the decompressed packet
+ *                            to fill if decompression is successful, may be
+ *                            NULL
+ * @return                    The same status values as \ref rohc_decompress3
+ */
+static rohc_status_t rohc_decomp_decompress_pkt(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf rohc_packet,
+                                                struct rohc_buf *const uncomp_packet,
+                                                struct rohc_buf *const rcvd_feedback,
+                                                struct rohc_buf *const feedback_send,
+                                                const bool in_place,
+                                                struct rohc_decomp_pkt_info *const info)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_decomp_stream stream;
+	size_t uncomp_len;
+	bool is_decoded;
+
+	/* check inputs validity */
+	if(rohc_buf_is_malformed(rohc_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(rohc_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is empty");
+		goto error;
+	}
+	if(rcvd_feedback != NULL)
+	{
+		if(rohc_buf_is_malformed(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is not empty");
+			goto error;
+		}
+	}
+	if(feedback_send != NULL)
+	{
+		if(rohc_buf_is_malformed(*feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is not empty");
+			goto error;
+		}
+	}
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
+	           decomp->stats.received + 1);
+
+	/* print compressed bytes */
+	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
+		                 "compressed data, max 100 bytes", rohc_packet);
+	}
+
+	/* reset the statistics of the packet */
+	decomp->pkt_crc_repairs_nr = 0;
+	decomp->pkt_inspected = false;
+	if((decomp->features & ROHC_DECOMP_FEATURE_PERF_INFO) != 0)
+	{
+		memset(decomp->pkt_phases_ns, 0, sizeof(decomp->pkt_phases_ns));
+	}
+
+	/* decode ROHC header */
+	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
+	                         in_place, &stream);
+	assert(status != ROHC_STATUS_SEGMENT);
+
+	/* the payload of a chain of buffers is referenced instead of copied */
+	uncomp_len = uncomp_packet->len;
+	if(decomp->chain_head_payload != NULL)
+	{
+		uncomp_len += decomp->chain_head_payload_len + decomp->chain_tail_len;
+	}
+
+	/* the inspected packets are empty but they are accounted as the
+	 * decompressed ones, the feedback-only packets are not */
+	is_decoded = (uncomp_len > 0 || decomp->pkt_inspected);
+
+	/* handle mode transitions if context was found and it is still valid */
+	if(stream.context != NULL)
+	{
+		if(stream.context->mode == ROHC_U_MODE)
+		{
+			if(decomp->target_mode == ROHC_U_MODE)
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "stay in U-mode as requested by user");
+			}
+			else if(decomp->target_mode == ROHC_O_MODE)
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "transit from U-mode to O-mode as requested by user");
+				stream.context->mode = ROHC_O_MODE;
+				/* ACK(O), NACK(O) or STATIC-NACK(O) will transmit the mode
+				 * transition to the remote compressor */
+				stream.mode = ROHC_O_MODE;
+				stream.do_change_mode = true;
+			}
+			else /* R-mode */
+			{
+				assert(0); /* TODO: R-mode not supported yet */
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+		}
+		else if(stream.context->mode == ROHC_O_MODE)
+		{
+			if(decomp->target_mode == ROHC_U_MODE)
+			{
+				assert(0); /* TODO: O- to U-mode transition not supported yet */
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+			else if(decomp->target_mode == ROHC_O_MODE)
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "stay in O-mode as requested by user");
+			}
+			else /* R-mode */
+			{
+				assert(0); /* TODO: R-mode not supported yet */
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+		}
+		else /* R-mode */
+		{
+			assert(0); /* TODO: R-mode not supported yet */
+			status = ROHC_STATUS_ERROR;
+			goto error;
+		}
+	}
+
+	/* update the decompressor and context statistics in one single update
+	 * published to the readers of statistics */
+	rohc_stats_write_begin(&decomp->stats_seq);
+	if(!decomp->reorder_releasing)
+	{
+		/* held packets were already accounted when they were received */
+		decomp->stats.received++;
+	}
+	if(stream.context != NULL)
+	{
+		/* failed packets cost their context too, CRC repairs included */
+		rohc_decomp_ctxt_cost_add(decomp, stream.context);
+	}
+	if(status == ROHC_STATUS_OK)
+	{
+		/* feedback-only packets are not accounted in context statistics */
+		if(is_decoded)
+		{
+			assert(stream.context != NULL);
+			stream.context->num_recv_packets++;
+			stream.context->last_packet_type = stream.packet_type;
+			stream.context->total_last_uncompressed_size = uncomp_len;
+			stream.context->total_uncompressed_size += uncomp_len;
+			stream.context->total_last_compressed_size =
+				rohc_packet.len + decomp->chain_tail_len;
+			stream.context->total_compressed_size +=
+				rohc_packet.len + decomp->chain_tail_len;
+			rohc_decomp_stats_add_success(stream.context,
+			                              stream.context->volat_ctxt.comp_hdr_len,
+			                              stream.context->volat_ctxt.uncomp_hdr_len);
+			rohc_decomp_pkt_stats_add(decomp, stream.profile_id, stream.packet_type,
+			                          status, stream.context);
+			decomp->stats.total_uncompressed_size += uncomp_len;
+			decomp->stats.total_compressed_size +=
+				rohc_packet.len + decomp->chain_tail_len;
+		}
+	}
+	else
+	{
+		if(stream.context != NULL)
+		{
+			stream.context->num_recv_packets++;
+		}
+		rohc_decomp_pkt_stats_add(decomp, stream.profile_id, stream.packet_type,
+		                          status, NULL);
+		switch(status)
+		{
+			case ROHC_STATUS_MALFORMED:
+			case ROHC_STATUS_OUTPUT_TOO_SMALL:
+			case ROHC_STATUS_ERROR:
+				decomp->stats.failed_decomp++;
+				break;
+			case ROHC_STATUS_NO_CONTEXT:
+			case ROHC_STATUS_NO_MEMORY:
+				decomp->stats.failed_no_context++;
+				break;
+			case ROHC_STATUS_BAD_CRC:
+				decomp->stats.failed_crc++;
+				break;
+			case ROHC_STATUS_OK: /* success codes shall not happen */
+			case ROHC_STATUS_SEGMENT:
+			default:
+				assert(0);
+				status = ROHC_STATUS_ERROR;
+				decomp->stats.failed_decomp++;
+				break;
+		}
+	}
+	rohc_stats_write_end(&decomp->stats_seq);
+
+	if(info != NULL && status == ROHC_STATUS_OK)
+	{
+		info->rcvd_feedbacks_offset = stream.feedbacks_offset;
+		info->rcvd_feedbacks_len = stream.feedbacks_len;
+		info->rcvd_feedbacks_nr = stream.feedbacks_nr;
+	}
+	if(info != NULL && status == ROHC_STATUS_OK && is_decoded)
+	{
+		info->cid = stream.context->cid;
+		info->profile_id = stream.context->profile->id;
+		info->packet_type = stream.packet_type;
+		info->context_state = stream.context->state;
+		info->context_mode = stream.context->mode;
+		info->hdr_len = stream.context->volat_ctxt.comp_hdr_len;
+		info->uncomp_hdr_len = stream.context->volat_ctxt.uncomp_hdr_len;
+		info->lost_packets_nr = stream.context->nr_lost_packets;
+		info->misordered_packets_nr = stream.context->nr_misordered_packets;
+		info->is_duplicated = stream.context->is_duplicated;
+		info->sn = stream.context->profile->get_sn(stream.context);
+		info->flow_id = stream.context->flow_id;
+	}
+
+	/* send feedback if needed */
+	if(status == ROHC_STATUS_OK)
+	{
+		/* print a trace to report success (the context may be NULL if packet
+		 * was a feedback-only packet) */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+		           "packet decompression succeeded");
+
+		/* do not build positive feedback for feedback-only packets */
+		if(is_decoded)
+		{
+			/* build positive feedback if asked by user and if needed by decompressor */
+			if(!rohc_decomp_feedback_ack(decomp, &stream, feedback_send))
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				             "failed to build positive feedback");
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+		}
+	}
+	else /* packet failed to be decompressed */
+	{
+		/* in case of failure, users shall get an empty decompressed packet */
+		uncomp_packet->len = 0;
+
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+		             "packet decompression failed: %s (%d)",
+		             rohc_strerror(status), status);
+
+		/* build negative feedback if asked by user and if needed by decompressor */
+		if(!rohc_decomp_feedback_nack(decomp, &stream, feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+			             "failed to build negative feedback");
+			status = ROHC_STATUS_ERROR;
+			goto error;
+		}
+	}
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress the compressed headers.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The ROHC packet to decode
+ * @param[out] uncomp_packet  The uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel:
+ *                            \li If NULL, ignore the received feedback data
+ *                            \li If not NULL, store the received feedback in
+ *                                at the given address
+ * @param in_place            Whether the packet is decompressed in place
+ * @param[out] stream         The information about the decompressed stream,
+ *                            required for sending feedback to compressor
+ * @return                    Possible return values:
+ *                            \li ROHC_STATUS_OK if packet is successfully
+ *                                decoded,
+ *                            \li ROHC_STATUS_NO_CONTEXT if no matching
+ *                                context was found and packet cannot create
+ *                                a new context (or failed to do so),
+ *                            \li ROHC_STATUS_NO_MEMORY if the new context
+ *                                would exceed the memory budget,
+ *                            \li ROHC_STATUS_MALFORMED if packet is
+ *                                malformed,
+ *                            \li ROHC_STATUS_BAD_CRC if a CRC error occurs,
+ *                            \li ROHC_STATUS_ERROR if another error occurs
+ */
+static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
+                                     const struct rohc_buf rohc_packet,
+                                     struct rohc_buf *const uncomp_packet,
+                                     struct rohc_buf *const rcvd_feedback,
+                                     const bool in_place,
+                                     struct rohc_decomp_stream *const stream)
+{
+	const struct rohc_decomp_profile *profile;
+	bool is_new_context = false;
+	size_t sn_feedback_min_bits;
+	size_t add_cid_len;
+	size_t large_cid_len;
+
+	struct rohc_buf remain_rohc_data = rohc_packet;
+	const uint8_t *walk;
+	size_t remain_len;
+
+	rohc_status_t status;
+
+	/* at the beginning, context is not found yet but channel CID type is known */
+	stream->profile_id = ROHC_PROFILE_GENERAL;
+	stream->cid_type = decomp->medium.cid_type;
+	stream->cid_found = false;
+	stream->cid = UINT16_MAX;
+	stream->context_found = false;
+	stream->context = NULL;
+	stream->mode = ROHC_UNKNOWN_MODE;
+	stream->state = ROHC_DECOMP_STATE_UNKNOWN;
+	stream->do_change_mode = false;
+	stream->sn_bits = 0; /* must be set to 0 until we get some bits */
+	stream->sn_bits_nr = 0;
+	stream->packet_type = ROHC_PACKET_UNKNOWN;
+	stream->crc_failed = false;
+	stream->arrival_time = rohc_packet.time;
+	stream->feedbacks_offset = 0;
+	stream->feedbacks_len = 0;
+	stream->feedbacks_nr = 0;
+
+	/* empty ROHC packets are not considered as valid */
+	if(remain_rohc_data.len < 1)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "ROHC packet too small (len = %zu, at least 1 byte "
+		             "required)", remain_rohc_data.len);
+		goto error_malformed;
+	}
+
+	/* skip padding bits if some are present */
+	rohc_decomp_parse_padding(decomp, &remain_rohc_data);
+
+	/* padding-only packets are not allowed according to RFC 3095, §5.2:
+	 *   Padding is any number (zero or more) of padding octets.  Either of
+	 *   Feedback or Header must be present. */
+	if(remain_rohc_data.len == 0)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "padding-only packet is not allowed");
+		goto error_malformed;
+	}
+
+	/* extract feedback items if present, remember where they are in the
+	 * ROHC packet for the zero-copy delivery to the same-side compressor */
+	stream->feedbacks_offset = rohc_packet.len - remain_rohc_data.len;
+	if(!rohc_decomp_parse_feedbacks(decomp, &remain_rohc_data,
+	                                decomp->feedback_ring, rcvd_feedback,
+	                                &stream->feedbacks_nr))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to decode feedback items at the beginning of the "
+		             "ROHC packet");
+		goto error_malformed;
+	}
+	stream->feedbacks_len =
+		rohc_packet.len - remain_rohc_data.len - stream->feedbacks_offset;
+	if(rcvd_feedback != NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "decompressor received %zu bytes of feedback for the "
+		           "same-side associated compressor", rcvd_feedback->len);
+	}
+	walk = rohc_buf_data(remain_rohc_data);
+	remain_len = remain_rohc_data.len;
+
+	/* is there some data after feedback? */
+	if(remain_rohc_data.len == 0 && decomp->chain_tail_len > 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "the ROHC header is not in the first segment of the chain "
+		             "of buffers");
+		goto error_malformed;
+	}
+	else if(remain_rohc_data.len == 0)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "feedback-only packet, stop decompression");
+		goto skip;
+	}
+
+	/* ROHC segment? */
+	if(rohc_decomp_packet_is_segment(walk))
+	{
+		const bool is_final = !!GET_REAL(GET_BIT_0(walk));
+		uint32_t crc_computed;
+		uint32_t crc_packet;
+
+		/* the reconstructed packet does not fit in the segment */
+		if(in_place)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "ROHC segments cannot be decompressed in place");
+			goto error_malformed;
+		}
+		if(decomp->chain_by_ref)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "ROHC segments cannot be decompressed from a chain of "
+			             "buffers");
+			goto error_malformed;
+		}
+
+		/* skip the segment type byte */
+		walk++;
+		remain_len--;
+		rohc_buf_pull(&remain_rohc_data, 1);
+
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "ROHC packet is a %zu-byte %s segment", remain_len,
+		           is_final ? "final" : "non-final");
+
+		/* first segment of a new RRU */
+		if(decomp->rru_len == 0)
+		{
+			decomp->rru_segs_nr = 0;
+			decomp->rru_crc = CRC_INIT_FCS32;
+			decomp->rru_crc_len = 0;
+		}
+
+		/* store all the remaining ROHC data in RRU */
+		if((decomp->rru_len + remain_len) > decomp->mrru)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid RRU: received segment is too large for MRRU "
+			             "(%zu bytes already received, %zu bytes received, "
+			             "MRRU = %zu bytes", decomp->rru_len, remain_len,
+			             decomp->mrru);
+			/* dicard RRU */
+			decomp->rru_len = 0;
+			goto error_malformed;
+		}
+		if((decomp->features & ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF) != 0 &&
+		   (decomp->rru_len == 0 || decomp->rru_segs_nr > 0) &&
+		   decomp->rru_segs_nr < ROHC_DECOMP_RRU_SEGS_MAX)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "reference new segment after the %zd bytes we already "
+			           "received", decomp->rru_len);
+			decomp->rru_segs[decomp->rru_segs_nr].data = walk;
+			decomp->rru_segs[decomp->rru_segs_nr].len = remain_len;
+			decomp->rru_segs_nr++;
+		}
+		else
+		{
+			/* too many segments to reference, copy them all */
+			rohc_decomp_rru_flatten(decomp, decomp->rru_len);
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "append new segment to the %zd bytes we already received",
+			           decomp->rru_len);
+			memcpy(decomp->rru + decomp->rru_len, walk, remain_len);
+		}
+		decomp->rru_len += remain_len;
+
+		/* compute the CRC as segments arrive, except over the last 4 bytes
+		 * that may be the CRC field itself */
+		rohc_decomp_rru_update_crc(decomp);
+
+		/* stop decoding here is not final segment */
+		if(!is_final)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "%zd bytes of RRU already received, wait for more "
+			           "segments before decompressing RRU", decomp->rru_len);
+			goto skip;
+		}
+
+		/* final segment received, let's check CRC */
+		if(decomp->rru_len <= 4)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid %zd-byte RRU: should be more than 4-byte long",
+			             decomp->rru_len);
+			/* discard RRU */
+			decomp->rru_len = 0;
+			goto error_malformed;
+		}
+		decomp->rru_len -= 4;
+		assert(decomp->rru_crc_len == decomp->rru_len);
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "final segment received, check the 4-byte CRC of the "
+		           "%zd-byte RRU", decomp->rru_len);
+		crc_computed = decomp->rru_crc;
+		rohc_decomp_rru_read(decomp, decomp->rru_len, 4, (uint8_t *) &crc_packet);
+		if(crc_computed != crc_packet)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid %zd-byte RRU: bad CRC (packet = 0x%08x, "
+			             "computed = 0x%08x)", decomp->rru_len,
+			             rohc_ntoh32(crc_packet), rohc_ntoh32(crc_computed));
+			/* discard RRU */
+			decomp->rru_len = 0;
+			goto error_crc;
+		}
+
+		/* only the beginning of a referenced RRU is copied for the ROHC header,
+		 * the payload is copied straight from the segments, unless the work
+		 * is bounded: the whole RRU is then copied once, so that its header
+		 * never needs to be parsed again */
+		if(decomp->rru_segs_nr > 0 &&
+		   (decomp->features & ROHC_DECOMP_FEATURE_BOUNDED_WORK) != 0)
+		{
+			rohc_decomp_rru_flatten(decomp, decomp->rru_len);
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "%zu bytes of the RRU referenced from segments copied "
+			           "before parsing", decomp->rru_len);
+		}
+		else if(decomp->rru_segs_nr > 0)
+		{
+			decomp->rru_copied_len =
+				rohc_min(decomp->rru_len, ROHC_DECOMP_RRU_HDR_LEN);
+			rohc_decomp_rru_read(decomp, 0, decomp->rru_copied_len, decomp->rru);
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "%zu bytes of the RRU referenced from %zu segments copied "
+			           "for the ROHC header", decomp->rru_copied_len,
+			           decomp->rru_segs_nr);
+		}
+
+		/* CRC of segment is OK, let's decode RRU */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "final segment received, decode the %zd-byte RRU",
+		           decomp->rru_len);
+		walk = decomp->rru;
+		remain_len = decomp->rru_len;
+		remain_rohc_data.offset = 0;
+		remain_rohc_data.data = decomp->rru;
+		remain_rohc_data.len = decomp->rru_len;
+		remain_rohc_data.max_len = decomp->rru_len;
+
+		/* reset context for next RRU */
+		decomp->rru_len = 0;
+	}
+
+	/* decode small or large CID */
+	if(!rohc_decomp_decode_cid(decomp, walk, remain_len, &stream->cid,
+	                           &add_cid_len, &large_cid_len))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to decode small or large CID in packet");
+		goto error_malformed;
+	}
+	stream->cid_found = true;
+
+	/* check whether the decoded CID is allowed by the decompressor */
+	if(stream->cid > decomp->medium.max_cid)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected CID %u received: MAX_CID was set to %u",
+		             stream->cid, decomp->medium.max_cid);
+		goto error_no_context;
+	}
+
+	/* skip add-CID if present */
+	walk += add_cid_len;
+	remain_len -= add_cid_len;
+	rohc_buf_pull(&remain_rohc_data, add_cid_len);
+
+	/* drop at once the packets that require a context the CID does not have */
+	status = rohc_decomp_drop_early(decomp, walk, remain_len, stream);
+	if(status != ROHC_STATUS_OK)
+	{
+		decomp->last_context = NULL;
+		return status;
+	}
+
+	/* find the context according to the CID found in CID,
+	 * create it if needed (and possible) */
+	status = rohc_decomp_find_context(decomp, walk, remain_len, stream->cid,
+	                                  large_cid_len, rohc_packet.time,
+	                                  &stream->profile_id, &stream->context,
+	                                  &is_new_context);
+	if(status == ROHC_STATUS_MALFORMED)
+	{
+		/* no additional feedback information to collect */
+		goto error_malformed;
+	}
+	else if(status == ROHC_STATUS_NO_CONTEXT)
 	{
 		/* even if the context was not found/created, the profile ID might be available */
 		goto error_no_context;
 	}
-	assert(status == ROHC_STATUS_OK);
-	profile = stream->context->profile;
-	decomp->last_context = stream->context;
-	sn_feedback_min_bits = rohc_min(decomp->sn_feedback_min_bits,
-	                                profile->msn_max_bits);
-	rohc_decomp_debug(stream->context, "decode packet with profile '%s' (0x%04x)",
-	                  rohc_get_profile_descr(profile->id), profile->id);
+	else if(status == ROHC_STATUS_NO_MEMORY)
+	{
+		goto error;
+	}
+	assert(status == ROHC_STATUS_OK);
+	profile = rohc_decomp_ctxt_profile(stream->context);
+	decomp->last_context = stream->context;
+	sn_feedback_min_bits = rohc_min(decomp->sn_feedback_min_bits,
+	                                profile->msn_max_bits);
+	rohc_decomp_debug(stream->context, "decode packet with profile '%s' (0x%04x)",
+	                  rohc_get_profile_descr(profile->id), profile->id);
+
+	/* collect information for sending feedback to decompressor */
+	stream->context_found = true;
+	stream->mode = stream->context->mode;
+	stream->state = stream->context->state;
+	if(!is_new_context)
+	{
+		stream->sn_bits = profile->get_sn(stream->context);
+		stream->sn_bits_nr = sn_feedback_min_bits;
+		rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
+		                  "(%zu bits required for RTT, %zu max)",
+		                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
+		                  profile->msn_max_bits);
+	}
+
+	/* detect the type of the ROHC packet */
+	stream->packet_type = profile->detect_pkt_type(stream->context, walk, remain_len,
+	                                               large_cid_len);
+	if(stream->packet_type == ROHC_PACKET_UNKNOWN)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "failed to detect ROHC packet type");
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error_malformed;
+	}
+	rohc_decomp_debug(stream->context, "decode packet as '%s'",
+	                  rohc_get_packet_descr(stream->packet_type));
+
+	/* only packets that carry static information can be received in the
+	 * No Context state, other cannot */
+	if(stream->state == ROHC_DECOMP_STATE_NC &&
+	   !rohc_packet_carry_static_info(stream->packet_type))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "CID %u: packet '%s' (%d) does not carry static information, "
+		             "it cannot be received in No Context state",
+		             stream->cid, rohc_get_packet_descr(stream->packet_type),
+		             stream->packet_type);
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error_malformed;
+	}
+	/* only packets carrying CRC-7 or CRC-8 can be received in the Static Context
+	 * state, other cannot */
+	else if(stream->state == ROHC_DECOMP_STATE_SC &&
+	        !rohc_packet_carry_crc_7_or_8(stream->packet_type))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "CID %u: packet '%s' (%d) does not carry 7- or 8-bit CRC, "
+		             "it cannot be received in Static Context state",
+		             stream->cid, rohc_get_packet_descr(stream->packet_type),
+		             stream->packet_type);
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error_malformed;
+	}
+	/* all packet types are allowed in Full Context state */
+
+	/* only IR or IR-CR packet can create a new context */
+	assert(stream->packet_type == ROHC_PACKET_IR ||
+	       stream->packet_type == ROHC_PACKET_IR_CR ||
+	       !is_new_context);
+
+	/* decode the packet thanks to the profile-specific routines
+	 * (may change the initial assumption about the packet type) */
+	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
+	                                add_cid_len, large_cid_len, uncomp_packet,
+	                                in_place, &stream->packet_type,
+	                                &stream->do_change_mode);
+	if(status != ROHC_STATUS_OK)
+	{
+		/* decompression failed, free resources if necessary */
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+		             "failed to decompress packet (code = %d)", status);
+		if(is_new_context)
+		{
+			context_free(stream->context);
+			stream->context = NULL;
+			decomp->last_context = NULL;
+		}
+		goto error;
+	}
+
+	/* decompression was successful, replace the existing context with the
+	 * new one if necessary */
+	if(is_new_context)
+	{
+		if(decomp->contexts[stream->cid] != NULL)
+		{
+			rohc_decomp_ctxt_event(decomp->contexts[stream->cid],
+			                       ROHC_DECOMP_CTXT_EVENT_FREED);
+			rohc_decomp_ctxts_used_del(decomp, decomp->contexts[stream->cid]);
+			context_free(decomp->contexts[stream->cid]);
+		}
+		decomp->contexts[stream->cid] = stream->context;
+		rohc_decomp_ctxts_used_add(decomp, stream->context);
+		rohc_decomp_ctxt_event(stream->context, ROHC_DECOMP_CTXT_EVENT_CREATED);
+	}
+
+	/* get the SN of the latest packet successfully decompressed */
+	stream->sn_bits = profile->get_sn(stream->context);
+	stream->sn_bits_nr = sn_feedback_min_bits;
+	rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
+	                  "(%zu bits required for RTT, %zu max)",
+	                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
+	                  profile->msn_max_bits);
+
+skip:
+	return ROHC_STATUS_OK;
+
+error:
+	stream->crc_failed = !!(status == ROHC_STATUS_BAD_CRC);
+	decomp->last_context = NULL;
+	return status;
+
+error_crc:
+	stream->crc_failed = true;
+	decomp->last_context = NULL;
+	return ROHC_STATUS_BAD_CRC;
+
+error_malformed:
+	decomp->last_context = NULL;
+	return ROHC_STATUS_MALFORMED;
+
+error_no_context:
+	decomp->last_context = NULL;
+	return ROHC_STATUS_NO_CONTEXT;
+}
+
+
+/**
+ * @brief Decode one ROHC packet
+ *
+ * Steps:
+ *  \li A. Parse the ROHC header
+ *  \li B. For IR and IR-DYN packet, check for correct compressed header (CRC)
+ *  \li C. Decode extracted bits
+ *  \li D. Build uncompressed headers (and check for correct decompression
+ *         for UO* packets)
+ *  \li E. Copy the payload (if any)
+ *  \li F. Update the compression context
+ *
+ * Steps C and D may be repeated if packet or context repair is attempted
+ * upon CRC failure.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param context              The decompression context
+ * @param rohc_packet          The ROHC packet to decode
+ * @param add_cid_len          The length of the optional Add-CID field
+ * @param large_cid_len        The length of the optional large CID field
+ * @param[out] uncomp_packet   The uncompressed packet
+ * @param in_place             Whether \e uncomp_packet is the headroom of
+ *                             \e rohc_packet, ie. the uncompressed headers
+ *                             shall be moved right before the payload instead
+ *                             of copying the payload behind them
+ * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
+ *                             OUT: The type of the parsed ROHC packet
+ * @param[out] do_change_mode  Whether the profile context wants to change
+ *                             its operational mode or not
+ * @return                     ROHC_STATUS_OK if packet is successfully decoded,
+ *                             ROHC_STATUS_MALFORMED if packet is malformed,
+ *                             ROHC_STATUS_BAD_CRC if a CRC error occurs,
+ *                             ROHC_STATUS_ERROR if an error occurs
+ */
+static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
+                                            struct rohc_decomp_ctxt *const context,
+                                            const struct rohc_buf rohc_packet,
+                                            const size_t add_cid_len,
+                                            const size_t large_cid_len,
+                                            struct rohc_buf *const uncomp_packet,
+                                            const bool in_place,
+                                            rohc_packet_t *const packet_type,
+                                            bool *const do_change_mode)
+{
+	const struct rohc_decomp_profile *const profile =
+		rohc_decomp_ctxt_profile(context);
+	struct rohc_decomp_crc *const extr_crc_bits = &context->volat_ctxt.crc;
+	void *const extr_bits = context->volat_ctxt.extr_bits;
+	void *const decoded_values = context->volat_ctxt.decoded_values;
+	const rohc_packet_t packet_type_orig = *packet_type;
+
+	/* the inspected packets are not decompressed, their uncompressed headers
+	 * are built only to verify their CRC if asked to */
+	const bool do_inspect =
+		!!((decomp->features & ROHC_DECOMP_FEATURE_INSPECT) != 0);
+	const bool do_build_hdrs =
+		(!do_inspect || (decomp->features & ROHC_DECOMP_FEATURE_INSPECT_CRC) != 0);
+
+	/* the packets of the IP-only contexts may carry the IPv4 fragment field
+	 * behind their ROHC header */
+	const size_t frag_len =
+		(((decomp->features & ROHC_DECOMP_FEATURE_IP_FRAGMENTS) != 0 &&
+		  (profile->id == ROHCv1_PROFILE_IP || profile->id == ROHCv2_PROFILE_IP)) ?
+		 ROHC_IP_FRAG_FIELD_LEN : 0);
+	uint16_t ipv4_frag = 0;
+
+	/* length of the parsed ROHC header and of the uncompressed headers */
+	size_t rohc_hdr_len;
+	size_t uncomp_hdr_len;
+
+	/* ROHC and uncompressed payloads (they are the same) */
+	const uint8_t *payload_data;
+	size_t payload_len;
+
+	/* Whether to attempt packet correction or not */
+	bool try_decoding_again;
+	size_t repairs_nr;
+
+	/* Whether the packet is a duplicate of the last packet of the context */
+	bool is_dup;
+
+	/* helper variables for values returned by functions */
+	bool parsing_ok;
+	rohc_status_t status;
+
+	struct rohc_perf_clock perf_clock;
+
+	assert(add_cid_len == 0 || add_cid_len == 1);
+	assert(large_cid_len <= 2);
+	assert((*packet_type) != ROHC_PACKET_UNKNOWN);
+
+	rohc_perf_start(&perf_clock,
+	                !!((decomp->features & ROHC_DECOMP_FEATURE_PERF_INFO) != 0));
+
+	context->pkt_arrival_time = rohc_packet.time;
+
+	/* the most frequent packets of the steady state may be parsed, decoded and
+	 * built in one single pass, the generic pipeline below handles the other
+	 * packets, the packets of RRUs and the CRC repairs */
+	if(profile->decode_fast != NULL && do_build_hdrs && frag_len == 0 &&
+	   context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE &&
+	   !rohc_decomp_rru_is_ref(decomp, rohc_packet) &&
+	   profile->decode_fast(decomp, context, rohc_packet, large_cid_len,
+	                        *packet_type, extr_crc_bits, extr_bits,
+	                        decoded_values, uncomp_packet, &rohc_hdr_len))
+	{
+		rohc_decomp_perf_lap(decomp, &perf_clock, ROHC_DECOMP_PERF_DECODE);
+		payload_data = rohc_buf_data(rohc_packet) + rohc_hdr_len;
+		payload_len = rohc_packet.len - rohc_hdr_len + decomp->chain_tail_len;
+		is_dup = false;
+		rohc_decomp_debug(context, "%s packet decoded in one single pass",
+		                  rohc_get_packet_descr(*packet_type));
+		goto decoded;
+	}
+
+	/* A. Parse the ROHC header */
+
+	rohc_decomp_debug(context, "parse packet type '%s' (%d)",
+	                  rohc_get_packet_descr(*packet_type), *packet_type);
+
+	/* let's parse the packet! */
+	parsing_ok = profile->parse_pkt(context, rohc_packet, large_cid_len,
+	                                packet_type, extr_crc_bits, extr_bits,
+	                                &rohc_hdr_len);
+	if((!parsing_ok ||
+	    (rohc_packet.offset + rohc_hdr_len + frag_len) > decomp->rru_copied_len) &&
+	   rohc_decomp_rru_is_ref(decomp, rohc_packet))
+	{
+		/* the ROHC header of the RRU is larger than the part copied from the
+		 * segments, copy the whole RRU and parse the header again */
+		rohc_decomp_debug(context, "ROHC header of RRU is not fully copied "
+		                  "from the segments, copy the whole RRU");
+		rohc_decomp_rru_flatten(decomp, rohc_packet.offset + rohc_packet.len);
+		*packet_type = packet_type_orig;
+		parsing_ok = profile->parse_pkt(context, rohc_packet, large_cid_len,
+		                                packet_type, extr_crc_bits, extr_bits,
+		                                &rohc_hdr_len);
+	}
+	if(!parsing_ok)
+	{
+		rohc_decomp_warn(context, "failed to parse the %s header",
+		                 rohc_get_packet_descr(*packet_type));
+		status = ROHC_STATUS_MALFORMED;
+		goto error;
+	}
+	if(frag_len != 0)
+	{
+		if((rohc_hdr_len + frag_len) > rohc_packet.len)
+		{
+			rohc_decomp_warn(context, "ROHC packet too small for the IPv4 "
+			                 "fragment field");
+			status = ROHC_STATUS_MALFORMED;
+			goto error;
+		}
+		memcpy(&ipv4_frag, rohc_buf_data(rohc_packet) + rohc_hdr_len, frag_len);
+		ipv4_frag = rohc_ntoh16(ipv4_frag);
+		if((ipv4_frag & IPV4_DF) != 0)
+		{
+			rohc_decomp_warn(context, "malformed IPv4 fragment field 0x%04x: the "
+			                 "DF flag is not part of it", ipv4_frag);
+			status = ROHC_STATUS_MALFORMED;
+			goto error;
+		}
+		rohc_hdr_len += frag_len;
+	}
+	rohc_decomp_perf_lap(decomp, &perf_clock, ROHC_DECOMP_PERF_PARSE);
+
+	/* ROHC base header and its optional extension is now fully parsed,
+	 * remaining data is the payload */
+	payload_data = rohc_buf_data(rohc_packet) + rohc_hdr_len;
+	payload_len = rohc_packet.len - rohc_hdr_len + decomp->chain_tail_len;
+	rohc_decomp_debug(context, "ROHC payload (length = %zu bytes) starts at "
+	                  "offset %zu", payload_len, rohc_hdr_len);
+
+	/* the duplicate of the last packet of the context needs neither to be
+	 * decoded nor to update the context: its uncompressed headers are the
+	 * ones of the last packet */
+	is_dup = rohc_decomp_dup_cache_match(decomp, context, *packet_type,
+	                                     rohc_packet, rohc_hdr_len, payload_len);
+	if(is_dup)
+	{
+		rohc_decomp_debug(context, "packet is a duplicate of the last packet, "
+		                  "re-emit its uncompressed headers");
+	}
+
+
+	/*
+	 * B. Check for correct compressed header (CRC)
+	 *
+	 * Use the CRC on compressed headers to check whether IR header was
+	 * correctly received. The optional Add-CID is part of the CRC.
+	 */
+
+	if(extr_crc_bits->comp.type != ROHC_CRC_TYPE_NONE)
+	{
+		const bool crc_ok =
+			rohc_decomp_check_ir_crc(context,
+			                         rohc_buf_data(rohc_packet) - add_cid_len,
+			                         add_cid_len + rohc_hdr_len - frag_len,
+			                         add_cid_len, large_cid_len,
+			                         &extr_crc_bits->comp);
+		if(!crc_ok)
+		{
+			rohc_decomp_warn(context, "CRC detected a transmission failure for "
+			                 "%s packet", rohc_get_packet_descr(*packet_type));
+			ROHC_PROBE3(decomp_crc_failure, context->cid, profile->id,
+			            *packet_type);
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			{
+				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
+				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
+				              rohc_buf_data(rohc_packet) - add_cid_len,
+				              rohc_hdr_len + add_cid_len);
+			}
+#ifndef ROHC_NO_IR_CRC_CHECK
+			status = ROHC_STATUS_BAD_CRC;
+			goto error;
+#endif
+		}
+
+		/* reset the correction attempt */
+		context->crc_corr.counter = 0;
+	}
+	rohc_decomp_perf_lap(decomp, &perf_clock, ROHC_DECOMP_PERF_CRC);
+
+
+	try_decoding_again = false;
+	repairs_nr = 0;
+	do
+	{
+		rohc_status_t decode_ret;
+
+		if(try_decoding_again)
+		{
+			rohc_decomp_warn(context, "CID %u: CRC repair: try decoding packet "
+			                 "again with new assumptions", context->cid);
+		}
+
+
+		/* C. Decode extracted bits
+		 * D. Build uncompressed headers & check for correct decompression
+		 *
+		 * All bits are now extracted from the packet, let's decode them,
+		 * and then let's build the uncompressed headers with decoded fields.
+		 *
+		 * Use the CRC on decompressed headers to check whether decompression was
+		 * correct.
+		 */
+
+		if(is_dup)
+		{
+			decode_ret = rohc_decomp_dup_cache_emit(context, uncomp_packet);
+		}
+		else
+		{
+			decode_ret = rohc_decomp_try_decode_pkt(decomp, context, *packet_type,
+			                                        extr_crc_bits, extr_bits, payload_len,
+			                                        decoded_values, do_build_hdrs,
+			                                        uncomp_packet, &perf_clock);
+		}
+		if(decode_ret == ROHC_STATUS_OK)
+		{
+			/* uncompressed headers successfully built and CRC is correct,
+			 * no need to try decoding with different values */
+			if(context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE)
+			{
+				rohc_decomp_debug(context, "CRC is correct");
+			}
+			else if((*packet_type) == ROHC_PACKET_IR)
+			{
+				rohc_decomp_debug(context, "CRC is correct, stop CRC repair");
+				context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
+				context->crc_corr.counter = 0;
+			}
+			else
+			{
+				rohc_decomp_debug(context, "CID %u: CRC repair: CRC is correct",
+				                  context->cid);
+				try_decoding_again = false;
+			}
+		}
+		else if(decode_ret == ROHC_STATUS_BAD_CRC)
+		{
+			/* uncompressed headers successfully built but CRC is incorrect,
+			 * try decoding with different values (repair) */
+
+			/* attempt a context/packet repair, only once per packet if the
+			 * work is bounded */
+			if((decomp->features & ROHC_DECOMP_FEATURE_BOUNDED_WORK) != 0 &&
+			   repairs_nr >= ROHC_DECOMP_BOUNDED_REPAIRS_MAX)
+			{
+				rohc_decomp_warn(context, "CID %u: CRC repair: %zu repair(s) "
+				                 "already attempted for the packet", context->cid,
+				                 repairs_nr);
+				try_decoding_again = false;
+			}
+			else
+			{
+				try_decoding_again =
+					profile->attempt_repair(decomp, context, rohc_packet.time,
+					                        &context->crc_corr, extr_bits);
+			}
+			if(try_decoding_again)
+			{
+				repairs_nr++;
+				ROHC_PROBE3(decomp_crc_repair, context->cid, profile->id,
+				            context->crc_corr.algo);
+				decomp->pkt_crc_repairs_nr++;
+			}
+
+			/* report CRC failure if attempt is not possible */
+			if(!try_decoding_again)
+			{
+				/* uncompressed headers successfully built, CRC is incorrect, repair
+				 * was disabled or attempted without any success, so give up */
+				rohc_decomp_warn(context, "CID %u: failed to build uncompressed "
+				                 "headers (CRC failure)", context->cid);
+				ROHC_PROBE3(decomp_crc_failure, context->cid, profile->id,
+				            *packet_type);
+				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+				{
+					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+					                 "compressed headers", rohc_packet);
+				}
+				status = ROHC_STATUS_BAD_CRC;
+				goto error;
+			}
+		}
+		else if(decode_ret != ROHC_STATUS_OK)
+		{
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			{
+				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
+				                 "compressed headers", rohc_packet);
+			}
+			status = decode_ret;
+			goto error;
+		}
+	}
+	while(try_decoding_again);
+
+	/* after CRC failure, if the SN value seems to be correctly guessed, we must
+	 * wait for 3 CRC-valid packets before the correction is approved. Two
+	 * packets are therefore thrown away. */
+	if(context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE)
+	{
+		if(context->crc_corr.counter > 1)
+		{
+			/* update context with decoded values even if we drop the packet */
+			rohc_decomp_update_context(context, decoded_values, payload_len,
+			                           rohc_packet.time, do_change_mode);
+			context->dup_cache.rohc_hdr_len = 0;
+
+			context->crc_corr.counter--;
+			rohc_decomp_warn(context, "CID %u: CRC repair: throw away packet, "
+			                 "still %zu CRC-valid packets required",
+			                 context->cid, context->crc_corr.counter);
+
+			status = ROHC_STATUS_BAD_CRC;
+			goto error;
+		}
+		else if(context->crc_corr.counter == 1)
+		{
+			rohc_decomp_warn(context, "CID %u: CRC repair: correction is "
+			                 "successful, keep packet", context->cid);
+			rohc_stats_write_begin(&decomp->stats_seq);
+			context->corrected_crc_failures++;
+			decomp->stats.corrected_crc_failures++;
+			switch(context->crc_corr.algo)
+			{
+				case ROHC_DECOMP_CRC_CORR_SN_WRAP:
+					context->corrected_sn_wraparounds++;
+					decomp->stats.corrected_sn_wraparounds++;
+					break;
+				case ROHC_DECOMP_CRC_CORR_SN_UPDATES:
+					context->corrected_wrong_sn_updates++;
+					decomp->stats.corrected_wrong_sn_updates++;
+					break;
+				case ROHC_DECOMP_CRC_CORR_SN_NONE:
+				default:
+					rohc_error(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+					           "CID %u: CRC repair: unsupported repair algorithm %d",
+					           context->cid, context->crc_corr.algo);
+					assert(0);
+					rohc_stats_write_end(&decomp->stats_seq);
+					status = ROHC_STATUS_ERROR;
+					goto error;
+			}
+			rohc_stats_write_end(&decomp->stats_seq);
+			context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
+			context->crc_corr.counter--;
+		}
+	}
+
+decoded:
+	/* hold the packet if it arrived before some of the packets that precede
+	 * it, it is decoded again once they updated the context */
+	if(!is_dup &&
+	   rohc_decomp_reorder_hold(decomp, context, *packet_type, rohc_packet,
+	                            add_cid_len, in_place, decoded_values))
+	{
+		uncomp_packet->len = 0;
+		status = ROHC_STATUS_OK;
+		goto error;
+	}
+	uncomp_hdr_len = uncomp_packet->len;
+
+	/* restore the fragmentation of the innermost IPv4 header */
+	if(frag_len != 0 && do_build_hdrs &&
+	   !rohc_decomp_set_ip_frag(context, rohc_buf_data(*uncomp_packet),
+	                            uncomp_hdr_len, ipv4_frag))
+	{
+		status = ROHC_STATUS_MALFORMED;
+		goto error;
+	}
+
+
+	/* E. Copy the payload (if any) */
+
+	if((rohc_hdr_len + payload_len) != (rohc_packet.len + decomp->chain_tail_len))
+	{
+		rohc_decomp_warn(context, "ROHC %s header (%zu bytes) and payload "
+		                 "(%zu bytes) do not match the full ROHC packet "
+		                 "(%zu bytes)", rohc_get_packet_descr(*packet_type),
+		                 rohc_hdr_len, payload_len,
+		                 rohc_packet.len + decomp->chain_tail_len);
+		status = ROHC_STATUS_ERROR;
+		goto error;
+	}
+	if(do_inspect)
+	{
+		/* the payload of the inspected packet is not copied */
+		rohc_decomp_debug(context, "%zu-byte payload is not copied for "
+		                  "inspection", payload_len);
+	}
+	else if(in_place)
+	{
+		/* the payload stays where it is, the uncompressed headers are moved
+		 * right before it once the context is updated since the decoded values
+		 * may still refer to the ROHC header */
+		rohc_decomp_debug(context, "%zu-byte payload stays in place", payload_len);
+	}
+	else if(decomp->chain_by_ref)
+	{
+		/* the payload is referenced where it is in the chain of buffers */
+		decomp->chain_head_payload = payload_data;
+		decomp->chain_head_payload_len = payload_len - decomp->chain_tail_len;
+		rohc_decomp_debug(context, "reference %zu-byte payload without copy",
+		                  payload_len);
+	}
+	else
+	{
+		rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+		if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+		{
+			rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+			                 "max) for the %zu-byte payload",
+			                 rohc_buf_avail_len(*uncomp_packet), payload_len);
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			goto error;
+		}
+		if(payload_len != 0 && rohc_decomp_rru_is_ref(decomp, rohc_packet))
+		{
+			/* copy the payload of the RRU straight from the segments */
+			rohc_decomp_rru_read(decomp, rohc_packet.offset + rohc_hdr_len,
+			                     payload_len, rohc_buf_data(*uncomp_packet) +
+			                     uncomp_packet->len);
+			uncomp_packet->len += payload_len;
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
+		else if(payload_len != 0)
+		{
+			rohc_buf_append(uncomp_packet, payload_data, payload_len);
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
+		/* unhide the uncompressed headers and payload */
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
+		rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
+		                  uncomp_packet->len);
+	}
+	rohc_decomp_perf_lap(decomp, &perf_clock, ROHC_DECOMP_PERF_PAYLOAD);
+
+
+	/* F. Update the compression context
+	 *
+	 * Once CRC check is done, update the compression context with the values
+	 * that were decoded earlier.
+	 *
+	 * TODO: check what fields shall be updated in the context
+	 */
+
+	if(is_dup)
+	{
+		/* the context already took the original packet into account */
+		context->is_duplicated = true;
+		*do_change_mode = false;
+	}
+	else
+	{
+		/* we are either already in full context state or we can transit
+		 * through it */
+		if(context->state != ROHC_DECOMP_STATE_FC)
+		{
+			rohc_decomp_debug(context, "change from state %d to state %d",
+			                  context->state, ROHC_DECOMP_STATE_FC);
+			context->state = ROHC_DECOMP_STATE_FC;
+		}
+
+		/* update context with decoded values */
+		context->is_duplicated = false;
+		rohc_decomp_update_context(context, decoded_values, payload_len,
+		                           rohc_packet.time, do_change_mode);
+	}
+
+	/* record the header lengths for the statistics updated once the packet
+	 * is fully handled */
+	context->volat_ctxt.comp_hdr_len = rohc_hdr_len;
+	context->volat_ctxt.uncomp_hdr_len = uncomp_hdr_len;
+
+	/* the inspected packet is returned empty, the uncompressed headers built
+	 * to verify its CRC are dropped */
+	if(do_inspect)
+	{
+		uncomp_packet->len = 0;
+		decomp->pkt_inspected = true;
+	}
+	/* move the uncompressed headers built in the headroom right before the
+	 * payload */
+	else if(in_place)
+	{
+		const size_t payload_offset = payload_data - uncomp_packet->data;
+		assert(payload_offset >= (uncomp_packet->offset + uncomp_hdr_len));
+		memmove(uncomp_packet->data + payload_offset - uncomp_hdr_len,
+		        rohc_buf_data(*uncomp_packet), uncomp_hdr_len);
+		uncomp_packet->max_len = payload_offset + payload_len;
+		uncomp_packet->offset = payload_offset - uncomp_hdr_len;
+		uncomp_packet->len = uncomp_hdr_len + payload_len;
+		rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
+		                  uncomp_packet->len);
+	}
+
+	/* record the packet to detect its duplicates, the inspected packets are
+	 * not since their uncompressed headers are not kept */
+	if(!is_dup && !do_inspect)
+	{
+		rohc_decomp_dup_cache_record(decomp, context, *packet_type, rohc_packet,
+		                             rohc_hdr_len, payload_len, *uncomp_packet,
+		                             uncomp_hdr_len);
+	}
+	rohc_decomp_perf_lap(decomp, &perf_clock, ROHC_DECOMP_PERF_UPDATE);
+	rohc_decomp_perf_stop(decomp, &perf_clock);
+
+	/* decompression is successful */
+	status = ROHC_STATUS_OK;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Restore the fragmentation of the innermost IPv4 header
+ *
+ * The IP-only profiles build the uncompressed headers of an IPv4 fragment
+ * without its MF flag nor its fragment offset, they are carried in the
+ * IPv4 fragment field behind the ROHC header, see
+ * \ref ROHC_DECOMP_FEATURE_IP_FRAGMENTS. The field is written in the
+ * innermost IPv4 header whose checksum is then computed again. Restoring
+ * the same field twice is harmless.
+ *
+ * @param context    The decompression context
+ * @param hdrs       The uncompressed IP headers
+ * @param hdrs_len   The length of the uncompressed IP headers
+ * @param ipv4_frag  The MF flag and the fragment offset to restore
+ * @return           true if the fragmentation was restored or if the packet
+ *                   is not a fragment, false if the field does not match
+ *                   the uncompressed headers
+ */
+static bool rohc_decomp_set_ip_frag(const struct rohc_decomp_ctxt *const context,
+                                    uint8_t *const hdrs,
+                                    const size_t hdrs_len,
+                                    const uint16_t ipv4_frag)
+{
+	struct ipv4_hdr *ipv4 = NULL;
+	size_t off = 0;
+	uint8_t next_proto;
+
+	/* find the innermost IP header */
+	do
+	{
+		if(off >= hdrs_len)
+		{
+			goto error;
+		}
+		if((hdrs[off] >> 4) == IPV4 && (off + sizeof(struct ipv4_hdr)) <= hdrs_len)
+		{
+			ipv4 = (struct ipv4_hdr *) (hdrs + off);
+			if(ipv4->ihl < (sizeof(struct ipv4_hdr) / sizeof(uint32_t)))
+			{
+				goto error;
+			}
+			next_proto = ipv4->protocol;
+			off += ipv4->ihl * sizeof(uint32_t);
+		}
+		else if((hdrs[off] >> 4) == IPV6 && (off + sizeof(struct ipv6_hdr)) <= hdrs_len)
+		{
+			ipv4 = NULL;
+			next_proto = ((const struct ipv6_hdr *) (hdrs + off))->nh;
+			off += sizeof(struct ipv6_hdr);
+			while(rohc_is_ipv6_opt(next_proto))
+			{
+				const uint8_t ext_type = next_proto;
+
+				if((off + 2) > hdrs_len)
+				{
+					goto error;
+				}
+				next_proto = hdrs[off];
+				if(ext_type == ROHC_IPPROTO_AH)
+				{
+					off += (hdrs[off + 1] + 2) * sizeof(uint32_t);
+				}
+				else
+				{
+					off += (hdrs[off + 1] + 1) * 8;
+				}
+			}
+		}
+		else
+		{
+			goto error;
+		}
+	}
+	while(rohc_is_tunneling(next_proto) && off < hdrs_len);
+
+	if(ipv4 == NULL)
+	{
+		if(ipv4_frag != 0)
+		{
+			goto error;
+		}
+		return true;
+	}
+	ipv4->frag_off = rohc_hton16((rohc_ntoh16(ipv4->frag_off) & IPV4_DF) | ipv4_frag);
+	ipv4->check = 0;
+	ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
+
+	return true;
+
+error:
+	rohc_decomp_warn(context, "IPv4 fragment field 0x%04x does not match the "
+	                 "uncompressed headers", ipv4_frag);
+	return false;
+}
+
+
+/**
+ * @brief Try to decode one ROHC packet
+ *
+ * Steps:
+ *  \li A. Decode extracted bits
+ *  \li B. Build uncompressed headers (and check for correct decompression
+ *         for UO* packets)
+ *
+ * @param decomp               The ROHC decompressor
+ * @param context              The decompression context
+ * @param packet_type          The type of the ROHC packet to parse
+ * @param extr_crc_bits        The CRC bits extracted from the ROHC header
+ * @param extr_bits            The bits extracted from the ROHC header
+ * @param payload_len          The length of the packet payload (in bytes)
+ * @param[out] decoded_values  The values decoded from extracted bits
+ * @param do_build_hdrs        Whether to build the uncompressed headers, and
+ *                             so to check the CRC of UO* packets, or not
+ * @param[out] uncomp_packet   The uncompressed packet
+ * @param perf_clock           The clock that measures the phases of
+ *                             decompression
+ * @return                     ROHC_STATUS_OK if packet is successfully decoded,
+ *                             ROHC_STATUS_MALFORMED if packet is malformed,
+ *                             ROHC_STATUS_BAD_CRC if a CRC error occurs,
+ *                             ROHC_STATUS_ERROR if an error occurs
+ */
+static rohc_status_t rohc_decomp_try_decode_pkt(struct rohc_decomp *const decomp,
+                                                const struct rohc_decomp_ctxt *const context,
+                                                const rohc_packet_t packet_type,
+                                                const struct rohc_decomp_crc *const extr_crc_bits,
+                                                const void *const extr_bits,
+                                                const size_t payload_len,
+                                                void *const decoded_values,
+                                                const bool do_build_hdrs,
+                                                struct rohc_buf *const uncomp_packet,
+                                                struct rohc_perf_clock *const perf_clock)
+{
+	const struct rohc_decomp_profile *const profile =
+		rohc_decomp_ctxt_profile(context);
+	size_t uncomp_hdr_len; /* length of the uncompressed headers */
+	rohc_status_t status;
+
+	assert(packet_type != ROHC_PACKET_UNKNOWN);
+
+	/* A. Decode extracted bits
+	 *
+	 * All bits are now extracted from the packet, let's decode them.
+	 */
+
+	status = profile->decode_bits(context, extr_bits, payload_len, decoded_values);
+	if(status != ROHC_STATUS_OK)
+	{
+		rohc_decomp_warn(context, "failed to decode values from bits extracted "
+		                 "from ROHC header");
+		goto error;
+	}
+	rohc_decomp_perf_lap(decomp, perf_clock, ROHC_DECOMP_PERF_DECODE);
+
+	/* B. Build uncompressed headers & check for correct decompression
+	 *
+	 * All fields are now decoded, let's build the uncompressed headers.
+	 *
+	 * Use the CRC on decompressed headers to check whether decompression was
+	 * correct.
+	 */
+
+	if(!do_build_hdrs)
+	{
+		rohc_decomp_debug(context, "do not build uncompressed headers for "
+		                  "inspection");
+	}
+	else
+	{
+		/* build the uncompressed headers */
+		status = profile->build_hdrs(decomp, context, packet_type, extr_crc_bits,
+		                             decoded_values, payload_len,
+		                             uncomp_packet, &uncomp_hdr_len);
+		rohc_decomp_perf_lap(decomp, perf_clock, ROHC_DECOMP_PERF_BUILD);
+		if(status != ROHC_STATUS_OK)
+		{
+			rohc_decomp_warn(context, "CID %u: failed to build uncompressed "
+			                 "headers: %s", context->cid, rohc_strerror(status));
+			goto error;
+		}
+	}
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Check whether the CRC on IR or IR-DYN header is correct or not
+ *
+ * The CRC for IR/IR-DYN headers is always CRC-8. It is computed on the
+ * whole compressed header (payload excluded, but any CID bits included).
+ *
+ * @param context         The decompression context
+ * @param rohc_hdr        The compressed IR or IR-DYN header
+ * @param rohc_hdr_len    The length (in bytes) of the compressed header
+ * @param add_cid_len     The length of the optional Add-CID field
+ * @param large_cid_len   The length of the optional large CID field
+ * @param crc_packet      The CRC extracted from the ROHC header
+ * @return                true if the CRC is correct, false otherwise
+ */
+static bool rohc_decomp_check_ir_crc(const struct rohc_decomp_ctxt *const context,
+                                     const uint8_t *const rohc_hdr,
+                                     const size_t rohc_hdr_len,
+                                     const size_t add_cid_len,
+                                     const size_t large_cid_len,
+                                     const struct rohc_decomp_crc_one *const crc_packet)
+{
+	const rohc_crc_type_t crc_type = ROHC_CRC_TYPE_8;
+	const uint8_t crc_zero[] = { 0x00 };
+	unsigned int crc_comp; /* computed CRC */
+
+	assert(rohc_hdr_len >= (add_cid_len + 2 + large_cid_len + 1));
+	assert(crc_packet->type == ROHC_CRC_TYPE_8);
+
+	/* ROHC header before CRC field:
+	 * optional Add-CID + IR type + Profile ID + optional large CID */
+	crc_comp = crc_engine_calc(&context->decompressor->crc_engine,
+	                           crc_type, rohc_hdr, add_cid_len + 2 + large_cid_len,
+	                           CRC_INIT_8);
+
+	/* all profiles but the Uncompressed profile compute their CRC through the
+	 * zeroed CRC field and the rest of the ROHC header */
+	if(context->profile->id != ROHC_PROFILE_UNCOMPRESSED)
+	{
+		/* zeroed CRC field */
+		crc_comp = crc_engine_calc(&context->decompressor->crc_engine,
+		                           crc_type, crc_zero, 1, crc_comp);
+
+		/* ROHC header after CRC field */
+		crc_comp = crc_engine_calc(&context->decompressor->crc_engine, crc_type,
+		                           rohc_hdr + add_cid_len + 2 + large_cid_len + 1,
+		                           rohc_hdr_len - add_cid_len - 2 - large_cid_len - 1,
+		                           crc_comp);
+	}
+
+	rohc_decomp_debug(context, "CRC-%d on compressed %zu-byte ROHC header = "
+	                  "0x%x", crc_type, rohc_hdr_len, crc_comp);
+
+	/* does the computed CRC match the one in packet? */
+	if(crc_comp != crc_packet->bits)
+	{
+		rohc_decomp_warn(context, "CRC failure (computed = 0x%02x, packet = "
+		                 "0x%02x)", crc_comp, crc_packet->bits);
+		goto error;
+	}
+
+	/* computed CRC matches the one in packet */
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Update context with decoded values
+ *
+ * @param context              The decompression context
+ * @param decoded              The decoded values to update in the context
+ * @param payload_len          The length of the packet payload
+ * @param pkt_arrival_time     The arrival time of the decoded ROHC packet
+ * @param[out] do_change_mode  Whether the context wants to change its
+ *                             operational mode or not
+ */
+static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
+                                       const void *const decoded,
+                                       const size_t payload_len,
+                                       const struct rohc_ts pkt_arrival_time,
+                                       bool *const do_change_mode)
+{
+	struct rohc_decomp_crc_corr_ctxt *const crc_corr = &context->crc_corr;
+
+	/* call the profile-specific callback */
+	rohc_decomp_ctxt_profile(context)->update_ctxt(context, decoded, payload_len,
+	                                               do_change_mode);
+
+	/* update arrival time */
+	crc_corr->arrival_times[crc_corr->arrival_times_index] = pkt_arrival_time;
+	crc_corr->arrival_times_index =
+		(crc_corr->arrival_times_index + 1) % ROHC_MAX_ARRIVAL_TIMES;
+	crc_corr->arrival_times_nr =
+		rohc_min(crc_corr->arrival_times_nr + 1, ROHC_MAX_ARRIVAL_TIMES);
+}
+
+
+/**
+ * @brief Is the given packet a duplicate of the last packet of the context?
+ *
+ * The duplicate has the same ROHC header, so the same SN bits and the same
+ * CRC, and the same payload length as the last packet recorded in the
+ * context, and no packet updated the context since then. The IR, IR-DYN and
+ * IR-CR packets are never deemed duplicates, neither are the packets received
+ * while a CRC repair is in progress.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param context       The decompression context
+ * @param packet_type   The type of the parsed ROHC packet
+ * @param rohc_packet   The ROHC packet, without the Add-CID
+ * @param rohc_hdr_len  The length of the parsed ROHC header
+ * @param payload_len   The length of the payload
+ * @return              true if the packet is a duplicate, false otherwise
+ */
+static bool rohc_decomp_dup_cache_match(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context,
+                                        const rohc_packet_t packet_type,
+                                        const struct rohc_buf rohc_packet,
+                                        const size_t rohc_hdr_len,
+                                        const size_t payload_len)
+{
+	const struct rohc_decomp_dup_cache *const cache = &context->dup_cache;
+
+	return ((decomp->features & ROHC_DECOMP_FEATURE_DUP_SHORTCUT) != 0 &&
+	        cache->rohc_hdr_len != 0 &&
+	        cache->rohc_hdr_len == rohc_hdr_len &&
+	        cache->payload_len == payload_len &&
+	        context->state == ROHC_DECOMP_STATE_FC &&
+	        context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE &&
+	        !rohc_packet_is_ir(packet_type) &&
+	        !rohc_decomp_rru_is_ref(decomp, rohc_packet) &&
+	        memcmp(cache->rohc_hdr, rohc_buf_data(rohc_packet), rohc_hdr_len) == 0);
+}
+
+
+/**
+ * @brief Re-emit the uncompressed headers of the last packet of the context
+ *
+ * @param context            The decompression context
+ * @param[out] uncomp_packet The uncompressed packet
+ * @return                   ROHC_STATUS_OK if the headers are emitted,
+ *                           ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                           uncompressed packet is too small
+ */
+static rohc_status_t rohc_decomp_dup_cache_emit(const struct rohc_decomp_ctxt *const context,
+                                                struct rohc_buf *const uncomp_packet)
+{
+	const struct rohc_decomp_dup_cache *const cache = &context->dup_cache;
+
+	if(rohc_buf_avail_len(*uncomp_packet) < cache->uncomp_hdrs_len)
+	{
+		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+		                 "max) for the %u-byte uncompressed headers",
+		                 rohc_buf_avail_len(*uncomp_packet),
+		                 cache->uncomp_hdrs_len);
+		return ROHC_STATUS_OUTPUT_TOO_SMALL;
+	}
+	rohc_buf_append(uncomp_packet, cache->uncomp_hdrs, cache->uncomp_hdrs_len);
+
+	return ROHC_STATUS_OK;
+}
+
+
+/**
+ * @brief Record the last packet of the context to detect its duplicates
+ *
+ * The packet is not recorded, and the previous packet is forgotten, if the
+ * feature is disabled, if the packet is one IR, IR-DYN or IR-CR packet, or if
+ * its headers are too large to be recorded.
+ *
+ * @param decomp          The ROHC decompressor
+ * @param context         The decompression context
+ * @param packet_type     The type of the ROHC packet
+ * @param rohc_packet     The ROHC packet, without the Add-CID
+ * @param rohc_hdr_len    The length of the ROHC header
+ * @param payload_len     The length of the payload
+ * @param uncomp_packet   The uncompressed packet
+ * @param uncomp_hdr_len  The length of the uncompressed headers
+ */
+static void rohc_decomp_dup_cache_record(const struct rohc_decomp *const decomp,
+                                         struct rohc_decomp_ctxt *const context,
+                                         const rohc_packet_t packet_type,
+                                         const struct rohc_buf rohc_packet,
+                                         const size_t rohc_hdr_len,
+                                         const size_t payload_len,
+                                         const struct rohc_buf uncomp_packet,
+                                         const size_t uncomp_hdr_len)
+{
+	struct rohc_decomp_dup_cache *const cache = &context->dup_cache;
+
+	if((decomp->features & ROHC_DECOMP_FEATURE_DUP_SHORTCUT) == 0 ||
+	   rohc_packet_is_ir(packet_type) ||
+	   rohc_decomp_rru_is_ref(decomp, rohc_packet) ||
+	   rohc_hdr_len == 0 ||
+	   rohc_hdr_len > ROHC_DECOMP_DUP_ROHC_HDR_MAX_LEN ||
+	   uncomp_hdr_len > ROHC_DECOMP_DUP_UNCOMP_HDRS_MAX_LEN)
+	{
+		cache->rohc_hdr_len = 0;
+		return;
+	}
+
+	memcpy(cache->rohc_hdr, rohc_buf_data(rohc_packet), rohc_hdr_len);
+	cache->rohc_hdr_len = rohc_hdr_len;
+	memcpy(cache->uncomp_hdrs, rohc_buf_data(uncomp_packet), uncomp_hdr_len);
+	cache->uncomp_hdrs_len = uncomp_hdr_len;
+	cache->payload_len = payload_len;
+}
+
+
+/**
+ * @brief Build a positive ACK feedback
+ *
+ * @param decomp         The ROHC decompressor
+ * @param infos          The information collected on the successfully
+ *                       decompressed packet
+ * @param[out] feedback  The feedback to be transmitted to the remote
+ *                       compressor through the feedback channel
+ * @return               true if the ACK feedback was successfully built
+ *                       (may be 0 byte), false if a problem occurred
+ */
+static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_stream *const infos,
+                                     struct rohc_buf *const feedback)
+{
+#ifndef ROHC_NO_TRACES
+	const char mode_short[ROHC_R_MODE + 1] = { '?', 'U', 'O', 'R' };
+#endif
+	bool do_build_ack = false;
+	size_t k;
+
+	assert(infos->cid_found);
+	assert(infos->context_found);
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+	           "CID %u: %s: %s state: %s packet successfully decompressed",
+	           infos->cid, rohc_get_mode_descr(infos->mode),
+	           rohc_decomp_get_state_descr(infos->state),
+	           rohc_get_packet_descr(infos->packet_type));
+
+	/* update all the stats about the feedbacks */
+	decomp->last_pkts_errors <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
+	infos->context->last_pkts_errors <<= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
+
+	/* the inspected packets are not acknowledged */
+	if((decomp->features & ROHC_DECOMP_FEATURE_INSPECT) != 0)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not send a positive ACK for an inspected packet");
+		goto skip;
+	}
+	/* force sending an ACK if compressor/decompressor modes mismatch or
+	 * if decompressor just changed its operational mode */
+	else if(infos->do_change_mode)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "force positive ACK because mode changed or compressor "
+		           "reported a different mode");
+		do_build_ack = true;
+	}
+	/* check if the decompressor shall build a positive feedback */
+	else if(infos->mode == ROHC_U_MODE)
+	{
+		/* send ACK(U) with rate-limiting as stated in RFC 3095, §5.3.1.3:
+		 *   To improve performance for the Unidirectional mode over a link that
+		 *   does have a feedback channel, the decompressor MAY send an
+		 *   acknowledgment when decompression succeeds.  Setting the mode
+		 *   parameter in the ACK packet to U indicates that the compressor is to
+		 *   stay in Unidirectional mode. [...] If IR packets continue to arrive,
+		 *   the decompressor MAY repeat the ACK(U), but it SHOULD NOT repeat the
+		 *   ACK(U) continuously.*/
+		do_build_ack = true;
+	}
+	else if(infos->mode == ROHC_O_MODE)
+	{
+		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
+
+		/* all states: when an IR packet is correctly decompressed, send an ACK(O) */
+		if(infos->packet_type == ROHC_PACKET_IR)
+		{
+			do_build_ack = true;
+		}
+		/* SC state:
+		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
+		 *    optionally send an ACK(O)
+		 * FC state:
+		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
+		 *    optionally send an ACK(O)
+		 *  - when a type 0 or 1 packet is correctly decompressed, no
+		 *    feedback is sent */
+		else if(infos->state != ROHC_DECOMP_STATE_NC &&
+		        rohc_packet_carry_crc_7_or_8(infos->packet_type))
+		{
+			do_build_ack = true;
+		}
+	}
+	else /* R-mode */
+	{
+		assert(0); /* TODO: R-mode not implemented yet */
+		goto error;
+	}
+
+	/* stop now if no ACK is required */
+	if(!do_build_ack)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "no need to send a positive ACK");
+		goto skip;
+	}
+
+	/* rate-limit the ACKs */
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
+	k = __builtin_popcount(infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent) * 100;
+	if(k >= decomp->ack_rate_limits.speed.threshold)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not send a positive ACK because of rate-limiting (%zu of 3200 "
+		           "with threshold %zu)", k, decomp->ack_rate_limits.speed.threshold);
+		goto skip;
+	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+	           "should send a positive ACK now (CID = %u, current mode = %d, "
+	           "target mode = %d, at least %zu bits of SN 0x%x, rate-limiting = "
+	           "%zu of 3200 with threshold %zu)", infos->cid, infos->mode,
+	           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
+	           k, decomp->ack_rate_limits.speed.threshold);
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
+	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
+
+	/* prepare feedback packet if asked by user */
+	if(feedback == NULL && decomp->feedback_ring == NULL &&
+	   (decomp->features & ROHC_DECOMP_FEATURE_FEEDBACK_COALESCING) == 0)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "user choose not to use a feedback channel, do not build any "
+		           "feedback packet");
+	}
+	else
+	{
+		rohc_feedback_crc_t crc_present;
+		struct d_feedback sfeedback;
+
+		/* FEEDBACK-1 or FEEDBACK-2 ? */
+		if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED ||
+		   (!infos->do_change_mode && infos->sn_bits_nr != 0 && infos->sn_bits_nr <= 8))
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "use FEEDBACK-1 as positive feedback");
+			f_feedback1(infos->sn_bits, &sfeedback);
+			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
+		}
+		else
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "use FEEDBACK-2 as positive ACK(%c) feedback",
+			           mode_short[infos->mode]);
+			if(!f_feedback2(infos->profile_id, ROHC_FEEDBACK_ACK, infos->mode,
+			                infos->sn_bits, infos->sn_bits_nr, &sfeedback))
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+				             "failed to build the ACK feedback");
+				goto error;
+			}
+
+			/* use CRC option if mode change requested */
+			if(infos->profile_id == ROHC_PROFILE_TCP ||
+			   rohc_profile_is_rohcv2(infos->profile_id))
+			{
+				/* CRC is present in base header for TCP and ROHCv2 profiles */
+				crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
+			}
+			else if(infos->do_change_mode)
+			{
+				crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
+			}
+			else
+			{
+				crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
+			}
+		}
+
+		/* build the feedback packet in the buffer provided by the user, or
+		 * accumulate it until the next flush */
+		if(!rohc_decomp_feedback_send(decomp, infos, ROHC_FEEDBACK_ACK, &sfeedback,
+		                              crc_present, feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			             "failed to wrap the ACK feedback");
+			goto error;
+		}
+		if(feedback != NULL && feedback->len > 0)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "decompressor built a %zu-byte positive feedback",
+			           feedback->len);
+		}
+	}
+
+skip:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build a negative ACK feedback
+ *
+ * There are two types of negative feedback: NACK and STATIC-NACK.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param infos          The information collected on the failed
+ *                       decompressed packet
+ * @param[out] feedback  The feedback to be transmitted to the remote
+ *                       compressor through the feedback channel (may be NULL)
+ * @return               true if the ACK feedback was successfully built
+ *                       (may be 0 byte), false if a problem occurred
+ */
+static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_stream *const infos,
+                                      struct rohc_buf *const feedback)
+{
+	bool do_downward_transition = false;
+	bool do_build_ack = false;
+	enum rohc_feedback_ack_type ack_type;
+	size_t threshold_too_quickly;
+	size_t k_too_quickly;
+	size_t k_too_many;
+
+	/* update all the stats about the feedbacks */
+	decomp->last_pkts_errors <<= 1;
+	decomp->last_pkts_errors |= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
+	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
+	if(infos->context != NULL)
+	{
+		infos->context->last_pkts_errors <<= 1;
+		infos->context->last_pkts_errors |= 1;
+		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
+		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
+		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
+		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
+		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
+		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
+	}
 
-	/* collect information for sending feedback to decompressor */
-	stream->context_found = true;
-	stream->mode = stream->context->mode;
-	stream->state = stream->context->state;
-	if(!is_new_context)
+	/* the decompressor cannot warn the compressor if the CID is not identified
+	 * (this happens only if packet is malformed) */
+	if(!infos->cid_found)
 	{
-		stream->sn_bits = profile->get_sn(stream->context);
-		stream->sn_bits_nr = sn_feedback_min_bits;
-		rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
-		                  "(%zu bits required for RTT, %zu max)",
-		                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
-		                  profile->msn_max_bits);
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not perform downward state transition nor send negative "
+		           "feedback to compressor since CID was not identified");
+		goto skip;
 	}
 
-	/* detect the type of the ROHC packet */
-	stream->packet_type = profile->detect_pkt_type(stream->context, walk, remain_len,
-	                                               large_cid_len);
-	if(stream->packet_type == ROHC_PACKET_UNKNOWN)
+	if(infos->context_found)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "failed to detect ROHC packet type");
-		if(is_new_context)
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "CID %u: %s: %s state: %s packet %s", infos->cid,
+		           rohc_get_mode_descr(infos->mode),
+		           rohc_decomp_get_state_descr(infos->state),
+		           rohc_get_packet_descr(infos->packet_type),
+		           infos->crc_failed ? "failed the CRC check" : "received");
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "CID %u: packet failed to be parsed", infos->cid);
+	}
+
+	/* check if the decompressor shall build a negative feedback */
+	if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED)
+	{
+		/* the Uncompressed profile does not use negative feedback nor FEEDBACK-2 */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not perform downward state transition nor send negative "
+		           "feedback for the Uncompressed profile");
+		goto skip;
+	}
+	else if(!infos->context_found)
+	{
+		/* RFC says nothing about negative feedbacks for malformed packets, but
+		 * it seems useful to tell the compressor to got back to lower states
+		 * if a packet failed to be parsed */
+		ack_type = ROHC_FEEDBACK_STATIC_NACK;
+		do_downward_transition = false; /* impossible w/o context */
+		do_build_ack = !!(decomp->target_mode > ROHC_U_MODE);
+	}
+	else if(infos->mode == ROHC_U_MODE)
+	{
+		/* U-mode does not use negative feedback */
+		ack_type = ROHC_FEEDBACK_NACK;
+		do_downward_transition = true;
+		do_build_ack = false;
+	}
+	else if(infos->mode == ROHC_O_MODE)
+	{
+		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
+
+		/* NC state: when receiving a type 0, 1, 2 or IR-DYN packet, or an IR
+		 * packet has failed the CRC check, send a STATIC-NACK(O), subject to the
+		 * considerations at the beginning of section 5.7.6 */
+		if(infos->state == ROHC_DECOMP_STATE_NC)
+		{
+			ack_type = ROHC_FEEDBACK_STATIC_NACK;
+			do_downward_transition = true;
+			do_build_ack = true;
+		}
+		/* SC state:
+		 *  - when a type 0 or 1 packet is received, treat it as a mismatching
+		 *    CRC and use the logic of section 5.3.2.2.3 to decide if a NACK(O)
+		 *    should be sent
+		 *  - when decompression of a type 2 packet, an IR-DYN packet or an
+		 *    IR packet has failed, use the logic of section 5.3.2.2.3 to
+		 *    decide if a STATIC-NACK(O) should be sent */
+		else if(infos->state == ROHC_DECOMP_STATE_SC)
+		{
+			if(!rohc_packet_carry_crc_7_or_8(infos->packet_type))
+			{
+				ack_type = ROHC_FEEDBACK_NACK;
+				do_downward_transition = true;
+				do_build_ack = true;
+			}
+			else
+			{
+				ack_type = ROHC_FEEDBACK_STATIC_NACK;
+				do_downward_transition = true;
+				do_build_ack = true;
+			}
+		}
+		/* FC state: when any packet fails the CRC check, use the logic of
+		 * 5.3.2.2.3 to decide if a NACK(O) should be sent */
+		else
+		{
+			ack_type = ROHC_FEEDBACK_NACK;
+			do_downward_transition = true;
+			do_build_ack = true;
+		}
+	}
+	else /* R-mode */
+	{
+		assert(0); /* TODO: R-mode not implemented yet */
+		goto error;
+	}
+
+	/* the inspected packets are not acknowledged, but the context follows
+	 * the downward state transitions of the decompressor */
+	if((decomp->features & ROHC_DECOMP_FEATURE_INSPECT) != 0)
+	{
+		do_build_ack = false;
+	}
+
+	/* stop now if no downward state transition nor NACK is required */
+	if(!do_build_ack && !do_downward_transition)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "no need to perform a downward state transition nor send a "
+		           "negative ACK");
+		goto skip;
+	}
+	assert(ack_type == ROHC_FEEDBACK_NACK || ack_type == ROHC_FEEDBACK_STATIC_NACK);
+
+	/* rate-limit the downward state transitions and NACKs */
+	if(infos->context != NULL)
+	{
+		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
+		infos->context->last_pkt_feedbacks[ack_type].needed |= 1;
+		k_too_quickly = __builtin_popcount(infos->context->last_pkts_errors) * 100;
+		k_too_many = __builtin_popcount(infos->context->last_pkt_feedbacks[ack_type].sent) * 100;
+	}
+	else
+	{
+		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
+		k_too_quickly = __builtin_popcount(decomp->last_pkts_errors) * 100;
+		k_too_many = __builtin_popcount(decomp->last_pkt_feedbacks[ack_type].sent) * 100;
+	}
+	if(ack_type == ROHC_FEEDBACK_NACK)
+	{
+		threshold_too_quickly = decomp->ack_rate_limits.nack.threshold;
+	}
+	else
+	{
+		threshold_too_quickly = decomp->ack_rate_limits.static_nack.threshold;
+	}
+	if(k_too_quickly < threshold_too_quickly)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "avoid sending feedback too quickly (%zu of 3200 with threshold %zu)",
+		           k_too_quickly, threshold_too_quickly);
+
+		/* force sending a negative ACK if compressor/decompressor modes mismatch
+		 * or if decompressor just changed its operational mode */
+		if(do_build_ack && infos->do_change_mode)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "force negative ACK because mode changed or compressor "
+			           "reported a different mode");
+			do_build_ack = true;
+		}
+		else
+		{
+			do_build_ack = false;
+		}
+		do_downward_transition = false;
+	}
+	else if(k_too_quickly >= (threshold_too_quickly + 100) &&
+	        k_too_many >= decomp->ack_rate_limits.speed.threshold)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "rate-limiting successive feedbacks (%zu of 3200 with threshold "
+		           "%zu)", k_too_many, decomp->ack_rate_limits.speed.threshold);
+
+		/* force sending a negative ACK if compressor/decompressor modes mismatch
+		 * or if decompressor just changed its operational mode */
+		if(do_build_ack && infos->do_change_mode)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "force negative ACK because mode changed or compressor "
+			           "reported a different mode");
+			do_build_ack = true;
+		}
+		else
+		{
+			do_build_ack = false;
+		}
+		do_downward_transition = false;
+	}
+
+	/* rate-limit the STATIC-NACKs of the CID without usable context with its
+	 * token bucket, the compressor gets the first ones of a burst only */
+	if(do_build_ack && ack_type == ROHC_FEEDBACK_STATIC_NACK &&
+	   (!infos->context_found || infos->state == ROHC_DECOMP_STATE_NC) &&
+	   !rohc_decomp_nack_bucket_take(decomp, infos->cid, infos->arrival_time))
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "CID %u: no token left to send a STATIC-NACK", infos->cid);
+		do_build_ack = false;
+	}
+
+	/* update information if feedback is sent or downward transition taken */
+	if(do_build_ack || do_downward_transition)
+	{
+		decomp->last_pkt_feedbacks[ack_type].sent |= 1;
+		if(infos->context != NULL)
+		{
+			infos->context->last_pkt_feedbacks[ack_type].sent |= 1;
+		}
+	}
+
+	/* prepare feedback packet if needed and asked by user */
+	if(!do_build_ack)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not send a negative ACK");
+	}
+	else if(feedback == NULL && decomp->feedback_ring == NULL &&
+	        (decomp->features & ROHC_DECOMP_FEATURE_FEEDBACK_COALESCING) == 0)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "user choose not to use a feedback channel, do not build any "
+		           "feedback packet");
+	}
+	else
+	{
+		rohc_feedback_crc_t crc_present;
+		struct d_feedback sfeedback;
+
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "should send a negative ACK (CID = %u, NACK type = %d, current "
+		           "mode = %d, target mode = %d, at least %zu bits of SN 0x%x, "
+		           "rate-limiting = %zu of 3200 with threshold %zu and %zu of 3200 "
+		           "with threshold %zu)", infos->cid, ack_type, infos->mode,
+		           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
+		           k_too_quickly, threshold_too_quickly,
+		           k_too_many, decomp->ack_rate_limits.speed.threshold);
+
+		/* prepare FEEDBACK-2 */
+		if(!f_feedback2(infos->profile_id, ack_type, infos->mode, infos->sn_bits,
+		                infos->sn_bits_nr, &sfeedback))
 		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			             "failed to build the (STATIC-)NACK feedback");
+			goto error;
 		}
-		goto error_malformed;
-	}
-	rohc_decomp_debug(stream->context, "decode packet as '%s'",
-	                  rohc_get_packet_descr(stream->packet_type));
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "FEEDBACK-2 is %d-byte long", sfeedback.size);
 
-	/* only packets that carry static information can be received in the
-	 * No Context state, other cannot */
-	if(stream->state == ROHC_DECOMP_STATE_NC &&
-	   !rohc_packet_carry_static_info(stream->packet_type))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "CID %u: packet '%s' (%d) does not carry static information, "
-		             "it cannot be received in No Context state",
-		             stream->cid, rohc_get_packet_descr(stream->packet_type),
-		             stream->packet_type);
-		if(is_new_context)
+		/* use CRC option if mode change requested */
+		if(infos->profile_id == ROHC_PROFILE_TCP ||
+		   rohc_profile_is_rohcv2(infos->profile_id))
 		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
+			crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
 		}
-		goto error_malformed;
-	}
-	/* only packets carrying CRC-7 or CRC-8 can be received in the Static Context
-	 * state, other cannot */
-	else if(stream->state == ROHC_DECOMP_STATE_SC &&
-	        !rohc_packet_carry_crc_7_or_8(stream->packet_type))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "CID %u: packet '%s' (%d) does not carry 7- or 8-bit CRC, "
-		             "it cannot be received in Static Context state",
-		             stream->cid, rohc_get_packet_descr(stream->packet_type),
-		             stream->packet_type);
-		if(is_new_context)
+		else if(infos->do_change_mode)
 		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
+			crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
+		}
+		else
+		{
+			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
 		}
-		goto error_malformed;
-	}
-	/* all packet types are allowed in Full Context state */
-
-	/* only IR or IR-CR packet can create a new context */
-	assert(stream->packet_type == ROHC_PACKET_IR ||
-	       stream->packet_type == ROHC_PACKET_IR_CR ||
-	       !is_new_context);
 
-	/* decode the packet thanks to the profile-specific routines
-	 * (may change the initial assumption about the packet type) */
-	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
-	                                add_cid_len, large_cid_len, uncomp_packet,
-	                                &stream->packet_type, &stream->do_change_mode);
-	if(status != ROHC_STATUS_OK)
-	{
-		/* decompression failed, free resources if necessary */
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "failed to decompress packet (code = %d)", status);
-		if(is_new_context)
+		/* build the feedback packet in the buffer provided by the user, or
+		 * accumulate it until the next flush */
+		if(!rohc_decomp_feedback_send(decomp, infos, ack_type, &sfeedback,
+		                              crc_present, feedback))
 		{
-			context_free(stream->context);
-			stream->context = NULL;
-			decomp->last_context = NULL;
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			             "failed to wrap the (STATIC-)NACK feedback");
+			goto error;
+		}
+		if(feedback != NULL && feedback->len > 0)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "decompressor built a %zu-byte negative feedback",
+			           feedback->len);
 		}
-		goto error;
 	}
 
-	/* decompression was successful, replace the existing context with the
-	 * new one if necessary */
-	if(is_new_context)
+	/* upon decompression failure, perform downward transitions if context is
+	 * still available (new contexts are destroyed upon decompression error) */
+	if(!do_downward_transition || infos->context == NULL)
 	{
-		if(decomp->contexts[stream->cid] != NULL)
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "do not perform a downward state transition");
+	}
+	else
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "perform a downward state transition now (CID = %u, NACK "
+		           "type = %d, current mode = %d, target mode = %d, rate-limiting "
+		           "= %zu of 3200 with threshold %zu and %zu of 3200 with "
+		           "threshold %zu)", infos->cid, ack_type, infos->mode,
+		           decomp->target_mode, k_too_quickly, threshold_too_quickly,
+		           k_too_many, decomp->ack_rate_limits.speed.threshold);
+
+		if(infos->state == ROHC_DECOMP_STATE_SC)
 		{
-			context_free(decomp->contexts[stream->cid]);
+			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			          "change from state %d to state %d because of error(s)",
+			          infos->state, ROHC_DECOMP_STATE_NC);
+			infos->context->state = ROHC_DECOMP_STATE_NC;
+		}
+		else if(infos->state == ROHC_DECOMP_STATE_FC)
+		{
+			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			          "change from state %d to state %d because of error(s)",
+			          infos->state, ROHC_DECOMP_STATE_SC);
+			infos->context->state = ROHC_DECOMP_STATE_SC;
+		}
+		else
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "stay in state %d because of error(s)", infos->context->state);
 		}
-		decomp->contexts[stream->cid] = stream->context;
 	}
 
-	/* get the SN of the latest packet successfully decompressed */
-	stream->sn_bits = profile->get_sn(stream->context);
-	stream->sn_bits_nr = sn_feedback_min_bits;
-	rohc_decomp_debug(stream->context, "%zu bits required for SN in feedback "
-	                  "(%zu bits required for RTT, %zu max)",
-	                  sn_feedback_min_bits, decomp->sn_feedback_min_bits,
-	                  profile->msn_max_bits);
-
 skip:
-	return ROHC_STATUS_OK;
+	return true;
 
 error:
-	stream->crc_failed = !!(status == ROHC_STATUS_BAD_CRC);
-	decomp->last_context = NULL;
-	return status;
-
-error_crc:
-	stream->crc_failed = true;
-	decomp->last_context = NULL;
-	return ROHC_STATUS_BAD_CRC;
-
-error_malformed:
-	decomp->last_context = NULL;
-	return ROHC_STATUS_MALFORMED;
-
-error_no_context:
-	decomp->last_context = NULL;
-	return ROHC_STATUS_NO_CONTEXT;
+	return false;
 }
 
 
 /**
- * @brief Decode one ROHC packet
- *
- * Steps:
- *  \li A. Parse the ROHC header
- *  \li B. For IR and IR-DYN packet, check for correct compressed header (CRC)
- *  \li C. Decode extracted bits
- *  \li D. Build uncompressed headers (and check for correct decompression
- *         for UO* packets)
- *  \li E. Copy the payload (if any)
- *  \li F. Update the compression context
+ * @brief Take one token from the bucket of STATIC-NACKs of the given CID
  *
- * Steps C and D may be repeated if packet or context repair is attempted
- * upon CRC failure.
+ * The bucket is refilled with one token per period of time elapsed since its
+ * last refill, or with one token per number of packets dropped if the arrival
+ * times of packets are unknown.
  *
- * @param decomp               The ROHC decompressor
- * @param context              The decompression context
- * @param rohc_packet          The ROHC packet to decode
- * @param add_cid_len          The length of the optional Add-CID field
- * @param large_cid_len        The length of the optional large CID field
- * @param[out] uncomp_packet   The uncompressed packet
- * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
- *                             OUT: The type of the parsed ROHC packet
- * @param[out] do_change_mode  Whether the profile context wants to change
- *                             its operational mode or not
- * @return                     ROHC_STATUS_OK if packet is successfully decoded,
- *                             ROHC_STATUS_MALFORMED if packet is malformed,
- *                             ROHC_STATUS_BAD_CRC if a CRC error occurs,
- *                             ROHC_STATUS_ERROR if an error occurs
+ * @param decomp        The ROHC decompressor
+ * @param cid           The CID the STATIC-NACK would be sent for
+ * @param arrival_time  The arrival time of the packet (0 if unknown)
+ * @return              true if the STATIC-NACK may be sent,
+ *                      false if the bucket is empty
  */
-static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
-                                            struct rohc_decomp_ctxt *const context,
-                                            const struct rohc_buf rohc_packet,
-                                            const size_t add_cid_len,
-                                            const size_t large_cid_len,
-                                            struct rohc_buf *const uncomp_packet,
-                                            rohc_packet_t *const packet_type,
-                                            bool *const do_change_mode)
+static bool rohc_decomp_nack_bucket_take(struct rohc_decomp *const decomp,
+                                         const rohc_cid_t cid,
+                                         const struct rohc_ts arrival_time)
 {
-	const struct rohc_decomp_profile *const profile = context->profile;
-	struct rohc_decomp_crc *const extr_crc_bits = &context->volat_ctxt.crc;
-	void *const extr_bits = context->volat_ctxt.extr_bits;
-	void *const decoded_values = context->volat_ctxt.decoded_values;
-
-	/* length of the parsed ROHC header and of the uncompressed headers */
-	size_t rohc_hdr_len;
-	size_t uncomp_hdr_len;
-
-	/* ROHC and uncompressed payloads (they are the same) */
-	const uint8_t *payload_data;
-	size_t payload_len;
+	struct rohc_decomp_nack_bucket *bucket;
 
-	/* Whether to attempt packet correction or not */
-	bool try_decoding_again;
-
-	/* helper variables for values returned by functions */
-	bool parsing_ok;
-	rohc_status_t status;
-
-	assert(add_cid_len == 0 || add_cid_len == 1);
-	assert(large_cid_len <= 2);
-	assert((*packet_type) != ROHC_PACKET_UNKNOWN);
-
-	/* A. Parse the ROHC header */
-
-	rohc_decomp_debug(context, "parse packet type '%s' (%d)",
-	                  rohc_get_packet_descr(*packet_type), *packet_type);
-
-	/* let's parse the packet! */
-	parsing_ok = profile->parse_pkt(context, rohc_packet, large_cid_len,
-	                                packet_type, extr_crc_bits, extr_bits,
-	                                &rohc_hdr_len);
-	if(!parsing_ok)
+	/* CIDs greater than MAX_CID have no bucket */
+	if(cid > decomp->medium.max_cid)
 	{
-		rohc_decomp_warn(context, "failed to parse the %s header",
-		                 rohc_get_packet_descr(*packet_type));
-		status = ROHC_STATUS_MALFORMED;
-		goto error;
+		return true;
 	}
+	bucket = &decomp->nack_buckets[cid];
 
-	/* ROHC base header and its optional extension is now fully parsed,
-	 * remaining data is the payload */
-	payload_data = rohc_buf_data(rohc_packet) + rohc_hdr_len;
-	payload_len = rohc_packet.len - rohc_hdr_len;
-	rohc_decomp_debug(context, "ROHC payload (length = %zu bytes) starts at "
-	                  "offset %zu", payload_len, rohc_hdr_len);
-
-
-	/*
-	 * B. Check for correct compressed header (CRC)
-	 *
-	 * Use the CRC on compressed headers to check whether IR header was
-	 * correctly received. The optional Add-CID is part of the CRC.
-	 */
-
-	if(extr_crc_bits->comp.type != ROHC_CRC_TYPE_NONE)
+	/* refill the bucket */
+	if(arrival_time.sec == 0 && arrival_time.nsec == 0)
 	{
-		const bool crc_ok =
-			rohc_decomp_check_ir_crc(context,
-			                         rohc_buf_data(rohc_packet) - add_cid_len,
-			                         add_cid_len + rohc_hdr_len, add_cid_len,
-			                         large_cid_len, &extr_crc_bits->comp);
-		if(!crc_ok)
+		bucket->drops_nr++;
+		if(bucket->drops_nr >= ROHC_DECOMP_NACK_BUCKET_REFILL_PKTS)
 		{
-			rohc_decomp_warn(context, "CRC detected a transmission failure for "
-			                 "%s packet", rohc_get_packet_descr(*packet_type));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			bucket->drops_nr = 0;
+			if(bucket->spent_nr > 0)
 			{
-				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
-				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
-				              rohc_buf_data(rohc_packet) - add_cid_len,
-				              rohc_hdr_len + add_cid_len);
+				bucket->spent_nr--;
 			}
-#ifndef ROHC_NO_IR_CRC_CHECK
-			status = ROHC_STATUS_BAD_CRC;
-			goto error;
-#endif
 		}
-
-		/* reset the correction attempt */
-		context->crc_corr.counter = 0;
+	}
+	else
+	{
+		const uint32_t now_ms = rohc_time_ms32(arrival_time);
+		const uint32_t refills_nr =
+			(now_ms - bucket->last_refill_ms) / ROHC_DECOMP_NACK_BUCKET_REFILL_MS;
+
+		if(refills_nr >= bucket->spent_nr)
+		{
+			bucket->spent_nr = 0;
+			bucket->last_refill_ms = now_ms;
+		}
+		else
+		{
+			bucket->spent_nr -= refills_nr;
+			bucket->last_refill_ms += refills_nr * ROHC_DECOMP_NACK_BUCKET_REFILL_MS;
+		}
 	}
 
-
-	try_decoding_again = false;
-	do
+	/* take one token if any is left */
+	if(bucket->spent_nr >= ROHC_DECOMP_NACK_BUCKET_BURST)
 	{
-		rohc_status_t decode_ret;
+		return false;
+	}
+	bucket->spent_nr++;
 
-		if(try_decoding_again)
-		{
-			rohc_decomp_warn(context, "CID %u: CRC repair: try decoding packet "
-			                 "again with new assumptions", context->cid);
-		}
+	return true;
+}
 
 
-		/* C. Decode extracted bits
-		 * D. Build uncompressed headers & check for correct decompression
-		 *
-		 * All bits are now extracted from the packet, let's decode them,
-		 * and then let's build the uncompressed headers with decoded fields.
-		 *
-		 * Use the CRC on decompressed headers to check whether decompression was
-		 * correct.
-		 */
+/**
+ * @brief Send one feedback built by the decompressor
+ *
+ * The feedback is wrapped into the feedback buffer provided by the user, or
+ * directly into a free slot of the feedback ring if one is linked with the
+ * decompressor. If feedback coalescing is enabled, the feedback is accumulated until the
+ * next call to \ref rohc_decomp_flush_feedback instead: one feedback is kept
+ * per CID, the latest feedback replaces the pending one unless the pending
+ * one is a negative ACK of higher priority.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param infos          The information collected on the failed packet
+ * @param ack_type       The type of acknowledgement
+ * @param sfeedback      The FEEDBACK-1 or FEEDBACK-2 data
+ * @param crc_present    How the feedback shall be protected by a CRC
+ * @param[out] feedback  The buffer to store the feedback in, may be NULL
+ * @return               true if the feedback was successfully handled,
+ *                       false if a problem occurred
+ */
+static bool rohc_decomp_feedback_send(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_stream *const infos,
+                                      const enum rohc_feedback_ack_type ack_type,
+                                      struct d_feedback *const sfeedback,
+                                      const rohc_feedback_crc_t crc_present,
+                                      struct rohc_buf *const feedback)
+{
+	if((decomp->features & ROHC_DECOMP_FEATURE_FEEDBACK_COALESCING) != 0)
+	{
+		struct rohc_decomp_pending_feedback *pending = NULL;
+		size_t i;
 
-		decode_ret = rohc_decomp_try_decode_pkt(decomp, context, *packet_type,
-		                                        extr_crc_bits, extr_bits, payload_len,
-		                                        decoded_values, uncomp_packet);
-		if(decode_ret == ROHC_STATUS_OK)
+		/* at most one feedback per CID */
+		for(i = 0; pending == NULL && i < decomp->feedbacks_pending_nr; i++)
 		{
-			/* uncompressed headers successfully built and CRC is correct,
-			 * no need to try decoding with different values */
-			if(context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE)
-			{
-				rohc_decomp_debug(context, "CRC is correct");
-			}
-			else if((*packet_type) == ROHC_PACKET_IR)
-			{
-				rohc_decomp_debug(context, "CRC is correct, stop CRC repair");
-				context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
-				context->crc_corr.counter = 0;
-			}
-			else
+			if(decomp->feedbacks_pending[i].cid == infos->cid)
 			{
-				rohc_decomp_debug(context, "CID %u: CRC repair: CRC is correct",
-				                  context->cid);
-				try_decoding_again = false;
+				pending = &(decomp->feedbacks_pending[i]);
 			}
 		}
-		else if(decode_ret == ROHC_STATUS_BAD_CRC)
+		if(pending != NULL && ack_type < pending->ack_type)
 		{
-			/* uncompressed headers successfully built but CRC is incorrect,
-			 * try decoding with different values (repair) */
-
-			/* attempt a context/packet repair */
-			try_decoding_again =
-				profile->attempt_repair(decomp, context, rohc_packet.time,
-				                        &context->crc_corr, extr_bits);
-
-			/* report CRC failure if attempt is not possible */
-			if(!try_decoding_again)
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "keep the pending feedback of type %d for CID %u",
+			           pending->ack_type, infos->cid);
+			return true;
+		}
+		else if(pending == NULL &&
+		        decomp->feedbacks_pending_nr < ROHC_DECOMP_FEEDBACKS_PENDING_MAX)
+		{
+			pending = &(decomp->feedbacks_pending[decomp->feedbacks_pending_nr]);
+			decomp->feedbacks_pending_nr++;
+		}
+		else if(pending == NULL && ack_type != ROHC_FEEDBACK_ACK)
+		{
+			/* no room left: a negative ACK takes the place of a positive one */
+			for(i = 0; pending == NULL && i < decomp->feedbacks_pending_nr; i++)
 			{
-				/* uncompressed headers successfully built, CRC is incorrect, repair
-				 * was disabled or attempted without any success, so give up */
-				rohc_decomp_warn(context, "CID %u: failed to build uncompressed "
-				                 "headers (CRC failure)", context->cid);
-				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+				if(decomp->feedbacks_pending[i].ack_type == ROHC_FEEDBACK_ACK)
 				{
-					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
-					                 "compressed headers", rohc_packet);
+					pending = &(decomp->feedbacks_pending[i]);
 				}
-				status = ROHC_STATUS_BAD_CRC;
-				goto error;
 			}
 		}
-		else if(decode_ret != ROHC_STATUS_OK)
+
+		if(pending != NULL)
 		{
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			memcpy(&pending->feedback, sfeedback, sizeof(struct d_feedback));
+			pending->cid = infos->cid;
+			pending->cid_type = infos->cid_type;
+			pending->ack_type = ack_type;
+			pending->crc_present = crc_present;
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "feedback of type %d for CID %u accumulated until next "
+			           "flush (%zu feedbacks pending)", ack_type, infos->cid,
+			           decomp->feedbacks_pending_nr);
+			return true;
+		}
+
+		/* no room left to accumulate the feedback, send it right now */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "too many feedbacks pending, do not accumulate the feedback "
+		           "for CID %u", infos->cid);
+	}
+
+	/* build the feedback in place in the ring for the same-side compressor */
+	if(decomp->feedback_ring != NULL)
+	{
+		struct rohc_feedback_ring_slot *const slot =
+			rohc_feedback_ring_reserve(decomp->feedback_ring);
+
+		if(slot != NULL)
+		{
+			struct rohc_buf slot_buf =
+				rohc_buf_init_empty(slot->data, ROHC_FEEDBACK_RING_ITEM_MAX_LEN);
+
+			if(!f_wrap_feedback(sfeedback, infos->cid, infos->cid_type,
+			                    crc_present, &decomp->crc_engine, &slot_buf))
 			{
-				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
-				                 "compressed headers", rohc_packet);
+				return false;
+			}
+			if(slot_buf.len > 0)
+			{
+				slot->len = slot_buf.len;
+				slot->is_rcvd = false;
+				rohc_feedback_ring_commit(decomp->feedback_ring);
+				return true;
 			}
-			status = decode_ret;
-			goto error;
 		}
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "feedback ring is full, store the feedback for CID %u into "
+		           "the buffer given by the user", infos->cid);
 	}
-	while(try_decoding_again);
 
-	/* after CRC failure, if the SN value seems to be correctly guessed, we must
-	 * wait for 3 CRC-valid packets before the correction is approved. Two
-	 * packets are therefore thrown away. */
-	if(context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE)
+	if(feedback == NULL)
 	{
-		if(context->crc_corr.counter > 1)
+		return true;
+	}
+	return f_wrap_feedback(sfeedback, infos->cid, infos->cid_type, crc_present,
+	                       &decomp->crc_engine, feedback);
+}
+
+
+/**
+ * @brief Update statistics upon successful decompression
+ *
+ * @param context         The decompression context
+ * @param comp_hdr_len    The length (in bytes) of the compressed header
+ * @param uncomp_hdr_len  The length (in bytes) of the uncompressed header
+ */
+static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context,
+                                          const size_t comp_hdr_len,
+                                          const size_t uncomp_hdr_len)
+{
+	context->header_last_compressed_size = comp_hdr_len;
+	context->header_compressed_size += comp_hdr_len;
+	context->header_last_uncompressed_size = uncomp_hdr_len;
+	context->header_uncompressed_size += uncomp_hdr_len;
+}
+
+
+/**
+ * @brief Whether the given ROHC packet is an RRU referenced from segments
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet being decoded
+ * @return             true if the packet is an RRU referenced from segments,
+ *                     false if it is contiguous in memory
+ */
+static bool rohc_decomp_rru_is_ref(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packet)
+{
+	return (decomp->rru_segs_nr > 0 && rohc_packet.data == decomp->rru);
+}
+
+
+/**
+ * @brief Copy some bytes of the RRU, from the segments if referenced
+ *
+ * @param decomp     The ROHC decompressor
+ * @param offset     The offset of the first byte to copy in the RRU
+ * @param len        The number of bytes to copy
+ * @param[out] data  The buffer to copy the bytes in
+ */
+static void rohc_decomp_rru_read(const struct rohc_decomp *const decomp,
+                                 const size_t offset,
+                                 const size_t len,
+                                 uint8_t *const data)
+{
+	size_t seg_offset = 0;
+	size_t copied_len = 0;
+	size_t i;
+
+	if(decomp->rru_segs_nr == 0)
+	{
+		memcpy(data, decomp->rru + offset, len);
+		return;
+	}
+
+	for(i = 0; copied_len < len && i < decomp->rru_segs_nr; i++)
+	{
+		const struct rohc_decomp_rru_seg *const seg = &(decomp->rru_segs[i]);
+
+		if((offset + copied_len) < (seg_offset + seg->len))
 		{
-			/* update context with decoded values even if we drop the packet */
-			rohc_decomp_update_context(context, decoded_values, payload_len,
-			                           rohc_packet.time, do_change_mode);
+			const size_t pos = offset + copied_len - seg_offset;
+			const size_t chunk_len = rohc_min(seg->len - pos, len - copied_len);
 
-			context->crc_corr.counter--;
-			rohc_decomp_warn(context, "CID %u: CRC repair: throw away packet, "
-			                 "still %zu CRC-valid packets required",
-			                 context->cid, context->crc_corr.counter);
+			memcpy(data + copied_len, seg->data + pos, chunk_len);
+			copied_len += chunk_len;
+		}
+		seg_offset += seg->len;
+	}
+	assert(copied_len == len);
+}
 
-			status = ROHC_STATUS_BAD_CRC;
-			goto error;
+
+/**
+ * @brief Copy the RRU referenced from segments in the RRU buffer
+ *
+ * @param decomp   The ROHC decompressor
+ * @param rru_len  The length of the RRU
+ */
+static void rohc_decomp_rru_flatten(struct rohc_decomp *const decomp,
+                                    const size_t rru_len)
+{
+	if(decomp->rru_segs_nr > 0)
+	{
+		rohc_decomp_rru_read(decomp, 0, rru_len, decomp->rru);
+		decomp->rru_segs_nr = 0;
+	}
+}
+
+
+/**
+ * @brief Extend the FCS-32 of the RRU over the bytes received so far
+ *
+ * The 4 last bytes received are not covered since they may be the CRC field
+ * of the RRU.
+ *
+ * @param decomp  The ROHC decompressor
+ */
+static void rohc_decomp_rru_update_crc(struct rohc_decomp *const decomp)
+{
+	const size_t crc_len = (decomp->rru_len > 4 ? decomp->rru_len - 4 : 0);
+	size_t seg_offset = 0;
+	size_t i;
+
+	if(decomp->rru_segs_nr == 0)
+	{
+		if(crc_len > decomp->rru_crc_len)
+		{
+			decomp->rru_crc = crc_engine_fcs32(&decomp->crc_engine,
+			                                   decomp->rru + decomp->rru_crc_len,
+			                                   crc_len - decomp->rru_crc_len,
+			                                   decomp->rru_crc);
+			decomp->rru_crc_len = crc_len;
 		}
-		else if(context->crc_corr.counter == 1)
+		return;
+	}
+
+	for(i = 0; decomp->rru_crc_len < crc_len && i < decomp->rru_segs_nr; i++)
+	{
+		const struct rohc_decomp_rru_seg *const seg = &(decomp->rru_segs[i]);
+
+		if(decomp->rru_crc_len < (seg_offset + seg->len))
 		{
-			rohc_decomp_warn(context, "CID %u: CRC repair: correction is "
-			                 "successful, keep packet", context->cid);
-			context->corrected_crc_failures++;
-			decomp->stats.corrected_crc_failures++;
-			switch(context->crc_corr.algo)
-			{
-				case ROHC_DECOMP_CRC_CORR_SN_WRAP:
-					context->corrected_sn_wraparounds++;
-					decomp->stats.corrected_sn_wraparounds++;
-					break;
-				case ROHC_DECOMP_CRC_CORR_SN_UPDATES:
-					context->corrected_wrong_sn_updates++;
-					decomp->stats.corrected_wrong_sn_updates++;
-					break;
-				case ROHC_DECOMP_CRC_CORR_SN_NONE:
-				default:
-					rohc_error(decomp, ROHC_TRACE_DECOMP, context->profile->id,
-					           "CID %u: CRC repair: unsupported repair algorithm %d",
-					           context->cid, context->crc_corr.algo);
-					assert(0);
-					status = ROHC_STATUS_ERROR;
-					goto error;
-			}
-			context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
-			context->crc_corr.counter--;
+			const size_t pos = decomp->rru_crc_len - seg_offset;
+			const size_t chunk_len =
+				rohc_min(seg->len - pos, crc_len - decomp->rru_crc_len);
+
+			decomp->rru_crc = crc_engine_fcs32(&decomp->crc_engine, seg->data + pos,
+			                                   chunk_len, decomp->rru_crc);
+			decomp->rru_crc_len += chunk_len;
 		}
+		seg_offset += seg->len;
 	}
-	uncomp_hdr_len = uncomp_packet->len;
-	rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+}
 
 
-	/* E. Copy the payload (if any) */
+/**
+ * @brief Reset all the statistics of the given ROHC decompressor
+ *
+ * @param decomp The ROHC decompressor
+ */
+static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
+{
+	size_t i;
 
-	if((rohc_hdr_len + payload_len) != rohc_packet.len)
+	decomp->stats.received = 0;
+	decomp->stats.failed_crc = 0;
+	decomp->stats.failed_no_context = 0;
+	decomp->stats.failed_decomp = 0;
+	decomp->stats.total_uncompressed_size = 0;
+	decomp->stats.total_compressed_size = 0;
+	decomp->stats.corrected_crc_failures = 0;
+	decomp->stats.corrected_sn_wraparounds = 0;
+	decomp->stats.corrected_wrong_sn_updates = 0;
+	for(i = 0; i < ROHC_DECOMP_PERF_PHASES_NR; i++)
 	{
-		rohc_decomp_warn(context, "ROHC %s header (%zu bytes) and payload "
-		                 "(%zu bytes) do not match the full ROHC packet "
-		                 "(%zu bytes)", rohc_get_packet_descr(*packet_type),
-		                 rohc_hdr_len, payload_len, rohc_packet.len);
-		status = ROHC_STATUS_ERROR;
-		goto error;
+		rohc_perf_histo_reset(&decomp->perf_histos[i]);
 	}
-	if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+	memset(decomp->pkt_stats, 0, sizeof(decomp->pkt_stats));
+}
+
+
+/**
+ * @brief Record the duration of the phase of decompression that just ended
+ *
+ * The duration is recorded in the histogram of the phase, and kept for the
+ * statistics of the profile and packet type of the packet.
+ *
+ * @param decomp      The ROHC decompressor
+ * @param perf_clock  The clock that measures the phases of the packet
+ * @param phase       The phase that just ended
+ */
+static void rohc_decomp_perf_lap(struct rohc_decomp *const decomp,
+                                 struct rohc_perf_clock *const perf_clock,
+                                 const rohc_decomp_perf_phase_t phase)
+{
+	decomp->pkt_phases_ns[phase] +=
+		rohc_perf_lap(perf_clock, &decomp->perf_histos[phase]);
+}
+
+
+/**
+ * @brief Record the duration of the whole decompression of the packet
+ *
+ * @param decomp      The ROHC decompressor
+ * @param perf_clock  The clock that measures the phases of the packet
+ */
+static void rohc_decomp_perf_stop(struct rohc_decomp *const decomp,
+                                  const struct rohc_perf_clock *const perf_clock)
+{
+	decomp->pkt_phases_ns[ROHC_DECOMP_PERF_TOTAL] +=
+		rohc_perf_stop(perf_clock, &decomp->perf_histos[ROHC_DECOMP_PERF_TOTAL]);
+}
+
+
+/**
+ * @brief Account one received packet in the statistics of its profile and
+ *        packet type
+ *
+ * Shall be called within the update of the statistics, see
+ * \ref rohc_stats_write_begin.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param profile_id   The profile of the packet, ROHC_PROFILE_GENERAL if not
+ *                     identified
+ * @param packet_type  The type of the packet, ROHC_PACKET_UNKNOWN if not
+ *                     identified
+ * @param status       The status of the decompression of the packet
+ * @param context      The context that decompressed the packet, if
+ *                     successful
+ */
+static void rohc_decomp_pkt_stats_add(struct rohc_decomp *const decomp,
+                                      const rohc_profile_t profile_id,
+                                      const rohc_packet_t packet_type,
+                                      const rohc_status_t status,
+                                      const struct rohc_decomp_ctxt *const context)
+{
+	const size_t major = (profile_id >> 8) & 0xff;
+	const size_t minor = profile_id & 0xff;
+	struct rohc_decomp_pkt_stats *pkt_stats;
+
+	if(profile_id == ROHC_PROFILE_GENERAL ||
+	   major > ROHC_PROFILE_ID_MAJOR_MAX || minor > ROHC_PROFILE_ID_MINOR_MAX ||
+	   packet_type == ROHC_PACKET_UNKNOWN || packet_type >= ROHC_PACKET_MAX)
 	{
-		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
-		                 "max) for the %zu-byte payload",
-		                 rohc_buf_avail_len(*uncomp_packet), payload_len);
-		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
-		goto error;
+		return;
 	}
-	if(payload_len != 0)
+	pkt_stats = &decomp->pkt_stats[major][minor][packet_type];
+
+	pkt_stats->packets_nr++;
+	if(status == ROHC_STATUS_OK)
 	{
-		rohc_buf_append(uncomp_packet, payload_data, payload_len);
-		rohc_buf_pull(uncomp_packet, payload_len);
+		assert(context != NULL);
+		pkt_stats->hdr_bytes_nr += context->volat_ctxt.comp_hdr_len;
+		pkt_stats->uncomp_hdr_bytes_nr += context->volat_ctxt.uncomp_hdr_len;
 	}
-	/* unhide the uncompressed headers and payload */
-	rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
-	rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
-	                  uncomp_packet->len);
-
-
-	/* F. Update the compression context
-	 *
-	 * Once CRC check is done, update the compression context with the values
-	 * that were decoded earlier.
-	 *
-	 * TODO: check what fields shall be updated in the context
-	 */
-
-	/* we are either already in full context state or we can transit
-	 * through it */
-	if(context->state != ROHC_DECOMP_STATE_FC)
+	else if(status == ROHC_STATUS_BAD_CRC)
 	{
-		rohc_decomp_debug(context, "change from state %d to state %d",
-		                  context->state, ROHC_DECOMP_STATE_FC);
-		context->state = ROHC_DECOMP_STATE_FC;
+		pkt_stats->crc_failures_nr++;
 	}
+	pkt_stats->crc_repairs_nr += decomp->pkt_crc_repairs_nr;
 
-	/* update context with decoded values */
-	rohc_decomp_update_context(context, decoded_values, payload_len,
-	                           rohc_packet.time, do_change_mode);
-
-	/* update statistics */
-	rohc_decomp_stats_add_success(context, rohc_hdr_len, uncomp_hdr_len);
-
-	/* decompression is successful */
-	status = ROHC_STATUS_OK;
+	if((decomp->features & ROHC_DECOMP_FEATURE_PERF_INFO) != 0)
+	{
+		size_t i;
 
-error:
-	return status;
+		for(i = 0; i < ROHC_DECOMP_PERF_PHASES_NR; i++)
+		{
+			pkt_stats->phases_ns[i] += decomp->pkt_phases_ns[i];
+		}
+	}
 }
 
 
 /**
- * @brief Try to decode one ROHC packet
+ * @brief Attribute the processing time of the packet to its context
  *
- * Steps:
- *  \li A. Decode extracted bits
- *  \li B. Build uncompressed headers (and check for correct decompression
- *         for UO* packets)
+ * The durations of all the phases of decompression are attributed, every
+ * attempt of CRC repair included. Nothing is attributed if the
+ * \ref ROHC_DECOMP_FEATURE_PERF_INFO feature is disabled.
  *
- * @param decomp               The ROHC decompressor
- * @param context              The decompression context
- * @param packet_type          The type of the ROHC packet to parse
- * @param extr_crc_bits        The CRC bits extracted from the ROHC header
- * @param extr_bits            The bits extracted from the ROHC header
- * @param payload_len          The length of the packet payload (in bytes)
- * @param[out] decoded_values  The values decoded from extracted bits
- * @param[out] uncomp_packet   The uncompressed packet
- * @return                     ROHC_STATUS_OK if packet is successfully decoded,
- *                             ROHC_STATUS_MALFORMED if packet is malformed,
- *                             ROHC_STATUS_BAD_CRC if a CRC error occurs,
- *                             ROHC_STATUS_ERROR if an error occurs
+ * Shall be called within the update of the statistics, see
+ * \ref rohc_stats_write_begin.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The context that decompressed the packet
  */
-static rohc_status_t rohc_decomp_try_decode_pkt(const struct rohc_decomp *const decomp,
-                                                const struct rohc_decomp_ctxt *const context,
-                                                const rohc_packet_t packet_type,
-                                                const struct rohc_decomp_crc *const extr_crc_bits,
-                                                const void *const extr_bits,
-                                                const size_t payload_len,
-                                                void *const decoded_values,
-                                                struct rohc_buf *const uncomp_packet)
+static void rohc_decomp_ctxt_cost_add(const struct rohc_decomp *const decomp,
+                                      struct rohc_decomp_ctxt *const context)
 {
-	const struct rohc_decomp_profile *const profile = context->profile;
-	size_t uncomp_hdr_len; /* length of the uncompressed headers */
-	rohc_status_t status;
-
-	assert(packet_type != ROHC_PACKET_UNKNOWN);
-
-	/* A. Decode extracted bits
-	 *
-	 * All bits are now extracted from the packet, let's decode them.
-	 */
-
-	status = profile->decode_bits(context, extr_bits, payload_len, decoded_values);
-	if(status != ROHC_STATUS_OK)
+	if((decomp->features & ROHC_DECOMP_FEATURE_PERF_INFO) != 0)
 	{
-		rohc_decomp_warn(context, "failed to decode values from bits extracted "
-		                 "from ROHC header");
-		goto error;
+		size_t i;
+
+		/* the total phase covers the other phases of successful packets only */
+		for(i = 0; i < ROHC_DECOMP_PERF_TOTAL; i++)
+		{
+			context->processing_ns += decomp->pkt_phases_ns[i];
+		}
 	}
+}
 
-	/* B. Build uncompressed headers & check for correct decompression
-	 *
-	 * All fields are now decoded, let's build the uncompressed headers.
-	 *
-	 * Use the CRC on decompressed headers to check whether decompression was
-	 * correct.
-	 */
 
-	/* build the uncompressed headers */
-	status = profile->build_hdrs(decomp, context, packet_type, extr_crc_bits,
-	                             decoded_values, payload_len,
-	                             uncomp_packet, &uncomp_hdr_len);
-	if(status != ROHC_STATUS_OK)
+/**
+ * @brief Give a description for the given ROHC decompression context state
+ *
+ * Give a description for the given ROHC decompression context state.
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of decompression context states
+ * used by the library. If unsure, ask on the mailing list.
+ *
+ * @param state  The decompression context state to get a description for
+ * @return       A string that describes the given decompression context state
+ *
+ * @ingroup rohc_decomp
+ */
+const char * rohc_decomp_get_state_descr(const rohc_decomp_state_t state)
+{
+	switch(state)
 	{
-		rohc_decomp_warn(context, "CID %u: failed to build uncompressed headers: %s",
-		                 context->cid, rohc_strerror(status));
-		goto error;
+		case ROHC_DECOMP_STATE_NC:
+			return "No Context";
+		case ROHC_DECOMP_STATE_SC:
+			return "Static Context";
+		case ROHC_DECOMP_STATE_FC:
+			return "Full Context";
+		case ROHC_DECOMP_STATE_UNKNOWN:
+		default:
+			return "no description";
 	}
-
-error:
-	return status;
 }
 
 
 /**
- * @brief Check whether the CRC on IR or IR-DYN header is correct or not
+ * @brief Get some information about the last decompressed packet
  *
- * The CRC for IR/IR-DYN headers is always CRC-8. It is computed on the
- * whole compressed header (payload excluded, but any CID bits included).
+ * Get some information about the last decompressed packet.
  *
- * @param context         The decompression context
- * @param rohc_hdr        The compressed IR or IR-DYN header
- * @param rohc_hdr_len    The length (in bytes) of the compressed header
- * @param add_cid_len     The length of the optional Add-CID field
- * @param large_cid_len   The length of the optional large CID field
- * @param crc_packet      The CRC extracted from the ROHC header
- * @return                true if the CRC is correct, false otherwise
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_last_packet_info_t structure with the \e version_major
+ * and \e version_minor fields set to one of the following supported
+ * versions:
+ *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *  - Major 0, minor 2
+ *
+ * See \ref rohc_decomp_last_packet_info_t for details about fields that
+ * are supported in the above versions.
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_last_packet_info_t
  */
-static bool rohc_decomp_check_ir_crc(const struct rohc_decomp_ctxt *const context,
-                                     const uint8_t *const rohc_hdr,
-                                     const size_t rohc_hdr_len,
-                                     const size_t add_cid_len,
-                                     const size_t large_cid_len,
-                                     const struct rohc_decomp_crc_one *const crc_packet)
+bool rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
+                                      rohc_decomp_last_packet_info_t *const info)
 {
-	const rohc_crc_type_t crc_type = ROHC_CRC_TYPE_8;
-	const uint8_t crc_zero[] = { 0x00 };
-	unsigned int crc_comp; /* computed CRC */
-
-	assert(rohc_hdr_len >= (add_cid_len + 2 + large_cid_len + 1));
-	assert(crc_packet->type == ROHC_CRC_TYPE_8);
-
-	/* ROHC header before CRC field:
-	 * optional Add-CID + IR type + Profile ID + optional large CID */
-	crc_comp = crc_calculate(crc_type, rohc_hdr, add_cid_len + 2 + large_cid_len,
-	                         CRC_INIT_8);
-
-	/* all profiles but the Uncompressed profile compute their CRC through the
-	 * zeroed CRC field and the rest of the ROHC header */
-	if(context->profile->id != ROHC_PROFILE_UNCOMPRESSED)
+	if(decomp == NULL)
 	{
-		/* zeroed CRC field */
-		crc_comp = crc_calculate(crc_type, crc_zero, 1, crc_comp);
-
-		/* ROHC header after CRC field */
-		crc_comp = crc_calculate(crc_type,
-		                         rohc_hdr + add_cid_len + 2 + large_cid_len + 1,
-		                         rohc_hdr_len - add_cid_len - 2 - large_cid_len - 1,
-		                         crc_comp);
+		goto error;
 	}
 
-	rohc_decomp_debug(context, "CRC-%d on compressed %zu-byte ROHC header = "
-	                  "0x%x", crc_type, rohc_hdr_len, crc_comp);
-
-	/* does the computed CRC match the one in packet? */
-	if(crc_comp != crc_packet->bits)
+	if(decomp->last_context == NULL)
 	{
-		rohc_decomp_warn(context, "CRC failure (computed = 0x%02x, packet = "
-		                 "0x%02x)", crc_comp, crc_packet->bits);
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "last context found in decompressor is not valid");
 		goto error;
 	}
 
-	/* computed CRC matches the one in packet */
-	return true;
+	if(info == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for last packet information is not valid");
+		goto error;
+	}
 
-error:
-	return false;
-}
+	/* check compatibility version */
+	if(info->version_major != 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for last "
+		           "packet information", info->version_major);
+		goto error;
+	}
 
+	/* base fields for major version 0 */
+	info->context_mode = decomp->last_context->mode;
+	info->context_state = decomp->last_context->state;
+	info->profile_id = decomp->last_context->profile->id;
+	info->nr_lost_packets = decomp->last_context->nr_lost_packets;
+	info->nr_misordered_packets = decomp->last_context->nr_misordered_packets;
+	info->is_duplicated = decomp->last_context->is_duplicated;
 
-/**
- * @brief Update context with decoded values
- *
- * @param context              The decompression context
- * @param decoded              The decoded values to update in the context
- * @param payload_len          The length of the packet payload
- * @param pkt_arrival_time     The arrival time of the decoded ROHC packet
- * @param[out] do_change_mode  Whether the context wants to change its
- *                             operational mode or not
- */
-static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
-                                       const void *const decoded,
-                                       const size_t payload_len,
-                                       const struct rohc_ts pkt_arrival_time,
-                                       bool *const do_change_mode)
-{
-	struct rohc_decomp_crc_corr_ctxt *const crc_corr = &context->crc_corr;
+	if(info->version_minor != 0 &&
+	   info->version_minor != 1 &&
+	   info->version_minor != 2)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported minor version (%u) of the structure for "
+		           "last packet information", info->version_minor);
+		goto error;
+	}
 
-	/* call the profile-specific callback */
-	context->profile->update_ctxt(context, decoded, payload_len, do_change_mode);
+	/* new fields in 0.1 */
+	if(info->version_minor >= 1)
+	{
+		info->corrected_crc_failures =
+			decomp->last_context->corrected_crc_failures;
+		info->corrected_sn_wraparounds =
+			decomp->last_context->corrected_sn_wraparounds;
+		info->corrected_wrong_sn_updates =
+			decomp->last_context->corrected_wrong_sn_updates;
+		info->packet_type = decomp->last_context->last_packet_type;
+	}
 
-	/* update arrival time */
-	crc_corr->arrival_times[crc_corr->arrival_times_index] = pkt_arrival_time;
-	crc_corr->arrival_times_index =
-		(crc_corr->arrival_times_index + 1) % ROHC_MAX_ARRIVAL_TIMES;
-	crc_corr->arrival_times_nr =
-		rohc_min(crc_corr->arrival_times_nr + 1, ROHC_MAX_ARRIVAL_TIMES);
+	/* new fields in 0.2 */
+	if(info->version_minor >= 2)
+	{
+		info->total_last_comp_size =
+			decomp->last_context->total_last_compressed_size;
+		info->header_last_comp_size =
+			decomp->last_context->header_last_compressed_size;
+		info->total_last_uncomp_size =
+			decomp->last_context->total_last_uncompressed_size;
+		info->header_last_uncomp_size =
+			decomp->last_context->header_last_uncompressed_size;
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Build a positive ACK feedback
+ * @brief Get some information about the given decompression context
  *
- * @param decomp         The ROHC decompressor
- * @param infos          The information collected on the successfully
- *                       decompressed packet
- * @param[out] feedback  The feedback to be transmitted to the remote
- *                       compressor through the feedback channel
- * @return               true if the ACK feedback was successfully built
- *                       (may be 0 byte), false if a problem occurred
+ * Get some information about the given decompression context.
+ *
+ * The counters may be read from another thread than the one that
+ * decompresses packets: they are copied as one consistent snapshot and the
+ * decompressor is never blocked by the reader.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_context_info_t structure with the \e version_major
+ * and \e version_minor fields set to one of the following supported
+ * versions:
+ *  - Major 0, minor 0
+ *
+ * See \ref rohc_decomp_context_info_t for details about fields that
+ * are supported in the above versions.
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param cid           The Context ID to get information for
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_context_info_t
  */
-static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
-                                     const struct rohc_decomp_stream *const infos,
-                                     struct rohc_buf *const feedback)
+bool rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
+                                  const rohc_cid_t cid,
+                                  rohc_decomp_context_info_t *const info)
 {
-#ifndef ROHC_NO_TRACES
-	const char mode_short[ROHC_R_MODE + 1] = { '?', 'U', 'O', 'R' };
-#endif
-	bool do_build_ack = false;
-	size_t k;
-
-	assert(infos->cid_found);
-	assert(infos->context_found);
-
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-	           "CID %u: %s: %s state: %s packet successfully decompressed",
-	           infos->cid, rohc_get_mode_descr(infos->mode),
-	           rohc_decomp_get_state_descr(infos->state),
-	           rohc_get_packet_descr(infos->packet_type));
-
-	/* update all the stats about the feedbacks */
-	decomp->last_pkts_errors <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
-	infos->context->last_pkts_errors <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
+	if(decomp == NULL)
+	{
+		goto error;
+	}
 
-	/* force sending an ACK if compressor/decompressor modes mismatch or
-	 * if decompressor just changed its operational mode */
-	if(infos->do_change_mode)
+	if(cid > decomp->medium.max_cid)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "force positive ACK because mode changed or compressor "
-		           "reported a different mode");
-		do_build_ack = true;
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "decompressor does not handle CID %u since MAX_CID is %u",
+		           cid, decomp->medium.max_cid);
+		goto error;
 	}
-	/* check if the decompressor shall build a positive feedback */
-	else if(infos->mode == ROHC_U_MODE)
+
+	if(info == NULL)
 	{
-		/* send ACK(U) with rate-limiting as stated in RFC 3095, §5.3.1.3:
-		 *   To improve performance for the Unidirectional mode over a link that
-		 *   does have a feedback channel, the decompressor MAY send an
-		 *   acknowledgment when decompression succeeds.  Setting the mode
-		 *   parameter in the ACK packet to U indicates that the compressor is to
-		 *   stay in Unidirectional mode. [...] If IR packets continue to arrive,
-		 *   the decompressor MAY repeat the ACK(U), but it SHOULD NOT repeat the
-		 *   ACK(U) continuously.*/
-		do_build_ack = true;
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for context information is not valid");
+		goto error;
 	}
-	else if(infos->mode == ROHC_O_MODE)
+
+	/* check compatibility version */
+	if(info->version_major == 0)
 	{
-		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
+		uint32_t seq;
 
-		/* all states: when an IR packet is correctly decompressed, send an ACK(O) */
-		if(infos->packet_type == ROHC_PACKET_IR)
+		/* new fields added by minor versions */
+		if(info->version_minor > 0)
 		{
-			do_build_ack = true;
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "context information", info->version_minor);
+			goto error;
 		}
-		/* SC state:
-		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
-		 *    optionally send an ACK(O)
-		 * FC state:
-		 *  - when a type 2 or an IR-DYN packet is correctly decompressed,
-		 *    optionally send an ACK(O)
-		 *  - when a type 0 or 1 packet is correctly decompressed, no
-		 *    feedback is sent */
-		else if(infos->state != ROHC_DECOMP_STATE_NC &&
-		        rohc_packet_carry_crc_7_or_8(infos->packet_type))
+
+		do
 		{
-			do_build_ack = true;
+			const struct rohc_decomp_ctxt *ctxt;
+
+			seq = rohc_stats_read_begin(&decomp->stats_seq);
+			ctxt = decomp->contexts[cid];
+
+			/* base fields for major version 0 */
+			if(ctxt == NULL)
+			{
+				info->packets_nr = 0;
+				info->comp_bytes_nr = 0;
+				info->uncomp_bytes_nr = 0;
+				info->corrected_crc_failures = 0;
+				info->corrected_sn_wraparounds = 0;
+				info->corrected_wrong_sn_updates = 0;
+			}
+			else
+			{
+				info->packets_nr = ctxt->num_recv_packets;
+				info->comp_bytes_nr = ctxt->total_compressed_size;
+				info->uncomp_bytes_nr = ctxt->total_uncompressed_size;
+				info->corrected_crc_failures = ctxt->corrected_crc_failures;
+				info->corrected_sn_wraparounds = ctxt->corrected_sn_wraparounds;
+				info->corrected_wrong_sn_updates = ctxt->corrected_wrong_sn_updates;
+			}
 		}
+		while(rohc_stats_read_retry(&decomp->stats_seq, seq));
 	}
-	else /* R-mode */
+	else
 	{
-		assert(0); /* TODO: R-mode not implemented yet */
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for context"
+		           "information", info->version_major);
 		goto error;
 	}
 
-	/* stop now if no ACK is required */
-	if(!do_build_ack)
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the durations of the phases of decompression
+ *
+ * Get the histograms of the durations of the phases of decompression. The
+ * durations are measured only once the \ref ROHC_DECOMP_FEATURE_PERF_INFO
+ * feature is enabled with \ref rohc_decomp_set_features, the histograms are
+ * empty otherwise.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_perf_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_perf_info_t
+ * @see rohc_perf_histo_bucket_min
+ */
+bool rohc_decomp_get_perf_info(const struct rohc_decomp *const decomp,
+                               rohc_decomp_perf_info_t *const info)
+{
+	if(decomp == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "no need to send a positive ACK");
-		goto skip;
+		goto error;
 	}
 
-	/* rate-limit the ACKs */
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
-	k = __builtin_popcount(infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent) * 100;
-	if(k >= decomp->ack_rate_limits.speed.threshold)
+	if(info == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not send a positive ACK because of rate-limiting (%zu of 3200 "
-		           "with threshold %zu)", k, decomp->ack_rate_limits.speed.threshold);
-		goto skip;
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for performance information is not valid");
+		goto error;
 	}
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-	           "should send a positive ACK now (CID = %u, current mode = %d, "
-	           "target mode = %d, at least %zu bits of SN 0x%x, rate-limiting = "
-	           "%zu of 3200 with threshold %zu)", infos->cid, infos->mode,
-	           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
-	           k, decomp->ack_rate_limits.speed.threshold);
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
-	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
 
-	/* prepare feedback packet if asked by user */
-	if(feedback == NULL)
+	/* check compatibility version */
+	if(info->version_major == 0)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "user choose not to use a feedback channel, do not build any "
-		           "feedback packet");
+		if(info->version_minor > 0)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "performance information", info->version_minor);
+			goto error;
+		}
+		memcpy(info->phases, decomp->perf_histos, sizeof(decomp->perf_histos));
 	}
 	else
 	{
-		rohc_feedback_crc_t crc_present;
-		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
-		size_t feedbacksize;
-		size_t feedback_hdr_len;
-
-		/* FEEDBACK-1 or FEEDBACK-2 ? */
-		if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED ||
-		   (!infos->do_change_mode && infos->sn_bits_nr != 0 && infos->sn_bits_nr <= 8))
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "use FEEDBACK-1 as positive feedback");
-			f_feedback1(infos->sn_bits, &sfeedback);
-			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
-		}
-		else
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "use FEEDBACK-2 as positive ACK(%c) feedback",
-			           mode_short[infos->mode]);
-			if(!f_feedback2(infos->profile_id, ROHC_FEEDBACK_ACK, infos->mode,
-			                infos->sn_bits, infos->sn_bits_nr, &sfeedback))
-			{
-				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-				             "failed to build the ACK feedback");
-				goto error;
-			}
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "performance information", info->version_major);
+		goto error;
+	}
 
-			/* use CRC option if mode change requested */
-			if(infos->profile_id == ROHC_PROFILE_TCP ||
-			   rohc_profile_is_rohcv2(infos->profile_id))
-			{
-				/* CRC is present in base header for TCP and ROHCv2 profiles */
-				crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
-			}
-			else if(infos->do_change_mode)
-			{
-				crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
-			}
-			else
-			{
-				crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
-			}
-		}
+	return true;
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, &feedbacksize);
-		if(feedbackp == NULL)
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the ACK feedback");
-			goto error;
-		}
+error:
+	return false;
+}
 
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
-		{
-			if(feedbacksize < 8)
-			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
-			}
-			else
-			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
-			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
-		}
 
-		if(feedback->len > 0)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "decompressor built a %zu-byte positive feedback "
-			           "(header = %zu bytes, data = %zu bytes)", feedback->len,
-			           feedback_hdr_len, feedbacksize);
-		}
+/**
+ * @brief Export the records of the decompression contexts in use
+ *
+ * Fill the given array with one record for every context in use, from the
+ * most recently created context to the oldest one. Only the contexts in use
+ * are visited, so the export does not depend on MAX_CID. The number of
+ * contexts in use is given by \ref rohc_decomp_get_general_info.
+ *
+ * @param decomp       The ROHC decompressor to get contexts from
+ * @param records      The array of records to fill
+ * @param records_max  The maximum number of records to fill
+ * @return             The number of records filled, 0 in case of error
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_ctxt_record
+ */
+size_t rohc_decomp_get_contexts_info(const struct rohc_decomp *const decomp,
+                                     struct rohc_decomp_ctxt_record *const records,
+                                     const size_t records_max)
+{
+	const struct rohc_decomp_ctxt *ctxt;
+	size_t records_nr = 0;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(records == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "array of context records is not valid");
+		goto error;
+	}
+
+	for(ctxt = decomp->ctxts_used_first;
+	    ctxt != NULL && records_nr < records_max;
+	    ctxt = ctxt->used_next)
+	{
+		struct rohc_decomp_ctxt_record *const record = &records[records_nr];
 
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
+		record->cid = ctxt->cid;
+		record->profile_id = ctxt->profile->id;
+		record->state = ctxt->state;
+		record->mode = ctxt->mode;
+		record->packets_nr = ctxt->num_recv_packets;
+		record->hdr_bytes_nr = ctxt->header_compressed_size;
+		record->uncomp_hdr_bytes_nr = ctxt->header_uncompressed_size;
+		record->last_used_sec = ctxt->latest_used;
+		record->lost_packets_nr = ctxt->nr_lost_packets;
+		record->misordered_packets_nr = ctxt->nr_misordered_packets;
+		record->processing_ns = ctxt->processing_ns;
+		records_nr++;
 	}
 
-skip:
-	return true;
+	return records_nr;
 
 error:
-	return false;
+	return 0;
 }
 
 
 /**
- * @brief Build a negative ACK feedback
+ * @brief Save the decompression contexts in use in a binary image
  *
- * There are two types of negative feedback: NACK and STATIC-NACK.
+ * One record is saved for every context in use: its generic part and its
+ * persistent profile-specific part. The image may be written to a file, then
+ * given to \ref rohc_decomp_restore_contexts after one restart, so that the
+ * flows go on being decompressed without waiting for IR packets again.
  *
- * @param decomp         The ROHC decompressor
- * @param infos          The information collected on the failed
- *                       decompressed packet
- * @param[out] feedback  The feedback to be transmitted to the remote
- *                       compressor through the feedback channel (may be NULL)
- * @return               true if the ACK feedback was successfully built
- *                       (may be 0 byte), false if a problem occurred
+ * Only the contexts of the Uncompressed, TCP and ROHCv2 profiles are saved,
+ * the contexts of the other profiles are skipped.
+ *
+ * The image is only valid for the same build of the library on the same
+ * architecture. It is not aligned, so it may be read from any address.
+ *
+ * @param decomp          The ROHC decompressor to save the contexts of
+ * @param image           The buffer to save the image in, may be NULL
+ * @param image_max_len   The length of the buffer
+ * @param[out] image_len  The length of the image, even if it does not fit
+ *                        in the buffer
+ * @return                true if the image was saved,
+ *                        false if the buffer is too small or in case of error
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_restore_contexts
  */
-static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
-                                      const struct rohc_decomp_stream *const infos,
-                                      struct rohc_buf *const feedback)
+bool rohc_decomp_save_contexts(const struct rohc_decomp *const decomp,
+                               uint8_t *const image,
+                               const size_t image_max_len,
+                               size_t *const image_len)
 {
-	bool do_downward_transition = false;
-	bool do_build_ack = false;
-	enum rohc_feedback_ack_type ack_type;
-	size_t threshold_too_quickly;
-	size_t k_too_quickly;
-	size_t k_too_many;
+	const size_t rec_hdrs_len =
+		sizeof(struct rohc_ctxt_image_rec) + sizeof(struct rohc_decomp_ctxt_image);
+	const struct rohc_decomp_ctxt *ctxt;
+	size_t ctxts_nr = 0;
+	size_t len;
 
-	/* update all the stats about the feedbacks */
-	decomp->last_pkts_errors <<= 1;
-	decomp->last_pkts_errors |= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
-	if(infos->context != NULL)
+	if(decomp == NULL)
 	{
-		infos->context->last_pkts_errors <<= 1;
-		infos->context->last_pkts_errors |= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].needed <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed <<= 1;
-		infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent <<= 1;
+		goto error;
+	}
+	if(image_len == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "length of context image is not valid");
+		goto error;
 	}
 
-	/* the decompressor cannot warn the compressor if the CID is not identified
-	 * (this happens only if packet is malformed) */
-	if(!infos->cid_found)
+	len = sizeof(struct rohc_ctxt_image_hdr);
+	for(ctxt = decomp->ctxts_used_first; ctxt != NULL; ctxt = ctxt->used_next)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not perform downward state transition nor send negative "
-		           "feedback to compressor since CID was not identified");
-		goto skip;
+		const size_t rec_len = rec_hdrs_len + ctxt->profile->persist_ctxt_len;
+
+		if(!ctxt->profile->persist_ctxt_is_flat)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ctxt->profile->id,
+			           "context with CID %u cannot be saved in context image",
+			           ctxt->cid);
+			continue;
+		}
+
+		if(image != NULL && len <= image_max_len &&
+		   rec_len <= (image_max_len - len))
+		{
+			const struct rohc_ctxt_image_rec rec = {
+				.profile_id = ctxt->profile->id,
+				.cid = ctxt->cid,
+				.generic_len = sizeof(struct rohc_decomp_ctxt_image),
+				.profile_len = ctxt->profile->persist_ctxt_len,
+			};
+			const struct rohc_decomp_ctxt_image generic = {
+				.mode = ctxt->mode,
+				.state = ctxt->state,
+				.unused = { 0, 0 },
+				.last_pkts_errors = ctxt->last_pkts_errors,
+				.num_recv_packets = ctxt->num_recv_packets,
+			};
+			uint8_t *const rec_image = image + len;
+
+			memcpy(rec_image, &rec, sizeof(struct rohc_ctxt_image_rec));
+			memcpy(rec_image + sizeof(struct rohc_ctxt_image_rec), &generic,
+			       sizeof(struct rohc_decomp_ctxt_image));
+			if(ctxt->profile->persist_ctxt_len > 0)
+			{
+				memcpy(rec_image + rec_hdrs_len, ctxt->persist_ctxt,
+				       ctxt->profile->persist_ctxt_len);
+			}
+		}
+		len += rec_len;
+		ctxts_nr++;
 	}
+	*image_len = len;
 
-	if(infos->context_found)
+	if(image == NULL || len > image_max_len)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "CID %u: %s: %s state: %s packet %s", infos->cid,
-		           rohc_get_mode_descr(infos->mode),
-		           rohc_decomp_get_state_descr(infos->state),
-		           rohc_get_packet_descr(infos->packet_type),
-		           infos->crc_failed ? "failed the CRC check" : "received");
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "buffer too small for context image: %zu bytes required, "
+		           "only %zu bytes available", len, image_max_len);
+		goto error;
 	}
-	else
+	if(len > UINT32_MAX)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "CID %u: packet failed to be parsed", infos->cid);
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "context image too large: %zu bytes", len);
+		goto error;
 	}
 
-	/* check if the decompressor shall build a negative feedback */
-	if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED)
+	rohc_ctxt_image_set_hdr(image, ROHC_CTXT_IMAGE_DECOMP, ctxts_nr, len);
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts saved in a context image of %zu bytes",
+	          ctxts_nr, len);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Restore the decompression contexts saved in a binary image
+ *
+ * Every context saved by \ref rohc_decomp_save_contexts is restored with the
+ * same CID, it replaces the context that may already use the CID. The
+ * records of the contexts that cannot be restored are skipped:
+ *  \li the CID is greater than MAX_CID,
+ *  \li the profile is disabled,
+ *  \li the context is malformed,
+ *  \li memory is missing.
+ *
+ * The statistics of the restored contexts start again from zero, except the
+ * number of packets received that the profiles rely on. The image shall come from a trusted source: the generic parts of the contexts are
+ * checked, but the persistent profile-specific parts are only checked for
+ * their length.
+ *
+ * @param decomp         The ROHC decompressor to restore the contexts in
+ * @param image          The image saved by \ref rohc_decomp_save_contexts
+ * @param image_len      The length of the image
+ * @param now            The current time
+ * @param[out] ctxts_nr  The number of contexts restored
+ * @return               true if the image was read, even if some contexts
+ *                       were skipped, false if the image is malformed
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_save_contexts
+ */
+bool rohc_decomp_restore_contexts(struct rohc_decomp *const decomp,
+                                  const uint8_t *const image,
+                                  const size_t image_len,
+                                  const struct rohc_ts now,
+                                  size_t *const ctxts_nr)
+{
+	size_t recs_nr;
+	size_t offset;
+	size_t i;
+
+	if(decomp == NULL)
 	{
-		/* the Uncompressed profile does not use negative feedback nor FEEDBACK-2 */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not perform downward state transition nor send negative "
-		           "feedback for the Uncompressed profile");
-		goto skip;
+		goto error;
 	}
-	else if(!infos->context_found)
+	if(image == NULL || ctxts_nr == NULL)
 	{
-		/* RFC says nothing about negative feedbacks for malformed packets, but
-		 * it seems useful to tell the compressor to got back to lower states
-		 * if a packet failed to be parsed */
-		ack_type = ROHC_FEEDBACK_STATIC_NACK;
-		do_downward_transition = false; /* impossible w/o context */
-		do_build_ack = !!(decomp->target_mode > ROHC_U_MODE);
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "context image or number of contexts is not valid");
+		goto error;
 	}
-	else if(infos->mode == ROHC_U_MODE)
+	if(!rohc_ctxt_image_check(image, image_len, ROHC_CTXT_IMAGE_DECOMP, &recs_nr))
 	{
-		/* U-mode does not use negative feedback */
-		ack_type = ROHC_FEEDBACK_NACK;
-		do_downward_transition = true;
-		do_build_ack = false;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "malformed context image: unexpected header");
+		goto error;
 	}
-	else if(infos->mode == ROHC_O_MODE)
+
+	*ctxts_nr = 0;
+	offset = sizeof(struct rohc_ctxt_image_hdr);
+	for(i = 0; i < recs_nr; i++)
 	{
-		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
+		struct rohc_ctxt_image_rec rec;
 
-		/* NC state: when receiving a type 0, 1, 2 or IR-DYN packet, or an IR
-		 * packet has failed the CRC check, send a STATIC-NACK(O), subject to the
-		 * considerations at the beginning of section 5.7.6 */
-		if(infos->state == ROHC_DECOMP_STATE_NC)
+		if(!rohc_ctxt_image_get_rec(image, image_len, &offset, &rec))
 		{
-			ack_type = ROHC_FEEDBACK_STATIC_NACK;
-			do_downward_transition = true;
-			do_build_ack = true;
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "malformed context image: record #%zu is truncated", i + 1);
+			goto error;
 		}
-		/* SC state:
-		 *  - when a type 0 or 1 packet is received, treat it as a mismatching
-		 *    CRC and use the logic of section 5.3.2.2.3 to decide if a NACK(O)
-		 *    should be sent
-		 *  - when decompression of a type 2 packet, an IR-DYN packet or an
-		 *    IR packet has failed, use the logic of section 5.3.2.2.3 to
-		 *    decide if a STATIC-NACK(O) should be sent */
-		else if(infos->state == ROHC_DECOMP_STATE_SC)
+		if(rohc_decomp_restore_context(decomp, &rec, image + offset, now))
 		{
-			if(!rohc_packet_carry_crc_7_or_8(infos->packet_type))
-			{
-				ack_type = ROHC_FEEDBACK_NACK;
-				do_downward_transition = true;
-				do_build_ack = true;
-			}
-			else
-			{
-				ack_type = ROHC_FEEDBACK_STATIC_NACK;
-				do_downward_transition = true;
-				do_build_ack = true;
-			}
+			(*ctxts_nr)++;
 		}
-		/* FC state: when any packet fails the CRC check, use the logic of
-		 * 5.3.2.2.3 to decide if a NACK(O) should be sent */
-		else
+		offset += rec.generic_len + rec.profile_len;
+	}
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts restored from a context image of %zu records",
+	          *ctxts_nr, recs_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some information about the memory used by the decompressor
+ *
+ * Get the number of bytes allocated by the decompressor for its contexts,
+ * their lists, and its RRU buffer, together with the memory budget set by
+ * \ref rohc_decomp_set_mem_budget.
+ *
+ * The function shall be called from the thread that decompresses packets.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_mem_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_mem_info_t
+ */
+bool rohc_decomp_get_mem_info(const struct rohc_decomp *const decomp,
+                              rohc_decomp_mem_info_t *const info)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for memory information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		if(info->version_minor > 0)
 		{
-			ack_type = ROHC_FEEDBACK_NACK;
-			do_downward_transition = true;
-			do_build_ack = true;
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "memory information", info->version_minor);
+			goto error;
 		}
+		info->used_bytes_nr = decomp->mempool.objs_len;
+		info->slabs_bytes_nr = decomp->mempool.slabs_nr * ROHC_MEMPOOL_SLAB_LEN;
+		info->budget_bytes_nr = decomp->mempool.budget;
+		info->refused_nr = decomp->mempool.refused_nr;
 	}
-	else /* R-mode */
+	else
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "memory information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some general information about the decompressor
+ *
+ * Get some general information about the decompressor.
+ *
+ * The counters may be read from another thread than the one that
+ * decompresses packets: they are copied as one consistent snapshot and the
+ * decompressor is never blocked by the reader.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_general_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_decomp_general_info_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param decomp        The ROHC decompressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_general_info_t
+ */
+bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
+                                  rohc_decomp_general_info_t *const info)
+{
+	if(decomp == NULL)
 	{
-		assert(0); /* TODO: R-mode not implemented yet */
 		goto error;
 	}
 
-	/* stop now if no downward state transition nor NACK is required */
-	if(!do_build_ack && !do_downward_transition)
+	if(info == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "no need to perform a downward state transition nor send a "
-		           "negative ACK");
-		goto skip;
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for general information is not valid");
+		goto error;
 	}
-	assert(ack_type == ROHC_FEEDBACK_NACK || ack_type == ROHC_FEEDBACK_STATIC_NACK);
 
-	/* rate-limit the downward state transitions and NACKs */
-	if(infos->context != NULL)
+	/* check compatibility version */
+	if(info->version_major == 0)
 	{
-		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
-		infos->context->last_pkt_feedbacks[ack_type].needed |= 1;
-		k_too_quickly = __builtin_popcount(infos->context->last_pkts_errors) * 100;
-		k_too_many = __builtin_popcount(infos->context->last_pkt_feedbacks[ack_type].sent) * 100;
+		uint32_t seq;
+
+		if(info->version_minor > 1)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "general information", info->version_minor);
+			goto error;
+		}
+
+		do
+		{
+			seq = rohc_stats_read_begin(&decomp->stats_seq);
+
+			/* base fields for major version 0 */
+			info->contexts_nr = decomp->num_contexts_used;
+			info->packets_nr = decomp->stats.received;
+			info->comp_bytes_nr = decomp->stats.total_compressed_size;
+			info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
+
+			/* new fields in 0.1 */
+			if(info->version_minor >= 1)
+			{
+				info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
+				info->corrected_sn_wraparounds =
+					decomp->stats.corrected_sn_wraparounds;
+				info->corrected_wrong_sn_updates =
+					decomp->stats.corrected_wrong_sn_updates;
+			}
+		}
+		while(rohc_stats_read_retry(&decomp->stats_seq, seq));
 	}
 	else
 	{
-		decomp->last_pkt_feedbacks[ack_type].needed |= 1;
-		k_too_quickly = __builtin_popcount(decomp->last_pkts_errors) * 100;
-		k_too_many = __builtin_popcount(decomp->last_pkt_feedbacks[ack_type].sent) * 100;
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "general information", info->version_major);
+		goto error;
 	}
-	if(ack_type == ROHC_FEEDBACK_NACK)
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the statistics of the decompressor per profile and packet type
+ *
+ * Get a snapshot of the statistics of the received packets, broken down by
+ * profile and by packet type: the number of packets, the lengths of their
+ * ROHC and uncompressed headers, the CRC failures and the attempts of CRC
+ * repair, and the durations of the phases of decompression if the
+ * \ref ROHC_DECOMP_FEATURE_PERF_INFO feature is enabled.
+ *
+ * The counters may be read from another thread than the one that
+ * decompresses packets, see \ref rohc_decomp_get_general_info.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_stats_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * @param decomp         The ROHC decompressor to get statistics from
+ * @param[in,out] stats  The structure where statistics will be stored
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_stats_t
+ */
+bool rohc_decomp_get_stats(const struct rohc_decomp *const decomp,
+                           rohc_decomp_stats_t *const stats)
+{
+	uint32_t seq;
+
+	if(decomp == NULL)
 	{
-		threshold_too_quickly = decomp->ack_rate_limits.nack.threshold;
+		goto error;
 	}
-	else
+
+	if(stats == NULL)
 	{
-		threshold_too_quickly = decomp->ack_rate_limits.static_nack.threshold;
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for statistics is not valid");
+		goto error;
 	}
-	if(k_too_quickly < threshold_too_quickly)
-	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "avoid sending feedback too quickly (%zu of 3200 with threshold %zu)",
-		           k_too_quickly, threshold_too_quickly);
 
-		/* force sending a negative ACK if compressor/decompressor modes mismatch
-		 * or if decompressor just changed its operational mode */
-		if(do_build_ack && infos->do_change_mode)
+	/* check compatibility version */
+	if(stats->version_major == 0)
+	{
+		if(stats->version_minor > 0)
 		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "force negative ACK because mode changed or compressor "
-			           "reported a different mode");
-			do_build_ack = true;
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "statistics", stats->version_minor);
+			goto error;
 		}
-		else
+		do
 		{
-			do_build_ack = false;
+			seq = rohc_stats_read_begin(&decomp->stats_seq);
+			memcpy(stats->pkts, decomp->pkt_stats, sizeof(decomp->pkt_stats));
 		}
-		do_downward_transition = false;
+		while(rohc_stats_read_retry(&decomp->stats_seq, seq));
 	}
-	else if(k_too_quickly >= (threshold_too_quickly + 100) &&
-	        k_too_many >= decomp->ack_rate_limits.speed.threshold)
+	else
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "rate-limiting successive feedbacks (%zu of 3200 with threshold "
-		           "%zu)", k_too_many, decomp->ack_rate_limits.speed.threshold);
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "statistics", stats->version_major);
+		goto error;
+	}
 
-		/* force sending a negative ACK if compressor/decompressor modes mismatch
-		 * or if decompressor just changed its operational mode */
-		if(do_build_ack && infos->do_change_mode)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "force negative ACK because mode changed or compressor "
-			           "reported a different mode");
-			do_build_ack = true;
-		}
-		else
-		{
-			do_build_ack = false;
-		}
-		do_downward_transition = false;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CID type that the decompressor uses
+ *
+ * Get the CID type that the decompressor currently uses.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
+ *                       \ref ROHC_LARGE_CID
+ * @return               true if the CID type was successfully retrieved,
+ *                       false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_get_cid_type(const struct rohc_decomp *const decomp,
+                              rohc_cid_type_t *const cid_type)
+{
+	if(decomp == NULL || cid_type == NULL)
+	{
+		goto error;
 	}
 
-	/* update information if feedback is sent or downward transition taken */
-	if(do_build_ack || do_downward_transition)
+	*cid_type = decomp->medium.cid_type;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the maximal CID value the decompressor uses
+ *
+ * Get the maximal CID value the decompressor uses, ie. the \e MAX_CID
+ * parameter defined in RFC 3095.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param[out] max_cid  The current maximal CID value
+ * @return              true if MAX_CID was successfully retrieved,
+ *                      false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_get_max_cid(const struct rohc_decomp *const decomp,
+                             size_t *const max_cid)
+{
+	if(decomp == NULL || max_cid == NULL)
 	{
-		decomp->last_pkt_feedbacks[ack_type].sent |= 1;
-		if(infos->context != NULL)
-		{
-			infos->context->last_pkt_feedbacks[ack_type].sent |= 1;
-		}
+		goto error;
 	}
 
-	/* prepare feedback packet if needed and asked by user */
-	if(!do_build_ack)
+	*max_cid = decomp->medium.max_cid;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If set to 0, segmentation is disabled as no segment headers are allowed
+ * on the channel. Every received segment will be dropped.
+ *
+ * According to RF5225 §6.1, ROHC segmentation cannot be enabled if any
+ * ROHCv2 profile is also enabled.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
+ * upon decompression until the last segment is received (or a non-segment is
+ * received). Decompressed data will be returned at that time.
+ *
+ * @warning Changing the MRRU value while library is used may lead to
+ *          destruction of the current RRU.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param mrru    The new MRRU value (in bytes)
+ * @return        true if the MRRU was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC decompressor
+ * \code
+        size_t mrru = 500;
+        ...
+\endcode
+ * \snippet test_segment.c create ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_segment.c set decompressor MRRU
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_get_mrru
+ * @see rohc_decompress3
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_mrru
+ */
+bool rohc_decomp_set_mrru(struct rohc_decomp *const decomp,
+                          const size_t mrru)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not send a negative ACK");
+		/* cannot print a trace without a valid decompressor */
+		goto error;
 	}
-	else if(feedback == NULL)
+
+	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
+	if(mrru > ROHC_MAX_MRRU)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "user choose not to use a feedback channel, do not build any "
-		           "feedback packet");
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected MRRU value: must be in range [0, %d]",
+		             ROHC_MAX_MRRU);
+		goto error;
 	}
-	else
-	{
-		rohc_feedback_crc_t crc_present;
-		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
-		size_t feedbacksize;
-		size_t feedback_hdr_len;
-
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "should send a negative ACK (CID = %u, NACK type = %d, current "
-		           "mode = %d, target mode = %d, at least %zu bits of SN 0x%x, "
-		           "rate-limiting = %zu of 3200 with threshold %zu and %zu of 3200 "
-		           "with threshold %zu)", infos->cid, ack_type, infos->mode,
-		           decomp->target_mode, infos->sn_bits_nr, infos->sn_bits,
-		           k_too_quickly, threshold_too_quickly,
-		           k_too_many, decomp->ack_rate_limits.speed.threshold);
-
-		/* prepare FEEDBACK-2 */
-		if(!f_feedback2(infos->profile_id, ack_type, infos->mode, infos->sn_bits,
-		                infos->sn_bits_nr, &sfeedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to build the (STATIC-)NACK feedback");
-			goto error;
-		}
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "FEEDBACK-2 is %d-byte long", sfeedback.size);
 
-		/* use CRC option if mode change requested */
-		if(infos->profile_id == ROHC_PROFILE_TCP ||
-		   rohc_profile_is_rohcv2(infos->profile_id))
-		{
-			crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
-		}
-		else if(infos->do_change_mode)
-		{
-			crc_present = ROHC_FEEDBACK_WITH_CRC_OPT;
-		}
-		else
-		{
-			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
-		}
+	/* RFC5225, §6.1:
+	 * The compressor MUST NOT use ROHC segmentation (see Section 5.2.5 of
+	 * [RFC4995]), i.e., the Maximum Reconstructed Reception Unit (MRRU)
+	 * MUST be set to 0, if the configuration of the ROHC channel contains
+	 * at least one ROHCv2 profile in the list of supported profiles (i.e.,
+	 * the PROFILES parameter) and if the channel cannot guarantee in-order
+	 * delivery of packets between compression endpoints.
+	 */
+	if(mrru > 0)
+	{
+		uint8_t profile_major;
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, &feedbacksize);
-		if(feedbackp == NULL)
+		for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the (STATIC-)NACK feedback");
-			goto error;
-		}
+			uint8_t profile_minor;
 
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
-		{
-			if(feedbacksize < 8)
-			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
-			}
-			else
+			for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
 			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
-			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
-		}
+				const uint16_t profile_id = (profile_major << 8) | profile_minor;
 
-		if(feedback->len > 0)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "decompressor built a %zu-byte negative feedback (%zu bytes "
-			           "of header + %zu bytes of data)", feedback->len,
-			           feedback_hdr_len, feedbacksize);
+				if(rohc_decomp_profile_enabled_nocheck(decomp, profile_id) &&
+				   rohc_profile_is_rohcv2(profile_id))
+				{
+					rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+					             "failed to set MRRU to %zu bytes: segmentation is not "
+					             "compatible with ROHCv2 profile 0x%04x that is enabled",
+					             mrru, profile_id);
+					goto error;
+				}
+			}
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
 	}
 
-	/* upon decompression failure, perform downward transitions if context is
-	 * still available (new contexts are destroyed upon decompression error) */
-	if(!do_downward_transition || infos->context == NULL)
+	/* set new MRRU */
+	if(mrru == 0)
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "do not perform a downward state transition");
+		rohc_mempool_release(&decomp->mempool, decomp->rru, decomp->mrru);
+		decomp->rru = NULL;
 	}
 	else
 	{
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-		           "perform a downward state transition now (CID = %u, NACK "
-		           "type = %d, current mode = %d, target mode = %d, rate-limiting "
-		           "= %zu of 3200 with threshold %zu and %zu of 3200 with "
-		           "threshold %zu)", infos->cid, ack_type, infos->mode,
-		           decomp->target_mode, k_too_quickly, threshold_too_quickly,
-		           k_too_many, decomp->ack_rate_limits.speed.threshold);
-
-		if(infos->state == ROHC_DECOMP_STATE_SC)
-		{
-			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			          "change from state %d to state %d because of error(s)",
-			          infos->state, ROHC_DECOMP_STATE_NC);
-			infos->context->state = ROHC_DECOMP_STATE_NC;
-		}
-		else if(infos->state == ROHC_DECOMP_STATE_FC)
-		{
-			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			          "change from state %d to state %d because of error(s)",
-			          infos->state, ROHC_DECOMP_STATE_SC);
-			infos->context->state = ROHC_DECOMP_STATE_SC;
-		}
-		else
+		uint8_t *const new_rru_buf = rohc_mempool_alloc(&decomp->mempool, mrru);
+		if(new_rru_buf == NULL)
 		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "stay in state %d because of error(s)", infos->context->state);
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to set MRRU: failed to allocate %zu bytes "
+			             "of memory for MRRU buffer", mrru);
+			goto error;
 		}
+		rohc_mempool_release(&decomp->mempool, decomp->rru, decomp->mrru);
+		decomp->rru = new_rru_buf;
 	}
+	decomp->mrru = mrru;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "MRRU is now set to %zu", decomp->mrru);
 
-skip:
 	return true;
 
 error:
@@ -2425,171 +5877,286 @@ error:
 
 
 /**
- * @brief Update statistics upon successful decompression
+ * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
  *
- * @param context         The decompression context
- * @param comp_hdr_len    The length (in bytes) of the compressed header
- * @param uncomp_hdr_len  The length (in bytes) of the uncompressed header
+ * Get the current Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If MRRU value is 0, segmentation is disabled.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
+ * upon decompression until the last segment is received (or a non-segment is
+ * received). Decompressed data will be returned at that time.
+ *
+ * @param decomp     The ROHC decompressor
+ * @param[out] mrru  The current MRRU value (in bytes)
+ * @return           true if MRRU was successfully retrieved, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_mrru
+ * @see rohc_decompress3
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_mrru
  */
-static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context,
-                                          const size_t comp_hdr_len,
-                                          const size_t uncomp_hdr_len)
+bool rohc_decomp_get_mrru(const struct rohc_decomp *const decomp,
+                          size_t *const mrru)
 {
-	context->header_last_compressed_size = comp_hdr_len;
-	context->header_compressed_size += comp_hdr_len;
-	context->header_last_uncompressed_size = uncomp_hdr_len;
-	context->header_uncompressed_size += uncomp_hdr_len;
+	if(decomp == NULL || mrru == NULL)
+	{
+		goto error;
+	}
+
+	*mrru = decomp->mrru;
+	return true;
+
+error:
+	return false;
 }
 
 
-/**
- * @brief Reset all the statistics of the given ROHC decompressor
- *
- * @param decomp The ROHC decompressor
- */
-static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
-{
-	decomp->stats.received = 0;
-	decomp->stats.failed_crc = 0;
-	decomp->stats.failed_no_context = 0;
-	decomp->stats.failed_decomp = 0;
-	decomp->stats.total_uncompressed_size = 0;
-	decomp->stats.total_compressed_size = 0;
-	decomp->stats.corrected_crc_failures = 0;
-	decomp->stats.corrected_sn_wraparounds = 0;
-	decomp->stats.corrected_wrong_sn_updates = 0;
+/**
+ * @brief Set the number of packets sent during one Round-Trip Time (RTT).
+ *
+ * Set the maximum number of packets sent in worst case by the remote ROHC
+ * compressor for one given stream (ie. one compression/decompression context)
+ * during one Round-Trip Time (RTT).
+ *
+ * The number of packets sent by the remote ROHC compressor is used to estimate
+ * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
+ * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
+ *
+ * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
+ * are always transmitted.
+ *
+ * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
+ * transmitted every 20 milliseconds (classic VoIP stream). If your network
+ * streams and conditions differ, change the default value.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param prtt    The number of packets sent during one RTT
+ * @return        true if the new value was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example:
+ * \snippet test_feedback2.c define ROHC decompressor
+ * \code
+        rohc_cid_type_t cid_type = ROHC_SMALL_CID;
+        rohc_cid_t max_cid = ROHC_SMALL_CID_MAX;
+        ...
+\endcode
+ * \snippet test_feedback2.c create ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_feedback2.c set decompressor pRTT
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_get_prtt
+ * @see rohc_decompress3
+ */
+bool rohc_decomp_set_prtt(struct rohc_decomp *const decomp,
+                          const size_t prtt)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* new pRTT must be in range [0, SIZE_MAX] */
+	if(prtt >= (SIZE_MAX / 2))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected pRTT value: must be in range [0, %zu]",
+		             SIZE_MAX);
+		goto error;
+	}
+
+	/* set new pRTT */
+	decomp->prtt = prtt;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "pRTT is now set to %zu", decomp->prtt);
+
+	/* compute the minimum number of SN bits to transmit to the remote
+	 * compressor in the positive or negative feedbacks in order to avoid
+	 * any ambiguity at compressor about the ROHC packet that is
+	 * (n)acknowledged by the decompressor */
+	decomp->sn_feedback_min_bits = sizeof(uint32_t) * 8;
+	if(decomp->prtt != 0)
+	{
+		decomp->sn_feedback_min_bits -= __builtin_clz(decomp->prtt);
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Give a description for the given ROHC decompression context state
+ * @brief Get the number of packets sent during one Round-Trip Time (RTT).
  *
- * Give a description for the given ROHC decompression context state.
+ * Get the maximum number of packets sent in worst case by the remote ROHC
+ * compressor for one given stream (ie. one compression/decompression context)
+ * during one Round-Trip Time (RTT).
  *
- * The descriptions are not part of the API. They may change between
- * releases without any warning. Do NOT use them for other means that
- * providing to users a textual description of decompression context states
- * used by the library. If unsure, ask on the mailing list.
+ * The number of packets sent by the remote ROHC compressor is used to estimate
+ * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
+ * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
  *
- * @param state  The decompression context state to get a description for
- * @return       A string that describes the given decompression context state
+ * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
+ * are always transmitted.
+ *
+ * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
+ * transmitted every 20 milliseconds (classic VoIP stream). If your network
+ * streams and conditions differ, change the default value.
+ *
+ * @param decomp     The ROHC decompressor
+ * @param[out] prtt  The number of packets sent during one RTT
+ * @return           true if pRTT was successfully retrieved, false otherwise
  *
  * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_prtt
+ * @see rohc_decompress3
  */
-const char * rohc_decomp_get_state_descr(const rohc_decomp_state_t state)
+bool rohc_decomp_get_prtt(const struct rohc_decomp *const decomp,
+                          size_t *const prtt)
 {
-	switch(state)
+	if(decomp == NULL || prtt == NULL)
 	{
-		case ROHC_DECOMP_STATE_NC:
-			return "No Context";
-		case ROHC_DECOMP_STATE_SC:
-			return "Static Context";
-		case ROHC_DECOMP_STATE_FC:
-			return "Full Context";
-		case ROHC_DECOMP_STATE_UNKNOWN:
-		default:
-			return "no description";
+		goto error;
 	}
+
+	*prtt = decomp->prtt;
+	return true;
+
+error:
+	return false;
 }
 
 
 /**
- * @brief Get some information about the last decompressed packet
+ * @brief Set the rate limits for feedbacks
  *
- * Get some information about the last decompressed packet.
+ * Set the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
+ * and STATIC-NACK).
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_decomp_last_packet_info_t structure with the \e version_major
- * and \e version_minor fields set to one of the following supported
- * versions:
- *  - Major 0, minor 0
- *  - Major 0, minor 1
- *  - Major 0, minor 2
+ * There are 3 different rate limits:
+ *  \li the rate limit to avoid sending the same type of feedback too often:
+ *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
+ *      specified by the parameters \e k and \e n ;
+ *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
+ *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
+ *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
+ *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
  *
- * See \ref rohc_decomp_last_packet_info_t for details about fields that
- * are supported in the above versions.
+ * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
+ * 3 ratios of packets:
+ *  \li a feedback is sent every \e k packets out of \e n packets that cause
+ *      the same feedback type to be sent ;
+ *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
+ *      because of a CRC failure in the Full Context state ;
+ *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
+ *      failed because of a CRC failure in the Static Context state ;
  *
- * @param decomp        The ROHC decompressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * The default values are:
+ *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
+ *  \li k_1 = 30 and n_1 = 100, ie. 30%
+ *  \li k_2 = 30 and n_2 = 100, ie. 30%
+ *
+ * If your network streams and conditions differ, change the default value.
+ *
+ * The n/n_1/n_2 values shall not be zero.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param k       The k rate-limit parameter to avoid sending feedback too often
+ * @param n       The n rate-limit parameter to avoid sending feedback too often
+ * @param k_1     The k_1 rate-limit parameter to avoid sending NACKs too quickly
+ * @param n_1     The n_1 rate-limit parameter to avoid sending NACKs too quickly
+ * @param k_2     The k_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
+ * @param n_2     The n_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
+ * @return        true if the new values were successfully set, false otherwise
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_last_packet_info_t
+ * \par Example:
+ * \snippet test_lost_packet.c define ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_lost_packet.c create ROHC decompressor
+ * \code
+        ...
+\endcode
+ * \snippet test_lost_packet.c set decompressor rate limits
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_decomp_get_rate_limits
+ * @see rohc_decomp_set_prtt
+ * @see rohc_decomp_get_prtt
+ * @see rohc_decompress3
  */
-bool rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
-                                      rohc_decomp_last_packet_info_t *const info)
+bool rohc_decomp_set_rate_limits(struct rohc_decomp *const decomp,
+                                 const size_t k, const size_t n,
+                                 const size_t k_1, const size_t n_1,
+                                 const size_t k_2, const size_t n_2)
 {
+	/* decompressor must be valid */
 	if(decomp == NULL)
 	{
+		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
 
-	if(decomp->last_context == NULL)
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "last context found in decompressor is not valid");
-		goto error;
-	}
-
-	if(info == NULL)
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "structure for last packet information is not valid");
-		goto error;
-	}
-
-	/* check compatibility version */
-	if(info->version_major != 0)
+	/* n values are used as divisors */
+	if(n == 0 || n_1 == 0 || n_2 == 0)
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for last "
-		           "packet information", info->version_major);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "rate-limits n/n_1/n_2 shall not be 0");
 		goto error;
 	}
 
-	/* base fields for major version 0 */
-	info->context_mode = decomp->last_context->mode;
-	info->context_state = decomp->last_context->state;
-	info->profile_id = decomp->last_context->profile->id;
-	info->nr_lost_packets = decomp->last_context->nr_lost_packets;
-	info->nr_misordered_packets = decomp->last_context->nr_misordered_packets;
-	info->is_duplicated = decomp->last_context->is_duplicated;
-
-	if(info->version_minor != 0 &&
-	   info->version_minor != 1 &&
-	   info->version_minor != 2)
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported minor version (%u) of the structure for "
-		           "last packet information", info->version_minor);
-		goto error;
-	}
+	/* set new rate-limits */
+	decomp->ack_rate_limits.speed.k = k;
+	decomp->ack_rate_limits.speed.n = n;
+	decomp->ack_rate_limits.nack.k = k_1;
+	decomp->ack_rate_limits.nack.n = n_1;
+	decomp->ack_rate_limits.static_nack.k = k_2;
+	decomp->ack_rate_limits.static_nack.n = n_2;
 
-	/* new fields in 0.1 */
-	if(info->version_minor >= 1)
-	{
-		info->corrected_crc_failures =
-			decomp->last_context->corrected_crc_failures;
-		info->corrected_sn_wraparounds =
-			decomp->last_context->corrected_sn_wraparounds;
-		info->corrected_wrong_sn_updates =
-			decomp->last_context->corrected_wrong_sn_updates;
-		info->packet_type = decomp->last_context->last_packet_type;
-	}
+	/* compute the rate-limit thresholds */
+	decomp->ack_rate_limits.speed.threshold =
+		decomp->ack_rate_limits.speed.k * 32 * 100 / decomp->ack_rate_limits.speed.n;
+	decomp->ack_rate_limits.nack.threshold =
+		decomp->ack_rate_limits.nack.k * 32 * 100 / decomp->ack_rate_limits.nack.n;
+	decomp->ack_rate_limits.static_nack.threshold =
+		decomp->ack_rate_limits.static_nack.k * 32 * 100 /
+		decomp->ack_rate_limits.static_nack.n;
 
-	/* new fields in 0.2 */
-	if(info->version_minor >= 2)
-	{
-		info->total_last_comp_size =
-			decomp->last_context->total_last_compressed_size;
-		info->header_last_comp_size =
-			decomp->last_context->header_last_compressed_size;
-		info->total_last_uncomp_size =
-			decomp->last_context->total_last_uncompressed_size;
-		info->header_last_uncomp_size =
-			decomp->last_context->header_last_uncompressed_size;
-	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "rate-limits are now set to: %zu/%zu (all), %zu/%zu (NACK), "
+	           "%zu/%zu (STATIC-NACK)",
+	           decomp->ack_rate_limits.speed.k, decomp->ack_rate_limits.speed.n,
+	           decomp->ack_rate_limits.nack.k, decomp->ack_rate_limits.nack.n,
+	           decomp->ack_rate_limits.static_nack.k,
+	           decomp->ack_rate_limits.static_nack.n);
 
 	return true;
 
@@ -2599,94 +6166,72 @@ error:
 
 
 /**
- * @brief Get some information about the given decompression context
+ * @brief Get the rate limits for feedbacks currently configured
+ *
+ * Get the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
+ * and STATIC-NACK).
+ *
+ * There are 3 different rate limits:
+ *  \li the rate limit to avoid sending the same type of feedback too often:
+ *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
+ *      specified by the parameters \e k and \e n ;
+ *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
+ *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
+ *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
+ *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
  *
- * Get some information about the given decompression context.
+ * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
+ * 3 ratios of packets:
+ *  \li a feedback is sent every \e k packets out of \e n packets that cause
+ *      the same feedback type to be sent ;
+ *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
+ *      because of a CRC failure in the Full Context state ;
+ *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
+ *      failed because of a CRC failure in the Static Context state ;
  *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_decomp_context_info_t structure with the \e version_major
- * and \e version_minor fields set to one of the following supported
- * versions:
- *  - Major 0, minor 0
+ * The default values are:
+ *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
+ *  \li k_1 = 30 and n_1 = 100, ie. 30%
+ *  \li k_2 = 30 and n_2 = 100, ie. 30%
  *
- * See \ref rohc_decomp_context_info_t for details about fields that
- * are supported in the above versions.
+ * If your network streams and conditions differ, change the default value.
  *
- * @param decomp        The ROHC decompressor to get information from
- * @param cid           The Context ID to get information for
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param decomp    The ROHC decompressor
+ * @param[out] k    The k rate-limit parameter to avoid sending feedback too often
+ * @param[out] n    The n rate-limit parameter to avoid sending feedback too often
+ * @param[out] k_1  The k_1 rate-limit param. to avoid sending NACKs too quickly
+ * @param[out] n_1  The n_1 rate-limit param. to avoid sending NACKs too quickly
+ * @param[out] k_2  The k_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
+ * @param[out] n_2  The n_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
+ * @return          true if rate-limits were successfully retrieved,
+ *                  false otherwise
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_context_info_t
+ * @see rohc_decomp_set_rate_limits
+ * @see rohc_decomp_set_prtt
+ * @see rohc_decomp_get_prtt
+ * @see rohc_decompress3
  */
-bool rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
-                                  const rohc_cid_t cid,
-                                  rohc_decomp_context_info_t *const info)
+bool rohc_decomp_get_rate_limits(const struct rohc_decomp *const decomp,
+                                 size_t *const k, size_t *const n,
+                                 size_t *const k_1, size_t *const n_1,
+                                 size_t *const k_2, size_t *const n_2)
 {
-	if(decomp == NULL)
-	{
-		goto error;
-	}
-
-	if(cid > decomp->medium.max_cid)
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "decompressor does not handle CID %u since MAX_CID is %u",
-		           cid, decomp->medium.max_cid);
-		goto error;
-	}
-
-	if(info == NULL)
+	if(decomp == NULL ||
+	   k == NULL || n == NULL ||
+	   k_1 == NULL || n_1 == NULL ||
+	   k_2 == NULL || n_2 == NULL)
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "structure for context information is not valid");
 		goto error;
 	}
 
-	/* check compatibility version */
-	if(info->version_major == 0)
-	{
-		/* base fields for major version 0 */
-		if(decomp->contexts[cid] == NULL)
-		{
-			info->packets_nr = 0;
-			info->comp_bytes_nr = 0;
-			info->uncomp_bytes_nr = 0;
-			info->corrected_crc_failures = 0;
-			info->corrected_sn_wraparounds = 0;
-			info->corrected_wrong_sn_updates = 0;
-		}
-		else
-		{
-			info->packets_nr = decomp->contexts[cid]->num_recv_packets;
-			info->comp_bytes_nr = decomp->contexts[cid]->total_compressed_size;
-			info->uncomp_bytes_nr = decomp->contexts[cid]->total_uncompressed_size;
-			info->corrected_crc_failures =
-				decomp->contexts[cid]->corrected_crc_failures;
-			info->corrected_sn_wraparounds =
-				decomp->contexts[cid]->corrected_sn_wraparounds;
-			info->corrected_wrong_sn_updates =
-				decomp->contexts[cid]->corrected_wrong_sn_updates;
-		}
-
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
-		{
-			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "context information", info->version_minor);
-			goto error;
-		}
-	}
-	else
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for context"
-		           "information", info->version_major);
-		goto error;
-	}
+	*k = decomp->ack_rate_limits.speed.k;
+	*n = decomp->ack_rate_limits.speed.n;
+	*k_1 = decomp->ack_rate_limits.nack.k;
+	*n_1 = decomp->ack_rate_limits.nack.n;
+	*n_2 = decomp->ack_rate_limits.static_nack.n;
+	*k_2 = decomp->ack_rate_limits.static_nack.k;
 
 	return true;
 
@@ -2696,78 +6241,87 @@ error:
 
 
 /**
- * @brief Get some general information about the decompressor
- *
- * Get some general information about the decompressor.
- *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_decomp_general_info_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
+ * @brief Flush the feedbacks accumulated by the ROHC decompressor
  *
- * See the \ref rohc_decomp_general_info_t structure for details about fields
- * that are supported in the above versions.
+ * Write the feedbacks accumulated by the decompressor since the previous
+ * flush at the end of the given buffer, negative ACKs first. Feedbacks are
+ * accumulated only if the \ref ROHC_DECOMP_FEATURE_FEEDBACK_COALESCING
+ * feature is enabled, at most one per CID. The feedbacks that do not fit in
+ * the buffer remain accumulated until the next flush.
  *
- * @param decomp        The ROHC decompressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @param decomp         The ROHC decompressor
+ * @param[out] feedback  The buffer to store the feedbacks in
+ * @return               true if the feedbacks were successfully flushed,
+ *                       false if a problem occurred
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_general_info_t
+ * @see rohc_decomp_set_features
  */
-bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
-                                  rohc_decomp_general_info_t *const info)
+bool rohc_decomp_flush_feedback(struct rohc_decomp *const decomp,
+                                struct rohc_buf *const feedback)
 {
-	if(decomp == NULL)
-	{
-		goto error;
-	}
+	bool is_sent[ROHC_DECOMP_FEEDBACKS_PENDING_MAX] = { false };
+	enum rohc_feedback_ack_type ack_type;
+	size_t pending_nr = 0;
+	size_t i;
 
-	if(info == NULL)
+	if(decomp == NULL || feedback == NULL)
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "structure for general information is not valid");
 		goto error;
 	}
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	/* negative ACKs first, so that they get the room in priority */
+	for(ack_type = ROHC_FEEDBACK_STATIC_NACK; ; ack_type--)
 	{
-		/* base fields for major version 0 */
-		info->contexts_nr = decomp->num_contexts_used;
-		info->packets_nr = decomp->stats.received;
-		info->comp_bytes_nr = decomp->stats.total_compressed_size;
-		info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
-
-		/* new fields added by minor versions */
-		switch(info->version_minor)
+		for(i = 0; i < decomp->feedbacks_pending_nr; i++)
 		{
-			case 0:
-				/* nothing to add */
-				break;
-			case 1:
-				/* new fields in 0.1 */
-				info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
-				info->corrected_sn_wraparounds =
-					decomp->stats.corrected_sn_wraparounds;
-				info->corrected_wrong_sn_updates =
-					decomp->stats.corrected_wrong_sn_updates;
-				break;
-			default:
-				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-				           "unsupported minor version (%u) of the structure for "
-				           "general information", info->version_minor);
+			const struct rohc_decomp_pending_feedback *const pending =
+				&(decomp->feedbacks_pending[i]);
+			struct d_feedback sfeedback;
+			const size_t len_before = feedback->len;
+
+			if(pending->ack_type != ack_type)
+			{
+				continue;
+			}
+
+			/* wrap a copy of the feedback, so that it remains intact if it does
+			 * not fit in the buffer */
+			memcpy(&sfeedback, &pending->feedback, sizeof(struct d_feedback));
+			if(!f_wrap_feedback(&sfeedback, pending->cid, pending->cid_type,
+			                    pending->crc_present, &decomp->crc_engine, feedback))
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+				             "failed to wrap the feedback for CID %u", pending->cid);
 				goto error;
+			}
+			is_sent[i] = !!(feedback->len > len_before);
+		}
+		if(ack_type == ROHC_FEEDBACK_ACK)
+		{
+			break;
 		}
 	}
-	else
+
+	/* keep the feedbacks that did not fit in the buffer */
+	for(i = 0; i < decomp->feedbacks_pending_nr; i++)
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for "
-		           "general information", info->version_major);
-		goto error;
+		if(!is_sent[i])
+		{
+			if(pending_nr != i)
+			{
+				memcpy(&(decomp->feedbacks_pending[pending_nr]),
+				       &(decomp->feedbacks_pending[i]),
+				       sizeof(struct rohc_decomp_pending_feedback));
+			}
+			pending_nr++;
+		}
 	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "%zu feedbacks flushed in %zu bytes, %zu feedbacks still pending",
+	           decomp->feedbacks_pending_nr - pending_nr, feedback->len, pending_nr);
+	decomp->feedbacks_pending_nr = pending_nr;
 
 	return true;
 
@@ -2777,27 +6331,38 @@ error:
 
 
 /**
- * @brief Get the CID type that the decompressor uses
+ * @brief Link the ROHC decompressor with a ring of feedbacks
  *
- * Get the CID type that the decompressor currently uses.
+ * Once linked with the ring, the decompressor pushes in the ring the
+ * feedbacks it receives from the remote compressor and the feedbacks it
+ * builds for the remote compressor, so that the same-side compressor may
+ * consume them from another thread without locking. The feedbacks are
+ * stored in the buffers given to \ref rohc_decomp_decompress3 only when the
+ * ring is full.
  *
- * @param decomp         The ROHC decompressor
- * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
- *                       \ref ROHC_LARGE_CID
- * @return               true if the CID type was successfully retrieved,
- *                       false otherwise
+ * @param decomp  The ROHC decompressor
+ * @param ring    The ring of feedbacks, NULL to unlink the decompressor
+ * @return        true if the ring was successfully linked,
+ *                false if a problem occurred
  *
  * @ingroup rohc_decomp
+ *
+ * @see rohc_feedback_ring_new
+ * @see rohc_comp_set_feedback_ring
  */
-bool rohc_decomp_get_cid_type(const struct rohc_decomp *const decomp,
-                              rohc_cid_type_t *const cid_type)
+bool rohc_decomp_set_feedback_ring(struct rohc_decomp *const decomp,
+                                   struct rohc_feedback_ring *const ring)
 {
-	if(decomp == NULL || cid_type == NULL)
+	if(decomp == NULL)
 	{
 		goto error;
 	}
 
-	*cid_type = decomp->medium.cid_type;
+	decomp->feedback_ring = ring;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "decompressor %s feedback ring", ring != NULL ?
+	           "linked with" : "unlinked from");
+
 	return true;
 
 error:
@@ -2806,27 +6371,78 @@ error:
 
 
 /**
- * @brief Get the maximal CID value the decompressor uses
+ * @brief Set the reorder buffer of the ROHC decompressor
+ *
+ * On links that reorder packets, eg. bonded or multipath links, the packets of
+ * one context may arrive a few packets out of order. With the reorder buffer,
+ * the packets that arrive before some of the packets that precede them are
+ * held instead of updating the context: \ref rohc_decompress3 returns
+ * \ref ROHC_STATUS_OK and one empty uncompressed packet for them. They are
+ * decoded again and given back by \ref rohc_decomp_reorder_release once the
+ * context was updated by the packets that precede them, or once they were
+ * held for too long. The compressor may then use smaller interpretation
+ * windows than the reordering of the link would require.
+ *
+ * The packets of the IP-only, UDP, UDP-Lite, RTP and ESP profiles of ROHCv1
+ * may be held, at most \e depth packets per context. The reorder buffer is
+ * disabled by default.
  *
- * Get the maximal CID value the decompressor uses, ie. the \e MAX_CID
- * parameter defined in RFC 3095.
- *
- * @param decomp        The ROHC decompressor
- * @param[out] max_cid  The current maximal CID value
- * @return              true if MAX_CID was successfully retrieved,
- *                      false otherwise
+ * @param decomp     The ROHC decompressor
+ * @param depth      The maximum number of packets held per context, at most
+ *                   8, 0 to disable the reorder buffer
+ * @param max_delay  The maximum delay (in milliseconds) one packet is held
+ * @return           true if the reorder buffer was successfully set,
+ *                   false otherwise (the reorder buffer cannot be disabled
+ *                   while it holds some packets)
  *
  * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_reorder_release
  */
-bool rohc_decomp_get_max_cid(const struct rohc_decomp *const decomp,
-                             size_t *const max_cid)
+bool rohc_decomp_set_reorder(struct rohc_decomp *const decomp,
+                             const size_t depth,
+                             const size_t max_delay)
 {
-	if(decomp == NULL || max_cid == NULL)
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(depth > ROHC_DECOMP_REORDER_DEPTH_MAX)
 	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to set the reorder buffer: depth %zu is greater "
+		             "than %u", depth, ROHC_DECOMP_REORDER_DEPTH_MAX);
 		goto error;
 	}
 
-	*max_cid = decomp->medium.max_cid;
+	if(depth == 0)
+	{
+		if(decomp->reorder_held_nr > 0)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to disable the reorder buffer: %zu packets are "
+			             "still held", decomp->reorder_held_nr);
+			goto error;
+		}
+		zfree(decomp->reorder_slots);
+	}
+	else if(decomp->reorder_slots == NULL)
+	{
+		decomp->reorder_slots = calloc(ROHC_DECOMP_REORDER_SLOTS_NR,
+		                               sizeof(struct rohc_decomp_reorder_slot));
+		if(decomp->reorder_slots == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to allocate memory for the reorder buffer");
+			goto error;
+		}
+	}
+	decomp->reorder_depth = depth;
+	decomp->reorder_max_delay = max_delay;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "reorder buffer holds up to %zu packets per context for up "
+	           "to %zu ms", depth, max_delay);
+
 	return true;
 
 error:
@@ -2835,182 +6451,358 @@ error:
 
 
 /**
- * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
- *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If set to 0, segmentation is disabled as no segment headers are allowed
- * on the channel. Every received segment will be dropped.
- *
- * According to RF5225 §6.1, ROHC segmentation cannot be enabled if any
- * ROHCv2 profile is also enabled.
+ * @brief Release one packet held by the reorder buffer of the decompressor
  *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
- * upon decompression until the last segment is received (or a non-segment is
- * received). Decompressed data will be returned at that time.
+ * Decompress one of the packets held by the reorder buffer, if the packets
+ * that precede it updated its context, or if it was held for too long. The
+ * packets held by one context are released in the order of their SNs.
  *
- * @warning Changing the MRRU value while library is used may lead to
- *          destruction of the current RRU.
+ * The function shall be called after every decompression, until it gives
+ * one empty uncompressed packet, and from time to time to release the
+ * packets held for too long.
  *
- * @param decomp  The ROHC decompressor
- * @param mrru    The new MRRU value (in bytes)
- * @return        true if the MRRU was successfully set, false otherwise
+ * @param decomp              The ROHC decompressor
+ * @param now                 The current time, 0 to release the held packets
+ *                            whatever their delays
+ * @param[out] uncomp_packet  The resulting uncompressed packet, empty if no
+ *                            packet is released
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @param[out] info           The information about the released packet,
+ *                            see \ref rohc_decompress4, may be NULL
+ * @return                    The same status values as \ref rohc_decompress3
  *
  * @ingroup rohc_decomp
  *
- * \par Example:
- * \snippet test_segment.c define ROHC decompressor
- * \code
-        size_t mrru = 500;
-        ...
-\endcode
- * \snippet test_segment.c create ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_segment.c set decompressor MRRU
- * \code
-        ...
-\endcode
- *
- * @see rohc_decomp_get_mrru
- * @see rohc_decompress3
- * @see rohc_comp_set_mrru
- * @see rohc_comp_get_mrru
+ * @see rohc_decomp_set_reorder
  */
-bool rohc_decomp_set_mrru(struct rohc_decomp *const decomp,
-                          const size_t mrru)
+rohc_status_t rohc_decomp_reorder_release(struct rohc_decomp *const decomp,
+                                          const struct rohc_ts now,
+                                          struct rohc_buf *const uncomp_packet,
+                                          struct rohc_buf *const feedback_send,
+                                          struct rohc_decomp_pkt_info *const info)
 {
-	/* decompressor must be valid */
+	const bool is_flush = !!(now.sec == 0 && now.nsec == 0);
+	struct rohc_decomp_reorder_slot *released = NULL;
+	rohc_status_t status;
+	size_t i;
+
+	/* check inputs validity */
 	if(decomp == NULL)
 	{
-		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
-
-	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
-	if(mrru > ROHC_MAX_MRRU)
+	if(uncomp_packet == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unexpected MRRU value: must be in range [0, %d]",
-		             ROHC_MAX_MRRU);
+		             "given uncomp_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is not empty");
 		goto error;
 	}
 
-	/* RFC5225, §6.1:
-	 * The compressor MUST NOT use ROHC segmentation (see Section 5.2.5 of
-	 * [RFC4995]), i.e., the Maximum Reconstructed Reception Unit (MRRU)
-	 * MUST be set to 0, if the configuration of the ROHC channel contains
-	 * at least one ROHCv2 profile in the list of supported profiles (i.e.,
-	 * the PROFILES parameter) and if the channel cannot guarantee in-order
-	 * delivery of packets between compression endpoints.
-	 */
-	if(mrru > 0)
+	if(decomp->reorder_held_nr == 0)
 	{
-		uint8_t profile_major;
+		return ROHC_STATUS_OK;
+	}
 
-		for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
-		{
-			uint8_t profile_minor;
+	/* release first the packet that one context expects next, otherwise the
+	 * first packet of one context that held one packet for too long */
+	for(i = 0; i < ROHC_DECOMP_REORDER_SLOTS_NR; i++)
+	{
+		struct rohc_decomp_reorder_slot *const slot = &(decomp->reorder_slots[i]);
 
-			for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
-			{
-				const uint16_t profile_id = (profile_major << 8) | profile_minor;
+		if(slot->len == 0)
+		{
+			continue;
+		}
+		if(rohc_decomp_reorder_gap(decomp, slot) == 0)
+		{
+			released = slot;
+			break;
+		}
+		if(released == NULL &&
+		   (is_flush ||
+		    !rohc_time_is_before(now, rohc_time_add_us(slot->arrival_time,
+		                                               decomp->reorder_max_delay * 1000ULL))))
+		{
+			released = slot;
+		}
+	}
+	if(released == NULL)
+	{
+		return ROHC_STATUS_OK;
+	}
+	for(i = 0; i < ROHC_DECOMP_REORDER_SLOTS_NR; i++)
+	{
+		struct rohc_decomp_reorder_slot *const slot = &(decomp->reorder_slots[i]);
 
-				if(rohc_decomp_profile_enabled_nocheck(decomp, profile_id) &&
-				   rohc_profile_is_rohcv2(profile_id))
-				{
-					rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-					             "failed to set MRRU to %zu bytes: segmentation is not "
-					             "compatible with ROHCv2 profile 0x%04x that is enabled",
-					             mrru, profile_id);
-					goto error;
-				}
-			}
+		if(slot->len > 0 && slot->cid == released->cid &&
+		   rohc_decomp_reorder_gap(decomp, slot) < rohc_decomp_reorder_gap(decomp, released))
+		{
+			released = slot;
 		}
 	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "CID %u: release held packet with SN %u", released->cid,
+	           released->sn);
 
-	/* set new MRRU */
-	if(mrru == 0)
+	/* decode the packet again against the updated context */
 	{
-		decomp->rru = NULL;
+		const struct rohc_buf rohc_packet =
+			rohc_buf_init_full(released->data, released->len, released->arrival_time);
+
+		decomp->reorder_releasing = true;
+		status = rohc_decomp_decompress_pkt(decomp, rohc_packet, uncomp_packet,
+		                                    NULL, feedback_send, false, info);
+		decomp->reorder_releasing = false;
+	}
+	released->len = 0;
+	decomp->reorder_held_nr--;
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Hold the packet in the reorder buffer if it arrived too early
+ *
+ * The packet is held if the SN decoded from it is ahead of the next SN that
+ * its context expects, by no more than the depth of the reorder buffer. The
+ * packets that precede it may then update the context before it is decoded
+ * again by \ref rohc_decomp_reorder_release.
+ *
+ * @param decomp          The ROHC decompressor
+ * @param context         The decompression context
+ * @param packet_type     The type of the ROHC packet
+ * @param rohc_packet     The ROHC packet, add-CID excluded
+ * @param add_cid_len     The length of the add-CID before the ROHC packet
+ * @param in_place        Whether the packet is decompressed in place
+ * @param decoded_values  The values decoded from the ROHC packet
+ * @return                true if the packet is held,
+ *                        false if it shall be decompressed now
+ */
+static bool rohc_decomp_reorder_hold(struct rohc_decomp *const decomp,
+                                     const struct rohc_decomp_ctxt *const context,
+                                     const rohc_packet_t packet_type,
+                                     const struct rohc_buf rohc_packet,
+                                     const size_t add_cid_len,
+                                     const bool in_place,
+                                     const void *const decoded_values)
+{
+	const struct rohc_decomp_profile *const profile =
+		rohc_decomp_ctxt_profile(context);
+	struct rohc_decomp_reorder_slot *free_slot = NULL;
+	size_t held_nr = 0;
+	uint32_t sn_mask;
+	uint32_t gap;
+	uint32_t sn;
+	size_t i;
+
+	/* only the packets that do not carry static nor dynamic information the
+	 * context cannot do without may be held, then decoded again */
+	if(decomp->reorder_depth == 0 || decomp->reorder_releasing || in_place ||
+	   decomp->chain_by_ref || profile->get_decoded_sn == NULL ||
+	   context->state != ROHC_DECOMP_STATE_FC ||
+	   context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE ||
+	   rohc_packet_carry_static_info(packet_type) ||
+	   packet_type == ROHC_PACKET_IR_DYN ||
+	   rohc_packet.data == decomp->rru ||
+	   (add_cid_len + rohc_packet.len) > ROHC_DECOMP_REORDER_PKT_MAX_LEN)
+	{
+		return false;
+	}
+
+	/* is the packet ahead of the next SN the context expects? */
+	if(profile->msn_max_bits >= 32)
+	{
+		sn_mask = UINT32_MAX;
 	}
 	else
 	{
-		uint8_t *const new_rru_buf = malloc(mrru);
-		if(new_rru_buf == NULL)
+		sn_mask = (1U << profile->msn_max_bits) - 1;
+	}
+	sn = profile->get_decoded_sn(decoded_values);
+	gap = (sn - profile->get_sn(context) - 1) & sn_mask;
+	if(gap == 0 || gap > decomp->reorder_depth)
+	{
+		return false;
+	}
+
+	/* hold one single copy of the packet, and not too many packets per
+	 * context */
+	for(i = 0; i < ROHC_DECOMP_REORDER_SLOTS_NR; i++)
+	{
+		struct rohc_decomp_reorder_slot *const slot = &(decomp->reorder_slots[i]);
+
+		if(slot->len == 0)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "failed to set MRRU: failed to allocate %zu bytes "
-			             "of memory for MRRU buffer", mrru);
-			goto error;
+			if(free_slot == NULL)
+			{
+				free_slot = slot;
+			}
 		}
-		if(decomp->rru != NULL)
+		else if(slot->cid == context->cid)
 		{
-			zfree(decomp->rru);
+			if(slot->sn == sn)
+			{
+				rohc_decomp_debug(context, "packet with SN %u is already held", sn);
+				return true;
+			}
+			held_nr++;
 		}
-		decomp->rru = new_rru_buf;
 	}
-	decomp->mrru = mrru;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "MRRU is now set to %zu", decomp->mrru);
+	if(free_slot == NULL || held_nr >= decomp->reorder_depth)
+	{
+		rohc_decomp_debug(context, "reorder buffer is full, do not hold packet "
+		                  "with SN %u", sn);
+		return false;
+	}
+
+	free_slot->arrival_time = rohc_packet.time;
+	free_slot->sn = sn;
+	free_slot->cid = context->cid;
+	free_slot->len = add_cid_len + rohc_packet.len;
+	memcpy(free_slot->data, rohc_buf_data(rohc_packet) - add_cid_len,
+	       free_slot->len);
+	decomp->reorder_held_nr++;
+	rohc_decomp_debug(context, "hold packet with SN %u, %u packet(s) ahead of "
+	                  "the next expected SN", sn, gap);
 
 	return true;
+}
 
-error:
-	return false;
+
+/**
+ * @brief Get how far the held packet is ahead of the next SN its context expects
+ *
+ * @param decomp  The ROHC decompressor
+ * @param slot    The slot of the held packet
+ * @return        The number of packets the held packet is ahead of the next
+ *                expected SN, 0 if the packet shall be released now since
+ *                the context expects it next, went ahead of it, or is gone
+ */
+static uint32_t rohc_decomp_reorder_gap(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_reorder_slot *const slot)
+{
+	const struct rohc_decomp_ctxt *const context = decomp->contexts[slot->cid];
+	const struct rohc_decomp_profile *profile;
+	uint32_t sn_mask;
+	uint32_t gap;
+
+	if(context == NULL || context->state != ROHC_DECOMP_STATE_FC)
+	{
+		return 0;
+	}
+	profile = rohc_decomp_ctxt_profile(context);
+	if(profile->get_decoded_sn == NULL)
+	{
+		return 0;
+	}
+
+	if(profile->msn_max_bits >= 32)
+	{
+		sn_mask = UINT32_MAX;
+	}
+	else
+	{
+		sn_mask = (1U << profile->msn_max_bits) - 1;
+	}
+	gap = (slot->sn - profile->get_sn(context) - 1) & sn_mask;
+	if(gap > decomp->reorder_depth)
+	{
+		/* the context went ahead of the packet */
+		return 0;
+	}
+
+	return gap;
 }
 
 
 /**
- * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
+ * @brief Enable/disable features for ROHC decompressor
  *
- * Get the current Maximum Reconstructed Reception Unit (MRRU).
+ * Enable/disable features for ROHC decompressor. Features control whether
+ * mechanisms defined as optional by RFCs are enabled or not.
  *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
+ * Available features are listed by \ref rohc_decomp_features_t. They may be
+ * combined by XOR'ing them together.
  *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If MRRU value is 0, segmentation is disabled.
+ * With \ref ROHC_DECOMP_FEATURE_BOUNDED_WORK, the work done for one ROHC
+ * packet of H header bytes and P payload bytes is bounded as follows, where
+ * one decoding is the decoding of the fields, the build of the uncompressed
+ * headers and the computation of their CRC:
+ *  - IR and IR-DYN: 1 parse, 1 CRC over the H bytes, 1 decoding (no repair),
+ *  - UO-0, UO-1 and UOR-2 of the steady state: 1 single-pass decoding,
+ *  - UO-0, UO-1 and UOR-2 otherwise: 1 aborted single-pass attempt, 1 parse
+ *    and at most 2 decodings (the original and 1 CRC repair),
+ *  - CO packets of the ROHCv2 and TCP profiles: 1 parse and 1 decoding, the
+ *    profiles do not repair contexts,
+ *  - final segment of an RRU: 1 copy of the RRU referenced from the segments
+ *    (MRRU bytes at most), 1 FCS-32 over the last segment, then the work of
+ *    the packet type of the RRU,
+ *  - all packets: 1 context lookup in a hash table and 1 copy of the P bytes.
+ * Without the feature, an RRU referenced from segments may be parsed twice.
  *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_decompress3 will return ROHC_OK and one empty uncompressed packet
- * upon decompression until the last segment is received (or a non-segment is
- * received). Decompressed data will be returned at that time.
+ * @warning Changing the feature set while library is used is not supported
  *
- * @param decomp     The ROHC decompressor
- * @param[out] mrru  The current MRRU value (in bytes)
- * @return           true if MRRU was successfully retrieved, false otherwise
+ * @param decomp    The ROHC decompressor
+ * @param features  The feature set to enable/disable
+ * @return          true if the feature set was successfully enabled/disabled,
+ *                  false if a problem occurred
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_set_mrru
- * @see rohc_decompress3
- * @see rohc_comp_set_mrru
- * @see rohc_comp_get_mrru
+ * @see rohc_decomp_features_t
  */
-bool rohc_decomp_get_mrru(const struct rohc_decomp *const decomp,
-                          size_t *const mrru)
+bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
+                              const rohc_decomp_features_t features)
 {
-	if(decomp == NULL || mrru == NULL)
+	const rohc_decomp_features_t all_features =
+		ROHC_DECOMP_FEATURE_CRC_REPAIR |
+		ROHC_DECOMP_FEATURE_DUMP_PACKETS |
+		ROHC_DECOMP_FEATURE_FEEDBACK_COALESCING |
+		ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF |
+		ROHC_DECOMP_FEATURE_PERF_INFO |
+		ROHC_DECOMP_FEATURE_TIMER_BASED_TS |
+		ROHC_DECOMP_FEATURE_DUP_SHORTCUT |
+		ROHC_DECOMP_FEATURE_INSPECT |
+		ROHC_DECOMP_FEATURE_INSPECT_CRC |
+		ROHC_DECOMP_FEATURE_BOUNDED_WORK |
+		ROHC_DECOMP_FEATURE_IP_FRAGMENTS;
+
+	/* decompressor must be valid */
+	if(decomp == NULL)
 	{
+		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
 
-	*mrru = decomp->mrru;
+	/* reject unsupported features */
+	if((features & all_features) != features)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported (supported features "
+		             "set is 0x%x)", features, all_features);
+		goto error;
+	}
+
+	/* record new feature set */
+	decomp->features = features;
+
 	return true;
 
 error:
@@ -3019,81 +6811,47 @@ error:
 
 
 /**
- * @brief Set the number of packets sent during one Round-Trip Time (RTT).
- *
- * Set the maximum number of packets sent in worst case by the remote ROHC
- * compressor for one given stream (ie. one compression/decompression context)
- * during one Round-Trip Time (RTT).
- *
- * The number of packets sent by the remote ROHC compressor is used to estimate
- * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
- * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
+ * @brief Set the engine that computes the CRCs of the decompressor
  *
- * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
- * are always transmitted.
+ * The CRCs of the ROHC headers, of the IR packets, of the feedbacks and the
+ * FCS-32 of the ROHC segments are computed with the tables of the library by
+ * default. Set an engine to compute them with the CRC instructions of the
+ * platform or to offload them instead. The callbacks left NULL in the engine
+ * keep the tables of the library. Give NULL to go back to the tables for all
+ * the CRCs.
  *
- * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
- * transmitted every 20 milliseconds (classic VoIP stream). If your network
- * streams and conditions differ, change the default value.
+ * The engine is copied, so it does not need to outlive the call. Its CRCs
+ * shall be bit-exact with the ones of the library, some of them are cached
+ * in the contexts.
  *
  * @param decomp  The ROHC decompressor
- * @param prtt    The number of packets sent during one RTT
- * @return        true if the new value was successfully set, false otherwise
+ * @param engine  The CRC engine to use, or NULL for the tables of the library
+ * @return        true if the engine was set, false otherwise
  *
  * @ingroup rohc_decomp
  *
- * \par Example:
- * \snippet test_feedback2.c define ROHC decompressor
- * \code
-        rohc_cid_type_t cid_type = ROHC_SMALL_CID;
-        rohc_cid_t max_cid = ROHC_SMALL_CID_MAX;
-        ...
-\endcode
- * \snippet test_feedback2.c create ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_feedback2.c set decompressor pRTT
- * \code
-        ...
-\endcode
- *
- * @see rohc_decomp_get_prtt
- * @see rohc_decompress3
+ * @see rohc_crc_engine
  */
-bool rohc_decomp_set_prtt(struct rohc_decomp *const decomp,
-                          const size_t prtt)
+bool rohc_decomp_set_crc_engine(struct rohc_decomp *const decomp,
+                                const struct rohc_crc_engine *const engine)
 {
-	/* decompressor must be valid */
 	if(decomp == NULL)
 	{
-		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
 
-	/* new pRTT must be in range [0, SIZE_MAX] */
-	if(prtt >= (SIZE_MAX / 2))
+	if(engine == NULL)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unexpected pRTT value: must be in range [0, %zu]",
-		             SIZE_MAX);
-		goto error;
+		memset(&decomp->crc_engine, 0, sizeof(struct rohc_crc_engine));
 	}
-
-	/* set new pRTT */
-	decomp->prtt = prtt;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "pRTT is now set to %zu", decomp->prtt);
-
-	/* compute the minimum number of SN bits to transmit to the remote
-	 * compressor in the positive or negative feedbacks in order to avoid
-	 * any ambiguity at compressor about the ROHC packet that is
-	 * (n)acknowledged by the decompressor */
-	decomp->sn_feedback_min_bits = sizeof(uint32_t) * 8;
-	if(decomp->prtt != 0)
+	else
 	{
-		decomp->sn_feedback_min_bits -= __builtin_clz(decomp->prtt);
+		memcpy(&decomp->crc_engine, engine, sizeof(struct rohc_crc_engine));
 	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "CRC engine set: %s CRC-3/7/8, %s FCS-32",
+	           (decomp->crc_engine.crc_calc != NULL ? "callback" : "tables"),
+	           (decomp->crc_engine.fcs32_calc != NULL ? "callback" : "tables"));
 
 	return true;
 
@@ -3103,41 +6861,103 @@ error:
 
 
 /**
- * @brief Get the number of packets sent during one Round-Trip Time (RTT).
+ * @brief Set the callbacks used to allocate the memory of the contexts
  *
- * Get the maximum number of packets sent in worst case by the remote ROHC
- * compressor for one given stream (ie. one compression/decompression context)
- * during one Round-Trip Time (RTT).
+ * By default, the decompression contexts are carved from slabs that the
+ * decompressor allocates as needed and keeps until it is destroyed. Those
+ * slabs are cache-aligned and are not shared with other decompressors, so the
+ * creation and destruction of contexts do not hit the system allocator once
+ * the slabs are allocated. The W-LSB windows and list tables of the contexts,
+ * and the RRU buffer for segmentation are allocated the same way.
  *
- * The number of packets sent by the remote ROHC compressor is used to estimate
- * how many SN bits those feedbacks shall transmit to avoid any ambiguity at
- * compressor about the ROHC packet that is (n)acknowledged by the decompressor.
+ * Set user-defined callbacks to provide that memory from another allocator
+ * instead, eg. a per-core memory pool of the application. Give NULL for both
+ * callbacks to go back to the default slabs.
  *
- * The pRTT value must be in range [0 ; SIZE_MAX/2[. If set to 0, all SN bits
- * are always transmitted.
+ * Deployments with many large CIDs may also carve the contexts from one
+ * contiguous arena mapped on huge pages, and on the NUMA node of the core
+ * that runs the decompressor, to limit the TLB misses on context lookup:
+ * every context is requested through the callbacks, with the same size for
+ * all the contexts of one profile.
  *
- * The default value is 50 packets / RTT, ie. a RTT of 1 second with one packet
- * transmitted every 20 milliseconds (classic VoIP stream). If your network
- * streams and conditions differ, change the default value.
+ * The callbacks cannot be changed once a context was created. The RRU buffer
+ * set by \ref rohc_decomp_set_mrru before is moved to the new allocator.
  *
  * @param decomp     The ROHC decompressor
- * @param[out] prtt  The number of packets sent during one RTT
- * @return           true if pRTT was successfully retrieved, false otherwise
+ * @param alloc_cb   The callback to allocate memory, or NULL
+ * @param free_cb    The callback to free memory, or NULL
+ * @param priv_ctxt  The private context given to the callbacks, may be NULL
+ * @return           true if the callbacks were set, false otherwise
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_set_prtt
- * @see rohc_decompress3
+ * @see rohc_mem_alloc_cb_t
+ * @see rohc_mem_free_cb_t
  */
-bool rohc_decomp_get_prtt(const struct rohc_decomp *const decomp,
-                          size_t *const prtt)
+bool rohc_decomp_set_mem_cbs(struct rohc_decomp *const decomp,
+                             rohc_mem_alloc_cb_t alloc_cb,
+                             rohc_mem_free_cb_t free_cb,
+                             void *const priv_ctxt)
 {
-	if(decomp == NULL || prtt == NULL)
+	struct rohc_mempool new_mempool;
+
+	rohc_mempool_init(&new_mempool);
+
+	/* decompressor must be valid */
+	if(decomp == NULL)
 	{
+		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
 
-	*prtt = decomp->prtt;
+	/* the memory of existing contexts would be freed with the wrong callbacks */
+	if(decomp->num_contexts_used > 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "memory callbacks cannot be changed after the creation "
+		             "of contexts");
+		goto error;
+	}
+
+	/* the new allocator keeps the memory budget */
+	rohc_mempool_set_budget(&new_mempool, decomp->mempool.budget);
+	new_mempool.refused_nr = decomp->mempool.refused_nr;
+
+	if(!rohc_mempool_set_cbs(&new_mempool, alloc_cb, free_cb, priv_ctxt))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to set memory callbacks: both callbacks shall be "
+		             "NULL or non-NULL");
+		goto error;
+	}
+
+	/* move the RRU buffer to the new allocator */
+	if(decomp->rru != NULL)
+	{
+		uint8_t *const new_rru_buf = rohc_mempool_alloc(&new_mempool, decomp->mrru);
+		if(new_rru_buf == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to set memory callbacks: failed to allocate "
+			             "%zu bytes of memory for MRRU buffer", decomp->mrru);
+			rohc_mempool_free(&new_mempool);
+			goto error;
+		}
+		memcpy(new_rru_buf, decomp->rru, decomp->mrru);
+		rohc_mempool_release(&decomp->mempool, decomp->rru, decomp->mrru);
+		decomp->rru = new_rru_buf;
+	}
+
+	rohc_mempool_free(&decomp->mempool);
+	decomp->mempool = new_mempool;
+
+	/* the decompressor does not use the memory of its channel set any more */
+	if(decomp->channel_set != NULL)
+	{
+		rohc_channel_set_leave(decomp->channel_set);
+		decomp->channel_set = NULL;
+	}
+
 	return true;
 
 error:
@@ -3146,73 +6966,42 @@ error:
 
 
 /**
- * @brief Set the rate limits for feedbacks
- *
- * Set the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
- * and STATIC-NACK).
- *
- * There are 3 different rate limits:
- *  \li the rate limit to avoid sending the same type of feedback too often:
- *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
- *      specified by the parameters \e k and \e n ;
- *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
- *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
- *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
- *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
- *
- * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
- * 3 ratios of packets:
- *  \li a feedback is sent every \e k packets out of \e n packets that cause
- *      the same feedback type to be sent ;
- *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
- *      because of a CRC failure in the Full Context state ;
- *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
- *      failed because of a CRC failure in the Static Context state ;
- *
- * The default values are:
- *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
- *  \li k_1 = 30 and n_1 = 100, ie. 30%
- *  \li k_2 = 30 and n_2 = 100, ie. 30%
- *
- * If your network streams and conditions differ, change the default value.
- *
- * The n/n_1/n_2 values shall not be zero.
+ * @brief Preallocate all the memory that the decompressor needs
+ *
+ * Allocate once all the memory that the decompressor may need after setup
+ * for its contexts, their lists and its RRU buffer. Neither the
+ * decompression of packets, nor the creation of feedback, nor the creation
+ * and the release of contexts call the system allocator afterwards.
+ *
+ * The memory is sized from the memory budget set by
+ * \ref rohc_decomp_set_mem_budget if any, from the maximum number of contexts
+ * otherwise. Set a budget for decompressors with many large CIDs. Beyond that
+ * memory, new contexts are refused as if the budget was exceeded. If the
+ * library was built with the check of the allocations
+ * (\e --enable-rohc-alloc-check), the program is aborted instead, so that
+ * tests may prove that the preallocated memory is large enough.
+ *
+ * The memory cannot be preallocated once a context was created, nor with
+ * memory callbacks: setting memory callbacks or a set of channels afterwards
+ * gives the preallocated memory back. The RRU buffer set by
+ * \ref rohc_decomp_set_mrru before is moved to the preallocated memory. The
+ * configuration functions called afterwards may still allocate memory.
  *
  * @param decomp  The ROHC decompressor
- * @param k       The k rate-limit parameter to avoid sending feedback too often
- * @param n       The n rate-limit parameter to avoid sending feedback too often
- * @param k_1     The k_1 rate-limit parameter to avoid sending NACKs too quickly
- * @param n_1     The n_1 rate-limit parameter to avoid sending NACKs too quickly
- * @param k_2     The k_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
- * @param n_2     The n_2 rate-limit parameter to avoid sending STATIC-NACKs too quickly
- * @return        true if the new values were successfully set, false otherwise
+ * @return        true if the memory was preallocated, false otherwise
  *
  * @ingroup rohc_decomp
  *
- * \par Example:
- * \snippet test_lost_packet.c define ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_lost_packet.c create ROHC decompressor
- * \code
-        ...
-\endcode
- * \snippet test_lost_packet.c set decompressor rate limits
- * \code
-        ...
-\endcode
- *
- * @see rohc_decomp_get_rate_limits
- * @see rohc_decomp_set_prtt
- * @see rohc_decomp_get_prtt
- * @see rohc_decompress3
+ * @see rohc_decomp_set_mem_budget
+ * @see rohc_decomp_get_mem_info
  */
-bool rohc_decomp_set_rate_limits(struct rohc_decomp *const decomp,
-                                 const size_t k, const size_t n,
-                                 const size_t k_1, const size_t n_1,
-                                 const size_t k_2, const size_t n_2)
+bool rohc_decomp_preallocate(struct rohc_decomp *const decomp)
 {
+	struct rohc_mempool new_mempool;
+	size_t objs_len;
+
+	rohc_mempool_init(&new_mempool);
+
 	/* decompressor must be valid */
 	if(decomp == NULL)
 	{
@@ -3220,38 +7009,68 @@ bool rohc_decomp_set_rate_limits(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	/* n values are used as divisors */
-	if(n == 0 || n_1 == 0 || n_2 == 0)
+	/* the memory of existing contexts shall not move */
+	if(decomp->num_contexts_used > 0)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "rate-limits n/n_1/n_2 shall not be 0");
+		             "memory cannot be preallocated after the creation of "
+		             "contexts");
+		goto error;
+	}
+	if(decomp->mempool.alloc_cb != NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "memory cannot be preallocated with memory callbacks or "
+		             "in a set of channels");
 		goto error;
 	}
 
-	/* set new rate-limits */
-	decomp->ack_rate_limits.speed.k = k;
-	decomp->ack_rate_limits.speed.n = n;
-	decomp->ack_rate_limits.nack.k = k_1;
-	decomp->ack_rate_limits.nack.n = n_1;
-	decomp->ack_rate_limits.static_nack.k = k_2;
-	decomp->ack_rate_limits.static_nack.n = n_2;
+	/* the contexts and the RRU buffer */
+	if(decomp->mempool.budget > 0)
+	{
+		objs_len = decomp->mempool.budget;
+	}
+	else
+	{
+		objs_len = (decomp->medium.max_cid + 1) * ROHC_DECOMP_PREALLOC_CTXT_LEN +
+		           decomp->mrru;
+	}
 
-	/* compute the rate-limit thresholds */
-	decomp->ack_rate_limits.speed.threshold =
-		decomp->ack_rate_limits.speed.k * 32 * 100 / decomp->ack_rate_limits.speed.n;
-	decomp->ack_rate_limits.nack.threshold =
-		decomp->ack_rate_limits.nack.k * 32 * 100 / decomp->ack_rate_limits.nack.n;
-	decomp->ack_rate_limits.static_nack.threshold =
-		decomp->ack_rate_limits.static_nack.k * 32 * 100 /
-		decomp->ack_rate_limits.static_nack.n;
+	/* the new allocator keeps the memory budget */
+	rohc_mempool_set_budget(&new_mempool, decomp->mempool.budget);
+	new_mempool.refused_nr = decomp->mempool.refused_nr;
 
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "rate-limits are now set to: %zu/%zu (all), %zu/%zu (NACK), "
-	           "%zu/%zu (STATIC-NACK)",
-	           decomp->ack_rate_limits.speed.k, decomp->ack_rate_limits.speed.n,
-	           decomp->ack_rate_limits.nack.k, decomp->ack_rate_limits.nack.n,
-	           decomp->ack_rate_limits.static_nack.k,
-	           decomp->ack_rate_limits.static_nack.n);
+	if(!rohc_mempool_prealloc(&new_mempool, objs_len))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to preallocate memory for %zu bytes of contexts",
+		             objs_len);
+		goto error;
+	}
+
+	/* move the RRU buffer to the preallocated memory */
+	if(decomp->rru != NULL)
+	{
+		uint8_t *const new_rru_buf = rohc_mempool_alloc(&new_mempool, decomp->mrru);
+		if(new_rru_buf == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to preallocate memory: failed to allocate "
+			             "%zu bytes of memory for MRRU buffer", decomp->mrru);
+			rohc_mempool_free(&new_mempool);
+			goto error;
+		}
+		memcpy(new_rru_buf, decomp->rru, decomp->mrru);
+		rohc_mempool_release(&decomp->mempool, decomp->rru, decomp->mrru);
+		decomp->rru = new_rru_buf;
+	}
+
+	rohc_mempool_free(&decomp->mempool);
+	decomp->mempool = new_mempool;
+
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "%zu bytes of "
+	          "memory preallocated for %zu contexts", new_mempool.arena_len,
+	          (size_t) (decomp->medium.max_cid + 1));
 
 	return true;
 
@@ -3261,72 +7080,47 @@ error:
 
 
 /**
- * @brief Get the rate limits for feedbacks currently configured
- *
- * Get the rate limits for positive feedbacks (ACK) and negative feedbacks (NACK
- * and STATIC-NACK).
- *
- * There are 3 different rate limits:
- *  \li the rate limit to avoid sending the same type of feedback too often:
- *      it applies to all feedback types (ACK, NACK, STATIC-NACK) and it is
- *      specified by the parameters \e k and \e n ;
- *  \li the rate limit to avoid sending NACKs too quickly after a sporadic CRC
- *      failure: it is specified by the parameters \e k_1 and \e n_1 ;
- *  \li the rate limit to avoid sending STATIC-NACKs too quickly after a sporadic
- *      CRC failure: it is specified by the parameters \e k_2 and \e n_2 ;
- *
- * In all 3 cases above, the \e k/k_1/k_2 and \e n/n_1/n_2 parameters define
- * 3 ratios of packets:
- *  \li a feedback is sent every \e k packets out of \e n packets that cause
- *      the same feedback type to be sent ;
- *  \li a NACK is not sent before \e k_1 packets out of \e n_1 packets failed
- *      because of a CRC failure in the Full Context state ;
- *  \li a STATIC-NACK is not sent before \e k_1 packets out of \e n_1 packets
- *      failed because of a CRC failure in the Static Context state ;
+ * @brief Make the decompressor join a set of ROHC channels
  *
- * The default values are:
- *  \li k   =  1 and n   = default pRTT (see rohc_decomp_set_prtt for details)
- *  \li k_1 = 30 and n_1 = 100, ie. 30%
- *  \li k_2 = 30 and n_2 = 100, ie. 30%
+ * By default, every decompressor keeps slabs of its own for the memory of its
+ * contexts, see \ref rohc_decomp_set_mem_cbs. Once in a set of channels, the
+ * decompressor carves that memory from the slabs of the set instead, so that
+ * the memory kept by many channels with a few active flows each scales with
+ * the number of flows instead of the number of channels. The RRU buffer set by
+ * \ref rohc_decomp_set_mrru is allocated the same way.
  *
- * If your network streams and conditions differ, change the default value.
+ * The decompressor shall be used by the same thread as all the other channels
+ * of the set. Give NULL to leave the set and go back to the default slabs.
+ * Like the memory callbacks, the set cannot be changed once a context was
+ * created.
  *
- * @param decomp    The ROHC decompressor
- * @param[out] k    The k rate-limit parameter to avoid sending feedback too often
- * @param[out] n    The n rate-limit parameter to avoid sending feedback too often
- * @param[out] k_1  The k_1 rate-limit param. to avoid sending NACKs too quickly
- * @param[out] n_1  The n_1 rate-limit param. to avoid sending NACKs too quickly
- * @param[out] k_2  The k_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
- * @param[out] n_2  The n_2 rate-limit param. to avoid sending STATIC-NACKs too quickly
- * @return          true if rate-limits were successfully retrieved,
- *                  false otherwise
+ * @param decomp  The ROHC decompressor
+ * @param set     The set of channels to join, or NULL
+ * @return        true if the decompressor joined or left the set,
+ *                false otherwise
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_set_rate_limits
- * @see rohc_decomp_set_prtt
- * @see rohc_decomp_get_prtt
- * @see rohc_decompress3
+ * @see rohc_channel_set_new
+ * @see rohc_decomp_set_mem_cbs
  */
-bool rohc_decomp_get_rate_limits(const struct rohc_decomp *const decomp,
-                                 size_t *const k, size_t *const n,
-                                 size_t *const k_1, size_t *const n_1,
-                                 size_t *const k_2, size_t *const n_2)
+bool rohc_decomp_set_channel_set(struct rohc_decomp *const decomp,
+                                 struct rohc_channel_set *const set)
 {
-	if(decomp == NULL ||
-	   k == NULL || n == NULL ||
-	   k_1 == NULL || n_1 == NULL ||
-	   k_2 == NULL || n_2 == NULL)
+	const bool is_set = (set != NULL);
+
+	if(!rohc_decomp_set_mem_cbs(decomp,
+	                            is_set ? rohc_channel_set_alloc : NULL,
+	                            is_set ? rohc_channel_set_release : NULL,
+	                            set))
 	{
 		goto error;
 	}
-
-	*k = decomp->ack_rate_limits.speed.k;
-	*n = decomp->ack_rate_limits.speed.n;
-	*k_1 = decomp->ack_rate_limits.nack.k;
-	*n_1 = decomp->ack_rate_limits.nack.n;
-	*n_2 = decomp->ack_rate_limits.static_nack.n;
-	*k_2 = decomp->ack_rate_limits.static_nack.k;
+	if(is_set)
+	{
+		rohc_channel_set_join(set);
+		decomp->channel_set = set;
+	}
 
 	return true;
 
@@ -3336,50 +7130,81 @@ error:
 
 
 /**
- * @brief Enable/disable features for ROHC decompressor
+ * @brief Set the memory budget of the decompressor
  *
- * Enable/disable features for ROHC decompressor. Features control whether
- * mechanisms defined as optional by RFCs are enabled or not.
+ * Limit the memory that the decompressor allocates for its contexts, their
+ * lists, and its RRU buffer. The memory is accounted by the decompressor,
+ * see \ref rohc_decomp_get_mem_info.
  *
- * Available features are listed by \ref rohc_decomp_features_t. They may be
- * combined by XOR'ing them together.
+ * The contexts of the decompressor are chosen by the remote compressor
+ * through their CIDs, so they are never released to make room for a new
+ * context: a packet that requires a new context beyond the budget is refused
+ * with \ref ROHC_STATUS_NO_MEMORY.
  *
- * @warning Changing the feature set while library is used is not supported
+ * There is no budget by default. The budget may be changed at any time: the
+ * memory already allocated is kept even if it exceeds the new budget.
  *
- * @param decomp    The ROHC decompressor
- * @param features  The feature set to enable/disable
- * @return          true if the feature set was successfully enabled/disabled,
- *                  false if a problem occurred
+ * @param decomp  The ROHC decompressor
+ * @param budget  The maximum number of bytes to allocate, 0 for no budget
+ * @return        true in case of success, false in case of failure
  *
  * @ingroup rohc_decomp
  *
- * @see rohc_decomp_features_t
+ * @see rohc_decomp_get_mem_info
  */
-bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
-                              const rohc_decomp_features_t features)
+bool rohc_decomp_set_mem_budget(struct rohc_decomp *const decomp,
+                                const size_t budget)
 {
-	const rohc_decomp_features_t all_features =
-		ROHC_DECOMP_FEATURE_CRC_REPAIR |
-		ROHC_DECOMP_FEATURE_DUMP_PACKETS;
-
-	/* decompressor must be valid */
 	if(decomp == NULL)
 	{
-		/* cannot print a trace without a valid decompressor */
 		goto error;
 	}
 
-	/* reject unsupported features */
-	if((features & all_features) != features)
+	rohc_mempool_set_budget(&decomp->mempool, budget);
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "memory budget set to %zu bytes", budget);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the callback notified of the events of decompression contexts
+ *
+ * Set the user-defined callback function that is called every time a
+ * decompression context is created, or freed because a new context replaced
+ * it. Polling the information about the last decompressed packet is thus not
+ * required to follow the contexts.
+ *
+ * A context is created only once the first packet for it was successfully
+ * decompressed: the contexts of the packets that failed are not notified.
+ * The callback is called synchronously from the decompression function. No
+ * event is notified when the decompressor is destroyed.
+ *
+ * @param decomp     The ROHC decompressor
+ * @param callback   The callback function notified of events, NULL to stop
+ *                   notifying them
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_ctxt_event_cb_t
+ */
+bool rohc_decomp_set_ctxt_event_cb(struct rohc_decomp *const decomp,
+                                   rohc_decomp_ctxt_event_cb_t callback,
+                                   void *const priv_ctxt)
+{
+	if(decomp == NULL)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "feature set 0x%x is not supported (supported features "
-		             "set is 0x%x)", features, all_features);
 		goto error;
 	}
 
-	/* record new feature set */
-	decomp->features = features;
+	decomp->ctxt_event_cb = callback;
+	decomp->ctxt_event_cb_priv = priv_ctxt;
 
 	return true;
 
@@ -3778,6 +7603,59 @@ error:
 }
 
 
+/**
+ * @brief Set the lowest level of the traces of the decompressor
+ *
+ * The traces of lower levels are dropped before the trace callback is even
+ * called, so that they do not cost anything. By default, the traces of all
+ * levels are given to the callback set by \ref rohc_decomp_set_traces_cb2.
+ *
+ * Like the trace callback, the level cannot be modified after library
+ * initialization: the parts of the contexts that print traces on their own
+ * keep the level they were created with.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param level  The lowest level of the traces to give to the callback
+ * @return       true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_traces_cb2
+ */
+bool rohc_decomp_set_trace_level(struct rohc_decomp *const decomp,
+                                 const rohc_trace_level_t level)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* refuse to set a new trace level if decompressor is in use */
+	if(decomp->stats.received > 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace level after initialization");
+		goto error;
+	}
+
+	if(level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unexpected trace "
+		           "level %d", level);
+		goto error;
+	}
+
+	decomp->trace_level = level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /*
  * Private functions
  */
@@ -3834,7 +7712,7 @@ static const struct rohc_decomp_profile * find_profile(const struct rohc_decomp
  * @param[out] large_cid_len  The length of large CID in ROHC packet
  * @return                    true in case of success, false in case of failure
  */
-static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
+static bool rohc_decomp_decode_cid(const struct rohc_decomp *const decomp,
                                    const uint8_t *packet,
                                    unsigned int len,
                                    rohc_cid_t *const cid,
@@ -3958,6 +7836,8 @@ static void rohc_decomp_parse_padding(const struct rohc_decomp *const decomp,
  *                              \li ROHC_STATUS_NO_CONTEXT if no matching
  *                                  context was found and packet cannot create
  *                                  a new context (or failed to do so),
+ *                              \li ROHC_STATUS_NO_MEMORY if the new context
+ *                                  would exceed the memory budget,
  *                              \li ROHC_STATUS_MALFORMED if packet is
  *                                  malformed
  */
@@ -4103,6 +7983,7 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 	if(new_context_needed)
 	{
 		const struct rohc_decomp_profile *profile;
+		size_t mem_refused_nr;
 
 		/* find the profile specified in the ROHC packet */
 		profile = find_profile(decomp, *profile_id);
@@ -4117,12 +7998,17 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "create new context with CID %u and profile '%s' (0x%04x)",
 		           cid, rohc_get_profile_descr(*profile_id), *profile_id);
+		mem_refused_nr = decomp->mempool.refused_nr;
 		*context = context_create(decomp, cid, profile, arrival_time);
 		if((*context) == NULL)
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 			             "failed to create a new context with CID %u and "
 			             "profile 0x%04x", cid, *profile_id);
+			if(decomp->mempool.refused_nr != mem_refused_nr)
+			{
+				goto error_no_memory;
+			}
 			goto error_no_context;
 		}
 		*context_created = true;
@@ -4139,6 +8025,72 @@ error_malformed:
 	return ROHC_STATUS_MALFORMED;
 error_no_context:
 	return ROHC_STATUS_NO_CONTEXT;
+error_no_memory:
+	return ROHC_STATUS_NO_MEMORY;
+}
+
+
+/**
+ * @brief Drop early the packets that require a context the CID does not have
+ *
+ * Only the IR and IR-CR packets may be received for a CID that has no
+ * context, or whose context is in No Context state. Classify the packet from
+ * its first byte, and drop the other packets without identifying their
+ * profile nor their packet type. The IR-DYN packets are left to the usual
+ * path that reports them in details.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param packet       The ROHC packet, add-CID excluded
+ * @param packet_len   The length of the ROHC packet
+ * @param[out] stream  The information about the decompressed stream,
+ *                     required for sending feedback to compressor
+ * @return             Possible return values:
+ *                     \li ROHC_STATUS_OK if the packet shall be decoded,
+ *                     \li ROHC_STATUS_NO_CONTEXT if the CID has no context,
+ *                     \li ROHC_STATUS_MALFORMED if the context of the CID is
+ *                         in No Context state
+ */
+static rohc_status_t rohc_decomp_drop_early(const struct rohc_decomp *const decomp,
+                                            const uint8_t *const packet,
+                                            const size_t packet_len,
+                                            struct rohc_decomp_stream *const stream)
+{
+	struct rohc_decomp_ctxt *const context = decomp->contexts[stream->cid];
+	const struct rohc_decomp_profile *profile;
+
+	if(packet_len < 1 ||
+	   rohc_decomp_packet_is_ir(packet, packet_len) ||
+	   rohc_decomp_packet_is_irdyn(packet, packet_len))
+	{
+		return ROHC_STATUS_OK;
+	}
+
+	if(context == NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "CID %u: drop non-IR packet for unknown context", stream->cid);
+		return ROHC_STATUS_NO_CONTEXT;
+	}
+	else if(context->state != ROHC_DECOMP_STATE_NC)
+	{
+		return ROHC_STATUS_OK;
+	}
+
+	/* collect the information for sending feedback to compressor */
+	profile = rohc_decomp_ctxt_profile(context);
+	stream->profile_id = profile->id;
+	stream->context_found = true;
+	stream->context = context;
+	stream->mode = context->mode;
+	stream->state = context->state;
+	stream->sn_bits = profile->get_sn(context);
+	stream->sn_bits_nr = rohc_min(decomp->sn_feedback_min_bits,
+	                              profile->msn_max_bits);
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, profile->id,
+	           "CID %u: drop non-IR packet for context in No Context state",
+	           stream->cid);
+
+	return ROHC_STATUS_MALFORMED;
 }
 
 
@@ -4147,16 +8099,22 @@ error_no_context:
  *
  * @param decomp              The ROHC decompressor
  * @param rohc_data           The ROHC data to parse for feedback items
+ * @param ring                The feedback ring to push the parsed feedback
+ *                            items in, may be NULL
  * @param[out] feedbacks      The parsed feedback items, may be NULL if one
  *                            don't want to retrieve the feedback items
+ * @param[out] feedbacks_nr   The number of parsed feedback items, may be
+ *                            NULL
  * @return                    true if parsing of feedback items is successful,
  *                            false if at least one feedback is malformed
  */
-static bool rohc_decomp_parse_feedbacks(struct rohc_decomp *const decomp,
+static bool rohc_decomp_parse_feedbacks(const struct rohc_decomp *const decomp,
                                         struct rohc_buf *const rohc_data,
-                                        struct rohc_buf *const feedbacks)
+                                        struct rohc_feedback_ring *const ring,
+                                        struct rohc_buf *const feedbacks,
+                                        size_t *const feedbacks_nr)
 {
-	size_t feedbacks_nr = 0;
+	size_t items_nr = 0;
 	size_t feedbacks_full_len = 0; /* full feedbacks length */
 	size_t feedbacks_len = 0;      /* maybe truncated feedbacks length */
 
@@ -4169,17 +8127,18 @@ static bool rohc_decomp_parse_feedbacks(struct rohc_decomp *const decomp,
 	{
 		size_t feedback_len = 0;
 
-		feedbacks_nr++;
+		items_nr++;
 
 		/* decode one feedback packet */
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "parse feedback item #%zu at offset %zu in ROHC packet",
-		           feedbacks_nr, feedbacks_full_len);
-		if(!rohc_decomp_parse_feedback(decomp, rohc_data, feedbacks, &feedback_len))
+		           items_nr, feedbacks_full_len);
+		if(!rohc_decomp_parse_feedback(decomp, rohc_data, ring, feedbacks,
+	                               &feedback_len))
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 			             "failed to parse feedback item #%zu at offset %zu in "
-			             "ROHC packet", feedbacks_nr, feedbacks_full_len);
+			             "ROHC packet", items_nr, feedbacks_full_len);
 			goto error;
 		}
 		feedbacks_full_len += feedback_len;
@@ -4192,6 +8151,11 @@ static bool rohc_decomp_parse_feedbacks(struct rohc_decomp *const decomp,
 		}
 	}
 
+	if(feedbacks_nr != NULL)
+	{
+		*feedbacks_nr = items_nr;
+	}
+
 	/* unhide all feedbacks */
 	if(feedbacks != NULL)
 	{
@@ -4210,6 +8174,9 @@ error:
  *
  * @param decomp             The ROHC decompressor
  * @param rohc_data          The ROHC data to parse for one feedback item
+ * @param ring               The feedback ring to push the feedback item in,
+ *                           may be NULL; the feedback item is stored in the
+ *                           feedback buffer if the ring is full
  * @param[out] feedback      The retrieved feedback (header and data included),
  *                           may be NULL if one don't want to retrieve the
  *                           feedback item
@@ -4218,8 +8185,9 @@ error:
  * @return                   true if feedback parsing was successful,
  *                           false if feedback is malformed
  */
-static bool rohc_decomp_parse_feedback(struct rohc_decomp *const decomp,
+static bool rohc_decomp_parse_feedback(const struct rohc_decomp *const decomp,
                                        struct rohc_buf *const rohc_data,
+                                       struct rohc_feedback_ring *const ring,
                                        struct rohc_buf *const feedback,
                                        size_t *const feedback_len)
 {
@@ -4250,6 +8218,27 @@ static bool rohc_decomp_parse_feedback(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
+	/* push the feedback item in the ring for the same-side compressor */
+	if(ring != NULL)
+	{
+		struct rohc_feedback_ring_slot *const slot =
+			rohc_feedback_ring_reserve(ring);
+
+		if(slot != NULL)
+		{
+			assert((*feedback_len) <= ROHC_FEEDBACK_RING_ITEM_MAX_LEN);
+			memcpy(slot->data, rohc_buf_data(*rohc_data), *feedback_len);
+			slot->len = *feedback_len;
+			slot->is_rcvd = true;
+			rohc_feedback_ring_commit(ring);
+			rohc_buf_pull(rohc_data, *feedback_len);
+			return true;
+		}
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "feedback ring is full, store the feedback into the buffer "
+		           "given by the user");
+	}
+
 	/* copy the feedback item in order to return it user if he/she asked for */
 	if(feedback != NULL)
 	{
@@ -4298,9 +8287,416 @@ static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
 		             "cannot allocate memory for the contexts");
 		return false;
 	}
+
+	/* allocate memory for the token buckets of the STATIC-NACKs */
+	decomp->nack_buckets = calloc(max_cid + 1, sizeof(struct rohc_decomp_nack_bucket));
+	if(decomp->nack_buckets == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot allocate memory for the STATIC-NACK token buckets");
+		zfree(decomp->contexts);
+		return false;
+	}
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "room for %u decompression contexts created", max_cid + 1);
 
 	return true;
 }
 
+
+/**
+ * @brief Start a new train of TCP segments with the given packet
+ *
+ * @param[out] train   The train of TCP segments
+ * @param idx          The index of the packet in the burst
+ * @param uncomp_pkt   The decompressed packet
+ * @param info         The information about the decompressed packet
+ * @return             true if the train was started,
+ *                     false if the packet cannot be coalesced
+ */
+static bool rohc_decomp_gro_start(struct rohc_decomp_gro_train *const train,
+                                  const size_t idx,
+                                  const struct rohc_buf uncomp_pkt,
+                                  const struct rohc_decomp_pkt_info *const info)
+{
+	const uint8_t *const pkt = rohc_buf_data(uncomp_pkt);
+	const struct tcphdr *tcp;
+
+	if(info->profile_id != ROHCv1_PROFILE_IP_TCP ||
+	   uncomp_pkt.len < sizeof(struct ipv4_hdr))
+	{
+		goto error;
+	}
+
+	/* one IPv4 header without options nor fragmentation, or one IPv6 header
+	 * without extension headers */
+	if((pkt[0] >> 4) == IPV4)
+	{
+		const struct ipv4_hdr *const ipv4 = (const struct ipv4_hdr *) pkt;
+
+		if(ipv4->ihl != 5 || ipv4->protocol != ROHC_IPPROTO_TCP ||
+		   (rohc_ntoh16(ipv4->frag_off) & (IPV4_MF | IPV4_OFFMASK)) != 0 ||
+		   rohc_ntoh16(ipv4->tot_len) != uncomp_pkt.len)
+		{
+			goto error;
+		}
+		train->is_ipv6 = false;
+		train->tcp_off = sizeof(struct ipv4_hdr);
+		train->next_ip_id = rohc_ntoh16(ipv4->id) + 1;
+	}
+	else if((pkt[0] >> 4) == IPV6 && uncomp_pkt.len >= sizeof(struct ipv6_hdr))
+	{
+		const struct ipv6_hdr *const ipv6 = (const struct ipv6_hdr *) pkt;
+
+		if(ipv6->nh != ROHC_IPPROTO_TCP ||
+		   (rohc_ntoh16(ipv6->plen) + sizeof(struct ipv6_hdr)) != uncomp_pkt.len)
+		{
+			goto error;
+		}
+		train->is_ipv6 = true;
+		train->tcp_off = sizeof(struct ipv6_hdr);
+		train->next_ip_id = 0;
+	}
+	else
+	{
+		goto error;
+	}
+
+	/* the TCP header with some payload, neither SYN, RST nor URG */
+	if(uncomp_pkt.len < (train->tcp_off + sizeof(struct tcphdr)))
+	{
+		goto error;
+	}
+	tcp = (const struct tcphdr *) (pkt + train->tcp_off);
+	train->hdr_len = train->tcp_off + tcp->data_offset * 4;
+	if(tcp->data_offset < 5 || train->hdr_len >= uncomp_pkt.len ||
+	   (tcp->rsf_flags & (RSF_SYN_ONLY | RSF_RST_ONLY)) != 0 || tcp->urg_flag)
+	{
+		goto error;
+	}
+
+	train->head = idx;
+	train->segs_nr = 1;
+	train->cid = info->cid;
+	train->gso_size = uncomp_pkt.len - train->hdr_len;
+	train->payload_len = train->gso_size;
+	train->payload_sum = rohc_decomp_gro_payload_sum(train, pkt, uncomp_pkt.len);
+	train->next_seq = rohc_ntoh32(tcp->seq_num) + train->gso_size;
+	train->last_flags = pkt[train->tcp_off + 13] & 0x09; /* PSH and FIN */
+	train->is_closed = (train->last_flags != 0);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Append the given packet to the given train of TCP segments
+ *
+ * @param[in,out] train     The train of TCP segments
+ * @param[in,out] head_pkt  The first packet of the train
+ * @param uncomp_pkt        The decompressed packet to append
+ * @param info              The information about the decompressed packet
+ * @return                  true if the packet was appended,
+ *                          false if the packet cannot be appended
+ */
+static bool rohc_decomp_gro_append(struct rohc_decomp_gro_train *const train,
+                                   struct rohc_buf *const head_pkt,
+                                   const struct rohc_buf uncomp_pkt,
+                                   const struct rohc_decomp_pkt_info *const info)
+{
+	const uint8_t *const head = rohc_buf_data(*head_pkt);
+	const uint8_t *const pkt = rohc_buf_data(uncomp_pkt);
+	const size_t tcp_off = train->tcp_off;
+	const struct tcphdr *const tcp = (const struct tcphdr *) (pkt + tcp_off);
+	const uint8_t head_flags = head[tcp_off + 13];
+	const uint8_t flags = pkt[tcp_off + 13];
+	size_t payload_len;
+	uint32_t payload_sum;
+
+	if(train->is_closed || info->cid != train->cid ||
+	   info->profile_id != ROHCv1_PROFILE_IP_TCP ||
+	   uncomp_pkt.len <= train->hdr_len)
+	{
+		goto error;
+	}
+	payload_len = uncomp_pkt.len - train->hdr_len;
+	if(payload_len > train->gso_size ||
+	   (head_pkt->len + payload_len) > (head_pkt->max_len - head_pkt->offset) ||
+	   (head_pkt->len + payload_len - (train->is_ipv6 ? tcp_off : 0)) > 0xffff)
+	{
+		goto error;
+	}
+
+	/* the same IP header but the lengths, the IP-ID and the checksum */
+	if(train->is_ipv6)
+	{
+		if(memcmp(pkt, head, 4) != 0 ||
+		   memcmp(pkt + 6, head + 6, tcp_off - 6) != 0 ||
+		   (rohc_ntoh16(((const struct ipv6_hdr *) pkt)->plen) + tcp_off) !=
+		   uncomp_pkt.len)
+		{
+			goto error;
+		}
+	}
+	else
+	{
+		const struct ipv4_hdr *const ipv4 = (const struct ipv4_hdr *) pkt;
+
+		if(memcmp(pkt, head, 2) != 0 ||
+		   memcmp(pkt + 6, head + 6, 4) != 0 ||
+		   memcmp(pkt + 12, head + 12, tcp_off - 12) != 0 ||
+		   rohc_ntoh16(ipv4->tot_len) != uncomp_pkt.len ||
+		   rohc_ntoh16(ipv4->id) != train->next_ip_id)
+		{
+			goto error;
+		}
+	}
+
+	/* the same TCP header but the sequence number, some flags and the
+	 * checksum */
+	if(memcmp(pkt + tcp_off, head + tcp_off, 4) != 0 ||
+	   memcmp(pkt + tcp_off + 8, head + tcp_off + 8, 5) != 0 ||
+	   memcmp(pkt + tcp_off + 14, head + tcp_off + 14, 2) != 0 ||
+	   memcmp(pkt + tcp_off + 18, head + tcp_off + 18,
+	          train->hdr_len - tcp_off - 18) != 0 ||
+	   (flags & ~0x09) != (head_flags & ~0x89) || /* CWR for the head only */
+	   rohc_ntoh32(tcp->seq_num) != train->next_seq)
+	{
+		goto error;
+	}
+
+	/* append the payload */
+	payload_sum = rohc_decomp_gro_payload_sum(train, pkt, uncomp_pkt.len);
+	if((train->payload_len % 2) != 0)
+	{
+		payload_sum = swab16(rohc_decomp_gro_csum_fold(payload_sum));
+	}
+	memcpy(rohc_buf_data(*head_pkt) + head_pkt->len, pkt + train->hdr_len,
+	       payload_len);
+	head_pkt->len += payload_len;
+	train->segs_nr++;
+	train->payload_len += payload_len;
+	train->payload_sum =
+		rohc_decomp_gro_csum_fold(train->payload_sum) + payload_sum;
+	train->next_seq += payload_len;
+	train->next_ip_id++;
+	train->last_flags = flags & 0x09; /* PSH and FIN */
+	train->is_closed = (train->last_flags != 0 || payload_len < train->gso_size);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Close the given train of TCP segments
+ *
+ * Update the headers of the first packet of the train for the coalesced
+ * packet, and report about it.
+ *
+ * @param[in,out] train     The train of TCP segments
+ * @param[in,out] head_pkt  The first packet of the train
+ * @param[out] gro_info     The GRO information about the first packet
+ */
+static void rohc_decomp_gro_close(struct rohc_decomp_gro_train *const train,
+                                  struct rohc_buf *const head_pkt,
+                                  struct rohc_decomp_gro_info *const gro_info)
+{
+	uint8_t *const pkt = rohc_buf_data(*head_pkt);
+	struct tcphdr *const tcp = (struct tcphdr *) (pkt + train->tcp_off);
+	uint32_t sum;
+
+	if(train->segs_nr > 1)
+	{
+		/* the lengths of the coalesced packet */
+		if(train->is_ipv6)
+		{
+			struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) pkt;
+			ipv6->plen = rohc_hton16(head_pkt->len - train->tcp_off);
+		}
+		else
+		{
+			struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) pkt;
+			ipv4->tot_len = rohc_hton16(head_pkt->len);
+			ipv4->check = 0;
+			ipv4->check = ip_fast_csum(pkt, ipv4->ihl);
+		}
+
+		/* the flags of the last segment, then the TCP checksum of the
+		 * coalesced packet from the checksums of the payloads */
+		pkt[train->tcp_off + 13] |= train->last_flags;
+		tcp->checksum = 0;
+		sum = rohc_decomp_gro_pseudo_sum(train, pkt, head_pkt->len);
+		sum = ip_csum_partial(sum, pkt + train->tcp_off,
+		                      train->hdr_len - train->tcp_off);
+		sum = rohc_decomp_gro_csum_fold(sum) +
+		      rohc_decomp_gro_csum_fold(train->payload_sum);
+		tcp->checksum = rohc_hton16(~rohc_decomp_gro_csum_fold(sum) & 0xffff);
+
+		gro_info->segs_nr = train->segs_nr;
+		gro_info->gso_size = train->gso_size;
+		gro_info->hdr_len = train->hdr_len;
+		gro_info->tcp_offset = train->tcp_off;
+		gro_info->is_ipv6 = train->is_ipv6;
+	}
+
+	train->segs_nr = 0;
+}
+
+
+/**
+ * @brief Compute the checksum of the payload of one TCP segment
+ *
+ * The checksum of the payload is derived from the TCP checksum of the
+ * segment, so that the payload is not read.
+ *
+ * @param train    The train of TCP segments
+ * @param pkt      The TCP segment
+ * @param pkt_len  The length of the TCP segment
+ * @return         The checksum of the payload, not folded
+ */
+static uint32_t rohc_decomp_gro_payload_sum(const struct rohc_decomp_gro_train *const train,
+                                            const uint8_t *const pkt,
+                                            const size_t pkt_len)
+{
+	uint32_t sum;
+
+	/* the checksum of the pseudo-header, of the TCP header with its checksum
+	 * and of the payload is zero: the checksum of the payload is the
+	 * complement of the other ones */
+	sum = rohc_decomp_gro_pseudo_sum(train, pkt, pkt_len);
+	sum = ip_csum_partial(sum, pkt + train->tcp_off,
+	                      train->hdr_len - train->tcp_off);
+
+	return (~rohc_decomp_gro_csum_fold(sum) & 0xffff);
+}
+
+
+/**
+ * @brief Compute the checksum of the TCP pseudo-header of one packet
+ *
+ * @param train    The train of TCP segments
+ * @param pkt      The IP/TCP packet
+ * @param pkt_len  The length of the IP/TCP packet
+ * @return         The checksum of the pseudo-header, not folded
+ */
+static uint32_t rohc_decomp_gro_pseudo_sum(const struct rohc_decomp_gro_train *const train,
+                                           const uint8_t *const pkt,
+                                           const size_t pkt_len)
+{
+	const size_t tcp_len = pkt_len - train->tcp_off;
+	uint32_t sum;
+
+	if(train->is_ipv6)
+	{
+		sum = ip_csum_partial(0, pkt + 8, 2 * sizeof(struct ipv6_addr));
+	}
+	else
+	{
+		sum = ip_csum_partial(0, pkt + 12, 2 * sizeof(uint32_t));
+	}
+
+	return (sum + ROHC_IPPROTO_TCP + (tcp_len >> 16) + (tcp_len & 0xffff));
+}
+
+
+/**
+ * @brief Fold the given Internet checksum on 16 bits
+ *
+ * @param sum  The checksum, not folded
+ * @return     The folded checksum
+ */
+static uint16_t rohc_decomp_gro_csum_fold(uint32_t sum)
+{
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+
+/**
+ * @brief Look up and prefetch the contexts of the given ROHC packets
+ *
+ * The contexts are prefetched one packet after the other with
+ * \ref rohc_decomp_prefetch. The packets with no CID, eg. the feedback-only
+ * packets and the ROHC segments, are skipped.
+ *
+ * @param decomp     The ROHC decompressor
+ * @param rohc_pkts  The ROHC packets
+ * @param pkts_nr    The number of ROHC packets
+ */
+static void rohc_decomp_burst_prefetch(const struct rohc_decomp *const decomp,
+                                       const struct rohc_buf *const rohc_pkts,
+                                       const size_t pkts_nr)
+{
+	size_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		rohc_decomp_prefetch(decomp, rohc_pkts[i]);
+	}
+}
+
+
+/**
+ * @brief Peek at the CID of the given ROHC packet, inputs being valid
+ *
+ * @param decomp                The ROHC decompressor
+ * @param rohc_packet           The ROHC packet to peek at
+ * @param[out] cid              The CID of the ROHC packet
+ * @param[out] feedback_offset  The offset of the piggybacked feedback items
+ * @param[out] feedback_len     The length of the piggybacked feedback items
+ * @return                      true if the CID was found, false otherwise
+ *
+ * @see rohc_decomp_peek_cid
+ */
+static bool rohc_decomp_peek_cid_nocheck(const struct rohc_decomp *const decomp,
+                                         const struct rohc_buf rohc_packet,
+                                         rohc_cid_t *const cid,
+                                         size_t *const feedback_offset,
+                                         size_t *const feedback_len)
+{
+	struct rohc_buf remain_rohc_data = rohc_packet;
+	size_t add_cid_len;
+	size_t large_cid_len;
+
+	/* skip padding bits if some are present */
+	rohc_decomp_parse_padding(decomp, &remain_rohc_data);
+	*feedback_offset = rohc_packet.len - remain_rohc_data.len;
+
+	/* skip feedback items if present, without retrieving them */
+	if(!rohc_decomp_parse_feedbacks(decomp, &remain_rohc_data, NULL, NULL,
+	                                NULL))
+	{
+		goto error;
+	}
+	*feedback_len = rohc_packet.len - remain_rohc_data.len - (*feedback_offset);
+
+	/* no CID in feedback-only packets nor in ROHC segments */
+	if(remain_rohc_data.len == 0 ||
+	   rohc_decomp_packet_is_segment(rohc_buf_data(remain_rohc_data)))
+	{
+		goto error;
+	}
+
+	/* decode small or large CID */
+	if(!rohc_decomp_decode_cid(decomp, rohc_buf_data(remain_rohc_data),
+	                           remain_rohc_data.len, cid, &add_cid_len,
+	                           &large_cid_len))
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
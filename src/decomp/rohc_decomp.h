@@ -164,6 +164,107 @@ typedef struct
 } __attribute__((packed)) rohc_decomp_last_packet_info_t;
 
 
+/**
+ * @brief Some information about one decompressed packet
+ *
+ * The structure is filled during the decompression of the packet by
+ * \ref rohc_decompress4, so that no extra call is required to account for
+ * every packet.
+ *
+ * The \e rcvd_feedbacks_* fields reference the feedback items piggybacked in
+ * the ROHC packet, in the memory of the ROHC packet itself. They are filled
+ * for every packet decompressed with success, feedback-only packets included.
+ * The feedback items are contiguous in the ROHC packet, so they may be given
+ * to \ref rohc_comp_deliver_feedback_burst without being copied first:
+ * \code
+	struct rohc_buf feedbacks = rohc_packet;
+	rohc_buf_pull(&feedbacks, info.rcvd_feedbacks_offset);
+	feedbacks.len = info.rcvd_feedbacks_len;
+	if(!rohc_comp_deliver_feedback_burst(comp, feedbacks))
+	...
+\endcode
+ * The decompressor copies the feedback items only if a buffer is given for
+ * them or if a ring of feedbacks is linked with it: give none of them for
+ * the zero-copy delivery. The references are valid as long as the memory of
+ * the ROHC packet is not reused.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress4
+ */
+struct rohc_decomp_pkt_info
+{
+	/** The Context ID (CID) of the context used for the packet */
+	rohc_cid_t cid;
+	/** The profile of the context used for the packet */
+	rohc_profile_t profile_id;
+	/** The type of the ROHC packet */
+	rohc_packet_t packet_type;
+	/** The state of the context once the packet is decompressed */
+	rohc_decomp_state_t context_state;
+	/** The mode of the context once the packet is decompressed */
+	rohc_mode_t context_mode;
+	/** The length (in bytes) of the ROHC header of the packet */
+	size_t hdr_len;
+	/** The length (in bytes) of the uncompressed headers of the packet */
+	size_t uncomp_hdr_len;
+	/** The number of packets possibly lost before the packet */
+	unsigned long lost_packets_nr;
+	/** The number of packets before the packet if the packet was late */
+	unsigned long misordered_packets_nr;
+	/** Whether the packet is possibly a duplicated packet */
+	bool is_duplicated;
+	/** The offset (in bytes) of the feedback items piggybacked in the ROHC
+	 *  packet, ie. the length of the padding */
+	size_t rcvd_feedbacks_offset;
+	/** The length (in bytes) of the feedback items piggybacked in the ROHC
+	 *  packet, 0 if there is no feedback */
+	size_t rcvd_feedbacks_len;
+	/** The number of feedback items piggybacked in the ROHC packet */
+	size_t rcvd_feedbacks_nr;
+	/** The Sequence Number (SN) of the packet, or the Master Sequence Number
+	 *  (MSN) for the profiles that use one */
+	uint32_t sn;
+	/** The identifier of the flow that the context of the packet follows:
+	 *  it is unique among the contexts created by the decompressor, so it
+	 *  changes whenever a new context is created for the CID */
+	unsigned long flow_id;
+};
+
+
+/**
+ * @brief Some information about one packet of a burst decompressed with GRO
+ *
+ * The structure is filled by \ref rohc_decompress_burst_gro for every packet
+ * of the burst. It gives the metadata that the host stack needs to handle a
+ * coalesced IP/TCP packet as a Generic Receive Offload (GRO) super-packet,
+ * eg. the fields of the virtio_net_hdr of a TUN interface.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress_burst_gro
+ */
+struct rohc_decomp_gro_info
+{
+	/** The number of decompressed packets in the packet: 1 if the packet was
+	 *  not coalesced with the next packets of the burst, 0 if the packet was
+	 *  coalesced in one of the previous packets of the burst */
+	size_t segs_nr;
+	/** The length (in bytes) of the payload of every coalesced segment but
+	 *  the last one, ie. the GSO size; 0 if the packet is not coalesced */
+	size_t gso_size;
+	/** The length (in bytes) of the IP and TCP headers of the coalesced
+	 *  packet; 0 if the packet is not coalesced */
+	size_t hdr_len;
+	/** The offset (in bytes) of the TCP header in the coalesced packet;
+	 *  0 if the packet is not coalesced */
+	size_t tcp_offset;
+	/** Whether the coalesced packet is an IPv6/TCP packet or an IPv4/TCP
+	 *  packet; false if the packet is not coalesced */
+	bool is_ipv6;
+};
+
+
 /**
  * @brief Some information about one decompression context
  *
@@ -221,6 +322,76 @@ typedef struct
 } __attribute__((packed)) rohc_decomp_context_info_t;
 
 
+/**
+ * @brief Some information about the memory used by the decompressor
+ *
+ * The structure is used by the \ref rohc_decomp_get_mem_info function to
+ * store the accounting of the memory allocated by the decompressor for its
+ * contexts and lists, and its RRU buffer.
+ *
+ * Versioning works as for \ref rohc_decomp_general_info_t.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_mem_info
+ * @see rohc_decomp_set_mem_budget
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The number of bytes currently allocated */
+	size_t used_bytes_nr;
+	/** The number of bytes of the slabs that the allocated bytes are carved
+	 *  from, unused if memory callbacks are set */
+	size_t slabs_bytes_nr;
+	/** The memory budget (in bytes), 0 if none */
+	size_t budget_bytes_nr;
+	/** The number of allocations refused because of the memory budget */
+	unsigned long refused_nr;
+} __attribute__((packed)) rohc_decomp_mem_info_t;
+
+
+/**
+ * @brief The record of one decompression context in use
+ *
+ * The records are exported in bulk by \ref rohc_decomp_get_contexts_info.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_contexts_info
+ */
+struct rohc_decomp_ctxt_record
+{
+	/** The Context ID (CID) of the context */
+	rohc_cid_t cid;
+	/** The profile of the context */
+	rohc_profile_t profile_id;
+	/** The state of the context */
+	rohc_decomp_state_t state;
+	/** The mode of the context */
+	rohc_mode_t mode;
+	/** The number of packets received by the context */
+	uint64_t packets_nr;
+	/** The cumulated length of the ROHC headers received (in bytes) */
+	uint64_t hdr_bytes_nr;
+	/** The cumulated length of the uncompressed headers produced (in bytes) */
+	uint64_t uncomp_hdr_bytes_nr;
+	/** The time the context was last used (in seconds) */
+	uint64_t last_used_sec;
+	/** The number of packets possibly lost before the last packet */
+	uint64_t lost_packets_nr;
+	/** The number of packets before the last packet if it was late */
+	uint64_t misordered_packets_nr;
+	/** The cumulated processing time of the packets received (in nanoseconds),
+	 *  CRC repairs included, measured only if the
+	 *  \ref ROHC_DECOMP_FEATURE_PERF_INFO feature is enabled */
+	uint64_t processing_ns;
+};
+
+
 /**
  * @brief Some general information about the decompressor
  *
@@ -282,6 +453,132 @@ typedef struct
 } __attribute__((packed)) rohc_decomp_general_info_t;
 
 
+/**
+ * @brief The phases of decompression measured by the decompressor
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_perf_info_t
+ */
+typedef enum
+{
+	/** Parse the ROHC header */
+	ROHC_DECOMP_PERF_PARSE    = 0,
+	/** Check the CRC of the IR or IR-DYN header */
+	ROHC_DECOMP_PERF_CRC      = 1,
+	/** Decode the bits extracted from the ROHC header */
+	ROHC_DECOMP_PERF_DECODE   = 2,
+	/** Build the uncompressed headers and check their CRC */
+	ROHC_DECOMP_PERF_BUILD    = 3,
+	/** Copy the payload behind the uncompressed headers */
+	ROHC_DECOMP_PERF_PAYLOAD  = 4,
+	/** Update the context with the decoded values */
+	ROHC_DECOMP_PERF_UPDATE   = 5,
+	/** The whole decompression of the packet */
+	ROHC_DECOMP_PERF_TOTAL    = 6,
+
+} rohc_decomp_perf_phase_t;
+
+/** The number of phases of decompression measured by the decompressor */
+#define ROHC_DECOMP_PERF_PHASES_NR  7U
+
+
+/**
+ * @brief The durations of the phases of decompression
+ *
+ * The structure is used by the \ref rohc_decomp_get_perf_info function to
+ * store the histograms of the durations of the phases of decompression. The
+ * durations are measured only if the \ref ROHC_DECOMP_FEATURE_PERF_INFO
+ * feature is enabled. The decoding and building phases are measured once
+ * per attempt of CRC repair. The phases of the packets that the
+ * decompressor fails to decompress are measured, but not their whole
+ * decompression.
+ *
+ * Versioning works as for \ref rohc_decomp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor and
+ *    phases.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_perf_info
+ * @see rohc_perf_histo_bucket_min
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The histograms of the durations, indexed by \ref rohc_decomp_perf_phase_t */
+	struct rohc_perf_histo phases[ROHC_DECOMP_PERF_PHASES_NR];
+} __attribute__((packed)) rohc_decomp_perf_info_t;
+
+
+/**
+ * @brief The statistics of the packets of one type decompressed with one
+ *        profile
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_stats_t
+ */
+struct rohc_decomp_pkt_stats
+{
+	/** The number of received packets, decompressed or not */
+	uint64_t packets_nr;
+	/** The cumulated length of the ROHC headers of the decompressed packets
+	 *  (in bytes) */
+	uint64_t hdr_bytes_nr;
+	/** The cumulated length of the uncompressed headers of the decompressed
+	 *  packets (in bytes) */
+	uint64_t uncomp_hdr_bytes_nr;
+	/** The number of packets that failed the CRC check */
+	uint64_t crc_failures_nr;
+	/** The number of attempts of CRC repair */
+	uint64_t crc_repairs_nr;
+	/** The cumulated durations of the phases of decompression (in
+	 *  nanoseconds), indexed by \ref rohc_decomp_perf_phase_t */
+	uint64_t phases_ns[ROHC_DECOMP_PERF_PHASES_NR];
+};
+
+
+/**
+ * @brief The statistics of the decompressor per profile and packet type
+ *
+ * The structure is used by the \ref rohc_decomp_get_stats function to store
+ * a snapshot of the statistics of the received packets, broken down by
+ * profile and by packet type: the \e pkts table is indexed by the major and
+ * minor numbers of the profile ID, then by the \ref rohc_packet_t packet
+ * type, eg.
+ * pkts[(ROHCv1_PROFILE_IP_UDP_RTP >> 8) & 0xff][ROHCv1_PROFILE_IP_UDP_RTP & 0xff][ROHC_PACKET_UO_0].
+ * The packets whose profile or packet type could not be identified are not
+ * accounted. The durations of the phases are measured only if the
+ * \ref ROHC_DECOMP_FEATURE_PERF_INFO feature is enabled, as for
+ * \ref rohc_decomp_perf_info_t. The structure is about 110 KiB large.
+ *
+ * Versioning works as for \ref rohc_decomp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor and pkts.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_stats
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The statistics of the received packets per profile and packet type */
+	struct rohc_decomp_pkt_stats
+		pkts[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1][ROHC_PACKET_MAX];
+} __attribute__((packed)) rohc_decomp_stats_t;
+
+
 /**
  * @brief The different features of the ROHC decompressor
  *
@@ -303,10 +600,117 @@ typedef enum
 	ROHC_DECOMP_FEATURE_COMPAT_1_6_x = (1 << 1),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_DECOMP_FEATURE_DUMP_PACKETS = (1 << 3),
+	/** Accumulate feedbacks until \ref rohc_decomp_flush_feedback is called */
+	ROHC_DECOMP_FEATURE_FEEDBACK_COALESCING = (1 << 4),
+	/** Reference ROHC segments instead of copying them: the buffers of the
+	 *  segments shall stay unchanged until the final segment is decompressed */
+	ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF = (1 << 5),
+	/** Measure the durations of the phases of decompression, see
+	 *  \ref rohc_decomp_get_perf_info (beware: performance impact) */
+	ROHC_DECOMP_FEATURE_PERF_INFO = (1 << 6),
+	/** Decode the RTP TS with the timer-based encoding of RFC 3095, §4.5.4,
+	 *  once the compressor transmitted TIME_STRIDE: the compressor shall enable
+	 *  \ref ROHC_COMP_FEATURE_TIMER_BASED_TS too and the \e time field of
+	 *  every ROHC packet shall be set to its arrival time */
+	ROHC_DECOMP_FEATURE_TIMER_BASED_TS = (1 << 7),
+	/** Detect the duplicates of the last packet of a context right after
+	 *  parsing, and re-emit its uncompressed headers without decoding the
+	 *  duplicates nor updating the context (useful on links with link-layer
+	 *  retransmissions) */
+	ROHC_DECOMP_FEATURE_DUP_SHORTCUT = (1 << 8),
+	/** Inspect the ROHC packets without decompressing them, eg. for passive
+	 *  monitoring taps: the contexts are followed and the packets are
+	 *  described in \ref rohc_decomp_pkt_info, but neither the uncompressed
+	 *  headers nor the payloads are rebuilt (the decompressed packets are
+	 *  empty), no feedback is built, and only the CRCs of the IR and IR-DYN
+	 *  headers are verified */
+	ROHC_DECOMP_FEATURE_INSPECT = (1 << 9),
+	/** Verify the CRCs of all the inspected packets, see
+	 *  \ref ROHC_DECOMP_FEATURE_INSPECT: the uncompressed headers are then
+	 *  built in the buffer given for the decompressed packet, the buffer
+	 *  shall be large enough for them, but the packet is still returned
+	 *  empty */
+	ROHC_DECOMP_FEATURE_INSPECT_CRC = (1 << 10),
+	/** Bound the work done for every packet, eg. to decompress within the
+	 *  fixed deadlines of a scheduler: at most one CRC repair is attempted
+	 *  per packet and the RRUs referenced from segments are copied once
+	 *  before parsing, so that no ROHC header is ever parsed twice, see
+	 *  \ref rohc_decomp_set_features for the worst-case work per packet */
+	ROHC_DECOMP_FEATURE_BOUNDED_WORK = (1 << 11),
+	/** Decompress the IPv4 fragments compressed with the IP-only profiles,
+	 *  see \ref ROHC_COMP_FEATURE_IP_FRAGMENTS: every packet of the IP-only
+	 *  contexts then carries the MF flag and the fragment offset of its
+	 *  innermost IPv4 header behind the ROHC header */
+	ROHC_DECOMP_FEATURE_IP_FRAGMENTS = (1 << 12),
 
 } rohc_decomp_features_t;
 
 
+/**
+ * @brief The events of the life of decompression contexts
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_ctxt_event_cb
+ */
+typedef enum
+{
+	/** A new context was created by a packet successfully decompressed */
+	ROHC_DECOMP_CTXT_EVENT_CREATED = 0,
+	/** A context was freed because a new context replaced it, or because
+	 *  the decompressor was reset */
+	ROHC_DECOMP_CTXT_EVENT_FREED   = 1,
+
+} rohc_decomp_ctxt_event_type_t;
+
+
+/**
+ * @brief One event of the life of a decompression context
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_ctxt_event_cb
+ */
+struct rohc_decomp_ctxt_event
+{
+	/** The type of the event */
+	rohc_decomp_ctxt_event_type_t type;
+	/** The Context ID (CID) of the context */
+	rohc_cid_t cid;
+	/** The profile of the context */
+	rohc_profile_t profile_id;
+	/** The state of the context */
+	rohc_decomp_state_t state;
+	/** The mode of the context */
+	rohc_mode_t mode;
+};
+
+
+/**
+ * @brief The prototype of the callback for the events of decompression contexts
+ *
+ * User-defined function that is called by the ROHC library every time a
+ * decompression context is created or freed. The function is called
+ * synchronously from the decompression function that caused the event, so it
+ * shall be short.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_decomp_set_ctxt_event_cb
+ *
+ * @param decomp     The ROHC decompressor
+ * @param event      The event of the decompression context
+ * @param priv_ctxt  The private context given by the user when he/she called
+ *                   the \ref rohc_decomp_set_ctxt_event_cb function, may be
+ *                   NULL
+ *
+ * @see rohc_decomp_set_ctxt_event_cb
+ * @ingroup rohc_decomp
+ */
+typedef void (*rohc_decomp_ctxt_event_cb_t)(const struct rohc_decomp *const decomp,
+                                            const struct rohc_decomp_ctxt_event *const event,
+                                            void *const priv_ctxt);
+
+
 
 /*
  * Functions related to decompressor:
@@ -319,6 +723,9 @@ struct rohc_decomp * ROHC_EXPORT rohc_decomp_new2(const rohc_cid_type_t cid_type
 
 void ROHC_EXPORT rohc_decomp_free(struct rohc_decomp *const decomp);
 
+bool ROHC_EXPORT rohc_decomp_reset(struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            const struct rohc_buf rohc_packet,
                                            struct rohc_buf *const uncomp_packet,
@@ -326,6 +733,64 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            struct rohc_buf *const feedback_send)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_decompress4(struct rohc_decomp *const decomp,
+                                           const struct rohc_buf rohc_packet,
+                                           struct rohc_buf *const uncomp_packet,
+                                           struct rohc_buf *const rcvd_feedback,
+                                           struct rohc_buf *const feedback_send,
+                                           struct rohc_decomp_pkt_info *const info)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_in_place(struct rohc_decomp *const decomp,
+                                                   struct rohc_buf *const pkt,
+                                                   struct rohc_buf *const rcvd_feedback,
+                                                   struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_chain(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf_chain rohc_chain,
+                                                struct rohc_buf *const uncomp_hdrs,
+                                                struct rohc_buf_chain *const payload,
+                                                struct rohc_buf *const rcvd_feedback,
+                                                struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decompress_burst(struct rohc_decomp *const decomp,
+                                         const struct rohc_buf *const rohc_pkts,
+                                         struct rohc_buf *const uncomp_pkts,
+                                         rohc_status_t *const statuses,
+                                         struct rohc_decomp_pkt_info *const infos,
+                                         const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decompress_burst2(struct rohc_decomp *const decomp,
+                                          const struct rohc_buf *const rohc_pkts,
+                                          struct rohc_buf *const uncomp_pkts,
+                                          struct rohc_buf *const rcvd_feedbacks,
+                                          struct rohc_buf *const feedbacks_send,
+                                          rohc_status_t *const statuses,
+                                          struct rohc_decomp_pkt_info *const infos,
+                                          const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decompress_burst_gro(struct rohc_decomp *const decomp,
+                                             const struct rohc_buf *const rohc_pkts,
+                                             struct rohc_buf *const uncomp_pkts,
+                                             rohc_status_t *const statuses,
+                                             struct rohc_decomp_gro_info *const gro_infos,
+                                             const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packet,
+                                      rohc_cid_t *const cid,
+                                      size_t *const feedback_offset,
+                                      size_t *const feedback_len)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_decomp_prefetch(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packet);
+
 
 
 /*
@@ -335,15 +800,45 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
 const char * ROHC_EXPORT rohc_decomp_get_state_descr(const rohc_decomp_state_t state)
 	__attribute__((warn_unused_result, const));
 
+bool ROHC_EXPORT rohc_decomp_get_perf_info(const struct rohc_decomp *const decomp,
+                                           rohc_decomp_perf_info_t *const info)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
                                               rohc_decomp_general_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_get_stats(const struct rohc_decomp *const decomp,
+                                       rohc_decomp_stats_t *const stats)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
                                               const rohc_cid_t cid,
                                               rohc_decomp_context_info_t *const info)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_decomp_get_contexts_info(const struct rohc_decomp *const decomp,
+                                                 struct rohc_decomp_ctxt_record *const records,
+                                                 const size_t records_max)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_save_contexts(const struct rohc_decomp *const decomp,
+                                           uint8_t *const image,
+                                           const size_t image_max_len,
+                                           size_t *const image_len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_restore_contexts(struct rohc_decomp *const decomp,
+                                              const uint8_t *const image,
+                                              const size_t image_len,
+                                              const struct rohc_ts now,
+                                              size_t *const ctxts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_mem_info(const struct rohc_decomp *const decomp,
+                                          rohc_decomp_mem_info_t *const info)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
                                                   rohc_decomp_last_packet_info_t *const info)
 	__attribute__((warn_unused_result));
@@ -397,12 +892,64 @@ bool ROHC_EXPORT rohc_decomp_get_rate_limits(const struct rohc_decomp *const dec
                                              size_t *const k_2, size_t *const n_2)
 	__attribute__((warn_unused_result));
 
+/* feedback coalescing */
+
+bool ROHC_EXPORT rohc_decomp_flush_feedback(struct rohc_decomp *const decomp,
+                                            struct rohc_buf *const feedback)
+	__attribute__((warn_unused_result));
+
+/* feedback ring for the same-side compressor */
+
+bool ROHC_EXPORT rohc_decomp_set_feedback_ring(struct rohc_decomp *const decomp,
+                                               struct rohc_feedback_ring *const ring)
+	__attribute__((warn_unused_result));
+
+/* reorder buffer */
+
+bool ROHC_EXPORT rohc_decomp_set_reorder(struct rohc_decomp *const decomp,
+                                         const size_t depth,
+                                         const size_t max_delay)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decomp_reorder_release(struct rohc_decomp *const decomp,
+                                                      const struct rohc_ts now,
+                                                      struct rohc_buf *const uncomp_packet,
+                                                      struct rohc_buf *const feedback_send,
+                                                      struct rohc_decomp_pkt_info *const info)
+	__attribute__((warn_unused_result));
+
 /* decompression library features */
 
 bool ROHC_EXPORT rohc_decomp_set_features(struct rohc_decomp *const decomp,
                                           const rohc_decomp_features_t features)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_mem_cbs(struct rohc_decomp *const decomp,
+                                         rohc_mem_alloc_cb_t alloc_cb,
+                                         rohc_mem_free_cb_t free_cb,
+                                         void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_preallocate(struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_crc_engine(struct rohc_decomp *const decomp,
+                                            const struct rohc_crc_engine *const engine)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_channel_set(struct rohc_decomp *const decomp,
+                                             struct rohc_channel_set *const set)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_mem_budget(struct rohc_decomp *const decomp,
+                                            const size_t budget)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_ctxt_event_cb(struct rohc_decomp *const decomp,
+                                               rohc_decomp_ctxt_event_cb_t callback,
+                                               void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to decompression profiles
@@ -438,6 +985,10 @@ bool ROHC_EXPORT rohc_decomp_set_traces_cb2(struct rohc_decomp *const decomp,
                                             void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_trace_level(struct rohc_decomp *const decomp,
+                                             const rohc_trace_level_t level)
+	__attribute__((warn_unused_result));
+
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
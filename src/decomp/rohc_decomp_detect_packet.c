@@ -27,6 +27,7 @@
 #include "rohc_decomp_detect_packet.h"
 #include "rohc_bit_ops.h"
 #include "rohc_internal.h"
+#include "rohc_packets.h"
 
 #include <assert.h>
 
@@ -40,6 +41,49 @@
 /** The magic byte to find out whether a ROHC packet is an IR-DYN packet */
 #define D_IR_DYN_PACKET  0xf8
 
+/* the packet types shall fit in the 8-bit entries of the detection tables */
+_Static_assert(ROHC_PACKET_MAX <= UINT8_MAX,
+               "packet types shall fit in the detection tables");
+
+
+/**
+ * @brief The RFC3095 packet types indexed by the first byte of the packet
+ *
+ * The UO-1 and UOR-2 entries stand for the whole UO-1* and UOR-2* families,
+ * the RTP profile refines them with its own tables.
+ */
+const uint8_t rohc_decomp_rfc3095_pkt_types[256] =
+{
+	[0x00 ... 0x7f] = ROHC_PACKET_UO_0,     /* 0xxxxxxx */
+	[0x80 ... 0xbf] = ROHC_PACKET_UO_1,     /* 10xxxxxx */
+	[0xc0 ... 0xdf] = ROHC_PACKET_UOR_2,    /* 110xxxxx */
+	[0xe0 ... 0xf7] = ROHC_PACKET_UNKNOWN,
+	[0xf8]          = ROHC_PACKET_IR_DYN,   /* 11111000 */
+	[0xf9 ... 0xfb] = ROHC_PACKET_UNKNOWN,
+	[0xfc ... 0xfd] = ROHC_PACKET_IR,       /* 1111110x */
+	[0xfe ... 0xff] = ROHC_PACKET_UNKNOWN,
+};
+
+
+/**
+ * @brief The ROHCv2 packet types indexed by the first byte of the packet
+ *
+ * All the ROHCv2 profiles share the same discriminators.
+ */
+const uint8_t rohc_decomp_rfc5225_pkt_types[256] =
+{
+	[0x00 ... 0x7f] = ROHC_PACKET_PT_0_CRC3,          /* 0xxxxxxx */
+	[0x80 ... 0x9f] = ROHC_PACKET_NORTP_PT_0_CRC7,    /* 100xxxxx */
+	[0xa0 ... 0xbf] = ROHC_PACKET_NORTP_PT_1_SEQ_ID,  /* 101xxxxx */
+	[0xc0 ... 0xdf] = ROHC_PACKET_NORTP_PT_2_SEQ_ID,  /* 110xxxxx */
+	[0xe0 ... 0xf9] = ROHC_PACKET_UNKNOWN,
+	[0xfa]          = ROHC_PACKET_CO_COMMON,          /* 11111010 */
+	[0xfb]          = ROHC_PACKET_CO_REPAIR,          /* 11111011 */
+	[0xfc]          = ROHC_PACKET_UNKNOWN,
+	[0xfd]          = ROHC_PACKET_IR,                 /* 11111101 */
+	[0xfe ... 0xff] = ROHC_PACKET_UNKNOWN,
+};
+
 
 /**
  * @brief Find out whether the field is a segment field or not
@@ -93,60 +137,6 @@ bool rohc_decomp_packet_is_irdyn(const uint8_t *const data, const size_t len)
 }
 
 
-/**
- * @brief Find out whether a ROHC packet is an UO-0 packet or not
- *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UO-0 packet or not
- */
-bool rohc_decomp_packet_is_uo0(const uint8_t *const data, const size_t len)
-{
-	return (len > 0 && GET_BIT_7(data) == 0);
-}
-
-
-/**
- * @brief Find out whether a ROHC packet is an UO-1* packet or not
- *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UO-1* packet or not
- */
-bool rohc_decomp_packet_is_uo1(const uint8_t *const data, const size_t len)
-{
-	return (len > 0 && GET_BIT_6_7(data) == 0x02);
-}
-
-
-/**
- * @brief Find out whether a ROHC packet is an UO-1-TS packet or not
- *
- * Check the T field that discriminates between UO-1-TS and UO-1-ID.
- *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UO-1-TS packet or not
- */
-bool rohc_decomp_packet_is_uo1_ts(const uint8_t *const data, const size_t len)
-{
-	return (len > 0 && GET_BIT_5(data) != 0);
-}
-
-
-/**
- * @brief Find out whether a ROHC packet is an UOR-2* packet or not
- *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UOR-2* packet or not
- */
-bool rohc_decomp_packet_is_uor2(const uint8_t *const data, const size_t len)
-{
-	return (len > 0 && GET_BIT_5_7(data) == 0x06);
-}
-
-
 /**
  * @brief Find out whether a ROHC packet is an UOR-2-TS packet or not
  *
@@ -32,6 +32,14 @@
 #include <stdbool.h>
 
 
+/*
+ * Packet detection tables.
+ */
+
+extern const uint8_t rohc_decomp_rfc3095_pkt_types[256];
+extern const uint8_t rohc_decomp_rfc5225_pkt_types[256];
+
+
 /*
  * Function prototypes.
  */
@@ -50,19 +58,7 @@ bool rohc_decomp_packet_is_ir(const uint8_t *const data, const size_t len)
 bool rohc_decomp_packet_is_irdyn(const uint8_t *const data, const size_t len)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
-/* UO-0 packet */
-bool rohc_decomp_packet_is_uo0(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
-
-/* UO-1* packets */
-bool rohc_decomp_packet_is_uo1(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
-bool rohc_decomp_packet_is_uo1_ts(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
-
 /* UOR-2* packets */
-bool rohc_decomp_packet_is_uor2(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
 bool rohc_decomp_packet_is_uor2_ts(const uint8_t *const data,
                                    const size_t data_len,
                                    const size_t large_cid_len)
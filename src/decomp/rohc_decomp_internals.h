@@ -32,6 +32,9 @@
 #include "rohc_traces_internal.h"
 #include "feedback_create.h"
 #include "crc.h"
+#include "rohc_mempool.h"
+#include "rohc_perf.h"
+#include "rohc_stats_seq.h"
 
 
 /*
@@ -54,7 +57,8 @@
 /** Dump a buffer for the given compression context */
 #define rohc_decomp_dump_buf(context, descr, buf, buf_len) \
 	do { \
-		if(((context)->decompressor->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0) { \
+		if(((context)->decompressor->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 && \
+		   (context)->decompressor->trace_level == ROHC_TRACE_DEBUG) { \
 			rohc_dump_buf((context)->decompressor->trace_callback, \
 			              (context)->decompressor->trace_callback_priv, \
 			              ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG, \
@@ -132,6 +136,122 @@ struct rohc_ack_stats
 };
 
 
+/** The maximum number of feedbacks the decompressor may accumulate */
+#define ROHC_DECOMP_FEEDBACKS_PENDING_MAX  64U
+
+
+/**
+ * @brief One feedback accumulated by the decompressor
+ *
+ * The feedback is kept unwrapped, it is wrapped with its CID and CRC when the
+ * accumulated feedbacks are flushed.
+ */
+struct rohc_decomp_pending_feedback
+{
+	/** The FEEDBACK-1 or FEEDBACK-2 data */
+	struct d_feedback feedback;
+	/** The CID the feedback is related to */
+	rohc_cid_t cid;
+	/** The CID type of the channel */
+	rohc_cid_type_t cid_type;
+	/** The type of acknowledgement */
+	enum rohc_feedback_ack_type ack_type;
+	/** How the feedback shall be protected by a CRC */
+	rohc_feedback_crc_t crc_present;
+};
+
+
+/** The maximum number of segments one RRU may be referenced from, an RRU
+ *  made of more segments is copied into the RRU buffer */
+#define ROHC_DECOMP_RRU_SEGS_MAX  32U
+
+/** The number of bytes at the beginning of an RRU referenced from segments
+ *  that are copied before decoding, in order to parse the ROHC header */
+#define ROHC_DECOMP_RRU_HDR_LEN  256U
+
+/** The maximum number of CRC repairs attempted for one packet when the work
+ *  per packet is bounded, see \ref ROHC_DECOMP_FEATURE_BOUNDED_WORK */
+#define ROHC_DECOMP_BOUNDED_REPAIRS_MAX  1U
+
+/** The number of packets of a burst whose contexts are looked up and
+ *  prefetched before the packets are decompressed */
+#define ROHC_DECOMP_BURST_PREFETCH_NR  16U
+
+/** The memory preallocated for every context by \ref rohc_decomp_preallocate,
+ *  the RFC 3095 contexts and their lists being the largest ones */
+#define ROHC_DECOMP_PREALLOC_CTXT_LEN  8192U
+
+
+/** The number of STATIC-NACKs one CID without usable context may send in a
+ *  row, before the token bucket that rate-limits them is empty */
+#define ROHC_DECOMP_NACK_BUCKET_BURST  4U
+
+/** The period (in milliseconds) of the refill of one token in the bucket that
+ *  rate-limits the STATIC-NACKs of one CID without usable context */
+#define ROHC_DECOMP_NACK_BUCKET_REFILL_MS  100U
+
+/** The number of packets dropped on one CID without usable context that
+ *  refill one token in its bucket when the arrival times are unknown */
+#define ROHC_DECOMP_NACK_BUCKET_REFILL_PKTS  32U
+
+
+/**
+ * @brief The token bucket that rate-limits the STATIC-NACKs of one CID
+ *
+ * The packets received for a CID that has no context or whose context is in
+ * No Context state cannot be decoded until an IR packet is received. During
+ * a restart of the remote compressor, this happens for every packet of every
+ * flow: the bucket limits the STATIC-NACKs to a short burst per CID, then to
+ * one per refill period.
+ *
+ * The bucket counts the tokens spent, so that a zeroed bucket is full.
+ */
+struct rohc_decomp_nack_bucket
+{
+	uint32_t last_refill_ms;  /**< The time of the last refill (in ms) */
+	uint8_t spent_nr;         /**< The number of tokens spent */
+	uint8_t drops_nr;         /**< The packets dropped since the last refill,
+	                               when the arrival times are unknown */
+};
+
+
+/** The maximum number of packets of one context the reorder buffer holds */
+#define ROHC_DECOMP_REORDER_DEPTH_MAX  8U
+
+/** The number of packets the reorder buffer holds for all the contexts */
+#define ROHC_DECOMP_REORDER_SLOTS_NR  32U
+
+/** The maximum length of one ROHC packet held by the reorder buffer */
+#define ROHC_DECOMP_REORDER_PKT_MAX_LEN  2048U
+
+
+/**
+ * @brief One ROHC packet held by the reorder buffer
+ *
+ * The packet arrived before some of the packets that precede it, it is held
+ * until they arrive, then decoded again against the updated context.
+ */
+struct rohc_decomp_reorder_slot
+{
+	struct rohc_ts arrival_time;  /**< The arrival time of the packet */
+	uint32_t sn;                  /**< The SN decoded from the packet */
+	rohc_cid_t cid;               /**< The CID of the packet */
+	size_t len;                   /**< The length of the packet, 0 if free */
+	/** The ROHC packet, from its first byte or its add-CID */
+	uint8_t data[ROHC_DECOMP_REORDER_PKT_MAX_LEN];
+};
+
+
+/**
+ * @brief One ROHC segment an RRU is referenced from
+ */
+struct rohc_decomp_rru_seg
+{
+	const uint8_t *data;  /**< The segment data (segment type byte excluded) */
+	size_t len;           /**< The length of the segment data */
+};
+
+
 /**
  * @brief The ROHC decompressor
  */
@@ -153,8 +273,23 @@ struct rohc_decomp
 	struct rohc_decomp_ctxt **contexts;
 	/** The number of decompression contexts in use */
 	uint16_t num_contexts_used;
+	/** The number of decompression contexts created so far, it gives every
+	 *  new context its flow identifier */
+	unsigned long flows_nr;
+	/** The most recently installed context of the list of contexts in use */
+	struct rohc_decomp_ctxt *ctxts_used_first;
 	/** The last decompression context used by the decompressor */
 	struct rohc_decomp_ctxt *last_context;
+	/** The memory pool for the decompression contexts */
+	struct rohc_mempool mempool;
+	/** The set of channels the memory pool takes its memory from, if any */
+	struct rohc_channel_set *channel_set;
+	/** The scratch memory for the bits extracted from the ROHC packet being
+	 *  decompressed, shared by all the contexts */
+	void *extr_bits;
+	/** The scratch memory for the values decoded from the ROHC packet being
+	 *  decompressed, shared by all the contexts */
+	void *decoded_values;
 
 
 	/* feedback-related variables */
@@ -169,6 +304,30 @@ struct rohc_decomp
 	uint32_t last_pkts_errors;
 	/** The information for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The token buckets that rate-limit the STATIC-NACKs of the CIDs
+	 *  without usable context, indexed by CID */
+	struct rohc_decomp_nack_bucket *nack_buckets;
+	/** The feedbacks accumulated until the next flush, at most one per CID */
+	struct rohc_decomp_pending_feedback feedbacks_pending[ROHC_DECOMP_FEEDBACKS_PENDING_MAX];
+	/** The number of feedbacks accumulated until the next flush */
+	size_t feedbacks_pending_nr;
+	/** The ring to push feedbacks in for the same-side compressor, may be NULL */
+	struct rohc_feedback_ring *feedback_ring;
+
+
+	/* reorder-related variables */
+
+	/** The packets held until the packets that precede them arrive, NULL if
+	 *  the reorder buffer is disabled */
+	struct rohc_decomp_reorder_slot *reorder_slots;
+	/** The maximum number of packets held per context, 0 if disabled */
+	size_t reorder_depth;
+	/** The maximum delay (in milliseconds) one packet is held */
+	size_t reorder_max_delay;
+	/** The number of packets held by the reorder buffer */
+	size_t reorder_held_nr;
+	/** Whether a held packet is being released */
+	bool reorder_releasing;
 
 
 	/* segment-related variables */
@@ -179,15 +338,74 @@ struct rohc_decomp
 	size_t rru_len;
 	/** The Maximum Reconstructed Reception Unit (MRRU) */
 	size_t mrru;
-
-
+	/** The segments the RRU is referenced from, none if the RRU is copied */
+	struct rohc_decomp_rru_seg rru_segs[ROHC_DECOMP_RRU_SEGS_MAX];
+	/** The number of segments the RRU is referenced from */
+	size_t rru_segs_nr;
+	/** The number of bytes of the referenced RRU copied in the RRU buffer */
+	size_t rru_copied_len;
+	/** The FCS-32 computed so far over the RRU */
+	uint32_t rru_crc;
+	/** The number of bytes of the RRU covered by the FCS-32 computed so far */
+	size_t rru_crc_len;
+
+
+	/* variables related to the decompression of chains of buffers */
+
+	/** Whether the payload of the ROHC packet being decompressed by
+	 *  \ref rohc_decompress_chain shall be referenced instead of copied */
+	bool chain_by_ref;
+	/** The length (in bytes) of the segments behind the first one of the
+	 *  chain being decompressed, 0 if the ROHC packet is contiguous */
+	size_t chain_tail_len;
+	/** The payload of the decompressed packet within the first segment of
+	 *  the chain, NULL if none */
+	const uint8_t *chain_head_payload;
+	/** The length (in bytes) of the payload within the first segment */
+	size_t chain_head_payload_len;
+
+
+	/* variables related to the statistics of the packet being decompressed */
+
+	/** The number of attempts of CRC repair for the packet */
+	size_t pkt_crc_repairs_nr;
+	/** Whether the packet was inspected with success without being
+	 *  decompressed, see \ref ROHC_DECOMP_FEATURE_INSPECT */
+	bool pkt_inspected;
+	/** The durations of the phases of decompression of the packet, indexed
+	 *  by \ref rohc_decomp_perf_phase_t */
+	uint64_t pkt_phases_ns[ROHC_DECOMP_PERF_PHASES_NR];
+
+
+	/** The sequence counter that publishes the statistics of the decompressor
+	 *  and of its contexts to other threads, odd while they are updated */
+	uint32_t stats_seq;
 	/** Some statistics about the decompression processes */
 	struct d_statistics stats;
+	/** The durations of the phases of decompression, indexed by
+	 *  \ref rohc_decomp_perf_phase_t */
+	struct rohc_perf_histo perf_histos[ROHC_DECOMP_PERF_PHASES_NR];
+	/** The statistics of the received packets, indexed by the major and
+	 *  minor numbers of their profile ID and by their packet type */
+	struct rohc_decomp_pkt_stats
+		pkt_stats[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1][ROHC_PACKET_MAX];
+
+	/** The callback function notified of the events of contexts, NULL if
+	 *  the events are not notified */
+	rohc_decomp_ctxt_event_cb_t ctxt_event_cb;
+	/** The private context of the callback function notified of events */
+	void *ctxt_event_cb_priv;
+
+	/** The engine that computes the CRCs, the tables of the library for the
+	 *  callbacks left NULL */
+	struct rohc_crc_engine crc_engine;
 
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces given to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
@@ -239,12 +457,23 @@ struct rohc_decomp_crc
 };
 
 
+/**
+ * @brief Round the length of one part of a decompression context up, so that
+ *        every part carved from the memory block of the context is aligned
+ */
+#define rohc_decomp_ctxt_part_len(len) \
+	(((size_t) (len) + 7U) & ~((size_t) 7U))
+
+
 /**
  * @brief The volatile part of the ROHC decompression context
  *
  * The volatile part of the ROHC decompression context lasts only one single
  * packet. Between two ROHC packets, the volatile part of the context is
  * erased.
+ *
+ * The extracted bits and the decoded values point to the scratch memory of
+ * the decompressor, shared by all its contexts.
  */
 struct rohc_decomp_volat_ctxt
 {
@@ -258,9 +487,64 @@ struct rohc_decomp_volat_ctxt
 	/** The profile-specific data for values decoded from persistent context
 	 * and bits extracted from the ROHC packet, defined by the profiles */
 	void *decoded_values;
+
+	/** The length (in bytes) of the compressed header of the packet, recorded
+	 *  in statistics once the packet is fully handled */
+	size_t comp_hdr_len;
+	/** The length (in bytes) of the uncompressed header of the packet,
+	 *  recorded in statistics once the packet is fully handled */
+	size_t uncomp_hdr_len;
+};
+
+
+/** The maximum length of the ROHC header recorded to detect the duplicates
+ *  of the last packet of a context */
+#define ROHC_DECOMP_DUP_ROHC_HDR_MAX_LEN  24U
+
+/** The maximum length of the uncompressed headers recorded to re-emit them
+ *  for the duplicates of the last packet of a context */
+#define ROHC_DECOMP_DUP_UNCOMP_HDRS_MAX_LEN  128U
+
+
+/**
+ * @brief The last packet of a decompression context, to detect its duplicates
+ *
+ * The ROHC header holds the SN bits and the CRC of the packet. As long as the
+ * context is not updated by another packet, the same ROHC header and the same
+ * payload length give the same uncompressed headers.
+ */
+struct rohc_decomp_dup_cache
+{
+	/** The ROHC header of the last packet, CID included */
+	uint8_t rohc_hdr[ROHC_DECOMP_DUP_ROHC_HDR_MAX_LEN];
+	/** The uncompressed headers of the last packet */
+	uint8_t uncomp_hdrs[ROHC_DECOMP_DUP_UNCOMP_HDRS_MAX_LEN];
+	/** The length of the payload of the last packet */
+	size_t payload_len;
+	/** The length of the ROHC header, 0 if no packet is recorded */
+	uint8_t rohc_hdr_len;
+	/** The length of the uncompressed headers */
+	uint8_t uncomp_hdrs_len;
 };
 
 
+/**
+ * @brief The generic part of one decompression context in a context image
+ *
+ * The statistics of the context, except the number of packets received, and
+ * the state of the corrections upon CRC failures are not saved: they are
+ * reset when the context is restored.
+ */
+struct rohc_decomp_ctxt_image
+{
+	uint8_t mode;               /**< The mode of the context */
+	uint8_t state;              /**< The state of the context */
+	uint8_t unused[2];
+	uint32_t last_pkts_errors;  /**< The errors of the last packets */
+	uint64_t num_recv_packets;  /**< The number of packets received */
+} __attribute__((packed));
+
+
 /**
  * @brief The ROHC decompression context
  */
@@ -271,6 +555,12 @@ struct rohc_decomp_ctxt
 
 	/** The associated decompressor */
 	struct rohc_decomp *decompressor;
+	/** The previous (more recently installed) context in the list of contexts
+	 *  in use */
+	struct rohc_decomp_ctxt *used_prev;
+	/** The next (less recently installed) context in the list of contexts in
+	 *  use */
+	struct rohc_decomp_ctxt *used_next;
 
 	/** The associated profile */
 	const struct rohc_decomp_profile *profile;
@@ -288,6 +578,11 @@ struct rohc_decomp_ctxt
 	unsigned int latest_used;
 	/** Usage timestamp */
 	unsigned int first_used;
+	/** The identifier of the flow followed by the context, unique among the
+	 *  contexts created by the decompressor */
+	unsigned long flow_id;
+	/** The arrival time of the ROHC packet being decompressed */
+	struct rohc_ts pkt_arrival_time;
 
 	/** Whether the last decompressed packets failed or not */
 	uint32_t last_pkts_errors;
@@ -322,6 +617,9 @@ struct rohc_decomp_ctxt
 
 	/* The number of received packets */
 	unsigned long num_recv_packets;
+	/** The cumulated processing time of the packets received (in nanoseconds),
+	 *  measured only if \ref ROHC_DECOMP_FEATURE_PERF_INFO is enabled */
+	uint64_t processing_ns;
 	/** The number of successful corrections upon CRC failure */
 	unsigned long corrected_crc_failures;
 	/** The number of successful corrections of SN wraparound upon CRC failure */
@@ -336,6 +634,10 @@ struct rohc_decomp_ctxt
 	unsigned long nr_misordered_packets;
 	/** Is last packet a (possible) duplicated packet? */
 	bool is_duplicated;
+
+	/** The last packet, to re-emit its duplicates without decoding them, see
+	 *  \ref ROHC_DECOMP_FEATURE_DUP_SHORTCUT */
+	struct rohc_decomp_dup_cache dup_cache;
 };
 
 
@@ -344,9 +646,10 @@ typedef bool (*rohc_decomp_new_context_t)(const struct rohc_decomp_ctxt *const c
                                           struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt,
+typedef void (*rohc_decomp_free_context_t)(const struct rohc_decomp_ctxt *const context,
+                                           void *const persist_ctxt,
                                            const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+	__attribute__((nonnull(1, 3)));
 
 typedef rohc_packet_t (*rohc_decomp_detect_pkt_type_t) (const struct rohc_decomp_ctxt *const context,
                                                         const uint8_t *const rohc_packet,
@@ -379,6 +682,18 @@ typedef rohc_status_t (*rohc_decomp_build_hdrs_t)(const struct rohc_decomp *cons
                                                   size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
 
+typedef bool (*rohc_decomp_decode_fast_t)(const struct rohc_decomp *const decomp,
+                                          const struct rohc_decomp_ctxt *const context,
+                                          const struct rohc_buf rohc_packet,
+                                          const size_t large_cid_len,
+                                          const rohc_packet_t packet_type,
+                                          struct rohc_decomp_crc *const extr_crc,
+                                          void *const extr_bits,
+                                          void *const decoded_values,
+                                          struct rohc_buf *const uncomp_hdrs,
+                                          size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8, 9, 10)));
+
 typedef void (*rohc_decomp_update_ctxt_t)(struct rohc_decomp_ctxt *const context,
                                           const void *const decoded_values,
                                           const size_t payload_len,
@@ -395,6 +710,9 @@ typedef bool (*rohc_decomp_attempt_repair_t)(const struct rohc_decomp *const dec
 typedef uint32_t (*rohc_decomp_get_sn_t)(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+typedef uint32_t (*rohc_decomp_get_decoded_sn_t)(const void *const decoded_values)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 
 /**
  * @brief The ROHC decompression profile.
@@ -410,12 +728,23 @@ struct rohc_decomp_profile
 	/** The maximum number of bits of the Master Sequence Number (MSN) */
 	const size_t msn_max_bits;
 
-	/** @brief The handler used to create the profile-specific part of the
-	 *         decompression context */
+	/** The length of the persistent part of the context, 0 if none */
+	const size_t persist_ctxt_len;
+	/** Whether the persistent part of the context holds no pointer, so that
+	 *  it may be saved bytewise in context images */
+	const bool persist_ctxt_is_flat;
+	/** The length of the bits extracted from one ROHC packet */
+	const size_t extr_bits_len;
+	/** The length of the values decoded from one ROHC packet */
+	const size_t decoded_values_len;
+
+	/** @brief The handler used to initialize the profile-specific parts of the
+	 *         decompression context, carved by the decompressor from the
+	 *         memory block of the context with the lengths above */
 	rohc_decomp_new_context_t new_context;
 
 	/** @brief The handler used to destroy the profile-specific part of the
-	 *         decompression context */
+	 *         decompression context, NULL if nothing but memory to release */
 	rohc_decomp_free_context_t free_context;
 
 	/** The handler used to detect the type of the ROHC packet */
@@ -430,6 +759,12 @@ struct rohc_decomp_profile
 	/* The handler used to build the uncompressed packet after decoding */
 	rohc_decomp_build_hdrs_t build_hdrs;
 
+	/* The handler used to parse, decode and build the most frequent packets of
+	 * the steady state in one single pass, NULL if none: it returns false for
+	 * the packets it does not handle, and the generic handlers above decode
+	 * them then */
+	rohc_decomp_decode_fast_t decode_fast;
+
 	/* The handler used to update the context after successful decompression */
 	rohc_decomp_update_ctxt_t update_ctxt;
 
@@ -438,6 +773,10 @@ struct rohc_decomp_profile
 
 	/* The handler used to retrieve the Sequence Number (SN) */
 	rohc_decomp_get_sn_t get_sn;
+
+	/* The handler used to retrieve the SN decoded from one packet, NULL if the
+	 * packets of the profile are not held in the reorder buffer */
+	rohc_decomp_get_decoded_sn_t get_decoded_sn;
 };
 
 #endif
@@ -230,6 +230,23 @@ static bool parse_uor2ts_once(const struct rohc_decomp_ctxt *const context,
                               size_t *const rohc_hdr_len,
                               bool *const need_reparse)
 	__attribute__((warn_unused_result, nonnull(1, 2, 8, 9, 10, 11)));
+static bool parse_uor2_rtp_variant(const struct rohc_decomp_ctxt *const context,
+                                   const uint8_t *const rohc_packet,
+                                   const size_t rohc_length,
+                                   const size_t large_cid_len,
+                                   rohc_packet_t *const packet_type,
+                                   struct rohc_decomp_crc *const extr_crc,
+                                   struct rohc_extr_bits *const bits,
+                                   size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7, 8)));
+static rohc_packet_t peek_uor2_rtp_variant(const struct rohc_decomp_ctxt *const context,
+                                           const uint8_t *const rohc_packet,
+                                           const size_t rohc_length,
+                                           const size_t large_cid_len,
+                                           const rohc_packet_t packet_type,
+                                           uint8_t *const outer_rnd,
+                                           uint8_t *const inner_rnd)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7)));
 
 static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
                                const uint8_t *const rohc_packet,
@@ -274,27 +291,30 @@ static int parse_extension2(const struct rohc_decomp_ctxt *const context,
 
 static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
                             const struct rohc_decoded_ip_values decoded,
+                            const struct rohc_decomp_rfc3095_changes *const ip_tmpl,
                             uint8_t *const dest,
                             const size_t uncomp_hdrs_max_len,
                             size_t *const uncomp_hdrs_len,
                             const size_t payload_size,
                             const struct list_decomp *const list_decomp)
-	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 4, 6)));
 static bool build_uncomp_ipv4(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_decoded_ip_values decoded,
+                              const struct rohc_decomp_rfc3095_changes *const ip_tmpl,
                               uint8_t *const dest,
                               const size_t uncomp_hdrs_max_len,
                               size_t *const uncomp_hdrs_len,
                               const size_t payload_size)
-	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 4, 6)));
 static bool build_uncomp_ipv6(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_decoded_ip_values decoded,
+                              const struct rohc_decomp_rfc3095_changes *const ip_tmpl,
                               uint8_t *const dest,
                               const size_t uncomp_hdrs_max_len,
                               size_t *const uncomp_hdrs_len,
                               const size_t payload_size,
                               const struct list_decomp *const list_decomp)
-	__attribute__((warn_unused_result, nonnull(1, 3, 5, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 4, 6, 8)));
 
 
 /*
@@ -311,6 +331,22 @@ static bool decode_ip_values_from_bits(const struct rohc_decomp_ctxt *const cont
                                        const size_t ip_hdr_pos,
                                        struct rohc_decoded_ip_values *const decoded)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6, 7, 9)));
+static bool decode_ip_id_from_bits(const struct rohc_decomp_ctxt *const context,
+                                   const struct ip_id_offset_decode *const ip_id_decode,
+                                   const uint32_t decoded_sn,
+                                   const rohc_lsb_ref_t lsb_ref_type,
+                                   const struct rohc_extr_ip_bits *const bits,
+                                   const char *const descr,
+                                   struct rohc_decoded_ip_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7)));
+static bool decode_ip_values_from_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       const struct rohc_decomp_rfc3095_changes *const ctxt,
+                                       const struct ip_id_offset_decode *const ip_id_decode,
+                                       const uint32_t decoded_sn,
+                                       const struct rohc_extr_ip_bits *const bits,
+                                       const char *const descr,
+                                       struct rohc_decoded_ip_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5, 6, 7)));
 
 
 /*
@@ -330,9 +366,15 @@ static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
                              const rohc_lsb_shift_t p)
 	__attribute__((warn_unused_result, pure));
 
+static void rfc3095_decomp_update_ipv4_check(struct rohc_decomp_rfc3095_changes *const ip_changes,
+                                             const struct ipv4_hdr *const old_ipv4)
+	__attribute__((nonnull(1, 2)));
+
 static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                             struct rohc_extr_bits *const bits)
 	__attribute__((nonnull(1, 2)));
+static void reset_extr_ip_bits(struct rohc_extr_ip_bits *const ip_bits)
+	__attribute__((nonnull(1)));
 
 
 
@@ -343,64 +385,79 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 /**
  * @brief Create the RFC3095 volatile and persistent parts of the context
  *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
+ * The parts of the persistent context are carved from the memory block
+ * given by the decompressor, its length shall be computed with
+ * \ref ROHC_DECOMP_RFC3095_CTXT_LEN.
  *
- * @param context            The decompression context
- * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
- * @param trace_cb           The function to call for printing traces
- * @param trace_cb_priv      An optional private context, may be NULL
- * @param profile_id         The ID of the associated decompression profile
- * @return                   true if the Uncompressed context was successfully
- *                           created, false if a problem occurred
+ * @param context          The decompression context
+ * @param rfc3095_ctxt     The persistent part of the decompression context
+ * @param[out] volat_ctxt  The volatile part of the decompression context
+ * @param specific_len     The length of the profile-specific data
+ * @param next_header_len  The length of the header after the IP header(s)
  */
-bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
-                                struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
+void rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
+                                struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                 struct rohc_decomp_volat_ctxt *const volat_ctxt,
-                                rohc_trace_callback2_t trace_cb,
-                                void *const trace_cb_priv,
-                                const int profile_id)
+                                const size_t specific_len,
+                                const size_t next_header_len)
 {
-	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
+	uint8_t *ctxt_part = ((uint8_t *) rfc3095_ctxt) +
+		rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_rfc3095_ctxt));
 
-	/* allocate memory for the generic context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc3095_ctxt));
-	if((*persist_ctxt) == NULL)
+	/* the changes of the outer and inner IP headers */
+	rfc3095_ctxt->outer_ip_changes = (void *) ctxt_part;
+	ctxt_part += rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->inner_ip_changes = (void *) ctxt_part;
+	ctxt_part += rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->outer_ip_changes->is_ipv4_check_valid = false;
+	rfc3095_ctxt->inner_ip_changes->is_ipv4_check_valid = false;
+
+	/* the profile-specific data */
+	if(specific_len > 0)
 	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "no memory for the generic decompression context");
-		goto quit;
+		rfc3095_ctxt->specific = ctxt_part;
+		ctxt_part += rohc_decomp_ctxt_part_len(specific_len);
 	}
-	rfc3095_ctxt = *persist_ctxt;
-
-	/* create the Offset IP-ID decoding context for outer IP header */
-	ip_id_offset_init(&rfc3095_ctxt->outer_ip_id_offset_ctxt);
-	/* create the Offset IP-ID decoding context for inner IP header */
-	ip_id_offset_init(&rfc3095_ctxt->inner_ip_id_offset_ctxt);
-
-	rfc3095_ctxt->outer_ip_changes = calloc(2, sizeof(struct rohc_decomp_rfc3095_changes));
-	if(rfc3095_ctxt->outer_ip_changes == NULL)
+	else
 	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the outer IP header changes");
-		goto free_context;
+		rfc3095_ctxt->specific = NULL;
 	}
 
-	rfc3095_ctxt->inner_ip_changes = calloc(1, sizeof(struct rohc_decomp_rfc3095_changes));
-	if(rfc3095_ctxt->inner_ip_changes == NULL)
+	/* the next header of the outer and inner IP headers */
+	rfc3095_ctxt->next_header_len = next_header_len;
+	rfc3095_ctxt->outer_ip_changes->next_header_len = next_header_len;
+	rfc3095_ctxt->inner_ip_changes->next_header_len = next_header_len;
+	if(next_header_len > 0)
+	{
+		rfc3095_ctxt->outer_ip_changes->next_header = ctxt_part;
+		ctxt_part += rohc_decomp_ctxt_part_len(next_header_len);
+		rfc3095_ctxt->inner_ip_changes->next_header = ctxt_part;
+	}
+	else
 	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the inner IP header changes");
-		goto free_outer_ip_changes;
+		rfc3095_ctxt->outer_ip_changes->next_header = NULL;
+		rfc3095_ctxt->inner_ip_changes->next_header = NULL;
 	}
 
+	/* create the Offset IP-ID decoding context for outer IP header */
+	ip_id_offset_init(&rfc3095_ctxt->outer_ip_id_offset_ctxt);
+	/* create the Offset IP-ID decoding context for inner IP header */
+	ip_id_offset_init(&rfc3095_ctxt->inner_ip_id_offset_ctxt);
+
 	/* init the context used to compress the list of IPv6 extension headers
 	 * for the outer and inner IP headers */
 	rohc_decomp_list_ipv6_init(&rfc3095_ctxt->list_decomp1,
-	                           trace_cb, trace_cb_priv, profile_id);
+	                           &context->decompressor->mempool,
+	                           context->decompressor->trace_callback,
+	                           context->decompressor->trace_callback_priv,
+	                           context->decompressor->trace_level,
+	                           context->profile->id);
 	rohc_decomp_list_ipv6_init(&rfc3095_ctxt->list_decomp2,
-	                           trace_cb, trace_cb_priv, profile_id);
+	                           &context->decompressor->mempool,
+	                           context->decompressor->trace_callback,
+	                           context->decompressor->trace_callback_priv,
+	                           context->decompressor->trace_level,
+	                           context->profile->id);
 
 	/* no default next header */
 	rfc3095_ctxt->next_header_proto = 0;
@@ -414,61 +471,26 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_inner_ip_changes;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_extr_bits;
-	}
-
-	return true;
-
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-free_inner_ip_changes:
-	zfree(rfc3095_ctxt->inner_ip_changes);
-free_outer_ip_changes:
-	zfree(rfc3095_ctxt->outer_ip_changes);
-free_context:
-	zfree(rfc3095_ctxt);
-quit:
-	return false;
 }
 
 
 /**
- * @brief Destroy the context.
+ * @brief Destroy the profile-specific data of a RFC3095 decompression context
  *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
+ * Release the lists of IPv6 extension headers and their items.
  *
- * @param rfc3095_ctxt  The generic decompression context
+ * @param context       The decompression context
+ * @param persist_ctxt  The persistent part of the decompression context
  * @param volat_ctxt    The volatile part of the decompression context
  */
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+void rohc_decomp_rfc3095_free(const struct rohc_decomp_ctxt *const context __attribute__((unused)),
+                              void *const persist_ctxt,
+                              const struct rohc_decomp_volat_ctxt *const volat_ctxt __attribute__((unused)))
 {
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-
-	/* destroy the information about the IP headers */
-	zfree(rfc3095_ctxt->outer_ip_changes);
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = persist_ctxt;
 
-	/* destroy profile-specific part */
-	zfree(rfc3095_ctxt->specific);
-
-	/* destroy generic context itself */
-	free(rfc3095_ctxt);
+	rohc_decomp_list_ipv6_free(&rfc3095_ctxt->list_decomp1);
+	rohc_decomp_list_ipv6_free(&rfc3095_ctxt->list_decomp2);
 }
 
 
@@ -1310,6 +1332,18 @@ uint32_t rohc_decomp_rfc3095_get_sn(const struct rohc_decomp_ctxt *const context
 }
 
 
+/**
+ * @brief Get the SN value decoded from one packet
+ *
+ * @param decoded  The values decoded from the packet
+ * @return         The decoded SN value
+ */
+uint32_t rohc_decomp_rfc3095_get_decoded_sn(const struct rohc_decoded_values *const decoded)
+{
+	return decoded->sn;
+}
+
+
 /**
  * @brief Parse one UO-0 header
  *
@@ -2747,7 +2781,13 @@ error:
 
 
 /**
- * @brief Parse one UOR-2 header for RTP profile (in 2 passes if needed)
+ * @brief Parse one UOR-2-RTP, UOR-2-ID or UOR-2-TS header for RTP profile
+ *
+ * The three UOR-2 variants of the RTP profile cannot be told apart from
+ * their base header only: an EXT-3 extension may change the RND flags of
+ * the IPv4 headers, and so the variant of the packet (RFC 3095, section
+ * 5.7.5.1). The RND flags of the EXT-3 extension are peeked first, so that
+ * the right variant is parsed in one single pass.
  *
  * @param context              The decompression context
  * @param rohc_packet          The ROHC packet to decode
@@ -2755,117 +2795,236 @@ error:
  * @param large_cid_len        The length of the optional large CID field
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
- * @param[out] extr_crc        The CRC bits extracted from the UOR-2-RTP header
- * @param[out] bits            The bits extracted from the UOR-2-RTP header
+ * @param[out] extr_crc        The CRC bits extracted from the UOR-2 header
+ * @param[out] bits            The bits extracted from the UOR-2 header
  * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
- * @return                     true if UOR-2-RTP is successfully parsed,
- *                             false otherwise
+ * @return                     true if the UOR-2 header is successfully
+ *                             parsed, false otherwise
  *
- * @see parse_uor2rtp_once
+ * @see peek_uor2_rtp_variant
  */
-static bool parse_uor2rtp(const struct rohc_decomp_ctxt *const context,
-                          const uint8_t *const rohc_packet,
-                          const size_t rohc_length,
-                          const size_t large_cid_len,
-                          rohc_packet_t *const packet_type,
-                          struct rohc_decomp_crc *const extr_crc,
-                          struct rohc_extr_bits *const bits,
-                          size_t *const rohc_hdr_len)
+static bool parse_uor2_rtp_variant(const struct rohc_decomp_ctxt *const context,
+                                   const uint8_t *const rohc_packet,
+                                   const size_t rohc_length,
+                                   const size_t large_cid_len,
+                                   rohc_packet_t *const packet_type,
+                                   struct rohc_decomp_crc *const extr_crc,
+                                   struct rohc_extr_bits *const bits,
+                                   size_t *const rohc_hdr_len)
 {
-	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-
-	/* forced values for outer and inner RND flags */
+	/* values of the outer and inner RND flags for the packet */
 	uint8_t outer_rnd;
 	uint8_t inner_rnd;
 
 	bool need_reparse;
 	bool parsing;
 
-	assert((*packet_type) == ROHC_PACKET_UOR_2_RTP);
 	assert(context->state != ROHC_DECOMP_STATE_NC);
 	assert(context->profile->id == ROHC_PROFILE_RTP);
 
-	/* for the first parsing, use the context values for the outer/inner RND
-	 * flags, force them for reparse later if required */
-	outer_rnd = rfc3095_ctxt->outer_ip_changes->rnd;
-	inner_rnd = rfc3095_ctxt->inner_ip_changes->rnd;
+	/* determine the UOR-2 variant from the RND flags of EXT-3 if any */
+	*packet_type = peek_uor2_rtp_variant(context, rohc_packet, rohc_length,
+	                                     large_cid_len, *packet_type,
+	                                     &outer_rnd, &inner_rnd);
 
-	/* try parsing UOR-2-RTP packet with information from context */
-	parsing = parse_uor2rtp_once(context, rohc_packet, rohc_length,
-	                             large_cid_len, *packet_type, outer_rnd, inner_rnd,
-	                             extr_crc, bits, rohc_hdr_len, &need_reparse);
+	/* parse the UOR-2 variant */
+	if((*packet_type) == ROHC_PACKET_UOR_2_RTP)
+	{
+		parsing = parse_uor2rtp_once(context, rohc_packet, rohc_length,
+		                             large_cid_len, *packet_type, outer_rnd,
+		                             inner_rnd, extr_crc, bits, rohc_hdr_len,
+		                             &need_reparse);
+	}
+	else if((*packet_type) == ROHC_PACKET_UOR_2_TS)
+	{
+		parsing = parse_uor2ts_once(context, rohc_packet, rohc_length,
+		                            large_cid_len, *packet_type, outer_rnd,
+		                            inner_rnd, extr_crc, bits, rohc_hdr_len,
+		                            &need_reparse);
+	}
+	else
+	{
+		assert((*packet_type) == ROHC_PACKET_UOR_2_ID);
+		parsing = parse_uor2id_once(context, rohc_packet, rohc_length,
+		                            large_cid_len, *packet_type, outer_rnd,
+		                            inner_rnd, extr_crc, bits, rohc_hdr_len,
+		                            &need_reparse);
+	}
 	if(!parsing)
 	{
-		if(!need_reparse)
+		if(need_reparse)
 		{
-			rohc_decomp_warn(context, "failed to parse the UOR-2-RTP header");
-			goto error;
+			/* the RND flags were peeked, EXT-3 shall agree with them */
+			rohc_decomp_warn(context, "RND flags of EXT-3 do not match the "
+			                 "ones peeked before parsing, there is an internal "
+			                 "problem");
+			assert(0);
 		}
+		else
+		{
+			rohc_decomp_warn(context, "failed to parse the UOR-2 header");
+		}
+		goto error;
+	}
+
+	return true;
 
-		/* UOR-2* packet overridden some context values, so reparsing with new
-		 * assumptions is required */
-		rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		          "packet needs to be reparsed with different assumptions "
-		          "for packet type");
+error:
+	return false;
+}
+
+
+/**
+ * @brief Peek the variant of one UOR-2 header for RTP profile
+ *
+ * The variant of the UOR-2 header depends on the RND flags of the IPv4
+ * headers: UOR-2-RTP if all the IPv4 headers have RND = 1, UOR-2-ID or
+ * UOR-2-TS otherwise. The RND flags are the ones of the EXT-3 extension
+ * if present, the ones of the context otherwise.
+ *
+ * The extension starts at the same offset for the three UOR-2 variants, so
+ * it can be located before the variant is known.
+ *
+ * @param context            The decompression context
+ * @param rohc_packet        The ROHC packet to decode
+ * @param rohc_length        The length of the ROHC packet
+ * @param large_cid_len      The length of the optional large CID field
+ * @param packet_type        The type of ROHC packet detected from the context
+ * @param[out] outer_rnd     The value of the outer RND flag for the packet
+ * @param[out] inner_rnd     The value of the inner RND flag for the packet
+ * @return                   The UOR-2 variant to parse
+ */
+static rohc_packet_t peek_uor2_rtp_variant(const struct rohc_decomp_ctxt *const context,
+                                           const uint8_t *const rohc_packet,
+                                           const size_t rohc_length,
+                                           const size_t large_cid_len,
+                                           const rohc_packet_t packet_type,
+                                           uint8_t *const outer_rnd,
+                                           uint8_t *const inner_rnd)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const struct rohc_decomp_rfc3095_changes *innermost_changes;
+	const size_t ext_pos = 1 + large_cid_len + 2;
+	const uint8_t *ext;
+	size_t ext_len;
+	uint8_t *innermost_rnd;
+	bool are_all_ipv4_rnd = true;
+	uint8_t ip_flags = 0;
+
+	/* use the context values for the outer/inner RND flags by default */
+	*outer_rnd = rfc3095_ctxt->outer_ip_changes->rnd;
+	*inner_rnd = rfc3095_ctxt->inner_ip_changes->rnd;
+
+	/* no EXT-3 extension, so no RND change: the packet type detected from
+	 * the context is right (too short packets are handled by the parsing) */
+	if(rohc_length <= ext_pos ||
+	   GET_BIT_7(rohc_packet + ext_pos - 1) == 0 ||
+	   parse_extension_type(rohc_packet + ext_pos) != ROHC_EXT_3)
+	{
+		return packet_type;
+	}
+	ext = rohc_packet + ext_pos;
+	ext_len = rohc_length - ext_pos;
+
+	/* the inner IP header flags are about the innermost IP header */
+	if(rfc3095_ctxt->multiple_ip)
+	{
+		innermost_changes = rfc3095_ctxt->inner_ip_changes;
+		innermost_rnd = inner_rnd;
+	}
+	else
+	{
+		innermost_changes = rfc3095_ctxt->outer_ip_changes;
+		innermost_rnd = outer_rnd;
+	}
 
-		/* determine the new RND values for outer and inner IP headers */
-		if(bits->multiple_ip &&
-		   bits->inner_ip.rnd_nr > 0 &&
-		   bits->inner_ip.rnd != rfc3095_ctxt->inner_ip_changes->rnd)
+	/* RND flag in the inner IP header flags if ip = 1 */
+	if(GET_BIT_1(ext) != 0 && ext_len >= 2)
+	{
+		ip_flags = ext[1];
+	}
+	if(ip_get_version(&innermost_changes->ip) == IPV4)
+	{
+		if(GET_BIT_1(ext) != 0)
 		{
-			/* inner RND flag changed */
-			assert(bits->inner_ip.rnd_nr == 1);
-			inner_rnd = bits->inner_ip.rnd;
+			*innermost_rnd = GET_REAL(GET_BIT_1(&ip_flags));
 		}
-		if(bits->outer_ip.rnd_nr > 0 &&
-		   bits->outer_ip.rnd != rfc3095_ctxt->outer_ip_changes->rnd)
+		are_all_ipv4_rnd &= ((*innermost_rnd) != 0);
+	}
+
+	/* RND2 flag in the outer IP header flags if ip2 = 1 */
+	if(rfc3095_ctxt->multiple_ip &&
+	   ip_get_version(&rfc3095_ctxt->outer_ip_changes->ip) == IPV4)
+	{
+		if(GET_BIT_0(&ip_flags) != 0 && ext_len >= 3)
 		{
-			/* outer RND flag changed */
-			assert(bits->outer_ip.rnd_nr == 1);
-			outer_rnd = bits->outer_ip.rnd;
+			*outer_rnd = GET_REAL(GET_BIT_1(ext + 2));
 		}
+		are_all_ipv4_rnd &= ((*outer_rnd) != 0);
+	}
 
-		/* change packet type UOR-2-RTP -> UOR-2-ID/TS, then try parsing UOR-2*
-		 * packet with information from packet */
-		if(rohc_decomp_packet_is_uor2_ts(rohc_packet, rohc_length,
-		                                 large_cid_len))
+	if(are_all_ipv4_rnd)
+	{
+		if(packet_type != ROHC_PACKET_UOR_2_RTP)
 		{
-			rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-			          "change for packet UOR-2-TS (T = 1)");
-			*packet_type = ROHC_PACKET_UOR_2_TS;
-			parsing = parse_uor2ts_once(context, rohc_packet, rohc_length,
-			                            large_cid_len, *packet_type, outer_rnd,
-			                            inner_rnd, extr_crc, bits, rohc_hdr_len,
-			                            &need_reparse);
+			rohc_decomp_debug(context, "RND flags of EXT-3 change the packet "
+			                  "type for UOR-2-RTP");
 		}
-		else
+		return ROHC_PACKET_UOR_2_RTP;
+	}
+	else if(rohc_decomp_packet_is_uor2_ts(rohc_packet, rohc_length,
+	                                      large_cid_len))
+	{
+		if(packet_type != ROHC_PACKET_UOR_2_TS)
 		{
-			rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-			          "change for packet UOR-2-ID (T = 0)");
-			*packet_type = ROHC_PACKET_UOR_2_ID;
-			parsing = parse_uor2id_once(context, rohc_packet, rohc_length,
-			                            large_cid_len, *packet_type, outer_rnd,
-			                            inner_rnd, extr_crc, bits, rohc_hdr_len,
-			                            &need_reparse);
+			rohc_decomp_debug(context, "RND flags of EXT-3 change the packet "
+			                  "type for UOR-2-TS (T = 1)");
 		}
-		if(!parsing)
+		return ROHC_PACKET_UOR_2_TS;
+	}
+	else
+	{
+		if(packet_type != ROHC_PACKET_UOR_2_ID)
 		{
-			if(!need_reparse)
-			{
-				rohc_decomp_warn(context, "failed to parse the UOR-2 header");
-				goto error;
-			}
-			rohc_decomp_warn(context, "reparse required by the reparse, there "
-			                 "is an internal problem");
-			assert(0);
-			goto error;
+			rohc_decomp_debug(context, "RND flags of EXT-3 change the packet "
+			                  "type for UOR-2-ID (T = 0)");
 		}
+		return ROHC_PACKET_UOR_2_ID;
 	}
+}
 
-	return true;
 
-error:
-	return false;
+/**
+ * @brief Parse one UOR-2-RTP header for RTP profile
+ *
+ * @param context              The decompression context
+ * @param rohc_packet          The ROHC packet to decode
+ * @param rohc_length          The length of the ROHC packet
+ * @param large_cid_len        The length of the optional large CID field
+ * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
+ *                             OUT: The type of the parsed ROHC packet
+ * @param[out] extr_crc        The CRC bits extracted from the UOR-2-RTP header
+ * @param[out] bits            The bits extracted from the UOR-2-RTP header
+ * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
+ * @return                     true if UOR-2-RTP is successfully parsed,
+ *                             false otherwise
+ *
+ * @see parse_uor2_rtp_variant
+ */
+static bool parse_uor2rtp(const struct rohc_decomp_ctxt *const context,
+                          const uint8_t *const rohc_packet,
+                          const size_t rohc_length,
+                          const size_t large_cid_len,
+                          rohc_packet_t *const packet_type,
+                          struct rohc_decomp_crc *const extr_crc,
+                          struct rohc_extr_bits *const bits,
+                          size_t *const rohc_hdr_len)
+{
+	assert((*packet_type) == ROHC_PACKET_UOR_2_RTP);
+
+	return parse_uor2_rtp_variant(context, rohc_packet, rohc_length,
+	                              large_cid_len, packet_type, extr_crc, bits,
+	                              rohc_hdr_len);
 }
 
 
@@ -2950,8 +3109,8 @@ error:
  * @param large_cid_len        The length of the optional large CID field
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
- * @param outer_rnd            The forced value for outer RND (used for reparsing)
- * @param inner_rnd            The forced value for inner RND (used for reparsing)
+ * @param outer_rnd            The forced value for outer RND (peeked in EXT-3)
+ * @param inner_rnd            The forced value for inner RND (peeked in EXT-3)
  * @param[out] extr_crc        The CRC bits extracted from the UOR-2-RTP header
  * @param[out] bits            The bits extracted from the UOR-2-RTP header
  * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
@@ -3214,7 +3373,7 @@ error:
 
 
 /**
- * @brief Parse one UOR-2-ID header for RTP profile (in 2 passes if needed)
+ * @brief Parse one UOR-2-ID header for RTP profile
  *
  * @param context              The decompression context
  * @param rohc_packet          The ROHC packet to decode
@@ -3228,7 +3387,7 @@ error:
  * @return                     true if UOR-2-ID is successfully parsed,
  *                             false otherwise
  *
- * @see parse_uor2id_once
+ * @see parse_uor2_rtp_variant
  */
 static bool parse_uor2id(const struct rohc_decomp_ctxt *const context,
                          const uint8_t *const rohc_packet,
@@ -3239,85 +3398,11 @@ static bool parse_uor2id(const struct rohc_decomp_ctxt *const context,
                          struct rohc_extr_bits *const bits,
                          size_t *const rohc_hdr_len)
 {
-	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-
-	/* forced values for outer and inner RND flags */
-	uint8_t outer_rnd;
-	uint8_t inner_rnd;
-
-	bool need_reparse;
-	bool parsing;
-
 	assert((*packet_type) == ROHC_PACKET_UOR_2_ID);
-	assert(context->state != ROHC_DECOMP_STATE_NC);
-	assert(context->profile->id == ROHC_PROFILE_RTP);
-
-	/* for the first parsing, use the context values for the outer/inner RND
-	 * flags, force them for reparse later if required */
-	outer_rnd = rfc3095_ctxt->outer_ip_changes->rnd;
-	inner_rnd = rfc3095_ctxt->inner_ip_changes->rnd;
-
-	/* try parsing UOR-2-ID packet with information from context */
-	parsing = parse_uor2id_once(context, rohc_packet, rohc_length,
-	                            large_cid_len, *packet_type, outer_rnd, inner_rnd,
-	                            extr_crc, bits, rohc_hdr_len, &need_reparse);
-	if(!parsing)
-	{
-		if(!need_reparse)
-		{
-			rohc_decomp_warn(context, "failed to parse the UOR-2-ID header");
-			goto error;
-		}
-
-		/* UOR-2* packet overridden some context values, so reparsing with new
-		 * assumptions is required */
-		rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		          "packet needs to be reparsed with different assumptions "
-		          "for packet type");
-
-		/* determine the new RND values for outer and inner IP headers */
-		if(bits->multiple_ip &&
-		   bits->inner_ip.rnd_nr > 0 &&
-		   bits->inner_ip.rnd != rfc3095_ctxt->inner_ip_changes->rnd)
-		{
-			/* inner RND flag changed */
-			assert(bits->inner_ip.rnd_nr == 1);
-			inner_rnd = bits->inner_ip.rnd;
-		}
-		if(bits->outer_ip.rnd_nr > 0 &&
-		   bits->outer_ip.rnd != rfc3095_ctxt->outer_ip_changes->rnd)
-		{
-			/* outer RND flag changed */
-			assert(bits->outer_ip.rnd_nr == 1);
-			outer_rnd = bits->outer_ip.rnd;
-		}
 
-		/* change packet type UOR-2-ID -> UOR-2-RTP, then try parsing UOR-2*
-		 * packet with information from packet */
-		rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		          "change for packet UOR-2-RTP");
-		*packet_type = ROHC_PACKET_UOR_2_RTP;
-		parsing = parse_uor2rtp_once(context, rohc_packet, rohc_length, large_cid_len,
-		                             *packet_type, outer_rnd, inner_rnd,
-		                             extr_crc, bits, rohc_hdr_len, &need_reparse);
-		if(!parsing)
-		{
-			if(!need_reparse)
-			{
-				rohc_decomp_warn(context, "failed to reparse the UOR-2 header");
-				goto error;
-			}
-			rohc_decomp_warn(context, "reparse required by the reparse, "
-			                 "there is an internal problem");
-			assert(0);
-			goto error;
-		}
-	}
-
-	return true;
-
-error:
-	return false;
+	return parse_uor2_rtp_variant(context, rohc_packet, rohc_length,
+	                              large_cid_len, packet_type, extr_crc, bits,
+	                              rohc_hdr_len);
 }
 
 
@@ -3405,8 +3490,8 @@ error:
  * @param large_cid_len        The length of the optional large CID field
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
- * @param outer_rnd            The forced value for outer RND (used for reparsing)
- * @param inner_rnd            The forced value for inner RND (used for reparsing)
+ * @param outer_rnd            The forced value for outer RND (peeked in EXT-3)
+ * @param inner_rnd            The forced value for inner RND (peeked in EXT-3)
  * @param[out] extr_crc        The CRC bits extracted from the UOR-2-ID header
  * @param[out] bits            The bits extracted from the UOR-2-ID header
  * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
@@ -3682,7 +3767,7 @@ error:
 
 
 /**
- * @brief Parse one UOR-2-TS header for RTP profile (in 2 passes if needed)
+ * @brief Parse one UOR-2-TS header for RTP profile
  *
  * @param context              The decompression context
  * @param rohc_packet          The ROHC packet to decode
@@ -3696,7 +3781,7 @@ error:
  * @return                     true if UOR-2-TS is successfully parsed,
  *                             false otherwise
  *
- * @see parse_uor2ts_once
+ * @see parse_uor2_rtp_variant
  */
 static bool parse_uor2ts(const struct rohc_decomp_ctxt *const context,
                          const uint8_t *const rohc_packet,
@@ -3707,85 +3792,11 @@ static bool parse_uor2ts(const struct rohc_decomp_ctxt *const context,
                          struct rohc_extr_bits *const bits,
                          size_t *const rohc_hdr_len)
 {
-	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-
-	/* forced values for outer and inner RND flags */
-	uint8_t outer_rnd;
-	uint8_t inner_rnd;
-
-	bool need_reparse;
-	bool parsing;
-
 	assert((*packet_type) == ROHC_PACKET_UOR_2_TS);
-	assert(context->state != ROHC_DECOMP_STATE_NC);
-	assert(context->profile->id == ROHC_PROFILE_RTP);
-
-	/* for the first parsing, use the context values for the outer/inner RND
-	 * flags, force them for reparse later if required */
-	outer_rnd = rfc3095_ctxt->outer_ip_changes->rnd;
-	inner_rnd = rfc3095_ctxt->inner_ip_changes->rnd;
 
-	/* try parsing UOR-2-TS packet with information from context */
-	parsing = parse_uor2ts_once(context, rohc_packet, rohc_length,
-	                            large_cid_len, *packet_type, outer_rnd, inner_rnd,
-	                            extr_crc, bits, rohc_hdr_len, &need_reparse);
-	if(!parsing)
-	{
-		if(!need_reparse)
-		{
-			rohc_decomp_warn(context, "failed to parse the UOR-2-TS header");
-			goto error;
-		}
-
-		/* UOR-2* packet overridden some context values, so reparsing with new
-		 * assumptions is required */
-		rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		          "packet needs to be reparsed with different assumptions "
-		          "for packet type");
-
-		/* determine the new RND values for outer and inner IP headers */
-		if(bits->multiple_ip &&
-		   bits->inner_ip.rnd_nr > 0 &&
-		   bits->inner_ip.rnd != rfc3095_ctxt->inner_ip_changes->rnd)
-		{
-			/* inner RND flag changed */
-			assert(bits->inner_ip.rnd_nr == 1);
-			inner_rnd = bits->inner_ip.rnd;
-		}
-		if(bits->outer_ip.rnd_nr > 0 &&
-		   bits->outer_ip.rnd != rfc3095_ctxt->outer_ip_changes->rnd)
-		{
-			/* outer RND flag changed */
-			assert(bits->outer_ip.rnd_nr == 1);
-			outer_rnd = bits->outer_ip.rnd;
-		}
-
-		/* change packet type UOR-2-ID -> UOR-2-RTP, then try parsing UOR-2*
-		 * packet with information from packet */
-		rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		          "change for packet UOR-2-RTP");
-		*packet_type = ROHC_PACKET_UOR_2_RTP;
-		parsing = parse_uor2rtp_once(context, rohc_packet, rohc_length, large_cid_len,
-		                             *packet_type, outer_rnd, inner_rnd,
-		                             extr_crc, bits, rohc_hdr_len, &need_reparse);
-		if(!parsing)
-		{
-			if(!need_reparse)
-			{
-				rohc_decomp_warn(context, "failed to reparse the UOR-2 header");
-				goto error;
-			}
-			rohc_decomp_warn(context, "reparse required by the reparse, there "
-			                 "is an internal problem");
-			assert(0);
-			goto error;
-		}
-	}
-
-	return true;
-
-error:
-	return false;
+	return parse_uor2_rtp_variant(context, rohc_packet, rohc_length,
+	                              large_cid_len, packet_type, extr_crc, bits,
+	                              rohc_hdr_len);
 }
 
 
@@ -3873,8 +3884,8 @@ error:
  * @param large_cid_len        The length of the optional large CID field
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
- * @param outer_rnd            The forced value for outer RND (used for reparsing)
- * @param inner_rnd            The forced value for inner RND (used for reparsing)
+ * @param outer_rnd            The forced value for outer RND (peeked in EXT-3)
+ * @param inner_rnd            The forced value for inner RND (peeked in EXT-3)
  * @param[out] extr_crc        The CRC bits extracted from the UOR-2-TS header
  * @param[out] bits            The bits extracted from the UOR-2-TS header
  * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
@@ -5184,6 +5195,9 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		.payload_len = payload_len,
 	};
 	size_t ip_payload_len = 0;
+	/* the IP headers kept in context are the templates of the IP headers to
+	 * build, except for IR packets that may change their static fields */
+	const bool use_ip_tmpls = (packet_type != ROHC_PACKET_IR);
 
 	/* build the IP headers */
 	if(decoded->multiple_ip)
@@ -5227,8 +5241,9 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		ip_payload_len += payload_len;
 
 		/* build the outer IP header */
-		if(!build_uncomp_ip(context, decoded->outer_ip, uncomp_hdrs_data,
-		                    uncomp_hdrs_max_len, &outer_ip_hdr_len,
+		if(!build_uncomp_ip(context, decoded->outer_ip,
+		                    use_ip_tmpls ? rfc3095_ctxt->outer_ip_changes : NULL,
+		                    uncomp_hdrs_data, uncomp_hdrs_max_len, &outer_ip_hdr_len,
 		                    ip_payload_len, &rfc3095_ctxt->list_decomp1))
 		{
 			rohc_decomp_warn(context, "failed to build the outer IP header");
@@ -5276,8 +5291,9 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 
 		/* build the inner IP header */
 		ip_payload_len -= inner_ip_hdr_len + inner_ip_ext_hdrs_len;
-		if(!build_uncomp_ip(context, decoded->inner_ip, uncomp_hdrs_data,
-		                    uncomp_hdrs_max_len, &inner_ip_hdr_len,
+		if(!build_uncomp_ip(context, decoded->inner_ip,
+		                    use_ip_tmpls ? rfc3095_ctxt->inner_ip_changes : NULL,
+		                    uncomp_hdrs_data, uncomp_hdrs_max_len, &inner_ip_hdr_len,
 		                    ip_payload_len, &rfc3095_ctxt->list_decomp2))
 		{
 			rohc_decomp_warn(context, "failed to build the inner IP header");
@@ -5335,9 +5351,10 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		ip_payload_len += payload_len;
 
 		/* build the single IP header */
-		if(!build_uncomp_ip(context, decoded->outer_ip, uncomp_hdrs_data,
-		                    uncomp_hdrs_max_len, &ip_hdr_len, ip_payload_len,
-		                    &rfc3095_ctxt->list_decomp1))
+		if(!build_uncomp_ip(context, decoded->outer_ip,
+		                    use_ip_tmpls ? rfc3095_ctxt->outer_ip_changes : NULL,
+		                    uncomp_hdrs_data, uncomp_hdrs_max_len, &ip_hdr_len,
+		                    ip_payload_len, &rfc3095_ctxt->list_decomp1))
 		{
 			rohc_decomp_warn(context, "failed to build the IP header");
 			goto error_output_too_small;
@@ -5446,6 +5463,9 @@ error_output_too_small:
  *
  * @param context               The decompression context
  * @param decoded               The decoded IPv4 fields
+ * @param ip_tmpl               The IP header of the context to copy the
+ *                              static fields from, NULL to build them from
+ *                              the decoded fields
  * @param dest                  The buffer to store the IP header
  * @param uncomp_hdrs_max_len   The max length of the IP header
  * @param[out] uncomp_hdrs_len  The length of the IPv4 header
@@ -5456,6 +5476,7 @@ error_output_too_small:
  */
 static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
                             const struct rohc_decoded_ip_values decoded,
+                            const struct rohc_decomp_rfc3095_changes *const ip_tmpl,
                             uint8_t *const dest,
                             const size_t uncomp_hdrs_max_len,
                             size_t *const uncomp_hdrs_len,
@@ -5466,13 +5487,15 @@ static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
 
 	if(decoded.version == IPV4)
 	{
-		is_ok = build_uncomp_ipv4(context, decoded, dest, uncomp_hdrs_max_len,
-		                          uncomp_hdrs_len, payload_size);
+		is_ok = build_uncomp_ipv4(context, decoded, ip_tmpl, dest,
+		                          uncomp_hdrs_max_len, uncomp_hdrs_len,
+		                          payload_size);
 	}
 	else
 	{
-		is_ok = build_uncomp_ipv6(context, decoded, dest, uncomp_hdrs_max_len,
-		                          uncomp_hdrs_len, payload_size, list_decomp);
+		is_ok = build_uncomp_ipv6(context, decoded, ip_tmpl, dest,
+		                          uncomp_hdrs_max_len, uncomp_hdrs_len,
+		                          payload_size, list_decomp);
 	}
 
 	return is_ok;
@@ -5484,6 +5507,9 @@ static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
  *
  * @param context               The decompression context
  * @param decoded               The decoded IPv4 fields
+ * @param ip_tmpl               The IPv4 header of the context to copy the
+ *                              static fields from, NULL to build them from
+ *                              the decoded fields
  * @param dest                  The buffer to store the IPv4 header
  * @param uncomp_hdrs_max_len   The max length of the IPv4 header
  * @param[out] uncomp_hdrs_len  The length of the IPv4 header
@@ -5493,6 +5519,7 @@ static bool build_uncomp_ip(const struct rohc_decomp_ctxt *const context,
  */
 static bool build_uncomp_ipv4(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_decoded_ip_values decoded,
+                              const struct rohc_decomp_rfc3095_changes *const ip_tmpl,
                               uint8_t *const dest,
                               const size_t uncomp_hdrs_max_len,
                               size_t *const uncomp_hdrs_len,
@@ -5507,14 +5534,23 @@ static bool build_uncomp_ipv4(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* static-known fields */
-	ip->ihl = 5;
+	if(ip_tmpl != NULL)
+	{
+		/* static-known and static fields from the IPv4 header of the context */
+		assert(ip_tmpl->ip.version == IPV4);
+		memcpy(ip, &ip_tmpl->ip.header.v4, sizeof(struct ipv4_hdr));
+	}
+	else
+	{
+		/* static-known fields */
+		ip->ihl = 5;
 
-	/* static fields */
-	ip->version = decoded.version;
-	ip->protocol = decoded.proto;
-	memcpy(&ip->saddr, decoded.saddr, 4);
-	memcpy(&ip->daddr, decoded.daddr, 4);
+		/* static fields */
+		ip->version = decoded.version;
+		ip->protocol = decoded.proto;
+		memcpy(&ip->saddr, decoded.saddr, 4);
+		memcpy(&ip->daddr, decoded.daddr, 4);
+	}
 
 	/* dynamic fields */
 	ip->tos = decoded.tos;
@@ -5527,8 +5563,27 @@ static bool build_uncomp_ipv4(const struct rohc_decomp_ctxt *const context,
 	ip->tot_len = rohc_hton16(payload_size + ip->ihl * 4);
 	rohc_decomp_debug(context, "Total Length = 0x%04x (IHL * 4 + %zu)",
 	                  rohc_ntoh16(ip->tot_len), payload_size);
-	ip->check = 0;
-	ip->check = ip_fast_csum(dest, ip->ihl);
+	if(ip_tmpl != NULL && ip_tmpl->is_ipv4_check_valid)
+	{
+		/* update the checksum of the IPv4 header of the context with the
+		 * fields that changed */
+		ip->check = ipv4_csum_update(ip_tmpl->ip.header.v4.check,
+		                             (const uint8_t *) &ip_tmpl->ip.header.v4, dest);
+#if ROHC_EXTRA_DEBUG == 1
+		{
+			struct ipv4_hdr full_csum_hdr;
+			memcpy(&full_csum_hdr, ip, sizeof(struct ipv4_hdr));
+			full_csum_hdr.check = 0;
+			assert(ip_fast_csum((uint8_t *) &full_csum_hdr, full_csum_hdr.ihl) ==
+			       ip->check);
+		}
+#endif
+	}
+	else
+	{
+		ip->check = 0;
+		ip->check = ip_fast_csum(dest, ip->ihl);
+	}
 	rohc_decomp_debug(context, "IP checksum = 0x%04x",
 	                  rohc_ntoh16(ip->check));
 
@@ -5545,6 +5600,9 @@ error:
  *
  * @param context               The decompression context
  * @param decoded               The decoded IPv6 fields
+ * @param ip_tmpl               The IPv6 header of the context to copy the
+ *                              static fields from, NULL to build them from
+ *                              the decoded fields
  * @param dest                  The buffer to store the IPv6 header
  * @param uncomp_hdrs_max_len   The max length of the IPv6 header
  * @param[out] uncomp_hdrs_len  The length of the IPv6 header
@@ -5555,6 +5613,7 @@ error:
  */
 static bool build_uncomp_ipv6(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_decoded_ip_values decoded,
+                              const struct rohc_decomp_rfc3095_changes *const ip_tmpl,
                               uint8_t *const dest,
                               const size_t uncomp_hdrs_max_len,
                               size_t *const uncomp_hdrs_len,
@@ -5571,12 +5630,21 @@ static bool build_uncomp_ipv6(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* static fields */
-	ip->version = decoded.version;
-	ipv6_set_flow_label(ip, decoded.flowid);
-	ip->nh = decoded.proto;
-	memcpy(&ip->saddr, decoded.saddr, 16);
-	memcpy(&ip->daddr, decoded.daddr, 16);
+	if(ip_tmpl != NULL)
+	{
+		/* static fields from the IPv6 header of the context */
+		assert(ip_tmpl->ip.version == IPV6);
+		memcpy(ip, &ip_tmpl->ip.header.v6, sizeof(struct ipv6_hdr));
+	}
+	else
+	{
+		/* static fields */
+		ip->version = decoded.version;
+		ipv6_set_flow_label(ip, decoded.flowid);
+		ip->nh = decoded.proto;
+		memcpy(&ip->saddr, decoded.saddr, 16);
+		memcpy(&ip->daddr, decoded.daddr, 16);
+	}
 
 	/* if there are extension headers, set Next Header in base header
 	 * according to the first one */
@@ -5596,8 +5664,8 @@ static bool build_uncomp_ipv6(const struct rohc_decomp_ctxt *const context,
 	if(list_decomp->pkt_list.id != ROHC_LIST_GEN_ID_NONE)
 	{
 		/* TODO: check dest max size */
-		ext_size = list_decomp->build_uncomp_item(list_decomp, decoded.proto,
-		                                          dest + sizeof(struct ipv6_hdr));
+		ext_size = rohc_decomp_list_build(list_decomp, decoded.proto,
+		                                  dest + sizeof(struct ipv6_hdr));
 	}
 	else
 	{
@@ -5622,8 +5690,11 @@ error:
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
- * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
- *       if the CRC-STATIC fields did not change.
+ * The CRC-3 and CRC-7 are computed over the CRC-STATIC fields first, then
+ * over the CRC-DYNAMIC fields (RFC 3095, section 5.9.2). The CRC register
+ * after the CRC-STATIC fields is cached in the context, so only the
+ * CRC-DYNAMIC fields are computed as long as the CRC-STATIC fields do not
+ * change. IR, IR-DYN and EXT-3 packets may change them and drop the cache.
  *
  * @param context          The decompression context
  * @param uncomp_pkt_hdrs  The uncompressed headers to compute CRC for
@@ -5672,8 +5743,10 @@ static bool check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
 	}
 	else
 	{
-		crc_computed = rfc3095_ctxt->compute_crc_static(uncomp_pkt_hdrs,
-		                                                crc_pkt->type, crc_computed);
+		crc_computed =
+			rfc3095_ctxt->compute_crc_static(&context->decompressor->crc_engine,
+			                                 uncomp_pkt_hdrs, crc_pkt->type,
+			                                 crc_computed);
 		rohc_decomp_debug(context, "compute CRC-STATIC-%d = 0x%x from packet",
 		                  crc_pkt->type, crc_computed);
 
@@ -5693,8 +5766,10 @@ static bool check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* compute the CRC on CRC-DYNAMIC fields of built uncompressed headers */
-	crc_computed = rfc3095_ctxt->compute_crc_dynamic(uncomp_pkt_hdrs,
-	                                                 crc_pkt->type, crc_computed);
+	crc_computed =
+		rfc3095_ctxt->compute_crc_dynamic(&context->decompressor->crc_engine,
+		                                  uncomp_pkt_hdrs, crc_pkt->type,
+		                                  crc_computed);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_pkt->type, crc_computed);
 
@@ -5938,6 +6013,10 @@ error:
  * Other fields may be decoded by the profile-specific callback named
  * decode_values_from_bits.
  *
+ * Upon CRC repair, the values decoded by the previous attempt are kept, and
+ * only the SN and the IP-IDs are decoded again with the new reference SN
+ * before the profile-specific callback is called again.
+ *
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
@@ -6006,9 +6085,20 @@ rohc_status_t rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const co
 		{
 			p = ROHC_LSB_SHIFT_SN;
 		}
-		decode_ok = rohc_lsb_decode(&rfc3095_ctxt->sn_lsb_ctxt, bits->lsb_ref_type,
-		                            bits->sn_ref_offset, bits->sn, bits->sn_nr,
-		                            p, &decoded->sn);
+		if(context->profile->id == ROHCv1_PROFILE_IP_ESP &&
+		   bits->lsb_ref_type == ROHC_LSB_REF_0 && bits->sn_ref_offset == 0 &&
+		   rohc_lsb_decode_next(&rfc3095_ctxt->sn_lsb_ctxt, bits->sn, bits->sn_nr,
+		                        p, &decoded->sn))
+		{
+			/* the ESP SNs are strictly increasing */
+			decode_ok = true;
+		}
+		else
+		{
+			decode_ok = rohc_lsb_decode(&rfc3095_ctxt->sn_lsb_ctxt, bits->lsb_ref_type,
+			                            bits->sn_ref_offset, bits->sn, bits->sn_nr,
+			                            p, &decoded->sn);
+		}
 		if(!decode_ok)
 		{
 			rohc_decomp_warn(context, "failed to decode %zu SN bits 0x%x",
@@ -6020,6 +6110,32 @@ rohc_status_t rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const co
 	                  "bits = %u / 0x%x)", decoded->sn, decoded->sn,
 	                  bits->sn_nr, bits->sn, bits->sn);
 
+	/* CRC repair: the packet was already fully decoded with the nominal
+	 * reference SN, only the SN changed since then, so decode again the
+	 * fields that depend on the SN only */
+	if(bits->lsb_ref_type != ROHC_LSB_REF_0 || bits->sn_ref_offset != 0)
+	{
+		rohc_decomp_debug(context, "CRC repair: decode again SN-related fields "
+		                  "only");
+		if(decoded->outer_ip.version == IPV4 &&
+		   bits->outer_ip.is_id_enc && !decoded->outer_ip.sid &&
+		   !decode_ip_id_from_bits(context, &rfc3095_ctxt->outer_ip_id_offset_ctxt,
+		                           decoded->sn, bits->lsb_ref_type,
+		                           &bits->outer_ip, "outer", &decoded->outer_ip))
+		{
+			goto error;
+		}
+		if(decoded->multiple_ip && decoded->inner_ip.version == IPV4 &&
+		   bits->inner_ip.is_id_enc && !decoded->inner_ip.sid &&
+		   !decode_ip_id_from_bits(context, &rfc3095_ctxt->inner_ip_id_offset_ctxt,
+		                           decoded->sn, bits->lsb_ref_type,
+		                           &bits->inner_ip, "inner", &decoded->inner_ip))
+		{
+			goto error;
+		}
+		goto next_header;
+	}
+
 	/* maybe current packet changed the number of IP headers */
 	decoded->multiple_ip = bits->multiple_ip;
 
@@ -6053,6 +6169,7 @@ rohc_status_t rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const co
 		}
 	}
 
+next_header:
 	/* decode fields of next header if required */
 	if(rfc3095_ctxt->decode_values_from_bits != NULL)
 	{
@@ -6071,6 +6188,121 @@ error:
 }
 
 
+/**
+ * @brief Decode one UO-0 packet of the steady state in one single pass
+ *
+ * In the steady state, most packets are UO-0 packets whose SN is the
+ * successor of the reference SN, and whose other fields are either
+ * unchanged or inferred from the SN. Parse, decode and build such packets
+ * without the generic pipeline: the UO-0 header is parsed directly, the SN
+ * is taken as the successor of the reference SN without interval decoding,
+ * the IP fields are copied from the headers of the context, and the
+ * uncompressed headers are built and checked against the CRC.
+ *
+ * Any other packet, or a packet that fails the CRC check, is left to the
+ * generic pipeline, that handles the CRC repair.
+ *
+ * @param decomp             The ROHC decompressor
+ * @param context            The decompression context
+ * @param rohc_packet        The ROHC packet to decode
+ * @param large_cid_len      The length of the optional large CID field
+ * @param packet_type        The type of the ROHC packet
+ * @param[out] extr_crc      The CRC bits extracted from the ROHC header
+ * @param[out] bits          The bits extracted from the ROHC header
+ * @param[out] decoded       The values decoded from the ROHC header
+ * @param[out] uncomp_hdrs   The uncompressed headers
+ * @param[out] rohc_hdr_len  The length of the ROHC header
+ * @return                   true if the packet was decoded,
+ *                           false if the generic pipeline shall decode it
+ */
+bool rfc3095_decomp_decode_fast(const struct rohc_decomp *const decomp,
+                                const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_buf rohc_packet,
+                                const size_t large_cid_len,
+                                const rohc_packet_t packet_type,
+                                struct rohc_decomp_crc *const extr_crc,
+                                struct rohc_extr_bits *const bits,
+                                struct rohc_decoded_values *const decoded,
+                                struct rohc_buf *const uncomp_hdrs,
+                                size_t *const rohc_hdr_len)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const size_t uncomp_hdrs_len_orig = uncomp_hdrs->len;
+	rohc_packet_t parsed_type = packet_type;
+	size_t uncomp_hdrs_len = 0;
+	rohc_status_t status;
+
+	if(packet_type != ROHC_PACKET_UO_0 || context->state != ROHC_DECOMP_STATE_FC)
+	{
+		goto fallback;
+	}
+
+	/* parse the UO-0 header and its remainder */
+	if(!parse_uo0(context, rohc_buf_data(rohc_packet), rohc_packet.len,
+	              large_cid_len, &parsed_type, extr_crc, bits, rohc_hdr_len))
+	{
+		goto fallback;
+	}
+
+	/* the 4 SN bits of UO-0 shall match the successor of the reference SN;
+	 * with k = 4, the successor is within the interpretation interval for the
+	 * shift parameters of all RFC3095 profiles (p = -1 or p = 1) */
+	decoded->sn = rohc_lsb_get_ref(&rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_0) + 1;
+	if(context->profile->id != ROHCv1_PROFILE_IP_ESP)
+	{
+		decoded->sn &= 0xffff;
+	}
+	if((decoded->sn & 0x0f) != bits->sn)
+	{
+		goto fallback;
+	}
+	rohc_decomp_debug(context, "fast path: decoded SN = %u / 0x%x is the "
+	                  "successor of the reference SN", decoded->sn, decoded->sn);
+
+	/* UO-0 packets carry neither mode nor IP field, but the random IP-IDs */
+	decoded->is_context_reused = false;
+	decoded->mode = context->mode;
+	decoded->multiple_ip = rfc3095_ctxt->multiple_ip;
+	if(!decode_ip_values_from_ctxt(context, rfc3095_ctxt->outer_ip_changes,
+	                               &rfc3095_ctxt->outer_ip_id_offset_ctxt,
+	                               decoded->sn, &bits->outer_ip, "outer",
+	                               &decoded->outer_ip))
+	{
+		goto fallback;
+	}
+	if(decoded->multiple_ip &&
+	   !decode_ip_values_from_ctxt(context, rfc3095_ctxt->inner_ip_changes,
+	                               &rfc3095_ctxt->inner_ip_id_offset_ctxt,
+	                               decoded->sn, &bits->inner_ip, "inner",
+	                               &decoded->inner_ip))
+	{
+		goto fallback;
+	}
+	if(rfc3095_ctxt->decode_values_from_bits != NULL &&
+	   !rfc3095_ctxt->decode_values_from_bits(context, bits, decoded))
+	{
+		goto fallback;
+	}
+
+	/* build the uncompressed headers from the templates of the context and
+	 * check them against the CRC */
+	status = rfc3095_decomp_build_hdrs(decomp, context, ROHC_PACKET_UO_0, extr_crc,
+	                                   decoded, rohc_packet.len - (*rohc_hdr_len) +
+	                                   decomp->chain_tail_len,
+	                                   uncomp_hdrs, &uncomp_hdrs_len);
+	if(status != ROHC_STATUS_OK)
+	{
+		goto fallback;
+	}
+
+	return true;
+
+fallback:
+	uncomp_hdrs->len = uncomp_hdrs_len_orig;
+	return false;
+}
+
+
 /**
  * @brief Decode IP values from extracted bits
  *
@@ -6261,40 +6493,10 @@ static bool decode_ip_values_from_bits(const struct rohc_decomp_ctxt *const cont
 			 * that is stored in the context */
 			decoded->id = ctxt->ip.header.v4.id;
 		}
-		else
+		else if(!decode_ip_id_from_bits(context, ip_id_decode, decoded_sn,
+		                                lsb_ref_type, bits, descr, decoded))
 		{
-			/* the IP-ID of the IPv4 header changed in a predictable way:
-			 * decode its new value with the help of the decoded SN and the
-			 * least-significant IP-ID bits transmitted in the ROHC header */
-			uint16_t decoded_id;
-			int ret;
-			rohc_decomp_debug(context, "decode %s IP-ID from %zu bits of IP-ID delta "
-			                  "0x%x and decoded SN = 0x%04x", descr, bits->id_nr,
-			                  bits->id, decoded_sn);
-			rohc_decomp_debug(context, "ref = 0x%x", rohc_lsb_get_ref(&ip_id_decode->lsb, lsb_ref_type));
-			ret = ip_id_offset_decode(ip_id_decode, lsb_ref_type, bits->id, bits->id_nr,
-			                          decoded_sn, &decoded_id);
-			if(ret != 1)
-			{
-				rohc_decomp_warn(context, "failed to decode %zu %s IP-ID bits "
-				                 "0x%x", bits->id_nr, descr, bits->id);
-				goto error;
-			}
-
-			/* RFC3095 §5.7: if value(NBO) = 0, the octets of hdr(IP-ID) are
-			 * swapped before compression and after decompression */
-			if(decoded->nbo == 0)
-			{
-				decoded->id = swab16(decoded_id);
-				rohc_decomp_debug(context, "%s IP-ID shall be swapped because NBO=0: "
-				                  "0x%04x -> 0x%04x", descr, decoded_id, decoded->id);
-			}
-			else
-			{
-				decoded->id = decoded_id;
-				rohc_decomp_debug(context, "%s IP-ID shall not be swapped because NBO=1: "
-				                  "0x%04x -> 0x%04x", descr, bits->id, decoded->id);
-			}
+			goto error;
 		}
 		rohc_decomp_debug(context, "decoded %s IP-ID = 0x%04x (rnd = %d, "
 		                  "nbo = %d, sid = %d, nr bits = %zd, bits = 0x%x)",
@@ -6439,6 +6641,139 @@ error:
 }
 
 
+/**
+ * @brief Decode IP values from the context for one UO-0 packet
+ *
+ * UO-0 packets transmit no IP field, but the random IP-IDs in the remainder
+ * of the header: all the other fields keep their context values, and the
+ * IP-ID of IPv4 headers is inferred from the SN. This is the result of
+ * \ref decode_ip_values_from_bits in that case, without testing every field.
+ *
+ * @param context       The decompression context
+ * @param ctxt          The decompression context for the IP header
+ * @param ip_id_decode  The context for decoding IP-ID offset
+ * @param decoded_sn    The SN that was decoded
+ * @param bits          The IP bits extracted from the UO-0 header
+ * @param descr         The description of the IP header
+ * @param decoded       OUT: The corresponding decoded IP values
+ * @return              true if decoding is successful, false otherwise
+ */
+static bool decode_ip_values_from_ctxt(const struct rohc_decomp_ctxt *const context,
+                                       const struct rohc_decomp_rfc3095_changes *const ctxt,
+                                       const struct ip_id_offset_decode *const ip_id_decode,
+                                       const uint32_t decoded_sn,
+                                       const struct rohc_extr_ip_bits *const bits,
+                                       const char *const descr,
+                                       struct rohc_decoded_ip_values *const decoded)
+{
+	decoded->version = bits->version;
+	decoded->tos = ip_get_tos(&ctxt->ip);
+	decoded->ttl = ip_get_ttl(&ctxt->ip);
+	decoded->proto = ip_get_protocol(&ctxt->ip);
+
+	if(decoded->version == IPV4)
+	{
+		decoded->nbo = ctxt->nbo;
+		decoded->rnd = ctxt->rnd;
+		decoded->sid = ctxt->sid;
+		if(!bits->is_id_enc)
+		{
+			/* random IP-ID transmitted verbatim in the remainder of header */
+			if(bits->id_nr != 16)
+			{
+				return false;
+			}
+			decoded->id = bits->id;
+		}
+		else if(decoded->sid)
+		{
+			/* constant IP-ID */
+			decoded->id = ctxt->ip.header.v4.id;
+		}
+		else if(!decode_ip_id_from_bits(context, ip_id_decode, decoded_sn,
+		                                ROHC_LSB_REF_0, bits, descr, decoded))
+		{
+			return false;
+		}
+		decoded->df = ctxt->ip.header.v4.df;
+		memcpy(decoded->saddr, &ctxt->ip.header.v4.saddr, 4);
+		memcpy(decoded->daddr, &ctxt->ip.header.v4.daddr, 4);
+	}
+	else /* IPV6 */
+	{
+		decoded->flowid = ipv6_get_flow_label(&ctxt->ip.header.v6);
+		memcpy(decoded->saddr, &ctxt->ip.header.v6.saddr, 16);
+		memcpy(decoded->daddr, &ctxt->ip.header.v6.daddr, 16);
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Decode the IP-ID of one IPv4 header from extracted bits
+ *
+ * The IP-ID of the IPv4 header changed in a predictable way: decode its new
+ * value with the help of the decoded SN and the least-significant IP-ID bits
+ * transmitted in the ROHC header.
+ *
+ * @param context       The decompression context
+ * @param ip_id_decode  The context for decoding IP-ID offset
+ * @param decoded_sn    The SN that was decoded
+ * @param lsb_ref_type  The reference value to use to decode LSB values
+ *                      (used for context repair upon CRC failure)
+ * @param bits          The IP bits extracted from ROHC header
+ * @param descr         The description of the IP header
+ * @param decoded       IN:  The decoded NBO flag of the IP header
+ *                      OUT: The decoded IP-ID of the IP header
+ * @return              true if decoding is successful, false otherwise
+ */
+static bool decode_ip_id_from_bits(const struct rohc_decomp_ctxt *const context,
+                                   const struct ip_id_offset_decode *const ip_id_decode,
+                                   const uint32_t decoded_sn,
+                                   const rohc_lsb_ref_t lsb_ref_type,
+                                   const struct rohc_extr_ip_bits *const bits,
+                                   const char *const descr,
+                                   struct rohc_decoded_ip_values *const decoded)
+{
+	uint16_t decoded_id;
+	int ret;
+
+	rohc_decomp_debug(context, "decode %s IP-ID from %zu bits of IP-ID delta "
+	                  "0x%x and decoded SN = 0x%04x", descr, bits->id_nr,
+	                  bits->id, decoded_sn);
+	rohc_decomp_debug(context, "ref = 0x%x", rohc_lsb_get_ref(&ip_id_decode->lsb, lsb_ref_type));
+	ret = ip_id_offset_decode(ip_id_decode, lsb_ref_type, bits->id, bits->id_nr,
+	                          decoded_sn, &decoded_id);
+	if(ret != 1)
+	{
+		rohc_decomp_warn(context, "failed to decode %zu %s IP-ID bits "
+		                 "0x%x", bits->id_nr, descr, bits->id);
+		goto error;
+	}
+
+	/* RFC3095 §5.7: if value(NBO) = 0, the octets of hdr(IP-ID) are
+	 * swapped before compression and after decompression */
+	if(decoded->nbo == 0)
+	{
+		decoded->id = swab16(decoded_id);
+		rohc_decomp_debug(context, "%s IP-ID shall be swapped because NBO=0: "
+		                  "0x%04x -> 0x%04x", descr, decoded_id, decoded->id);
+	}
+	else
+	{
+		decoded->id = decoded_id;
+		rohc_decomp_debug(context, "%s IP-ID shall not be swapped because NBO=1: "
+		                  "0x%04x -> 0x%04x", descr, bits->id, decoded->id);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Update context with decoded values
  *
@@ -6463,6 +6798,7 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
                                 bool *const do_change_mode)
 {
 	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	struct ipv4_hdr old_ipv4; /* to update the IPv4 checksums of the context */
 	bool keep_ref_minus_1; /* for action upon CRC failure */
 
 	/* action upon CRC failure: in case of incorrect SN updates, ref-1 shall not
@@ -6585,6 +6921,8 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->multiple_ip = decoded->multiple_ip;
 
 	/* update fields related to the outer IP header */
+	memcpy(&old_ipv4, &rfc3095_ctxt->outer_ip_changes->ip.header.v4,
+	       sizeof(struct ipv4_hdr));
 	ip_set_version(&rfc3095_ctxt->outer_ip_changes->ip, decoded->outer_ip.version);
 	ip_set_protocol(&rfc3095_ctxt->outer_ip_changes->ip, decoded->outer_ip.proto);
 	ip_set_tos(&rfc3095_ctxt->outer_ip_changes->ip, decoded->outer_ip.tos);
@@ -6599,13 +6937,21 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 		rohc_decomp_debug(context, "outer IP-ID delta 0x%04x - 0x%04x = 0x%04x "
 		                  "is the new reference", decoded->outer_ip.id, decoded->sn,
 		                  decoded->outer_ip.id - decoded->sn);
+		/* the IPv4 header of the context is the template of the next IPv4
+		 * headers to build, so keep the static-known fields there too */
+		rfc3095_ctxt->outer_ip_changes->ip.header.v4.version = IPV4;
+		rfc3095_ctxt->outer_ip_changes->ip.header.v4.ihl = 5;
+		rfc3095_ctxt->outer_ip_changes->ip.header.v4.frag_off = 0;
 		rfc3095_ctxt->outer_ip_changes->ip.header.v4.df = decoded->outer_ip.df;
 		rfc3095_ctxt->outer_ip_changes->nbo = decoded->outer_ip.nbo;
 		rfc3095_ctxt->outer_ip_changes->rnd = decoded->outer_ip.rnd;
 		rfc3095_ctxt->outer_ip_changes->sid = decoded->outer_ip.sid;
+		rfc3095_decomp_update_ipv4_check(rfc3095_ctxt->outer_ip_changes, &old_ipv4);
 	}
 	else /* IPV6 */
 	{
+		rfc3095_ctxt->outer_ip_changes->is_ipv4_check_valid = false;
+		rfc3095_ctxt->outer_ip_changes->ip.header.v6.version = IPV6;
 		ipv6_set_flow_label(&rfc3095_ctxt->outer_ip_changes->ip.header.v6, 
 		                    decoded->outer_ip.flowid);
 	}
@@ -6613,6 +6959,8 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	/* update fields related to the inner IP header (if any) */
 	if(rfc3095_ctxt->multiple_ip)
 	{
+		memcpy(&old_ipv4, &rfc3095_ctxt->inner_ip_changes->ip.header.v4,
+		       sizeof(struct ipv4_hdr));
 		ip_set_version(&rfc3095_ctxt->inner_ip_changes->ip, decoded->inner_ip.version);
 		ip_set_protocol(&rfc3095_ctxt->inner_ip_changes->ip, decoded->inner_ip.proto);
 		ip_set_tos(&rfc3095_ctxt->inner_ip_changes->ip, decoded->inner_ip.tos);
@@ -6627,13 +6975,21 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 			rohc_decomp_debug(context, "inner IP-ID delta 0x%04x - 0x%04x = 0x%04x "
 			                  "is the new reference", decoded->inner_ip.id, decoded->sn,
 			                  decoded->inner_ip.id - decoded->sn);
+			/* the IPv4 header of the context is the template of the next IPv4
+			 * headers to build, so keep the static-known fields there too */
+			rfc3095_ctxt->inner_ip_changes->ip.header.v4.version = IPV4;
+			rfc3095_ctxt->inner_ip_changes->ip.header.v4.ihl = 5;
+			rfc3095_ctxt->inner_ip_changes->ip.header.v4.frag_off = 0;
 			rfc3095_ctxt->inner_ip_changes->ip.header.v4.df = decoded->inner_ip.df;
 			rfc3095_ctxt->inner_ip_changes->nbo = decoded->inner_ip.nbo;
 			rfc3095_ctxt->inner_ip_changes->rnd = decoded->inner_ip.rnd;
 			rfc3095_ctxt->inner_ip_changes->sid = decoded->inner_ip.sid;
+			rfc3095_decomp_update_ipv4_check(rfc3095_ctxt->inner_ip_changes, &old_ipv4);
 		}
 		else /* IPV6 */
 		{
+			rfc3095_ctxt->inner_ip_changes->is_ipv4_check_valid = false;
+			rfc3095_ctxt->inner_ip_changes->ip.header.v6.version = IPV6;
 			ipv6_set_flow_label(&rfc3095_ctxt->inner_ip_changes->ip.header.v6, 
 			                    decoded->inner_ip.flowid);
 		}
@@ -6648,25 +7004,71 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Update the checksum of the IPv4 header kept in context
+ *
+ * The checksum is computed over the whole header the first time only, it is
+ * then updated with the fields that changed.
+ *
+ * @param ip_changes  The changes of the IPv4 header kept in context
+ * @param old_ipv4    The IPv4 header kept in context before its update
+ */
+static void rfc3095_decomp_update_ipv4_check(struct rohc_decomp_rfc3095_changes *const ip_changes,
+                                             const struct ipv4_hdr *const old_ipv4)
+{
+	struct ipv4_hdr *const ipv4 = &ip_changes->ip.header.v4;
+
+	if(ip_changes->is_ipv4_check_valid)
+	{
+		ipv4->check = ipv4_csum_update(old_ipv4->check, (const uint8_t *) old_ipv4,
+		                               (const uint8_t *) ipv4);
+	}
+	else
+	{
+		ipv4->check = 0;
+		ipv4->check = ip_fast_csum((const uint8_t *) ipv4, ipv4->ihl);
+		ip_changes->is_ipv4_check_valid = true;
+	}
+}
+
+
 /**
  * @brief Reset the extracted bits for next parsing
  *
+ * Only the sizes and the flags are reset: a field is present in the packet
+ * only if its number of bits is non-zero, so the value of a field that the
+ * packet does not carry is never read. The cost of the reset does not
+ * depend on the fields of the largest packets then. The CCE-related
+ * variables are kept unchanged.
+ *
  * @param rfc3095_ctxt  The generic decompression context
  * @param[out] bits     The extracted bits to reset
  */
 static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                             struct rohc_extr_bits *const bits)
 {
-	/* set every bits and sizes to 0 except for CCE-related variables */
-	{
-		const rohc_packet_cce_t cce_pkt = bits->cce_pkt;
-		const rohc_tristate_t cfp = bits->cfp;
-		const rohc_tristate_t cfi = bits->cfi;
-		memset(bits, 0, sizeof(struct rohc_extr_bits));
-		bits->cce_pkt = cce_pkt;
-		bits->cfp = cfp;
-		bits->cfi = cfi;
-	}
+	/* set every sizes to 0 */
+	bits->sn_nr = 0;
+	bits->is_sn_enc = false;
+	reset_extr_ip_bits(&bits->outer_ip);
+	reset_extr_ip_bits(&bits->inner_ip);
+	bits->ext_flag = 0;
+	bits->mode_nr = 0;
+	bits->udp_src_nr = 0;
+	bits->udp_dst_nr = 0;
+	bits->udp_check_present = ROHC_TRISTATE_NONE;
+	bits->udp_check_nr = 0;
+	bits->udp_lite_cc_nr = 0;
+	bits->rtp_version_nr = 0;
+	bits->rtp_p_nr = 0;
+	bits->rtp_x_nr = 0;
+	bits->rtp_cc_nr = 0;
+	bits->rtp_m_nr = 0;
+	bits->rtp_pt_nr = 0;
+	bits->ts_nr = 0;
+	bits->rtp_ssrc_nr = 0;
+	bits->time_stride_nr = 0;
+	bits->esp_spi_nr = 0;
 
 	/* by default, use ref 0 for LSB decoding (ref -1 will be used only for
 	 * correction upon CRC failure) */
@@ -6708,3 +7110,31 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 	bits->is_ts_scaled = true;
 }
 
+
+/**
+ * @brief Reset the bits extracted for one IP header for next parsing
+ *
+ * See \ref reset_extr_bits for details.
+ *
+ * @param[out] ip_bits  The extracted IP bits to reset
+ */
+static void reset_extr_ip_bits(struct rohc_extr_ip_bits *const ip_bits)
+{
+	ip_bits->version = 0;
+	ip_bits->static_chain_end = false;
+	ip_bits->tos_nr = 0;
+	ip_bits->id_nr = 0;
+	ip_bits->is_id_enc = false;
+	ip_bits->df_nr = 0;
+	ip_bits->ttl_nr = 0;
+	ip_bits->proto_nr = 0;
+	ip_bits->nbo = 0;
+	ip_bits->nbo_nr = 0;
+	ip_bits->rnd = 0;
+	ip_bits->rnd_nr = 0;
+	ip_bits->sid_nr = 0;
+	ip_bits->flowid_nr = 0;
+	ip_bits->saddr_nr = 0;
+	ip_bits->daddr_nr = 0;
+}
+
@@ -216,6 +216,11 @@ struct rohc_extr_bits
 	                             IR header */
 	size_t rtp_ssrc_nr;     /**< The number of SSRC bits found in header */
 
+	/* RTP TIME_STRIDE */
+	uint32_t time_stride;   /**< The TIME_STRIDE found in dynamic chain of
+	                             IR/IR-DYN header or in extension header */
+	size_t time_stride_nr;  /**< The number of TIME_STRIDE bits found */
+
 
 	/* bits below are for ESP profile only
 	   @todo TODO should be moved in d_esp.c */
@@ -291,6 +296,7 @@ struct rohc_decoded_values
 	uint8_t rtp_pt:7;       /**< The decoded RTP Payload Type (RTP-PT) */
 	uint32_t ts;            /**< The decoded RTP TimeStamp (TS) value */
 	uint32_t rtp_ssrc;      /**< The decoded SSRC value */
+	uint32_t time_stride;   /**< The decoded TIME_STRIDE, 0 if not received */
 
 	/* bits below are for ESP profile only
 	   @todo TODO should be moved in d_esp.c */
@@ -317,6 +323,8 @@ struct rohc_decomp_rfc3095_changes
 	int nbo;
 	/// Whether the IP-ID is considered as static or not (IPv4 only)
 	int sid;
+	/// Whether the checksum of the IP header is up to date (IPv4 only)
+	bool is_ipv4_check_valid;
 
 	/// The next header located after the IP header(s)
 	void *next_header;
@@ -425,16 +433,18 @@ struct rohc_decomp_rfc3095_ctxt
 	                         const unsigned int payload_len);
 
 	/// @brief The handler used to compute the CRC-STATIC value
-	uint8_t (*compute_crc_static)(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+	uint8_t (*compute_crc_static)(const struct rohc_crc_engine *const crc_engine,
+	                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
 	                              const rohc_crc_type_t crc_type,
 	                              const uint8_t init_val)
-		__attribute__((warn_unused_result, nonnull(1)));
+		__attribute__((warn_unused_result, nonnull(1, 2)));
 
 	/// @brief The handler used to compute the CRC-DYNAMIC value
-	uint8_t (*compute_crc_dynamic)(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+	uint8_t (*compute_crc_dynamic)(const struct rohc_crc_engine *const crc_engine,
+	                               const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
 	                               const rohc_crc_type_t crc_type,
 	                               const uint8_t init_val)
-		__attribute__((warn_unused_result, nonnull(1)));
+		__attribute__((warn_unused_result, nonnull(1, 2)));
 
 	/** The handler used to update context with decoded next header fields */
 	void (*update_context)(struct rohc_decomp_ctxt *const context,
@@ -446,21 +456,38 @@ struct rohc_decomp_rfc3095_ctxt
 };
 
 
+/**
+ * @brief The length of the persistent context of one RFC3095-based profile
+ *
+ * The generic context, the changes of the outer and inner IP headers, the
+ * profile-specific data and the next headers of the IP headers changes are
+ * all carved from the same memory block by \ref rohc_decomp_rfc3095_create.
+ *
+ * @param specific_len     The length of the profile-specific data
+ * @param next_header_len  The length of the header after the IP header(s)
+ */
+#define ROHC_DECOMP_RFC3095_CTXT_LEN(specific_len, next_header_len) \
+	(rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_rfc3095_ctxt)) + \
+	 2 * rohc_decomp_ctxt_part_len(sizeof(struct rohc_decomp_rfc3095_changes)) + \
+	 rohc_decomp_ctxt_part_len(specific_len) + \
+	 2 * rohc_decomp_ctxt_part_len(next_header_len))
+
+
 /*
  * Public function prototypes.
  */
 
-bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
-                                struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
+void rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
+                                struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                 struct rohc_decomp_volat_ctxt *const volat_ctxt,
-                                rohc_trace_callback2_t trace_cb,
-                                void *const trace_cb_priv,
-                                const int profile_id)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                const size_t specific_len,
+                                const size_t next_header_len)
+	__attribute__((nonnull(1, 2, 3)));
 
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+void rohc_decomp_rfc3095_free(const struct rohc_decomp_ctxt *const context,
+                              void *const persist_ctxt,
+                              const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((nonnull(1, 2, 3)));
 
 bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_buf rohc_packet,
@@ -496,6 +523,18 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
                                         size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
 
+bool rfc3095_decomp_decode_fast(const struct rohc_decomp *const decomp,
+                                const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_buf rohc_packet,
+                                const size_t large_cid_len,
+                                const rohc_packet_t packet_type,
+                                struct rohc_decomp_crc *const extr_crc,
+                                struct rohc_extr_bits *const bits,
+                                struct rohc_decoded_values *const decoded,
+                                struct rohc_buf *const uncomp_hdrs,
+                                size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8, 9, 10)));
+
 rohc_status_t rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
                                          const struct rohc_extr_bits *const bits,
                                          const size_t payload_len,
@@ -518,6 +557,9 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 uint32_t rohc_decomp_rfc3095_get_sn(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+uint32_t rohc_decomp_rfc3095_get_decoded_sn(const struct rohc_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 
 
 /*
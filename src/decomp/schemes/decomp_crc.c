@@ -32,6 +32,10 @@
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
+ * The TCP and ROHCv2 profiles compute the CRC over the uncompressed headers
+ * in their wire order, so there is no static part to cache the CRC for,
+ * unlike the CRC-STATIC fields of the RFC 3095 profiles.
+ *
  * @param context      The decompression context
  * @param uncomp_hdrs  The uncompressed headers
  * @param crc_pkt      The CRC over uncompressed headers extracted from packet
@@ -65,8 +69,9 @@ bool rohc_decomp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
 
 	/* compute the CRC from built uncompressed headers */
 	crc_computed =
-		crc_calculate(crc_pkt->type, rohc_buf_data(*uncomp_hdrs), uncomp_hdrs->len,
-		              crc_computed);
+		crc_engine_calc(&context->decompressor->crc_engine,
+		                crc_pkt->type, rohc_buf_data(*uncomp_hdrs), uncomp_hdrs->len,
+		                crc_computed);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_pkt->type, crc_computed);
 
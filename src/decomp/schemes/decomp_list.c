@@ -39,6 +39,10 @@ static int rohc_list_decode(struct list_decomp *decomp,
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 
+static void rohc_list_cache_chain(struct list_decomp *const decomp)
+	__attribute__((nonnull(1)));
+
+
 /* decode the 4 types of compressed lists */
 
 static int rohc_list_decode_type_0(struct list_decomp *const decomp,
@@ -208,6 +212,7 @@ static int rohc_list_decode(struct list_decomp *decomp,
 
 	/* reset the list of the current packet */
 	rohc_list_reset(&decomp->pkt_list);
+	decomp->chain_valid = false;
 
 	/* is there enough data in packet for the ET, PS, m/XI1 and gen_id
 	 * fields? */
@@ -299,15 +304,15 @@ static int rohc_list_decode(struct list_decomp *decomp,
 		 * window of lists */
 		rd_list_debug(decomp, "anonymous list was received");
 	}
-	else if(decomp->lists[gen_id].counter > 0)
+	else if(decomp->lists[gen_id] != NULL && decomp->lists[gen_id]->counter > 0)
 	{
 		/* list is identified by a gen_id, but the sliding window of lists
 		 * already contain a list with that generation identifier, so do
 		 * not update the sliding window of lists */
-		decomp->lists[gen_id].counter++;
+		decomp->lists[gen_id]->counter++;
 		rd_list_debug(decomp, "list with gen_id %u is already present in "
 		              "reference lists (received for the #%u times)",
-		              gen_id, decomp->lists[gen_id].counter);
+		              gen_id, decomp->lists[gen_id]->counter);
 	}
 	else
 	{
@@ -316,13 +321,27 @@ static int rohc_list_decode(struct list_decomp *decomp,
 		 * the sliding window of lists */
 		rd_list_debug(decomp, "list with gen_id %u is not present yet in "
 		              "reference lists, add it", gen_id);
-		memcpy(decomp->lists[gen_id].items, decomp->pkt_list.items,
+		if(decomp->lists[gen_id] == NULL)
+		{
+			decomp->lists[gen_id] = rohc_list_new(decomp->mempool, gen_id);
+			if(decomp->lists[gen_id] == NULL)
+			{
+				rd_list_warn(decomp, "failed to allocate list with gen_id %u",
+				             gen_id);
+				goto error;
+			}
+		}
+		memcpy(decomp->lists[gen_id]->items, decomp->pkt_list.items,
 		       ROHC_LIST_ITEMS_MAX * sizeof(struct decomp_list *));
-		decomp->lists[gen_id].items_nr = decomp->pkt_list.items_nr;
-		decomp->lists[gen_id].counter = 1;
+		decomp->lists[gen_id]->items_nr = decomp->pkt_list.items_nr;
+		decomp->lists[gen_id]->counter = 1;
 		/* TODO: remove all lists with gen_id < ref_id */
 	}
 
+	/* the list and its items may have changed, serialize them once for all
+	 * the next packets that do not transmit the list */
+	rohc_list_cache_chain(decomp);
+
 	return read_length;
 
 error:
@@ -330,6 +349,109 @@ error:
 }
 
 
+/**
+ * @brief Serialize the items of the packet list in the chain of the context
+ *
+ * The chain is left invalid if memory is missing: the uncompressed items are
+ * then built one by one for every packet.
+ *
+ * @param decomp  The list decompressor
+ */
+static void rohc_list_cache_chain(struct list_decomp *const decomp)
+{
+	size_t chain_len = 0;
+	size_t i;
+
+	assert(!decomp->chain_valid);
+
+	for(i = 0; i < decomp->pkt_list.items_nr; i++)
+	{
+		chain_len += decomp->pkt_list.items[i]->length;
+	}
+	if(chain_len > decomp->chain_max_len)
+	{
+		/* round the new length up to the size class of the memory pool, so
+		 * that the chain may grow a little without allocating again */
+		size_t chain_max_len = ROHC_MEMPOOL_OBJ_MIN_LEN;
+		uint8_t *chain;
+
+		while(chain_max_len < chain_len)
+		{
+			chain_max_len <<= 1;
+		}
+		chain = rohc_mempool_alloc(decomp->mempool, chain_max_len);
+		if(chain == NULL)
+		{
+			rd_list_debug(decomp, "no memory for the %zu-byte chain of items, "
+			              "build items one by one", chain_len);
+			return;
+		}
+		if(decomp->chain != NULL)
+		{
+			rohc_mempool_release(decomp->mempool, decomp->chain,
+			                     decomp->chain_max_len);
+		}
+		decomp->chain = chain;
+		decomp->chain_max_len = chain_max_len;
+	}
+
+	if(chain_len > 0)
+	{
+		if(decomp->build_uncomp_item(decomp, 0, decomp->chain) != chain_len)
+		{
+			rd_list_warn(decomp, "failed to serialize the %zu-byte chain of "
+			             "items, build items one by one", chain_len);
+			return;
+		}
+		decomp->chain_last_off =
+			chain_len - decomp->pkt_list.items[decomp->pkt_list.items_nr - 1]->length;
+	}
+	else
+	{
+		decomp->chain_last_off = 0;
+	}
+	decomp->chain_len = chain_len;
+	decomp->chain_valid = true;
+}
+
+
+/**
+ * @brief Build the uncompressed items of the packet list
+ *
+ * The items are copied at once from the chain of the context if it is valid,
+ * they are built one by one otherwise.
+ *
+ * @param decomp      The list decompressor
+ * @param ip_nh_type  The Next Header value of the last item
+ * @param dest        The buffer to store the uncompressed items
+ * @return            The length of the uncompressed items (in bytes)
+ */
+size_t rohc_decomp_list_build(const struct list_decomp *const decomp,
+                              const uint8_t ip_nh_type,
+                              uint8_t *const dest)
+{
+	size_t len;
+
+	if(decomp->chain_valid)
+	{
+		if(decomp->chain_len > 0)
+		{
+			memcpy(dest, decomp->chain, decomp->chain_len);
+			dest[decomp->chain_last_off] = ip_nh_type;
+		}
+		len = decomp->chain_len;
+		rd_list_debug(decomp, "copy the %zu-byte chain of %u items",
+		              len, decomp->pkt_list.items_nr);
+	}
+	else
+	{
+		len = decomp->build_uncomp_item(decomp, ip_nh_type, dest);
+	}
+
+	return len;
+}
+
+
 /**
  * @brief Create a list item from a XI item
  *
@@ -613,7 +735,7 @@ static int rohc_list_decode_type_1(struct list_decomp *const decomp,
 		goto error;
 	}
 	/* reference list must not be empty (RFC 4815, §5.7) */
-	if(decomp->lists[ref_id].items_nr == 0)
+	if(decomp->lists[ref_id]->items_nr == 0)
 	{
 		rd_list_warn(decomp, "list encoding type 1 must not be used with an "
 		             "empty reference list, discard packet");
@@ -622,7 +744,7 @@ static int rohc_list_decode_type_1(struct list_decomp *const decomp,
 
 	/* insertion scheme */
 	ret = rohc_list_parse_insertion_scheme(decomp, packet, packet_len, ps, xi_1, 0,
-	                                       &(decomp->lists[ref_id]),
+	                                       decomp->lists[ref_id],
 	                                       &decomp->pkt_list);
 	if(ret < 0)
 	{
@@ -698,7 +820,7 @@ static int rohc_list_decode_type_2(struct list_decomp *const decomp,
 		goto error;
 	}
 	/* reference list must not be empty (RFC 4815, §5.7) */
-	if(decomp->lists[ref_id].items_nr == 0)
+	if(decomp->lists[ref_id]->items_nr == 0)
 	{
 		rd_list_warn(decomp, "list encoding type 2 must not be used with an "
 		             "empty reference list, discard packet");
@@ -707,7 +829,7 @@ static int rohc_list_decode_type_2(struct list_decomp *const decomp,
 
 	/* removal scheme */
 	ret = rohc_list_parse_removal_scheme(decomp, packet, packet_len,
-	                                     &(decomp->lists[ref_id]),
+	                                     decomp->lists[ref_id],
 	                                     &(decomp->pkt_list));
 	if(ret < 0)
 	{
@@ -799,7 +921,7 @@ static int rohc_list_decode_type_3(struct list_decomp *const decomp,
 		goto error;
 	}
 	/* reference list must not be empty (RFC 4815, §5.7) */
-	if(decomp->lists[ref_id].items_nr == 0)
+	if(decomp->lists[ref_id]->items_nr == 0)
 	{
 		rd_list_warn(decomp, "list encoding type 3 must not be used with an "
 		             "empty reference list, discard packet");
@@ -809,7 +931,7 @@ static int rohc_list_decode_type_3(struct list_decomp *const decomp,
 	/* removal scheme */
 	rohc_list_reset(&removal_list);
 	ret = rohc_list_parse_removal_scheme(decomp, packet, packet_len,
-	                                     &(decomp->lists[ref_id]), &removal_list);
+	                                     decomp->lists[ref_id], &removal_list);
 	if(ret < 0)
 	{
 		if(gen_id == ROHC_LIST_GEN_ID_ANON)
@@ -870,7 +992,8 @@ static bool rohc_list_is_gen_id_known(const struct list_decomp *const decomp,
                                       const unsigned int gen_id)
 {
 	return (gen_id <= ROHC_LIST_GEN_ID_MAX &&
-	        decomp->lists[gen_id].counter > 0);
+	        decomp->lists[gen_id] != NULL &&
+	        decomp->lists[gen_id]->counter > 0);
 }
 
 
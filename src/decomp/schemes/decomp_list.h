@@ -53,12 +53,30 @@ struct list_decomp
 	/** The translation table */
 	struct rohc_list_item trans_table[ROHC_LIST_MAX_ITEM];
 
-	/** All the possible named lists, indexed by gen_id */
-	struct rohc_list lists[ROHC_LIST_GEN_ID_MAX + 1];
+	/** All the possible named lists, indexed by gen_id, allocated upon
+	 *  first reception, NULL if never received */
+	struct rohc_list *lists[ROHC_LIST_GEN_ID_MAX + 1];
+
+	/** The memory pool the lists and the item data are allocated from */
+	struct rohc_mempool *mempool;
 
 	/** The temporary packet list (not persistent across packets) */
 	struct rohc_list pkt_list;
 
+	/** The uncompressed bytes of the items of the packet list, rebuilt every
+	 *  time a list is received, allocated from the memory pool upon first
+	 *  use: the Next Header of the last item is set when the chain is copied
+	 *  in the uncompressed header */
+	uint8_t *chain;
+	/** The length of the memory allocated for the chain (in bytes) */
+	uint16_t chain_max_len;
+	/** The length of the chain (in bytes) */
+	uint16_t chain_len;
+	/** The offset of the last item in the chain (in bytes) */
+	uint16_t chain_last_off;
+	/** Whether the chain matches the packet list and its items */
+	bool chain_valid;
+
 
 	/* Functions for handling the data to decompress */
 
@@ -90,6 +108,8 @@ struct list_decomp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces given to the callback function */
+	rohc_trace_level_t trace_level;
 	/** The profile ID the decompression list was created for */
 	int profile_id;
 };
@@ -105,6 +125,11 @@ int rohc_list_decode_maybe(struct list_decomp *const decomp,
                            const size_t packet_len)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+size_t rohc_decomp_list_build(const struct list_decomp *const decomp,
+                              const uint8_t ip_nh_type,
+                              uint8_t *const dest)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
 bool rohc_decomp_list_create_item(struct list_decomp *const decomp,
                                   const unsigned int xi_index,
                                   const unsigned int xi_index_value,
@@ -60,16 +60,25 @@ static size_t rohc_build_ip6_extension(const struct list_decomp *const decomp,
 /**
  * @brief Init one context for decompressing lists of IPv6 extension headers
  *
+ * The context is expected to be zeroed: lists and item data are allocated
+ * from the given memory pool upon first reception only.
+ *
  * @param decomp         The context to create
+ * @param mempool        The memory pool to allocate lists and items from
  * @param trace_cb       The function to call for printing traces
  * @param trace_cb_priv  An optional private context, may be NULL
+ * @param trace_level    The lowest level of the traces to print
  * @param profile_id     The ID of the associated decompression profile
  */
 void rohc_decomp_list_ipv6_init(struct list_decomp *const decomp,
+                                struct rohc_mempool *const mempool,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_level,
                                 const int profile_id)
 {
+	decomp->mempool = mempool;
+
 	/* specific callbacks for IPv6 extension headers */
 	decomp->check_item = check_ip6_item;
 	decomp->get_item_size = get_ip6_ext_size;
@@ -80,10 +89,44 @@ void rohc_decomp_list_ipv6_init(struct list_decomp *const decomp,
 	/* traces */
 	decomp->trace_callback = trace_cb;
 	decomp->trace_callback_priv = trace_cb_priv;
+	decomp->trace_level = trace_level;
 	decomp->profile_id = profile_id;
 }
 
 
+/**
+ * @brief Free the lists and items of one context for decompressing lists of
+ *        IPv6 extension headers
+ *
+ * @param decomp  The context to free
+ */
+void rohc_decomp_list_ipv6_free(struct list_decomp *const decomp)
+{
+	size_t i;
+
+	for(i = 0; i <= ROHC_LIST_GEN_ID_MAX; i++)
+	{
+		if(decomp->lists[i] != NULL)
+		{
+			rohc_list_free(decomp->mempool, decomp->lists[i]);
+			decomp->lists[i] = NULL;
+		}
+	}
+	for(i = 0; i < ROHC_LIST_MAX_ITEM; i++)
+	{
+		rohc_list_item_free(decomp->mempool, &decomp->trans_table[i]);
+	}
+	if(decomp->chain != NULL)
+	{
+		rohc_mempool_release(decomp->mempool, decomp->chain,
+		                     decomp->chain_max_len);
+		decomp->chain = NULL;
+		decomp->chain_max_len = 0;
+	}
+	decomp->chain_valid = false;
+}
+
+
 /**
  * @brief Check if the item is correct in IPv6 table
  *
@@ -187,7 +230,7 @@ static bool create_ip6_item(const uint8_t *const data,
 
 	rd_list_debug(decomp, "update %zu-byte item #%zu (type %u/0x%02x) "
 	              "in translation table", length, index_table, item_type, item_type);
-	ret = rohc_list_item_update_if_changed(decomp->cmp_item,
+	ret = rohc_list_item_update_if_changed(decomp->cmp_item, decomp->mempool,
 	                                       &decomp->trans_table[index_table],
 	                                       item_type, data, length);
 	if(ret < 0)
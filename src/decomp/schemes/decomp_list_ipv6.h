@@ -29,9 +29,14 @@
 #include "schemes/decomp_list.h"
 
 void rohc_decomp_list_ipv6_init(struct list_decomp *const decomp,
+                                struct rohc_mempool *const mempool,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_level,
                                 const int profile_id)
+	__attribute__((nonnull(1, 2)));
+
+void rohc_decomp_list_ipv6_free(struct list_decomp *const decomp)
 	__attribute__((nonnull(1)));
 
 #endif
@@ -48,14 +48,19 @@
  * @param[in,out] ts_scaled  The scaled RTP Timestamp decoding context to init
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
+ * @param trace_level        The lowest level of the traces to print
  */
 void d_init_sc(struct ts_sc_decomp *const ts_scaled,
                rohc_trace_callback2_t trace_cb,
-               void *const trace_cb_priv)
+               void *const trace_cb_priv,
+               const rohc_trace_level_t trace_level)
 {
 	ts_scaled->ts_stride = 0;
+	ts_scaled->ts_stride_div.divisor = 0;
 	ts_scaled->ts_scaled = 0;
 	ts_scaled->ts_offset = 0;
+	ts_scaled->time_stride = 0;
+	ts_scaled->time = 0;
 
 	ts_scaled->old_ts = 0;
 	ts_scaled->old_sn = 0;
@@ -65,12 +70,14 @@ void d_init_sc(struct ts_sc_decomp *const ts_scaled,
 	ts_scaled->new_ts_stride = 0;
 	ts_scaled->new_ts_scaled = 0;
 	ts_scaled->new_ts_offset = 0;
+	ts_scaled->new_time_stride = 0;
 
 	rohc_lsb_init(&ts_scaled->lsb_ts_scaled, 32);
 	rohc_lsb_init(&ts_scaled->lsb_ts_unscaled, 32);
 
 	ts_scaled->trace_callback = trace_cb;
 	ts_scaled->trace_callback_priv = trace_cb_priv;
+	ts_scaled->trace_level = trace_level;
 }
 
 
@@ -80,10 +87,12 @@ void d_init_sc(struct ts_sc_decomp *const ts_scaled,
  * @param ts_sc  The ts_sc_decomp object
  * @param ts     The new decoded TimeStamp (TS)
  * @param sn     The new decoded Sequence Number (SN)
+ * @param time   The arrival time (in milliseconds) of the packet
  */
 void ts_update_context(struct ts_sc_decomp *const ts_sc,
                        const uint32_t ts,
-                       const uint16_t sn)
+                       const uint16_t sn,
+                       const uint32_t time)
 {
 	/* replace the old TS/SN with the new ones, keep backup of the old ones */
 	ts_sc->old_ts = ts_sc->ts;
@@ -110,6 +119,18 @@ void ts_update_context(struct ts_sc_decomp *const ts_sc,
 		ts_debug(ts_sc, "old TS_STRIDE %u replaced by new TS_STRIDE %u",
 		         ts_sc->ts_stride, ts_sc->new_ts_stride);
 		ts_sc->ts_stride = ts_sc->new_ts_stride;
+		if(ts_sc->ts_stride != 0)
+		{
+			rohc_div32_init(&ts_sc->ts_stride_div, ts_sc->ts_stride);
+
+			/* TS_SCALED changes meaning, so does TIME_STRIDE */
+			if(ts_sc->time_stride != 0)
+			{
+				ts_debug(ts_sc, "TS_STRIDE changed, forget TIME_STRIDE %u",
+				         ts_sc->time_stride);
+				ts_sc->time_stride = 0;
+			}
+		}
 	}
 	else
 	{
@@ -126,10 +147,19 @@ void ts_update_context(struct ts_sc_decomp *const ts_sc,
 		ts_debug(ts_sc, "old TS_OFFSET %u kept unchanged", ts_sc->ts_offset);
 	}
 
+	if(ts_sc->new_time_stride != 0)
+	{
+		ts_debug(ts_sc, "TIME_STRIDE %u replaced by new TIME_STRIDE %u",
+		         ts_sc->time_stride, ts_sc->new_time_stride);
+		ts_sc->time_stride = ts_sc->new_time_stride;
+	}
+	ts_sc->time = time;
+
 	/* reset all the new TS_* values */
 	ts_sc->new_ts_scaled = 0;
 	ts_sc->new_ts_stride = 0;
 	ts_sc->new_ts_offset = 0;
+	ts_sc->new_time_stride = 0;
 
 	/* update the LSB objects for unscaled TS and TS_SCALED */
 	rohc_lsb_set_ref(&ts_sc->lsb_ts_unscaled, ts_sc->ts, false);
@@ -151,6 +181,20 @@ void d_record_ts_stride(struct ts_sc_decomp *const ts_sc,
 }
 
 
+/**
+ * @brief Store the newly-received TIME_STRIDE value
+ *
+ * @param ts_sc        The ts_sc_decomp object
+ * @param time_stride  The TIME_STRIDE value (in milliseconds) to add
+ */
+void d_record_time_stride(struct ts_sc_decomp *const ts_sc,
+                          const uint32_t time_stride)
+{
+	ts_debug(ts_sc, "new TIME_STRIDE %u recorded", time_stride);
+	ts_sc->new_time_stride = time_stride;
+}
+
+
 /**
  * @brief Decode timestamp (TS) value with some LSB bits of the unscaled value
  *
@@ -222,13 +266,20 @@ bool ts_decode_unscaled_bits(struct ts_sc_decomp *const ts_sc,
 
 	if(effective_ts_stride != 0)
 	{
-		/* compute the new TS_OFFSET value */
-		new_ts_offset = (*decoded_ts) % effective_ts_stride;
+		/* compute the new TS_OFFSET and TS_SCALED values, divide with the
+		 * inverse of TS_STRIDE if TS_STRIDE did not change */
+		if(effective_ts_stride == ts_sc->ts_stride_div.divisor)
+		{
+			new_ts_scaled = rohc_div32_quot(*decoded_ts, &ts_sc->ts_stride_div);
+			new_ts_offset = (*decoded_ts) - new_ts_scaled * effective_ts_stride;
+		}
+		else
+		{
+			new_ts_scaled = (*decoded_ts) / effective_ts_stride;
+			new_ts_offset = (*decoded_ts) % effective_ts_stride;
+		}
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         *decoded_ts, effective_ts_stride, new_ts_offset);
-
-		/* compute the new TS_SCALED value */
-		new_ts_scaled = ((*decoded_ts) - new_ts_offset) / effective_ts_stride;
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", *decoded_ts,
 		         new_ts_offset, effective_ts_stride, new_ts_scaled);
 
@@ -329,6 +380,88 @@ error:
 }
 
 
+/**
+ * @brief Decode timestamp (TS) value with TS_SCALED bits and the arrival time
+ *
+ * See section 4.5.4 of RFC 3095: the TS_SCALED of the packet is approximated
+ * from the TS_SCALED and the arrival time of the reference packet, then the
+ * given bits correct the approximation:
+ *   approx = TS_SCALED_ref + round((time - time_ref) / TIME_STRIDE)
+ *   TS_SCALED in [approx + 1 - 2^(k-1), approx + 2^(k-1)]
+ *
+ * Use the TS_STRIDE, TS_OFFSET and TIME_STRIDE values found in context.
+ *
+ * @param ts_sc              The ts_sc_decomp object
+ * @param ts_scaled_bits     The timer-based encoded TS_SCALED value
+ * @param ts_scaled_bits_nr  The number of bits of TS_SCALED
+ * @param time               The arrival time (in milliseconds) of the packet
+ * @param decoded_ts         OUT: The decoded TS
+ * @return                   true in case of success, false otherwise
+ */
+bool ts_decode_scaled_bits_timer(struct ts_sc_decomp *const ts_sc,
+                                 const uint32_t ts_scaled_bits,
+                                 const size_t ts_scaled_bits_nr,
+                                 const uint32_t time,
+                                 uint32_t *const decoded_ts)
+{
+	const int32_t elapsed = (int32_t) (time - ts_sc->time);
+	uint32_t ts_scaled_delta;
+	uint32_t ts_scaled_decoded;
+
+	assert(ts_sc->ts_stride != 0);
+	assert(ts_sc->time_stride != 0);
+
+	/* approximate the TS_SCALED increase from the elapsed time, rounded to
+	 * the nearest integer */
+	if(elapsed >= 0)
+	{
+		ts_scaled_delta = (((uint32_t) elapsed) + ts_sc->time_stride / 2) /
+		                  ts_sc->time_stride;
+	}
+	else
+	{
+		ts_scaled_delta = -((((uint32_t) -elapsed) + ts_sc->time_stride / 2) /
+		                    ts_sc->time_stride);
+	}
+	ts_debug(ts_sc, "%d ms elapsed since reference packet, so TS_SCALED "
+	         "approximated to %u + %d", elapsed, ts_sc->ts_scaled,
+	         (int32_t) ts_scaled_delta);
+
+	if(ts_scaled_bits_nr >= 32)
+	{
+		ts_scaled_decoded = ts_scaled_bits;
+	}
+	else if(!rohc_lsb_decode(&ts_sc->lsb_ts_scaled, ROHC_LSB_REF_0,
+	                         ts_scaled_delta, ts_scaled_bits, ts_scaled_bits_nr,
+	                         rohc_interval_compute_p_rtp_ts_timer(ts_scaled_bits_nr),
+	                         &ts_scaled_decoded))
+	{
+		rohc_error(ts_sc, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "failed to decode %zu-bit timer-based TS_SCALED %u",
+		           ts_scaled_bits_nr, ts_scaled_bits);
+		goto error;
+	}
+	ts_debug(ts_sc, "TS_SCALED decoded = %u / 0x%x with %zu timer-based bits",
+	         ts_scaled_decoded, ts_scaled_decoded, ts_scaled_bits_nr);
+
+	/* TS computation with the TS_SCALED we just decoded and the
+	   TS_STRIDE/TS_OFFSET values found in context */
+	*decoded_ts = ts_sc->ts_stride * ts_scaled_decoded + ts_sc->ts_offset;
+	ts_debug(ts_sc, "TS = %u (TS_STRIDE = %u, TS_OFFSET = %u)", *decoded_ts,
+	         ts_sc->ts_stride, ts_sc->ts_offset);
+
+	/* store the updated TS_* values in context */
+	ts_sc->new_ts_scaled = ts_scaled_decoded;
+	ts_sc->new_ts_stride = ts_sc->ts_stride;
+	ts_sc->new_ts_offset = ts_sc->ts_offset;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Deduct timestamp (TS) from Sequence Number (SN)
  *
@@ -31,6 +31,7 @@
 
 #include "rohc_traces.h"
 #include "decomp_wlsb.h"
+#include "rohc_div.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -51,6 +52,8 @@ struct ts_sc_decomp
 {
 	/// The last computed or received TS_STRIDE value (validated by CRC)
 	uint32_t ts_stride;
+	/** The inverse of TS_STRIDE, computed again only when TS_STRIDE changes */
+	struct rohc_div32 ts_stride_div;
 
 	/// The last computed or received TS_SCALED value (validated by CRC)
 	uint32_t ts_scaled;
@@ -60,6 +63,13 @@ struct ts_sc_decomp
 	/// The last computed or received TS_OFFSET value (validated by CRC)
 	uint32_t ts_offset;
 
+	/** The TIME_STRIDE value (in milliseconds, validated by CRC), 0 if the
+	 *  timer-based encoding of TS_SCALED is not possible */
+	uint32_t time_stride;
+	/** The arrival time (in milliseconds) of the last packet that updated
+	 *  TS_SCALED in context */
+	uint32_t time;
+
 	/** The last timestamp (TS) value */
 	uint32_t ts;
 	/** The LSB-encoded unscaled timestamp (TS) value */
@@ -82,11 +92,15 @@ struct ts_sc_decomp
 	uint32_t new_ts_scaled;
 	/// The last computed or received TS_OFFSET value (not validated by CRC)
 	uint32_t new_ts_offset;
+	/** The received TIME_STRIDE value (not validated by CRC) */
+	uint32_t new_time_stride;
 
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The lowest level of the traces given to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
@@ -96,16 +110,21 @@ struct ts_sc_decomp
 
 void d_init_sc(struct ts_sc_decomp *const ts_scaled,
                rohc_trace_callback2_t trace_cb,
-               void *const trace_cb_priv)
+               void *const trace_cb_priv,
+               const rohc_trace_level_t trace_level)
 	__attribute__((nonnull(1)));
 
 void ts_update_context(struct ts_sc_decomp *const ts_sc,
                        const uint32_t ts,
-                       const uint16_t sn);
+                       const uint16_t sn,
+                       const uint32_t time);
 
 void d_record_ts_stride(struct ts_sc_decomp *const ts_sc,
                         const uint32_t ts_stride);
 
+void d_record_time_stride(struct ts_sc_decomp *const ts_sc,
+                          const uint32_t time_stride);
+
 bool ts_decode_unscaled_bits(struct ts_sc_decomp *const ts_sc,
                              const uint32_t ts_unscaled_bits,
                              const size_t ts_unscaled_bits_nr,
@@ -118,6 +137,13 @@ bool ts_decode_scaled_bits(struct ts_sc_decomp *const ts_sc,
                            uint32_t *const decoded_ts)
 	__attribute__((warn_unused_result));
 
+bool ts_decode_scaled_bits_timer(struct ts_sc_decomp *const ts_sc,
+                                 const uint32_t ts_scaled_bits,
+                                 const size_t ts_scaled_bits_nr,
+                                 const uint32_t time,
+                                 uint32_t *const decoded_ts)
+	__attribute__((warn_unused_result));
+
 uint32_t ts_deduce_from_sn(struct ts_sc_decomp *const ts_sc,
                            const uint16_t sn)
 	__attribute__((warn_unused_result));
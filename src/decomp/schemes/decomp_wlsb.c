@@ -167,6 +167,57 @@ bool rohc_lsb_decode(const struct rohc_lsb_decode *const lsb,
 }
 
 
+/**
+ * @brief Decode a 32-bit LSB-encoded value that follows the reference value
+ *
+ * Fast path of \ref rohc_lsb_decode for the strictly increasing values, such
+ * as the ESP SNs: the interpretation interval holds 2^k values, so only one of
+ * them has the k lower bits of m, and that value is the successor of the
+ * reference value if the successor has the same k lower bits as m and if it
+ * belongs to the interval. Only the reference value of the last packet is
+ * used, the context repair upon CRC failure needs \ref rohc_lsb_decode.
+ *
+ * @param lsb      The LSB object used to decode
+ * @param m        The LSB value to decode
+ * @param k        The length of the LSB value to decode
+ * @param p        The shift value p used to efficiently encode/decode
+ *                 the values
+ * @param decoded  OUT: The decoded value
+ * @return         true if the value is the successor of the reference value,
+ *                 false if it shall be decoded by \ref rohc_lsb_decode
+ */
+bool rohc_lsb_decode_next(const struct rohc_lsb_decode *const lsb,
+                          const uint32_t m,
+                          const size_t k,
+                          const rohc_lsb_shift_t p,
+                          uint32_t *const decoded)
+{
+	const uint32_t next = lsb->v_ref_d[ROHC_LSB_REF_0] + 1;
+	const int32_t computed_p = rohc_interval_compute_p(k, p);
+	/* the mask for k bits, computed on 64 bits for k = 32 */
+	const uint32_t mask = (uint32_t) ((((uint64_t) 1) << k) - 1);
+
+	assert(lsb->is_init == true);
+	assert(k <= 32);
+
+	if(lsb->max_len != 32 || k == 0)
+	{
+		return false;
+	}
+
+	/* the successor belongs to [v_ref - p ; v_ref + 2^k - 1 - p] if and only
+	 * if -1 <= p < 2^k - 1 */
+	if((next & mask) != m ||
+	   computed_p < -1 || ((int64_t) computed_p) >= ((int64_t) mask))
+	{
+		return false;
+	}
+
+	*decoded = next;
+	return true;
+}
+
+
 /**
  * @brief Decode a 32-bit LSB-encoded value
  *
@@ -192,68 +243,27 @@ static bool rohc_lsb_decode32(const struct rohc_lsb_decode *const lsb,
                               const rohc_lsb_shift_t p,
                               uint32_t *const decoded)
 {
+	/* the mask for k bits, computed on 64 bits for k = 32 */
+	const uint32_t mask = (uint32_t) ((((uint64_t) 1) << k) - 1);
 	struct rohc_interval32 interval;
-	uint32_t decoded_value;
-	uint32_t try;
-	uint32_t mask;
-	bool is_found = false;
+	uint32_t offset;
+	bool is_found;
 
-	/* compute the mask for k bits (and avoid integer overflow) */
-	if(k == 32)
-	{
-		mask = 0xffffffff;
-	}
-	else
-	{
-		mask = (1U << k) - 1;
-	}
 	assert((m & mask) == m);
 
 	/* determine the interval in which the decoded value should be present */
 	interval = rohc_f_32bits(lsb->v_ref_d[ref_type] + v_ref_d_offset, k, p);
 
-	/* search the value that matches the k lower bits of the value m to decode */
-	if(interval.min <= interval.max)
-	{
-		/* the interpretation interval does not straddle the field boundaries */
-
-		/* find the minimum value in the interval [min ; max] with the same k LSB
-		 * bits as m */
-		try = (interval.min & (~mask)) | m;
-		if((interval.min & mask) > m)
-		{
-			/* value is not in the interval (lower than min), try next value */
-			try += mask + 1;
-		}
-		if(try >= interval.min && try <= interval.max)
-		{
-			/* value is in the interval: corresponding value found */
-			is_found = true;
-			decoded_value = try;
-		}
-	}
-	else
-	{
-		/* the interpretation interval does straddle the field boundaries */
-
-		/* find the first value in the interval [min ; max] with the same
-		 * k LSB bits as m */
-		try = (interval.min & (~mask)) | m;
-		if((interval.min & mask) > m)
-		{
-			/* value is not in the interval (lower than min), try next value */
-			try += mask + 1;
-		}
-		if(try >= interval.min || try <= interval.max)
-		{
-			/* value is in the interval: corresponding value found */
-			is_found = true;
-			decoded_value = try;
-		}
-	}
-
+	/* the only value of [min ; min + 2^k - 1] with the same k LSB bits as m is
+	 * min plus the distance between the k LSB bits of min and m modulo 2^k;
+	 * it belongs to [min ; max] if that distance is not greater than the
+	 * width of the interval, whether the interval straddles the field
+	 * boundaries or not */
+	offset = (m - interval.min) & mask;
+	is_found = !!(offset <= (uint32_t) (interval.max - interval.min));
 	if(is_found)
 	{
+		const uint32_t decoded_value = interval.min + offset;
 		assert((decoded_value & mask) == m);
 		memcpy(decoded, &decoded_value, sizeof(uint32_t));
 	}
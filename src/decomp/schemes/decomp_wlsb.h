@@ -150,6 +150,13 @@ bool rohc_lsb_decode(const struct rohc_lsb_decode *const lsb,
                      uint32_t *const decoded)
 	__attribute__((warn_unused_result, nonnull(1, 7)));
 
+bool rohc_lsb_decode_next(const struct rohc_lsb_decode *const lsb,
+                          const uint32_t m,
+                          const size_t k,
+                          const rohc_lsb_shift_t p,
+                          uint32_t *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 5)));
+
 void rohc_lsb_set_ref(struct rohc_lsb_decode *const lsb,
                       const uint32_t v_ref_d,
                       const bool keep_ref_minus_1)
@@ -77,18 +77,13 @@ bool ip_id_offset_decode(const struct ip_id_offset_decode *const ipid,
 	 *   in a slightly different way (with the same meaning) in Section 5.7,
 	 *   where it is said that "default-slope(IP-ID offset) = 0", meaning, if
 	 *   no bits are sent for IP-ID, its SN offset slope defaults to 0.
-	 */
-	if(k == 0)
-	{
-		offset_decoded = rohc_lsb_get_ref(&ipid->lsb, ref_type);
-		is_success = true;
-	}
-	else
-	{
-		/* decode IP-ID / SN offset from the received bits */
-		is_success = rohc_lsb_decode(&ipid->lsb, ref_type, 0, m, k,
-		                             ROHC_LSB_SHIFT_IP_ID, &offset_decoded);
-	}
+	 *
+	 * The shift parameter of IP-ID is 0, so the interpretation interval for
+	 * k = 0 is [Offset_ref ; Offset_ref]: LSB decoding handles that case too */
+	assert(k <= 16);
+	is_success = rohc_lsb_decode(&ipid->lsb, ref_type, 0,
+	                             m & ((1U << k) - 1), k,
+	                             ROHC_LSB_SHIFT_IP_ID, &offset_decoded);
 
 	if(is_success)
 	{
@@ -30,17 +30,25 @@
 
 #include "rohc_utils.h"
 
-static int d_tcp_sack_block(const struct rohc_decomp_ctxt *const context,
-                            const uint8_t *const data,
-                            const size_t data_len,
-                            sack_block_t *const sack_block)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
-static int d_tcp_sack_pure_lsb(const struct rohc_decomp_ctxt *const context,
-                               const uint8_t *const data,
-                               const size_t data_len,
-                               uint32_t *const field)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+/**
+ * @brief The length (in bytes) of one encoded SACK field indexed by the 3
+ *        first bits of the field, the 5-byte length requires all the bits
+ *        of the first byte to be set
+ */
+static const uint8_t d_tcp_sack_len_by_prefix[8] =
+{
+	2, 2, 2, 2,  /* discriminator '0' */
+	3, 3,        /* discriminator '10' */
+	4,           /* discriminator '110' */
+	5,           /* discriminator '11111111' */
+};
+
+/** The value bits of the SACK fields encoded on 2, 3, 4 and 5 bytes */
+static const uint32_t d_tcp_sack_value_mask[5 + 1] =
+{
+	0, 0, 0x7fff, 0x3fffff, 0x1fffffff, 0xffffffff
+};
 
 
 /**
@@ -49,6 +57,10 @@ static int d_tcp_sack_pure_lsb(const struct rohc_decomp_ctxt *const context,
  * See RFC6846 page 68
  * (and RFC2018 for Selective Acknowledgement option)
  *
+ * The start and end fields of all the SACK blocks are parsed in one pass:
+ * the length of every field is given by its first bits, and its value is
+ * read at once whatever the length.
+ *
  * @param context        The decompression context
  * @param data           The ROHC data to parse
  * @param data_len       The length of the ROHC data to parse
@@ -61,28 +73,25 @@ int d_tcp_sack_parse(const struct rohc_decomp_ctxt *const context,
                      const size_t data_len,
                      struct d_tcp_opt_sack *const opt_sack)
 {
-	const uint8_t *remain_data;
-	size_t remain_data_len;
+	uint32_t sack_fields[TCP_SACK_BLOCKS_MAX_NR * 2];
+	size_t parsed_len;
 	uint8_t discriminator;
-	int i;
+	size_t fields_nr;
+	size_t i;
 
 	rohc_decomp_debug(context, "parse SACK option");
 
-	remain_data = data;
-	remain_data_len = data_len;
-
 	/* parse discriminator */
-	if(remain_data_len < 1)
+	if(data_len < 1)
 	{
 		rohc_warning(context->decompressor, ROHC_TRACE_DECOMP, ROHC_PROFILE_TCP,
 		             "packet too short for the discriminator of the TCP SACK "
 		             "option: only %zu bytes available while at least 1 byte "
-		             "required", remain_data_len);
+		             "required", data_len);
 		goto error;
 	}
-	discriminator = remain_data[0];
-	remain_data++;
-	remain_data_len--;
+	discriminator = data[0];
+	parsed_len = 1;
 	if(discriminator > TCP_SACK_BLOCKS_MAX_NR)
 	{
 		rohc_decomp_warn(context, "invalid discriminator value (%d)",
@@ -90,194 +99,65 @@ int d_tcp_sack_parse(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* parse up to 4 SACK blocks */
-	for(i = 0; i < discriminator; i++)
-	{
-		const int ret = d_tcp_sack_block(context, remain_data, remain_data_len,
-		                                 &(opt_sack->blocks[i]));
-		if(ret < 0)
-		{
-			rohc_decomp_warn(context, "failed to parse block #%d of SACK "
-			                 "option", i + 1);
-			goto error;
-		}
-		remain_data += ret;
-		remain_data_len -= ret;
-		rohc_decomp_debug(context, "block #%d of SACK option: start bits = 0x%08x, "
-		                  "end bits = 0x%08x", i + 1, opt_sack->blocks[i].block_start,
-		                  opt_sack->blocks[i].block_end);
-	}
-	opt_sack->blocks_nr = discriminator;
-
-	return (data_len - remain_data_len);
-
-error:
-	return -1;
-}
-
-
-/**
- * @brief Parse a SACK block of the TCP SACK option
- *
- * See RFC6846 page 68
- * (and RFC2018 for Selective Acknowledgement option)
- *
- * @param context          The decompression context
- * @param data             The data to parse
- * @param data_len         The length of the data to parse
- * @param[out] sack_block  The SACK block bits extracted from ROHC packet
- * @return                 The number of data bytes parsed,
- *                         -1 if data is malformed
- */
-static int d_tcp_sack_block(const struct rohc_decomp_ctxt *const context,
-                            const uint8_t *const data,
-                            const size_t data_len,
-                            sack_block_t *const sack_block)
-{
-	const uint8_t *remain_data = data;
-	size_t remain_len = data_len;
-	uint32_t block_start;
-	uint32_t block_end;
-	int ret;
-
-	/* parse block start */
-	ret = d_tcp_sack_pure_lsb(context, remain_data, remain_len, &block_start);
-	if(ret < 0)
-	{
-		goto error;
-	}
-	memcpy(&sack_block->block_start, &block_start, sizeof(uint32_t));
-	remain_data += ret;
-	remain_len -= ret;
-
-	/* parse block end */
-	ret = d_tcp_sack_pure_lsb(context, remain_data, remain_len, &block_end);
-	if(ret < 0)
-	{
-		goto error;
-	}
-	memcpy(&sack_block->block_end, &block_end, sizeof(uint32_t));
-#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
-	remain_data += ret;
-#endif
-	remain_len -= ret;
-
-	return (data_len - remain_len);
-
-error:
-	return -1;
-}
-
-
-/**
- * @brief Parse a SACK field of a SACK block of the TCP SACK option
- *
- * See RFC6846 page 67
- * (and RFC2018 for Selective Acknowledgement option)
- *
- * @param context          The decompression context
- * @param data             The ROHC data to parse
- * @param data_len         The length of the ROHC data to parse
- * @param[out] sack_field  The uncompressed SACK field
- * @return                 The number of data bytes parsed,
- *                         -1 if data is malformed
- */
-static int d_tcp_sack_pure_lsb(const struct rohc_decomp_ctxt *const context,
-                               const uint8_t *const data,
-                               const size_t data_len,
-                               uint32_t *const sack_field)
-{
-	const uint8_t *remain_data = data;
-	size_t remain_len = data_len;
-
-	if(remain_len < 2)
+	/* parse the start and end fields of up to 4 SACK blocks */
+	fields_nr = discriminator * 2;
+	for(i = 0; i < fields_nr; i++)
 	{
-		rohc_warning(context->decompressor, ROHC_TRACE_DECOMP, ROHC_PROFILE_TCP,
-		             "packet too short for the discriminator of the TCP pure "
-		             "field: only %zu bytes available while at least 2 bytes "
-		             "required", remain_len);
-		goto error;
-	}
+		const uint8_t *const field_data = data + parsed_len;
+		const size_t remain_len = data_len - parsed_len;
+		size_t field_len;
+		uint32_t field;
+		size_t j;
 
-	if((remain_data[0] & 0x80) == 0)
-	{
-		/* discriminator '0' */
-		rohc_decomp_debug(context, "SACK block is 2-byte long");
-		(*sack_field) = *(remain_data++) & 0x7f;
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		remain_len -= 2;
-	}
-	else if((remain_data[0] & 0x40) == 0)
-	{
-		/* discriminator '10' */
-		rohc_decomp_debug(context, "SACK block is 3-byte long");
-		if(remain_len < 3)
+		if(remain_len < 2)
 		{
 			rohc_warning(context->decompressor, ROHC_TRACE_DECOMP, ROHC_PROFILE_TCP,
 			             "packet too short for the discriminator of the TCP pure "
-			             "field: only %zu bytes available while at least 3 bytes "
+			             "field: only %zu bytes available while at least 2 bytes "
 			             "required", remain_len);
 			goto error;
 		}
-		(*sack_field) = *(remain_data++) & 0x3f;
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		remain_len -= 3;
-	}
-	else if((remain_data[0] & 0x20) == 0)
-	{
-		/* discriminator '110' */
-		rohc_decomp_debug(context, "SACK block is 4-byte long");
-		if(remain_len < 4)
+		field_len = d_tcp_sack_len_by_prefix[field_data[0] >> 5];
+		if(field_len == 5 && field_data[0] != 0xff)
 		{
-			rohc_warning(context->decompressor, ROHC_TRACE_DECOMP, ROHC_PROFILE_TCP,
-			             "packet too short for the discriminator of the TCP pure "
-			             "field: only %zu bytes available while at least 4 bytes "
-			             "required", remain_len);
+			rohc_decomp_warn(context, "malformed SACK block: unexpected "
+			                 "discriminator 0x%02x", field_data[0]);
 			goto error;
 		}
-		(*sack_field) = *(remain_data++) & 0x1f;
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		remain_len -= 4;
-	}
-	else if(remain_data[0] == 0xff)
-	{
-		/* discriminator '11111111' */
-		rohc_decomp_debug(context, "SACK block is 5-byte long");
-		if(remain_len < 5)
+		if(remain_len < field_len)
 		{
 			rohc_warning(context->decompressor, ROHC_TRACE_DECOMP, ROHC_PROFILE_TCP,
 			             "packet too short for the discriminator of the TCP pure "
-			             "field: only %zu bytes available while at least 5 bytes "
-			             "required", remain_len);
+			             "field: only %zu bytes available while at least %zu bytes "
+			             "required", remain_len, field_len);
 			goto error;
 		}
-		remain_data++; /* skip discriminator */
-		(*sack_field) = *(remain_data++);
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		(*sack_field) <<= 8;
-		(*sack_field) |= *(remain_data++);
-		remain_len -= 5;
+		rohc_decomp_debug(context, "SACK block is %zu-byte long", field_len);
+
+		/* the discriminator bits are masked out, the discriminator byte of the
+		 * 5-byte field is shifted out */
+		field = field_data[0];
+		for(j = 1; j < field_len; j++)
+		{
+			field = (field << 8) | field_data[j];
+		}
+		sack_fields[i] = field & d_tcp_sack_value_mask[field_len];
+		parsed_len += field_len;
 	}
-	else
+
+	for(i = 0; i < discriminator; i++)
 	{
-		rohc_decomp_warn(context, "malformed SACK block: unexpected "
-		                 "discriminator 0x%02x", remain_data[0]);
-		goto error;
+		memcpy(&opt_sack->blocks[i].block_start, &sack_fields[i * 2],
+		       sizeof(uint32_t));
+		memcpy(&opt_sack->blocks[i].block_end, &sack_fields[i * 2 + 1],
+		       sizeof(uint32_t));
+		rohc_decomp_debug(context, "block #%zu of SACK option: start bits = 0x%08x, "
+		                  "end bits = 0x%08x", i + 1, opt_sack->blocks[i].block_start,
+		                  opt_sack->blocks[i].block_end);
 	}
+	opt_sack->blocks_nr = discriminator;
 
-	return (data_len - remain_len);
+	return parsed_len;
 
 error:
 	return -1;
@@ -0,0 +1,249 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    bench_decomp_schemes.c
+ * @brief   Microbenchmarks for the decoding schemes of the decompressor
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * Measure the LSB decoding and the parsing of the TCP SACK and TS options in
+ * isolation, so that optimizations of these kernels may be validated without
+ * the noise of the whole decompression path.
+ *
+ * Every kernel is checked once before being measured, then one line is
+ * printed for each kernel:
+ *
+ *   BENCH  <kernel>  <operations>  <ns/operation>
+ */
+
+#include "decomp_wlsb.h"
+#include "tcp_ts.h"
+#include "tcp_sack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/** The default number of times every kernel is run */
+#define BENCH_ITERS_DEFAULT  200000U
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+/** Run the given code the given number of times and print its mean duration */
+#define BENCH(name, iters_nr, ...) \
+	do { \
+		const uint64_t bench_start = bench_get_ns(); \
+		size_t i; \
+		for(i = 0; i < (iters_nr); i++) \
+		{ \
+			__VA_ARGS__; \
+		} \
+		bench_print(name, iters_nr, bench_get_ns() - bench_start); \
+	} while(0)
+
+/** The 15-bit sack_var_length_enc() encoding of the given value */
+#define lsb_15(val) \
+	((((val) & 0x7fff) >> 8) & 0x7f), \
+	(((val) & 0x7fff) & 0xff)
+
+/** The 22-bit sack_var_length_enc() encoding of the given value */
+#define lsb_22(val) \
+	(0x80 | ((((val) & 0x3fffff) >> 16) & 0x3f)), \
+	((((val) & 0x3fffff) >> 8) & 0xff), \
+	(((val) & 0x3fffff) & 0xff)
+
+/** The 32-bit sack_var_length_enc() encoding of the given value */
+#define lsb_32(val) \
+	0xff, \
+	(((val) >> 24) & 0xff), \
+	(((val) >> 16) & 0xff), \
+	(((val) >> 8) & 0xff), \
+	((val) & 0xff)
+
+
+/** Accumulate the kernel results so that the compiler cannot drop them */
+static volatile uint64_t bench_sink;
+
+
+static uint64_t bench_get_ns(void)
+	__attribute__((warn_unused_result));
+static void bench_print(const char *const name,
+                        const size_t ops_nr,
+                        const uint64_t duration_ns)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Run the microbenchmarks of the decoding schemes of the decompressor
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if all the kernels were checked and measured,
+ *              non-zero otherwise
+ */
+int main(int argc, char *argv[])
+{
+	/* a fake decompression context for the TCP option parsers: traces are
+	 * disabled, so that only the parsing itself is measured */
+	struct rohc_decomp decomp = { .trace_callback = NULL };
+	struct rohc_decomp_profile profile = { .id = ROHC_PROFILE_TCP };
+	struct rohc_decomp_ctxt context = { .decompressor = &decomp, .profile = &profile };
+	const uint8_t ts_data[4][4] = {
+		{ 0x12 },                          /* 1-byte long with prefix '0' */
+		{ 0x80 | 0x12, 0x34 },             /* 2-byte long with prefix '10' */
+		{ 0xc0 | 0x12, 0x34, 0x56 },       /* 3-byte long with prefix '110' */
+		{ 0xe0 | 0x12, 0x34, 0x56, 0x78 }, /* 4-byte long with prefix '111' */
+	};
+	const uint8_t sack_data[] = {
+		0x04,                          /* discriminator */
+		lsb_15(0x12345678),            /* block 1 */
+		lsb_15(0x12345679),
+		lsb_22(0x1234567a),            /* block 2 */
+		lsb_22(0x1234567b),
+		lsb_32(0x1234567c),            /* block 3 */
+		lsb_32(0x1234567d),
+		lsb_32(0x1234567e),            /* block 4 */
+		lsb_32(0x1234567f),
+	};
+	struct rohc_lsb_decode lsb16;
+	struct rohc_lsb_decode lsb32;
+	size_t iters_nr = BENCH_ITERS_DEFAULT;
+	int is_failure = 1;
+
+	if(argc == 2)
+	{
+		char *end;
+		iters_nr = strtoul(argv[1], &end, 10);
+		if(argv[1][0] == '\0' || (*end) != '\0' || iters_nr == 0)
+		{
+			fprintf(stderr, "bad number of iterations '%s'\n", argv[1]);
+			goto error;
+		}
+	}
+	else if(argc != 1)
+	{
+		printf("benchmark the decoding schemes of the decompressor\n");
+		printf("usage: %s [ITERATIONS]\n", argv[0]);
+		goto error;
+	}
+
+	/* LSB decoding of a 16-bit SN and of a 32-bit TCP sequence number */
+	rohc_lsb_init(&lsb16, 16);
+	rohc_lsb_set_ref(&lsb16, 0xfff0, false);
+	rohc_lsb_init(&lsb32, 32);
+	rohc_lsb_set_ref(&lsb32, 0xfffff000, false);
+	{
+		uint32_t decoded;
+		CHECK(rohc_lsb_decode(&lsb16, ROHC_LSB_REF_0, 0, 0x3, 4,
+		                      ROHC_LSB_SHIFT_SN, &decoded));
+		CHECK(decoded == 0xfff3);
+		CHECK(rohc_lsb_decode(&lsb32, ROHC_LSB_REF_0, 0, 0x05b4, 14, 63,
+		                      &decoded));
+		CHECK(decoded == 0x000005b4);
+	}
+	BENCH("rohc_lsb_decode_16bits", iters_nr,
+	      const size_t k = 4 + (i & 7);
+	      uint32_t decoded;
+	      CHECK(rohc_lsb_decode(&lsb16, ROHC_LSB_REF_0, 0,
+	                            (0xfff0 + 1 + (i & 0x7)) & ((1U << k) - 1), k,
+	                            ROHC_LSB_SHIFT_SN, &decoded));
+	      bench_sink += decoded);
+	BENCH("rohc_lsb_decode_32bits", iters_nr,
+	      const size_t k = 14 + (i & 15);
+	      uint32_t decoded;
+	      CHECK(rohc_lsb_decode(&lsb32, ROHC_LSB_REF_0, 0,
+	                            (i * 1460) & ((1U << k) - 1), k, 63, &decoded));
+	      bench_sink += decoded);
+
+	/* the TCP TS option: the LSB fields on 1 to 4 bytes */
+	{
+		struct rohc_lsb_field32 lsb_field;
+		CHECK(d_tcp_ts_lsb_parse(&context, ts_data[3], 4, &lsb_field) == 4);
+		CHECK(lsb_field.bits == 0x12345678 && lsb_field.bits_nr == 29);
+	}
+	BENCH("d_tcp_ts_lsb_parse", iters_nr,
+	      struct rohc_lsb_field32 lsb_field;
+	      const int ret = d_tcp_ts_lsb_parse(&context, ts_data[i & 3], 4,
+	                                         &lsb_field);
+	      CHECK(ret > 0);
+	      bench_sink += ret + lsb_field.bits);
+
+	/* the TCP SACK option: 4 blocks of all the field lengths */
+	{
+		struct d_tcp_opt_sack sack;
+		CHECK(d_tcp_sack_parse(&context, sack_data, sizeof(sack_data), &sack) ==
+		      sizeof(sack_data));
+		CHECK(sack.blocks_nr == 4);
+		CHECK(sack.blocks[3].block_end == 0x1234567f);
+	}
+	BENCH("d_tcp_sack_parse", iters_nr,
+	      struct d_tcp_opt_sack sack;
+	      const int ret = d_tcp_sack_parse(&context, sack_data, sizeof(sack_data),
+	                                       &sack);
+	      CHECK(ret > 0);
+	      bench_sink += ret + sack.blocks[i & 3].block_start);
+
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t bench_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+
+	return ((uint64_t) now.tv_sec) * 1000000000U + ((uint64_t) now.tv_nsec);
+}
+
+
+/**
+ * @brief Print the mean duration of one kernel
+ *
+ * @param name         The name of the kernel
+ * @param ops_nr       The number of times the kernel was run
+ * @param duration_ns  The duration of all the runs (in nanoseconds)
+ */
+static void bench_print(const char *const name,
+                        const size_t ops_nr,
+                        const uint64_t duration_ns)
+{
+	printf("BENCH\t%s\t%zu\t%.2f\n", name, ops_nr,
+	       ops_nr == 0 ? 0.0 : ((double) duration_ns) / ((double) ops_nr));
+}
@@ -153,6 +153,63 @@ static void test_lsb_decode(void **state)
 }
 
 
+/** Test \ref rohc_lsb_decode_next */
+static void test_lsb_decode_next(void **state)
+{
+	const struct
+	{
+		bool used;
+		uint32_t ref;
+		uint32_t m;
+		size_t k;
+		bool exp_status;
+		uint32_t exp_value;
+	} tests[] = {
+		/* used          ref            m   k   exp_status    exp_value */
+		/* the successor of the reference value */
+		{  true,      0x4242,         0x3,  4,        true,      0x4243 },
+		{  true,      0x4242,        0x43,  8,        true,      0x4243 },
+		{  true,      0x4242,  0x00004243, 32,        true,      0x4243 },
+		/* the successor with wraparound */
+		{  true,  0xffffffff,         0x0,  8,        true,         0x0 },
+		{  true,  0xffffffff,         0x0, 32,        true,         0x0 },
+		/* not the successor of the reference value */
+		{  true,      0x4242,         0x4,  4,       false,         0x0 },
+		{  true,      0x4242,        0x42,  8,       false,         0x0 },
+		/* the successor is out of the interval: p = 1 for 1 bit */
+		{  true,      0x4242,         0x1,  1,       false,         0x0 },
+		/* no bits */
+		{  true,      0x4242,         0x0,  0,       false,         0x0 },
+		/* end of tests */
+		{ false,         0x0,         0x0,  0,       false,         0x0 },
+	};
+	struct rohc_lsb_decode lsb;
+	size_t test_num;
+
+	rohc_lsb_init(&lsb, 32);
+
+	for(test_num = 0; tests[test_num].used; test_num++)
+	{
+		uint32_t decoded = 0;
+		bool ret;
+
+		printf("decode %zu-bit m 0x%08x as the successor of 0x%08x (expected %s)\n",
+		       tests[test_num].k, tests[test_num].m, tests[test_num].ref,
+		       tests[test_num].exp_status ? "success" : "failure");
+
+		rohc_lsb_set_ref(&lsb, tests[test_num].ref, false);
+		ret = rohc_lsb_decode_next(&lsb, tests[test_num].m, tests[test_num].k,
+		                           ROHC_LSB_SHIFT_ESP_SN, &decoded);
+		assert_true(ret == tests[test_num].exp_status);
+		if(ret)
+		{
+			assert_true(decoded == tests[test_num].exp_value);
+		}
+		printf("\n");
+	}
+}
+
+
 /**
  * @brief Test LSB encoding/decoding
  *
@@ -166,12 +223,14 @@ int main(int argc, char *argv[])
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_lsb_init),
 		cmocka_unit_test(test_lsb_decode),
+		cmocka_unit_test(test_lsb_decode_next),
 	};
 	return cmocka_run_group_tests(tests, NULL, NULL);
 #elif defined(HAVE_CMOCKA_RUN_TESTS) && HAVE_CMOCKA_RUN_TESTS == 1
 	const UnitTest tests[] = {
 		unit_test(test_lsb_init),
 		unit_test(test_lsb_decode),
+		unit_test(test_lsb_decode_next),
 	};
 	return run_tests(tests);
 #else
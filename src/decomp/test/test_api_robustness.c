@@ -25,6 +25,7 @@
 #include "rohc_decomp.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
@@ -47,6 +48,20 @@
 	} while(0)
 
 
+static void * mem_alloc_cb(const size_t size, void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+static void mem_free_cb(void *const ptr, const size_t size, void *const priv_ctxt);
+static void ctxt_event_cb(const struct rohc_decomp *const decomp,
+                          const struct rohc_decomp_ctxt_event *const event,
+                          void *const priv_ctxt);
+static uint8_t crc_calc_cb(const size_t crc_bits,
+                           const uint8_t *const data,
+                           const size_t len,
+                           const uint8_t init_val,
+                           void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+
 /**
  * @brief Test the robustness of the decompression API
  *
@@ -111,6 +126,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == true);
 	}
 
+	/* rohc_decomp_set_trace_level() */
+	CHECK(rohc_decomp_set_trace_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_decomp_profile_enabled() */
 	CHECK(rohc_decomp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_GENERAL) == false);
@@ -283,8 +304,136 @@ int main(int argc, char *argv[])
 	/* rohc_decomp_set_features */
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_COMPAT_1_6_x) == false);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CRC_REPAIR) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_FEEDBACK_COALESCING) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_PERF_INFO) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_TIMER_BASED_TS) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_DUP_SHORTCUT) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_INSPECT) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_INSPECT |
+	                                       ROHC_DECOMP_FEATURE_INSPECT_CRC) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_BOUNDED_WORK) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CRC_REPAIR |
+	                                       ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF |
+	                                       ROHC_DECOMP_FEATURE_BOUNDED_WORK) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_IP_FRAGMENTS) == true);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
 
+	/* rohc_decomp_flush_feedback() */
+	{
+		uint8_t buf[100];
+		struct rohc_buf feedback = rohc_buf_init_empty(buf, 100);
+		CHECK(rohc_decomp_flush_feedback(NULL, &feedback) == false);
+		CHECK(rohc_decomp_flush_feedback(decomp, NULL) == false);
+		CHECK(rohc_decomp_flush_feedback(decomp, &feedback) == true);
+		CHECK(feedback.len == 0);
+	}
+
+	/* rohc_decomp_set_feedback_ring() */
+	{
+		struct rohc_feedback_ring *const ring = rohc_feedback_ring_new(16);
+		CHECK(ring != NULL);
+		CHECK(rohc_decomp_set_feedback_ring(NULL, ring) == false);
+		CHECK(rohc_decomp_set_feedback_ring(decomp, ring) == true);
+		CHECK(rohc_decomp_set_feedback_ring(decomp, NULL) == true);
+		rohc_feedback_ring_free(ring);
+	}
+
+	/* rohc_decomp_set_mem_cbs() */
+	CHECK(rohc_decomp_set_mem_cbs(NULL, mem_alloc_cb, mem_free_cb, NULL) == false);
+	CHECK(rohc_decomp_set_mem_cbs(decomp, mem_alloc_cb, NULL, NULL) == false);
+	CHECK(rohc_decomp_set_mem_cbs(decomp, NULL, mem_free_cb, NULL) == false);
+	CHECK(rohc_decomp_set_mem_cbs(decomp, NULL, NULL, NULL) == true);
+	CHECK(rohc_decomp_set_mem_cbs(decomp, mem_alloc_cb, mem_free_cb, NULL) == true);
+
+	/* rohc_decomp_preallocate(), but not with callbacks */
+	CHECK(rohc_decomp_preallocate(NULL) == false);
+	CHECK(rohc_decomp_preallocate(decomp) == false);
+	CHECK(rohc_decomp_set_mem_cbs(decomp, NULL, NULL, NULL) == true);
+	CHECK(rohc_decomp_preallocate(decomp) == true);
+	CHECK(rohc_decomp_set_mem_cbs(decomp, mem_alloc_cb, mem_free_cb, NULL) == true);
+
+	/* rohc_decomp_set_channel_set() */
+	{
+		struct rohc_channel_set *const set = rohc_channel_set_new();
+		struct rohc_decomp *decomps[2];
+		size_t i;
+
+		CHECK(set != NULL);
+		CHECK(rohc_decomp_set_channel_set(NULL, set) == false);
+		for(i = 0; i < 2; i++)
+		{
+			rohc_decomp_mem_info_t info;
+
+			decomps[i] = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+			                              ROHC_U_MODE);
+			CHECK(decomps[i] != NULL);
+			CHECK(rohc_decomp_set_channel_set(decomps[i], set) == true);
+			CHECK(rohc_decomp_set_mrru(decomps[i], 1000) == true);
+
+			/* the RRU buffer is carved from the slabs of the set */
+			memset(&info, 0, sizeof(rohc_decomp_mem_info_t));
+			CHECK(rohc_decomp_get_mem_info(decomps[i], &info) == true);
+			CHECK(info.used_bytes_nr >= 1000);
+			CHECK(info.slabs_bytes_nr == 0);
+		}
+
+		/* leave the set, then join it again */
+		CHECK(rohc_decomp_set_channel_set(decomps[0], NULL) == true);
+		CHECK(rohc_decomp_set_channel_set(decomps[0], set) == true);
+
+		/* the set is destroyed with its last channel */
+		rohc_channel_set_free(set);
+		rohc_decomp_free(decomps[0]);
+		rohc_decomp_free(decomps[1]);
+	}
+
+	/* rohc_decomp_set_crc_engine() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t uncomp_buf[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(uncomp_buf, 100);
+		size_t crc_calls_nr = 0;
+		const struct rohc_crc_engine engine =
+			{ .crc_calc = crc_calc_cb, .fcs32_calc = NULL, .priv_ctxt = &crc_calls_nr };
+		struct rohc_decomp *decomp2;
+
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHCv1_PROFILE_IP) == true);
+		CHECK(rohc_decomp_set_crc_engine(NULL, &engine) == false);
+		CHECK(rohc_decomp_set_crc_engine(decomp2, &engine) == true);
+
+		/* the CRC of the IR packet is computed by the callback, which is
+		 * wrong on purpose */
+		CHECK(rohc_decompress3(decomp2, pkt, &uncomp, NULL, NULL) == ROHC_STATUS_BAD_CRC);
+		CHECK(crc_calls_nr > 0);
+
+		/* back to the tables of the library */
+		crc_calls_nr = 0;
+		CHECK(rohc_decomp_set_crc_engine(decomp2, NULL) == true);
+		uncomp.len = 0;
+		CHECK(rohc_decompress3(decomp2, pkt, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 84);
+		CHECK(crc_calls_nr == 0);
+		rohc_decomp_free(decomp2);
+	}
+
 	/* rohc_decompress3() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
@@ -307,6 +456,9 @@ int main(int argc, char *argv[])
 			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
 		};
 		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		size_t events_nr[ROHC_DECOMP_CTXT_EVENT_FREED + 1] = { 0 };
+		CHECK(rohc_decomp_set_ctxt_event_cb(NULL, ctxt_event_cb, events_nr) == false);
+		CHECK(rohc_decomp_set_ctxt_event_cb(decomp, ctxt_event_cb, events_nr) == true);
 		CHECK(rohc_decompress3(NULL, pkt1, &pkt2, NULL, NULL) == ROHC_STATUS_ERROR);
 		CHECK(pkt2.len == 0);
 		pkt1.len = 0;
@@ -332,11 +484,87 @@ int main(int argc, char *argv[])
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
 			CHECK(pkt2.len == 0);
 		}
+		/* the contexts of the packets that failed are not notified */
+		CHECK(events_nr[ROHC_DECOMP_CTXT_EVENT_CREATED] == 0);
 		pkt2.max_len = pkt.len - 2;
 		pkt2.offset = 0;
 		pkt2.len = 0;
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_PERF_INFO) == true);
+		CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(pkt2.len > 0);
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
+		CHECK(events_nr[ROHC_DECOMP_CTXT_EVENT_CREATED] == 1);
+		CHECK(events_nr[ROHC_DECOMP_CTXT_EVENT_FREED] == 0);
+
+		/* rohc_decomp_reset() frees the context and resets the statistics,
+		 * the IR packet creates the context again */
+		CHECK(rohc_decomp_reset(NULL) == false);
+		CHECK(rohc_decomp_reset(decomp) == true);
+		CHECK(events_nr[ROHC_DECOMP_CTXT_EVENT_FREED] == 1);
+		CHECK(rohc_decomp_reset(decomp) == true);
+		CHECK(events_nr[ROHC_DECOMP_CTXT_EVENT_FREED] == 1);
+		pkt2.len = 0;
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_PERF_INFO) == true);
 		CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
 		CHECK(pkt2.len > 0);
+		CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
+		CHECK(events_nr[ROHC_DECOMP_CTXT_EVENT_CREATED] == 2);
+		CHECK(rohc_decomp_set_ctxt_event_cb(decomp, NULL, NULL) == true);
+
+		/* rohc_decompress4() */
+		{
+			struct rohc_decomp_pkt_info info;
+			const size_t uncomp_len = pkt2.len;
+			memset(&info, 0, sizeof(struct rohc_decomp_pkt_info));
+			pkt2.len = 0;
+			CHECK(rohc_decompress4(NULL, pkt, &pkt2, NULL, NULL, &info) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress4(decomp, pkt, &pkt2, NULL, NULL, NULL) == ROHC_STATUS_OK);
+			pkt2.len = 0;
+			CHECK(rohc_decompress4(decomp, pkt, &pkt2, NULL, NULL, &info) == ROHC_STATUS_OK);
+			CHECK(pkt2.len == uncomp_len);
+			CHECK(info.context_state == ROHC_DECOMP_STATE_FC);
+			CHECK(info.hdr_len > 0);
+			CHECK(info.uncomp_hdr_len > 0);
+			CHECK(pkt.len == (info.hdr_len + pkt2.len - info.uncomp_hdr_len));
+		}
+
+		/* rohc_decomp_get_perf_info() */
+		{
+			rohc_decomp_perf_info_t info;
+			memset(&info, 0, sizeof(rohc_decomp_perf_info_t));
+			CHECK(rohc_decomp_get_perf_info(NULL, &info) == false);
+			CHECK(rohc_decomp_get_perf_info(decomp, NULL) == false);
+			info.version_major = 0xffff;
+			CHECK(rohc_decomp_get_perf_info(decomp, &info) == false);
+			info.version_major = 0;
+			info.version_minor = 1;
+			CHECK(rohc_decomp_get_perf_info(decomp, &info) == false);
+			info.version_minor = 0;
+			/* only the successful packet was measured */
+			CHECK(rohc_decomp_get_perf_info(decomp, &info) == true);
+			for(size_t i = 0; i < ROHC_DECOMP_PERF_PHASES_NR; i++)
+			{
+				CHECK(info.phases[i].count == 1);
+				CHECK(info.phases[i].min_ns == info.phases[i].max_ns);
+			}
+			CHECK(info.phases[ROHC_DECOMP_PERF_TOTAL].sum_ns >=
+			      info.phases[ROHC_DECOMP_PERF_PARSE].sum_ns);
+		}
+
+		/* the measured packet is attributed to its context */
+		{
+			rohc_decomp_perf_info_t info;
+			struct rohc_decomp_ctxt_record record;
+			uint64_t phases_ns = 0;
+			memset(&info, 0, sizeof(rohc_decomp_perf_info_t));
+			CHECK(rohc_decomp_get_perf_info(decomp, &info) == true);
+			for(size_t i = 0; i < ROHC_DECOMP_PERF_TOTAL; i++)
+			{
+				phases_ns += info.phases[i].sum_ns;
+			}
+			CHECK(rohc_decomp_get_contexts_info(decomp, &record, 1) == 1);
+			CHECK(record.processing_ns == phases_ns);
+		}
 
 		{
 			uint8_t buf_full[100];
@@ -358,6 +586,618 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* rohc_decompress_in_place() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t rohc_pkt[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		uint8_t buf[100 + sizeof(rohc_pkt)];
+		struct rohc_buf pkt = rohc_buf_init_empty(buf, sizeof(buf));
+		CHECK(rohc_decompress_in_place(NULL, &pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_in_place(decomp, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_in_place(decomp, &pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+		/* no headroom for the uncompressed headers */
+		pkt.time = ts;
+		rohc_buf_append(&pkt, rohc_pkt, sizeof(rohc_pkt));
+		CHECK(rohc_decompress_in_place(decomp, &pkt, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+		CHECK(pkt.offset == 0 && pkt.len == sizeof(rohc_pkt));
+		/* enough headroom for the uncompressed headers */
+		pkt.offset = 100;
+		pkt.len = 0;
+		rohc_buf_append(&pkt, rohc_pkt, sizeof(rohc_pkt));
+		CHECK(rohc_decompress_in_place(decomp, &pkt, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(pkt.len == (sizeof(rohc_pkt) - 2));
+		CHECK((pkt.offset + pkt.len) == sizeof(buf));
+		CHECK(rohc_buf_byte_at(pkt, 0) == 0x45);
+	}
+
+	/* rohc_decompress_chain() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir[] =
+		{
+			0xfd, 0x04, 0xa0, 0x40,  0x01, 0xc0, 0xa8, 0x13,
+			0x01, 0xc0, 0xa8, 0x13,  0x05, 0x00, 0x40, 0x00,
+			0x04, 0xa0, 0x00, 0x00,  0x04, 0x08, 0x00, 0xf7,
+			0xfb, 0x00, 0x00, 0x00,  0x04
+		};
+		uint8_t uo0_5[] = { 0x2c, 0x08, 0x00, 0xf7, 0xfa, 0x00, 0x00, 0x00, 0x05 };
+		uint8_t padding[] = { 0xe0, 0xe0 };
+		const struct rohc_buf pkt_ir = rohc_buf_init_full(ir, sizeof(ir), ts);
+		const struct rohc_buf pkt_5 = rohc_buf_init_full(uo0_5, sizeof(uo0_5), ts);
+		const struct rohc_buf pkt_pad = rohc_buf_init_full(padding, sizeof(padding), ts);
+		struct rohc_buf segs[2];
+		struct rohc_buf_chain chain = { .segs = segs, .segs_nr = 2, .segs_max = 2 };
+		struct rohc_buf payload_segs[2];
+		struct rohc_buf_chain payload =
+			{ .segs = payload_segs, .segs_nr = 0, .segs_max = 2 };
+		uint8_t buf1[100];
+		struct rohc_buf uncomp1 = rohc_buf_init_empty(buf1, sizeof(buf1));
+		uint8_t buf2[100];
+		struct rohc_buf uncomp2 = rohc_buf_init_empty(buf2, sizeof(buf2));
+		struct rohc_decomp *decomp2;
+		struct rohc_decomp *decomp3;
+
+		decomp2 = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHCv1_PROFILE_IP) == true);
+		decomp3 = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp3 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp3, ROHCv1_PROFILE_IP) == true);
+
+		/* IR packet with 4 bytes of payload in the first segment */
+		segs[0] = pkt_ir;
+		segs[0].len = sizeof(ir) - 4;
+		segs[1] = pkt_ir;
+		segs[1].offset = sizeof(ir) - 4;
+		segs[1].len = 4;
+		CHECK(rohc_decompress_chain(NULL, chain, &uncomp2, &payload, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_chain(decomp3, chain, NULL, &payload, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_chain(decomp3, chain, &uncomp2, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+		chain.segs_nr = 0;
+		CHECK(rohc_decompress_chain(decomp3, chain, &uncomp2, &payload, NULL, NULL) == ROHC_STATUS_ERROR);
+		chain.segs_nr = 2;
+		payload.segs_max = 1;
+		CHECK(rohc_decompress_chain(decomp3, chain, &uncomp2, &payload, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+		payload.segs_max = 2;
+
+		CHECK(rohc_decompress3(decomp2, pkt_ir, &uncomp1, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decompress_chain(decomp3, chain, &uncomp2, &payload, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp2.len == 20);
+		CHECK(payload.segs_nr == 2);
+		CHECK(payload.segs[0].len == 4);
+		CHECK(rohc_buf_data(payload.segs[0]) == (ir + sizeof(ir) - 8));
+		CHECK(rohc_buf_data(payload.segs[1]) == (ir + sizeof(ir) - 4));
+		CHECK(uncomp1.len == (uncomp2.len + rohc_buf_chain_len(payload)));
+		CHECK(memcmp(buf1, rohc_buf_data(uncomp2), uncomp2.len) == 0);
+		CHECK(memcmp(buf1 + uncomp2.len, ir + sizeof(ir) - 8, 8) == 0);
+
+		/* UO-0 packet with no payload in the first segment */
+		segs[0] = pkt_5;
+		segs[0].len = 1;
+		segs[1] = pkt_5;
+		segs[1].offset = 1;
+		segs[1].len = sizeof(uo0_5) - 1;
+		rohc_buf_reset(&uncomp1);
+		rohc_buf_reset(&uncomp2);
+		CHECK(rohc_decompress3(decomp2, pkt_5, &uncomp1, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decompress_chain(decomp3, chain, &uncomp2, &payload, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp2.len == 20);
+		CHECK(payload.segs_nr == 1);
+		CHECK(rohc_buf_data(payload.segs[0]) == (uo0_5 + 1));
+		CHECK(payload.segs[0].len == 8);
+		CHECK(memcmp(buf1, rohc_buf_data(uncomp2), uncomp2.len) == 0);
+
+		/* the ROHC header shall be in the first segment */
+		segs[0] = pkt_pad;
+		segs[1] = pkt_5;
+		rohc_buf_reset(&uncomp2);
+		CHECK(rohc_decompress_chain(decomp3, chain, &uncomp2, &payload, NULL, NULL) == ROHC_STATUS_MALFORMED);
+		CHECK(payload.segs_nr == 0);
+
+		rohc_decomp_free(decomp2);
+		rohc_decomp_free(decomp3);
+	}
+
+	/* ROHC_DECOMP_FEATURE_DUP_SHORTCUT */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir[] =
+		{
+			0xfd, 0x04, 0xa0, 0x40,  0x01, 0xc0, 0xa8, 0x13,
+			0x01, 0xc0, 0xa8, 0x13,  0x05, 0x00, 0x40, 0x00,
+			0x04, 0xa0, 0x00, 0x00,  0x04, 0x08, 0x00, 0xf7,
+			0xfb, 0x00, 0x00, 0x00,  0x04
+		};
+		uint8_t uo0_5[] = { 0x2c, 0x08, 0x00, 0xf7, 0xfa, 0x00, 0x00, 0x00, 0x05 };
+		uint8_t uo0_6[] = { 0x36, 0x08, 0x00, 0xf7, 0xf9, 0x00, 0x00, 0x00, 0x06 };
+		const struct rohc_buf pkt_ir = rohc_buf_init_full(ir, sizeof(ir), ts);
+		const struct rohc_buf pkt_5 = rohc_buf_init_full(uo0_5, sizeof(uo0_5), ts);
+		const struct rohc_buf pkt_6 = rohc_buf_init_full(uo0_6, sizeof(uo0_6), ts);
+		uint8_t buf1[100];
+		struct rohc_buf uncomp1 = rohc_buf_init_empty(buf1, sizeof(buf1));
+		uint8_t buf2[100];
+		struct rohc_buf uncomp2 = rohc_buf_init_empty(buf2, sizeof(buf2));
+		struct rohc_decomp_pkt_info info;
+		struct rohc_decomp *decomp2;
+
+		decomp2 = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHCv1_PROFILE_IP) == true);
+		CHECK(rohc_decomp_set_features(decomp2, ROHC_DECOMP_FEATURE_DUP_SHORTCUT) == true);
+		CHECK(rohc_decompress3(decomp2, pkt_ir, &uncomp1, NULL, NULL) == ROHC_STATUS_OK);
+
+		/* the duplicate gives the same packet without updating the context */
+		memset(&info, 0, sizeof(struct rohc_decomp_pkt_info));
+		rohc_buf_reset(&uncomp1);
+		CHECK(rohc_decompress4(decomp2, pkt_5, &uncomp1, NULL, NULL, &info) == ROHC_STATUS_OK);
+		CHECK(uncomp1.len == 28);
+		CHECK(info.is_duplicated == false);
+		for(size_t i = 0; i < 3; i++)
+		{
+			rohc_buf_reset(&uncomp2);
+			CHECK(rohc_decompress4(decomp2, pkt_5, &uncomp2, NULL, NULL, &info) == ROHC_STATUS_OK);
+			CHECK(uncomp2.len == uncomp1.len);
+			CHECK(memcmp(buf1, buf2, uncomp1.len) == 0);
+			CHECK(info.is_duplicated == true);
+		}
+
+		/* too small output buffer for the duplicate */
+		uncomp2.max_len = 10;
+		rohc_buf_reset(&uncomp2);
+		CHECK(rohc_decompress3(decomp2, pkt_5, &uncomp2, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+		uncomp2.max_len = sizeof(buf2);
+
+		/* the next packet is decoded as usual */
+		rohc_buf_reset(&uncomp2);
+		CHECK(rohc_decompress4(decomp2, pkt_6, &uncomp2, NULL, NULL, &info) == ROHC_STATUS_OK);
+		CHECK(info.is_duplicated == false);
+		CHECK(uncomp2.len == 28);
+		CHECK(rohc_buf_byte_at(uncomp2, 5) == 0x06);
+		CHECK(rohc_buf_byte_at(uncomp2, 27) == 0x06);
+		rohc_decomp_free(decomp2);
+	}
+
+	/* ROHC_DECOMP_FEATURE_INSPECT and ROHC_DECOMP_FEATURE_INSPECT_CRC */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir[] =
+		{
+			0xfd, 0x04, 0xa0, 0x40,  0x01, 0xc0, 0xa8, 0x13,
+			0x01, 0xc0, 0xa8, 0x13,  0x05, 0x00, 0x40, 0x00,
+			0x04, 0xa0, 0x00, 0x00,  0x04, 0x08, 0x00, 0xf7,
+			0xfb, 0x00, 0x00, 0x00,  0x04
+		};
+		uint8_t uo0_5[] = { 0x2c, 0x08, 0x00, 0xf7, 0xfa, 0x00, 0x00, 0x00, 0x05 };
+		uint8_t uo0_6[] = { 0x36, 0x08, 0x00, 0xf7, 0xf9, 0x00, 0x00, 0x00, 0x06 };
+		uint8_t uo0_6_bad_crc[] = { 0x35, 0x08, 0x00, 0xf7, 0xf9, 0x00, 0x00, 0x00, 0x06 };
+		const struct rohc_buf pkt_ir = rohc_buf_init_full(ir, sizeof(ir), ts);
+		const struct rohc_buf pkt_5 = rohc_buf_init_full(uo0_5, sizeof(uo0_5), ts);
+		const struct rohc_buf pkt_6 = rohc_buf_init_full(uo0_6, sizeof(uo0_6), ts);
+		const struct rohc_buf pkt_6_bad_crc =
+			rohc_buf_init_full(uo0_6_bad_crc, sizeof(uo0_6_bad_crc), ts);
+		uint8_t buf1[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf1, sizeof(buf1));
+		uint8_t buf2[100];
+		struct rohc_buf feedback = rohc_buf_init_empty(buf2, sizeof(buf2));
+		struct rohc_decomp_pkt_info info;
+		struct rohc_decomp *decomp2;
+
+		decomp2 = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHCv1_PROFILE_IP) == true);
+		CHECK(rohc_decomp_set_features(decomp2, ROHC_DECOMP_FEATURE_INSPECT) == true);
+
+		/* the IR packet creates the context, but is neither decompressed nor
+		 * acknowledged */
+		memset(&info, 0, sizeof(struct rohc_decomp_pkt_info));
+		CHECK(rohc_decompress4(decomp2, pkt_ir, &uncomp, NULL, &feedback, &info) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+		CHECK(feedback.len == 0);
+		CHECK(info.cid == 0);
+		CHECK(info.profile_id == ROHCv1_PROFILE_IP);
+		CHECK(info.packet_type == ROHC_PACKET_IR);
+		CHECK(info.context_state == ROHC_DECOMP_STATE_FC);
+		CHECK(info.sn == 4);
+		CHECK(info.flow_id == 0);
+
+		/* the next packets update the context */
+		memset(&info, 0, sizeof(struct rohc_decomp_pkt_info));
+		CHECK(rohc_decompress4(decomp2, pkt_5, &uncomp, NULL, &feedback, &info) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+		CHECK(feedback.len == 0);
+		CHECK(info.packet_type == ROHC_PACKET_UO_0);
+		CHECK(info.sn == 5);
+		CHECK(info.flow_id == 0);
+
+		/* the CRC of the UO-0 packet is verified only if asked to */
+		CHECK(rohc_decomp_set_features(decomp2, ROHC_DECOMP_FEATURE_INSPECT |
+		                                        ROHC_DECOMP_FEATURE_INSPECT_CRC) == true);
+		CHECK(rohc_decompress4(decomp2, pkt_6_bad_crc, &uncomp, NULL, &feedback,
+		                       &info) == ROHC_STATUS_BAD_CRC);
+		CHECK(uncomp.len == 0);
+		CHECK(feedback.len == 0);
+		memset(&info, 0, sizeof(struct rohc_decomp_pkt_info));
+		CHECK(rohc_decompress4(decomp2, pkt_6, &uncomp, NULL, &feedback, &info) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+		CHECK(info.uncomp_hdr_len == 20);
+		CHECK(info.sn == 6);
+		CHECK(info.flow_id == 0);
+		rohc_decomp_free(decomp2);
+	}
+
+	/* STATIC-NACKs for CIDs without context are rate-limited per CID */
+	{
+		struct rohc_ts ts = { .sec = 1, .nsec = 0 };
+		uint8_t uo0[] = { 0xe1, 0x2c, 0x08, 0x00, 0xf7, 0xfa, 0x00, 0x00, 0x00, 0x05 };
+		uint8_t buf1[100];
+		uint8_t buf2[100];
+		struct rohc_decomp *decomp2;
+		size_t feedbacks_nr;
+		size_t round;
+		size_t i;
+
+		decomp2 = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHCv1_PROFILE_IP) == true);
+		/* no rate-limiting but the one of the token buckets */
+		CHECK(rohc_decomp_set_rate_limits(decomp2, 100, 1, 0, 1, 0, 1) == true);
+
+		/* a burst of 4 STATIC-NACKs, then one every 100 ms */
+		for(round = 0; round < 3; round++)
+		{
+			feedbacks_nr = 0;
+			for(i = 0; i < 10; i++)
+			{
+				const struct rohc_buf pkt = rohc_buf_init_full(uo0 + 1, sizeof(uo0) - 1, ts);
+				struct rohc_buf uncomp = rohc_buf_init_empty(buf1, sizeof(buf1));
+				struct rohc_buf feedback = rohc_buf_init_empty(buf2, sizeof(buf2));
+
+				CHECK(rohc_decompress3(decomp2, pkt, &uncomp, NULL, &feedback) ==
+				      ROHC_STATUS_NO_CONTEXT);
+				CHECK(uncomp.len == 0);
+				if(feedback.len > 0)
+				{
+					feedbacks_nr++;
+				}
+			}
+			CHECK(feedbacks_nr == (round == 0 ? 4 : (round == 1 ? 2 : 3)));
+			ts.nsec += 250000000;
+		}
+
+		/* the bucket of another CID is full */
+		{
+			const struct rohc_buf pkt = rohc_buf_init_full(uo0, sizeof(uo0), ts);
+			struct rohc_buf uncomp = rohc_buf_init_empty(buf1, sizeof(buf1));
+			struct rohc_buf feedback = rohc_buf_init_empty(buf2, sizeof(buf2));
+
+			CHECK(rohc_decompress3(decomp2, pkt, &uncomp, NULL, &feedback) ==
+			      ROHC_STATUS_NO_CONTEXT);
+			CHECK(feedback.len > 0);
+		}
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decomp_set_reorder() and rohc_decomp_reorder_release() */
+	{
+		const struct rohc_ts ts = { .sec = 1, .nsec = 0 };
+		const struct rohc_ts ts_later = { .sec = 1, .nsec = 50000000 };
+		const struct rohc_ts ts_late = { .sec = 1, .nsec = 150000000 };
+		uint8_t ir[] =
+		{
+			0xfd, 0x04, 0xa0, 0x40,  0x01, 0xc0, 0xa8, 0x13,
+			0x01, 0xc0, 0xa8, 0x13,  0x05, 0x00, 0x40, 0x00,
+			0x04, 0xa0, 0x00, 0x00,  0x04, 0x08, 0x00, 0xf7,
+			0xfb, 0x00, 0x00, 0x00,  0x04
+		};
+		uint8_t uo0_5[] = { 0x2c, 0x08, 0x00, 0xf7, 0xfa, 0x00, 0x00, 0x00, 0x05 };
+		uint8_t uo0_6[] = { 0x36, 0x08, 0x00, 0xf7, 0xf9, 0x00, 0x00, 0x00, 0x06 };
+		uint8_t uo0_7[] = { 0x3c, 0x08, 0x00, 0xf7, 0xf8, 0x00, 0x00, 0x00, 0x07 };
+		uint8_t uo0_9[] = { 0x49, 0x08, 0x00, 0xf7, 0xf6, 0x00, 0x00, 0x00, 0x09 };
+		const struct rohc_buf pkt_ir = rohc_buf_init_full(ir, sizeof(ir), ts);
+		const struct rohc_buf pkt_5 = rohc_buf_init_full(uo0_5, sizeof(uo0_5), ts);
+		const struct rohc_buf pkt_6 = rohc_buf_init_full(uo0_6, sizeof(uo0_6), ts);
+		const struct rohc_buf pkt_7 = rohc_buf_init_full(uo0_7, sizeof(uo0_7), ts);
+		const struct rohc_buf pkt_9 = rohc_buf_init_full(uo0_9, sizeof(uo0_9), ts);
+		uint8_t buf1[100];
+		struct rohc_buf uncomp = rohc_buf_init_empty(buf1, sizeof(buf1));
+		struct rohc_decomp_pkt_info info;
+		struct rohc_decomp *decomp2;
+
+		decomp2 = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHCv1_PROFILE_IP) == true);
+
+		CHECK(rohc_decomp_set_reorder(NULL, 2, 100) == false);
+		CHECK(rohc_decomp_set_reorder(decomp2, 9, 100) == false);
+		CHECK(rohc_decomp_set_reorder(decomp2, 0, 100) == true);
+		CHECK(rohc_decomp_set_reorder(decomp2, 2, 100) == true);
+		CHECK(rohc_decomp_reorder_release(NULL, ts, &uncomp, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decomp_reorder_release(decomp2, ts, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decomp_reorder_release(decomp2, ts, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+
+		CHECK(rohc_decompress3(decomp2, pkt_ir, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		rohc_buf_reset(&uncomp);
+
+		/* the packet that arrives too early is held */
+		CHECK(rohc_decompress3(decomp2, pkt_6, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+		CHECK(rohc_decomp_reorder_release(decomp2, ts, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+		CHECK(rohc_decomp_set_reorder(decomp2, 0, 100) == false);
+
+		/* then released once the packet that precedes it arrived */
+		CHECK(rohc_decompress3(decomp2, pkt_5, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 28);
+		CHECK(rohc_buf_byte_at(uncomp, 27) == 0x05);
+		rohc_buf_reset(&uncomp);
+		memset(&info, 0, sizeof(struct rohc_decomp_pkt_info));
+		CHECK(rohc_decomp_reorder_release(decomp2, ts, &uncomp, NULL, &info) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 28);
+		CHECK(rohc_buf_byte_at(uncomp, 27) == 0x06);
+		CHECK(info.lost_packets_nr == 0);
+		rohc_buf_reset(&uncomp);
+		CHECK(rohc_decomp_reorder_release(decomp2, ts, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+
+		/* the packets that arrive in order are not held */
+		CHECK(rohc_decompress3(decomp2, pkt_7, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_buf_byte_at(uncomp, 27) == 0x07);
+		rohc_buf_reset(&uncomp);
+
+		/* the packet whose predecessor is lost is released after the delay */
+		CHECK(rohc_decompress3(decomp2, pkt_9, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+		CHECK(rohc_decomp_reorder_release(decomp2, ts_later, &uncomp, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 0);
+		memset(&info, 0, sizeof(struct rohc_decomp_pkt_info));
+		CHECK(rohc_decomp_reorder_release(decomp2, ts_late, &uncomp, NULL, &info) == ROHC_STATUS_OK);
+		CHECK(uncomp.len == 28);
+		CHECK(rohc_buf_byte_at(uncomp, 27) == 0x09);
+		CHECK(info.lost_packets_nr == 1);
+		rohc_buf_reset(&uncomp);
+
+		CHECK(rohc_decomp_set_reorder(decomp2, 0, 100) == true);
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decompress_burst() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t rohc_buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		const struct rohc_buf rohc_pkts[2] = {
+			rohc_buf_init_full(rohc_buf, sizeof(rohc_buf), ts),
+			rohc_buf_init_full(rohc_buf, sizeof(rohc_buf), ts),
+		};
+		uint8_t buf1[100];
+		uint8_t buf2[100];
+		struct rohc_buf uncomp_pkts[2] = {
+			rohc_buf_init_empty(buf1, 100),
+			rohc_buf_init_empty(buf2, 100),
+		};
+		rohc_status_t statuses[2];
+		struct rohc_decomp_pkt_info infos[2];
+
+		CHECK(rohc_decompress_burst(NULL, rohc_pkts, uncomp_pkts, statuses, NULL, 2) == 0);
+		CHECK(rohc_decompress_burst(decomp, NULL, uncomp_pkts, statuses, NULL, 2) == 0);
+		CHECK(rohc_decompress_burst(decomp, rohc_pkts, NULL, statuses, NULL, 2) == 0);
+		CHECK(rohc_decompress_burst(decomp, rohc_pkts, uncomp_pkts, NULL, NULL, 2) == 0);
+		CHECK(rohc_decompress_burst(decomp, rohc_pkts, uncomp_pkts, statuses, NULL, 0) == 0);
+
+		/* the second output buffer is not empty */
+		uncomp_pkts[1].len = 1;
+		CHECK(rohc_decompress_burst(decomp, rohc_pkts, uncomp_pkts, statuses, NULL, 2) == 2);
+		CHECK(statuses[0] == ROHC_STATUS_OK);
+		CHECK(uncomp_pkts[0].len == (sizeof(rohc_buf) - 2));
+		CHECK(statuses[1] == ROHC_STATUS_ERROR);
+
+		/* both packets are decompressed */
+		uncomp_pkts[0].len = 0;
+		uncomp_pkts[1].len = 0;
+		memset(infos, 0, sizeof(infos));
+		CHECK(rohc_decompress_burst(decomp, rohc_pkts, uncomp_pkts, statuses, infos, 2) == 2);
+		for(size_t i = 0; i < 2; i++)
+		{
+			CHECK(statuses[i] == ROHC_STATUS_OK);
+			CHECK(uncomp_pkts[i].len == (sizeof(rohc_buf) - 2));
+			CHECK(rohc_buf_byte_at(uncomp_pkts[i], 0) == 0x45);
+			CHECK(infos[i].hdr_len > 0);
+		}
+
+		/* rohc_decompress_burst2() */
+		{
+			uint8_t rcvd_buf1[100];
+			uint8_t rcvd_buf2[100];
+			uint8_t send_buf1[100];
+			uint8_t send_buf2[100];
+			struct rohc_buf rcvd_feedbacks[2] = {
+				rohc_buf_init_empty(rcvd_buf1, 100),
+				rohc_buf_init_empty(rcvd_buf2, 100),
+			};
+			struct rohc_buf feedbacks_send[2] = {
+				rohc_buf_init_empty(send_buf1, 100),
+				rohc_buf_init_empty(send_buf2, 100),
+			};
+
+			uncomp_pkts[0].len = 0;
+			uncomp_pkts[1].len = 0;
+			CHECK(rohc_decompress_burst2(NULL, rohc_pkts, uncomp_pkts, rcvd_feedbacks, feedbacks_send, statuses, infos, 2) == 0);
+			CHECK(rohc_decompress_burst2(decomp, NULL, uncomp_pkts, rcvd_feedbacks, feedbacks_send, statuses, infos, 2) == 0);
+			CHECK(rohc_decompress_burst2(decomp, rohc_pkts, NULL, rcvd_feedbacks, feedbacks_send, statuses, infos, 2) == 0);
+			CHECK(rohc_decompress_burst2(decomp, rohc_pkts, uncomp_pkts, rcvd_feedbacks, feedbacks_send, NULL, infos, 2) == 0);
+			CHECK(rohc_decompress_burst2(decomp, rohc_pkts, uncomp_pkts, rcvd_feedbacks, feedbacks_send, statuses, infos, 0) == 0);
+
+			/* the feedback buffers of the second packet are not empty */
+			rcvd_feedbacks[1].len = 1;
+			CHECK(rohc_decompress_burst2(decomp, rohc_pkts, uncomp_pkts, rcvd_feedbacks, feedbacks_send, statuses, infos, 2) == 2);
+			CHECK(statuses[0] == ROHC_STATUS_OK);
+			CHECK(uncomp_pkts[0].len == (sizeof(rohc_buf) - 2));
+			CHECK(rcvd_feedbacks[0].len == 0);
+			CHECK(statuses[1] == ROHC_STATUS_ERROR);
+			rcvd_feedbacks[1].len = 0;
+			uncomp_pkts[0].len = 0;
+			feedbacks_send[0].len = 0;
+			feedbacks_send[1].len = 1;
+			CHECK(rohc_decompress_burst2(decomp, rohc_pkts, uncomp_pkts, rcvd_feedbacks, feedbacks_send, statuses, infos, 2) == 2);
+			CHECK(statuses[0] == ROHC_STATUS_OK);
+			CHECK(statuses[1] == ROHC_STATUS_ERROR);
+
+			/* both packets are decompressed, with or without feedback buffers */
+			uncomp_pkts[0].len = 0;
+			feedbacks_send[0].len = 0;
+			feedbacks_send[1].len = 0;
+			CHECK(rohc_decompress_burst2(decomp, rohc_pkts, uncomp_pkts, rcvd_feedbacks, feedbacks_send, statuses, infos, 2) == 2);
+			for(size_t i = 0; i < 2; i++)
+			{
+				CHECK(statuses[i] == ROHC_STATUS_OK);
+				CHECK(uncomp_pkts[i].len == (sizeof(rohc_buf) - 2));
+				CHECK(rcvd_feedbacks[i].len == 0);
+			}
+			uncomp_pkts[0].len = 0;
+			uncomp_pkts[1].len = 0;
+			CHECK(rohc_decompress_burst2(decomp, rohc_pkts, uncomp_pkts, NULL, NULL, statuses, NULL, 2) == 2);
+			CHECK(statuses[0] == ROHC_STATUS_OK);
+			CHECK(statuses[1] == ROHC_STATUS_OK);
+		}
+
+		/* references to the piggybacked feedbacks */
+		{
+			uint8_t fb_buf[2 + 1 + sizeof(rohc_buf)] = { 0xe0, 0xf1, 0x42 };
+			struct rohc_buf fb_pkt = rohc_buf_init_full(fb_buf, sizeof(fb_buf), ts);
+			struct rohc_decomp_pkt_info info;
+
+			memcpy(fb_buf + 3, rohc_buf, sizeof(rohc_buf));
+			uncomp_pkts[0].len = 0;
+			memset(&info, 0, sizeof(info));
+			CHECK(rohc_decompress4(decomp, fb_pkt, &uncomp_pkts[0], NULL, NULL, &info) == ROHC_STATUS_OK);
+			CHECK(uncomp_pkts[0].len == (sizeof(rohc_buf) - 2));
+			CHECK(info.rcvd_feedbacks_offset == 1);
+			CHECK(info.rcvd_feedbacks_len == 2);
+			CHECK(info.rcvd_feedbacks_nr == 1);
+			CHECK(info.hdr_len > 0);
+
+			/* feedback-only packet */
+			fb_pkt.len = 3;
+			uncomp_pkts[0].len = 0;
+			memset(&info, 0, sizeof(info));
+			CHECK(rohc_decompress4(decomp, fb_pkt, &uncomp_pkts[0], NULL, NULL, &info) == ROHC_STATUS_OK);
+			CHECK(uncomp_pkts[0].len == 0);
+			CHECK(info.rcvd_feedbacks_offset == 1);
+			CHECK(info.rcvd_feedbacks_len == 2);
+			CHECK(info.rcvd_feedbacks_nr == 1);
+			CHECK(info.hdr_len == 0);
+
+			/* no feedback */
+			uncomp_pkts[0].len = 0;
+			CHECK(rohc_decompress4(decomp, rohc_pkts[0], &uncomp_pkts[0], NULL, NULL, &info) == ROHC_STATUS_OK);
+			CHECK(info.rcvd_feedbacks_offset == 0);
+			CHECK(info.rcvd_feedbacks_len == 0);
+			CHECK(info.rcvd_feedbacks_nr == 0);
+		}
+
+		/* rohc_decompress_burst_gro() */
+		{
+			struct rohc_decomp_gro_info gro_infos[2];
+
+			uncomp_pkts[0].len = 0;
+			uncomp_pkts[1].len = 0;
+			CHECK(rohc_decompress_burst_gro(NULL, rohc_pkts, uncomp_pkts, statuses, gro_infos, 2) == 0);
+			CHECK(rohc_decompress_burst_gro(decomp, NULL, uncomp_pkts, statuses, gro_infos, 2) == 0);
+			CHECK(rohc_decompress_burst_gro(decomp, rohc_pkts, NULL, statuses, gro_infos, 2) == 0);
+			CHECK(rohc_decompress_burst_gro(decomp, rohc_pkts, uncomp_pkts, NULL, gro_infos, 2) == 0);
+			CHECK(rohc_decompress_burst_gro(decomp, rohc_pkts, uncomp_pkts, statuses, NULL, 2) == 0);
+			CHECK(rohc_decompress_burst_gro(decomp, rohc_pkts, uncomp_pkts, statuses, gro_infos, 0) == 0);
+
+			/* IP-only packets are never coalesced */
+			CHECK(rohc_decompress_burst_gro(decomp, rohc_pkts, uncomp_pkts, statuses, gro_infos, 2) == 2);
+			for(size_t i = 0; i < 2; i++)
+			{
+				CHECK(statuses[i] == ROHC_STATUS_OK);
+				CHECK(uncomp_pkts[i].len == (sizeof(rohc_buf) - 2));
+				CHECK(gro_infos[i].segs_nr == 1);
+				CHECK(gro_infos[i].gso_size == 0);
+			}
+		}
+	}
+
+	/* rohc_decomp_peek_cid() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		/* padding, 2-byte feedback, then the IR type octet and large CID 5 */
+		uint8_t buf[] = { 0xe0, 0xf1, 0x00, 0xfd, 0x05 };
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		rohc_cid_t cid;
+		size_t fb_offset;
+		size_t fb_len;
+		CHECK(rohc_decomp_peek_cid(NULL, pkt, &cid, &fb_offset, &fb_len) == false);
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, NULL, &fb_offset, &fb_len) == false);
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, NULL, &fb_len) == false);
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, &fb_offset, NULL) == false);
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, &fb_offset, &fb_len) == true);
+		CHECK(cid == 5 && fb_offset == 1 && fb_len == 2);
+		/* no padding nor feedback */
+		rohc_buf_pull(&pkt, 3);
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, &fb_offset, &fb_len) == true);
+		CHECK(cid == 5 && fb_offset == 0 && fb_len == 0);
+		/* truncated large CID */
+		pkt.len = 1;
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, &fb_offset, &fb_len) == false);
+		/* feedback-only packet */
+		rohc_buf_push(&pkt, 3);
+		pkt.len = 3;
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, &fb_offset, &fb_len) == false);
+		/* malformed feedback */
+		pkt.len = 2;
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, &fb_offset, &fb_len) == false);
+		/* ROHC segment */
+		buf[3] = 0xfe;
+		pkt.len = 5;
+		CHECK(rohc_decomp_peek_cid(decomp, pkt, &cid, &fb_offset, &fb_len) == false);
+	}
+
+	/* rohc_decomp_prefetch() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		/* the IR type octet and large CID 5, then a large CID out of range */
+		uint8_t buf[] = { 0xfd, 0x05, 0xfd, 0xbf, 0xff };
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 2, ts);
+		struct rohc_buf malformed = rohc_buf_init_full(NULL, 1, ts);
+		rohc_decomp_prefetch(NULL, pkt);
+		rohc_decomp_prefetch(decomp, malformed);
+		rohc_decomp_prefetch(decomp, pkt);
+		pkt.len = 1;
+		rohc_decomp_prefetch(decomp, pkt);
+		rohc_buf_pull(&pkt, 2);
+		pkt.len = 3;
+		rohc_decomp_prefetch(decomp, pkt);
+	}
+
 	/* rohc_decomp_get_last_packet_info() */
 	{
 		rohc_decomp_last_packet_info_t info;
@@ -392,6 +1232,179 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
 	}
 
+	/* rohc_decomp_get_stats() */
+	{
+		static rohc_decomp_stats_t stats;
+		rohc_decomp_general_info_t info;
+		uint64_t packets_nr = 0;
+		uint64_t hdr_bytes_nr = 0;
+		uint64_t uncomp_hdr_bytes_nr = 0;
+		memset(&stats, 0, sizeof(rohc_decomp_stats_t));
+		CHECK(rohc_decomp_get_stats(NULL, &stats) == false);
+		CHECK(rohc_decomp_get_stats(decomp, NULL) == false);
+		stats.version_major = 0xffff;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == false);
+		stats.version_major = 0;
+		stats.version_minor = 1;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == false);
+		stats.version_minor = 0;
+		CHECK(rohc_decomp_get_stats(decomp, &stats) == true);
+		for(size_t major = 0; major <= ROHC_PROFILE_ID_MAJOR_MAX; major++)
+		{
+			for(size_t minor = 0; minor <= ROHC_PROFILE_ID_MINOR_MAX; minor++)
+			{
+				for(size_t type = 0; type < ROHC_PACKET_MAX; type++)
+				{
+					packets_nr += stats.pkts[major][minor][type].packets_nr;
+					hdr_bytes_nr += stats.pkts[major][minor][type].hdr_bytes_nr;
+					uncomp_hdr_bytes_nr += stats.pkts[major][minor][type].uncomp_hdr_bytes_nr;
+				}
+			}
+		}
+		memset(&info, 0, sizeof(rohc_decomp_general_info_t));
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(packets_nr > 0);
+		CHECK(packets_nr <= info.packets_nr);
+		CHECK(hdr_bytes_nr > 0);
+		CHECK(hdr_bytes_nr <= info.comp_bytes_nr);
+		CHECK(uncomp_hdr_bytes_nr > 0);
+		CHECK(uncomp_hdr_bytes_nr <= info.uncomp_bytes_nr);
+	}
+
+	/* rohc_decomp_get_contexts_info() */
+	{
+		struct rohc_decomp_ctxt_record records[2];
+		rohc_decomp_general_info_t info;
+		memset(&info, 0, sizeof(rohc_decomp_general_info_t));
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.contexts_nr > 0);
+		CHECK(rohc_decomp_get_contexts_info(NULL, records, 2) == 0);
+		CHECK(rohc_decomp_get_contexts_info(decomp, NULL, 2) == 0);
+		CHECK(rohc_decomp_get_contexts_info(decomp, records, 0) == 0);
+		CHECK(rohc_decomp_get_contexts_info(decomp, records, 2) == info.contexts_nr);
+		CHECK(records[0].packets_nr > 0);
+		CHECK(records[0].hdr_bytes_nr > 0);
+		CHECK(records[0].uncomp_hdr_bytes_nr > 0);
+	}
+
+	/* rohc_decomp_set_mem_budget() and rohc_decomp_get_mem_info() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf2[100];
+		struct rohc_buf pkt2 = rohc_buf_init_empty(buf2, 100);
+		uint8_t buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01, 0x66, 0x15,
+			0xa6, 0x45, 0x77, 0x9b,  0x04, 0x00, 0x08, 0x09,
+			0x0a, 0x0b, 0x0c, 0x0d,  0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 0x14, 0x15,  0x16, 0x17, 0x18, 0x19,
+			0x1a, 0x1b, 0x1c, 0x1d,  0x1e, 0x1f, 0x20, 0x21,
+			0x22, 0x23, 0x24, 0x25,  0x26, 0x27, 0x28, 0x29,
+			0x2a, 0x2b, 0x2c, 0x2d,  0x2e, 0x2f, 0x30, 0x31,
+			0x32, 0x33, 0x34, 0x35,  0x36, 0x37
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		struct rohc_decomp *decomp2;
+		rohc_decomp_mem_info_t info;
+
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_IP) == true);
+		memset(&info, 0, sizeof(rohc_decomp_mem_info_t));
+		CHECK(rohc_decomp_get_mem_info(NULL, &info) == false);
+		CHECK(rohc_decomp_get_mem_info(decomp2, NULL) == false);
+		info.version_major = 0xffff;
+		CHECK(rohc_decomp_get_mem_info(decomp2, &info) == false);
+		info.version_major = 0;
+		info.version_minor = 1;
+		CHECK(rohc_decomp_get_mem_info(decomp2, &info) == false);
+		info.version_minor = 0;
+		CHECK(rohc_decomp_get_mem_info(decomp2, &info) == true);
+		CHECK(info.budget_bytes_nr == 0);
+
+		/* no room for the context of the IR packet */
+		CHECK(rohc_decomp_set_mem_budget(NULL, 1) == false);
+		CHECK(rohc_decomp_set_mem_budget(decomp2, 1) == true);
+		CHECK(rohc_decompress3(decomp2, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_NO_MEMORY);
+		CHECK(pkt2.len == 0);
+		CHECK(rohc_decomp_get_mem_info(decomp2, &info) == true);
+		CHECK(info.budget_bytes_nr == 1);
+		CHECK(info.refused_nr > 0);
+
+		/* no budget anymore */
+		CHECK(rohc_decomp_set_mem_budget(decomp2, 0) == true);
+		CHECK(rohc_decompress3(decomp2, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decomp_preallocate(decomp2) == false);
+		CHECK(rohc_decomp_get_mem_info(decomp2, &info) == true);
+		CHECK(info.used_bytes_nr > 0);
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decomp_save_contexts() and rohc_decomp_restore_contexts() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir_buf[] =
+		{
+			0xfd, 0x00, 0x04, 0x41,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x04, 0x00,
+			0x40, 0x00, 0x00, 0x00,  0x01, 0x08, 0x00, 0xe9,
+			0xc2, 0x9b, 0x42, 0x00,  0x01
+		};
+		const struct rohc_buf ir_pkt = rohc_buf_init_full(ir_buf, sizeof(ir_buf), ts);
+		uint8_t co_buf[] =
+		{
+			0xfa, 0x00, 0x35, 0x84,  0x70, 0x05, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		const struct rohc_buf co_pkt = rohc_buf_init_full(co_buf, sizeof(co_buf), ts);
+		uint8_t buf2[100];
+		struct rohc_buf pkt2 = rohc_buf_init_empty(buf2, 100);
+		uint8_t buf3[100];
+		struct rohc_buf pkt3 = rohc_buf_init_empty(buf3, 100);
+		uint8_t image[2000];
+		size_t image_len;
+		size_t ctxts_nr;
+		struct rohc_decomp *decomp2;
+		struct rohc_decomp *decomp3;
+
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_decompress3(decomp2, ir_pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+
+		CHECK(rohc_decomp_save_contexts(NULL, image, sizeof(image), &image_len) == false);
+		CHECK(rohc_decomp_save_contexts(decomp2, image, sizeof(image), NULL) == false);
+		CHECK(rohc_decomp_save_contexts(decomp2, NULL, 0, &image_len) == false);
+		CHECK(image_len > 0 && image_len <= sizeof(image));
+		CHECK(rohc_decomp_save_contexts(decomp2, image, image_len - 1, &image_len) == false);
+		CHECK(rohc_decomp_save_contexts(decomp2, image, sizeof(image), &image_len) == true);
+
+		decomp3 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp3 != NULL);
+		CHECK(rohc_decomp_restore_contexts(NULL, image, image_len, ts, &ctxts_nr) == false);
+		CHECK(rohc_decomp_restore_contexts(decomp3, NULL, image_len, ts, &ctxts_nr) == false);
+		CHECK(rohc_decomp_restore_contexts(decomp3, image, image_len, ts, NULL) == false);
+		CHECK(rohc_decomp_restore_contexts(decomp3, image, image_len - 1, ts, &ctxts_nr) == false);
+		/* the profile is disabled */
+		CHECK(rohc_decomp_restore_contexts(decomp3, image, image_len, ts, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 0);
+		CHECK(rohc_decomp_enable_profile(decomp3, ROHCv2_PROFILE_IP) == true);
+		CHECK(rohc_decomp_restore_contexts(decomp3, image, image_len, ts, &ctxts_nr) == true);
+		CHECK(ctxts_nr == 1);
+
+		/* the restored context decompresses as the saved one */
+		pkt2.len = 0;
+		CHECK(rohc_decompress3(decomp2, co_pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decompress3(decomp3, co_pkt, &pkt3, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(pkt2.len == pkt3.len);
+		CHECK(memcmp(rohc_buf_data(pkt2), rohc_buf_data(pkt3), pkt2.len) == 0);
+		rohc_decomp_free(decomp3);
+		rohc_decomp_free(decomp2);
+	}
+
 	/* rohc_decomp_get_state_descr() */
 	CHECK(strcmp(rohc_decomp_get_state_descr(ROHC_DECOMP_STATE_NC), "No Context") == 0);
 	CHECK(strcmp(rohc_decomp_get_state_descr(ROHC_DECOMP_STATE_SC), "Static Context") == 0);
@@ -402,6 +1415,7 @@ int main(int argc, char *argv[])
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == false);
+		CHECK(rohc_decomp_set_trace_level(decomp, ROHC_TRACE_ERROR) == false);
 	}
 
 	/* rohc_decomp_free() */
@@ -416,3 +1430,74 @@ error:
 	return is_failure;
 }
 
+
+/**
+ * @brief Memory allocation callback: use the system allocator
+ *
+ * @param size       The number of bytes to allocate
+ * @param priv_ctxt  Private data
+ * @return           The allocated memory, NULL if allocation failed
+ */
+static void * mem_alloc_cb(const size_t size,
+                           void *const priv_ctxt __attribute__((unused)))
+{
+	return malloc(size);
+}
+
+
+/**
+ * @brief Memory release callback: use the system allocator
+ *
+ * @param ptr        The memory to release
+ * @param size       The number of bytes to release
+ * @param priv_ctxt  Private data
+ */
+static void mem_free_cb(void *const ptr,
+                        const size_t size __attribute__((unused)),
+                        void *const priv_ctxt __attribute__((unused)))
+{
+	free(ptr);
+}
+
+
+/**
+ * @brief Context event callback: count the events per type
+ *
+ * @param decomp     The ROHC decompressor
+ * @param event      The event of the decompression context
+ * @param priv_ctxt  The numbers of events per type
+ */
+static void ctxt_event_cb(const struct rohc_decomp *const decomp __attribute__((unused)),
+                          const struct rohc_decomp_ctxt_event *const event,
+                          void *const priv_ctxt)
+{
+	size_t *const events_nr = priv_ctxt;
+
+	assert(event->type <= ROHC_DECOMP_CTXT_EVENT_FREED);
+	assert(event->cid == 0);
+	assert(event->state == ROHC_DECOMP_STATE_FC);
+	events_nr[event->type]++;
+}
+
+
+/**
+ * @brief CRC callback: count the calls and return a wrong CRC
+ *
+ * @param crc_bits   The size of the CRC
+ * @param data       The data to compute the CRC over
+ * @param len        The length of the data
+ * @param init_val   The initial value of the CRC
+ * @param priv_ctxt  The number of calls
+ * @return           The complemented initial value
+ */
+static uint8_t crc_calc_cb(const size_t crc_bits,
+                           const uint8_t *const data __attribute__((unused)),
+                           const size_t len __attribute__((unused)),
+                           const uint8_t init_val,
+                           void *const priv_ctxt)
+{
+	size_t *const crc_calls_nr = priv_ctxt;
+
+	(*crc_calls_nr)++;
+	return (~init_val) & ((1U << crc_bits) - 1);
+}
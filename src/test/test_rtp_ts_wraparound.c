@@ -129,6 +129,7 @@ error:
 bool run_test(bool be_verbose, const unsigned int incr)
 {
 	struct ts_sc_comp ts_sc_comp;      /* the RTP TS encoding context */
+	struct rohc_mempool mempool;       /* the memory pool for the W-LSB windows */
 	struct ts_sc_decomp ts_sc_decomp; /* the RTP TS decoding context */
 
 	uint32_t value; /* the value to encode */
@@ -143,7 +144,9 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	uint64_t i;
 
 	/* create the RTP TS encoding context */
-	ret = c_create_sc(&ts_sc_comp, ROHC_WLSB_WINDOW_WIDTH, NULL, NULL);
+	rohc_mempool_init(&mempool);
+	ret = c_create_sc(&ts_sc_comp, ROHC_WLSB_WINDOW_WIDTH, &mempool, NULL, NULL,
+	                  ROHC_TRACE_DEBUG);
 	if(ret != 1)
 	{
 		fprintf(stderr, "failed to initialize the RTP TS encoding context\n");
@@ -151,7 +154,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	}
 
 	/* create the RTP TS decoding context */
-	d_init_sc(&ts_sc_decomp, NULL, NULL);
+	d_init_sc(&ts_sc_decomp, NULL, NULL, ROHC_TRACE_DEBUG);
 
 	/* compute the initial value to encode */
 	if(incr == 0)
@@ -299,7 +302,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 		}
 
 		/* update decoding context */
-		ts_update_context(&ts_sc_decomp, value_decoded, i);
+		ts_update_context(&ts_sc_decomp, value_decoded, i, 0);
 	}
 
 	/* test succeeds */
@@ -308,6 +311,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 
 destroy_ts_sc_comp:
 	c_destroy_sc(&ts_sc_comp);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
@@ -190,6 +190,7 @@ static bool run_test8_with_shift_param(bool be_verbose,
                                        const size_t loss_nr)
 {
 	struct c_wlsb wlsb; /* the W-LSB encoding context */
+	struct rohc_mempool mempool; /* the memory pool for the W-LSB window */
 	struct rohc_lsb_decode lsb; /* the LSB decoding context */
 
 	uint8_t value8; /* the value to encode */
@@ -204,7 +205,8 @@ static bool run_test8_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, win_size);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, win_size, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -318,6 +320,7 @@ static bool run_test8_with_shift_param(bool be_verbose,
 
 destroy_wlsb:
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
@@ -338,6 +341,7 @@ static bool run_test16_with_shift_param(bool be_verbose,
                                         const size_t loss_nr)
 {
 	struct c_wlsb wlsb; /* the W-LSB encoding context */
+	struct rohc_mempool mempool; /* the memory pool for the W-LSB window */
 	struct rohc_lsb_decode lsb; /* the LSB decoding context */
 
 	uint16_t value16; /* the value to encode */
@@ -352,7 +356,8 @@ static bool run_test16_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, win_size);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, win_size, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -466,6 +471,7 @@ static bool run_test16_with_shift_param(bool be_verbose,
 
 destroy_wlsb:
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
@@ -486,6 +492,7 @@ static bool run_test32_with_shift_param(bool be_verbose,
                                         const size_t loss_nr)
 {
 	struct c_wlsb wlsb; /* the W-LSB encoding context */
+	struct rohc_mempool mempool; /* the memory pool for the W-LSB window */
 	struct rohc_lsb_decode lsb; /* the LSB decoding context */
 
 	uint32_t value32; /* the value to encode */
@@ -500,7 +507,8 @@ static bool run_test32_with_shift_param(bool be_verbose,
 	assert(win_size > 0);
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, win_size);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, win_size, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -614,6 +622,7 @@ static bool run_test32_with_shift_param(bool be_verbose,
 
 destroy_wlsb:
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
@@ -47,6 +47,7 @@
 static bool run_test8_with_shift_param(bool be_verbose, const short p);
 static bool run_test16_with_shift_param(bool be_verbose, const short p);
 static bool run_test32_with_shift_param(bool be_verbose, const short p);
+static bool run_test_ack(bool be_verbose);
 
 static void init_wlsb_8(struct c_wlsb *const wlsb,
                         struct rohc_lsb_decode *const lsb,
@@ -172,6 +173,15 @@ int main(int argc, char *argv[])
 		trace(extraverbose, "\n");
 	}
 
+	/* acknowledge window entries with SNs that wrap around */
+	trace(verbose, "run test with acknowledgments at SN wraparound\n");
+	if(!run_test_ack(extraverbose))
+	{
+		fprintf(stderr, "test with acknowledgments at SN wraparound failed\n");
+		goto error;
+	}
+	trace(extraverbose, "\n");
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -191,6 +201,7 @@ error:
 bool run_test8_with_shift_param(bool be_verbose, const short p)
 {
 	struct c_wlsb wlsb; /* the W-LSB encoding context */
+	struct rohc_mempool mempool; /* the memory pool for the W-LSB window */
 	struct rohc_lsb_decode lsb; /* the LSB decoding context */
 
 	uint8_t value8; /* the value to encode */
@@ -201,7 +212,8 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 	bool is_ok;
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -239,6 +251,7 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 
 destroy_wlsb:
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
@@ -254,6 +267,7 @@ error:
 bool run_test16_with_shift_param(bool be_verbose, const short p)
 {
 	struct c_wlsb wlsb; /* the W-LSB encoding context */
+	struct rohc_mempool mempool; /* the memory pool for the W-LSB window */
 	struct rohc_lsb_decode lsb; /* the LSB decoding context */
 
 	uint16_t value16; /* the value to encode */
@@ -264,7 +278,8 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 	bool is_ok;
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -297,12 +312,28 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 		}
 	}
 
+	/* narrow then widen the window, and go on encoding values [101, 300] */
+	wlsb_set_width(&wlsb, ROHC_WLSB_WIDTH_MIN);
+	for(i = 101; i <= 300; i++)
+	{
+		if(i == 200)
+		{
+			wlsb_set_width(&wlsb, ROHC_WLSB_INLINE_WIDTH);
+		}
+		value16 = i;
+		if(!test_wlsb_16(&wlsb, &lsb, value16, p, be_verbose))
+		{
+			goto destroy_wlsb;
+		}
+	}
+
 	/* test succeeds */
 	trace(be_verbose, "\ttest with shift parameter %d is successful\n", p);
 	is_success = true;
 
 destroy_wlsb:
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
@@ -318,6 +349,7 @@ error:
 bool run_test32_with_shift_param(bool be_verbose, const short p)
 {
 	struct c_wlsb wlsb; /* the W-LSB encoding context */
+	struct rohc_mempool mempool; /* the memory pool for the W-LSB window */
 	struct rohc_lsb_decode lsb; /* the LSB decoding context */
 
 	uint32_t value32; /* the value to encode */
@@ -328,7 +360,8 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	bool is_ok;
 
 	/* create the W-LSB encoding context */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -363,9 +396,11 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 
 	/* destroy the W-LSB encoding context */
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 
 	/* create the W-LSB encoding context again */
-	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -401,9 +436,11 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 
 	/* destroy the W-LSB encoding context */
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 
 	/* create the W-LSB encoding context again */
-	is_ok = wlsb_new(&wlsb, 64U);
+	rohc_mempool_init(&mempool);
+	is_ok = wlsb_new(&wlsb, 64U, &mempool);
 	if(!is_ok)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -454,6 +491,95 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 
 destroy_wlsb:
 	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Run the test of acknowledgments with 16-bit SNs that wrap around
+ *
+ * @param be_verbose  Whether to print traces or not
+ * @return            true if test succeeds, false otherwise
+ */
+static bool run_test_ack(bool be_verbose)
+{
+	struct c_wlsb wlsb; /* the W-LSB encoding context */
+	struct rohc_mempool mempool; /* the memory pool for the W-LSB window */
+	uint32_t sn;
+	size_t acked_nr;
+	bool is_success = false; /* test fails by default */
+
+	/* create the W-LSB encoding context */
+	rohc_mempool_init(&mempool);
+	if(!wlsb_new(&wlsb, ROHC_WLSB_WINDOW_WIDTH, &mempool))
+	{
+		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
+		goto error;
+	}
+
+	/* fill the window with SNs 0xfffe, 0xffff, 0 and 1 */
+	for(sn = 0xfffe; sn <= 0x10001; sn++)
+	{
+		c_add_wlsb(&wlsb, sn & 0xffff, sn & 0xffff);
+	}
+	for(sn = 0xfffe; sn <= 0x10001; sn++)
+	{
+		if(!wlsb_is_sn_present(&wlsb, sn & 0xffff))
+		{
+			fprintf(stderr, "SN 0x%04x not found in window\n", sn & 0xffff);
+			goto destroy_wlsb;
+		}
+	}
+	if(wlsb_is_sn_present(&wlsb, 0xfffd) || wlsb_is_sn_present(&wlsb, 2))
+	{
+		fprintf(stderr, "SN found in window while it was never added\n");
+		goto destroy_wlsb;
+	}
+
+	/* acknowledge SN 0xffff with 4 LSB: SN 0xfffe is removed */
+	acked_nr = wlsb_ack(&wlsb, 0xf, 4);
+	trace(be_verbose, "\tACK of SN 0xffff removed %zu entries\n", acked_nr);
+	if(acked_nr != 1 || wlsb.count != 3 ||
+	   wlsb_is_sn_present(&wlsb, 0xfffe) || !wlsb_is_sn_present(&wlsb, 0xffff))
+	{
+		fprintf(stderr, "ACK of SN 0xffff with 4 bits failed\n");
+		goto destroy_wlsb;
+	}
+
+	/* acknowledge SN 1 with 16 LSB: SNs 0xffff and 0 are removed */
+	acked_nr = wlsb_ack(&wlsb, 1, 16);
+	trace(be_verbose, "\tACK of SN 1 removed %zu entries\n", acked_nr);
+	if(acked_nr != 2 || wlsb.count != 1 ||
+	   wlsb_is_sn_present(&wlsb, 0) || !wlsb_is_sn_present(&wlsb, 1))
+	{
+		fprintf(stderr, "ACK of SN 1 with 16 bits failed\n");
+		goto destroy_wlsb;
+	}
+
+	/* acknowledge an unknown SN: nothing is removed */
+	if(wlsb_ack(&wlsb, 0x1234, 16) != 0 || wlsb.count != 1)
+	{
+		fprintf(stderr, "ACK of unknown SN removed entries\n");
+		goto destroy_wlsb;
+	}
+
+	/* the window is filled again by the next values */
+	c_add_wlsb(&wlsb, 2, 2);
+	if(wlsb.count != 2 || wlsb_get_minkp_16bits(&wlsb, 3, 0) != 2)
+	{
+		fprintf(stderr, "window not filled again after ACKs\n");
+		goto destroy_wlsb;
+	}
+
+	/* test succeeds */
+	trace(be_verbose, "\ttest with acknowledgments is successful\n");
+	is_success = true;
+
+destroy_wlsb:
+	wlsb_free(&wlsb);
+	rohc_mempool_free(&mempool);
 error:
 	return is_success;
 }
@@ -508,6 +634,18 @@ static bool test_wlsb_8(struct c_wlsb *const wlsb,
 	{
 	}
 	assert(required_bits <= 8);
+	assert(wlsb_get_minkp_8bits(wlsb, value8, p) == required_bits);
+	{
+		struct wlsb_range range;
+		size_t k;
+
+		wlsb_get_range_8bits(wlsb, value8, &range);
+		for(k = 0; k <= 8; k++)
+		{
+			assert(wlsb_range_is_kp_possible(&range, k, p) ==
+			       wlsb_is_kp_possible_8bits(wlsb, value8, k, p));
+		}
+	}
 	if(required_bits == 8)
 	{
 		required_bits_mask = 0xff;
@@ -604,6 +742,18 @@ static bool test_wlsb_16(struct c_wlsb *const wlsb,
 	{
 	}
 	assert(required_bits <= 16);
+	assert(wlsb_get_minkp_16bits(wlsb, value16, p) == required_bits);
+	{
+		struct wlsb_range range;
+		size_t k;
+
+		wlsb_get_range_16bits(wlsb, value16, &range);
+		for(k = 0; k <= 16; k++)
+		{
+			assert(wlsb_range_is_kp_possible(&range, k, p) ==
+			       wlsb_is_kp_possible_16bits(wlsb, value16, k, p));
+		}
+	}
 	if(required_bits == 16)
 	{
 		required_bits_mask = 0xffff;
@@ -703,7 +853,19 @@ static bool test_wlsb_32(struct c_wlsb *const wlsb,
 		fprintf(stderr, "required_bits shall be <= 32\n");
 		goto error;
 	}
-	else if(required_bits == 32)
+	assert(wlsb_get_minkp_32bits(wlsb, value32, p) == required_bits);
+	{
+		struct wlsb_range range;
+		size_t k;
+
+		wlsb_get_range_32bits(wlsb, value32, &range);
+		for(k = 0; k <= 32; k++)
+		{
+			assert(wlsb_range_is_kp_possible(&range, k, p) ==
+			       wlsb_is_kp_possible_32bits(wlsb, value32, k, p));
+		}
+	}
+	if(required_bits == 32)
 	{
 		required_bits_mask = 0xffffffff;
 	}
@@ -0,0 +1,956 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_gso.c
+ * @brief  Check the compression of TSO/GSO super-packets and their coalescing
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The application compresses some IP/TCP and IP/UDP flows of super-packets
+ * with \ref rohc_compress_gso. Every super-packet is also segmented by the
+ * application, and its segments are compressed one by one with
+ * \ref rohc_compress4 by a second compressor. The ROHC packets of both
+ * compressors shall be the same, and the decompressed packets shall be the
+ * segments built by the application.
+ *
+ * The ROHC packets of the TCP super-packets are then decompressed with
+ * \ref rohc_decompress_burst_gro: the segments shall be coalesced back into
+ * the super-packets, with valid checksums.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+#include "protocols/ip_numbers.h"
+
+
+/** The number of super-packets of every flow */
+#define TEST_SUPER_PKTS_NR  3U
+
+/** The maximum number of segments of one super-packet */
+#define TEST_SEGS_MAX  8U
+
+/** The maximum length of the super-packets (in bytes) */
+#define TEST_SUPER_PKT_MAX_LEN  (TEST_SEGS_MAX * 1500U)
+
+/** The length of the buffers for the segments and ROHC packets (in bytes) */
+#define TEST_BUF_LEN  2048U
+
+
+/** The description of one flow of super-packets */
+struct test_flow
+{
+	const char *descr;     /**< The description of the flow */
+	int ip_version;        /**< The version of the IP header */
+	uint8_t proto;         /**< The transport protocol */
+	size_t l4_off;         /**< The offset of the transport header */
+	size_t hdrs_len;       /**< The length of all the headers */
+	size_t gso_size;       /**< The length of the payload of the segments */
+	size_t payload_len;    /**< The payload length of the super-packets */
+};
+
+
+static void usage(void);
+
+static bool test_gso_flow(const struct test_flow *const flow,
+                          const bool verbose)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool test_gso_too_many_segs(const bool verbose)
+	__attribute__((warn_unused_result));
+
+static bool test_gro_flow(const struct test_flow *const flow,
+                          const bool verbose)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static struct rohc_comp * create_comp(const bool verbose)
+	__attribute__((warn_unused_result));
+
+static size_t build_super_pkt(const struct test_flow *const flow,
+                              const size_t super_num,
+                              uint8_t *const data)
+	__attribute__((nonnull(1, 3)));
+
+static size_t build_seg(const struct test_flow *const flow,
+                        const uint8_t *const super_pkt,
+                        const size_t seg_num,
+                        const size_t segs_nr,
+                        uint8_t *const data)
+	__attribute__((nonnull(1, 2, 5)));
+
+static void set_l4_csum(const struct test_flow *const flow,
+                        uint8_t *const data,
+                        const size_t len)
+	__attribute__((nonnull(1, 2)));
+
+static void set_ipv4_csum(uint8_t *const data)
+	__attribute__((nonnull(1)));
+
+static uint32_t csum_add(uint32_t sum,
+                         const uint8_t *const data,
+                         const size_t len)
+	__attribute__((nonnull(2)));
+
+static uint16_t csum_fold(uint32_t sum);
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/** The flows of super-packets to compress */
+static const struct test_flow test_flows[] =
+{
+	{
+		.descr = "IPv4/TCP",
+		.ip_version = 4,
+		.proto = ROHC_IPPROTO_TCP,
+		.l4_off = 20,
+		.hdrs_len = 20 + 20 + 12,
+		.gso_size = 1000,
+		.payload_len = 4 * 1000 + 500,
+	},
+	{
+		.descr = "IPv6/UDP",
+		.ip_version = 6,
+		.proto = ROHC_IPPROTO_UDP,
+		.l4_off = 40,
+		.hdrs_len = 40 + 8,
+		.gso_size = 1200,
+		.payload_len = 3 * 1200,
+	},
+	{
+		.descr = "IPv6/TCP",
+		.ip_version = 6,
+		.proto = ROHC_IPPROTO_TCP,
+		.l4_off = 40,
+		.hdrs_len = 40 + 20 + 12,
+		.gso_size = 999, /* odd segments for the checksums */
+		.payload_len = 5 * 999 + 1,
+	},
+};
+
+
+/**
+ * @brief Check the compression of TSO/GSO super-packets
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose = false;
+	int status = 1;
+	size_t i;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc--, argv++)
+	{
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			verbose = true;
+		}
+		else
+		{
+			fprintf(stderr, "unexpected argument '%s'\n", *argv);
+			usage();
+			goto error;
+		}
+	}
+
+	for(i = 0; i < (sizeof(test_flows) / sizeof(test_flows[0])); i++)
+	{
+		if(!test_gso_flow(&test_flows[i], verbose))
+		{
+			fprintf(stderr, "%s flow: test failed\n", test_flows[i].descr);
+			goto error;
+		}
+		if(test_flows[i].proto == ROHC_IPPROTO_TCP &&
+		   !test_gro_flow(&test_flows[i], verbose))
+		{
+			fprintf(stderr, "%s flow: GRO test failed\n", test_flows[i].descr);
+			goto error;
+		}
+	}
+	if(!test_gso_too_many_segs(verbose))
+	{
+		goto error;
+	}
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check the compression of TSO/GSO super-packets and their coalescing\n"
+	        "\n"
+	        "usage: test_gso [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  --verbose               Print the traces of the ROHC library\n"
+	        "  -h, --help              Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress and decompress one flow of super-packets
+ *
+ * @param flow     The flow of super-packets
+ * @param verbose  Whether to print the traces of the library or not
+ * @return         true if the super-packets were compressed as expected,
+ *                 false otherwise
+ */
+static bool test_gso_flow(const struct test_flow *const flow,
+                          const bool verbose)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const size_t segs_nr =
+		(flow->payload_len + flow->gso_size - 1) / flow->gso_size;
+	static uint8_t super_data[TEST_SUPER_PKT_MAX_LEN];
+	static uint8_t rohc_data[TEST_SEGS_MAX][TEST_BUF_LEN];
+	struct rohc_buf rohc_pkts[TEST_SEGS_MAX];
+	struct rohc_comp *comp;
+	struct rohc_comp *comp_ref;
+	struct rohc_decomp *decomp;
+	size_t super_num;
+	bool is_success = false;
+
+	assert(segs_nr <= TEST_SEGS_MAX);
+	assert((flow->hdrs_len + flow->payload_len) <= TEST_SUPER_PKT_MAX_LEN);
+
+	/* the compressor of super-packets and the one of segments */
+	comp = create_comp(verbose);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	comp_ref = create_comp(verbose);
+	if(comp_ref == NULL)
+	{
+		goto free_comp;
+	}
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto free_comp_ref;
+	}
+	if(verbose && !rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the traces of the decompressor\n");
+		goto free_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHCv1_PROFILE_IP_TCP,
+	                                ROHCv1_PROFILE_IP_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decomp;
+	}
+
+	for(super_num = 0; super_num < TEST_SUPER_PKTS_NR; super_num++)
+	{
+		const size_t super_len = build_super_pkt(flow, super_num, super_data);
+		const struct rohc_buf super_pkt =
+			rohc_buf_init_full(super_data, super_len, arrival_time);
+		size_t rohc_pkts_nr;
+		rohc_status_t status;
+		size_t i;
+
+		for(i = 0; i < TEST_SEGS_MAX; i++)
+		{
+			const struct rohc_buf rohc_pkt =
+				rohc_buf_init_empty(rohc_data[i], TEST_BUF_LEN);
+			rohc_pkts[i] = rohc_pkt;
+		}
+
+		/* compress the super-packet at once */
+		status = rohc_compress_gso(comp, super_pkt, flow->gso_size, rohc_pkts,
+		                           TEST_SEGS_MAX, &rohc_pkts_nr);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "super-packet #%zu: failed to compress the "
+			        "super-packet (%s)\n", super_num + 1, rohc_strerror(status));
+			goto free_decomp;
+		}
+		if(rohc_pkts_nr != segs_nr)
+		{
+			fprintf(stderr, "super-packet #%zu: %zu ROHC packets while %zu "
+			        "segments were expected\n", super_num + 1, rohc_pkts_nr,
+			        segs_nr);
+			goto free_decomp;
+		}
+
+		for(i = 0; i < segs_nr; i++)
+		{
+			uint8_t seg_data[TEST_BUF_LEN];
+			uint8_t ref_data[TEST_BUF_LEN];
+			uint8_t decomp_data[TEST_BUF_LEN];
+			const size_t seg_len =
+				build_seg(flow, super_data, i, segs_nr, seg_data);
+			const struct rohc_buf seg =
+				rohc_buf_init_full(seg_data, seg_len, arrival_time);
+			struct rohc_buf ref_pkt = rohc_buf_init_empty(ref_data, TEST_BUF_LEN);
+			struct rohc_buf decomp_pkt =
+				rohc_buf_init_empty(decomp_data, TEST_BUF_LEN);
+
+			/* compress the segment built by the application */
+			status = rohc_compress4(comp_ref, seg, &ref_pkt);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "super-packet #%zu: segment #%zu: failed to "
+				        "compress the segment (%s)\n", super_num + 1, i + 1,
+				        rohc_strerror(status));
+				goto free_decomp;
+			}
+			if(rohc_pkts[i].len != ref_pkt.len ||
+			   memcmp(rohc_buf_data(rohc_pkts[i]), rohc_buf_data(ref_pkt),
+			          ref_pkt.len) != 0)
+			{
+				fprintf(stderr, "super-packet #%zu: segment #%zu: the %zu-byte "
+				        "ROHC packet does not match the %zu-byte ROHC packet of "
+				        "the segment\n", super_num + 1, i + 1, rohc_pkts[i].len,
+				        ref_pkt.len);
+				goto free_decomp;
+			}
+
+			/* decompress the ROHC packet of the super-packet */
+			rohc_pkts[i].time = arrival_time;
+			status = rohc_decompress3(decomp, rohc_pkts[i], &decomp_pkt,
+			                          NULL, NULL);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "super-packet #%zu: segment #%zu: failed to "
+				        "decompress the ROHC packet (%s)\n", super_num + 1, i + 1,
+				        rohc_strerror(status));
+				goto free_decomp;
+			}
+			if(decomp_pkt.len != seg_len ||
+			   memcmp(rohc_buf_data(decomp_pkt), seg_data, seg_len) != 0)
+			{
+				fprintf(stderr, "super-packet #%zu: segment #%zu: the %zu-byte "
+				        "decompressed packet does not match the %zu-byte "
+				        "segment\n", super_num + 1, i + 1, decomp_pkt.len, seg_len);
+				goto free_decomp;
+			}
+		}
+	}
+	is_success = true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp_ref:
+	rohc_comp_free(comp_ref);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Check that no segment is compressed if there are too few ROHC packets
+ *
+ * @param verbose  Whether to print the traces of the library or not
+ * @return         true if the super-packet was refused as expected,
+ *                 false otherwise
+ */
+static bool test_gso_too_many_segs(const bool verbose)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const struct test_flow *const flow = &test_flows[0];
+	static uint8_t super_data[TEST_SUPER_PKT_MAX_LEN];
+	static uint8_t rohc_data[2][TEST_BUF_LEN];
+	struct rohc_buf rohc_pkts[2] =
+	{
+		rohc_buf_init_empty(rohc_data[0], TEST_BUF_LEN),
+		rohc_buf_init_empty(rohc_data[1], TEST_BUF_LEN),
+	};
+	const size_t super_len = build_super_pkt(flow, 0, super_data);
+	const struct rohc_buf super_pkt =
+		rohc_buf_init_full(super_data, super_len, arrival_time);
+	struct rohc_comp *comp;
+	size_t rohc_pkts_nr = 42;
+	rohc_status_t status;
+	bool is_success = false;
+
+	comp = create_comp(verbose);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	status = rohc_compress_gso(comp, super_pkt, flow->gso_size, rohc_pkts, 2,
+	                           &rohc_pkts_nr);
+	if(status != ROHC_STATUS_OUTPUT_TOO_SMALL)
+	{
+		fprintf(stderr, "too many segments: unexpected status (%s)\n",
+		        rohc_strerror(status));
+		goto free_comp;
+	}
+	if(rohc_pkts_nr != 0 || rohc_pkts[0].len != 0 || rohc_pkts[1].len != 0)
+	{
+		fprintf(stderr, "too many segments: some segments were compressed\n");
+		goto free_comp;
+	}
+	is_success = true;
+
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Coalesce the decompressed segments of one flow of super-packets
+ *
+ * @param flow     The flow of TCP super-packets
+ * @param verbose  Whether to print the traces of the library or not
+ * @return         true if the segments were coalesced as expected,
+ *                 false otherwise
+ */
+static bool test_gro_flow(const struct test_flow *const flow,
+                          const bool verbose)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const size_t segs_nr =
+		(flow->payload_len + flow->gso_size - 1) / flow->gso_size;
+	static uint8_t super_data[TEST_SUPER_PKT_MAX_LEN];
+	static uint8_t rohc_data[TEST_SEGS_MAX][TEST_BUF_LEN];
+	static uint8_t uncomp_data[TEST_SEGS_MAX][TEST_SUPER_PKT_MAX_LEN];
+	struct rohc_buf rohc_pkts[TEST_SEGS_MAX];
+	struct rohc_buf uncomp_pkts[TEST_SEGS_MAX];
+	struct rohc_decomp_gro_info gro_infos[TEST_SEGS_MAX];
+	rohc_status_t statuses[TEST_SEGS_MAX];
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	size_t super_num;
+	bool is_success = false;
+
+	comp = create_comp(verbose);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto free_comp;
+	}
+	if(verbose && !rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the traces of the decompressor\n");
+		goto free_decomp;
+	}
+	if(!rohc_decomp_enable_profile(decomp, ROHCv1_PROFILE_IP_TCP))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decomp;
+	}
+
+	for(super_num = 0; super_num < TEST_SUPER_PKTS_NR; super_num++)
+	{
+		const size_t super_len = build_super_pkt(flow, super_num, super_data);
+		const struct rohc_buf super_pkt =
+			rohc_buf_init_full(super_data, super_len, arrival_time);
+		size_t rohc_pkts_nr;
+		rohc_status_t status;
+		size_t i;
+
+		for(i = 0; i < TEST_SEGS_MAX; i++)
+		{
+			const struct rohc_buf rohc_pkt =
+				rohc_buf_init_empty(rohc_data[i], TEST_BUF_LEN);
+			const struct rohc_buf uncomp_pkt =
+				rohc_buf_init_empty(uncomp_data[i], TEST_SUPER_PKT_MAX_LEN);
+			rohc_pkts[i] = rohc_pkt;
+			rohc_pkts[i].time = arrival_time;
+			uncomp_pkts[i] = uncomp_pkt;
+		}
+
+		status = rohc_compress_gso(comp, super_pkt, flow->gso_size, rohc_pkts,
+		                           TEST_SEGS_MAX, &rohc_pkts_nr);
+		if(status != ROHC_STATUS_OK || rohc_pkts_nr != segs_nr)
+		{
+			fprintf(stderr, "super-packet #%zu: failed to compress the "
+			        "super-packet (%s)\n", super_num + 1, rohc_strerror(status));
+			goto free_decomp;
+		}
+
+		/* decompress and coalesce the segments */
+		if(rohc_decompress_burst_gro(decomp, rohc_pkts, uncomp_pkts, statuses,
+		                             gro_infos, rohc_pkts_nr) != rohc_pkts_nr)
+		{
+			fprintf(stderr, "super-packet #%zu: failed to decompress the "
+			        "burst\n", super_num + 1);
+			goto free_decomp;
+		}
+		for(i = 0; i < rohc_pkts_nr; i++)
+		{
+			if(statuses[i] != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "super-packet #%zu: segment #%zu: failed to "
+				        "decompress the ROHC packet (%s)\n", super_num + 1, i + 1,
+				        rohc_strerror(statuses[i]));
+				goto free_decomp;
+			}
+			if(i > 0 && (gro_infos[i].segs_nr != 0 || uncomp_pkts[i].len != 0))
+			{
+				fprintf(stderr, "super-packet #%zu: segment #%zu: segment not "
+				        "coalesced\n", super_num + 1, i + 1);
+				goto free_decomp;
+			}
+		}
+		if(gro_infos[0].segs_nr != segs_nr ||
+		   gro_infos[0].gso_size != flow->gso_size ||
+		   gro_infos[0].hdr_len != flow->hdrs_len ||
+		   gro_infos[0].tcp_offset != flow->l4_off ||
+		   gro_infos[0].is_ipv6 != (flow->ip_version == 6))
+		{
+			fprintf(stderr, "super-packet #%zu: unexpected GRO information: "
+			        "%zu segments of %zu bytes, %zu-byte headers\n",
+			        super_num + 1, gro_infos[0].segs_nr, gro_infos[0].gso_size,
+			        gro_infos[0].hdr_len);
+			goto free_decomp;
+		}
+
+		/* the coalesced packet is the super-packet with a valid checksum */
+		set_l4_csum(flow, super_data, super_len);
+		if(uncomp_pkts[0].len != super_len ||
+		   memcmp(rohc_buf_data(uncomp_pkts[0]), super_data, super_len) != 0)
+		{
+			fprintf(stderr, "super-packet #%zu: the %zu-byte coalesced packet "
+			        "does not match the %zu-byte super-packet\n", super_num + 1,
+			        uncomp_pkts[0].len, super_len);
+			goto free_decomp;
+		}
+	}
+	is_success = true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Create one compressor with the IP/TCP and IP/UDP profiles
+ *
+ * @param verbose  Whether to print the traces of the library or not
+ * @return         The new compressor, NULL in case of error
+ */
+static struct rohc_comp * create_comp(const bool verbose)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(verbose && !rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the traces of the compressor\n");
+		goto free_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_IP_TCP,
+	                              ROHCv1_PROFILE_IP_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto free_comp;
+	}
+
+	return comp;
+
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Build one super-packet of the given flow
+ *
+ * The transport checksum of the super-packet is a bogus one, as with checksum
+ * offload: \ref rohc_compress_gso shall compute the ones of the segments.
+ *
+ * @param flow       The flow of super-packets
+ * @param super_num  The number of the super-packet in the flow
+ * @param[out] data  The memory to write the super-packet in
+ * @return           The length of the super-packet
+ */
+static size_t build_super_pkt(const struct test_flow *const flow,
+                              const size_t super_num,
+                              uint8_t *const data)
+{
+	const size_t len = flow->hdrs_len + flow->payload_len;
+	const size_t l4_len = len - flow->l4_off;
+	const size_t segs_nr =
+		(flow->payload_len + flow->gso_size - 1) / flow->gso_size;
+	uint8_t *const l4 = data + flow->l4_off;
+	size_t i;
+
+	memset(data, 0, flow->hdrs_len);
+
+	if(flow->ip_version == 4)
+	{
+		const uint16_t ip_id = 0x100 + super_num * segs_nr;
+
+		data[0] = 0x45;
+		data[2] = (len >> 8) & 0xff;
+		data[3] = len & 0xff;
+		data[4] = (ip_id >> 8) & 0xff;
+		data[5] = ip_id & 0xff;
+		data[6] = 0x40; /* DF */
+		data[8] = 64;
+		data[9] = flow->proto;
+		data[12] = 192;
+		data[13] = 168;
+		data[15] = 1;
+		data[16] = 192;
+		data[17] = 168;
+		data[19] = 2;
+		set_ipv4_csum(data);
+	}
+	else
+	{
+		data[0] = 0x60;
+		data[4] = (l4_len >> 8) & 0xff;
+		data[5] = l4_len & 0xff;
+		data[6] = flow->proto;
+		data[7] = 64;
+		data[8] = 0x20;
+		data[9] = 0x01;
+		data[10] = 0x0d;
+		data[11] = 0xb8;
+		data[23] = 1;
+		data[24] = 0x20;
+		data[25] = 0x01;
+		data[26] = 0x0d;
+		data[27] = 0xb8;
+		data[39] = 2;
+	}
+
+	if(flow->proto == ROHC_IPPROTO_TCP)
+	{
+		const uint32_t seq = 0x01020304 + super_num * flow->payload_len;
+		const uint32_t tsval = 1000 + super_num;
+
+		l4[0] = 0x9c; /* source port 40000 */
+		l4[1] = 0x40;
+		l4[3] = 80;
+		l4[4] = (seq >> 24) & 0xff;
+		l4[5] = (seq >> 16) & 0xff;
+		l4[6] = (seq >> 8) & 0xff;
+		l4[7] = seq & 0xff;
+		l4[11] = 0x42; /* ACK number */
+		l4[12] = (32 / 4) << 4;
+		l4[13] = 0x18; /* PSH, ACK */
+		l4[14] = 0x01; /* window */
+		l4[16] = 0xde; /* bogus checksum */
+		l4[17] = 0xad;
+		l4[20] = 0x01; /* NOP */
+		l4[21] = 0x01; /* NOP */
+		l4[22] = 0x08; /* Timestamp */
+		l4[23] = 10;
+		l4[24] = (tsval >> 24) & 0xff;
+		l4[25] = (tsval >> 16) & 0xff;
+		l4[26] = (tsval >> 8) & 0xff;
+		l4[27] = tsval & 0xff;
+		l4[31] = 0x07;
+	}
+	else
+	{
+		l4[0] = 0x9c; /* source port 40000 */
+		l4[1] = 0x40;
+		l4[2] = 0x11; /* destination port 4433 */
+		l4[3] = 0x51;
+		l4[4] = (l4_len >> 8) & 0xff;
+		l4[5] = l4_len & 0xff;
+		l4[6] = 0xde; /* bogus checksum */
+		l4[7] = 0xad;
+	}
+
+	for(i = flow->hdrs_len; i < len; i++)
+	{
+		data[i] = (uint8_t) (i * 7 + super_num);
+	}
+
+	return len;
+}
+
+
+/**
+ * @brief Build one segment of the given super-packet as a host stack would
+ *
+ * @param flow       The flow of super-packets
+ * @param super_pkt  The super-packet
+ * @param seg_num    The number of the segment in the super-packet
+ * @param segs_nr    The number of segments of the super-packet
+ * @param[out] data  The memory to write the segment in
+ * @return           The length of the segment
+ */
+static size_t build_seg(const struct test_flow *const flow,
+                        const uint8_t *const super_pkt,
+                        const size_t seg_num,
+                        const size_t segs_nr,
+                        uint8_t *const data)
+{
+	const size_t seg_off = seg_num * flow->gso_size;
+	const size_t seg_payload_len =
+		((flow->payload_len - seg_off) < flow->gso_size ?
+		 (flow->payload_len - seg_off) : flow->gso_size);
+	const size_t len = flow->hdrs_len + seg_payload_len;
+	const size_t l4_len = len - flow->l4_off;
+	uint8_t *const l4 = data + flow->l4_off;
+
+	memcpy(data, super_pkt, flow->hdrs_len);
+	memcpy(data + flow->hdrs_len, super_pkt + flow->hdrs_len + seg_off,
+	       seg_payload_len);
+
+	if(flow->ip_version == 4)
+	{
+		const uint16_t ip_id = ((data[4] << 8) | data[5]) + seg_num;
+
+		data[2] = (len >> 8) & 0xff;
+		data[3] = len & 0xff;
+		data[4] = (ip_id >> 8) & 0xff;
+		data[5] = ip_id & 0xff;
+		set_ipv4_csum(data);
+	}
+	else
+	{
+		data[4] = (l4_len >> 8) & 0xff;
+		data[5] = l4_len & 0xff;
+	}
+
+	if(flow->proto == ROHC_IPPROTO_TCP)
+	{
+		const uint32_t seq =
+			((l4[4] << 24) | (l4[5] << 16) | (l4[6] << 8) | l4[7]) + seg_off;
+
+		l4[4] = (seq >> 24) & 0xff;
+		l4[5] = (seq >> 16) & 0xff;
+		l4[6] = (seq >> 8) & 0xff;
+		l4[7] = seq & 0xff;
+		if((seg_num + 1) < segs_nr)
+		{
+			l4[13] &= ~0x09; /* FIN and PSH for the last segment only */
+		}
+		if(seg_num > 0)
+		{
+			l4[13] &= ~0x80; /* CWR for the first segment only */
+		}
+	}
+	else
+	{
+		l4[4] = (l4_len >> 8) & 0xff;
+		l4[5] = l4_len & 0xff;
+	}
+	set_l4_csum(flow, data, len);
+
+	return len;
+}
+
+
+/**
+ * @brief Compute the TCP or UDP checksum of the given packet
+ *
+ * @param flow  The flow of the packet
+ * @param data  The packet
+ * @param len   The length of the packet
+ */
+static void set_l4_csum(const struct test_flow *const flow,
+                        uint8_t *const data,
+                        const size_t len)
+{
+	const size_t l4_len = len - flow->l4_off;
+	const size_t csum_off = (flow->proto == ROHC_IPPROTO_TCP ? 16 : 6);
+	uint8_t *const l4 = data + flow->l4_off;
+	uint32_t sum;
+	uint16_t csum;
+
+	/* pseudo-header */
+	if(flow->ip_version == 4)
+	{
+		sum = csum_add(0, data + 12, 8);
+	}
+	else
+	{
+		sum = csum_add(0, data + 8, 32);
+	}
+	sum += flow->proto + l4_len;
+
+	l4[csum_off] = 0;
+	l4[csum_off + 1] = 0;
+	csum = ~csum_fold(csum_add(sum, l4, l4_len)) & 0xffff;
+	if(flow->proto == ROHC_IPPROTO_UDP && csum == 0)
+	{
+		csum = 0xffff;
+	}
+	l4[csum_off] = (csum >> 8) & 0xff;
+	l4[csum_off + 1] = csum & 0xff;
+}
+
+
+/**
+ * @brief Compute the checksum of the given IPv4 header
+ *
+ * @param data  The IPv4 header without options
+ */
+static void set_ipv4_csum(uint8_t *const data)
+{
+	uint16_t csum;
+
+	data[10] = 0;
+	data[11] = 0;
+	csum = ~csum_fold(csum_add(0, data, 20)) & 0xffff;
+	data[10] = (csum >> 8) & 0xff;
+	data[11] = csum & 0xff;
+}
+
+
+/**
+ * @brief Add the given data to the given one's complement sum
+ *
+ * @param sum   The current sum
+ * @param data  The data to add
+ * @param len   The length of the data
+ * @return      The new sum
+ */
+static uint32_t csum_add(uint32_t sum,
+                         const uint8_t *const data,
+                         const size_t len)
+{
+	size_t i;
+
+	for(i = 0; (i + 1) < len; i += 2)
+	{
+		sum += (data[i] << 8) | data[i + 1];
+	}
+	if((len % 2) != 0)
+	{
+		sum += data[len - 1] << 8;
+	}
+	return sum;
+}
+
+
+/**
+ * @brief Fold the given one's complement sum on 16 bits
+ *
+ * @param sum  The sum
+ * @return     The folded sum
+ */
+static uint16_t csum_fold(uint32_t sum)
+{
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	return sum;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * Both compressors shall build the same ROHC packets, so the random numbers
+ * are not random at all.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0x1234;
+}
@@ -0,0 +1,426 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_ip_fragments.c
+ * @brief  Check that the IP-only profiles compress the IPv4 fragments
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * For the ROHCv1 and ROHCv2 IP-only profiles, the application compresses one
+ * flow of IPv4/UDP datagrams split in several IPv4 fragments, with the
+ * \e ROHC_COMP_FEATURE_IP_FRAGMENTS and \e ROHC_DECOMP_FEATURE_IP_FRAGMENTS
+ * features enabled, then decompresses the ROHC packets. All the fragments
+ * shall be compressed by the IP-only profile, their ROHC headers shall be
+ * smaller than their IPv4 headers once the context left the IR state, and the
+ * decompressed fragments shall be the uncompressed fragments.
+ *
+ * Without the features, the fragments shall be compressed by the Uncompressed
+ * profile as before.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of datagrams of the flow */
+#define TEST_DATAGRAMS_NR  10U
+
+/** The number of IPv4 fragments of every datagram */
+#define TEST_FRAGS_NR  3U
+
+/** The length of the payload of the fragments but the last one (in bytes) */
+#define TEST_FRAG_PAYLOAD_LEN  64U
+
+/** The length of the payload of the last fragment (in bytes) */
+#define TEST_LAST_FRAG_PAYLOAD_LEN  30U
+
+/** The max length of the uncompressed fragments (in bytes) */
+#define TEST_MAX_PKT_LEN  (20U + TEST_FRAG_PAYLOAD_LEN)
+
+
+static void usage(void);
+
+static bool test_ip_fragments(const rohc_profile_t profile,
+                              const bool with_features,
+                              const bool verbose)
+	__attribute__((warn_unused_result));
+
+static size_t build_ipv4_fragment(uint8_t *const data,
+                                  const size_t datagram_num,
+                                  const size_t frag_num)
+	__attribute__((nonnull(1)));
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that the IP-only profiles compress the IPv4 fragments
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose = false;
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc--, argv++)
+	{
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			verbose = true;
+		}
+		else
+		{
+			fprintf(stderr, "unexpected argument '%s'\n", *argv);
+			usage();
+			goto error;
+		}
+	}
+
+	if(!test_ip_fragments(ROHCv1_PROFILE_IP, true, verbose) ||
+	   !test_ip_fragments(ROHCv2_PROFILE_IP, true, verbose) ||
+	   !test_ip_fragments(ROHCv1_PROFILE_IP, false, verbose))
+	{
+		goto error;
+	}
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that the IP-only profiles compress the IPv4 fragments\n"
+	        "\n"
+	        "usage: test_ip_fragments [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  --verbose               Print the traces of the ROHC library\n"
+	        "  -h, --help              Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress and decompress one flow of IPv4 fragments
+ *
+ * @param profile        The IP-only profile to enable
+ * @param with_features  Whether to enable the IP fragments features or not
+ * @param verbose        Whether to print the traces of the library or not
+ * @return               true if the fragments were compressed and
+ *                       decompressed as expected, false otherwise
+ */
+static bool test_ip_fragments(const rohc_profile_t profile,
+                              const bool with_features,
+                              const bool verbose)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const rohc_profile_t expected_profile =
+		(with_features ? profile : ROHCv1_PROFILE_UNCOMPRESSED);
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	size_t small_hdrs_nr = 0;
+	size_t datagram_num;
+	bool is_success = false;
+
+	fprintf(stderr, "test profile '%s' (0x%04x) %s the IP fragments features\n",
+	        rohc_get_profile_descr(profile), profile,
+	        (with_features ? "with" : "without"));
+
+	/* create the compressor */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(verbose && !rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the traces of the compressor\n");
+		goto free_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_UNCOMPRESSED, profile, -1))
+	{
+		fprintf(stderr, "failed to enable the profiles of the compressor\n");
+		goto free_comp;
+	}
+	if(with_features &&
+	   !rohc_comp_set_features(comp, ROHC_COMP_FEATURE_IP_FRAGMENTS))
+	{
+		fprintf(stderr, "failed to enable the IP fragments of the compressor\n");
+		goto free_comp;
+	}
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto free_comp;
+	}
+	if(verbose && !rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the traces of the decompressor\n");
+		goto free_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHCv1_PROFILE_UNCOMPRESSED, profile,
+	                                -1))
+	{
+		fprintf(stderr, "failed to enable the profiles of the decompressor\n");
+		goto free_decomp;
+	}
+	if(with_features &&
+	   !rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_IP_FRAGMENTS))
+	{
+		fprintf(stderr, "failed to enable the IP fragments of the "
+		        "decompressor\n");
+		goto free_decomp;
+	}
+
+	for(datagram_num = 0; datagram_num < TEST_DATAGRAMS_NR; datagram_num++)
+	{
+		size_t frag_num;
+
+		for(frag_num = 0; frag_num < TEST_FRAGS_NR; frag_num++)
+		{
+			uint8_t uncomp_data[TEST_MAX_PKT_LEN];
+			const size_t uncomp_len =
+				build_ipv4_fragment(uncomp_data, datagram_num, frag_num);
+			const struct rohc_buf uncomp_pkt =
+				rohc_buf_init_full(uncomp_data, uncomp_len, arrival_time);
+			uint8_t rohc_data[TEST_MAX_PKT_LEN * 2];
+			struct rohc_buf rohc_pkt =
+				rohc_buf_init_empty(rohc_data, TEST_MAX_PKT_LEN * 2);
+			uint8_t decomp_data[TEST_MAX_PKT_LEN * 2];
+			struct rohc_buf decomp_pkt =
+				rohc_buf_init_empty(decomp_data, TEST_MAX_PKT_LEN * 2);
+			rohc_comp_last_packet_info2_t last_pkt_info;
+			rohc_status_t status;
+
+			status = rohc_compress4(comp, uncomp_pkt, &rohc_pkt);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "datagram #%zu, fragment #%zu: failed to compress "
+				        "the fragment (%s)\n", datagram_num + 1, frag_num + 1,
+				        rohc_strerror(status));
+				goto free_decomp;
+			}
+			memset(&last_pkt_info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			if(!rohc_comp_get_last_packet_info2(comp, &last_pkt_info))
+			{
+				fprintf(stderr, "failed to get the information about the last "
+				        "compressed packet\n");
+				goto free_decomp;
+			}
+			if(last_pkt_info.profile_id != expected_profile)
+			{
+				fprintf(stderr, "datagram #%zu, fragment #%zu: compressed by "
+				        "profile 0x%04x instead of profile 0x%04x\n",
+				        datagram_num + 1, frag_num + 1, last_pkt_info.profile_id,
+				        expected_profile);
+				goto free_decomp;
+			}
+			if(last_pkt_info.header_last_comp_size < 20)
+			{
+				small_hdrs_nr++;
+			}
+
+			status = rohc_decompress3(decomp, rohc_pkt, &decomp_pkt, NULL, NULL);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "datagram #%zu, fragment #%zu: failed to "
+				        "decompress the fragment (%s)\n", datagram_num + 1,
+				        frag_num + 1, rohc_strerror(status));
+				goto free_decomp;
+			}
+			if(decomp_pkt.len != uncomp_len ||
+			   memcmp(rohc_buf_data(decomp_pkt), uncomp_data, uncomp_len) != 0)
+			{
+				fprintf(stderr, "datagram #%zu, fragment #%zu: the decompressed "
+				        "fragment does not match the uncompressed fragment\n",
+				        datagram_num + 1, frag_num + 1);
+				goto free_decomp;
+			}
+		}
+	}
+
+	if(with_features && small_hdrs_nr == 0)
+	{
+		fprintf(stderr, "no ROHC header was smaller than the IPv4 header\n");
+		goto free_decomp;
+	}
+	is_success = true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Build one IPv4 fragment of one IPv4/UDP datagram of the flow
+ *
+ * @param[out] data     The memory to write the fragment in, at least
+ *                      TEST_MAX_PKT_LEN bytes long
+ * @param datagram_num  The number of the datagram in the flow
+ * @param frag_num      The number of the fragment in the datagram
+ * @return              The length of the fragment
+ */
+static size_t build_ipv4_fragment(uint8_t *const data,
+                                  const size_t datagram_num,
+                                  const size_t frag_num)
+{
+	const bool is_last_frag = (frag_num == (TEST_FRAGS_NR - 1));
+	const size_t payload_len =
+		(is_last_frag ? TEST_LAST_FRAG_PAYLOAD_LEN : TEST_FRAG_PAYLOAD_LEN);
+	const size_t pkt_len = 20 + payload_len;
+	const size_t frag_off = frag_num * TEST_FRAG_PAYLOAD_LEN / 8;
+	uint32_t checksum = 0;
+	size_t i;
+
+	memset(data, 0, pkt_len);
+
+	/* IPv4 header: the MF flag is set in all fragments but the last one */
+	data[0] = 0x45;
+	data[2] = (pkt_len >> 8) & 0xff;
+	data[3] = pkt_len & 0xff;
+	data[4] = ((datagram_num + 1) >> 8) & 0xff;
+	data[5] = (datagram_num + 1) & 0xff;
+	data[6] = ((frag_off >> 8) & 0x1f) | (is_last_frag ? 0x00 : 0x20);
+	data[7] = frag_off & 0xff;
+	data[8] = 64;
+	data[9] = 17; /* UDP */
+	data[12] = 192;
+	data[13] = 168;
+	data[15] = 1;
+	data[16] = 192;
+	data[17] = 168;
+	data[19] = 2;
+	for(i = 0; i < 20; i += 2)
+	{
+		checksum += (data[i] << 8) | data[i + 1];
+	}
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	checksum = ~checksum & 0xffff;
+	data[10] = (checksum >> 8) & 0xff;
+	data[11] = checksum & 0xff;
+
+	/* the part of the UDP datagram: the UDP header is in the first fragment */
+	for(i = 20; i < pkt_len; i++)
+	{
+		data[i] = (uint8_t) (i * 7 + datagram_num + frag_num);
+	}
+	if(frag_num == 0)
+	{
+		const size_t udp_len =
+			(TEST_FRAGS_NR - 1) * TEST_FRAG_PAYLOAD_LEN + TEST_LAST_FRAG_PAYLOAD_LEN;
+
+		data[20] = 0x12;
+		data[21] = 0x34;
+		data[22] = 0x00;
+		data[23] = 0x35;
+		data[24] = (udp_len >> 8) & 0xff;
+		data[25] = udp_len & 0xff;
+	}
+
+	return pkt_len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
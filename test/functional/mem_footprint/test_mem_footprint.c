@@ -0,0 +1,869 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_mem_footprint.c
+ * @brief  Report the memory used by the contexts of every profile
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The application creates many contexts of every profile, for IPv4, IPv6 and
+ * IPv6 with extension headers flows, on both the compressor and the
+ * decompressor. It reports the memory used by one context once all the flows
+ * reached their steady state, that is the context itself and all its
+ * profile-specific parts: W-LSB windows, list tables, volatile buffers...
+ *
+ * The memory of the contexts is provided by allocation callbacks that count
+ * the bytes and the objects requested from the system allocator, so every
+ * object is accounted at its actual size, whatever the size classes of the
+ * default slabs. The application fails if one context needs more memory than
+ * the given budget.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The default number of contexts created for every profile */
+#define TEST_CONTEXTS_NR  256U
+
+/** The number of packets sent for every flow to reach the steady state */
+#define TEST_PKTS_PER_FLOW  5U
+
+/** The UDP port dedicated to RTP traffic */
+#define TEST_RTP_PORT  5004U
+
+/** The max size of the generated packets */
+#define TEST_MAX_PKT_LEN  256U
+
+/** The length of the payload of the generated packets */
+#define TEST_PAYLOAD_LEN  20U
+
+
+/** The IP variants of the flows */
+typedef enum
+{
+	TEST_IPV4      = 0, /**< IPv4 */
+	TEST_IPV6      = 1, /**< IPv6 */
+	TEST_IPV6_EXTS = 2, /**< IPv6 with Hop-by-Hop and Destination options */
+	TEST_IP_MAX,
+} test_ip_t;
+
+/** The names of the IP variants */
+static const char *const test_ip_names[TEST_IP_MAX] = {
+	[TEST_IPV4]      = "IPv4",
+	[TEST_IPV6]      = "IPv6",
+	[TEST_IPV6_EXTS] = "IPv6+exts",
+};
+
+
+/** One tested profile */
+struct test_profile
+{
+	rohc_profile_t id;     /**< The ID of the profile */
+	const char *name;      /**< The name of the profile */
+	uint8_t protocol;      /**< The transport protocol of the flows, 0xff for
+	                            the IP-only profiles */
+	bool is_rtp;           /**< Whether the flows transport RTP or not */
+	bool has_ipv6_exts;    /**< Whether the profile supports IPv6 extension
+	                            headers or not */
+};
+
+/** The tested profiles */
+static const struct test_profile test_profiles[] = {
+	{ ROHCv1_PROFILE_IP,         "ROHCv1 IP",       0xff, false, true },
+	{ ROHCv1_PROFILE_IP_UDP,     "ROHCv1 UDP",        17, false, true },
+	{ ROHCv1_PROFILE_IP_UDP_RTP, "ROHCv1 RTP",        17, true,  true },
+	{ ROHCv1_PROFILE_IP_ESP,     "ROHCv1 ESP",        50, false, true },
+	{ ROHCv1_PROFILE_IP_UDPLITE, "ROHCv1 UDP-Lite",  136, false, true },
+	{ ROHCv1_PROFILE_IP_TCP,     "ROHCv1 TCP",         6, false, true },
+	{ ROHCv2_PROFILE_IP,         "ROHCv2 IP",       0xff, false, false },
+	{ ROHCv2_PROFILE_IP_UDP,     "ROHCv2 UDP",        17, false, false },
+	{ ROHCv2_PROFILE_IP_UDP_RTP, "ROHCv2 RTP",        17, true,  false },
+	{ ROHCv2_PROFILE_IP_ESP,     "ROHCv2 ESP",        50, false, false },
+};
+
+
+/** The memory currently allocated through the allocation callbacks */
+struct test_mem_stats
+{
+	size_t bytes_nr;  /**< The number of bytes allocated */
+	size_t objs_nr;   /**< The number of objects allocated */
+};
+
+/** The memory used by one context */
+struct test_ctxt_mem
+{
+	size_t comp_bytes;    /**< The bytes allocated for one compression context */
+	size_t comp_objs;     /**< The objects allocated for one compression context */
+	size_t decomp_bytes;  /**< The bytes allocated for one decompression context */
+	size_t decomp_objs;   /**< The objects allocated for one decompression context */
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+static bool test_profile_mem(const struct test_profile *const profile,
+                             const test_ip_t ip,
+                             const size_t contexts_nr,
+                             const bool verbose,
+                             struct test_ctxt_mem *const ctxt_mem)
+	__attribute__((warn_unused_result, nonnull(1, 5)));
+static size_t test_gen_pkt(const struct test_profile *const profile,
+                           const test_ip_t ip,
+                           const size_t flow_id,
+                           const size_t pkt_id,
+                           uint8_t *const pkt)
+	__attribute__((warn_unused_result, nonnull(1, 5)));
+static uint32_t test_csum_add(uint32_t sum,
+                              const uint8_t *const data,
+                              const size_t len)
+	__attribute__((warn_unused_result, nonnull(2)));
+static uint16_t test_csum_fold(uint32_t sum)
+	__attribute__((warn_unused_result, const));
+static void test_put16(uint8_t *const buf, const uint16_t value)
+	__attribute__((nonnull(1)));
+static void test_put32(uint8_t *const buf, const uint32_t value)
+	__attribute__((nonnull(1)));
+static void * test_mem_alloc(const size_t size, void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+static void test_mem_free(void *const ptr,
+                          const size_t size,
+                          void *const priv_ctxt);
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Report the memory used by the contexts of every profile, and check
+ *        that the memory budgets of one context are kept
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	size_t contexts_nr = TEST_CONTEXTS_NR;
+	size_t comp_budget = 0;
+	size_t decomp_budget = 0;
+	bool verbose = false;
+	size_t failures_nr = 0;
+	int status = 1;
+	size_t i;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			verbose = true;
+		}
+		else if(argc > 1 && (!strcmp(*argv, "--contexts") ||
+		                     !strcmp(*argv, "--comp-budget") ||
+		                     !strcmp(*argv, "--decomp-budget")))
+		{
+			char *end;
+			const unsigned long value = strtoul(argv[1], &end, 10);
+
+			if(argv[1][0] == '\0' || (*end) != '\0')
+			{
+				fprintf(stderr, "bad value '%s' for option %s\n", argv[1], *argv);
+				goto error;
+			}
+			if(!strcmp(*argv, "--contexts"))
+			{
+				if(value == 0 || value > (ROHC_LARGE_CID_MAX + 1))
+				{
+					fprintf(stderr, "the number of contexts shall be in range "
+					        "[1, %u]\n", ROHC_LARGE_CID_MAX + 1);
+					goto error;
+				}
+				contexts_nr = value;
+			}
+			else if(!strcmp(*argv, "--comp-budget"))
+			{
+				comp_budget = value;
+			}
+			else
+			{
+				decomp_budget = value;
+			}
+			args_used++;
+		}
+		else
+		{
+			fprintf(stderr, "unexpected argument '%s'\n", *argv);
+			usage();
+			goto error;
+		}
+	}
+
+	printf("# memory used by one context among %zu contexts (in bytes)\n",
+	       contexts_nr);
+	printf("# profile\tIP\tcomp bytes\tcomp objects\tdecomp bytes\t"
+	       "decomp objects\n");
+
+	for(i = 0; i < (sizeof(test_profiles) / sizeof(test_profiles[0])); i++)
+	{
+		test_ip_t ip;
+
+		for(ip = TEST_IPV4; ip < TEST_IP_MAX; ip++)
+		{
+			struct test_ctxt_mem ctxt_mem;
+
+			if(ip == TEST_IPV6_EXTS && !test_profiles[i].has_ipv6_exts)
+			{
+				printf("# %s\t%s\tnot supported\n", test_profiles[i].name,
+				       test_ip_names[ip]);
+				continue;
+			}
+
+			if(!test_profile_mem(&test_profiles[i], ip, contexts_nr, verbose,
+			                     &ctxt_mem))
+			{
+				fprintf(stderr, "failed to measure the memory of the %s "
+				        "contexts for %s flows\n", test_profiles[i].name,
+				        test_ip_names[ip]);
+				goto error;
+			}
+
+			printf("%s\t%s\t%zu\t%zu\t%zu\t%zu\n", test_profiles[i].name,
+			       test_ip_names[ip], ctxt_mem.comp_bytes, ctxt_mem.comp_objs,
+			       ctxt_mem.decomp_bytes, ctxt_mem.decomp_objs);
+
+			if(comp_budget > 0 && ctxt_mem.comp_bytes > comp_budget)
+			{
+				fprintf(stderr, "one %s compression context for %s flows "
+				        "uses %zu bytes, more than the budget of %zu bytes\n",
+				        test_profiles[i].name, test_ip_names[ip],
+				        ctxt_mem.comp_bytes, comp_budget);
+				failures_nr++;
+			}
+			if(decomp_budget > 0 && ctxt_mem.decomp_bytes > decomp_budget)
+			{
+				fprintf(stderr, "one %s decompression context for %s flows "
+				        "uses %zu bytes, more than the budget of %zu bytes\n",
+				        test_profiles[i].name, test_ip_names[ip],
+				        ctxt_mem.decomp_bytes, decomp_budget);
+				failures_nr++;
+			}
+		}
+	}
+
+	if(failures_nr == 0)
+	{
+		status = 0;
+	}
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Report the memory used by the contexts of every profile\n"
+	        "\n"
+	        "usage: test_mem_footprint [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  --contexts NUM          The number of contexts to create for\n"
+	        "                          every profile (default: %u)\n"
+	        "  --comp-budget BYTES     Fail if one compression context uses\n"
+	        "                          more memory (default: no budget)\n"
+	        "  --decomp-budget BYTES   Fail if one decompression context uses\n"
+	        "                          more memory (default: no budget)\n"
+	        "  --verbose               Print the traces of the ROHC library\n"
+	        "  -h, --help              Print this usage and exit\n",
+	        TEST_CONTEXTS_NR);
+}
+
+
+/**
+ * @brief Measure the memory used by the contexts of one profile
+ *
+ * One flow is compressed and decompressed for every context, the memory
+ * allocated by the compressor and the decompressor before and after the
+ * flows gives the memory of one context. The memory accounted by the library
+ * itself shall match the memory requested from the allocation callbacks.
+ *
+ * @param profile          The profile to test
+ * @param ip               The IP variant of the flows
+ * @param contexts_nr      The number of contexts to create
+ * @param verbose          Whether to print the traces of the library or not
+ * @param[out] ctxt_mem    The memory used by one context
+ * @return                 true if the memory was measured,
+ *                         false if a flow was not handled as expected
+ */
+static bool test_profile_mem(const struct test_profile *const profile,
+                             const test_ip_t ip,
+                             const size_t contexts_nr,
+                             const bool verbose,
+                             struct test_ctxt_mem *const ctxt_mem)
+{
+	rohc_comp_mem_info_t comp_mem_start = { .version_major = 0, .version_minor = 0 };
+	rohc_comp_mem_info_t comp_mem_end = { .version_major = 0, .version_minor = 0 };
+	rohc_decomp_mem_info_t decomp_mem_start = { .version_major = 0, .version_minor = 0 };
+	rohc_decomp_mem_info_t decomp_mem_end = { .version_major = 0, .version_minor = 0 };
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	struct test_mem_stats comp_stats = { .bytes_nr = 0, .objs_nr = 0 };
+	struct test_mem_stats decomp_stats = { .bytes_nr = 0, .objs_nr = 0 };
+	struct test_mem_stats comp_stats_start;
+	struct test_mem_stats decomp_stats_start;
+	uint8_t ip_buffer[TEST_MAX_PKT_LEN];
+	uint8_t rohc_buffer[TEST_MAX_PKT_LEN];
+	uint8_t uncomp_buffer[TEST_MAX_PKT_LEN];
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	bool is_success = false;
+	size_t pkt_id;
+	size_t flow_id;
+
+	/* create the compressor and the decompressor with only the tested
+	 * profile, so that the flows cannot be handled by another profile */
+	comp = rohc_comp_new2(ROHC_LARGE_CID, contexts_nr - 1, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(verbose && !rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_mem_cbs(comp, test_mem_alloc, test_mem_free, &comp_stats))
+	{
+		fprintf(stderr, "failed to set the memory callbacks\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profile(comp, profile->id))
+	{
+		fprintf(stderr, "failed to enable the %s compression profile\n",
+		        profile->name);
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback\n");
+		goto destroy_comp;
+	}
+
+	decomp = rohc_decomp_new2(ROHC_LARGE_CID, contexts_nr - 1, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(verbose && !rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_mem_cbs(decomp, test_mem_alloc, test_mem_free,
+	                            &decomp_stats))
+	{
+		fprintf(stderr, "failed to set the memory callbacks\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profile(decomp, profile->id))
+	{
+		fprintf(stderr, "failed to enable the %s decompression profile\n",
+		        profile->name);
+		goto destroy_decomp;
+	}
+
+	if(!rohc_comp_get_mem_info(comp, &comp_mem_start) ||
+	   !rohc_decomp_get_mem_info(decomp, &decomp_mem_start))
+	{
+		fprintf(stderr, "failed to get the memory information\n");
+		goto destroy_decomp;
+	}
+	comp_stats_start = comp_stats;
+	decomp_stats_start = decomp_stats;
+
+	/* send several packets of every flow, so that the contexts reach their
+	 * steady state with all their lists and windows in use */
+	for(pkt_id = 0; pkt_id < TEST_PKTS_PER_FLOW; pkt_id++)
+	{
+		for(flow_id = 0; flow_id < contexts_nr; flow_id++)
+		{
+			const size_t ip_len =
+				test_gen_pkt(profile, ip, flow_id, pkt_id, ip_buffer);
+			const struct rohc_buf ip_packet =
+				rohc_buf_init_full(ip_buffer, ip_len, arrival_time);
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_LEN);
+			struct rohc_buf uncomp_packet =
+				rohc_buf_init_empty(uncomp_buffer, TEST_MAX_PKT_LEN);
+			rohc_comp_last_packet_info2_t last_packet_info = {
+				.version_major = 0, .version_minor = 0
+			};
+			rohc_status_t status;
+
+			status = rohc_compress4(comp, ip_packet, &rohc_packet);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "failed to compress packet #%zu of flow #%zu: "
+				        "%s (%d)\n", pkt_id + 1, flow_id + 1,
+				        rohc_strerror(status), status);
+				goto destroy_decomp;
+			}
+			if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
+			{
+				fprintf(stderr, "failed to get the information on packet #%zu "
+				        "of flow #%zu\n", pkt_id + 1, flow_id + 1);
+				goto destroy_decomp;
+			}
+			if(last_packet_info.profile_id != (int) profile->id ||
+			   last_packet_info.context_id != flow_id)
+			{
+				fprintf(stderr, "packet #%zu of flow #%zu was compressed with "
+				        "profile 0x%04x and CID %u, while profile 0x%04x and CID "
+				        "%zu were expected\n", pkt_id + 1, flow_id + 1,
+				        last_packet_info.profile_id, last_packet_info.context_id,
+				        profile->id, flow_id);
+				goto destroy_decomp;
+			}
+
+			status = rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+			                          NULL, NULL);
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "failed to decompress packet #%zu of flow #%zu: "
+				        "%s (%d)\n", pkt_id + 1, flow_id + 1,
+				        rohc_strerror(status), status);
+				goto destroy_decomp;
+			}
+			if(uncomp_packet.len != ip_packet.len ||
+			   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+			          ip_packet.len) != 0)
+			{
+				fprintf(stderr, "packet #%zu of flow #%zu was not decompressed "
+				        "as expected\n", pkt_id + 1, flow_id + 1);
+				goto destroy_decomp;
+			}
+		}
+	}
+
+	if(!rohc_comp_get_mem_info(comp, &comp_mem_end) ||
+	   !rohc_decomp_get_mem_info(decomp, &decomp_mem_end))
+	{
+		fprintf(stderr, "failed to get the memory information\n");
+		goto destroy_decomp;
+	}
+
+	if((comp_mem_end.used_bytes_nr - comp_mem_start.used_bytes_nr) !=
+	   (comp_stats.bytes_nr - comp_stats_start.bytes_nr) ||
+	   (decomp_mem_end.used_bytes_nr - decomp_mem_start.used_bytes_nr) !=
+	   (decomp_stats.bytes_nr - decomp_stats_start.bytes_nr))
+	{
+		fprintf(stderr, "the memory accounted by the library does not match "
+		        "the memory allocated: %zu/%zu bytes for the compressor, "
+		        "%zu/%zu bytes for the decompressor\n",
+		        comp_mem_end.used_bytes_nr - comp_mem_start.used_bytes_nr,
+		        comp_stats.bytes_nr - comp_stats_start.bytes_nr,
+		        decomp_mem_end.used_bytes_nr - decomp_mem_start.used_bytes_nr,
+		        decomp_stats.bytes_nr - decomp_stats_start.bytes_nr);
+		goto destroy_decomp;
+	}
+
+	ctxt_mem->comp_bytes =
+		(comp_stats.bytes_nr - comp_stats_start.bytes_nr) / contexts_nr;
+	ctxt_mem->comp_objs =
+		(comp_stats.objs_nr - comp_stats_start.objs_nr) / contexts_nr;
+	ctxt_mem->decomp_bytes =
+		(decomp_stats.bytes_nr - decomp_stats_start.bytes_nr) / contexts_nr;
+	ctxt_mem->decomp_objs =
+		(decomp_stats.objs_nr - decomp_stats_start.objs_nr) / contexts_nr;
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Generate one packet of one flow
+ *
+ * The flows differ by their addresses, the fields of their other headers
+ * change regularly from one packet to the next one, as in real traffic.
+ *
+ * @param profile   The profile the flow is compressed with
+ * @param ip        The IP variant of the flow
+ * @param flow_id   The index of the flow
+ * @param pkt_id    The index of the packet in the flow
+ * @param[out] pkt  The generated packet, \ref TEST_MAX_PKT_LEN bytes at most
+ * @return          The length of the generated packet
+ */
+static size_t test_gen_pkt(const struct test_profile *const profile,
+                           const test_ip_t ip,
+                           const size_t flow_id,
+                           const size_t pkt_id,
+                           uint8_t *const pkt)
+{
+	const size_t ip_hdr_len = (ip == TEST_IPV4 ? 20 : 40);
+	const size_t exts_len = (ip == TEST_IPV6_EXTS ? 16 : 0);
+	const uint8_t protocol = (profile->protocol == 0xff ?
+	                          (ip == TEST_IPV4 ? 1 : 58) : profile->protocol);
+	uint8_t *const l4 = pkt + ip_hdr_len + exts_len;
+	size_t l4_len;
+	uint32_t csum;
+
+	/* the transport headers and the payload */
+	if(protocol == 17 || protocol == 136)
+	{
+		const size_t rtp_hdr_len = (profile->is_rtp ? 12 : 0);
+		l4_len = 8 + rtp_hdr_len + TEST_PAYLOAD_LEN;
+		test_put16(l4, 10000 + flow_id);
+		test_put16(l4 + 2, (profile->is_rtp ? TEST_RTP_PORT : 53));
+		test_put16(l4 + 4, (protocol == 17 ? l4_len : 0)); /* length/coverage */
+		test_put16(l4 + 6, 0);
+		if(profile->is_rtp)
+		{
+			l4[8] = 0x80;
+			l4[9] = 96;
+			test_put16(l4 + 10, 1000 + pkt_id);
+			test_put32(l4 + 12, 0x10000000 + pkt_id * 160);
+			test_put32(l4 + 16, 0x12345678 + flow_id);
+		}
+	}
+	else if(protocol == 6)
+	{
+		const size_t tcp_hdr_len = 32;
+		l4_len = tcp_hdr_len + TEST_PAYLOAD_LEN;
+		test_put16(l4, 10000 + flow_id);
+		test_put16(l4 + 2, 80);
+		test_put32(l4 + 4, 0x10000000 + pkt_id * TEST_PAYLOAD_LEN);
+		test_put32(l4 + 8, 0x20000000);
+		l4[12] = (tcp_hdr_len / 4) << 4;
+		l4[13] = 0x18; /* ACK + PSH */
+		test_put16(l4 + 14, 0xffff);
+		test_put16(l4 + 16, 0);
+		test_put16(l4 + 18, 0);
+		l4[20] = 1; /* NOP */
+		l4[21] = 1; /* NOP */
+		l4[22] = 8; /* TS */
+		l4[23] = 10;
+		test_put32(l4 + 24, 0x30000000 + pkt_id);
+		test_put32(l4 + 28, 0x40000000 + pkt_id);
+	}
+	else if(protocol == 50)
+	{
+		l4_len = 8 + TEST_PAYLOAD_LEN;
+		test_put32(l4, 0x1000 + flow_id);
+		test_put32(l4 + 4, 1 + pkt_id);
+	}
+	else /* ICMP or ICMPv6 echo request for the IP-only profiles */
+	{
+		l4_len = 8 + TEST_PAYLOAD_LEN;
+		l4[0] = (protocol == 1 ? 8 : 128);
+		l4[1] = 0;
+		test_put16(l4 + 2, 0);
+		test_put16(l4 + 4, flow_id);
+		test_put16(l4 + 6, pkt_id);
+	}
+	memset(pkt + ip_hdr_len + exts_len + l4_len - TEST_PAYLOAD_LEN,
+	       flow_id & 0xff, TEST_PAYLOAD_LEN);
+
+	/* the IP header and its extension headers */
+	if(ip == TEST_IPV4)
+	{
+		pkt[0] = 0x45;
+		pkt[1] = 0;
+		test_put16(pkt + 2, ip_hdr_len + l4_len);
+		test_put16(pkt + 4, 0x1000 + pkt_id);
+		test_put16(pkt + 6, 0x4000); /* DF */
+		pkt[8] = 64;
+		pkt[9] = protocol;
+		test_put16(pkt + 10, 0);
+		test_put32(pkt + 12, 0x0a000000 + flow_id);
+		test_put32(pkt + 16, 0xc0a80001);
+		test_put16(pkt + 10, test_csum_fold(test_csum_add(0, pkt, ip_hdr_len)));
+		csum = test_csum_add(0, pkt + 12, 8);
+	}
+	else
+	{
+		test_put32(pkt, 0x60000000U | flow_id);
+		test_put16(pkt + 4, exts_len + l4_len);
+		pkt[6] = (ip == TEST_IPV6_EXTS ? 0 : protocol);
+		pkt[7] = 64;
+		memset(pkt + 8, 0, 32);
+		test_put32(pkt + 8, 0x20010db8U);
+		test_put32(pkt + 20, flow_id);
+		test_put32(pkt + 24, 0x20010db8U);
+		test_put16(pkt + 38, 1);
+		csum = test_csum_add(0, pkt + 8, 32);
+		if(ip == TEST_IPV6_EXTS)
+		{
+			uint8_t *const hbh = pkt + ip_hdr_len;
+			uint8_t *const dest = hbh + 8;
+
+			/* Hop-by-Hop options with one PadN option */
+			memset(hbh, 0, 16);
+			hbh[0] = 60; /* next header: Destination options */
+			hbh[2] = 1;  /* PadN */
+			hbh[3] = 4;
+			/* Destination options with one PadN option */
+			dest[0] = protocol;
+			dest[2] = 1; /* PadN */
+			dest[3] = 4;
+		}
+	}
+
+	/* the transport checksum over the pseudo IP header */
+	if(protocol == 17 || protocol == 136 || protocol == 6 || protocol == 58)
+	{
+		const size_t csum_offset =
+			((protocol == 17 || protocol == 136) ? 6 : (protocol == 6 ? 16 : 2));
+		uint16_t check;
+		csum += protocol + l4_len;
+		check = test_csum_fold(test_csum_add(csum, l4, l4_len));
+		test_put16(l4 + csum_offset, (check == 0 ? 0xffff : check));
+	}
+	else if(protocol == 1)
+	{
+		test_put16(l4 + 2, test_csum_fold(test_csum_add(0, l4, l4_len)));
+	}
+
+	return ip_hdr_len + exts_len + l4_len;
+}
+
+
+/**
+ * @brief Add some data to one Internet checksum
+ *
+ * @param sum   The checksum being computed
+ * @param data  The data to add to the checksum
+ * @param len   The length of the data
+ * @return      The updated checksum
+ */
+static uint32_t test_csum_add(uint32_t sum,
+                              const uint8_t *const data,
+                              const size_t len)
+{
+	size_t i;
+
+	for(i = 0; (i + 1) < len; i += 2)
+	{
+		sum += (((uint32_t) data[i]) << 8) | data[i + 1];
+	}
+	if(i < len)
+	{
+		sum += ((uint32_t) data[i]) << 8;
+	}
+
+	return sum;
+}
+
+
+/**
+ * @brief Fold one Internet checksum
+ *
+ * @param sum  The checksum being computed
+ * @return     The final checksum
+ */
+static uint16_t test_csum_fold(uint32_t sum)
+{
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	return (~sum) & 0xffff;
+}
+
+
+/**
+ * @brief Write one 16-bit field in network byte order
+ *
+ * @param buf    The buffer to write the field in
+ * @param value  The value of the field
+ */
+static void test_put16(uint8_t *const buf, const uint16_t value)
+{
+	buf[0] = (value >> 8) & 0xff;
+	buf[1] = value & 0xff;
+}
+
+
+/**
+ * @brief Write one 32-bit field in network byte order
+ *
+ * @param buf    The buffer to write the field in
+ * @param value  The value of the field
+ */
+static void test_put32(uint8_t *const buf, const uint32_t value)
+{
+	test_put16(buf, (value >> 16) & 0xffff);
+	test_put16(buf + 2, value & 0xffff);
+}
+
+
+/**
+ * @brief Allocate memory for the contexts and account it
+ *
+ * @param size       The number of bytes to allocate
+ * @param priv_ctxt  The memory statistics to update
+ * @return           The allocated memory, NULL in case of failure
+ */
+static void * test_mem_alloc(const size_t size, void *const priv_ctxt)
+{
+	struct test_mem_stats *const stats = priv_ctxt;
+	void *const ptr = malloc(size);
+
+	if(ptr != NULL)
+	{
+		stats->bytes_nr += size;
+		stats->objs_nr++;
+	}
+
+	return ptr;
+}
+
+
+/**
+ * @brief Free the memory of the contexts and account it
+ *
+ * @param ptr        The memory to free
+ * @param size       The number of bytes that were allocated
+ * @param priv_ctxt  The memory statistics to update
+ */
+static void test_mem_free(void *const ptr,
+                          const size_t size,
+                          void *const priv_ctxt)
+{
+	struct test_mem_stats *const stats = priv_ctxt;
+
+	assert(stats->bytes_nr >= size);
+	assert(stats->objs_nr > 0);
+	stats->bytes_nr -= size;
+	stats->objs_nr--;
+	free(ptr);
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  Should always be NULL
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+{
+	if(udp == NULL)
+	{
+		return false;
+	}
+	return (((udp[2] << 8) | udp[3]) == TEST_RTP_PORT);
+}
@@ -63,7 +63,8 @@ static void usage(void);
 static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
                                 const bool is_comp_expected_ok,
-                                const size_t expected_segments_nr);
+                                const size_t expected_segments_nr,
+                                const rohc_decomp_features_t decomp_features);
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -100,7 +101,8 @@ int main(int argc, char *argv[])
 
 	/* test ROHC segments with small packet (wrt output buffer) and large MRRU
 	 * => no segmentation needed */
-	status = test_comp_and_decomp(100, TEST_MAX_ROHC_SIZE * 2, true, 0);
+	status = test_comp_and_decomp(100, TEST_MAX_ROHC_SIZE * 2, true, 0,
+	                              ROHC_DECOMP_FEATURE_NONE);
 	if(status != 0)
 	{
 		goto error;
@@ -109,7 +111,29 @@ int main(int argc, char *argv[])
 	/* test ROHC segments with large packet (wrt output buffer) and large MRRU,
 	 * => segmentation needed */
 	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE,
-	                               TEST_MAX_ROHC_SIZE * 2, true, 2);
+	                               TEST_MAX_ROHC_SIZE * 2, true, 2,
+	                               ROHC_DECOMP_FEATURE_NONE);
+	if(status != 0)
+	{
+		goto error;
+	}
+
+	/* same test with segments referenced by the decompressor instead of
+	 * being copied */
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE,
+	                               TEST_MAX_ROHC_SIZE * 2, true, 2,
+	                               ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF);
+	if(status != 0)
+	{
+		goto error;
+	}
+
+	/* same test with the work per packet bounded: the referenced RRU is
+	 * copied once before parsing */
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE,
+	                               TEST_MAX_ROHC_SIZE * 2, true, 2,
+	                               ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF |
+	                               ROHC_DECOMP_FEATURE_BOUNDED_WORK);
 	if(status != 0)
 	{
 		goto error;
@@ -117,7 +141,8 @@ int main(int argc, char *argv[])
 
 	/* test ROHC segments with large packet (wrt output buffer) and MRRU = 0,
 	 * ie. segments disabled => segmentation needed but impossible */
-	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE, 0, false, 0);
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE, 0, false, 0,
+	                               ROHC_DECOMP_FEATURE_NONE);
 	if(status != 0)
 	{
 		goto error;
@@ -126,7 +151,28 @@ int main(int argc, char *argv[])
 	/* test ROHC segments with very large packet (wrt output buffer) and large
 	 * MRRU => segmentation needed, more than 2 segments expected */
 	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
-	                               TEST_MAX_ROHC_SIZE * 3, true, 3);
+	                               TEST_MAX_ROHC_SIZE * 3, true, 3,
+	                               ROHC_DECOMP_FEATURE_NONE);
+	if(status != 0)
+	{
+		goto error;
+	}
+
+	/* same test with segments referenced by the decompressor instead of
+	 * being copied */
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
+	                               TEST_MAX_ROHC_SIZE * 3, true, 3,
+	                               ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF);
+	if(status != 0)
+	{
+		goto error;
+	}
+
+	/* same test with the work per packet bounded */
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
+	                               TEST_MAX_ROHC_SIZE * 3, true, 3,
+	                               ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF |
+	                               ROHC_DECOMP_FEATURE_BOUNDED_WORK);
 	if(status != 0)
 	{
 		goto error;
@@ -135,7 +181,7 @@ int main(int argc, char *argv[])
 	/* test ROHC segments with very large packet (wrt output buffer) and large
 	 * MRRU (but not large enough) => segmentation needed, but MRRU forbids it */
 	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2, TEST_MAX_ROHC_SIZE,
-	                               false, 0);
+	                               false, 0, ROHC_DECOMP_FEATURE_NONE);
 	if(status != 0)
 	{
 		goto error;
@@ -172,13 +218,17 @@ static void usage(void)
  *                              successful or not?
  * @parma expected_segments_nr  The number of ROHC segments that we expect
  *                              for the test
+ * @param decomp_features       The features to enable at decompressor, eg.
+ *                              to reference the ROHC segments instead of
+ *                              copying them
  * @return                      0 in case of success,
  *                              1 in case of failure
  */
 static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
                                 const bool is_comp_expected_ok,
-                                const size_t expected_segments_nr)
+                                const size_t expected_segments_nr,
+                                const rohc_decomp_features_t decomp_features)
 {
 //! [define ROHC compressor]
 	struct rohc_comp *comp;
@@ -192,7 +242,9 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	struct rohc_buf ip_packet =
 		rohc_buf_init_empty(ip_buffer, TEST_MAX_ROHC_SIZE * 3);
 
-	uint8_t rohc_buffer[TEST_MAX_ROHC_SIZE];
+	/* every segment is kept in its own part of the buffer when the
+	 * decompressor references them */
+	uint8_t rohc_buffer[TEST_MAX_ROHC_SIZE * 3];
 	struct rohc_buf rohc_packet =
 		rohc_buf_init_empty(rohc_buffer, TEST_MAX_ROHC_SIZE);
 
@@ -206,8 +258,14 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	rohc_status_t status;
 	size_t i;
 
+	const bool segments_by_ref =
+		!!((decomp_features & ROHC_DECOMP_FEATURE_SEGMENTS_BY_REF) != 0);
+
 	fprintf(stderr, "test ROHC segments with %zu-byte IP packet and "
-	        "MMRU = %zu bytes\n", ip_packet_len, mrru);
+	        "MMRU = %zu bytes%s%s\n", ip_packet_len, mrru,
+	        segments_by_ref ? " (segments referenced)" : "",
+	        (decomp_features & ROHC_DECOMP_FEATURE_BOUNDED_WORK) != 0 ?
+	        " (work bounded)" : "");
 
 	/* check that buffer for IP packet is large enough */
 	if(ip_packet_len > TEST_MAX_ROHC_SIZE * 3)
@@ -282,6 +340,14 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	}
 //! [set decompressor MRRU]
 
+	/* enable the decompressor features asked for, eg. segments by reference */
+	if(!rohc_decomp_set_features(decomp, decomp_features))
+	{
+		fprintf(stderr, "failed to enable features 0x%x at decompressor\n",
+		        decomp_features);
+		goto destroy_decomp;
+	}
+
 	/* enable decompression profiles */
 	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
 	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
@@ -366,6 +432,10 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 				goto destroy_decomp;
 			}
 			rohc_packet.len = 0;
+			if(segments_by_ref)
+			{
+				rohc_packet.data += TEST_MAX_ROHC_SIZE;
+			}
 		}
 		if(status != ROHC_STATUS_OK)
 		{
@@ -0,0 +1,372 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_uncomp_passthrough.c
+ * @brief  Check that the Uncompressed profile passes packets through in place
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The application compresses one IPv4/ESP flow in place with a compressor
+ * that only enables the Uncompressed profile, then decompresses the ROHC
+ * packets in place. Once the context left the IR state, the ROHC packets
+ * shall be the uncompressed packets themselves (small CID 0), and neither
+ * the compressor nor the decompressor shall move the payload of the packets.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of packets of the flow */
+#define TEST_PKTS_NR  10U
+
+/** The length of the uncompressed packets (in bytes) */
+#define TEST_PKT_LEN  (20U + 8U + 32U)
+
+/** The headroom reserved in front of the packets (in bytes) */
+#define TEST_HEADROOM  16U
+
+
+static void usage(void);
+
+static bool test_passthrough(const bool verbose)
+	__attribute__((warn_unused_result));
+
+static void build_esp_packet(uint8_t *const data, const size_t pkt_num);
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that the Uncompressed profile passes packets through in place
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose = false;
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc--, argv++)
+	{
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			verbose = true;
+		}
+		else
+		{
+			fprintf(stderr, "unexpected argument '%s'\n", *argv);
+			usage();
+			goto error;
+		}
+	}
+
+	if(!test_passthrough(verbose))
+	{
+		goto error;
+	}
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that the Uncompressed profile passes packets through in place\n"
+	        "\n"
+	        "usage: test_uncomp_passthrough [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  --verbose               Print the traces of the ROHC library\n"
+	        "  -h, --help              Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress and decompress one IPv4/ESP flow in place
+ *
+ * @param verbose  Whether to print the traces of the library or not
+ * @return         true if the flow was passed through as expected,
+ *                 false otherwise
+ */
+static bool test_passthrough(const bool verbose)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	size_t normal_pkts_nr = 0;
+	size_t pkt_num;
+	bool is_success = false;
+
+	/* create the compressor with the Uncompressed profile only */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(verbose && !rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the traces of the compressor\n");
+		goto free_comp;
+	}
+	if(!rohc_comp_enable_profile(comp, ROHCv1_PROFILE_UNCOMPRESSED))
+	{
+		fprintf(stderr, "failed to enable the Uncompressed profile\n");
+		goto free_comp;
+	}
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto free_comp;
+	}
+	if(verbose && !rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the traces of the decompressor\n");
+		goto free_decomp;
+	}
+	if(!rohc_decomp_enable_profile(decomp, ROHCv1_PROFILE_UNCOMPRESSED))
+	{
+		fprintf(stderr, "failed to enable the Uncompressed profile\n");
+		goto free_decomp;
+	}
+
+	for(pkt_num = 0; pkt_num < TEST_PKTS_NR; pkt_num++)
+	{
+		uint8_t buf[TEST_HEADROOM + TEST_PKT_LEN];
+		uint8_t orig[TEST_PKT_LEN];
+		struct rohc_buf pkt =
+			rohc_buf_init_full(buf, TEST_HEADROOM + TEST_PKT_LEN, arrival_time);
+		const uint8_t *payload;
+		rohc_status_t status;
+
+		rohc_buf_pull(&pkt, TEST_HEADROOM);
+		build_esp_packet(rohc_buf_data(pkt), pkt_num);
+		memcpy(orig, rohc_buf_data(pkt), TEST_PKT_LEN);
+		payload = rohc_buf_data(pkt) + 1;
+
+		/* compress the packet in place */
+		status = rohc_compress_in_place(comp, &pkt);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to compress the packet in "
+			        "place (%s)\n", pkt_num + 1, rohc_strerror(status));
+			goto free_decomp;
+		}
+		if(rohc_buf_data(pkt) + pkt.len != buf + sizeof(buf))
+		{
+			fprintf(stderr, "packet #%zu: the payload was moved by the "
+			        "compressor\n", pkt_num + 1);
+			goto free_decomp;
+		}
+
+		/* the Normal packets with small CID 0 are the packets themselves */
+		if(rohc_buf_byte(pkt) == 0xfc)
+		{
+			if(normal_pkts_nr > 0)
+			{
+				fprintf(stderr, "packet #%zu: unexpected IR packet after Normal "
+				        "packets\n", pkt_num + 1);
+				goto free_decomp;
+			}
+		}
+		else if(pkt.len != TEST_PKT_LEN ||
+		        memcmp(rohc_buf_data(pkt), orig, TEST_PKT_LEN) != 0)
+		{
+			fprintf(stderr, "packet #%zu: the Normal packet is not the "
+			        "uncompressed packet\n", pkt_num + 1);
+			goto free_decomp;
+		}
+		else
+		{
+			normal_pkts_nr++;
+		}
+
+		/* decompress the packet in place */
+		status = rohc_decompress_in_place(decomp, &pkt, NULL, NULL);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to decompress the packet in "
+			        "place (%s)\n", pkt_num + 1, rohc_strerror(status));
+			goto free_decomp;
+		}
+		if(pkt.len != TEST_PKT_LEN ||
+		   memcmp(rohc_buf_data(pkt), orig, TEST_PKT_LEN) != 0)
+		{
+			fprintf(stderr, "packet #%zu: the decompressed packet does not "
+			        "match the uncompressed packet\n", pkt_num + 1);
+			goto free_decomp;
+		}
+		if(rohc_buf_data(pkt) + 1 != payload)
+		{
+			fprintf(stderr, "packet #%zu: the payload was moved by the "
+			        "decompressor\n", pkt_num + 1);
+			goto free_decomp;
+		}
+	}
+
+	if(normal_pkts_nr == 0)
+	{
+		fprintf(stderr, "the context never left the IR state\n");
+		goto free_decomp;
+	}
+	is_success = true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Build one IPv4/ESP packet of the flow
+ *
+ * @param[out] data  The memory to write the TEST_PKT_LEN bytes of the packet in
+ * @param pkt_num    The number of the packet in the flow
+ */
+static void build_esp_packet(uint8_t *const data, const size_t pkt_num)
+{
+	uint32_t checksum = 0;
+	size_t i;
+
+	memset(data, 0, TEST_PKT_LEN);
+
+	/* IPv4 header */
+	data[0] = 0x45;
+	data[2] = (TEST_PKT_LEN >> 8) & 0xff;
+	data[3] = TEST_PKT_LEN & 0xff;
+	data[4] = (pkt_num >> 8) & 0xff;
+	data[5] = pkt_num & 0xff;
+	data[8] = 64;
+	data[9] = 50; /* ESP */
+	data[12] = 192;
+	data[13] = 168;
+	data[15] = 1;
+	data[16] = 192;
+	data[17] = 168;
+	data[19] = 2;
+	for(i = 0; i < 20; i += 2)
+	{
+		checksum += (data[i] << 8) | data[i + 1];
+	}
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	checksum = ~checksum & 0xffff;
+	data[10] = (checksum >> 8) & 0xff;
+	data[11] = checksum & 0xff;
+
+	/* ESP header: SPI and sequence number */
+	data[23] = 0x42;
+	data[24] = ((pkt_num + 1) >> 24) & 0xff;
+	data[25] = ((pkt_num + 1) >> 16) & 0xff;
+	data[26] = ((pkt_num + 1) >> 8) & 0xff;
+	data[27] = (pkt_num + 1) & 0xff;
+
+	/* ciphered payload */
+	for(i = 28; i < TEST_PKT_LEN; i++)
+	{
+		data[i] = (uint8_t) (i * 7 + pkt_num);
+	}
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
@@ -1,4 +1,20 @@
 #!/bin/bash
+#
+# Compare the ROHCv1 and ROHCv2 profiles on the same captures.
+#
+# Without argument, the sizes of the ROHC packets recorded for both versions
+# are compared: the test fails for every capture that ROHCv1 compresses
+# better than ROHCv2.
+#
+# With the --benchmark NUM argument, every capture is replayed NUM times
+# through both versions of the profiles by the test_non_regression tool, then
+# the cost of both versions is reported side by side: the time spent per
+# packet for compression and decompression, the average size of the ROHC
+# headers, and the memory used per context by the compressor and the
+# decompressor.
+#
+# usage: compare_v1_v2.sh [--benchmark NUM] [CAPTURE_DIR...]
+#
 
 print_green()
 {
@@ -16,22 +32,69 @@ print_yellow()
 }
 
 basedir=$( dirname $0 )
+app="${basedir}/test_non_regression"
+
+bench_repetitions=0
+if [ "$1" = "--benchmark" ] ; then
+	bench_repetitions="$2"
+	if [ -z "${bench_repetitions}" ] || [ "${bench_repetitions}" -le 0 ] ; then
+		echo "option --benchmark takes one positive number" >&2
+		exit 1
+	fi
+	shift 2
+fi
+
+if [ $# -gt 0 ] ; then
+	dirs="$@"
+else
+	dirs=$( find $basedir/rfc3095/inputs/ -type d )
+fi
+
+# print the COST line of the benchmark of one capture with one ROHC version
+bench_cost()
+{
+	local version="$1"
+	local capture="$2"
+
+	${app} --quiet --benchmark ${bench_repetitions} --rohc-version ${version} \
+		smallcid ${capture} | gawk -F'\t' '$1 == "COST" && $2 != "\"ROHC version\"" { print }'
+}
 
 failures_nr=0
 
-for dir in $( find $basedir/rfc3095/inputs/ -type d ) ; do
-	if [ -f $dir/source.pcap ] ; then
-		v1=$( gawk 'START { sum=0 } { sum+=$9 } END { print sum }' $dir/rohc_maxcontexts0_wlsb4_smallcid.sizes )
-		v2=$( gawk 'START { sum=0 } { sum+=$9 } END { print sum }' $dir/rohcv2_maxcontexts0_wlsb4_smallcid.sizes )
-		if [ $v1 -lt $v2 ] ; then
-			print_red "FAIL: "
-			failures_nr=$(( ${failures_nr} + 1 ))
-		else
-			print_green "PASS: "
-		fi
-		echo "$dir: v1=$v1 v2=$v2 delta=$(( $v2 - $v1 ))"
+if [ ${bench_repetitions} -gt 0 ] ; then
+	echo -e "capture\tversion\tcomp (ns/pkt)\tdecomp (ns/pkt)\theader (bytes/pkt)\tcomp (bytes/ctxt)\tdecomp (bytes/ctxt)"
+fi
+
+for dir in ${dirs} ; do
+	if [ ! -f $dir/source.pcap ] ; then
+		continue
+	fi
+
+	if [ ${bench_repetitions} -gt 0 ] ; then
+		for version in 1 2 ; do
+			cost=$( bench_cost ${version} $dir/source.pcap )
+			if [ -z "${cost}" ] ; then
+				print_red "FAIL: "
+				echo "$dir: benchmark failed with ROHCv${version}"
+				failures_nr=$(( ${failures_nr} + 1 ))
+				continue
+			fi
+			echo "${cost}" | gawk -F'\t' -v dir="$dir" \
+				'{ printf("%s\t%s\t%s\t%s\t%s\t%s\t%s\n", dir, $2, $4, $5, $6, $7, $8) }'
+		done
+		continue
 	fi
+
+	v1=$( gawk 'START { sum=0 } { sum+=$9 } END { print sum }' $dir/rohc_maxcontexts0_wlsb4_smallcid.sizes )
+	v2=$( gawk 'START { sum=0 } { sum+=$9 } END { print sum }' $dir/rohcv2_maxcontexts0_wlsb4_smallcid.sizes )
+	if [ $v1 -lt $v2 ] ; then
+		print_red "FAIL: "
+		failures_nr=$(( ${failures_nr} + 1 ))
+	else
+		print_green "PASS: "
+	fi
+	echo "$dir: v1=$v1 v2=$v2 delta=$(( $v2 - $v1 ))"
 done
 
 exit ${failures_nr}
-
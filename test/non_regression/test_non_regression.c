@@ -80,6 +80,27 @@
  * comparison and shutdown).
  *
  * The program optionally outputs the ROHC packets in a PCAP packet.
+ *
+ * Benchmark
+ * ---------
+ *
+ * With the --benchmark option, the program loads all the IP packets in memory,
+ * then replays them the requested number of times through new
+ * compressor/decompressor pairs without any comparison. It outputs the
+ * throughput and the latency percentiles of compression and decompression,
+ * then the cost of the ROHC version in use: the time spent per packet, the
+ * average size of the ROHC headers and the memory used per context, so that
+ * the ROHCv1 and ROHCv2 profiles may be compared on the same flows (see
+ * compare_v1_v2.sh).
+ *
+ * With the --impairment-sweep option, the replays of the benchmark mode go
+ * through a channel that loses and reorders the ROHC packets. All the
+ * combinations of several loss and reorder rates are swept. For every
+ * combination, the program outputs the time spent per packet, the average
+ * size of the ROHC headers, the number of feedback bytes sent back to the
+ * compressor and the number of packets it takes the decompressor to recover
+ * from a failure, so that the efficiency and the CPU cost of the library may
+ * be compared together.
  */
 
 #include "test.h"
@@ -99,6 +120,8 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <time.h> /* for clock_gettime(2) */
+#include <inttypes.h> /* for PRIu32 */
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -136,6 +159,51 @@ for ./configure ? If yes, check configure output and config.log"
 		} \
 	} while(0)
 
+/** One IP packet preloaded for the benchmark mode */
+struct bench_pkt
+{
+	uint8_t *data;             /**< The IP packet */
+	size_t len;                /**< The length of the IP packet */
+	struct rohc_ts arrival;    /**< The arrival time of the IP packet */
+};
+
+/** All the IP packets preloaded for the benchmark mode */
+struct bench_pkts
+{
+	struct bench_pkt *pkts;    /**< The IP packets */
+	size_t nr;                 /**< The number of IP packets */
+	size_t max;                /**< The number of allocated IP packets */
+	size_t bytes_nr;           /**< The total length of the IP packets */
+};
+
+/** The results of the replays through one impaired channel */
+struct bench_impair
+{
+	size_t pkts_nr;            /**< The number of compressed packets */
+	size_t lost_nr;            /**< The number of lost ROHC packets */
+	size_t reordered_nr;       /**< The number of reordered ROHC packets */
+	uint64_t comp_ns;          /**< The time spent in compression (ns) */
+	uint64_t decomp_ns;        /**< The time spent in decompression (ns) */
+	size_t decomp_nr;          /**< The number of decompressed packets */
+	size_t hdr_bytes_nr;       /**< The length of all the ROHC headers */
+	size_t feedback_bytes_nr;  /**< The length of all the feedback */
+	size_t failures_nr;        /**< The number of decompression failures */
+	size_t recoveries_nr;      /**< The number of recoveries after failures */
+	size_t recovery_pkts_nr;   /**< The number of failed packets before
+	                                all the recoveries */
+	size_t recovery_max;       /**< The largest number of failed packets
+	                                before one recovery */
+	size_t unrecovered_nr;     /**< The number of contexts that did not
+	                                recover at the end of the replays */
+};
+
+/** The loss rates (in 1/1000) swept by the impairment benchmark */
+static const unsigned int bench_loss_rates[] = { 0, 10, 20, 50, 100, 200 };
+
+/** The reorder rates (in 1/1000) swept by the impairment benchmark */
+static const unsigned int bench_reorder_rates[] = { 0, 10, 50, 100 };
+
+
 /* prototypes of private functions */
 static void usage(void);
 static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
@@ -157,7 +225,7 @@ static int compress_decompress(struct rohc_comp *comp,
                                int num_packet,
                                struct pcap_pkthdr header,
                                const uint8_t *const packet,
-                               int link_len_src,
+                               size_t link_len_src,
                                const size_t padding_up_to,
                                const bool no_comparison,
                                const bool ignore_malformed,
@@ -169,6 +237,74 @@ static int compress_decompress(struct rohc_comp *comp,
                                const struct rohc_buf feedback_send_by_me,
                                struct rohc_buf *const feedback_send_by_other);
 
+static bool get_ip_packet(const struct pcap_pkthdr header,
+                          size_t *const link_len,
+                          bool *const is_vlan_present,
+                          struct rohc_buf *const ip_packet)
+	__attribute__((nonnull(2, 3, 4), warn_unused_result));
+
+static int test_benchmark(const rohc_cid_type_t cid_type,
+                          const size_t oa_repetitions,
+                          const size_t max_contexts,
+                          const size_t proto_version,
+                          const char *const src_filenames[],
+                          const size_t src_filenames_nr,
+                          const size_t repetitions)
+	__attribute__((nonnull(5), warn_unused_result));
+static bool bench_load_packets(const char *const src_filenames[],
+                               const size_t src_filenames_nr,
+                               struct bench_pkts *const pkts)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+static bool bench_replay(struct rohc_comp *const comp,
+                         struct rohc_decomp *const decomp,
+                         const struct bench_pkts *const pkts,
+                         const size_t num_comp,
+                         uint32_t *const comp_lat,
+                         uint32_t *const decomp_lat,
+                         size_t *const rohc_hdrs_len)
+	__attribute__((nonnull(1, 2, 3, 5, 6, 7), warn_unused_result));
+static bool bench_ctxts_mem(const struct rohc_comp *const comp,
+                            const struct rohc_decomp *const decomp,
+                            size_t *const comp_bytes_nr,
+                            size_t *const decomp_bytes_nr,
+                            size_t *const ctxts_nr)
+	__attribute__((nonnull(1, 2, 3, 4, 5), warn_unused_result));
+static void bench_print(const char *const direction,
+                        uint32_t *const latencies,
+                        const size_t latencies_nr,
+                        const size_t bytes_nr)
+	__attribute__((nonnull(1, 2)));
+static int test_impairment_sweep(const rohc_cid_type_t cid_type,
+                                 const size_t oa_repetitions,
+                                 const size_t max_contexts,
+                                 const size_t proto_version,
+                                 const char *const src_filenames[],
+                                 const size_t src_filenames_nr,
+                                 const size_t repetitions)
+	__attribute__((nonnull(5), warn_unused_result));
+static bool bench_impair_replay(struct rohc_comp *const comp,
+                                struct rohc_decomp *const decomp,
+                                const struct bench_pkts *const pkts,
+                                const unsigned int loss_rate,
+                                const unsigned int reorder_rate,
+                                uint32_t *const rand_state,
+                                size_t *const failed_pkts,
+                                struct bench_impair *const res)
+	__attribute__((nonnull(1, 2, 3, 6, 7, 8), warn_unused_result));
+static void bench_impair_decomp(struct rohc_comp *const comp,
+                                struct rohc_decomp *const decomp,
+                                const struct rohc_buf rohc_packet,
+                                const rohc_cid_t cid,
+                                size_t *const failed_pkts,
+                                struct bench_impair *const res)
+	__attribute__((nonnull(1, 2, 5, 6)));
+static unsigned int bench_rand(uint32_t *const state)
+	__attribute__((nonnull(1), warn_unused_result));
+static int bench_cmp_latencies(const void *const lat1, const void *const lat2)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+static uint64_t bench_get_ns(void)
+	__attribute__((warn_unused_result));
+
 static struct rohc_comp * create_compressor(const rohc_cid_type_t cid_type,
                                             const size_t oa_repetitions,
                                             const size_t max_contexts,
@@ -293,6 +429,8 @@ int main(int argc, char *argv[])
 	bool ignore_malformed = false;
 	bool assert_on_error = false;
 	bool print_stats = false;
+	int bench_repetitions = 0;
+	bool impairment_sweep = false;
 	int status = 1;
 	rohc_cid_type_t cid_type;
 	int args_used;
@@ -456,6 +594,30 @@ int main(int argc, char *argv[])
 			proto_version = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--benchmark"))
+		{
+			/* get the number of replays of the benchmark mode */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --benchmark takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			bench_repetitions = atoi(argv[1]);
+			if(bench_repetitions <= 0)
+			{
+				fprintf(stderr, "invalid number of benchmark replays %d: should be "
+				        "a positive number\n\n", bench_repetitions);
+				usage();
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--impairment-sweep"))
+		{
+			/* replay the benchmark through lossy and reordering channels */
+			impairment_sweep = true;
+		}
 		else if(!strcmp(*argv, "--initial-msn"))
 		{
 			/* get the initial Master Sequence Number (MSN) */
@@ -567,6 +729,34 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* the impairment sweep is one flavour of the benchmark mode */
+	if(impairment_sweep && bench_repetitions <= 0)
+	{
+		fprintf(stderr, "option --impairment-sweep requires option "
+		        "--benchmark\n\n");
+		usage();
+		goto error;
+	}
+
+	/* benchmark the ROHC library through impaired channels if asked */
+	if(impairment_sweep)
+	{
+		status = test_impairment_sweep(cid_type, oa_repetitions, max_contexts,
+		                               proto_version,
+		                               (const char *const *) src_filenames,
+		                               src_filenames_nr, bench_repetitions);
+		goto error;
+	}
+
+	/* benchmark the ROHC library with the packets from the files if asked */
+	if(bench_repetitions > 0)
+	{
+		status = test_benchmark(cid_type, oa_repetitions, max_contexts,
+		                        proto_version, (const char *const *) src_filenames,
+		                        src_filenames_nr, bench_repetitions);
+		goto error;
+	}
+
 	/* test ROHC compression/decompression with the packets from the file */
 	status = test_comp_and_decomp(cid_type, oa_repetitions, max_contexts, proto_version,
 	                              padding_up_to, no_comparison, ignore_malformed,
@@ -644,6 +834,16 @@ static void usage(void)
 	        "  --ignore-malformed         Ignore malformed packets for test\n"
 	        "  --assert-on-error          Stop the test after the very first encountered error\n"
 	        "  --initial-msn NUM          The initial Master Sequence Number (MSN) for debug\n"
+	        "  --benchmark NUM            Replay the flows NUM times from memory without\n"
+	        "                             any comparison, then print the throughput\n"
+	        "                             and the latencies of compression and\n"
+	        "                             decompression, the average header size\n"
+	        "                             and the memory used per context\n"
+	        "  --impairment-sweep         With --benchmark, replay the flows through\n"
+	        "                             channels with several loss and reorder\n"
+	        "                             rates, then print the time per packet, the\n"
+	        "                             header sizes, the feedback bytes and the\n"
+	        "                             recovery latencies for every rate\n"
 	        "  --verbose                  Run the test in verbose mode\n"
 	        "  --quiet                    Run the test in silent mode\n");
 }
@@ -933,7 +1133,7 @@ static int compress_decompress(struct rohc_comp *comp,
                                int num_packet,
                                struct pcap_pkthdr header,
                                const uint8_t *const packet,
-                               int link_len_src,
+                               size_t link_len_src,
                                const size_t padding_up_to,
                                const bool no_comparison,
                                const bool ignore_malformed,
@@ -980,97 +1180,15 @@ static int compress_decompress(struct rohc_comp *comp,
 	trace("=== compressor/decompressor #%d, packet #%d:\n", num_comp, num_packet);
 	trace("=== arrival time %ld seconds %ld us\n", header.ts.tv_sec, header.ts.tv_usec);
 
-	/* check Ethernet frame length */
-	if(header.len < link_len_src || header.len != header.caplen)
+	/* get the IP packet out of the link layer frame */
+	if(!get_ip_packet(header, &link_len_src, &is_vlan_present, &ip_packet))
 	{
-		trace("bad PCAP packet (len = %u, caplen = %u)\n", header.len,
-		      header.caplen);
 		status = -3;
 		goto exit;
 	}
-
-	/* copy the layer 2 header before the ROHC packet, then skip it */
-	if(link_len_src == ETHER_HDR_LEN)
-	{
-		const struct ether_header *const eth_header =
-			(struct ether_header *) rohc_buf_data(ip_packet);
-		uint16_t proto_type = ntohs(eth_header->ether_type);
-
-		/* skip all 802.1q or 802.1ad headers */
-		while(proto_type == ETHERTYPE_8021Q || proto_type == ETHERTYPE_8021AD)
-		{
-			trace("found one 802.1q or 802.1ad header\n");
-			is_vlan_present = true;
-
-			/* check min length */
-			if(header.len < link_len_src + sizeof(struct vlan_hdr))
-			{
-				trace("truncated %u-byte 802.1q or 802.1ad frame\n", header.len);
-				status = -3;
-				goto exit;
-			}
-
-			/* detect next header */
-			const struct vlan_hdr *const vlan_hdr =
-				(struct vlan_hdr *) rohc_buf_data_at(ip_packet, link_len_src);
-			proto_type = ntohs(vlan_hdr->type);
-
-			/* skip VLAN header */
-			link_len_src += sizeof(struct vlan_hdr);
-		}
-	}
 	rohc_buf_append(&rohc_packet, packet, link_len_src);
-	rohc_buf_pull(&ip_packet, link_len_src);
 	rohc_buf_pull(&rohc_packet, link_len_src);
 
-	/* check for padding after the IP packet in the Ethernet payload */
-	if(link_len_src == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
-	{
-		int version;
-		size_t tot_len;
-
-		version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
-
-		if(version == 4)
-		{
-			struct ipv4_hdr *ip = (struct ipv4_hdr *) rohc_buf_data(ip_packet);
-			tot_len = ntohs(ip->tot_len);
-			if(tot_len < sizeof(struct ipv4_hdr))
-			{
-				trace("malformed IPv4 packet: IPv4 total length is %zu bytes, "
-				      "but it should be at least %zu bytes", tot_len,
-				      sizeof(struct ipv4_hdr));
-				status = -3;
-				goto exit;
-			}
-		}
-		else
-		{
-			struct ipv6_hdr *ip = (struct ipv6_hdr *) rohc_buf_data(ip_packet);
-			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
-		}
-
-		if(tot_len < ip_packet.len)
-		{
-			trace("The Ethernet frame has %zu bytes of padding after the "
-			      "%zu byte IP packet!\n", ip_packet.len - tot_len, tot_len);
-			ip_packet.len = tot_len;
-		}
-	}
-
-	/* fix IPv4 packets with non-standard-compliant 0xffff checksums instead
-	 * of 0x0000 (Windows Vista seems to be faulty for the latter), to avoid
-	 * false comparison failures after decompression) */
-	if(((rohc_buf_byte(ip_packet) >> 4) & 0x0f) == 4 &&
-	   ip_packet.len >= sizeof(struct ipv4_hdr) &&
-	   rohc_buf_byte_at(ip_packet, 10) == 0xff &&
-	   rohc_buf_byte_at(ip_packet, 11) == 0xff)
-	{
-		trace("fix IPv4 packet with 0xffff IP checksum\n");
-		rohc_buf_byte_at(ip_packet, 10) = 0x00;
-		rohc_buf_byte_at(ip_packet, 11) = 0x00;
-	}
-
 	/* make room for future ROHC padding */
 	rohc_packet.len += padding_up_to;
 	rohc_buf_pull(&rohc_packet, padding_up_to);
@@ -1282,6 +1400,121 @@ exit:
 }
 
 
+/**
+ * @brief Get the IP packet out of one link layer frame
+ *
+ * The 802.1q and 802.1ad headers are skipped, the Ethernet padding is
+ * removed, and the IPv4 0xffff checksums are fixed.
+ *
+ * @param header                The PCAP header of the frame
+ * @param[in,out] link_len      IN:  The length of the link layer header
+ *                              OUT: The length of the link layer headers,
+ *                                   VLAN headers included
+ * @param[out] is_vlan_present  Whether at least one VLAN header was found
+ * @param[in,out] ip_packet     IN:  The frame
+ *                              OUT: The IP packet within the frame
+ * @return                      true if the frame is well-formed,
+ *                              false otherwise
+ */
+static bool get_ip_packet(const struct pcap_pkthdr header,
+                          size_t *const link_len,
+                          bool *const is_vlan_present,
+                          struct rohc_buf *const ip_packet)
+{
+	/* check Ethernet frame length */
+	if(header.len < *link_len || header.len != header.caplen)
+	{
+		trace("bad PCAP packet (len = %u, caplen = %u)\n", header.len,
+		      header.caplen);
+		goto error;
+	}
+
+	/* skip the layer 2 header */
+	if(*link_len == ETHER_HDR_LEN)
+	{
+		const struct ether_header *const eth_header =
+			(struct ether_header *) rohc_buf_data(*ip_packet);
+		uint16_t proto_type = ntohs(eth_header->ether_type);
+
+		/* skip all 802.1q or 802.1ad headers */
+		while(proto_type == ETHERTYPE_8021Q || proto_type == ETHERTYPE_8021AD)
+		{
+			trace("found one 802.1q or 802.1ad header\n");
+			*is_vlan_present = true;
+
+			/* check min length */
+			if(header.len < *link_len + sizeof(struct vlan_hdr))
+			{
+				trace("truncated %u-byte 802.1q or 802.1ad frame\n", header.len);
+				goto error;
+			}
+
+			/* detect next header */
+			const struct vlan_hdr *const vlan_hdr =
+				(struct vlan_hdr *) rohc_buf_data_at(*ip_packet, *link_len);
+			proto_type = ntohs(vlan_hdr->type);
+
+			/* skip VLAN header */
+			*link_len += sizeof(struct vlan_hdr);
+		}
+	}
+	rohc_buf_pull(ip_packet, *link_len);
+
+	/* check for padding after the IP packet in the Ethernet payload */
+	if(*link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+	{
+		int version;
+		size_t tot_len;
+
+		version = (rohc_buf_byte(*ip_packet) >> 4) & 0x0f;
+
+		if(version == 4)
+		{
+			struct ipv4_hdr *ip = (struct ipv4_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = ntohs(ip->tot_len);
+			if(tot_len < sizeof(struct ipv4_hdr))
+			{
+				trace("malformed IPv4 packet: IPv4 total length is %zu bytes, "
+				      "but it should be at least %zu bytes", tot_len,
+				      sizeof(struct ipv4_hdr));
+				goto error;
+			}
+		}
+		else
+		{
+			struct ipv6_hdr *ip = (struct ipv6_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+		}
+
+		if(tot_len < ip_packet->len)
+		{
+			trace("The Ethernet frame has %zu bytes of padding after the "
+			      "%zu byte IP packet!\n", ip_packet->len - tot_len, tot_len);
+			ip_packet->len = tot_len;
+		}
+	}
+
+	/* fix IPv4 packets with non-standard-compliant 0xffff checksums instead
+	 * of 0x0000 (Windows Vista seems to be faulty for the latter), to avoid
+	 * false comparison failures after decompression) */
+	if(((rohc_buf_byte(*ip_packet) >> 4) & 0x0f) == 4 &&
+	   ip_packet->len >= sizeof(struct ipv4_hdr) &&
+	   rohc_buf_byte_at(*ip_packet, 10) == 0xff &&
+	   rohc_buf_byte_at(*ip_packet, 11) == 0xff)
+	{
+		trace("fix IPv4 packet with 0xffff IP checksum\n");
+		rohc_buf_byte_at(*ip_packet, 10) = 0x00;
+		rohc_buf_byte_at(*ip_packet, 11) = 0x00;
+	}
+
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Test the ROHC library with a flow of IP packets going through
  *        two compressor/decompressor pairs
@@ -1597,6 +1830,809 @@ error:
 }
 
 
+/**
+ * @brief Benchmark the ROHC library with a flow of IP packets
+ *
+ * All the IP packets are loaded in memory first, so that reading the PCAP
+ * files is not measured. The IP packets are then compressed and decompressed
+ * as many times as requested by the two compressor/decompressor pairs, without
+ * any comparison. New compressors and decompressors are created for every
+ * replay.
+ *
+ * @param cid_type        The type of CIDs the compressor shall use
+ * @param oa_repetitions  The nr of repetitions for the Optimistic Approach
+ * @param max_contexts    The maximum number of ROHC contexts to use
+ * @param proto_version   The version of the ROHC protocol to use: v1 or v2
+ * @param src_filenames   The names of the PCAP files that contain the
+ *                        IP packets
+ * @param src_filenames_nr  The number of PCAP files
+ * @param repetitions     The number of replays of the IP packets
+ * @return                0 in case of success,
+ *                        1 in case of failure,
+ *                        77 if test is skipped
+ */
+static int test_benchmark(const rohc_cid_type_t cid_type,
+                          const size_t oa_repetitions,
+                          const size_t max_contexts,
+                          const size_t proto_version,
+                          const char *const src_filenames[],
+                          const size_t src_filenames_nr,
+                          const size_t repetitions)
+{
+	struct bench_pkts pkts = { .pkts = NULL, .nr = 0, .max = 0, .bytes_nr = 0 };
+	uint32_t *comp_lat;
+	uint32_t *decomp_lat;
+	size_t lat_nr = 0;
+	size_t rohc_hdrs_len = 0;
+	size_t comp_mem_nr = 0;
+	size_t decomp_mem_nr = 0;
+	size_t ctxts_nr = 0;
+	uint64_t comp_ns = 0;
+	uint64_t decomp_ns = 0;
+	size_t rep;
+	size_t i;
+	int status = 1;
+
+	trace("=== benchmark: load the IP packets\n");
+	if(!bench_load_packets(src_filenames, src_filenames_nr, &pkts))
+	{
+		status = 77; /* skip test */
+		goto free_pkts;
+	}
+	if(pkts.nr == 0)
+	{
+		trace("no IP packet to replay\n");
+		status = 77; /* skip test */
+		goto free_pkts;
+	}
+	trace("=== benchmark: %zu IP packets (%zu bytes) loaded\n", pkts.nr,
+	      pkts.bytes_nr);
+
+	/* the latencies of all the packets of all the replays are recorded */
+	comp_lat = malloc(NUM_COMP * repetitions * pkts.nr * sizeof(uint32_t));
+	if(comp_lat == NULL)
+	{
+		trace("failed to allocate memory for the compression latencies\n");
+		goto free_pkts;
+	}
+	decomp_lat = malloc(NUM_COMP * repetitions * pkts.nr * sizeof(uint32_t));
+	if(decomp_lat == NULL)
+	{
+		trace("failed to allocate memory for the decompression latencies\n");
+		goto free_comp_lat;
+	}
+
+	for(rep = 0; rep < repetitions; rep++)
+	{
+		size_t num_comp;
+
+		trace("=== benchmark: replay %zu/%zu\n", rep + 1, repetitions);
+
+		for(num_comp = 1; num_comp <= NUM_COMP; num_comp++)
+		{
+			struct rohc_comp *comp;
+			struct rohc_decomp *decomp;
+			bool is_ok;
+
+			comp = create_compressor(cid_type, oa_repetitions, max_contexts,
+			                         proto_version);
+			if(comp == NULL)
+			{
+				trace("failed to create the compressor %zu\n", num_comp);
+				goto free_decomp_lat;
+			}
+			decomp = create_decompressor(cid_type, max_contexts, proto_version);
+			if(decomp == NULL)
+			{
+				trace("failed to create the decompressor %zu\n", num_comp);
+				rohc_comp_free(comp);
+				goto free_decomp_lat;
+			}
+
+			is_ok = bench_replay(comp, decomp, &pkts, num_comp,
+			                     comp_lat + lat_nr, decomp_lat + lat_nr,
+			                     &rohc_hdrs_len);
+			if(is_ok)
+			{
+				is_ok = bench_ctxts_mem(comp, decomp, &comp_mem_nr,
+				                        &decomp_mem_nr, &ctxts_nr);
+			}
+
+			rohc_decomp_free(decomp);
+			rohc_comp_free(comp);
+
+			if(!is_ok)
+			{
+				goto free_decomp_lat;
+			}
+			lat_nr += pkts.nr;
+		}
+	}
+
+	/* the total times are computed before the latencies get sorted */
+	for(i = 0; i < lat_nr; i++)
+	{
+		comp_ns += comp_lat[i];
+		decomp_ns += decomp_lat[i];
+	}
+
+	/* print the results */
+	printf("BENCH\t\"direction\"\t\"packets\"\t\"packets/s\"\t\"Mbit/s\"\t"
+	       "\"min (ns)\"\t\"p50 (ns)\"\t\"p90 (ns)\"\t\"p99 (ns)\"\t\"p99.9 (ns)\"\t"
+	       "\"max (ns)\"\n");
+	bench_print("compression", comp_lat, lat_nr,
+	            NUM_COMP * repetitions * pkts.bytes_nr);
+	bench_print("decompression", decomp_lat, lat_nr,
+	            NUM_COMP * repetitions * pkts.bytes_nr);
+	printf("COST\t\"ROHC version\"\t\"packets\"\t\"comp (ns/packet)\"\t"
+	       "\"decomp (ns/packet)\"\t\"header (bytes/packet)\"\t"
+	       "\"comp memory (bytes/context)\"\t"
+	       "\"decomp memory (bytes/context)\"\n");
+	printf("COST\tv%zu\t%zu\t%.1f\t%.1f\t%.2f\t%zu\t%zu\n", proto_version,
+	       lat_nr, ((double) comp_ns) / lat_nr, ((double) decomp_ns) / lat_nr,
+	       ((double) rohc_hdrs_len) / lat_nr,
+	       ctxts_nr == 0 ? 0 : comp_mem_nr / ctxts_nr,
+	       ctxts_nr == 0 ? 0 : decomp_mem_nr / ctxts_nr);
+
+	status = 0;
+
+free_decomp_lat:
+	free(decomp_lat);
+free_comp_lat:
+	free(comp_lat);
+free_pkts:
+	for(i = 0; i < pkts.nr; i++)
+	{
+		free(pkts.pkts[i].data);
+	}
+	free(pkts.pkts);
+	return status;
+}
+
+
+/**
+ * @brief Load the IP packets of PCAP files in memory for the benchmark mode
+ *
+ * The malformed frames are skipped.
+ *
+ * @param src_filenames     The names of the PCAP files that contain the
+ *                          IP packets
+ * @param src_filenames_nr  The number of PCAP files
+ * @param[in,out] pkts      The loaded IP packets, to be freed by the caller
+ *                          even in case of failure
+ * @return                  true if the IP packets were loaded,
+ *                          false otherwise
+ */
+static bool bench_load_packets(const char *const src_filenames[],
+                               const size_t src_filenames_nr,
+                               struct bench_pkts *const pkts)
+{
+	size_t src_filenames_id = 0;
+	struct pcap_pkthdr header;
+	const uint8_t *packet;
+	size_t link_len_src;
+	pcap_t *handle;
+
+	handle = open_pcap_file("source", src_filenames[0], &link_len_src);
+	if(handle == NULL)
+	{
+		goto error;
+	}
+
+	while(get_next_packet(&handle, src_filenames, src_filenames_nr,
+	                      &src_filenames_id, &header, &link_len_src, &packet))
+	{
+		const struct rohc_ts arrival_time = {
+			.sec = header.ts.tv_sec,
+			.nsec = header.ts.tv_usec * 1000
+		};
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full((uint8_t *) packet, header.caplen, arrival_time);
+		size_t link_len = link_len_src;
+		bool is_vlan_present = false;
+		struct bench_pkt *pkt;
+
+		if(!get_ip_packet(header, &link_len, &is_vlan_present, &ip_packet))
+		{
+			trace("skip malformed frame #%zu\n", pkts->nr + 1);
+			continue;
+		}
+
+		/* grow the array of packets if needed */
+		if(pkts->nr == pkts->max)
+		{
+			const size_t new_max = (pkts->max == 0 ? 1024 : pkts->max * 2);
+			struct bench_pkt *const new_pkts =
+				realloc(pkts->pkts, new_max * sizeof(struct bench_pkt));
+			if(new_pkts == NULL)
+			{
+				trace("failed to allocate memory for %zu IP packets\n", new_max);
+				goto close_input;
+			}
+			pkts->pkts = new_pkts;
+			pkts->max = new_max;
+		}
+
+		/* copy the IP packet since libpcap re-uses its buffer */
+		pkt = &(pkts->pkts[pkts->nr]);
+		pkt->data = malloc(ip_packet.len);
+		if(pkt->data == NULL)
+		{
+			trace("failed to allocate memory for one %zu-byte IP packet\n",
+			      ip_packet.len);
+			goto close_input;
+		}
+		memcpy(pkt->data, rohc_buf_data(ip_packet), ip_packet.len);
+		pkt->len = ip_packet.len;
+		pkt->arrival = arrival_time;
+		pkts->nr++;
+		pkts->bytes_nr += ip_packet.len;
+	}
+
+	/* get_next_packet() stops on the first PCAP file it fails to open */
+	if(handle == NULL && src_filenames_id < src_filenames_nr)
+	{
+		goto error;
+	}
+	if(handle != NULL)
+	{
+		pcap_close(handle);
+	}
+
+	return true;
+
+close_input:
+	if(handle != NULL)
+	{
+		pcap_close(handle);
+	}
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress and decompress all the preloaded IP packets once
+ *
+ * The feedback generated by the decompressor is delivered straight to the
+ * compressor. Only the compression and the decompression are measured.
+ *
+ * @param comp             The compressor
+ * @param decomp           The decompressor
+ * @param pkts             The IP packets to compress and decompress
+ * @param num_comp         The number of the compressor/decompressor pair
+ * @param[out] comp_lat    The compression latencies of the packets (ns)
+ * @param[out] decomp_lat  The decompression latencies of the packets (ns)
+ * @param[in,out] rohc_hdrs_len  The total length of the ROHC headers, the
+ *                               headers of the packets are added to it
+ * @return                 true if all the packets were compressed then
+ *                         decompressed, false otherwise
+ */
+static bool bench_replay(struct rohc_comp *const comp,
+                         struct rohc_decomp *const decomp,
+                         const struct bench_pkts *const pkts,
+                         const size_t num_comp,
+                         uint32_t *const comp_lat,
+                         uint32_t *const decomp_lat,
+                         size_t *const rohc_hdrs_len)
+{
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	uint8_t feedback_buffer[MAX_ROHC_SIZE];
+	size_t i;
+
+	for(i = 0; i < pkts->nr; i++)
+	{
+		const struct bench_pkt *const pkt = &(pkts->pkts[i]);
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(pkt->data, pkt->len, pkt->arrival);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+		struct rohc_comp_pkt_info info;
+		rohc_status_t ret;
+		uint64_t start;
+
+		/* compress the IP packet */
+		start = bench_get_ns();
+		ret = rohc_compress5(comp, ip_packet, &rohc_packet, &info);
+		comp_lat[i] = bench_get_ns() - start;
+		if(ret != ROHC_STATUS_OK)
+		{
+			trace("compressor #%zu failed to compress packet #%zu\n", num_comp, i + 1);
+			goto error;
+		}
+		(*rohc_hdrs_len) += info.hdr_len;
+
+		/* decompress the ROHC packet */
+		start = bench_get_ns();
+		ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                       &feedback_send);
+		decomp_lat[i] = bench_get_ns() - start;
+		if(ret != ROHC_STATUS_OK)
+		{
+			trace("decompressor #%zu failed to decompress packet #%zu\n",
+			      num_comp, i + 1);
+			goto error;
+		}
+
+		/* deliver the feedback to the compressor */
+		if(feedback_send.len > 0 && !rohc_comp_deliver_feedback2(comp, feedback_send))
+		{
+			trace("compressor #%zu failed to handle the feedback for packet #%zu\n",
+			      num_comp, i + 1);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Account for the memory used by the contexts of one benchmark pair
+ *
+ * The memory is read once all the packets were replayed, all the contexts
+ * of the flows being created then.
+ *
+ * @param comp                     The compressor
+ * @param decomp                   The decompressor
+ * @param[in,out] comp_bytes_nr    The memory used by the compressors
+ * @param[in,out] decomp_bytes_nr  The memory used by the decompressors
+ * @param[in,out] ctxts_nr         The number of contexts of the compressors
+ * @return                         true if the memory was accounted for,
+ *                                 false otherwise
+ */
+static bool bench_ctxts_mem(const struct rohc_comp *const comp,
+                            const struct rohc_decomp *const decomp,
+                            size_t *const comp_bytes_nr,
+                            size_t *const decomp_bytes_nr,
+                            size_t *const ctxts_nr)
+{
+	rohc_comp_general_info_t comp_info = { .version_major = 0, .version_minor = 0 };
+	rohc_comp_mem_info_t comp_mem = { .version_major = 0, .version_minor = 0 };
+	rohc_decomp_mem_info_t decomp_mem = { .version_major = 0, .version_minor = 0 };
+
+	if(!rohc_comp_get_general_info(comp, &comp_info) ||
+	   !rohc_comp_get_mem_info(comp, &comp_mem) ||
+	   !rohc_decomp_get_mem_info(decomp, &decomp_mem))
+	{
+		trace("failed to get the memory used by the contexts\n");
+		goto error;
+	}
+	(*comp_bytes_nr) += comp_mem.used_bytes_nr;
+	(*decomp_bytes_nr) += decomp_mem.used_bytes_nr;
+	(*ctxts_nr) += comp_info.contexts_nr;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Print the throughput and the latency percentiles of one direction
+ *
+ * @param direction     The description of the direction
+ * @param latencies     The latencies of all the packets (ns), sorted in place
+ * @param latencies_nr  The number of packets
+ * @param bytes_nr      The number of uncompressed bytes of all the packets
+ */
+static void bench_print(const char *const direction,
+                        uint32_t *const latencies,
+                        const size_t latencies_nr,
+                        const size_t bytes_nr)
+{
+	uint64_t total_ns = 0;
+	size_t i;
+
+	for(i = 0; i < latencies_nr; i++)
+	{
+		total_ns += latencies[i];
+	}
+	if(total_ns == 0)
+	{
+		total_ns = 1;
+	}
+	qsort(latencies, latencies_nr, sizeof(uint32_t), bench_cmp_latencies);
+
+	printf("BENCH\t%s\t%zu\t%.0f\t%.1f\t%" PRIu32 "\t%" PRIu32 "\t%" PRIu32 "\t%"
+	       PRIu32 "\t%" PRIu32 "\t%" PRIu32 "\n", direction, latencies_nr,
+	       latencies_nr * 1e9 / total_ns, bytes_nr * 8e3 / total_ns,
+	       latencies[0], latencies[(latencies_nr - 1) * 500 / 1000],
+	       latencies[(latencies_nr - 1) * 900 / 1000],
+	       latencies[(latencies_nr - 1) * 990 / 1000],
+	       latencies[(latencies_nr - 1) * 999 / 1000],
+	       latencies[latencies_nr - 1]);
+}
+
+
+/**
+ * @brief Sweep loss and reorder rates over the IP packets of the flows
+ *
+ * For every combination of loss and reorder rates, the IP packets are
+ * replayed the requested number of times through new compressor/decompressor
+ * pairs. The ROHC packets go through a channel that loses and reorders them
+ * with a deterministic pseudo-random generator, so that the runs are
+ * reproducible. Decompression failures are counted instead of stopping the
+ * test.
+ *
+ * @param cid_type        The type of CIDs the compressor shall use
+ * @param oa_repetitions  The number of Optimistic Approach repetitions
+ * @param max_contexts    The maximum number of ROHC contexts to use
+ * @param proto_version   The version of the ROHC protocol to use
+ * @param src_filenames   The names of the PCAP files that contain the
+ *                        IP packets
+ * @param src_filenames_nr  The number of PCAP files
+ * @param repetitions     The number of replays for every combination of rates
+ * @return                0 in case of success,
+ *                        1 in case of failure,
+ *                        77 if test is skipped
+ */
+static int test_impairment_sweep(const rohc_cid_type_t cid_type,
+                                 const size_t oa_repetitions,
+                                 const size_t max_contexts,
+                                 const size_t proto_version,
+                                 const char *const src_filenames[],
+                                 const size_t src_filenames_nr,
+                                 const size_t repetitions)
+{
+	const size_t loss_rates_nr =
+		sizeof(bench_loss_rates) / sizeof(bench_loss_rates[0]);
+	const size_t reorder_rates_nr =
+		sizeof(bench_reorder_rates) / sizeof(bench_reorder_rates[0]);
+	struct bench_pkts pkts = { .pkts = NULL, .nr = 0, .max = 0, .bytes_nr = 0 };
+	size_t *failed_pkts;
+	size_t loss_id;
+	size_t i;
+	int status = 1;
+
+	trace("=== impairment sweep: load the IP packets\n");
+	if(!bench_load_packets(src_filenames, src_filenames_nr, &pkts))
+	{
+		status = 77; /* skip test */
+		goto free_pkts;
+	}
+	if(pkts.nr == 0)
+	{
+		trace("no IP packet to replay\n");
+		status = 77; /* skip test */
+		goto free_pkts;
+	}
+	trace("=== impairment sweep: %zu IP packets (%zu bytes) loaded\n", pkts.nr,
+	      pkts.bytes_nr);
+
+	/* the number of failed packets since the last success, per context */
+	failed_pkts = malloc(max_contexts * sizeof(size_t));
+	if(failed_pkts == NULL)
+	{
+		trace("failed to allocate memory for the recovery counters\n");
+		goto free_pkts;
+	}
+
+	printf("IMPAIR\t\"loss (%%)\"\t\"reorder (%%)\"\t\"packets\"\t\"lost\"\t"
+	       "\"reordered\"\t\"comp (ns/pkt)\"\t\"decomp (ns/pkt)\"\t"
+	       "\"header (bytes/pkt)\"\t\"feedback (bytes)\"\t\"failures\"\t"
+	       "\"recoveries\"\t\"avg recovery (pkts)\"\t\"max recovery (pkts)\"\t"
+	       "\"unrecovered\"\n");
+
+	for(loss_id = 0; loss_id < loss_rates_nr; loss_id++)
+	{
+		size_t reorder_id;
+
+		for(reorder_id = 0; reorder_id < reorder_rates_nr; reorder_id++)
+		{
+			const unsigned int loss_rate = bench_loss_rates[loss_id];
+			const unsigned int reorder_rate = bench_reorder_rates[reorder_id];
+			struct bench_impair res;
+			size_t rep;
+
+			memset(&res, 0, sizeof(struct bench_impair));
+
+			for(rep = 0; rep < repetitions; rep++)
+			{
+				/* same pseudo-random sequence for every run of the program */
+				uint32_t rand_state = 2463534242U + rep;
+				struct rohc_comp *comp;
+				struct rohc_decomp *decomp;
+				size_t cid;
+				bool is_ok;
+
+				trace("=== impairment sweep: loss %u/1000, reorder %u/1000, "
+				      "replay %zu/%zu\n", loss_rate, reorder_rate, rep + 1,
+				      repetitions);
+
+				comp = create_compressor(cid_type, oa_repetitions, max_contexts,
+				                         proto_version);
+				if(comp == NULL)
+				{
+					trace("failed to create the compressor\n");
+					goto free_failed_pkts;
+				}
+				decomp = create_decompressor(cid_type, max_contexts, proto_version);
+				if(decomp == NULL)
+				{
+					trace("failed to create the decompressor\n");
+					rohc_comp_free(comp);
+					goto free_failed_pkts;
+				}
+
+				memset(failed_pkts, 0, max_contexts * sizeof(size_t));
+				is_ok = bench_impair_replay(comp, decomp, &pkts, loss_rate,
+				                            reorder_rate, &rand_state, failed_pkts,
+				                            &res);
+
+				rohc_decomp_free(decomp);
+				rohc_comp_free(comp);
+
+				if(!is_ok)
+				{
+					goto free_failed_pkts;
+				}
+
+				/* the contexts still in failure never recovered */
+				for(cid = 0; cid < max_contexts; cid++)
+				{
+					if(failed_pkts[cid] > 0)
+					{
+						res.unrecovered_nr++;
+					}
+				}
+			}
+
+			printf("IMPAIR\t%.1f\t%.1f\t%zu\t%zu\t%zu\t%.0f\t%.0f\t%.2f\t%zu\t%zu\t"
+			       "%zu\t%.2f\t%zu\t%zu\n", loss_rate / 10.0, reorder_rate / 10.0,
+			       res.pkts_nr, res.lost_nr, res.reordered_nr,
+			       ((double) res.comp_ns) / res.pkts_nr,
+			       res.decomp_nr == 0 ? 0.0 : ((double) res.decomp_ns) / res.decomp_nr,
+			       ((double) res.hdr_bytes_nr) / res.pkts_nr, res.feedback_bytes_nr,
+			       res.failures_nr, res.recoveries_nr,
+			       res.recoveries_nr == 0 ? 0.0 :
+			       ((double) res.recovery_pkts_nr) / res.recoveries_nr,
+			       res.recovery_max, res.unrecovered_nr);
+		}
+	}
+
+	status = 0;
+
+free_failed_pkts:
+	free(failed_pkts);
+free_pkts:
+	for(i = 0; i < pkts.nr; i++)
+	{
+		free(pkts.pkts[i].data);
+	}
+	free(pkts.pkts);
+	return status;
+}
+
+
+/**
+ * @brief Compress all the preloaded IP packets and decompress them through
+ *        an impaired channel
+ *
+ * Every ROHC packet is lost with the given loss rate. Every ROHC packet that
+ * is not lost is held back and delivered after the next one with the given
+ * reorder rate. The feedback generated by the decompressor is delivered
+ * straight to the compressor without any impairment.
+ *
+ * @param comp               The compressor
+ * @param decomp             The decompressor
+ * @param pkts               The IP packets to compress and decompress
+ * @param loss_rate          The loss rate of the channel (in 1/1000)
+ * @param reorder_rate       The reorder rate of the channel (in 1/1000)
+ * @param[in,out] rand_state The state of the pseudo-random generator
+ * @param[in,out] failed_pkts  The number of failed packets since the last
+ *                           success, per context
+ * @param[in,out] res        The results of the replays
+ * @return                   true if all the packets were compressed,
+ *                           false otherwise
+ */
+static bool bench_impair_replay(struct rohc_comp *const comp,
+                                struct rohc_decomp *const decomp,
+                                const struct bench_pkts *const pkts,
+                                const unsigned int loss_rate,
+                                const unsigned int reorder_rate,
+                                uint32_t *const rand_state,
+                                size_t *const failed_pkts,
+                                struct bench_impair *const res)
+{
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	uint8_t held_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf held_packet = rohc_buf_init_empty(held_buffer, MAX_ROHC_SIZE);
+	rohc_cid_t held_cid = 0;
+	bool is_held = false;
+	size_t i;
+
+	for(i = 0; i < pkts->nr; i++)
+	{
+		const struct bench_pkt *const pkt = &(pkts->pkts[i]);
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(pkt->data, pkt->len, pkt->arrival);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_comp_pkt_info info;
+		rohc_status_t ret;
+		uint64_t start;
+
+		/* compress the IP packet */
+		start = bench_get_ns();
+		ret = rohc_compress5(comp, ip_packet, &rohc_packet, &info);
+		res->comp_ns += bench_get_ns() - start;
+		if(ret != ROHC_STATUS_OK)
+		{
+			trace("failed to compress packet #%zu\n", i + 1);
+			goto error;
+		}
+		res->pkts_nr++;
+		res->hdr_bytes_nr += info.hdr_len;
+
+		/* the channel loses the ROHC packet... */
+		if(bench_rand(rand_state) < loss_rate)
+		{
+			res->lost_nr++;
+			continue;
+		}
+
+		/* ... or holds it back until the next one is delivered... */
+		if(!is_held && bench_rand(rand_state) < reorder_rate)
+		{
+			rohc_buf_reset(&held_packet);
+			rohc_buf_append_buf(&held_packet, rohc_packet);
+			held_cid = info.cid;
+			is_held = true;
+			res->reordered_nr++;
+			continue;
+		}
+
+		/* ... or delivers it, followed by the packet held back if any */
+		bench_impair_decomp(comp, decomp, rohc_packet, info.cid, failed_pkts, res);
+		if(is_held)
+		{
+			bench_impair_decomp(comp, decomp, held_packet, held_cid, failed_pkts,
+			                    res);
+			is_held = false;
+		}
+	}
+
+	/* flush the channel */
+	if(is_held)
+	{
+		bench_impair_decomp(comp, decomp, held_packet, held_cid, failed_pkts, res);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress one ROHC packet received from the impaired channel
+ *
+ * A failure starts or extends a failure period for the context of the
+ * packet. The first success after a failure period ends it: the number of
+ * failed packets of the period is the recovery latency.
+ *
+ * @param comp               The compressor that receives the feedback
+ * @param decomp             The decompressor
+ * @param rohc_packet        The ROHC packet to decompress
+ * @param cid                The CID of the context of the ROHC packet
+ * @param[in,out] failed_pkts  The number of failed packets since the last
+ *                           success, per context
+ * @param[in,out] res        The results of the replays
+ */
+static void bench_impair_decomp(struct rohc_comp *const comp,
+                                struct rohc_decomp *const decomp,
+                                const struct rohc_buf rohc_packet,
+                                const rohc_cid_t cid,
+                                size_t *const failed_pkts,
+                                struct bench_impair *const res)
+{
+	uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf decomp_packet =
+		rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+	uint8_t feedback_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+	rohc_status_t ret;
+	uint64_t start;
+
+	start = bench_get_ns();
+	ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+	                       &feedback_send);
+	res->decomp_ns += bench_get_ns() - start;
+	res->decomp_nr++;
+
+	if(ret != ROHC_STATUS_OK)
+	{
+		res->failures_nr++;
+		failed_pkts[cid]++;
+	}
+	else if(failed_pkts[cid] > 0)
+	{
+		res->recoveries_nr++;
+		res->recovery_pkts_nr += failed_pkts[cid];
+		if(failed_pkts[cid] > res->recovery_max)
+		{
+			res->recovery_max = failed_pkts[cid];
+		}
+		failed_pkts[cid] = 0;
+	}
+
+	/* a failure to handle the feedback is part of the measured behaviour */
+	if(feedback_send.len > 0)
+	{
+		res->feedback_bytes_nr += feedback_send.len;
+		if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+		{
+			trace("compressor failed to handle %zu bytes of feedback\n",
+			      feedback_send.len);
+		}
+	}
+}
+
+
+/**
+ * @brief Get a reproducible pseudo-random number for the impaired channel
+ *
+ * @param[in,out] state  The state of the xorshift generator
+ * @return               A number between 0 and 999
+ */
+static unsigned int bench_rand(uint32_t *const state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+
+	return x % 1000;
+}
+
+
+/**
+ * @brief Compare two latencies for qsort(3)
+ *
+ * @param lat1  The first latency
+ * @param lat2  The second latency
+ * @return      A negative number, zero, or a positive number if the first
+ *              latency is lower, equal, or greater than the second one
+ */
+static int bench_cmp_latencies(const void *const lat1, const void *const lat2)
+{
+	const uint32_t val1 = *((const uint32_t *) lat1);
+	const uint32_t val2 = *((const uint32_t *) lat2);
+
+	return (val1 > val2) - (val1 < val2);
+}
+
+
+/**
+ * @brief Get the current monotonic time
+ *
+ * @return  The current time (ns)
+ */
+static uint64_t bench_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
 /**
  * @brief Create and configure a ROHC compressor
  *
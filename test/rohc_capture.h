@@ -0,0 +1,753 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_capture.h
+ * @brief  Seekable captures of ROHC packets for the test applications
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * One ROHC capture stores the ROHC packets of one decompressor along with
+ * snapshots of its contexts taken every few packets. The snapshots are the
+ * images of \ref rohc_decomp_save_contexts. One packet in the middle of one
+ * long capture is thus decompressed without decompressing all the packets
+ * before it: the contexts are restored from the nearest snapshot, then the
+ * few packets between the snapshot and the packet are decompressed.
+ *
+ * The capture is written as one stream of records:
+ *   \li one file header,
+ *   \li the packet and snapshot records, one snapshot is written before the
+ *       packet it gives the contexts for,
+ *   \li one index record that gives the offsets of all the snapshots,
+ *   \li one trailer that gives the offset of the index record.
+ *
+ * The index and the trailer are written once the capture is closed. If they
+ * are missing, for example because the writer was killed, the index is
+ * rebuilt by reading the records until the first truncated one.
+ *
+ * All the fields are in the byte order of the host, the snapshots are only
+ * valid for the same build of the library on the same architecture anyway.
+ *
+ * The rohc_decomp.h header of the library shall be included before this one.
+ */
+
+#ifndef ROHC_TEST_CAPTURE__H
+#define ROHC_TEST_CAPTURE__H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/** The magic number of ROHC captures: "RCAP" in the byte order of the host */
+#define ROHC_CAPTURE_MAGIC  0x50414352U
+
+/** The version of the format of ROHC captures */
+#define ROHC_CAPTURE_VERSION  1U
+
+/** The default number of packets between two snapshots */
+#define ROHC_CAPTURE_SNAPSHOT_INTERVAL  1000U
+
+
+/** The header of one ROHC capture */
+struct rohc_capture_file_hdr
+{
+	uint32_t magic;      /**< \ref ROHC_CAPTURE_MAGIC */
+	uint16_t version;    /**< \ref ROHC_CAPTURE_VERSION */
+	uint16_t unused;
+} __attribute__((packed));
+
+/** The types of records of one ROHC capture */
+enum rohc_capture_rec_type
+{
+	ROHC_CAPTURE_REC_PKT      = 1,  /**< One ROHC packet */
+	ROHC_CAPTURE_REC_SNAPSHOT = 2,  /**< One snapshot of the contexts */
+	ROHC_CAPTURE_REC_INDEX    = 3,  /**< The index of the snapshots */
+};
+
+/** The header of one record of one ROHC capture */
+struct rohc_capture_rec_hdr
+{
+	uint8_t type;        /**< The type of record among \ref rohc_capture_rec_type */
+	uint8_t unused[3];
+	uint32_t len;        /**< The length of the data after the header */
+	uint64_t pkt_num;    /**< The number of the packet (from 0), or the number
+	                          of the next packet for one snapshot */
+	uint32_t ts_sec;     /**< The arrival time of the packet (seconds) */
+	uint32_t ts_nsec;    /**< The arrival time of the packet (nanoseconds) */
+} __attribute__((packed));
+
+/** One entry of the index of one ROHC capture */
+struct rohc_capture_index_entry
+{
+	uint64_t pkt_num;    /**< The number of the packet after the snapshot */
+	uint64_t offset;     /**< The offset of the snapshot record */
+} __attribute__((packed));
+
+/** The trailer of one ROHC capture */
+struct rohc_capture_trailer
+{
+	uint64_t index_offset;  /**< The offset of the index record */
+	uint32_t entries_nr;    /**< The number of entries in the index */
+	uint32_t magic;         /**< \ref ROHC_CAPTURE_MAGIC */
+} __attribute__((packed));
+
+
+/** One ROHC capture being written */
+struct rohc_capture_writer
+{
+	FILE *file;                  /**< The capture file */
+	size_t snapshot_interval;    /**< The number of packets between snapshots */
+	uint64_t offset;             /**< The offset of the next record */
+	uint64_t pkts_nr;            /**< The number of packets written */
+
+	/** The index of the snapshots written */
+	struct rohc_capture_index_entry *index;
+	size_t index_nr;             /**< The number of entries in the index */
+	size_t index_max;            /**< The number of entries allocated */
+
+	uint8_t *image;              /**< The buffer for the snapshots */
+	size_t image_max_len;        /**< The length of the buffer */
+};
+
+/** One ROHC capture mapped in memory */
+struct rohc_capture_map
+{
+	const uint8_t *data;         /**< The content of the file */
+	size_t len;                  /**< The length of the file */
+	size_t records_end;          /**< The end of the packet/snapshot records */
+	size_t offset;               /**< The offset of the next record to read */
+
+	/** The index of the snapshots, in host memory to be aligned */
+	struct rohc_capture_index_entry *index;
+	size_t index_nr;             /**< The number of entries in the index */
+};
+
+
+/**
+ * @brief Write one record in one ROHC capture
+ *
+ * @param writer   The ROHC capture
+ * @param type     The type of record
+ * @param pkt_num  The number of the packet the record is related to
+ * @param ts       The arrival time of the packet
+ * @param data     The data of the record
+ * @param len      The length of the data
+ * @return         true if the record was written, false otherwise
+ */
+static bool rohc_capture_write_rec(struct rohc_capture_writer *const writer,
+                                   const enum rohc_capture_rec_type type,
+                                   const uint64_t pkt_num,
+                                   const struct rohc_ts ts,
+                                   const uint8_t *const data,
+                                   const size_t len)
+	__attribute__((unused));
+static bool rohc_capture_write_rec(struct rohc_capture_writer *const writer,
+                                   const enum rohc_capture_rec_type type,
+                                   const uint64_t pkt_num,
+                                   const struct rohc_ts ts,
+                                   const uint8_t *const data,
+                                   const size_t len)
+{
+	struct rohc_capture_rec_hdr rec;
+
+	if(len > UINT32_MAX)
+	{
+		goto error;
+	}
+	memset(&rec, 0, sizeof(struct rohc_capture_rec_hdr));
+	rec.type = type;
+	rec.len = len;
+	rec.pkt_num = pkt_num;
+	rec.ts_sec = ts.sec;
+	rec.ts_nsec = ts.nsec;
+	if(fwrite(&rec, sizeof(struct rohc_capture_rec_hdr), 1, writer->file) != 1 ||
+	   (len > 0 && fwrite(data, len, 1, writer->file) != 1))
+	{
+		goto error;
+	}
+	writer->offset += sizeof(struct rohc_capture_rec_hdr) + len;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Start one ROHC capture
+ *
+ * @param writer             The ROHC capture
+ * @param path               The path of the capture file
+ * @param snapshot_interval  The number of packets between two snapshots
+ * @return                   true if the capture was started, false otherwise
+ */
+static bool rohc_capture_writer_open(struct rohc_capture_writer *const writer,
+                                     const char *const path,
+                                     const size_t snapshot_interval)
+	__attribute__((unused));
+static bool rohc_capture_writer_open(struct rohc_capture_writer *const writer,
+                                     const char *const path,
+                                     const size_t snapshot_interval)
+{
+	struct rohc_capture_file_hdr hdr;
+
+	memset(writer, 0, sizeof(struct rohc_capture_writer));
+	if(snapshot_interval == 0)
+	{
+		fprintf(stderr, "the interval between two snapshots shall not be 0\n");
+		goto error;
+	}
+	writer->snapshot_interval = snapshot_interval;
+
+	writer->file = fopen(path, "wb");
+	if(writer->file == NULL)
+	{
+		fprintf(stderr, "failed to open ROHC capture '%s': %s (%d)\n", path,
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	memset(&hdr, 0, sizeof(struct rohc_capture_file_hdr));
+	hdr.magic = ROHC_CAPTURE_MAGIC;
+	hdr.version = ROHC_CAPTURE_VERSION;
+	if(fwrite(&hdr, sizeof(struct rohc_capture_file_hdr), 1, writer->file) != 1)
+	{
+		fprintf(stderr, "failed to write ROHC capture '%s': %s (%d)\n", path,
+		        strerror(errno), errno);
+		goto close_file;
+	}
+	writer->offset = sizeof(struct rohc_capture_file_hdr);
+
+	return true;
+
+close_file:
+	fclose(writer->file);
+	writer->file = NULL;
+error:
+	return false;
+}
+
+
+/**
+ * @brief Add one ROHC packet to one ROHC capture
+ *
+ * One snapshot of the contexts of the decompressor is written before the
+ * packet every \e snapshot_interval packets. The packet shall thus be
+ * recorded before it is given to the decompressor.
+ *
+ * @param writer  The ROHC capture
+ * @param decomp  The decompressor the packet is given to
+ * @param ts      The arrival time of the packet
+ * @param packet  The ROHC packet
+ * @param len     The length of the ROHC packet
+ * @return        true if the packet was added, false otherwise
+ */
+static bool rohc_capture_writer_add(struct rohc_capture_writer *const writer,
+                                    const struct rohc_decomp *const decomp,
+                                    const struct rohc_ts ts,
+                                    const uint8_t *const packet,
+                                    const size_t len)
+	__attribute__((unused));
+static bool rohc_capture_writer_add(struct rohc_capture_writer *const writer,
+                                    const struct rohc_decomp *const decomp,
+                                    const struct rohc_ts ts,
+                                    const uint8_t *const packet,
+                                    const size_t len)
+{
+	/* no snapshot before the first packet, the contexts are empty */
+	if(writer->pkts_nr > 0 && (writer->pkts_nr % writer->snapshot_interval) == 0)
+	{
+		size_t image_len;
+
+		/* the buffer grows at the size of the largest image */
+		while(!rohc_decomp_save_contexts(decomp, writer->image,
+		                                 writer->image_max_len, &image_len))
+		{
+			uint8_t *image;
+
+			if(image_len <= writer->image_max_len)
+			{
+				fprintf(stderr, "failed to save the decompression contexts\n");
+				goto error;
+			}
+			image = realloc(writer->image, image_len);
+			if(image == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for one snapshot\n");
+				goto error;
+			}
+			writer->image = image;
+			writer->image_max_len = image_len;
+		}
+
+		if(writer->index_nr == writer->index_max)
+		{
+			const size_t index_max = (writer->index_max == 0 ?
+			                          64 : writer->index_max * 2);
+			struct rohc_capture_index_entry *const index =
+				realloc(writer->index, index_max * sizeof(*index));
+			if(index == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for the index\n");
+				goto error;
+			}
+			writer->index = index;
+			writer->index_max = index_max;
+		}
+		writer->index[writer->index_nr].pkt_num = writer->pkts_nr;
+		writer->index[writer->index_nr].offset = writer->offset;
+
+		if(!rohc_capture_write_rec(writer, ROHC_CAPTURE_REC_SNAPSHOT,
+		                           writer->pkts_nr, ts, writer->image, image_len))
+		{
+			fprintf(stderr, "failed to write one snapshot in the ROHC capture\n");
+			goto error;
+		}
+		writer->index_nr++;
+	}
+
+	if(!rohc_capture_write_rec(writer, ROHC_CAPTURE_REC_PKT, writer->pkts_nr,
+	                           ts, packet, len))
+	{
+		fprintf(stderr, "failed to write one packet in the ROHC capture\n");
+		goto error;
+	}
+	writer->pkts_nr++;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Write the index of one ROHC capture, then close it
+ *
+ * @param writer  The ROHC capture
+ * @return        true if the capture was completed, false otherwise
+ */
+static bool rohc_capture_writer_close(struct rohc_capture_writer *const writer)
+	__attribute__((unused));
+static bool rohc_capture_writer_close(struct rohc_capture_writer *const writer)
+{
+	const struct rohc_ts no_ts = { .sec = 0, .nsec = 0 };
+	struct rohc_capture_trailer trailer;
+	bool is_success = true;
+
+	memset(&trailer, 0, sizeof(struct rohc_capture_trailer));
+	trailer.index_offset = writer->offset;
+	trailer.entries_nr = writer->index_nr;
+	trailer.magic = ROHC_CAPTURE_MAGIC;
+	if(!rohc_capture_write_rec(writer, ROHC_CAPTURE_REC_INDEX, writer->pkts_nr,
+	                           no_ts, (const uint8_t *) writer->index,
+	                           writer->index_nr * sizeof(*writer->index)) ||
+	   fwrite(&trailer, sizeof(struct rohc_capture_trailer), 1,
+	          writer->file) != 1)
+	{
+		fprintf(stderr, "failed to write the index of the ROHC capture\n");
+		is_success = false;
+	}
+	if(fclose(writer->file) != 0)
+	{
+		fprintf(stderr, "failed to close the ROHC capture: %s (%d)\n",
+		        strerror(errno), errno);
+		is_success = false;
+	}
+	writer->file = NULL;
+
+	free(writer->index);
+	writer->index = NULL;
+	free(writer->image);
+	writer->image = NULL;
+
+	return is_success;
+}
+
+
+/**
+ * @brief Whether one file is one ROHC capture
+ *
+ * @param path  The path of the file
+ * @return      true if the file starts like one ROHC capture, false otherwise
+ */
+static bool rohc_capture_is_capture(const char *const path)
+	__attribute__((unused));
+static bool rohc_capture_is_capture(const char *const path)
+{
+	struct rohc_capture_file_hdr hdr;
+	bool is_capture = false;
+	FILE *file;
+
+	file = fopen(path, "rb");
+	if(file != NULL)
+	{
+		is_capture =
+			(fread(&hdr, sizeof(struct rohc_capture_file_hdr), 1, file) == 1 &&
+			 hdr.magic == ROHC_CAPTURE_MAGIC);
+		fclose(file);
+	}
+
+	return is_capture;
+}
+
+
+/**
+ * @brief Load the index of one ROHC capture mapped in memory
+ *
+ * The index written at the end of the capture is used if it is there and
+ * consistent, otherwise the index is rebuilt from the records.
+ *
+ * @param map  The ROHC capture mapped in memory
+ * @return     true if the index was loaded, false otherwise
+ */
+static bool rohc_capture_map_load_index(struct rohc_capture_map *const map)
+	__attribute__((unused));
+static bool rohc_capture_map_load_index(struct rohc_capture_map *const map)
+{
+	struct rohc_capture_rec_hdr rec;
+	size_t index_max = 0;
+	size_t offset;
+
+	/* the index written at the end of the capture */
+	if(map->len >= (sizeof(struct rohc_capture_file_hdr) +
+	                sizeof(struct rohc_capture_rec_hdr) +
+	                sizeof(struct rohc_capture_trailer)))
+	{
+		const size_t trailer_offset = map->len - sizeof(struct rohc_capture_trailer);
+		struct rohc_capture_trailer trailer;
+
+		memcpy(&trailer, map->data + trailer_offset,
+		       sizeof(struct rohc_capture_trailer));
+		if(trailer.magic == ROHC_CAPTURE_MAGIC &&
+		   trailer.index_offset >= sizeof(struct rohc_capture_file_hdr) &&
+		   trailer.index_offset <= (trailer_offset -
+		                            sizeof(struct rohc_capture_rec_hdr)))
+		{
+			memcpy(&rec, map->data + trailer.index_offset,
+			       sizeof(struct rohc_capture_rec_hdr));
+			if(rec.type == ROHC_CAPTURE_REC_INDEX &&
+			   rec.len == (trailer.entries_nr * sizeof(*map->index)) &&
+			   (trailer.index_offset + sizeof(struct rohc_capture_rec_hdr) +
+			    rec.len) == trailer_offset)
+			{
+				if(trailer.entries_nr > 0)
+				{
+					map->index = malloc(rec.len);
+					if(map->index == NULL)
+					{
+						goto error;
+					}
+					memcpy(map->index, map->data + trailer.index_offset +
+					       sizeof(struct rohc_capture_rec_hdr), rec.len);
+				}
+				map->index_nr = trailer.entries_nr;
+				map->records_end = trailer.index_offset;
+				return true;
+			}
+		}
+	}
+
+	/* no index, rebuild it from the records until the truncated one */
+	offset = sizeof(struct rohc_capture_file_hdr);
+	while((map->len - offset) >= sizeof(struct rohc_capture_rec_hdr))
+	{
+		memcpy(&rec, map->data + offset, sizeof(struct rohc_capture_rec_hdr));
+		if(rec.len > (map->len - offset - sizeof(struct rohc_capture_rec_hdr)) ||
+		   rec.type == ROHC_CAPTURE_REC_INDEX)
+		{
+			break;
+		}
+		if(rec.type == ROHC_CAPTURE_REC_SNAPSHOT)
+		{
+			if(map->index_nr == index_max)
+			{
+				struct rohc_capture_index_entry *index;
+
+				index_max = (index_max == 0 ? 64 : index_max * 2);
+				index = realloc(map->index, index_max * sizeof(*index));
+				if(index == NULL)
+				{
+					goto error;
+				}
+				map->index = index;
+			}
+			map->index[map->index_nr].pkt_num = rec.pkt_num;
+			map->index[map->index_nr].offset = offset;
+			map->index_nr++;
+		}
+		offset += sizeof(struct rohc_capture_rec_hdr) + rec.len;
+	}
+	map->records_end = offset;
+
+	return true;
+
+error:
+	free(map->index);
+	map->index = NULL;
+	map->index_nr = 0;
+	return false;
+}
+
+
+/**
+ * @brief Map one ROHC capture in memory
+ *
+ * @param path      The path of the capture file
+ * @param[out] map  The ROHC capture mapped in memory
+ * @return          true if the capture was mapped, false otherwise
+ */
+static bool rohc_capture_map_open(const char *const path,
+                                  struct rohc_capture_map *const map)
+	__attribute__((unused));
+static bool rohc_capture_map_open(const char *const path,
+                                  struct rohc_capture_map *const map)
+{
+	struct rohc_capture_file_hdr hdr;
+	struct stat file_stat;
+	void *data;
+	int fd;
+
+	memset(map, 0, sizeof(struct rohc_capture_map));
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to open ROHC capture '%s': %s (%d)\n", path,
+		        strerror(errno), errno);
+		goto error;
+	}
+	if(fstat(fd, &file_stat) != 0)
+	{
+		fprintf(stderr, "failed to get information for file '%s': %s (%d)\n",
+		        path, strerror(errno), errno);
+		goto close_file;
+	}
+	if(file_stat.st_size < (off_t) sizeof(struct rohc_capture_file_hdr))
+	{
+		fprintf(stderr, "file '%s' is too short for a ROHC capture\n", path);
+		goto close_file;
+	}
+
+	data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(data == MAP_FAILED)
+	{
+		fprintf(stderr, "failed to map ROHC capture '%s': %s (%d)\n", path,
+		        strerror(errno), errno);
+		goto close_file;
+	}
+	map->data = data;
+	map->len = file_stat.st_size;
+
+	memcpy(&hdr, map->data, sizeof(struct rohc_capture_file_hdr));
+	if(hdr.magic != ROHC_CAPTURE_MAGIC)
+	{
+		fprintf(stderr, "file '%s' is not a ROHC capture, or it was written "
+		        "on a host with another byte order\n", path);
+		goto unmap_file;
+	}
+	if(hdr.version != ROHC_CAPTURE_VERSION)
+	{
+		fprintf(stderr, "ROHC capture '%s' has unsupported version %u\n", path,
+		        hdr.version);
+		goto unmap_file;
+	}
+
+	if(!rohc_capture_map_load_index(map))
+	{
+		fprintf(stderr, "failed to allocate memory for the index of ROHC "
+		        "capture '%s'\n", path);
+		goto unmap_file;
+	}
+	map->offset = sizeof(struct rohc_capture_file_hdr);
+
+	close(fd);
+	return true;
+
+unmap_file:
+	munmap(data, map->len);
+	map->data = NULL;
+close_file:
+	close(fd);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Seek one ROHC capture mapped in memory to the nearest snapshot
+ *
+ * The contexts of the last snapshot before the given packet are restored in
+ * the decompressor, and the capture is read from the packet that follows
+ * the snapshot. The capture is read from its beginning if there is no such
+ * snapshot, the decompressor shall then have no context.
+ *
+ * @param map                 The ROHC capture mapped in memory
+ * @param decomp              The decompressor to restore the contexts in
+ * @param pkt_num             The number of the packet (from 0) to seek to
+ * @param[out] first_pkt_num  The number of the next packet read
+ * @param[out] ctxts_nr       The number of contexts restored
+ * @return                    true if the capture was seeked, false if the
+ *                            snapshot is malformed
+ */
+static bool rohc_capture_map_seek(struct rohc_capture_map *const map,
+                                  struct rohc_decomp *const decomp,
+                                  const uint64_t pkt_num,
+                                  uint64_t *const first_pkt_num,
+                                  size_t *const ctxts_nr)
+	__attribute__((unused));
+static bool rohc_capture_map_seek(struct rohc_capture_map *const map,
+                                  struct rohc_decomp *const decomp,
+                                  const uint64_t pkt_num,
+                                  uint64_t *const first_pkt_num,
+                                  size_t *const ctxts_nr)
+{
+	struct rohc_capture_rec_hdr rec;
+	struct rohc_ts now;
+	size_t low = 0;
+	size_t high = map->index_nr;
+	size_t offset;
+
+	/* the last snapshot before the packet, the index is sorted by packet */
+	while(low < high)
+	{
+		const size_t mid = low + (high - low) / 2;
+		if(map->index[mid].pkt_num <= pkt_num)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	if(low == 0)
+	{
+		map->offset = sizeof(struct rohc_capture_file_hdr);
+		*first_pkt_num = 0;
+		*ctxts_nr = 0;
+		return true;
+	}
+
+	offset = map->index[low - 1].offset;
+	if(map->records_end < (sizeof(struct rohc_capture_file_hdr) +
+	                       sizeof(struct rohc_capture_rec_hdr)) ||
+	   offset < sizeof(struct rohc_capture_file_hdr) ||
+	   offset > (map->records_end - sizeof(struct rohc_capture_rec_hdr)))
+	{
+		fprintf(stderr, "snapshot for packet #%llu is out of the capture\n",
+		        (unsigned long long) map->index[low - 1].pkt_num);
+		goto error;
+	}
+	memcpy(&rec, map->data + offset, sizeof(struct rohc_capture_rec_hdr));
+	if(rec.type != ROHC_CAPTURE_REC_SNAPSHOT ||
+	   rec.len > (map->records_end - offset - sizeof(struct rohc_capture_rec_hdr)))
+	{
+		fprintf(stderr, "snapshot for packet #%llu is malformed\n",
+		        (unsigned long long) map->index[low - 1].pkt_num);
+		goto error;
+	}
+
+	now.sec = rec.ts_sec;
+	now.nsec = rec.ts_nsec;
+	if(!rohc_decomp_restore_contexts(decomp, map->data + offset +
+	                                 sizeof(struct rohc_capture_rec_hdr),
+	                                 rec.len, now, ctxts_nr))
+	{
+		fprintf(stderr, "failed to restore the snapshot for packet #%llu\n",
+		        (unsigned long long) rec.pkt_num);
+		goto error;
+	}
+	map->offset = offset + sizeof(struct rohc_capture_rec_hdr) + rec.len;
+	*first_pkt_num = rec.pkt_num;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the next ROHC packet of one ROHC capture mapped in memory
+ *
+ * The snapshots are skipped.
+ *
+ * @param map           The ROHC capture mapped in memory
+ * @param[out] rec      The header of the packet record
+ * @param[out] packet   The ROHC packet, in the mapped file
+ * @return              true if one packet was found, false at the end of
+ *                      the capture
+ */
+static bool rohc_capture_map_next(struct rohc_capture_map *const map,
+                                  struct rohc_capture_rec_hdr *const rec,
+                                  const uint8_t **const packet)
+	__attribute__((unused));
+static bool rohc_capture_map_next(struct rohc_capture_map *const map,
+                                  struct rohc_capture_rec_hdr *const rec,
+                                  const uint8_t **const packet)
+{
+	while((map->records_end - map->offset) >= sizeof(struct rohc_capture_rec_hdr))
+	{
+		memcpy(rec, map->data + map->offset, sizeof(struct rohc_capture_rec_hdr));
+		if(rec->len > (map->records_end - map->offset -
+		               sizeof(struct rohc_capture_rec_hdr)))
+		{
+			break;
+		}
+		map->offset += sizeof(struct rohc_capture_rec_hdr);
+		*packet = map->data + map->offset;
+		map->offset += rec->len;
+
+		if(rec->type == ROHC_CAPTURE_REC_PKT)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * @brief Unmap one ROHC capture from memory
+ *
+ * @param map  The ROHC capture mapped in memory
+ */
+static void rohc_capture_map_close(struct rohc_capture_map *const map)
+	__attribute__((unused));
+static void rohc_capture_map_close(struct rohc_capture_map *const map)
+{
+	munmap((void *) map->data, map->len);
+	map->data = NULL;
+	map->len = 0;
+	free(map->index);
+	map->index = NULL;
+	map->index_nr = 0;
+}
+
+#endif
+